@@ -0,0 +1,121 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/aes/aesni_primitives.h"
+#include "utility/block.h"
+
+namespace {
+
+struct RoundKeys {
+  RoundKeys() {
+    // any fixed key is fine for the throughput
+    for (std::size_t i = 0; i < kAesKeySize128; ++i) round_keys[i] = std::uint8_t(i);
+    AesniKeyExpansion128(round_keys.data());
+  }
+
+  alignas(16) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys{};
+};
+
+}  // namespace
+
+/**
+ * Benchmark for AES in counter mode as used by the pseudo-random generators.
+ */
+static void BM_AesniCtrStreamBlocks128(benchmark::State& state) {
+  const std::size_t number_of_blocks = state.range(0);
+  const RoundKeys keys;
+  auto output{encrypto::motion::Block128Vector::MakeZero(number_of_blocks)};
+  std::uint64_t counter{0};
+
+  for (auto _ : state) {
+    AesniCtrStreamBlocks128(keys.round_keys.data(), &counter, output.data(), number_of_blocks);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * kAesBlockSize);
+}
+BENCHMARK(BM_AesniCtrStreamBlocks128)->RangeMultiplier(8)->Range(1 << 6, 1 << 18);
+
+/**
+ * Benchmark for the fixed-key hash MMO^\pi as used in the OT extension and garbled circuits.
+ */
+static void BM_AesniMmoBlocks(benchmark::State& state) {
+  const std::size_t number_of_blocks = state.range(0);
+  const RoundKeys keys;
+  auto blocks{encrypto::motion::Block128Vector::MakeRandom(number_of_blocks)};
+
+  for (auto _ : state) {
+    AesniMmoBlocks(keys.round_keys.data(), blocks.data(), number_of_blocks);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * number_of_blocks * kAesBlockSize);
+}
+BENCHMARK(BM_AesniMmoBlocks)->RangeMultiplier(8)->Range(1 << 6, 1 << 18);
+
+/**
+ * Benchmark for the tweakable fixed-key hash TMMO^\pi of four blocks as used for the garbled
+ * tables.
+ */
+static void BM_AesniTmmoBatch4(benchmark::State& state) {
+  const RoundKeys keys;
+  auto blocks{encrypto::motion::Block128Vector::MakeRandom(4)};
+  __uint128_t tweak{0};
+
+  for (auto _ : state) {
+    AesniTmmoBatch4(keys.round_keys.data(), blocks.data(), tweak++);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * 4 * kAesBlockSize);
+}
+BENCHMARK(BM_AesniTmmoBatch4);
+
+/**
+ * Benchmark for the dual-key cipher of the BMR garbled AND gates, where the argument is the number
+ * of parties.
+ */
+static void BM_AesniBmrDkcBatch(benchmark::State& state) {
+  constexpr std::size_t kNumberOfKeys{1 << 10};
+  const std::size_t number_of_parties = state.range(0);
+  const RoundKeys keys;
+  const auto keys_a{encrypto::motion::Block128Vector::MakeRandom(kNumberOfKeys)};
+  const auto keys_b{encrypto::motion::Block128Vector::MakeRandom(kNumberOfKeys)};
+  auto output{encrypto::motion::Block128Vector::MakeZero(kNumberOfKeys * number_of_parties)};
+  std::uint64_t gate_id{0};
+
+  for (auto _ : state) {
+    AesniBmrDkcBatch(keys.round_keys.data(), keys_a.data(), keys_b.data(), gate_id++,
+                     kNumberOfKeys, number_of_parties, output.data(), number_of_parties);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumberOfKeys * number_of_parties);
+}
+BENCHMARK(BM_AesniBmrDkcBatch)->Arg(2)->Arg(3)->Arg(5);
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <benchmark/benchmark.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include "algorithm/aes_128.h"
+#include "algorithm/algorithm_description.h"
+#include "algorithm/sha_256.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+#include "utility/config.h"
+
+namespace {
+
+enum class CircuitSource : int { kBristol = 0, kBuilder = 1 };
+
+// evaluates \p function on two inputs of garbler and evaluator with garbled circuits
+template <typename Function>
+void EvaluateGarbledCircuit(std::size_t number_of_wires_0, std::size_t number_of_wires_1,
+                            std::size_t number_of_simd, Function function) {
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, 0)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      party->GetLogger()->SetEnabled(false);
+      const std::vector<encrypto::motion::BitVector<>> input_0(
+          number_of_wires_0, encrypto::motion::BitVector<>(number_of_simd));
+      const std::vector<encrypto::motion::BitVector<>> input_1(
+          number_of_wires_1, encrypto::motion::BitVector<>(number_of_simd));
+      encrypto::motion::ShareWrapper share_0{party->In<kGarbledCircuit>(input_0, 0)};
+      encrypto::motion::ShareWrapper share_1{party->In<kGarbledCircuit>(input_1, 1)};
+      auto output{function(share_0, share_1).Out()};
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
+
+static void BM_Aes128GarbledCircuit(benchmark::State& state) {
+  const auto source{static_cast<CircuitSource>(state.range(0))};
+  const std::size_t number_of_simd = state.range(1);
+  const auto aes_algorithm{encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/advanced/aes_128.bristol")};
+
+  for (auto _ : state) {
+    EvaluateGarbledCircuit(
+        encrypto::motion::algorithm::kAes128BlockBitSize,
+        encrypto::motion::algorithm::kAes128BlockBitSize, number_of_simd,
+        [&](const auto& key, const auto& plaintext) {
+          return source == CircuitSource::kBristol
+                     ? encrypto::motion::ShareWrapper::Concatenate({key, plaintext})
+                           .Evaluate(aes_algorithm)
+                     : encrypto::motion::algorithm::Aes128(key, plaintext);
+        });
+  }
+  state.counters["Blocks"] = benchmark::Counter(state.iterations() * number_of_simd,
+                                                benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Aes128GarbledCircuit)
+    ->ArgsProduct({{static_cast<int>(CircuitSource::kBristol),
+                    static_cast<int>(CircuitSource::kBuilder)},
+                   {1, 64}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Sha256GarbledCircuit(benchmark::State& state) {
+  const auto source{static_cast<CircuitSource>(state.range(0))};
+  const std::size_t number_of_simd = state.range(1);
+  const auto sha_algorithm{encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/advanced/sha_256.bristol")};
+
+  for (auto _ : state) {
+    EvaluateGarbledCircuit(
+        encrypto::motion::algorithm::kSha256BlockBitSize,
+        encrypto::motion::algorithm::kSha256StateBitSize, number_of_simd,
+        [&](const auto& block, const auto& chaining_state) {
+          return source == CircuitSource::kBristol
+                     ? encrypto::motion::ShareWrapper::Concatenate({block, chaining_state})
+                           .Evaluate(sha_algorithm)
+                     : encrypto::motion::algorithm::Sha256Compression(block, chaining_state);
+        });
+  }
+  state.counters["Blocks"] = benchmark::Counter(state.iterations() * number_of_simd,
+                                                benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Sha256GarbledCircuit)
+    ->ArgsProduct({{static_cast<int>(CircuitSource::kBristol),
+                    static_cast<int>(CircuitSource::kBuilder)},
+                   {1, 64}})
+    ->Unit(benchmark::kMillisecond);
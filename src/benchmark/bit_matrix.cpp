@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_matrix.h"
+#include "utility/bit_vector.h"
+
+/**
+ * Benchmark for the bit-sliced transposition of a matrix with 128 rows as used in OT extension.
+ * The width of the vector registers used for the transposition is selected with MOTION_USE_AVX.
+ */
+static void BM_TransposeUsingBitSlicing(benchmark::State& state) {
+  const std::size_t number_of_columns = state.range(0);
+  std::vector<encrypto::motion::AlignedBitVector> rows;
+  std::array<std::byte*, 128> pointers;
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    rows.emplace_back(encrypto::motion::AlignedBitVector::RandomSeeded(number_of_columns, i));
+  }
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    pointers[i] = rows[i].GetMutableData().data();
+  }
+
+  for (auto _ : state) {
+    encrypto::motion::BitMatrix::TransposeUsingBitSlicing(pointers, number_of_columns);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * number_of_columns * pointers.size() / 8);
+}
+BENCHMARK(BM_TransposeUsingBitSlicing)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+/**
+ * Benchmark for the transposition and hashing of the OT extension matrix by the receiver.
+ */
+static void BM_ReceiverTranspose128AndEncrypt(benchmark::State& state) {
+  const std::size_t number_of_columns = state.range(0);
+  std::vector<encrypto::motion::AlignedBitVector> rows;
+  std::array<const std::byte*, 128> pointers;
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    rows.emplace_back(encrypto::motion::AlignedBitVector::RandomSeeded(number_of_columns, i));
+  }
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    pointers[i] = rows[i].GetData().data();
+  }
+  const std::vector<std::size_t> bitlengths(number_of_columns, 128);
+  std::array<std::byte, 16> key{};
+  encrypto::motion::primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(key.data());
+
+  for (auto _ : state) {
+    std::vector<encrypto::motion::BitVector<>> output(number_of_columns);
+    encrypto::motion::BitMatrix::ReceiverTranspose128AndEncrypt(pointers, output, prg_fixed_key,
+                                                                number_of_columns, bitlengths);
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * number_of_columns);
+}
+BENCHMARK(BM_ReceiverTranspose128AndEncrypt)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
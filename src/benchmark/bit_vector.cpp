@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utility/bit_vector.h"
+
+/**
+ * Benchmarks for the bulk operations of BitVector and BitSpan.  The offset of 3 bits makes the
+ * copies and subsets take the shifting code paths.
+ */
+static void BM_BitVectorAppendUnaligned(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+  const auto head{encrypto::motion::BitVector<>::RandomSeeded(3, 0)};
+  const auto tail{encrypto::motion::BitVector<>::RandomSeeded(bit_size, 1)};
+
+  for (auto _ : state) {
+    auto result{head};
+    result.Append(tail);
+    benchmark::DoNotOptimize(result.GetData().data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bit_size / 8);
+}
+BENCHMARK(BM_BitVectorAppendUnaligned)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+static void BM_BitVectorCopyUnaligned(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+  auto destination{encrypto::motion::BitVector<>::RandomSeeded(bit_size + 3, 0)};
+  const auto source{encrypto::motion::BitVector<>::RandomSeeded(bit_size, 1)};
+
+  for (auto _ : state) {
+    destination.Copy(3, source);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * bit_size / 8);
+}
+BENCHMARK(BM_BitVectorCopyUnaligned)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+static void BM_BitVectorSubsetUnaligned(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+  const auto source{encrypto::motion::BitVector<>::RandomSeeded(bit_size + 3, 0)};
+
+  for (auto _ : state) {
+    auto result{source.Subset(3, bit_size + 3)};
+    benchmark::DoNotOptimize(result.GetData().data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bit_size / 8);
+}
+BENCHMARK(BM_BitVectorSubsetUnaligned)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+static void BM_BitSpanXor(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+  auto a{encrypto::motion::AlignedBitVector::RandomSeeded(bit_size, 0)};
+  const auto b{encrypto::motion::AlignedBitVector::RandomSeeded(bit_size, 1)};
+  encrypto::motion::BitSpan span(a.GetMutableData().data(), bit_size, true);
+
+  for (auto _ : state) {
+    span ^= b;
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * bit_size / 8);
+}
+BENCHMARK(BM_BitSpanXor)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+static void BM_XorReduceBitVector(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+  const auto bit_vector{encrypto::motion::BitVector<>::RandomSeeded(bit_size, 0)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encrypto::motion::BitVector<>::XorReduceBitVector(bit_vector));
+  }
+
+  state.SetBytesProcessed(state.iterations() * bit_size / 8);
+}
+BENCHMARK(BM_XorReduceBitVector)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+/**
+ * Benchmark for the construction of the single-bit BitVectors of the wires of non-SIMD
+ * circuits, which are stored in the inline buffer of BitVector.
+ */
+static void BM_BitVectorSingleBitConstruction(benchmark::State& state) {
+  const std::size_t number_of_wires = state.range(0);
+
+  for (auto _ : state) {
+    std::vector<encrypto::motion::BitVector<>> wires;
+    wires.reserve(number_of_wires);
+    for (std::size_t i = 0; i < number_of_wires; ++i) wires.emplace_back(1, (i & 1) == 1);
+    benchmark::DoNotOptimize(wires.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * number_of_wires);
+}
+BENCHMARK(BM_BitVectorSingleBitConstruction)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+/**
+ * Benchmark for the allocation of AlignedBitVectors, which reuse the blocks of the thread-local
+ * AlignedMemoryPool.
+ */
+static void BM_AlignedBitVectorAllocation(benchmark::State& state) {
+  const std::size_t bit_size = state.range(0);
+
+  for (auto _ : state) {
+    encrypto::motion::AlignedBitVector bit_vector(bit_size);
+    benchmark::DoNotOptimize(bit_vector.GetMutableData().data());
+  }
+}
+BENCHMARK(BM_AlignedBitVectorAllocation)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "primitives/blake2b.h"
+
+/**
+ * Benchmarks for hashing many short messages of state.range(0) bytes, e.g., 48 B for the base OT
+ * resumption, once by single calls and once by the batched Blake2b.
+ */
+constexpr std::size_t kNumberOfMessages{1024};
+
+static void BM_Blake2bSingle(benchmark::State& state) {
+  const std::size_t length = state.range(0);
+  std::vector<std::uint8_t> messages(kNumberOfMessages * length, 0x42);
+  std::vector<std::uint8_t> digests(kNumberOfMessages * EVP_MAX_MD_SIZE);
+  auto context{encrypto::motion::NewBlakeCtx()};
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+      encrypto::motion::Blake2b(messages.data() + i * length,
+                                digests.data() + i * EVP_MAX_MD_SIZE, length, context);
+    }
+    benchmark::DoNotOptimize(digests.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumberOfMessages);
+}
+BENCHMARK(BM_Blake2bSingle)->Arg(16)->Arg(48)->Arg(96);
+
+static void BM_Blake2bBatch(benchmark::State& state) {
+  const std::size_t length = state.range(0);
+  std::vector<std::uint8_t> messages(kNumberOfMessages * length, 0x42);
+  std::vector<std::uint8_t> digests(kNumberOfMessages * EVP_MAX_MD_SIZE);
+  std::vector<const std::uint8_t*> message_pointers(kNumberOfMessages);
+  std::vector<std::uint8_t*> digest_pointers(kNumberOfMessages);
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_pointers[i] = messages.data() + i * length;
+    digest_pointers[i] = digests.data() + i * EVP_MAX_MD_SIZE;
+  }
+
+  for (auto _ : state) {
+    encrypto::motion::Blake2bBatch(message_pointers, length, digest_pointers);
+    benchmark::DoNotOptimize(digests.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumberOfMessages);
+}
+BENCHMARK(BM_Blake2bBatch)->Arg(16)->Arg(48)->Arg(96);
@@ -0,0 +1,189 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compares the results of motion_benchmark with a stored baseline and fails if a benchmark became
+// slower by more than a threshold, e.g.,
+//
+//   motion_benchmark --benchmark_repetitions=5 --benchmark_out=baseline.json
+//   ... upgrade ...
+//   motion_benchmark --benchmark_repetitions=5 --benchmark_out=contender.json
+//   motion_benchmark_compare baseline.json contender.json --threshold 5
+//
+// The median is compared if the results contain repetitions.
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+namespace program_options = boost::program_options;
+
+namespace {
+
+double ToNanoseconds(double time, const std::string& time_unit) {
+  if (time_unit == "ns") return time;
+  if (time_unit == "us") return time * 1e3;
+  if (time_unit == "ms") return time * 1e6;
+  if (time_unit == "s") return time * 1e9;
+  throw std::runtime_error(fmt::format("Unknown time unit {}", time_unit));
+}
+
+std::string FormatNanoseconds(double time) {
+  if (time >= 1e9) return fmt::format("{:.3f} s", time / 1e9);
+  if (time >= 1e6) return fmt::format("{:.3f} ms", time / 1e6);
+  if (time >= 1e3) return fmt::format("{:.3f} us", time / 1e3);
+  return fmt::format("{:.3f} ns", time);
+}
+
+double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const auto middle{values.size() / 2};
+  return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// <benchmark name, time in nanoseconds> of the medians or of the single runs
+std::map<std::string, double> LoadResults(const std::string& path, const std::string& metric) {
+  std::ifstream file(path);
+  if (!file) throw std::runtime_error(fmt::format("Cannot open {}", path));
+  std::stringstream content;
+  content << file.rdbuf();
+  const auto json{boost::json::parse(content.str())};
+
+  std::map<std::string, double> medians;
+  std::map<std::string, std::vector<double>> iterations;
+  for (const auto& entry : json.at("benchmarks").as_array()) {
+    const auto& benchmark{entry.as_object()};
+    // errors are reported instead of timings
+    if (benchmark.contains("error_occurred") && benchmark.at("error_occurred").as_bool()) continue;
+    const auto name{boost::json::value_to<std::string>(
+        benchmark.contains("run_name") ? benchmark.at("run_name") : benchmark.at("name"))};
+    const auto time{ToNanoseconds(boost::json::value_to<double>(benchmark.at(metric)),
+                                  boost::json::value_to<std::string>(benchmark.at("time_unit")))};
+    if (benchmark.contains("run_type") && benchmark.at("run_type").as_string() == "aggregate") {
+      if (benchmark.at("aggregate_name").as_string() == "median") medians[name] = time;
+    } else {
+      iterations[name].push_back(time);
+    }
+  }
+  for (auto& [name, times] : iterations) {
+    // the reported median takes precedence over the runs
+    medians.try_emplace(name, Median(std::move(times)));
+  }
+  return medians;
+}
+
+// <variables map, help flag>
+std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char* av[]) {
+  bool help;
+  program_options::options_description description("Allowed options");
+  // clang-format off
+  description.add_options()
+      ("help,h", program_options::bool_switch(&help)->default_value(false),"produce help message")
+      ("baseline", program_options::value<std::string>()->required(), "JSON output of motion_benchmark with --benchmark_out of the baseline")
+      ("contender", program_options::value<std::string>()->required(), "JSON output of motion_benchmark with --benchmark_out to compare to the baseline")
+      ("threshold", program_options::value<double>()->default_value(5), "slowdown in percent beyond which a benchmark is reported as regression")
+      ("metric", program_options::value<std::string>()->default_value("real_time"), "compared time, real_time or cpu_time")
+      ("filter", program_options::value<std::string>()->default_value(".*"), "regular expression of the compared benchmark names");
+  // clang-format on
+  program_options::positional_options_description positional;
+  positional.add("baseline", 1).add("contender", 1);
+
+  program_options::variables_map user_options;
+  program_options::store(program_options::command_line_parser(ac, av)
+                             .options(description)
+                             .positional(positional)
+                             .run(),
+                         user_options);
+  if (help) {
+    std::cout << "Usage: motion_benchmark_compare BASELINE CONTENDER [options]\n"
+              << description << "\n";
+    return std::make_pair<program_options::variables_map, bool>({}, true);
+  }
+  program_options::notify(user_options);
+
+  const auto metric{user_options["metric"].as<std::string>()};
+  if (metric != "real_time" && metric != "cpu_time") {
+    throw std::runtime_error(
+        fmt::format("Unknown metric {}, expected real_time or cpu_time", metric));
+  }
+  return std::make_pair(user_options, help);
+}
+
+}  // namespace
+
+int main(int ac, char* av[]) {
+  auto [user_options, help_flag] = ParseProgramOptions(ac, av);
+  // if help flag is set - print allowed command line arguments and exit
+  if (help_flag) return EXIT_SUCCESS;
+
+  const auto metric{user_options["metric"].as<std::string>()};
+  const auto baseline{LoadResults(user_options["baseline"].as<std::string>(), metric)};
+  const auto contender{LoadResults(user_options["contender"].as<std::string>(), metric)};
+  const auto threshold{user_options["threshold"].as<double>() / 100};
+  const std::regex filter(user_options["filter"].as<std::string>());
+
+  std::size_t number_of_regressions{0}, number_of_improvements{0};
+  std::cout << fmt::format("{:<60} {:>14} {:>14} {:>9}\n", "Benchmark", "Baseline", "Contender",
+                           "Change");
+  for (const auto& [name, baseline_time] : baseline) {
+    if (!std::regex_search(name, filter)) continue;
+    const auto iterator{contender.find(name)};
+    if (iterator == contender.end()) {
+      std::cout << fmt::format("{:<60} {:>14} {:>14}\n", name, FormatNanoseconds(baseline_time),
+                               "missing");
+      continue;
+    }
+    const auto change{(iterator->second - baseline_time) / baseline_time};
+    std::string verdict;
+    if (change > threshold) {
+      verdict = "REGRESSION";
+      ++number_of_regressions;
+    } else if (change < -threshold) {
+      verdict = "improvement";
+      ++number_of_improvements;
+    }
+    std::cout << fmt::format("{:<60} {:>14} {:>14} {:>+8.1f}% {}\n", name,
+                             FormatNanoseconds(baseline_time),
+                             FormatNanoseconds(iterator->second), change * 100, verdict);
+  }
+  for (const auto& [name, contender_time] : contender) {
+    if (std::regex_search(name, filter) && !baseline.contains(name)) {
+      std::cout << fmt::format("{:<60} {:>14} {:>14}\n", name, "new",
+                               FormatNanoseconds(contender_time));
+    }
+  }
+
+  std::cout << fmt::format("\n{} regressions and {} improvements beyond {}% of the {}\n",
+                           number_of_regressions, number_of_improvements, threshold * 100, metric);
+  return number_of_regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
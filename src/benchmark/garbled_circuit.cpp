@@ -92,4 +92,66 @@ static void BM_ThreeHalvesGarbling(benchmark::State& state) {
 
   state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
 }
-BENCHMARK(BM_ThreeHalvesGarbling)->RangeMultiplier(2)->Range(1, 128);
\ No newline at end of file
+BENCHMARK(BM_ThreeHalvesGarbling)->RangeMultiplier(2)->Range(1, 128);
+
+static void BM_HalfGatesEvaluation(benchmark::State& state) {
+  auto communication_layers = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  encrypto::motion::proto::garbled_circuit::ThreeHalvesEvaluatorProvider provider(
+      *communication_layers[1]);
+
+  std::size_t number_of_simd = state.range(0);
+  encrypto::motion::Block128Vector keys_a(number_of_simd), keys_b(number_of_simd),
+      keys_out(number_of_simd);
+  encrypto::motion::BitVector<> garbled_tables(
+      number_of_simd * encrypto::motion::proto::garbled_circuit::kHalfGatesGarbledTableBitSize);
+
+  std::size_t counter{0};
+  for (auto _ : state) {
+    provider.EvaluateHalfGates(keys_a, keys_b, keys_out, garbled_tables.GetData().data(), 0, 0);
+    counter += number_of_simd;
+  }
+
+  // shutdown all commmunication layers
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+  state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_HalfGatesEvaluation)->RangeMultiplier(2)->Range(1, 128);
+
+static void BM_HalfGatesGarbling(benchmark::State& state) {
+  auto communication_layers = encrypto::motion::communication::MakeDummyCommunicationLayers(2);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  encrypto::motion::proto::garbled_circuit::ThreeHalvesGarblerProvider provider(
+      *communication_layers[0]);
+
+  std::size_t number_of_simd = state.range(0);
+  encrypto::motion::Block128Vector keys_a(number_of_simd), keys_b(number_of_simd),
+      keys_out(number_of_simd);
+  encrypto::motion::BitVector<> garbled_tables(
+      number_of_simd * encrypto::motion::proto::garbled_circuit::kHalfGatesGarbledTableBitSize);
+
+  std::size_t counter{0};
+  for (auto _ : state) {
+    provider.GarbleHalfGates(keys_a, keys_b, keys_out, garbled_tables.GetMutableData().data(), 0,
+                             0);
+    counter += number_of_simd;
+  }
+
+  // shutdown all commmunication layers
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+  state.counters["Gates"] = benchmark::Counter(counter, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_HalfGatesGarbling)->RangeMultiplier(2)->Range(1, 128);
\ No newline at end of file
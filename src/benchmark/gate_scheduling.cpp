@@ -0,0 +1,200 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/configuration.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+#include "utility/fiber_condition.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
+
+namespace {
+
+// synthetic circuits of local gates with a single SIMD value, so that the evaluation time is
+// dominated by the scheduling of the gates
+enum class CircuitShape : int {
+  // one XOR gate per layer
+  kXorChain = 0,
+  // one INV gate per layer
+  kInvChain = 1,
+  // a single layer of independent XOR gates
+  kWideLayer = 2
+};
+
+constexpr std::array kCircuitShapes{static_cast<int>(CircuitShape::kXorChain),
+                                    static_cast<int>(CircuitShape::kInvChain),
+                                    static_cast<int>(CircuitShape::kWideLayer)};
+
+// 0 uses one worker per hardware thread
+constexpr std::array kNumbersOfWorkerThreads{2, 4, 8, 0};
+
+encrypto::motion::ShareWrapper BuildCircuit(encrypto::motion::Party& party, CircuitShape shape,
+                                            std::size_t number_of_gates) {
+  constexpr auto kBooleanGmw{encrypto::motion::MpcProtocol::kBooleanGmw};
+  const std::size_t number_of_wires{shape == CircuitShape::kWideLayer ? number_of_gates : 1};
+  const std::vector<encrypto::motion::BitVector<>> input(number_of_wires,
+                                                         encrypto::motion::BitVector<>(1));
+  encrypto::motion::ShareWrapper input_0{party.In<kBooleanGmw>(input, 0)};
+  const encrypto::motion::ShareWrapper input_1{party.In<kBooleanGmw>(input, 1)};
+  switch (shape) {
+    case CircuitShape::kXorChain:
+      for (std::size_t i = 0; i < number_of_gates; ++i) input_0 = input_0 ^ input_1;
+      return input_0;
+    case CircuitShape::kInvChain:
+      for (std::size_t i = 0; i < number_of_gates; ++i) input_0 = ~input_0;
+      return input_0;
+    case CircuitShape::kWideLayer: {
+      const auto wires_0{input_0.Split()}, wires_1{input_1.Split()};
+      std::vector<encrypto::motion::ShareWrapper> outputs;
+      outputs.reserve(number_of_gates);
+      for (std::size_t i = 0; i < number_of_gates; ++i) {
+        outputs.emplace_back(wires_0[i] ^ wires_1[i]);
+      }
+      return encrypto::motion::ShareWrapper::Concatenate(outputs);
+    }
+  }
+  throw std::invalid_argument("Unknown circuit shape");
+}
+
+}  // namespace
+
+/**
+ * Benchmark for the overhead of the gate scheduling of Party::Run(), i.e., the evaluation of
+ * synthetic circuits of local gates in Boolean GMW by two parties, parameterized by the circuit
+ * shape, the number of worker threads of the FiberThreadPool and the number of gates.  Only
+ * Party::Run() of party 0 is timed, without the connection setup and the construction of the
+ * circuit, such that the time per gate is the scheduling overhead of the executor.
+ */
+static void BM_GateSchedulingOverhead(benchmark::State& state) {
+  const auto shape{static_cast<CircuitShape>(state.range(0))};
+  const std::size_t number_of_worker_threads = state.range(1);
+  const std::size_t number_of_gates = state.range(2);
+
+  for (auto _ : state) {
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, 0)};
+    std::vector<std::future<double>> futures;
+    for (auto& party : parties) {
+      futures.emplace_back(std::async(std::launch::async, [&] {
+        party->GetLogger()->SetEnabled(false);
+        party->GetConfiguration()->SetNumberOfWorkerThreads(number_of_worker_threads);
+        auto output{BuildCircuit(*party, shape, number_of_gates).Out()};
+        const auto start{std::chrono::steady_clock::now()};
+        party->Run();
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+        party->Finish();
+        return elapsed.count();
+      }));
+    }
+    const auto elapsed{futures.front().get()};
+    for (std::size_t i = 1; i < futures.size(); ++i) futures[i].get();
+    state.SetIterationTime(elapsed);
+  }
+
+  state.counters["Gates"] =
+      benchmark::Counter(state.iterations() * number_of_gates, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_GateSchedulingOverhead)
+    ->ArgsProduct({{kCircuitShapes.begin(), kCircuitShapes.end()},
+                   {kNumbersOfWorkerThreads.begin(), kNumbersOfWorkerThreads.end()},
+                   {1 << 8, 1 << 12}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark for posting empty tasks to the FiberThreadPool and waiting for their completion, i.e.,
+ * the cost of a fiber per gate in the work-stealing scheduler without dependencies between the
+ * gates, parameterized by the number of worker threads and the number of tasks.
+ */
+static void BM_FiberThreadPoolPost(benchmark::State& state) {
+  const std::size_t number_of_workers = state.range(0);
+  const std::size_t number_of_tasks = state.range(1);
+  encrypto::motion::FiberThreadPool pool(number_of_workers, number_of_tasks);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number_of_tasks; ++i) pool.post([] {});
+    pool.wait_idle();
+  }
+  pool.join();
+
+  state.counters["Tasks"] =
+      benchmark::Counter(state.iterations() * number_of_tasks, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FiberThreadPoolPost)
+    ->ArgsProduct({{kNumbersOfWorkerThreads.begin(), kNumbersOfWorkerThreads.end()},
+                   {1 << 10, 1 << 14}});
+
+/**
+ * Benchmark for chains of tasks in the FiberThreadPool where each task waits for the FiberCondition
+ * of its predecessor, i.e., the cost of the wake-up of a fiber by a finished parent gate,
+ * parameterized by the number of worker threads and the number of independent chains.  The tasks
+ * are posted in reverse order such that most of them block before their predecessor finishes.
+ */
+static void BM_FiberConditionChain(benchmark::State& state) {
+  constexpr std::size_t kChainLength{1 << 8};
+  const std::size_t number_of_workers = state.range(0);
+  const std::size_t number_of_chains = state.range(1);
+  const std::size_t number_of_tasks{kChainLength * number_of_chains};
+  encrypto::motion::FiberThreadPool pool(number_of_workers, number_of_tasks);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<char> is_ready(number_of_tasks, false);
+    std::vector<std::unique_ptr<encrypto::motion::FiberCondition>> conditions;
+    conditions.reserve(number_of_tasks);
+    for (std::size_t i = 0; i < number_of_tasks; ++i) {
+      conditions.emplace_back(std::make_unique<encrypto::motion::FiberCondition>(
+          [&is_ready, i] { return static_cast<bool>(is_ready[i]); }));
+    }
+    state.ResumeTiming();
+
+    for (std::size_t i = number_of_tasks; i-- > 0;) {
+      pool.post([&is_ready, &conditions, i] {
+        // the first task of each chain has no predecessor
+        if (i % kChainLength != 0) conditions[i - 1]->Wait();
+        {
+          std::scoped_lock lock(conditions[i]->GetMutex());
+          is_ready[i] = true;
+        }
+        conditions[i]->NotifyAll();
+      });
+    }
+    pool.wait_idle();
+  }
+  pool.join();
+
+  state.counters["Tasks"] =
+      benchmark::Counter(state.iterations() * number_of_tasks, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FiberConditionChain)
+    ->ArgsProduct({{kNumbersOfWorkerThreads.begin(), kNumbersOfWorkerThreads.end()}, {1, 16}});
@@ -0,0 +1,370 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Throughput and communication of the preprocessing providers.  Each benchmark reports the rate
+// of the generated items, e.g., TriplesPerSecond, and the bytes sent by both parties per item,
+// e.g., BytesPerTriple.  Use --benchmark_format=json to compare the results between versions.
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/backend.h"
+#include "base/motion_base_provider.h"
+#include "base/party.h"
+#include "communication/communication_layer.h"
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
+#include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
+#include "oblivious_transfer/base_ots/base_ot_provider.h"
+#include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "utility/constants.h"
+
+namespace {
+
+using encrypto::motion::Backend;
+using encrypto::motion::BitVector;
+
+// registers the work of a party before the preprocessing and returns a function that consumes
+// its results after the setup phase
+using RegisterWork = std::function<std::function<void()>(std::size_t my_id, Backend& backend)>;
+
+enum class MeasuredPhase { kBaseOts, kSetup };
+
+struct Measurement {
+  double seconds{0};
+  // sent by both parties
+  std::size_t number_of_bytes{0};
+};
+
+template <typename Function>
+void RunForBothParties(Function function) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&function, party_id] {
+      function(party_id);
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+std::size_t GetNumberOfBytesSent(Backend& backend) {
+  std::size_t number_of_bytes{0};
+  for (const auto& statistics : backend.GetCommunicationLayer().GetTransportStatistics()) {
+    number_of_bytes += statistics.number_of_bytes_sent;
+  }
+  return number_of_bytes;
+}
+
+// Runs the preprocessing of two locally connected parties and measures either only the base OTs
+// or the OT extension, the setup of the MT, SP and SB providers and the consumption of the OTs.
+Measurement RunPreprocessing(const RegisterWork& register_work, MeasuredPhase measured_phase) {
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, 0)};
+  std::vector<std::function<void()>> consume_work(2);
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    parties.at(party_id)->GetLogger()->SetEnabled(false);
+    consume_work.at(party_id) = register_work(party_id, *parties.at(party_id)->GetBackend());
+  }
+
+  RunForBothParties([&](std::size_t party_id) {
+    auto& backend{*parties.at(party_id)->GetBackend()};
+    backend.GetBaseProvider().Setup();
+    if (backend.GetMtProvider().NeedMts()) backend.GetMtProvider().PreSetup();
+    if (backend.GetSbProvider().NeedSbs()) backend.GetSbProvider().PreSetup();
+    if (backend.GetSpProvider().NeedSps()) backend.GetSpProvider().PreSetup();
+    if (backend.GetKk13OtProviderManager().HasWork()) backend.GetKk13OtProviderManager().PreSetup();
+    if (backend.GetOtProviderManager().HasWork()) backend.GetOtProviderManager().PreSetup();
+    backend.GetBaseOtProvider().PreSetup();
+    backend.Synchronize();
+    if (measured_phase != MeasuredPhase::kBaseOts) backend.GetBaseOtProvider().ComputeBaseOts();
+  });
+
+  std::size_t number_of_bytes_before{0};
+  for (auto& party : parties) number_of_bytes_before += GetNumberOfBytesSent(*party->GetBackend());
+
+  const auto start{std::chrono::steady_clock::now()};
+  RunForBothParties([&](std::size_t party_id) {
+    auto& backend{*parties.at(party_id)->GetBackend()};
+    if (measured_phase == MeasuredPhase::kBaseOts) {
+      backend.GetBaseOtProvider().ComputeBaseOts();
+      return;
+    }
+    if (backend.GetOtProviderManager().HasWork() || backend.GetKk13OtProviderManager().HasWork()) {
+      backend.OtExtensionSetup();
+    }
+    auto mt_future{std::async(std::launch::async, [&] { backend.GetMtProvider().Setup(); })};
+    auto sp_future{std::async(std::launch::async, [&] { backend.GetSpProvider().Setup(); })};
+    auto sb_future{std::async(std::launch::async, [&] { backend.GetSbProvider().Setup(); })};
+    mt_future.get();
+    sp_future.get();
+    sb_future.get();
+    consume_work.at(party_id)();
+  });
+  const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+
+  Measurement measurement{duration.count(), 0};
+  for (auto& party : parties) {
+    measurement.number_of_bytes += GetNumberOfBytesSent(*party->GetBackend());
+  }
+  measurement.number_of_bytes -= number_of_bytes_before;
+
+  RunForBothParties([&](std::size_t party_id) { parties.at(party_id)->Finish(); });
+  return measurement;
+}
+
+// runs the benchmark loop and reports <item_name>sPerSecond and BytesPer<item_name>
+void RunBenchmark(benchmark::State& state, const RegisterWork& register_work,
+                  std::size_t number_of_items, const std::string& item_name,
+                  MeasuredPhase measured_phase = MeasuredPhase::kSetup) {
+  std::size_t number_of_bytes{0}, total_number_of_items{0};
+  for (auto _ : state) {
+    const auto measurement{RunPreprocessing(register_work, measured_phase)};
+    state.SetIterationTime(measurement.seconds);
+    number_of_bytes += measurement.number_of_bytes;
+    total_number_of_items += number_of_items;
+  }
+  state.counters[item_name + "sPerSecond"] =
+      benchmark::Counter(static_cast<double>(total_number_of_items), benchmark::Counter::kIsRate);
+  state.counters["BytesPer" + item_name] = benchmark::Counter(
+      static_cast<double>(number_of_bytes) / static_cast<double>(total_number_of_items));
+}
+
+// calls function(T{}) for the unsigned integer type T of bit_length bits
+template <typename Function>
+void DispatchBitLength(std::size_t bit_length, Function function) {
+  switch (bit_length) {
+    case 8:
+      return function(std::uint8_t{});
+    case 16:
+      return function(std::uint16_t{});
+    case 32:
+      return function(std::uint32_t{});
+    case 64:
+      return function(std::uint64_t{});
+    default:
+      throw std::invalid_argument("bit length needs to be 8, 16, 32 or 64");
+  }
+}
+
+encrypto::motion::OtProvider& GetOtProvider(std::size_t my_id, Backend& backend) {
+  return backend.GetOtProvider(1 - my_id);
+}
+
+void BM_BaseOts(benchmark::State& state) {
+  // a single OT triggers the base OTs in both directions
+  RegisterWork register_work = [](std::size_t my_id, Backend& backend) -> std::function<void()> {
+    if (my_id == 0) {
+      std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterSendROt(1, 1)};
+      return [ot] {};
+    }
+    std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterReceiveROt(1, 1)};
+    return [ot] {};
+  };
+  RunBenchmark(state, register_work, 2 * encrypto::motion::kKappa, "BaseOt",
+               MeasuredPhase::kBaseOts);
+}
+BENCHMARK(BM_BaseOts)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+void BM_ROt(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t my_id, Backend& backend) -> std::function<void()> {
+    if (my_id == 0) {
+      std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterSendROt(number_of_ots, bit_length)};
+      return [ot] { ot->ComputeOutputs(); };
+    }
+    std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterReceiveROt(number_of_ots, bit_length)};
+    return [ot] { ot->ComputeOutputs(); };
+  };
+  RunBenchmark(state, register_work, number_of_ots, "Ot");
+}
+
+void BM_XcOt(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t my_id, Backend& backend) -> std::function<void()> {
+    if (my_id == 0) {
+      std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterSendXcOt(number_of_ots, bit_length)};
+      return [=] {
+        ot->SetCorrelations(std::vector<BitVector<>>(number_of_ots, BitVector<>(bit_length)));
+        ot->SendMessages();
+        ot->ComputeOutputs();
+      };
+    }
+    std::shared_ptr ot{
+        GetOtProvider(my_id, backend).RegisterReceiveXcOt(number_of_ots, bit_length)};
+    return [=] {
+      ot->SetChoices(BitVector<>::SecureRandom(number_of_ots));
+      ot->SendCorrections();
+      ot->ComputeOutputs();
+    };
+  };
+  RunBenchmark(state, register_work, number_of_ots, "Ot");
+}
+
+void BM_AcOt(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t my_id, Backend& backend) {
+    std::function<void()> consume_work;
+    auto& ot_provider{GetOtProvider(my_id, backend)};
+    DispatchBitLength(bit_length, [&]<typename T>(T) {
+      if (my_id == 0) {
+        std::shared_ptr<encrypto::motion::AcOtSender<T>> ot{
+            dynamic_cast<encrypto::motion::AcOtSender<T>*>(
+                ot_provider.RegisterSendAcOt(number_of_ots, bit_length).release())};
+        consume_work = [=] {
+          ot->SetCorrelations(std::vector<T>(number_of_ots, T(0x42)));
+          ot->SendMessages();
+          ot->ComputeOutputs();
+        };
+      } else {
+        std::shared_ptr<encrypto::motion::AcOtReceiver<T>> ot{
+            dynamic_cast<encrypto::motion::AcOtReceiver<T>*>(
+                ot_provider.RegisterReceiveAcOt(number_of_ots, bit_length).release())};
+        consume_work = [=] {
+          ot->SetChoices(BitVector<>::SecureRandom(number_of_ots));
+          ot->SendCorrections();
+          ot->ComputeOutputs();
+        };
+      }
+    });
+    return consume_work;
+  };
+  RunBenchmark(state, register_work, number_of_ots, "Ot");
+}
+
+void BM_GOt(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t my_id, Backend& backend) -> std::function<void()> {
+    if (my_id == 0) {
+      std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterSendGOt(number_of_ots, bit_length)};
+      return [=] {
+        // both messages of an OT are concatenated
+        ot->SetInputs(std::vector<BitVector<>>(number_of_ots, BitVector<>(2 * bit_length)));
+        ot->SendMessages();
+      };
+    }
+    std::shared_ptr ot{GetOtProvider(my_id, backend).RegisterReceiveGOt(number_of_ots, bit_length)};
+    return [=] {
+      ot->SetChoices(BitVector<>::SecureRandom(number_of_ots));
+      ot->SendCorrections();
+      ot->ComputeOutputs();
+    };
+  };
+  RunBenchmark(state, register_work, number_of_ots, "Ot");
+}
+
+void OtArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->UseManualTime()->Unit(benchmark::kMillisecond)->ArgNames({"ots", "bits"});
+  for (std::int64_t number_of_ots : {1 << 12, 1 << 16, 1 << 20}) {
+    for (std::int64_t bit_length : {8, 64}) benchmark->Args({number_of_ots, bit_length});
+  }
+}
+BENCHMARK(BM_ROt)->Apply(OtArguments);
+BENCHMARK(BM_XcOt)->Apply(OtArguments);
+BENCHMARK(BM_AcOt)->Apply(OtArguments);
+BENCHMARK(BM_GOt)->Apply(OtArguments);
+
+void BM_Kk13ROt(benchmark::State& state) {
+  const std::size_t number_of_ots = state.range(0), number_of_messages = state.range(1);
+  constexpr std::size_t kBitLength{64};
+  RegisterWork register_work = [=](std::size_t my_id, Backend& backend) -> std::function<void()> {
+    auto& ot_provider{backend.GetKk13OtProvider(1 - my_id)};
+    if (my_id == 0) {
+      std::shared_ptr ot{
+          ot_provider.RegisterSendROt(number_of_ots, kBitLength, number_of_messages)};
+      return [ot] { ot->ComputeOutputs(); };
+    }
+    std::shared_ptr ot{
+        ot_provider.RegisterReceiveROt(number_of_ots, kBitLength, number_of_messages)};
+    return [ot] { ot->ComputeOutputs(); };
+  };
+  RunBenchmark(state, register_work, number_of_ots, "Ot");
+}
+BENCHMARK(BM_Kk13ROt)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->ArgNames({"ots", "messages"})
+    ->ArgsProduct({{1 << 12, 1 << 16}, {4, 16, 256}});
+
+void BM_BinaryMts(benchmark::State& state) {
+  const std::size_t number_of_mts = state.range(0);
+  RegisterWork register_work = [=](std::size_t, Backend& backend) -> std::function<void()> {
+    backend.GetMtProvider().RequestBinaryMts(number_of_mts);
+    return [] {};
+  };
+  RunBenchmark(state, register_work, number_of_mts, "Triple");
+}
+BENCHMARK(BM_BinaryMts)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->ArgNames({"mts"})
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20);
+
+void BM_ArithmeticMts(benchmark::State& state) {
+  const std::size_t number_of_mts = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t, Backend& backend) -> std::function<void()> {
+    DispatchBitLength(bit_length, [&]<typename T>(T) {
+      backend.GetMtProvider().RequestArithmeticMts<T>(number_of_mts);
+    });
+    return [] {};
+  };
+  RunBenchmark(state, register_work, number_of_mts, "Triple");
+}
+
+void BM_Sps(benchmark::State& state) {
+  const std::size_t number_of_sps = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t, Backend& backend) -> std::function<void()> {
+    DispatchBitLength(bit_length,
+                      [&]<typename T>(T) { backend.GetSpProvider().RequestSps<T>(number_of_sps); });
+    return [] {};
+  };
+  RunBenchmark(state, register_work, number_of_sps, "Sp");
+}
+
+void BM_Sbs(benchmark::State& state) {
+  const std::size_t number_of_sbs = state.range(0), bit_length = state.range(1);
+  RegisterWork register_work = [=](std::size_t, Backend& backend) -> std::function<void()> {
+    DispatchBitLength(bit_length,
+                      [&]<typename T>(T) { backend.GetSbProvider().RequestSbs<T>(number_of_sbs); });
+    return [] {};
+  };
+  RunBenchmark(state, register_work, number_of_sbs, "Sb");
+}
+
+void PerBitLengthArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->UseManualTime()
+      ->Unit(benchmark::kMillisecond)
+      ->ArgNames({"n", "bits"})
+      ->ArgsProduct({{1 << 12, 1 << 16}, {8, 16, 32, 64}});
+}
+BENCHMARK(BM_ArithmeticMts)->Apply(PerBitLengthArguments);
+BENCHMARK(BM_Sps)->Apply(PerBitLengthArguments);
+BENCHMARK(BM_Sbs)->Apply(PerBitLengthArguments);
+
+}  // namespace
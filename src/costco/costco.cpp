@@ -7,7 +7,7 @@
 #include <fmt/format.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
-#include <boost/algorithm/string.hpp>
+#include "algorithm/costco_circuit.h"
 #include "base/party.h"
 #include "communication/communication_layer.h"
 #include "communication/tcp_transport.h"
@@ -42,7 +42,8 @@ std::pair<program_options::variables_map, std::vector<bool>> ParseProgramOptions
   description.add_options()
       ("help,h", program_options::bool_switch(&help)->default_value(false),"produce help message")
       ("role,r", program_options::value<std::size_t>(), "Role: 0/1")
-      ("circuit-file,c", program_options::value<std::string>(), "circuit file")
+      ("circuit-file,c", program_options::value<std::string>(), "circuit file, in the text or in the binary format")
+      ("save-binary", program_options::value<std::string>(), "write the circuit in the binary format to this file, which loads faster")
       ("num-paral,n", program_options::value<uint32_t>()->default_value((uint32_t)1), "Number of parallel operation elements")
       ("num-round,i", program_options::value<uint32_t>()->default_value((uint32_t)10), "Number of rounds")
       ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,IP,port) for each party e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
@@ -99,161 +100,67 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
   return party;
 }
 
-mo::ShareWrapper CreateShare(mo::PartyPointer& party, std::size_t protocol, uint32_t input, uint32_t party_id) {
-  mo::ShareWrapper ret_share;
-  if(protocol == (std::size_t)0){
-    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kArithmeticGmw>(input, party_id));
-  } else if(protocol == (std::size_t)1){
-    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(input), party_id));
-  } else if(protocol == (std::size_t)2){
-    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kBmr>(mo::ToInput(input), party_id));
-  } else {
-    throw std::invalid_argument("Invalid MPC protocol");
+mo::MpcProtocol GetProtocol(std::size_t protocol) {
+  switch (protocol) {
+    case 0:
+      return mo::MpcProtocol::kArithmeticGmw;
+    case 1:
+      return mo::MpcProtocol::kBooleanGmw;
+    case 2:
+      return mo::MpcProtocol::kBmr;
+    default:
+      throw std::invalid_argument("Invalid MPC protocol");
   }
-  return ret_share;
 }
 
-uint32_t EvaluateCircuit(mo::PartyPointer& party, std::string circ_file_name, std::size_t role, std::size_t protocol, uint32_t nround, uint32_t nparal) {
-    // start
-    // read circuit file
-    std::vector<std::string> gates;
-	std::map<std::string, std::vector<std::string>> inputs;
-
-	std::ifstream circ_file;
-	circ_file.open(circ_file_name);
-	std::string line;
-	std::vector<std::string> tokens;
-	while (std::getline(circ_file, line)) {
-		if (boost::starts_with(line, "#")) {
-			continue;
-		}
-		boost::split(tokens, line, [](char c){return c == ' ';});
-		auto it = tokens.begin();
-		std::string curr_node = *it;
-		// std::cout << "curr_node: " << curr_node << std::endl;
-		gates.push_back(curr_node);
-		it++;
-		for (it; it != tokens.end(); it++){
-			inputs[*it].push_back(curr_node);
-			// std::cout << "*it: " << *it << std::endl;
-		}
-        // inputs["ADD_3"] = ["ADD_2", "INPUT0_0"]
-        // inputs["ADD_2"] = ["INPUT0_0", "INPUT1_1"]
-		// std::cout << "***end loop***" << std::endl << std::endl;
-		tokens.clear();
-	}
-	circ_file.close();
-
-    // generate circuit
-    std::map<std::string, mo::ShareWrapper> output_shares; // all gates that have output? output_shares["INPUT0_0"] -> INPUT0_0's output share
-	std::vector<mo::ShareWrapper> outputs;
-    srand(12345);
-    for (std::string g : gates) {
-        std::string g_type = g.substr(0, g.find("_")); // g = "INPUT0_0"
-        std::vector<std::string> input_gates = inputs[g]; // inputs["ADD_2"] = ["INPUT0_0", "INPUT1_1"]
-        if (g_type == "INPUT0") {
-            //uint32_t val = rand();
-            uint32_t val = 1;
-            output_shares[g] = CreateShare(party, protocol, val, (uint32_t)0);
-        } else if (g_type == "INPUT1") {
-            //uint32_t val = rand();
-            uint32_t val = 1;
-            output_shares[g] = CreateShare(party, protocol, val, (uint32_t)1);
-        } else if (g_type == "A2Y" || g_type == "B2Y") {
-            mo::ShareWrapper input = output_shares[input_gates[0]];
-            output_shares[g] = input.Convert<mo::MpcProtocol::kBmr>();
-        } else if (g_type == "A2B" || g_type == "Y2B") {
-            mo::ShareWrapper input = output_shares[input_gates[0]];
-            output_shares[g] = input.Convert<mo::MpcProtocol::kBooleanGmw>();
-        } else if (g_type == "B2A" || g_type == "Y2A") {
-            mo::ShareWrapper input = output_shares[input_gates[0]];
-            output_shares[g] = input.Convert<mo::MpcProtocol::kArithmeticGmw>();
-        } else if (g_type == "OUTPUT") {
-            mo::ShareWrapper input = output_shares[input_gates[0]];
-            std::string input_t = input_gates[0].substr(0, input_gates[0].find("_"));
-            output_shares[g] = input.Out();
-            outputs.push_back(output_shares[g]);
-        } else {
-            // if g = "ADD_2"
-            // input_gates = inputs["ADD_2"] = ["INPUT0_0", "INPUT1_1"]
-            // output_shares = {"INPUT0_0": ...; "INPUT1_1": ...}
-            mo::ShareWrapper input1 = output_shares[input_gates[0]]; //input1 = output_shares["INPUT0_0"]
-            mo::ShareWrapper input2 = output_shares[input_gates[1]]; //input2 = output_shares["INPUT1_1"]
-            if (g_type == "MUL") {
-                output_shares[g] = input1 * input2;
-            } else if (g_type == "ADD") {
-                output_shares[g] = input1 + input2;
-            } else if (g_type == "SUB") {
-                output_shares[g] = input1 - input2;
-            } else if (g_type == "DIV") {
-                output_shares[g] = input1 / input2;
-            } else if (g_type == "AND") {
-                output_shares[g] = input1 & input2;
-            } else if (g_type == "OR") {
-                output_shares[g] = input1 | input2;
-            } else if (g_type == "XOR") {
-                output_shares[g] = input1 ^ input2;
-            } else if (g_type == "GT") {
-                output_shares[g] = input1 > input2;
-            } else if (g_type == "LT") {
-                output_shares[g] = input2 > input1;
-            } else if (g_type == "GE") {
-                mo::ShareWrapper temp = input2 > input1;
-                output_shares[g] = ~temp;
-            } else if (g_type == "LE") {
-                mo::ShareWrapper temp = input1 > input2;
-                output_shares[g] = ~temp;
-            } else if (g_type == "EQ") {
-                output_shares[g] = input1 == input2;
-            } else if (g_type == "NE") {
-                output_shares[g] = ~(input1 == input2);
-            } 
-            // else if (g_type == "MUX") {
-            //     // do circuit files include 'MUX'?
-            // }  
-        }
-    }
-    // run circuit
-    party->Run();
-    party->Finish();
-    mo::AccumulatedRunTimeStatistics accumulated_statistics;
-    mo::AccumulatedCommunicationStatistics accumulated_communication_statistics;
-    const auto& statistics = party->GetBackend()->GetRunTimeStatistics();
-    accumulated_statistics.Add(statistics.front());
-    auto communication_statistics = party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
-    accumulated_communication_statistics.Add(communication_statistics);
-    std::cout << "output: " << std::endl;
-    for(mo::SecureUnsignedInteger x : outputs){
-        std::cout << x.As<std::uint32_t>() << std::endl;
-    }
-    std::cout << mo::PrintStatistics(fmt::format("op_name"), accumulated_statistics, accumulated_communication_statistics);
-    
-    output_shares.clear();
-	outputs.clear();
-    // end
-	return 0;
+// builds the circuit with the parallel elements as SIMD values, runs it and prints the outputs
+void EvaluateRound(mo::Party& party, const mo::CostcoCircuit& circuit, mo::MpcProtocol protocol,
+                   uint32_t nparal) {
+  std::vector<mo::ShareWrapper> outputs{circuit.Build(party, protocol, nparal)};
+  party.Run();
+  std::cout << "output: " << std::endl;
+  for (mo::SecureUnsignedInteger x : outputs) {
+    std::cout << x.As<std::uint32_t>() << std::endl;
+  }
 }
 
 int main(int ac, char* av[]) {
   try {
     auto [user_options, flag] = ParseProgramOptions(ac, av);
     if (flag[0]) return EXIT_SUCCESS;
-    const auto role{user_options["role"].as<std::size_t>()};
     const auto circuit_file{user_options["circuit-file"].as<std::string>()};
-    const auto protocol{user_options["circuit-protocol"].as<std::size_t>()};
+    const auto protocol{GetProtocol(user_options["circuit-protocol"].as<std::size_t>())};
     const auto nround{user_options["num-round"].as<uint32_t>()};
     const auto nparal{user_options["num-paral"].as<uint32_t>()};
+    // the graph is parsed once into dense gate ids, which all rounds build the circuit from
+    const auto circuit{mo::CostcoCircuit::FromFile(circuit_file)};
+    if (user_options.count("save-binary")) {
+      circuit.ToBinary(user_options["save-binary"].as<std::string>());
+    }
     // all inputs (in input gate) default to "1", no need for user inputs
+    encrypto::motion::PartyPointer party{CreateParty(user_options)};
     for (uint32_t r = 0; r < nround; r++) {
-        encrypto::motion::PartyPointer party{CreateParty(user_options)};
-        EvaluateCircuit(party, circuit_file, role, protocol, nround, nparal);
-        std::cout << "&party: " << &party << std::endl;
-        // delete &party;
+      // the connections and the base OTs are kept across the rounds
+      if (r > 0) party->Reset();
+      EvaluateRound(*party, circuit, protocol, nparal);
+    }
+    party->Finish();
+    mo::AccumulatedRunTimeStatistics accumulated_statistics;
+    mo::AccumulatedCommunicationStatistics accumulated_communication_statistics;
+    for (const auto& statistics : party->GetBackend()->GetRunTimeStatistics()) {
+      accumulated_statistics.Add(statistics);
     }
-    // delete party;
+    auto communication_statistics =
+        party->GetBackend()->GetCommunicationLayer().GetTransportStatistics();
+    accumulated_communication_statistics.Add(communication_statistics);
+    std::cout << mo::PrintStatistics(fmt::format("op_name"), accumulated_statistics,
+                                     accumulated_communication_statistics);
   } catch (std::runtime_error& e) {
     std::cerr << e.what() << "\n";
     return EXIT_FAILURE;
+  } catch (std::invalid_argument& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
   }
   return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -35,6 +35,7 @@
 #include "base/party.h"
 #include "common/benchmark_integers.h"
 #include "communication/communication_layer.h"
+#include "communication/network_emulation_transport.h"
 #include "communication/tcp_transport.h"
 #include "statistics/analysis.h"
 #include "utility/typedefs.h"
@@ -155,6 +156,9 @@ std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char
       ("my-id", program_options::value<std::size_t>(), "my party id")
       ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,IP,port) for each party e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
       ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
+      ("rtt", program_options::value<double>()->default_value(0), "emulated round trip time in milliseconds")
+      ("jitter", program_options::value<double>()->default_value(0), "emulated variation of the one-way delay in milliseconds")
+      ("bandwidth", program_options::value<double>()->default_value(0), "emulated bandwidth in Mbit/s, 0 means unlimited")
       ("repetitions", program_options::value<std::size_t>()->default_value(1), "number of repetitions");
   // clang-format on
 
@@ -230,8 +234,17 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
     parties_configuration.at(party_id) = std::make_pair(host, port);
   }
   encrypto::motion::communication::TcpSetupHelper helper(my_id, parties_configuration);
+  encrypto::motion::communication::NetworkEmulationConfiguration network_emulation_configuration;
+  network_emulation_configuration.round_trip_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration<double, std::milli>(user_options["rtt"].as<double>()));
+  network_emulation_configuration.jitter = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double, std::milli>(user_options["jitter"].as<double>()));
+  network_emulation_configuration.bandwidth = user_options["bandwidth"].as<double>() * 1e6;
+  auto transports{encrypto::motion::communication::EmulateNetwork(
+      helper.SetupConnections(), network_emulation_configuration)};
   auto communication_layer = std::make_unique<encrypto::motion::communication::CommunicationLayer>(
-      my_id, helper.SetupConnections());
+      my_id, std::move(transports));
   auto party = std::make_unique<encrypto::motion::Party>(std::move(communication_layer));
   auto configuration = party->GetConfiguration();
   // disable logging if the corresponding flag was set
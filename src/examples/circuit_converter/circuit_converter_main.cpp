@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/program_options.hpp>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_optimizer.h"
+
+namespace program_options = boost::program_options;
+
+encrypto::motion::AlgorithmDescription ReadCircuit(const std::string& path,
+                                                   const std::string& format);
+
+int main(int ac, char* av[]) {
+  try {
+    bool help;
+    program_options::options_description description("Allowed options");
+    // clang-format off
+    description.add_options()
+        ("help,h", program_options::bool_switch(&help)->default_value(false), "produce help message")
+        ("input,i", program_options::value<std::vector<std::string>>()->multitoken()->required(), "circuit files to convert")
+        ("format", program_options::value<std::string>()->default_value("bristol"), "format of the input circuits (bristol, bristol-fashion or aby)")
+        ("optimize", program_options::value<std::string>(), "optimize the circuits for the number of AND gates (size), e.g., for BMR, or for the AND depth (depth), e.g., for GMW")
+        ("output,o", program_options::value<std::string>(), "output file for a single input circuit, by default the input path with the extension .mbc, which is loaded by Register::GetCachedAlgorithmDescription");
+    // clang-format on
+
+    program_options::variables_map user_options;
+    program_options::store(program_options::parse_command_line(ac, av, description),
+                           user_options);
+    if (help) {
+      std::cout << description << "\n";
+      return EXIT_SUCCESS;
+    }
+    program_options::notify(user_options);
+
+    const auto inputs{user_options["input"].as<std::vector<std::string>>()};
+    const auto format{user_options["format"].as<std::string>()};
+    if (user_options.count("output") && inputs.size() != 1) {
+      throw std::invalid_argument("An output file can only be given for a single input circuit");
+    }
+
+    for (const auto& input : inputs) {
+      const auto output{user_options.count("output")
+                            ? user_options["output"].as<std::string>()
+                            : encrypto::motion::AlgorithmDescription::GetBinaryPath(input)};
+      auto algorithm_description{ReadCircuit(input, format)};
+      if (user_options.count("optimize")) {
+        const auto objective_string{user_options["optimize"].as<std::string>()};
+        if (objective_string != "size" && objective_string != "depth") {
+          throw std::invalid_argument(fmt::format("Unknown objective {}", objective_string));
+        }
+        const auto before{encrypto::motion::GetAlgorithmStatistics(algorithm_description)};
+        algorithm_description = encrypto::motion::OptimizeCircuit(
+            algorithm_description, objective_string == "size"
+                                       ? encrypto::motion::CircuitObjective::kSize
+                                       : encrypto::motion::CircuitObjective::kDepth);
+        const auto after{encrypto::motion::GetAlgorithmStatistics(algorithm_description)};
+        std::cout << fmt::format("Optimized {} from {} AND gates of depth {} to {} of depth {}",
+                                 input, before.number_of_and_gates, before.and_depth,
+                                 after.number_of_and_gates, after.and_depth)
+                  << std::endl;
+      }
+      algorithm_description.ToBinary(output);
+      std::cout << fmt::format("Converted {} with {} gates to {}", input,
+                               algorithm_description.gates.size(), output)
+                << std::endl;
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+encrypto::motion::AlgorithmDescription ReadCircuit(const std::string& path,
+                                                   const std::string& format) {
+  if (format == "bristol") {
+    return encrypto::motion::AlgorithmDescription::FromBristol(path);
+  } else if (format == "bristol-fashion") {
+    return encrypto::motion::AlgorithmDescription::FromBristolFashion(path);
+  } else if (format == "aby") {
+    return encrypto::motion::AlgorithmDescription::FromAby(path);
+  }
+  throw std::invalid_argument(fmt::format("Unknown circuit format {}", format));
+}
@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/format.h>
+#include <boost/program_options.hpp>
+
+#include "communication/tcp_transport.h"
+#include "trusted_dealer/trusted_dealer.h"
+
+namespace program_options = boost::program_options;
+
+// <variables map, help flag>
+std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char* av[]) {
+  bool help;
+  boost::program_options::options_description description("Allowed options");
+  // clang-format off
+  description.add_options()
+      ("help,h", program_options::bool_switch(&help)->default_value(false),"produce help message")
+      ("number-of-parties,n", program_options::value<std::size_t>(), "number of parties")
+      ("address,a", program_options::value<std::string>()->default_value("127.0.0.1"), "IP address to listen on")
+      ("port,p", program_options::value<std::uint16_t>(), "port to listen on")
+      ("once", "exit after the parties closed their connections instead of waiting for new ones");
+  // clang-format on
+
+  program_options::variables_map user_options;
+  program_options::store(program_options::parse_command_line(ac, av, description), user_options);
+  program_options::notify(user_options);
+
+  if (user_options["help"].as<bool>() || ac == 1) {
+    std::cout << description << "\n";
+    return std::make_pair<program_options::variables_map, bool>({}, true);
+  }
+  if (!user_options.count("number-of-parties")) {
+    throw std::runtime_error("Number of parties is not set but required");
+  }
+  if (!user_options.count("port")) {
+    throw std::runtime_error("Port is not set but required");
+  }
+  return std::make_pair(user_options, help);
+}
+
+int main(int ac, char* av[]) {
+  auto [user_options, help_flag] = ParseProgramOptions(ac, av);
+  if (help_flag) return EXIT_SUCCESS;
+
+  const auto number_of_parties{user_options["number-of-parties"].as<std::size_t>()};
+  const encrypto::motion::communication::TcpConnectionConfiguration bind_configuration{
+      user_options["address"].as<std::string>(), user_options["port"].as<std::uint16_t>()};
+  do {
+    std::cout << fmt::format("Waiting for {} parties on {}:{}", number_of_parties,
+                             bind_configuration.first, bind_configuration.second)
+              << std::endl;
+    encrypto::motion::TrustedDealer dealer(
+        encrypto::motion::communication::TcpAcceptParties(bind_configuration, number_of_parties));
+    try {
+      dealer.Run();
+    } catch (std::runtime_error& e) {
+      std::cerr << "Rejected the requests: " << e.what() << std::endl;
+    }
+  } while (!user_options.count("once"));
+  return EXIT_SUCCESS;
+}
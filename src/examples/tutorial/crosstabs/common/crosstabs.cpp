@@ -24,6 +24,7 @@
 
 #include <fstream>
 #include <span>
+#include "algorithm/group_by.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
@@ -39,17 +40,14 @@
  */
 struct Attributes {
   std::vector<std::uint32_t> cleartext_input;  // values for party_0 and categories for party_1.
-  std::vector<encrypto::motion::SecureUnsignedInteger> shared_input;
-  std::vector<encrypto::motion::SecureUnsignedInteger> id;
 } party_0, party_1;
 
 /**
  * Stores all the inputs needed for CrossTabsCircuit().
+ * Row i of values and categories, i.e., their SIMD value i, belongs to the same pseudonym.
  */
 struct CrossTabsContext {
-  Attributes party_0, party_1;
-  std::vector<encrypto::motion::SecureUnsignedInteger> categories, results;
-  encrypto::motion::ShareWrapper full_zero;
+  encrypto::motion::ShareWrapper values, categories;
   std::uint32_t number_of_bins;
 };
 
@@ -57,20 +55,7 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
     encrypto::motion::PartyPointer& party, std::uint32_t number_of_bins,
     std::span<const std::uint32_t> input_command_line, const std::string& input_file_path,
     bool print_output) {
-  /* Prepares some variables such as id (input index), results (zero vector as
-   * initialization), and categories. categories contains the number from 0 until number_of_bins-1.
-   * */
-  std::vector<std::uint32_t> id;
-  std::uint32_t zero = 0;
   auto party_id = party->GetConfiguration()->GetMyId();
-  std::vector<encrypto::motion::SecureUnsignedInteger> results(number_of_bins),
-      categories(number_of_bins);
-
-  for (std::uint32_t i = 0; i < number_of_bins; i++) {
-    results[i] = party->In<encrypto::motion::MpcProtocol::kArithmeticGmw>(zero, 0);
-    categories[i] =
-        party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(encrypto::motion::ToInput(i), 0);
-  }
 
   // Checks if there is no input from command line.
   if (input_command_line.empty()) {
@@ -79,10 +64,8 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
         GetFileInput(party_id, input_file_path, number_of_bins);
     party_0.cleartext_input = party_0_temp;
     party_1.cleartext_input = party_1_temp;
-    id = id_temp;
   } else {
     // Takes input as vector of integers from terminal.
-    id.reserve(input_command_line.size());
     for (std::uint32_t i = 0; i < input_command_line.size(); i++) {
       // Assigns real input to party and dummy input to the other party.
       if (party_id == 0) {
@@ -92,42 +75,26 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
         party_0.cleartext_input.push_back(input_command_line[i] % number_of_bins);
         party_1.cleartext_input.push_back(input_command_line[i] % number_of_bins);
       }
-      id.push_back(i);
     }
   }
 
-  /* Assigns input to its party.
+  /* Assigns input to its party, one SIMD value per row.
    * The same input will be used as a dummy input for the other party, but only the party with the
    * same id will really set the input.
    * */
-  for (std::size_t i = 0; i < party_0.cleartext_input.size(); i++) {
-    party_0.shared_input.push_back(
-        party->In<encrypto::motion::MpcProtocol::kArithmeticGmw>(party_0.cleartext_input[i], 0));
-    party_1.shared_input.push_back(party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
-        encrypto::motion::ToInput(party_1.cleartext_input[i]), 1));
-    party_0.id.push_back(
-        party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(encrypto::motion::ToInput(id[i]), 0));
-    party_1.id.push_back(
-        party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(encrypto::motion::ToInput(id[i]), 1));
-  }
-
-  /* Creates a ShareWrapper initialized with zeros that will be used in CreateCrossTabsCircuit()
-   * as a concatenation fill in.
-   * */
-  encrypto::motion::ShareWrapper full_zero = party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
-      encrypto::motion::BitVector<>(1, false), 0);
-
-  CrossTabsContext context = {party_0, party_1, categories, results, full_zero, number_of_bins};
-  std::vector<encrypto::motion::SecureUnsignedInteger> output = CreateCrossTabsCircuit(context);
+  encrypto::motion::ShareWrapper values = party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
+      encrypto::motion::ToInput(party_0.cleartext_input), 0);
+  encrypto::motion::ShareWrapper categories =
+      party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(
+          encrypto::motion::ToInput(party_1.cleartext_input), 1);
 
-  // Constructs an output gate for each bin.
-  for (std::size_t i = 0; i < output.size(); i++) output[i] = output[i].Out();
+  CrossTabsContext context = {values, categories, number_of_bins};
+  encrypto::motion::SecureUnsignedIntegerVector output = CreateCrossTabsCircuit(context).Out();
 
   party->Run();
 
   // Converts the outputs to integers.
-  std::vector<std::uint32_t> result;
-  for (auto each_output : output) result.push_back(each_output.As<std::uint32_t>());
+  const auto result = output.As<std::uint32_t>();
 
   if (print_output) {
     for (std::size_t i = 0; i < number_of_bins; i++) {
@@ -143,39 +110,14 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
 
 /**
  * Constructs the cross tabs of the given data in CrossTabsContext.
+ * The rows are grouped by their categories with an oblivious sort instead of comparing each row
+ * with each bin, see encrypto::motion::algorithm::GroupByCategories.
  * */
-std::vector<encrypto::motion::SecureUnsignedInteger> CreateCrossTabsCircuit(
-    CrossTabsContext context) {
-  auto party_0_id = context.party_0.id, party_0_values = context.party_0.shared_input,
-       party_1_id = context.party_1.id, party_1_categories = context.party_1.shared_input;
-  encrypto::motion::ShareWrapper id_match, bin_match;
-
-  for (std::size_t i = 0; i < party_0_id.size(); i++) {
-    for (std::size_t j = 0; j < party_1_id.size(); j++) {
-      id_match = (party_0_id[i] == party_1_id[j]);  // Checks if the indices are the same.
-      for (std::size_t k = 0; k < context.number_of_bins; k++) {
-        // Checks if the bins numbers are the same.
-        bin_match = (context.categories[k] == party_1_categories[j]);
-
-        // Checks if both binmatch and idmatch are 'true'.
-        encrypto::motion::ShareWrapper keep = bin_match & id_match;
-
-        // Concatenates keep so that it has the same length as party_0_values[i].
-        std::vector<encrypto::motion::ShareWrapper> keep_concat;
-        keep_concat.push_back(keep);
-        for (std::size_t i = 0; i < 31; i++) keep_concat.push_back(context.full_zero);
-        keep = encrypto::motion::ShareWrapper::Concatenate(keep_concat);
-
-        // Assigns party_0_values[i] in keep only if keep is 'true'.
-        keep = keep.Convert<encrypto::motion::MpcProtocol::kArithmeticGmw>();
-        keep = keep * party_0_values[i].Get();
-
-        // Adds keep to the result.
-        context.results[k] = context.results[k] + encrypto::motion::SecureUnsignedInteger(keep);
-      }
-    }
-  }
-  return context.results;
+encrypto::motion::SecureUnsignedIntegerVector CreateCrossTabsCircuit(
+    const CrossTabsContext& context) {
+  return encrypto::motion::algorithm::GroupByCategories(
+      context.categories, context.values, context.number_of_bins,
+      encrypto::motion::algorithm::AggregationType::kSum);
 }
 
 /**
@@ -24,7 +24,7 @@
 
 #include <span>
 #include "base/party.h"
-#include "secure_type/secure_unsigned_integer.h"
+#include "secure_type/secure_unsigned_integer_vector.h"
 #include "statistics/run_time_statistics.h"
 
 struct Attributes;
@@ -35,8 +35,8 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
     std::span<const std::uint32_t> input_command_line, const std::string& input_file_path,
     bool print_output);
 
-std::vector<encrypto::motion::SecureUnsignedInteger> CreateCrossTabsCircuit(
-    CrossTabsContext context);
+encrypto::motion::SecureUnsignedIntegerVector CreateCrossTabsCircuit(
+    const CrossTabsContext& context);
 
 std::tuple<std::vector<std::uint32_t>, std::vector<std::uint32_t>, std::vector<std::uint32_t>>
 GetFileInput(std::size_t party_id, const std::string& path, std::uint32_t number_of_bins);
@@ -101,6 +101,14 @@ encrypto::motion::RunTimeStatistics EvaluateProtocol(
  */
 encrypto::motion::SecureUnsignedInteger CreateInnerProductCircuit(
     encrypto::motion::SecureUnsignedInteger a, encrypto::motion::SecureUnsignedInteger b) {
+  // In arithmetic GMW, a single gate computes the inner product from a matrix triple and opens only
+  // the masked inputs instead of one multiplication triple per element.
+  if (a->GetProtocol() == encrypto::motion::MpcProtocol::kArithmeticGmw) {
+    std::vector<encrypto::motion::ShareWrapper> a_unsimdified = a.Get().Unsimdify();
+    std::vector<encrypto::motion::ShareWrapper> b_unsimdified = b.Get().Unsimdify();
+    return encrypto::motion::DotProduct(a_unsimdified, b_unsimdified);
+  }
+
   // Multiplies the values in a and b, that usually has more than one SIMD values, simultaneously.
   encrypto::motion::SecureUnsignedInteger mult = a * b;
 
@@ -1,7 +0,0 @@
-#include "../common/common.h"
-
-encrypto::motion::ShareWrapper CreateOPCircuit(
-    encrypto::motion::ShareWrapper a, encrypto::motion::ShareWrapper b, 
-    encrypto::motion::PartyPointer& party, encrypto::motion::MpcProtocol protocol) {
-  return a & b;
-}
\ No newline at end of file
@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "micro_benchmarks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <boost/math/distributions/students_t.hpp>
+
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "secure_type/secure_unsigned_integer.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using P = MpcProtocol;
+
+struct Operation {
+  std::string name;
+  // protocols of the inputs in which the operation is implemented
+  std::vector<MpcProtocol> protocols;
+  std::function<ShareWrapper(const ShareWrapper& a, const ShareWrapper& b,
+                             const ShareWrapper& selection)>
+      build;
+  bool needs_selection{false};
+};
+
+const std::vector<MpcProtocol> kAllProtocols{P::kArithmeticGmw, P::kBooleanGmw, P::kBmr,
+                                             P::kGarbledCircuit};
+const std::vector<MpcProtocol> kBooleanProtocols{P::kBooleanGmw, P::kBmr, P::kGarbledCircuit};
+
+template <MpcProtocol Target>
+Operation MakeConversion(std::string name, MpcProtocol source) {
+  return {std::move(name),
+          {source},
+          [](const ShareWrapper& a, const ShareWrapper&, const ShareWrapper&) {
+            return a.Convert<Target>();
+          }};
+}
+
+const std::vector<Operation>& GetOperations() {
+  using U = SecureUnsignedInteger;
+  static const std::vector<Operation> kOperations{
+      {"add", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return (U(a) + U(b)).Get(); }},
+      {"sub", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return (U(a) - U(b)).Get(); }},
+      {"mul", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return (U(a) * U(b)).Get(); }},
+      {"div", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return (U(a) / U(b)).Get(); }},
+      {"gt", kAllProtocols, [](const auto& a, const auto& b, const auto&) { return U(a) > U(b); }},
+      {"ge", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return ~(U(b) > U(a)); }},
+      {"lt", kAllProtocols, [](const auto& a, const auto& b, const auto&) { return U(b) > U(a); }},
+      {"le", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return ~(U(a) > U(b)); }},
+      {"eq", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return U(a) == U(b); }},
+      {"ne", kAllProtocols,
+       [](const auto& a, const auto& b, const auto&) { return ~(U(a) == U(b)); }},
+      {"and", kBooleanProtocols, [](const auto& a, const auto& b, const auto&) { return a & b; }},
+      {"or", kBooleanProtocols, [](const auto& a, const auto& b, const auto&) { return a | b; }},
+      {"xor", kBooleanProtocols, [](const auto& a, const auto& b, const auto&) { return a ^ b; }},
+      {"inv", kBooleanProtocols, [](const auto& a, const auto&, const auto&) { return ~a; }},
+      {"mux", kBooleanProtocols,
+       [](const auto& a, const auto& b, const auto& selection) { return selection.Mux(a, b); },
+       true},
+      MakeConversion<P::kBooleanGmw>("a2b", P::kArithmeticGmw),
+      MakeConversion<P::kBmr>("a2y", P::kArithmeticGmw),
+      MakeConversion<P::kGarbledCircuit>("a2g", P::kArithmeticGmw),
+      MakeConversion<P::kArithmeticGmw>("b2a", P::kBooleanGmw),
+      MakeConversion<P::kBmr>("b2y", P::kBooleanGmw),
+      MakeConversion<P::kGarbledCircuit>("b2g", P::kBooleanGmw),
+      MakeConversion<P::kArithmeticGmw>("y2a", P::kBmr),
+      MakeConversion<P::kBooleanGmw>("y2b", P::kBmr),
+      MakeConversion<P::kArithmeticGmw>("g2a", P::kGarbledCircuit),
+      MakeConversion<P::kBooleanGmw>("g2b", P::kGarbledCircuit),
+  };
+  return kOperations;
+}
+
+const Operation* FindOperation(const std::string& name) {
+  const auto& operations{GetOperations()};
+  const auto iterator{
+      std::find_if(operations.begin(), operations.end(),
+                   [&name](const auto& operation) { return operation.name == name; })};
+  return iterator == operations.end() ? nullptr : &*iterator;
+}
+
+bool UsesGarbledCircuit(const std::string& operation, MpcProtocol protocol) {
+  return protocol == P::kGarbledCircuit || operation.ends_with("2g");
+}
+
+template <typename T>
+ShareWrapper CreateInput(Party& party, MpcProtocol protocol, const std::vector<T>& values,
+                         std::size_t input_owner) {
+  switch (protocol) {
+    case P::kArithmeticGmw:
+      return party.In<P::kArithmeticGmw>(values, input_owner);
+    case P::kBooleanGmw:
+      return party.In<P::kBooleanGmw>(ToInput<T>(values), input_owner);
+    case P::kBmr:
+      return party.In<P::kBmr>(ToInput<T>(values), input_owner);
+    case P::kGarbledCircuit:
+      return party.In<P::kGarbledCircuit>(ToInput<T>(values), input_owner);
+    default:
+      throw std::invalid_argument(
+          fmt::format("Micro benchmarks are not implemented for {}", to_string(protocol)));
+  }
+}
+
+ShareWrapper CreateSelection(Party& party, MpcProtocol protocol, BitVector<>&& values) {
+  std::vector<BitVector<>> input{std::move(values)};
+  switch (protocol) {
+    case P::kBooleanGmw:
+      return party.In<P::kBooleanGmw>(std::move(input), 0);
+    case P::kBmr:
+      return party.In<P::kBmr>(std::move(input), 0);
+    case P::kGarbledCircuit:
+      return party.In<P::kGarbledCircuit>(std::move(input), 0);
+    default:
+      throw std::invalid_argument(
+          fmt::format("Selection bits are not implemented for {}", to_string(protocol)));
+  }
+}
+
+template <typename T>
+void CreateCircuit(Party& party, const MicroBenchmark& benchmark, const Operation& operation,
+                   std::uint32_t seed) {
+  // every party draws the same values, only the ones of the input owners are used
+  std::mt19937_64 random_engine(seed);
+  const auto draw{[&random_engine, &benchmark] {
+    std::vector<T> values(benchmark.number_of_simd);
+    std::generate(values.begin(), values.end(),
+                  [&random_engine] { return static_cast<T>(random_engine()); });
+    return values;
+  }};
+  const auto values_a{draw()};
+  auto values_b{draw()};
+  // the divisors are non-zero
+  for (auto& value : values_b) value |= T(1);
+  const ShareWrapper a{CreateInput(party, benchmark.protocol, values_a, 0)};
+  const ShareWrapper b{CreateInput(party, benchmark.protocol, values_b, 1)};
+  ShareWrapper selection;
+  if (operation.needs_selection) {
+    BitVector<> selection_bits(benchmark.number_of_simd);
+    for (std::size_t i = 0; i < selection_bits.GetSize(); ++i) {
+      selection_bits.Set(random_engine() & 1, i);
+    }
+    selection = CreateSelection(party, benchmark.protocol, std::move(selection_bits));
+  }
+  operation.build(a, b, selection).Out();
+}
+
+}  // namespace
+
+std::string to_string(const MicroBenchmark& benchmark) {
+  return fmt::format("{} {} {}-bit SIMD {} {} parties", benchmark.operation,
+                     to_string(benchmark.protocol), benchmark.bit_size, benchmark.number_of_simd,
+                     benchmark.number_of_parties);
+}
+
+const std::vector<std::string>& GetMicroBenchmarkOperations() {
+  static const std::vector<std::string> kNames{[] {
+    std::vector<std::string> names;
+    for (const auto& operation : GetOperations()) names.push_back(operation.name);
+    return names;
+  }()};
+  return kNames;
+}
+
+bool IsSupported(const MicroBenchmark& benchmark) {
+  const auto operation{FindOperation(benchmark.operation)};
+  if (operation == nullptr || benchmark.number_of_simd == 0 || benchmark.number_of_parties < 2) {
+    return false;
+  }
+  if (std::find(operation->protocols.begin(), operation->protocols.end(), benchmark.protocol) ==
+      operation->protocols.end()) {
+    return false;
+  }
+  // the garbled circuit protocol is a two-party protocol
+  if (UsesGarbledCircuit(benchmark.operation, benchmark.protocol) &&
+      benchmark.number_of_parties != 2) {
+    return false;
+  }
+  return benchmark.bit_size == 8 || benchmark.bit_size == 16 || benchmark.bit_size == 32 ||
+         benchmark.bit_size == 64;
+}
+
+void CreateMicroBenchmarkCircuit(Party& party, const MicroBenchmark& benchmark,
+                                 std::uint32_t seed) {
+  if (!IsSupported(benchmark)) {
+    throw std::invalid_argument(
+        fmt::format("Unsupported micro benchmark {}", to_string(benchmark)));
+  }
+  const auto& operation{*FindOperation(benchmark.operation)};
+  switch (benchmark.bit_size) {
+    case 8:
+      return CreateCircuit<std::uint8_t>(party, benchmark, operation, seed);
+    case 16:
+      return CreateCircuit<std::uint16_t>(party, benchmark, operation, seed);
+    case 32:
+      return CreateCircuit<std::uint32_t>(party, benchmark, operation, seed);
+    default:
+      return CreateCircuit<std::uint64_t>(party, benchmark, operation, seed);
+  }
+}
+
+ConfidenceInterval ComputeConfidenceInterval(const std::vector<double>& samples,
+                                             double confidence) {
+  if (samples.empty()) {
+    throw std::invalid_argument("Cannot compute a confidence interval of no samples");
+  }
+  if (!(confidence > 0 && confidence < 1)) {
+    throw std::invalid_argument(fmt::format("Invalid confidence level {}", confidence));
+  }
+  const auto n{static_cast<double>(samples.size())};
+  const double mean{std::accumulate(samples.begin(), samples.end(), 0.0) / n};
+  if (samples.size() == 1) return {mean, mean, mean};
+  double sum_of_squares{0};
+  for (const auto sample : samples) sum_of_squares += (sample - mean) * (sample - mean);
+  // corrected standard deviation of the samples
+  const double standard_deviation{std::sqrt(sum_of_squares / (n - 1))};
+  const boost::math::students_t distribution(n - 1);
+  const double t{
+      boost::math::quantile(boost::math::complement(distribution, (1 - confidence) / 2))};
+  const double half_width{t * standard_deviation / std::sqrt(n)};
+  return {mean, mean - half_width, mean + half_width};
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,77 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+class Party;
+
+/// \brief One entry of the matrix evaluated by the micro benchmark driver.
+struct MicroBenchmark {
+  // one of GetMicroBenchmarkOperations
+  std::string operation;
+  // protocol of the inputs, conversions start in it
+  MpcProtocol protocol{MpcProtocol::kInvalid};
+  std::size_t bit_size{0};
+  std::size_t number_of_simd{0};
+  std::size_t number_of_parties{0};
+};
+
+std::string to_string(const MicroBenchmark& benchmark);
+
+/// \returns the names of the benchmarked operations, e.g., "add", "gt" or "a2y"
+const std::vector<std::string>& GetMicroBenchmarkOperations();
+
+/// \returns whether \p benchmark names an operation that is implemented in its protocol for its
+///          bit size and number of parties, the matrix of the driver skips the other entries
+bool IsSupported(const MicroBenchmark& benchmark);
+
+/// \brief Builds the circuit of \p benchmark in \p party, i.e., random inputs of party 0 and
+///        party 1, the operation, and the output of the result to all parties.  All parties need
+///        to build the circuit with the same \p seed.
+/// \throws std::invalid_argument if \p benchmark is not supported
+void CreateMicroBenchmarkCircuit(Party& party, const MicroBenchmark& benchmark,
+                                 std::uint32_t seed);
+
+/// \brief Two-sided confidence interval of the mean of a sample.
+struct ConfidenceInterval {
+  double mean{0};
+  double lower{0};
+  double upper{0};
+};
+
+/// \brief Uses Student's t-distribution, i.e., assumes normally distributed samples.  A single
+///        sample yields an interval containing only its value.
+/// \throws std::invalid_argument if \p samples is empty or \p confidence is not in (0, 1)
+ConfidenceInterval ComputeConfidenceInterval(const std::vector<double>& samples, double confidence);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,396 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <regex>
+#include <sstream>
+
+#include <fmt/format.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/json.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+
+#include "base/party.h"
+#include "common/micro_benchmarks.h"
+#include "communication/communication_layer.h"
+#include "communication/dummy_transport.h"
+#include "communication/network_emulation_transport.h"
+#include "communication/tcp_transport.h"
+#include "statistics/analysis.h"
+#include "statistics/run_time_statistics.h"
+#include "utility/typedefs.h"
+
+namespace mo = encrypto::motion;
+namespace program_options = boost::program_options;
+
+namespace {
+
+const std::regex kPartyArgumentRegex("(\\d+),([^,]+),(\\d{1,5})");
+
+std::tuple<std::size_t, std::string, std::uint16_t> ParsePartyArgument(
+    const std::string& party_argument) {
+  std::smatch match;
+  if (!std::regex_match(party_argument, match, kPartyArgumentRegex)) {
+    throw std::runtime_error("Incorrect party argument syntax " + party_argument);
+  }
+  auto id = boost::lexical_cast<std::size_t>(match[1]);
+  auto host = match[2];
+  auto port = boost::lexical_cast<std::uint16_t>(match[3]);
+  return {id, host, port};
+}
+
+mo::MpcProtocol ParseProtocol(const std::string& protocol) {
+  if (protocol == "a") return mo::MpcProtocol::kArithmeticGmw;
+  if (protocol == "b") return mo::MpcProtocol::kBooleanGmw;
+  if (protocol == "y") return mo::MpcProtocol::kBmr;
+  if (protocol == "g") return mo::MpcProtocol::kGarbledCircuit;
+  throw std::invalid_argument(fmt::format("Unknown protocol {}, expected a, b, y or g", protocol));
+}
+
+// <variables map, help flag>
+std::pair<program_options::variables_map, bool> ParseProgramOptions(int ac, char* av[]) {
+  using namespace std::string_view_literals;
+  constexpr std::string_view kConfigFileMessage =
+      "configuration file, other arguments will overwrite the parameters read from the configuration file"sv;
+  bool help;
+  program_options::options_description description("Allowed options");
+  // clang-format off
+  description.add_options()
+      ("help,h", program_options::bool_switch(&help)->default_value(false),"produce help message")
+      ("disable-logging,l","disable logging to file")
+      ("configuration-file,f", program_options::value<std::string>(), kConfigFileMessage.data())
+      ("my-id", program_options::value<std::size_t>(), "my party id, evaluates all parties in this process if not set")
+      ("parties", program_options::value<std::vector<std::string>>()->multitoken(), "info (id,host,port) for each party if --my-id is set, e.g., --parties 0,127.0.0.1,23000 1,127.0.0.1,23001")
+      ("operations", program_options::value<std::vector<std::string>>()->multitoken(), "operations to benchmark, all if not set")
+      ("protocols", program_options::value<std::vector<std::string>>()->multitoken()->default_value({"a", "b", "y", "g"}, "a b y g"), "protocols of the inputs, a (arithmetic GMW), b (Boolean GMW), y (BMR) or g (garbled circuit)")
+      ("bit-lengths", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({32}, "32"), "bit lengths of the inputs, 8, 16, 32 or 64")
+      ("simd", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({1}, "1"), "numbers of SIMD values")
+      ("number-of-parties", program_options::value<std::vector<std::size_t>>()->multitoken()->default_value({2}, "2"), "numbers of parties, only the number of --parties is used if --my-id is set")
+      ("warm-up", program_options::value<std::size_t>()->default_value(1), "number of discarded evaluations before the repetitions of each benchmark")
+      ("repetitions", program_options::value<std::size_t>()->default_value(10), "number of repetitions of each benchmark")
+      ("confidence", program_options::value<double>()->default_value(0.95), "confidence level of the reported intervals")
+      ("seed", program_options::value<std::uint32_t>()->default_value(0), "seed of the random inputs, must be equal in all parties")
+      ("csv", program_options::value<std::string>(), "write one line per benchmark to this CSV file")
+      ("json", program_options::value<std::string>(), "write the statistics of all benchmarks to this JSON file")
+      ("verbose,v", "print the full statistics of each benchmark")
+      ("online-after-setup", program_options::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
+      ("insecure-fake-preprocessing", program_options::value<std::uint64_t>(), "INSECURE: generate the MTs, SPs, SBs and OTs locally from this seed to benchmark the online phase only, must be equal in all parties")
+      ("rtt", program_options::value<double>()->default_value(0), "emulated round trip time in milliseconds")
+      ("jitter", program_options::value<double>()->default_value(0), "emulated variation of the one-way delay in milliseconds")
+      ("bandwidth", program_options::value<double>()->default_value(0), "emulated bandwidth in Mbit/s, 0 means unlimited");
+  // clang-format on
+
+  program_options::variables_map user_options;
+
+  program_options::store(program_options::parse_command_line(ac, av, description), user_options);
+  program_options::notify(user_options);
+
+  if (help) {
+    std::cout << description << "\n";
+    return std::make_pair<program_options::variables_map, bool>({}, true);
+  }
+
+  // read configuration file
+  if (user_options.count("configuration-file")) {
+    std::ifstream ifs(user_options["configuration-file"].as<std::string>().c_str());
+    program_options::store(program_options::parse_config_file(ifs, description), user_options);
+    program_options::notify(user_options);
+  }
+
+  if (user_options.count("my-id") && !user_options.count("parties")) {
+    throw std::runtime_error("Other parties' information is not set but required with --my-id");
+  }
+  const auto confidence{user_options["confidence"].as<double>()};
+  if (!(confidence > 0 && confidence < 1)) {
+    throw std::runtime_error(fmt::format("Confidence level {} is not in (0, 1)", confidence));
+  }
+  return std::make_pair(user_options, help);
+}
+
+mo::communication::NetworkEmulationConfiguration GetNetworkEmulationConfiguration(
+    const program_options::variables_map& user_options) {
+  mo::communication::NetworkEmulationConfiguration configuration;
+  configuration.round_trip_time = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double, std::milli>(user_options["rtt"].as<double>()));
+  configuration.jitter = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double, std::milli>(user_options["jitter"].as<double>()));
+  configuration.bandwidth = user_options["bandwidth"].as<double>() * 1e6;
+  return configuration;
+}
+
+mo::PartyPointer MakeParty(std::unique_ptr<mo::communication::CommunicationLayer> layer,
+                           const program_options::variables_map& user_options) {
+  auto party = std::make_unique<mo::Party>(std::move(layer));
+  auto configuration = party->GetConfiguration();
+  configuration->SetLoggingEnabled(!user_options.count("disable-logging"));
+  configuration->SetOnlineAfterSetup(user_options["online-after-setup"].as<bool>());
+  if (user_options.count("insecure-fake-preprocessing")) {
+    configuration->SetInsecureFakePreprocessing(
+        user_options["insecure-fake-preprocessing"].as<std::uint64_t>());
+  }
+  return party;
+}
+
+std::vector<mo::PartyPointer> CreateLocalParties(
+    std::size_t number_of_parties, const program_options::variables_map& user_options) {
+  std::vector<std::vector<std::unique_ptr<mo::communication::Transport>>> transports(
+      number_of_parties);
+  for (auto& party_transports : transports) party_transports.resize(number_of_parties);
+  for (std::size_t i = 0; i + 1 < number_of_parties; ++i) {
+    for (std::size_t j = i + 1; j < number_of_parties; ++j) {
+      auto [transport_ij, transport_ji] = mo::communication::DummyTransport::MakeTransportPair();
+      transports[i][j] = std::move(transport_ij);
+      transports[j][i] = std::move(transport_ji);
+    }
+  }
+  const auto network_emulation_configuration{GetNetworkEmulationConfiguration(user_options)};
+  std::vector<mo::PartyPointer> parties;
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    parties.emplace_back(MakeParty(
+        std::make_unique<mo::communication::CommunicationLayer>(
+            party_id, mo::communication::EmulateNetwork(std::move(transports[party_id]),
+                                                        network_emulation_configuration)),
+        user_options));
+  }
+  return parties;
+}
+
+mo::PartyPointer CreateTcpParty(const program_options::variables_map& user_options) {
+  const auto parties_string{user_options["parties"].as<std::vector<std::string>>()};
+  const auto number_of_parties{parties_string.size()};
+  const auto my_id{user_options["my-id"].as<std::size_t>()};
+  if (my_id >= number_of_parties) {
+    throw std::runtime_error(fmt::format(
+        "My id needs to be in the range [0, #parties - 1], current my id is {} and #parties is {}",
+        my_id, number_of_parties));
+  }
+  mo::communication::TcpPartiesConfiguration parties_configuration(number_of_parties);
+  for (const auto& party_string : parties_string) {
+    const auto [party_id, host, port] = ParsePartyArgument(party_string);
+    if (party_id >= number_of_parties) {
+      throw std::runtime_error(
+          fmt::format("Party's id needs to be in the range [0, #parties - 1], current id "
+                      "is {} and #parties is {}",
+                      party_id, number_of_parties));
+    }
+    parties_configuration.at(party_id) = std::make_pair(host, port);
+  }
+  mo::communication::TcpSetupHelper helper(my_id, parties_configuration);
+  auto transports{mo::communication::EmulateNetwork(
+      helper.SetupConnections(), GetNetworkEmulationConfiguration(user_options))};
+  return MakeParty(std::make_unique<mo::communication::CommunicationLayer>(my_id,
+                                                                           std::move(transports)),
+                   user_options);
+}
+
+struct Evaluation {
+  mo::RunTimeStatistics run_time_statistics;
+  std::vector<mo::communication::TransportStatistics> communication_statistics;
+};
+
+Evaluation Evaluate(mo::Party& party, const mo::MicroBenchmark& benchmark, std::uint32_t seed) {
+  mo::CreateMicroBenchmarkCircuit(party, benchmark, seed);
+  party.Run();
+  party.Finish();
+  return {party.GetBackend()->GetRunTimeStatistics().front(),
+          party.GetBackend()->GetCommunicationLayer().GetTransportStatistics()};
+}
+
+// evaluates all parties in this process and returns the statistics of party 0, or only this party
+Evaluation EvaluateOnce(const mo::MicroBenchmark& benchmark,
+                        const program_options::variables_map& user_options, std::uint32_t seed) {
+  if (user_options.count("my-id")) {
+    auto party{CreateTcpParty(user_options)};
+    return Evaluate(*party, benchmark, seed);
+  }
+  auto parties{CreateLocalParties(benchmark.number_of_parties, user_options)};
+  std::vector<std::future<Evaluation>> futures;
+  for (auto& party : parties) {
+    futures.emplace_back(std::async(std::launch::async, [&party, &benchmark, seed] {
+      return Evaluate(*party, benchmark, seed);
+    }));
+  }
+  std::vector<Evaluation> evaluations;
+  for (auto& future : futures) evaluations.emplace_back(future.get());
+  return std::move(evaluations.front());
+}
+
+constexpr std::array kIntervalIds{
+    mo::RunTimeStatistics::StatisticsId::kPreprocessing,
+    mo::RunTimeStatistics::StatisticsId::kGatesSetup,
+    mo::RunTimeStatistics::StatisticsId::kGatesOnline,
+    mo::RunTimeStatistics::StatisticsId::kEvaluate};
+constexpr std::array kIntervalNames{"preprocessing", "gates_setup", "gates_online", "evaluate"};
+
+struct Result {
+  mo::MicroBenchmark benchmark;
+  mo::AccumulatedRunTimeStatistics run_time_statistics;
+  mo::AccumulatedCommunicationStatistics communication_statistics;
+  // in milliseconds, by kIntervalIds
+  std::array<mo::ConfidenceInterval, kIntervalIds.size()> intervals;
+  std::size_t number_of_bytes_sent{0};
+  std::size_t number_of_messages_sent{0};
+};
+
+Result RunBenchmark(const mo::MicroBenchmark& benchmark,
+                    const program_options::variables_map& user_options) {
+  const auto seed{user_options["seed"].as<std::uint32_t>()};
+  for (std::size_t i = 0; i < user_options["warm-up"].as<std::size_t>(); ++i) {
+    EvaluateOnce(benchmark, user_options, seed);
+  }
+  Result result{.benchmark = benchmark};
+  std::array<std::vector<double>, kIntervalIds.size()> samples;
+  const auto repetitions{user_options["repetitions"].as<std::size_t>()};
+  for (std::size_t i = 0; i < repetitions; ++i) {
+    const auto evaluation{EvaluateOnce(benchmark, user_options, seed)};
+    result.run_time_statistics.Add(evaluation.run_time_statistics);
+    result.communication_statistics.Add(evaluation.communication_statistics);
+    for (std::size_t j = 0; j < kIntervalIds.size(); ++j) {
+      const auto& [start, end] = evaluation.run_time_statistics.Get(kIntervalIds[j]);
+      samples[j].push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    for (const auto& statistics : evaluation.communication_statistics) {
+      result.number_of_bytes_sent += statistics.number_of_bytes_sent;
+      result.number_of_messages_sent += statistics.number_of_messages_sent;
+    }
+  }
+  const auto confidence{user_options["confidence"].as<double>()};
+  for (std::size_t j = 0; j < kIntervalIds.size(); ++j) {
+    result.intervals[j] = mo::ComputeConfidenceInterval(samples[j], confidence);
+  }
+  // per repetition
+  result.number_of_bytes_sent /= repetitions;
+  result.number_of_messages_sent /= repetitions;
+  return result;
+}
+
+void WriteCsv(std::ostream& stream, const std::vector<Result>& results) {
+  stream << "operation,protocol,bit_size,number_of_simd,number_of_parties";
+  for (const auto name : kIntervalNames) {
+    stream << fmt::format(",{0}_mean_ms,{0}_ci_lower_ms,{0}_ci_upper_ms", name);
+  }
+  stream << ",bytes_sent,messages_sent\n";
+  for (const auto& result : results) {
+    const auto& benchmark{result.benchmark};
+    stream << fmt::format("{},{},{},{},{}", benchmark.operation, mo::to_string(benchmark.protocol),
+                          benchmark.bit_size, benchmark.number_of_simd,
+                          benchmark.number_of_parties);
+    for (const auto& interval : result.intervals) {
+      stream << fmt::format(",{},{},{}", interval.mean, interval.lower, interval.upper);
+    }
+    stream << fmt::format(",{},{}\n", result.number_of_bytes_sent, result.number_of_messages_sent);
+  }
+}
+
+boost::json::array ToJson(const std::vector<Result>& results) {
+  boost::json::array json;
+  for (const auto& result : results) {
+    const auto& benchmark{result.benchmark};
+    boost::json::object intervals;
+    for (std::size_t j = 0; j < kIntervalIds.size(); ++j) {
+      const auto& interval{result.intervals[j]};
+      intervals[kIntervalNames[j]] = {
+          {"mean_ms", interval.mean}, {"lower_ms", interval.lower}, {"upper_ms", interval.upper}};
+    }
+    json.emplace_back(boost::json::object{
+        {"operation", benchmark.operation},
+        {"protocol", mo::to_string(benchmark.protocol)},
+        {"bit_size", benchmark.bit_size},
+        {"number_of_simd", benchmark.number_of_simd},
+        {"number_of_parties", benchmark.number_of_parties},
+        {"confidence_intervals", std::move(intervals)},
+        {"run_time", result.run_time_statistics.ToJson()},
+        {"communication", result.communication_statistics.ToJson()}});
+  }
+  return json;
+}
+
+}  // namespace
+
+int main(int ac, char* av[]) {
+  auto [user_options, help_flag] = ParseProgramOptions(ac, av);
+  // if help flag is set - print allowed command line arguments and exit
+  if (help_flag) return EXIT_SUCCESS;
+
+  const auto operations{user_options.count("operations")
+                            ? user_options["operations"].as<std::vector<std::string>>()
+                            : mo::GetMicroBenchmarkOperations()};
+  std::vector<mo::MpcProtocol> protocols;
+  for (const auto& protocol : user_options["protocols"].as<std::vector<std::string>>()) {
+    protocols.push_back(ParseProtocol(protocol));
+  }
+  // in the distributed mode, the number of parties is given by --parties
+  const auto numbers_of_parties{
+      user_options.count("my-id")
+          ? std::vector<std::size_t>{user_options["parties"].as<std::vector<std::string>>().size()}
+          : user_options["number-of-parties"].as<std::vector<std::size_t>>()};
+
+  std::vector<mo::MicroBenchmark> benchmarks;
+  // operation x protocol x bit length x SIMD x number of parties, unsupported entries are skipped
+  for (const auto& operation : operations) {
+    for (const auto protocol : protocols) {
+      for (const auto bit_size : user_options["bit-lengths"].as<std::vector<std::size_t>>()) {
+        for (const auto number_of_simd : user_options["simd"].as<std::vector<std::size_t>>()) {
+          for (const auto number_of_parties : numbers_of_parties) {
+            mo::MicroBenchmark benchmark{operation, protocol, bit_size, number_of_simd,
+                                         number_of_parties};
+            if (mo::IsSupported(benchmark)) benchmarks.push_back(std::move(benchmark));
+          }
+        }
+      }
+    }
+  }
+  if (benchmarks.empty()) {
+    std::cerr << "None of the selected benchmarks is supported\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Result> results;
+  for (const auto& benchmark : benchmarks) {
+    results.push_back(RunBenchmark(benchmark, user_options));
+    const auto& result{results.back()};
+    const auto& evaluate{result.intervals.back()};
+    std::cout << fmt::format("{}: evaluate {:.3f} ms [{:.3f}, {:.3f}], {} bytes sent\n",
+                             mo::to_string(benchmark), evaluate.mean, evaluate.lower,
+                             evaluate.upper, result.number_of_bytes_sent);
+    if (user_options.count("verbose")) {
+      std::cout << mo::PrintStatistics(mo::to_string(benchmark), result.run_time_statistics,
+                                       result.communication_statistics);
+    }
+  }
+
+  if (user_options.count("csv")) {
+    std::ofstream csv(user_options["csv"].as<std::string>());
+    WriteCsv(csv, results);
+  }
+  if (user_options.count("json")) {
+    std::ofstream json(user_options["json"].as<std::string>());
+    json << boost::json::serialize(ToJson(results)) << "\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "aes_128.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "protocols/share.h"
+
+namespace encrypto::motion::algorithm {
+
+ShareWrapper Aes128(const ShareWrapper& key, const ShareWrapper& plaintext) {
+  assert(key->GetBitLength() == kAes128BlockBitSize);
+  const std::vector<ShareWrapper> key_wires{key.Split()};
+  const std::vector<ShareWrapper> round_keys{
+      Aes128KeyExpansion<ShareWrapper>(std::span<const ShareWrapper>(key_wires))};
+  const std::vector<ShareWrapper> plaintext_wires{plaintext.Split()};
+  return ShareWrapper::Concatenate(
+      Aes128Encryption<ShareWrapper>(round_keys, std::span<const ShareWrapper>(plaintext_wires)));
+}
+
+ShareWrapper Aes128WithRoundKeys(const ShareWrapper& round_keys, const ShareWrapper& plaintext) {
+  assert(round_keys->GetBitLength() == kAes128RoundKeysBitSize);
+  assert(plaintext->GetBitLength() == kAes128BlockBitSize);
+  const std::vector<ShareWrapper> round_key_wires{round_keys.Split()};
+  const std::vector<ShareWrapper> plaintext_wires{plaintext.Split()};
+  return ShareWrapper::Concatenate(
+      Aes128Encryption<ShareWrapper>(std::span<const ShareWrapper>(round_key_wires),
+                                     std::span<const ShareWrapper>(plaintext_wires)));
+}
+
+std::vector<BitVector<>> ExpandAes128Key(std::span<const BitVector<>> key) {
+  if (key.size() != kAes128BlockBitSize) {
+    throw std::invalid_argument(
+        fmt::format("AES-128 key must have {} bits, got {}", kAes128BlockBitSize, key.size()));
+  }
+  return Aes128KeyExpansion<BitVector<>>(key);
+}
+
+}  // namespace encrypto::motion::algorithm
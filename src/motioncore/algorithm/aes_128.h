@@ -0,0 +1,243 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+constexpr std::size_t kAes128NumberOfRounds{10};
+constexpr std::size_t kAes128BlockBitSize{128};
+constexpr std::size_t kAes128RoundKeysBitSize{(kAes128NumberOfRounds + 1) * kAes128BlockBitSize};
+
+/// \brief AES-128 encryption of \p plaintext under \p key with a dedicated circuit, which computes
+/// the same as circuits/advanced/aes_128.bristol evaluated on key || plaintext.  The S-boxes use
+/// the circuit by Boyar and Peralta with 32 ANDs, i.e., 6400 ANDs in total, and far fewer XORs and
+/// INVs than the Bristol circuit, which is built without parsing a circuit description.
+/// \param key 128 wires, where wire i is bit i of the key read as a big-endian integer
+/// \param plaintext 128 wires with the same layout as \p key
+/// \returns the ciphertext as 128 wires with the same layout as \p key
+ShareWrapper Aes128(const ShareWrapper& key, const ShareWrapper& plaintext);
+
+/// \brief Same as Aes128, but with the round keys computed in the clear by the key owner with
+/// ExpandAes128Key, which saves the 40 S-boxes of the key schedule, i.e., 5120 instead of 6400
+/// ANDs.  Suited if the key is held by a single party, e.g., for an AES-based OPRF.
+/// \param round_keys 11 round keys of 128 wires each, with the same layout as the key of Aes128
+ShareWrapper Aes128WithRoundKeys(const ShareWrapper& round_keys, const ShareWrapper& plaintext);
+
+/// \brief Expands the plaintext \p key of 128 bits with one bit per SIMD value into the input of
+/// Aes128WithRoundKeys.
+std::vector<BitVector<>> ExpandAes128Key(std::span<const BitVector<>> key);
+
+namespace detail {
+
+// a byte of the AES state, least significant bit first
+template <typename Bit>
+using Aes128Byte = std::array<Bit, 8>;
+
+// the AES state in the byte order of the standard, i.e., column by column
+template <typename Bit>
+using Aes128State = std::array<Aes128Byte<Bit>, 16>;
+
+// byte k of a block is at the wires 8 * (15 - k) to 8 * (15 - k) + 7
+template <typename Bit>
+Aes128State<Bit> ToAes128State(std::span<const Bit> block) {
+  assert(block.size() == kAes128BlockBitSize);
+  Aes128State<Bit> state;
+  for (std::size_t byte_i = 0; byte_i < 16; ++byte_i) {
+    for (std::size_t bit_j = 0; bit_j < 8; ++bit_j) {
+      state[byte_i][bit_j] = block[8 * (15 - byte_i) + bit_j];
+    }
+  }
+  return state;
+}
+
+template <typename Bit>
+void AppendAes128State(const Aes128State<Bit>& state, std::vector<Bit>& block) {
+  for (std::size_t i = 0; i < kAes128BlockBitSize; ++i) {
+    block.push_back(state[15 - i / 8][i % 8]);
+  }
+}
+
+template <typename Bit>
+Aes128Byte<Bit> Aes128XorBytes(const Aes128Byte<Bit>& a, const Aes128Byte<Bit>& b) {
+  Aes128Byte<Bit> result;
+  for (std::size_t bit_j = 0; bit_j < 8; ++bit_j) result[bit_j] = a[bit_j] ^ b[bit_j];
+  return result;
+}
+
+// multiplication by x in GF(2^8)
+template <typename Bit>
+Aes128Byte<Bit> Aes128Xtime(const Aes128Byte<Bit>& a) {
+  return {a[7], a[0] ^ a[7], a[1], a[2] ^ a[7], a[3] ^ a[7], a[4], a[5], a[6]};
+}
+
+// the S-box circuit by Boyar and Peralta (https://eprint.iacr.org/2009/191) with 32 ANDs and
+// 83 XORs/XNORs, where u0 and s0 are the most significant bits
+template <typename Bit>
+Aes128Byte<Bit> Aes128SBox(const Aes128Byte<Bit>& input) {
+  const Bit &u0{input[7]}, &u1{input[6]}, &u2{input[5]}, &u3{input[4]}, &u4{input[3]},
+      &u5{input[2]}, &u6{input[1]}, &u7{input[0]};
+
+  // top linear transformation
+  const Bit y14{u3 ^ u5}, y13{u0 ^ u6}, y9{u0 ^ u3}, y8{u0 ^ u5}, t0{u1 ^ u2};
+  const Bit y1{t0 ^ u7};
+  const Bit y4{y1 ^ u3}, y12{y13 ^ y14}, y2{y1 ^ u0}, y5{y1 ^ u6};
+  const Bit y3{y5 ^ y8}, t1{u4 ^ y12};
+  const Bit y15{t1 ^ u5}, y20{t1 ^ u1};
+  const Bit y6{y15 ^ u7}, y10{y15 ^ t0}, y11{y20 ^ y9};
+  const Bit y7{u7 ^ y11}, y17{y10 ^ y11}, y19{y10 ^ y8}, y16{t0 ^ y11};
+  const Bit y21{y13 ^ y16}, y18{u0 ^ y16};
+
+  // shared non-linear middle part, i.e., the inversion in GF(2^4)
+  const Bit t2{y12 & y15}, t3{y3 & y6}, t5{y4 & u7}, t7{y13 & y16}, t8{y5 & y1}, t10{y2 & y7},
+      t12{y9 & y11}, t13{y14 & y17}, t15{y8 & y10};
+  const Bit t4{t3 ^ t2}, t6{t5 ^ t2}, t9{t8 ^ t7}, t11{t10 ^ t7}, t14{t13 ^ t12}, t16{t15 ^ t12};
+  const Bit t17{t4 ^ t14}, t18{t6 ^ t16}, t19{t9 ^ t14}, t20{t11 ^ t16};
+  const Bit t21{t17 ^ y20}, t22{t18 ^ y19}, t23{t19 ^ y21}, t24{t20 ^ y18};
+  const Bit t25{t21 ^ t22}, t26{t21 & t23};
+  const Bit t27{t24 ^ t26}, t30{t23 ^ t24}, t31{t22 ^ t26};
+  const Bit t28{t25 & t27}, t32{t31 & t30};
+  const Bit t29{t28 ^ t22}, t33{t32 ^ t24};
+  const Bit t34{t23 ^ t33}, t35{t27 ^ t33}, t42{t29 ^ t33};
+  const Bit t36{t24 & t35};
+  const Bit t37{t36 ^ t34}, t38{t27 ^ t36};
+  const Bit t39{t29 & t38}, t44{t33 ^ t37};
+  const Bit t40{t25 ^ t39};
+  const Bit t41{t40 ^ t37}, t43{t29 ^ t40};
+  const Bit t45{t42 ^ t41};
+  const Bit z0{t44 & y15}, z1{t37 & y6}, z2{t33 & u7}, z3{t43 & y16}, z4{t40 & y1}, z5{t29 & y7},
+      z6{t42 & y11}, z7{t45 & y17}, z8{t41 & y10}, z9{t44 & y12}, z10{t37 & y3}, z11{t33 & y4},
+      z12{t43 & y13}, z13{t40 & y5}, z14{t29 & y2}, z15{t42 & y9}, z16{t45 & y14},
+      z17{t41 & y8};
+
+  // bottom linear transformation
+  const Bit t46{z15 ^ z16}, t47{z10 ^ z11}, t48{z5 ^ z13}, t49{z9 ^ z10}, t50{z2 ^ z12},
+      t51{z2 ^ z5}, t52{z7 ^ z8}, t53{z0 ^ z3}, t54{z6 ^ z7}, t55{z16 ^ z17};
+  const Bit t56{z12 ^ t48}, t57{t50 ^ t53}, t58{z4 ^ t46}, t59{z3 ^ t54};
+  const Bit t60{t46 ^ t57}, t61{z14 ^ t57}, t62{t52 ^ t58}, t63{t49 ^ t58}, t64{z4 ^ t59};
+  const Bit t65{t61 ^ t62}, t66{z1 ^ t63};
+  const Bit t67{t64 ^ t65};
+  const Bit s0{t59 ^ t63}, s6{~(t56 ^ t62)}, s7{~(t48 ^ t60)}, s3{t53 ^ t66}, s4{t51 ^ t66},
+      s5{t47 ^ t65};
+  const Bit s1{~(t64 ^ s3)}, s2{~(t55 ^ t67)};
+  return {s7, s6, s5, s4, s3, s2, s1, s0};
+}
+
+template <typename Bit>
+Aes128State<Bit> Aes128SubBytesShiftRows(const Aes128State<Bit>& state) {
+  Aes128State<Bit> result;
+  // byte r + 4c of the state is in row r and column c
+  for (std::size_t row = 0; row < 4; ++row) {
+    for (std::size_t column = 0; column < 4; ++column) {
+      result[row + 4 * column] = Aes128SBox(state[row + 4 * ((column + row) % 4)]);
+    }
+  }
+  return result;
+}
+
+template <typename Bit>
+Aes128State<Bit> Aes128MixColumns(const Aes128State<Bit>& state) {
+  Aes128State<Bit> result;
+  for (std::size_t column = 0; column < 4; ++column) {
+    const auto* a{&state[4 * column]};
+    // b_i = 2 a_i + 3 a_{i+1} + a_{i+2} + a_{i+3} = a_i + t + 2 (a_i + a_{i+1})
+    const auto t{Aes128XorBytes(Aes128XorBytes(a[0], a[1]), Aes128XorBytes(a[2], a[3]))};
+    for (std::size_t i = 0; i < 4; ++i) {
+      result[4 * column + i] = Aes128XorBytes(
+          Aes128XorBytes(a[i], t), Aes128Xtime(Aes128XorBytes(a[i], a[(i + 1) % 4])));
+    }
+  }
+  return result;
+}
+
+template <typename Bit>
+void Aes128AddRoundKey(Aes128State<Bit>& state, const Aes128State<Bit>& round_key) {
+  for (std::size_t byte_i = 0; byte_i < 16; ++byte_i) {
+    state[byte_i] = Aes128XorBytes(state[byte_i], round_key[byte_i]);
+  }
+}
+
+}  // namespace detail
+
+/// \brief Builds the AES-128 key schedule on the bits of \p key, see Aes128.
+/// \tparam Bit a type with the operators ^, & and ~, e.g., ShareWrapper or BitVector<>
+/// \returns the 11 round keys of 128 bits each
+template <typename Bit>
+std::vector<Bit> Aes128KeyExpansion(std::span<const Bit> key) {
+  constexpr std::array<std::uint8_t, kAes128NumberOfRounds> kRoundConstants{
+      0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+  auto round_key{detail::ToAes128State(key)};
+  std::vector<Bit> round_keys;
+  round_keys.reserve(kAes128RoundKeysBitSize);
+  detail::AppendAes128State(round_key, round_keys);
+  for (std::size_t round = 0; round < kAes128NumberOfRounds; ++round) {
+    // SubWord(RotWord(w)) + Rcon for the last word w of the previous round key
+    std::array<detail::Aes128Byte<Bit>, 4> temp;
+    for (std::size_t i = 0; i < 4; ++i) temp[i] = detail::Aes128SBox(round_key[12 + (i + 1) % 4]);
+    for (std::size_t bit_j = 0; bit_j < 8; ++bit_j) {
+      if ((kRoundConstants[round] >> bit_j) & 1) temp[0][bit_j] = ~temp[0][bit_j];
+    }
+    for (std::size_t word_i = 0; word_i < 4; ++word_i) {
+      for (std::size_t i = 0; i < 4; ++i) {
+        round_key[4 * word_i + i] = detail::Aes128XorBytes(round_key[4 * word_i + i], temp[i]);
+        temp[i] = round_key[4 * word_i + i];
+      }
+    }
+    detail::AppendAes128State(round_key, round_keys);
+  }
+  return round_keys;
+}
+
+/// \brief Builds the AES-128 encryption of the bits of \p plaintext with the \p round_keys from
+/// Aes128KeyExpansion, see Aes128.
+/// \tparam Bit a type with the operators ^, & and ~, e.g., ShareWrapper or BitVector<>
+template <typename Bit>
+std::vector<Bit> Aes128Encryption(std::span<const Bit> round_keys, std::span<const Bit> plaintext) {
+  assert(round_keys.size() == kAes128RoundKeysBitSize);
+  const auto GetRoundKey = [round_keys](std::size_t round) {
+    return detail::ToAes128State(round_keys.subspan(round * kAes128BlockBitSize,
+                                                    kAes128BlockBitSize));
+  };
+  auto state{detail::ToAes128State(plaintext)};
+  detail::Aes128AddRoundKey(state, GetRoundKey(0));
+  for (std::size_t round = 1; round <= kAes128NumberOfRounds; ++round) {
+    state = detail::Aes128SubBytesShiftRows(state);
+    if (round < kAes128NumberOfRounds) state = detail::Aes128MixColumns(state);
+    detail::Aes128AddRoundKey(state, GetRoundKey(round));
+  }
+  std::vector<Bit> ciphertext;
+  ciphertext.reserve(kAes128BlockBitSize);
+  detail::AppendAes128State(state, ciphertext);
+  return ciphertext;
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -24,24 +24,130 @@
 
 #include "algorithm_description.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <regex>
 #include <sstream>
+#include <string_view>
 
 #include <fmt/format.h>
-#include <boost/algorithm/string/trim.hpp>
+#include <omp.h>
 #include <boost/lexical_cast.hpp>
 
+#include "utility/mapped_column.h"
+
 namespace encrypto::motion {
 
+namespace {
+
+// text files smaller than this are parsed on one thread
+constexpr std::size_t kMinimumChunkSize{1 << 20};
+
+bool IsWhitespace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// returns the next line of text and advances text past its line break
+std::string_view NextLine(std::string_view& text) {
+  const auto end{text.find('\n')};
+  const auto line{text.substr(0, end)};
+  text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+  return line;
+}
+
+// splits line into the tokens separated by whitespace, reusing the memory of tokens
+void Tokenize(std::string_view line, std::vector<std::string_view>& tokens) {
+  tokens.clear();
+  std::size_t position{0};
+  while (true) {
+    while (position < line.size() && IsWhitespace(line[position])) ++position;
+    if (position == line.size()) return;
+    const auto begin{position};
+    while (position < line.size() && !IsWhitespace(line[position])) ++position;
+    tokens.push_back(line.substr(begin, position - begin));
+  }
+}
+
+std::optional<std::size_t> ParseNumber(std::string_view token) {
+  std::size_t value;
+  const auto [end, error]{std::from_chars(token.data(), token.data() + token.size(), value)};
+  if (error != std::errc() || end != token.data() + token.size()) return std::nullopt;
+  return value;
+}
+
+// parses the lines of text in parallel chunks, which end at line breaks, by
+// parse_chunk(chunk, number of the first line of the chunk), and returns the results of the chunks
+// in order.  The first exception thrown by a chunk is rethrown.
+template <typename ChunkResult, typename ParseChunk>
+std::vector<ChunkResult> ParseInParallel(std::string_view text, std::size_t first_line_number,
+                                         ParseChunk parse_chunk) {
+  const std::size_t number_of_chunks{std::clamp<std::size_t>(
+      text.size() / kMinimumChunkSize, 1, static_cast<std::size_t>(omp_get_max_threads()))};
+  std::vector<std::string_view> chunks;
+  chunks.reserve(number_of_chunks);
+  for (std::size_t i = number_of_chunks; i > 1; --i) {
+    auto end{std::min(text.size(), text.size() / i)};
+    end = text.find('\n', end);
+    if (end == std::string_view::npos) break;
+    chunks.push_back(text.substr(0, end + 1));
+    text.remove_prefix(end + 1);
+  }
+  chunks.push_back(text);
+
+  std::vector<std::size_t> first_line_numbers(chunks.size());
+  first_line_numbers[0] = first_line_number;
+  for (std::size_t i = 1; i < chunks.size(); ++i) {
+    first_line_numbers[i] = first_line_numbers[i - 1] +
+                            std::count(chunks[i - 1].begin(), chunks[i - 1].end(), '\n');
+  }
+
+  std::vector<ChunkResult> results(chunks.size());
+  std::vector<std::exception_ptr> errors(chunks.size());
+#pragma omp parallel for schedule(static, 1)
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    try {
+      results[i] = parse_chunk(chunks[i], first_line_numbers[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+  for (const auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+  return results;
+}
+
+std::string ReadStream(std::ifstream& stream) {
+  assert(stream.is_open());
+  assert(stream.good());
+  return std::string(std::istreambuf_iterator<char>(stream), {});
+}
+
+}  // namespace
+
 AlgorithmDescription AlgorithmDescription::FromBristol(const std::string& path) {
-  std::ifstream file_stream(path);
-  return FromBristol(file_stream);
+  const MappedFile file(path);
+  const auto bytes{file.GetBytes()};
+  return FromBristolText(
+      std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
 }
 
 AlgorithmDescription AlgorithmDescription::FromBristol(std::string&& path) {
-  std::ifstream file_stream(std::move(path));
-  return FromBristol(file_stream);
+  return FromBristol(static_cast<const std::string&>(path));
+}
+
+AlgorithmDescription AlgorithmDescription::FromBristol(std::ifstream& stream) {
+  return FromBristolText(ReadStream(stream));
 }
 
 //
@@ -60,213 +166,425 @@ AlgorithmDescription AlgorithmDescription::FromBristol(std::string&& path) {
 // 2 1 0 8 17 AND   ***
 // ...
 //
+// The gates are parsed in parallel chunks of lines, and their wires are checked afterwards.
+//
 
-AlgorithmDescription AlgorithmDescription::FromBristol(std::ifstream& stream) {
+AlgorithmDescription AlgorithmDescription::FromBristolText(std::string_view text) {
   AlgorithmDescription algorithm_description;
-  assert(stream.is_open());
-  assert(stream.good());
-  stream >> algorithm_description.number_of_gates >> algorithm_description.number_of_wires;
+  std::vector<std::string_view> tokens;
+  const auto number = [](std::string_view token) {
+    const auto value{ParseNumber(token)};
+    if (!value) throw std::runtime_error(fmt::format("Invalid number {} in Bristol file", token));
+    return *value;
+  };
+
+  Tokenize(NextLine(text), tokens);
+  if (tokens.size() != 2) {
+    throw std::runtime_error("Unexpected number of values in the first line of the Bristol file");
+  }
+  algorithm_description.number_of_gates = number(tokens[0]);
+  algorithm_description.number_of_wires = number(tokens[1]);
+
+  Tokenize(NextLine(text), tokens);
+  if (tokens.size() == 2) {
+    algorithm_description.number_of_input_wires_parent_a = number(tokens[0]);
+    algorithm_description.number_of_output_wires = number(tokens[1]);
+  } else if (tokens.size() == 3) {
+    algorithm_description.number_of_input_wires_parent_a = number(tokens[0]);
+    algorithm_description.number_of_input_wires_parent_b = number(tokens[1]);
+    algorithm_description.number_of_output_wires = number(tokens[2]);
+  } else {
+    throw std::runtime_error(
+        std::string("Unexpected number of values: " + std::to_string(tokens.size()) + "\n"));
+  }
 
-  std::vector<std::string> line_vector;
-  std::string line;
-  std::getline(stream, line);  // skip \n at the end of the first line
-  // second line
-  {
-    std::string second_line;
-    std::getline(stream, second_line);
-    std::stringstream ss(second_line);
-    while (std::getline(ss, line, ' ')) {
-      line_vector.emplace_back(std::move(line));
-      line.clear();
-    }
-    algorithm_description.number_of_input_wires_parent_a = std::stoull(line_vector.at(0));
-    if (line_vector.size() == 2) {
-      algorithm_description.number_of_output_wires = std::stoull(line_vector.at(1));
-    } else if (line_vector.size() == 3) {
-      algorithm_description.number_of_input_wires_parent_b = std::stoull(line_vector.at(1));
-      algorithm_description.number_of_output_wires = std::stoull(line_vector.at(2));
-    } else {
+  [[maybe_unused]] const auto empty_line{NextLine(text)};
+  assert(empty_line.empty() || empty_line == "\r");
+
+  const auto chunks{ParseInParallel<std::vector<PrimitiveOperation>>(
+      text, 4, [&number](std::string_view chunk, std::size_t) {
+        std::vector<PrimitiveOperation> gates;
+        std::vector<std::string_view> line_tokens;
+        while (!chunk.empty()) {
+          Tokenize(NextLine(chunk), line_tokens);
+          if (line_tokens.empty()) continue;
+          const auto type{line_tokens.back()};
+          const auto check_size = [&line_tokens, type](std::size_t size) {
+            if (line_tokens.size() != size) {
+              throw std::runtime_error(
+                  fmt::format("Unexpected number of values of a {} gate in Bristol file", type));
+            }
+          };
+          PrimitiveOperation primitive_operation;
+          if (type == "XOR" || type == "AND" || type == "ADD" || type == "MUL" || type == "OR") {
+            check_size(6);
+            if (type == "XOR")
+              primitive_operation.type = PrimitiveOperationType::kXor;
+            else if (type == "AND")
+              primitive_operation.type = PrimitiveOperationType::kAnd;
+            else if (type == "ADD")
+              primitive_operation.type = PrimitiveOperationType::kAdd;
+            else if (type == "MUL")
+              primitive_operation.type = PrimitiveOperationType::kMul;
+            else
+              primitive_operation.type = PrimitiveOperationType::kOr;
+            primitive_operation.parent_a = number(line_tokens[2]);
+            primitive_operation.parent_b = number(line_tokens[3]);
+            primitive_operation.output_wire = number(line_tokens[4]);
+          } else if (type == "MUX") {
+            check_size(7);
+            primitive_operation.type = PrimitiveOperationType::kMux;
+            primitive_operation.parent_a = number(line_tokens[2]);
+            primitive_operation.parent_b = number(line_tokens[3]);
+            primitive_operation.selection_bit = number(line_tokens[4]);
+            primitive_operation.output_wire = number(line_tokens[5]);
+          } else if (type == "INV") {
+            check_size(5);
+            primitive_operation.type = PrimitiveOperationType::kInv;
+            primitive_operation.parent_a = number(line_tokens[2]);
+            primitive_operation.output_wire = number(line_tokens[3]);
+          } else {
+            throw std::runtime_error(fmt::format("Unknown operation type: {}\n", type));
+          }
+          gates.emplace_back(primitive_operation);
+        }
+        return gates;
+      })};
+
+  auto& gates{algorithm_description.gates};
+  std::size_t number_of_parsed_gates{0};
+  for (const auto& chunk : chunks) number_of_parsed_gates += chunk.size();
+  gates.reserve(number_of_parsed_gates);
+  for (const auto& chunk : chunks) gates.insert(gates.end(), chunk.begin(), chunk.end());
+
+  const auto number_of_wires{algorithm_description.number_of_wires};
+  for (const auto& gate : gates) {
+    if (gate.parent_a >= number_of_wires || gate.parent_b.value_or(0) >= number_of_wires ||
+        gate.selection_bit.value_or(0) >= number_of_wires || gate.output_wire >= number_of_wires) {
       throw std::runtime_error(
-          std::string("Unexpected number of values: " + std::to_string(line_vector.size()) + "\n"));
+          fmt::format("Bristol file has a gate with a wire out of the range of {} wires",
+                      number_of_wires));
     }
-    line.clear();
-    line_vector.clear();
-  }
-
-  std::getline(stream, line);
-  assert(line.empty());
-
-  // read line
-  while (std::getline(stream, line)) {
-    std::stringstream ss(line);
-    // split line
-    while (std::getline(ss, line, ' ')) {
-      line_vector.emplace_back(std::move(line));
-    }
-
-    if (line_vector.empty()) continue;
-    const auto& type = line_vector.at(line_vector.size() - 1);
-    PrimitiveOperation primitive_operation;
-    if (type == std::string("XOR") || type == std::string("AND") || type == std::string("ADD") ||
-        type == std::string("MUL") || type == std::string("OR")) {
-      assert(line_vector.size() == 6);
-      if (type == std::string("XOR"))
-        primitive_operation.type = PrimitiveOperationType::kXor;
-      else if (type == std::string("AND"))
-        primitive_operation.type = PrimitiveOperationType::kAnd;
-      else if (type == std::string("ADD"))
-        primitive_operation.type = PrimitiveOperationType::kAdd;
-      else if (type == std::string("MUL"))
-        primitive_operation.type = PrimitiveOperationType::kMul;
-      else if (type == std::string("OR"))
-        primitive_operation.type = PrimitiveOperationType::kOr;
-      primitive_operation.parent_a = std::stoull(line_vector.at(2));
-      primitive_operation.parent_b = std::stoull(line_vector.at(3));
-      primitive_operation.output_wire = std::stoull(line_vector.at(4));
-    } else if (type == std::string("MUX")) {
-      assert(line_vector.size() == 7);
-      primitive_operation.type = PrimitiveOperationType::kMux;
-      primitive_operation.parent_a = std::stoull(line_vector.at(2));
-      primitive_operation.parent_b = std::stoull(line_vector.at(3));
-      primitive_operation.selection_bit = std::stoull(line_vector.at(4));
-      primitive_operation.output_wire = std::stoull(line_vector.at(5));
-    } else if (type == std::string("INV")) {
-      assert(line_vector.size() == 5);
-      primitive_operation.type = PrimitiveOperationType::kInv;
-      primitive_operation.parent_a = std::stoull(line_vector.at(2));
-      primitive_operation.output_wire = std::stoull(line_vector.at(3));
-    } else {
-      throw std::runtime_error("Unknown operation type: " + line_vector.at(line_vector.size() - 1) +
-                               "\n");
-    }
-    algorithm_description.gates.emplace_back(primitive_operation);
-    line.clear();
-    line_vector.clear();
   }
   return algorithm_description;
 }
 
 AlgorithmDescription AlgorithmDescription::FromBristolFashion(const std::string& path) {
-  std::ifstream file_stream(path);
-  return FromBristolFashion(file_stream);
+  const MappedFile file(path);
+  const auto bytes{file.GetBytes()};
+  return FromBristolFashionText(
+      std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
 }
 
 AlgorithmDescription AlgorithmDescription::FromBristolFashion(std::string&& path) {
-  std::ifstream file_stream(std::move(path));
-  return FromBristolFashion(file_stream);
+  return FromBristolFashion(static_cast<const std::string&>(path));
 }
 
 AlgorithmDescription AlgorithmDescription::FromBristolFashion(std::ifstream& stream) {
+  return FromBristolFashionText(ReadStream(stream));
+}
+
+namespace {
+
+// the value of a wire of a Bristol Fashion file, which is either a constant assigned by EQ or a
+// wire of the AlgorithmDescription, i.e., the wire itself or the wire copied by EQW
+struct BristolFashionWire {
+  bool is_constant{false};
+  bool constant{false};
+  std::size_t wire{0};
+};
+
+// parses a header line of the form "n v_1 ... v_n"
+std::vector<std::size_t> ParseBristolFashionHeader(const std::string& line,
+                                                   std::size_t line_number) {
+  const static std::regex kLineNumbersRegex("^\\s*\\d+(\\s+\\d+)*\\s*$");
+  if (!std::regex_match(line, kLineNumbersRegex)) {
+    throw std::runtime_error(
+        fmt::format("Cannot parse Bristol Fashion file at line {}", line_number));
+  }
+  std::istringstream line_stream(line);
+  std::vector<std::size_t> values{std::istream_iterator<std::size_t>(line_stream), {}};
+  if (values.at(0) == 0 || values.at(0) + 1 != values.size()) {
+    throw std::runtime_error(
+        fmt::format("Malformed Bristol Fashion format at line {}", line_number));
+  }
+  values.erase(values.begin());
+  return values;
+}
+
+// a gate line of a Bristol Fashion file, whose numbers are values[offset, offset + size) of the
+// chunk of lines it belongs to
+struct BristolFashionLine {
+  std::size_t line_number;
+  std::string_view operation;
+  std::size_t offset;
+  std::size_t size;
+};
+
+struct BristolFashionChunk {
+  std::vector<BristolFashionLine> lines;
+  std::vector<std::size_t> values;
+};
+
+}  // namespace
+
+//
+// Bristol Fashion format
+// 2 5              *** total # of gates, total # of wires
+// 2 1 1            *** # of input values, # of wires of each input value
+// 1 1              *** # of output values, # of wires of each output value
+//                  *** empty line
+// *** below, each gate is given as
+// *** # of inputs, # of outputs, input wire ids, output wire ids, gate type
+// 2 1 0 1 2 AND
+// 1 1 2 4 INV
+//
+// The output wires are the last wires.  Besides XOR, AND and INV, the extensions
+// 1 1 c w EQ         *** assigns the constant c (0 or 1) to w
+// 1 1 a w EQW        *** copies wire a to w
+// 2k k a_1 ... a_k b_1 ... b_k w_1 ... w_k MAND  *** k independent ANDs w_i = a_i & b_i
+// are supported.  Constants and copies are folded into the gates reading them, s.t. the
+// AlgorithmDescription may have fewer gates than the file, and the ANDs of each MAND are recorded
+// in and_groups.  The numbers of the gate lines are parsed in parallel chunks of lines, and the
+// gates are constructed from them afterwards.
+//
+
+AlgorithmDescription AlgorithmDescription::FromBristolFashionText(std::string_view text) {
   AlgorithmDescription algorithm_description;
-  assert(stream.is_open());
-  assert(stream.good());
 
   constexpr std::size_t kGateEncodingLineNumber = 4;
   const static std::regex kLineTwoNumbersRegex("^\\s*(\\d+)\\s+(\\d+)\\s*$");
-  const static std::regex kLineThreeNumbersRegex("^\\s*(\\d+)\\s+(\\d+)\\s+(\\d+)\\s*$");
-  const static std::regex kLineGateRegex(
-      "^\\s*(1|2)\\s+(1)\\s+(\\d+)\\s+(\\d+\\s+)?(\\d+)\\s+(XOR|AND|INV)\\s*$");
-  const static std::regex kLineWhitespaceRegex("^\\s*$");
 
   std::string line;
   std::smatch match;
 
   // first line
-  std::getline(stream, line);
+  line = NextLine(text);
   if (!std::regex_match(line, match, kLineTwoNumbersRegex)) {
     throw std::runtime_error("Cannot parse Bristol Fashion file at line 1");
   }
-  algorithm_description.number_of_gates = boost::lexical_cast<std::size_t>(match[1]);
+  const auto number_of_file_gates = boost::lexical_cast<std::size_t>(match[1]);
   algorithm_description.number_of_wires = boost::lexical_cast<std::size_t>(match[2]);
 
-  // second line
-  std::getline(stream, line);
-  if (std::regex_match(line, match, kLineTwoNumbersRegex)) {
-    auto n = boost::lexical_cast<std::size_t>(match[1]);
-    if (n != 1) {
-      throw std::runtime_error("Malformed Bristol Fashion format at line 2");
-    }
-    algorithm_description.number_of_input_wires_parent_a =
-        boost::lexical_cast<std::size_t>(match[2]);
-  } else if (std::regex_match(line, match, kLineThreeNumbersRegex)) {
-    auto n = boost::lexical_cast<std::size_t>(match[1]);
-    if (n != 2) {
-      throw std::runtime_error("Malformed Bristol Fashion format at line 2");
-    }
-    algorithm_description.number_of_input_wires_parent_a =
-        boost::lexical_cast<std::size_t>(match[2]);
+  // second line, the first input value is parent a and all further input values are parent b
+  line = NextLine(text);
+  const auto input_values{ParseBristolFashionHeader(line, 2)};
+  algorithm_description.number_of_input_wires_parent_a = input_values.front();
+  if (input_values.size() > 1) {
     algorithm_description.number_of_input_wires_parent_b =
-        boost::lexical_cast<std::size_t>(match[3]);
-  } else {
-    throw std::runtime_error(
-        "Cannot parse Bristol Fashion file at line 2 (maybe unsupported number of input values)");
+        std::accumulate(input_values.begin() + 1, input_values.end(), std::size_t(0));
   }
 
-  // third line
-  std::getline(stream, line);
-  if (std::regex_match(line, match, kLineTwoNumbersRegex)) {
-    auto n = boost::lexical_cast<std::size_t>(match[1]);
-    if (n != 1) {
-      throw std::runtime_error("Malformed Bristol Fashion format at line 3");
-    }
-    algorithm_description.number_of_output_wires = boost::lexical_cast<std::size_t>(match[2]);
-  } else {
-    throw std::runtime_error(
-        "Cannot parse Bristol Fashion file at line 3 (maybe unsupported number of output values)");
+  // third line, the output values are concatenated
+  line = NextLine(text);
+  const auto output_values{ParseBristolFashionHeader(line, 3)};
+  algorithm_description.number_of_output_wires =
+      std::accumulate(output_values.begin(), output_values.end(), std::size_t(0));
+
+  const std::size_t number_of_input_wires{
+      algorithm_description.number_of_input_wires_parent_a +
+      algorithm_description.number_of_input_wires_parent_b.value_or(0)};
+  const std::size_t number_of_wires{algorithm_description.number_of_wires};
+  if (number_of_input_wires > number_of_wires ||
+      algorithm_description.number_of_output_wires > number_of_wires) {
+    throw std::runtime_error("Bristol Fashion file has more input or output wires than wires");
   }
 
   // consume empty line
-  std::getline(stream, line);
-  assert(line.empty());
+  [[maybe_unused]] const auto empty_line{NextLine(text)};
+  assert(empty_line.empty() || empty_line == "\r");
 
   std::size_t line_number = kGateEncodingLineNumber;
 
-  // read gates
-  while (std::getline(stream, line)) {
-    ++line_number;
-    if (line.empty() || std::regex_match(line, kLineWhitespaceRegex)) {
-      continue;
+  std::vector<std::optional<BristolFashionWire>> wires(number_of_wires);
+  for (std::size_t wire_i = 0; wire_i < number_of_input_wires; ++wire_i) {
+    wires[wire_i] = BristolFashionWire{.wire = wire_i};
+  }
+  const auto error = [&line_number](std::string_view message) {
+    return std::runtime_error(
+        fmt::format("Cannot parse Bristol Fashion file at line {}: {}", line_number, message));
+  };
+  const auto resolve = [&wires, &error](std::size_t wire) {
+    if (wire >= wires.size() || !wires[wire]) throw error("wire is read before it is assigned");
+    return *wires[wire];
+  };
+  const auto assign = [&wires, &error](std::size_t wire, BristolFashionWire value) {
+    if (wire >= wires.size() || wires[wire]) throw error("wire is assigned twice or out of range");
+    wires[wire] = value;
+  };
+  auto& gates{algorithm_description.gates};
+  const auto emit = [&gates, &assign](PrimitiveOperationType type, std::size_t parent_a,
+                                      std::optional<std::size_t> parent_b, std::size_t output) {
+    assign(output, BristolFashionWire{.wire = output});
+    gates.emplace_back(
+        PrimitiveOperation{.type = type, .parent_a = parent_a, .parent_b = parent_b,
+                           .output_wire = output});
+  };
+  // emits a XOR or an AND unless one of its inputs is constant
+  const auto emit_binary = [&](PrimitiveOperationType type, BristolFashionWire a,
+                               BristolFashionWire b, std::size_t output) {
+    const bool is_xor{type == PrimitiveOperationType::kXor};
+    if (a.is_constant && b.is_constant) {
+      const bool value{is_xor ? a.constant != b.constant : a.constant && b.constant};
+      assign(output, BristolFashionWire{.is_constant = true, .constant = value});
+      return;
     }
-
-    if (!std::regex_match(line, match, kLineGateRegex)) {
-      throw std::runtime_error(
-          fmt::format("Cannot parse Bristol Fashion file at line {}", line_number));
+    if (a.is_constant) std::swap(a, b);
+    if (!b.is_constant) {
+      emit(type, a.wire, b.wire, output);
+    } else if (is_xor && b.constant) {
+      emit(PrimitiveOperationType::kInv, a.wire, std::nullopt, output);
+    } else if (!is_xor && !b.constant) {
+      assign(output, BristolFashionWire{.is_constant = true, .constant = false});
+    } else {
+      assign(output, a);
     }
+  };
 
-    using namespace std::string_literals;
-
-    auto number_of_inputs = boost::lexical_cast<std::size_t>(match[1]);
-    const auto& operation = match[6];
-    PrimitiveOperation primitive_operation;
-
-    if (operation == "XOR"s) {
-      if (number_of_inputs != 2) {
-        throw std::runtime_error(fmt::format(
-            "Cannot parse Bristol Fashion file at line {}: invalid number of inputs", line_number));
-      }
-      primitive_operation.type = PrimitiveOperationType::kXor;
-    } else if (operation == "AND"s) {
-      if (number_of_inputs != 2) {
-        throw std::runtime_error(fmt::format(
-            "Cannot parse Bristol Fashion file at line {}: invalid number of inputs", line_number));
+  // read gates
+  const auto chunks{ParseInParallel<BristolFashionChunk>(
+      text, kGateEncodingLineNumber + 1,
+      [](std::string_view chunk_text, std::size_t chunk_line_number) {
+        BristolFashionChunk chunk;
+        std::vector<std::string_view> tokens;
+        for (; !chunk_text.empty(); ++chunk_line_number) {
+          Tokenize(NextLine(chunk_text), tokens);
+          if (tokens.empty()) continue;
+          const auto chunk_error = [chunk_line_number](std::string_view message) {
+            return std::runtime_error(fmt::format(
+                "Cannot parse Bristol Fashion file at line {}: {}", chunk_line_number, message));
+          };
+          const std::size_t offset{chunk.values.size()};
+          for (std::size_t i = 0; i + 1 < tokens.size(); ++i) {
+            const auto value{ParseNumber(tokens[i])};
+            if (!value) throw chunk_error("invalid number");
+            chunk.values.push_back(*value);
+          }
+          const std::size_t size{chunk.values.size() - offset};
+          if (size < 2 || chunk.values[offset] + chunk.values[offset + 1] + 2 != size) {
+            throw chunk_error("invalid number of wires");
+          }
+          chunk.lines.push_back({chunk_line_number, tokens.back(), offset, size});
+        }
+        return chunk;
+      })};
+
+  std::size_t number_of_lines{0};
+  for (const auto& chunk : chunks) number_of_lines += chunk.lines.size();
+  for (const auto& chunk : chunks) {
+    for (const auto& gate_line : chunk.lines) {
+      line_number = gate_line.line_number;
+      const std::span<const std::size_t> values(chunk.values.data() + gate_line.offset,
+                                                gate_line.size);
+      const std::size_t number_of_inputs{values[0]}, number_of_outputs{values[1]};
+      const auto inputs{values.begin() + 2};
+      const auto outputs{inputs + number_of_inputs};
+      const auto& operation{gate_line.operation};
+      const auto check_arity = [&](std::size_t expected_inputs) {
+        if (number_of_inputs != expected_inputs || number_of_outputs != 1) {
+          throw error("invalid number of inputs");
+        }
+      };
+
+      if (operation == "XOR" || operation == "AND") {
+        check_arity(2);
+        emit_binary(
+            operation == "XOR" ? PrimitiveOperationType::kXor : PrimitiveOperationType::kAnd,
+            resolve(inputs[0]), resolve(inputs[1]), outputs[0]);
+      } else if (operation == "INV") {
+        check_arity(1);
+        if (const auto a{resolve(inputs[0])}; a.is_constant) {
+          assign(outputs[0], BristolFashionWire{.is_constant = true, .constant = !a.constant});
+        } else {
+          emit(PrimitiveOperationType::kInv, a.wire, std::nullopt, outputs[0]);
+        }
+      } else if (operation == "EQ") {
+        check_arity(1);
+        if (inputs[0] > 1) throw error("EQ assigns a constant other than 0 or 1");
+        assign(outputs[0], BristolFashionWire{.is_constant = true, .constant = inputs[0] == 1});
+      } else if (operation == "EQW") {
+        check_arity(1);
+        assign(outputs[0], resolve(inputs[0]));
+      } else if (operation == "MAND") {
+        if (number_of_outputs == 0 || number_of_inputs != 2 * number_of_outputs) {
+          throw error("invalid number of inputs");
+        }
+        // the ANDs of a MAND are independent, so all inputs are read before assigning the outputs
+        std::vector<BristolFashionWire> input_values;
+        for (auto input = inputs; input != outputs; ++input) {
+          input_values.push_back(resolve(*input));
+        }
+        const std::size_t first_gate{gates.size()};
+        for (std::size_t i = 0; i < number_of_outputs; ++i) {
+          emit_binary(PrimitiveOperationType::kAnd, input_values[i],
+                      input_values[number_of_outputs + i], outputs[i]);
+        }
+        if (gates.size() - first_gate > 1) {
+          algorithm_description.and_groups.emplace_back(first_gate, gates.size() - first_gate);
+        }
+      } else {
+        throw error(fmt::format("unknown operation {}", operation));
       }
-      primitive_operation.type = PrimitiveOperationType::kAnd;
-    } else if (operation == "INV"s) {
-      if (number_of_inputs != 1) {
-        throw std::runtime_error(fmt::format(
-            "Cannot parse Bristol Fashion file at line {}: invalid number of inputs", line_number));
+    }
+  }
+  if (number_of_lines != number_of_file_gates) {
+    throw std::runtime_error(fmt::format("Bristol Fashion file has {} instead of {} gates",
+                                         number_of_lines, number_of_file_gates));
+  }
+
+  // output wires that are constants or copies are assigned by gates reading a zero wire, which is
+  // an unused wire or an additional one before the output wires
+  const std::size_t first_output{number_of_wires - algorithm_description.number_of_output_wires};
+  std::vector<BristolFashionWire> output_values_of_wires;
+  bool needs_zero{false};
+  for (std::size_t wire_i = first_output; wire_i < number_of_wires; ++wire_i) {
+    if (!wires[wire_i]) {
+      throw std::runtime_error(fmt::format("Output wire {} is not assigned", wire_i));
+    }
+    output_values_of_wires.push_back(*wires[wire_i]);
+    needs_zero |= wires[wire_i]->is_constant || wires[wire_i]->wire != wire_i;
+  }
+  if (needs_zero) {
+    if (number_of_input_wires == 0) {
+      throw std::runtime_error("Bristol Fashion file without inputs has constant outputs");
+    }
+    std::size_t zero{number_of_input_wires};
+    while (zero < first_output && wires[zero] && !wires[zero]->is_constant &&
+           wires[zero]->wire == zero) {
+      ++zero;
+    }
+    if (zero == first_output) {
+      const auto shift = [first_output](std::size_t& wire) {
+        if (wire >= first_output) ++wire;
+      };
+      for (auto& gate : gates) {
+        shift(gate.parent_a);
+        if (gate.parent_b) shift(*gate.parent_b);
+        shift(gate.output_wire);
       }
-      primitive_operation.type = PrimitiveOperationType::kInv;
+      for (auto& value : output_values_of_wires) shift(value.wire);
+      ++algorithm_description.number_of_wires;
     }
-    primitive_operation.output_wire = boost::lexical_cast<std::size_t>(match[5]);
-    primitive_operation.parent_a = boost::lexical_cast<std::size_t>(match[3]);
-    if (number_of_inputs == 2) {
-      std::string input_b = match[4];
-      boost::trim(input_b);
-      primitive_operation.parent_b = boost::lexical_cast<std::size_t>(input_b);
+    const std::size_t shifted_first_output{algorithm_description.number_of_wires -
+                                           algorithm_description.number_of_output_wires};
+    gates.emplace_back(PrimitiveOperation{
+        .type = PrimitiveOperationType::kXor, .parent_a = 0, .parent_b = 0, .output_wire = zero});
+    for (std::size_t i = 0; i < output_values_of_wires.size(); ++i) {
+      const auto& value{output_values_of_wires[i]};
+      const std::size_t output{shifted_first_output + i};
+      if (!value.is_constant && value.wire == output) continue;
+      if (value.is_constant && value.constant) {
+        gates.emplace_back(PrimitiveOperation{
+            .type = PrimitiveOperationType::kInv, .parent_a = zero, .output_wire = output});
+      } else {
+        gates.emplace_back(PrimitiveOperation{.type = PrimitiveOperationType::kXor,
+                                              .parent_a = value.is_constant ? zero : value.wire,
+                                              .parent_b = zero,
+                                              .output_wire = output});
+      }
     }
-    algorithm_description.gates.emplace_back(std::move(primitive_operation));
   }
+  algorithm_description.number_of_gates = gates.size();
 
   return algorithm_description;
 }
@@ -418,4 +736,203 @@ AlgorithmDescription AlgorithmDescription::FromAby(std::ifstream& stream) {
   return algorithm_description;
 }
 
+namespace {
+
+//
+// Binary format, all integers are little endian
+// magic "MOTIONBC", uint64 version
+// uint64 # of gates, # of wires, # of input wires parent a, # of input wires parent b or
+//        kNoParentB, # of output wires, # of gate records
+// gate records of kRecordSize bytes:
+//   uint8 type, uint8 has parent b, uint8 has selection bit, uint8 reserved,
+//   uint32 parent a, parent b, selection bit, output wire
+// kLut records are followed by uint32 k, k uint32 inputs and the 2^k bit truth table in bytes
+// since version 2: uint64 # of and groups, uint64 first gate and # of gates of each and group
+//
+
+constexpr std::array<char, 8> kBinaryMagic{'M', 'O', 'T', 'I', 'O', 'N', 'B', 'C'};
+constexpr std::uint64_t kBinaryVersion{2};
+constexpr std::size_t kNumberOfHeaderFields{7};
+constexpr std::size_t kBinaryHeaderSize{kBinaryMagic.size() +
+                                        kNumberOfHeaderFields * sizeof(std::uint64_t)};
+constexpr std::size_t kRecordSize{4 + 4 * sizeof(std::uint32_t)};
+constexpr std::uint64_t kNoParentB{std::numeric_limits<std::uint64_t>::max()};
+
+std::uint32_t ToWireId(std::size_t wire_id) {
+  if (wire_id > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::invalid_argument(
+        fmt::format("Wire id {} does not fit into the binary circuit format", wire_id));
+  }
+  return static_cast<std::uint32_t>(wire_id);
+}
+
+template <typename T>
+void WriteValue(std::ofstream& stream, T value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// reads values from front to back of a memory-mapped binary circuit
+class BinaryCircuitReader {
+ public:
+  explicit BinaryCircuitReader(const std::string& path) : path_(path) {
+    int file_descriptor{open(path.c_str(), O_RDONLY)};
+    if (file_descriptor < 0) {
+      throw std::runtime_error(
+          fmt::format("Could not open binary circuit {}: {}", path_, std::strerror(errno)));
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 ||
+        static_cast<std::size_t>(file_status.st_size) < kBinaryHeaderSize) {
+      close(file_descriptor);
+      throw std::runtime_error(fmt::format("Binary circuit {} is truncated", path_));
+    }
+    size_ = file_status.st_size;
+    void* mapping{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0)};
+    // the mapping stays valid after closing the file
+    close(file_descriptor);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error(
+          fmt::format("Could not map binary circuit {}: {}", path_, std::strerror(errno)));
+    }
+    data_ = static_cast<const std::byte*>(mapping);
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    if (std::memcmp(data_, kBinaryMagic.data(), kBinaryMagic.size()) != 0) {
+      throw std::runtime_error(fmt::format("{} is not a binary circuit", path_));
+    }
+    position_ = kBinaryMagic.size();
+  }
+
+  ~BinaryCircuitReader() { munmap(const_cast<std::byte*>(data_), size_); }
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Advance(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const std::byte* Advance(std::size_t number_of_bytes) {
+    if (size_ - position_ < number_of_bytes) {
+      throw std::runtime_error(fmt::format("Binary circuit {} is truncated", path_));
+    }
+    const std::byte* data{data_ + position_};
+    position_ += number_of_bytes;
+    return data;
+  }
+
+  const std::string& GetPath() const { return path_; }
+
+ private:
+  std::string path_;
+  const std::byte* data_{nullptr};
+  std::size_t size_{0}, position_{0};
+};
+
+}  // namespace
+
+AlgorithmDescription AlgorithmDescription::FromBinary(const std::string& path) {
+  BinaryCircuitReader reader(path);
+  const auto version{reader.Read<std::uint64_t>()};
+  if (version == 0 || version > kBinaryVersion) {
+    throw std::runtime_error(fmt::format("Binary circuit {} has version {} but expected at most {}",
+                                         path, version, kBinaryVersion));
+  }
+  AlgorithmDescription algorithm_description;
+  algorithm_description.number_of_gates = reader.Read<std::uint64_t>();
+  algorithm_description.number_of_wires = reader.Read<std::uint64_t>();
+  algorithm_description.number_of_input_wires_parent_a = reader.Read<std::uint64_t>();
+  if (const auto parent_b{reader.Read<std::uint64_t>()}; parent_b != kNoParentB) {
+    algorithm_description.number_of_input_wires_parent_b = parent_b;
+  }
+  algorithm_description.number_of_output_wires = reader.Read<std::uint64_t>();
+  const auto number_of_records{reader.Read<std::uint64_t>()};
+
+  algorithm_description.gates.resize(number_of_records);
+  for (auto& gate : algorithm_description.gates) {
+    const std::byte* record{reader.Advance(kRecordSize)};
+    std::array<std::uint32_t, 4> wires;
+    std::memcpy(wires.data(), record + 4, sizeof(wires));
+    const auto type{static_cast<std::uint8_t>(record[0])};
+    if (type >= static_cast<std::uint8_t>(PrimitiveOperationType::kInvalid)) {
+      throw std::runtime_error(
+          fmt::format("Invalid operation type {} in binary circuit {}", type, path));
+    }
+    gate.type = static_cast<PrimitiveOperationType>(type);
+    gate.parent_a = wires[0];
+    if (record[1] != std::byte(0)) gate.parent_b = wires[1];
+    if (record[2] != std::byte(0)) gate.selection_bit = wires[2];
+    gate.output_wire = wires[3];
+    if (gate.type == PrimitiveOperationType::kLut) {
+      const auto number_of_inputs{reader.Read<std::uint32_t>()};
+      if (number_of_inputs >= 8 * sizeof(std::size_t)) {
+        throw std::runtime_error(fmt::format("Invalid lookup table in binary circuit {}", path));
+      }
+      gate.lut_inputs.resize(number_of_inputs);
+      for (auto& input : gate.lut_inputs) input = reader.Read<std::uint32_t>();
+      const std::size_t table_size{std::size_t(1) << number_of_inputs};
+      const std::byte* table{reader.Advance((table_size + 7) / 8)};
+      gate.truth_table = BitVector<>(table, table_size);
+    }
+  }
+  if (version >= 2) {
+    algorithm_description.and_groups.resize(reader.Read<std::uint64_t>());
+    for (auto& [first_gate, number_of_gates] : algorithm_description.and_groups) {
+      first_gate = reader.Read<std::uint64_t>();
+      number_of_gates = reader.Read<std::uint64_t>();
+    }
+  }
+  return algorithm_description;
+}
+
+void AlgorithmDescription::ToBinary(const std::string& path) const {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("Could not create binary circuit {}", path));
+  }
+  stream.write(kBinaryMagic.data(), kBinaryMagic.size());
+  for (std::uint64_t value :
+       {kBinaryVersion, std::uint64_t(number_of_gates), std::uint64_t(number_of_wires),
+        std::uint64_t(number_of_input_wires_parent_a),
+        number_of_input_wires_parent_b ? std::uint64_t(*number_of_input_wires_parent_b)
+                                       : kNoParentB,
+        std::uint64_t(number_of_output_wires), std::uint64_t(gates.size())}) {
+    WriteValue(stream, value);
+  }
+  for (const auto& gate : gates) {
+    const std::array<std::uint8_t, 4> flags{static_cast<std::uint8_t>(gate.type),
+                                            gate.parent_b.has_value(),
+                                            gate.selection_bit.has_value(), 0};
+    stream.write(reinterpret_cast<const char*>(flags.data()), flags.size());
+    for (std::size_t wire : {gate.parent_a, gate.parent_b.value_or(0),
+                             gate.selection_bit.value_or(0), gate.output_wire}) {
+      WriteValue(stream, ToWireId(wire));
+    }
+    if (gate.type == PrimitiveOperationType::kLut) {
+      WriteValue(stream, ToWireId(gate.lut_inputs.size()));
+      for (const auto input : gate.lut_inputs) WriteValue(stream, ToWireId(input));
+      const std::size_t table_size{std::size_t(1) << gate.lut_inputs.size()};
+      if (gate.truth_table.GetSize() != table_size) {
+        throw std::invalid_argument(
+            fmt::format("Lookup table of {} inputs has {} instead of {} entries",
+                        gate.lut_inputs.size(), gate.truth_table.GetSize(), table_size));
+      }
+      stream.write(reinterpret_cast<const char*>(gate.truth_table.GetData().data()),
+                   (table_size + 7) / 8);
+    }
+  }
+  WriteValue(stream, std::uint64_t(and_groups.size()));
+  for (const auto& [first_gate, number_of_gates] : and_groups) {
+    WriteValue(stream, std::uint64_t(first_gate));
+    WriteValue(stream, std::uint64_t(number_of_gates));
+  }
+  stream.close();
+  if (stream.fail()) {
+    throw std::runtime_error(fmt::format("Could not write binary circuit {}", path));
+  }
+}
+
+std::string AlgorithmDescription::GetBinaryPath(const std::string& path) {
+  return std::filesystem::path(path).replace_extension(".mbc").string();
+}
+
 }  // namespace encrypto::motion
@@ -26,8 +26,12 @@
 
 #include <cassert>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "utility/bit_vector.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion {
@@ -38,6 +42,11 @@ struct PrimitiveOperation {
   std::optional<std::size_t> parent_b{std::nullopt};
   std::optional<std::size_t> selection_bit{std::nullopt};
   std::size_t output_wire{0};
+  // the inputs of a kLut, the first one being the least significant bit of the index into
+  // truth_table, which holds the output for each of the 2^k inputs.  Consecutive kLuts on the same
+  // inputs are evaluated by one lookup table gate.
+  std::vector<std::size_t> lut_inputs{};
+  BitVector<> truth_table{};
 };
 
 struct AlgorithmDescription {
@@ -49,22 +58,46 @@ struct AlgorithmDescription {
 
   static AlgorithmDescription FromBristol(std::ifstream& stream);
 
+  // parses a Bristol circuit held in memory, the lines of gates are parsed by parallel threads
+  static AlgorithmDescription FromBristolText(std::string_view text);
+
   static AlgorithmDescription FromBristolFashion(const std::string& path);
 
   static AlgorithmDescription FromBristolFashion(std::string&& path);
 
   static AlgorithmDescription FromBristolFashion(std::ifstream& stream);
 
+  // parses a Bristol Fashion circuit held in memory, like FromBristolText
+  static AlgorithmDescription FromBristolFashionText(std::string_view text);
+
   static AlgorithmDescription FromAby(const std::string& path);
 
   static AlgorithmDescription FromAby(std::string&& path);
 
   static AlgorithmDescription FromAby(std::ifstream& stream);
 
+  /// \brief reads a circuit in the binary format of ToBinary.  The file is memory-mapped and its
+  /// fixed-size gate records are decoded in one pass without parsing text.
+  /// \throws std::runtime_error if the file cannot be read or is not a binary circuit
+  static AlgorithmDescription FromBinary(const std::string& path);
+
+  /// \brief writes this circuit in the binary format read by FromBinary, which stores wire ids as
+  /// 32-bit integers.
+  /// \throws std::invalid_argument if a wire id does not fit into 32 bits
+  /// \throws std::runtime_error if the file cannot be written
+  void ToBinary(const std::string& path) const;
+
+  /// \returns the path of the binary circuit converted from the text circuit at path, i.e., path
+  /// with the extension .mbc instead of its own, see Register::GetCachedAlgorithmDescription
+  static std::string GetBinaryPath(const std::string& path);
+
   std::size_t number_of_output_wires{0}, number_of_input_wires_parent_a{0}, number_of_wires{0},
       number_of_gates{0};
   std::optional<std::size_t> number_of_input_wires_parent_b{std::nullopt};
   std::vector<PrimitiveOperation> gates;
+  // ranges of (first gate, number of gates) of consecutive independent kAnds, e.g., of the MAND
+  // gates of Bristol Fashion, which are evaluated in the same layer, see EvaluationTemplate
+  std::vector<std::pair<std::size_t, std::size_t>> and_groups;
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,194 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "arithmetic_algorithm_description.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <boost/lexical_cast.hpp>
+
+namespace encrypto::motion {
+
+std::string to_string(ArithmeticOperationType type) {
+  switch (type) {
+    case ArithmeticOperationType::kAdd:
+      return "ADD";
+    case ArithmeticOperationType::kMul:
+      return "MUL";
+    case ArithmeticOperationType::kConstantMul:
+      return "CMUL";
+    case ArithmeticOperationType::kDot:
+      return "DOT";
+    default:
+      return "INVALID";
+  }
+}
+
+ArithmeticAlgorithmDescription ArithmeticAlgorithmDescription::FromFile(const std::string& path) {
+  std::ifstream stream(path);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("Could not open arithmetic circuit {}", path));
+  }
+  return FromStream(stream);
+}
+
+//
+// Arithmetic circuit format
+// 3 8              *** total # of gates, total # of wires
+// 32 4 1           *** bit length, # of input wires, # of output wires
+//                  *** empty line
+// *** below, each gate is given as
+// *** # of inputs, # of outputs, input wire ids, output wire id, gate type
+// 2 1 0 1 4 MUL
+// 1 1 4 5 CMUL 3   *** the constant factor follows the gate type
+// 4 1 0 1 2 3 6 DOT  *** the inner product of (w0, w1) and (w2, w3)
+// 2 1 5 6 7 ADD
+//
+
+ArithmeticAlgorithmDescription ArithmeticAlgorithmDescription::FromStream(std::istream& stream) {
+  ArithmeticAlgorithmDescription algorithm_description;
+  std::size_t line_number{0};
+  const auto error = [&line_number](std::string_view message) {
+    return std::runtime_error(
+        fmt::format("Cannot parse arithmetic circuit at line {}: {}", line_number, message));
+  };
+  // reads the next line and splits it into tokens
+  const auto read_line = [&stream, &line_number]() {
+    std::string line;
+    std::getline(stream, line);
+    ++line_number;
+    std::istringstream line_stream(line);
+    return std::vector<std::string>{std::istream_iterator<std::string>(line_stream), {}};
+  };
+  const auto to_number = [&error](const std::string& token) {
+    try {
+      return boost::lexical_cast<std::uint64_t>(token);
+    } catch (const boost::bad_lexical_cast&) {
+      throw error(fmt::format("invalid number {}", token));
+    }
+  };
+
+  auto header{read_line()};
+  if (header.size() != 2) throw error("expected the number of gates and wires");
+  const auto number_of_gates{to_number(header[0])};
+  algorithm_description.number_of_wires = to_number(header[1]);
+  header = read_line();
+  if (header.size() != 3) {
+    throw error("expected the bit length and the number of input and output wires");
+  }
+  algorithm_description.bit_length = to_number(header[0]);
+  algorithm_description.number_of_input_wires = to_number(header[1]);
+  algorithm_description.number_of_output_wires = to_number(header[2]);
+  const auto bit_length{algorithm_description.bit_length};
+  if (bit_length != 8 && bit_length != 16 && bit_length != 32 && bit_length != 64) {
+    throw error(fmt::format("unsupported bit length {}", bit_length));
+  }
+  const auto number_of_wires{algorithm_description.number_of_wires};
+  if (algorithm_description.number_of_input_wires > number_of_wires ||
+      algorithm_description.number_of_output_wires > number_of_wires) {
+    throw error("more input or output wires than wires");
+  }
+  const std::uint64_t max_constant{std::numeric_limits<std::uint64_t>::max() >> (64 - bit_length)};
+
+  std::vector<bool> assigned(number_of_wires, false);
+  std::fill_n(assigned.begin(), algorithm_description.number_of_input_wires, true);
+  while (stream) {
+    const auto tokens{read_line()};
+    if (tokens.empty()) continue;
+    // the gate type is the first non-numeric token, which may be followed by a constant
+    std::size_t type_position{0};
+    while (type_position < tokens.size() && !tokens[type_position].empty() &&
+           std::isdigit(static_cast<unsigned char>(tokens[type_position][0]))) {
+      ++type_position;
+    }
+    if (type_position < 2 || type_position == tokens.size()) throw error("expected a gate");
+    const auto& operation{tokens[type_position]};
+    const auto number_of_inputs{to_number(tokens[0])}, number_of_outputs{to_number(tokens[1])};
+    if (number_of_outputs != 1 || number_of_inputs + 3 != type_position) {
+      throw error("invalid number of wires");
+    }
+
+    auto& gate{algorithm_description.gates.emplace_back()};
+    for (std::size_t i = 2; i < type_position - 1; ++i) {
+      const auto wire{to_number(tokens[i])};
+      if (wire >= number_of_wires || !assigned[wire]) {
+        throw error(fmt::format("wire {} is read before it is assigned", wire));
+      }
+      gate.inputs.push_back(wire);
+    }
+    gate.output_wire = to_number(tokens[type_position - 1]);
+    if (gate.output_wire >= number_of_wires || assigned[gate.output_wire]) {
+      throw error(fmt::format("wire {} is assigned twice or out of range", gate.output_wire));
+    }
+    assigned[gate.output_wire] = true;
+
+    const std::size_t number_of_arguments{tokens.size() - type_position - 1};
+    if (operation == "ADD" || operation == "MUL") {
+      gate.type =
+          operation == "ADD" ? ArithmeticOperationType::kAdd : ArithmeticOperationType::kMul;
+      if (number_of_inputs != 2 || number_of_arguments != 0) {
+        throw error("invalid number of inputs");
+      }
+    } else if (operation == "CMUL") {
+      gate.type = ArithmeticOperationType::kConstantMul;
+      if (number_of_inputs != 1 || number_of_arguments != 1) {
+        throw error("CMUL expects one input and a constant");
+      }
+      gate.constant = to_number(tokens.back());
+      if (gate.constant > max_constant) {
+        throw error(fmt::format("constant {} exceeds the bit length", gate.constant));
+      }
+    } else if (operation == "DOT") {
+      gate.type = ArithmeticOperationType::kDot;
+      if (number_of_inputs == 0 || number_of_inputs % 2 != 0 || number_of_arguments != 0) {
+        throw error("DOT expects two vectors of the same positive length");
+      }
+    } else {
+      throw error(fmt::format("unknown operation {}", operation));
+    }
+  }
+
+  if (algorithm_description.gates.size() != number_of_gates) {
+    throw std::runtime_error(fmt::format("Arithmetic circuit has {} instead of {} gates",
+                                         algorithm_description.gates.size(), number_of_gates));
+  }
+  for (auto wire = number_of_wires - algorithm_description.number_of_output_wires;
+       wire < number_of_wires; ++wire) {
+    if (!assigned[wire]) {
+      throw std::runtime_error(fmt::format("Output wire {} is not assigned", wire));
+    }
+  }
+  return algorithm_description;
+}
+
+}  // namespace encrypto::motion
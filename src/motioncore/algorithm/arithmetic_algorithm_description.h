@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace encrypto::motion {
+
+enum class ArithmeticOperationType : std::uint8_t {
+  kAdd,
+  kMul,
+  kConstantMul,  // multiplication by a public constant
+  kDot,          // inner product
+  kInvalid
+};
+
+std::string to_string(ArithmeticOperationType type);
+
+struct ArithmeticOperation {
+  ArithmeticOperationType type{ArithmeticOperationType::kInvalid};
+  // the two factors or summands of kAdd and kMul, the single input of kConstantMul and the vectors
+  // a_1, ..., a_n, b_1, ..., b_n of kDot
+  std::vector<std::size_t> inputs;
+  // the factor of kConstantMul
+  std::uint64_t constant{0};
+  std::size_t output_wire{0};
+};
+
+/// \brief An arithmetic circuit over the integers modulo 2^bit_length, which is evaluated on
+/// arithmetic GMW or ASTRA shares by ShareWrapper::Evaluate.  Like in Bristol Fashion, the inputs
+/// are the first number_of_input_wires wires and the outputs the last number_of_output_wires
+/// wires, and each wire is assigned once before it is read.
+struct ArithmeticAlgorithmDescription {
+  /// \throws std::runtime_error if the file cannot be read or is malformed
+  static ArithmeticAlgorithmDescription FromFile(const std::string& path);
+
+  /// \throws std::runtime_error if the circuit is malformed
+  static ArithmeticAlgorithmDescription FromStream(std::istream& stream);
+
+  // one of 8, 16, 32 and 64
+  std::size_t bit_length{0};
+  std::size_t number_of_input_wires{0}, number_of_output_wires{0}, number_of_wires{0};
+  std::vector<ArithmeticOperation> gates;
+};
+
+}  // namespace encrypto::motion
@@ -28,6 +28,13 @@
 #include <cassert>
 #include <cmath>
 
+#include <fmt/format.h>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/integer_circuits.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "protocols/conversion/b2a_gate.h"
 #include "protocols/share.h"
 
 namespace encrypto::motion::algorithm {
@@ -88,38 +95,49 @@ ShareWrapper AdderChain(std::span<const ShareWrapper> bits_0, std::span<const Sh
 }
 
 ShareWrapper HammingWeight(const ShareWrapper& bit_string) {
-  std::vector<ShareWrapper> bits{bit_string.Split()};
-  return HammingWeight(bits);
+  assert(bit_string->GetCircuitType() == CircuitType::kBoolean);
+  const std::size_t number_of_bits{bit_string->GetBitLength()};
+  // HW(bit) = bit
+  if (number_of_bits == 1) return bit_string;
+  const auto protocol{bit_string->GetProtocol()};
+  // BMR and garbled circuits use size-optimized circuits, GMW uses depth-optimized circuits
+  const auto objective{protocol == MpcProtocol::kBmr || protocol == MpcProtocol::kGarbledCircuit
+                           ? CircuitObjective::kSize
+                           : CircuitObjective::kDepth};
+  const auto name{fmt::format("generated/HAMMING_WEIGHT_{}_{}", number_of_bits,
+                              objective == CircuitObjective::kSize ? "size" : "depth")};
+  auto register_pointer{bit_string->GetRegister()};
+  auto algorithm{register_pointer->GetCachedAlgorithmDescription(name)};
+  if (!algorithm) {
+    algorithm = std::make_shared<AlgorithmDescription>(
+        MakeHammingWeightCircuit(number_of_bits, objective));
+    // another thread may have added the same circuit in the meantime
+    if (!register_pointer->AddCachedAlgorithmDescription(name, algorithm)) {
+      algorithm = register_pointer->GetCachedAlgorithmDescription(name);
+    }
+  }
+  return bit_string.Evaluate(algorithm);
 }
 
 ShareWrapper HammingWeight(std::span<const ShareWrapper> bits) {
-  if (bits.size() == 0) {
-    return ShareWrapper(nullptr);
-  } else if (bits.size() == 1) {
-    // HW(bit) = bit
-    return bits[0];
-  } else if (bits.size() == 2) {
-    // return {sum (0th pos.), carry (1st pos.)}
-    return ShareWrapper::Concatenate({bits[0] ^ bits[1], bits[0] & bits[1]});
-  } else if (bits.size() == 3) {
-    // use full adder
-    // FullAdder returns
-    auto [sum, carry] = FullAdder(bits[0], bits[1], bits[2]);
-    return ShareWrapper::Concatenate({sum, carry});
-  } else {  // bits.size() > 3
-    // split the input bit string into three parts: v, u and i
-    // length of v is the largest possible power of two - 1, e.g., 3, 7, 15, etc
-    // length of u is total length - length of v - 1
-    // length of i is always 1
-    size_t length_v{static_cast<std::size_t>(std::pow(2, std::floor(log2(bits.size())))) - 1};
-    size_t length_u{bits.size() - length_v - 1};
-
-    auto v{bits.first(length_v)};
-    auto u{bits.subspan(length_v, length_u)};
-    ShareWrapper i{bits.back()};
-
-    return AdderChain(HammingWeight(v), HammingWeight(u), i);
-  }
+  if (bits.size() == 0) return ShareWrapper(nullptr);
+  return HammingWeight(ShareWrapper::Concatenate(bits));
 }
 
+template <typename T>
+ShareWrapper ArithmeticHammingWeight(const ShareWrapper& bit_string) {
+  assert(bit_string->GetCircuitType() == CircuitType::kBoolean);
+  const auto boolean_gmw_bits{bit_string->GetProtocol() == MpcProtocol::kBooleanGmw
+                                  ? bit_string
+                                  : bit_string.Convert<MpcProtocol::kBooleanGmw>()};
+  auto hamming_weight_gate{bit_string->GetRegister()->EmplaceGate<GmwToArithmeticGate<T>>(
+      boolean_gmw_bits.Get(), true)};
+  return ShareWrapper(hamming_weight_gate->GetOutputAsShare());
+}
+
+template ShareWrapper ArithmeticHammingWeight<std::uint8_t>(const ShareWrapper& bit_string);
+template ShareWrapper ArithmeticHammingWeight<std::uint16_t>(const ShareWrapper& bit_string);
+template ShareWrapper ArithmeticHammingWeight<std::uint32_t>(const ShareWrapper& bit_string);
+template ShareWrapper ArithmeticHammingWeight<std::uint64_t>(const ShareWrapper& bit_string);
+
 }  // namespace encrypto::motion::algorithm
\ No newline at end of file
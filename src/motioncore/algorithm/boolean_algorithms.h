@@ -48,8 +48,19 @@ ShareWrapper AdderChain(const ShareWrapper& bit_string_0, const ShareWrapper& bi
 ShareWrapper AdderChain(std::span<const ShareWrapper> bits_0, std::span<const ShareWrapper> bits_1,
                         const ShareWrapper& carry_in);
 
+/// \brief counts the ones among the wires of bit_string, i.e., computes the Hamming weight of
+/// each SIMD value, by a single evaluation of MakeHammingWeightCircuit.  The result has
+/// std::bit_width(bit_string->GetBitLength()) wires with the least significant bit first.
 ShareWrapper HammingWeight(const ShareWrapper& bit_string);
 
+/// \brief computes HammingWeight on the concatenation of the single-wire shares in bits.
 ShareWrapper HammingWeight(std::span<const ShareWrapper> bits);
 
+/// \brief computes the Hamming weight of each SIMD value of bit_string as an arithmetic GMW share
+/// of T, i.e., modulo 2^(8 * sizeof(T)).  Every bit is converted to an arithmetic share and the
+/// converted bits are summed locally, which takes a single round and no AND gates.  Shares of
+/// other Boolean protocols are converted to Boolean GMW first.
+template <typename T>
+ShareWrapper ArithmeticHammingWeight(const ShareWrapper& bit_string);
+
 }  // namespace encrypto::motion::algorithm
\ No newline at end of file
@@ -0,0 +1,259 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "circuit_builder.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace encrypto::motion::detail {
+
+AlgorithmDescription CircuitBuilder::Build(const std::vector<Bit>& outputs) && {
+  const std::size_t number_of_input_wires{bitlength_a_ + bitlength_b_};
+  // outputs that are constants, inputs or repeated are computed from a zero wire x ^ x
+  std::optional<std::size_t> zero;
+  const auto get_zero = [this, &zero]() {
+    if (!zero) zero = Emit(PrimitiveOperationType::kXor, 0, 0, 0);
+    return *zero;
+  };
+  std::vector<std::size_t> output_wires;
+  std::vector<bool> is_output;
+  for (const auto& output : outputs) {
+    std::size_t wire;
+    if (!output.wire) {
+      // every constant output has its own zero wire
+      wire = Emit(PrimitiveOperationType::kXor, 0, 0, 0);
+      if (output.is_inverted) wire = Emit(PrimitiveOperationType::kInv, wire, std::nullopt, 0);
+    } else {
+      wire = Materialize(output);
+      is_output.resize(depths_.size(), false);
+      if (wire < number_of_input_wires || is_output[wire]) {
+        wire = Emit(PrimitiveOperationType::kXor, wire, get_zero(), depths_[wire]);
+      }
+    }
+    is_output.resize(depths_.size(), false);
+    is_output[wire] = true;
+    output_wires.push_back(wire);
+  }
+
+  // the gates keep their order, the outputs of the remaining ones are renumbered
+  const std::size_t number_of_wires{depths_.size()};
+  std::vector<bool> is_needed(is_output);
+  is_needed.resize(number_of_wires, false);
+  for (auto gate = gates_.rbegin(); gate != gates_.rend(); ++gate) {
+    if (!is_needed[gate->output_wire]) continue;
+    is_needed[gate->parent_a] = true;
+    if (gate->parent_b) is_needed[*gate->parent_b] = true;
+  }
+  std::vector<std::size_t> new_wires(number_of_wires);
+  for (std::size_t wire = 0; wire < number_of_input_wires; ++wire) new_wires[wire] = wire;
+  std::size_t next_wire{number_of_input_wires};
+  for (std::size_t wire = number_of_input_wires; wire < number_of_wires; ++wire) {
+    if (is_needed[wire] && !is_output[wire]) new_wires[wire] = next_wire++;
+  }
+  for (const auto wire : output_wires) new_wires[wire] = next_wire++;
+  std::vector<PrimitiveOperation> gates;
+  for (auto& gate : gates_) {
+    if (!is_needed[gate.output_wire]) continue;
+    gate.parent_a = new_wires[gate.parent_a];
+    if (gate.parent_b) gate.parent_b = new_wires[*gate.parent_b];
+    gate.output_wire = new_wires[gate.output_wire];
+    gates.push_back(gate);
+  }
+
+  AlgorithmDescription algorithm_description;
+  algorithm_description.number_of_input_wires_parent_a = bitlength_a_;
+  if (bitlength_b_ > 0) algorithm_description.number_of_input_wires_parent_b = bitlength_b_;
+  algorithm_description.number_of_output_wires = outputs.size();
+  algorithm_description.number_of_wires = next_wire;
+  algorithm_description.number_of_gates = gates.size();
+  algorithm_description.gates = std::move(gates);
+  return algorithm_description;
+}
+
+std::vector<Bit> AddRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                         const std::vector<Bit>& b, Bit carry_in, CircuitObjective objective) {
+  const std::size_t size{a.size()};
+  std::vector<Bit> sum(size);
+  if (objective == CircuitObjective::kSize) {
+    Bit carry{carry_in};
+    for (std::size_t i = 0; i < size; ++i) {
+      std::tie(sum[i], carry) = builder.FullAdder(a[i], b[i], carry, i + 1 < size);
+    }
+    return sum;
+  }
+
+  // Sklansky prefix tree on the generate and propagate bits of the groups of elements, where
+  // element 0 is the carry in and element i + 1 is bit i.  After the tree, generate[i] is the
+  // carry into bit i.  The propagate bits of the groups that start with element 0 are not needed
+  // and not computed.
+  std::vector<Bit> generate(size), propagate(size), propagate_bits(size);
+  generate[0] = carry_in;
+  for (std::size_t i = 0; i < size; ++i) {
+    propagate_bits[i] = builder.Xor(a[i], b[i]);
+    if (i + 1 < size) {
+      generate[i + 1] = builder.And(a[i], b[i]);
+      propagate[i + 1] = propagate_bits[i];
+    }
+  }
+  for (std::size_t span = 1; span < size; span *= 2) {
+    for (std::size_t i = 0; i < size; ++i) {
+      if ((i & span) == 0) continue;
+      // the group of element i is combined with the lower group ending at element j
+      const std::size_t first{i & ~(2 * span - 1)};
+      const std::size_t j{first + span - 1};
+      generate[i] = builder.Xor(generate[i], builder.And(propagate[i], generate[j]));
+      propagate[i] = first > 0 ? builder.And(propagate[i], propagate[j]) : kZero;
+    }
+  }
+  for (std::size_t i = 0; i < size; ++i) sum[i] = builder.Xor(propagate_bits[i], generate[i]);
+  return sum;
+}
+
+std::pair<std::vector<Bit>, Bit> SubtractRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                                              const std::vector<Bit>& b,
+                                              CircuitObjective objective) {
+  // a + ~b + 1 on one more bit, whose top bit is one iff there is no carry, i.e., a < b
+  const std::size_t size{a.size()};
+  std::vector<Bit> a_extended(a), b_inverted(size + 1, kOne);
+  a_extended.push_back(kZero);
+  for (std::size_t i = 0; i < size; ++i) b_inverted[i] = builder.Not(b[i]);
+  auto difference{AddRows(builder, a_extended, b_inverted, kOne, objective)};
+  const Bit is_less{difference.back()};
+  difference.pop_back();
+  return {difference, is_less};
+}
+
+std::vector<Bit> ConditionalNegation(CircuitBuilder& builder, const std::vector<Bit>& x,
+                                     const Bit& is_negative, CircuitObjective objective) {
+  std::vector<Bit> flipped(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i) flipped[i] = builder.Xor(x[i], is_negative);
+  return AddRows(builder, flipped, std::vector<Bit>(x.size()), is_negative, objective);
+}
+
+std::vector<Bit> DivideRows(CircuitBuilder& builder, const std::vector<Bit>& dividend,
+                            const std::vector<Bit>& divisor, CircuitObjective objective) {
+  const std::size_t size{dividend.size()};
+  // the partial remainder r in two's complement, which lies in [-divisor, divisor) after the
+  // first step and fits into size + 1 bits
+  std::vector<Bit> remainder(size + 1), shifted(size + 1), operand(size + 1);
+  std::vector<Bit> quotient(size);
+  // the divisor is subtracted from 2r + dividend_i if r is not negative and added otherwise
+  Bit subtract{kOne};
+  for (std::size_t i = size; i-- > 0;) {
+    shifted[0] = dividend[i];
+    std::copy(remainder.begin(), remainder.end() - 1, shifted.begin() + 1);
+    for (std::size_t j = 0; j < size; ++j) operand[j] = builder.Xor(divisor[j], subtract);
+    operand[size] = subtract;
+    remainder = AddRows(builder, shifted, operand, subtract, objective);
+    quotient[i] = builder.Not(remainder[size]);
+    subtract = quotient[i];
+  }
+  return quotient;
+}
+
+std::pair<std::vector<Bit>, std::vector<Bit>> ReduceColumns(CircuitBuilder& builder,
+                                                            std::vector<std::vector<Bit>> columns,
+                                                            CircuitObjective objective) {
+  // each column is reduced to at most two bits by full adders, whose carries go to the next
+  // column unless it is the last.  For CircuitObjective::kDepth, the adders take the bits of the
+  // lowest AND depth.
+  const auto is_deeper = [&builder](const Bit& x, const Bit& y) {
+    return builder.GetDepth(x) > builder.GetDepth(y);
+  };
+  const std::size_t size{columns.size()};
+  std::vector<Bit> row_a(size), row_b(size);
+  for (std::size_t k = 0; k < size; ++k) {
+    auto& column{columns[k]};
+    const bool needs_carry{k + 1 < size};
+    if (objective == CircuitObjective::kDepth) {
+      std::make_heap(column.begin(), column.end(), is_deeper);
+    }
+    const auto take = [&column, &is_deeper, objective]() {
+      if (objective == CircuitObjective::kDepth) {
+        std::pop_heap(column.begin(), column.end(), is_deeper);
+      }
+      const Bit bit{column.back()};
+      column.pop_back();
+      return bit;
+    };
+    const auto put = [&column, &is_deeper, objective](Bit bit) {
+      column.push_back(bit);
+      if (objective == CircuitObjective::kDepth) {
+        std::push_heap(column.begin(), column.end(), is_deeper);
+      }
+    };
+    while (column.size() > 2) {
+      // for the depth, three bits are reduced by a half adder, s.t. the deepest bit is kept
+      const bool is_half_adder{objective == CircuitObjective::kDepth && column.size() == 3};
+      const Bit x{take()}, y{take()}, z{is_half_adder ? kZero : take()};
+      const auto [sum, carry]{builder.FullAdder(x, y, z, needs_carry)};
+      put(sum);
+      if (needs_carry) columns[k + 1].push_back(carry);
+    }
+    if (column.size() > 0) row_a[k] = column[0];
+    if (column.size() > 1) row_b[k] = column[1];
+  }
+  return {row_a, row_b};
+}
+
+std::vector<Bit> MultiplyRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                              const std::vector<Bit>& b, std::size_t size,
+                              CircuitObjective objective) {
+  // the partial products of the bits of the result
+  std::vector<std::vector<Bit>> columns(size);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    for (std::size_t j = 0; j < b.size() && i + j < size; ++j) {
+      const Bit product{builder.And(a[i], b[j])};
+      if (product.wire || product.is_inverted) columns[i + j].push_back(product);
+    }
+  }
+  const auto [row_a, row_b]{ReduceColumns(builder, std::move(columns), objective)};
+  return AddRows(builder, row_a, row_b, kZero, objective);
+}
+
+Bit OrBits(CircuitBuilder& builder, std::vector<Bit> bits) {
+  if (bits.empty()) return kZero;
+  while (bits.size() > 1) {
+    std::vector<Bit> next;
+    for (std::size_t i = 0; i + 1 < bits.size(); i += 2) {
+      next.push_back(builder.Or(bits[i], bits[i + 1]));
+    }
+    if (bits.size() % 2 == 1) next.push_back(bits.back());
+    bits = std::move(next);
+  }
+  return bits[0];
+}
+
+std::pair<std::vector<Bit>, std::vector<Bit>> GetInputs(const CircuitBuilder& builder,
+                                                         std::size_t bitlength) {
+  std::vector<Bit> a(bitlength), b(bitlength);
+  for (std::size_t i = 0; i < bitlength; ++i) {
+    a[i] = builder.InputA(i);
+    b[i] = builder.InputB(i);
+  }
+  return {a, b};
+}
+
+}  // namespace encrypto::motion::detail
@@ -0,0 +1,175 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "algorithm_description.h"
+#include "circuit_optimizer.h"
+
+// building blocks of the generated circuits of integer_circuits.h and float_circuits.h
+
+namespace encrypto::motion::detail {
+
+/// \brief A wire of a generated circuit or a constant if wire is std::nullopt, either possibly
+/// inverted.
+struct Bit {
+  std::optional<std::size_t> wire{std::nullopt};
+  bool is_inverted{false};
+};
+
+constexpr Bit kZero{};
+constexpr Bit kOne{.is_inverted = true};
+
+/// \brief Builds a circuit on inputs of bitlength_a and bitlength_b bits, where the gates on
+/// constants and inversions are folded and the AND depth of each wire is tracked.
+class CircuitBuilder {
+ public:
+  CircuitBuilder(std::size_t bitlength_a, std::size_t bitlength_b)
+      : bitlength_a_(bitlength_a),
+        bitlength_b_(bitlength_b),
+        depths_(bitlength_a + bitlength_b, 0),
+        inversions_(bitlength_a + bitlength_b) {}
+
+  explicit CircuitBuilder(std::size_t bitlength) : CircuitBuilder(bitlength, bitlength) {}
+
+  Bit InputA(std::size_t i) const { return Bit{.wire = i}; }
+
+  Bit InputB(std::size_t i) const { return Bit{.wire = bitlength_a_ + i}; }
+
+  std::size_t GetDepth(const Bit& a) const { return a.wire ? depths_[*a.wire] : 0; }
+
+  Bit Not(const Bit& a) const { return Bit{.wire = a.wire, .is_inverted = !a.is_inverted}; }
+
+  Bit Xor(const Bit& a, const Bit& b) {
+    const bool is_inverted{a.is_inverted != b.is_inverted};
+    if (!a.wire) return Bit{.wire = b.wire, .is_inverted = is_inverted};
+    if (!b.wire) return Bit{.wire = a.wire, .is_inverted = is_inverted};
+    return Bit{.wire = Emit(PrimitiveOperationType::kXor, *a.wire, *b.wire,
+                            std::max(GetDepth(a), GetDepth(b))),
+               .is_inverted = is_inverted};
+  }
+
+  Bit And(const Bit& a, const Bit& b) {
+    if (!a.wire) return a.is_inverted ? b : kZero;
+    if (!b.wire) return b.is_inverted ? a : kZero;
+    return Bit{.wire = Emit(PrimitiveOperationType::kAnd, Materialize(a), Materialize(b),
+                            std::max(GetDepth(a), GetDepth(b)) + 1)};
+  }
+
+  Bit Or(const Bit& a, const Bit& b) { return Not(And(Not(a), Not(b))); }
+
+  /// \brief Returns selection ? a : b by one AND gate.
+  Bit Mux(const Bit& selection, const Bit& a, const Bit& b) {
+    return Xor(b, And(selection, Xor(a, b)));
+  }
+
+  /// \brief Returns the sum and, if needed, the carry of a + b + c by at most one AND gate.
+  std::pair<Bit, Bit> FullAdder(Bit a, Bit b, Bit c, bool needs_carry) {
+    if (!a.wire) std::swap(a, c);
+    if (!b.wire) std::swap(b, c);
+    const Bit sum{Xor(Xor(a, b), c)};
+    if (!needs_carry) return {sum, kZero};
+    return {sum, Xor(c, And(Xor(a, c), Xor(b, c)))};
+  }
+
+  /// \brief Makes outputs the last wires of the circuit in their order and removes the gates that
+  /// no output depends on.
+  AlgorithmDescription Build(const std::vector<Bit>& outputs) &&;
+
+ private:
+  std::size_t Emit(PrimitiveOperationType type, std::size_t a, std::optional<std::size_t> b,
+                   std::size_t depth) {
+    const std::size_t output_wire{depths_.size()};
+    gates_.emplace_back(
+        PrimitiveOperation{.type = type, .parent_a = a, .parent_b = b, .output_wire = output_wire});
+    depths_.push_back(depth);
+    inversions_.emplace_back();
+    return output_wire;
+  }
+
+  // returns the wire of a, which is computed by an inversion gate if a is inverted
+  std::size_t Materialize(const Bit& a) {
+    const std::size_t wire{*a.wire};
+    if (!a.is_inverted) return wire;
+    if (!inversions_[wire]) {
+      inversions_[wire] = Emit(PrimitiveOperationType::kInv, wire, std::nullopt, depths_[wire]);
+    }
+    return *inversions_[wire];
+  }
+
+  std::size_t bitlength_a_;
+  std::size_t bitlength_b_;
+  std::vector<std::size_t> depths_;
+  // the inversion gate of each wire if there is one
+  std::vector<std::optional<std::size_t>> inversions_;
+  std::vector<PrimitiveOperation> gates_;
+};
+
+// All rows hold the bits of unsigned integers with the least significant bit first.
+
+/// \brief Adds the rows a and b of the same size and the carry in modulo 2^size by a ripple-carry
+/// adder for CircuitObjective::kSize and a Sklansky adder for CircuitObjective::kDepth.
+std::vector<Bit> AddRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                         const std::vector<Bit>& b, Bit carry_in, CircuitObjective objective);
+
+/// \brief Returns a - b modulo 2^size for the rows a and b of the same size and whether a < b.
+std::pair<std::vector<Bit>, Bit> SubtractRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                                              const std::vector<Bit>& b,
+                                              CircuitObjective objective);
+
+/// \brief Returns -x if is_negative is one and x otherwise, i.e., (x ^ is_negative) + is_negative.
+std::vector<Bit> ConditionalNegation(CircuitBuilder& builder, const std::vector<Bit>& x,
+                                     const Bit& is_negative, CircuitObjective objective);
+
+/// \brief Returns the quotient of the non-restoring division of the dividend by the divisor,
+/// which is all ones for a divisor of zero.
+std::vector<Bit> DivideRows(CircuitBuilder& builder, const std::vector<Bit>& dividend,
+                            const std::vector<Bit>& divisor, CircuitObjective objective);
+
+/// \brief Reduces the bits of each column, whose weight is its index, to the two rows of the same
+/// weights modulo 2^columns.size().
+std::pair<std::vector<Bit>, std::vector<Bit>> ReduceColumns(CircuitBuilder& builder,
+                                                            std::vector<std::vector<Bit>> columns,
+                                                            CircuitObjective objective);
+
+/// \brief Returns the product of the rows a and b modulo 2^size, where size is at most
+/// a.size() + b.size().  The bits of constant rows are folded, s.t. multiplying by a constant
+/// only adds the shifted copies of the other row.
+std::vector<Bit> MultiplyRows(CircuitBuilder& builder, const std::vector<Bit>& a,
+                              const std::vector<Bit>& b, std::size_t size,
+                              CircuitObjective objective);
+
+/// \brief Returns the OR of the bits, which is zero for no bits, by a tree of the least AND depth.
+Bit OrBits(CircuitBuilder& builder, std::vector<Bit> bits);
+
+/// \brief The bits of inputs a and b of the builder, least significant bit first.
+std::pair<std::vector<Bit>, std::vector<Bit>> GetInputs(const CircuitBuilder& builder,
+                                                         std::size_t bitlength);
+
+}  // namespace encrypto::motion::detail
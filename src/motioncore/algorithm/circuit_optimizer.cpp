@@ -0,0 +1,475 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "circuit_optimizer.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+namespace {
+
+// literals are 2 * node + complemented, where node 0 is the constant zero
+using Literal = std::size_t;
+
+constexpr Literal kFalse{0};
+constexpr Literal kTrue{1};
+
+constexpr std::size_t GetNode(Literal literal) { return literal >> 1; }
+
+constexpr bool IsComplemented(Literal literal) { return literal & 1; }
+
+constexpr Literal MakeLiteral(std::size_t node) { return node << 1; }
+
+enum class XagNodeType : std::uint8_t { kConstant, kInput, kAnd, kXor };
+
+struct XagNode {
+  XagNodeType type;
+  Literal a{0}, b{0};
+};
+
+struct XagNodeHash {
+  std::size_t operator()(const std::tuple<XagNodeType, Literal, Literal>& key) const {
+    const auto [type, a, b] = key;
+    return std::hash<std::size_t>{}((a * 0x9e3779b97f4a7c15ULL) ^ (b << 2) ^
+                                    static_cast<std::size_t>(type));
+  }
+};
+
+// graph of AND and XOR nodes with complemented edges in topological order, which merges nodes on
+// the same inputs and propagates constants on construction.  The inputs of XOR nodes are never
+// complemented, their complements are moved to the output.
+class Xag {
+ public:
+  explicit Xag(std::size_t number_of_inputs) : number_of_inputs_(number_of_inputs) {
+    nodes_.push_back({XagNodeType::kConstant});
+    depths_.push_back(0);
+    for (std::size_t i = 0; i < number_of_inputs; ++i) {
+      nodes_.push_back({XagNodeType::kInput});
+      depths_.push_back(0);
+    }
+  }
+
+  Literal GetInput(std::size_t input) const { return MakeLiteral(input + 1); }
+
+  Literal And(Literal a, Literal b) {
+    if (a > b) std::swap(a, b);
+    if (a == kFalse) return kFalse;
+    if (a == kTrue) return b;
+    if (a == b) return a;
+    if ((a ^ 1) == b) return kFalse;
+    return Add(XagNodeType::kAnd, a, b, std::max(GetDepth(a), GetDepth(b)) + 1);
+  }
+
+  Literal Xor(Literal a, Literal b) {
+    const Literal complement{(a ^ b) & 1};
+    a &= ~Literal(1);
+    b &= ~Literal(1);
+    if (a > b) std::swap(a, b);
+    if (a == b) return complement;
+    if (a == kFalse) return b ^ complement;
+    return Add(XagNodeType::kXor, a, b, std::max(GetDepth(a), GetDepth(b))) ^ complement;
+  }
+
+  const std::vector<XagNode>& GetNodes() const noexcept { return nodes_; }
+
+  std::size_t GetNumberOfInputs() const noexcept { return number_of_inputs_; }
+
+  // AND depth of the node of literal
+  std::size_t GetDepth(Literal literal) const { return depths_[GetNode(literal)]; }
+
+  std::size_t GetNumberOfAndNodes() const noexcept { return number_of_and_nodes_; }
+
+  std::size_t GetAndDepth() const {
+    std::size_t depth{0};
+    for (const auto output : outputs_) depth = std::max(depth, GetDepth(output));
+    return depth;
+  }
+
+  void AddOutput(Literal output) { outputs_.push_back(output); }
+
+  const std::vector<Literal>& GetOutputs() const noexcept { return outputs_; }
+
+ private:
+  Literal Add(XagNodeType type, Literal a, Literal b, std::size_t depth) {
+    const auto [iterator, inserted] = hash_table_.try_emplace({type, a, b}, nodes_.size());
+    if (inserted) {
+      nodes_.push_back({type, a, b});
+      depths_.push_back(depth);
+      if (type == XagNodeType::kAnd) ++number_of_and_nodes_;
+    }
+    return MakeLiteral(iterator->second);
+  }
+
+  std::size_t number_of_inputs_;
+  std::size_t number_of_and_nodes_{0};
+  std::vector<XagNode> nodes_;
+  std::vector<std::size_t> depths_;
+  std::vector<Literal> outputs_;
+  std::unordered_map<std::tuple<XagNodeType, Literal, Literal>, std::size_t, XagNodeHash>
+      hash_table_;
+};
+
+bool IsGate(const XagNode& node) {
+  return node.type == XagNodeType::kAnd || node.type == XagNodeType::kXor;
+}
+
+// number of references to each node by other nodes and by the outputs
+std::vector<std::size_t> CountFanouts(const Xag& xag) {
+  const auto& nodes{xag.GetNodes()};
+  std::vector<std::size_t> fanouts(nodes.size(), 0);
+  for (const auto& node : nodes) {
+    if (IsGate(node)) {
+      ++fanouts[GetNode(node.a)];
+      ++fanouts[GetNode(node.b)];
+    }
+  }
+  for (const auto output : xag.GetOutputs()) ++fanouts[GetNode(output)];
+  return fanouts;
+}
+
+// rebuilds xag node by node in topological order, where rewrite(node, map, result) returns the
+// literal of a node in result or std::nullopt to copy it
+template <typename Rewrite>
+Xag Rebuild(const Xag& xag, Rewrite rewrite) {
+  const auto& nodes{xag.GetNodes()};
+  // dead gate removal: only the nodes that the outputs depend on are rebuilt
+  std::vector<bool> live(nodes.size(), false);
+  for (const auto output : xag.GetOutputs()) live[GetNode(output)] = true;
+  for (std::size_t node = nodes.size(); node-- > 0;) {
+    if (live[node] && IsGate(nodes[node])) {
+      live[GetNode(nodes[node].a)] = true;
+      live[GetNode(nodes[node].b)] = true;
+    }
+  }
+
+  Xag result(xag.GetNumberOfInputs());
+  std::vector<Literal> map(nodes.size(), kFalse);
+  const auto map_literal = [&map](Literal literal) {
+    return map[GetNode(literal)] ^ (literal & 1);
+  };
+  for (std::size_t input = 0; input < xag.GetNumberOfInputs(); ++input) {
+    map[GetNode(xag.GetInput(input))] = result.GetInput(input);
+  }
+  for (std::size_t node = 0; node < nodes.size(); ++node) {
+    if (!live[node] || !IsGate(nodes[node])) continue;
+    if (const auto rewritten{rewrite(node, map_literal, result)}) {
+      map[node] = *rewritten;
+    } else if (nodes[node].type == XagNodeType::kAnd) {
+      map[node] = result.And(map_literal(nodes[node].a), map_literal(nodes[node].b));
+    } else {
+      map[node] = result.Xor(map_literal(nodes[node].a), map_literal(nodes[node].b));
+    }
+  }
+  for (const auto output : xag.GetOutputs()) result.AddOutput(map_literal(output));
+  return result;
+}
+
+// structural hashing, constant propagation and dead gate removal
+Xag Sweep(const Xag& xag) {
+  return Rebuild(xag, [](std::size_t, const auto&, Xag&) { return std::optional<Literal>{}; });
+}
+
+// replaces (a & b) ^ (a & c) by a & (b ^ c) if the AND nodes have no other references
+Xag RewriteXors(const Xag& xag) {
+  const auto& nodes{xag.GetNodes()};
+  const auto fanouts{CountFanouts(xag)};
+  return Rebuild(xag, [&](std::size_t node, const auto& map_literal,
+                          Xag& result) -> std::optional<Literal> {
+    const auto& xor_node{nodes[node]};
+    if (xor_node.type != XagNodeType::kXor) return std::nullopt;
+    const auto& x{nodes[GetNode(xor_node.a)]};
+    const auto& y{nodes[GetNode(xor_node.b)]};
+    if (x.type != XagNodeType::kAnd || y.type != XagNodeType::kAnd ||
+        fanouts[GetNode(xor_node.a)] != 1 || fanouts[GetNode(xor_node.b)] != 1) {
+      return std::nullopt;
+    }
+    for (const auto& [common, other_x] : {std::pair{x.a, x.b}, std::pair{x.b, x.a}}) {
+      if (common == y.a || common == y.b) {
+        const Literal other_y{common == y.a ? y.b : y.a};
+        return result.And(map_literal(common),
+                          result.Xor(map_literal(other_x), map_literal(other_y)));
+      }
+    }
+    return std::nullopt;
+  });
+}
+
+// turns trees of AND nodes, whose inner nodes have no other references, into trees of minimal
+// depth by always combining the two shallowest inputs
+Xag BalanceAnds(const Xag& xag) {
+  const auto& nodes{xag.GetNodes()};
+  const auto fanouts{CountFanouts(xag)};
+  // inner nodes of a tree, which are only referenced uncomplemented by another AND node
+  std::vector<bool> inner(nodes.size(), false);
+  for (const auto& node : nodes) {
+    if (node.type != XagNodeType::kAnd) continue;
+    for (const auto literal : {node.a, node.b}) {
+      if (!IsComplemented(literal) && nodes[GetNode(literal)].type == XagNodeType::kAnd &&
+          fanouts[GetNode(literal)] == 1) {
+        inner[GetNode(literal)] = true;
+      }
+    }
+  }
+  return Rebuild(xag, [&](std::size_t node, const auto& map_literal,
+                          Xag& result) -> std::optional<Literal> {
+    if (nodes[node].type != XagNodeType::kAnd) return std::nullopt;
+    // inner nodes are rebuilt as part of their tree and stay dead
+    if (inner[node]) return kFalse;
+    using Leaf = std::pair<std::size_t, Literal>;
+    std::priority_queue<Leaf, std::vector<Leaf>, std::greater<Leaf>> leaves;
+    std::vector<Literal> stack{nodes[node].a, nodes[node].b};
+    while (!stack.empty()) {
+      const auto literal{stack.back()};
+      stack.pop_back();
+      if (!IsComplemented(literal) && inner[GetNode(literal)]) {
+        stack.push_back(nodes[GetNode(literal)].a);
+        stack.push_back(nodes[GetNode(literal)].b);
+      } else {
+        const auto leaf{map_literal(literal)};
+        leaves.emplace(result.GetDepth(leaf), leaf);
+      }
+    }
+    while (leaves.size() > 1) {
+      const auto first{leaves.top().second};
+      leaves.pop();
+      const auto second{leaves.top().second};
+      leaves.pop();
+      const auto combined{result.And(first, second)};
+      leaves.emplace(result.GetDepth(combined), combined);
+    }
+    return leaves.top().second;
+  });
+}
+
+Xag ToXag(const AlgorithmDescription& algorithm_description) {
+  const std::size_t number_of_inputs{
+      algorithm_description.number_of_input_wires_parent_a +
+      algorithm_description.number_of_input_wires_parent_b.value_or(0)};
+  if (number_of_inputs == 0) {
+    throw std::invalid_argument("Cannot optimize a circuit without inputs");
+  }
+  const std::size_t number_of_wires{
+      std::max(algorithm_description.number_of_wires, number_of_inputs)};
+  if (algorithm_description.number_of_output_wires > number_of_wires) {
+    throw std::invalid_argument("Circuit has more output wires than wires");
+  }
+  Xag xag(number_of_inputs);
+  std::vector<std::optional<Literal>> literals(number_of_wires);
+  for (std::size_t input = 0; input < number_of_inputs; ++input) {
+    literals[input] = xag.GetInput(input);
+  }
+  const auto get_literal = [&literals](std::optional<std::size_t> wire) {
+    if (!wire || *wire >= literals.size() || !literals[*wire]) {
+      throw std::invalid_argument("Gate reads a wire that has not been assigned before");
+    }
+    return *literals[*wire];
+  };
+  for (const auto& gate : algorithm_description.gates) {
+    if (gate.output_wire >= literals.size()) {
+      throw std::invalid_argument(
+          fmt::format("Output wire {} of a gate exceeds the number of wires {}", gate.output_wire,
+                      literals.size()));
+    }
+    auto& literal{literals[gate.output_wire]};
+    switch (gate.type) {
+      case PrimitiveOperationType::kXor:
+        literal = xag.Xor(get_literal(gate.parent_a), get_literal(gate.parent_b));
+        break;
+      case PrimitiveOperationType::kAnd:
+        literal = xag.And(get_literal(gate.parent_a), get_literal(gate.parent_b));
+        break;
+      case PrimitiveOperationType::kOr:
+        literal = xag.And(get_literal(gate.parent_a) ^ 1, get_literal(gate.parent_b) ^ 1) ^ 1;
+        break;
+      case PrimitiveOperationType::kInv:
+        literal = get_literal(gate.parent_a) ^ 1;
+        break;
+      default:
+        throw std::invalid_argument(fmt::format("Cannot optimize circuits with {} gates",
+                                                to_string(gate.type)));
+    }
+  }
+  for (std::size_t wire = number_of_wires - algorithm_description.number_of_output_wires;
+       wire < number_of_wires; ++wire) {
+    xag.AddOutput(get_literal(wire));
+  }
+  return xag;
+}
+
+AlgorithmDescription ToAlgorithmDescription(const Xag& xag,
+                                            const AlgorithmDescription& original) {
+  AlgorithmDescription result;
+  result.number_of_input_wires_parent_a = original.number_of_input_wires_parent_a;
+  result.number_of_input_wires_parent_b = original.number_of_input_wires_parent_b;
+  result.number_of_output_wires = xag.GetOutputs().size();
+
+  const auto& nodes{xag.GetNodes()};
+  std::size_t next_wire{xag.GetNumberOfInputs()};
+  const auto add_gate = [&result, &next_wire](PrimitiveOperationType type, std::size_t parent_a,
+                                               std::optional<std::size_t> parent_b) {
+    result.gates.push_back({.type = type,
+                            .parent_a = parent_a,
+                            .parent_b = parent_b,
+                            .output_wire = next_wire});
+    return next_wire++;
+  };
+  const auto get_gate_type = [](const XagNode& node) {
+    return node.type == XagNodeType::kAnd ? PrimitiveOperationType::kAnd
+                                          : PrimitiveOperationType::kXor;
+  };
+
+  std::vector<std::size_t> wires(nodes.size(), 0);
+  std::vector<std::optional<std::size_t>> inverted_wires(nodes.size());
+  for (std::size_t input = 0; input < xag.GetNumberOfInputs(); ++input) {
+    wires[GetNode(xag.GetInput(input))] = input;
+  }
+  const auto get_wire = [&](Literal literal) {
+    const auto node{GetNode(literal)};
+    if (!IsComplemented(literal)) return wires[node];
+    if (!inverted_wires[node]) {
+      inverted_wires[node] = add_gate(PrimitiveOperationType::kInv, wires[node], std::nullopt);
+    }
+    return *inverted_wires[node];
+  };
+
+  // the gate of a node that is only referenced uncomplemented by a single output is the gate of
+  // that output, all other outputs need a gate of their own since they are the last wires
+  std::vector<std::size_t> gate_fanouts(nodes.size(), 0), output_references(nodes.size(), 0);
+  for (const auto& node : nodes) {
+    if (IsGate(node)) {
+      ++gate_fanouts[GetNode(node.a)];
+      ++gate_fanouts[GetNode(node.b)];
+    }
+  }
+  for (const auto output : xag.GetOutputs()) {
+    // complemented references count twice, s.t. they are never the gate of the output
+    output_references[GetNode(output)] += IsComplemented(output) ? 2 : 1;
+  }
+  const auto is_output_gate = [&](std::size_t node) {
+    return IsGate(nodes[node]) && gate_fanouts[node] == 0 && output_references[node] == 1;
+  };
+
+  for (std::size_t node = 0; node < nodes.size(); ++node) {
+    if (IsGate(nodes[node]) && !is_output_gate(node)) {
+      wires[node] = add_gate(get_gate_type(nodes[node]), get_wire(nodes[node].a),
+                             get_wire(nodes[node].b));
+    }
+  }
+  // the inverted inputs of the output gates and the constant zero for copies are no outputs
+  std::optional<std::size_t> zero_wire;
+  for (const auto output : xag.GetOutputs()) {
+    const auto node{GetNode(output)};
+    if (is_output_gate(node)) {
+      get_wire(nodes[node].a);
+      get_wire(nodes[node].b);
+    } else if (!zero_wire && (output == kTrue || (output != kFalse && !IsComplemented(output)))) {
+      zero_wire = add_gate(PrimitiveOperationType::kXor, 0, 0);
+    }
+  }
+  for (const auto output : xag.GetOutputs()) {
+    const auto node{GetNode(output)};
+    if (is_output_gate(node)) {
+      add_gate(get_gate_type(nodes[node]), get_wire(nodes[node].a), get_wire(nodes[node].b));
+    } else if (output == kFalse) {
+      add_gate(PrimitiveOperationType::kXor, 0, 0);
+    } else if (output == kTrue) {
+      add_gate(PrimitiveOperationType::kInv, *zero_wire, std::nullopt);
+    } else if (IsComplemented(output)) {
+      add_gate(PrimitiveOperationType::kInv, wires[node], std::nullopt);
+    } else {
+      add_gate(PrimitiveOperationType::kXor, wires[node], *zero_wire);
+    }
+  }
+  result.number_of_gates = result.gates.size();
+  result.number_of_wires = next_wire;
+  return result;
+}
+
+}  // namespace
+
+AlgorithmStatistics GetAlgorithmStatistics(const AlgorithmDescription& algorithm_description) {
+  AlgorithmStatistics statistics;
+  std::vector<std::size_t> depths(algorithm_description.number_of_wires, 0);
+  const auto get_depth = [&depths](std::optional<std::size_t> wire) {
+    return wire && *wire < depths.size() ? depths[*wire] : 0;
+  };
+  for (const auto& gate : algorithm_description.gates) {
+    std::size_t depth{std::max(get_depth(gate.parent_a), get_depth(gate.parent_b))};
+    switch (gate.type) {
+      case PrimitiveOperationType::kXor:
+        ++statistics.number_of_xor_gates;
+        break;
+      case PrimitiveOperationType::kAnd:
+      case PrimitiveOperationType::kOr:
+        ++statistics.number_of_and_gates;
+        ++depth;
+        break;
+      case PrimitiveOperationType::kInv:
+        ++statistics.number_of_inv_gates;
+        break;
+      default:
+        throw std::invalid_argument(
+            fmt::format("Cannot count {} gates", to_string(gate.type)));
+    }
+    if (gate.output_wire < depths.size()) depths[gate.output_wire] = depth;
+    statistics.and_depth = std::max(statistics.and_depth, depth);
+  }
+  return statistics;
+}
+
+AlgorithmDescription OptimizeCircuit(const AlgorithmDescription& algorithm_description,
+                                     CircuitObjective objective) {
+  Xag xag{Sweep(ToXag(algorithm_description))};
+  const auto is_better = [objective](const Xag& candidate, const Xag& current) {
+    const auto size{std::pair{candidate.GetNumberOfAndNodes(), current.GetNumberOfAndNodes()}};
+    const auto depth{std::pair{candidate.GetAndDepth(), current.GetAndDepth()}};
+    if (objective == CircuitObjective::kSize) {
+      return size.first < size.second || (size.first == size.second && depth.first < depth.second);
+    }
+    return depth.first < depth.second || (depth.first == depth.second && size.first < size.second);
+  };
+  // each rewrite may enable another one on the resulting AND node
+  while (true) {
+    Xag rewritten{Sweep(RewriteXors(xag))};
+    if (!is_better(rewritten, xag)) break;
+    xag = std::move(rewritten);
+  }
+  if (objective == CircuitObjective::kDepth) {
+    if (Xag balanced{BalanceAnds(xag)}; is_better(balanced, xag)) xag = std::move(balanced);
+  }
+  return ToAlgorithmDescription(xag, algorithm_description);
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,66 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion {
+
+/// \brief The cost that OptimizeCircuit minimizes first.  The number of AND gates determines the
+///        communication of all protocols and the run time of BMR and garbled circuits, whereas
+///        the AND depth determines the number of rounds of GMW.
+enum class CircuitObjective : std::uint8_t { kSize, kDepth };
+
+struct AlgorithmStatistics {
+  // AND and OR gates
+  std::size_t number_of_and_gates{0};
+  std::size_t number_of_xor_gates{0};
+  std::size_t number_of_inv_gates{0};
+  // largest number of AND gates on a path from an input to an output
+  std::size_t and_depth{0};
+};
+
+/// \brief Counts the gates of a Boolean circuit consisting of kXor, kAnd, kOr and kInv gates.
+/// \throws std::invalid_argument for other gates
+AlgorithmStatistics GetAlgorithmStatistics(const AlgorithmDescription& algorithm_description);
+
+/// \brief Optimizes a Boolean circuit, e.g., one imported from a third party.  The circuit is
+/// converted into a graph of AND and XOR nodes with complemented edges, on which
+///   - structural hashing merges nodes on the same inputs and propagates constants,
+///   - XOR rewriting replaces (a & b) ^ (a & c) by a & (b ^ c),
+///   - dead gate removal drops the nodes that no output depends on, and
+///   - for CircuitObjective::kDepth, AND rebalancing turns chains of AND and OR gates into trees
+///     of minimal depth, which keeps their number of AND gates.
+/// The result computes the same outputs from the same inputs.  It consists of kXor, kAnd and kInv
+/// gates, where copies of inputs and constants are XOR gates with a constant zero wire x ^ x.
+/// \throws std::invalid_argument for gates other than kXor, kAnd, kOr and kInv, e.g., kLut, or for
+///         circuits without inputs
+AlgorithmDescription OptimizeCircuit(const AlgorithmDescription& algorithm_description,
+                                     CircuitObjective objective);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,297 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "costco_circuit.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+#include "base/party.h"
+#include "utility/bit_vector.h"
+#include "utility/mapped_column.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+constexpr std::array<char, 8> kBinaryMagic{'M', 'O', 'T', 'I', 'O', 'N', 'C', 'G'};
+constexpr std::uint64_t kBinaryVersion{1};
+constexpr std::size_t kBinaryHeaderSize{kBinaryMagic.size() + 3 * sizeof(std::uint64_t)};
+
+const std::unordered_map<std::string_view, CostcoGateType> kGateTypes{
+    {"INPUT0", CostcoGateType::kInput0},
+    {"INPUT1", CostcoGateType::kInput1},
+    {"A2Y", CostcoGateType::kToBmr},
+    {"B2Y", CostcoGateType::kToBmr},
+    {"A2B", CostcoGateType::kToBooleanGmw},
+    {"Y2B", CostcoGateType::kToBooleanGmw},
+    {"B2A", CostcoGateType::kToArithmeticGmw},
+    {"Y2A", CostcoGateType::kToArithmeticGmw},
+    {"OUTPUT", CostcoGateType::kOutput},
+    {"MUL", CostcoGateType::kMultiplication},
+    {"ADD", CostcoGateType::kAddition},
+    {"SUB", CostcoGateType::kSubtraction},
+    {"DIV", CostcoGateType::kDivision},
+    {"AND", CostcoGateType::kAnd},
+    {"OR", CostcoGateType::kOr},
+    {"XOR", CostcoGateType::kXor},
+    {"GT", CostcoGateType::kGreaterThan},
+    {"LT", CostcoGateType::kLessThan},
+    {"GE", CostcoGateType::kGreaterEqual},
+    {"LE", CostcoGateType::kLessEqual},
+    {"EQ", CostcoGateType::kEqual},
+    {"NE", CostcoGateType::kNotEqual}};
+
+std::size_t GetNumberOfInputs(CostcoGateType type) {
+  switch (type) {
+    case CostcoGateType::kInput0:
+    case CostcoGateType::kInput1:
+      return 0;
+    case CostcoGateType::kToBmr:
+    case CostcoGateType::kToBooleanGmw:
+    case CostcoGateType::kToArithmeticGmw:
+    case CostcoGateType::kOutput:
+      return 1;
+    default:
+      return 2;
+  }
+}
+
+template <typename T>
+void WriteValues(std::ofstream& stream, std::span<const T> values) {
+  stream.write(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+}
+
+template <typename T>
+std::vector<T> ReadValues(std::span<const std::byte> bytes, std::size_t& position,
+                          std::size_t number_of_values, const std::string& path) {
+  if (bytes.size() - position < number_of_values * sizeof(T)) {
+    throw std::runtime_error(fmt::format("Costco circuit {} is truncated", path));
+  }
+  std::vector<T> values(number_of_values);
+  std::memcpy(values.data(), bytes.data() + position, number_of_values * sizeof(T));
+  position += number_of_values * sizeof(T);
+  return values;
+}
+
+}  // namespace
+
+CostcoCircuit CostcoCircuit::FromText(std::istream& stream) {
+  CostcoCircuit circuit;
+  std::unordered_map<std::string, std::uint32_t> gate_ids;
+  // (parent, name of the child) in the order of the lines of the parents
+  std::vector<std::pair<std::uint32_t, std::string>> edges;
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.starts_with('#')) continue;
+    std::istringstream tokens(line);
+    std::string name;
+    if (!(tokens >> name)) continue;
+    const auto type{kGateTypes.find(std::string_view(name).substr(0, name.find('_')))};
+    if (type == kGateTypes.end()) {
+      throw std::invalid_argument(fmt::format("Unknown type of Costco gate {}", name));
+    }
+    const auto gate_id{static_cast<std::uint32_t>(circuit.gate_types.size())};
+    if (!gate_ids.try_emplace(name, gate_id).second) {
+      throw std::invalid_argument(fmt::format("Costco gate {} is listed twice", name));
+    }
+    circuit.gate_types.push_back(type->second);
+    for (std::string child; tokens >> child;) edges.emplace_back(gate_id, std::move(child));
+  }
+
+  // sort the parents into the inputs of their children, keeping the order of the lines
+  const auto number_of_gates{circuit.gate_types.size()};
+  std::vector<std::uint32_t> children(edges.size());
+  circuit.input_offsets.assign(number_of_gates + 1, 0);
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    const auto child{gate_ids.find(edges[i].second)};
+    if (child == gate_ids.end()) {
+      throw std::invalid_argument(fmt::format("Costco gate {} is not listed", edges[i].second));
+    }
+    if (child->second <= edges[i].first) {
+      throw std::invalid_argument(
+          fmt::format("Costco gate {} is listed before its input", edges[i].second));
+    }
+    children[i] = child->second;
+    ++circuit.input_offsets[child->second + 1];
+  }
+  for (std::size_t gate = 0; gate < number_of_gates; ++gate) {
+    const auto number_of_inputs{circuit.input_offsets[gate + 1]};
+    if (number_of_inputs != GetNumberOfInputs(circuit.gate_types[gate])) {
+      throw std::invalid_argument(fmt::format("Costco gate #{} has {} instead of {} inputs", gate,
+                                              number_of_inputs,
+                                              GetNumberOfInputs(circuit.gate_types[gate])));
+    }
+    circuit.input_offsets[gate + 1] += circuit.input_offsets[gate];
+  }
+  circuit.inputs.resize(edges.size());
+  std::vector<std::uint32_t> positions(circuit.input_offsets.begin(),
+                                       circuit.input_offsets.end() - 1);
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    circuit.inputs[positions[children[i]]++] = edges[i].first;
+  }
+  return circuit;
+}
+
+CostcoCircuit CostcoCircuit::FromFile(const std::string& path) {
+  {
+    const MappedFile file(path);
+    const auto bytes{file.GetBytes()};
+    if (bytes.size() >= kBinaryHeaderSize &&
+        std::memcmp(bytes.data(), kBinaryMagic.data(), kBinaryMagic.size()) == 0) {
+      std::size_t position{kBinaryMagic.size()};
+      const auto header{ReadValues<std::uint64_t>(bytes, position, 3, path)};
+      if (header[0] != kBinaryVersion) {
+        throw std::runtime_error(
+            fmt::format("Costco circuit {} has the unsupported version {}", path, header[0]));
+      }
+      CostcoCircuit circuit;
+      circuit.gate_types = ReadValues<CostcoGateType>(bytes, position, header[1], path);
+      circuit.input_offsets = ReadValues<std::uint32_t>(bytes, position, header[1] + 1, path);
+      circuit.inputs = ReadValues<std::uint32_t>(bytes, position, header[2], path);
+      return circuit;
+    }
+  }
+  std::ifstream stream(path);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("Could not open Costco circuit {}", path));
+  }
+  return FromText(stream);
+}
+
+void CostcoCircuit::ToBinary(const std::string& path) const {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("Could not create Costco circuit {}", path));
+  }
+  stream.write(kBinaryMagic.data(), kBinaryMagic.size());
+  const std::array<std::uint64_t, 3> header{kBinaryVersion, gate_types.size(), inputs.size()};
+  WriteValues<std::uint64_t>(stream, header);
+  WriteValues(stream, std::span(gate_types));
+  WriteValues(stream, std::span(input_offsets));
+  WriteValues(stream, std::span(inputs));
+  stream.close();
+  if (stream.fail()) {
+    throw std::runtime_error(fmt::format("Could not write Costco circuit {}", path));
+  }
+}
+
+std::vector<ShareWrapper> CostcoCircuit::Build(Party& party, MpcProtocol protocol,
+                                               std::size_t number_of_simd,
+                                               std::uint32_t input_value) const {
+  if (protocol != MpcProtocol::kArithmeticGmw && protocol != MpcProtocol::kBooleanGmw &&
+      protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Costco circuits cannot be built in {}", to_string(protocol)));
+  }
+  const std::vector<std::uint32_t> input_values(number_of_simd, input_value);
+  auto input = [&](std::size_t input_owner) {
+    switch (protocol) {
+      case MpcProtocol::kArithmeticGmw:
+        return ShareWrapper(party.In<MpcProtocol::kArithmeticGmw>(input_values, input_owner));
+      case MpcProtocol::kBooleanGmw:
+        return ShareWrapper(party.In<MpcProtocol::kBooleanGmw>(ToInput(input_values), input_owner));
+      default:
+        return ShareWrapper(party.In<MpcProtocol::kBmr>(ToInput(input_values), input_owner));
+    }
+  };
+
+  std::vector<ShareWrapper> shares(GetNumberOfGates());
+  std::vector<ShareWrapper> outputs;
+  for (std::size_t gate = 0; gate < GetNumberOfGates(); ++gate) {
+    const auto parents{GetInputs(gate)};
+    auto& share{shares[gate]};
+    switch (gate_types[gate]) {
+      case CostcoGateType::kInput0:
+        share = input(0);
+        break;
+      case CostcoGateType::kInput1:
+        share = input(1);
+        break;
+      case CostcoGateType::kToBmr:
+        share = shares[parents[0]].Convert<MpcProtocol::kBmr>();
+        break;
+      case CostcoGateType::kToBooleanGmw:
+        share = shares[parents[0]].Convert<MpcProtocol::kBooleanGmw>();
+        break;
+      case CostcoGateType::kToArithmeticGmw:
+        share = shares[parents[0]].Convert<MpcProtocol::kArithmeticGmw>();
+        break;
+      case CostcoGateType::kOutput:
+        share = shares[parents[0]].Out();
+        outputs.push_back(share);
+        break;
+      case CostcoGateType::kMultiplication:
+        share = shares[parents[0]] * shares[parents[1]];
+        break;
+      case CostcoGateType::kAddition:
+        share = shares[parents[0]] + shares[parents[1]];
+        break;
+      case CostcoGateType::kSubtraction:
+        share = shares[parents[0]] - shares[parents[1]];
+        break;
+      case CostcoGateType::kDivision:
+        share = shares[parents[0]] / shares[parents[1]];
+        break;
+      case CostcoGateType::kAnd:
+        share = shares[parents[0]] & shares[parents[1]];
+        break;
+      case CostcoGateType::kOr:
+        share = shares[parents[0]] | shares[parents[1]];
+        break;
+      case CostcoGateType::kXor:
+        share = shares[parents[0]] ^ shares[parents[1]];
+        break;
+      case CostcoGateType::kGreaterThan:
+        share = shares[parents[0]] > shares[parents[1]];
+        break;
+      case CostcoGateType::kLessThan:
+        share = shares[parents[1]] > shares[parents[0]];
+        break;
+      case CostcoGateType::kGreaterEqual:
+        share = ~(shares[parents[1]] > shares[parents[0]]);
+        break;
+      case CostcoGateType::kLessEqual:
+        share = ~(shares[parents[0]] > shares[parents[1]]);
+        break;
+      case CostcoGateType::kEqual:
+        share = shares[parents[0]] == shares[parents[1]];
+        break;
+      case CostcoGateType::kNotEqual:
+        share = ~(shares[parents[0]] == shares[parents[1]]);
+        break;
+    }
+  }
+  return outputs;
+}
+
+}  // namespace encrypto::motion
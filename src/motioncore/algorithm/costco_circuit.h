@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+class Party;
+
+enum class CostcoGateType : std::uint8_t {
+  kInput0,
+  kInput1,
+  kToBmr,
+  kToBooleanGmw,
+  kToArithmeticGmw,
+  kOutput,
+  kMultiplication,
+  kAddition,
+  kSubtraction,
+  kDivision,
+  kAnd,
+  kOr,
+  kXor,
+  kGreaterThan,
+  kLessThan,
+  kGreaterEqual,
+  kLessEqual,
+  kEqual,
+  kNotEqual
+};
+
+/// \brief Circuit graph of the Costco cost model experiments with dense gate ids.
+///
+/// The text format has one line per gate, which starts with the name of the gate followed by the
+/// names of the gates it feeds into.  The type of a gate is the prefix of its name up to the first
+/// '_', e.g., ADD for ADD_2, and a gate's inputs are ordered as the lines of its parents.  The
+/// names are only used while parsing, afterwards gates are referred to by the position of their
+/// line, so building the circuit does not look up any strings.
+struct CostcoCircuit {
+  /// \throws std::invalid_argument if a gate has an unknown type, feeds into an unknown gate or
+  /// has the wrong number of inputs
+  static CostcoCircuit FromText(std::istream& stream);
+
+  /// \brief reads a circuit in the binary format of ToBinary or, otherwise, in the text format.
+  /// \throws std::runtime_error if the file cannot be read or a binary circuit is truncated
+  static CostcoCircuit FromFile(const std::string& path);
+
+  /// \brief writes this circuit in a binary format, which FromFile reads with a few copies instead
+  /// of parsing text.
+  /// \throws std::runtime_error if the file cannot be written
+  void ToBinary(const std::string& path) const;
+
+  std::size_t GetNumberOfGates() const { return gate_types.size(); }
+
+  std::span<const std::uint32_t> GetInputs(std::size_t gate) const {
+    return std::span(inputs).subspan(input_offsets[gate],
+                                     input_offsets[gate + 1] - input_offsets[gate]);
+  }
+
+  /// \brief constructs the circuit in \p protocol, i.e., arithmetic GMW, Boolean GMW or BMR, with
+  /// \p number_of_simd SIMD values per wire, e.g., the number of parallel elements of the
+  /// experiment.  All SIMD values of the inputs of parties 0 and 1 are \p input_value.
+  /// \returns the outputs in the order of the kOutput gates
+  /// \throws std::invalid_argument for other protocols
+  std::vector<ShareWrapper> Build(Party& party, MpcProtocol protocol, std::size_t number_of_simd,
+                                  std::uint32_t input_value = 1) const;
+
+  std::vector<CostcoGateType> gate_types;
+  // the inputs of gate i are inputs[input_offsets[i]], ..., inputs[input_offsets[i + 1] - 1]
+  std::vector<std::uint32_t> input_offsets{0};
+  std::vector<std::uint32_t> inputs;
+};
+
+}  // namespace encrypto::motion
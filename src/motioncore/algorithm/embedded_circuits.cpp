@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "embedded_circuits.h"
+
+#include <algorithm>
+
+#include "algorithm_description.h"
+#include "utility/config.h"
+
+namespace encrypto::motion {
+
+const EmbeddedCircuit* FindEmbeddedCircuit(std::string_view path) {
+  if (path.starts_with(kRootDir) && path.substr(kRootDir.size()).starts_with('/')) {
+    path.remove_prefix(kRootDir.size() + 1);
+  }
+  const auto circuits{GetEmbeddedCircuits()};
+  const auto iterator{std::find_if(circuits.begin(), circuits.end(),
+                                   [path](const auto& circuit) { return circuit.path == path; })};
+  return iterator == circuits.end() ? nullptr : &*iterator;
+}
+
+AlgorithmDescription ToAlgorithmDescription(const EmbeddedCircuit& circuit) {
+  AlgorithmDescription algorithm_description;
+  algorithm_description.number_of_gates = circuit.number_of_gates;
+  algorithm_description.number_of_wires = circuit.number_of_wires;
+  algorithm_description.number_of_input_wires_parent_a = circuit.number_of_input_wires_parent_a;
+  algorithm_description.number_of_input_wires_parent_b = circuit.number_of_input_wires_parent_b;
+  algorithm_description.number_of_output_wires = circuit.number_of_output_wires;
+  algorithm_description.gates.resize(circuit.gates.size());
+  for (std::size_t i = 0; i < circuit.gates.size(); ++i) {
+    const auto& gate{circuit.gates[i]};
+    auto& primitive_operation{algorithm_description.gates[i]};
+    primitive_operation.type = gate.type;
+    primitive_operation.parent_a = gate.parent_a;
+    if (gate.parent_b != kNoWire) primitive_operation.parent_b = gate.parent_b;
+    if (gate.selection_bit != kNoWire) primitive_operation.selection_bit = gate.selection_bit;
+    primitive_operation.output_wire = gate.output_wire;
+  }
+  return algorithm_description;
+}
+
+}  // namespace encrypto::motion
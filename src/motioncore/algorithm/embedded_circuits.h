@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+struct AlgorithmDescription;
+
+/// \brief a gate of an embedded circuit, whose absent parent b or selection bit is kNoWire
+struct EmbeddedGate {
+  PrimitiveOperationType type;
+  std::uint32_t parent_a, parent_b, selection_bit, output_wire;
+};
+
+constexpr std::uint32_t kNoWire{std::numeric_limits<std::uint32_t>::max()};
+
+/// \brief a Bristol circuit of the circuits directory that was compiled into the library by
+/// cmake/embed_circuits.cmake, see the CMake option MOTION_EMBEDDED_CIRCUITS
+struct EmbeddedCircuit {
+  // relative to the root directory, e.g., circuits/int/int_add8_size.bristol
+  std::string_view path;
+  std::size_t number_of_gates, number_of_wires, number_of_input_wires_parent_a;
+  std::optional<std::size_t> number_of_input_wires_parent_b;
+  std::size_t number_of_output_wires;
+  std::span<const EmbeddedGate> gates;
+};
+
+/// \brief checks at compile time that the gates of an embedded circuit only use its wires
+constexpr bool HasValidWires(std::span<const EmbeddedGate> gates, std::size_t number_of_wires) {
+  for (const auto& gate : gates) {
+    if (gate.parent_a >= number_of_wires || gate.output_wire >= number_of_wires ||
+        (gate.parent_b != kNoWire && gate.parent_b >= number_of_wires) ||
+        (gate.selection_bit != kNoWire && gate.selection_bit >= number_of_wires)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \returns all embedded circuits, which are defined in the generated embedded_circuits_data.cpp
+std::span<const EmbeddedCircuit> GetEmbeddedCircuits();
+
+/// \returns the embedded circuit with the given path, which is either relative to the root
+/// directory or starts with kRootDir, i.e., paths of the source tree are found even if it does not
+/// exist at runtime, or nullptr if the circuit was not embedded
+const EmbeddedCircuit* FindEmbeddedCircuit(std::string_view path);
+
+/// \brief copies the gates of an embedded circuit into an AlgorithmDescription without parsing,
+/// which is the same as AlgorithmDescription::FromBristol of the circuit file
+AlgorithmDescription ToAlgorithmDescription(const EmbeddedCircuit& circuit);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "epistasis.h"
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "low_depth_reduce.h"
+#include "protocols/share.h"
+#include "secure_type/secure_unsigned_integer.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the number of genotypes of a SNP and of columns of a contingency table
+constexpr std::size_t kNumberOfGenotypes{3};
+constexpr std::size_t kNumberOfColumns{kNumberOfGenotypes * kNumberOfGenotypes};
+
+template <typename T>
+ShareWrapper ConstantOf(Backend& backend, std::size_t number_of_simd, std::uint64_t value) {
+  return backend.ConstantArithmeticGmwInput<T>(std::vector<T>(number_of_simd, T(value)));
+}
+
+// the public constant value in each SIMD value of share
+ShareWrapper Constant(const ShareWrapper& share, std::uint64_t value) {
+  auto& backend{share->GetBackend()};
+  const std::size_t number_of_simd{share->GetNumberOfSimdValues()};
+  switch (share->GetBitLength()) {
+    case 8u:
+      return ConstantOf<std::uint8_t>(backend, number_of_simd, value);
+    case 16u:
+      return ConstantOf<std::uint16_t>(backend, number_of_simd, value);
+    case 32u:
+      return ConstantOf<std::uint32_t>(backend, number_of_simd, value);
+    case 64u:
+      return ConstantOf<std::uint64_t>(backend, number_of_simd, value);
+    default:
+      throw std::invalid_argument(fmt::format("Invalid bit length {}", share->GetBitLength()));
+  }
+}
+
+void CheckArithmeticGmw(const ShareWrapper& share, std::size_t bit_length) {
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw || share->GetBitLength() != bit_length) {
+    throw std::invalid_argument(
+        fmt::format("Epistasis analysis needs arithmetic GMW shares of {} bits", bit_length));
+  }
+}
+
+}  // namespace
+
+ContingencyTables CountContingencyTables(
+    std::span<const ShareWrapper> genotypes, const ShareWrapper& phenotypes,
+    std::span<const std::pair<std::size_t, std::size_t>> snp_pairs) {
+  const std::size_t bit_length{phenotypes->GetBitLength()};
+  const std::size_t number_of_individuals{phenotypes->GetNumberOfSimdValues()};
+  CheckArithmeticGmw(phenotypes, bit_length);
+  for (const auto& genotype : genotypes) {
+    CheckArithmeticGmw(genotype, bit_length);
+    if (genotype->GetNumberOfSimdValues() != kNumberOfGenotypes * number_of_individuals) {
+      throw std::invalid_argument(
+          fmt::format("Genotype indicators of {} SIMD values for {} individuals",
+                      genotype->GetNumberOfSimdValues(), number_of_individuals));
+    }
+  }
+  if (snp_pairs.empty()) throw std::invalid_argument("No SNP pairs to count");
+
+  // the pairs of each first SNP and the position of each second SNP among the case indicators
+  std::map<std::size_t, std::vector<std::size_t>> pairs_of_first_snp;
+  std::map<std::size_t, std::size_t> second_snp_positions;
+  for (std::size_t p = 0; p < snp_pairs.size(); ++p) {
+    const auto [first, second] = snp_pairs[p];
+    if (first >= genotypes.size() || second >= genotypes.size()) {
+      throw std::invalid_argument(
+          fmt::format("SNP pair ({}, {}) of {} SNPs", first, second, genotypes.size()));
+    }
+    pairs_of_first_snp[first].emplace_back(p);
+    second_snp_positions.emplace(second, 0);
+  }
+
+  // the case indicators of all second SNPs by one multiplication with the repeated phenotypes
+  std::vector<ShareWrapper> second_genotypes;
+  for (auto& [snp, position] : second_snp_positions) {
+    position = second_genotypes.size();
+    second_genotypes.emplace_back(genotypes[snp]);
+  }
+  const std::size_t number_of_indicators{kNumberOfGenotypes * number_of_individuals};
+  std::vector<std::size_t> phenotype_positions(second_genotypes.size() * number_of_indicators);
+  for (std::size_t i = 0; i < phenotype_positions.size(); ++i) {
+    phenotype_positions[i] = i % number_of_individuals;
+  }
+  ShareWrapper case_indicators{ShareWrapper::Simdify(second_genotypes) *
+                               ShareWrapper(phenotypes).Subset(std::move(phenotype_positions))};
+  const auto case_values{case_indicators.Unsimdify()};
+  std::vector<std::vector<ShareWrapper>> genotype_values(genotypes.size());
+  const auto values_of = [&](std::size_t snp) -> const std::vector<ShareWrapper>& {
+    if (genotype_values[snp].empty()) {
+      genotype_values[snp] = ShareWrapper(genotypes[snp]).Unsimdify();
+    }
+    return genotype_values[snp];
+  };
+
+  std::vector<ShareWrapper> counts(snp_pairs.size() * kNumberOfColumns),
+      cases(snp_pairs.size() * kNumberOfColumns);
+  for (const auto& [first, pairs] : pairs_of_first_snp) {
+    // the n x 6k matrix of the genotype and case indicators of the second SNPs
+    const std::size_t number_of_columns{2 * kNumberOfGenotypes * pairs.size()};
+    std::vector<ShareWrapper> partners(number_of_individuals * number_of_columns);
+    for (std::size_t q = 0; q < pairs.size(); ++q) {
+      const std::size_t second{snp_pairs[pairs[q]].second};
+      const auto& second_values{values_of(second)};
+      const std::size_t case_offset{second_snp_positions.at(second) * number_of_indicators};
+      for (std::size_t g = 0; g < kNumberOfGenotypes; ++g) {
+        for (std::size_t i = 0; i < number_of_individuals; ++i) {
+          const std::size_t column{2 * kNumberOfGenotypes * q + g};
+          partners[i * number_of_columns + column] = second_values[g * number_of_individuals + i];
+          partners[i * number_of_columns + column + kNumberOfGenotypes] =
+              case_values[case_offset + g * number_of_individuals + i];
+        }
+      }
+    }
+    std::vector<ShareWrapper> first_values{values_of(first)};
+    const auto products{
+        MatrixMultiplication(first_values, partners, kNumberOfGenotypes, number_of_columns)};
+    for (std::size_t q = 0; q < pairs.size(); ++q) {
+      for (std::size_t i = 0; i < kNumberOfGenotypes; ++i) {
+        for (std::size_t j = 0; j < kNumberOfGenotypes; ++j) {
+          const std::size_t product{i * number_of_columns + 2 * kNumberOfGenotypes * q + j};
+          const std::size_t column{pairs[q] * kNumberOfColumns + i * kNumberOfGenotypes + j};
+          counts[column] = products[product];
+          cases[column] = products[product + kNumberOfGenotypes];
+        }
+      }
+    }
+  }
+  const ShareWrapper case_share{ShareWrapper::Simdify(cases)};
+  return {ShareWrapper::Simdify(counts) - case_share, case_share};
+}
+
+ShareWrapper ChiSquaredStatistics(const ContingencyTables& tables, std::uint64_t number_of_cases,
+                                  std::uint64_t number_of_controls, std::size_t fractional_bits) {
+  const std::size_t bit_length{tables.cases->GetBitLength()};
+  CheckArithmeticGmw(tables.cases, bit_length);
+  CheckArithmeticGmw(tables.controls, bit_length);
+  const std::size_t number_of_simd{tables.cases->GetNumberOfSimdValues()};
+  if (number_of_simd == 0 || number_of_simd % kNumberOfColumns != 0 ||
+      tables.controls->GetNumberOfSimdValues() != number_of_simd) {
+    throw std::invalid_argument(
+        fmt::format("Contingency tables of {} cases and {} controls", number_of_simd,
+                    tables.controls->GetNumberOfSimdValues()));
+  }
+  if (fractional_bits >= bit_length) {
+    throw std::invalid_argument(
+        fmt::format("{} fractional bits of {}-bit statistics", fractional_bits, bit_length));
+  }
+
+  // (a_j S - b_j R)^2 2^f, whose difference may be negative before squaring
+  const ShareWrapper difference{tables.cases * Constant(tables.cases, number_of_controls) -
+                                tables.controls * Constant(tables.controls, number_of_cases)};
+  const ShareWrapper numerator{(difference * difference) *
+                               Constant(difference, std::uint64_t(1) << fractional_bits)};
+  const ShareWrapper column_sizes{
+      (tables.cases + tables.controls).Convert<MpcProtocol::kBooleanGmw>()};
+  // columns without individuals have a numerator of 0 and are divided by 1 instead of 0
+  auto divisor_bits{column_sizes.Split()};
+  divisor_bits[0] = divisor_bits[0] | ~column_sizes.OrReduce();
+  const ShareWrapper quotients{
+      (SecureUnsignedInteger(numerator.Convert<MpcProtocol::kBooleanGmw>()) /
+       SecureUnsignedInteger(ShareWrapper::Concatenate(divisor_bits)))
+          .Get()
+          .Convert<MpcProtocol::kArithmeticGmw>()};
+
+  // the sums of the 9 columns of each table, which are local
+  const std::size_t number_of_tables{number_of_simd / kNumberOfColumns};
+  std::vector<ShareWrapper> columns;
+  columns.reserve(kNumberOfColumns);
+  for (std::size_t j = 0; j < kNumberOfColumns; ++j) {
+    std::vector<std::size_t> positions(number_of_tables);
+    for (std::size_t t = 0; t < number_of_tables; ++t) positions[t] = t * kNumberOfColumns + j;
+    columns.emplace_back(ShareWrapper(quotients).Subset(std::move(positions)));
+  }
+  return LowDepthReduce(std::move(columns), std::plus<>());
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief the 2 x 9 contingency tables of SNP pairs, i.e., the numbers of controls and cases of
+/// each of the 3 x 3 combinations of the genotypes 0, 1 and 2 of both SNPs.  The count of genotype
+/// i of the first and j of the second SNP of pair p is SIMD value 9p + 3i + j.  Tables of several
+/// data owners, e.g., of horizontally partitioned cohorts, are added locally.
+struct ContingencyTables {
+  ShareWrapper controls;
+  ShareWrapper cases;
+};
+
+/// \brief counts the contingency tables of snp_pairs of n individuals.  The tables of all pairs
+/// with the same first SNP are the product of its 3 x n genotype indicators with the n x 6k
+/// indicators of its k partners and of their cases by a single MatrixMultiplicationGate, whose
+/// case indicators are computed by one SIMD multiplication for all SNPs, i.e., no gate is
+/// constructed per individual.
+/// \param genotypes arithmetic GMW share per SNP of 3n SIMD values, whose value gn + i is 1 if
+///        individual i has genotype g and 0 otherwise
+/// \param phenotypes arithmetic GMW share of n SIMD values, which are 1 for cases and 0 for
+///        controls
+/// \throws std::invalid_argument if the shares do not fit or a SNP of snp_pairs does not exist
+ContingencyTables CountContingencyTables(
+    std::span<const ShareWrapper> genotypes, const ShareWrapper& phenotypes,
+    std::span<const std::pair<std::size_t, std::size_t>> snp_pairs);
+
+/// \brief the chi-squared test statistics of the tables with f fractional bits, scaled by the
+/// public numbers of cases R and controls S, i.e., sum_j (a_j S - b_j R)^2 / n_j of the a_j cases,
+/// b_j controls and n_j individuals of the 9 columns j of each table, which is R S times the
+/// chi-squared statistic and ranks the pairs equally.  The quotients of all columns of all tables
+/// are computed by one Boolean GMW division circuit, where columns without individuals are 0.
+/// \returns arithmetic GMW share of one statistic per table, whose quotients are rounded down
+/// \throws std::invalid_argument if the tables are no arithmetic GMW shares of 9k SIMD values
+/// \note (a_j S - b_j R)^2 2^f must not exceed the bit length of the tables, e.g., 64 bits allow
+///       2^f n^4 < 2^64 for n individuals
+ShareWrapper ChiSquaredStatistics(const ContingencyTables& tables, std::uint64_t number_of_cases,
+                                  std::uint64_t number_of_controls, std::size_t fractional_bits);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "evaluation_template.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+EvaluationTemplate::EvaluationTemplate(const AlgorithmDescription& algorithm_description)
+    : number_of_input_wires_(algorithm_description.number_of_input_wires_parent_a +
+                             algorithm_description.number_of_input_wires_parent_b.value_or(0)),
+      number_of_wires_(algorithm_description.number_of_wires),
+      number_of_output_wires_(algorithm_description.number_of_output_wires) {
+  if (number_of_input_wires_ > number_of_wires_ || number_of_output_wires_ > number_of_wires_) {
+    throw std::invalid_argument(fmt::format(
+        "Circuit has {} input and {} output wires but only {} wires", number_of_input_wires_,
+        number_of_output_wires_, number_of_wires_));
+  }
+  const auto& gates{algorithm_description.gates};
+  // the layer of each wire, which is one after the latest layer of its gate's parents
+  std::vector<std::optional<std::size_t>> layers(number_of_wires_);
+  std::fill_n(layers.begin(), number_of_input_wires_, 0);
+  // the gate assigning each wire, or the number of gates for inputs
+  std::vector<std::size_t> wire_gates(number_of_wires_, gates.size());
+  std::vector<std::size_t> gate_layers(gates.size());
+  // the end of the and group starting at each gate, or 0 if no group starts there
+  std::vector<std::size_t> group_ends(gates.size(), 0);
+  for (const auto& [first_gate, number_of_gates] : algorithm_description.and_groups) {
+    if (number_of_gates == 0 || first_gate >= gates.size() ||
+        number_of_gates > gates.size() - first_gate) {
+      throw std::invalid_argument(fmt::format(
+          "And group of {} gates at gate {} is out of range", number_of_gates, first_gate));
+    }
+    group_ends[first_gate] = first_gate + number_of_gates;
+  }
+  std::size_t group_begin{0}, group_end{0};
+  for (std::size_t gate_i = 0; gate_i < gates.size(); ++gate_i) {
+    const auto& gate{gates[gate_i]};
+    if (group_ends[gate_i] != 0) {
+      if (gate_i < group_end) {
+        throw std::invalid_argument(fmt::format("And groups overlap at gate {}", gate_i));
+      }
+      group_begin = gate_i;
+      group_end = group_ends[gate_i];
+    }
+    const bool in_group{gate_i < group_end};
+    if (in_group && gate.type != PrimitiveOperationType::kAnd) {
+      throw std::invalid_argument(
+          fmt::format("And group contains gate {} of type {}", gate_i, to_string(gate.type)));
+    }
+    const auto get_layer = [&, gate_i](std::optional<std::size_t> wire) {
+      if (!wire || *wire >= layers.size() || !layers[*wire]) {
+        throw std::invalid_argument(
+            fmt::format("Gate {} reads a wire before it is assigned", gate_i));
+      }
+      if (in_group && wire_gates[*wire] >= group_begin && wire_gates[*wire] < gate_i) {
+        throw std::invalid_argument(
+            fmt::format("Gate {} reads an output of its own and group", gate_i));
+      }
+      return *layers[*wire];
+    };
+    std::size_t layer{0};
+    switch (gate.type) {
+      case PrimitiveOperationType::kXor:
+      case PrimitiveOperationType::kAnd:
+      case PrimitiveOperationType::kOr:
+        layer = std::max(get_layer(gate.parent_a), get_layer(gate.parent_b));
+        break;
+      case PrimitiveOperationType::kInv:
+        layer = get_layer(gate.parent_a);
+        break;
+      case PrimitiveOperationType::kLut:
+        if (gate.lut_inputs.empty()) {
+          throw std::invalid_argument(fmt::format("Lookup table gate {} has no inputs", gate_i));
+        }
+        for (const auto input : gate.lut_inputs) layer = std::max(layer, get_layer(input));
+        break;
+      default:
+        throw std::invalid_argument(fmt::format("Cannot evaluate gate {} of type {}", gate_i,
+                                                to_string(gate.type)));
+    }
+    if (gate.output_wire >= layers.size() || layers[gate.output_wire]) {
+      throw std::invalid_argument(
+          fmt::format("Gate {} assigns wire {} twice or out of range", gate_i, gate.output_wire));
+    }
+    layers[gate.output_wire] = gate_layers[gate_i] = layer + 1;
+    wire_gates[gate.output_wire] = gate_i;
+    if (in_group && gate_i + 1 == group_end) {
+      const auto group_layer{*std::max_element(gate_layers.begin() + group_begin,
+                                               gate_layers.begin() + group_end)};
+      for (auto group_gate_i = group_begin; group_gate_i < group_end; ++group_gate_i) {
+        layers[gates[group_gate_i].output_wire] = gate_layers[group_gate_i] = group_layer;
+      }
+    }
+  }
+  for (std::size_t wire_i = number_of_wires_ - number_of_output_wires_; wire_i < number_of_wires_;
+       ++wire_i) {
+    if (!layers[wire_i]) {
+      throw std::invalid_argument(fmt::format("Output wire {} is not assigned", wire_i));
+    }
+  }
+
+  // sorts the gates by layer and operation, and lookup tables by their inputs, s.t. consecutive
+  // gates with the same key form a batch
+  std::vector<std::size_t> order(gates.size());
+  std::iota(order.begin(), order.end(), 0);
+  const auto key = [&](std::size_t gate_i) {
+    static const std::vector<std::size_t> kNoInputs;
+    const auto& gate{gates[gate_i]};
+    return std::tie(gate_layers[gate_i], gate.type,
+                    gate.type == PrimitiveOperationType::kLut ? gate.lut_inputs : kNoInputs);
+  };
+  std::stable_sort(order.begin(), order.end(),
+                   [&key](std::size_t a, std::size_t b) { return key(a) < key(b); });
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const auto& gate{gates[order[i]]};
+    if (i == 0 || key(order[i - 1]) != key(order[i])) {
+      auto& batch{batches_.emplace_back()};
+      batch.type = gate.type;
+      batch.layer = gate_layers[order[i]];
+      if (gate.type == PrimitiveOperationType::kLut) batch.lut_inputs = gate.lut_inputs;
+    }
+    auto& batch{batches_.back()};
+    if (layer_sizes_.size() <= batch.layer) layer_sizes_.resize(batch.layer + 1, 0);
+    ++layer_sizes_[batch.layer];
+    batch.output_wires.push_back(gate.output_wire);
+    if (gate.type == PrimitiveOperationType::kLut) {
+      batch.truth_tables.push_back(gate.truth_table);
+    } else {
+      batch.parents_a.push_back(gate.parent_a);
+      if (gate.type != PrimitiveOperationType::kInv) batch.parents_b.push_back(*gate.parent_b);
+    }
+  }
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "algorithm_description.h"
+
+namespace encrypto::motion {
+
+/// \brief An AlgorithmDescription compiled for ShareWrapper::Evaluate.  The gates are grouped into
+/// batches of the same operation, whose inputs are all computed by earlier batches, s.t. each
+/// batch is instantiated as a single gate on all of its wires instead of one gate and one share
+/// per wire.  The template depends neither on the protocol nor on the number of SIMD values of
+/// the inputs and can be reused for any number of evaluations, see
+/// Register::GetEvaluationTemplate.
+class EvaluationTemplate {
+ public:
+  struct Batch {
+    PrimitiveOperationType type;
+    // the layers of the batches are ascending, the inputs are layer 0
+    std::size_t layer;
+    // the wires of the first parents, of the second parents (empty for kInv and kLut) and of the
+    // outputs of the gates in the batch
+    std::vector<std::size_t> parents_a, parents_b, output_wires;
+    // for kLut, the inputs shared by all gates of the batch and the truth table of each output
+    std::vector<std::size_t> lut_inputs;
+    std::vector<BitVector<>> truth_tables;
+  };
+
+  /// \brief assigns each gate to the batch of its operation in the layer after its latest parent.
+  /// The gates of each of AlgorithmDescription::and_groups are assigned to the latest layer of
+  /// the group, s.t. they are evaluated by a single gate.
+  /// \throws std::invalid_argument if a gate is not kXor, kAnd, kOr, kInv or kLut, reads a wire
+  /// before it is assigned or assigns a wire twice, if an output wire is not assigned, or if an
+  /// and group overlaps another one, contains other gates than kAnd or reads its own outputs
+  explicit EvaluationTemplate(const AlgorithmDescription& algorithm_description);
+
+  const std::vector<Batch>& GetBatches() const noexcept { return batches_; }
+
+  /// \brief the number of gates in each layer, i.e., in the batches of the same Batch::layer, by
+  /// which the wires of a layer are allocated next to each other
+  const std::vector<std::size_t>& GetLayerSizes() const noexcept { return layer_sizes_; }
+
+  std::size_t GetNumberOfInputWires() const noexcept { return number_of_input_wires_; }
+
+  std::size_t GetNumberOfWires() const noexcept { return number_of_wires_; }
+
+  /// \brief the outputs are the last GetNumberOfOutputWires() wires
+  std::size_t GetNumberOfOutputWires() const noexcept { return number_of_output_wires_; }
+
+ private:
+  std::size_t number_of_input_wires_;
+  std::size_t number_of_wires_;
+  std::size_t number_of_output_wires_;
+  std::vector<Batch> batches_;
+  std::vector<std::size_t> layer_sizes_;
+};
+
+}  // namespace encrypto::motion
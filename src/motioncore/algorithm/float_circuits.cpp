@@ -0,0 +1,553 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "float_circuits.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "circuit_builder.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using detail::Bit;
+using detail::CircuitBuilder;
+using detail::kOne;
+using detail::kZero;
+using Row = std::vector<Bit>;
+
+// the bits [from, to) of x
+Row Slice(const Row& x, std::size_t from, std::size_t to) {
+  return Row(x.begin() + from, x.begin() + to);
+}
+
+// x with the width bits of its value, whose upper bits are zero
+Row ZeroExtend(Row x, std::size_t width) {
+  x.resize(width, kZero);
+  return x;
+}
+
+// x with the width bits of its value in two's complement
+Row SignExtend(Row x, std::size_t width) {
+  x.resize(width, x.back());
+  return x;
+}
+
+// x * 2^shift modulo 2^x.size()
+Row ShiftLeft(const Row& x, std::size_t shift) {
+  Row shifted(x.size(), kZero);
+  for (std::size_t i = shift; i < x.size(); ++i) shifted[i] = x[i - shift];
+  return shifted;
+}
+
+// the width bits of value modulo 2^width in two's complement
+Row MakeConstant(long long value, std::size_t width) {
+  Row constant(width);
+  for (std::size_t i = 0; i < width; ++i) {
+    const bool bit{i < 63 ? ((value >> i) & 1) != 0 : value < 0};
+    constant[i] = bit ? kOne : kZero;
+  }
+  return constant;
+}
+
+// the width bits of the non-negative value * 2^fraction_bits rounded down
+Row MakeFixedPointConstant(long double value, std::size_t fraction_bits, std::size_t width) {
+  Row constant(width, kZero);
+  for (std::size_t i = width; i-- > 0;) {
+    const long double weight{
+        std::ldexp(1.0L, static_cast<int>(i) - static_cast<int>(fraction_bits))};
+    if (value >= weight) {
+      constant[i] = kOne;
+      value -= weight;
+    }
+  }
+  return constant;
+}
+
+Row MuxRows(CircuitBuilder& builder, const Bit& selection, const Row& a, const Row& b) {
+  Row result(a.size());
+  for (std::size_t i = 0; i < a.size(); ++i) result[i] = builder.Mux(selection, a[i], b[i]);
+  return result;
+}
+
+Bit IsZero(CircuitBuilder& builder, const Row& x) {
+  return builder.Not(detail::OrBits(builder, x));
+}
+
+// x + carry modulo 2^x.size() by one AND gate per bit
+Row Increment(CircuitBuilder& builder, const Row& x, const Bit& carry, CircuitObjective objective) {
+  return detail::AddRows(builder, x, Row(x.size(), kZero), carry, objective);
+}
+
+// shifts x right by the amount with the bits that are shifted out ORed into the returned bit
+std::pair<Row, Bit> ShiftRightSticky(CircuitBuilder& builder, Row x, const Row& amount) {
+  const std::size_t size{x.size()};
+  Bit sticky{kZero};
+  for (std::size_t k = 0; k < amount.size(); ++k) {
+    // the bits shifted out of x, which are all for shifts beyond its size
+    const std::size_t lost_bits{k < 63 ? std::min(std::size_t(1) << k, size) : size};
+    Row shifted(size, kZero);
+    for (std::size_t i = 0; i + lost_bits < size; ++i) shifted[i] = x[i + lost_bits];
+    const Bit lost{detail::OrBits(builder, Slice(x, 0, lost_bits))};
+    sticky = builder.Or(sticky, builder.And(amount[k], lost));
+    x = MuxRows(builder, amount[k], shifted, x);
+  }
+  return {x, sticky};
+}
+
+// shifts x left until its most significant bit is one and returns the shifted x and the number
+// of leading zeros of x in std::bit_width(x.size() - 1) bits, which are meaningless if x is zero
+std::pair<Row, Row> Normalize(CircuitBuilder& builder, Row x) {
+  const std::size_t size{x.size()};
+  Row leading_zeros(std::bit_width(size - 1));
+  for (std::size_t k = leading_zeros.size(); k-- > 0;) {
+    const std::size_t shift{std::size_t(1) << k};
+    leading_zeros[k] = IsZero(builder, Slice(x, size - shift, size));
+    x = MuxRows(builder, leading_zeros[k], ShiftLeft(x, shift), x);
+  }
+  return {x, leading_zeros};
+}
+
+// x * x modulo 2^size, whose partial products x_i * x_j and x_j * x_i are added once at the
+// doubled weight
+Row SquareRow(CircuitBuilder& builder, const Row& x, std::size_t size,
+              CircuitObjective objective) {
+  std::vector<Row> columns(size);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    if (2 * i < size) columns[2 * i].push_back(x[i]);
+    for (std::size_t j = i + 1; j < x.size() && i + j + 1 < size; ++j) {
+      columns[i + j + 1].push_back(builder.And(x[i], x[j]));
+    }
+  }
+  const auto [row_a, row_b]{detail::ReduceColumns(builder, std::move(columns), objective)};
+  return detail::AddRows(builder, row_a, row_b, kZero, objective);
+}
+
+// builds the circuit of an operation on floating-point numbers of the format
+class FloatingPointCircuit {
+ public:
+  FloatingPointCircuit(std::size_t exponent_bits, std::size_t mantissa_bits, bool is_binary,
+                       CircuitObjective objective)
+      : exponent_bits_(exponent_bits),
+        mantissa_bits_(mantissa_bits),
+        bitlength_(1 + exponent_bits + mantissa_bits),
+        // the exponents are computed in two's complement with room for the carries and the
+        // leading zeros of the significands
+        exponent_width_(std::max<std::size_t>(
+            exponent_bits + 2, std::bit_width(exponent_bits + mantissa_bits + 5) + 1)),
+        bias_((1ll << (exponent_bits - 1)) - 1),
+        objective_(objective),
+        builder_(bitlength_, is_binary ? bitlength_ : 0) {}
+
+  AlgorithmDescription Build(FloatingPointOperationType type) &&;
+
+ private:
+  // the fields of a number, whose significand has the hidden bit, which is zero for zeros
+  struct Number {
+    Bit sign;
+    Row exponent;
+    Row significand;
+    Bit is_zero;
+  };
+
+  Number Unpack(const Row& x) {
+    Number number{.sign = x.back(), .exponent = Slice(x, mantissa_bits_, bitlength_ - 1)};
+    number.is_zero = IsZero(builder_, number.exponent);
+    number.significand = Slice(x, 0, mantissa_bits_);
+    number.significand.push_back(builder_.Not(number.is_zero));
+    return number;
+  }
+
+  // rounds the significand with the guard and sticky bits to nearest, ties to even, and packs the
+  // result, whose exponent is increased by a carry of the rounding and flushed to zero if it is
+  // not positive
+  Row RoundAndPack(const Bit& sign, const Row& exponent, const Row& significand, const Bit& guard,
+                   const Bit& sticky, const Bit& is_zero) {
+    const Bit round_up{builder_.And(guard, builder_.Or(sticky, significand[0]))};
+    const Row rounded{Increment(builder_, significand, round_up, objective_)};
+    // the most significant bit of the significand is one and only an overflow clears it
+    const Row final_exponent{Increment(builder_, exponent, builder_.Not(rounded.back()),
+                                       objective_)};
+    const Bit underflow{builder_.Or(final_exponent.back(), IsZero(builder_, final_exponent))};
+    const Bit is_nonzero{builder_.Not(builder_.Or(is_zero, underflow))};
+    Row result(bitlength_);
+    for (std::size_t i = 0; i < mantissa_bits_; ++i) {
+      result[i] = builder_.And(rounded[i], is_nonzero);
+    }
+    for (std::size_t i = 0; i < exponent_bits_; ++i) {
+      result[mantissa_bits_ + i] = builder_.And(final_exponent[i], is_nonzero);
+    }
+    result.back() = sign;
+    return result;
+  }
+
+  // rounds the non-negative fixed-point number with fraction_bits fractional bits and packs it
+  Row PackFixedPoint(const Bit& sign, const Row& magnitude, std::size_t fraction_bits) {
+    const std::size_t size{magnitude.size()};
+    const auto [normalized, leading_zeros]{Normalize(builder_, magnitude)};
+    // the most significant bit of the normalized magnitude has the weight
+    // 2^(size - 1 - fraction_bits - leading_zeros)
+    const Row exponent{detail::SubtractRows(
+                           builder_,
+                           MakeConstant(static_cast<long long>(size - 1 - fraction_bits) + bias_,
+                                        exponent_width_),
+                           ZeroExtend(leading_zeros, exponent_width_), objective_)
+                           .first};
+    const std::size_t kept{size - 1 - mantissa_bits_};
+    return RoundAndPack(sign, exponent, Slice(normalized, kept, size), normalized[kept - 1],
+                        detail::OrBits(builder_, Slice(normalized, 0, kept - 1)),
+                        IsZero(builder_, magnitude));
+  }
+
+  Row Add(const Row& a, const Row& b);
+  Row Multiply(const Row& a, const Row& b);
+  Row Divide(const Row& a, const Row& b);
+  Row SquareRoot(const Row& a);
+  Row Compare(const Row& a, const Row& b, bool is_equality);
+  Row Exp2(const Row& a, bool is_natural);
+  Row Log2(const Row& a, bool is_natural);
+
+  std::size_t exponent_bits_;
+  std::size_t mantissa_bits_;
+  std::size_t bitlength_;
+  std::size_t exponent_width_;
+  long long bias_;
+  CircuitObjective objective_;
+  CircuitBuilder builder_;
+};
+
+Row FloatingPointCircuit::Add(const Row& a, const Row& b) {
+  // the operands are swapped s.t. x has the larger magnitude, which is compared on the exponent
+  // and mantissa bits in their order
+  const Bit swap{detail::SubtractRows(builder_, Slice(a, 0, bitlength_ - 1),
+                                      Slice(b, 0, bitlength_ - 1), objective_)
+                     .second};
+  Row larger(bitlength_), smaller(bitlength_);
+  for (std::size_t i = 0; i < bitlength_; ++i) {
+    const Bit difference{builder_.And(swap, builder_.Xor(a[i], b[i]))};
+    larger[i] = builder_.Xor(a[i], difference);
+    smaller[i] = builder_.Xor(b[i], difference);
+  }
+  const Number x{Unpack(larger)}, y{Unpack(smaller)};
+
+  // the significands get three guard bits and y is aligned to x with the bits that are shifted
+  // out in the last guard bit
+  const std::size_t width{mantissa_bits_ + 4};
+  Row x_significand(3, kZero), y_significand(3, kZero);
+  x_significand.insert(x_significand.end(), x.significand.begin(), x.significand.end());
+  y_significand.insert(y_significand.end(), y.significand.begin(), y.significand.end());
+  const Row distance{
+      detail::SubtractRows(builder_, x.exponent, y.exponent, objective_).first};
+  auto [aligned, sticky]{ShiftRightSticky(builder_, y_significand, distance)};
+  aligned[0] = builder_.Or(aligned[0], sticky);
+
+  // y is subtracted if the signs differ, which cannot be negative
+  const Bit is_subtraction{builder_.Xor(x.sign, y.sign)};
+  Row operand(width + 1);
+  for (std::size_t i = 0; i < width; ++i) operand[i] = builder_.Xor(aligned[i], is_subtraction);
+  operand[width] = is_subtraction;
+  const Row sum{detail::AddRows(builder_, ZeroExtend(x_significand, width + 1), operand,
+                                is_subtraction, objective_)};
+
+  // the sum has one more bit than x before the guard bits, s.t. its exponent is the one of x
+  // plus one minus its leading zeros
+  const auto [normalized, leading_zeros]{Normalize(builder_, sum)};
+  const Row exponent{
+      detail::SubtractRows(
+          builder_,
+          detail::AddRows(builder_, ZeroExtend(x.exponent, exponent_width_),
+                          Row(exponent_width_, kZero), kOne, objective_),
+          ZeroExtend(leading_zeros, exponent_width_), objective_)
+          .first};
+  const Bit is_zero{IsZero(builder_, sum)};
+  // an exact zero is negative only if both operands are
+  const Bit sign{builder_.Mux(is_zero, builder_.And(x.sign, y.sign), x.sign)};
+  return RoundAndPack(sign, exponent, Slice(normalized, 4, width + 1), normalized[3],
+                      detail::OrBits(builder_, Slice(normalized, 0, 3)), is_zero);
+}
+
+Row FloatingPointCircuit::Multiply(const Row& a, const Row& b) {
+  const Number x{Unpack(a)}, y{Unpack(b)};
+  const std::size_t width{2 * mantissa_bits_ + 2};
+  const Row product{
+      detail::MultiplyRows(builder_, x.significand, y.significand, width, objective_)};
+  // the product of the significands is in [1, 4) and shifted into [2, 4) if it is below 2
+  const Bit is_large{product.back()};
+  const Row normalized{MuxRows(builder_, is_large, product, ShiftLeft(product, 1))};
+  const Row exponent{detail::AddRows(
+      builder_,
+      detail::AddRows(builder_, ZeroExtend(x.exponent, exponent_width_),
+                      ZeroExtend(y.exponent, exponent_width_), is_large, objective_),
+      MakeConstant(-bias_, exponent_width_), kZero, objective_)};
+  return RoundAndPack(builder_.Xor(x.sign, y.sign), exponent,
+                      Slice(normalized, mantissa_bits_ + 1, width), normalized[mantissa_bits_],
+                      detail::OrBits(builder_, Slice(normalized, 0, mantissa_bits_)),
+                      builder_.Or(x.is_zero, y.is_zero));
+}
+
+Row FloatingPointCircuit::Divide(const Row& a, const Row& b) {
+  const Number x{Unpack(a)}, y{Unpack(b)};
+  // restoring division of the significands, whose quotient in (1/2, 2) gets mantissa_bits + 3
+  // bits, the first of weight 1, and a remainder below the divisor
+  const std::size_t width{mantissa_bits_ + 2}, quotient_bits{mantissa_bits_ + 3};
+  const Row divisor{ZeroExtend(y.significand, width)};
+  Row remainder{ZeroExtend(x.significand, width)};
+  Row quotient(quotient_bits);
+  for (std::size_t i = quotient_bits; i-- > 0;) {
+    const auto [difference, is_less]{
+        detail::SubtractRows(builder_, remainder, divisor, objective_)};
+    quotient[i] = builder_.Not(is_less);
+    remainder = MuxRows(builder_, is_less, remainder, difference);
+    if (i > 0) remainder = ShiftLeft(remainder, 1);
+  }
+  const Bit is_large{quotient.back()};
+  const Row normalized{MuxRows(builder_, is_large, quotient, ShiftLeft(quotient, 1))};
+  const Row exponent{detail::SubtractRows(
+                         builder_,
+                         detail::AddRows(builder_, ZeroExtend(x.exponent, exponent_width_),
+                                         MakeConstant(bias_ - 1, exponent_width_), is_large,
+                                         objective_),
+                         ZeroExtend(y.exponent, exponent_width_), objective_)
+                         .first};
+  return RoundAndPack(builder_.Xor(x.sign, y.sign), exponent, Slice(normalized, 2, quotient_bits),
+                      normalized[1],
+                      builder_.Or(normalized[0], builder_.Not(IsZero(builder_, remainder))),
+                      x.is_zero);
+}
+
+Row FloatingPointCircuit::SquareRoot(const Row& a) {
+  const Number x{Unpack(a)};
+  // the significand is doubled for an odd unbiased exponent, i.e., an even biased one, and
+  // the digit-by-digit method computes mantissa_bits + 3 bits of the root of the radicand
+  // significand * 2^(mantissa_bits + 4), s.t. the first bit of the root is one
+  const std::size_t root_bits{mantissa_bits_ + 3}, width{mantissa_bits_ + 5};
+  const Bit is_even{builder_.Not(x.exponent[0])};
+  Row radicand(2 * root_bits, kZero);
+  for (std::size_t i = 0; i <= mantissa_bits_; ++i) {
+    const Bit previous{i > 0 ? x.significand[i - 1] : kZero};
+    radicand[mantissa_bits_ + 4 + i] = builder_.Mux(is_even, previous, x.significand[i]);
+  }
+  radicand.back() = builder_.And(is_even, x.significand.back());
+  Row remainder(width, kZero), root(root_bits, kZero);
+  for (std::size_t i = root_bits; i-- > 0;) {
+    remainder = ShiftLeft(remainder, 2);
+    remainder[0] = radicand[2 * i];
+    remainder[1] = radicand[2 * i + 1];
+    // the trial subtrahend 4 * root + 1
+    Row trial(width, kZero);
+    trial[0] = kOne;
+    for (std::size_t j = 0; j + 2 < width && j < root_bits; ++j) trial[j + 2] = root[j];
+    const auto [difference, is_less]{detail::SubtractRows(builder_, remainder, trial, objective_)};
+    remainder = MuxRows(builder_, is_less, remainder, difference);
+    root = ShiftLeft(root, 1);
+    root[0] = builder_.Not(is_less);
+  }
+  // the exponent of the root is floor((exponent + bias) / 2)
+  const Row sum{detail::AddRows(builder_, ZeroExtend(x.exponent, exponent_width_),
+                                MakeConstant(bias_, exponent_width_), kZero, objective_)};
+  const Row exponent{ZeroExtend(Slice(sum, 1, exponent_width_), exponent_width_)};
+  return RoundAndPack(x.sign, exponent, Slice(root, 2, root_bits), root[1],
+                      builder_.Or(root[0], builder_.Not(IsZero(builder_, remainder))), x.is_zero);
+}
+
+Row FloatingPointCircuit::Compare(const Row& a, const Row& b, bool is_equality) {
+  const Bit a_sign{a.back()}, b_sign{b.back()};
+  const auto [difference, is_less]{detail::SubtractRows(
+      builder_, Slice(a, 0, bitlength_ - 1), Slice(b, 0, bitlength_ - 1), objective_)};
+  const Bit is_equal{IsZero(builder_, difference)};
+  // +0 and -0 are equal
+  Row exponents{Slice(a, mantissa_bits_, bitlength_ - 1)};
+  for (std::size_t i = mantissa_bits_; i + 1 < bitlength_; ++i) exponents.push_back(b[i]);
+  const Bit are_zeros{IsZero(builder_, exponents)};
+  const Bit signs_differ{builder_.Xor(a_sign, b_sign)};
+  if (is_equality) {
+    return {builder_.Or(are_zeros, builder_.And(builder_.Not(signs_differ), is_equal))};
+  }
+  // for negative numbers, the larger magnitude is the smaller number
+  const Bit is_greater{builder_.Not(builder_.Or(is_less, is_equal))};
+  return {builder_.Mux(signs_differ, builder_.And(a_sign, builder_.Not(are_zeros)),
+                       builder_.Mux(a_sign, is_greater, is_less))};
+}
+
+Row FloatingPointCircuit::Exp2(const Row& a, bool is_natural) {
+  const Number x{Unpack(a)};
+  // x is converted to a fixed-point number with fraction_bits fractional bits, which is exact for
+  // |x| < 2^(exponent_bits - 1), since the result overflows or is flushed to zero for larger |x|
+  const std::size_t fraction_bits{mantissa_bits_ + 4}, width{exponent_bits_ + 1 + fraction_bits};
+  const long long largest_exponent{static_cast<long long>(exponent_bits_) - 2};
+  const Row shifted{ShiftLeft(ZeroExtend(x.significand, width),
+                              largest_exponent + fraction_bits - mantissa_bits_)};
+  const auto [distance, is_large]{detail::SubtractRows(
+      builder_, MakeConstant(largest_exponent + bias_, exponent_width_),
+      ZeroExtend(x.exponent, exponent_width_), objective_)};
+  Row magnitude{ShiftRightSticky(builder_, shifted, Slice(distance, 0, exponent_width_ - 1)).first};
+  if (is_natural) {
+    // e^x = 2^(x * log2(e)), where the constant has enough bits for the largest |x|
+    const std::size_t constant_bits{fraction_bits + exponent_bits_};
+    const Row log2_e{MakeFixedPointConstant(std::log2(std::exp(1.0L)), constant_bits,
+                                            constant_bits + 1)};
+    magnitude = Slice(detail::MultiplyRows(builder_, magnitude, log2_e, width + constant_bits,
+                                           objective_),
+                      constant_bits, width + constant_bits);
+  }
+  // the two's complement of x = n + r with an integer n and r in [0, 1)
+  const Row fixed_point{ConditionalNegation(builder_, magnitude, x.sign, objective_)};
+
+  // 2^r is the product of the constants 2^(2^-i) for the bits r_i of weight 2^-i, which are
+  // multiplied with significand_bits fractional bits
+  const std::size_t significand_bits{mantissa_bits_ + 8};
+  Row power{MakeFixedPointConstant(1, significand_bits, significand_bits + 1)};
+  for (std::size_t i = 1; i <= fraction_bits; ++i) {
+    const Row constant{MakeFixedPointConstant(std::exp2(std::ldexp(1.0L, -static_cast<int>(i))),
+                                              significand_bits, significand_bits + 1)};
+    const Row product{Slice(detail::MultiplyRows(builder_, power, constant,
+                                                 2 * significand_bits + 1, objective_),
+                            significand_bits, 2 * significand_bits + 1)};
+    power = MuxRows(builder_, fixed_point[fraction_bits - i], product, power);
+  }
+  const Row exponent{detail::AddRows(
+      builder_, SignExtend(Slice(fixed_point, fraction_bits, width), exponent_width_),
+      MakeConstant(bias_, exponent_width_), kZero, objective_)};
+  const std::size_t kept{significand_bits - mantissa_bits_};
+  return RoundAndPack(kZero, exponent, Slice(power, kept, significand_bits + 1), power[kept - 1],
+                      detail::OrBits(builder_, Slice(power, 0, kept - 1)),
+                      builder_.And(x.sign, is_large));
+}
+
+Row FloatingPointCircuit::Log2(const Row& a, bool is_natural) {
+  const Number x{Unpack(a)};
+  // log2(x) = exponent - bias + log2(significand), whose fractional bits are the integer parts
+  // of the significand squared repeatedly and halved in [1, 2)
+  const std::size_t fraction_bits{mantissa_bits_ + 4}, significand_bits{mantissa_bits_ + 8};
+  Row significand{ShiftLeft(ZeroExtend(x.significand, significand_bits + 1),
+                            significand_bits - mantissa_bits_)};
+  Row fixed_point(fraction_bits);
+  for (std::size_t i = fraction_bits; i-- > 0;) {
+    const Row square{Slice(SquareRow(builder_, significand, 2 * significand_bits + 2, objective_),
+                           significand_bits, 2 * significand_bits + 2)};
+    fixed_point[i] = square.back();
+    significand = MuxRows(builder_, fixed_point[i], Slice(square, 1, significand_bits + 2),
+                          Slice(square, 0, significand_bits + 1));
+  }
+  const Row integer_part{detail::SubtractRows(builder_, ZeroExtend(x.exponent, exponent_width_),
+                                              MakeConstant(bias_, exponent_width_), objective_)
+                             .first};
+  fixed_point.insert(fixed_point.end(), integer_part.begin(), integer_part.end());
+  const Bit sign{fixed_point.back()};
+  Row magnitude{ConditionalNegation(builder_, fixed_point, sign, objective_)};
+  if (is_natural) {
+    // ln(x) = log2(x) * ln(2)
+    const std::size_t width{magnitude.size()}, constant_bits{fraction_bits + exponent_bits_};
+    const Row ln_2{MakeFixedPointConstant(std::log(2.0L), constant_bits, constant_bits + 1)};
+    magnitude = Slice(detail::MultiplyRows(builder_, magnitude, ln_2, width + constant_bits,
+                                           objective_),
+                      constant_bits, width + constant_bits);
+  }
+  return PackFixedPoint(sign, magnitude, fraction_bits);
+}
+
+AlgorithmDescription FloatingPointCircuit::Build(FloatingPointOperationType type) && {
+  Row a(bitlength_), b(bitlength_);
+  for (std::size_t i = 0; i < bitlength_; ++i) a[i] = builder_.InputA(i);
+  switch (type) {
+    case FloatingPointOperationType::kSqrt:
+    case FloatingPointOperationType::kExp2:
+    case FloatingPointOperationType::kExp:
+    case FloatingPointOperationType::kLog2:
+    case FloatingPointOperationType::kLog:
+      break;
+    default:
+      for (std::size_t i = 0; i < bitlength_; ++i) b[i] = builder_.InputB(i);
+  }
+  Row result;
+  switch (type) {
+    case FloatingPointOperationType::kAdd:
+      result = Add(a, b);
+      break;
+    case FloatingPointOperationType::kSub:
+      b.back() = builder_.Not(b.back());
+      result = Add(a, b);
+      break;
+    case FloatingPointOperationType::kMul:
+      result = Multiply(a, b);
+      break;
+    case FloatingPointOperationType::kDiv:
+      result = Divide(a, b);
+      break;
+    case FloatingPointOperationType::kLt:
+      result = Compare(a, b, false);
+      break;
+    case FloatingPointOperationType::kEq:
+      result = Compare(a, b, true);
+      break;
+    case FloatingPointOperationType::kSqrt:
+      result = SquareRoot(a);
+      break;
+    case FloatingPointOperationType::kExp2:
+      result = Exp2(a, false);
+      break;
+    case FloatingPointOperationType::kExp:
+      result = Exp2(a, true);
+      break;
+    case FloatingPointOperationType::kLog2:
+      result = Log2(a, false);
+      break;
+    case FloatingPointOperationType::kLog:
+      result = Log2(a, true);
+      break;
+    default:
+      throw std::invalid_argument("Invalid FloatingPointOperationType");
+  }
+  return std::move(builder_).Build(result);
+}
+
+}  // namespace
+
+AlgorithmDescription MakeFloatingPointCircuit(FloatingPointOperationType type,
+                                              std::size_t exponent_bits,
+                                              std::size_t mantissa_bits,
+                                              CircuitObjective objective) {
+  if (exponent_bits < 2 || exponent_bits > 11) {
+    throw std::invalid_argument("Floating-point numbers need 2 to 11 exponent bits");
+  }
+  if (mantissa_bits < 1 || mantissa_bits > 52) {
+    throw std::invalid_argument("Floating-point numbers need 1 to 52 mantissa bits");
+  }
+  const bool is_binary{type == FloatingPointOperationType::kAdd ||
+                       type == FloatingPointOperationType::kSub ||
+                       type == FloatingPointOperationType::kMul ||
+                       type == FloatingPointOperationType::kDiv ||
+                       type == FloatingPointOperationType::kLt ||
+                       type == FloatingPointOperationType::kEq};
+  return FloatingPointCircuit(exponent_bits, mantissa_bits, is_binary, objective)
+      .Build(type);
+}
+
+}  // namespace encrypto::motion
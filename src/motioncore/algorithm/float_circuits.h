@@ -0,0 +1,62 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "algorithm_description.h"
+#include "circuit_optimizer.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+/// \brief Generates a Boolean circuit of the floating-point operation type on IEEE 754 binary
+/// numbers of 1 + exponent_bits + mantissa_bits bits, i.e., 8 and 23 for binary32 (float) and 11
+/// and 52 for binary64 (double).  The operands are the inputs of parent a and, for the binary
+/// operations kAdd, kSub, kMul, kDiv, kLt and kEq, parent b, each with the least significant bit
+/// of the mantissa first and the sign last as given by ToInput.  The comparisons kLt and kEq
+/// output a single bit and all other operations a number of the same format.
+///
+/// The circuits are built from the adders and multipliers of integer_circuits.h, s.t.
+/// CircuitObjective::kSize and CircuitObjective::kDepth trade off AND gates and AND depth as
+/// there.  Supported are zeros and normal numbers:
+///   - subnormal inputs are not supported and subnormal results are flushed to zero,
+///   - infinities and NaNs are not supported, i.e., results must not overflow, and the results of
+///     divisions by zero, square roots of negative numbers, and logarithms of numbers that are
+///     not positive are undefined.
+/// kAdd, kSub, kMul, kDiv and kSqrt are rounded to nearest with ties to even as in IEEE 754.
+/// kExp2 and kExp evaluate 2^x = 2^floor(x) * 2^r on a fixed-point x with mantissa_bits + 4
+/// fractional bits as products of the constants 2^(2^-i) selected by the bits of r and are off by
+/// at most one unit in the last place.  kLog2 and kLog compute the fractional bits of log2 of the
+/// mantissa by repeated squaring and have an absolute error of at most 2^-(mantissa_bits + 2)
+/// plus the rounding of the result, which is relatively large for results close to zero.
+/// \throws std::invalid_argument if exponent_bits is not in [2, 11], mantissa_bits is not in
+/// [1, 52], or type is FloatingPointOperationType::kInvalid
+AlgorithmDescription MakeFloatingPointCircuit(FloatingPointOperationType type,
+                                              std::size_t exponent_bits,
+                                              std::size_t mantissa_bits,
+                                              CircuitObjective objective);
+
+}  // namespace encrypto::motion
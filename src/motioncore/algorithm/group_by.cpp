@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "group_by.h"
+
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "protocols/share.h"
+#include "sort.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the bit length of the counts of AggregationType::kCount
+constexpr std::size_t kCountBitLength{32};
+
+std::vector<std::size_t> Range(std::size_t begin, std::size_t end) {
+  std::vector<std::size_t> positions(end - begin);
+  std::iota(positions.begin(), positions.end(), begin);
+  return positions;
+}
+
+ShareWrapper SubsetOf(ShareWrapper share, std::size_t begin, std::size_t end) {
+  return share.Subset(Range(begin, end));
+}
+
+bool IsSupportedBitLength(std::size_t bit_length) {
+  return bit_length == 8 || bit_length == 16 || bit_length == 32 || bit_length == 64;
+}
+
+void CheckInputs(const ShareWrapper& keys, const ShareWrapper& values, AggregationType type) {
+  const MpcProtocol protocol{keys->GetProtocol()};
+  if (protocol != MpcProtocol::kBooleanGmw && protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Grouping does not support protocol {}", to_string(protocol)));
+  }
+  if (!IsSupportedBitLength(keys->GetBitLength())) {
+    throw std::invalid_argument(
+        fmt::format("Grouping keys need 8, 16, 32 or 64 bits but have {}", keys->GetBitLength()));
+  }
+  if (type == AggregationType::kCount) return;
+  if (values->GetProtocol() != protocol ||
+      values->GetNumberOfSimdValues() != keys->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(
+        "Grouped values need the same protocol and number of SIMD values as the keys");
+  }
+  if (type == AggregationType::kMax && !IsSupportedBitLength(values->GetBitLength())) {
+    throw std::invalid_argument(fmt::format(
+        "The maximum needs values of 8, 16, 32 or 64 bits but they have {}",
+        values->GetBitLength()));
+  }
+}
+
+// the rows of value for kCount, which are one for the rows of reference and zero for the dummies
+ShareWrapper MakeCountValues(const ShareWrapper& reference, std::size_t number_of_dummies) {
+  const auto bit{reference.Split().at(0)};
+  // the XOR of a share with itself is a zero without communication
+  const auto zero{bit ^ bit};
+  std::vector<ShareWrapper> wires(kCountBitLength, zero);
+  wires.at(0) = ~zero;
+  const auto ones{ShareWrapper::Concatenate(wires)};
+  if (number_of_dummies == 0) return ones;
+  const auto zeros{
+      SubsetOf(ones ^ ones, 0, 1).Subset(std::vector<std::size_t>(number_of_dummies, 0))};
+  return ShareWrapper::Simdify(std::vector<ShareWrapper>{ones, zeros});
+}
+
+// SUM and COUNT add without communication in arithmetic GMW and select with one multiplication
+bool AggregatesInArithmeticGmw(const ShareWrapper& values, AggregationType type) {
+  return type != AggregationType::kMax && values->GetProtocol() == MpcProtocol::kBooleanGmw &&
+         IsSupportedBitLength(values->GetBitLength());
+}
+
+// aggregates the groups of the sorted rows and returns the aggregates and the group ends
+std::pair<SecureUnsignedIntegerVector, ShareWrapper> AggregateSortedGroups(
+    const ShareWrapper& sorted_keys, const ShareWrapper& sorted_values, AggregationType type) {
+  const std::size_t size{sorted_keys->GetNumberOfSimdValues()};
+  const auto first_bit{SubsetOf(sorted_keys.Split().at(0), 0, 1)};
+  const auto one{~(first_bit ^ first_bit)};
+
+  // row i starts a group iff its key differs from the key of row i - 1
+  ShareWrapper is_group_start{one}, is_group_end{one};
+  if (size > 1) {
+    const auto differs{~(SubsetOf(sorted_keys, 1, size) == SubsetOf(sorted_keys, 0, size - 1))};
+    is_group_start = ShareWrapper::Simdify(std::vector<ShareWrapper>{one, differs});
+    is_group_end = ShareWrapper::Simdify(std::vector<ShareWrapper>{differs, one});
+  }
+
+  SecureUnsignedIntegerVector aggregates{AggregatesInArithmeticGmw(sorted_values, type)
+                                             ? sorted_values.Convert<MpcProtocol::kArithmeticGmw>()
+                                             : sorted_values};
+  // segmented scan: after the round with distance, row i combines the rows
+  // max(i - 2 * distance + 1, start of its group)..i and is_segment_start[i] tells whether this
+  // range reaches the start of the group
+  ShareWrapper is_segment_start{is_group_start};
+  for (std::size_t distance = 1; distance < size; distance *= 2) {
+    const auto tail{Range(distance, size)}, head{Range(0, size - distance)};
+    const auto current{aggregates.Gather(tail)}, previous{aggregates.Gather(head)};
+    const auto current_is_start{SubsetOf(is_segment_start, distance, size)};
+    const auto previous_is_start{SubsetOf(is_segment_start, 0, size - distance)};
+    SecureUnsignedIntegerVector combined;
+    if (type == AggregationType::kMax) {
+      combined = SecureUnsignedIntegerVector::Mux(~current_is_start & (previous > current),
+                                                  previous, current);
+    } else {
+      combined =
+          SecureUnsignedIntegerVector::Mux(~current_is_start, current + previous, current);
+    }
+    aggregates = ShareWrapper::Simdify(
+        std::vector<ShareWrapper>{aggregates.Gather(Range(0, distance)).Get().Get(),
+                                  combined.Get().Get()});
+    // the last round does not need the segment starts anymore
+    if (2 * distance < size) {
+      is_segment_start = ShareWrapper::Simdify(std::vector<ShareWrapper>{
+          SubsetOf(is_segment_start, 0, distance), current_is_start | previous_is_start});
+    }
+  }
+  return {aggregates, is_group_end};
+}
+
+}  // namespace
+
+GroupByResult GroupBy(const ShareWrapper& keys, const ShareWrapper& values, AggregationType type) {
+  CheckInputs(keys, values, type);
+  const auto grouped_values{type == AggregationType::kCount ? MakeCountValues(keys, 0) : values};
+  const auto [sorted_keys, sorted_values] = SortBy(keys, grouped_values);
+  auto [aggregates, is_group_end] = AggregateSortedGroups(sorted_keys, sorted_values, type);
+  return {sorted_keys, is_group_end, std::move(aggregates)};
+}
+
+SecureUnsignedIntegerVector GroupByCategories(const ShareWrapper& keys, const ShareWrapper& values,
+                                              std::size_t number_of_categories,
+                                              AggregationType type) {
+  CheckInputs(keys, values, type);
+  if (keys->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    throw std::invalid_argument(fmt::format("Grouping by categories does not support protocol {}",
+                                            to_string(keys->GetProtocol())));
+  }
+  const std::size_t bit_length{keys->GetBitLength()};
+  if (number_of_categories == 0 || number_of_categories > (std::size_t(1) << (bit_length - 1))) {
+    throw std::invalid_argument(fmt::format("{} categories do not fit into keys of {} bits",
+                                            number_of_categories, bit_length));
+  }
+
+  // one dummy row with a neutral value for each category
+  const auto dummy_rows{std::vector<std::size_t>(number_of_categories, 0)};
+  const auto zero_keys{SubsetOf(keys ^ keys, 0, 1).Subset(dummy_rows)};
+  std::vector<BitVector<>> categories(bit_length, BitVector<>(number_of_categories));
+  for (std::size_t c = 0; c < number_of_categories; ++c) {
+    for (std::size_t i = 0; i < bit_length; ++i) categories[i].Set(((c >> i) & 1) == 1, c);
+  }
+  const ShareWrapper category_keys{keys->GetBackend().ConstantBooleanInput(std::move(categories))};
+  const auto all_keys{
+      ShareWrapper::Simdify(std::vector<ShareWrapper>{keys, zero_keys ^ category_keys})};
+  ShareWrapper all_values;
+  if (type == AggregationType::kCount) {
+    all_values = MakeCountValues(keys, number_of_categories);
+  } else {
+    // zero is neutral for the sum and for the maximum of unsigned integers
+    const auto zero_values{SubsetOf(values ^ values, 0, 1).Subset(dummy_rows)};
+    all_values = ShareWrapper::Simdify(std::vector<ShareWrapper>{values, zero_values});
+  }
+
+  const auto [sorted_keys, sorted_values] = SortBy(all_keys, all_values);
+  auto [aggregates, is_group_end] = AggregateSortedGroups(sorted_keys, sorted_values, type);
+  ShareWrapper boolean_aggregates{aggregates.Get().Get()};
+  if (boolean_aggregates->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    boolean_aggregates = boolean_aggregates.Convert<MpcProtocol::kBooleanGmw>();
+  }
+
+  // the group ends of the categories have the smallest keys if the most significant bit is set
+  // for all other rows, which also moves the groups of keys of at least 2^(l - 1) to the back
+  auto key_wires{sorted_keys.Split()};
+  key_wires.back() = key_wires.back() | ~is_group_end;
+  const auto [compacted_keys, compacted_aggregates] =
+      SortBy(ShareWrapper::Concatenate(key_wires), boolean_aggregates);
+  return SubsetOf(compacted_aggregates, 0, number_of_categories);
+}
+
+}  // namespace encrypto::motion::algorithm
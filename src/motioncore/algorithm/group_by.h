@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "protocols/share_wrapper.h"
+#include "secure_type/secure_unsigned_integer_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+enum class AggregationType : unsigned int { kSum, kCount, kMax };
+
+/// \brief the groups of rows with equal keys and their aggregated values
+struct GroupByResult {
+  /// the keys in ascending order
+  ShareWrapper keys;
+  /// share of 1 wire, which is 1 at the last row of each group
+  ShareWrapper is_group_end;
+  /// the aggregate of the rows of each group at its last row and of a prefix of the group at
+  /// the other rows, which can be dropped by ShareWrapper::Mux with is_group_end
+  SecureUnsignedIntegerVector aggregates;
+};
+
+/// \brief groups the rows, i.e., SIMD values, of keys and values by keys and aggregates the values
+/// of each group.  The rows are sorted by SortBy s.t. the groups are contiguous and aggregated by a
+/// segmented Hillis-Steele scan of ceil(log2 n) rounds, each of which combines all rows at once.
+/// The protocol of the scan is chosen automatically: SUM and COUNT of Boolean GMW rows are
+/// converted to arithmetic GMW, where the additions are local and each round needs a single
+/// multiplication with the 1-bit selection, and MAX and BMR stay in the protocol of the keys.
+/// This takes O(n log^2 n) instead of the O(n * k) comparisons of one pass per group.
+/// \param keys Boolean GMW or BMR share of 8, 16, 32 or 64 bits
+/// \param values share of the same protocol and number of SIMD values as keys, whose bit length
+///        is 8, 16, 32 or 64 for kMax, which is ignored for kCount
+/// \returns the aggregates as arithmetic GMW for the sums and counts of Boolean GMW rows and
+///          in the protocol of the keys otherwise, where COUNT has 32 bits
+/// \throws std::invalid_argument if keys and values do not fit
+GroupByResult GroupBy(const ShareWrapper& keys, const ShareWrapper& values, AggregationType type);
+
+/// \brief aggregates the values of the rows by the public categories 0, ..., k - 1 of their keys,
+/// e.g., for cross tabulation.  One row of each category with a neutral value is appended before
+/// GroupBy s.t. every category forms a group, and a second SortBy by the keys of the group ends
+/// moves the k groups to the front.  Rows with keys of at least k are ignored.
+/// \param keys Boolean GMW share of 8, 16, 32 or 64 bits
+/// \param values see GroupBy
+/// \returns a vector of one aggregate per category as Boolean GMW share
+/// \throws std::invalid_argument if keys and values do not fit or if number_of_categories is 0 or
+///         greater than 2^(l - 1) for the bit length l of the keys
+SecureUnsignedIntegerVector GroupByCategories(const ShareWrapper& keys, const ShareWrapper& values,
+                                              std::size_t number_of_categories,
+                                              AggregationType type);
+
+}  // namespace encrypto::motion::algorithm
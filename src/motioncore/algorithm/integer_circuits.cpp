@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "integer_circuits.h"
+
+#include <bit>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "circuit_builder.h"
+
+namespace encrypto::motion {
+
+using detail::Bit;
+using detail::CircuitBuilder;
+using detail::kZero;
+
+AlgorithmDescription MakeAdditionCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate an adder of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  const auto sum{AddRows(builder, a, b, kZero, objective)};
+  return std::move(builder).Build(sum);
+}
+
+AlgorithmDescription MakeSubtractionCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a subtractor of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  const auto difference{SubtractRows(builder, a, b, objective).first};
+  return std::move(builder).Build(difference);
+}
+
+AlgorithmDescription MakeGreaterThanCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a comparator of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  // the gates of the difference itself are removed by Build
+  const Bit is_greater{SubtractRows(builder, b, a, objective).second};
+  return std::move(builder).Build({is_greater});
+}
+
+AlgorithmDescription MakeSignedGreaterThanCircuit(std::size_t bitlength,
+                                                  CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a comparator of 0 bits");
+  CircuitBuilder builder(bitlength);
+  auto [a, b]{GetInputs(builder, bitlength)};
+  // a + 2^(bitlength - 1) > b + 2^(bitlength - 1) as unsigned integers
+  a.back() = builder.Not(a.back());
+  b.back() = builder.Not(b.back());
+  const Bit is_greater{SubtractRows(builder, b, a, objective).second};
+  return std::move(builder).Build({is_greater});
+}
+
+AlgorithmDescription MakeAbsoluteValueCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate an absolute value of 0 bits");
+  CircuitBuilder builder(bitlength, 0);
+  std::vector<Bit> x;
+  x.reserve(bitlength);
+  for (std::size_t i = 0; i < bitlength; ++i) x.push_back(builder.InputA(i));
+  return std::move(builder).Build(ConditionalNegation(builder, x, x.back(), objective));
+}
+
+AlgorithmDescription MakeMultiplicationCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a multiplier of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  const auto product{MultiplyRows(builder, a, b, bitlength, objective)};
+  return std::move(builder).Build(product);
+}
+
+AlgorithmDescription MakeHammingWeightCircuit(std::size_t number_of_bits,
+                                             CircuitObjective objective) {
+  if (number_of_bits == 0) throw std::invalid_argument("Cannot count the ones of 0 bits");
+  CircuitBuilder builder(number_of_bits, 0);
+  // all bits have weight 1 and the carries of full adders go to the columns of higher weights
+  std::vector<std::vector<Bit>> columns(std::bit_width(number_of_bits));
+  for (std::size_t i = 0; i < number_of_bits; ++i) columns[0].push_back(builder.InputA(i));
+  const auto [row_a, row_b]{ReduceColumns(builder, std::move(columns), objective)};
+  return std::move(builder).Build(AddRows(builder, row_a, row_b, kZero, objective));
+}
+
+AlgorithmDescription MakeDivisionCircuit(std::size_t bitlength, CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a divider of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  const auto quotient{DivideRows(builder, a, b, objective)};
+  return std::move(builder).Build(quotient);
+}
+
+AlgorithmDescription MakeSignedDivisionCircuit(std::size_t bitlength,
+                                               CircuitObjective objective) {
+  if (bitlength == 0) throw std::invalid_argument("Cannot generate a divider of 0 bits");
+  CircuitBuilder builder(bitlength);
+  const auto [a, b]{GetInputs(builder, bitlength)};
+  // the quotient of the absolute values gets the sign of the product of a and b
+  const Bit a_is_negative{a.back()}, b_is_negative{b.back()};
+  const auto quotient{DivideRows(builder, ConditionalNegation(builder, a, a_is_negative, objective),
+                                 ConditionalNegation(builder, b, b_is_negative, objective),
+                                 objective)};
+  return std::move(builder).Build(ConditionalNegation(
+      builder, quotient, builder.Xor(a_is_negative, b_is_negative), objective));
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+
+#pragma once
+
+#include <cstddef>
+
+#include "algorithm_description.h"
+#include "circuit_optimizer.h"
+
+namespace encrypto::motion {
+
+/// \brief Generates a Boolean circuit that adds two unsigned integers of bitlength bits modulo
+/// 2^bitlength.  The summands are the inputs of parent a and b and the sum is the output, each
+/// with the least significant bit first as in the circuits of circuits/int.
+///   - CircuitObjective::kSize gives a ripple-carry adder of bitlength - 1 AND gates, and
+///   - CircuitObjective::kDepth gives a Sklansky parallel-prefix adder of AND depth
+///     ceil(log2(bitlength)), which is the smallest possible.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeAdditionCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that subtracts two unsigned integers of bitlength bits
+/// modulo 2^bitlength with the inputs and outputs of MakeAdditionCircuit, i.e., the output is
+/// a - b, which is computed as a + ~b + 1 by the adder of MakeAdditionCircuit.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeSubtractionCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that compares two unsigned integers of bitlength bits with
+/// the inputs of MakeAdditionCircuit, whose single output bit is a > b.  Only the carries of
+/// b - a are computed, i.e., bitlength AND gates for CircuitObjective::kSize and an AND depth of
+/// ceil(log2(bitlength + 1)) for CircuitObjective::kDepth.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeGreaterThanCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit as MakeGreaterThanCircuit for integers in two's complement.
+/// The most significant bits are inverted, which maps the order of the signed integers to the
+/// order of the unsigned integers, and thus, the circuit has the same costs.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeSignedGreaterThanCircuit(std::size_t bitlength,
+                                                  CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that computes the absolute value of an integer of bitlength
+/// bits in two's complement, the input of parent a, with the least significant bit first.  The
+/// input is negated conditioned on its sign bit as (x ^ sign) + sign, i.e., the circuit costs an
+/// incrementer of bitlength - 1 AND gates, and the smallest integer is its own absolute value.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeAbsoluteValueCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that multiplies two unsigned integers of bitlength bits
+/// modulo 2^bitlength with the inputs and outputs of MakeAdditionCircuit.  The partial products
+/// of the result bits are reduced by full adders to two rows, which are added by the adder of
+/// MakeAdditionCircuit.  For CircuitObjective::kDepth, each full adder takes the bits of a column
+/// with the lowest AND depth as in a Wallace tree, s.t. the AND depth grows logarithmically in
+/// bitlength.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeMultiplicationCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that counts the ones among the number_of_bits inputs of
+/// parent a, i.e., the output is their Hamming weight in std::bit_width(number_of_bits) bits with
+/// the least significant bit first.  The inputs are compressed by full adders in Wallace-style
+/// counter trees as in MakeMultiplicationCircuit.  CircuitObjective::kSize needs fewer than
+/// number_of_bits AND gates and CircuitObjective::kDepth an AND depth of at most
+/// 2 * ceil(log2(number_of_bits)).
+/// \throws std::invalid_argument if number_of_bits is 0
+AlgorithmDescription MakeHammingWeightCircuit(std::size_t number_of_bits,
+                                             CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit that divides two unsigned integers of bitlength bits with
+/// the inputs and outputs of MakeAdditionCircuit, i.e., the output is the quotient a / b rounded
+/// down, or all ones if b is zero.  The circuit performs non-restoring division, whose steps
+/// each add or subtract b by the adder of MakeAdditionCircuit on bitlength + 1 bits.  Thus, it
+/// has about bitlength^2 AND gates for CircuitObjective::kSize and an AND depth of about
+/// bitlength * log2(bitlength) for CircuitObjective::kDepth.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeDivisionCircuit(std::size_t bitlength, CircuitObjective objective);
+
+/// \brief Generates a Boolean circuit as MakeDivisionCircuit for integers in two's complement,
+/// whose quotient is rounded toward zero as in C++.  The quotient of the smallest integer by -1
+/// wraps around to the smallest integer, and a divisor of zero gives -1 for a non-negative and 1
+/// for a negative dividend.
+/// \throws std::invalid_argument if bitlength is 0
+AlgorithmDescription MakeSignedDivisionCircuit(std::size_t bitlength,
+                                               CircuitObjective objective);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,453 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "keccak.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/register.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "protocols/share.h"
+#include "protocols/wire.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+constexpr std::size_t kNumberOfRounds{24};
+constexpr std::size_t kLaneBitSize{64};
+constexpr std::size_t kSliceBitSize{5 * kLaneBitSize};
+
+// the constants of iota, which are XORed onto lane (0, 0)
+constexpr std::array<std::uint64_t, kNumberOfRounds> kRoundConstants{
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
+    0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008a, 0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008};
+
+// the rotations of rho, where lane (x, y) is at x + 5 * y
+constexpr std::array<std::size_t, 25> kRotationOffsets{0,  1,  62, 28, 27, 36, 44, 6,  55,
+                                                       20, 3,  10, 43, 25, 39, 41, 45, 15,
+                                                       21, 8,  18, 2,  61, 56, 14};
+
+// the wire of bit z of lane (x, y), where the coordinates are taken modulo 5 and 64
+constexpr std::size_t StateIndex(std::size_t x, std::size_t y, std::size_t z) {
+  return kLaneBitSize * (x % 5 + 5 * (y % 5)) + z % kLaneBitSize;
+}
+
+// the bit of the column parity of theta, i.e., of the XOR of the five bits z of the lanes (x, *)
+constexpr std::size_t ParityIndex(std::size_t x, std::size_t z) {
+  return kLaneBitSize * (x % 5) + z % kLaneBitSize;
+}
+
+// the bit z of the lanes (x, y) onto which the bit z of the lane (x, y) is moved by rho and pi
+constexpr std::size_t RhoPiIndex(std::size_t x, std::size_t y, std::size_t z) {
+  return StateIndex(y, 2 * x + 3 * y, z + kRotationOffsets[x + 5 * y]);
+}
+
+bool IsSetInRoundConstant(std::size_t round, std::size_t z) {
+  return ((kRoundConstants[round] >> z) & 1) == 1;
+}
+
+// XOR of the parents at the sorted indices terms, inverted if inverted
+struct LinearCombination {
+  std::vector<std::size_t> terms;
+  bool inverted{false};
+};
+
+LinearCombination operator^(const LinearCombination& a, const LinearCombination& b) {
+  LinearCombination result{.terms = {}, .inverted = a.inverted != b.inverted};
+  result.terms.reserve(a.terms.size() + b.terms.size());
+  std::set_symmetric_difference(a.terms.begin(), a.terms.end(), b.terms.begin(), b.terms.end(),
+                                std::back_inserter(result.terms));
+  return result;
+}
+
+// The state in Boolean GMW as linear combinations of parent wires.  A round materializes theta,
+// rho and pi of the combinations with a single FusedXorGate and computes the ANDs of chi with a
+// single AND gate, whose outputs are the parents of the next round.  Chi computes
+// b ^ (~b_1 & b_2) as b ^ b_2 ^ (b_1 & b_2), s.t. its XORs and iota are combinations again.
+class FusedKeccakState {
+ public:
+  void Xor(std::size_t bit, const ShareWrapper& wire) {
+    // the new parent has the largest index, which keeps the terms sorted
+    bits_.at(bit) = bits_.at(bit) ^ LinearCombination{.terms = {parents_.size()}};
+    parents_.emplace_back(wire->GetWires().at(0));
+  }
+
+  void Invert(std::size_t bit) { bits_.at(bit).inverted = !bits_.at(bit).inverted; }
+
+  void Permute() {
+    for (std::size_t round = 0; round < kNumberOfRounds; ++round) {
+      const auto b{Materialize(ThetaRhoPi())};
+      std::vector<ShareWrapper> b_1, b_2;
+      b_1.reserve(kKeccakStateBitSize);
+      b_2.reserve(kKeccakStateBitSize);
+      for (std::size_t y = 0; y < 5; ++y) {
+        for (std::size_t x = 0; x < 5; ++x) {
+          for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+            b_1.push_back(b[StateIndex(x + 1, y, z)]);
+            b_2.push_back(b[StateIndex(x + 2, y, z)]);
+          }
+        }
+      }
+      const auto products{
+          (ShareWrapper::Concatenate(b_1) & ShareWrapper::Concatenate(b_2)).Split()};
+
+      // the parents are b at [0, 1600) and the products at [1600, 3200)
+      parents_.clear();
+      parents_.reserve(2 * kKeccakStateBitSize);
+      for (const auto& wire : b) parents_.emplace_back(wire->GetWires().at(0));
+      for (const auto& wire : products) parents_.emplace_back(wire->GetWires().at(0));
+      for (std::size_t y = 0; y < 5; ++y) {
+        for (std::size_t x = 0; x < 5; ++x) {
+          for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+            const std::size_t bit{StateIndex(x, y, z)};
+            bits_[bit].terms = {std::min(bit, StateIndex(x + 2, y, z)),
+                                std::max(bit, StateIndex(x + 2, y, z)),
+                                kKeccakStateBitSize + bit};
+            bits_[bit].inverted = x == 0 && y == 0 && IsSetInRoundConstant(round, z);
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<ShareWrapper> Squeeze(std::size_t number_of_bits) const {
+    return Materialize(
+        std::vector<LinearCombination>(bits_.begin(), bits_.begin() + number_of_bits));
+  }
+
+ private:
+  std::vector<LinearCombination> ThetaRhoPi() const {
+    std::vector<LinearCombination> parities(kSliceBitSize);
+    for (std::size_t y = 0; y < 5; ++y) {
+      for (std::size_t x = 0; x < 5; ++x) {
+        for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+          parities[ParityIndex(x, z)] = parities[ParityIndex(x, z)] ^ bits_[StateIndex(x, y, z)];
+        }
+      }
+    }
+    std::vector<LinearCombination> result(kKeccakStateBitSize);
+    for (std::size_t y = 0; y < 5; ++y) {
+      for (std::size_t x = 0; x < 5; ++x) {
+        for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+          result[RhoPiIndex(x, y, z)] = bits_[StateIndex(x, y, z)] ^
+                                        parities[ParityIndex(x + 4, z)] ^
+                                        parities[ParityIndex(x + 1, z + kLaneBitSize - 1)];
+        }
+      }
+    }
+    return result;
+  }
+
+  // computes combinations with a single FusedXorGate
+  std::vector<ShareWrapper> Materialize(const std::vector<LinearCombination>& combinations) const {
+    std::vector<std::vector<std::size_t>> output_terms;
+    std::vector<bool> output_inversions;
+    output_terms.reserve(combinations.size());
+    output_inversions.reserve(combinations.size());
+    for (const auto& combination : combinations) {
+      output_terms.push_back(combination.terms);
+      output_inversions.push_back(combination.inverted);
+    }
+    auto& backend{parents_.at(0)->GetBackend()};
+    auto fused_xor_gate{backend.GetRegister()->EmplaceGate<proto::boolean_gmw::FusedXorGate>(
+        std::vector<WirePointer>(parents_), std::move(output_terms), std::move(output_inversions),
+        backend)};
+    return ShareWrapper(fused_xor_gate->GetOutputAsShare()).Split();
+  }
+
+  std::vector<WirePointer> parents_;
+  // the initial state is all zero, i.e., empty combinations
+  std::vector<LinearCombination> bits_ = std::vector<LinearCombination>(kKeccakStateBitSize);
+};
+
+// The state in other Boolean protocols as single wires, which are concatenated s.t. each step of a
+// round is a few gates over many wires.  The public zero of the initial state is the XOR of a wire
+// with itself.
+class WideKeccakState {
+ public:
+  void Xor(std::size_t bit, const ShareWrapper& wire) {
+    auto& absorbed{absorbed_.at(bit)};
+    absorbed = absorbed ? *absorbed ^ wire : wire;
+  }
+
+  void Invert(std::size_t bit) { inversions_.at(bit) = !inversions_.at(bit); }
+
+  void Permute() {
+    Flush();
+    for (std::size_t round = 0; round < kNumberOfRounds; ++round) Round(round);
+  }
+
+  std::vector<ShareWrapper> Squeeze(std::size_t number_of_bits) {
+    Flush();
+    std::vector<ShareWrapper> bits;
+    bits.reserve(number_of_bits);
+    for (std::size_t bit = 0; bit < number_of_bits; ++bit) bits.push_back(*bits_[bit]);
+    return bits;
+  }
+
+ private:
+  static ShareWrapper Select(const std::vector<ShareWrapper>& wires,
+                             std::span<const std::size_t> positions) {
+    std::vector<ShareWrapper> selected;
+    selected.reserve(positions.size());
+    for (const auto position : positions) selected.push_back(wires[position]);
+    return ShareWrapper::Concatenate(selected);
+  }
+
+  // the positions of the wires which the steps of a round select
+  struct Positions {
+    // the bits (x, y, z) for the parity x * 64 + z
+    std::array<std::vector<std::size_t>, 5> rows;
+    // the parities (x - 1, z) and (x + 1, z - 1) for theta's bit x * 64 + z
+    std::vector<std::size_t> left_parities, right_parities;
+    // theta's bit x * 64 + z for the bit (x, y, z)
+    std::vector<std::size_t> columns;
+    // the bit that rho and pi move onto the bit (x, y, z)
+    std::vector<std::size_t> rho_pi;
+    // the bits (x + 1, y, z) and (x + 2, y, z) for the bit (x, y, z)
+    std::vector<std::size_t> chi_1, chi_2;
+  };
+
+  static const Positions& GetPositions() {
+    static const Positions kPositions{[]() {
+      Positions positions;
+      positions.rho_pi.resize(kKeccakStateBitSize);
+      for (std::size_t x = 0; x < 5; ++x) {
+        for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+          for (std::size_t y = 0; y < 5; ++y) positions.rows[y].push_back(StateIndex(x, y, z));
+          positions.left_parities.push_back(ParityIndex(x + 4, z));
+          positions.right_parities.push_back(ParityIndex(x + 1, z + kLaneBitSize - 1));
+        }
+      }
+      for (std::size_t y = 0; y < 5; ++y) {
+        for (std::size_t x = 0; x < 5; ++x) {
+          for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+            positions.columns.push_back(ParityIndex(x, z));
+            positions.rho_pi[RhoPiIndex(x, y, z)] = StateIndex(x, y, z);
+            positions.chi_1.push_back(StateIndex(x + 1, y, z));
+            positions.chi_2.push_back(StateIndex(x + 2, y, z));
+          }
+        }
+      }
+      return positions;
+    }()};
+    return kPositions;
+  }
+
+  // applies the absorbed wires and inversions to the state
+  void Flush() {
+    std::vector<std::size_t> xor_bits, inverted_bits;
+    std::optional<ShareWrapper> reference;
+    for (std::size_t bit = 0; bit < kKeccakStateBitSize; ++bit) {
+      if (absorbed_[bit]) {
+        if (!reference) reference = absorbed_[bit];
+        if (bits_[bit]) {
+          xor_bits.push_back(bit);
+        } else {
+          bits_[bit] = std::exchange(absorbed_[bit], std::nullopt);
+        }
+      }
+      if (inversions_[bit]) inverted_bits.push_back(bit);
+    }
+    for (auto& bit : bits_) {
+      if (bit) continue;
+      if (!zero_) {
+        assert(reference);
+        zero_ = *reference ^ *reference;
+      }
+      bit = zero_;
+    }
+    const auto apply = [this](const std::vector<std::size_t>& positions, auto&& operation) {
+      if (positions.empty()) return;
+      std::vector<ShareWrapper> wires;
+      wires.reserve(positions.size());
+      for (const auto bit : positions) wires.push_back(*bits_[bit]);
+      const auto results{operation(ShareWrapper::Concatenate(wires), positions).Split()};
+      for (std::size_t i = 0; i < positions.size(); ++i) bits_[positions[i]] = results[i];
+    };
+    apply(xor_bits, [this](const ShareWrapper& state, const std::vector<std::size_t>& positions) {
+      std::vector<ShareWrapper> absorbed;
+      absorbed.reserve(positions.size());
+      for (const auto bit : positions) {
+        absorbed.push_back(*std::exchange(absorbed_[bit], std::nullopt));
+      }
+      return state ^ ShareWrapper::Concatenate(absorbed);
+    });
+    apply(inverted_bits, [](const ShareWrapper& state, const std::vector<std::size_t>&) {
+      return ~state;
+    });
+    std::fill(inversions_.begin(), inversions_.end(), false);
+  }
+
+  void Round(std::size_t round) {
+    const auto& positions{GetPositions()};
+    std::vector<ShareWrapper> wires;
+    wires.reserve(kKeccakStateBitSize);
+    for (const auto& bit : bits_) wires.push_back(*bit);
+
+    // theta
+    ShareWrapper parities{Select(wires, positions.rows[0])};
+    for (std::size_t y = 1; y < 5; ++y) parities ^= Select(wires, positions.rows[y]);
+    const auto parity_wires{parities.Split()};
+    const auto d{(Select(parity_wires, positions.left_parities) ^
+                  Select(parity_wires, positions.right_parities))
+                     .Split()};
+    const auto theta{(ShareWrapper::Concatenate(wires) ^ Select(d, positions.columns)).Split()};
+
+    // rho and pi only move wires, and chi is b ^ (~b_1 & b_2)
+    const auto b{Select(theta, positions.rho_pi).Split()};
+    auto chi{(ShareWrapper::Concatenate(b) ^
+              (~Select(b, positions.chi_1) & Select(b, positions.chi_2)))
+                 .Split()};
+
+    // iota inverts the bits of lane (0, 0) that are set in the round constant
+    std::vector<std::size_t> inverted_bits;
+    for (std::size_t z = 0; z < kLaneBitSize; ++z) {
+      if (IsSetInRoundConstant(round, z)) inverted_bits.push_back(StateIndex(0, 0, z));
+    }
+    const auto inverted{(~Select(chi, inverted_bits)).Split()};
+    for (std::size_t i = 0; i < inverted_bits.size(); ++i) chi[inverted_bits[i]] = inverted[i];
+    for (std::size_t bit = 0; bit < kKeccakStateBitSize; ++bit) bits_[bit] = chi[bit];
+  }
+
+  std::vector<std::optional<ShareWrapper>> bits_ =
+      std::vector<std::optional<ShareWrapper>>(kKeccakStateBitSize);
+  std::vector<std::optional<ShareWrapper>> absorbed_ =
+      std::vector<std::optional<ShareWrapper>>(kKeccakStateBitSize);
+  std::vector<bool> inversions_ = std::vector<bool>(kKeccakStateBitSize, false);
+  std::optional<ShareWrapper> zero_;
+};
+
+template <typename State>
+ShareWrapper Permutation(const ShareWrapper& state) {
+  const auto wires{state.Split()};
+  State keccak_state;
+  for (std::size_t bit = 0; bit < kKeccakStateBitSize; ++bit) keccak_state.Xor(bit, wires[bit]);
+  keccak_state.Permute();
+  return ShareWrapper::Concatenate(keccak_state.Squeeze(kKeccakStateBitSize));
+}
+
+template <typename State>
+ShareWrapper Sponge(const ShareWrapper& message, std::size_t rate_bit_size, std::uint8_t suffix,
+                    std::size_t number_of_suffix_bits, std::size_t output_bit_size) {
+  const auto message_wires{message.Split()};
+  // pad10*1 appends at least two bits and fills up the last block
+  const std::size_t number_of_bits{message_wires.size() + number_of_suffix_bits};
+  const std::size_t padded_bit_size{(number_of_bits + 1) / rate_bit_size * rate_bit_size +
+                                    rate_bit_size};
+  const auto is_public_one = [&](std::size_t position) {
+    if (position < number_of_bits) {
+      return ((suffix >> (position - message_wires.size())) & 1) == 1;
+    }
+    return position == number_of_bits || position + 1 == padded_bit_size;
+  };
+
+  State state;
+  for (std::size_t block = 0; block < padded_bit_size; block += rate_bit_size) {
+    for (std::size_t bit = 0; bit < rate_bit_size; ++bit) {
+      const std::size_t position{block + bit};
+      if (position < message_wires.size()) {
+        state.Xor(bit, message_wires[position]);
+      } else if (is_public_one(position)) {
+        state.Invert(bit);
+      }
+    }
+    state.Permute();
+  }
+
+  std::vector<ShareWrapper> output;
+  output.reserve(output_bit_size);
+  while (true) {
+    const auto bits{state.Squeeze(std::min(rate_bit_size, output_bit_size - output.size()))};
+    output.insert(output.end(), bits.begin(), bits.end());
+    if (output.size() == output_bit_size) break;
+    state.Permute();
+  }
+  return ShareWrapper::Concatenate(output);
+}
+
+}  // namespace
+
+ShareWrapper KeccakF1600(const ShareWrapper& state) {
+  assert(state->GetBitLength() == kKeccakStateBitSize);
+  if (state->GetProtocol() == MpcProtocol::kBooleanGmw) {
+    return Permutation<FusedKeccakState>(state);
+  }
+  return Permutation<WideKeccakState>(state);
+}
+
+ShareWrapper KeccakSponge(const ShareWrapper& message, std::size_t rate_bit_size,
+                          std::uint8_t suffix, std::size_t number_of_suffix_bits,
+                          std::size_t output_bit_size) {
+  if (!message.Get() || message->GetBitLength() == 0) {
+    throw std::invalid_argument("KeccakSponge: the message has no wires");
+  }
+  if (rate_bit_size == 0 || rate_bit_size >= kKeccakStateBitSize ||
+      rate_bit_size % kLaneBitSize != 0) {
+    throw std::invalid_argument(
+        fmt::format("KeccakSponge: invalid rate of {} bits", rate_bit_size));
+  }
+  if (number_of_suffix_bits > 8) {
+    throw std::invalid_argument(
+        fmt::format("KeccakSponge: {} instead of at most 8 suffix bits", number_of_suffix_bits));
+  }
+  if (output_bit_size == 0) throw std::invalid_argument("KeccakSponge: no output bits");
+  if (message->GetProtocol() == MpcProtocol::kBooleanGmw) {
+    return Sponge<FusedKeccakState>(message, rate_bit_size, suffix, number_of_suffix_bits,
+                                    output_bit_size);
+  }
+  return Sponge<WideKeccakState>(message, rate_bit_size, suffix, number_of_suffix_bits,
+                                 output_bit_size);
+}
+
+// the suffixes 01 of SHA-3 and 1111 of SHAKE, whose first bit is the least significant one
+ShareWrapper Sha3_256(const ShareWrapper& message) {
+  return KeccakSponge(message, kSha3_256RateBitSize, 0b10, 2, kSha3_256DigestBitSize);
+}
+
+ShareWrapper Shake128(const ShareWrapper& message, std::size_t output_bit_size) {
+  return KeccakSponge(message, kShake128RateBitSize, 0b1111, 4, output_bit_size);
+}
+
+ShareWrapper Shake256(const ShareWrapper& message, std::size_t output_bit_size) {
+  return KeccakSponge(message, kShake256RateBitSize, 0b1111, 4, output_bit_size);
+}
+
+}  // namespace encrypto::motion::algorithm
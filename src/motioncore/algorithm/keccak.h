@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+constexpr std::size_t kKeccakStateBitSize{1600};
+constexpr std::size_t kSha3_256RateBitSize{1088};
+constexpr std::size_t kSha3_256DigestBitSize{256};
+constexpr std::size_t kShake128RateBitSize{1344};
+constexpr std::size_t kShake256RateBitSize{1088};
+
+/// \brief The permutation Keccak-f[1600] of FIPS 202 on \p state with a dedicated circuit.  Each
+/// of the 1600 bits of the state is a wire, s.t. the SIMD values of the wires are independent
+/// states.  In Boolean GMW, theta, rho and pi of a round and chi's XORs and iota of the previous
+/// round are a single FusedXorGate, so a round is one such gate and one AND gate of 1600 wires,
+/// and only the 24 AND gates communicate.  Other Boolean protocols use a few XOR, INV and AND
+/// gates over all wires of the state per round.
+/// \param state 1600 wires, where wire 64 * (x + 5 * y) + z is bit z of lane (x, y), i.e., wire i
+/// is bit i % 8 of byte i / 8 of the state as a byte string of FIPS 202
+/// \returns the permuted state with the same layout as \p state
+ShareWrapper KeccakF1600(const ShareWrapper& state);
+
+/// \brief The sponge construction of FIPS 202 on Keccak-f[1600], i.e., Keccak[c] with the
+/// capacity c = 1600 - \p rate_bit_size, on \p message followed by the \p number_of_suffix_bits
+/// least significant bits of \p suffix as the domain separation and the padding pad10*1.  The
+/// padding and the all-zero initial state are public and cost no gates.
+/// \param message wires with the bit order of FIPS 202, i.e., wire i is bit i % 8 of byte i / 8
+/// \returns \p output_bit_size wires with the same layout as \p message
+/// \throws invalid_argument if \p message has no wires, the rate is not a positive multiple of 64
+/// bits below 1600 bits or there are more than 8 suffix bits
+ShareWrapper KeccakSponge(const ShareWrapper& message, std::size_t rate_bit_size,
+                          std::uint8_t suffix, std::size_t number_of_suffix_bits,
+                          std::size_t output_bit_size);
+
+/// \brief SHA3-256 of \p message, see KeccakSponge for the layout of the wires.
+ShareWrapper Sha3_256(const ShareWrapper& message);
+
+/// \brief SHAKE128 of \p message with \p output_bit_size bits of output, see KeccakSponge.
+ShareWrapper Shake128(const ShareWrapper& message, std::size_t output_bit_size);
+
+/// \brief SHAKE256 of \p message with \p output_bit_size bits of output, see KeccakSponge.
+ShareWrapper Shake256(const ShareWrapper& message, std::size_t output_bit_size);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "neural_network.h"
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "low_depth_reduce.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+void CheckLinearLayerInput(const ShareWrapper& share, std::string_view layer) {
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+      share->GetProtocol() != MpcProtocol::kAstra) {
+    throw std::invalid_argument(
+        fmt::format("{} does not support protocol {}", layer, to_string(share->GetProtocol())));
+  }
+}
+
+void CheckSameProtocol(const ShareWrapper& share, const ShareWrapper& other,
+                       std::string_view layer) {
+  if (share->GetProtocol() != other->GetProtocol() ||
+      share->GetBitLength() != other->GetBitLength()) {
+    throw std::invalid_argument(
+        fmt::format("{} needs shares of the same protocol and bit length", layer));
+  }
+}
+
+// the SIMD values of share at positions.  SubsetGate does not support ASTRA, whose values are
+// composed by a SimdifyGate of their Unsimdified values instead.
+ShareWrapper Gather(ShareWrapper share, std::span<const ShareWrapper> astra_values,
+                    std::vector<std::size_t>&& positions) {
+  if (share->GetProtocol() != MpcProtocol::kAstra) return share.Subset(std::move(positions));
+  std::vector<ShareWrapper> gathered;
+  gathered.reserve(positions.size());
+  for (const auto position : positions) gathered.emplace_back(astra_values[position]);
+  return ShareWrapper::Simdify(gathered);
+}
+
+std::vector<ShareWrapper> AstraValues(const ShareWrapper& share) {
+  if (share->GetProtocol() != MpcProtocol::kAstra) return {};
+  return ShareWrapper(share).Unsimdify();
+}
+
+template <typename T>
+ShareWrapper ConstantOf(Backend& backend, std::size_t number_of_simd, std::uint64_t value) {
+  return backend.ConstantArithmeticGmwInput<T>(std::vector<T>(number_of_simd, T(value)));
+}
+
+// the public constant value in each SIMD value of share
+ShareWrapper Constant(const ShareWrapper& share, std::uint64_t value) {
+  auto& backend{share->GetBackend()};
+  const std::size_t number_of_simd{share->GetNumberOfSimdValues()};
+  switch (share->GetBitLength()) {
+    case 8u:
+      return ConstantOf<std::uint8_t>(backend, number_of_simd, value);
+    case 16u:
+      return ConstantOf<std::uint16_t>(backend, number_of_simd, value);
+    case 32u:
+      return ConstantOf<std::uint32_t>(backend, number_of_simd, value);
+    case 64u:
+      return ConstantOf<std::uint64_t>(backend, number_of_simd, value);
+    default:
+      throw std::invalid_argument(fmt::format("Invalid bit length {}", share->GetBitLength()));
+  }
+}
+
+// the product of the row-major matrices a and b plus the bias of each column, rescaled
+ShareWrapper AffineProduct(std::vector<ShareWrapper> a, std::vector<ShareWrapper> b,
+                           std::size_t number_of_rows, const ShareWrapper& bias,
+                           std::size_t fractional_bits) {
+  const std::size_t number_of_columns{bias->GetNumberOfSimdValues()};
+  const ShareWrapper product{
+      ShareWrapper::Simdify(MatrixMultiplication(a, b, number_of_rows, number_of_columns))};
+  ShareWrapper repeated_bias{bias};
+  if (number_of_rows > 1) {
+    std::vector<std::size_t> positions(number_of_rows * number_of_columns);
+    for (std::size_t i = 0; i < positions.size(); ++i) positions[i] = i % number_of_columns;
+    repeated_bias = Gather(bias, AstraValues(bias), std::move(positions));
+  }
+  return Rescale(product + repeated_bias, fractional_bits);
+}
+
+// the values of input at each offset of the non-overlapping windows of window_size x window_size
+// positions, i.e., window_size^2 shares of (h / window_size) x (w / window_size) x c values
+std::vector<ShareWrapper> PoolingWindows(const ShareWrapper& input, const TensorShape& shape,
+                                         std::size_t window_size) {
+  if (input->GetNumberOfSimdValues() != shape.GetSize()) {
+    throw std::invalid_argument(fmt::format("Pooling of {} values of a tensor of shape {}x{}x{}",
+                                            input->GetNumberOfSimdValues(), shape.height,
+                                            shape.width, shape.channels));
+  }
+  if (window_size == 0 || window_size > shape.height || window_size > shape.width) {
+    throw std::invalid_argument(fmt::format("Pooling window of size {} for a {}x{} tensor",
+                                            window_size, shape.height, shape.width));
+  }
+  const std::size_t output_height{shape.height / window_size};
+  const std::size_t output_width{shape.width / window_size};
+  const auto astra_values{AstraValues(input)};
+  std::vector<ShareWrapper> windows;
+  windows.reserve(window_size * window_size);
+  for (std::size_t dy = 0; dy < window_size; ++dy) {
+    for (std::size_t dx = 0; dx < window_size; ++dx) {
+      std::vector<std::size_t> positions;
+      positions.reserve(output_height * output_width * shape.channels);
+      for (std::size_t y = 0; y < output_height; ++y) {
+        for (std::size_t x = 0; x < output_width; ++x) {
+          const std::size_t pixel{(y * window_size + dy) * shape.width + x * window_size + dx};
+          for (std::size_t c = 0; c < shape.channels; ++c) {
+            positions.emplace_back(pixel * shape.channels + c);
+          }
+        }
+      }
+      windows.emplace_back(Gather(input, astra_values, std::move(positions)));
+    }
+  }
+  return windows;
+}
+
+}  // namespace
+
+ShareWrapper Rescale(const ShareWrapper& input, std::size_t fractional_bits) {
+  if (fractional_bits == 0) return input;
+  return input.Truncate(fractional_bits);
+}
+
+ShareWrapper Dense(const ShareWrapper& input, const ShareWrapper& weights, const ShareWrapper& bias,
+                   std::size_t fractional_bits) {
+  CheckLinearLayerInput(input, "Dense");
+  CheckSameProtocol(input, weights, "Dense");
+  CheckSameProtocol(input, bias, "Dense");
+  const std::size_t number_of_inputs{input->GetNumberOfSimdValues()};
+  const std::size_t number_of_outputs{bias->GetNumberOfSimdValues()};
+  if (weights->GetNumberOfSimdValues() != number_of_inputs * number_of_outputs) {
+    throw std::invalid_argument(
+        fmt::format("Dense layer of {} inputs and {} outputs with {} weights", number_of_inputs,
+                    number_of_outputs, weights->GetNumberOfSimdValues()));
+  }
+  return AffineProduct(ShareWrapper(input).Unsimdify(), ShareWrapper(weights).Unsimdify(), 1,
+                       bias, fractional_bits);
+}
+
+ShareWrapper Convolution(const ShareWrapper& input, const TensorShape& input_shape,
+                         const ShareWrapper& kernels, std::size_t kernel_size,
+                         const ShareWrapper& bias, std::size_t fractional_bits,
+                         std::size_t stride) {
+  CheckLinearLayerInput(input, "Convolution");
+  CheckSameProtocol(input, kernels, "Convolution");
+  CheckSameProtocol(input, bias, "Convolution");
+  const std::size_t window_length{kernel_size * kernel_size * input_shape.channels};
+  const std::size_t number_of_kernels{bias->GetNumberOfSimdValues()};
+  if (input->GetNumberOfSimdValues() != input_shape.GetSize() ||
+      kernels->GetNumberOfSimdValues() != window_length * number_of_kernels) {
+    throw std::invalid_argument(fmt::format(
+        "Convolution of {} values of a tensor of shape {}x{}x{} with {} kernel values",
+        input->GetNumberOfSimdValues(), input_shape.height, input_shape.width,
+        input_shape.channels, kernels->GetNumberOfSimdValues()));
+  }
+  if (kernel_size == 0 || stride == 0 || kernel_size > input_shape.height ||
+      kernel_size > input_shape.width) {
+    throw std::invalid_argument(fmt::format("Convolution with {}x{} kernels for a {}x{} tensor",
+                                            kernel_size, kernel_size, input_shape.height,
+                                            input_shape.width));
+  }
+  const std::size_t output_height{(input_shape.height - kernel_size) / stride + 1};
+  const std::size_t output_width{(input_shape.width - kernel_size) / stride + 1};
+
+  // the im2col matrix, whose row of each output position holds the values of its window
+  const auto input_values{ShareWrapper(input).Unsimdify()};
+  std::vector<ShareWrapper> windows;
+  windows.reserve(output_height * output_width * window_length);
+  for (std::size_t y = 0; y < output_height; ++y) {
+    for (std::size_t x = 0; x < output_width; ++x) {
+      for (std::size_t dy = 0; dy < kernel_size; ++dy) {
+        for (std::size_t dx = 0; dx < kernel_size; ++dx) {
+          const std::size_t pixel{(y * stride + dy) * input_shape.width + x * stride + dx};
+          for (std::size_t c = 0; c < input_shape.channels; ++c) {
+            windows.emplace_back(input_values[pixel * input_shape.channels + c]);
+          }
+        }
+      }
+    }
+  }
+  return AffineProduct(std::move(windows), ShareWrapper(kernels).Unsimdify(),
+                       output_height * output_width, bias, fractional_bits);
+}
+
+ShareWrapper Relu(const ShareWrapper& input) {
+  switch (input->GetProtocol()) {
+    case MpcProtocol::kArithmeticGmw: {
+      const ShareWrapper zero{input - input};
+      return (~input.MostSignificantBit()).Mux(input, zero);
+    }
+    case MpcProtocol::kAstra: {
+      const auto bits{input.Convert<MpcProtocol::kBooleanGmw>()};
+      const auto is_not_negative{~bits.Split().back()};
+      const auto positive_bits{
+          ShareWrapper::Concatenate(std::vector<ShareWrapper>(bits->GetBitLength(),
+                                                              is_not_negative)) &
+          bits};
+      return positive_bits.Convert<MpcProtocol::kArithmeticGmw>();
+    }
+    default:
+      throw std::invalid_argument(
+          fmt::format("Relu does not support protocol {}", to_string(input->GetProtocol())));
+  }
+}
+
+ShareWrapper MaxPooling(const ShareWrapper& input, const TensorShape& shape,
+                        std::size_t window_size) {
+  if (input->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::invalid_argument(
+        fmt::format("MaxPooling does not support protocol {}", to_string(input->GetProtocol())));
+  }
+  return LowDepthReduce(PoolingWindows(input, shape, window_size),
+                        [](const ShareWrapper& a, const ShareWrapper& b) { return a.Maximum(b); });
+}
+
+ShareWrapper AveragePooling(const ShareWrapper& input, const TensorShape& shape,
+                            std::size_t window_size, std::size_t fractional_bits) {
+  CheckLinearLayerInput(input, "AveragePooling");
+  const ShareWrapper sum{LowDepthReduce(PoolingWindows(input, shape, window_size), std::plus<>())};
+  const std::uint64_t window_area{window_size * window_size};
+  // 1 / window_area with f fractional bits, rounded to the nearest value
+  const std::uint64_t reciprocal{((std::uint64_t(1) << fractional_bits) + window_area / 2) /
+                                 window_area};
+  return Rescale(sum * Constant(sum, reciprocal), fractional_bits);
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief the shape of a tensor of height x width x channels values, which are the SIMD values of
+/// a single arithmetic share in row-major order, i.e., the channels of a position are adjacent.
+/// Each layer thus evaluates a few gates on all values of the tensor instead of one per value.
+struct TensorShape {
+  std::size_t height{1};
+  std::size_t width{1};
+  std::size_t channels{1};
+
+  std::size_t GetSize() const { return height * width * channels; }
+};
+
+/// \brief divides the fixed-point values of input with 2f fractional bits by 2^f, see
+/// ShareWrapper::Truncate.  Returns input for f = 0.
+ShareWrapper Rescale(const ShareWrapper& input, std::size_t fractional_bits);
+
+/// \brief the fully connected layer input * weights + bias of the n values of input and the
+/// n x m weights in row-major order by a single MatrixMultiplicationGate, see
+/// MatrixMultiplication, followed by Rescale.
+/// \param input arithmetic GMW or ASTRA share of n SIMD values with f fractional bits
+/// \param weights share of the same protocol of n * m SIMD values with f fractional bits
+/// \param bias share of the same protocol of m SIMD values with 2f fractional bits
+/// \returns the m outputs with f fractional bits
+/// \throws std::invalid_argument if the shares do not fit
+ShareWrapper Dense(const ShareWrapper& input, const ShareWrapper& weights, const ShareWrapper& bias,
+                   std::size_t fractional_bits);
+
+/// \brief the convolution of input with o kernels of k x k x c values without padding as the
+/// product of the im2col matrix of input, whose rows are the windows of the outputs, with the
+/// kernels by a single MatrixMultiplicationGate, see Dense.  The im2col matrix repeats the wires
+/// of input, i.e., it needs no gates.
+/// \param kernels share of k * k * c * o SIMD values, i.e., a row-major (k * k * c) x o matrix,
+///        whose rows are ordered like the values of a window of input
+/// \param bias share of o SIMD values with 2f fractional bits
+/// \returns the ((h - k) / stride + 1) x ((w - k) / stride + 1) x o outputs
+/// \throws std::invalid_argument if the shares do not fit or if the kernels exceed input
+ShareWrapper Convolution(const ShareWrapper& input, const TensorShape& input_shape,
+                         const ShareWrapper& kernels, std::size_t kernel_size,
+                         const ShareWrapper& bias, std::size_t fractional_bits,
+                         std::size_t stride = 1);
+
+/// \brief max(x, 0) of the two's complement values of input.  In arithmetic GMW, the sign bits
+/// are extracted by ShareWrapper::MostSignificantBit and select the values by a single
+/// ShareWrapper::Mux.  ASTRA shares are converted to Boolean GMW, see AstraToBooleanGmwGate,
+/// whose bits are ANDed with the inverted sign bit and converted to arithmetic GMW, since there
+/// is no conversion back to ASTRA, i.e., the result is an arithmetic GMW share in both cases.
+/// \throws std::invalid_argument for other protocols
+ShareWrapper Relu(const ShareWrapper& input);
+
+/// \brief the maxima of the non-overlapping windows of window_size x window_size positions of
+/// each channel of input by a tree of ShareWrapper::Maximum on all windows at once.
+/// \param input arithmetic GMW share, e.g., the output of Relu
+/// \returns the (h / window_size) x (w / window_size) x c outputs
+/// \throws std::invalid_argument for other protocols or if the window exceeds input
+ShareWrapper MaxPooling(const ShareWrapper& input, const TensorShape& shape,
+                        std::size_t window_size);
+
+/// \brief the averages of the windows of MaxPooling as their local sums times the public
+/// fixed-point constant 2^f / window_size^2 followed by Rescale.
+/// \param input arithmetic GMW or ASTRA share with f fractional bits
+/// \throws std::invalid_argument for other protocols or if the window exceeds input
+ShareWrapper AveragePooling(const ShareWrapper& input, const TensorShape& shape,
+                            std::size_t window_size, std::size_t fractional_bits);
+
+}  // namespace encrypto::motion::algorithm
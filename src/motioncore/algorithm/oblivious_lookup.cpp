@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "oblivious_lookup.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "protocols/share.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the maximum number of index bits, s.t. the one-hot encoding of 2^k entries stays addressable
+constexpr std::size_t kMaxIndexBitLength{32};
+
+bool IsBoolean(MpcProtocol protocol) {
+  return protocol == MpcProtocol::kBooleanGmw || protocol == MpcProtocol::kBmr;
+}
+
+void CheckIndex(const ShareWrapper& index, std::size_t number_of_entries) {
+  if (!IsBoolean(index->GetProtocol())) {
+    throw std::invalid_argument(fmt::format("Oblivious lookups need Boolean indices but got {}",
+                                            to_string(index->GetProtocol())));
+  }
+  const std::size_t bit_length{index->GetBitLength()};
+  if (bit_length > kMaxIndexBitLength) {
+    throw std::invalid_argument(fmt::format(
+        "Oblivious lookups support at most {} index bits, got {}", kMaxIndexBitLength, bit_length));
+  }
+  if (number_of_entries == 0 || number_of_entries > (std::size_t(1) << bit_length)) {
+    throw std::invalid_argument(
+        fmt::format("An index of {} bits cannot address a table of {} entries", bit_length,
+                    number_of_entries));
+  }
+}
+
+// appends the positions of the block_size SIMD values of block to positions
+void AppendBlock(std::vector<std::size_t>& positions, std::size_t block, std::size_t block_size) {
+  for (std::size_t i = 0; i < block_size; ++i) positions.push_back(block * block_size + i);
+}
+
+// number_of_queries local zeros in the protocol of one_hot
+ShareWrapper ZeroBits(ShareWrapper one_hot, std::size_t number_of_queries) {
+  std::vector<std::size_t> first_entry(number_of_queries);
+  std::iota(first_entry.begin(), first_entry.end(), 0);
+  const auto bits{one_hot.Subset(first_entry)};
+  return bits ^ bits;
+}
+
+// reduces each group of blocks of block_size consecutive SIMD values of input by operation, which
+// combines the i-th values of the blocks of a group, and returns one block per group in the order
+// of groups.  All groups are reduced together, s.t. this takes as many SIMD gates as
+// LowDepthReduceSimd for the largest group.  The groups must not be empty.
+template <typename BinaryOperation>
+ShareWrapper ReduceGroups(ShareWrapper input, std::size_t block_size,
+                          std::vector<std::vector<std::size_t>> groups,
+                          BinaryOperation operation) {
+  const auto has_pairs{[](const auto& group) { return group.size() > 1; }};
+  while (std::any_of(groups.begin(), groups.end(), has_pairs)) {
+    // the pairs of all groups are combined first, their unpaired blocks are appended
+    std::vector<std::size_t> even, odd, unpaired;
+    std::vector<std::vector<std::size_t>> reduced(groups.size());
+    for (std::size_t group = 0; group < groups.size(); ++group) {
+      for (std::size_t i = 0; i + 1 < groups[group].size(); i += 2) {
+        reduced[group].push_back(even.size() / block_size);
+        AppendBlock(even, groups[group][i], block_size);
+        AppendBlock(odd, groups[group][i + 1], block_size);
+      }
+    }
+    const std::size_t number_of_pairs{even.size() / block_size};
+    for (std::size_t group = 0; group < groups.size(); ++group) {
+      if (groups[group].size() % 2 == 1) {
+        reduced[group].push_back(number_of_pairs + unpaired.size() / block_size);
+        AppendBlock(unpaired, groups[group].back(), block_size);
+      }
+    }
+    ShareWrapper combined{operation(input.Subset(even), input.Subset(odd))};
+    if (!unpaired.empty()) {
+      combined = ShareWrapper::Simdify(std::vector{combined, input.Subset(unpaired)});
+    }
+    input = std::move(combined);
+    groups = std::move(reduced);
+  }
+  std::vector<std::size_t> positions;
+  positions.reserve(groups.size() * block_size);
+  for (const auto& group : groups) AppendBlock(positions, group.front(), block_size);
+  return input.Subset(positions);
+}
+
+// the one-hot encoding of the number_of_queries values of bits, see OneHotIndex, expanded from
+// the most to the least significant bit.  number_of_entries must be at most 2^bits.size().
+ShareWrapper ExpandOneHot(std::span<const ShareWrapper> bits, std::size_t number_of_entries,
+                          std::size_t number_of_queries) {
+  // after bit j, one_hot holds the blocks of the prefixes p = index >> j that are < ceil(n / 2^j)
+  ShareWrapper one_hot;
+  for (std::size_t j = bits.size(); j-- > 0;) {
+    // the q SIMD values of the negated bit followed by the q SIMD values of the bit
+    ShareWrapper selection{ShareWrapper::Simdify(std::vector{~bits[j], bits[j]})};
+    const std::size_t number_of_prefixes{(number_of_entries + (std::size_t(1) << j) - 1) >> j};
+    std::vector<std::size_t> previous_positions, selection_positions;
+    previous_positions.reserve(number_of_prefixes * number_of_queries);
+    selection_positions.reserve(number_of_prefixes * number_of_queries);
+    for (std::size_t prefix = 0; prefix < number_of_prefixes; ++prefix) {
+      for (std::size_t query = 0; query < number_of_queries; ++query) {
+        previous_positions.push_back((prefix >> 1) * number_of_queries + query);
+        selection_positions.push_back((prefix & 1) * number_of_queries + query);
+      }
+    }
+    if (j + 1 == bits.size()) {
+      // the most significant bit needs no AND
+      one_hot = number_of_prefixes == 2 ? selection : selection.Subset(selection_positions);
+    } else {
+      one_hot = one_hot.Subset(previous_positions) & selection.Subset(selection_positions);
+    }
+  }
+  return one_hot;
+}
+
+// the square-root decomposition of the indices into rows of width = 2^k_l entries, where the k_l
+// least significant bits select the column and the other bits the row.  k_l is half the bits
+// needed for the entries, s.t. both one-hot encodings have about sqrt(n) q bits and are expanded
+// in parallel.  An index with k_l = k has no row bits and therefore no row encoding.
+struct SquareRootIndex {
+  ShareWrapper columns;
+  std::optional<ShareWrapper> rows;
+  std::size_t width;
+  std::size_t number_of_rows;
+};
+
+SquareRootIndex DecomposeIndex(const ShareWrapper& index, std::size_t number_of_entries) {
+  const std::size_t number_of_queries{index->GetNumberOfSimdValues()};
+  const auto bits{index.Split()};
+  const std::size_t needed_bit_length{
+      static_cast<std::size_t>(std::bit_width(number_of_entries - 1))};
+  const std::size_t column_bit_length{
+      std::min(bits.size(), std::max<std::size_t>(1, needed_bit_length / 2))};
+  SquareRootIndex result;
+  result.width = std::size_t(1) << column_bit_length;
+  result.number_of_rows = (number_of_entries + result.width - 1) / result.width;
+  const std::span<const ShareWrapper> all_bits(bits);
+  result.columns = ExpandOneHot(all_bits.first(column_bit_length),
+                                std::min(number_of_entries, result.width), number_of_queries);
+  if (column_bit_length < bits.size()) {
+    result.rows = ExpandOneHot(all_bits.subspan(column_bit_length), result.number_of_rows,
+                               number_of_queries);
+  }
+  return result;
+}
+
+// reads a secret-shared table, whose entries are summed up by operation, i.e., XOR or addition.
+// Each row of entries is first reduced to the entry in the column of the query, after which the
+// row of the query is selected from these number_of_rows entries.
+template <typename BinaryOperation>
+ShareWrapper LookupSecretTable(const ShareWrapper& table, const ShareWrapper& index,
+                               BinaryOperation operation) {
+  const std::size_t number_of_entries{table->GetNumberOfSimdValues()};
+  const std::size_t number_of_queries{index->GetNumberOfSimdValues()};
+  auto [columns, rows, width, number_of_rows]{DecomposeIndex(index, number_of_entries)};
+  const auto mux{[](const ShareWrapper& selection, const ShareWrapper& entries) {
+    if constexpr (std::is_same_v<BinaryOperation, std::plus<>>) {
+      return selection.Mux(entries, entries - entries);
+    } else {
+      return selection.Mux(entries, entries ^ entries);
+    }
+  }};
+
+  // entry h * width + l at the positions of column l, grouped by row h
+  std::vector<std::size_t> column_positions, entry_positions;
+  column_positions.reserve(number_of_entries * number_of_queries);
+  entry_positions.reserve(number_of_entries * number_of_queries);
+  std::vector<std::vector<std::size_t>> row_groups(number_of_rows);
+  for (std::size_t row = 0; row < number_of_rows; ++row) {
+    for (std::size_t column = 0; column < std::min(width, number_of_entries - row * width);
+         ++column) {
+      row_groups[row].push_back(column_positions.size() / number_of_queries);
+      AppendBlock(column_positions, column, number_of_queries);
+      entry_positions.insert(entry_positions.end(), number_of_queries, row * width + column);
+    }
+  }
+  ShareWrapper entries{table};
+  entries = entries.Subset(entry_positions);
+  ShareWrapper row_entries{ReduceGroups(mux(columns.Subset(column_positions), entries),
+                                        number_of_queries, std::move(row_groups), operation)};
+  if (!rows) return row_entries;
+
+  // row h at the positions h * q, ..., h * q + q - 1 of both rows and row_entries
+  std::vector<std::vector<std::size_t>> all_rows(1, std::vector<std::size_t>(number_of_rows));
+  std::iota(all_rows.front().begin(), all_rows.front().end(), 0);
+  return ReduceGroups(mux(*rows, row_entries), number_of_queries, std::move(all_rows), operation);
+}
+
+}  // namespace
+
+ShareWrapper OneHotIndex(const ShareWrapper& index, std::size_t number_of_entries) {
+  CheckIndex(index, number_of_entries);
+  const std::size_t number_of_queries{index->GetNumberOfSimdValues()};
+  auto [columns, rows, width, number_of_rows]{DecomposeIndex(index, number_of_entries)};
+  if (!rows) return columns;
+  std::vector<std::size_t> row_positions, column_positions;
+  row_positions.reserve(number_of_entries * number_of_queries);
+  column_positions.reserve(number_of_entries * number_of_queries);
+  for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+    AppendBlock(row_positions, entry / width, number_of_queries);
+    AppendBlock(column_positions, entry % width, number_of_queries);
+  }
+  return rows->Subset(row_positions) & columns.Subset(column_positions);
+}
+
+ShareWrapper ObliviousLookup(const ShareWrapper& table, const ShareWrapper& index) {
+  const MpcProtocol protocol{table->GetProtocol()};
+  if (protocol != index->GetProtocol() && protocol != MpcProtocol::kArithmeticGmw) {
+    throw std::invalid_argument(
+        fmt::format("Oblivious lookups need tables in the protocol of the index or arithmetic "
+                    "GMW but got {}",
+                    to_string(protocol)));
+  }
+  CheckIndex(index, table->GetNumberOfSimdValues());
+  if (protocol == MpcProtocol::kArithmeticGmw) {
+    return LookupSecretTable(table, index, std::plus<>());
+  }
+  return LookupSecretTable(table, index, std::bit_xor<>());
+}
+
+ShareWrapper ObliviousLookup(std::span<const BitVector<>> table, const ShareWrapper& index) {
+  if (table.empty() || table.front().GetSize() == 0) {
+    throw std::invalid_argument("Oblivious lookups need a table of non-empty entries");
+  }
+  const std::size_t bit_length{table.front().GetSize()};
+  for (const auto& entry : table) {
+    if (entry.GetSize() != bit_length) {
+      throw std::invalid_argument(
+          fmt::format("The entries of a public table need {} bits, got {}", bit_length,
+                      entry.GetSize()));
+    }
+  }
+  CheckIndex(index, table.size());
+  const std::size_t number_of_queries{index->GetNumberOfSimdValues()};
+  auto [columns, rows, width, number_of_rows]{DecomposeIndex(index, table.size())};
+
+  // bit i of row h is the XOR of the column bits of the entries of row h whose bit i is set, which
+  // needs no communication, the terms of wire i are these bits ANDed with the row bits
+  std::vector<std::size_t> column_positions, term_rows;
+  std::vector<std::vector<std::size_t>> row_groups;
+  std::vector<std::vector<std::size_t>> wire_groups(bit_length);
+  for (std::size_t i = 0; i < bit_length; ++i) {
+    for (std::size_t row = 0; row < number_of_rows; ++row) {
+      std::vector<std::size_t> group;
+      for (std::size_t entry = row * width; entry < std::min(table.size(), (row + 1) * width);
+           ++entry) {
+        if (!table[entry].Get(i)) continue;
+        group.push_back(column_positions.size() / number_of_queries);
+        AppendBlock(column_positions, entry - row * width, number_of_queries);
+      }
+      if (group.empty()) continue;
+      wire_groups[i].push_back(row_groups.size());
+      row_groups.push_back(std::move(group));
+      term_rows.push_back(row);
+    }
+  }
+
+  if (row_groups.empty()) {
+    // no entry has a bit set, so all wires are local zeros
+    return ShareWrapper::Concatenate(
+        std::vector(bit_length, ZeroBits(columns, number_of_queries)));
+  }
+  ShareWrapper terms{ReduceGroups(columns.Subset(column_positions), number_of_queries,
+                                  std::move(row_groups), std::bit_xor<>())};
+  if (rows) {
+    std::vector<std::size_t> row_positions;
+    row_positions.reserve(term_rows.size() * number_of_queries);
+    for (const auto row : term_rows) AppendBlock(row_positions, row, number_of_queries);
+    terms = rows->Subset(row_positions) & terms;
+  }
+
+  std::vector<std::vector<std::size_t>> nonempty_wire_groups;
+  for (const auto& group : wire_groups) {
+    if (!group.empty()) nonempty_wire_groups.push_back(group);
+  }
+  ShareWrapper bits{
+      ReduceGroups(terms, number_of_queries, std::move(nonempty_wire_groups), std::bit_xor<>())};
+  std::vector<ShareWrapper> wires;
+  wires.reserve(bit_length);
+  for (std::size_t i = 0, nonempty = 0; i < bit_length; ++i) {
+    if (wire_groups[i].empty()) {
+      // no entry has bit i set, so the wire is a local zero
+      wires.push_back(ZeroBits(columns, number_of_queries));
+    } else {
+      std::vector<std::size_t> positions;
+      AppendBlock(positions, nonempty++, number_of_queries);
+      wires.push_back(bits.Subset(positions));
+    }
+  }
+  return ShareWrapper::Concatenate(wires);
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <span>
+
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief the one-hot encoding of the secret indices, i.e., a share of 1 wire with one SIMD value
+/// per pair of entry and query at position entry * q + query for the q SIMD values of index, which
+/// is 1 iff the query has the index of the entry.  The index is decomposed into a row and a column
+/// of about sqrt(n) entries each, whose one-hot encodings are expanded in parallel from the most to
+/// the least significant bit, where each level ANDs every prefix of the previous one with the bit
+/// and its negation in one SIMD gate.  The bit of an entry is the AND of the bits of its row and
+/// column, s.t. the k bits of the index take about k / 2 rounds and n q + O(sqrt(n) q) ANDs
+/// instead of the n q (k - 1) of comparing the index with each entry.  Prefixes of entries
+/// >= number_of_entries are not expanded.
+/// \param index Boolean GMW or BMR share of the k bits of the indices, least significant bit first
+/// \throws std::invalid_argument if index is not Boolean, number_of_entries is 0 or greater than
+///         2^k or k is greater than 32
+ShareWrapper OneHotIndex(const ShareWrapper& index, std::size_t number_of_entries);
+
+/// \brief reads the entries of the secret-shared table at the secret indices, i.e., the
+/// data-oblivious array access table[index] for each SIMD value of index.  The table is split into
+/// rows of about sqrt(n) entries, see OneHotIndex.  Each entry is selected by the column encoding
+/// of the query with ShareWrapper::Mux and each row is reduced to one entry by a tree of XORs or
+/// additions, which need no communication.  The row encoding then selects one of these sqrt(n)
+/// entries in the same way.  An arithmetic GMW table thus needs n + sqrt(n) multiplications of a
+/// selection bit per query and no one-hot encoding of all n entries.  Indices of at least the
+/// number of entries read 0.
+/// \param table share of one entry per SIMD value in the protocol of index or arithmetic GMW
+/// \param index see OneHotIndex, one query per SIMD value
+/// \returns share of the entries of table with one SIMD value per query
+/// \throws std::invalid_argument if the protocols do not fit, see also OneHotIndex
+ShareWrapper ObliviousLookup(const ShareWrapper& table, const ShareWrapper& index);
+
+/// \brief reads the entries of a public table at the secret indices, see ObliviousLookup.  Since
+/// the entries are public, bit i of the entry in the column of the query is the XOR of the column
+/// bits of the entries of its row whose bit i is set, which is then ANDed with the row bit.  This
+/// costs the O(sqrt(n) q) ANDs of the row and column encodings and sqrt(n) q l ANDs for the rows.
+/// \param table the entries, which all have the same bit length l
+/// \returns Boolean share of l wires in the protocol of index with one SIMD value per query
+/// \throws std::invalid_argument if the entries are empty or differ in their bit lengths, see also
+///         OneHotIndex
+ShareWrapper ObliviousLookup(std::span<const BitVector<>> table, const ShareWrapper& index);
+
+}  // namespace encrypto::motion::algorithm
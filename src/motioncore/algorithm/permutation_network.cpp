@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "permutation_network.h"
+
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "utility/helpers.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+constexpr std::size_t kUncolored{std::numeric_limits<std::size_t>::max()};
+
+// routes permutation through the subnetwork on positions, whose first and last layers are
+// layers[depth] and layers[layers.size() - 1 - depth]
+void Route(std::span<const std::size_t> positions, std::span<const std::size_t> permutation,
+           std::size_t depth, std::vector<PermutationNetworkLayer>& layers) {
+  const std::size_t size{positions.size()};
+  if (size == 2) {
+    auto& layer{layers[depth]};
+    layer.first.emplace_back(positions[0]);
+    layer.second.emplace_back(positions[1]);
+    layer.swaps.emplace_back(permutation[0] == 1);
+    return;
+  }
+
+  std::vector<std::size_t> inverse(size);
+  for (std::size_t i = 0; i < size; ++i) inverse[permutation[i]] = i;
+
+  // colors the inputs with the upper (0) and the lower (1) subnetwork, s.t. the two inputs of a
+  // switch of the first layer and the two outputs of a switch of the last layer differ in color
+  std::vector<std::size_t> color(size, kUncolored);
+  for (std::size_t start = 0; start < size; start += 2) {
+    if (color[start] != kUncolored) continue;
+    color[start] = 0;
+    color[start ^ 1] = 1;
+    for (std::size_t x = start;;) {
+      // the input sharing the output switch with x
+      const std::size_t y{inverse[permutation[x] ^ 1]};
+      if (color[y] != kUncolored) break;
+      color[y] = 1 - color[x];
+      color[y ^ 1] = color[x];
+      x = y ^ 1;
+    }
+  }
+
+  const std::size_t half{size / 2};
+  std::vector<std::size_t> upper_positions(half), lower_positions(half);
+  std::vector<std::size_t> upper_permutation(half), lower_permutation(half);
+  std::vector<bool> last_swaps(half);
+  auto& first_layer{layers[depth]};
+  for (std::size_t i = 0; i < half; ++i) {
+    const bool swap{color[2 * i] == 1};
+    const std::size_t upper_input{swap ? 2 * i + 1 : 2 * i};
+    const std::size_t lower_input{swap ? 2 * i : 2 * i + 1};
+    first_layer.first.emplace_back(positions[2 * i]);
+    first_layer.second.emplace_back(positions[2 * i + 1]);
+    first_layer.swaps.emplace_back(swap);
+    upper_positions[i] = positions[2 * i];
+    lower_positions[i] = positions[2 * i + 1];
+    upper_permutation[i] = permutation[upper_input] / 2;
+    lower_permutation[i] = permutation[lower_input] / 2;
+    // the upper output of the last layer's switch goes to its second position if it is odd
+    last_swaps[permutation[upper_input] / 2] = permutation[upper_input] % 2 == 1;
+  }
+
+  Route(upper_positions, upper_permutation, depth + 1, layers);
+  Route(lower_positions, lower_permutation, depth + 1, layers);
+
+  auto& last_layer{layers[layers.size() - 1 - depth]};
+  for (std::size_t i = 0; i < half; ++i) {
+    last_layer.first.emplace_back(positions[2 * i]);
+    last_layer.second.emplace_back(positions[2 * i + 1]);
+    last_layer.swaps.emplace_back(last_swaps[i]);
+  }
+}
+
+}  // namespace
+
+std::vector<PermutationNetworkLayer> RoutePermutationNetwork(
+    std::span<const std::size_t> permutation) {
+  const std::size_t size{permutation.size()};
+  if (size < 2 || !std::has_single_bit(size)) {
+    throw std::invalid_argument(
+        fmt::format("Permutation networks need a power of 2 values but got {}", size));
+  }
+  std::vector<bool> is_image(size, false);
+  for (const auto target : permutation) {
+    if (target >= size || is_image[target]) {
+      throw std::invalid_argument(fmt::format("Invalid position {} in the permutation", target));
+    }
+    is_image[target] = true;
+  }
+
+  std::vector<PermutationNetworkLayer> layers(2 * std::bit_width(size) - 3);
+  std::vector<std::size_t> positions(size);
+  for (std::size_t i = 0; i < size; ++i) positions[i] = i;
+  Route(positions, permutation, 0, layers);
+  return layers;
+}
+
+std::vector<std::size_t> RandomPermutation(std::size_t size) {
+  std::vector<std::size_t> permutation(size);
+  for (std::size_t i = 0; i < size; ++i) permutation[i] = i;
+  // Fisher-Yates, the bias of the modular reduction of 64-bit values is negligible
+  const auto randomness{RandomVector<std::uint64_t>(size)};
+  for (std::size_t i = size; i-- > 1;) {
+    std::swap(permutation[i], permutation[randomness[i] % (i + 1)]);
+  }
+  return permutation;
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,53 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace encrypto::motion::algorithm {
+
+/// \brief A layer of switches of a permutation network.  Switch i exchanges the values at the
+///        positions first[i] and second[i] if swaps[i] is set, where all switches of a layer are
+///        on distinct positions.
+struct PermutationNetworkLayer {
+  std::vector<std::size_t> first;
+  std::vector<std::size_t> second;
+  std::vector<bool> swaps;
+};
+
+/// \brief Routes \p permutation through a Benes network, which moves the value at position i to
+///        position permutation[i].  The network on n = 2^k values has 2k - 1 layers of n / 2
+///        switches, whose positions only depend on n.
+/// \throws std::invalid_argument if the size of \p permutation is not a power of 2 or if
+///         \p permutation is not a permutation
+std::vector<PermutationNetworkLayer> RoutePermutationNetwork(
+    std::span<const std::size_t> permutation);
+
+/// \brief Samples a uniformly random permutation of \p size values with the default RNG.
+std::vector<std::size_t> RandomPermutation(std::size_t size);
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,573 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "protocol_assignment.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "base/party.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
+#include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "secure_type/secure_unsigned_integer.h"
+#include "utility/bit_vector.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+constexpr auto kArithmeticGmw{MpcProtocol::kArithmeticGmw};
+constexpr auto kBooleanGmw{MpcProtocol::kBooleanGmw};
+constexpr auto kBmr{MpcProtocol::kBmr};
+constexpr auto kGarbledCircuit{MpcProtocol::kGarbledCircuit};
+
+constexpr double kInfinity{std::numeric_limits<double>::infinity()};
+
+// computation of the default cost model, measured like the ones of SelectGarbledCircuitScheme
+// one random OT of the OT extension, e.g., for an MT or an SB
+constexpr double kTimePerOt{20e-9};
+// garbling or evaluating an AND gate with AES-NI
+constexpr double kThreeHalvesTimePerAndGate{40e-9};
+constexpr double kHalfGatesTimePerAndGate{20e-9};
+// computing a BMR AND gate for one party's keys
+constexpr double kBmrTimePerAndGatePerParty{40e-9};
+
+ProtocolCost operator+(const ProtocolCost& a, const ProtocolCost& b) {
+  return {a.rounds + b.rounds, a.bits + b.bits, a.time + b.time};
+}
+
+double Log2(std::size_t bit_length) {
+  return std::ceil(std::log2(static_cast<double>(bit_length)));
+}
+
+}  // namespace
+
+MixedValue MixedValue::operator+(const MixedValue& other) const {
+  return circuit_->Add(MixedOperation::kAdd, {node_, other.node_});
+}
+
+MixedValue MixedValue::operator-(const MixedValue& other) const {
+  return circuit_->Add(MixedOperation::kSub, {node_, other.node_});
+}
+
+MixedValue MixedValue::operator*(const MixedValue& other) const {
+  return circuit_->Add(MixedOperation::kMul, {node_, other.node_});
+}
+
+MixedValue MixedValue::operator>(const MixedValue& other) const {
+  return circuit_->Add(MixedOperation::kGreaterThan, {node_, other.node_});
+}
+
+MixedValue MixedValue::operator==(const MixedValue& other) const {
+  return circuit_->Add(MixedOperation::kEqual, {node_, other.node_});
+}
+
+MixedValue MixedValue::Mux(const MixedValue& a, const MixedValue& b) const {
+  return circuit_->Add(MixedOperation::kMux, {node_, a.node_, b.node_});
+}
+
+MixedCircuit::MixedCircuit(std::size_t bit_length, std::size_t number_of_simd)
+    : bit_length_(bit_length), number_of_simd_(number_of_simd) {
+  if (bit_length != 8 && bit_length != 16 && bit_length != 32 && bit_length != 64) {
+    throw std::invalid_argument(fmt::format("Invalid bit length {}", bit_length));
+  }
+}
+
+MixedValue MixedCircuit::Input(std::size_t input_owner) {
+  nodes_.push_back({MixedOperation::kInput, {}, input_owner});
+  ++number_of_inputs_;
+  return MixedValue(*this, nodes_.size() - 1);
+}
+
+MixedValue MixedCircuit::Add(MixedOperation operation, std::vector<std::size_t> parents) {
+  for (const auto parent : parents) {
+    if (parent >= nodes_.size()) {
+      throw std::invalid_argument(fmt::format("Parent node {} does not exist", parent));
+    }
+  }
+  const bool is_mux{operation == MixedOperation::kMux};
+  if (operation == MixedOperation::kInput || operation >= MixedOperation::kInvalid ||
+      parents.size() != (is_mux ? 3 : 2)) {
+    throw std::invalid_argument(fmt::format("Invalid operation {} on {} parents",
+                                            static_cast<unsigned>(operation), parents.size()));
+  }
+  // the selection bit of kMux has bit length 1, all other parents the bit length of the circuit
+  for (std::size_t i = 0; i < parents.size(); ++i) {
+    const std::size_t expected_bit_length{is_mux && i == 0 ? 1 : bit_length_};
+    if (GetBitLength(parents[i]) != expected_bit_length) {
+      throw std::invalid_argument(fmt::format("Parent node {} has bit length {} but expected {}",
+                                              parents[i], GetBitLength(parents[i]),
+                                              expected_bit_length));
+    }
+  }
+  nodes_.push_back({operation, std::move(parents)});
+  return MixedValue(*this, nodes_.size() - 1);
+}
+
+std::size_t MixedCircuit::GetBitLength(std::size_t node) const {
+  const auto operation{nodes_.at(node).operation};
+  return operation == MixedOperation::kGreaterThan || operation == MixedOperation::kEqual
+             ? 1
+             : bit_length_;
+}
+
+ProtocolCostModel::ProtocolCostModel(std::size_t number_of_parties,
+                                     std::chrono::microseconds round_trip_time,
+                                     double network_bandwidth)
+    : number_of_parties_(number_of_parties),
+      round_trip_time_(round_trip_time),
+      round_trip_seconds_(std::chrono::duration<double>(round_trip_time).count()),
+      network_bandwidth_(network_bandwidth),
+      protocols_{kArithmeticGmw, kBooleanGmw, kBmr} {
+  if (number_of_parties < 2) {
+    throw std::invalid_argument(
+        fmt::format("Needs at least 2 parties but got {}", number_of_parties));
+  }
+  if (number_of_parties == 2) protocols_.push_back(kGarbledCircuit);
+}
+
+std::optional<ProtocolCost> ProtocolCostModel::GetOperationCost(MixedOperation operation,
+                                                                MpcProtocol protocol,
+                                                                std::size_t bit_length) const {
+  if (auto iterator{operation_costs_.find({operation, protocol, bit_length})};
+      iterator != operation_costs_.end()) {
+    return iterator->second;
+  }
+  return GetDefaultOperationCost(operation, protocol, bit_length);
+}
+
+std::optional<ProtocolCost> ProtocolCostModel::GetConversionCost(MpcProtocol from, MpcProtocol to,
+                                                                 std::size_t bit_length) const {
+  if (from == to) return ProtocolCost{};
+  // arithmetic shares have at least 8 bits
+  if (bit_length == 1 && (from == kArithmeticGmw || to == kArithmeticGmw)) return std::nullopt;
+  if (auto iterator{conversion_costs_.find({from, to, bit_length})};
+      iterator != conversion_costs_.end()) {
+    return iterator->second;
+  }
+  return GetDefaultConversionCost(from, to, bit_length);
+}
+
+double ProtocolCostModel::EstimateTime(const ProtocolCost& cost, std::size_t number_of_simd) const {
+  double time{cost.rounds * round_trip_seconds_ + number_of_simd * cost.time};
+  if (network_bandwidth_ > 0) time += number_of_simd * cost.bits / network_bandwidth_;
+  return time;
+}
+
+ProtocolCost ProtocolCostModel::GetBooleanCircuitCost(MpcProtocol protocol,
+                                                      double number_of_and_gates,
+                                                      double and_depth) const {
+  const double n{static_cast<double>(number_of_parties_)};
+  switch (protocol) {
+    case kBooleanGmw:
+      // the parties open 2 bits per AND gate and generate its MT with 2 random OTs
+      return {and_depth, number_of_and_gates * (2 + 2 * kKappa),
+              number_of_and_gates * 2 * kTimePerOt};
+    case kGarbledCircuit: {
+      // constant rounds, the garbler sends the garbled tables in the setup phase
+      const auto scheme{proto::garbled_circuit::SelectGarbledCircuitScheme(network_bandwidth_)};
+      const double bits{static_cast<double>(
+          proto::garbled_circuit::Provider::GetGarbledTableBitSize(scheme) +
+          proto::garbled_circuit::Provider::GetGarbledControlBitsBitSize(scheme))};
+      const double time{scheme == GarbledCircuitScheme::kHalfGates ? kHalfGatesTimePerAndGate
+                                                                   : kThreeHalvesTimePerAndGate};
+      return {0, number_of_and_gates * bits, number_of_and_gates * time};
+    }
+    case kBmr:
+      // constant rounds, each party sends its keys of the 4 rows of the jointly garbled table and
+      // the products of the permutation bits with its keys
+      return {0, number_of_and_gates * 6 * n * kKappa,
+              number_of_and_gates * n * kBmrTimePerAndGatePerParty};
+    default:
+      throw std::invalid_argument(
+          fmt::format("Protocol {} has no Boolean circuits", to_string(protocol)));
+  }
+}
+
+std::optional<ProtocolCost> ProtocolCostModel::GetDefaultOperationCost(
+    MixedOperation operation, MpcProtocol protocol, std::size_t bit_length) const {
+  const double l{static_cast<double>(bit_length)};
+  const double log_l{Log2(bit_length)};
+  const double n{static_cast<double>(number_of_parties_)};
+  // GMW uses the depth-optimized circuits, BMR and garbled circuits the size-optimized ones, see
+  // SecureUnsignedInteger
+  const bool depth_optimized{protocol == kBooleanGmw};
+  switch (operation) {
+    case MixedOperation::kInput: {
+      if (protocol == kArithmeticGmw || protocol == kBooleanGmw)
+        return ProtocolCost{1, l * (n - 1)};
+      if (protocol == kBmr) return ProtocolCost{2, l * (n - 1) * (1 + kKappa)};
+      // the evaluator's inputs need OTs, the garbler's labels only a message
+      return ProtocolCost{2, l * 3 * kKappa, l * kTimePerOt};
+    }
+    case MixedOperation::kAdd:
+    case MixedOperation::kSub: {
+      if (protocol == kArithmeticGmw) return ProtocolCost{};
+      if (depth_optimized) return GetBooleanCircuitCost(protocol, l * log_l / 2 + l, log_l + 1);
+      return GetBooleanCircuitCost(protocol, l - 1, l - 1);
+    }
+    case MixedOperation::kMul: {
+      if (protocol == kArithmeticGmw) {
+        // the parties open d and e, the MT is generated by l OTs of l-bit messages
+        return ProtocolCost{1, 2 * l + l * (kKappa + l), l * kTimePerOt};
+      }
+      if (depth_optimized) return GetBooleanCircuitCost(protocol, 2 * l * l, 3 * log_l);
+      return GetBooleanCircuitCost(protocol, 2 * l * l - l, 2 * l);
+    }
+    case MixedOperation::kGreaterThan:
+    case MixedOperation::kEqual: {
+      const bool is_equal{operation == MixedOperation::kEqual};
+      if (protocol == kArithmeticGmw) {
+        if (!arithmetic_comparisons_ || number_of_parties_ != 2) return std::nullopt;
+        // the chain of 1ooN-OTs of MostSignificantBitExtraction, where the first OT compares l_s
+        // bits and the others l_s - 1 bits each, equality extracts the differences both ways
+        const double l_s{static_cast<double>(SelectGreaterThanChunkBitLength(
+            bit_length, 1, round_trip_time_, network_bandwidth_))};
+        const double number_of_ots{1 + std::ceil(std::max(0.0, l - 1 - l_s) / (l_s - 1))};
+        const double number_of_messages{number_of_ots * std::exp2(l_s) * (is_equal ? 2 : 1)};
+        return ProtocolCost{number_of_ots, number_of_messages + number_of_ots * (8 + 2 * kKappa),
+                            number_of_ots * 5 * kTimePerOt};
+      }
+      if (is_equal) return GetBooleanCircuitCost(protocol, l - 1, log_l);
+      if (depth_optimized) return GetBooleanCircuitCost(protocol, 3 * l, log_l + 1);
+      return GetBooleanCircuitCost(protocol, l, l);
+    }
+    case MixedOperation::kMux: {
+      if (protocol == kArithmeticGmw) return std::nullopt;
+      return GetBooleanCircuitCost(protocol, l, 1);
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<ProtocolCost> ProtocolCostModel::GetDefaultConversionCost(
+    MpcProtocol from, MpcProtocol to, std::size_t bit_length) const {
+  const double l{static_cast<double>(bit_length)};
+  const double log_l{Log2(bit_length)};
+  const double n{static_cast<double>(number_of_parties_)};
+  // the evaluator obtains the labels of its bits by OTs and the garbler sends its labels
+  const ProtocolCost garbled_circuit_inputs{2, l * 4 * kKappa, l * kTimePerOt};
+  // the parties publish their masked bits and the keys of the public values
+  const ProtocolCost bmr_inputs{2, l * (n - 1) * (1 + kKappa)};
+  // l SBs of l bits, each generated by an OT
+  const ProtocolCost shared_bits{0, l * (kKappa + l), l * kTimePerOt};
+
+  if (from == kArithmeticGmw && to == kBooleanGmw) {
+    // open x - r, then the prefix circuit of the carries, see ArithmeticGmwToBooleanGmwGate
+    return ProtocolCost{1, l} + shared_bits +
+           GetBooleanCircuitCost(kBooleanGmw, 2 * l * log_l, log_l);
+  }
+  if (from == kBooleanGmw && to == kArithmeticGmw) {
+    // open the bits masked by the SBs, see GmwToArithmeticGate
+    return ProtocolCost{1, l} + shared_bits;
+  }
+  if (from == kArithmeticGmw && to == kGarbledCircuit) {
+    return garbled_circuit_inputs + GetBooleanCircuitCost(kGarbledCircuit, l - 1, 0);
+  }
+  if (from == kGarbledCircuit && to == kArithmeticGmw) {
+    // the garbler inputs the mask and the masked value is revealed to the evaluator
+    return ProtocolCost{1, l * (kKappa + 1)} + GetBooleanCircuitCost(kGarbledCircuit, l - 1, 0);
+  }
+  if (from == kBooleanGmw && to == kGarbledCircuit) return garbled_circuit_inputs;
+  if (from == kArithmeticGmw && to == kBmr) {
+    // each party inputs its share, which are summed up by n - 1 additions
+    return ProtocolCost{bmr_inputs.rounds, n * bmr_inputs.bits} +
+           GetBooleanCircuitCost(kBmr, (n - 1) * (l - 1), 0);
+  }
+  if (from == kBooleanGmw && to == kBmr) return bmr_inputs;
+  // the permutation bits of BMR and garbled circuits are XOR shares
+  if (to == kBooleanGmw && (from == kBmr || from == kGarbledCircuit)) return ProtocolCost{};
+
+  // all other conversions go over Boolean GMW, see ShareWrapper::Convert
+  if (from != kBooleanGmw && to != kBooleanGmw) {
+    const auto to_boolean_gmw{GetConversionCost(from, kBooleanGmw, bit_length)};
+    const auto from_boolean_gmw{GetConversionCost(kBooleanGmw, to, bit_length)};
+    if (to_boolean_gmw && from_boolean_gmw) return *to_boolean_gmw + *from_boolean_gmw;
+  }
+  return std::nullopt;
+}
+
+MpcProtocol GetResultProtocol(MixedOperation operation, MpcProtocol protocol) {
+  if (protocol == kArithmeticGmw &&
+      (operation == MixedOperation::kGreaterThan || operation == MixedOperation::kEqual)) {
+    return kBooleanGmw;
+  }
+  return protocol;
+}
+
+double EstimateRunTime(const MixedCircuit& circuit, const std::vector<MpcProtocol>& protocols,
+                       const ProtocolCostModel& cost_model) {
+  const auto& nodes{circuit.GetNodes()};
+  assert(protocols.size() == nodes.size());
+  ProtocolCost sum;
+  // rounds until the result of each node is available
+  std::vector<double> rounds(nodes.size(), 0);
+  // each node is converted to each protocol at most once
+  std::set<std::pair<std::size_t, MpcProtocol>> conversions;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const auto cost{
+        cost_model.GetOperationCost(nodes[i].operation, protocols[i], circuit.GetBitLength())};
+    if (!cost) return kInfinity;
+    double parent_rounds{0};
+    for (const auto parent : nodes[i].parents) {
+      const auto parent_protocol{GetResultProtocol(nodes[parent].operation, protocols[parent])};
+      const auto conversion_cost{cost_model.GetConversionCost(parent_protocol, protocols[i],
+                                                              circuit.GetBitLength(parent))};
+      if (!conversion_cost) return kInfinity;
+      parent_rounds = std::max(parent_rounds, rounds[parent] + conversion_cost->rounds);
+      if (parent_protocol != protocols[i] && conversions.emplace(parent, protocols[i]).second) {
+        sum.bits += conversion_cost->bits;
+        sum.time += conversion_cost->time;
+      }
+    }
+    rounds[i] = parent_rounds + cost->rounds;
+    sum.bits += cost->bits;
+    sum.time += cost->time;
+  }
+  sum.rounds = nodes.empty() ? 0 : *std::max_element(rounds.begin(), rounds.end());
+  return cost_model.EstimateTime(sum, circuit.GetNumberOfSimdValues());
+}
+
+ProtocolAssignment AssignProtocols(const MixedCircuit& circuit,
+                                   const ProtocolCostModel& cost_model) {
+  const auto& nodes{circuit.GetNodes()};
+  const auto& candidates{cost_model.GetProtocols()};
+  const auto number_of_simd{circuit.GetNumberOfSimdValues()};
+
+  // the time of a conversion of the result of node j evaluated in candidates[q] to protocol p
+  const auto conversion_time = [&](std::size_t j, std::size_t q, MpcProtocol p) {
+    const auto cost{cost_model.GetConversionCost(
+        GetResultProtocol(nodes[j].operation, candidates[q]), p, circuit.GetBitLength(j))};
+    return cost ? cost_model.EstimateTime(*cost, number_of_simd) : kInfinity;
+  };
+
+  // time[i][k] is the time of the subcircuit of node i evaluated in candidates[k], where shared
+  // parents are counted once per child
+  std::vector<std::vector<double>> time(nodes.size(), std::vector<double>(candidates.size()));
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    for (std::size_t k = 0; k < candidates.size(); ++k) {
+      const auto cost{
+          cost_model.GetOperationCost(nodes[i].operation, candidates[k], circuit.GetBitLength())};
+      if (!cost) {
+        time[i][k] = kInfinity;
+        continue;
+      }
+      time[i][k] = cost_model.EstimateTime(*cost, number_of_simd);
+      for (const auto parent : nodes[i].parents) {
+        double best{kInfinity};
+        for (std::size_t q = 0; q < candidates.size(); ++q) {
+          best = std::min(best, time[parent][q] + conversion_time(parent, q, candidates[k]));
+        }
+        time[i][k] += best;
+      }
+    }
+    if (std::all_of(time[i].begin(), time[i].end(), [](double t) { return t == kInfinity; })) {
+      throw std::invalid_argument(fmt::format("No protocol supports node {}", i));
+    }
+  }
+
+  // backtrack from the children, which are after their parents, to the parents
+  std::vector<std::optional<std::size_t>> choices(nodes.size());
+  for (std::size_t i = nodes.size(); i-- > 0;) {
+    if (!choices[i]) {
+      choices[i] = std::min_element(time[i].begin(), time[i].end()) - time[i].begin();
+    }
+    const auto protocol{candidates[*choices[i]]};
+    for (const auto parent : nodes[i].parents) {
+      if (choices[parent]) continue;
+      std::size_t best_q{0};
+      double best{kInfinity};
+      for (std::size_t q = 0; q < candidates.size(); ++q) {
+        const double t{time[parent][q] + conversion_time(parent, q, protocol)};
+        if (t < best) {
+          best = t;
+          best_q = q;
+        }
+      }
+      choices[parent] = best_q;
+    }
+  }
+
+  ProtocolAssignment assignment;
+  assignment.protocols.reserve(nodes.size());
+  for (const auto& choice : choices) assignment.protocols.push_back(candidates[*choice]);
+  assignment.estimated_time = EstimateRunTime(circuit, assignment.protocols, cost_model);
+
+  // change single nodes while the estimate improves, which accounts for shared parents and the
+  // rounds on the critical path
+  for (bool improved = true; improved;) {
+    improved = false;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      const auto current{assignment.protocols[i]};
+      for (const auto protocol : candidates) {
+        if (protocol == current) continue;
+        assignment.protocols[i] = protocol;
+        const double estimated_time{EstimateRunTime(circuit, assignment.protocols, cost_model)};
+        if (estimated_time < assignment.estimated_time) {
+          assignment.estimated_time = estimated_time;
+          improved = true;
+          break;
+        }
+        assignment.protocols[i] = current;
+      }
+    }
+  }
+  return assignment;
+}
+
+namespace {
+
+ShareWrapper ConvertTo(const ShareWrapper& share, MpcProtocol protocol) {
+  if (share->GetProtocol() == protocol) return share;
+  switch (protocol) {
+    case kArithmeticGmw:
+      return share.Convert<kArithmeticGmw>();
+    case kBooleanGmw:
+      return share.Convert<kBooleanGmw>();
+    case kBmr:
+      return share.Convert<kBmr>();
+    case kGarbledCircuit:
+      return share.Convert<kGarbledCircuit>();
+    default:
+      throw std::invalid_argument(
+          fmt::format("Cannot convert to protocol {}", to_string(protocol)));
+  }
+}
+
+template <typename T>
+ShareWrapper MakeInput(Party& party, MpcProtocol protocol, const std::vector<T>& values,
+                       std::size_t input_owner) {
+  switch (protocol) {
+    case kArithmeticGmw:
+      return ShareWrapper(party.In<kArithmeticGmw>(values, input_owner));
+    case kBooleanGmw:
+      return ShareWrapper(party.In<kBooleanGmw>(ToInput(values), input_owner));
+    case kBmr:
+      return ShareWrapper(party.In<kBmr>(ToInput(values), input_owner));
+    case kGarbledCircuit:
+      return ShareWrapper(party.In<kGarbledCircuit>(ToInput(values), input_owner));
+    default:
+      throw std::invalid_argument(fmt::format("Invalid input protocol {}", to_string(protocol)));
+  }
+}
+
+}  // namespace
+
+template <typename T>
+std::vector<ShareWrapper> BuildMixedCircuit(Party& party, const MixedCircuit& circuit,
+                                            const ProtocolAssignment& assignment,
+                                            const std::vector<std::vector<T>>& inputs) {
+  if (sizeof(T) * 8 != circuit.GetBitLength()) {
+    throw std::invalid_argument(fmt::format("Type of {} bits for a circuit of bit length {}",
+                                            sizeof(T) * 8, circuit.GetBitLength()));
+  }
+  const auto& nodes{circuit.GetNodes()};
+  assert(assignment.protocols.size() == nodes.size());
+  const auto my_id{party.GetConfiguration()->GetMyId()};
+  const std::vector<T> dummy_input(circuit.GetNumberOfSimdValues(), 0);
+
+  // the shares of each node in the protocols it is needed, starting with the result protocol
+  std::vector<std::map<MpcProtocol, ShareWrapper>> shares(nodes.size());
+  const auto get_share = [&shares](std::size_t node, MpcProtocol protocol) {
+    auto& node_shares{shares[node]};
+    if (auto iterator{node_shares.find(protocol)}; iterator != node_shares.end()) {
+      return iterator->second;
+    }
+    auto converted{ConvertTo(node_shares.begin()->second, protocol)};
+    node_shares.emplace(protocol, converted);
+    return converted;
+  };
+
+  std::size_t input_index{0};
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const auto& node{nodes[i]};
+    const auto protocol{assignment.protocols[i]};
+    ShareWrapper result;
+    if (node.operation == MixedOperation::kInput) {
+      const bool is_my_input{node.input_owner == my_id};
+      result = MakeInput(party, protocol, is_my_input ? inputs.at(input_index) : dummy_input,
+                         node.input_owner);
+      ++input_index;
+    } else if (node.operation == MixedOperation::kMux) {
+      result = get_share(node.parents[0], protocol)
+                   .Mux(get_share(node.parents[1], protocol), get_share(node.parents[2], protocol));
+    } else {
+      const SecureUnsignedInteger a{get_share(node.parents[0], protocol)};
+      const SecureUnsignedInteger b{get_share(node.parents[1], protocol)};
+      switch (node.operation) {
+        case MixedOperation::kAdd:
+          result = (a + b).Get();
+          break;
+        case MixedOperation::kSub:
+          result = (a - b).Get();
+          break;
+        case MixedOperation::kMul:
+          result = (a * b).Get();
+          break;
+        case MixedOperation::kGreaterThan:
+          result = a > b;
+          break;
+        case MixedOperation::kEqual:
+          result = a == b;
+          break;
+        default:
+          throw std::invalid_argument(
+              fmt::format("Invalid operation {}", static_cast<unsigned>(node.operation)));
+      }
+    }
+    assert(result->GetProtocol() == GetResultProtocol(node.operation, protocol));
+    shares[i].emplace(result->GetProtocol(), std::move(result));
+  }
+
+  std::vector<ShareWrapper> outputs;
+  outputs.reserve(circuit.GetOutputs().size());
+  for (const auto output : circuit.GetOutputs()) {
+    outputs.push_back(shares[output].begin()->second.Out());
+  }
+  return outputs;
+}
+
+template std::vector<ShareWrapper> BuildMixedCircuit<std::uint8_t>(
+    Party& party, const MixedCircuit& circuit, const ProtocolAssignment& assignment,
+    const std::vector<std::vector<std::uint8_t>>& inputs);
+template std::vector<ShareWrapper> BuildMixedCircuit<std::uint16_t>(
+    Party& party, const MixedCircuit& circuit, const ProtocolAssignment& assignment,
+    const std::vector<std::vector<std::uint16_t>>& inputs);
+template std::vector<ShareWrapper> BuildMixedCircuit<std::uint32_t>(
+    Party& party, const MixedCircuit& circuit, const ProtocolAssignment& assignment,
+    const std::vector<std::vector<std::uint32_t>>& inputs);
+template std::vector<ShareWrapper> BuildMixedCircuit<std::uint64_t>(
+    Party& party, const MixedCircuit& circuit, const ProtocolAssignment& assignment,
+    const std::vector<std::vector<std::uint64_t>>& inputs);
+
+}  // namespace encrypto::motion
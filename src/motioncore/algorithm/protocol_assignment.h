@@ -0,0 +1,256 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+class Party;
+
+/// \brief Operations of a MixedCircuit on unsigned integers.  Comparisons output a single bit,
+///        which is the selection bit of kMux.  Their values need to be smaller than 2^(l-1) if
+///        they are evaluated in arithmetic GMW, see
+///        ProtocolCostModel::SetArithmeticComparisons.
+enum class MixedOperation : std::uint8_t {
+  kInput,
+  kAdd,
+  kSub,
+  kMul,
+  kGreaterThan,
+  kEqual,
+  kMux,
+  kInvalid  // for checking whether the value is valid
+};
+
+class MixedCircuit;
+
+/// \brief Handle of a node of a MixedCircuit, which builds the circuit with the operators of
+///        SecureUnsignedInteger.
+class MixedValue {
+ public:
+  MixedValue(MixedCircuit& circuit, std::size_t node) : circuit_(&circuit), node_(node) {}
+
+  std::size_t GetNode() const noexcept { return node_; }
+
+  MixedValue operator+(const MixedValue& other) const;
+
+  MixedValue operator-(const MixedValue& other) const;
+
+  MixedValue operator*(const MixedValue& other) const;
+
+  MixedValue operator>(const MixedValue& other) const;
+
+  MixedValue operator==(const MixedValue& other) const;
+
+  /// \brief Uses this comparison result as the selection bit, returns this ? a : b.
+  MixedValue Mux(const MixedValue& a, const MixedValue& b) const;
+
+ private:
+  MixedCircuit* circuit_;
+  std::size_t node_;
+};
+
+/// \brief A circuit on unsigned integers of a single bit length without protocols, which are
+///        assigned by AssignProtocols.  The nodes are stored in topological order.
+class MixedCircuit {
+ public:
+  struct Node {
+    MixedOperation operation;
+    std::vector<std::size_t> parents;
+    // the party providing the values of kInput
+    std::size_t input_owner{0};
+  };
+
+  /// \param bit_length of the values, one of 8, 16, 32 and 64
+  MixedCircuit(std::size_t bit_length, std::size_t number_of_simd = 1);
+
+  MixedValue Input(std::size_t input_owner);
+
+  /// \brief Appends a node of \p operation on \p parents, which are checked for their number and
+  ///        bit lengths.
+  /// \throws std::invalid_argument if the parents do not fit the operation
+  MixedValue Add(MixedOperation operation, std::vector<std::size_t> parents);
+
+  /// \brief Marks \p value as an output of the circuit, see BuildMixedCircuit.
+  void Output(const MixedValue& value) { outputs_.push_back(value.GetNode()); }
+
+  const std::vector<Node>& GetNodes() const noexcept { return nodes_; }
+
+  const std::vector<std::size_t>& GetOutputs() const noexcept { return outputs_; }
+
+  std::size_t GetNumberOfInputs() const noexcept { return number_of_inputs_; }
+
+  std::size_t GetBitLength() const noexcept { return bit_length_; }
+
+  /// \brief Comparisons have bit length 1, all other nodes GetBitLength().
+  std::size_t GetBitLength(std::size_t node) const;
+
+  std::size_t GetNumberOfSimdValues() const noexcept { return number_of_simd_; }
+
+ private:
+  std::size_t bit_length_;
+  std::size_t number_of_simd_;
+  std::size_t number_of_inputs_{0};
+  std::vector<Node> nodes_;
+  std::vector<std::size_t> outputs_;
+};
+
+/// \brief Cost of an operation or a conversion on a single SIMD value.
+struct ProtocolCost {
+  // communication rounds on the critical path
+  double rounds{0};
+  // bits sent by each party, including the setup phase
+  double bits{0};
+  // computation time in seconds
+  double time{0};
+};
+
+/// \brief Estimates the costs of the operations of a MixedCircuit and of the conversions between
+///        protocols.  The defaults are analytical estimates from the AND gates of the Boolean
+///        circuits and the preprocessing of the protocols, and can be replaced by run times
+///        measured with the micro benchmarks with SetOperationCost and SetConversionCost.
+class ProtocolCostModel {
+ public:
+  /// \param network_bandwidth in bits per second, 0 means unlimited, see
+  ///        Configuration::SetNetworkProfile
+  ProtocolCostModel(std::size_t number_of_parties, std::chrono::microseconds round_trip_time,
+                    double network_bandwidth);
+
+  /// \brief Arithmetic GMW, Boolean GMW and BMR, and garbled circuits for 2 parties.
+  const std::vector<MpcProtocol>& GetProtocols() const noexcept { return protocols_; }
+
+  /// \returns the cost of \p operation on values of \p bit_length bits in \p protocol or
+  ///          std::nullopt if the protocol does not support the operation
+  std::optional<ProtocolCost> GetOperationCost(MixedOperation operation, MpcProtocol protocol,
+                                               std::size_t bit_length) const;
+
+  /// \returns the cost of converting a share of \p bit_length bits from protocol \p from to
+  ///          \p to or std::nullopt if the conversion is not supported, which is the case for
+  ///          arithmetic shares of single bits
+  std::optional<ProtocolCost> GetConversionCost(MpcProtocol from, MpcProtocol to,
+                                                std::size_t bit_length) const;
+
+  /// \brief Allows the OT-based comparisons of arithmetic GMW for 2 parties, which require the
+  ///        inputs to be smaller than 2^(l-1), see proto::arithmetic_gmw::GreaterThanGate.
+  ///        Disabled by default, s.t. the results do not depend on the assignment.
+  void SetArithmeticComparisons(bool arithmetic_comparisons = true) {
+    arithmetic_comparisons_ = arithmetic_comparisons;
+  }
+
+  void SetOperationCost(MixedOperation operation, MpcProtocol protocol, std::size_t bit_length,
+                        ProtocolCost cost) {
+    operation_costs_[{operation, protocol, bit_length}] = cost;
+  }
+
+  void SetConversionCost(MpcProtocol from, MpcProtocol to, std::size_t bit_length,
+                         ProtocolCost cost) {
+    conversion_costs_[{from, to, bit_length}] = cost;
+  }
+
+  /// \brief Estimated run time in seconds of \p cost on \p number_of_simd values, where the
+  ///        rounds are not parallelized over the SIMD values: rounds * RTT + number_of_simd *
+  ///        (bits / bandwidth + time).
+  double EstimateTime(const ProtocolCost& cost, std::size_t number_of_simd) const;
+
+  std::size_t GetNumberOfParties() const noexcept { return number_of_parties_; }
+
+  double GetRoundTripTime() const noexcept { return round_trip_seconds_; }
+
+  double GetNetworkBandwidth() const noexcept { return network_bandwidth_; }
+
+ private:
+  std::optional<ProtocolCost> GetDefaultOperationCost(MixedOperation operation,
+                                                      MpcProtocol protocol,
+                                                      std::size_t bit_length) const;
+
+  std::optional<ProtocolCost> GetDefaultConversionCost(MpcProtocol from, MpcProtocol to,
+                                                       std::size_t bit_length) const;
+
+  // cost of a Boolean circuit of \p number_of_and_gates AND gates of depth \p and_depth
+  ProtocolCost GetBooleanCircuitCost(MpcProtocol protocol, double number_of_and_gates,
+                                     double and_depth) const;
+
+  std::size_t number_of_parties_;
+  std::chrono::microseconds round_trip_time_;
+  double round_trip_seconds_;
+  double network_bandwidth_;
+  std::vector<MpcProtocol> protocols_;
+  bool arithmetic_comparisons_{false};
+  std::map<std::tuple<MixedOperation, MpcProtocol, std::size_t>, ProtocolCost> operation_costs_;
+  std::map<std::tuple<MpcProtocol, MpcProtocol, std::size_t>, ProtocolCost> conversion_costs_;
+};
+
+/// \brief Assignment of a protocol to each node of a MixedCircuit.
+struct ProtocolAssignment {
+  // the protocol evaluating each node
+  std::vector<MpcProtocol> protocols;
+  // estimated run time in seconds, see EstimateRunTime
+  double estimated_time{0};
+};
+
+/// \brief The protocol of the result of \p operation evaluated in \p protocol.  The OT-based
+///        comparisons of arithmetic GMW output Boolean GMW shares, see
+///        proto::arithmetic_gmw::GreaterThanGate.
+MpcProtocol GetResultProtocol(MixedOperation operation, MpcProtocol protocol);
+
+/// \brief Estimates the run time of \p circuit with \p protocols by \p cost_model.  The rounds are
+///        the ones of the critical path, the bits and the computation are summed over all nodes
+///        and conversions, where a node is converted to each protocol at most once.
+/// \returns the estimated time or infinity if a protocol does not support its node or a
+///          conversion is not supported
+double EstimateRunTime(const MixedCircuit& circuit, const std::vector<MpcProtocol>& protocols,
+                       const ProtocolCostModel& cost_model);
+
+/// \brief Assigns the protocol to each node of \p circuit that minimizes the estimated run time
+///        by \p cost_model, inserting conversions where parents and children differ.
+///
+/// The initial assignment is the one of a dynamic program over the nodes in topological order,
+/// which is optimal for trees but counts shared parents once per child.  It is refined by
+/// changing the protocol of single nodes as long as EstimateRunTime improves, since the optimal
+/// assignment of general circuits is NP-hard.
+/// \throws std::invalid_argument if no protocol supports a node
+ProtocolAssignment AssignProtocols(const MixedCircuit& circuit,
+                                   const ProtocolCostModel& cost_model);
+
+/// \brief Constructs the gates of \p circuit in \p party with \p assignment, converting the shares
+///        between protocols by ShareWrapper::Convert.  \p inputs holds the values of the inputs in
+///        their order of construction, where only the values of this party's inputs are read.
+/// \returns the output shares of the outputs of \p circuit, see ShareWrapper::Out
+/// \pre T has the bit length of \p circuit
+template <typename T>
+std::vector<ShareWrapper> BuildMixedCircuit(Party& party, const MixedCircuit& circuit,
+                                            const ProtocolAssignment& assignment,
+                                            const std::vector<std::vector<T>>& inputs);
+
+}  // namespace encrypto::motion
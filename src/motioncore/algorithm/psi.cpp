@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "psi.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/register.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "protocols/share.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the statistical security parameter of the simple hashing bin sizes
+constexpr double kPsiStatisticalSecurity{40};
+
+// the maximum number of evictions of a cuckoo insertion until the hashing fails
+constexpr std::size_t kMaxCuckooEvictions{1000};
+
+// the finalizer of SplitMix64, see https://prng.di.unimi.it/splitmix64.c
+std::uint64_t Mix(std::uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+// the smallest m s.t. some of number_of_bins bins gets more than m of number_of_balls random balls
+// with a probability of at most 2^-kPsiStatisticalSecurity by the union bound over the bins
+std::size_t GetMaxBinSize(std::size_t number_of_balls, std::size_t number_of_bins) {
+  if (number_of_bins == 1) return number_of_balls;
+  const double n{static_cast<double>(number_of_balls)};
+  const double log_p{-std::log(static_cast<double>(number_of_bins))};
+  const double log_q{std::log1p(-1.0 / number_of_bins)};
+  const double log_n_factorial{std::lgamma(n + 1)};
+  // the probability of exactly k balls in a bin
+  const auto probability = [&](std::size_t k) {
+    const double kd{static_cast<double>(k)};
+    return std::exp(log_n_factorial - std::lgamma(kd + 1) - std::lgamma(n - kd + 1) + kd * log_p +
+                    (n - kd) * log_q);
+  };
+  const double max_probability{std::exp2(-kPsiStatisticalSecurity) / number_of_bins};
+  for (std::size_t m = 1; m < number_of_balls; ++m) {
+    double tail{0};
+    for (std::size_t k = m + 1; k <= number_of_balls; ++k) {
+      const double term{probability(k)};
+      tail += term;
+      // the terms decrease geometrically beyond the mean
+      if (term <= tail * 1e-12) break;
+    }
+    if (tail <= max_probability) return m;
+  }
+  return number_of_balls;
+}
+
+}  // namespace
+
+PsiParameters GetPsiParameters(std::size_t receiver_set_size, std::size_t sender_set_size) {
+  if (receiver_set_size == 0 || sender_set_size == 0) {
+    throw std::invalid_argument("The sets of a PSI must not be empty");
+  }
+  const auto number_of_bins{
+      static_cast<std::size_t>(std::ceil(kPsiCuckooExpansion * receiver_set_size))};
+  return {number_of_bins,
+          GetMaxBinSize(kPsiNumberOfHashFunctions * sender_set_size, number_of_bins)};
+}
+
+std::size_t PsiHash(std::uint64_t item, std::size_t hash_index, std::size_t number_of_bins) {
+  // arbitrary public constants, the fractional digits of the golden ratio and of sqrt(2), sqrt(3)
+  constexpr std::array<std::uint64_t, kPsiNumberOfHashFunctions> kSeeds{
+      0x9e3779b97f4a7c15, 0x6a09e667f3bcc908, 0xbb67ae8584caa73b};
+  const __uint128_t hash{Mix(item ^ kSeeds.at(hash_index))};
+  // maps the hash to [0, number_of_bins) without the bias of a modulo
+  return static_cast<std::size_t>((hash * number_of_bins) >> 64);
+}
+
+std::vector<std::optional<std::size_t>> CuckooHash(std::span<const std::uint64_t> items,
+                                                   std::size_t number_of_bins) {
+  std::vector<std::optional<std::size_t>> bins(number_of_bins);
+  // the random walk of the evictions needs no secret randomness
+  std::mt19937_64 random(items.size());
+  for (std::size_t item_index = 0; item_index < items.size(); ++item_index) {
+    std::size_t current{item_index}, previous_bin{number_of_bins};
+    for (std::size_t eviction = 0;; ++eviction) {
+      bool is_placed{false};
+      for (std::size_t h = 0; h < kPsiNumberOfHashFunctions && !is_placed; ++h) {
+        const auto bin{PsiHash(items[current], h, number_of_bins)};
+        if (!bins[bin]) {
+          bins[bin] = current;
+          is_placed = true;
+        }
+      }
+      if (is_placed) break;
+      if (eviction == kMaxCuckooEvictions) {
+        throw std::runtime_error(fmt::format(
+            "Cuckoo hashing of {} items into {} bins failed", items.size(), number_of_bins));
+      }
+      // evicts the item of a random bin, which is not the bin that current was just evicted from
+      auto h{random() % kPsiNumberOfHashFunctions};
+      auto bin{PsiHash(items[current], h, number_of_bins)};
+      if (bin == previous_bin) {
+        bin = PsiHash(items[current], (h + 1) % kPsiNumberOfHashFunctions, number_of_bins);
+      }
+      std::swap(current, *bins[bin]);
+      previous_bin = bin;
+    }
+  }
+  return bins;
+}
+
+std::vector<std::vector<std::uint64_t>> SimpleHash(std::span<const std::uint64_t> items,
+                                                   std::size_t number_of_bins) {
+  std::vector<std::vector<std::uint64_t>> bins(number_of_bins);
+  for (const auto item : items) {
+    std::array<std::size_t, kPsiNumberOfHashFunctions> item_bins;
+    for (std::size_t h = 0; h < kPsiNumberOfHashFunctions; ++h) {
+      item_bins[h] = PsiHash(item, h, number_of_bins);
+      // an item that hashes twice to a bin matches at most once
+      if (std::find(item_bins.begin(), item_bins.begin() + h, item_bins[h]) ==
+          item_bins.begin() + h) {
+        bins[item_bins[h]].push_back(item);
+      }
+    }
+  }
+  return bins;
+}
+
+PsiResult PrivateSetIntersection(Backend& backend, std::span<const std::uint64_t> set,
+                                 std::size_t receiver_set_size, std::size_t sender_set_size) {
+  using proto::boolean_gmw::PrivateSetIntersectionGate;
+  const auto gate{backend.GetRegister()->EmplaceGate<PrivateSetIntersectionGate>(
+      set, receiver_set_size, sender_set_size, backend)};
+  const std::size_t number_of_chunks{PrivateSetIntersectionGate::kNumberOfChunks};
+  const std::size_t max_bin_size{gate->GetOutputWires().size() / number_of_chunks};
+  const auto equalities{
+      ShareWrapper(std::static_pointer_cast<Share>(gate->GetOutputAsGmwShare())).Split()};
+
+  // a slot matches iff all of its chunks are equal, which is computed for all slots at once
+  std::vector<ShareWrapper> chunk_equalities;
+  chunk_equalities.reserve(number_of_chunks);
+  for (std::size_t k = 0; k < number_of_chunks; ++k) {
+    chunk_equalities.push_back(
+        ShareWrapper::Concatenate(equalities.begin() + k * max_bin_size,
+                                  equalities.begin() + (k + 1) * max_bin_size));
+  }
+  const auto slot_matches{ShareWrapper::MultiInputAnd(std::move(chunk_equalities)).Split()};
+
+  // the items of the sender in a bin are distinct, so at most one slot matches and the OR of the
+  // slots is their XOR
+  ShareWrapper membership{slot_matches.at(0)};
+  for (std::size_t slot = 1; slot < slot_matches.size(); ++slot) membership ^= slot_matches[slot];
+  return {membership, gate->GetBinItems()};
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+class Backend;
+
+}  // namespace encrypto::motion
+
+namespace encrypto::motion::algorithm {
+
+/// \brief the number of hash functions of the cuckoo and simple hashing of the PSI
+constexpr std::size_t kPsiNumberOfHashFunctions{3};
+
+/// \brief the number of cuckoo bins per receiver item, which succeeds without a stash except with
+/// negligible probability for 3 hash functions
+constexpr double kPsiCuckooExpansion{1.27};
+
+/// \brief Public parameters of the circuit-based PSI, which both parties derive from the public
+/// set sizes.
+struct PsiParameters {
+  std::size_t number_of_bins;
+  /// the number of slots that the sender pads each of its simple hashing bins to, s.t. the bin
+  /// sizes do not leak; a larger bin occurs with probability at most 2^-40
+  std::size_t max_bin_size;
+};
+
+/// \throws std::invalid_argument if a set is empty
+PsiParameters GetPsiParameters(std::size_t receiver_set_size, std::size_t sender_set_size);
+
+/// \brief the bin of item for the hash function hash_index < kPsiNumberOfHashFunctions
+std::size_t PsiHash(std::uint64_t item, std::size_t hash_index, std::size_t number_of_bins);
+
+/// \brief Places each item into one of its kPsiNumberOfHashFunctions bins by cuckoo hashing.
+/// \returns the index of the item in each bin or std::nullopt for empty bins
+/// \throws std::runtime_error if the insertion fails, which has negligible probability for the
+///         number of bins of PsiParameters
+std::vector<std::optional<std::size_t>> CuckooHash(std::span<const std::uint64_t> items,
+                                                   std::size_t number_of_bins);
+
+/// \brief Places each item into all of its distinct kPsiNumberOfHashFunctions bins.
+std::vector<std::vector<std::uint64_t>> SimpleHash(std::span<const std::uint64_t> items,
+                                                   std::size_t number_of_bins);
+
+/// \brief Secret-shared membership of the receiver's items in the sender's set.
+struct PsiResult {
+  /// Boolean GMW share of one wire with one SIMD value per cuckoo bin, which is 1 iff the bin
+  /// holds a receiver item that is in the sender's set
+  ShareWrapper membership;
+  /// the receiver's index of the item in each bin, see CuckooHash; empty for the sender
+  std::vector<std::optional<std::size_t>> bin_items;
+};
+
+/// \brief Computes the circuit-based private set intersection of the receiver's set X of party 0
+/// and the sender's set Y of party 1.  The receiver cuckoo hashes X and the sender simple hashes Y
+/// into the same bins, s.t. x in X is in Y iff it equals an item of the sender in the bin of x.
+/// proto::boolean_gmw::PrivateSetIntersectionGate compares the item of each bin with all sender
+/// items of the bin by 1-out-of-N KK13 OTs and the membership is the XOR of the AND over the
+/// equalities of the chunks of each pair, which costs O(n) instead of O(n^2) comparisons.  The
+/// membership bits can be used by later gates, e.g., converted to arithmetic GMW to count or sum
+/// over the intersection.  Exactly 2 parties are supported.
+/// \param set the distinct items of this party
+/// \throws std::invalid_argument if there are not exactly 2 parties, if the size of set differs
+///         from the public set size of this party or if set contains duplicates
+PsiResult PrivateSetIntersection(Backend& backend, std::span<const std::uint64_t> set,
+                                 std::size_t receiver_set_size, std::size_t sender_set_size);
+
+}  // namespace encrypto::motion::algorithm
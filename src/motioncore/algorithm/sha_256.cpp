@@ -1,6 +1,6 @@
 // MIT License
 //
-// Copyright (c) 2021 Arianne Roselina Prananto
+// Copyright (c) 2022 Oleksandr Tkachenko
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -20,12 +20,21 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#pragma once
+#include "sha_256.h"
 
-#include "base/party.h"
-#include "secure_type/secure_unsigned_integer.h"
-#include "statistics/run_time_statistics.h"
+#include <cassert>
 
-encrypto::motion::ShareWrapper CreateOPCircuit(
-    encrypto::motion::ShareWrapper a, encrypto::motion::ShareWrapper b, encrypto::motion::PartyPointer& party, encrypto::motion::MpcProtocol protocol);
+#include "protocols/share.h"
 
+namespace encrypto::motion::algorithm {
+
+ShareWrapper Sha256Compression(const ShareWrapper& block, const ShareWrapper& state) {
+  assert(block->GetBitLength() == kSha256BlockBitSize);
+  assert(state->GetBitLength() == kSha256StateBitSize);
+  const std::vector<ShareWrapper> block_wires{block.Split()};
+  const std::vector<ShareWrapper> state_wires{state.Split()};
+  return ShareWrapper::Concatenate(Sha256CompressionFunction<ShareWrapper>(
+      std::span<const ShareWrapper>(block_wires), std::span<const ShareWrapper>(state_wires)));
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,189 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+constexpr std::size_t kSha256BlockBitSize{512};
+constexpr std::size_t kSha256StateBitSize{256};
+
+/// \brief The initial hash value of SHA-256, i.e., the state for the first block.
+constexpr std::array<std::uint32_t, 8> kSha256InitialHashValue{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+/// \brief The SHA-256 compression function on a padded message \p block and the chaining
+/// \p state with a dedicated circuit, which computes the same as
+/// circuits/advanced/sha_256.bristol.  Additions modulo 2^32 are ripple-carry adders with 31 ANDs,
+/// and the round constants are added with an adder specialized on their known bits.
+/// \param block 512 wires, where wire i is bit i of the block read as a big-endian integer
+/// \param state 256 wires with the same layout as \p block
+/// \returns the next chaining state as 256 wires with the same layout as \p block
+ShareWrapper Sha256Compression(const ShareWrapper& block, const ShareWrapper& state);
+
+namespace detail {
+
+// a 32-bit word, least significant bit first
+template <typename Bit>
+using Sha256Word = std::array<Bit, 32>;
+
+// word j of n words is at the wires 32 * (n - 1 - j) to 32 * (n - 1 - j) + 31
+template <typename Bit, std::size_t kNumberOfWords>
+std::array<Sha256Word<Bit>, kNumberOfWords> ToSha256Words(std::span<const Bit> wires) {
+  assert(wires.size() == 32 * kNumberOfWords);
+  std::array<Sha256Word<Bit>, kNumberOfWords> words;
+  for (std::size_t word_j = 0; word_j < kNumberOfWords; ++word_j) {
+    for (std::size_t bit_i = 0; bit_i < 32; ++bit_i) {
+      words[word_j][bit_i] = wires[32 * (kNumberOfWords - 1 - word_j) + bit_i];
+    }
+  }
+  return words;
+}
+
+// addition modulo 2^32 with 31 ANDs
+template <typename Bit>
+Sha256Word<Bit> Sha256Add(const Sha256Word<Bit>& a, const Sha256Word<Bit>& b) {
+  Sha256Word<Bit> sum;
+  sum[0] = a[0] ^ b[0];
+  Bit carry{a[0] & b[0]};
+  for (std::size_t bit_i = 1; bit_i < 32; ++bit_i) {
+    const Bit a_xor_carry{a[bit_i] ^ carry};
+    sum[bit_i] = a_xor_carry ^ b[bit_i];
+    // the carry of the most significant bit is not needed
+    if (bit_i < 31) carry = (a_xor_carry & (b[bit_i] ^ carry)) ^ carry;
+  }
+  return sum;
+}
+
+// addition of a constant modulo 2^32, which saves the ANDs while no carry can occur yet
+template <typename Bit>
+Sha256Word<Bit> Sha256AddConstant(const Sha256Word<Bit>& a, std::uint32_t constant) {
+  Sha256Word<Bit> sum;
+  std::optional<Bit> carry;
+  for (std::size_t bit_i = 0; bit_i < 32; ++bit_i) {
+    const bool constant_bit{((constant >> bit_i) & 1) == 1};
+    const bool is_last{bit_i == 31};
+    if (!carry) {
+      sum[bit_i] = constant_bit ? ~a[bit_i] : a[bit_i];
+      if (constant_bit && !is_last) carry = a[bit_i];
+    } else {
+      const Bit a_xor_carry{a[bit_i] ^ *carry};
+      sum[bit_i] = constant_bit ? ~a_xor_carry : a_xor_carry;
+      if (is_last) break;
+      const Bit a_and_carry{a[bit_i] & *carry};
+      // a | carry = a ^ carry ^ (a & carry) for a set constant bit, and a & carry otherwise
+      carry = constant_bit ? a_xor_carry ^ a_and_carry : a_and_carry;
+    }
+  }
+  return sum;
+}
+
+// XOR of right rotations and a right shift of x, where rotation_2 == 0 and shift == 0 denote
+// the absence of the third rotation and of the shift, respectively
+template <typename Bit>
+Sha256Word<Bit> Sha256Sigma(const Sha256Word<Bit>& x, std::size_t rotation_0,
+                            std::size_t rotation_1, std::size_t rotation_2, std::size_t shift) {
+  Sha256Word<Bit> result;
+  for (std::size_t bit_i = 0; bit_i < 32; ++bit_i) {
+    result[bit_i] = x[(bit_i + rotation_0) % 32] ^ x[(bit_i + rotation_1) % 32];
+    if (rotation_2 > 0) result[bit_i] = result[bit_i] ^ x[(bit_i + rotation_2) % 32];
+    if (shift > 0 && bit_i + shift < 32) result[bit_i] = result[bit_i] ^ x[bit_i + shift];
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/// \brief Builds the SHA-256 compression function on the bits of \p block and \p state, see
+/// Sha256Compression.
+/// \tparam Bit a type with the operators ^, & and ~, e.g., ShareWrapper or BitVector<>
+template <typename Bit>
+std::vector<Bit> Sha256CompressionFunction(std::span<const Bit> block,
+                                           std::span<const Bit> state) {
+  using Word = detail::Sha256Word<Bit>;
+  constexpr std::array<std::uint32_t, 64> kRoundConstants{
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+      0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+      0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+      0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+      0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+      0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+      0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+      0xc67178f2};
+
+  // message schedule
+  std::vector<Word> schedule;
+  schedule.reserve(64);
+  for (const auto& word : detail::ToSha256Words<Bit, 16>(block)) schedule.push_back(word);
+  for (std::size_t t = 16; t < 64; ++t) {
+    const Word s0{detail::Sha256Sigma(schedule[t - 15], 7, 18, 0, 3)};
+    const Word s1{detail::Sha256Sigma(schedule[t - 2], 17, 19, 0, 10)};
+    schedule.push_back(detail::Sha256Add(detail::Sha256Add(s1, schedule[t - 7]),
+                                         detail::Sha256Add(s0, schedule[t - 16])));
+  }
+
+  const auto initial_state{detail::ToSha256Words<Bit, 8>(state)};
+  auto [a, b, c, d, e, f, g, h] = initial_state;
+  for (std::size_t t = 0; t < 64; ++t) {
+    Word choose, majority;
+    for (std::size_t bit_i = 0; bit_i < 32; ++bit_i) {
+      // Ch(e, f, g) = (e & f) ^ (~e & g) and Maj(a, b, c) with a single AND each
+      choose[bit_i] = (e[bit_i] & (f[bit_i] ^ g[bit_i])) ^ g[bit_i];
+      majority[bit_i] = ((a[bit_i] ^ b[bit_i]) & (a[bit_i] ^ c[bit_i])) ^ a[bit_i];
+    }
+    const Word temp_1{detail::Sha256Add(
+        detail::Sha256Add(h, detail::Sha256Sigma(e, 6, 11, 25, 0)),
+        detail::Sha256Add(choose, detail::Sha256AddConstant(schedule[t], kRoundConstants[t])))};
+    const Word temp_2{detail::Sha256Add(detail::Sha256Sigma(a, 2, 13, 22, 0), majority)};
+    h = g;
+    g = f;
+    f = e;
+    e = detail::Sha256Add(d, temp_1);
+    d = c;
+    c = b;
+    b = a;
+    a = detail::Sha256Add(temp_1, temp_2);
+  }
+
+  const std::array<Word, 8> working_variables{a, b, c, d, e, f, g, h};
+  std::vector<Bit> next_state;
+  next_state.reserve(kSha256StateBitSize);
+  for (std::size_t word_j = 8; word_j-- > 0;) {
+    const Word sum{detail::Sha256Add(initial_state[word_j], working_variables[word_j])};
+    next_state.insert(next_state.end(), sum.begin(), sum.end());
+  }
+  return next_state;
+}
+
+}  // namespace encrypto::motion::algorithm
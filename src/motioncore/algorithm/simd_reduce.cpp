@@ -0,0 +1,200 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "simd_reduce.h"
+
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "protocols/share.h"
+#include "secure_type/secure_unsigned_integer.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// the wires begin..end of share
+ShareWrapper GetWires(const ShareWrapper& share, std::size_t begin, std::size_t end) {
+  const auto wires{share.Split()};
+  return ShareWrapper::Concatenate(wires.begin() + begin, wires.begin() + end);
+}
+
+// the records are the values followed by the bits of their positions, which grow by one bit on
+// each level, s.t. the comparison results select the value and position as one share
+std::pair<ShareWrapper, ShareWrapper> ArgReduce(const ShareWrapper& input, bool is_maximum) {
+  if (input->GetCircuitType() != CircuitType::kBoolean) {
+    throw std::invalid_argument("The position of an extremum requires Boolean shares");
+  }
+  const std::size_t bit_length{input->GetBitLength()};
+  const ShareWrapper first_wire{GetWires(input, 0, 1)};
+  ShareWrapper records{input};
+  std::size_t number_of_simd{input->GetNumberOfSimdValues()};
+  if (number_of_simd == 0) throw std::invalid_argument("Cannot reduce a share of 0 SIMD values");
+  if (number_of_simd == 1) return {input, first_wire ^ first_wire};
+  while (number_of_simd > 1) {
+    std::vector<std::size_t> even, odd;
+    for (std::size_t i = 0; i + 1 < number_of_simd; i += 2) {
+      even.push_back(i);
+      odd.push_back(i + 1);
+    }
+    const ShareWrapper even_records{records.Subset(even)}, odd_records{records.Subset(odd)};
+    const SecureUnsignedInteger even_values{GetWires(even_records, 0, bit_length)},
+        odd_values{GetWires(odd_records, 0, bit_length)};
+    // the odd record is better only if it is strictly larger or smaller, i.e., the first wins ties
+    const ShareWrapper take_odd{is_maximum ? odd_values > even_values : even_values > odd_values};
+    const auto difference{ShareWrapper::Concatenate(
+                              std::vector<ShareWrapper>(records->GetBitLength(), take_odd)) &
+                          (even_records ^ odd_records)};
+    std::vector<ShareWrapper> parts{
+        ShareWrapper::Concatenate(std::vector{even_records ^ difference, take_odd})};
+    if (number_of_simd % 2 == 1) {
+      // the left over record is the first of its pair
+      const auto last{records.Subset(std::vector<std::size_t>{number_of_simd - 1})};
+      const auto last_first_wire{GetWires(last, 0, 1)};
+      parts.emplace_back(
+          ShareWrapper::Concatenate(std::vector{last, last_first_wire ^ last_first_wire}));
+    }
+    records = ShareWrapper::Simdify(parts);
+    number_of_simd = (number_of_simd + 1) / 2;
+  }
+  return {GetWires(records, 0, bit_length),
+          GetWires(records, bit_length, records->GetBitLength())};
+}
+
+// a ^ (select & (a ^ b)) for each wire, i.e., select ? b : a
+ShareWrapper Select(const ShareWrapper& select, const ShareWrapper& a, const ShareWrapper& b) {
+  return a ^ (ShareWrapper::Concatenate(std::vector<ShareWrapper>(a->GetBitLength(), select)) &
+              (a ^ b));
+}
+
+// k tournaments as in ArgReduce on the records of the values followed by a bit whether they are
+// still in the tournament and the bits of their positions.  The comparison results of the levels
+// form the tournament tree, which yields the winner's leaf by one AND per node from the root down,
+// s.t. it drops out of the next tournament without comparing its position to all others.
+std::pair<ShareWrapper, ShareWrapper> TopKReduce(const ShareWrapper& input, std::size_t k,
+                                                 bool is_maximum) {
+  if (input->GetCircuitType() != CircuitType::kBoolean) {
+    throw std::invalid_argument("The top k values require Boolean shares");
+  }
+  const std::size_t bit_length{input->GetBitLength()};
+  const std::size_t number_of_simd{input->GetNumberOfSimdValues()};
+  if (k == 0 || k > number_of_simd) {
+    throw std::invalid_argument(
+        fmt::format("Cannot select the top {} of {} SIMD values", k, number_of_simd));
+  }
+  const ShareWrapper first_wire{GetWires(input, 0, 1)};
+  if (number_of_simd == 1) return {input, first_wire ^ first_wire};
+
+  ShareWrapper alive{~(first_wire ^ first_wire)};
+  std::vector<ShareWrapper> values, positions;
+  for (std::size_t round = 0; round < k; ++round) {
+    ShareWrapper records{ShareWrapper::Concatenate(std::vector{input, alive})};
+    // the number of records before and the comparison results of each level
+    std::vector<std::size_t> level_sizes;
+    std::vector<ShareWrapper> level_take_odd;
+    for (std::size_t size = number_of_simd; size > 1; size = (size + 1) / 2) {
+      std::vector<std::size_t> even, odd;
+      for (std::size_t i = 0; i + 1 < size; i += 2) {
+        even.push_back(i);
+        odd.push_back(i + 1);
+      }
+      const ShareWrapper even_records{records.Subset(even)}, odd_records{records.Subset(odd)};
+      const SecureUnsignedInteger even_values{GetWires(even_records, 0, bit_length)},
+          odd_values{GetWires(odd_records, 0, bit_length)};
+      const ShareWrapper odd_is_better{is_maximum ? odd_values > even_values
+                                                  : even_values > odd_values};
+      // a record that dropped out never wins against one that is still in the tournament
+      const ShareWrapper even_alive{GetWires(even_records, bit_length, bit_length + 1)},
+          odd_alive{GetWires(odd_records, bit_length, bit_length + 1)};
+      const ShareWrapper take_odd{odd_alive & ~(even_alive & ~odd_is_better)};
+      std::vector<ShareWrapper> parts{ShareWrapper::Concatenate(
+          std::vector{Select(take_odd, even_records, odd_records), take_odd})};
+      if (size % 2 == 1) {
+        const auto last{records.Subset(std::vector<std::size_t>{size - 1})};
+        const auto last_first_wire{GetWires(last, 0, 1)};
+        parts.emplace_back(
+            ShareWrapper::Concatenate(std::vector{last, last_first_wire ^ last_first_wire}));
+      }
+      records = ShareWrapper::Simdify(parts);
+      level_sizes.push_back(size);
+      level_take_odd.push_back(take_odd);
+    }
+    values.push_back(GetWires(records, 0, bit_length));
+    positions.push_back(GetWires(records, bit_length + 1, records->GetBitLength()));
+    if (round + 1 == k) break;
+
+    // flags[i] is whether record i of the current level is the winner
+    const ShareWrapper root_wire{GetWires(records, 0, 1)};
+    ShareWrapper flags{~(root_wire ^ root_wire)};
+    for (std::size_t level = level_sizes.size(); level-- > 0;) {
+      const std::size_t size{level_sizes[level]}, number_of_pairs{size / 2};
+      std::vector<std::size_t> pair_positions(number_of_pairs);
+      std::iota(pair_positions.begin(), pair_positions.end(), 0);
+      ShareWrapper pair_flags{flags.Subset(pair_positions)};
+      const ShareWrapper odd_flags{pair_flags & level_take_odd[level]};
+      std::vector<ShareWrapper> parts{pair_flags ^ odd_flags, odd_flags};
+      if (size % 2 == 1) parts.emplace_back(flags.Subset(std::vector{number_of_pairs}));
+      // the parts hold the even records, the odd records and the left over record
+      std::vector<std::size_t> order(size);
+      for (std::size_t i = 0; i < size; ++i) {
+        order[i] = i % 2 == 0 ? i / 2 : number_of_pairs + i / 2;
+      }
+      flags = ShareWrapper::Simdify(parts).Subset(std::move(order));
+    }
+    alive ^= flags;
+  }
+  return {ShareWrapper::Simdify(values), ShareWrapper::Simdify(positions)};
+}
+
+}  // namespace
+
+ShareWrapper MaximumSimd(const ShareWrapper& input) {
+  return LowDepthReduceSimd(
+      input, [](const ShareWrapper& a, const ShareWrapper& b) { return a.Maximum(b); });
+}
+
+ShareWrapper MinimumSimd(const ShareWrapper& input) {
+  return LowDepthReduceSimd(
+      input, [](const ShareWrapper& a, const ShareWrapper& b) { return a.Minimum(b); });
+}
+
+std::pair<ShareWrapper, ShareWrapper> ArgMaximumSimd(const ShareWrapper& input) {
+  return ArgReduce(input, true);
+}
+
+std::pair<ShareWrapper, ShareWrapper> ArgMinimumSimd(const ShareWrapper& input) {
+  return ArgReduce(input, false);
+}
+
+std::pair<ShareWrapper, ShareWrapper> TopKSimd(const ShareWrapper& input, std::size_t k) {
+  return TopKReduce(input, k, true);
+}
+
+std::pair<ShareWrapper, ShareWrapper> BottomKSimd(const ShareWrapper& input, std::size_t k) {
+  return TopKReduce(input, k, false);
+}
+
+}  // namespace encrypto::motion::algorithm
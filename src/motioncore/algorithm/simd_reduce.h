@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief reduces the SIMD values of input by operation as LowDepthReduce does for a vector of
+/// shares, but each level applies operation once to the Subsets of the SIMD values at even and at
+/// odd positions, i.e., it combines all adjacent pairs in one SIMD gate.  Reducing n SIMD values
+/// thus needs ceil(log2(n)) applications of operation instead of n - 1.  An odd SIMD value left
+/// over on a level is carried to the next one, s.t. the order of the operands is kept as in
+/// LowDepthReduce.
+/// \param operation takes and returns ShareWrappers with the same number of SIMD values
+/// \throws std::invalid_argument if input has no SIMD values
+template <typename BinaryOperation>
+ShareWrapper LowDepthReduceSimd(ShareWrapper input, BinaryOperation operation) {
+  std::size_t number_of_simd{input->GetNumberOfSimdValues()};
+  if (number_of_simd == 0) throw std::invalid_argument("Cannot reduce a share of 0 SIMD values");
+  while (number_of_simd > 1) {
+    std::vector<std::size_t> even, odd;
+    for (std::size_t i = 0; i + 1 < number_of_simd; i += 2) {
+      even.push_back(i);
+      odd.push_back(i + 1);
+    }
+    ShareWrapper combined{operation(input.Subset(even), input.Subset(odd))};
+    if (number_of_simd % 2 == 1) {
+      combined = ShareWrapper::Simdify(
+          std::vector{combined, input.Subset(std::vector<std::size_t>{number_of_simd - 1})});
+    }
+    input = std::move(combined);
+    number_of_simd = (number_of_simd + 1) / 2;
+  }
+  return input;
+}
+
+/// \brief returns the largest SIMD value of input, see ShareWrapper::Maximum and
+/// LowDepthReduceSimd.
+ShareWrapper MaximumSimd(const ShareWrapper& input);
+
+/// \brief returns the smallest SIMD value of input, see ShareWrapper::Minimum and
+/// LowDepthReduceSimd.
+ShareWrapper MinimumSimd(const ShareWrapper& input);
+
+/// \brief returns the largest SIMD value of input as unsigned integers and its position, whose
+/// max(1, ceil(log2(n))) wires, least significant bit first, are the comparison results of the
+/// levels of LowDepthReduceSimd, i.e., no input of the positions is needed.  Of equal values, the
+/// first one is chosen.
+/// \param input Boolean share of 8, 16, 32 or 64 bits
+/// \throws std::invalid_argument for arithmetic shares
+std::pair<ShareWrapper, ShareWrapper> ArgMaximumSimd(const ShareWrapper& input);
+
+/// \brief returns the smallest SIMD value of input and its position, see ArgMaximumSimd.
+std::pair<ShareWrapper, ShareWrapper> ArgMinimumSimd(const ShareWrapper& input);
+
+/// \brief returns the k largest SIMD values of input in descending order and their positions as k
+/// SIMD values each, see ArgMaximumSimd.  Each of the k tournaments of ArgMaximumSimd is followed
+/// by one AND per node of its tournament tree, which marks the winner that drops out of the next
+/// tournament, i.e., k (n - 1) comparisons instead of the n log^2 n of a sorting network.  Of
+/// equal values, the first one is chosen first.
+/// \param input Boolean share of 8, 16, 32 or 64 bits
+/// \throws std::invalid_argument for arithmetic shares or if k is 0 or exceeds the SIMD values
+std::pair<ShareWrapper, ShareWrapper> TopKSimd(const ShareWrapper& input, std::size_t k);
+
+/// \brief returns the k smallest SIMD values of input in ascending order and their positions, see
+/// TopKSimd.
+std::pair<ShareWrapper, ShareWrapper> BottomKSimd(const ShareWrapper& input, std::size_t k);
+
+}  // namespace encrypto::motion::algorithm
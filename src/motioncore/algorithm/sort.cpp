@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sort.h"
+
+#include <bit>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "protocols/share.h"
+#include "secure_type/secure_unsigned_integer.h"
+
+namespace encrypto::motion::algorithm {
+
+namespace {
+
+// pairs of positions of a layer of the bitonic sorting network on size = 2^k positions, where the
+// minimum goes to the first position.  Each merge starts by comparing mirrored positions, s.t. all
+// pairs have the same direction and the positions from number_of_simd on can act as the maximum.
+std::vector<std::vector<std::pair<std::size_t, std::size_t>>> BitonicLayers(
+    std::size_t number_of_simd) {
+  const std::size_t size{std::bit_ceil(number_of_simd)};
+  std::vector<std::vector<std::pair<std::size_t, std::size_t>>> layers;
+  const auto add_pair = [number_of_simd](auto& layer, std::size_t first, std::size_t second) {
+    // comparisons with the padding never swap
+    if (second < number_of_simd) layer.emplace_back(first, second);
+  };
+  for (std::size_t block = 2; block <= size; block *= 2) {
+    auto& mirrored{layers.emplace_back()};
+    for (std::size_t start = 0; start < size; start += block) {
+      for (std::size_t i = 0; i < block / 2; ++i) {
+        add_pair(mirrored, start + i, start + block - 1 - i);
+      }
+    }
+    for (std::size_t distance = block / 4; distance > 0; distance /= 2) {
+      auto& layer{layers.emplace_back()};
+      for (std::size_t start = 0; start < size; start += 2 * distance) {
+        for (std::size_t i = 0; i < distance; ++i) add_pair(layer, start + i, start + i + distance);
+      }
+    }
+  }
+  return layers;
+}
+
+// sorts the SIMD values of all shares by the SIMD values of shares[0]
+std::vector<ShareWrapper> BitonicSort(std::vector<ShareWrapper> shares) {
+  const auto& keys{shares.at(0)};
+  const MpcProtocol protocol{keys->GetProtocol()};
+  if (protocol != MpcProtocol::kBooleanGmw && protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Sorting does not support protocol {}", to_string(protocol)));
+  }
+  const std::size_t number_of_simd{keys->GetNumberOfSimdValues()};
+  for (const auto& share : shares) {
+    if (share->GetProtocol() != protocol || share->GetNumberOfSimdValues() != number_of_simd) {
+      throw std::invalid_argument(
+          "Sorted shares need the same protocol and number of SIMD values as the keys");
+    }
+  }
+  if (number_of_simd == 1) return shares;
+
+  // order[p] is the SIMD value of the shares that holds network position p
+  std::vector<std::size_t> order(number_of_simd);
+  for (std::size_t i = 0; i < number_of_simd; ++i) order[i] = i;
+  std::vector<bool> is_compared(number_of_simd);
+  for (const auto& layer : BitonicLayers(number_of_simd)) {
+    if (layer.empty()) continue;
+    std::vector<std::size_t> first, second, rest;
+    std::fill(is_compared.begin(), is_compared.end(), false);
+    for (const auto& [p, q] : layer) {
+      first.emplace_back(order[p]);
+      second.emplace_back(order[q]);
+      is_compared[p] = is_compared[q] = true;
+    }
+    for (std::size_t p = 0; p < number_of_simd; ++p) {
+      if (!is_compared[p]) rest.emplace_back(order[p]);
+    }
+
+    std::vector<ShareWrapper> firsts, seconds;
+    for (auto& share : shares) {
+      firsts.emplace_back(share.Subset(first));
+      seconds.emplace_back(share.Subset(second));
+    }
+    const ShareWrapper swap{SecureUnsignedInteger(firsts[0]) > SecureUnsignedInteger(seconds[0])};
+    for (std::size_t i = 0; i < shares.size(); ++i) {
+      // a, b <- swap ? b : a, swap ? a : b
+      const auto difference{
+          ShareWrapper::Concatenate(std::vector<ShareWrapper>(shares[i]->GetBitLength(), swap)) &
+          (firsts[i] ^ seconds[i])};
+      std::vector<ShareWrapper> parts{firsts[i] ^ difference, seconds[i] ^ difference};
+      if (!rest.empty()) parts.emplace_back(shares[i].Subset(rest));
+      shares[i] = ShareWrapper::Simdify(parts);
+    }
+
+    std::size_t position{0};
+    for (const auto& [p, q] : layer) order[p] = position++;
+    for (const auto& [p, q] : layer) order[q] = position++;
+    for (std::size_t p = 0; p < number_of_simd; ++p) {
+      if (!is_compared[p]) order[p] = position++;
+    }
+  }
+  for (auto& share : shares) share = share.Subset(order);
+  return shares;
+}
+
+}  // namespace
+
+ShareWrapper Sort(const ShareWrapper& keys) { return BitonicSort({keys}).at(0); }
+
+std::pair<ShareWrapper, ShareWrapper> SortBy(const ShareWrapper& keys, const ShareWrapper& values) {
+  auto sorted{BitonicSort({keys, values})};
+  return {sorted.at(0), sorted.at(1)};
+}
+
+}  // namespace encrypto::motion::algorithm
@@ -0,0 +1,48 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <utility>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion::algorithm {
+
+/// \brief sorts the SIMD values of keys in ascending order as unsigned integers by a bitonic
+/// sorting network.  Each of the log n (log n + 1) / 2 layers of compare-exchanges is evaluated as
+/// one SIMD comparison circuit of SecureUnsignedInteger on all of its pairs, which are gathered by
+/// Subset and reassembled by Simdify.  The sorting is not stable.
+/// \param keys Boolean GMW or BMR share of 8, 16, 32 or 64 bits
+/// \throws std::invalid_argument for other protocols
+ShareWrapper Sort(const ShareWrapper& keys);
+
+/// \brief sorts the SIMD values of keys and values by keys, see Sort.
+/// \param values share of the same protocol and number of SIMD values as keys with any number of
+/// wires that is moved along with its keys
+/// \returns the sorted keys and the values in the order of the sorted keys
+/// \throws std::invalid_argument if keys and values do not fit
+std::pair<ShareWrapper, ShareWrapper> SortBy(const ShareWrapper& keys, const ShareWrapper& values);
+
+}  // namespace encrypto::motion::algorithm
@@ -28,6 +28,7 @@
 #include "motion_base_provider.h"
 
 #include <boost/log/trivial.hpp>
+#include <array>
 #include <chrono>
 #include <functional>
 #include <future>
@@ -38,17 +39,21 @@
 
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "communication/tcp_transport.h"
 #include "configuration.h"
 #include "data_storage/base_ot_data.h"
 #include "executor/gate_executor.h"
 #include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/preprocessing_store.h"
 #include "multiplication_triple/sb_provider.h"
 #include "multiplication_triple/sp_provider.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 #include "oblivious_transfer/ot_provider.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_provider.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/astra/astra_gate.h"
+#include "protocols/astra/astra_provider.h"
 #include "protocols/astra/astra_share.h"
 #include "protocols/bmr/bmr_gate.h"
 #include "protocols/bmr/bmr_provider.h"
@@ -59,8 +64,13 @@
 #include "protocols/garbled_circuit/garbled_circuit_gate.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
 #include "protocols/garbled_circuit/garbled_circuit_share.h"
+#include "protocols/output_batcher.h"
+#include "protocols/replicated/replicated_gate.h"
+#include "protocols/replicated/replicated_share.h"
+#include "compiled_circuit.h"
 #include "register.h"
 #include "statistics/run_time_statistics.h"
+#include "trusted_dealer/trusted_dealer.h"
 #include "utility/constants.h"
 
 using namespace std::chrono_literals;
@@ -75,37 +85,71 @@ Backend::Backend(std::unique_ptr<communication::CommunicationLayer> communicatio
       configuration_(configuration),
       register_(std::make_shared<Register>(logger_)),
       gate_executor_(std::make_unique<GateExecutor>(
-          *register_, [this] { RunPreprocessing(); }, logger_)) {
+          *register_, [this] { RunPreprocessing(); }, logger_, configuration_)) {
   motion_base_provider_ = std::make_unique<BaseProvider>(*communication_layer_);
   base_ot_provider_ = std::make_unique<BaseOtProvider>(*communication_layer_);
   communication_layer_->SetLogger(logger_);
+  MakeOtBasedProviders();
+  arithmetic_gmw_provider_ =
+      std::make_unique<proto::arithmetic_gmw::Provider>(*communication_layer_);
+  output_batcher_ = std::make_unique<proto::OutputBatcher>(*communication_layer_);
+
+  // TODO should probably throw if it has been already started
+  communication_layer_->Start();
+}
+
+Backend::~Backend() {}
+
+void Backend::MakeOtBasedProviders() {
   auto my_id = communication_layer_->GetMyId();
 
   ot_provider_manager_ = std::make_unique<OtProviderManager>(
       *communication_layer_, *base_ot_provider_, *motion_base_provider_);
 
-  kk13_ot_provider_manager_ = std::make_unique<Kk13OtProviderManager>(
-      *communication_layer_, *base_ot_provider_, *motion_base_provider_);
-
-  mt_provider_ = std::make_shared<MtProviderFromOts>(ot_provider_manager_->GetProviders(), my_id,
-                                                     logger, run_time_statistics_.back());
+  mt_provider_ = std::make_shared<MtProviderFromOts>(*communication_layer_,
+                                                     ot_provider_manager_->GetProviders(), my_id,
+                                                     logger_, run_time_statistics_.back());
   sp_provider_ = std::make_shared<SpProviderFromOts>(ot_provider_manager_->GetProviders(), my_id,
-                                                     logger, run_time_statistics_.back());
-  sb_provider_ = std::make_shared<SbProviderFromSps>(*communication_layer_, sp_provider_, logger,
+                                                     logger_, run_time_statistics_.back());
+  sb_provider_ = std::make_shared<SbProviderFromSps>(*communication_layer_, sp_provider_, logger_,
                                                      run_time_statistics_.back());
-  bmr_provider_ = std::make_unique<proto::bmr::Provider>(*communication_layer_);
-  if (communication_layer_->GetNumberOfParties() == 2) {
-    garbled_circuit_provider_ =
-        proto::garbled_circuit::Provider::MakeProvider(*communication_layer_);
-  }
+}
 
-  // TODO should probably throw if it has been already started
-  communication_layer_->Start();
+const LoggerPointer& Backend::GetLogger() const noexcept { return logger_; }
+
+proto::astra::Provider& Backend::GetAstraProvider() {
+  return astra_provider_.Get(
+      [this] { return std::make_unique<proto::astra::Provider>(*communication_layer_); });
 }
 
-Backend::~Backend() {}
+proto::bmr::Provider& Backend::GetBmrProvider() {
+  return bmr_provider_.Get(
+      [this] { return std::make_unique<proto::bmr::Provider>(*communication_layer_); });
+}
 
-const LoggerPointer& Backend::GetLogger() const noexcept { return logger_; }
+proto::garbled_circuit::Provider& Backend::GetGarbledCircuitProvider() {
+  return garbled_circuit_provider_.Get([this] {
+    if (communication_layer_->GetNumberOfParties() != 2) {
+      throw std::logic_error(
+          fmt::format("Garbled circuits need exactly 2 parties, but there are {}",
+                      communication_layer_->GetNumberOfParties()));
+    }
+    return proto::garbled_circuit::Provider::MakeProvider(*communication_layer_, configuration_);
+  });
+}
+
+Kk13OtProviderManager& Backend::GetKk13OtProviderManager() {
+  return kk13_ot_provider_manager_.Get([this] {
+    return std::make_unique<Kk13OtProviderManager>(*communication_layer_, *base_ot_provider_,
+                                                   *motion_base_provider_);
+  });
+}
+
+bool Backend::OtExtensionsHaveWork() {
+  const auto kk13_ot_provider_manager{kk13_ot_provider_manager_.Find()};
+  return ot_provider_manager_->HasWork() ||
+         (kk13_ot_provider_manager && kk13_ot_provider_manager->HasWork());
+}
 
 void Backend::RunPreprocessing() {
   logger_->LogInfo("Start preprocessing");
@@ -114,30 +158,78 @@ void Backend::RunPreprocessing() {
   // TODO: should this be measured?
   motion_base_provider_->Setup();
 
+  ot_provider_manager_->SetSilentOtExtension(configuration_->GetSilentOtExtension());
+  if (const auto chunk_size{configuration_->GetOtExtensionChunkSize()}; chunk_size > 0) {
+    ot_provider_manager_->SetOtExtensionChunkSize(chunk_size);
+  }
+  if (configuration_->GetPaillierMts()) {
+    if (auto mt_provider{std::dynamic_pointer_cast<MtProviderFromOts>(mt_provider_)}) {
+      mt_provider->SetPaillierMts();
+    }
+  }
+
+  if (const auto& cpus{configuration_->GetCommunicationThreadAffinity()}; !cpus.empty()) {
+    communication_layer_->SetThreadAffinity(cpus);
+  }
+  communication_layer_->SetMessageDispatchThread(configuration_->GetMessageDispatchThread());
+  communication_layer_->SetMessageVerification(configuration_->GetMessageVerification());
+  for (auto message_type : configuration_->GetCompressedMessageTypes()) {
+    communication_layer_->SetMessageCompression(message_type);
+  }
+  communication_layer_->SetBroadcastHub(configuration_->GetBroadcastHub());
+  communication_layer_->SetSynchronizationMode(configuration_->GetSynchronizationMode());
+  communication_layer_->SetRoundTripTime(configuration_->GetNetworkRoundTripTime());
+
   // TODO: design and implement a dependency manager that automatically arranges and runs
   // components depending on their dependencies
   // SB needs SP
   // SP needs OT
   // MT needs OT
 
-  const bool needs_mts = mt_provider_->NeedMts();
-  if (needs_mts) {
-    mt_provider_->PreSetup();
+  const bool fake_preprocessing{configuration_->GetInsecureFakePreprocessingSeed().has_value()};
+  if (!trusted_dealer_client_ && !fake_preprocessing &&
+      !configuration_->GetTrustedDealerHost().empty()) {
+    trusted_dealer_client_ =
+        std::make_unique<TrustedDealerClient>(communication::TcpConnectToServer(
+            communication_layer_->GetMyId(),
+            {configuration_->GetTrustedDealerHost(), configuration_->GetTrustedDealerPort()}));
   }
-  const bool needs_sbs = sb_provider_->NeedSbs();
-  if (needs_sbs) {
-    sb_provider_->PreSetup();
+  const bool use_trusted_dealer{trusted_dealer_client_ != nullptr || fake_preprocessing};
+
+  const auto& input_path{configuration_->GetPreprocessingInputPath()};
+  const bool load_preprocessing{!input_path.empty()};
+  if (load_preprocessing) {
+    logger_->LogInfo("Load MTs, SPs and SBs from {}", input_path);
+    PreprocessingReader reader(input_path, communication_layer_->GetMyId(),
+                               communication_layer_->GetNumberOfParties());
+    mt_provider_->Load(reader);
+    sp_provider_->Load(reader);
+    sb_provider_->Load(reader);
   }
-  const bool needs_sps = sp_provider_->NeedSps();
-  if (needs_sps) {
-    sp_provider_->PreSetup();
+  if (use_trusted_dealer) {
+    // the OTs of the trusted dealer replace the OT extension
+    RequestTrustedDealer(!load_preprocessing);
+  } else if (!load_preprocessing) {
+    const bool needs_mts = mt_provider_->NeedMts();
+    if (needs_mts) {
+      mt_provider_->PreSetup();
+    }
+    const bool needs_sbs = sb_provider_->NeedSbs();
+    if (needs_sbs) {
+      sb_provider_->PreSetup();
+    }
+    const bool needs_sps = sp_provider_->NeedSps();
+    if (needs_sps) {
+      sp_provider_->PreSetup();
+    }
   }
 
-  if (kk13_ot_provider_manager_->HasWork()) {
-    kk13_ot_provider_manager_->PreSetup();
+  if (auto kk13_ot_provider_manager{kk13_ot_provider_manager_.Find()};
+      kk13_ot_provider_manager && kk13_ot_provider_manager->HasWork()) {
+    kk13_ot_provider_manager->PreSetup();
   }
 
-  if (ot_provider_manager_->HasWork()) {
+  if (ot_provider_manager_->HasWork() && !use_trusted_dealer) {
     ot_provider_manager_->PreSetup();
   }
 
@@ -151,18 +243,21 @@ void Backend::RunPreprocessing() {
     base_ot_provider_->ComputeBaseOts();
   }
 
-  if (ot_provider_manager_->HasWork() || kk13_ot_provider_manager_->HasWork()) {
+  if (OtExtensionsHaveWork()) {
     OtExtensionSetup();
   }
 
   std::vector<std::future<void>> futures;
   futures.reserve(4);
-  futures.emplace_back(std::async(std::launch::async, [this] { mt_provider_->Setup(); }));
-  futures.emplace_back(std::async(std::launch::async, [this] { sp_provider_->Setup(); }));
-  futures.emplace_back(std::async(std::launch::async, [this] { sb_provider_->Setup(); }));
-  if (garbled_circuit_provider_ && garbled_circuit_provider_->HasWork()) {
-    futures.emplace_back(
-        std::async(std::launch::async, [this] { garbled_circuit_provider_->Setup(); }));
+  if (!load_preprocessing && !use_trusted_dealer) {
+    futures.emplace_back(std::async(std::launch::async, [this] { mt_provider_->Setup(); }));
+    futures.emplace_back(std::async(std::launch::async, [this] { sp_provider_->Setup(); }));
+    futures.emplace_back(std::async(std::launch::async, [this] { sb_provider_->Setup(); }));
+  }
+  if (auto garbled_circuit_provider{garbled_circuit_provider_.Find()};
+      garbled_circuit_provider && garbled_circuit_provider->HasWork()) {
+    futures.emplace_back(std::async(
+        std::launch::async, [garbled_circuit_provider] { garbled_circuit_provider->Setup(); }));
   }
 
   for (auto& f : futures) {
@@ -170,22 +265,190 @@ void Backend::RunPreprocessing() {
     f.get();
   }
 
+  const auto& output_path{configuration_->GetPreprocessingOutputPath()};
+  if (!output_path.empty() && !load_preprocessing) {
+    logger_->LogInfo("Store MTs, SPs and SBs to {}", output_path);
+    PreprocessingWriter writer(output_path, communication_layer_->GetMyId(),
+                               communication_layer_->GetNumberOfParties());
+    mt_provider_->Save(writer);
+    sp_provider_->Save(writer);
+    sb_provider_->Save(writer);
+    writer.Close();
+  }
+
   run_time_statistics_.back().RecordEnd<RunTimeStatistics::StatisticsId::kPreprocessing>();
 }
 
+void Backend::RequestTrustedDealer(bool with_mts_sps_sbs) {
+  const std::size_t my_id{communication_layer_->GetMyId()};
+  const std::size_t number_of_parties{communication_layer_->GetNumberOfParties()};
+  DealerRequest request;
+  request.my_id = my_id;
+  request.number_of_parties = number_of_parties;
+  if (with_mts_sps_sbs) {
+    request.number_of_mts = {
+        mt_provider_->GetNumberOfMts<bool>(), mt_provider_->GetNumberOfMts<std::uint8_t>(),
+        mt_provider_->GetNumberOfMts<std::uint16_t>(),
+        mt_provider_->GetNumberOfMts<std::uint32_t>(),
+        mt_provider_->GetNumberOfMts<std::uint64_t>()};
+    request.number_of_sps = {
+        sp_provider_->GetNumberOfSps<std::uint8_t>(), sp_provider_->GetNumberOfSps<std::uint16_t>(),
+        sp_provider_->GetNumberOfSps<std::uint32_t>(),
+        sp_provider_->GetNumberOfSps<std::uint64_t>(), sp_provider_->GetNumberOfSps<__uint128_t>()};
+    request.number_of_sbs = {
+        sb_provider_->GetNumberOfSbs<std::uint8_t>(), sb_provider_->GetNumberOfSbs<std::uint16_t>(),
+        sb_provider_->GetNumberOfSbs<std::uint32_t>(),
+        sb_provider_->GetNumberOfSbs<std::uint64_t>()};
+  }
+  request.number_of_ots_sender.resize(number_of_parties);
+  request.number_of_ots_receiver.resize(number_of_parties);
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    if (i == my_id) continue;
+    request.number_of_ots_sender[i] = ot_provider_manager_->GetProvider(i).GetNumOtsSender();
+    request.number_of_ots_receiver[i] = ot_provider_manager_->GetProvider(i).GetNumOtsReceiver();
+  }
+
+  DealerCorrelations correlations;
+  if (const auto& seed{configuration_->GetInsecureFakePreprocessingSeed()}) {
+    logger_->LogInfo("INSECURE: generate the preprocessing material locally from a shared seed");
+    const std::array<std::uint64_t, 2> run_seed{*seed, number_of_fake_preprocessing_runs_++};
+    correlations = MakeInsecureFakeCorrelations(
+        request, Block128::MakeFromMemory(reinterpret_cast<const std::byte*>(run_seed.data())));
+  } else {
+    logger_->LogInfo("Request the preprocessing material from the trusted dealer");
+    correlations = trusted_dealer_client_->Request(request);
+  }
+  if (with_mts_sps_sbs) {
+    mt_provider_->SetMts(std::move(correlations.bit_mts), std::move(correlations.mts_8),
+                         std::move(correlations.mts_16), std::move(correlations.mts_32),
+                         std::move(correlations.mts_64));
+    sp_provider_->SetSps(std::move(correlations.sps_8), std::move(correlations.sps_16),
+                         std::move(correlations.sps_32), std::move(correlations.sps_64),
+                         std::move(correlations.sps_128));
+    sb_provider_->SetSbs(std::move(correlations.sbs_8), std::move(correlations.sbs_16),
+                         std::move(correlations.sbs_32), std::move(correlations.sbs_64));
+  }
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    if (i == my_id) continue;
+    auto& provider{dynamic_cast<OtProviderFromOtExtension&>(ot_provider_manager_->GetProvider(i))};
+    auto& ots{correlations.ots[i]};
+    if (request.number_of_ots_sender[i] > 0) {
+      provider.SetSenderCorrelations(ots.delta, std::move(ots.sender_ots));
+    }
+    if (request.number_of_ots_receiver[i] > 0) {
+      provider.SetReceiverCorrelations(std::move(ots.choices), std::move(ots.receiver_ots));
+    }
+  }
+}
+
+void Backend::SetTrustedDealer(std::unique_ptr<communication::Transport> transport) {
+  trusted_dealer_client_ = std::make_unique<TrustedDealerClient>(std::move(transport));
+}
+
 void Backend::EvaluateSequential() {
   gate_executor_->EvaluateSetupOnline(run_time_statistics_.back());
 }
 
 void Backend::EvaluateParallel() { gate_executor_->Evaluate(run_time_statistics_.back()); }
 
+void Backend::EvaluateLayered() {
+  gate_executor_->EvaluateLayered(run_time_statistics_.back());
+}
+
+void Backend::EvaluateDataflow() { gate_executor_->EvaluateDataflow(run_time_statistics_.back()); }
+
 const GatePointer& Backend::GetGate(std::size_t gate_id) const {
   return register_->GetGate(gate_id);
 }
 
-void Backend::Reset() { register_->Reset(); }
+CompiledCircuit& Backend::Compile(std::vector<std::size_t> instance_offsets,
+                                  std::size_t number_of_instances_in_flight) {
+  if (compiled_circuit_) {
+    throw std::logic_error("The circuit was already compiled");
+  }
+  // the multiplication gates of a batched opening wait for each other
+  if (arithmetic_gmw_provider_->GetOpeningBatching() &&
+      (configuration_->GetDeadGateElimination() || number_of_instances_in_flight > 0)) {
+    throw std::logic_error(
+        "Batched arithmetic GMW openings need all gates of a layer to be evaluated concurrently");
+  }
+  if (output_batcher_->GetOutputBatching() &&
+      (configuration_->GetDeadGateElimination() || number_of_instances_in_flight > 0)) {
+    throw std::logic_error(
+        "Batched outputs need all output gates of a layer to be evaluated concurrently");
+  }
+  compiled_circuit_ = std::make_unique<CompiledCircuit>(*register_, std::move(instance_offsets),
+                                                        number_of_instances_in_flight);
+  return *compiled_circuit_;
+}
+
+void Backend::EvaluateCompiled() {
+  if (!compiled_circuit_) {
+    throw std::logic_error("The circuit needs to be compiled before EvaluateCompiled");
+  }
+  gate_executor_->EvaluateDataflow(*compiled_circuit_, run_time_statistics_.back());
+}
+
+void Backend::Reset() {
+  compiled_circuit_.reset();
+  register_->Reset();
+  arithmetic_gmw_provider_->Reset();
+  output_batcher_->Reset();
+  if (auto garbled_circuit_provider{garbled_circuit_provider_.Find()}) {
+    garbled_circuit_provider->Reset();
+  }
+
+  // the OT extension and the MTs, SPs and SBs generated from it count the requests of the gates
+  // that were just destroyed, so they are constructed anew
+  sb_provider_.reset();
+  sp_provider_.reset();
+  mt_provider_.reset();
+  kk13_ot_provider_manager_.Reset();
+  ot_provider_manager_.reset();
+  // the next run resumes the base OTs with fresh nonces instead of recomputing them
+  const std::size_t my_id{communication_layer_->GetMyId()};
+  if (base_ot_provider_->HasWork()) {
+    resumable_base_ots_.resize(communication_layer_->GetNumberOfParties());
+    for (std::size_t party_id = 0; party_id < resumable_base_ots_.size(); ++party_id) {
+      if (party_id != my_id) {
+        resumable_base_ots_[party_id] = base_ot_provider_->ExportBaseOts(party_id);
+      }
+    }
+  }
+  base_ot_provider_ = std::make_unique<BaseOtProvider>(*communication_layer_);
+  for (std::size_t party_id = 0; party_id < resumable_base_ots_.size(); ++party_id) {
+    if (party_id == my_id) continue;
+    base_ot_provider_->ImportBaseOts(party_id, resumable_base_ots_[party_id].first);
+    base_ot_provider_->ImportBaseOts(party_id, resumable_base_ots_[party_id].second);
+  }
+  MakeOtBasedProviders();
+}
+
+void Backend::Clear() {
+  if (compiled_circuit_) {
+    ClearPreprocessing();
+  }
+  register_->Clear();
+  if (auto garbled_circuit_provider{garbled_circuit_provider_.Find()}) {
+    garbled_circuit_provider->Clear();
+  }
+}
 
-void Backend::Clear() { register_->Clear(); }
+void Backend::ClearPreprocessing() {
+  // the 1-out-of-N OT extension cannot extend its OTs anew yet
+  if (auto kk13_ot_provider_manager{kk13_ot_provider_manager_.Find()};
+      kk13_ot_provider_manager && kk13_ot_provider_manager->HasWork()) {
+    throw std::logic_error("Compiled circuits using 1-out-of-N OTs cannot be re-run");
+  }
+  // the MTs, SPs and SBs are generated anew or loaded from the rest of the preprocessing file
+  mt_provider_->Clear();
+  sp_provider_->Clear();
+  sb_provider_->Clear();
+  // the gates and providers keep the offsets of their OTs, which are extended anew from the base
+  // OTs resumed with fresh nonces
+  ot_provider_manager_->Clear();
+  base_ot_provider_->Clear();
+}
 
 SharePointer Backend::BooleanGmwInput(std::size_t party_id, bool input) {
   return BooleanGmwInput(party_id, BitVector(1, input));
@@ -299,6 +562,25 @@ template SharePointer Backend::ArithmeticGmwInput<std::uint64_t>(
 template SharePointer Backend::ArithmeticGmwInput<__uint128_t>(std::size_t party_id,
                                                                std::vector<__uint128_t>&& input);
 
+template <typename T>
+SharePointer Backend::RandomArithmeticShare(std::size_t number_of_simd) {
+  auto random_gate =
+      register_->EmplaceGate<proto::arithmetic_gmw::RandomGate<T>>(number_of_simd, *this);
+  return std::static_pointer_cast<Share>(random_gate->GetOutputAsArithmeticShare());
+}
+
+template SharePointer Backend::RandomArithmeticShare<std::uint8_t>(std::size_t number_of_simd);
+template SharePointer Backend::RandomArithmeticShare<std::uint16_t>(std::size_t number_of_simd);
+template SharePointer Backend::RandomArithmeticShare<std::uint32_t>(std::size_t number_of_simd);
+template SharePointer Backend::RandomArithmeticShare<std::uint64_t>(std::size_t number_of_simd);
+template SharePointer Backend::RandomArithmeticShare<__uint128_t>(std::size_t number_of_simd);
+
+SharePointer Backend::RandomBooleanShare(std::size_t number_of_simd, std::size_t number_of_wires) {
+  const auto random_gate = register_->EmplaceGate<proto::boolean_gmw::RandomGate>(
+      number_of_wires, number_of_simd, *this);
+  return std::static_pointer_cast<Share>(random_gate->GetOutputAsGmwShare());
+}
+
 template <typename T>
 SharePointer Backend::ArithmeticGmwOutput(const proto::arithmetic_gmw::SharePointer<T>& parent,
                                           std::size_t output_owner) {
@@ -405,6 +687,87 @@ template SharePointer Backend::AstraOutput<std::uint64_t>(const SharePointer& pa
 template SharePointer Backend::AstraOutput<__uint128_t>(const SharePointer& parent,
                                                         std::size_t output_owner);
 
+template <typename T>
+SharePointer Backend::AstraMatrixMultiplication(const SharePointer& a, const SharePointer& b,
+                                                std::size_t number_of_rows,
+                                                std::size_t number_of_columns) {
+  assert(a);
+  assert(b);
+  assert(a->GetProtocol() == MpcProtocol::kAstra && b->GetProtocol() == MpcProtocol::kAstra);
+  auto gate = register_->EmplaceGate<proto::astra::MatrixMultiplicationGate<T>>(
+      a->GetWires(), b->GetWires(), number_of_rows, number_of_columns);
+  return std::static_pointer_cast<Share>(gate->GetOutputAsAstraShare());
+}
+
+template SharePointer Backend::AstraMatrixMultiplication<std::uint8_t>(
+    const SharePointer& a, const SharePointer& b, std::size_t number_of_rows,
+    std::size_t number_of_columns);
+template SharePointer Backend::AstraMatrixMultiplication<std::uint16_t>(
+    const SharePointer& a, const SharePointer& b, std::size_t number_of_rows,
+    std::size_t number_of_columns);
+template SharePointer Backend::AstraMatrixMultiplication<std::uint32_t>(
+    const SharePointer& a, const SharePointer& b, std::size_t number_of_rows,
+    std::size_t number_of_columns);
+template SharePointer Backend::AstraMatrixMultiplication<std::uint64_t>(
+    const SharePointer& a, const SharePointer& b, std::size_t number_of_rows,
+    std::size_t number_of_columns);
+template SharePointer Backend::AstraMatrixMultiplication<__uint128_t>(
+    const SharePointer& a, const SharePointer& b, std::size_t number_of_rows,
+    std::size_t number_of_columns);
+
+template <typename T>
+SharePointer Backend::ArithmeticReplicatedInput(std::size_t party_id, std::vector<T> input) {
+  auto input_gate = register_->EmplaceGate<proto::replicated::ArithmeticInputGate<T>>(
+      std::move(input), party_id, *this);
+  return std::static_pointer_cast<Share>(input_gate->GetOutputAsReplicatedShare());
+}
+
+template SharePointer Backend::ArithmeticReplicatedInput<std::uint8_t>(
+    std::size_t party_id, std::vector<std::uint8_t> input);
+template SharePointer Backend::ArithmeticReplicatedInput<std::uint16_t>(
+    std::size_t party_id, std::vector<std::uint16_t> input);
+template SharePointer Backend::ArithmeticReplicatedInput<std::uint32_t>(
+    std::size_t party_id, std::vector<std::uint32_t> input);
+template SharePointer Backend::ArithmeticReplicatedInput<std::uint64_t>(
+    std::size_t party_id, std::vector<std::uint64_t> input);
+template SharePointer Backend::ArithmeticReplicatedInput<__uint128_t>(
+    std::size_t party_id, std::vector<__uint128_t> input);
+
+template <typename T>
+SharePointer Backend::ArithmeticReplicatedOutput(const SharePointer& parent,
+                                                 std::size_t output_owner) {
+  assert(parent);
+  auto output_gate =
+      register_->EmplaceGate<proto::replicated::ArithmeticOutputGate<T>>(parent, output_owner);
+  return std::static_pointer_cast<Share>(output_gate->GetOutputAsReplicatedShare());
+}
+
+template SharePointer Backend::ArithmeticReplicatedOutput<std::uint8_t>(
+    const SharePointer& parent, std::size_t output_owner);
+template SharePointer Backend::ArithmeticReplicatedOutput<std::uint16_t>(
+    const SharePointer& parent, std::size_t output_owner);
+template SharePointer Backend::ArithmeticReplicatedOutput<std::uint32_t>(
+    const SharePointer& parent, std::size_t output_owner);
+template SharePointer Backend::ArithmeticReplicatedOutput<std::uint64_t>(
+    const SharePointer& parent, std::size_t output_owner);
+template SharePointer Backend::ArithmeticReplicatedOutput<__uint128_t>(
+    const SharePointer& parent, std::size_t output_owner);
+
+SharePointer Backend::BooleanReplicatedInput(std::size_t party_id,
+                                             std::vector<BitVector<>> input) {
+  auto input_gate = register_->EmplaceGate<proto::replicated::BooleanInputGate>(std::move(input),
+                                                                                party_id, *this);
+  return std::static_pointer_cast<Share>(input_gate->GetOutputAsReplicatedShare());
+}
+
+SharePointer Backend::BooleanReplicatedOutput(const SharePointer& parent,
+                                              std::size_t output_owner) {
+  assert(parent);
+  auto output_gate =
+      register_->EmplaceGate<proto::replicated::BooleanOutputGate>(parent, output_owner);
+  return std::static_pointer_cast<Share>(output_gate->GetOutputAsReplicatedShare());
+}
+
 SharePointer Backend::GarbledCircuitInput(std::size_t party_id,
                                           std::span<const BitVector<>> input) {
   bool is_garbler =
@@ -442,6 +805,8 @@ SharePointer Backend::GarbledCircuitOutput(const SharePointer& parent, std::size
 
 void Backend::Synchronize() { communication_layer_->Synchronize(); }
 
+void Backend::StartSynchronization() { communication_layer_->StartSynchronization(); }
+
 void Backend::ComputeBaseOts() {
   run_time_statistics_.back().RecordStart<RunTimeStatistics::StatisticsId::kBaseOts>();
   base_ot_provider_->ComputeBaseOts();
@@ -457,7 +822,8 @@ void Backend::OtExtensionSetup() {
   run_time_statistics_.back().RecordStart<RunTimeStatistics::StatisticsId::kOtExtensionSetup>();
 
   std::vector<std::future<void>> task_futures;
-  task_futures.reserve(2 * (communication_layer_->GetNumberOfParties() - 1));
+  task_futures.reserve(4 * (communication_layer_->GetNumberOfParties() - 1));
+  const auto kk13_ot_provider_manager{kk13_ot_provider_manager_.Find()};
 
   for (auto i = 0ull; i < communication_layer_->GetNumberOfParties(); ++i) {
     if (i == communication_layer_->GetMyId()) {
@@ -469,12 +835,12 @@ void Backend::OtExtensionSetup() {
       task_futures.emplace_back(std::async(
           std::launch::async, [this, i] { ot_provider_manager_->GetProvider(i).ReceiveSetup(); }));
     }
-    if (kk13_ot_provider_manager_->GetProvider(i).HasWork()) {
-      task_futures.emplace_back(std::async(std::launch::async, [this, i] {
-        kk13_ot_provider_manager_->GetProvider(i).SendSetup();
+    if (kk13_ot_provider_manager && kk13_ot_provider_manager->GetProvider(i).HasWork()) {
+      task_futures.emplace_back(std::async(std::launch::async, [kk13_ot_provider_manager, i] {
+        kk13_ot_provider_manager->GetProvider(i).SendSetup();
       }));
-      task_futures.emplace_back(std::async(std::launch::async, [this, i] {
-        kk13_ot_provider_manager_->GetProvider(i).ReceiveSetup();
+      task_futures.emplace_back(std::async(std::launch::async, [kk13_ot_provider_manager, i] {
+        kk13_ot_provider_manager->GetProvider(i).ReceiveSetup();
       }));
     }
   }
@@ -493,7 +859,7 @@ OtProvider& Backend::GetOtProvider(std::size_t party_id) {
 }
 
 Kk13OtProvider& Backend::GetKk13OtProvider(std::size_t party_id) {
-  return kk13_ot_provider_manager_->GetProvider(party_id);
+  return GetKk13OtProviderManager().GetProvider(party_id);
 }
 
 }  // namespace encrypto::motion
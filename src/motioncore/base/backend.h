@@ -24,7 +24,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 #include <flatbuffers/flatbuffers.h>
 #include <span>
@@ -37,6 +39,7 @@ static_assert(FLATBUFFERS_LITTLEENDIAN);
 namespace encrypto::motion::communication {
 
 class CommunicationLayer;
+class Transport;
 
 }  // namespace encrypto::motion::communication
 
@@ -49,12 +52,19 @@ using SharePointer = std::shared_ptr<Share>;
 
 namespace encrypto::motion::proto {
 
+namespace arithmetic_gmw {
+class Provider;
+}
+namespace astra {
+class Provider;
+}
 namespace bmr {
 class Provider;
 }
 namespace garbled_circuit {
 class Provider;
 }
+class OutputBatcher;
 
 }  // namespace encrypto::motion::proto
 
@@ -85,6 +95,7 @@ class GarbledCircuitProvider;
 class MtProvider;
 class SpProvider;
 class SbProvider;
+class TrustedDealerClient;
 
 struct RunTimeStatistics;
 
@@ -100,6 +111,7 @@ using ConfigurationPointer = std::shared_ptr<Configuration>;
 class Register;
 using RegisterPointer = std::shared_ptr<Register>;
 
+class CompiledCircuit;
 class GateExecutor;
 
 class Backend : public std::enable_shared_from_this<Backend> {
@@ -124,12 +136,38 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   void EvaluateParallel();
 
+  void EvaluateLayered();
+
+  void EvaluateDataflow();
+
+  /// \brief Compiles the gates registered so far into a CompiledCircuit, which is evaluated by
+  /// EvaluateCompiled.  No further gates may be registered afterwards.  After Clear, the circuit
+  /// can be re-run with fresh inputs, see CompiledCircuit::SetInput, and fresh preprocessing.
+  /// \p instance_offsets and \p number_of_instances_in_flight are passed to the CompiledCircuit.
+  CompiledCircuit& Compile(std::vector<std::size_t> instance_offsets = {},
+                           std::size_t number_of_instances_in_flight = 0);
+
+  void EvaluateCompiled();
+
+  /// \brief Returns the circuit compiled by Compile or nullptr if it was not compiled.
+  CompiledCircuit* GetCompiledCircuit() const { return compiled_circuit_.get(); }
+
   const GatePointer& GetGate(std::size_t gate_id) const;
 
   const std::vector<GatePointer>& GetInputGates() const;
 
+  /// \brief Destroys all gates and wires s.t. a new circuit can be constructed and run.  The
+  /// connections and the base OTs are kept: the next run resumes the base OTs with fresh nonces,
+  /// see BaseOtProvider::ImportBaseOts, instead of recomputing them, and only runs the OT
+  /// extension and the preprocessing for the gates of the new circuit.
   void Reset();
 
+  /// \brief Prepares the gates for another evaluation.  For compiled circuits, the OTs, MTs, SPs
+  /// and SBs of the last run are discarded s.t. the next run generates fresh ones at the same
+  /// offsets, obtains them from the trusted dealer or loads them from the rest of the
+  /// preprocessing file.  The OT extension uses the base OTs of the last run with fresh nonces.
+  /// \throws std::logic_error if the compiled circuit needs 1-out-of-N OTs, which cannot be
+  ///         renewed.
   void Clear();
 
   SharePointer BooleanGmwInput(std::size_t party_id, bool input = false);
@@ -156,6 +194,16 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   SharePointer BmrOutput(const SharePointer& parent, std::size_t output_owner);
 
+  SharePointer ConstantBooleanInput(std::span<const BitVector<>> input) {
+    return ConstantBooleanInput(std::vector<BitVector<>>(input.begin(), input.end()));
+  }
+
+  SharePointer ConstantBooleanInput(std::vector<BitVector<>>&& input) {
+    auto input_gate =
+        register_->EmplaceGate<proto::ConstantBooleanInputGate>(std::move(input), *this);
+    return input_gate->GetOutputAsShare();
+  }
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   SharePointer ConstantArithmeticGmwInput(T input = 0) {
     return ConstantArithmeticGmwInput({input});
@@ -191,6 +239,15 @@ class Backend : public std::enable_shared_from_this<Backend> {
   template <typename T>
   SharePointer ArithmeticGmwOutput(const SharePointer& parent, std::size_t output_owner);
 
+  /// \brief Returns an arithmetic GMW share of \p number_of_simd uniformly random values, which
+  /// are derived from the private seeds of the parties without an input round or communication.
+  template <typename T>
+  SharePointer RandomArithmeticShare(std::size_t number_of_simd);
+
+  /// \brief Returns a Boolean GMW share of \p number_of_wires wires with \p number_of_simd
+  /// uniformly random bits each, see RandomArithmeticShare.
+  SharePointer RandomBooleanShare(std::size_t number_of_simd, std::size_t number_of_wires = 1);
+
   template <typename T>
   SharePointer AstraInput(std::size_t party_id, T input = 0);
 
@@ -203,6 +260,27 @@ class Backend : public std::enable_shared_from_this<Backend> {
   template <typename T>
   SharePointer AstraOutput(const SharePointer& parent, std::size_t output_owner);
 
+  /// \brief Multiplies the matrix \p a of number_of_rows rows by the matrix \p b of
+  ///        number_of_columns columns in each SIMD value by a single ASTRA gate.
+  /// \param a ASTRA share whose wires are the entries of the first matrix in row-major order
+  /// \param b ASTRA share whose wires are the entries of the second matrix in row-major order
+  /// \return ASTRA share whose wires are the entries of the product in row-major order
+  template <typename T>
+  SharePointer AstraMatrixMultiplication(const SharePointer& a, const SharePointer& b,
+                                         std::size_t number_of_rows,
+                                         std::size_t number_of_columns);
+
+  /// \brief Creates a 3-party replicated sharing of \p input, which only matters at \p party_id.
+  template <typename T>
+  SharePointer ArithmeticReplicatedInput(std::size_t party_id, std::vector<T> input);
+
+  template <typename T>
+  SharePointer ArithmeticReplicatedOutput(const SharePointer& parent, std::size_t output_owner);
+
+  SharePointer BooleanReplicatedInput(std::size_t party_id, std::vector<BitVector<>> input);
+
+  SharePointer BooleanReplicatedOutput(const SharePointer& parent, std::size_t output_owner);
+
   SharePointer GarbledCircuitInput(std::size_t party_id, bool input = false);
 
   SharePointer GarbledCircuitInput(std::size_t party_id, const BitVector<>& input);
@@ -222,15 +300,38 @@ class Backend : public std::enable_shared_from_this<Backend> {
   /// \brief Blocking wait for synchronizing between parties. Called in Clear() and Reset()
   void Synchronize();
 
+  /// \brief Send the messages of the next Synchronize() without waiting, e.g., together with the
+  /// last messages of a phase, see CommunicationLayer::StartSynchronization
+  void StartSynchronization();
+
   void ComputeBaseOts();
 
   void OtExtensionSetup();
 
+  /// \brief Get the MTs, SPs, SBs and OTs from the trusted dealer connected via \p transport
+  /// instead of generating them with the other parties. Takes precedence over
+  /// Configuration::SetTrustedDealer.
+  void SetTrustedDealer(std::unique_ptr<communication::Transport> transport);
+
   communication::CommunicationLayer& GetCommunicationLayer() { return *communication_layer_; }
 
+  GateExecutor& GetGateExecutor() { return *gate_executor_; }
+
   BaseProvider& GetBaseProvider() { return *motion_base_provider_; }
 
-  proto::bmr::Provider& GetBmrProvider() { return *bmr_provider_; }
+  proto::arithmetic_gmw::Provider& GetArithmeticGmwProvider() { return *arithmetic_gmw_provider_; }
+
+  proto::OutputBatcher& GetOutputBatcher() { return *output_batcher_; }
+
+  // The ASTRA, BMR and garbled circuit providers and the KK13 OT extension are constructed when
+  // they are first used, s.t. circuits of other protocols neither hold their state nor run their
+  // setup.  The Find... functions return nullptr if the provider has not been constructed yet.
+
+  proto::astra::Provider& GetAstraProvider();
+
+  proto::astra::Provider* FindAstraProvider() noexcept { return astra_provider_.Find(); }
+
+  proto::bmr::Provider& GetBmrProvider();
 
   BaseOtProvider& GetBaseOtProvider() { return *base_ot_provider_; }
 
@@ -240,7 +341,11 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   Kk13OtProvider& GetKk13OtProvider(std::size_t party_id);
 
-  Kk13OtProviderManager& GetKk13OtProviderManager() { return *kk13_ot_provider_manager_; }
+  Kk13OtProviderManager& GetKk13OtProviderManager();
+
+  Kk13OtProviderManager* FindKk13OtProviderManager() noexcept {
+    return kk13_ot_provider_manager_.Find();
+  }
 
   auto& GetMtProvider() { return *mt_provider_; }
 
@@ -248,13 +353,57 @@ class Backend : public std::enable_shared_from_this<Backend> {
 
   auto& GetSbProvider() { return *sb_provider_; }
 
-  auto& GetGarbledCircuitProvider() { return *garbled_circuit_provider_; }
+  /// \throws std::logic_error if there are not exactly two parties
+  proto::garbled_circuit::Provider& GetGarbledCircuitProvider();
 
   const auto& GetRunTimeStatistics() const { return run_time_statistics_; }
 
   auto& GetMutableRunTimeStatistics() { return run_time_statistics_; }
 
  private:
+  // owns a provider that is constructed on first use, which may happen concurrently
+  template <typename T>
+  class LazyProvider {
+   public:
+    template <typename MakeFunction>
+    T& Get(MakeFunction make) {
+      if (T* provider{provider_.load(std::memory_order_acquire)}) return *provider;
+      std::scoped_lock lock(mutex_);
+      if (!owner_) {
+        owner_ = make();
+        provider_.store(owner_.get(), std::memory_order_release);
+      }
+      return *owner_;
+    }
+
+    T* Find() const noexcept { return provider_.load(std::memory_order_acquire); }
+
+    // destroys the provider, s.t. the next Get constructs a new one, must not be called
+    // concurrently with Get
+    void Reset() {
+      provider_.store(nullptr, std::memory_order_release);
+      owner_.reset();
+    }
+
+   private:
+    std::atomic<T*> provider_{nullptr};
+    std::mutex mutex_;
+    std::unique_ptr<T> owner_;
+  };
+
+  // true if the OT extension or the KK13 OT extension has OTs to generate
+  bool OtExtensionsHaveWork();
+
+  // requests the OTs and, if with_mts_sps_sbs, the MTs, SPs and SBs from the trusted dealer, or
+  // generates them locally if Configuration::GetInsecureFakePreprocessingSeed is set
+  void RequestTrustedDealer(bool with_mts_sps_sbs);
+
+  // discards the OTs, MTs, SPs and SBs of the last run of the compiled circuit
+  void ClearPreprocessing();
+
+  // constructs the OT extension providers and the MT, SP and SB providers using them
+  void MakeOtBasedProviders();
+
   std::list<RunTimeStatistics> run_time_statistics_;
 
   std::unique_ptr<communication::CommunicationLayer> communication_layer_;
@@ -262,16 +411,25 @@ class Backend : public std::enable_shared_from_this<Backend> {
   ConfigurationPointer configuration_;
   RegisterPointer register_;
   std::unique_ptr<GateExecutor> gate_executor_;
+  std::unique_ptr<CompiledCircuit> compiled_circuit_;
 
   std::unique_ptr<BaseProvider> motion_base_provider_;
   std::unique_ptr<BaseOtProvider> base_ot_provider_;
-  std::unique_ptr<proto::garbled_circuit::Provider> garbled_circuit_provider_;
+  LazyProvider<proto::garbled_circuit::Provider> garbled_circuit_provider_;
   std::unique_ptr<OtProviderManager> ot_provider_manager_;
-  std::unique_ptr<Kk13OtProviderManager> kk13_ot_provider_manager_;
+  LazyProvider<Kk13OtProviderManager> kk13_ot_provider_manager_;
   std::shared_ptr<MtProvider> mt_provider_;
   std::shared_ptr<SpProvider> sp_provider_;
   std::shared_ptr<SbProvider> sb_provider_;
-  std::unique_ptr<proto::bmr::Provider> bmr_provider_;
+  std::unique_ptr<proto::arithmetic_gmw::Provider> arithmetic_gmw_provider_;
+  std::unique_ptr<proto::OutputBatcher> output_batcher_;
+  LazyProvider<proto::astra::Provider> astra_provider_;
+  LazyProvider<proto::bmr::Provider> bmr_provider_;
+  std::unique_ptr<TrustedDealerClient> trusted_dealer_client_;
+  // number of runs with insecure fake preprocessing, s.t. each run derives fresh correlations
+  std::uint64_t number_of_fake_preprocessing_runs_{0};
+  // base OTs with each party exported by the last Reset after a run with OTs
+  std::vector<std::pair<ReceiverMessage, SenderMessage>> resumable_base_ots_;
 };
 
 using BackendPointer = std::shared_ptr<Backend>;
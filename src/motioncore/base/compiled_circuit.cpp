@@ -0,0 +1,216 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "compiled_circuit.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
+#include "protocols/boolean_gmw/boolean_gmw_gate.h"
+#include "protocols/gate.h"
+#include "protocols/wire.h"
+#include "register.h"
+
+namespace encrypto::motion {
+
+CompiledCircuit::CompiledCircuit(const Register& reg, std::vector<std::size_t> instance_offsets,
+                                 std::size_t number_of_instances_in_flight)
+    : instance_offsets_(std::move(instance_offsets)),
+      number_of_instances_in_flight_(number_of_instances_in_flight) {
+  const auto& gates{reg.GetGates()};
+  const std::size_t number_of_gates{gates.size()};
+  const std::size_t wire_id_offset{reg.GetWireIdOffset()};
+
+  if (instance_offsets_.empty()) {
+    instance_offsets_.push_back(0);
+  } else {
+    if (instance_offsets_.front() != 0) {
+      throw std::invalid_argument("The first instance of a circuit needs to start at gate 0");
+    }
+    for (std::size_t i = 1; i < instance_offsets_.size(); ++i) {
+      if (instance_offsets_[i] <= instance_offsets_[i - 1]) {
+        throw std::invalid_argument(fmt::format("Instance #{} of the circuit is empty", i - 1));
+      }
+    }
+    if (instance_offsets_.back() >= number_of_gates) {
+      throw std::invalid_argument(
+          fmt::format("Instance #{} of the circuit is empty", instance_offsets_.size() - 1));
+    }
+  }
+  instance_offsets_.push_back(number_of_gates);
+  if (number_of_instances_in_flight_ >= GetNumberOfInstances()) {
+    number_of_instances_in_flight_ = 0;
+  }
+
+  // producers_[wire_id - wire_id_offset] is the index of the first gate having the wire as output,
+  // gates that forward the wires of their parents do not become the wires' producer
+  constexpr std::size_t kNoProducer{std::numeric_limits<std::size_t>::max()};
+  std::vector<std::size_t> producers(reg.GetTotalNumberOfWires(), kNoProducer);
+
+  gates_.reserve(number_of_gates);
+  fan_in_offsets_.reserve(number_of_gates + 1);
+  fan_in_offsets_.push_back(0);
+  for (std::size_t gate_index = 0; gate_index < number_of_gates; ++gate_index) {
+    auto& gate{*gates[gate_index]};
+    gates_.push_back(&gate);
+    if (dynamic_cast<const InputGate*>(&gate) != nullptr) {
+      input_gates_.push_back(gate_index);
+    }
+
+    // the gates are registered after their parents, so edges only point to earlier gates and the
+    // graph is acyclic; wires without a producer are set from outside of the gate graph
+    const auto begin{fan_in_.size()};
+    for (const auto& wire : gate.GetParentWires()) {
+      const auto producer{producers.at(wire->GetWireId() - wire_id_offset)};
+      if (producer != kNoProducer) {
+        fan_in_.push_back(producer);
+      }
+    }
+    std::sort(fan_in_.begin() + begin, fan_in_.end());
+    fan_in_.erase(std::unique(fan_in_.begin() + begin, fan_in_.end()), fan_in_.end());
+    fan_in_offsets_.push_back(fan_in_.size());
+
+    for (const auto& wire : gate.GetOutputWires()) {
+      auto& producer{producers.at(wire->GetWireId() - wire_id_offset)};
+      if (producer == kNoProducer) {
+        producer = gate_index;
+      }
+    }
+  }
+
+  // transpose the fan-in to obtain the fan-out
+  fan_out_offsets_.assign(number_of_gates + 1, 0);
+  for (auto parent : fan_in_) {
+    ++fan_out_offsets_[parent + 1];
+  }
+  std::partial_sum(fan_out_offsets_.begin(), fan_out_offsets_.end(), fan_out_offsets_.begin());
+  fan_out_.resize(fan_in_.size());
+  std::vector<std::size_t> positions(fan_out_offsets_.begin(), fan_out_offsets_.end() - 1);
+  for (std::size_t gate_index = 0; gate_index < number_of_gates; ++gate_index) {
+    for (auto parent : GetFanIn(gate_index)) {
+      fan_out_[positions[parent]++] = gate_index;
+    }
+  }
+
+  // the helpers that each gate registered in its constructor, see Register::GetGateOwner
+  std::vector<std::vector<std::size_t>> helpers(number_of_gates);
+  for (std::size_t gate_index = 0; gate_index < number_of_gates; ++gate_index) {
+    const auto owner{reg.GetGateOwner(gate_index)};
+    if (owner != Register::kNoOwner) {
+      helpers.at(owner).push_back(gate_index);
+    }
+  }
+
+  // walk back from the output gates of the user, the parents and the helpers of a gate always
+  // have smaller indices.  Helper output gates, e.g., of the masked values of a multiplication,
+  // are only live with their owner, since they wait for wires that the owner sets
+  live_gates_.assign(number_of_gates, false);
+  for (std::size_t gate_index = number_of_gates; gate_index-- > 0;) {
+    const bool is_output{dynamic_cast<const OutputGate*>(gates_[gate_index]) != nullptr &&
+                         reg.GetGateOwner(gate_index) == Register::kNoOwner};
+    if (!live_gates_[gate_index] && !is_output) {
+      continue;
+    }
+    live_gates_[gate_index] = true;
+    ++number_of_live_gates_;
+    for (auto parent : GetFanIn(gate_index)) {
+      live_gates_[parent] = true;
+    }
+    for (auto helper : helpers[gate_index]) {
+      live_gates_[helper] = true;
+    }
+  }
+}
+
+std::size_t CompiledCircuit::GetInstance(std::size_t gate_index) const {
+  assert(gate_index < GetNumberOfGates());
+  return std::upper_bound(instance_offsets_.begin(), instance_offsets_.end(), gate_index) -
+         instance_offsets_.begin() - 1;
+}
+
+std::size_t CompiledCircuit::GetFirstInputOfInstance(std::size_t instance) const {
+  return std::lower_bound(input_gates_.begin(), input_gates_.end(),
+                          GetInstanceOffset(instance)) -
+         input_gates_.begin();
+}
+
+void CompiledCircuit::SetInput(std::size_t input_index, std::vector<BitVector<>>&& input) {
+  auto input_gate{
+      dynamic_cast<proto::boolean_gmw::InputGate*>(&GetGate(input_gates_.at(input_index)))};
+  if (input_gate == nullptr) {
+    throw std::invalid_argument(
+        fmt::format("Input gate #{} is no Boolean GMW input gate", input_index));
+  }
+  input_gate->SetInput(std::move(input));
+}
+
+template <typename T>
+void CompiledCircuit::SetInput(std::size_t input_index, std::vector<T>&& input) {
+  auto input_gate{
+      dynamic_cast<proto::arithmetic_gmw::InputGate<T>*>(&GetGate(input_gates_.at(input_index)))};
+  if (input_gate == nullptr) {
+    throw std::invalid_argument(fmt::format(
+        "Input gate #{} is no arithmetic GMW input gate of {} bit", input_index, sizeof(T) * 8));
+  }
+  input_gate->SetInput(std::move(input));
+}
+
+template <typename T>
+void CompiledCircuit::SetInput(std::size_t input_index, std::span<const T> input) {
+  auto input_gate{
+      dynamic_cast<proto::arithmetic_gmw::InputGate<T>*>(&GetGate(input_gates_.at(input_index)))};
+  if (input_gate == nullptr) {
+    throw std::invalid_argument(fmt::format(
+        "Input gate #{} is no arithmetic GMW input gate of {} bit", input_index, sizeof(T) * 8));
+  }
+  input_gate->SetInput(input);
+}
+
+template void CompiledCircuit::SetInput<std::uint8_t>(std::size_t input_index,
+                                                      std::vector<std::uint8_t>&& input);
+template void CompiledCircuit::SetInput<std::uint16_t>(std::size_t input_index,
+                                                       std::vector<std::uint16_t>&& input);
+template void CompiledCircuit::SetInput<std::uint32_t>(std::size_t input_index,
+                                                       std::vector<std::uint32_t>&& input);
+template void CompiledCircuit::SetInput<std::uint64_t>(std::size_t input_index,
+                                                       std::vector<std::uint64_t>&& input);
+template void CompiledCircuit::SetInput<__uint128_t>(std::size_t input_index,
+                                                     std::vector<__uint128_t>&& input);
+
+template void CompiledCircuit::SetInput<std::uint8_t>(std::size_t input_index,
+                                                      std::span<const std::uint8_t> input);
+template void CompiledCircuit::SetInput<std::uint16_t>(std::size_t input_index,
+                                                       std::span<const std::uint16_t> input);
+template void CompiledCircuit::SetInput<std::uint32_t>(std::size_t input_index,
+                                                       std::span<const std::uint32_t> input);
+template void CompiledCircuit::SetInput<std::uint64_t>(std::size_t input_index,
+                                                       std::span<const std::uint64_t> input);
+template void CompiledCircuit::SetInput<__uint128_t>(std::size_t input_index,
+                                                     std::span<const __uint128_t> input);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+class Gate;
+class Register;
+
+/// \brief Flat, index-addressed view of the gate graph of a Register, which is computed once and
+///        re-evaluated for many inputs.
+///
+/// The gate with index i is the i-th gate registered since the last Register::Reset, i.e., the gate
+/// with id Register::GetGateIdOffset() + i.  The fan-in of a gate are the gates producing the wires
+/// it reads and the fan-out are the gates reading the wires it produces.  Both are stored in
+/// compressed sparse row format.  The gates and wires themselves stay owned by the Register, so
+/// re-running the circuit after Backend::Clear does not allocate any of them again.
+///
+/// The circuit may consist of several independent instances of the same computation, e.g., one
+/// per query of a stream, occupying consecutive ranges of gate indices.  At most
+/// GetNumberOfInstancesInFlight() of them are evaluated at the same time, see
+/// GateExecutor::EvaluateDataflow, s.t. the setup of the later instances overlaps the online phase
+/// of the earlier ones.
+class CompiledCircuit {
+ public:
+  /// \param instance_offsets index of the first gate of each instance, empty for a single instance
+  /// \param number_of_instances_in_flight maximum number of instances evaluated at the same time,
+  ///        0 for no limit
+  /// \throws std::invalid_argument if \p instance_offsets does not start with 0 or an instance is
+  ///         empty
+  explicit CompiledCircuit(const Register& reg, std::vector<std::size_t> instance_offsets = {},
+                           std::size_t number_of_instances_in_flight = 0);
+
+  std::size_t GetNumberOfGates() const { return gates_.size(); }
+
+  Gate& GetGate(std::size_t gate_index) const { return *gates_.at(gate_index); }
+
+  /// \brief Indices of the gates that produce the wires read by the gate with index \p gate_index.
+  std::span<const std::size_t> GetFanIn(std::size_t gate_index) const {
+    return {fan_in_.data() + fan_in_offsets_.at(gate_index),
+            fan_in_.data() + fan_in_offsets_.at(gate_index + 1)};
+  }
+
+  /// \brief Indices of the gates that read a wire produced by the gate with index \p gate_index.
+  std::span<const std::size_t> GetFanOut(std::size_t gate_index) const {
+    return {fan_out_.data() + fan_out_offsets_.at(gate_index),
+            fan_out_.data() + fan_out_offsets_.at(gate_index + 1)};
+  }
+
+  /// \brief A gate is live if an output gate of the user depends on it, i.e., it is such an
+  ///        output gate, in the fan-in of a live gate or a helper of a live gate, see
+  ///        Register::GetGateOwner.  The other gates do not contribute to any revealed value.
+  bool IsLive(std::size_t gate_index) const { return live_gates_.at(gate_index); }
+
+  std::size_t GetNumberOfLiveGates() const { return number_of_live_gates_; }
+
+  /// \brief Indices of the input gates in the order they were created.
+  const std::vector<std::size_t>& GetInputGates() const { return input_gates_; }
+
+  std::size_t GetNumberOfInstances() const { return instance_offsets_.size() - 1; }
+
+  std::size_t GetNumberOfInstancesInFlight() const { return number_of_instances_in_flight_; }
+
+  /// \brief Index of the first gate of instance \p instance, or the number of gates for
+  ///        \p instance == GetNumberOfInstances().
+  std::size_t GetInstanceOffset(std::size_t instance) const {
+    return instance_offsets_.at(instance);
+  }
+
+  /// \brief Instance the gate with index \p gate_index belongs to.
+  std::size_t GetInstance(std::size_t gate_index) const;
+
+  /// \brief Position in GetInputGates() of the first input gate of instance \p instance, s.t. the
+  ///        j-th input of the instance is set via SetInput(GetFirstInputOfInstance(instance) + j).
+  std::size_t GetFirstInputOfInstance(std::size_t instance) const;
+
+  /// \brief Replaces the input of the \p input_index-th Boolean GMW input gate for the next run.
+  ///        Parties that do not own the input only need to pass an input of the right dimensions.
+  /// \throws std::invalid_argument if the gate is no Boolean GMW input gate or the dimensions of
+  ///         \p input differ from the original input.
+  void SetInput(std::size_t input_index, std::vector<BitVector<>>&& input);
+
+  /// \brief Replaces the input of the \p input_index-th arithmetic GMW input gate for the next run.
+  /// \throws std::invalid_argument if the gate is no arithmetic GMW input gate of type T or the
+  ///         size of \p input differs from the original input.
+  template <typename T>
+  void SetInput(std::size_t input_index, std::vector<T>&& input);
+
+  /// \brief Copies \p input into the \p input_index-th arithmetic GMW input gate for the next run,
+  ///        s.t. successive chunks of a MappedColumn can be streamed through the circuit.
+  /// \throws std::invalid_argument as the overload taking a vector.
+  template <typename T>
+  void SetInput(std::size_t input_index, std::span<const T> input);
+
+ private:
+  std::vector<Gate*> gates_;
+  std::vector<std::size_t> fan_in_offsets_, fan_in_;
+  std::vector<std::size_t> fan_out_offsets_, fan_out_;
+  std::vector<std::size_t> input_gates_;
+  std::vector<bool> live_gates_;
+  std::size_t number_of_live_gates_{0};
+  std::vector<std::size_t> instance_offsets_;
+  std::size_t number_of_instances_in_flight_;
+};
+
+}  // namespace encrypto::motion
@@ -25,7 +25,21 @@
 #pragma once
 
 #include <boost/log/trivial.hpp>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utility/typedefs.h"
+
+namespace encrypto::motion::communication {
+
+enum class MessageType : std::uint8_t;
+enum class SynchronizationMode;
+
+}  // namespace encrypto::motion::communication
 
 namespace encrypto::motion {
 
@@ -39,6 +53,81 @@ class Configuration {
 
   void SetNumOfThreads(std::size_t n) { number_of_threads_ = n; }
 
+  std::size_t GetNumberOfWorkerThreads() const noexcept { return number_of_worker_threads_; }
+
+  /// \brief Sets the number of worker threads of the fiber pool evaluating the gates.  0 uses one
+  /// worker per hardware thread, any other number must be at least 2.
+  void SetNumberOfWorkerThreads(std::size_t n) { number_of_worker_threads_ = n; }
+
+  const std::vector<std::size_t>& GetWorkerThreadAffinity() const noexcept {
+    return worker_thread_affinity_;
+  }
+
+  /// \brief Pins the worker threads to the logical CPUs \p cpus in round-robin order.
+  void SetWorkerThreadAffinity(std::vector<std::size_t> cpus) {
+    worker_thread_affinity_ = std::move(cpus);
+  }
+
+  std::size_t GetFiberStackSize() const noexcept { return fiber_stack_size_; }
+
+  /// \brief Sets the stack size of the fibers evaluating the gates, 0 uses kFiberStackSize.
+  /// Smaller stacks suffice for circuits of simple gates but overflow silently for complex gates.
+  void SetFiberStackSize(std::size_t size) { fiber_stack_size_ = size; }
+
+  bool GetNumaAwareStealing() const noexcept { return numa_aware_stealing_; }
+
+  /// \brief Let idle worker threads steal fibers from workers on their own NUMA node before
+  /// trying the other nodes.  Requires SetWorkerThreadAffinity.
+  void SetNumaAwareStealing(bool value = true) { numa_aware_stealing_ = value; }
+
+  const std::vector<std::size_t>& GetCommunicationThreadAffinity() const noexcept {
+    return communication_thread_affinity_;
+  }
+
+  /// \brief Pins the send and receive threads of the communication layer to the logical CPUs
+  /// \p cpus in round-robin order, e.g., to keep them apart from the worker threads.
+  void SetCommunicationThreadAffinity(std::vector<std::size_t> cpus) {
+    communication_thread_affinity_ = std::move(cpus);
+  }
+
+  bool GetMessageDispatchThread() const noexcept { return message_dispatch_thread_; }
+
+  /// \brief Verifies and dispatches received messages in a separate thread per party, s.t. the
+  /// receive threads keep draining the sockets during bursts of large messages.
+  void SetMessageDispatchThread(bool value = true) { message_dispatch_thread_ = value; }
+
+  bool GetMessageVerification() const noexcept { return message_verification_; }
+
+  /// \brief Disabling the verification of received messages saves a pass over each message, but
+  /// must only be done for trusted links since corrupt messages are not detected.
+  void SetMessageVerification(bool value = true) { message_verification_ = value; }
+
+  const std::vector<communication::MessageType>& GetCompressedMessageTypes() const noexcept {
+    return compressed_message_types_;
+  }
+
+  /// \brief Compresses large messages of the given types, which pays off for links with a low
+  /// bandwidth, see CommunicationLayer::SetMessageCompression.  Requires MOTION_USE_ZSTD.
+  void SetCompressedMessageTypes(std::vector<communication::MessageType> message_types) {
+    compressed_message_types_ = std::move(message_types);
+  }
+
+  std::optional<std::size_t> GetBroadcastHub() const noexcept { return broadcast_hub_; }
+
+  /// \brief Relays the broadcast messages of all other parties through party \p hub_id, which
+  /// lowers their outgoing traffic for many parties, see CommunicationLayer::SetBroadcastHub.
+  void SetBroadcastHub(std::optional<std::size_t> hub_id) { broadcast_hub_ = hub_id; }
+
+  communication::SynchronizationMode GetSynchronizationMode() const noexcept {
+    return synchronization_mode_;
+  }
+
+  /// \brief Exchanges the messages of the synchronizations between the phases as selected by
+  /// \p mode, see CommunicationLayer::SetSynchronizationMode.  Defaults to all-to-all.
+  void SetSynchronizationMode(communication::SynchronizationMode mode) {
+    synchronization_mode_ = mode;
+  }
+
   void SetLoggingSeverityLevel(boost::log::trivial::severity_level severity_level) {
     severity_level_ = severity_level;
   }
@@ -47,6 +136,142 @@ class Configuration {
 
   void SetOnlineAfterSetup(bool value);
 
+  bool GetLayeredEvaluation() const noexcept { return layered_evaluation_; }
+
+  /// \brief Evaluate the circuit layer by layer instead of running all gates concurrently.
+  /// Takes precedence over SetOnlineAfterSetup.
+  void SetLayeredEvaluation(bool value = true) { layered_evaluation_ = value; }
+
+  bool GetDataflowEvaluation() const noexcept { return dataflow_evaluation_; }
+
+  /// \brief Start each gate only after all gates producing its input wires have been evaluated,
+  /// s.t. no fibers are suspended waiting for their inputs.  Takes precedence over
+  /// SetLayeredEvaluation and SetOnlineAfterSetup.
+  void SetDataflowEvaluation(bool value = true) { dataflow_evaluation_ = value; }
+
+  bool GetDeadGateElimination() const noexcept { return dead_gate_elimination_; }
+
+  /// \brief Skip the gates no output gate depends on in dataflow evaluation, see
+  /// CompiledCircuit::IsLive.  Needs to be set by all parties alike.
+  void SetDeadGateElimination(bool value = true) { dead_gate_elimination_ = value; }
+
+  bool GetSetupPipeline() const noexcept { return setup_pipeline_; }
+
+  /// \brief Evaluate the setup phases of all gates with Gate::HasIndependentSetup, e.g., of all
+  /// ASTRA gates, in circuit order in a pipeline of their own, s.t. the helper party generates and
+  /// streams the correlated values of the whole circuit ahead of the online phase instead of gate
+  /// by gate in the fibers of the online evaluation.  Applies to the parallel, layered and
+  /// dataflow evaluation.  Needs to be set by all parties alike.
+  void SetSetupPipeline(bool value = true) { setup_pipeline_ = value; }
+
+  bool GetGateStatistics() const noexcept { return gate_statistics_; }
+
+  /// \brief Record the online time, the time waiting for the input wires and the estimated bytes
+  /// of each gate, aggregated by gate class and by circuit layer in
+  /// RunTimeStatistics::gate_statistics and RunTimeStatistics::layer_statistics.  The gates wait
+  /// for all of their input wires before their online phase starts, which adds a little overhead
+  /// per gate.
+  void SetGateStatistics(bool value = true) { gate_statistics_ = value; }
+
+  const std::string& GetPreprocessingOutputPath() const noexcept {
+    return preprocessing_output_path_;
+  }
+
+  /// \brief Write the MTs, SPs and SBs generated in the setup phase to \p path, s.t. a later run of
+  /// the same circuit can load them via SetPreprocessingInputPath.  The material must not be used
+  /// by the run generating it, so Party::Run throws if the path is set and the setup phase needs
+  /// to be run alone by Backend::RunPreprocessing.  OTs requested by gates are not stored.
+  void SetPreprocessingOutputPath(std::string path) {
+    preprocessing_output_path_ = std::move(path);
+  }
+
+  const std::string& GetPreprocessingInputPath() const noexcept {
+    return preprocessing_input_path_;
+  }
+
+  /// \brief Load the MTs, SPs and SBs from a file written by SetPreprocessingOutputPath instead of
+  /// generating them in the setup phase.  The loaded material is marked as consumed in the file,
+  /// s.t. each of it is used by one run only, and loading throws if not enough of it is left.
+  void SetPreprocessingInputPath(std::string path) { preprocessing_input_path_ = std::move(path); }
+
+  bool GetSilentOtExtension() const noexcept { return silent_ot_extension_; }
+
+  /// \brief Generate large numbers of OTs with the silent OT extension, see
+  /// OtProviderManager::SetSilentOtExtension.
+  void SetSilentOtExtension(bool value = true) { silent_ot_extension_ = value; }
+
+  std::size_t GetOtExtensionChunkSize() const noexcept { return ot_extension_chunk_size_; }
+
+  /// \brief Extend the OTs in chunks of \p number_of_ots OTs to bound the memory of the setup,
+  /// see OtProviderManager::SetOtExtensionChunkSize.  0 keeps the default chunk size.
+  void SetOtExtensionChunkSize(std::size_t number_of_ots) {
+    ot_extension_chunk_size_ = number_of_ots;
+  }
+
+  bool GetPaillierMts() const noexcept { return paillier_mts_; }
+
+  /// \brief Generate the arithmetic MTs with the Paillier cryptosystem instead of OTs, which
+  /// trades computation for communication, see MtProviderFromOts::SetPaillierMts.
+  void SetPaillierMts(bool value = true) { paillier_mts_ = value; }
+
+  std::size_t GetGreaterThanChunkBitLength() const noexcept {
+    return greater_than_chunk_bit_length_;
+  }
+
+  /// \brief Sets the chunk bit length l_s of the arithmetic GMW GreaterThanGate, which compares
+  /// l_s bits at once with 1-out-of-2^l_s OTs.  0 selects l_s per comparison for the network set
+  /// by SetNetworkProfile, see proto::arithmetic_gmw::SelectGreaterThanChunkBitLength.  Needs to
+  /// be set by all parties alike.
+  void SetGreaterThanChunkBitLength(std::size_t l_s) { greater_than_chunk_bit_length_ = l_s; }
+
+  GarbledCircuitScheme GetGarbledCircuitScheme() const noexcept { return garbled_circuit_scheme_; }
+
+  /// \brief Selects the garbling scheme for garbled circuit AND gates, where kAuto selects the
+  /// scheme for the network set by SetNetworkProfile, see
+  /// proto::garbled_circuit::SelectGarbledCircuitScheme.  Needs to be set by both parties alike
+  /// before constructing the party.
+  void SetGarbledCircuitScheme(GarbledCircuitScheme scheme) { garbled_circuit_scheme_ = scheme; }
+
+  std::chrono::microseconds GetNetworkRoundTripTime() const noexcept {
+    return network_round_trip_time_;
+  }
+
+  double GetNetworkBandwidth() const noexcept { return network_bandwidth_; }
+
+  /// \brief Describes the network between the parties for the cost models that tune protocol
+  /// parameters, e.g., SetGreaterThanChunkBitLength, and for the window in which the
+  /// communication layer coalesces small messages, see CommunicationLayer::SetRoundTripTime.
+  /// \p bandwidth is in bits per second, 0 means unlimited.  Needs to be set by all parties alike.
+  void SetNetworkProfile(std::chrono::microseconds round_trip_time, double bandwidth) {
+    network_round_trip_time_ = round_trip_time;
+    network_bandwidth_ = bandwidth;
+  }
+
+  const std::string& GetTrustedDealerHost() const noexcept { return trusted_dealer_host_; }
+
+  std::uint16_t GetTrustedDealerPort() const noexcept { return trusted_dealer_port_; }
+
+  /// \brief Get the MTs, SPs, SBs and OTs from the trusted dealer listening at \p host and
+  /// \p port instead of generating them with the other parties, see
+  /// trusted_dealer/trusted_dealer.h.
+  void SetTrustedDealer(std::string host, std::uint16_t port) {
+    trusted_dealer_host_ = std::move(host);
+    trusted_dealer_port_ = port;
+  }
+
+  const std::optional<std::uint64_t>& GetInsecureFakePreprocessingSeed() const noexcept {
+    return insecure_fake_preprocessing_seed_;
+  }
+
+  /// \brief INSECURE, for benchmarking the online phase only: every party generates the MTs, SPs,
+  /// SBs and OTs locally from \p seed as the trusted dealer would, without any communication, s.t.
+  /// each party knows the shares of all other parties, see MakeInsecureFakeCorrelations in
+  /// trusted_dealer/trusted_dealer.h.  Takes precedence over SetTrustedDealer.  Needs to be set
+  /// by all parties alike with the same seed, std::nullopt disables it (the default).
+  void SetInsecureFakePreprocessing(std::optional<std::uint64_t> seed) {
+    insecure_fake_preprocessing_seed_ = seed;
+  }
+
   void SetLoggingEnabled(bool value = true) { logging_enabled_ = value; }
 
   bool GetLoggingEnabled() const noexcept { return logging_enabled_; }
@@ -71,11 +296,69 @@ class Configuration {
   /// until proceeding to the online phase
   bool online_after_setup_ = false;
 
+  /// @param layered_evaluation_ if set true, the gates are evaluated by depth layers, see
+  /// GateExecutor::EvaluateLayered
+  bool layered_evaluation_ = false;
+
+  /// @param dataflow_evaluation_ if set true, the gates are started as soon as their inputs are
+  /// ready, see GateExecutor::EvaluateDataflow
+  bool dataflow_evaluation_ = false;
+
+  /// @param dead_gate_elimination_ if set true, the dataflow evaluation skips the gates that do not
+  /// contribute to any output
+  bool dead_gate_elimination_ = false;
+
+  /// @param setup_pipeline_ if set true, the independent setup phases are evaluated ahead of the
+  /// online phase, see GateExecutor::StartSetupPipeline
+  bool setup_pipeline_ = false;
+
+  /// @param gate_statistics_ if set true, the online phase of each gate is timed, see
+  /// GateExecutor::EvaluateOnline
+  bool gate_statistics_ = false;
+
+  bool silent_ot_extension_ = false;
+  std::size_t ot_extension_chunk_size_ = 0;
+  bool paillier_mts_ = false;
+
+  // 0 selects the chunk bit length with the network profile
+  std::size_t greater_than_chunk_bit_length_ = 0;
+  std::chrono::microseconds network_round_trip_time_{0};
+  double network_bandwidth_ = 0;
+
+  GarbledCircuitScheme garbled_circuit_scheme_ = GarbledCircuitScheme::kThreeHalves;
+
+  // empty paths disable storing or loading preprocessing material, respectively
+  std::string preprocessing_output_path_;
+  std::string preprocessing_input_path_;
+
+  // an empty host disables the trusted dealer
+  std::string trusted_dealer_host_;
+  std::uint16_t trusted_dealer_port_ = 0;
+  std::optional<std::uint64_t> insecure_fake_preprocessing_seed_;
+
   // determines how many worker threads are used in openmp, but not in
   // communication handlers! the latter always use at least 2 threads for each
   // communication channel to send and receive data to prevent the communication
   // becoming a bottleneck, e.g., in 10 Gbps networks.
   std::size_t number_of_threads_;
+
+  // 0 uses std::thread::hardware_concurrency() worker threads
+  std::size_t number_of_worker_threads_ = 0;
+
+  // empty vectors leave the threads unpinned
+  std::vector<std::size_t> worker_thread_affinity_;
+  std::vector<std::size_t> communication_thread_affinity_;
+  bool message_dispatch_thread_ = false;
+  bool message_verification_ = true;
+  std::vector<communication::MessageType> compressed_message_types_;
+  std::optional<std::size_t> broadcast_hub_;
+  // value-initialized to SynchronizationMode::kAllToAll
+  communication::SynchronizationMode synchronization_mode_{};
+
+  bool numa_aware_stealing_ = false;
+
+  // 0 uses kFiberStackSize
+  std::size_t fiber_stack_size_ = 0;
 };
 
 using ConfigurationPointer = std::shared_ptr<Configuration>;
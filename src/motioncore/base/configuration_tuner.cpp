@@ -0,0 +1,360 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "configuration_tuner.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/json.hpp>
+
+#include "base/configuration.h"
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "primitives/aes/aesni_primitives.h"
+#include "primitives/random/default_rng.h"
+#include "utility/bit_matrix.h"
+#include "utility/block.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// each host measurement is repeated until it took at least this long
+constexpr std::chrono::milliseconds kMinimumMeasurementTime{50};
+// number of blocks hashed at once to measure the AES throughput, which fit into the L2 cache
+constexpr std::size_t kNumberOfAesBlocks{1 << 14};
+// number of columns of the 128-row matrix transposed to measure the transpose throughput
+constexpr std::size_t kNumberOfTransposeColumns{1 << 16};
+
+// message ids of the kNetworkProbe messages
+constexpr std::size_t kProfileMessageId{0};
+constexpr std::size_t kNumberOfPings{8};
+constexpr std::size_t GetPingMessageId(std::size_t ping) { return 1 + 2 * ping; }
+constexpr std::size_t GetPongMessageId(std::size_t ping) { return 2 + 2 * ping; }
+constexpr std::size_t kBulkMessageId{1 + 2 * kNumberOfPings};
+constexpr std::size_t kBulkAcknowledgementMessageId{kBulkMessageId + 1};
+constexpr std::size_t kMeasuredProfileMessageId{kBulkMessageId + 2};
+// size of the bulk message, which takes about 3 s on a 10 Mbit/s link
+constexpr std::size_t kBulkMessageSize{4 * 1024 * 1024};
+
+// links with a smaller round-trip time are local, where the evaluation is bound by the computation
+// and the dataflow evaluation saves suspending the fibers of gates waiting for their inputs
+constexpr std::chrono::microseconds kLocalRoundTripTime{1'000};
+// from this bandwidth on, bursts of large messages arrive faster than the receive thread verifies
+// and dispatches them, see Configuration::SetMessageDispatchThread
+constexpr double kMessageDispatchThreadBandwidth{1e9};
+// cost model of the OT extension: IKNP sends and transposes kKappa bits and computes a PRG and a
+// hash block per OT, the silent OT extension expands a GGM tree with 2 AES blocks per OT and
+// gathers kLpnWeight random blocks, each of which costs about as much as an AES block
+constexpr double kIknpAesBlocksPerOt{2};
+constexpr double kSilentOtAesBlocksPerOt{12};
+// smallest OT extension chunk, which keeps the per-chunk overhead negligible
+constexpr std::size_t kMinimumOtExtensionChunkSize{1 << 16};
+
+// the party id of the i-th other party as in MessageManager::RegisterReceiveAll
+std::size_t GetOtherPartyId(std::size_t i, std::size_t my_id) { return i < my_id ? i : i + 1; }
+
+// serialization of a profile for the other parties, where the first value is 1 if the party asks
+// for a network measurement
+using ProfileMessage = std::array<double, 6>;
+
+ProfileMessage ToMessage(const TuningProfile& profile, bool measure_network) {
+  return {measure_network ? 1.0 : 0.0,
+          static_cast<double>(profile.number_of_hardware_threads),
+          profile.aes_blocks_per_second,
+          profile.transpose_bits_per_second,
+          static_cast<double>(profile.round_trip_time.count()),
+          profile.bandwidth};
+}
+
+std::pair<TuningProfile, bool> FromMessage(const std::vector<std::uint8_t>& raw_message) {
+  auto payload{communication::GetMessage(raw_message.data())->payload()};
+  ProfileMessage message;
+  if (payload == nullptr || payload->size() != sizeof(message)) {
+    throw std::runtime_error("Received a corrupt tuning profile");
+  }
+  std::memcpy(message.data(), payload->data(), sizeof(message));
+  TuningProfile profile;
+  profile.number_of_hardware_threads = static_cast<std::size_t>(message[1]);
+  profile.aes_blocks_per_second = message[2];
+  profile.transpose_bits_per_second = message[3];
+  profile.round_trip_time =
+      std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(message[4]));
+  profile.bandwidth = message[5];
+  return {profile, message[0] != 0};
+}
+
+// sends profile to all other parties and returns their profiles and whether they ask for a
+// network measurement
+std::vector<std::pair<TuningProfile, bool>> ExchangeProfiles(
+    communication::CommunicationLayer& communication_layer, const TuningProfile& profile,
+    bool measure_network, std::size_t message_id) {
+  auto futures{communication_layer.GetMessageManager().RegisterReceiveAll(
+      communication::MessageType::kNetworkProbe, message_id)};
+  // the other parties must have registered the messages before they are sent
+  communication_layer.Synchronize();
+  const ProfileMessage message{ToMessage(profile, measure_network)};
+  communication_layer.BroadcastMessage(
+      communication::BuildMessage(
+          communication::MessageType::kNetworkProbe, message_id,
+          std::span(reinterpret_cast<const std::uint8_t*>(message.data()), sizeof(message)))
+          .Release());
+  std::vector<std::pair<TuningProfile, bool>> profiles;
+  profiles.reserve(futures.size());
+  for (auto& future : futures) profiles.emplace_back(FromMessage(future.get()));
+  return profiles;
+}
+
+// the slowest values of all parties, where a bandwidth of 0 is unlimited
+TuningProfile AgreeOnProfile(TuningProfile profile,
+                             const std::vector<std::pair<TuningProfile, bool>>& other_profiles) {
+  for (const auto& [other, measure_network] : other_profiles) {
+    profile.aes_blocks_per_second =
+        std::min(profile.aes_blocks_per_second, other.aes_blocks_per_second);
+    profile.transpose_bits_per_second =
+        std::min(profile.transpose_bits_per_second, other.transpose_bits_per_second);
+    profile.round_trip_time = std::max(profile.round_trip_time, other.round_trip_time);
+    if (profile.bandwidth == 0 || (other.bandwidth != 0 && other.bandwidth < profile.bandwidth)) {
+      profile.bandwidth = other.bandwidth;
+    }
+  }
+  return profile;
+}
+
+// runs function until it took at least kMinimumMeasurementTime and returns the repetitions per
+// second
+template <typename Function>
+double MeasureRate(Function&& function) {
+  std::size_t repetitions{0};
+  const auto start{Clock::now()};
+  std::chrono::duration<double> elapsed{0};
+  do {
+    function();
+    ++repetitions;
+    elapsed = Clock::now() - start;
+  } while (elapsed < kMinimumMeasurementTime);
+  return repetitions / elapsed.count();
+}
+
+bool SelectSilentOtExtension(const TuningProfile& profile) {
+  if (profile.aes_blocks_per_second <= 0 || profile.transpose_bits_per_second <= 0) return false;
+  const double iknp_compute_time{kKappa / profile.transpose_bits_per_second +
+                                 kIknpAesBlocksPerOt / profile.aes_blocks_per_second};
+  const double iknp_send_time{profile.bandwidth > 0 ? kKappa / profile.bandwidth : 0};
+  const double silent_compute_time{kSilentOtAesBlocksPerOt / profile.aes_blocks_per_second};
+  return silent_compute_time < std::max(iknp_compute_time, iknp_send_time);
+}
+
+// OtProviderManager keeps 2 chunks in flight per acknowledgement, s.t. chunks of half the
+// bandwidth-delay product keep the link busy, which bounds the memory of the OT extension
+std::size_t SelectOtExtensionChunkSize(const TuningProfile& profile) {
+  if (profile.bandwidth <= 0) return 0;
+  const double round_trip_seconds{
+      std::chrono::duration<double>(profile.round_trip_time).count()};
+  const auto bandwidth_delay_ots{
+      static_cast<std::size_t>(profile.bandwidth * round_trip_seconds / kKappa)};
+  const std::size_t chunk_size{std::max(kMinimumOtExtensionChunkSize, bandwidth_delay_ots / 2)};
+  return (chunk_size + kKappa - 1) / kKappa * kKappa;
+}
+
+}  // namespace
+
+void TuningProfile::Save(const std::string& path) const {
+  const boost::json::object json{
+      {"number_of_hardware_threads", number_of_hardware_threads},
+      {"aes_blocks_per_second", aes_blocks_per_second},
+      {"transpose_bits_per_second", transpose_bits_per_second},
+      {"round_trip_time_us", round_trip_time.count()},
+      {"bandwidth", bandwidth}};
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot write the tuning profile to {}", path));
+  }
+  file << boost::json::serialize(json);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot write the tuning profile to {}", path));
+  }
+}
+
+std::optional<TuningProfile> TuningProfile::Load(const std::string& path) {
+  if (!std::filesystem::exists(path)) return std::nullopt;
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot read the tuning profile {}", path));
+  }
+  try {
+    const boost::json::value value{boost::json::parse(content.str())};
+    const auto& json{value.as_object()};
+    TuningProfile profile;
+    profile.number_of_hardware_threads =
+        json.at("number_of_hardware_threads").to_number<std::size_t>();
+    profile.aes_blocks_per_second = json.at("aes_blocks_per_second").to_number<double>();
+    profile.transpose_bits_per_second = json.at("transpose_bits_per_second").to_number<double>();
+    profile.round_trip_time =
+        std::chrono::microseconds(json.at("round_trip_time_us").to_number<std::int64_t>());
+    profile.bandwidth = json.at("bandwidth").to_number<double>();
+    return profile;
+  } catch (const std::exception& e) {
+    throw std::runtime_error(fmt::format("Invalid tuning profile {}: {}", path, e.what()));
+  }
+}
+
+TuningProfile MeasureHost() {
+  TuningProfile profile;
+  profile.number_of_hardware_threads = std::thread::hardware_concurrency();
+
+  alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> round_keys;
+  DefaultRng::GetThreadInstance().RandomBytes(round_keys.data(), kAesKeySize128);
+  AesniKeyExpansion128(round_keys.data());
+  auto blocks{Block128Vector::MakeRandom(kNumberOfAesBlocks)};
+  profile.aes_blocks_per_second =
+      kNumberOfAesBlocks *
+      MeasureRate([&] { AesniMmoBlocks(round_keys.data(), blocks.data(), blocks.size()); });
+
+  // each repetition transposes a copy as in the OT extension, which is cheap compared to the
+  // transposition itself
+  const BitMatrix matrix(kKappa, kNumberOfTransposeColumns);
+  profile.transpose_bits_per_second = kKappa * kNumberOfTransposeColumns * MeasureRate([&] {
+                                        BitMatrix copy(matrix);
+                                        copy.Transpose128Rows();
+                                      });
+  return profile;
+}
+
+void MeasureNetwork(communication::CommunicationLayer& communication_layer,
+                    TuningProfile& profile) {
+  using communication::MessageType;
+  const std::size_t my_id{communication_layer.GetMyId()};
+  auto& message_manager{communication_layer.GetMessageManager()};
+  std::vector<std::vector<communication::MessageManager::future_type>> ping_futures, pong_futures;
+  for (std::size_t ping = 0; ping < kNumberOfPings; ++ping) {
+    ping_futures.emplace_back(
+        message_manager.RegisterReceiveAll(MessageType::kNetworkProbe, GetPingMessageId(ping)));
+    pong_futures.emplace_back(
+        message_manager.RegisterReceiveAll(MessageType::kNetworkProbe, GetPongMessageId(ping)));
+  }
+  auto bulk_futures{message_manager.RegisterReceiveAll(MessageType::kNetworkProbe, kBulkMessageId)};
+  auto acknowledgement_futures{message_manager.RegisterReceiveAll(
+      MessageType::kNetworkProbe, kBulkAcknowledgementMessageId)};
+  communication_layer.Synchronize();
+
+  // each party pings all others at once and answers their pings, the round-trip time is the time
+  // until all answers arrived in the fastest round
+  auto round_trip_time{Clock::duration::max()};
+  for (std::size_t ping = 0; ping < kNumberOfPings; ++ping) {
+    const auto start{Clock::now()};
+    communication_layer.BroadcastMessage(
+        communication::BuildMessage(MessageType::kNetworkProbe, GetPingMessageId(ping), {})
+            .Release());
+    for (std::size_t i = 0; i < ping_futures[ping].size(); ++i) {
+      ping_futures[ping][i].get();
+      communication_layer.SendMessage(
+          GetOtherPartyId(i, my_id),
+          communication::BuildMessage(MessageType::kNetworkProbe, GetPongMessageId(ping), {})
+              .Release());
+    }
+    for (auto& future : pong_futures[ping]) future.get();
+    round_trip_time = std::min(round_trip_time, Clock::now() - start);
+  }
+  profile.round_trip_time = std::chrono::duration_cast<std::chrono::microseconds>(round_trip_time);
+
+  // random bytes s.t. a compressing transport does not distort the bandwidth
+  auto payload{std::make_shared<std::vector<std::uint8_t>>(kBulkMessageSize)};
+  DefaultRng::GetThreadInstance().RandomBytes(reinterpret_cast<std::byte*>(payload->data()),
+                                              payload->size());
+  const auto start{Clock::now()};
+  communication_layer.BroadcastMessage(MessageType::kNetworkProbe, kBulkMessageId,
+                                       std::span(*payload), payload);
+  for (std::size_t i = 0; i < bulk_futures.size(); ++i) {
+    bulk_futures[i].get();
+    communication_layer.SendMessage(
+        GetOtherPartyId(i, my_id),
+        communication::BuildMessage(MessageType::kNetworkProbe, kBulkAcknowledgementMessageId, {})
+            .Release());
+  }
+  for (auto& future : acknowledgement_futures) future.get();
+  const std::chrono::duration<double> transfer_time{Clock::now() - start - round_trip_time};
+  // a transfer within the noise of the round-trip time is considered unlimited
+  profile.bandwidth =
+      transfer_time.count() > 0 ? 8.0 * kBulkMessageSize / transfer_time.count() : 0;
+}
+
+void ApplyTuningProfile(const TuningProfile& profile, Configuration& configuration) {
+  if (profile.number_of_hardware_threads > 0) {
+    const std::size_t number_of_threads{
+        std::max<std::size_t>(profile.number_of_hardware_threads, 2)};
+    configuration.SetNumOfThreads(number_of_threads);
+    configuration.SetNumberOfWorkerThreads(number_of_threads);
+  }
+  configuration.SetNetworkProfile(profile.round_trip_time, profile.bandwidth);
+  configuration.SetGarbledCircuitScheme(GarbledCircuitScheme::kAuto);
+  configuration.SetGreaterThanChunkBitLength(0);
+  configuration.SetDataflowEvaluation(profile.round_trip_time < kLocalRoundTripTime);
+  configuration.SetMessageDispatchThread(profile.bandwidth == 0 ||
+                                         profile.bandwidth >= kMessageDispatchThreadBandwidth);
+  configuration.SetSilentOtExtension(SelectSilentOtExtension(profile));
+  configuration.SetOtExtensionChunkSize(SelectOtExtensionChunkSize(profile));
+}
+
+TuningProfile TuneConfiguration(communication::CommunicationLayer& communication_layer,
+                                Configuration& configuration, const std::string& profile_path) {
+  std::optional<TuningProfile> profile;
+  if (!profile_path.empty()) profile = TuningProfile::Load(profile_path);
+  const bool measured_host{!profile.has_value()};
+  if (measured_host) profile = MeasureHost();
+
+  auto other_profiles{
+      ExchangeProfiles(communication_layer, *profile, measured_host, kProfileMessageId)};
+  const bool measure_network{
+      measured_host || std::any_of(other_profiles.begin(), other_profiles.end(),
+                                   [](const auto& other) { return other.second; })};
+  if (measure_network) {
+    MeasureNetwork(communication_layer, *profile);
+    if (!profile_path.empty()) profile->Save(profile_path);
+    other_profiles =
+        ExchangeProfiles(communication_layer, *profile, false, kMeasuredProfileMessageId);
+  }
+
+  const TuningProfile agreed_profile{AgreeOnProfile(*profile, other_profiles)};
+  ApplyTuningProfile(agreed_profile, configuration);
+  return agreed_profile;
+}
+
+}  // namespace encrypto::motion
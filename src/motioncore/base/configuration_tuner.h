@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion {
+
+class Configuration;
+
+/// \brief Throughput of this host and round-trip time and bandwidth of the network to the other
+/// parties, from which ApplyTuningProfile chooses the settings of a Configuration.
+struct TuningProfile {
+  std::size_t number_of_hardware_threads{0};
+
+  // fixed-key AES blocks per second of a single thread
+  double aes_blocks_per_second{0};
+
+  // bits per second a single thread transposes in the OT extension
+  double transpose_bits_per_second{0};
+
+  // of the slowest link to the other parties
+  std::chrono::microseconds round_trip_time{0};
+
+  // bits per second of the slowest link to the other parties, 0 means unlimited
+  double bandwidth{0};
+
+  /// \brief Writes the profile to \p path as JSON.
+  /// \throws std::runtime_error if the file cannot be written
+  void Save(const std::string& path) const;
+
+  /// \brief Reads a profile written by Save or returns std::nullopt if \p path does not exist.
+  /// \throws std::runtime_error if the file is not a valid profile
+  static std::optional<TuningProfile> Load(const std::string& path);
+};
+
+/// \brief Measures the AES and transpose throughput of a single thread of this host, which takes
+/// about a tenth of a second.  The network fields are left 0.
+TuningProfile MeasureHost();
+
+/// \brief Measures the round-trip time with pings to all other parties and the bandwidth with a
+/// bulk message to all of them at once, and stores the values of the slowest link in \p profile.
+/// Needs to be called by all parties at the same time before the circuit is evaluated.
+void MeasureNetwork(communication::CommunicationLayer& communication_layer,
+                    TuningProfile& profile);
+
+/// \brief Chooses the thread counts, the executor mode, the OT extension and the message handling
+/// of \p configuration for \p profile, and sets the network profile, s.t. the garbled circuit
+/// scheme and the chunk bit length of the GreaterThanGate are selected by their cost models.
+void ApplyTuningProfile(const TuningProfile& profile, Configuration& configuration);
+
+/// \brief Loads the profile from \p profile_path or measures it if the file does not exist or
+/// \p profile_path is empty, and applies it to \p configuration.  The last measurement is saved
+/// to \p profile_path for later runs.  The network is measured by all parties if any party lacks
+/// a stored profile, and the parties agree on the largest round-trip time and the smallest
+/// bandwidth and AES and transpose throughput of all parties, s.t. the settings that need to be
+/// the same for all parties are.  Needs to be called by all parties at the same time before the
+/// circuit is built.
+/// \return the agreed profile with the number of hardware threads of this host
+TuningProfile TuneConfiguration(communication::CommunicationLayer& communication_layer,
+                                Configuration& configuration,
+                                const std::string& profile_path = {});
+
+}  // namespace encrypto::motion
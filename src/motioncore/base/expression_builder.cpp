@@ -0,0 +1,492 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "expression_builder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "utility/mapped_column.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+ShareWrapper ApplyOperation(ExpressionBuilder::Operation operation, const ShareWrapper& a,
+                            const ShareWrapper& b) {
+  switch (operation) {
+    case ExpressionBuilder::Operation::kXor:
+      return a ^ b;
+    case ExpressionBuilder::Operation::kAnd:
+      return a & b;
+    case ExpressionBuilder::Operation::kOr:
+      return a | b;
+    case ExpressionBuilder::Operation::kAdd:
+      return a + b;
+    case ExpressionBuilder::Operation::kSubtract:
+      return a - b;
+    case ExpressionBuilder::Operation::kMultiply:
+      return a * b;
+    case ExpressionBuilder::Operation::kEqual:
+      return a == b;
+    case ExpressionBuilder::Operation::kGreaterThan:
+      return a > b;
+  }
+  throw std::invalid_argument(
+      fmt::format("Unknown operation {}", static_cast<unsigned>(operation)));
+}
+
+// whether the operation sends messages in the protocols of GMW, i.e., whether evaluating many
+// pairs in one SIMD gate saves messages
+bool IsInteractive(ExpressionBuilder::Operation operation) {
+  switch (operation) {
+    case ExpressionBuilder::Operation::kXor:
+    case ExpressionBuilder::Operation::kAdd:
+    case ExpressionBuilder::Operation::kSubtract:
+      return false;
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+ExpressionBuilder::Node ExpressionBuilder::Insert(ShareWrapper share) {
+  if (program_) {
+    throw std::logic_error("ExpressionBuilder cannot record the gates of inserted shares");
+  }
+  return AddNode(std::move(share));
+}
+
+ExpressionBuilder::Node ExpressionBuilder::AddNode(ShareWrapper share) {
+  if (shares_.size() > std::numeric_limits<Node>::max()) {
+    throw std::length_error("ExpressionBuilder ran out of node handles");
+  }
+  shares_.emplace_back(std::move(share));
+  return static_cast<Node>(shares_.size() - 1);
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Apply(Operation operation, Node a, Node b) {
+  const auto node{AddNode(ApplyOperation(operation, Get(a), Get(b)))};
+  if (program_) {
+    program_->instructions_.push_back({.opcode = ExpressionProgram::Opcode::kApply,
+                                       .argument = static_cast<std::uint8_t>(operation),
+                                       .nodes = {a, b}});
+  }
+  return node;
+}
+
+void ExpressionBuilder::Apply(Operation operation, std::span<const Node> a,
+                              std::span<const Node> b, std::span<Node> result) {
+  if (a.size() != b.size() || a.size() != result.size()) {
+    throw std::invalid_argument(fmt::format(
+        "ExpressionBuilder::Apply got {} and {} operands for {} results", a.size(), b.size(),
+        result.size()));
+  }
+  auto is_scalar = [this](Node node) { return Get(node)->GetNumberOfSimdValues() == 1; };
+  if (a.size() > 1 && IsInteractive(operation) && std::all_of(a.begin(), a.end(), is_scalar) &&
+      std::all_of(b.begin(), b.end(), is_scalar)) {
+    // Simdify may grow shares_, so the shares are only looked up afterwards
+    const auto simd_a{Simdify(a)};
+    const auto simd_b{Simdify(b)};
+    Unsimdify(Apply(operation, simd_a, simd_b), result);
+  } else {
+    for (std::size_t i = 0; i < a.size(); ++i) result[i] = Apply(operation, a[i], b[i]);
+  }
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Not(Node a) {
+  const auto node{AddNode(~Get(a))};
+  if (program_) {
+    program_->instructions_.push_back({.opcode = ExpressionProgram::Opcode::kNot, .nodes = {a}});
+  }
+  return node;
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Mux(Node selection, Node a, Node b) {
+  const auto node{AddNode(Get(selection).Mux(Get(a), Get(b)))};
+  if (program_) {
+    program_->instructions_.push_back(
+        {.opcode = ExpressionProgram::Opcode::kMux, .nodes = {selection, a, b}});
+  }
+  return node;
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Simdify(std::span<const Node> nodes) {
+  if (nodes.size() == 1) return nodes[0];
+  std::vector<SharePointer> shares;
+  shares.reserve(nodes.size());
+  for (const auto node : nodes) shares.emplace_back(Get(node).Get());
+  const auto node{AddNode(ShareWrapper::Simdify(shares))};
+  if (program_) {
+    program_->instructions_.push_back({.opcode = ExpressionProgram::Opcode::kSimdify,
+                                       .size = nodes.size(),
+                                       .offset = program_->operands_.size()});
+    program_->operands_.insert(program_->operands_.end(), nodes.begin(), nodes.end());
+  }
+  return node;
+}
+
+void ExpressionBuilder::Unsimdify(Node node, std::span<Node> result) {
+  const auto number_of_simd{Get(node)->GetNumberOfSimdValues()};
+  if (number_of_simd != result.size()) {
+    throw std::invalid_argument(fmt::format(
+        "ExpressionBuilder::Unsimdify got {} results for {} SIMD values", result.size(),
+        number_of_simd));
+  }
+  if (number_of_simd == 1) {
+    result[0] = node;
+    return;
+  }
+  auto shares{ShareWrapper(Get(node)).Unsimdify()};
+  for (std::size_t i = 0; i < shares.size(); ++i) result[i] = AddNode(std::move(shares[i]));
+  if (program_) {
+    program_->instructions_.push_back(
+        {.opcode = ExpressionProgram::Opcode::kUnsimdify, .nodes = {node}, .size = result.size()});
+  }
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Output(Node node, std::size_t output_owner) {
+  const auto output{AddNode(Get(node).Out(output_owner))};
+  if (program_) {
+    program_->instructions_.push_back(
+        {.opcode = ExpressionProgram::Opcode::kOutput, .nodes = {node}, .owner = output_owner});
+  }
+  return output;
+}
+
+ExpressionBuilder::Node ExpressionBuilder::Outputs(std::span<const Node> nodes,
+                                                   std::size_t output_owner) {
+  return Output(Simdify(nodes), output_owner);
+}
+
+void ExpressionBuilder::RecordInput(MpcProtocol protocol, std::size_t value_size,
+                                    std::size_t number_of_values, std::size_t input_owner,
+                                    std::span<const std::byte> values) {
+  ExpressionProgram::Instruction instruction{.opcode = ExpressionProgram::Opcode::kInput,
+                                             .argument = static_cast<std::uint8_t>(protocol),
+                                             .value_size = static_cast<std::uint8_t>(value_size),
+                                             .size = number_of_values,
+                                             .owner = input_owner};
+  if (protocol == MpcProtocol::kArithmeticConstant) {
+    instruction.offset = program_->data_.size();
+    program_->data_.insert(program_->data_.end(), values.begin(), values.end());
+  }
+  program_->instructions_.push_back(instruction);
+}
+
+void ExpressionBuilder::RecordInput(MpcProtocol protocol, std::span<const BitVector<>> wires,
+                                    std::size_t input_owner) {
+  ExpressionProgram::Instruction instruction{.opcode = ExpressionProgram::Opcode::kInput,
+                                             .argument = static_cast<std::uint8_t>(protocol),
+                                             .size = wires.empty() ? 0 : wires[0].GetSize(),
+                                             .number_of_wires = wires.size(),
+                                             .owner = input_owner};
+  if (protocol == MpcProtocol::kBooleanConstant) {
+    instruction.offset = program_->data_.size();
+    for (const auto& wire : wires) {
+      const auto& bytes{wire.GetData()};
+      program_->data_.insert(program_->data_.end(), bytes.begin(),
+                             bytes.begin() + (instruction.size + 7) / 8);
+    }
+  }
+  program_->instructions_.push_back(instruction);
+}
+
+namespace {
+
+//
+// Binary format of ExpressionProgram in native byte order
+// magic "MOTIONEP", uint64 version, # of instructions, # of operands, # of bytes of data
+// instruction records of kInstructionSize bytes:
+//   uint8 opcode, argument, value size, reserved, uint32 nodes[3],
+//   uint64 size, number of wires, owner, offset
+// uint32 operands, bytes of data
+//
+
+constexpr std::array<char, 8> kProgramMagic{'M', 'O', 'T', 'I', 'O', 'N', 'E', 'P'};
+constexpr std::uint64_t kProgramVersion{1};
+constexpr std::size_t kInstructionSize{4 + 3 * sizeof(std::uint32_t) + 4 * sizeof(std::uint64_t)};
+
+template <typename T>
+void WriteValue(std::ofstream& stream, T value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool IsConstant(MpcProtocol protocol) {
+  return protocol == MpcProtocol::kArithmeticConstant ||
+         protocol == MpcProtocol::kBooleanConstant;
+}
+
+template <typename T>
+void ReplayArithmeticInput(ExpressionBuilder& builder, MpcProtocol protocol,
+                           const ExpressionProgram::Instruction& instruction,
+                           std::span<const std::byte> data) {
+  std::vector<T> values(instruction.size);
+  if (protocol == MpcProtocol::kArithmeticConstant) {
+    std::memcpy(values.data(), data.data() + instruction.offset, values.size() * sizeof(T));
+  }
+  const std::span<const T> input(values);
+  switch (protocol) {
+    case MpcProtocol::kArithmeticGmw:
+      builder.Input<MpcProtocol::kArithmeticGmw>(input, instruction.owner);
+      break;
+    case MpcProtocol::kAstra:
+      builder.Input<MpcProtocol::kAstra>(input, instruction.owner);
+      break;
+    case MpcProtocol::kArithmeticReplicated:
+      builder.Input<MpcProtocol::kArithmeticReplicated>(input, instruction.owner);
+      break;
+    case MpcProtocol::kArithmeticConstant:
+      builder.Input<MpcProtocol::kArithmeticConstant>(input, instruction.owner);
+      break;
+    default:
+      throw std::invalid_argument(
+          fmt::format("Cannot replay an arithmetic input in {}", to_string(protocol)));
+  }
+}
+
+void ReplayBooleanInput(ExpressionBuilder& builder, MpcProtocol protocol,
+                        const ExpressionProgram::Instruction& instruction,
+                        std::span<const std::byte> data) {
+  std::vector<BitVector<>> wires(instruction.number_of_wires, BitVector<>(instruction.size));
+  if (protocol == MpcProtocol::kBooleanConstant) {
+    const std::size_t bytes_per_wire{(instruction.size + 7) / 8};
+    for (std::size_t i = 0; i < wires.size(); ++i) {
+      wires[i] = BitVector<>(data.data() + instruction.offset + i * bytes_per_wire,
+                             instruction.size);
+    }
+  }
+  const std::span<const BitVector<>> input(wires);
+  switch (protocol) {
+    case MpcProtocol::kBooleanGmw:
+      builder.Input<MpcProtocol::kBooleanGmw>(input, instruction.owner);
+      break;
+    case MpcProtocol::kBmr:
+      builder.Input<MpcProtocol::kBmr>(input, instruction.owner);
+      break;
+    case MpcProtocol::kGarbledCircuit:
+      builder.Input<MpcProtocol::kGarbledCircuit>(input, instruction.owner);
+      break;
+    case MpcProtocol::kBooleanReplicated:
+      builder.Input<MpcProtocol::kBooleanReplicated>(input, instruction.owner);
+      break;
+    case MpcProtocol::kBooleanConstant:
+      builder.Input<MpcProtocol::kBooleanConstant>(input, instruction.owner);
+      break;
+    default:
+      throw std::invalid_argument(
+          fmt::format("Cannot replay a Boolean input in {}", to_string(protocol)));
+  }
+}
+
+}  // namespace
+
+std::size_t ExpressionProgram::GetNumberOfInputGates() const {
+  return std::count_if(instructions_.begin(), instructions_.end(), [](const auto& instruction) {
+    return instruction.opcode == Opcode::kInput &&
+           !IsConstant(static_cast<MpcProtocol>(instruction.argument));
+  });
+}
+
+void ExpressionProgram::Replay(ExpressionBuilder& builder) const {
+  if (builder.GetNumberOfNodes() != 0) {
+    throw std::invalid_argument("ExpressionProgram::Replay needs an empty ExpressionBuilder");
+  }
+  builder.Reserve(instructions_.size());
+  std::vector<ExpressionBuilder::Node> results;
+  for (const auto& instruction : instructions_) {
+    const auto& [a, b, c]{instruction.nodes};
+    switch (instruction.opcode) {
+      case Opcode::kInput: {
+        const auto protocol{static_cast<MpcProtocol>(instruction.argument)};
+        switch (instruction.value_size) {
+          case 0:
+            ReplayBooleanInput(builder, protocol, instruction, data_);
+            break;
+          case sizeof(std::uint8_t):
+            ReplayArithmeticInput<std::uint8_t>(builder, protocol, instruction, data_);
+            break;
+          case sizeof(std::uint16_t):
+            ReplayArithmeticInput<std::uint16_t>(builder, protocol, instruction, data_);
+            break;
+          case sizeof(std::uint32_t):
+            ReplayArithmeticInput<std::uint32_t>(builder, protocol, instruction, data_);
+            break;
+          case sizeof(std::uint64_t):
+            ReplayArithmeticInput<std::uint64_t>(builder, protocol, instruction, data_);
+            break;
+          case sizeof(__uint128_t):
+            ReplayArithmeticInput<__uint128_t>(builder, protocol, instruction, data_);
+            break;
+          default:
+            throw std::invalid_argument(
+                fmt::format("Cannot replay inputs of {} bytes", instruction.value_size));
+        }
+        break;
+      }
+      case Opcode::kApply:
+        builder.Apply(static_cast<ExpressionBuilder::Operation>(instruction.argument), a, b);
+        break;
+      case Opcode::kNot:
+        builder.Not(a);
+        break;
+      case Opcode::kMux:
+        builder.Mux(a, b, c);
+        break;
+      case Opcode::kSimdify:
+        builder.Simdify(std::span(operands_).subspan(instruction.offset, instruction.size));
+        break;
+      case Opcode::kUnsimdify:
+        results.resize(instruction.size);
+        builder.Unsimdify(a, results);
+        break;
+      case Opcode::kOutput:
+        builder.Output(a, instruction.owner);
+        break;
+      case Opcode::kInvalid:
+        throw std::invalid_argument("Cannot replay an invalid instruction");
+    }
+  }
+}
+
+ExpressionProgram ExpressionProgram::FromBinary(const std::string& path) {
+  const MappedFile file(path);
+  const auto bytes{file.GetBytes()};
+  std::size_t position{0};
+  const auto advance = [&](std::size_t number_of_bytes) {
+    if (bytes.size() - position < number_of_bytes) {
+      throw std::runtime_error(fmt::format("Expression program {} is truncated", path));
+    }
+    const std::byte* data{bytes.data() + position};
+    position += number_of_bytes;
+    return data;
+  };
+  if (std::memcmp(advance(kProgramMagic.size()), kProgramMagic.data(), kProgramMagic.size()) !=
+      0) {
+    throw std::runtime_error(fmt::format("{} is not an expression program", path));
+  }
+  std::uint64_t version, number_of_instructions, number_of_operands, number_of_bytes;
+  for (auto value : {&version, &number_of_instructions, &number_of_operands, &number_of_bytes}) {
+    std::memcpy(value, advance(sizeof(*value)), sizeof(*value));
+  }
+  if (version != kProgramVersion) {
+    throw std::runtime_error(fmt::format("Expression program {} has version {} but expected {}",
+                                         path, version, kProgramVersion));
+  }
+  // the records are checked against the size of the file before allocating them
+  if ((bytes.size() - position) / kInstructionSize < number_of_instructions) {
+    throw std::runtime_error(fmt::format("Expression program {} is truncated", path));
+  }
+
+  ExpressionProgram program;
+  program.instructions_.resize(number_of_instructions);
+  for (auto& instruction : program.instructions_) {
+    const std::byte* record{advance(kInstructionSize)};
+    if (static_cast<std::uint8_t>(record[0]) >= static_cast<std::uint8_t>(Opcode::kInvalid)) {
+      throw std::runtime_error(fmt::format("Invalid opcode {} in expression program {}",
+                                           static_cast<unsigned>(record[0]), path));
+    }
+    instruction.opcode = static_cast<Opcode>(record[0]);
+    instruction.argument = static_cast<std::uint8_t>(record[1]);
+    instruction.value_size = static_cast<std::uint8_t>(record[2]);
+    std::memcpy(instruction.nodes.data(), record + 4, sizeof(instruction.nodes));
+    const std::byte* fields{record + 4 + sizeof(instruction.nodes)};
+    for (auto field : {&instruction.size, &instruction.number_of_wires, &instruction.owner,
+                       &instruction.offset}) {
+      std::memcpy(field, fields, sizeof(*field));
+      fields += sizeof(*field);
+    }
+  }
+  if ((bytes.size() - position) / sizeof(ExpressionBuilder::Node) < number_of_operands) {
+    throw std::runtime_error(fmt::format("Expression program {} is truncated", path));
+  }
+  program.operands_.resize(number_of_operands);
+  std::memcpy(program.operands_.data(),
+              advance(number_of_operands * sizeof(ExpressionBuilder::Node)),
+              number_of_operands * sizeof(ExpressionBuilder::Node));
+  const std::byte* data{advance(number_of_bytes)};
+  program.data_.assign(data, data + number_of_bytes);
+
+  // Replay reads the operands and the data of constants without checking their bounds
+  for (const auto& instruction : program.instructions_) {
+    std::uint64_t end{0}, limit{0};
+    if (instruction.opcode == Opcode::kSimdify) {
+      end = instruction.offset + instruction.size;
+      limit = number_of_operands;
+    } else if (instruction.opcode == Opcode::kInput &&
+               IsConstant(static_cast<MpcProtocol>(instruction.argument))) {
+      const std::uint64_t bytes_per_value_or_wire{
+          instruction.value_size == 0 ? (instruction.size + 7) / 8 : instruction.value_size};
+      const std::uint64_t count{instruction.value_size == 0 ? instruction.number_of_wires
+                                                            : instruction.size};
+      if (bytes_per_value_or_wire != 0 &&
+          count > std::numeric_limits<std::uint64_t>::max() / bytes_per_value_or_wire) {
+        throw std::runtime_error(fmt::format("Invalid constant in expression program {}", path));
+      }
+      end = instruction.offset + bytes_per_value_or_wire * count;
+      limit = number_of_bytes;
+    }
+    if (end < instruction.offset || end > limit) {
+      throw std::runtime_error(
+          fmt::format("Expression program {} refers to operands or data beyond its end", path));
+    }
+  }
+  return program;
+}
+
+void ExpressionProgram::ToBinary(const std::string& path) const {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw std::runtime_error(fmt::format("Could not create expression program {}", path));
+  }
+  stream.write(kProgramMagic.data(), kProgramMagic.size());
+  for (std::uint64_t value : {kProgramVersion, std::uint64_t(instructions_.size()),
+                              std::uint64_t(operands_.size()), std::uint64_t(data_.size())}) {
+    WriteValue(stream, value);
+  }
+  for (const auto& instruction : instructions_) {
+    const std::array<std::uint8_t, 4> header{static_cast<std::uint8_t>(instruction.opcode),
+                                             instruction.argument, instruction.value_size, 0};
+    stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+    for (const auto node : instruction.nodes) WriteValue(stream, node);
+    for (const auto value : {instruction.size, instruction.number_of_wires, instruction.owner,
+                             instruction.offset}) {
+      WriteValue(stream, value);
+    }
+  }
+  stream.write(reinterpret_cast<const char*>(operands_.data()),
+               operands_.size() * sizeof(ExpressionBuilder::Node));
+  stream.write(reinterpret_cast<const char*>(data_.data()), data_.size());
+  stream.close();
+  if (stream.fail()) {
+    throw std::runtime_error(fmt::format("Could not write expression program {}", path));
+  }
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,224 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+class ExpressionProgram;
+
+/// \brief Builds a circuit through integer handles instead of ShareWrappers, for code generators
+/// that emit one call per operation of the source program.
+///
+/// The shares of all nodes are kept in one vector, which is indexed by the handles, so building an
+/// expression neither copies shared pointers nor allocates vectors of ShareWrappers.  Inputs of
+/// many values are created by one input gate, and the bulk operations evaluate interactive
+/// operations on many scalar nodes by a single SIMD gate.
+class ExpressionBuilder {
+ public:
+  using Node = std::uint32_t;
+
+  static constexpr std::size_t kAll{std::numeric_limits<std::int64_t>::max()};
+
+  /// \brief The binary operations of ShareWrapper.
+  enum class Operation : std::uint8_t {
+    kXor,
+    kAnd,
+    kOr,
+    kAdd,
+    kSubtract,
+    kMultiply,
+    kEqual,
+    kGreaterThan
+  };
+
+  /// \param program if not null, records the calls of this builder, s.t. the same gates can be
+  /// built in another process by ExpressionProgram::Replay
+  explicit ExpressionBuilder(Party& party, ExpressionProgram* program = nullptr)
+      : party_(party), program_(program) {}
+
+  /// \brief Reserves space for \p number_of_nodes nodes, e.g., the number of nodes of the generated
+  /// program.
+  void Reserve(std::size_t number_of_nodes) { shares_.reserve(number_of_nodes); }
+
+  std::size_t GetNumberOfNodes() const { return shares_.size(); }
+
+  /// \throws std::out_of_range if \p node was not created by this builder
+  const ShareWrapper& Get(Node node) const { return shares_.at(node); }
+
+  /// \brief Adds an existing share as a node, e.g., the result of an algorithm of ShareWrapper.
+  /// \throws std::logic_error if the builder records an ExpressionProgram, which cannot rebuild
+  /// the gates of the share
+  Node Insert(ShareWrapper share);
+
+  /// \brief Creates one node holding the \p values as SIMD values, see Party::In.
+  template <MpcProtocol P, typename T>
+  Node Input(std::span<const T> values, std::size_t input_owner) {
+    const auto node{
+        AddNode(party_.In<P>(std::vector<T>(values.begin(), values.end()), input_owner))};
+    if (program_) RecordInput(P, sizeof(T), values.size(), input_owner, std::as_bytes(values));
+    return node;
+  }
+
+  /// \brief Creates one node of a Boolean share with the \p wires, see Party::In.
+  template <MpcProtocol P>
+  Node Input(std::span<const BitVector<>> wires, std::size_t input_owner) {
+    const auto node{AddNode(party_.In<P>(wires, input_owner))};
+    if (program_) RecordInput(P, wires, input_owner);
+    return node;
+  }
+
+  /// \brief Creates one scalar node per value in \p nodes, which are split off a single input
+  /// gate of all \p values.
+  /// \throws std::invalid_argument if \p values and \p nodes differ in size
+  template <MpcProtocol P, typename T>
+  void Inputs(std::span<const T> values, std::size_t input_owner, std::span<Node> nodes) {
+    Unsimdify(Input<P>(values, input_owner), nodes);
+  }
+
+  Node Apply(Operation operation, Node a, Node b);
+
+  /// \brief Applies \p operation to the pairs of nodes of \p a and \p b.  Interactive operations
+  /// on more than one pair of scalar nodes are evaluated on the simdified nodes, s.t. all pairs
+  /// share one gate.
+  /// \throws std::invalid_argument if \p a, \p b and \p result differ in size
+  void Apply(Operation operation, std::span<const Node> a, std::span<const Node> b,
+             std::span<Node> result);
+
+  Node Not(Node a);
+
+  /// \brief Returns \p a if \p selection is 1 and \p b otherwise, see ShareWrapper::Mux.
+  Node Mux(Node selection, Node a, Node b);
+
+  /// \brief Creates one node holding the SIMD values of \p nodes, see ShareWrapper::Simdify.
+  Node Simdify(std::span<const Node> nodes);
+
+  /// \brief Splits \p node into one node per SIMD value, see ShareWrapper::Unsimdify.
+  /// \throws std::invalid_argument if \p result differs in size from the SIMD values of \p node
+  void Unsimdify(Node node, std::span<Node> result);
+
+  Node Output(Node node, std::size_t output_owner = kAll);
+
+  /// \brief Creates an output of the simdified \p nodes, whose values are returned by
+  /// Get(result).As<std::vector<T>>() resp. As<std::vector<BitVector<>>>() in the order of
+  /// \p nodes.
+  Node Outputs(std::span<const Node> nodes, std::size_t output_owner = kAll);
+
+ private:
+  Node AddNode(ShareWrapper share);
+
+  // records an arithmetic input, whose values are only stored for public constants
+  void RecordInput(MpcProtocol protocol, std::size_t value_size, std::size_t number_of_values,
+                   std::size_t input_owner, std::span<const std::byte> values);
+
+  void RecordInput(MpcProtocol protocol, std::span<const BitVector<>> wires,
+                   std::size_t input_owner);
+
+  Party& party_;
+  ExpressionProgram* program_;
+  std::vector<ShareWrapper> shares_;
+};
+
+/// \brief The calls of an ExpressionBuilder, from which another party builds the same gates, e.g.,
+/// the workers of a pool that all evaluate one circuit.  The gates and shares themselves belong to
+/// a Register and cannot be copied into another process, but replaying the calls of the builder
+/// does not run the code that generated them and takes one pass over fixed-size instructions.
+///
+/// The inputs of the parties are replayed as zeros of the recorded dimensions, only the values of
+/// public constants are stored.  The i-th input instruction of a protocol that is no constant
+/// creates the i-th input gate of the Register, whose values are set by CompiledCircuit::SetInput
+/// after Party::Compile.  The nodes of the replayed calls get the same handles as the recorded
+/// ones, s.t. the outputs can be found by the handles returned while recording.
+class ExpressionProgram {
+ public:
+  enum class Opcode : std::uint8_t {
+    kInput,
+    kApply,
+    kNot,
+    kMux,
+    kSimdify,
+    kUnsimdify,
+    kOutput,
+    kInvalid  // for checking whether the value is valid
+  };
+
+  struct Instruction {
+    Opcode opcode{Opcode::kInvalid};
+    // the ExpressionBuilder::Operation of kApply or the MpcProtocol of kInput
+    std::uint8_t argument{0};
+    // the bytes per value of arithmetic inputs and 0 for Boolean inputs
+    std::uint8_t value_size{0};
+    // the operands, i.e., the selection bit and both values of kMux
+    std::array<ExpressionBuilder::Node, 3> nodes{};
+    // the number of (SIMD) values of kInput and kUnsimdify or of nodes of kSimdify
+    std::uint64_t size{0};
+    // the number of wires of Boolean inputs
+    std::uint64_t number_of_wires{0};
+    // the input owner of kInput or the output owner of kOutput
+    std::uint64_t owner{0};
+    // the position of the first node of kSimdify in the operands or of the values of constant
+    // inputs in the data of the program
+    std::uint64_t offset{0};
+  };
+
+  const std::vector<Instruction>& GetInstructions() const noexcept { return instructions_; }
+
+  /// \brief Number of input gates created by Replay, see CompiledCircuit::GetInputGates.
+  std::size_t GetNumberOfInputGates() const;
+
+  /// \brief Makes the recorded calls on \p builder, which needs to be empty.
+  /// \throws std::invalid_argument if \p builder already holds nodes or an instruction has an
+  /// unsupported protocol or value size
+  void Replay(ExpressionBuilder& builder) const;
+
+  /// \brief reads a program in the binary format of ToBinary from a memory-mapped file.
+  /// \throws std::runtime_error if the file cannot be read, is no program or refers to operands
+  /// or data outside of the file
+  static ExpressionProgram FromBinary(const std::string& path);
+
+  /// \brief writes this program in a binary format of fixed-size instructions.
+  /// \throws std::runtime_error if the file cannot be written
+  void ToBinary(const std::string& path) const;
+
+ private:
+  friend class ExpressionBuilder;
+
+  std::vector<Instruction> instructions_;
+  std::vector<ExpressionBuilder::Node> operands_;
+  std::vector<std::byte> data_;
+};
+
+}  // namespace encrypto::motion
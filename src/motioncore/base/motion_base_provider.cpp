@@ -71,7 +71,11 @@ void BaseProvider::Setup() {
         kMotionVersionMinor, kMotionVersionPatch);
     communication_layer_.SendMessage(party_id, msg_builder.Release());
   }
-  // initialize my randomness generators
+  // initialize my randomness generators, the one for myself uses a private seed, which is never
+  // sent, for the non-interactive random shares of the RandomGates
+  my_randomness_generators_.at(my_id_) =
+      std::make_unique<primitives::SharingRandomnessGenerator>(my_id_);
+  my_randomness_generators_.at(my_id_)->Initialize(my_seeds.at(my_id_).data());
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
     if (party_id == my_id_) {
       continue;
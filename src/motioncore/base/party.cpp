@@ -28,8 +28,12 @@
 #include "base/configuration.h"
 #include "base/register.h"
 #include "communication/communication_layer.h"
+#include "executor/gate_executor.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_provider.h"
 #include "oblivious_transfer/ot_provider.h"
+#include "protocols/astra/astra_provider.h"
+#include "statistics/run_time_statistics.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/logger.h"
 
 namespace encrypto::motion {
@@ -84,16 +88,33 @@ SharePointer Party::Out(SharePointer parent, std::size_t output_owner) {
   }
 }
 
+TuningProfile Party::TuneConfiguration(const std::string& profile_path) {
+  const TuningProfile profile{encrypto::motion::TuneConfiguration(
+      backend_->GetCommunicationLayer(), *configuration_, profile_path)};
+  logger_->LogInfo(
+      "Tuned the configuration: {} hardware threads, {} us round-trip time, {} bit/s bandwidth, "
+      "silent OT extension {}, dataflow evaluation {}",
+      profile.number_of_hardware_threads, profile.round_trip_time.count(), profile.bandwidth,
+      configuration_->GetSilentOtExtension(), configuration_->GetDataflowEvaluation());
+  return profile;
+}
+
 void Party::Run(std::size_t repetitions) {
   logger_->LogDebug("Party run");
   if(repetitions != 1){
     throw std::runtime_error("This functionality is not yet implemented");
   }
+  if (!configuration_->GetPreprocessingOutputPath().empty()) {
+    // the stored MTs, SPs and SBs would be used by this run and a later one
+    throw std::logic_error(
+        "A run cannot store its preprocessing, call Backend::RunPreprocessing to store it");
+  }
 
   // TODO: fix check if work exists s.t. it does not require knowledge about OT
   // internals etc.
   bool work_exists{backend_->GetOtProviderManager().HasWork() ||
-                   backend_->GetKk13OtProviderManager().HasWork() ||
+                   (backend_->FindKk13OtProviderManager() &&
+                    backend_->FindKk13OtProviderManager()->HasWork()) ||
                    !backend_->GetRegister()->GetGates().empty()};
   if (!work_exists) {
     logger_->LogInfo("Party terminate: no work to do");
@@ -105,13 +126,62 @@ void Party::Run(std::size_t repetitions) {
     if (i > 0u) {
       Clear();
     }
-    logger_->LogDebug(fmt::format("Circuit evaluation #{}", i));
+    logger_->LogDebug("Circuit evaluation #{}", i);
     EvaluateCircuit();
   }
 }
 
+CompiledCircuit& Party::CompilePipelined(std::size_t number_of_instances,
+                                        std::size_t number_of_instances_in_flight,
+                                        const std::function<void(std::size_t)>& build_instance) {
+  std::vector<std::size_t> instance_offsets;
+  instance_offsets.reserve(number_of_instances);
+  for (std::size_t instance = 0; instance < number_of_instances; ++instance) {
+    instance_offsets.push_back(instance == 0 ? 0 : backend_->GetRegister()->GetGates().size());
+    build_instance(instance);
+  }
+  return backend_->Compile(std::move(instance_offsets), number_of_instances_in_flight);
+}
+
+std::future<void> Party::RunAsync(std::function<void()> callback) {
+  std::packaged_task<void()> task([this, callback = std::move(callback)] {
+    Run();
+    if (callback) {
+      callback();
+    }
+  });
+  auto future{task.get_future()};
+  {
+    std::scoped_lock lock(async_mutex_);
+    if (async_stopped_) {
+      throw std::logic_error("RunAsync must not be called after Finish");
+    }
+    async_tasks_.push_back(std::move(task));
+    if (!async_thread_.joinable()) {
+      async_thread_ = std::thread([this] { RunAsyncTasks(); });
+    }
+  }
+  async_condition_.notify_one();
+  return future;
+}
+
+void Party::RunAsyncTasks() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock lock(async_mutex_);
+      async_condition_.wait(lock, [this] { return async_stopped_ || !async_tasks_.empty(); });
+      if (async_tasks_.empty()) {
+        return;
+      }
+      task = std::move(async_tasks_.front());
+      async_tasks_.pop_front();
+    }
+    task();
+  }
+}
+
 void Party::Reset() {
-  logger_->LogError("Not yet implemented");
   backend_->Synchronize();
   logger_->LogDebug("Party reset");
   backend_->Reset();
@@ -131,19 +201,43 @@ void Party::Clear() {
 }
 
 void Party::EvaluateCircuit() {
-  if (configuration_->GetOnlineAfterSetup()) {
+  if (backend_->GetCompiledCircuit() != nullptr) {
+    backend_->EvaluateCompiled();
+  } else if (configuration_->GetDataflowEvaluation()) {
+    backend_->EvaluateDataflow();
+  } else if (configuration_->GetLayeredEvaluation()) {
+    backend_->EvaluateLayered();
+  } else if (configuration_->GetOnlineAfterSetup()) {
     backend_->EvaluateSequential();
   } else {
     backend_->EvaluateParallel();
   }
+  // after the online phase s.t. all messages of the circuit are checked at once
+  if (auto astra_provider{backend_->FindAstraProvider()}) astra_provider->Verify();
+  backend_->GetMutableRunTimeStatistics().back().RecordMemoryUsage();
 }
 
 void Party::Finish() {
+  // complete the evaluations submitted via RunAsync before shutting down
+  {
+    std::scoped_lock lock(async_mutex_);
+    async_stopped_ = true;
+  }
+  async_condition_.notify_one();
+  if (async_thread_.joinable()) {
+    if (async_thread_.get_id() == std::this_thread::get_id()) {
+      throw std::logic_error("Finish must not be called from a RunAsync callback");
+    }
+    async_thread_.join();
+  }
+
   bool finished = finished_.exchange(true);
   if (!finished) {
+    // OTs of a random OT pool may still be sent in the background
+    backend_->GetOtProviderManager().FinishRandomOtPools();
     backend_->GetCommunicationLayer().Shutdown();
-    logger_->LogInfo(fmt::format("Finished evaluating {} gates",
-                                 backend_->GetRegister()->GetTotalNumberOfGates()));
+    logger_->LogInfo("Finished evaluating {} gates",
+                     backend_->GetRegister()->GetTotalNumberOfGates());
   }
 }
 
@@ -164,4 +258,26 @@ std::vector<std::unique_ptr<Party>> MakeLocallyConnectedParties(const std::size_
   return motion_parties;
 }
 
+std::vector<std::unique_ptr<Party>> MakeSimulatedParties(std::size_t number_of_parties,
+                                                         std::size_t number_of_worker_threads) {
+  if (number_of_parties < 2) {
+    throw std::invalid_argument(fmt::format(
+        "Can simulate only >= 2 parties, current input: {}", number_of_parties));
+  }
+  auto fiber_pool = std::make_shared<FiberThreadPool>(number_of_worker_threads);
+  auto comm_layers = communication::MakeDummyCommunicationLayers(number_of_parties);
+
+  std::vector<PartyPointer> motion_parties;
+  motion_parties.reserve(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    // batches would copy the messages twice more, the DummyTransports move them
+    comm_layers.at(party_id)->SetMessageCoalescing(false);
+    auto& party = motion_parties.emplace_back(
+        std::make_unique<Party>(std::move(comm_layers.at(party_id))));
+    party->GetConfiguration()->SetMessageVerification(false);
+    party->GetBackend()->GetGateExecutor().SetFiberPool(fiber_pool);
+  }
+  return motion_parties;
+}
+
 }  // namespace encrypto::motion
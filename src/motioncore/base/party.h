@@ -25,12 +25,21 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <span>
+#include <string>
 #include <vector>
 
 #include "base/backend.h"
+#include "base/compiled_circuit.h"
 #include "base/configuration.h"
+#include "base/configuration_tuner.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
@@ -61,17 +70,23 @@ class Party {
 
   ConfigurationPointer GetConfiguration() { return configuration_; }
 
+  /// \brief Chooses the settings of GetConfiguration for the host and the network to the other
+  /// parties, which are measured or loaded from \p profile_path, see TuneConfiguration in
+  /// base/configuration_tuner.h.  Needs to be called by all parties at the same time before the
+  /// circuit is built.
+  TuningProfile TuneConfiguration(const std::string& profile_path = {});
+
   template <MpcProtocol P>
   SharePointer In(std::span<const BitVector<>> input,
                   std::size_t party_id = std::numeric_limits<std::size_t>::max()) {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
     static_assert(P != MpcProtocol::kAstra);
+    static_assert(P != MpcProtocol::kArithmeticReplicated);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBooleanConstant, "Not implemented yet");
-        // return backend_->BooleanGmwInput(party_id, input);
+        // public constants have no input owner
+        return backend_->ConstantBooleanInput(input);
       }
       case MpcProtocol::kBooleanGmw: {
         return backend_->BooleanGmwInput(party_id, input);
@@ -82,6 +97,10 @@ class Party {
       case MpcProtocol::kGarbledCircuit: {
         return backend_->GarbledCircuitInput(party_id, input);
       }
+      case MpcProtocol::kBooleanReplicated: {
+        return backend_->BooleanReplicatedInput(
+            party_id, std::vector<BitVector<>>(input.begin(), input.end()));
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -124,11 +143,11 @@ class Party {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
     static_assert(P != MpcProtocol::kAstra);
+    static_assert(P != MpcProtocol::kArithmeticReplicated);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBooleanConstant, "Not implemented yet");
-        // return backend_->BooleanGmwInput(party_id, input);
+        // public constants have no input owner
+        return backend_->ConstantBooleanInput(std::move(input));
       }
       case MpcProtocol::kBooleanGmw: {
         return backend_->BooleanGmwInput(party_id, std::move(input));
@@ -139,6 +158,9 @@ class Party {
       case MpcProtocol::kGarbledCircuit: {
         return backend_->GarbledCircuitInput(party_id, input);
       }
+      case MpcProtocol::kBooleanReplicated: {
+        return backend_->BooleanReplicatedInput(party_id, std::move(input));
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -152,11 +174,11 @@ class Party {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
     static_assert(P != MpcProtocol::kAstra);
+    static_assert(P != MpcProtocol::kArithmeticReplicated);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBooleanConstant, "Not implemented yet");
-        // return backend_->BooleanGmwInput(party_id, input);
+        // public constants have no input owner
+        return backend_->ConstantBooleanInput(std::vector<BitVector<>>{input});
       }
       case MpcProtocol::kBooleanGmw: {
         return backend_->BooleanGmwInput(party_id, input);
@@ -164,6 +186,9 @@ class Party {
       case MpcProtocol::kBmr: {
         return backend_->BmrInput(party_id, input);
       }
+      case MpcProtocol::kBooleanReplicated: {
+        return backend_->BooleanReplicatedInput(party_id, {input});
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -177,11 +202,11 @@ class Party {
     static_assert(P != MpcProtocol::kArithmeticGmw);
     static_assert(P != MpcProtocol::kArithmeticConstant);
     static_assert(P != MpcProtocol::kAstra);
+    static_assert(P != MpcProtocol::kArithmeticReplicated);
     switch (P) {
       case MpcProtocol::kBooleanConstant: {
-        // TODO implement
-        static_assert(P != MpcProtocol::kBooleanConstant, "Not implemented yet");
-        // return backend_->BooleanGmwInput(party_id, input);
+        // public constants have no input owner
+        return backend_->ConstantBooleanInput(std::vector<BitVector<>>{std::move(input)});
       }
       case MpcProtocol::kBooleanGmw: {
         return backend_->BooleanGmwInput(party_id, std::move(input));
@@ -189,6 +214,9 @@ class Party {
       case MpcProtocol::kBmr: {
         return backend_->BmrInput(party_id, input);
       }
+      case MpcProtocol::kBooleanReplicated: {
+        return backend_->BooleanReplicatedInput(party_id, {std::move(input)});
+      }
       default: {
         throw(std::runtime_error(
             fmt::format("Unknown MPC protocol with id {}", static_cast<unsigned int>(P))));
@@ -219,6 +247,14 @@ class Party {
       case MpcProtocol::kAstra: {
         return backend_->AstraInput<T>(party_id, input);
       }
+      case MpcProtocol::kArithmeticReplicated: {
+        if constexpr (std::is_unsigned_v<T>) {
+          return backend_->ArithmeticReplicatedInput<T>(party_id, input);
+        } else {
+          return backend_->ArithmeticReplicatedInput<std::make_unsigned_t<T>>(
+              party_id, ToTwosComplement<T>(input));
+        }
+      }
       case MpcProtocol::kBooleanGmw: {
         throw std::runtime_error(
             "Non-binary types have to be converted to BitVectors in BooleanGMW, "
@@ -259,6 +295,14 @@ class Party {
       case MpcProtocol::kAstra: {
         return backend_->AstraInput<T>(party_id, std::move(input));
       }
+      case MpcProtocol::kArithmeticReplicated: {
+        if constexpr (std::is_unsigned_v<T>) {
+          return backend_->ArithmeticReplicatedInput<T>(party_id, input);
+        } else {
+          return backend_->ArithmeticReplicatedInput<std::make_unsigned_t<T>>(
+              party_id, ToTwosComplement<T>(input));
+        }
+      }
       case MpcProtocol::kBooleanGmw: {
         throw(std::runtime_error(
             fmt::format("Non-binary types have to be converted to BitVectors in BooleanGMW, "
@@ -281,6 +325,8 @@ class Party {
     if constexpr (std::is_same_v<T, bool>) {
       if constexpr (P == MpcProtocol::kBooleanGmw)
         return backend_->BooleanGmwInput(party_id, input);
+      else if constexpr (P == MpcProtocol::kBooleanReplicated)
+        return backend_->BooleanReplicatedInput(party_id, {BitVector<>(1, input)});
       else
         return backend_->BmrInput(party_id, input);
     } else {
@@ -402,7 +448,32 @@ class Party {
   /// @param repetitions Number of iterations.
   void Run(std::size_t repetitions = 1);
 
-  /// \brief Destroys all the gates and wires that were constructed until now.
+  /// \brief Starts Party::Run() on the background thread of this party and returns immediately.
+  /// The returned future becomes ready when the evaluation has finished, or holds the exception
+  /// thrown by it, such that the outputs can be read without blocking.  If given, \p callback is
+  /// invoked on the background thread after a successful evaluation and before the future becomes
+  /// ready.  Evaluations submitted while another one is still running are queued.  The circuit must
+  /// not be modified and Party::Finish() must not be called from \p callback.
+  std::future<void> RunAsync(std::function<void()> callback = {});
+
+  /// \brief Compiles the gates constructed until now into a flat gate graph which Party::Run()
+  /// evaluates from then on.  Afterwards, the circuit can be re-run with fresh inputs by calling
+  /// Party::Clear(), CompiledCircuit::SetInput and Party::Run() again.
+  CompiledCircuit& Compile() { return backend_->Compile(); }
+
+  /// \brief Constructs \p number_of_instances independent instances of a circuit by calling
+  /// \p build_instance with the index of each instance and compiles them like Party::Compile().
+  /// Party::Run() keeps at most \p number_of_instances_in_flight of them in evaluation at the same
+  /// time (0 for no limit), s.t. the later instances are set up while the earlier ones are in their
+  /// online phase and output reconstruction.  Gates constructed before become part of the first
+  /// instance.  The inputs of the instances are replaced for the next batch via
+  /// CompiledCircuit::GetFirstInputOfInstance and CompiledCircuit::SetInput.
+  CompiledCircuit& CompilePipelined(std::size_t number_of_instances,
+                                    std::size_t number_of_instances_in_flight,
+                                    const std::function<void(std::size_t)>& build_instance);
+
+  /// \brief Destroys all the gates and wires that were constructed until now, s.t. a new circuit
+  /// can be constructed and run.  The base OTs are kept for the next run, see Backend::Reset.
   void Reset();
 
   /// \brief Interprets the gates and wires as newly created, i.e., Party::Run()
@@ -431,7 +502,16 @@ class Party {
   BackendPointer backend_;
   std::atomic<bool> finished_ = false;
 
+  // evaluations submitted via RunAsync, which are run one after another by async_thread_
+  std::mutex async_mutex_;
+  std::condition_variable async_condition_;
+  std::deque<std::packaged_task<void()>> async_tasks_;
+  bool async_stopped_ = false;
+  std::thread async_thread_;
+
   void EvaluateCircuit();
+
+  void RunAsyncTasks();
 };
 
 /// \brief constructs number_of_parties motion::Party's *locally* connected via TCP.
@@ -442,6 +522,14 @@ std::vector<std::unique_ptr<Party>> MakeLocallyConnectedParties(const std::size_
                                                                 std::uint16_t port,
                                                                 const bool logging = false);
 
+/// \brief Constructs number_of_parties motion::Party's that are simulated in this process, e.g.,
+/// for capacity planning on one machine.  The messages are moved into the queue of the receiving
+/// party and sent one by one without verification, s.t. they are not copied into batches.  All
+/// parties evaluate their gates in one fiber pool of number_of_worker_threads workers instead of a
+/// pool per party, 0 for one worker per hardware thread.
+std::vector<std::unique_ptr<Party>> MakeSimulatedParties(std::size_t number_of_parties,
+                                                         std::size_t number_of_worker_threads = 0);
+
 using PartyPointer = std::unique_ptr<Party>;
 
 }  // namespace encrypto::motion
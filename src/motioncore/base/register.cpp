@@ -24,10 +24,16 @@
 
 #include "register.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
 
 #include <fmt/format.h>
 
+#include "algorithm/algorithm_description.h"
+#include "algorithm/arithmetic_algorithm_description.h"
+#include "algorithm/embedded_circuits.h"
+#include "algorithm/evaluation_template.h"
 #include "configuration.h"
 #include "protocols/gate.h"
 #include "protocols/wire.h"
@@ -37,7 +43,8 @@
 
 namespace encrypto::motion {
 
-Register::Register(std::shared_ptr<Logger> logger) : logger_(std::move(logger)) {
+Register::Register(std::shared_ptr<Logger> logger)
+    : logger_(std::move(logger)), arena_(std::make_unique<Arena>()) {
   gates_setup_done_condition_ =
       std::make_shared<FiberCondition>([this]() { return gates_setup_done_flag_; });
   gates_online_done_condition_ =
@@ -45,8 +52,15 @@ Register::Register(std::shared_ptr<Logger> logger) : logger_(std::move(logger))
 }
 
 Register::~Register() {
+  gate_layers_.clear();
+  unlayered_gates_.clear();
   gates_.clear();
   wires_.clear();
+  // objects that outlive the register keep the memory of their arena, which is leaked
+  if (arena_->HasLiveObjects()) static_cast<void>(arena_.release());
+  for (auto& arena : retired_arenas_) {
+    if (arena->HasLiveObjects()) static_cast<void>(arena.release());
+  }
 }
 
 std::size_t Register::NextGateId() noexcept {
@@ -82,6 +96,83 @@ void Register::RegisterGate(const GatePointer& gate) {
     gates_online_++;
   }
   gates_.push_back(gate);
+  gate_owners_.push_back(kNoOwner);
+  AssignLayer(gate);
+}
+
+std::optional<std::size_t> Register::ComputeLayer(
+    const std::vector<WirePointer>& parent_wires) const {
+  std::size_t layer = 0;
+  for (const auto& wire : parent_wires) {
+    assert(wire);
+    const auto parent_layer = wire_layers_.at(wire->GetWireId() - wire_id_offset_);
+    if (parent_layer == kUnlayered || (parent_layer == kNoProducer && !wire->IsReady())) {
+      // the wire gets its value from somewhere outside the gate graph
+      return std::nullopt;
+    } else if (parent_layer != kNoProducer) {
+      layer = std::max(layer, parent_layer + 1);
+    }
+  }
+  return layer;
+}
+
+void Register::AssignLayer(const GatePointer& gate) {
+  const auto layer{ComputeLayer(gate->GetParentWires())};
+
+  for (const auto& wire : gate->GetOutputWires()) {
+    auto& wire_layer = wire_layers_.at(wire->GetWireId() - wire_id_offset_);
+    // gates that forward the wires of their parents do not become the wires' producer
+    if (wire_layer == kNoProducer) {
+      wire_layer = layer.value_or(kUnlayered);
+    }
+  }
+
+  if (layer) {
+    if (gate_layers_.size() <= *layer) {
+      gate_layers_.resize(*layer + 1);
+    }
+    gate_layers_[*layer].push_back(gate.get());
+    gate_layers_are_sorted_ = false;
+  } else {
+    unlayered_gates_.push_back(gate.get());
+  }
+}
+
+void Register::SortGateLayersByLocality() {
+  if (gate_layers_are_sorted_) return;
+  constexpr std::size_t kNoPosition{std::numeric_limits<std::size_t>::max()};
+  // wire_positions[wire_id - wire_id_offset_] is the position of its producer among all layers,
+  // where wires forwarded by a later gate keep the position of their first producer
+  std::vector<std::size_t> wire_positions(wire_layers_.size(), kNoPosition);
+  std::size_t position{0};
+  std::vector<std::pair<std::size_t, std::size_t>> keys;
+  std::vector<Gate*> sorted_layer;
+  for (auto& layer : gate_layers_) {
+    keys.clear();
+    keys.reserve(layer.size());
+    for (std::size_t i = 0; i < layer.size(); ++i) {
+      std::size_t earliest_parent{kNoPosition};
+      for (const auto& wire : layer[i]->GetParentWires()) {
+        earliest_parent =
+            std::min(earliest_parent, wire_positions.at(wire->GetWireId() - wire_id_offset_));
+      }
+      keys.emplace_back(earliest_parent, i);
+    }
+    // the pairs are unique, so the creation order decides between gates of the same parent
+    std::sort(keys.begin(), keys.end());
+    sorted_layer.clear();
+    sorted_layer.reserve(layer.size());
+    for (const auto& [earliest_parent, i] : keys) {
+      sorted_layer.push_back(layer[i]);
+      for (const auto& wire : sorted_layer.back()->GetOutputWires()) {
+        auto& wire_position{wire_positions.at(wire->GetWireId() - wire_id_offset_)};
+        wire_position = std::min(wire_position, position);
+      }
+      ++position;
+    }
+    std::swap(layer, sorted_layer);
+  }
+  gate_layers_are_sorted_ = true;
 }
 
 void Register::IncrementEvaluatedGatesSetupCounter() {
@@ -131,13 +222,23 @@ void Register::Reset() {
 
   wires_.clear();
   gates_.clear();
+  gate_owners_.clear();
+  wire_layers_.clear();
+  gate_layers_.clear();
+  gate_layers_are_sorted_ = true;
+  unlayered_gates_.clear();
+  // the arenas are only freed once the caller dropped its last share of them
+  std::erase_if(retired_arenas_, [](const auto& arena) { return !arena->HasLiveObjects(); });
+  if (arena_->HasLiveObjects()) {
+    retired_arenas_.push_back(std::exchange(arena_, std::make_unique<Arena>()));
+  } else {
+    arena_->Release();
+  }
 
   evaluated_gates_setup_ = 0;
   evaluated_gates_online_ = 0;
   gates_setup_done_flag_ = false;
   gates_online_done_flag_ = false;
-  
-  
 }
 
 void Register::Clear() {
@@ -171,11 +272,54 @@ std::shared_ptr<AlgorithmDescription> Register::GetCachedAlgorithmDescription(
     const std::string& path) {
   std::scoped_lock lock(cached_algos_mutex_);
   const auto iterator = cached_algos_.find(path);
-  if (iterator == cached_algos_.end()) {
-    return nullptr;
-  } else {
+  if (iterator != cached_algos_.end()) {
     return iterator->second;
   }
+  // circuits compiled into the library need neither the file system nor parsing
+  if (const auto embedded_circuit{FindEmbeddedCircuit(path)}) {
+    auto algorithm_description{
+        std::make_shared<AlgorithmDescription>(ToAlgorithmDescription(*embedded_circuit))};
+    cached_algos_.emplace(path, algorithm_description);
+    return algorithm_description;
+  }
+  // load the binary circuit converted from the text circuit, which needs no parsing
+  const auto binary_path{AlgorithmDescription::GetBinaryPath(path)};
+  if (binary_path == path || !std::filesystem::exists(binary_path)) {
+    return nullptr;
+  }
+  auto algorithm_description{
+      std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBinary(binary_path))};
+  cached_algos_.emplace(path, algorithm_description);
+  return algorithm_description;
+}
+
+bool Register::AddCachedArithmeticAlgorithmDescription(
+    std::string path,
+    const std::shared_ptr<ArithmeticAlgorithmDescription>& algorithm_description) {
+  std::scoped_lock lock(cached_algos_mutex_);
+  return cached_arithmetic_algos_.try_emplace(std::move(path), algorithm_description).second;
+}
+
+std::shared_ptr<ArithmeticAlgorithmDescription> Register::GetCachedArithmeticAlgorithmDescription(
+    const std::string& path) {
+  std::scoped_lock lock(cached_algos_mutex_);
+  auto& algorithm_description{cached_arithmetic_algos_[path]};
+  if (!algorithm_description) {
+    algorithm_description = std::make_shared<ArithmeticAlgorithmDescription>(
+        ArithmeticAlgorithmDescription::FromFile(path));
+  }
+  return algorithm_description;
+}
+
+std::shared_ptr<const EvaluationTemplate> Register::GetEvaluationTemplate(
+    const std::shared_ptr<const AlgorithmDescription>& algorithm_description) {
+  std::scoped_lock lock(cached_algos_mutex_);
+  auto& [algorithm, evaluation_template] = evaluation_templates_[algorithm_description.get()];
+  if (!evaluation_template) {
+    evaluation_template = std::make_shared<EvaluationTemplate>(*algorithm_description);
+    algorithm = algorithm_description;
+  }
+  return evaluation_template;
 }
 
 }  // namespace encrypto::motion
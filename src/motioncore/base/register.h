@@ -25,14 +25,21 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <unordered_map>
+#include <utility>
+
+#include "utility/arena.h"
 
 namespace encrypto::motion {
 
 struct AlgorithmDescription;
+struct ArithmeticAlgorithmDescription;
+class EvaluationTemplate;
 class Backend;
 class FiberCondition;
 class Gate;
@@ -62,9 +69,30 @@ class Register {
 
   std::size_t NextBooleanGmwSharingId(std::size_t number_of_parallel_values);
 
+  /// \brief Creates an object in the arena of this register, which is released by Reset().  Used
+  ///        for gates, wires and shares.  Objects the caller still holds at Reset() keep their
+  ///        arena until a later Reset() finds them destroyed.
+  template <typename T, typename... Args>
+  std::shared_ptr<T> EmplaceShared(Args&&... args) {
+    return std::allocate_shared<T>(ArenaAllocator<T>(*arena_), std::forward<Args&&>(args)...);
+  }
+
+  /// \brief Makes the next objects of up to number_of_bytes in total adjacent in the arena, e.g.,
+  ///        the gates and wires of a circuit layer, see Arena::Reserve.  Only the objects are
+  ///        placed in the arena, the buffers they allocate themselves, e.g., the values of a
+  ///        wire, are not.
+  void ReserveContiguous(std::size_t number_of_bytes) { arena_->Reserve(number_of_bytes); }
+
+  /// \brief Creates and registers a gate.  Gates registered by its constructor, e.g., the helper
+  ///        output gates that open masked values, belong to the gate, see GetGateOwner.
   template <typename T, typename... Args>
   std::shared_ptr<T> EmplaceGate(Args&&... args) {
-    auto gate = std::make_shared<T>(std::forward<Args&&>(args)...);
+    const std::size_t first_helper{gates_.size()};
+    auto gate = EmplaceShared<T>(std::forward<Args&&>(args)...);
+    // helpers of helpers already belong to the helper
+    for (std::size_t i = first_helper; i < gates_.size(); ++i) {
+      if (gate_owners_[i] == kNoOwner) gate_owners_[i] = gates_.size();
+    }
     RegisterGate(gate);
     return gate;
   }
@@ -73,12 +101,15 @@ class Register {
 
   template <typename T, typename... Args>
   std::shared_ptr<T> EmplaceWire(Args&&... args) {
-    auto wire = std::make_shared<T>(std::forward<Args&&>(args)...);
+    auto wire = EmplaceShared<T>(std::forward<Args&&>(args)...);
     RegisterWire(wire);
     return wire;
   }
 
-  void RegisterWire(const WirePointer& wire) { wires_.push_back(wire); }
+  void RegisterWire(const WirePointer& wire) {
+    wires_.push_back(wire);
+    wire_layers_.push_back(kNoProducer);
+  }
 
   const GatePointer& GetGate(std::size_t gate_id) const {
     return gates_.at(gate_id - gate_id_offset_);
@@ -86,6 +117,13 @@ class Register {
 
   auto& GetGates() const { return gates_; }
 
+  /// \brief the position in GetGates of the gate whose constructor registered the gate at
+  ///        position \p gate_index, or kNoOwner for gates created by the user, see EmplaceGate.
+  ///        The owner is registered after its helpers.
+  std::size_t GetGateOwner(std::size_t gate_index) const { return gate_owners_.at(gate_index); }
+
+  static constexpr std::size_t kNoOwner = std::numeric_limits<std::size_t>::max();
+
   WirePointer GetWire(std::size_t wire_id) const { return wires_.at(wire_id - wire_id_offset_); }
 
   void IncrementEvaluatedGatesSetupCounter();
@@ -108,6 +146,36 @@ class Register {
   
   std::size_t GetGateIdOffset() const { return gate_id_offset_; }
 
+  std::size_t GetTotalNumberOfWires() const { return global_wire_id_ - wire_id_offset_; }
+
+  std::size_t GetWireIdOffset() const { return wire_id_offset_; }
+
+  /// \brief Gates grouped by their depth in the circuit, i.e., each gate in layer i only depends on
+  ///        wires computed by gates in layers < i. Computed incrementally in RegisterGate.  The
+  ///        gates are owned by GetGates.
+  const std::vector<std::vector<Gate*>>& GetGateLayers() const { return gate_layers_; }
+
+  /// \brief Gates that depend on wires which are not produced by any earlier registered gate, e.g.,
+  ///        helper output gates reading wires that are only set during the evaluation of another
+  ///        gate. These gates cannot be assigned to a layer and need to run concurrently.
+  const std::vector<Gate*>& GetUnlayeredGates() const { return unlayered_gates_; }
+
+  std::size_t GetNumberOfLayers() const { return gate_layers_.size(); }
+
+  /// \brief Sorts the gates of each layer of GetGateLayers by the position of the earliest gate
+  ///        of the previous layers they depend on, s.t. gates reading the same wires and the
+  ///        descendants of a gate are posted next to each other by GateExecutor::EvaluateLayered
+  ///        and find their parents' wire data still in the cache.  Gates of the same earliest
+  ///        parent keep their creation order.  GetGates and the gate ids are not changed.  Does
+  ///        nothing if no gate was registered since the last call.
+  void SortGateLayersByLocality();
+
+  /// \brief Returns the layer a gate depending on \p parent_wires is assigned to, see
+  ///        GetGateLayers, or std::nullopt if the gate is unlayered, see GetUnlayeredGates.
+  std::optional<std::size_t> ComputeLayer(const std::vector<WirePointer>& parent_wires) const;
+
+  const Arena& GetArena() const { return *arena_; }
+
   void Reset();
 
   void Clear();
@@ -127,13 +195,42 @@ class Register {
   bool AddCachedAlgorithmDescription(
       std::string path, const std::shared_ptr<AlgorithmDescription>& algorithm_description);
 
-  /// \brief Gets cached AlgorithmDescription object read from a file and placed into cached_algos_
-  /// \return shared_ptr to the algorithm description or to nullptr if not in the hash table
+  /// \brief Gets cached AlgorithmDescription object read from a file and placed into cached_algos_.
+  /// On a miss, the circuit compiled into the library for path is cached, see
+  /// FindEmbeddedCircuit, or else the binary circuit at AlgorithmDescription::GetBinaryPath(path)
+  /// is loaded and cached if it exists, see the circuit_converter example.
+  /// \return shared_ptr to the algorithm description or to nullptr if neither in the hash table,
+  /// embedded nor converted to a binary circuit
   std::shared_ptr<AlgorithmDescription> GetCachedAlgorithmDescription(const std::string& path);
 
+  /// \brief Tries to insert an ArithmeticAlgorithmDescription read from path into the cache
+  /// \returns true if the insertion was successful and false if path is already in the cache
+  bool AddCachedArithmeticAlgorithmDescription(
+      std::string path,
+      const std::shared_ptr<ArithmeticAlgorithmDescription>& algorithm_description);
+
+  /// \brief Gets the ArithmeticAlgorithmDescription of path, which is read by
+  /// ArithmeticAlgorithmDescription::FromFile and cached on the first call
+  /// \throws std::runtime_error if the circuit is not cached and cannot be read
+  std::shared_ptr<ArithmeticAlgorithmDescription> GetCachedArithmeticAlgorithmDescription(
+      const std::string& path);
+
+  /// \brief Gets the EvaluationTemplate of algorithm_description, which is compiled on the first
+  /// call and kept along with algorithm_description for later calls
+  std::shared_ptr<const EvaluationTemplate> GetEvaluationTemplate(
+      const std::shared_ptr<const AlgorithmDescription>& algorithm_description);
+
  private:
+  void AssignLayer(const GatePointer& gate);
+
   std::shared_ptr<Logger> logger_;
 
+  // holds the gates, wires and shares created since the last Reset()
+  std::unique_ptr<Arena> arena_;
+
+  // arenas of earlier circuits whose objects were still held by the caller at Reset()
+  std::vector<std::unique_ptr<Arena>> retired_arenas_;
+
   // don't need atomic here, since only the master thread has access to these
   std::size_t global_gate_id_ = 0, global_wire_id_ = 0;
   std::size_t global_arithmetic_gmw_sharing_id_ = 0, global_boolean_gmw_sharing_id_ = 0;
@@ -154,9 +251,34 @@ class Register {
 
   std::vector<GatePointer> gates_;
 
+  // gate_owners_[i] is the position of the gate that registered gates_[i] or kNoOwner
+  std::vector<std::size_t> gate_owners_;
+
   std::vector<WirePointer> wires_;
 
+  // marks wires that were not (yet) produced by a registered gate
+  static constexpr std::size_t kNoProducer = std::numeric_limits<std::size_t>::max();
+  // marks wires that were produced by an unlayered gate
+  static constexpr std::size_t kUnlayered = kNoProducer - 1;
+
+  // wire_layers_[wire_id - wire_id_offset_] is the layer of the gate producing the wire
+  std::vector<std::size_t> wire_layers_;
+
+  std::vector<std::vector<Gate*>> gate_layers_;
+
+  // whether gate_layers_ are sorted by SortGateLayersByLocality
+  bool gate_layers_are_sorted_ = true;
+
+  std::vector<Gate*> unlayered_gates_;
+
   std::unordered_map<std::string, std::shared_ptr<AlgorithmDescription>> cached_algos_;
+  // the algorithm descriptions are kept alive, s.t. their addresses are not reused
+  std::unordered_map<const AlgorithmDescription*,
+                     std::pair<std::shared_ptr<const AlgorithmDescription>,
+                               std::shared_ptr<const EvaluationTemplate>>>
+      evaluation_templates_;
+  std::unordered_map<std::string, std::shared_ptr<ArithmeticAlgorithmDescription>>
+      cached_arithmetic_algos_;
   std::mutex cached_algos_mutex_;
 };
 
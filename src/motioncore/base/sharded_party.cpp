@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sharded_party.h"
+
+#include <future>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+std::vector<SimdShard> SplitSimd(std::size_t number_of_simd, std::size_t number_of_shards) {
+  if (number_of_shards == 0) {
+    throw std::invalid_argument("SIMD values need to be split into at least one shard");
+  }
+  std::vector<SimdShard> shards;
+  shards.reserve(number_of_shards);
+  const std::size_t quotient{number_of_simd / number_of_shards};
+  const std::size_t remainder{number_of_simd % number_of_shards};
+  std::size_t offset{0};
+  for (std::size_t i = 0; i < number_of_shards; ++i) {
+    const std::size_t size{quotient + (i < remainder ? 1 : 0)};
+    shards.push_back({offset, size});
+    offset += size;
+  }
+  return shards;
+}
+
+std::vector<BitVector<>> GetShardOfInput(std::span<const BitVector<>> input,
+                                         const SimdShard& shard) {
+  std::vector<BitVector<>> result;
+  result.reserve(input.size());
+  for (const auto& wire : input) {
+    result.emplace_back(wire.Subset(shard.offset, shard.offset + shard.number_of_simd));
+  }
+  return result;
+}
+
+std::vector<BitVector<>> MergeShardOutputs(std::span<const std::vector<BitVector<>>> outputs) {
+  if (outputs.empty()) return {};
+  std::vector<BitVector<>> result(outputs.front().size());
+  for (std::size_t shard_i = 0; shard_i < outputs.size(); ++shard_i) {
+    if (outputs[shard_i].size() != result.size()) {
+      throw std::invalid_argument(
+          fmt::format("Shard #{} has {} output wires, but shard #0 has {}", shard_i,
+                      outputs[shard_i].size(), result.size()));
+    }
+    for (std::size_t wire_i = 0; wire_i < result.size(); ++wire_i) {
+      result[wire_i].Append(outputs[shard_i][wire_i]);
+    }
+  }
+  return result;
+}
+
+ShardedParty::ShardedParty(std::vector<PartyPointer>&& workers, std::size_t number_of_simd)
+    : workers_(std::move(workers)) {
+  if (workers_.empty()) {
+    throw std::invalid_argument("A sharded party needs at least one worker");
+  }
+  shards_ = SplitSimd(number_of_simd, workers_.size());
+}
+
+void ShardedParty::Run(const std::function<void(Party&, std::size_t, const SimdShard&)>& build) {
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers_.size());
+  for (std::size_t worker_i = 0; worker_i < workers_.size(); ++worker_i) {
+    futures.emplace_back(std::async(std::launch::async, [this, &build, worker_i] {
+      build(*workers_[worker_i], worker_i, shards_[worker_i]);
+      workers_[worker_i]->Run();
+    }));
+  }
+  // wait for all workers before rethrowing, since the futures of std::async block on destruction
+  for (auto& future : futures) future.wait();
+  for (auto& future : futures) future.get();
+}
+
+void ShardedParty::Finish() {
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers_.size());
+  for (auto& worker : workers_) {
+    futures.emplace_back(std::async(std::launch::async, [&worker] { worker->Finish(); }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+std::vector<ShardedParty> MakeLocallyConnectedShardedParties(std::size_t number_of_parties,
+                                                             std::size_t number_of_workers,
+                                                             std::size_t number_of_simd) {
+  std::vector<std::vector<PartyPointer>> workers(number_of_parties);
+  for (std::size_t worker_i = 0; worker_i < number_of_workers; ++worker_i) {
+    // the i-th workers of all parties form a group of ordinary, connected parties
+    auto group{MakeLocallyConnectedParties(number_of_parties, 0)};
+    for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+      workers[party_id].emplace_back(std::move(group[party_id]));
+    }
+  }
+  std::vector<ShardedParty> sharded_parties;
+  sharded_parties.reserve(number_of_parties);
+  for (auto& party_workers : workers) {
+    sharded_parties.emplace_back(std::move(party_workers), number_of_simd);
+  }
+  return sharded_parties;
+}
+
+}  // namespace encrypto::motion
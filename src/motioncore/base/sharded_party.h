@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "base/party.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+/// \brief The SIMD values [offset, offset + number_of_simd) of a circuit, which are evaluated by
+///        one worker of a ShardedParty.
+struct SimdShard {
+  std::size_t offset;
+  std::size_t number_of_simd;
+};
+
+/// \brief Splits \p number_of_simd SIMD values into \p number_of_shards consecutive shards whose
+///        sizes differ by at most 1.  Every party needs to split its lanes the same way.
+/// \throws std::invalid_argument if \p number_of_shards is 0
+std::vector<SimdShard> SplitSimd(std::size_t number_of_simd, std::size_t number_of_shards);
+
+/// \brief Returns the SIMD values of \p shard of each wire of \p input.
+std::vector<BitVector<>> GetShardOfInput(std::span<const BitVector<>> input,
+                                         const SimdShard& shard);
+
+template <typename T>
+std::vector<T> GetShardOfInput(std::span<const T> input, const SimdShard& shard) {
+  const auto begin{input.begin() + shard.offset};
+  return std::vector<T>(begin, begin + shard.number_of_simd);
+}
+
+/// \brief Concatenates the outputs of the shards of each wire in the order of the shards, which
+///        the coordinator of a sharded party uses to aggregate the outputs of its workers.
+/// \throws std::invalid_argument if the shards have different numbers of wires
+std::vector<BitVector<>> MergeShardOutputs(std::span<const std::vector<BitVector<>>> outputs);
+
+template <typename T>
+std::vector<T> MergeShardOutputs(std::span<const std::vector<T>> outputs) {
+  std::vector<T> result;
+  for (const auto& output : outputs) result.insert(result.end(), output.begin(), output.end());
+  return result;
+}
+
+/// \brief A single logical party whose SIMD values are split across several workers, each of
+///        which is a Party of its own.  The i-th worker of every party evaluates the i-th SimdShard
+///        of the circuit and is only connected to the i-th workers of the other parties, s.t. the
+///        workers may run on different machines and a party is not limited by a single machine.
+///
+/// The circuit of each worker is constructed for the number of SIMD values of its shard and the
+/// outputs of the workers are aggregated with MergeShardOutputs.  If the workers are distributed,
+/// each machine runs its worker as an ordinary Party with the shard from SplitSimd and only the
+/// outputs are sent to the coordinator.
+class ShardedParty {
+ public:
+  /// \throws std::invalid_argument if \p workers is empty
+  ShardedParty(std::vector<PartyPointer>&& workers, std::size_t number_of_simd);
+
+  std::size_t GetNumberOfWorkers() const { return workers_.size(); }
+
+  Party& GetWorker(std::size_t worker_index) { return *workers_.at(worker_index); }
+
+  const SimdShard& GetShard(std::size_t worker_index) const { return shards_.at(worker_index); }
+
+  /// \brief Constructs the circuit of each worker by calling \p build with the worker, its index
+  ///        and its shard, and evaluates the workers concurrently.  \p build is invoked
+  ///        concurrently for different workers.
+  /// \throws the first exception thrown by \p build or the evaluation of a worker
+  void Run(const std::function<void(Party&, std::size_t, const SimdShard&)>& build);
+
+  /// \brief Finishes all workers concurrently, see Party::Finish.
+  void Finish();
+
+ private:
+  std::vector<PartyPointer> workers_;
+  std::vector<SimdShard> shards_;
+};
+
+/// \brief Constructs \p number_of_parties sharded parties with \p number_of_workers workers each,
+///        where the i-th workers of all parties are locally connected to each other.
+std::vector<ShardedParty> MakeLocallyConnectedShardedParties(std::size_t number_of_parties,
+                                                             std::size_t number_of_workers,
+                                                             std::size_t number_of_simd);
+
+}  // namespace encrypto::motion
@@ -0,0 +1,101 @@
+# MIT License
+#
+# Copyright (c) 2024 Oleksandr Tkachenko
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Converts the Bristol circuits in CIRCUIT_FILES (separated by commas), which are paths relative to
+# CIRCUITS_ROOT, into constexpr gate arrays in OUTPUT, see algorithm/embedded_circuits.h.  The gate
+# lines are rewritten by regular expressions over the whole file, so the library does not parse
+# text when loading an embedded circuit.
+
+string(REPLACE "," ";" CIRCUIT_FILES "${CIRCUIT_FILES}")
+
+set(SPACE "[ \t]+")
+set(NUMBER "([0-9]+)")
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(INDEX 0)
+foreach (CIRCUIT_FILE ${CIRCUIT_FILES})
+  file(READ "${CIRCUITS_ROOT}/${CIRCUIT_FILE}" CONTENT)
+  string(REPLACE "\r" "" CONTENT "${CONTENT}")
+
+  # header: # of gates and wires, # of input wires of parent a (and b) and # of output wires
+  string(REGEX MATCH "^[ \t]*${NUMBER}${SPACE}${NUMBER}[ \t]*\n[ \t]*${NUMBER}${SPACE}${NUMBER}(${SPACE}${NUMBER})?[ \t]*\n"
+         HEADER "${CONTENT}")
+  if (NOT HEADER)
+    message(FATAL_ERROR "${CIRCUIT_FILE} is not a Bristol circuit")
+  endif ()
+  set(NUMBER_OF_GATES ${CMAKE_MATCH_1})
+  set(NUMBER_OF_WIRES ${CMAKE_MATCH_2})
+  set(NUMBER_OF_INPUT_WIRES_PARENT_A ${CMAKE_MATCH_3})
+  if (CMAKE_MATCH_6 STREQUAL "")
+    set(NUMBER_OF_INPUT_WIRES_PARENT_B "std::nullopt")
+    set(NUMBER_OF_OUTPUT_WIRES ${CMAKE_MATCH_4})
+  else ()
+    set(NUMBER_OF_INPUT_WIRES_PARENT_B ${CMAKE_MATCH_4})
+    set(NUMBER_OF_OUTPUT_WIRES ${CMAKE_MATCH_6})
+  endif ()
+  string(LENGTH "${HEADER}" HEADER_LENGTH)
+  string(SUBSTRING "${CONTENT}" ${HEADER_LENGTH} -1 GATES)
+
+  foreach (TYPE XOR AND OR ADD MUL)
+    string(SUBSTRING ${TYPE} 0 1 FIRST_LETTER)
+    string(SUBSTRING ${TYPE} 1 -1 OTHER_LETTERS)
+    string(TOLOWER ${OTHER_LETTERS} OTHER_LETTERS)
+    string(REGEX REPLACE "2${SPACE}1${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}${TYPE}"
+           "{Type::k${FIRST_LETTER}${OTHER_LETTERS}, \\1, \\2, kNoWire, \\3}," GATES "${GATES}")
+  endforeach ()
+  string(REGEX REPLACE "3${SPACE}1${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}MUX"
+         "{Type::kMux, \\1, \\2, \\3, \\4}," GATES "${GATES}")
+  string(REGEX REPLACE "1${SPACE}1${SPACE}${NUMBER}${SPACE}${NUMBER}${SPACE}INV"
+         "{Type::kInv, \\1, kNoWire, kNoWire, \\2}," GATES "${GATES}")
+
+  # every line that is left has an unknown gate
+  string(REGEX REPLACE "{[^}]*}," "" REMAINDER "${GATES}")
+  string(STRIP "${REMAINDER}" REMAINDER)
+  if (NOT REMAINDER STREQUAL "")
+    string(REGEX MATCH "[^\n]*" LINE "${REMAINDER}")
+    message(FATAL_ERROR "Unknown gate in ${CIRCUIT_FILE}: ${LINE}")
+  endif ()
+
+  string(APPEND ARRAYS "\n// ${CIRCUIT_FILE}\nconstexpr EmbeddedGate kGates${INDEX}[]{${GATES}};\n")
+  string(APPEND ARRAYS "static_assert(HasValidWires(kGates${INDEX}, ${NUMBER_OF_WIRES}));\n")
+  string(APPEND ENTRIES "    EmbeddedCircuit{\"circuits/${CIRCUIT_FILE}\", ${NUMBER_OF_GATES}, "
+         "${NUMBER_OF_WIRES}, ${NUMBER_OF_INPUT_WIRES_PARENT_A}, ${NUMBER_OF_INPUT_WIRES_PARENT_B}, "
+         "${NUMBER_OF_OUTPUT_WIRES}, kGates${INDEX}},\n")
+  math(EXPR INDEX "${INDEX} + 1")
+endforeach ()
+
+file(WRITE "${OUTPUT}.new"
+     "// generated by embed_circuits.cmake, do not edit\n\n"
+     "#include \"algorithm/embedded_circuits.h\"\n\n"
+     "namespace encrypto::motion {\n\n"
+     "namespace {\n\n"
+     "using Type = PrimitiveOperationType;\n"
+     "${ARRAYS}\n"
+     "constexpr std::array<EmbeddedCircuit, ${INDEX}> kEmbeddedCircuits{\n${ENTRIES}};\n\n"
+     "}  // namespace\n\n"
+     "std::span<const EmbeddedCircuit> GetEmbeddedCircuits() { return kEmbeddedCircuits; }\n\n"
+     "}  // namespace encrypto::motion\n")
+
+# only touch the output if the circuits changed to avoid recompiling it
+execute_process(COMMAND "${CMAKE_COMMAND}" "-E" "copy_if_different" "${OUTPUT}.new" "${OUTPUT}")
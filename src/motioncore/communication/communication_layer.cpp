@@ -22,29 +22,176 @@
 
 #include "communication_layer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <shared_mutex>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <variant>
 
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
+#include <unistd.h>
 
 #include "dummy_transport.h"
 #include "message.h"
+#include "message_compression.h"
 #include "message_manager.h"
+#include "shared_memory_transport.h"
+#include "statistics/memory_accounting.h"
+#include "statistics/trace.h"
 #include "tcp_transport.h"
 #include "utility/constants.h"
+#include "utility/lock_free_queue.h"
 #include "utility/logger.h"
-#include "utility/synchronized_queue.h"
 #include "utility/thread.h"
 
 namespace encrypto::motion::communication {
 
+// messages larger than this are sent on their own to avoid copying them into a batch
+constexpr std::size_t kMaximumCoalescedMessageSize = 64 * 1024;
+// upper bound for the payload size of a single batch
+constexpr std::size_t kMaximumBatchSize = 4 * 1024 * 1024;
+// the send threads wait at most this fraction of the round-trip time for further small messages,
+// which delays a communication round by at most 2%
+constexpr std::int64_t kCoalescingWindowDivisor = 50;
+constexpr std::chrono::nanoseconds kMaximumCoalescingWindow = std::chrono::milliseconds(1);
+// the window shrinks down to this fraction of its maximum while the waits collect no messages
+constexpr double kMinimumCoalescingWindowScale = 1.0 / 8;
+// party id used internally for messages to all other parties
+constexpr std::size_t kAll = std::numeric_limits<std::size_t>::max();
+// smaller messages are never compressed
+constexpr std::size_t kMinimumCompressedMessageSize = 512;
+// messages are only sent compressed if this shrinks them to at most this fraction of their size
+constexpr double kMaximumCompressionRatio = 0.9;
+// number of messages of a type that are sent uncompressed after compression did not pay off
+constexpr std::size_t kCompressionBackoff = 64;
+constexpr std::size_t kNumberOfMessageTypes = static_cast<std::size_t>(MessageType::MAX) + 1;
+// prioritized messages larger than this are sent in fragments of this size
+constexpr std::size_t kMessageFragmentSize = 256 * 1024;
+// larger payloads are sent as streams since they come close to the maximum message size
+constexpr std::size_t kMaximumUnstreamedPayloadSize = std::size_t(1) << 30;
+// the type and the payload size of the message precede each fragment of a stream
+constexpr std::size_t kStreamFragmentHeaderSize = sizeof(std::uint8_t) + sizeof(std::uint64_t);
+// streams without a registered receiver are reassembled if the message fits into the maximum
+// message size, which leaves room for the fields around the payload
+constexpr std::size_t kMaximumReassembledPayloadSize = kMaxMessageSize - 1024;
+
+static MessagePhase GetMessagePhase(MessageType message_type) {
+  switch (message_type) {
+    case MessageType::kHelloMessage:
+    case MessageType::kTerminationMessage:
+    case MessageType::kSynchronizationMessage:
+    case MessageType::kBatchedMessage:
+    case MessageType::kCompressedMessage:
+    case MessageType::kRelayedMessage:
+    case MessageType::kMessageFragment:
+    case MessageType::kMessageStream:
+    case MessageType::kNetworkProbe:
+      return MessagePhase::kControl;
+    case MessageType::kOutputMessage:
+    case MessageType::kBmrInputGate0:
+    case MessageType::kBmrInputGate1:
+    case MessageType::kAstraInputGate:
+    case MessageType::kAstraOutputGate:
+    case MessageType::kAstraOnlineMultiplyGate:
+    case MessageType::kAstraOnlineDotProductGate:
+    case MessageType::kGarbledCircuitOutput:
+    case MessageType::kGarbledCircuitInput:
+    case MessageType::kGarbledCircuitEvaluatorInputCorrections:
+    case MessageType::kGarbledCircuitEvaluatorInputMaskedLabels:
+    case MessageType::kArithmeticGmwOpening:
+    case MessageType::kBatchedOutput:
+    case MessageType::kAstraOnlineMatrixMultiplicationGate:
+    case MessageType::kAstraOnlineTruncationGate:
+    case MessageType::kAstraVerification:
+    case MessageType::kHybridMultiplicationGate:
+    case MessageType::kMsbExtractionOffsets:
+    case MessageType::kMsbExtractionMessages:
+    case MessageType::kReplicatedInputGate:
+    case MessageType::kReplicatedOutputGate:
+    case MessageType::kReplicatedMultiplicationGate:
+    case MessageType::kReplicatedReshareGate:
+      return MessagePhase::kOnline;
+    default:
+      // OTs, MTs, SPs, SBs, garbled tables and the setup messages of the gates
+      return MessagePhase::kSetup;
+  }
+}
+
+// lanes of the prioritized send queues, which are sent in this order
+enum class SendLane : std::size_t { kOnline = 0, kSetup = 1, kBulk = 2 };
+constexpr std::size_t kNumberOfSendLanes = 3;
+
+static SendLane GetSendLane(MessageType message_type) {
+  switch (message_type) {
+    // base OTs, OT extension, MTs, SPs, SBs and garbled tables
+    case MessageType::kBaseROtMessageSender:
+    case MessageType::kBaseROtMessageReceiver:
+    case MessageType::kBaseOtResumptionNonce:
+    case MessageType::kOtExtensionReceiverMasks:
+    case MessageType::kOtExtensionReceiverCorrections:
+    case MessageType::kOtExtensionSender:
+    case MessageType::kOtExtensionChunkAcknowledgement:
+    case MessageType::kKK13OtExtensionReceiverMasks:
+    case MessageType::kKK13OtExtensionReceiverCorrections:
+    case MessageType::kKK13OtExtensionSender:
+    case MessageType::kKK13OtExtensionMaskSeed:
+    case MessageType::kSilentOtExtensionSender:
+    case MessageType::kRandomOtPoolMasks:
+    case MessageType::kRandomOtPoolAcknowledgement:
+    case MessageType::kPaillierPublicKey:
+    case MessageType::kPaillierCiphertexts:
+    case MessageType::kPaillierProducts:
+    case MessageType::kSharedBitsMask:
+    case MessageType::kSharedBitsReconstruct:
+    case MessageType::kBmrAndGate:
+    case MessageType::kBmrGarbledTablesChunk:
+    case MessageType::kGarbledCircuitGarbledTables:
+    case MessageType::kGarbledCircuitGarbledTablesChunk:
+      return SendLane::kBulk;
+    // relayed broadcasts are mostly openings
+    case MessageType::kRelayedMessage:
+      return SendLane::kOnline;
+    default:
+      switch (GetMessagePhase(message_type)) {
+        case MessagePhase::kOnline:
+          return SendLane::kOnline;
+        case MessagePhase::kSetup:
+          return SendLane::kSetup;
+        default:
+          // control messages like terminations and synchronizations are in the last lane, s.t.
+          // they are sent after all messages that were queued before them
+          return SendLane::kBulk;
+      }
+  }
+}
+
+// Build a fragment of a stream with an uninitialized fragment of fragment_size bytes.  Returns the
+// builder and the offset of the fragment in its buffer.
+static std::pair<flatbuffers::FlatBufferBuilder, std::size_t> BuildStreamFragmentHeader(
+    MessageType message_type, std::size_t message_id, std::uint64_t payload_size,
+    std::size_t fragment_size) {
+  auto [message_builder, payload_offset] = BuildMessageHeader(
+      MessageType::kMessageStream, message_id, kStreamFragmentHeaderSize + fragment_size);
+  auto header = message_builder.GetBufferPointer() + payload_offset;
+  header[0] = static_cast<std::uint8_t>(message_type);
+  std::copy_n(reinterpret_cast<const std::uint8_t*>(&payload_size), sizeof(payload_size),
+              header + sizeof(std::uint8_t));
+  return {std::move(message_builder), payload_offset + kStreamFragmentHeaderSize};
+}
+
 struct CommunicationLayer::CommunicationLayerImplementation {
   CommunicationLayerImplementation(std::size_t my_id,
                                    std::vector<std::unique_ptr<Transport>>&& transports,
@@ -52,6 +199,12 @@ struct CommunicationLayer::CommunicationLayerImplementation {
   // run in a thread for each party
   void ReceiveTask(std::size_t party_id, MessageManager& message_manager);
   void SendTask(std::size_t party_id);
+  // run in a thread for each party, handles the messages passed on by the receive thread
+  void DispatchTask(std::size_t party_id, MessageManager& message_manager);
+
+  // forward a received message to its destination, returns false for termination messages
+  bool HandleMessage(std::size_t party_id, std::vector<std::uint8_t>&& raw_message,
+                     MessageManager& message_manager, bool relayed = false);
 
   // setup threads and data structures
   void Initialize(std::size_t my_id, std::size_t number_of_parties);
@@ -64,16 +217,153 @@ struct CommunicationLayer::CommunicationLayerImplementation {
   std::promise<void> start_promise_;
   std::shared_future<void> start_sfuture_;
   std::atomic<bool> continue_communication_ = true;
+  std::atomic<bool> message_coalescing_ = true;
+  std::atomic<bool> message_prioritization_ = false;
+  std::atomic<bool> message_dispatch_thread_ = false;
+  std::atomic<bool> message_verification_ = true;
+  // party that relays the broadcast messages of the other parties, kAll if there is none
+  std::atomic<std::size_t> broadcast_hub_ = kAll;
 
   std::vector<std::unique_ptr<Transport>> transports_;
 
+  // message in a send queue
+  struct OutgoingMessage {
+    flatbuffers::DetachedBuffer buffer;
+    // if not empty, replaces the uninitialized payload at payload_offset in buffer
+    std::span<const std::uint8_t> payload;
+    std::size_t payload_offset = 0;
+    std::shared_ptr<const void> payload_owner;
+
+    // for the statistics of the time spent in the send queue
+    std::chrono::steady_clock::time_point creation_time = std::chrono::steady_clock::now();
+
+    // bytes of the buffer and the payload from the enqueueing until the last send queue
+    // released the message
+    MemoryAccount memory_account{MemorySubsystem::kMessageBuffers};
+    // bytes counted against the watermarks of the send queues, 0 for relayed messages
+    std::size_t number_of_queued_bytes = 0;
+
+    std::size_t size() const { return buffer.size(); }
+
+    // the message as a sequence of consecutive parts
+    std::vector<std::span<const std::uint8_t>> GetParts() const {
+      std::span<const std::uint8_t> message(buffer.data(), buffer.size());
+      if (payload.empty()) {
+        return {message};
+      }
+      return {message.subspan(0, payload_offset), payload,
+              message.subspan(payload_offset + payload.size())};
+    }
+
+    // length bytes of the message starting at offset as a sequence of consecutive parts
+    std::vector<std::span<const std::uint8_t>> GetParts(std::size_t offset,
+                                                        std::size_t length) const {
+      std::vector<std::span<const std::uint8_t>> parts;
+      for (const auto part : GetParts()) {
+        if (length == 0) break;
+        if (offset >= part.size()) {
+          offset -= part.size();
+          continue;
+        }
+        const auto size = std::min(length, part.size() - offset);
+        parts.push_back(part.subspan(offset, size));
+        offset = 0;
+        length -= size;
+      }
+      return parts;
+    }
+  };
+
   // message type
-  using message_t = std::shared_ptr<flatbuffers::DetachedBuffer>;
+  using message_t = std::shared_ptr<OutgoingMessage>;
+
+  void Enqueue(std::size_t party_id, message_t&& message);
 
-  std::vector<SynchronizedFiberQueue<message_t>> send_queues_;
+  // replaces the message by a compressed message if compression is enabled for its type and
+  // was worth it for the last messages of the type
+  void CompressMessage(std::size_t party_id, message_t& message);
+
+  std::vector<LockFreeFiberQueue<message_t>> send_queues_;
+  // bytes of the send queue of a party which were not sent yet, where producers are suspended
+  // once the high watermark is reached until the queue has drained to the low watermark
+  struct SendQueueBytes {
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable condition;
+    std::size_t number_of_bytes = 0;
+    bool full = false;
+    std::size_t peak_number_of_bytes = 0;
+    std::size_t number_of_waits = 0;
+    std::chrono::nanoseconds wait_time{0};
+  };
+  std::vector<SendQueueBytes> send_queue_bytes_;
+  // 0 disables the backpressure
+  std::atomic<std::size_t> send_queue_high_watermark_ = 0;
+  std::atomic<std::size_t> send_queue_low_watermark_ = 0;
+  // adds the bytes of a message to the send queue of the party, waits while the queue is full
+  void AcquireSendQueueBytes(std::size_t party_id, std::size_t number_of_bytes);
+  // called by the send thread after the message was sent
+  void ReleaseSendQueueBytes(std::size_t party_id, std::size_t number_of_bytes);
+  // messages taken from the send queue of each party into the lanes of its send thread
+  std::vector<std::atomic<std::size_t>> number_of_prioritized_messages_;
+  // fragment_buffers_[party_id][lane] -> received fragments of a message, only accessed by the
+  // thread handling the messages of the party
+  std::vector<std::array<std::vector<std::uint8_t>, kNumberOfSendLanes>> fragment_buffers_;
+  // streams being received by sender, message type and message id, the buffer holds the payload
+  // of streams without a registered receiver, which are reassembled into a message
+  struct ReceivedStream {
+    std::uint64_t number_of_bytes = 0;
+    std::vector<std::uint8_t> buffer;
+  };
+  std::mutex received_streams_mutex_;
+  std::map<std::tuple<std::size_t, MessageType, std::size_t>, ReceivedStream> received_streams_;
   std::vector<std::thread> receive_threads_;
   std::vector<std::thread> send_threads_;
 
+  // received messages on their way from the receive thread to the dispatch thread
+  std::vector<LockFreeQueue<std::vector<std::uint8_t>>> dispatch_queues_;
+  std::vector<std::thread> dispatch_threads_;
+  std::vector<std::atomic<bool>> termination_received_;
+
+  // message types that are compressed if they are large enough
+  std::vector<std::atomic<bool>> compressed_message_types_;
+  // compression_backoff_[party_id][message_type] -> messages to send before compressing again,
+  // only accessed by the send thread of the party
+  std::vector<std::vector<std::size_t>> compression_backoff_;
+  struct CompressionStatistics {
+    std::atomic<std::size_t> number_of_bytes_before_compression = 0;
+    std::atomic<std::size_t> number_of_bytes_after_compression = 0;
+  };
+  std::vector<CompressionStatistics> compression_statistics_;
+
+  // 0 if unknown, which disables waiting for further messages to coalesce
+  std::atomic<std::int64_t> round_trip_nanoseconds_ = 0;
+  struct CoalescingStatistics {
+    std::atomic<std::int64_t> window_nanoseconds = 0;
+    std::atomic<std::size_t> number_of_waits = 0;
+    std::atomic<std::size_t> number_of_collected_messages = 0;
+  };
+  std::vector<CoalescingStatistics> coalescing_statistics_;
+  std::size_t GetNumberOfQueuedBytes(std::size_t party_id) {
+    auto& queue_bytes = send_queue_bytes_[party_id];
+    std::scoped_lock lock(queue_bytes.mutex);
+    return queue_bytes.number_of_bytes;
+  }
+  // message_type_counters_[party_id * kNumberOfMessageTypes + message_type], the sent messages
+  // are counted by the send thread and the received ones by the thread handling them
+  struct MessageTypeCounters {
+    std::atomic<std::size_t> number_of_messages_sent = 0;
+    std::atomic<std::size_t> number_of_messages_received = 0;
+    std::atomic<std::size_t> number_of_bytes_sent = 0;
+    std::atomic<std::size_t> number_of_bytes_received = 0;
+    std::atomic<std::int64_t> send_queue_nanoseconds = 0;
+  };
+  std::vector<MessageTypeCounters> message_type_counters_;
+
+  MessageTypeCounters& GetMessageTypeCounters(std::size_t party_id, MessageType message_type) {
+    return message_type_counters_[party_id * kNumberOfMessageTypes +
+                                  static_cast<std::size_t>(message_type)];
+  }
+
   std::shared_ptr<Logger> logger_;
 };
 
@@ -85,19 +375,33 @@ CommunicationLayer::CommunicationLayerImplementation::CommunicationLayerImplemen
       start_sfuture_(start_promise_.get_future().share()),
       transports_(std::move(transports)),
       send_queues_(number_of_parties_),
+      send_queue_bytes_(number_of_parties_),
+      number_of_prioritized_messages_(number_of_parties_),
+      fragment_buffers_(number_of_parties_),
+      dispatch_queues_(number_of_parties_),
+      termination_received_(number_of_parties_),
+      compressed_message_types_(kNumberOfMessageTypes),
+      compression_backoff_(number_of_parties_, std::vector<std::size_t>(kNumberOfMessageTypes)),
+      compression_statistics_(number_of_parties_),
+      coalescing_statistics_(number_of_parties_),
+      message_type_counters_(number_of_parties_ * kNumberOfMessageTypes),
       logger_(std::move(logger)) {
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
     if (party_id == my_id) {
       receive_threads_.emplace_back();
       send_threads_.emplace_back();
+      dispatch_threads_.emplace_back();
       continue;
     }
     receive_threads_.emplace_back(
         [this, &message_manager, party_id] { ReceiveTask(party_id, message_manager); });
     send_threads_.emplace_back([this, party_id] { SendTask(party_id); });
+    dispatch_threads_.emplace_back(
+        [this, &message_manager, party_id] { DispatchTask(party_id, message_manager); });
 
     ThreadSetName(receive_threads_.at(party_id), fmt::format("recv-{}<->{}", my_id_, party_id));
     ThreadSetName(send_threads_.at(party_id), fmt::format("send-{}<->{}", my_id_, party_id));
+    ThreadSetName(dispatch_threads_.at(party_id), fmt::format("disp-{}<->{}", my_id_, party_id));
   }
 }
 
@@ -108,26 +412,220 @@ void CommunicationLayer::CommunicationLayerImplementation::SendTask(std::size_t
   auto my_start_sfuture = start_sfuture_;
   my_start_sfuture.get();
 
-  while (!queue.IsClosedAndEmpty()) {
-    auto tmp_queue = queue.BatchDequeue();
-    if (!tmp_queue.has_value()) {
-      assert(queue.IsClosed());
-      break;
+  // records the time the transport needed to send a message if tracing is enabled
+  auto trace_send = [&](MessageType message_type, std::size_t number_of_bytes,
+                        Tracer::TimePoint start) {
+    Tracer::Get().RecordMessage(Tracer::Category::kMessageSent, EnumNameMessageType(message_type),
+                                my_id_, party_id, number_of_bytes, start, Tracer::ClockType::now());
+  };
+  // small messages that became ready in the same round are concatenated and sent at once
+  std::vector<std::uint8_t> batch;
+  std::size_t batch_size = 0;
+  // type of the first message in the batch
+  MessageType batch_type = MessageType::kBatchedMessage;
+  auto flush_batch = [&] {
+    const bool tracing = Tracer::IsEnabled() && batch_size > 0;
+    const auto start = tracing ? Tracer::ClockType::now() : Tracer::TimePoint();
+    if (batch_size == 1) {
+      // no need for the batch header
+      transport.SendMessage(std::span(batch).subspan(sizeof(std::uint32_t)));
+      if (tracing) trace_send(batch_type, batch.size() - sizeof(std::uint32_t), start);
+    } else if (batch_size > 1) {
+      auto message_builder = BuildMessage(MessageType::kBatchedMessage, batch);
+      auto message = message_builder.Release();
+      transport.SendMessage(std::span(message.data(), message.size()));
+      if (tracing) trace_send(MessageType::kBatchedMessage, message.size(), start);
+    }
+    if (logger_ && batch_size > 0) {
+      logger_->LogDebug("Sent batch of {} messages to party {}", batch_size, party_id);
     }
-    while (!tmp_queue->empty()) {
-      auto& message = tmp_queue->front();
-      transport.SendMessage(std::span(message->data(), message->size()));
-      tmp_queue->pop();
+    batch.clear();
+    batch_size = 0;
+  };
+  // counts the message and compresses it when it leaves the queue
+  auto prepare_message = [&](message_t& message) {
+    {
+      // counted before the compression, which only changes the size on the wire
+      auto& counters =
+          GetMessageTypeCounters(party_id, GetMessage(message->buffer.data())->message_type());
+      counters.number_of_messages_sent.fetch_add(1, std::memory_order_relaxed);
+      counters.number_of_bytes_sent.fetch_add(message->size(), std::memory_order_relaxed);
+      counters.send_queue_nanoseconds.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                               message->creation_time)
+              .count(),
+          std::memory_order_relaxed);
+    }
+    CompressMessage(party_id, message);
+  };
+  auto send_message = [&](message_t& message, bool coalesce) {
+    const auto number_of_queued_bytes = message->number_of_queued_bytes;
+    prepare_message(message);
+    if (coalesce && message->size() <= kMaximumCoalescedMessageSize) {
+      if (batch.size() + message->size() > kMaximumBatchSize) {
+        flush_batch();
+      }
+      if (batch_size == 0) {
+        batch_type = GetMessage(message->buffer.data())->message_type();
+      }
+      const auto message_size = static_cast<std::uint32_t>(message->size());
+      const auto message_size_pointer = reinterpret_cast<const std::uint8_t*>(&message_size);
+      batch.insert(batch.end(), message_size_pointer, message_size_pointer + sizeof(message_size));
+      for (const auto& part : message->GetParts()) {
+        batch.insert(batch.end(), part.begin(), part.end());
+      }
+      ++batch_size;
+    } else {
+      // keep the order of the messages
+      flush_batch();
+      const bool tracing = Tracer::IsEnabled();
+      const auto start = tracing ? Tracer::ClockType::now() : Tracer::TimePoint();
+      if (message->payload.empty()) {
+        transport.SendMessage(std::span(message->buffer.data(), message->buffer.size()));
+      } else {
+        transport.SendMessageParts(message->GetParts());
+      }
+      if (tracing) {
+        trace_send(GetMessage(message->buffer.data())->message_type(), message->size(), start);
+      }
       if (logger_) {
-        logger_->LogDebug(fmt::format("Sent message to party {}", party_id));
+        logger_->LogDebug("Sent message to party {}", party_id);
+      }
+    }
+    // a coalesced message only occupies the bounded batch from now on
+    ReleaseSendQueueBytes(party_id, number_of_queued_bytes);
+  };
+
+  // the messages of the prioritized send queue by lane, where the first message of a lane may be
+  // partially sent in fragments
+  struct Lane {
+    std::deque<message_t> messages;
+    std::size_t fragment_offset = 0;
+  };
+  std::array<Lane, kNumberOfSendLanes> lanes;
+
+  // a few small dequeued messages are sent together with the messages that arrive within the
+  // coalescing window, which is a fraction of the round-trip time scaled by how often the last
+  // waits collected further messages, s.t. waiting stops paying its delay when it is in vain
+  double coalescing_window_scale = 1.0;
+  auto& coalescing_statistics = coalescing_statistics_.at(party_id);
+  auto collect_messages = [&](std::queue<message_t>& messages) {
+    const auto maximum_window =
+        std::min(kMaximumCoalescingWindow,
+                 std::chrono::nanoseconds(round_trip_nanoseconds_ / kCoalescingWindowDivisor));
+    // larger messages and a backlog in the queue fill the link on their own
+    if (!message_coalescing_ || maximum_window.count() == 0 ||
+        GetNumberOfQueuedBytes(party_id) > kMaximumCoalescedMessageSize) {
+      return;
+    }
+    const auto window = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        maximum_window * coalescing_window_scale);
+    coalescing_statistics.window_nanoseconds.store(window.count(), std::memory_order_relaxed);
+    coalescing_statistics.number_of_waits.fetch_add(1, std::memory_order_relaxed);
+    const auto deadline = std::chrono::steady_clock::now() + window;
+    std::size_t number_of_collected_messages = 0;
+    while (GetNumberOfQueuedBytes(party_id) <= kMaximumCoalescedMessageSize) {
+      auto further_messages = queue.TryBatchDequeueUntil(deadline);
+      if (further_messages.empty()) break;
+      number_of_collected_messages += further_messages.size();
+      for (; !further_messages.empty(); further_messages.pop()) {
+        messages.push(std::move(further_messages.front()));
       }
     }
+    coalescing_statistics.number_of_collected_messages.fetch_add(number_of_collected_messages,
+                                                                 std::memory_order_relaxed);
+    coalescing_window_scale = number_of_collected_messages > 0
+                                  ? std::min(1.0, 2 * coalescing_window_scale)
+                                  : std::max(kMinimumCoalescingWindowScale,
+                                             coalescing_window_scale / 2);
+  };
+  auto& number_of_prioritized_messages = number_of_prioritized_messages_.at(party_id);
+  auto send_fragment = [&](std::size_t lane_index) {
+    auto& lane = lanes[lane_index];
+    auto& message = lane.messages.front();
+    const auto number_of_queued_bytes = message->number_of_queued_bytes;
+    if (lane.fragment_offset == 0) prepare_message(message);
+    const std::uint64_t message_size = message->size();
+    const auto fragment_size = std::min(kMessageFragmentSize, message_size - lane.fragment_offset);
+    // the payload is the size of the whole message followed by the fragment
+    auto [message_builder, payload_offset] = BuildMessageHeader(
+        MessageType::kMessageFragment, lane_index, sizeof(message_size) + fragment_size);
+    const auto header = message_builder.Release();
+    const std::span<const std::uint8_t> header_bytes(header.data(), header.size());
+    std::vector<std::span<const std::uint8_t>> parts{
+        header_bytes.subspan(0, payload_offset),
+        std::span(reinterpret_cast<const std::uint8_t*>(&message_size), sizeof(message_size))};
+    for (const auto part : message->GetParts(lane.fragment_offset, fragment_size)) {
+      parts.push_back(part);
+    }
+    parts.push_back(header_bytes.subspan(payload_offset + sizeof(message_size) + fragment_size));
+    const bool tracing = Tracer::IsEnabled();
+    const auto start = tracing ? Tracer::ClockType::now() : Tracer::TimePoint();
+    transport.SendMessageParts(parts);
+    if (tracing) trace_send(MessageType::kMessageFragment, header.size(), start);
+    lane.fragment_offset += fragment_size;
+    if (lane.fragment_offset == message_size) {
+      lane.messages.pop_front();
+      lane.fragment_offset = 0;
+      --number_of_prioritized_messages;
+      ReleaseSendQueueBytes(party_id, number_of_queued_bytes);
+    }
+  };
+
+  while (true) {
+    const bool lanes_are_empty = std::all_of(
+        lanes.begin(), lanes.end(), [](const Lane& lane) { return lane.messages.empty(); });
+    std::queue<message_t> messages;
+    if (lanes_are_empty) {
+      auto dequeued_messages = queue.BatchDequeue();
+      if (!dequeued_messages.has_value()) {
+        assert(queue.IsClosed());
+        break;
+      }
+      messages = std::move(*dequeued_messages);
+      collect_messages(messages);
+    } else {
+      // new messages may overtake the remaining ones of lower priority
+      messages = queue.TryBatchDequeue();
+    }
+
+    if (lanes_are_empty && !message_prioritization_) {
+      const bool coalesce = message_coalescing_ && messages.size() > 1;
+      for (; !messages.empty(); messages.pop()) send_message(messages.front(), coalesce);
+      flush_batch();
+      continue;
+    }
+
+    number_of_prioritized_messages += messages.size();
+    for (; !messages.empty(); messages.pop()) {
+      auto& message = messages.front();
+      const auto lane = GetSendLane(GetMessage(message->buffer.data())->message_type());
+      lanes[static_cast<std::size_t>(lane)].messages.push_back(std::move(message));
+    }
+    // only the first lane with messages is served before looking for new messages again
+    const auto lane_index = static_cast<std::size_t>(
+        std::find_if(lanes.begin(), lanes.end(),
+                     [](const Lane& lane) { return !lane.messages.empty(); }) -
+        lanes.begin());
+    auto& lane = lanes[lane_index];
+    if (lane.fragment_offset > 0 || lane.messages.front()->size() > kMessageFragmentSize) {
+      send_fragment(lane_index);
+      continue;
+    }
+    // the messages up to the next large one are sent at once
+    const bool coalesce = message_coalescing_ && lane.messages.size() > 1;
+    while (!lane.messages.empty() && lane.messages.front()->size() <= kMessageFragmentSize) {
+      send_message(lane.messages.front(), coalesce);
+      lane.messages.pop_front();
+      --number_of_prioritized_messages;
+    }
+    flush_batch();
   }
 
   transport.ShutdownSend();
 
   if (logger_) {
-    logger_->LogDebug(fmt::format("SendTask finished for party {}", party_id));
+    logger_->LogDebug("SendTask finished for party {}", party_id);
   }
 }
 
@@ -144,63 +642,267 @@ void CommunicationLayer::CommunicationLayerImplementation::ReceiveTask(
       raw_message_opt = transport.ReceiveMessage();
     } catch (std::runtime_error& e) {
       if (logger_) {
-        logger_->LogError(
-            fmt::format("ReceiveMessage failed for party {}: {}", party_id, e.what()));
+        logger_->LogError("ReceiveMessage failed for party {}: {}", party_id, e.what());
       }
       break;
     }
     if (!raw_message_opt.has_value()) {
-      // underlying transport was closed unexpectedly
-      if (logger_) {
-        logger_->LogError(
-            fmt::format("underlying transport was closed unexpectedly from party {}", party_id));
+      // with a dispatch thread, the termination message may still be queued, which is checked by
+      // the dispatch thread
+      if (!message_dispatch_thread_ && logger_) {
+        logger_->LogError("underlying transport was closed unexpectedly from party {}", party_id);
       }
       break;
     }
-    auto raw_message = std::move(*raw_message_opt);
+    if (message_dispatch_thread_) {
+      // keep reading from the transport while the message is verified and dispatched, the loop
+      // ends when the other party closes the transport after its termination message
+      MemoryAccounting::Add(MemorySubsystem::kMessageBuffers, raw_message_opt->size());
+      dispatch_queues_.at(party_id).enqueue(std::move(*raw_message_opt));
+    } else if (!HandleMessage(party_id, std::move(*raw_message_opt), message_manager)) {
+      break;
+    }
+  }
+  dispatch_queues_.at(party_id).close();
+
+  if constexpr (kDebug) {
+    if (logger_) {
+      logger_->LogDebug("ReceiveTask finished for party {}", party_id);
+    }
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::DispatchTask(
+    std::size_t party_id, MessageManager& message_manager) {
+  auto& queue = dispatch_queues_.at(party_id);
+  bool terminated = false;
+  while (auto messages = queue.BatchDequeue()) {
+    for (; !messages->empty(); messages->pop()) {
+      MemoryAccounting::Subtract(MemorySubsystem::kMessageBuffers, messages->front().size());
+      if (!terminated && !HandleMessage(party_id, std::move(messages->front()), message_manager)) {
+        terminated = true;
+      }
+    }
+  }
+  if (message_dispatch_thread_ && !termination_received_.at(party_id) && logger_) {
+    logger_->LogError("underlying transport was closed unexpectedly from party {}", party_id);
+  }
+}
+
+bool CommunicationLayer::CommunicationLayerImplementation::HandleMessage(
+    std::size_t party_id, std::vector<std::uint8_t>&& raw_message, MessageManager& message_manager,
+    bool relayed) {
+  if (message_verification_) {
     flatbuffers::Verifier verifier(reinterpret_cast<std::uint8_t*>(raw_message.data()),
                                    raw_message.size());
     if (!VerifyMessageBuffer(verifier)) {
       if (logger_) {
-        logger_->LogError(fmt::format("received corrupt message from party {}", party_id));
+        logger_->LogError("received corrupt message from party {}", party_id);
       }
-      continue;
+      return true;
     }
+  }
 
-    // XXX: maybe use a separate thread for this
-    auto message = GetMessage(raw_message.data());
+  auto message = GetMessage(raw_message.data());
 
-    auto message_id = message->message_id();
-    auto message_type = message->message_type();
+  auto message_id = message->message_id();
+  auto message_type = message->message_type();
+  if (Tracer::IsEnabled()) {
+    const auto now = Tracer::ClockType::now();
+    Tracer::Get().RecordMessage(Tracer::Category::kMessageReceived,
+                                EnumNameMessageType(message_type), my_id_, party_id,
+                                raw_message.size(), now, now);
+  }
+  // the messages inside of batches, compressed, relayed, fragmented and streamed messages are
+  // counted on their own
+  if (message_type != MessageType::kBatchedMessage &&
+      message_type != MessageType::kCompressedMessage &&
+      message_type != MessageType::kRelayedMessage &&
+      message_type != MessageType::kMessageFragment &&
+      message_type != MessageType::kMessageStream) {
+    auto& counters = GetMessageTypeCounters(party_id, message_type);
+    counters.number_of_messages_received.fetch_add(1, std::memory_order_relaxed);
+    counters.number_of_bytes_received.fetch_add(raw_message.size(), std::memory_order_relaxed);
+  }
+  if constexpr (kDebug) {
+    if (logger_) {
+      logger_->LogDebug("received message of type {} with id {} from party {}",
+                        EnumNameMessageType(message_type), message_id, party_id);
+    }
+  }
+  if (relayed && (message_type == MessageType::kTerminationMessage ||
+                  message_type == MessageType::kRelayedMessage ||
+                  message_type == MessageType::kMessageFragment)) {
+    if (logger_) {
+      logger_->LogError("received invalid relayed message from party {}", party_id);
+    }
+    return true;
+  } else if (message_type == MessageType::kTerminationMessage) {
     if constexpr (kDebug) {
       if (logger_) {
-        logger_->LogDebug(fmt::format("received message of type {} with id {} from party {}",
-                                      EnumNameMessageType(message_type), message_id, party_id));
+        logger_->LogDebug("received termination message from party {}", party_id);
       }
     }
-    if (message_type == MessageType::kTerminationMessage) {
-      if constexpr (kDebug) {
-        if (logger_) {
-          logger_->LogDebug(fmt::format("received termination message from party {}", party_id));
-        }
+    termination_received_.at(party_id) = true;
+    return false;
+  } else if (message_type == MessageType::kBatchedMessage) {
+    auto payload = message->payload();
+    std::span<const std::uint8_t> batch(payload->data(), payload->size());
+    while (batch.size() >= sizeof(std::uint32_t)) {
+      std::uint32_t message_size;
+      std::copy_n(batch.data(), sizeof(message_size),
+                  reinterpret_cast<std::uint8_t*>(&message_size));
+      batch = batch.subspan(sizeof(message_size));
+      if (message_size > batch.size()) {
+        break;
+      }
+      // copy the message into its own buffer, which is correctly aligned for the verifier
+      std::vector<std::uint8_t> inner_message(batch.begin(), batch.begin() + message_size);
+      batch = batch.subspan(message_size);
+      if (!HandleMessage(party_id, std::move(inner_message), message_manager)) {
+        return false;
       }
-      break;
-    } else if (message_type == MessageType::kSynchronizationMessage) {
-      message_manager.GetSyncStates(party_id).enqueue(std::move(raw_message));
-    } else {
-      assert(!message_manager.GetMessagePromises(party_id).empty());
-      assert(message_manager.GetMessagePromises(party_id).contains(message_type));
-      assert(message_manager.GetMessagePromises(party_id)[message_type].contains(message_id));
-      message_manager.GetMessagePromises(party_id)[message_type][message_id]->set_value(
-          std::move(raw_message));
     }
-  }
-
-  if constexpr (kDebug) {
-    if (logger_) {
-      logger_->LogDebug(fmt::format("ReceiveTask finished for party {}", party_id));
+    if (!batch.empty() && logger_) {
+      logger_->LogError("received corrupt message batch from party {}", party_id);
+    }
+  } else if (message_type == MessageType::kCompressedMessage) {
+    auto payload = message->payload();
+    std::optional<std::vector<std::uint8_t>> inner_message;
+    if (payload != nullptr) {
+      inner_message = DecompressBytes(std::span(payload->data(), payload->size()));
+    }
+    if (!inner_message.has_value()) {
+      if (logger_) {
+        logger_->LogError("received corrupt compressed message from party {}", party_id);
+      }
+      return true;
+    }
+    return HandleMessage(party_id, std::move(*inner_message), message_manager);
+  } else if (message_type == MessageType::kMessageFragment) {
+    // the fragments of the messages of a lane arrive in order, one message after another
+    auto payload = message->payload();
+    std::uint64_t message_size;
+    if (payload == nullptr || payload->size() < sizeof(message_size) ||
+        message_id >= kNumberOfSendLanes) {
+      if (logger_) {
+        logger_->LogError("received corrupt message fragment from party {}", party_id);
+      }
+      return true;
+    }
+    std::copy_n(payload->data(), sizeof(message_size),
+                reinterpret_cast<std::uint8_t*>(&message_size));
+    auto& buffer = fragment_buffers_.at(party_id)[message_id];
+    if (buffer.empty()) buffer.reserve(std::min<std::uint64_t>(message_size, kMaximumBatchSize));
+    buffer.insert(buffer.end(), payload->data() + sizeof(message_size),
+                  payload->data() + payload->size());
+    if (buffer.size() > message_size) {
+      if (logger_) {
+        logger_->LogError("received corrupt fragmented message from party {}", party_id);
+      }
+      buffer = {};
+      return true;
+    }
+    if (buffer.size() == message_size) {
+      auto whole_message = std::move(buffer);
+      buffer = {};
+      return HandleMessage(party_id, std::move(whole_message), message_manager);
+    }
+  } else if (message_type == MessageType::kMessageStream) {
+    auto payload = message->payload();
+    if (payload == nullptr || payload->size() < kStreamFragmentHeaderSize ||
+        payload->data()[0] > static_cast<std::uint8_t>(MessageType::MAX) ||
+        GetMessagePhase(static_cast<MessageType>(payload->data()[0])) == MessagePhase::kControl) {
+      if (logger_) {
+        logger_->LogError("received corrupt message stream from party {}", party_id);
+      }
+      return true;
+    }
+    const auto stream_message_type = static_cast<MessageType>(payload->data()[0]);
+    std::uint64_t payload_size;
+    std::copy_n(payload->data() + sizeof(std::uint8_t), sizeof(payload_size),
+                reinterpret_cast<std::uint8_t*>(&payload_size));
+    std::vector<std::uint8_t> fragment(payload->begin() + kStreamFragmentHeaderSize,
+                                       payload->end());
+    std::unique_lock lock(received_streams_mutex_);
+    const auto key = std::make_tuple(party_id, stream_message_type, std::size_t(message_id));
+    auto& stream = received_streams_[key];
+    stream.number_of_bytes += fragment.size();
+    if (stream.number_of_bytes > payload_size) {
+      if (logger_) {
+        logger_->LogError("received corrupt message stream from party {}", party_id);
+      }
+      received_streams_.erase(key);
+      return true;
+    }
+    const bool last = stream.number_of_bytes == payload_size;
+    if (message_manager.ReceivedStreamFragment(party_id, stream_message_type, message_id,
+                                               std::move(fragment), last)) {
+      if (last) {
+        received_streams_.erase(key);
+        auto& counters = GetMessageTypeCounters(party_id, stream_message_type);
+        counters.number_of_messages_received.fetch_add(1, std::memory_order_relaxed);
+        counters.number_of_bytes_received.fetch_add(payload_size, std::memory_order_relaxed);
+      }
+      return true;
+    }
+    // without a registered stream the message is reassembled, which is when it fits into one
+    if (payload_size > kMaximumReassembledPayloadSize) {
+      const bool first = stream.number_of_bytes == payload->size() - kStreamFragmentHeaderSize;
+      if (last) received_streams_.erase(key);
+      if (first) {
+        // the receiver fails instead of waiting for a message that never arrives
+        const auto error{fmt::format(
+            "cannot reassemble message stream of {} B from party {} without a registered stream",
+            payload_size, party_id)};
+        if (logger_) logger_->LogError(error);
+        message_manager.ReceivedError(party_id, stream_message_type, message_id,
+                                      std::make_exception_ptr(std::runtime_error(error)));
+      }
+      return true;
     }
+    stream.buffer.insert(stream.buffer.end(), fragment.begin(), fragment.end());
+    if (!last) return true;
+    auto stream_payload = std::move(stream.buffer);
+    received_streams_.erase(key);
+    lock.unlock();
+    auto whole_message =
+        BuildMessage(stream_message_type, message_id, stream_payload).Release();
+    return HandleMessage(party_id,
+                         std::vector<std::uint8_t>(whole_message.data(),
+                                                   whole_message.data() + whole_message.size()),
+                         message_manager, relayed);
+  } else if (message_type == MessageType::kRelayedMessage) {
+    // the original sender is stored in the message id
+    const std::size_t sender_id = message_id;
+    auto payload = message->payload();
+    if (payload == nullptr || sender_id >= number_of_parties_ || sender_id == my_id_) {
+      if (logger_) {
+        logger_->LogError("received corrupt relayed message from party {}", party_id);
+      }
+      return true;
+    }
+    std::vector<std::uint8_t> inner_message(payload->begin(), payload->end());
+    if (sender_id == party_id) {
+      // this party is the hub, which forwards the message unchanged to the other parties; this
+      // does not depend on the own setting, which might be applied later than the sender's
+      auto outgoing_message = std::make_shared<OutgoingMessage>(
+          BuildMessage(MessageType::kRelayedMessage, sender_id, inner_message).Release());
+      outgoing_message->memory_account.Set(outgoing_message->size());
+      for (std::size_t other_id = 0; other_id < number_of_parties_; ++other_id) {
+        // the queues are only closed when shutting down, after which no broadcasts are relayed
+        if (other_id != my_id_ && other_id != sender_id && !send_queues_[other_id].IsClosed()) {
+          send_queues_[other_id].enqueue(outgoing_message);
+        }
+      }
+    }
+    return HandleMessage(sender_id, std::move(inner_message), message_manager, true);
+  } else if (message_type == MessageType::kSynchronizationMessage) {
+    message_manager.GetSyncStates(party_id).enqueue(std::move(raw_message));
+  } else {
+    message_manager.ReceivedMessage(party_id, std::move(raw_message));
   }
+  return true;
 }
 
 void CommunicationLayer::CommunicationLayerImplementation::Shutdown() {
@@ -216,6 +918,7 @@ void CommunicationLayer::CommunicationLayerImplementation::Shutdown() {
     }
     send_threads_.at(party_id).join();
     receive_threads_.at(party_id).join();
+    dispatch_threads_.at(party_id).join();
     transports_.at(party_id)->Shutdown();
   }
 }
@@ -261,23 +964,21 @@ void CommunicationLayer::Synchronize() {
       logger_->LogDebug("start synchronization");
     }
   }
-  // broadcast sync message with counter value
-  {
-    std::span s(reinterpret_cast<const std::uint8_t*>(&sync_state_), sizeof(sync_state_));
-    assert(s.size() == 8);
-    auto message_builder = BuildMessage(MessageType::kSynchronizationMessage, s);
-    BroadcastMessage(message_builder.Release());
-  }
-  // wait for N-1 sync messages with at least the same value
-  for (auto& q : message_manager_->GetSyncStates()) {
-    if constexpr (kDebug) {
-      auto bytes{*q.dequeue()};
-      std::size_t other_state;
-      std::copy_n(GetMessage(bytes.data())->payload()->data(), sizeof(other_state),
-                  reinterpret_cast<uint8_t*>(&other_state));
-      assert(sync_state_ == other_state);
-    } else {
-      q.dequeue();
+  StartSynchronization();
+  if (synchronization_mode_ == SynchronizationMode::kAllToAll) {
+    // wait for N-1 sync messages with the same value
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id != my_id_) {
+        WaitForSynchronizationMessage(party_id);
+      }
+    }
+  } else {
+    // after round r, all of the 2^(r+1) - 1 parties before this one started the synchronization
+    for (std::size_t distance = 1; distance < number_of_parties_; distance *= 2) {
+      WaitForSynchronizationMessage((my_id_ + number_of_parties_ - distance) % number_of_parties_);
+      if (2 * distance < number_of_parties_) {
+        SendMessage((my_id_ + 2 * distance) % number_of_parties_, BuildSynchronizationMessage());
+      }
     }
   }
   if constexpr (kDebug) {
@@ -285,13 +986,175 @@ void CommunicationLayer::Synchronize() {
       logger_->LogDebug("finished synchronization");
     }
   }
+  synchronization_started_ = false;
   // increment counter
   ++sync_state_;
 }
 
+void CommunicationLayer::StartSynchronization() {
+  if (synchronization_started_) {
+    return;
+  }
+  synchronization_started_ = true;
+  if (synchronization_mode_ == SynchronizationMode::kAllToAll) {
+    BroadcastMessage(BuildSynchronizationMessage());
+  } else {
+    SendMessage((my_id_ + 1) % number_of_parties_, BuildSynchronizationMessage());
+  }
+}
+
+void CommunicationLayer::SetSynchronizationMode(SynchronizationMode mode) {
+  if (synchronization_started_) {
+    throw std::logic_error("changing the synchronization mode while synchronizing");
+  }
+  synchronization_mode_ = mode;
+}
+
+flatbuffers::DetachedBuffer CommunicationLayer::BuildSynchronizationMessage() const {
+  // the message contains the counter value
+  std::span s(reinterpret_cast<const std::uint8_t*>(&sync_state_), sizeof(sync_state_));
+  assert(s.size() == 8);
+  return BuildMessage(MessageType::kSynchronizationMessage, s).Release();
+}
+
+void CommunicationLayer::WaitForSynchronizationMessage(std::size_t party_id) {
+  auto& queue = message_manager_->GetSyncStates(party_id);
+  if constexpr (kDebug) {
+    auto bytes{*queue.dequeue()};
+    std::size_t other_state;
+    std::copy_n(GetMessage(bytes.data())->payload()->data(), sizeof(other_state),
+                reinterpret_cast<uint8_t*>(&other_state));
+    assert(sync_state_ == other_state);
+  } else {
+    queue.dequeue();
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::Enqueue(std::size_t party_id,
+                                                                   message_t&& message) {
+  const auto number_of_bytes = message->size() + message->payload.size();
+  message->memory_account.Set(number_of_bytes);
+  message->number_of_queued_bytes = number_of_bytes;
+  if (party_id != kAll) {
+    AcquireSendQueueBytes(party_id, number_of_bytes);
+    send_queues_[party_id].enqueue(std::move(message));
+    return;
+  }
+  for (std::size_t other_id = 0; other_id < number_of_parties_; ++other_id) {
+    if (other_id == my_id_) continue;
+    AcquireSendQueueBytes(other_id, number_of_bytes);
+    send_queues_[other_id].enqueue(message);
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::AcquireSendQueueBytes(
+    std::size_t party_id, std::size_t number_of_bytes) {
+  auto& queue_bytes = send_queue_bytes_[party_id];
+  std::unique_lock lock(queue_bytes.mutex);
+  if (queue_bytes.full) {
+    // a message larger than the high watermark is accepted by an empty queue, so this terminates
+    const auto start = std::chrono::steady_clock::now();
+    queue_bytes.condition.wait(lock, [&queue_bytes] { return !queue_bytes.full; });
+    ++queue_bytes.number_of_waits;
+    queue_bytes.wait_time += std::chrono::steady_clock::now() - start;
+  }
+  queue_bytes.number_of_bytes += number_of_bytes;
+  queue_bytes.peak_number_of_bytes =
+      std::max(queue_bytes.peak_number_of_bytes, queue_bytes.number_of_bytes);
+  const std::size_t high_watermark = send_queue_high_watermark_;
+  if (high_watermark > 0 && queue_bytes.number_of_bytes >= high_watermark) {
+    queue_bytes.full = true;
+  }
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::ReleaseSendQueueBytes(
+    std::size_t party_id, std::size_t number_of_bytes) {
+  if (number_of_bytes == 0) return;
+  auto& queue_bytes = send_queue_bytes_[party_id];
+  {
+    std::scoped_lock lock(queue_bytes.mutex);
+    assert(queue_bytes.number_of_bytes >= number_of_bytes);
+    queue_bytes.number_of_bytes -= number_of_bytes;
+    if (!queue_bytes.full || queue_bytes.number_of_bytes > send_queue_low_watermark_) return;
+    queue_bytes.full = false;
+  }
+  queue_bytes.condition.notify_all();
+}
+
+void CommunicationLayer::CommunicationLayerImplementation::CompressMessage(std::size_t party_id,
+                                                                           message_t& message) {
+  // messages with a separate payload are large and sent without copying them
+  if (!message->payload.empty() || message->size() < kMinimumCompressedMessageSize) {
+    return;
+  }
+  const auto message_type =
+      static_cast<std::size_t>(GetMessage(message->buffer.data())->message_type());
+  if (!compressed_message_types_[message_type]) {
+    return;
+  }
+  auto& backoff = compression_backoff_[party_id][message_type];
+  if (backoff > 0) {
+    --backoff;
+    return;
+  }
+  auto compressed = CompressBytes(std::span(message->buffer.data(), message->buffer.size()));
+  if (compressed.size() > kMaximumCompressionRatio * message->size()) {
+    backoff = kCompressionBackoff;
+    return;
+  }
+  auto& statistics = compression_statistics_[party_id];
+  statistics.number_of_bytes_before_compression += message->size();
+  statistics.number_of_bytes_after_compression += compressed.size();
+  message = std::make_shared<OutgoingMessage>(
+      BuildMessage(MessageType::kCompressedMessage, compressed).Release());
+}
+
 void CommunicationLayer::SendMessage(std::size_t party_id, flatbuffers::DetachedBuffer&& message) {
-  implementation_->send_queues_[party_id].enqueue(
-      std::make_shared<flatbuffers::DetachedBuffer>(std::move(message)));
+  auto outgoing_message =
+      std::make_shared<CommunicationLayerImplementation::OutgoingMessage>(std::move(message));
+  implementation_->Enqueue(party_id, std::move(outgoing_message));
+}
+
+void CommunicationLayer::SendMessage(std::size_t party_id, MessageType message_type,
+                                     std::size_t message_id, std::span<const std::uint8_t> payload,
+                                     std::shared_ptr<const void> payload_owner) {
+  if (payload.size() > kMaximumUnstreamedPayloadSize) {
+    SendMessageStream(party_id, message_type, message_id, payload, std::move(payload_owner));
+    return;
+  }
+  if (payload.size() <= kMaximumCoalescedMessageSize) {
+    // small messages are copied, so that they can be sent in a batch
+    SendMessage(party_id, BuildMessage(message_type, message_id, payload).Release());
+    return;
+  }
+  auto [message_builder, payload_offset] =
+      BuildMessageHeader(message_type, message_id, payload.size());
+  auto outgoing_message = std::make_shared<CommunicationLayerImplementation::OutgoingMessage>(
+      message_builder.Release(), payload, payload_offset, std::move(payload_owner));
+  implementation_->Enqueue(party_id, std::move(outgoing_message));
+}
+
+void CommunicationLayer::SendMessageStream(std::size_t party_id, MessageType message_type,
+                                           std::size_t message_id,
+                                           std::span<const std::uint8_t> payload,
+                                           std::shared_ptr<const void> payload_owner,
+                                           std::size_t fragment_size) {
+  if (fragment_size == 0 || fragment_size > kMaximumUnstreamedPayloadSize) {
+    throw std::invalid_argument(
+        fmt::format("Invalid fragment size {} B of a message stream", fragment_size));
+  }
+  // an empty payload is sent as one empty fragment
+  std::size_t offset = 0;
+  do {
+    const auto fragment = payload.subspan(offset, std::min(fragment_size, payload.size() - offset));
+    auto [message_builder, fragment_offset] =
+        BuildStreamFragmentHeader(message_type, message_id, payload.size(), fragment.size());
+    // every fragment keeps the payload alive
+    auto outgoing_message = std::make_shared<CommunicationLayerImplementation::OutgoingMessage>(
+        message_builder.Release(), fragment, fragment_offset, payload_owner);
+    implementation_->Enqueue(party_id, std::move(outgoing_message));
+    offset += fragment.size();
+  } while (offset < payload.size());
 }
 
 void CommunicationLayer::BroadcastMessage(flatbuffers::DetachedBuffer&& message) {
@@ -299,11 +1162,42 @@ void CommunicationLayer::BroadcastMessage(flatbuffers::DetachedBuffer&& message)
     SendMessage(1 - my_id_, std::move(message));
     return;
   }
-  auto shared_message = std::make_shared<flatbuffers::DetachedBuffer>(std::move(message));
+  // every link needs its own termination message, so they are never relayed
+  if (const std::size_t hub = implementation_->broadcast_hub_;
+      hub != kAll && hub != my_id_ &&
+      GetMessage(message.data())->message_type() != MessageType::kTerminationMessage) {
+    SendMessage(hub, BuildMessage(MessageType::kRelayedMessage, my_id_,
+                                  std::span<const std::uint8_t>(message.data(), message.size()))
+                         .Release());
+    return;
+  }
+  // the message is shared by the send queues of all parties, ie it is serialized only once
+  SendMessage(kAll, std::move(message));
+}
 
-  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
-    if (party_id != my_id_) implementation_->send_queues_[party_id].enqueue(shared_message);
+void CommunicationLayer::BroadcastMessage(MessageType message_type, std::size_t message_id,
+                                          std::span<const std::uint8_t> payload,
+                                          std::shared_ptr<const void> payload_owner) {
+  if (const std::size_t hub = implementation_->broadcast_hub_;
+      number_of_parties_ > 2 && hub != kAll && hub != my_id_) {
+    // the payload is copied into the relayed message
+    if (payload.size() <= kMaximumUnstreamedPayloadSize) {
+      BroadcastMessage(BuildMessage(message_type, message_id, payload).Release());
+      return;
+    }
+    for (std::size_t offset = 0; offset < payload.size(); offset += kDefaultStreamFragmentSize) {
+      const auto fragment = payload.subspan(
+          offset, std::min(kDefaultStreamFragmentSize, payload.size() - offset));
+      auto [message_builder, fragment_offset] =
+          BuildStreamFragmentHeader(message_type, message_id, payload.size(), fragment.size());
+      std::copy(fragment.begin(), fragment.end(),
+                message_builder.GetBufferPointer() + fragment_offset);
+      BroadcastMessage(message_builder.Release());
+    }
+    return;
   }
+  SendMessage(number_of_parties_ == 2 ? 1 - my_id_ : kAll, message_type, message_id, payload,
+              std::move(payload_owner));
 }
 
 void CommunicationLayer::Shutdown() {
@@ -329,10 +1223,130 @@ std::vector<TransportStatistics> CommunicationLayer::GetTransportStatistics() co
       continue;
     }
     statistics.emplace_back(implementation_->transports_.at(party_id)->GetStatistics());
+    const auto& compression_statistics = implementation_->compression_statistics_.at(party_id);
+    statistics.back().number_of_bytes_before_compression =
+        compression_statistics.number_of_bytes_before_compression;
+    statistics.back().number_of_bytes_after_compression =
+        compression_statistics.number_of_bytes_after_compression;
+    {
+      auto& queue_bytes = implementation_->send_queue_bytes_.at(party_id);
+      std::scoped_lock lock(queue_bytes.mutex);
+      statistics.back().peak_send_queue_bytes = queue_bytes.peak_number_of_bytes;
+      statistics.back().number_of_send_queue_waits = queue_bytes.number_of_waits;
+      statistics.back().send_queue_wait_time = queue_bytes.wait_time;
+    }
+    const auto& coalescing_statistics = implementation_->coalescing_statistics_.at(party_id);
+    statistics.back().coalescing_window = std::chrono::nanoseconds(
+        coalescing_statistics.window_nanoseconds.load(std::memory_order_relaxed));
+    statistics.back().number_of_coalescing_waits =
+        coalescing_statistics.number_of_waits.load(std::memory_order_relaxed);
+    statistics.back().number_of_messages_collected_by_waiting =
+        coalescing_statistics.number_of_collected_messages.load(std::memory_order_relaxed);
+    for (std::size_t type = 0; type < kNumberOfMessageTypes; ++type) {
+      const auto message_type = static_cast<MessageType>(type);
+      const auto& counters = implementation_->GetMessageTypeCounters(party_id, message_type);
+      MessageTypeStatistics message_type_statistics{
+          GetMessagePhase(message_type),
+          counters.number_of_messages_sent.load(std::memory_order_relaxed),
+          counters.number_of_messages_received.load(std::memory_order_relaxed),
+          counters.number_of_bytes_sent.load(std::memory_order_relaxed),
+          counters.number_of_bytes_received.load(std::memory_order_relaxed),
+          std::chrono::nanoseconds(
+              counters.send_queue_nanoseconds.load(std::memory_order_relaxed))};
+      if (message_type_statistics.number_of_messages_sent > 0 ||
+          message_type_statistics.number_of_messages_received > 0) {
+        statistics.back().message_types.emplace(EnumNameMessageType(message_type),
+                                                message_type_statistics);
+      }
+    }
   }
   return statistics;
 }
 
+std::vector<std::size_t> CommunicationLayer::GetSendQueueSizes() const {
+  std::vector<std::size_t> sizes(number_of_parties_, 0);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      sizes[party_id] = implementation_->send_queues_.at(party_id).size() +
+                        implementation_->number_of_prioritized_messages_.at(party_id);
+    }
+  }
+  return sizes;
+}
+
+std::vector<std::size_t> CommunicationLayer::GetSendQueueBytes() const {
+  std::vector<std::size_t> number_of_bytes(number_of_parties_, 0);
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id != my_id_) {
+      auto& queue_bytes = implementation_->send_queue_bytes_.at(party_id);
+      std::scoped_lock lock(queue_bytes.mutex);
+      number_of_bytes[party_id] = queue_bytes.number_of_bytes;
+    }
+  }
+  return number_of_bytes;
+}
+
+void CommunicationLayer::SetSendQueueWatermarks(std::size_t high_watermark,
+                                                std::size_t low_watermark) {
+  if (low_watermark > high_watermark) {
+    throw std::invalid_argument(fmt::format(
+        "Low watermark {} of the send queues exceeds the high watermark {}", low_watermark,
+        high_watermark));
+  }
+  implementation_->send_queue_low_watermark_ = low_watermark;
+  implementation_->send_queue_high_watermark_ = high_watermark;
+  // the new watermarks apply to the next messages, the waiting producers are released
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    auto& queue_bytes = implementation_->send_queue_bytes_.at(party_id);
+    {
+      std::scoped_lock lock(queue_bytes.mutex);
+      queue_bytes.full = false;
+    }
+    queue_bytes.condition.notify_all();
+  }
+}
+
+void CommunicationLayer::SetMessageCoalescing(bool value) {
+  implementation_->message_coalescing_ = value;
+}
+
+void CommunicationLayer::SetRoundTripTime(std::chrono::microseconds round_trip_time) {
+  if (round_trip_time.count() < 0) {
+    throw std::invalid_argument(
+        fmt::format("Negative round-trip time of {} us", round_trip_time.count()));
+  }
+  implementation_->round_trip_nanoseconds_ =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(round_trip_time).count();
+}
+
+void CommunicationLayer::SetMessagePrioritization(bool value) {
+  implementation_->message_prioritization_ = value;
+}
+
+void CommunicationLayer::SetMessageDispatchThread(bool value) {
+  implementation_->message_dispatch_thread_ = value;
+}
+
+void CommunicationLayer::SetMessageVerification(bool value) {
+  implementation_->message_verification_ = value;
+}
+
+void CommunicationLayer::SetMessageCompression(MessageType message_type, bool value) {
+  if (value && !IsMessageCompressionAvailable()) {
+    throw std::logic_error("message compression requires building MOTION with MOTION_USE_ZSTD");
+  }
+  implementation_->compressed_message_types_.at(static_cast<std::size_t>(message_type)) = value;
+}
+
+void CommunicationLayer::SetBroadcastHub(std::optional<std::size_t> hub_id) {
+  if (hub_id.has_value() && *hub_id >= number_of_parties_) {
+    throw std::invalid_argument(
+        fmt::format("invalid broadcast hub: {} >= {}", *hub_id, number_of_parties_));
+  }
+  implementation_->broadcast_hub_ = hub_id.value_or(kAll);
+}
+
 void CommunicationLayer::SetLogger(std::shared_ptr<Logger> logger) {
   if (is_started_) {
     throw std::logic_error(
@@ -342,6 +1356,25 @@ void CommunicationLayer::SetLogger(std::shared_ptr<Logger> logger) {
   implementation_->logger_ = logger;
 }
 
+void CommunicationLayer::SetThreadAffinity(std::span<const std::size_t> cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+  std::size_t i = 0;
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    for (auto* thread : {&implementation_->receive_threads_.at(party_id),
+                         &implementation_->send_threads_.at(party_id),
+                         &implementation_->dispatch_threads_.at(party_id)}) {
+      if (thread->joinable()) {
+        ThreadSetAffinity(*thread, cpus[i++ % cpus.size()]);
+      }
+    }
+  }
+}
+
 std::vector<std::unique_ptr<CommunicationLayer>> MakeDummyCommunicationLayers(
     std::size_t number_of_parties) {
   std::vector<std::vector<std::unique_ptr<Transport>>> transports;
@@ -392,4 +1425,24 @@ std::vector<std::unique_ptr<CommunicationLayer>> MakeLocalTcpCommunicationLayers
   return communication_layers;
 }
 
+std::vector<std::unique_ptr<CommunicationLayer>> MakeSharedMemoryCommunicationLayers(
+    std::size_t number_of_parties) {
+  // unique names for concurrent test processes and for several sets of layers in one process
+  static std::atomic<std::size_t> instance = 0;
+  const auto name_prefix = fmt::format("/motion-{}-{}", getpid(), instance++);
+  std::vector<std::vector<std::unique_ptr<Transport>>> transports;
+  transports.reserve(number_of_parties);
+  // the parties are set up in order, so the regions of the lower party ids already exist
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    transports.emplace_back(MakeSharedMemoryTransports(party_id, number_of_parties, name_prefix));
+  }
+  std::vector<std::unique_ptr<CommunicationLayer>> communication_layers;
+  communication_layers.reserve(number_of_parties);
+  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+    communication_layers.emplace_back(
+        std::make_unique<CommunicationLayer>(party_id, std::move(transports.at(party_id))));
+  }
+  return communication_layers;
+}
+
 }  // namespace encrypto::motion::communication
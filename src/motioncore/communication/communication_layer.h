@@ -23,9 +23,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <span>
 #include <vector>
 
@@ -53,12 +55,24 @@ namespace encrypto::motion::communication {
 class MessageManager;
 struct TransportStatistics;
 
+// How the parties exchange the messages of CommunicationLayer::Synchronize
+enum class SynchronizationMode {
+  // every party sends a message to every other party, i.e., one round of N * (N - 1) messages
+  kAllToAll,
+  // every party sends a message to the party 2^r positions after it in round r, i.e.,
+  // ceil(log2 N) rounds of N messages each
+  kDissemination
+};
+
 // Central interface for all communication related functionality
 //
 // Allows to send messages to other parties and to register handlers for
 // specific message types.
 class CommunicationLayer {
  public:
+  // default size of the fragments of SendMessageStream
+  static constexpr std::size_t kDefaultStreamFragmentSize = 64 * 1024 * 1024;
+
   CommunicationLayer(std::size_t my_id, std::vector<std::unique_ptr<Transport>>&& transports);
   CommunicationLayer(std::size_t my_id, std::vector<std::unique_ptr<Transport>>&& transports,
                      std::shared_ptr<Logger> logger);
@@ -72,23 +86,116 @@ class CommunicationLayer {
 
   // Start communication
   void Start();
+
+  // Block until all parties called Synchronize, starts the synchronization if it was not started
+  // via StartSynchronization
   void Synchronize();
 
+  // Send the first messages of the next synchronization without waiting for the other parties,
+  // e.g., right after the last messages of a phase, s.t. they are sent together and the
+  // synchronization completes after one message delay instead of two.  Synchronize needs to be
+  // called afterwards to complete the synchronization.
+  void StartSynchronization();
+
+  // Select how the messages of the synchronization are exchanged (all-to-all by default), which
+  // needs to be the same for all parties.  The dissemination barrier needs more rounds, but
+  // fewer messages for many parties.  Throws std::logic_error while a synchronization is started.
+  void SetSynchronizationMode(SynchronizationMode mode);
+
   // Send a message to a specified party
   void SendMessage(std::size_t party_id, flatbuffers::DetachedBuffer&& message);
 
+  // Send a message to a specified party, where a large payload is written to the transport
+  // directly from its buffer instead of being copied into the message first.
+  // The payload needs to stay valid as long as payload_owner is alive.
+  void SendMessage(std::size_t party_id, MessageType message_type, std::size_t message_id,
+                   std::span<const std::uint8_t> payload,
+                   std::shared_ptr<const void> payload_owner);
+
+  // Send a message whose payload is split into fragments of at most fragment_size bytes, s.t. it
+  // may exceed the maximum message size of the transports.  The receiving party consumes the
+  // fragments as they arrive if it registered a stream for the message, see
+  // MessageManager::RegisterReceiveStream, and gets the reassembled message otherwise.  Payloads
+  // beyond 2 GiB are not reassembled, the receiving future throws without a registered stream.  The
+  // SendMessage and BroadcastMessage overloads above stream payloads beyond 1 GiB on their own.
+  void SendMessageStream(std::size_t party_id, MessageType message_type, std::size_t message_id,
+                         std::span<const std::uint8_t> payload,
+                         std::shared_ptr<const void> payload_owner,
+                         std::size_t fragment_size = kDefaultStreamFragmentSize);
+
   // Send a message to all other parties
   void BroadcastMessage(flatbuffers::DetachedBuffer&& message);
 
+  // Send a message to all other parties, see the SendMessage overload above
+  void BroadcastMessage(MessageType message_type, std::size_t message_id,
+                        std::span<const std::uint8_t> payload,
+                        std::shared_ptr<const void> payload_owner);
+
+  // Enable or disable combining small messages that are queued for the same party at the same
+  // time into a single batched message (enabled by default)
+  void SetMessageCoalescing(bool value = true);
+
+  // Set the measured round-trip time to the other parties, e.g., by MeasureNetwork, from which the
+  // send threads derive how long they wait for further messages after dequeuing a few small ones
+  // to coalesce them: at most 2% of the round-trip time and 1 ms, shrinking down to an eighth of
+  // that while the waits collect no messages.  They do not wait while more than 64 KiB are queued
+  // or if the round-trip time is 0 (the default).  The current window is reported in the
+  // TransportStatistics.  Throws std::invalid_argument for a negative round-trip time.
+  void SetRoundTripTime(std::chrono::microseconds round_trip_time);
+
+  // Enable or disable sending the queued messages by priority, i.e., the online messages before the
+  // setup messages of the gates before the bulk preprocessing messages like OT extension, MTs and
+  // garbled tables (disabled by default).  Messages larger than 256 KiB are sent in fragments, so
+  // that higher-priority messages queued in the meantime are sent in between.  The order of the
+  // messages of each priority is kept and control messages like synchronizations are sent after
+  // all messages queued before them.  The receiving party does not need the setting.
+  void SetMessagePrioritization(bool value = true);
+
+  // Enable or disable handing received messages to a separate dispatch thread per party, which
+  // verifies and forwards them while the receive thread keeps reading from the transport
+  // (disabled by default).  The setting applies to messages received afterwards.
+  void SetMessageDispatchThread(bool value = true);
+
+  // Enable or disable the verification of received messages, which may only be disabled for
+  // trusted links, eg between machines of the same cluster (enabled by default)
+  void SetMessageVerification(bool value = true);
+
+  // Enable or disable compressing messages of the given type before sending them (disabled for
+  // all types by default).  Compression is skipped for small messages and, for a while, for a
+  // type whose messages did not shrink.  Throws std::logic_error if MOTION was built without zstd.
+  void SetMessageCompression(MessageType message_type, bool value = true);
+
+  // Send broadcast messages to the given hub party only, which forwards them to the other parties,
+  // s.t. the outgoing traffic of the other parties does not grow with the number of parties.  All
+  // parties must use the same hub, std::nullopt sends broadcasts directly (the default).
+  void SetBroadcastHub(std::optional<std::size_t> hub_id);
+
   // shutdown the communication layer
   void Shutdown();
 
   std::vector<TransportStatistics> GetTransportStatistics() const noexcept;
 
+  // Number of messages waiting in the send queue of each party, 0 for this party.  May be called
+  // concurrently with sending.
+  std::vector<std::size_t> GetSendQueueSizes() const;
+
+  // Number of bytes of the messages that were queued for each party but not sent yet, 0 for this
+  // party.  May be called concurrently with sending.
+  std::vector<std::size_t> GetSendQueueBytes() const;
+
+  // Bound the memory of the send queues: once the bytes queued for a party reach the high
+  // watermark, the fibers and threads sending to it are suspended until the queue has drained
+  // to the low watermark.  Relayed broadcasts are never delayed.  A high watermark of 0 disables
+  // the bound (the default).  Throws std::invalid_argument if low_watermark > high_watermark.
+  void SetSendQueueWatermarks(std::size_t high_watermark, std::size_t low_watermark);
+
   auto GetLogger() { return logger_; }
 
   void SetLogger(std::shared_ptr<Logger> logger);
 
+  // Pin the send, receive and dispatch threads to the given logical CPUs in round-robin order
+  void SetThreadAffinity(std::span<const std::size_t> cpus);
+
   MessageManager& GetMessageManager() { return *message_manager_; }
 
  private:
@@ -103,6 +210,14 @@ class CommunicationLayer {
   std::shared_ptr<MessageManager> message_manager_;
 
   std::size_t sync_state_{0};
+  bool synchronization_started_{false};
+  SynchronizationMode synchronization_mode_{SynchronizationMode::kAllToAll};
+
+  // build the message of the current synchronization
+  flatbuffers::DetachedBuffer BuildSynchronizationMessage() const;
+
+  // wait for the message of the current synchronization from the given party
+  void WaitForSynchronizationMessage(std::size_t party_id);
 };
 
 // Create a set of communication layers connected by dummy transports
@@ -113,4 +228,8 @@ std::vector<std::unique_ptr<CommunicationLayer>> MakeDummyCommunicationLayers(
 std::vector<std::unique_ptr<CommunicationLayer>> MakeLocalTcpCommunicationLayers(
     std::size_t number_of_parties, bool ipv6 = true);
 
+// Create a set of communication layers connected by shared memory transports
+std::vector<std::unique_ptr<CommunicationLayer>> MakeSharedMemoryCommunicationLayers(
+    std::size_t number_of_parties);
+
 }  // namespace encrypto::motion::communication
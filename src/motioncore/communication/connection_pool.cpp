@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "connection_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct PooledConnection {
+  std::unique_ptr<Transport> transport;
+  std::atomic<bool> in_session = false;
+};
+
+namespace {
+
+// transport of one session, where an empty message marks the end of the session in each
+// direction
+class SessionTransport : public Transport {
+ public:
+  SessionTransport(std::shared_ptr<PooledConnection> connection)
+      : connection_(std::move(connection)) {}
+
+  ~SessionTransport() { Shutdown(); }
+
+  void SendMessage(std::span<const std::uint8_t> message) override {
+    if (message.empty()) {
+      throw std::invalid_argument("pooled connections cannot send empty messages");
+    }
+    connection_->transport->SendMessage(message);
+    statistics_.number_of_messages_sent += 1;
+    statistics_.number_of_bytes_sent += message.size();
+  }
+
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override {
+    std::size_t message_size = 0;
+    for (const auto& part : message_parts) {
+      message_size += part.size();
+    }
+    if (message_size == 0) {
+      throw std::invalid_argument("pooled connections cannot send empty messages");
+    }
+    connection_->transport->SendMessageParts(message_parts);
+    statistics_.number_of_messages_sent += 1;
+    statistics_.number_of_bytes_sent += message_size;
+  }
+
+  bool Available() const override {
+    return !end_of_session_received_ && connection_->transport->Available();
+  }
+
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override {
+    if (end_of_session_received_) {
+      return std::nullopt;
+    }
+    auto message = connection_->transport->ReceiveMessage();
+    if (!message.has_value() || message->empty()) {
+      // the other party ended the session or closed the connection
+      end_of_session_received_ = true;
+      return std::nullopt;
+    }
+    statistics_.number_of_messages_received += 1;
+    statistics_.number_of_bytes_received += message->size();
+    return message;
+  }
+
+  void ShutdownSend() override {
+    if (!end_of_session_sent_) {
+      connection_->transport->SendMessage(std::span<const std::uint8_t>());
+      end_of_session_sent_ = true;
+    }
+  }
+
+  // keeps the connection open but consumes the rest of the session s.t. the next session starts
+  // with its first message
+  void Shutdown() override {
+    if (is_shutdown_) {
+      return;
+    }
+    ShutdownSend();
+    while (ReceiveMessage().has_value()) {
+    }
+    is_shutdown_ = true;
+    connection_->in_session = false;
+  }
+
+ private:
+  std::shared_ptr<PooledConnection> connection_;
+  bool end_of_session_sent_ = false;
+  bool end_of_session_received_ = false;
+  bool is_shutdown_ = false;
+};
+
+}  // namespace
+
+}  // namespace detail
+
+ConnectionPool::ConnectionPool(std::vector<std::unique_ptr<Transport>>&& transports) {
+  connections_.reserve(transports.size());
+  for (auto& transport : transports) {
+    if (transport) {
+      connections_.emplace_back(std::make_shared<detail::PooledConnection>());
+      connections_.back()->transport = std::move(transport);
+    } else {
+      // connection to myself
+      connections_.emplace_back(nullptr);
+    }
+  }
+}
+
+ConnectionPool::~ConnectionPool() {
+  for (auto& connection : connections_) {
+    if (connection) {
+      connection->transport->ShutdownSend();
+      connection->transport->Shutdown();
+    }
+  }
+}
+
+std::vector<std::unique_ptr<Transport>> ConnectionPool::GetTransports() {
+  for (const auto& connection : connections_) {
+    if (connection && connection->in_session) {
+      throw std::logic_error("the previous session of the ConnectionPool is not shut down yet");
+    }
+  }
+  std::vector<std::unique_ptr<Transport>> transports(connections_.size());
+  for (std::size_t i = 0; i < connections_.size(); ++i) {
+    if (connections_.at(i)) {
+      connections_.at(i)->in_session = true;
+      transports.at(i) = std::make_unique<detail::SessionTransport>(connections_.at(i));
+    }
+  }
+  ++number_of_sessions_;
+  return transports;
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct PooledConnection;
+
+}  // namespace detail
+
+// Keeps the connections to the other parties open for several successive sessions, e.g.,
+// CommunicationLayers of short-lived Party instances, s.t. the connections are set up only once.
+// The transports of each session end the session instead of closing the connection when they are
+// shut down, which needs to happen on all parties.  Only one session may use the pool at a time.
+class ConnectionPool {
+ public:
+  // takes the transports to the other parties, e.g., from TcpSetupHelper::SetupConnections
+  explicit ConnectionPool(std::vector<std::unique_ptr<Transport>>&& transports);
+
+  // closes the connections, all sessions need to be finished
+  ~ConnectionPool();
+
+  ConnectionPool(const ConnectionPool&) = delete;
+
+  // Returns the transports for a new session, which may be passed to a CommunicationLayer.
+  // Sessions must not send empty messages since they mark the end of a session.
+  // Throws a std::logic_error if the previous session has not been shut down yet.
+  std::vector<std::unique_ptr<Transport>> GetTransports();
+
+  std::size_t GetNumberOfSessions() const noexcept { return number_of_sessions_; }
+
+ private:
+  std::vector<std::shared_ptr<detail::PooledConnection>> connections_;
+  std::size_t number_of_sessions_ = 0;
+};
+
+}  // namespace encrypto::motion::communication
@@ -43,8 +43,12 @@ DummyTransport::MakeTransportPair() {
 }
 
 void DummyTransport::SendMessage(std::span<const std::uint8_t> message) {
+  SendOwnedMessage(std::vector(message.begin(), message.end()));
+}
+
+void DummyTransport::SendOwnedMessage(std::vector<std::uint8_t>&& message) {
   auto message_size = message.size();
-  send_queue_->enqueue(std::vector(message.begin(), message.end()));
+  send_queue_->enqueue(std::move(message));
   statistics_.number_of_messages_sent += 1;
   statistics_.number_of_bytes_sent += message_size;
 }
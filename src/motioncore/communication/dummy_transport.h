@@ -41,6 +41,9 @@ class DummyTransport : public Transport {
   // send a message
   void SendMessage(std::span<const std::uint8_t> message) override;
 
+  // move the message into the queue of the other transport
+  void SendOwnedMessage(std::vector<std::uint8_t>&& message) override;
+
   // check if a new message is available
   bool Available() const override;
 
@@ -0,0 +1,230 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "encrypted_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+constexpr std::size_t kNonceSize = 16;
+constexpr std::size_t kKeySize = 32;
+constexpr std::size_t kIvSize = 12;
+
+struct EvpCipherContextDeleter {
+  void operator()(EVP_CIPHER_CTX* context) const noexcept { EVP_CIPHER_CTX_free(context); }
+};
+
+using EvpCipherContextPointer = std::unique_ptr<EVP_CIPHER_CTX, EvpCipherContextDeleter>;
+
+// one direction of the transport, the key stays set up in the context and only the initialization
+// vector changes from message to message
+struct Direction {
+  Direction(const std::array<std::uint8_t, kKeySize>& key, bool encrypt);
+
+  // initialization vector of the next message made of 4 zero bytes and the message counter
+  std::array<std::uint8_t, kIvSize> NextIv();
+
+  EvpCipherContextPointer context;
+  std::uint64_t message_counter = 0;
+};
+
+Direction::Direction(const std::array<std::uint8_t, kKeySize>& key, bool encrypt)
+    : context(EVP_CIPHER_CTX_new()) {
+  if (!context ||
+      EVP_CipherInit_ex(context.get(), EVP_aes_256_gcm(), nullptr, key.data(), nullptr,
+                        encrypt ? 1 : 0) != 1) {
+    throw std::runtime_error("Error while setting up AES-256-GCM");
+  }
+}
+
+std::array<std::uint8_t, kIvSize> Direction::NextIv() {
+  if (message_counter == std::numeric_limits<std::uint64_t>::max()) {
+    throw std::runtime_error("EncryptedTransport ran out of initialization vectors");
+  }
+  std::array<std::uint8_t, kIvSize> iv{};
+  const auto counter = message_counter++;
+  std::memcpy(iv.data() + kIvSize - sizeof(counter), &counter, sizeof(counter));
+  return iv;
+}
+
+// derives the key of one direction as HMAC-SHA256(pre_shared_key, label || nonces)
+std::array<std::uint8_t, kKeySize> DeriveKey(std::span<const std::uint8_t> pre_shared_key,
+                                             std::string_view label,
+                                             std::span<const std::uint8_t> nonces) {
+  std::vector<std::uint8_t> input(label.begin(), label.end());
+  input.insert(input.end(), nonces.begin(), nonces.end());
+  std::array<std::uint8_t, kKeySize> key;
+  unsigned int key_size = 0;
+  if (HMAC(EVP_sha256(), pre_shared_key.data(), static_cast<int>(pre_shared_key.size()),
+           input.data(), input.size(), key.data(), &key_size) == nullptr ||
+      key_size != kKeySize) {
+    throw std::runtime_error("Error while deriving the keys of an EncryptedTransport");
+  }
+  return key;
+}
+
+struct EncryptedTransportImplementation {
+  EncryptedTransportImplementation(const std::array<std::uint8_t, kKeySize>& send_key,
+                                   const std::array<std::uint8_t, kKeySize>& receive_key)
+      : send_direction(send_key, true), receive_direction(receive_key, false) {}
+
+  Direction send_direction;
+  Direction receive_direction;
+  // reused for all outgoing messages, which are only sent by one thread
+  std::vector<std::uint8_t> send_buffer;
+};
+
+}  // namespace detail
+
+EncryptedTransport::EncryptedTransport(std::unique_ptr<Transport> transport,
+                                       std::span<const std::uint8_t> pre_shared_key,
+                                       bool is_initiator)
+    : transport_(std::move(transport)) {
+  if (pre_shared_key.size() < kMinimumKeySize) {
+    throw std::invalid_argument(fmt::format("pre-shared key of {} bytes is shorter than {} bytes",
+                                            pre_shared_key.size(), kMinimumKeySize));
+  }
+  std::array<std::uint8_t, detail::kNonceSize> my_nonce;
+  if (RAND_bytes(my_nonce.data(), my_nonce.size()) != 1) {
+    throw std::runtime_error("Error while generating the nonce of an EncryptedTransport");
+  }
+  transport_->SendMessage(my_nonce);
+  auto other_nonce = transport_->ReceiveMessage();
+  if (!other_nonce.has_value() || other_nonce->size() != detail::kNonceSize) {
+    throw std::runtime_error("EncryptedTransport handshake failed");
+  }
+  // initiator nonce || responder nonce
+  std::vector<std::uint8_t> nonces(my_nonce.begin(), my_nonce.end());
+  nonces.insert(is_initiator ? nonces.end() : nonces.begin(), other_nonce->begin(),
+                other_nonce->end());
+  const auto initiator_key = detail::DeriveKey(pre_shared_key, "motion initiator", nonces);
+  const auto responder_key = detail::DeriveKey(pre_shared_key, "motion responder", nonces);
+  implementation_ = std::make_unique<detail::EncryptedTransportImplementation>(
+      is_initiator ? initiator_key : responder_key, is_initiator ? responder_key : initiator_key);
+}
+
+EncryptedTransport::EncryptedTransport(EncryptedTransport&& other)
+    : Transport(std::move(other)),
+      transport_(std::move(other.transport_)),
+      implementation_(std::move(other.implementation_)) {}
+
+EncryptedTransport::~EncryptedTransport() = default;
+
+void EncryptedTransport::SendMessage(std::span<const std::uint8_t> message) {
+  SendMessageParts(std::span(&message, 1));
+}
+
+void EncryptedTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  auto& direction = implementation_->send_direction;
+  auto& buffer = implementation_->send_buffer;
+  buffer.resize(message_size + kTagSize);
+  const auto iv = direction.NextIv();
+  auto context = direction.context.get();
+  bool success = EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr, iv.data()) == 1;
+  std::size_t offset = 0;
+  for (const auto& part : message_parts) {
+    // EVP_EncryptUpdate takes int sizes
+    for (auto rest = part; success && !rest.empty();) {
+      const auto chunk = rest.first(std::min<std::size_t>(rest.size(), 1 << 30));
+      int output_size = 0;
+      success = EVP_EncryptUpdate(context, buffer.data() + offset, &output_size, chunk.data(),
+                                  static_cast<int>(chunk.size())) == 1;
+      offset += output_size;
+      rest = rest.subspan(chunk.size());
+    }
+  }
+  int final_size = 0;
+  success = success && EVP_EncryptFinal_ex(context, buffer.data() + offset, &final_size) == 1 &&
+            EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_GET_TAG, kTagSize,
+                                buffer.data() + message_size) == 1;
+  if (!success) {
+    throw std::runtime_error("Error while encrypting a message");
+  }
+  transport_->SendMessage(buffer);
+  statistics_.number_of_messages_sent += 1;
+  statistics_.number_of_bytes_sent += message_size;
+}
+
+bool EncryptedTransport::Available() const { return transport_->Available(); }
+
+std::optional<std::vector<std::uint8_t>> EncryptedTransport::ReceiveMessage() {
+  auto message = transport_->ReceiveMessage();
+  if (!message.has_value()) {
+    return std::nullopt;
+  }
+  if (message->size() < kTagSize) {
+    throw std::runtime_error("received message is too short to be authenticated");
+  }
+  const std::size_t message_size = message->size() - kTagSize;
+  auto& direction = implementation_->receive_direction;
+  const auto iv = direction.NextIv();
+  auto context = direction.context.get();
+  // decrypt in place
+  bool success = EVP_DecryptInit_ex(context, nullptr, nullptr, nullptr, iv.data()) == 1 &&
+                 EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_GCM_SET_TAG, kTagSize,
+                                     message->data() + message_size) == 1;
+  std::size_t offset = 0;
+  while (success && offset < message_size) {
+    const auto chunk_size = std::min<std::size_t>(message_size - offset, 1 << 30);
+    int output_size = 0;
+    success = EVP_DecryptUpdate(context, message->data() + offset, &output_size,
+                                message->data() + offset, static_cast<int>(chunk_size)) == 1;
+    offset += chunk_size;
+  }
+  int final_size = 0;
+  if (!success || EVP_DecryptFinal_ex(context, message->data() + offset, &final_size) != 1) {
+    throw std::runtime_error("received message failed the authentication");
+  }
+  message->resize(message_size);
+  statistics_.number_of_messages_received += 1;
+  statistics_.number_of_bytes_received += message_size;
+  return message;
+}
+
+void EncryptedTransport::ShutdownSend() { transport_->ShutdownSend(); }
+
+void EncryptedTransport::Shutdown() { transport_->Shutdown(); }
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct EncryptedTransportImplementation;
+
+}  // namespace detail
+
+// Transport that encrypts and authenticates all messages of another transport with AES-256-GCM,
+// which uses AES-NI and carry-less multiplications via OpenSSL.  Both parties derive fresh keys
+// for each direction from a pre-shared key and random nonces exchanged in the constructor.  The
+// initialization vectors are message counters, so reordered, replayed or dropped messages are
+// detected as well.
+class EncryptedTransport : public Transport {
+ public:
+  // size of the authentication tag appended to each message
+  static constexpr std::size_t kTagSize = 16;
+  // minimum size of the pre-shared key
+  static constexpr std::size_t kMinimumKeySize = 16;
+
+  // Exchanges the nonces over transport, which blocks until the other party constructs its
+  // EncryptedTransport with the same key and the opposite value of is_initiator.
+  // Throws std::invalid_argument for keys shorter than kMinimumKeySize and std::runtime_error if
+  // the handshake fails.
+  EncryptedTransport(std::unique_ptr<Transport> transport,
+                     std::span<const std::uint8_t> pre_shared_key, bool is_initiator);
+  EncryptedTransport(EncryptedTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~EncryptedTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  // encrypts the parts into one buffer without concatenating them first
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
+  bool Available() const override;
+
+  // Throws std::runtime_error if a message fails the authentication
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  std::unique_ptr<Transport> transport_;
+  std::unique_ptr<detail::EncryptedTransportImplementation> implementation_;
+};
+
+}  // namespace encrypto::motion::communication
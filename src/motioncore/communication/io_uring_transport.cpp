@@ -0,0 +1,311 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "io_uring_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <liburing.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// number of entries in each submission queue
+constexpr unsigned kQueueDepth = 8;
+// size of the registered buffer that receives small messages in bulk
+constexpr std::size_t kReceiveBufferSize = 1 << 20;
+
+struct IoUringTransportImplementation {
+  IoUringTransportImplementation(int socket_fd);
+  ~IoUringTransportImplementation();
+
+  // submit the prepared entry and wait for its completion, returns the result of the operation
+  static int SubmitAndWait(io_uring& ring);
+
+  // read exactly size bytes, returns false if the connection was closed before any byte was read
+  bool ReadExactly(std::uint8_t* destination, std::size_t size);
+
+  // read the size prefix of the next message, returns std::nullopt if the connection was closed
+  std::optional<std::uint32_t> ReadMessageSize();
+
+  // read as much as currently possible (but at least one byte) into the registered buffer
+  bool FillReceiveBuffer();
+
+  int socket_fd_;
+  io_uring send_ring_;
+  io_uring receive_ring_;
+  std::unique_ptr<std::uint8_t[]> receive_buffer_;
+  std::size_t receive_buffer_begin_ = 0;
+  std::size_t receive_buffer_end_ = 0;
+};
+
+IoUringTransportImplementation::IoUringTransportImplementation(int socket_fd)
+    : socket_fd_(socket_fd), receive_buffer_(std::make_unique<std::uint8_t[]>(kReceiveBufferSize)) {
+  if (auto result = io_uring_queue_init(kQueueDepth, &send_ring_, 0); result < 0) {
+    throw std::runtime_error(
+        fmt::format("Error while setting up io_uring: {}", std::strerror(-result)));
+  }
+  if (auto result = io_uring_queue_init(kQueueDepth, &receive_ring_, 0); result < 0) {
+    io_uring_queue_exit(&send_ring_);
+    throw std::runtime_error(
+        fmt::format("Error while setting up io_uring: {}", std::strerror(-result)));
+  }
+  iovec receive_buffer_iovec{receive_buffer_.get(), kReceiveBufferSize};
+  if (auto result = io_uring_register_buffers(&receive_ring_, &receive_buffer_iovec, 1);
+      result < 0) {
+    io_uring_queue_exit(&send_ring_);
+    io_uring_queue_exit(&receive_ring_);
+    throw std::runtime_error(
+        fmt::format("Error while registering io_uring buffer: {}", std::strerror(-result)));
+  }
+}
+
+IoUringTransportImplementation::~IoUringTransportImplementation() {
+  io_uring_queue_exit(&send_ring_);
+  io_uring_queue_exit(&receive_ring_);
+  if (socket_fd_ >= 0) {
+    ::close(socket_fd_);
+  }
+}
+
+int IoUringTransportImplementation::SubmitAndWait(io_uring& ring) {
+  if (auto result = io_uring_submit_and_wait(&ring, 1); result < 0) {
+    return result;
+  }
+  io_uring_cqe* cqe;
+  if (auto result = io_uring_wait_cqe(&ring, &cqe); result < 0) {
+    return result;
+  }
+  const auto result = cqe->res;
+  io_uring_cqe_seen(&ring, cqe);
+  return result;
+}
+
+bool IoUringTransportImplementation::FillReceiveBuffer() {
+  assert(receive_buffer_begin_ == receive_buffer_end_);
+  auto sqe = io_uring_get_sqe(&receive_ring_);
+  io_uring_prep_read_fixed(sqe, socket_fd_, receive_buffer_.get(), kReceiveBufferSize, 0, 0);
+  auto result = SubmitAndWait(receive_ring_);
+  if (result < 0) {
+    throw std::runtime_error(
+        fmt::format("Error while reading from socket: {} ({})", std::strerror(-result), -result));
+  }
+  receive_buffer_begin_ = 0;
+  receive_buffer_end_ = static_cast<std::size_t>(result);
+  return result > 0;
+}
+
+bool IoUringTransportImplementation::ReadExactly(std::uint8_t* destination, std::size_t size) {
+  std::size_t bytes_read = 0;
+  while (bytes_read < size) {
+    if (receive_buffer_begin_ < receive_buffer_end_) {
+      // take what we already have
+      auto n = std::min(size - bytes_read, receive_buffer_end_ - receive_buffer_begin_);
+      std::copy_n(receive_buffer_.get() + receive_buffer_begin_, n, destination + bytes_read);
+      receive_buffer_begin_ += n;
+      bytes_read += n;
+    } else if (size - bytes_read >= kReceiveBufferSize) {
+      // large messages are received directly into their destination
+      auto sqe = io_uring_get_sqe(&receive_ring_);
+      io_uring_prep_recv(sqe, socket_fd_, destination + bytes_read, size - bytes_read,
+                         MSG_WAITALL);
+      auto result = SubmitAndWait(receive_ring_);
+      if (result < 0) {
+        throw std::runtime_error(fmt::format("Error while reading from socket: {} ({})",
+                                             std::strerror(-result), -result));
+      }
+      if (result == 0) {
+        break;
+      }
+      bytes_read += static_cast<std::size_t>(result);
+    } else if (!FillReceiveBuffer()) {
+      break;
+    }
+  }
+  if (bytes_read == 0) {
+    return false;
+  }
+  if (bytes_read < size) {
+    throw std::runtime_error("Connection was closed while reading a message");
+  }
+  return true;
+}
+
+}  // namespace detail
+
+IoUringTransport::IoUringTransport(int socket_fd)
+    : implementation_(std::make_unique<detail::IoUringTransportImplementation>(socket_fd)) {}
+
+IoUringTransport::IoUringTransport(IoUringTransport&& other)
+    : Transport(std::move(other)), implementation_(std::move(other.implementation_)) {}
+
+IoUringTransport::~IoUringTransport() = default;
+
+void IoUringTransport::SendMessage(std::span<const std::uint8_t> message) {
+  const std::array<std::span<const std::uint8_t>, 1> message_parts{message};
+  SendMessageParts(message_parts);
+}
+
+void IoUringTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  if (message_size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(),
+                                         message_size));
+  }
+  // same framing as TcpTransport: little endian uint32 size followed by the message
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    message_size_buffer[i] = (message_size >> i * 8) & 0xFF;
+  }
+
+  std::vector<iovec> iovecs;
+  iovecs.reserve(message_parts.size() + 1);
+  iovecs.push_back({message_size_buffer.data(), message_size_buffer.size()});
+  for (const auto& part : message_parts) {
+    if (!part.empty()) {
+      iovecs.push_back({const_cast<std::uint8_t*>(part.data()), part.size()});
+    }
+  }
+
+  msghdr message_header{};
+  message_header.msg_iov = iovecs.data();
+  message_header.msg_iovlen = iovecs.size();
+  while (message_header.msg_iovlen > 0) {
+    auto sqe = io_uring_get_sqe(&implementation_->send_ring_);
+    io_uring_prep_sendmsg(sqe, implementation_->socket_fd_, &message_header, MSG_NOSIGNAL);
+    auto result =
+        detail::IoUringTransportImplementation::SubmitAndWait(implementation_->send_ring_);
+    if (result < 0) {
+      throw std::runtime_error(
+          fmt::format("Error while writing to socket: {}", std::strerror(-result)));
+    }
+    // skip what has been sent in case of a partial write
+    auto bytes_sent = static_cast<std::size_t>(result);
+    while (message_header.msg_iovlen > 0 && bytes_sent >= message_header.msg_iov->iov_len) {
+      bytes_sent -= message_header.msg_iov->iov_len;
+      ++message_header.msg_iov;
+      --message_header.msg_iovlen;
+    }
+    if (bytes_sent > 0) {
+      message_header.msg_iov->iov_base =
+          static_cast<std::uint8_t*>(message_header.msg_iov->iov_base) + bytes_sent;
+      message_header.msg_iov->iov_len -= bytes_sent;
+    }
+  }
+  statistics_.number_of_bytes_sent += message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_sent += 1;
+}
+
+bool IoUringTransport::Available() const {
+  if (implementation_->receive_buffer_begin_ < implementation_->receive_buffer_end_) {
+    return true;
+  }
+  int bytes_available = 0;
+  if (::ioctl(implementation_->socket_fd_, FIONREAD, &bytes_available) < 0) {
+    throw std::runtime_error(fmt::format(
+        "Error while querying the available bytes of the socket: {}", std::strerror(errno)));
+  }
+  return bytes_available > 0;
+}
+
+bool IoUringTransport::IsAvailable() {
+  io_uring ring;
+  if (io_uring_queue_init(1, &ring, 0) < 0) return false;
+  io_uring_queue_exit(&ring);
+  return true;
+}
+
+std::optional<std::uint32_t> IoUringTransportImplementation::ReadMessageSize() {
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  if (!ReadExactly(message_size_buffer.data(), message_size_buffer.size())) {
+    // connection has been closed
+    return std::nullopt;
+  }
+  std::uint32_t message_size = 0;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    message_size += (message_size_buffer[i] << i * 8);
+  }
+  return message_size;
+}
+
+std::optional<std::vector<std::uint8_t>> IoUringTransport::ReceiveMessage() {
+  const auto optional_message_size = implementation_->ReadMessageSize();
+  if (!optional_message_size.has_value()) {
+    return std::nullopt;
+  }
+  const std::uint32_t message_size = *optional_message_size;
+  std::vector<std::uint8_t> message_buffer(message_size);
+  if (message_size > 0 && !implementation_->ReadExactly(message_buffer.data(), message_size)) {
+    throw std::runtime_error("Connection was closed while reading a message");
+  }
+  statistics_.number_of_bytes_received += message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_received += 1;
+  return message_buffer;
+}
+
+bool IoUringTransport::ReceiveMessageInto(std::span<std::uint8_t> destination) {
+  const auto message_size = implementation_->ReadMessageSize();
+  if (!message_size.has_value()) {
+    return false;
+  }
+  if (*message_size != destination.size()) {
+    throw std::runtime_error(fmt::format("Expected message of {} B but received {} B",
+                                         destination.size(), *message_size));
+  }
+  if (!destination.empty() && !implementation_->ReadExactly(destination.data(), *message_size)) {
+    throw std::runtime_error("Connection was closed while reading a message");
+  }
+  statistics_.number_of_bytes_received += *message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_received += 1;
+  return true;
+}
+
+void IoUringTransport::ShutdownSend() { ::shutdown(implementation_->socket_fd_, SHUT_WR); }
+
+void IoUringTransport::Shutdown() {
+  ::shutdown(implementation_->socket_fd_, SHUT_RDWR);
+  ::close(implementation_->socket_fd_);
+  implementation_->socket_fd_ = -1;
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct IoUringTransportImplementation;
+
+}  // namespace detail
+
+// Transport over a connected TCP socket which uses io_uring instead of blocking reads and writes.
+// The send and the receive direction use separate rings, since they are driven by different
+// threads.  Message parts are written with a single vectored send, and small messages are read
+// in bulk into a registered buffer, so that a single system call usually serves many messages.
+class IoUringTransport : public Transport {
+ public:
+  // takes ownership of the connected socket
+  IoUringTransport(int socket_fd);
+  IoUringTransport(IoUringTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~IoUringTransport();
+
+  // check if the kernel supports io_uring, which may be disabled, e.g., by a seccomp filter
+  static bool IsAvailable();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
+  // throws a std::runtime_error if the available bytes of the socket cannot be queried
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  // reads the message directly into destination
+  bool ReceiveMessageInto(std::span<std::uint8_t> destination) override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  std::unique_ptr<detail::IoUringTransportImplementation> implementation_;
+};
+
+}  // namespace encrypto::motion::communication
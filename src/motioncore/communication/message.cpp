@@ -72,6 +72,24 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
   return BuildMessage(message_type, std::span(*payload));
 }
 
+std::pair<flatbuffers::FlatBufferBuilder, std::size_t> BuildMessageHeader(
+    MessageType message_type, std::size_t message_id, std::size_t payload_size) {
+  auto allocation_size = payload_size + 32;
+  flatbuffers::FlatBufferBuilder fbb(allocation_size);
+  std::uint8_t* payload_pointer;
+  auto payload_vector = fbb.CreateUninitializedVector<uint8_t>(payload_size, &payload_pointer);
+  MessageBuilder message_builder(fbb);
+  message_builder.add_message_id(message_id);
+  message_builder.add_payload(payload_vector);
+  message_builder.add_message_type(message_type);
+  auto root = message_builder.Finish();
+  FinishMessageBuffer(fbb, root);
+  // the builder might have moved the payload while finishing the message
+  const auto payload_offset = static_cast<std::size_t>(
+      GetMessage(fbb.GetBufferPointer())->payload()->data() - fbb.GetBufferPointer());
+  return {std::move(fbb), payload_offset};
+}
+
 using namespace std::string_literals;
 
 std::string to_string(MessageType message_type) {
@@ -26,6 +26,7 @@
 
 #include <flatbuffers/flatbuffers.h>
 #include <span>
+#include <utility>
 
 #include "fbs_headers/message_generated.h"
 
@@ -42,6 +43,11 @@ flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
 flatbuffers::FlatBufferBuilder BuildMessage(MessageType message_type,
                                             const std::vector<uint8_t>* payload);
 
+// Build a message with an uninitialized payload of payload_size bytes, which is going to be sent
+// from a separate buffer.  Returns the builder and the offset of the payload in its buffer.
+std::pair<flatbuffers::FlatBufferBuilder, std::size_t> BuildMessageHeader(
+    MessageType message_type, std::size_t message_id, std::size_t payload_size);
+
 // Give a human readable representation of MessageType values
 std::string to_string(MessageType message_type);
 
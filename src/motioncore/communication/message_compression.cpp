@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "message_compression.h"
+
+#include <memory>
+#include <stdexcept>
+
+#ifdef MOTION_ZSTD
+#include <zstd.h>
+#endif
+
+namespace encrypto::motion::communication {
+
+#ifdef MOTION_ZSTD
+
+namespace {
+
+// the fastest level since the messages are on the critical path of the evaluation
+constexpr int kCompressionLevel = 1;
+
+// the contexts are reused for all messages of a thread to avoid allocating them per message
+struct CompressionContextDeleter {
+  void operator()(ZSTD_CCtx* context) const noexcept { ZSTD_freeCCtx(context); }
+};
+
+struct DecompressionContextDeleter {
+  void operator()(ZSTD_DCtx* context) const noexcept { ZSTD_freeDCtx(context); }
+};
+
+}  // namespace
+
+bool IsMessageCompressionAvailable() noexcept { return true; }
+
+std::vector<std::uint8_t> CompressBytes(std::span<const std::uint8_t> bytes) {
+  thread_local std::unique_ptr<ZSTD_CCtx, CompressionContextDeleter> context{ZSTD_createCCtx()};
+  std::vector<std::uint8_t> compressed(ZSTD_compressBound(bytes.size()));
+  const auto size = ZSTD_compressCCtx(context.get(), compressed.data(), compressed.size(),
+                                      bytes.data(), bytes.size(), kCompressionLevel);
+  if (ZSTD_isError(size)) {
+    throw std::runtime_error("zstd failed to compress a message");
+  }
+  compressed.resize(size);
+  return compressed;
+}
+
+std::optional<std::vector<std::uint8_t>> DecompressBytes(std::span<const std::uint8_t> bytes) {
+  thread_local std::unique_ptr<ZSTD_DCtx, DecompressionContextDeleter> context{
+      ZSTD_createDCtx()};
+  const auto decompressed_size = ZSTD_getFrameContentSize(bytes.data(), bytes.size());
+  if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> decompressed(decompressed_size);
+  const auto size = ZSTD_decompressDCtx(context.get(), decompressed.data(), decompressed.size(),
+                                        bytes.data(), bytes.size());
+  if (ZSTD_isError(size) || size != decompressed_size) {
+    return std::nullopt;
+  }
+  return decompressed;
+}
+
+#else
+
+bool IsMessageCompressionAvailable() noexcept { return false; }
+
+std::vector<std::uint8_t> CompressBytes(std::span<const std::uint8_t>) {
+  throw std::logic_error("MOTION was built without zstd, see MOTION_USE_ZSTD");
+}
+
+std::optional<std::vector<std::uint8_t>> DecompressBytes(std::span<const std::uint8_t>) {
+  return std::nullopt;
+}
+
+#endif
+
+}  // namespace encrypto::motion::communication
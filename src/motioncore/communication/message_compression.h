@@ -0,0 +1,43 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace encrypto::motion::communication {
+
+// Returns true if MOTION was built with zstd, see MOTION_USE_ZSTD
+bool IsMessageCompressionAvailable() noexcept;
+
+// Compresses the given bytes with zstd in the calling thread's context.
+// Throws std::logic_error if compression is not available.
+std::vector<std::uint8_t> CompressBytes(std::span<const std::uint8_t> bytes);
+
+// Decompresses bytes compressed by CompressBytes, returns std::nullopt if they are corrupt or
+// compression is not available
+std::optional<std::vector<std::uint8_t>> DecompressBytes(std::span<const std::uint8_t> bytes);
+
+}  // namespace encrypto::motion::communication
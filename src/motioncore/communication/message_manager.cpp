@@ -22,23 +22,128 @@
 
 #include "message_manager.h"
 
+#include <cassert>
+
 #include "fbs_headers/message_generated.h"
 
 namespace encrypto::motion::communication {
 
-MessageManager::MessageManager(std::size_t number_of_parties, std::size_t my_id) : my_id_(my_id) {
-  incoming_message_promises_.resize(number_of_parties - 1);
+namespace {
+
+constexpr std::size_t kNumberOfMessageTypes{static_cast<std::size_t>(MessageType::MAX) + 1};
+
+}  // namespace
+
+MessageManager::MessageManager(std::size_t number_of_parties, std::size_t my_id)
+    : directories_((number_of_parties - 1) * kNumberOfMessageTypes),
+      overflow_promises_((number_of_parties - 1) * kNumberOfMessageTypes),
+      my_id_(my_id) {
   incoming_sync_states_ =
       std::vector<SynchronizedFiberQueue<container_type>>(number_of_parties - 1);
 }
 
+MessageManager::~MessageManager() {
+  for (auto& directory_pointer : directories_) {
+    auto directory{directory_pointer.load(std::memory_order_acquire)};
+    if (directory == nullptr) {
+      continue;
+    }
+    for (auto& chunk_pointer : *directory) {
+      auto chunk{chunk_pointer.load(std::memory_order_acquire)};
+      if (chunk == nullptr) {
+        continue;
+      }
+      for (auto& slot : *chunk) {
+        delete slot.load(std::memory_order_acquire);
+      }
+      delete chunk;
+    }
+    delete directory;
+  }
+}
+
+std::atomic<MessageManager::promise_type*>* MessageManager::GetSlot(std::size_t sender_id,
+                                                                    MessageType message_type,
+                                                                    std::size_t message_id,
+                                                                    bool allocate) {
+  const std::size_t chunk_index{message_id / kChunkSize};
+  if (chunk_index >= kNumberOfChunks) {
+    return nullptr;
+  }
+  // directories and chunks are installed with a compare-exchange s.t. concurrent registrations,
+  // e.g., from several providers, and the receive thread never need a lock
+  auto& directory_pointer{
+      directories_[ComputeId(sender_id) * kNumberOfMessageTypes +
+                   static_cast<std::size_t>(message_type)]};
+  auto directory{directory_pointer.load(std::memory_order_acquire)};
+  if (directory == nullptr) {
+    if (!allocate) {
+      return nullptr;
+    }
+    auto new_directory{new Directory{}};
+    if (directory_pointer.compare_exchange_strong(directory, new_directory,
+                                                  std::memory_order_acq_rel)) {
+      directory = new_directory;
+    } else {
+      delete new_directory;
+    }
+  }
+  auto& chunk_pointer{(*directory)[chunk_index]};
+  auto chunk{chunk_pointer.load(std::memory_order_acquire)};
+  if (chunk == nullptr) {
+    if (!allocate) {
+      return nullptr;
+    }
+    auto new_chunk{new Chunk{}};
+    if (chunk_pointer.compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel)) {
+      chunk = new_chunk;
+    } else {
+      delete new_chunk;
+    }
+  }
+  return &(*chunk)[message_id % kChunkSize];
+}
+
 void MessageManager::ReceivedMessage(std::size_t sender_id,
                                      std::vector<std::uint8_t>&& message) {
   auto fb_message{GetMessage(message.data())};
   MessageType message_type{fb_message->message_type()};
   std::size_t message_id{fb_message->message_id()};
-  incoming_message_promises_[ComputeId(sender_id)][message_type][message_id]->set_value(
-      std::move(message));
+  // only the payloads of streams are copied out of the message, all others are moved as a whole
+  if (number_of_streams_.load(std::memory_order_acquire) > 0 &&
+      HasStream(sender_id, message_type, message_id)) {
+    auto payload{fb_message->payload()};
+    container_type fragment;
+    if (payload != nullptr) fragment.assign(payload->begin(), payload->end());
+    if (ReceivedStreamFragment(sender_id, message_type, message_id, std::move(fragment), true)) {
+      return;
+    }
+  }
+  auto promise{FindPromise(sender_id, message_type, message_id)};
+  // the message must have been registered before it arrives
+  assert(promise);
+  promise->set_value(std::move(message));
+}
+
+void MessageManager::ReceivedError(std::size_t sender_id, MessageType message_type,
+                                   std::size_t message_id, std::exception_ptr error) {
+  if (auto promise{FindPromise(sender_id, message_type, message_id)}) {
+    promise->set_exception(std::move(error));
+  }
+}
+
+MessageManager::promise_type* MessageManager::FindPromise(std::size_t sender_id,
+                                                          MessageType message_type,
+                                                          std::size_t message_id) {
+  if (message_id / kChunkSize < kNumberOfChunks) {
+    auto slot{GetSlot(sender_id, message_type, message_id, false)};
+    return slot == nullptr ? nullptr : slot->load(std::memory_order_acquire);
+  }
+  std::scoped_lock lock(overflow_mutex_);
+  auto& promises{overflow_promises_[ComputeId(sender_id) * kNumberOfMessageTypes +
+                                    static_cast<std::size_t>(message_type)]};
+  auto iterator{promises.find(message_id)};
+  return iterator == promises.end() ? nullptr : iterator->second.get();
 }
 
 MessageManager::future_type MessageManager::RegisterReceive(std::size_t sender_id,
@@ -46,21 +151,64 @@ MessageManager::future_type MessageManager::RegisterReceive(std::size_t sender_i
                                                             std::size_t message_id) {
   auto p{std::make_unique<promise_type>()};
   auto f{p->get_future()};
-  incoming_message_promises_[ComputeId(sender_id)][message_type][message_id] = std::move(p);
+  if (auto slot{GetSlot(sender_id, message_type, message_id, true)}) {
+    // a registration for a message id that was used before, e.g., by a cleared circuit, replaces
+    // the old promise
+    delete slot->exchange(p.release(), std::memory_order_acq_rel);
+  } else {
+    std::scoped_lock lock(overflow_mutex_);
+    overflow_promises_[ComputeId(sender_id) * kNumberOfMessageTypes +
+                       static_cast<std::size_t>(message_type)][message_id] = std::move(p);
+  }
   return f;
 }
 
 std::vector<MessageManager::future_type> MessageManager::RegisterReceiveAll(
     MessageType message_type, std::size_t message_id) {
   std::vector<MessageManager::future_type> futures;
-  futures.reserve(incoming_message_promises_.size());
-  for (auto& m : incoming_message_promises_) {
-    auto p{std::make_unique<promise_type>()};
-    auto f{p->get_future()};
-    m[message_type][message_id] = std::move(p);
-    futures.emplace_back(std::move(f));
+  futures.reserve(incoming_sync_states_.size());
+  for (std::size_t party_id = 0; party_id <= incoming_sync_states_.size(); ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    futures.emplace_back(RegisterReceive(party_id, message_type, message_id));
   }
   return futures;
 }
 
-}  // namespace encrypto::motion::communication
\ No newline at end of file
+MessageManager::stream_type MessageManager::RegisterReceiveStream(std::size_t sender_id,
+                                                                MessageType message_type,
+                                                                std::size_t message_id) {
+  auto stream{std::make_shared<SynchronizedFiberQueue<container_type>>()};
+  std::scoped_lock lock(stream_mutex_);
+  if (streams_.insert_or_assign({sender_id, message_type, message_id}, stream).second) {
+    number_of_streams_.fetch_add(1, std::memory_order_release);
+  }
+  return stream;
+}
+
+bool MessageManager::HasStream(std::size_t sender_id, MessageType message_type,
+                               std::size_t message_id) {
+  std::scoped_lock lock(stream_mutex_);
+  return streams_.contains({sender_id, message_type, message_id});
+}
+
+bool MessageManager::ReceivedStreamFragment(std::size_t sender_id, MessageType message_type,
+                                            std::size_t message_id, container_type&& fragment,
+                                            bool last) {
+  std::scoped_lock lock(stream_mutex_);
+  auto iterator{streams_.find({sender_id, message_type, message_id})};
+  if (iterator == streams_.end()) {
+    return false;
+  }
+  auto& stream{*iterator->second};
+  stream.enqueue(std::move(fragment));
+  if (last) {
+    stream.close();
+    streams_.erase(iterator);
+    number_of_streams_.fetch_sub(1, std::memory_order_release);
+  }
+  return true;
+}
+
+}  // namespace encrypto::motion::communication
@@ -22,8 +22,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "utility/reusable_future.h"
 #include "utility/synchronized_queue.h"
@@ -35,13 +42,18 @@ enum class MessageType : uint8_t;
 /// \brief Manages future/promise based communication channels in the following way:
 /// In a pre-setup phase, a callee calls some Register* function eg RegisterReceive for
 /// some \p sender_id, \p message_type and a \p message_id. The result of the function is a future.
-/// The respective promise is stored in a nested hash map based structure that allows to efficiently
-/// find the promise, when a matching message arrives.
+/// The respective promise is stored in a slot of a dense table indexed by the sender, the message
+/// type and the message id, which the receive thread finds without locking or hashing, when a
+/// matching message arrives. Message ids beyond the table are stored in a locked hash map.
 /// After the pre-setup phase, another party transmits the message corresponding to the registered
 /// parameters. The message gets moved to the promise as a whole ie all further actions such as
 /// parsing the message depend on the code calling the get() function. Consequently, a message
 /// obtained from the future should be obtained via
 /// communication::GetMessage(raw_message_pointer)->payload() interface from flatbuffers.
+/// The buffer a transport reads a message into is moved, not copied, through the receive and
+/// dispatch threads to the future, so gates read the payload in place, e.g., through BitSpan.
+/// The buffers are plain std::vectors allocated per message, not pooled ones, since the
+/// container_type of the futures is shared by all providers and gates.
 class MessageManager {
  public:
   // byte type
@@ -52,30 +64,44 @@ class MessageManager {
   using promise_type = ReusableFiberPromise<container_type>;
   // future belonging to a promise
   using future_type = ReusableFiberFuture<container_type>;
-  // submap[message_id] -> message_promise
-  using submap_type = std::unordered_map<std::size_t, std::unique_ptr<promise_type>>;
-  // map[message_type] -> submap
-  using map_type = std::unordered_map<MessageType, submap_type>;
+  // fragments of the payload of a message, the queue is closed after the last fragment
+  using stream_type = std::shared_ptr<SynchronizedFiberQueue<container_type>>;
+  // number of message ids per chunk of slots, chunks are allocated on the first registration
+  static constexpr std::size_t kChunkSize{1'024};
+  // number of chunks per message type and sender, ie message ids up to 16M are stored in slots
+  static constexpr std::size_t kNumberOfChunks{16'384};
 
   MessageManager() = delete;
   MessageManager(const MessageManager&) = delete;
 
   MessageManager(std::size_t number_of_parties, std::size_t my_id);
 
+  ~MessageManager();
+
   // This method is called to forward a received message to the corresponding future.
   void ReceivedMessage(std::size_t sender_id, std::vector<std::uint8_t>&& message);
 
+  // Fail the future of a registered message, e.g., if it cannot be received.  Does nothing if the
+  // message was not registered.
+  void ReceivedError(std::size_t sender_id, MessageType message_type, std::size_t message_id,
+                     std::exception_ptr error);
+
   [[nodiscard]] future_type RegisterReceive(std::size_t sender_id, MessageType message_type,
                                             std::size_t message_id);
 
   [[nodiscard]] std::vector<future_type> RegisterReceiveAll(MessageType message_type,
                                                             std::size_t message_id);
 
-  auto& GetMessagePromises(std::size_t party_id) {
-    return incoming_message_promises_[ComputeId(party_id)];
-  }
+  // Register a message whose payload is consumed in fragments as they arrive instead of as a
+  // whole message, which allows payloads beyond the maximum message size.  A message that was not
+  // sent as a stream is handed over as a single fragment.
+  [[nodiscard]] stream_type RegisterReceiveStream(std::size_t sender_id, MessageType message_type,
+                                                  std::size_t message_id);
 
-  auto& GetMessagePromises() { return incoming_message_promises_; }
+  // Forward a fragment of the payload of a message to its stream, which is closed after the last
+  // fragment.  Returns false if no stream was registered for the message.
+  bool ReceivedStreamFragment(std::size_t sender_id, MessageType message_type,
+                              std::size_t message_id, container_type&& fragment, bool last);
 
   auto& GetSyncStates(std::size_t party_id) { return incoming_sync_states_[ComputeId(party_id)]; }
 
@@ -84,8 +110,31 @@ class MessageManager {
  private:
   std::size_t ComputeId(std::size_t id) { return id < my_id_ ? id : id - 1; }
 
-  // incoming_message_promises_[sender_id][message_type][message_id]
-  std::vector<map_type> incoming_message_promises_;
+  using Chunk = std::array<std::atomic<promise_type*>, kChunkSize>;
+  using Directory = std::array<std::atomic<Chunk*>, kNumberOfChunks>;
+
+  // returns the promise of the given message or nullptr if it was not registered
+  promise_type* FindPromise(std::size_t sender_id, MessageType message_type,
+                            std::size_t message_id);
+
+  // whether a stream was registered for the given message
+  bool HasStream(std::size_t sender_id, MessageType message_type, std::size_t message_id);
+
+  // returns the slot of the given message or nullptr if it is beyond the table; the slot is
+  // allocated if allocate is true and, otherwise, nullptr is returned for missing chunks
+  std::atomic<promise_type*>* GetSlot(std::size_t sender_id, MessageType message_type,
+                                      std::size_t message_id, bool allocate);
+
+  // directories_[sender_id * number_of_message_types + message_type], allocated on demand
+  std::vector<std::atomic<Directory*>> directories_;
+  // promises of message ids that do not fit into the table, indexed by sender and message type
+  std::mutex overflow_mutex_;
+  std::vector<std::unordered_map<std::size_t, std::unique_ptr<promise_type>>> overflow_promises_;
+  // registered streams by sender, message type and message id, which are rare and large, so the
+  // lock does not matter; the counter spares the lookups while there are none
+  std::mutex stream_mutex_;
+  std::map<std::tuple<std::size_t, MessageType, std::size_t>, stream_type> streams_;
+  std::atomic<std::size_t> number_of_streams_ = 0;
   // sync states need to be handled differently because it may happen that 2 sync states arrive
   // sequentially, which would break the promise-future logic.
   std::vector<SynchronizedFiberQueue<container_type>> incoming_sync_states_;
@@ -0,0 +1,201 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "network_emulation_transport.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "utility/thread.h"
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct NetworkEmulationTransportImplementation {
+  using Clock = std::chrono::steady_clock;
+
+  NetworkEmulationTransportImplementation(Transport& transport,
+                                          const NetworkEmulationConfiguration& configuration);
+  ~NetworkEmulationTransportImplementation();
+
+  // computes when a message of message_size bytes sent now arrives at the other party
+  Clock::time_point ComputeArrivalTime(std::size_t message_size);
+
+  void Enqueue(std::vector<std::uint8_t>&& message);
+
+  // forwards the queued messages to the transport, returns after Close once the queue is empty
+  void ForwardTask();
+
+  // stops accepting messages and waits until all queued messages are forwarded
+  void Close();
+
+  Transport& transport;
+  const NetworkEmulationConfiguration configuration;
+  std::mt19937_64 random_engine{std::random_device{}()};
+
+  // time at which the emulated link finished transmitting the last message
+  Clock::time_point link_free_time{};
+  Clock::time_point last_arrival_time{};
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::pair<Clock::time_point, std::vector<std::uint8_t>>> queue;
+  bool closed = false;
+  std::thread forward_thread;
+};
+
+NetworkEmulationTransportImplementation::NetworkEmulationTransportImplementation(
+    Transport& transport, const NetworkEmulationConfiguration& configuration)
+    : transport(transport), configuration(configuration) {
+  forward_thread = std::thread([this] { ForwardTask(); });
+  ThreadSetName(forward_thread, "netem");
+}
+
+NetworkEmulationTransportImplementation::~NetworkEmulationTransportImplementation() { Close(); }
+
+auto NetworkEmulationTransportImplementation::ComputeArrivalTime(std::size_t message_size)
+    -> Clock::time_point {
+  const auto now = Clock::now();
+  link_free_time = std::max(link_free_time, now);
+  if (configuration.bandwidth > 0) {
+    link_free_time += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(8 * message_size / configuration.bandwidth));
+  }
+  auto one_way_delay =
+      std::chrono::duration_cast<Clock::duration>(configuration.round_trip_time) / 2;
+  if (configuration.jitter.count() > 0) {
+    const auto jitter = std::chrono::duration_cast<Clock::duration>(configuration.jitter);
+    std::uniform_int_distribution<Clock::rep> distribution(-jitter.count(), jitter.count());
+    one_way_delay = std::max(Clock::duration::zero(),
+                             one_way_delay + Clock::duration(distribution(random_engine)));
+  }
+  // messages are not reordered
+  last_arrival_time = std::max(last_arrival_time, link_free_time + one_way_delay);
+  return last_arrival_time;
+}
+
+void NetworkEmulationTransportImplementation::Enqueue(std::vector<std::uint8_t>&& message) {
+  {
+    std::scoped_lock lock(mutex);
+    if (closed) {
+      throw std::logic_error("NetworkEmulationTransport is already shut down");
+    }
+    const auto arrival_time = ComputeArrivalTime(message.size());
+    queue.emplace_back(arrival_time, std::move(message));
+  }
+  condition.notify_one();
+}
+
+void NetworkEmulationTransportImplementation::ForwardTask() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    condition.wait(lock, [this] { return closed || !queue.empty(); });
+    if (queue.empty()) {
+      return;
+    }
+    const auto arrival_time = queue.front().first;
+    if (Clock::now() < arrival_time) {
+      // a new message cannot arrive earlier, so only closing ends the wait early
+      condition.wait_until(lock, arrival_time);
+      continue;
+    }
+    auto message = std::move(queue.front().second);
+    queue.pop_front();
+    lock.unlock();
+    transport.SendMessage(message);
+    lock.lock();
+  }
+}
+
+void NetworkEmulationTransportImplementation::Close() {
+  {
+    std::scoped_lock lock(mutex);
+    closed = true;
+  }
+  condition.notify_one();
+  if (forward_thread.joinable()) {
+    forward_thread.join();
+  }
+}
+
+}  // namespace detail
+
+NetworkEmulationTransport::NetworkEmulationTransport(
+    std::unique_ptr<Transport> transport, const NetworkEmulationConfiguration& configuration)
+    : transport_(std::move(transport)),
+      implementation_(std::make_unique<detail::NetworkEmulationTransportImplementation>(
+          *transport_, configuration)) {}
+
+NetworkEmulationTransport::~NetworkEmulationTransport() = default;
+
+void NetworkEmulationTransport::SendMessage(std::span<const std::uint8_t> message) {
+  statistics_.number_of_messages_sent += 1;
+  statistics_.number_of_bytes_sent += message.size();
+  implementation_->Enqueue(std::vector<std::uint8_t>(message.begin(), message.end()));
+}
+
+bool NetworkEmulationTransport::Available() const { return transport_->Available(); }
+
+std::optional<std::vector<std::uint8_t>> NetworkEmulationTransport::ReceiveMessage() {
+  auto message = transport_->ReceiveMessage();
+  if (message.has_value()) {
+    statistics_.number_of_messages_received += 1;
+    statistics_.number_of_bytes_received += message->size();
+  }
+  return message;
+}
+
+void NetworkEmulationTransport::ShutdownSend() {
+  implementation_->Close();
+  transport_->ShutdownSend();
+}
+
+void NetworkEmulationTransport::Shutdown() {
+  implementation_->Close();
+  transport_->Shutdown();
+}
+
+std::vector<std::unique_ptr<Transport>> EmulateNetwork(
+    std::vector<std::unique_ptr<Transport>> transports,
+    const NetworkEmulationConfiguration& configuration) {
+  if (configuration.IsEnabled()) {
+    for (auto& transport : transports) {
+      if (transport) {
+        transport =
+            std::make_unique<NetworkEmulationTransport>(std::move(transport), configuration);
+      }
+    }
+  }
+  return transports;
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct NetworkEmulationTransportImplementation;
+
+}  // namespace detail
+
+// parameters of an emulated network link, the defaults do not change the link
+struct NetworkEmulationConfiguration {
+  // round trip time, i.e., each message is delayed by half of it
+  std::chrono::microseconds round_trip_time{0};
+  // the one-way delay of each message varies uniformly by up to +-jitter, while the messages
+  // still arrive in order
+  std::chrono::microseconds jitter{0};
+  // bandwidth of the link in bits per second in each direction, 0 means unlimited
+  double bandwidth = 0;
+
+  bool IsEnabled() const {
+    return round_trip_time.count() > 0 || jitter.count() > 0 || bandwidth > 0;
+  }
+};
+
+// Transport that emulates a slower network on top of another transport, e.g., to benchmark WAN
+// settings in a LAN.  Outgoing messages are queued and forwarded to the underlying transport by
+// a separate thread at the time they would arrive over the emulated link, so the latency of
+// consecutive messages overlaps as on a real network.  Incoming messages are not delayed since
+// the other party emulates its direction of the link.
+class NetworkEmulationTransport : public Transport {
+ public:
+  NetworkEmulationTransport(std::unique_ptr<Transport> transport,
+                            const NetworkEmulationConfiguration& configuration);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~NetworkEmulationTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+
+  // forwards the outstanding messages before shutting down the underlying transport
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  std::unique_ptr<Transport> transport_;
+  std::unique_ptr<detail::NetworkEmulationTransportImplementation> implementation_;
+};
+
+// Wraps each non-null transport into a NetworkEmulationTransport if the configuration is enabled.
+std::vector<std::unique_ptr<Transport>> EmulateNetwork(
+    std::vector<std::unique_ptr<Transport>> transports,
+    const NetworkEmulationConfiguration& configuration);
+
+}  // namespace encrypto::motion::communication
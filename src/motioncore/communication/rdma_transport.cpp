@@ -0,0 +1,851 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rdma_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fmt/format.h>
+#include <infiniband/verbs.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// ring of registered slots that the sender writes the messages into
+constexpr std::size_t kNumberOfSlots = 64;
+constexpr std::size_t kSlotSize = 256 * 1024;
+// registered buffers of the sender that the messages are copied into before writing them
+constexpr std::size_t kNumberOfStagingBuffers = 4;
+// the receiver returns the consumed slots to the sender in batches of this size
+constexpr std::size_t kCreditBatchSize = kNumberOfSlots / 4;
+// receives posted for the control messages, which bounds the unhandled control messages
+constexpr std::size_t kNumberOfControlReceives = 16;
+constexpr std::uint32_t kMaximumSendRequests = 64;
+// largest size of a single write request of a direct write
+constexpr std::size_t kMaximumWriteSize = std::size_t(1) << 30;
+// immediate values of writes that do not write into a slot, all others are the size of the data
+// written into the next slot
+constexpr std::uint32_t kDirectWriteCompletion = 0xFFFFFFFF;
+constexpr std::uint32_t kEndOfStream = 0xFFFFFFFE;
+// polls of a completion queue before waiting for a completion event
+constexpr int kSpinCount = 1000;
+// timeout of waiting for a completion event, after which a shutdown is noticed
+constexpr int kEventTimeoutMilliseconds = 100;
+
+// sent by the receiver to the sender on the control queue pair
+struct ControlMessage {
+  // total number of slots the receiver has consumed
+  std::uint64_t number_of_consumed_slots;
+  // destination of the pending direct write if is_direct_write is set
+  std::uint64_t address;
+  std::uint32_t rkey;
+  std::uint32_t is_direct_write;
+};
+
+// details of the queue pairs exchanged over the socket, which connects parties of the same
+// architecture
+struct ConnectionInfo {
+  std::uint32_t data_queue_pair_number;
+  std::uint32_t control_queue_pair_number;
+  std::uint32_t packet_sequence_number;
+  std::uint16_t lid;
+  std::array<std::uint8_t, 16> gid;
+  std::uint64_t slots_address;
+  std::uint32_t slots_rkey;
+};
+
+struct CompletionQueue {
+  ibv_comp_channel* channel = nullptr;
+  ibv_cq* queue = nullptr;
+};
+
+struct RdmaTransportImplementation {
+  RdmaTransportImplementation(int socket_fd, const RdmaDeviceConfiguration& device_configuration);
+  ~RdmaTransportImplementation();
+
+  void Connect(const RdmaDeviceConfiguration& device_configuration);
+  // frees all resources, also of a partially connected transport
+  void Release();
+
+  CompletionQueue CreateCompletionQueue(int number_of_entries);
+  ibv_qp* CreateQueuePair(CompletionQueue& send_queue, CompletionQueue& receive_queue,
+                          std::uint32_t number_of_send_requests,
+                          std::uint32_t number_of_receive_requests);
+  void ConnectQueuePair(ibv_qp* queue_pair, std::uint32_t remote_queue_pair_number,
+                        const ConnectionInfo& local_info, const ConnectionInfo& remote_info,
+                        const RdmaDeviceConfiguration& device_configuration);
+  ibv_mr* RegisterMemory(void* address, std::size_t size, int access);
+
+  // returns false if there was no completion
+  static bool PollCompletion(CompletionQueue& queue, ibv_wc& completion);
+  ibv_wc WaitForCompletion(CompletionQueue& queue);
+
+  // sending thread
+  void PostWrite(ibv_send_wr& request);
+  void HandleWriteCompletion(const ibv_wc& completion);
+  void HandleControlMessages(bool wait);
+  std::size_t AcquireStagingBuffer();
+  void WriteSlot(std::size_t staging_buffer, std::size_t size);
+  void WriteToSlots(std::span<const std::span<const std::uint8_t>> parts);
+  void WriteDirectly(std::span<const std::span<const std::uint8_t>> parts);
+  void WriteImmediate(std::uint32_t immediate);
+  void WaitForWrites();
+
+  // receiving thread
+  void PostDataReceive();
+  void PostControlReceive(std::size_t index);
+  void SendControlMessage(const ControlMessage& message);
+  std::uint32_t NextImmediate();
+  // returns false at the end of the stream
+  bool NextSlot();
+  void ConsumeSlot();
+  // returns false if the stream ended before any byte was read
+  bool ReadExactly(std::uint8_t* destination, std::size_t size);
+  std::vector<std::uint8_t> ReadDirectly(std::size_t size);
+
+  int socket_fd_;
+  std::atomic<bool> shutdown_ = false;
+
+  ibv_context* context_ = nullptr;
+  ibv_pd* protection_domain_ = nullptr;
+  // each completion queue is only polled by one thread
+  CompletionQueue data_send_queue_;
+  CompletionQueue data_receive_queue_;
+  CompletionQueue control_send_queue_;
+  CompletionQueue control_receive_queue_;
+  // messages are written on the data queue pair and the receiver answers on the control one
+  ibv_qp* data_queue_pair_ = nullptr;
+  ibv_qp* control_queue_pair_ = nullptr;
+
+  std::unique_ptr<std::uint8_t[]> slots_;
+  ibv_mr* slots_memory_region_ = nullptr;
+  std::unique_ptr<std::uint8_t[]> staging_buffers_;
+  ibv_mr* staging_memory_region_ = nullptr;
+  std::array<ControlMessage, kNumberOfControlReceives> control_receive_buffers_;
+  ibv_mr* control_receive_memory_region_ = nullptr;
+  std::uint64_t remote_slots_address_ = 0;
+  std::uint32_t remote_slots_rkey_ = 0;
+
+  // only used by the sending thread
+  std::uint64_t number_of_written_slots_ = 0;
+  std::uint64_t number_of_remotely_consumed_slots_ = 0;
+  std::array<bool, kNumberOfStagingBuffers> staging_buffer_in_use_{};
+  std::size_t next_staging_buffer_ = 0;
+  std::size_t number_of_outstanding_writes_ = 0;
+  std::optional<ControlMessage> direct_write_destination_;
+
+  // only used by the receiving thread
+  std::uint64_t number_of_received_slots_ = 0;
+  std::uint64_t number_of_consumed_slots_ = 0;
+  std::uint64_t number_of_reported_slots_ = 0;
+  const std::uint8_t* slot_ = nullptr;
+  std::size_t slot_size_ = 0;
+  std::size_t slot_offset_ = 0;
+  std::size_t number_of_outstanding_control_messages_ = 0;
+  // immediate value of a completion that was polled to check if a message is available
+  std::optional<std::uint32_t> pending_immediate_;
+  bool end_of_stream_ = false;
+};
+
+static void WriteToSocket(int socket_fd, const void* data, std::size_t size) {
+  auto bytes = static_cast<const std::uint8_t*>(data);
+  while (size > 0) {
+    const auto result = ::send(socket_fd, bytes, size, MSG_NOSIGNAL);
+    if (result <= 0) {
+      throw std::runtime_error(
+          fmt::format("Error while writing to socket: {}", std::strerror(errno)));
+    }
+    bytes += result;
+    size -= static_cast<std::size_t>(result);
+  }
+}
+
+static void ReadFromSocket(int socket_fd, void* data, std::size_t size) {
+  auto bytes = static_cast<std::uint8_t*>(data);
+  while (size > 0) {
+    const auto result = ::recv(socket_fd, bytes, size, MSG_WAITALL);
+    if (result <= 0) {
+      throw std::runtime_error("Connection was closed while connecting the RDMA queue pairs");
+    }
+    bytes += result;
+    size -= static_cast<std::size_t>(result);
+  }
+}
+
+RdmaTransportImplementation::RdmaTransportImplementation(
+    int socket_fd, const RdmaDeviceConfiguration& device_configuration)
+    : socket_fd_(socket_fd) {
+  try {
+    Connect(device_configuration);
+  } catch (...) {
+    Release();
+    throw;
+  }
+}
+
+RdmaTransportImplementation::~RdmaTransportImplementation() { Release(); }
+
+void RdmaTransportImplementation::Connect(const RdmaDeviceConfiguration& device_configuration) {
+  int number_of_devices = 0;
+  auto devices = ibv_get_device_list(&number_of_devices);
+  if (devices == nullptr || number_of_devices == 0) {
+    if (devices != nullptr) ibv_free_device_list(devices);
+    throw std::runtime_error("No RDMA device found");
+  }
+  for (int i = 0; i < number_of_devices; ++i) {
+    if (device_configuration.device_name.empty() ||
+        device_configuration.device_name == ibv_get_device_name(devices[i])) {
+      context_ = ibv_open_device(devices[i]);
+      break;
+    }
+  }
+  ibv_free_device_list(devices);
+  if (context_ == nullptr) {
+    throw std::runtime_error(
+        fmt::format("Could not open RDMA device \"{}\"", device_configuration.device_name));
+  }
+  protection_domain_ = ibv_alloc_pd(context_);
+  if (protection_domain_ == nullptr) {
+    throw std::runtime_error("Could not allocate RDMA protection domain");
+  }
+
+  data_send_queue_ = CreateCompletionQueue(kMaximumSendRequests);
+  data_receive_queue_ = CreateCompletionQueue(kNumberOfSlots + 2);
+  control_send_queue_ = CreateCompletionQueue(kNumberOfControlReceives);
+  control_receive_queue_ = CreateCompletionQueue(kNumberOfControlReceives);
+  // at most all slots, a direct write and the end of the stream are written with immediates
+  data_queue_pair_ =
+      CreateQueuePair(data_send_queue_, data_receive_queue_, kMaximumSendRequests,
+                      kNumberOfSlots + 2);
+  control_queue_pair_ = CreateQueuePair(control_send_queue_, control_receive_queue_,
+                                        kNumberOfControlReceives, kNumberOfControlReceives);
+
+  slots_ = std::make_unique<std::uint8_t[]>(kNumberOfSlots * kSlotSize);
+  slots_memory_region_ = RegisterMemory(slots_.get(), kNumberOfSlots * kSlotSize,
+                                        IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+  staging_buffers_ = std::make_unique<std::uint8_t[]>(kNumberOfStagingBuffers * kSlotSize);
+  staging_memory_region_ =
+      RegisterMemory(staging_buffers_.get(), kNumberOfStagingBuffers * kSlotSize, 0);
+  control_receive_memory_region_ =
+      RegisterMemory(control_receive_buffers_.data(), sizeof(control_receive_buffers_),
+                     IBV_ACCESS_LOCAL_WRITE);
+  for (std::size_t i = 0; i < kNumberOfSlots + 2; ++i) PostDataReceive();
+  for (std::size_t i = 0; i < kNumberOfControlReceives; ++i) PostControlReceive(i);
+
+  ibv_port_attr port_attributes;
+  if (ibv_query_port(context_, device_configuration.port_number, &port_attributes)) {
+    throw std::runtime_error(fmt::format("Could not query port {} of the RDMA device",
+                                         device_configuration.port_number));
+  }
+  ibv_gid gid;
+  if (ibv_query_gid(context_, device_configuration.port_number, device_configuration.gid_index,
+                    &gid)) {
+    throw std::runtime_error(
+        fmt::format("Could not query GID {} of the RDMA device", device_configuration.gid_index));
+  }
+  ConnectionInfo local_info{};
+  local_info.data_queue_pair_number = data_queue_pair_->qp_num;
+  local_info.control_queue_pair_number = control_queue_pair_->qp_num;
+  local_info.packet_sequence_number = std::random_device{}() & 0xFFFFFF;
+  local_info.lid = port_attributes.lid;
+  std::copy_n(gid.raw, local_info.gid.size(), local_info.gid.begin());
+  local_info.slots_address = reinterpret_cast<std::uint64_t>(slots_.get());
+  local_info.slots_rkey = slots_memory_region_->rkey;
+
+  ConnectionInfo remote_info;
+  WriteToSocket(socket_fd_, &local_info, sizeof(local_info));
+  ReadFromSocket(socket_fd_, &remote_info, sizeof(remote_info));
+  remote_slots_address_ = remote_info.slots_address;
+  remote_slots_rkey_ = remote_info.slots_rkey;
+  ConnectQueuePair(data_queue_pair_, remote_info.data_queue_pair_number, local_info, remote_info,
+                   device_configuration);
+  ConnectQueuePair(control_queue_pair_, remote_info.control_queue_pair_number, local_info,
+                   remote_info, device_configuration);
+
+  // nothing is written before the queue pairs of both sides are ready to receive
+  std::uint8_t ready = 1;
+  WriteToSocket(socket_fd_, &ready, sizeof(ready));
+  ReadFromSocket(socket_fd_, &ready, sizeof(ready));
+}
+
+void RdmaTransportImplementation::Release() {
+  for (auto queue_pair : {data_queue_pair_, control_queue_pair_}) {
+    if (queue_pair != nullptr) ibv_destroy_qp(queue_pair);
+  }
+  data_queue_pair_ = control_queue_pair_ = nullptr;
+  for (auto memory_region :
+       {slots_memory_region_, staging_memory_region_, control_receive_memory_region_}) {
+    if (memory_region != nullptr) ibv_dereg_mr(memory_region);
+  }
+  slots_memory_region_ = staging_memory_region_ = control_receive_memory_region_ = nullptr;
+  for (auto queue : {&data_send_queue_, &data_receive_queue_, &control_send_queue_,
+                     &control_receive_queue_}) {
+    if (queue->queue != nullptr) ibv_destroy_cq(queue->queue);
+    if (queue->channel != nullptr) ibv_destroy_comp_channel(queue->channel);
+    *queue = {};
+  }
+  if (protection_domain_ != nullptr) ibv_dealloc_pd(protection_domain_);
+  protection_domain_ = nullptr;
+  if (context_ != nullptr) ibv_close_device(context_);
+  context_ = nullptr;
+  if (socket_fd_ >= 0) ::close(socket_fd_);
+  socket_fd_ = -1;
+}
+
+CompletionQueue RdmaTransportImplementation::CreateCompletionQueue(int number_of_entries) {
+  CompletionQueue queue;
+  queue.channel = ibv_create_comp_channel(context_);
+  if (queue.channel == nullptr) {
+    throw std::runtime_error("Could not create RDMA completion channel");
+  }
+  queue.queue = ibv_create_cq(context_, number_of_entries, nullptr, queue.channel, 0);
+  if (queue.queue == nullptr) {
+    ibv_destroy_comp_channel(queue.channel);
+    throw std::runtime_error("Could not create RDMA completion queue");
+  }
+  return queue;
+}
+
+ibv_qp* RdmaTransportImplementation::CreateQueuePair(CompletionQueue& send_queue,
+                                                     CompletionQueue& receive_queue,
+                                                     std::uint32_t number_of_send_requests,
+                                                     std::uint32_t number_of_receive_requests) {
+  ibv_qp_init_attr attributes{};
+  attributes.send_cq = send_queue.queue;
+  attributes.recv_cq = receive_queue.queue;
+  attributes.cap.max_send_wr = number_of_send_requests;
+  attributes.cap.max_recv_wr = number_of_receive_requests;
+  attributes.cap.max_send_sge = 1;
+  attributes.cap.max_recv_sge = 1;
+  attributes.cap.max_inline_data = sizeof(ControlMessage);
+  attributes.qp_type = IBV_QPT_RC;
+  auto queue_pair = ibv_create_qp(protection_domain_, &attributes);
+  if (queue_pair == nullptr) {
+    throw std::runtime_error(
+        fmt::format("Could not create RDMA queue pair: {}", std::strerror(errno)));
+  }
+  return queue_pair;
+}
+
+void RdmaTransportImplementation::ConnectQueuePair(
+    ibv_qp* queue_pair, std::uint32_t remote_queue_pair_number, const ConnectionInfo& local_info,
+    const ConnectionInfo& remote_info, const RdmaDeviceConfiguration& device_configuration) {
+  ibv_port_attr port_attributes;
+  ibv_query_port(context_, device_configuration.port_number, &port_attributes);
+
+  ibv_qp_attr attributes{};
+  attributes.qp_state = IBV_QPS_INIT;
+  attributes.pkey_index = 0;
+  attributes.port_num = device_configuration.port_number;
+  attributes.qp_access_flags = IBV_ACCESS_REMOTE_WRITE;
+  if (ibv_modify_qp(queue_pair, &attributes,
+                    IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT | IBV_QP_ACCESS_FLAGS)) {
+    throw std::runtime_error("Could not initialize RDMA queue pair");
+  }
+
+  attributes = {};
+  attributes.qp_state = IBV_QPS_RTR;
+  attributes.path_mtu = port_attributes.active_mtu;
+  attributes.dest_qp_num = remote_queue_pair_number;
+  attributes.rq_psn = remote_info.packet_sequence_number;
+  attributes.max_dest_rd_atomic = 1;
+  attributes.min_rnr_timer = 12;
+  attributes.ah_attr.dlid = remote_info.lid;
+  attributes.ah_attr.port_num = device_configuration.port_number;
+  // RoCE has no LIDs and is always routed by the GID
+  if (std::any_of(remote_info.gid.begin(), remote_info.gid.end(), [](auto x) { return x != 0; })) {
+    attributes.ah_attr.is_global = 1;
+    std::copy_n(remote_info.gid.begin(), remote_info.gid.size(), attributes.ah_attr.grh.dgid.raw);
+    attributes.ah_attr.grh.sgid_index = device_configuration.gid_index;
+    attributes.ah_attr.grh.hop_limit = 1;
+  }
+  if (ibv_modify_qp(queue_pair, &attributes,
+                    IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU | IBV_QP_DEST_QPN |
+                        IBV_QP_RQ_PSN | IBV_QP_MAX_DEST_RD_ATOMIC | IBV_QP_MIN_RNR_TIMER)) {
+    throw std::runtime_error("Could not connect RDMA queue pair");
+  }
+
+  attributes = {};
+  attributes.qp_state = IBV_QPS_RTS;
+  attributes.timeout = 14;
+  attributes.retry_cnt = 7;
+  // retry indefinitely if the receiver has not posted a receive yet
+  attributes.rnr_retry = 7;
+  attributes.sq_psn = local_info.packet_sequence_number;
+  attributes.max_rd_atomic = 1;
+  if (ibv_modify_qp(queue_pair, &attributes,
+                    IBV_QP_STATE | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT | IBV_QP_RNR_RETRY |
+                        IBV_QP_SQ_PSN | IBV_QP_MAX_QP_RD_ATOMIC)) {
+    throw std::runtime_error("Could not connect RDMA queue pair");
+  }
+}
+
+ibv_mr* RdmaTransportImplementation::RegisterMemory(void* address, std::size_t size,
+                                                    int access) {
+  auto memory_region = ibv_reg_mr(protection_domain_, address, size, access);
+  if (memory_region == nullptr) {
+    throw std::runtime_error(fmt::format("Could not register {} B of memory for RDMA: {}", size,
+                                         std::strerror(errno)));
+  }
+  return memory_region;
+}
+
+bool RdmaTransportImplementation::PollCompletion(CompletionQueue& queue, ibv_wc& completion) {
+  const auto result = ibv_poll_cq(queue.queue, 1, &completion);
+  if (result < 0) {
+    throw std::runtime_error("Error while polling RDMA completion queue");
+  }
+  if (result == 0) {
+    return false;
+  }
+  if (completion.status != IBV_WC_SUCCESS) {
+    throw std::runtime_error(
+        fmt::format("RDMA operation failed: {}", ibv_wc_status_str(completion.status)));
+  }
+  return true;
+}
+
+ibv_wc RdmaTransportImplementation::WaitForCompletion(CompletionQueue& queue) {
+  ibv_wc completion;
+  while (true) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (PollCompletion(queue, completion)) return completion;
+    }
+    // poll again after arming the notification, which only covers later completions
+    if (ibv_req_notify_cq(queue.queue, 0)) {
+      throw std::runtime_error("Could not request RDMA completion notification");
+    }
+    if (PollCompletion(queue, completion)) return completion;
+    pollfd event{queue.channel->fd, POLLIN, 0};
+    const auto result = ::poll(&event, 1, kEventTimeoutMilliseconds);
+    if (shutdown_) {
+      throw std::runtime_error("RdmaTransport was shut down");
+    }
+    if (result > 0) {
+      ibv_cq* event_queue;
+      void* event_context;
+      if (ibv_get_cq_event(queue.channel, &event_queue, &event_context) == 0) {
+        ibv_ack_cq_events(event_queue, 1);
+      }
+    }
+  }
+}
+
+void RdmaTransportImplementation::PostWrite(ibv_send_wr& request) {
+  // the requests complete in order, so waiting for the oldest one makes room in the queue
+  while (number_of_outstanding_writes_ >= kMaximumSendRequests) {
+    HandleWriteCompletion(WaitForCompletion(data_send_queue_));
+  }
+  request.send_flags |= IBV_SEND_SIGNALED;
+  ibv_send_wr* bad_request;
+  if (auto result = ibv_post_send(data_queue_pair_, &request, &bad_request); result != 0) {
+    throw std::runtime_error(
+        fmt::format("Error while posting RDMA write: {}", std::strerror(result)));
+  }
+  ++number_of_outstanding_writes_;
+}
+
+void RdmaTransportImplementation::HandleWriteCompletion(const ibv_wc& completion) {
+  assert(number_of_outstanding_writes_ > 0);
+  --number_of_outstanding_writes_;
+  // the id is the index of the staging buffer plus one or 0 for writes without one
+  if (completion.wr_id > 0) staging_buffer_in_use_[completion.wr_id - 1] = false;
+}
+
+void RdmaTransportImplementation::HandleControlMessages(bool wait) {
+  ibv_wc completion;
+  bool handled = false;
+  while (true) {
+    if (!PollCompletion(control_receive_queue_, completion)) {
+      if (!wait || handled) return;
+      completion = WaitForCompletion(control_receive_queue_);
+    }
+    handled = true;
+    const auto& message = control_receive_buffers_[completion.wr_id];
+    number_of_remotely_consumed_slots_ =
+        std::max(number_of_remotely_consumed_slots_, message.number_of_consumed_slots);
+    if (message.is_direct_write) direct_write_destination_ = message;
+    PostControlReceive(completion.wr_id);
+  }
+}
+
+std::size_t RdmaTransportImplementation::AcquireStagingBuffer() {
+  const auto staging_buffer = next_staging_buffer_;
+  while (staging_buffer_in_use_[staging_buffer]) {
+    HandleWriteCompletion(WaitForCompletion(data_send_queue_));
+  }
+  staging_buffer_in_use_[staging_buffer] = true;
+  next_staging_buffer_ = (staging_buffer + 1) % kNumberOfStagingBuffers;
+  return staging_buffer;
+}
+
+void RdmaTransportImplementation::WriteSlot(std::size_t staging_buffer, std::size_t size) {
+  HandleControlMessages(false);
+  while (number_of_written_slots_ - number_of_remotely_consumed_slots_ >= kNumberOfSlots) {
+    HandleControlMessages(true);
+  }
+  ibv_sge scatter_gather_element{
+      reinterpret_cast<std::uint64_t>(staging_buffers_.get() + staging_buffer * kSlotSize),
+      static_cast<std::uint32_t>(size), staging_memory_region_->lkey};
+  ibv_send_wr request{};
+  request.wr_id = staging_buffer + 1;
+  request.sg_list = &scatter_gather_element;
+  request.num_sge = 1;
+  request.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+  request.imm_data = htonl(static_cast<std::uint32_t>(size));
+  request.wr.rdma.remote_addr =
+      remote_slots_address_ + (number_of_written_slots_ % kNumberOfSlots) * kSlotSize;
+  request.wr.rdma.rkey = remote_slots_rkey_;
+  PostWrite(request);
+  ++number_of_written_slots_;
+}
+
+void RdmaTransportImplementation::WriteToSlots(
+    std::span<const std::span<const std::uint8_t>> parts) {
+  auto staging_buffer = AcquireStagingBuffer();
+  std::size_t size = 0;
+  for (auto part : parts) {
+    while (!part.empty()) {
+      if (size == kSlotSize) {
+        WriteSlot(staging_buffer, size);
+        staging_buffer = AcquireStagingBuffer();
+        size = 0;
+      }
+      const auto n = std::min(part.size(), kSlotSize - size);
+      std::copy_n(part.data(), n, staging_buffers_.get() + staging_buffer * kSlotSize + size);
+      part = part.subspan(n);
+      size += n;
+    }
+  }
+  assert(size > 0);
+  WriteSlot(staging_buffer, size);
+}
+
+void RdmaTransportImplementation::WriteDirectly(
+    std::span<const std::span<const std::uint8_t>> parts) {
+  while (!direct_write_destination_) HandleControlMessages(true);
+  const auto destination = *direct_write_destination_;
+  direct_write_destination_.reset();
+
+  std::vector<ibv_mr*> memory_regions;
+  try {
+    std::size_t offset = 0;
+    for (const auto part : parts) {
+      if (part.empty()) continue;
+      // the parts are only read
+      memory_regions.push_back(
+          RegisterMemory(const_cast<std::uint8_t*>(part.data()), part.size(), 0));
+      for (std::size_t i = 0; i < part.size(); i += kMaximumWriteSize) {
+        const auto size = std::min(kMaximumWriteSize, part.size() - i);
+        ibv_sge scatter_gather_element{reinterpret_cast<std::uint64_t>(part.data() + i),
+                                       static_cast<std::uint32_t>(size),
+                                       memory_regions.back()->lkey};
+        ibv_send_wr request{};
+        request.sg_list = &scatter_gather_element;
+        request.num_sge = 1;
+        request.opcode = IBV_WR_RDMA_WRITE;
+        request.wr.rdma.remote_addr = destination.address + offset;
+        request.wr.rdma.rkey = destination.rkey;
+        PostWrite(request);
+        offset += size;
+      }
+    }
+    // the writes are placed in order, so the message is complete when the immediate arrives
+    ibv_send_wr request{};
+    request.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+    request.imm_data = htonl(kDirectWriteCompletion);
+    request.wr.rdma.remote_addr = destination.address;
+    request.wr.rdma.rkey = destination.rkey;
+    PostWrite(request);
+    WaitForWrites();
+  } catch (...) {
+    for (auto memory_region : memory_regions) ibv_dereg_mr(memory_region);
+    throw;
+  }
+  for (auto memory_region : memory_regions) ibv_dereg_mr(memory_region);
+}
+
+void RdmaTransportImplementation::WriteImmediate(std::uint32_t immediate) {
+  ibv_send_wr request{};
+  request.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+  request.imm_data = htonl(immediate);
+  request.wr.rdma.remote_addr = remote_slots_address_;
+  request.wr.rdma.rkey = remote_slots_rkey_;
+  PostWrite(request);
+}
+
+void RdmaTransportImplementation::WaitForWrites() {
+  while (number_of_outstanding_writes_ > 0) {
+    HandleWriteCompletion(WaitForCompletion(data_send_queue_));
+  }
+}
+
+void RdmaTransportImplementation::PostDataReceive() {
+  // the writes with immediates consume receives without buffers
+  ibv_recv_wr request{};
+  ibv_recv_wr* bad_request;
+  if (auto result = ibv_post_recv(data_queue_pair_, &request, &bad_request); result != 0) {
+    throw std::runtime_error(
+        fmt::format("Error while posting RDMA receive: {}", std::strerror(result)));
+  }
+}
+
+void RdmaTransportImplementation::PostControlReceive(std::size_t index) {
+  ibv_sge scatter_gather_element{reinterpret_cast<std::uint64_t>(&control_receive_buffers_[index]),
+                                 sizeof(ControlMessage), control_receive_memory_region_->lkey};
+  ibv_recv_wr request{};
+  request.wr_id = index;
+  request.sg_list = &scatter_gather_element;
+  request.num_sge = 1;
+  ibv_recv_wr* bad_request;
+  if (auto result = ibv_post_recv(control_queue_pair_, &request, &bad_request); result != 0) {
+    throw std::runtime_error(
+        fmt::format("Error while posting RDMA receive: {}", std::strerror(result)));
+  }
+}
+
+void RdmaTransportImplementation::SendControlMessage(const ControlMessage& message) {
+  ibv_wc completion;
+  while (PollCompletion(control_send_queue_, completion)) --number_of_outstanding_control_messages_;
+  while (number_of_outstanding_control_messages_ >= kNumberOfControlReceives) {
+    WaitForCompletion(control_send_queue_);
+    --number_of_outstanding_control_messages_;
+  }
+  // the message is copied into the request
+  ibv_sge scatter_gather_element{reinterpret_cast<std::uint64_t>(&message), sizeof(message), 0};
+  ibv_send_wr request{};
+  request.sg_list = &scatter_gather_element;
+  request.num_sge = 1;
+  request.opcode = IBV_WR_SEND;
+  request.send_flags = IBV_SEND_INLINE | IBV_SEND_SIGNALED;
+  ibv_send_wr* bad_request;
+  if (auto result = ibv_post_send(control_queue_pair_, &request, &bad_request); result != 0) {
+    throw std::runtime_error(
+        fmt::format("Error while posting RDMA send: {}", std::strerror(result)));
+  }
+  ++number_of_outstanding_control_messages_;
+  number_of_reported_slots_ = message.number_of_consumed_slots;
+}
+
+std::uint32_t RdmaTransportImplementation::NextImmediate() {
+  if (pending_immediate_) {
+    const auto immediate = *pending_immediate_;
+    pending_immediate_.reset();
+    return immediate;
+  }
+  const auto completion = WaitForCompletion(data_receive_queue_);
+  PostDataReceive();
+  return ntohl(completion.imm_data);
+}
+
+bool RdmaTransportImplementation::NextSlot() {
+  const auto immediate = NextImmediate();
+  if (immediate == kEndOfStream) {
+    end_of_stream_ = true;
+    return false;
+  }
+  if (immediate == kDirectWriteCompletion || immediate > kSlotSize) {
+    throw std::runtime_error("Received unexpected RDMA write");
+  }
+  slot_ = slots_.get() + (number_of_received_slots_ % kNumberOfSlots) * kSlotSize;
+  slot_size_ = immediate;
+  slot_offset_ = 0;
+  ++number_of_received_slots_;
+  return true;
+}
+
+void RdmaTransportImplementation::ConsumeSlot() {
+  slot_ = nullptr;
+  ++number_of_consumed_slots_;
+  if (number_of_consumed_slots_ - number_of_reported_slots_ >= kCreditBatchSize) {
+    SendControlMessage({number_of_consumed_slots_, 0, 0, 0});
+  }
+}
+
+bool RdmaTransportImplementation::ReadExactly(std::uint8_t* destination, std::size_t size) {
+  std::size_t bytes_read = 0;
+  while (bytes_read < size) {
+    if (slot_ == nullptr && (end_of_stream_ || !NextSlot())) {
+      break;
+    }
+    const auto n = std::min(size - bytes_read, slot_size_ - slot_offset_);
+    std::copy_n(slot_ + slot_offset_, n, destination + bytes_read);
+    slot_offset_ += n;
+    bytes_read += n;
+    if (slot_offset_ == slot_size_) ConsumeSlot();
+  }
+  if (bytes_read == 0) {
+    return false;
+  }
+  if (bytes_read < size) {
+    throw std::runtime_error("Connection was closed while reading a message");
+  }
+  return true;
+}
+
+std::vector<std::uint8_t> RdmaTransportImplementation::ReadDirectly(std::size_t size) {
+  std::vector<std::uint8_t> message(size);
+  auto memory_region =
+      RegisterMemory(message.data(), size, IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+  try {
+    // the consumed slots are reported as well since the sender waits for the answer
+    SendControlMessage({number_of_consumed_slots_, reinterpret_cast<std::uint64_t>(message.data()),
+                        memory_region->rkey, 1});
+    if (NextImmediate() != kDirectWriteCompletion) {
+      throw std::runtime_error("Received unexpected RDMA write");
+    }
+  } catch (...) {
+    ibv_dereg_mr(memory_region);
+    throw;
+  }
+  ibv_dereg_mr(memory_region);
+  return message;
+}
+
+}  // namespace detail
+
+RdmaTransport::RdmaTransport(int socket_fd, const RdmaDeviceConfiguration& device_configuration)
+    : implementation_(
+          std::make_unique<detail::RdmaTransportImplementation>(socket_fd, device_configuration)) {}
+
+RdmaTransport::RdmaTransport(RdmaTransport&& other)
+    : Transport(std::move(other)), implementation_(std::move(other.implementation_)) {}
+
+RdmaTransport::~RdmaTransport() = default;
+
+bool RdmaTransport::IsAvailable() {
+  int number_of_devices = 0;
+  auto devices = ibv_get_device_list(&number_of_devices);
+  if (devices != nullptr) ibv_free_device_list(devices);
+  return number_of_devices > 0;
+}
+
+void RdmaTransport::SendMessage(std::span<const std::uint8_t> message) {
+  const std::array<std::span<const std::uint8_t>, 1> message_parts{message};
+  SendMessageParts(message_parts);
+}
+
+void RdmaTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  if (message_size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(),
+                                         message_size));
+  }
+  // same framing as TcpTransport: little endian uint32 size followed by the message
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    message_size_buffer[i] = (message_size >> i * 8) & 0xFF;
+  }
+  if (message_size >= kDirectWriteThreshold) {
+    // the receiver answers the size with the destination of the message
+    const std::array<std::span<const std::uint8_t>, 1> size_part{message_size_buffer};
+    implementation_->WriteToSlots(size_part);
+    implementation_->WriteDirectly(message_parts);
+  } else {
+    std::vector<std::span<const std::uint8_t>> parts;
+    parts.reserve(message_parts.size() + 1);
+    parts.push_back(message_size_buffer);
+    parts.insert(parts.end(), message_parts.begin(), message_parts.end());
+    implementation_->WriteToSlots(parts);
+  }
+  statistics_.number_of_bytes_sent += message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_sent += 1;
+}
+
+bool RdmaTransport::Available() const {
+  auto& implementation = *implementation_;
+  if (implementation.slot_ != nullptr) {
+    return true;
+  }
+  if (!implementation.pending_immediate_ && !implementation.end_of_stream_) {
+    ibv_wc completion;
+    if (detail::RdmaTransportImplementation::PollCompletion(implementation.data_receive_queue_,
+                                                            completion)) {
+      implementation.PostDataReceive();
+      implementation.pending_immediate_ = ntohl(completion.imm_data);
+    }
+  }
+  return implementation.pending_immediate_.has_value() &&
+         *implementation.pending_immediate_ != detail::kEndOfStream;
+}
+
+std::optional<std::vector<std::uint8_t>> RdmaTransport::ReceiveMessage() {
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  if (!implementation_->ReadExactly(message_size_buffer.data(), message_size_buffer.size())) {
+    // connection has been closed
+    return std::nullopt;
+  }
+  std::uint32_t message_size = 0;
+  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
+    message_size += (message_size_buffer[i] << i * 8);
+  }
+  std::vector<std::uint8_t> message_buffer;
+  if (message_size >= kDirectWriteThreshold) {
+    message_buffer = implementation_->ReadDirectly(message_size);
+  } else {
+    message_buffer.resize(message_size);
+    if (message_size > 0 && !implementation_->ReadExactly(message_buffer.data(), message_size)) {
+      throw std::runtime_error("Connection was closed while reading a message");
+    }
+  }
+  statistics_.number_of_bytes_received += message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_received += 1;
+  return message_buffer;
+}
+
+void RdmaTransport::ShutdownSend() {
+  implementation_->WriteImmediate(detail::kEndOfStream);
+  implementation_->WaitForWrites();
+}
+
+void RdmaTransport::Shutdown() {
+  // waiting threads notice the shutdown within kEventTimeoutMilliseconds
+  implementation_->shutdown_ = true;
+  if (implementation_->socket_fd_ >= 0) ::shutdown(implementation_->socket_fd_, SHUT_RDWR);
+}
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct RdmaTransportImplementation;
+
+}  // namespace detail
+
+// RDMA device and port used by an RdmaTransport
+struct RdmaDeviceConfiguration {
+  // name of the device, e.g., "mlx5_0", or empty for the first device
+  std::string device_name;
+  std::uint8_t port_number = 1;
+  // index of the GID of the port, RoCE usually needs the index of a RoCE v2 GID
+  int gid_index = 0;
+};
+
+// Transport over reliably connected RDMA queue pairs, e.g., over RoCE or InfiniBand, which
+// bypasses the kernel.  A connected TCP socket is used to exchange the details of the queue pairs.
+// Messages are written with one-sided writes into a ring of registered slots of the receiver,
+// which returns the slots to the sender as credits after it copied the messages out.  Large
+// messages like OT matrices and garbled tables are written directly from their buffers into the
+// destination buffer of the receiver, which the receiver registers and announces when it gets the
+// size of the message.
+class RdmaTransport : public Transport {
+ public:
+  // messages of at least this size are written directly into their destination
+  static constexpr std::size_t kDirectWriteThreshold = 1 << 20;
+
+  // Takes ownership of the connected socket, throws a std::runtime_error if the device cannot be
+  // opened or the queue pairs cannot be connected.  Both sides need to construct their transport
+  // at the same time.
+  RdmaTransport(int socket_fd, const RdmaDeviceConfiguration& device_configuration = {});
+  RdmaTransport(RdmaTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~RdmaTransport();
+
+  // check if there is an RDMA device
+  static bool IsAvailable();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  std::unique_ptr<detail::RdmaTransportImplementation> implementation_;
+};
+
+}  // namespace encrypto::motion::communication
@@ -0,0 +1,369 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "shared_memory_transport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// marks a region whose headers have been initialized by its creator
+constexpr std::uint64_t kRegionMagic = 0x6d6f74696f6e736d;
+// number of times a waiting thread yields before it starts sleeping
+constexpr std::size_t kNumberOfYields = 1'000;
+constexpr auto kSleepDuration = std::chrono::microseconds(20);
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "the ring buffers need lock-free atomics to be shared between processes");
+
+// header of a ring buffer, the positions count the bytes written and read so far
+struct RingHeader {
+  alignas(64) std::atomic<std::uint64_t> write_position;
+  alignas(64) std::atomic<std::uint64_t> read_position;
+  // set by the producer after its last message and by the consumer if it stops reading
+  alignas(64) std::atomic<std::uint64_t> producer_closed;
+  std::atomic<std::uint64_t> consumer_closed;
+};
+
+// the region consists of this header followed by the data of both rings
+struct RegionHeader {
+  std::atomic<std::uint64_t> magic;
+  std::uint64_t capacity;
+  // ring 0 is written by the creator and ring 1 by the other party
+  RingHeader rings[2];
+};
+
+// waits by yielding first and sleeping later, s.t. short waits have a low latency while long
+// waits do not occupy a CPU
+class Backoff {
+ public:
+  void operator()() {
+    if (number_of_waits_++ < kNumberOfYields) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(kSleepDuration);
+    }
+  }
+
+ private:
+  std::size_t number_of_waits_ = 0;
+};
+
+struct SharedMemoryTransportImplementation {
+  SharedMemoryTransportImplementation(std::string name, void* region, std::size_t region_size,
+                                      bool is_creator);
+  ~SharedMemoryTransportImplementation();
+
+  // write the bytes into the send ring, waiting for free space
+  void Write(std::span<const std::uint8_t> bytes);
+
+  // read exactly destination.size() bytes, returns false if the other party closed its send
+  // direction before all bytes were available
+  bool Read(std::span<std::uint8_t> destination);
+
+  std::string name_;
+  void* region_;
+  std::size_t region_size_;
+  bool is_creator_;
+  std::uint64_t capacity_;
+  RingHeader* send_ring_;
+  RingHeader* receive_ring_;
+  std::uint8_t* send_data_;
+  std::uint8_t* receive_data_;
+};
+
+SharedMemoryTransportImplementation::SharedMemoryTransportImplementation(std::string name,
+                                                                         void* region,
+                                                                         std::size_t region_size,
+                                                                         bool is_creator)
+    : name_(std::move(name)), region_(region), region_size_(region_size), is_creator_(is_creator) {
+  auto header = static_cast<RegionHeader*>(region_);
+  capacity_ = header->capacity;
+  auto data = static_cast<std::uint8_t*>(region_) + sizeof(RegionHeader);
+  const std::size_t send_index = is_creator_ ? 0 : 1;
+  send_ring_ = &header->rings[send_index];
+  receive_ring_ = &header->rings[1 - send_index];
+  send_data_ = data + send_index * capacity_;
+  receive_data_ = data + (1 - send_index) * capacity_;
+}
+
+SharedMemoryTransportImplementation::~SharedMemoryTransportImplementation() {
+  munmap(region_, region_size_);
+  if (is_creator_) {
+    // the other party might not have opened the region, which it removes afterwards
+    shm_unlink(name_.c_str());
+  }
+}
+
+void SharedMemoryTransportImplementation::Write(std::span<const std::uint8_t> bytes) {
+  Backoff backoff;
+  while (!bytes.empty()) {
+    if (send_ring_->consumer_closed.load(std::memory_order_acquire)) {
+      throw std::runtime_error(
+          fmt::format("shared memory transport {} was closed by the other party", name_));
+    }
+    const auto write_position = send_ring_->write_position.load(std::memory_order_relaxed);
+    const auto read_position = send_ring_->read_position.load(std::memory_order_acquire);
+    const auto free_space = capacity_ - (write_position - read_position);
+    if (free_space == 0) {
+      backoff();
+      continue;
+    }
+    const auto size = std::min<std::uint64_t>(free_space, bytes.size());
+    const auto offset = write_position % capacity_;
+    const auto first_size = std::min(size, capacity_ - offset);
+    std::memcpy(send_data_ + offset, bytes.data(), first_size);
+    std::memcpy(send_data_, bytes.data() + first_size, size - first_size);
+    send_ring_->write_position.store(write_position + size, std::memory_order_release);
+    bytes = bytes.subspan(size);
+    backoff = Backoff();
+  }
+}
+
+bool SharedMemoryTransportImplementation::Read(std::span<std::uint8_t> destination) {
+  Backoff backoff;
+  while (!destination.empty()) {
+    const auto read_position = receive_ring_->read_position.load(std::memory_order_relaxed);
+    const auto write_position = receive_ring_->write_position.load(std::memory_order_acquire);
+    const auto available = write_position - read_position;
+    if (available == 0) {
+      if (receive_ring_->producer_closed.load(std::memory_order_acquire) &&
+          receive_ring_->write_position.load(std::memory_order_acquire) == read_position) {
+        return false;
+      }
+      backoff();
+      continue;
+    }
+    const auto size = std::min<std::uint64_t>(available, destination.size());
+    const auto offset = read_position % capacity_;
+    const auto first_size = std::min(size, capacity_ - offset);
+    std::memcpy(destination.data(), receive_data_ + offset, first_size);
+    std::memcpy(destination.data() + first_size, receive_data_, size - first_size);
+    receive_ring_->read_position.store(read_position + size, std::memory_order_release);
+    destination = destination.subspan(size);
+    backoff = Backoff();
+  }
+  return true;
+}
+
+}  // namespace detail
+
+std::unique_ptr<SharedMemoryTransport> SharedMemoryTransport::Create(const std::string& name,
+                                                                     std::size_t capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("the capacity of a shared memory transport must not be 0");
+  }
+  // remove a stale region of an earlier run that did not terminate properly
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("Error while creating shared memory region {}: {}", name,
+                                         std::strerror(errno)));
+  }
+  const std::size_t region_size = sizeof(detail::RegionHeader) + 2 * capacity;
+  if (ftruncate(fd, static_cast<off_t>(region_size)) != 0) {
+    const int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error(fmt::format("Error while resizing shared memory region {}: {}", name,
+                                         std::strerror(error)));
+  }
+  void* region = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::runtime_error(fmt::format("Error while mapping shared memory region {}: {}", name,
+                                         std::strerror(errno)));
+  }
+  // the region is zero-initialized, which is a valid state of the atomics
+  auto header = static_cast<detail::RegionHeader*>(region);
+  header->capacity = capacity;
+  header->magic.store(detail::kRegionMagic, std::memory_order_release);
+  return std::unique_ptr<SharedMemoryTransport>(
+      new SharedMemoryTransport(std::make_unique<detail::SharedMemoryTransportImplementation>(
+          name, region, region_size, true)));
+}
+
+std::unique_ptr<SharedMemoryTransport> SharedMemoryTransport::Open(
+    const std::string& name, std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto check_deadline = [&] {
+    if (std::chrono::steady_clock::now() > deadline) {
+      throw std::runtime_error(
+          fmt::format("Timeout while waiting for shared memory region {}", name));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+  int fd;
+  while ((fd = shm_open(name.c_str(), O_RDWR, 0)) < 0) {
+    if (errno != ENOENT) {
+      throw std::runtime_error(fmt::format("Error while opening shared memory region {}: {}", name,
+                                           std::strerror(errno)));
+    }
+    check_deadline();
+  }
+  // wait until the creator has resized the region
+  struct stat region_stat;
+  while (true) {
+    if (fstat(fd, &region_stat) != 0) {
+      const int error = errno;
+      close(fd);
+      throw std::runtime_error(fmt::format("Error while opening shared memory region {}: {}",
+                                           name, std::strerror(error)));
+    }
+    if (static_cast<std::size_t>(region_stat.st_size) >= sizeof(detail::RegionHeader)) {
+      break;
+    }
+    try {
+      check_deadline();
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+  }
+  const auto region_size = static_cast<std::size_t>(region_stat.st_size);
+  void* region = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Error while mapping shared memory region {}: {}", name,
+                                         std::strerror(errno)));
+  }
+  auto header = static_cast<detail::RegionHeader*>(region);
+  while (header->magic.load(std::memory_order_acquire) != detail::kRegionMagic) {
+    try {
+      check_deadline();
+    } catch (...) {
+      munmap(region, region_size);
+      throw;
+    }
+  }
+  // both parties have mapped the region, so its name is not needed anymore
+  shm_unlink(name.c_str());
+  return std::unique_ptr<SharedMemoryTransport>(
+      new SharedMemoryTransport(std::make_unique<detail::SharedMemoryTransportImplementation>(
+          name, region, region_size, false)));
+}
+
+SharedMemoryTransport::SharedMemoryTransport(
+    std::unique_ptr<detail::SharedMemoryTransportImplementation> implementation)
+    : implementation_(std::move(implementation)) {}
+
+SharedMemoryTransport::SharedMemoryTransport(SharedMemoryTransport&& other)
+    : Transport(std::move(other)), implementation_(std::move(other.implementation_)) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() = default;
+
+void SharedMemoryTransport::SendMessage(std::span<const std::uint8_t> message) {
+  SendMessageParts(std::span(&message, 1));
+}
+
+void SharedMemoryTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  if (message_size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::invalid_argument(
+        fmt::format("Message of {} bytes is too large for the shared memory transport",
+                    message_size));
+  }
+  // the parts are prefixed by the size of the message as in TcpTransport
+  const auto size_prefix = static_cast<std::uint32_t>(message_size);
+  implementation_->Write(std::span(reinterpret_cast<const std::uint8_t*>(&size_prefix),
+                                   sizeof(size_prefix)));
+  for (const auto& part : message_parts) {
+    implementation_->Write(part);
+  }
+  statistics_.number_of_messages_sent += 1;
+  statistics_.number_of_bytes_sent += message_size;
+}
+
+bool SharedMemoryTransport::Available() const {
+  const auto& ring = *implementation_->receive_ring_;
+  return ring.write_position.load(std::memory_order_acquire) !=
+         ring.read_position.load(std::memory_order_relaxed);
+}
+
+std::optional<std::vector<std::uint8_t>> SharedMemoryTransport::ReceiveMessage() {
+  std::uint32_t message_size;
+  if (!implementation_->Read(
+          std::span(reinterpret_cast<std::uint8_t*>(&message_size), sizeof(message_size)))) {
+    // transport has been closed
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message(message_size);
+  if (!implementation_->Read(message)) {
+    throw std::runtime_error("shared memory transport was closed in the middle of a message");
+  }
+  statistics_.number_of_messages_received += 1;
+  statistics_.number_of_bytes_received += message_size;
+  return message;
+}
+
+void SharedMemoryTransport::ShutdownSend() {
+  implementation_->send_ring_->producer_closed.store(1, std::memory_order_release);
+}
+
+void SharedMemoryTransport::Shutdown() {
+  ShutdownSend();
+  implementation_->receive_ring_->consumer_closed.store(1, std::memory_order_release);
+}
+
+std::vector<std::unique_ptr<Transport>> MakeSharedMemoryTransports(std::size_t my_id,
+                                                                   std::size_t number_of_parties,
+                                                                   const std::string& name_prefix) {
+  // create all regions of this party first, s.t. the other parties find them while this party
+  // waits for theirs
+  std::vector<std::unique_ptr<Transport>> transports(number_of_parties);
+  for (std::size_t other_id = my_id + 1; other_id < number_of_parties; ++other_id) {
+    transports.at(other_id) =
+        SharedMemoryTransport::Create(fmt::format("{}-{}-{}", name_prefix, my_id, other_id));
+  }
+  for (std::size_t other_id = 0; other_id < my_id; ++other_id) {
+    transports.at(other_id) =
+        SharedMemoryTransport::Open(fmt::format("{}-{}-{}", name_prefix, other_id, my_id));
+  }
+  return transports;
+}
+
+}  // namespace encrypto::motion::communication
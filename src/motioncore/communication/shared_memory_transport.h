@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct SharedMemoryTransportImplementation;
+
+}  // namespace detail
+
+// Transport between two parties on the same host, which may run in different processes.  The
+// parties share a POSIX shared memory region with one single-producer single-consumer ring
+// buffer per direction, which messages are copied into and out of without any system call.
+// Waiting for data or free space spins for a short while before sleeping.
+class SharedMemoryTransport : public Transport {
+ public:
+  // capacity of each ring buffer in bytes
+  static constexpr std::size_t kDefaultCapacity = 4 * 1024 * 1024;
+
+  // Create the shared memory region with the given name, eg "/motion-0-1", for the other party
+  // to open.  Throws std::runtime_error if the region cannot be created.
+  static std::unique_ptr<SharedMemoryTransport> Create(const std::string& name,
+                                                       std::size_t capacity = kDefaultCapacity);
+
+  // Open the region created by the other party, waiting up to timeout for it to be created.
+  // Throws std::runtime_error if the region does not become available in time.
+  static std::unique_ptr<SharedMemoryTransport> Open(
+      const std::string& name, std::chrono::milliseconds timeout = std::chrono::seconds(10));
+
+  SharedMemoryTransport(SharedMemoryTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~SharedMemoryTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+ private:
+  explicit SharedMemoryTransport(
+      std::unique_ptr<detail::SharedMemoryTransportImplementation> implementation);
+
+  std::unique_ptr<detail::SharedMemoryTransportImplementation> implementation_;
+};
+
+// Create the transports of party my_id to all other parties for parties running in different
+// processes on the same host.  The regions are named name_prefix-i-j and created by party i < j.
+std::vector<std::unique_ptr<Transport>> MakeSharedMemoryTransports(std::size_t my_id,
+                                                                   std::size_t number_of_parties,
+                                                                   const std::string& name_prefix);
+
+}  // namespace encrypto::motion::communication
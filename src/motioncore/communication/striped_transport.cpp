@@ -0,0 +1,276 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "striped_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "utility/synchronized_queue.h"
+#include "utility/thread.h"
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+// thread that executes the tasks submitted for one connection in order
+struct StripedConnectionWorker {
+  StripedConnectionWorker(const std::string& name);
+  // executes the remaining tasks before returning
+  ~StripedConnectionWorker();
+
+  std::future<void> Submit(std::function<void()>&& function);
+
+  SynchronizedQueue<std::packaged_task<void()>> tasks;
+  std::thread thread;
+};
+
+StripedConnectionWorker::StripedConnectionWorker(const std::string& name) {
+  thread = std::thread([this] {
+    while (auto task = tasks.dequeue()) {
+      (*task)();
+    }
+  });
+  ThreadSetName(thread, name);
+}
+
+StripedConnectionWorker::~StripedConnectionWorker() {
+  tasks.close();
+  thread.join();
+}
+
+std::future<void> StripedConnectionWorker::Submit(std::function<void()>&& function) {
+  std::packaged_task<void()> task(std::move(function));
+  auto future = task.get_future();
+  tasks.enqueue(std::move(task));
+  return future;
+}
+
+}  // namespace detail
+
+namespace {
+
+// returns the parts covering the bytes between from and to of the concatenation of message_parts
+std::vector<std::span<const std::uint8_t>> SliceParts(
+    std::span<const std::span<const std::uint8_t>> message_parts, std::size_t from,
+    std::size_t to) {
+  std::vector<std::span<const std::uint8_t>> result;
+  std::size_t part_begin = 0;
+  for (const auto& part : message_parts) {
+    const auto part_end = part_begin + part.size();
+    if (part_end > from && part_begin < to) {
+      const auto begin = std::max(from, part_begin) - part_begin;
+      const auto end = std::min(to, part_end) - part_begin;
+      result.push_back(part.subspan(begin, end - begin));
+    }
+    part_begin = part_end;
+  }
+  return result;
+}
+
+void ReceiveChunk(Transport& transport, std::span<std::uint8_t> chunk) {
+  if (!transport.ReceiveMessageInto(chunk)) {
+    throw std::runtime_error("Connection was closed while receiving a striped message");
+  }
+}
+
+// waits for all futures also if one of them or the work of the calling thread failed, s.t. no
+// worker uses the message afterwards, and rethrows the first exception
+void WaitForAll(std::vector<std::future<void>>& futures, std::exception_ptr exception) {
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!exception) exception = std::current_exception();
+    }
+  }
+  if (exception) std::rethrow_exception(exception);
+}
+
+}  // namespace
+
+StripedTransport::StripedTransport(std::vector<std::unique_ptr<Transport>>&& transports)
+    : transports_(std::move(transports)) {
+  if (transports_.empty() || transports_.size() > std::numeric_limits<std::uint8_t>::max()) {
+    throw std::invalid_argument(
+        fmt::format("StripedTransport needs 1 to 255 connections, got {}", transports_.size()));
+  }
+  for (std::size_t connection_i = 1; connection_i < transports_.size(); ++connection_i) {
+    send_workers_.emplace_back(std::make_unique<detail::StripedConnectionWorker>(
+        fmt::format("stripe-send-{}", connection_i)));
+    receive_workers_.emplace_back(std::make_unique<detail::StripedConnectionWorker>(
+        fmt::format("stripe-recv-{}", connection_i)));
+  }
+}
+
+StripedTransport::StripedTransport(StripedTransport&& other) = default;
+
+StripedTransport::~StripedTransport() = default;
+
+void StripedTransport::SendMessage(std::span<const std::uint8_t> message) {
+  const std::array<std::span<const std::uint8_t>, 1> message_parts{message};
+  SendMessageParts(message_parts);
+}
+
+// Every message on the first connection ends with a trailer byte holding the number of chunks,
+// which can be removed from the received message without moving the data.  A message with a
+// single chunk is sent as is with this trailer.  Otherwise, the first connection carries a header
+// with the sizes of the chunks as 64 bit little endian integers followed by the trailer, and then
+// chunk i is sent over connection i.
+void StripedTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  const std::size_t number_of_chunks =
+      std::clamp<std::size_t>(message_size / kMinimumChunkSize, 1, transports_.size());
+  const auto trailer = static_cast<std::uint8_t>(number_of_chunks);
+
+  if (number_of_chunks == 1) {
+    std::vector<std::span<const std::uint8_t>> parts(message_parts.begin(), message_parts.end());
+    parts.emplace_back(&trailer, 1);
+    transports_[0]->SendMessageParts(parts);
+  } else {
+    auto chunk_begin = [&](std::size_t chunk_i) {
+      return chunk_i * message_size / number_of_chunks;
+    };
+    std::vector<std::uint8_t> header;
+    header.reserve(number_of_chunks * sizeof(std::uint64_t) + 1);
+    for (std::size_t chunk_i = 0; chunk_i < number_of_chunks; ++chunk_i) {
+      const std::uint64_t chunk_size = chunk_begin(chunk_i + 1) - chunk_begin(chunk_i);
+      for (std::size_t byte_i = 0; byte_i < sizeof(std::uint64_t); ++byte_i) {
+        header.push_back(static_cast<std::uint8_t>(chunk_size >> (8 * byte_i)));
+      }
+    }
+    header.push_back(trailer);
+    transports_[0]->SendMessage(header);
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_chunks - 1);
+    for (std::size_t chunk_i = 1; chunk_i < number_of_chunks; ++chunk_i) {
+      futures.emplace_back(send_workers_[chunk_i - 1]->Submit(
+          [transport = transports_[chunk_i].get(),
+           chunk_parts = SliceParts(message_parts, chunk_begin(chunk_i),
+                                    chunk_begin(chunk_i + 1))] {
+            transport->SendMessageParts(chunk_parts);
+          }));
+    }
+    std::exception_ptr exception;
+    try {
+      transports_[0]->SendMessageParts(SliceParts(message_parts, 0, chunk_begin(1)));
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    WaitForAll(futures, exception);
+  }
+  statistics_.number_of_bytes_sent += message_size;
+  statistics_.number_of_messages_sent += 1;
+}
+
+bool StripedTransport::Available() const { return transports_[0]->Available(); }
+
+std::optional<std::vector<std::uint8_t>> StripedTransport::ReceiveMessage() {
+  auto message = transports_[0]->ReceiveMessage();
+  if (!message.has_value()) {
+    return std::nullopt;
+  }
+  if (message->empty()) {
+    throw std::runtime_error("Received message without StripedTransport trailer");
+  }
+  const std::size_t number_of_chunks = message->back();
+  message->pop_back();
+  if (number_of_chunks == 0 || number_of_chunks > transports_.size()) {
+    throw std::runtime_error(
+        fmt::format("Received message with invalid number of chunks {}", number_of_chunks));
+  }
+
+  if (number_of_chunks > 1) {
+    if (message->size() != number_of_chunks * sizeof(std::uint64_t)) {
+      throw std::runtime_error(
+          fmt::format("Received StripedTransport header of invalid size {}", message->size()));
+    }
+    std::vector<std::size_t> chunk_sizes(number_of_chunks, 0);
+    std::size_t message_size = 0;
+    for (std::size_t chunk_i = 0; chunk_i < number_of_chunks; ++chunk_i) {
+      for (std::size_t byte_i = 0; byte_i < sizeof(std::uint64_t); ++byte_i) {
+        chunk_sizes[chunk_i] |= static_cast<std::size_t>(
+                                    (*message)[chunk_i * sizeof(std::uint64_t) + byte_i])
+                                << (8 * byte_i);
+      }
+      message_size += chunk_sizes[chunk_i];
+    }
+
+    // all chunks are received simultaneously into their place in the message
+    std::vector<std::uint8_t> striped_message(message_size);
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_chunks - 1);
+    std::size_t chunk_begin = chunk_sizes[0];
+    for (std::size_t chunk_i = 1; chunk_i < number_of_chunks; ++chunk_i) {
+      const std::span<std::uint8_t> chunk(striped_message.data() + chunk_begin,
+                                          chunk_sizes[chunk_i]);
+      futures.emplace_back(receive_workers_[chunk_i - 1]->Submit(
+          [transport = transports_[chunk_i].get(), chunk] { ReceiveChunk(*transport, chunk); }));
+      chunk_begin += chunk_sizes[chunk_i];
+    }
+    std::exception_ptr exception;
+    try {
+      ReceiveChunk(*transports_[0], std::span(striped_message.data(), chunk_sizes[0]));
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    WaitForAll(futures, exception);
+    message = std::move(striped_message);
+  }
+
+  statistics_.number_of_bytes_received += message->size();
+  statistics_.number_of_messages_received += 1;
+  return message;
+}
+
+void StripedTransport::ShutdownSend() {
+  for (auto& transport : transports_) {
+    transport->ShutdownSend();
+  }
+}
+
+void StripedTransport::Shutdown() {
+  for (auto& transport : transports_) {
+    transport->Shutdown();
+  }
+}
+
+}  // namespace encrypto::motion::communication
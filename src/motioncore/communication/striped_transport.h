@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct StripedConnectionWorker;
+
+}  // namespace detail
+
+// Transport that combines several connections to the same party.  Large messages are split into
+// chunks which are sent and received over all connections in parallel, while small messages only
+// use the first connection.  A striped message is announced by a header with the sizes of its
+// chunks on the first connection, s.t. the receiver reads all chunks simultaneously into a single
+// buffer.  Every further connection is served by a persistent send and receive thread.  All the
+// connections need to be established in the same order on both sides.
+class StripedTransport : public Transport {
+ public:
+  StripedTransport(std::vector<std::unique_ptr<Transport>>&& transports);
+  StripedTransport(StripedTransport&& other);
+
+  // Destructor needs to be defined in implementation due to pimpl
+  ~StripedTransport();
+
+  void SendMessage(std::span<const std::uint8_t> message) override;
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
+  bool Available() const override;
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  void ShutdownSend() override;
+  void Shutdown() override;
+
+  std::size_t GetNumberOfConnections() const noexcept { return transports_.size(); }
+
+  // messages are only striped if every chunk has at least this size
+  static constexpr std::size_t kMinimumChunkSize = 1024 * 1024;
+
+ private:
+  std::vector<std::unique_ptr<Transport>> transports_;
+  // workers of the connections 1, 2, ..., destroyed before the transports they use
+  std::vector<std::unique_ptr<detail::StripedConnectionWorker>> send_workers_;
+  std::vector<std::unique_ptr<detail::StripedConnectionWorker>> receive_workers_;
+};
+
+}  // namespace encrypto::motion::communication
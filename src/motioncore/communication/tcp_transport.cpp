@@ -22,9 +22,12 @@
 
 #include "tcp_transport.h"
 
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <future>
 #include <shared_mutex>
+#include <thread>
 
 #include <fmt/format.h>
 #include <boost/asio/connect.hpp>
@@ -34,6 +37,13 @@
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/system/error_code.hpp>
+#include <sys/socket.h>
+
+#ifdef MOTION_IO_URING
+#include "io_uring_transport.h"
+#endif
+#include "encrypted_transport.h"
+#include "striped_transport.h"
 
 // Undefine Windows macros that collide with function names in MOTION.
 #ifdef SendMessage
@@ -53,6 +63,7 @@ struct TcpTransportImplementation {
   std::shared_ptr<boost::asio::io_context> io_context_;
   boost::asio::ip::tcp::socket socket_;
   std::shared_mutex socket_mutex_;
+  std::atomic<bool> busy_poll_ = false;
 };
 
 }  // namespace detail
@@ -112,6 +123,37 @@ void TcpTransport::SendMessage(std::span<const std::uint8_t> message) {
   statistics_.number_of_messages_sent += 1;
 }
 
+void TcpTransport::SendMessageParts(
+    std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  if (message_size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
+                                         std::numeric_limits<std::uint32_t>::max(),
+                                         message_size));
+  }
+  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
+  u32tou8(message_size, message_size_buffer.data());
+
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(message_parts.size() + 1);
+  buffers.emplace_back(boost::asio::buffer(message_size_buffer));
+  for (const auto& part : message_parts) {
+    buffers.emplace_back(boost::asio::buffer(part.data(), part.size()));
+  }
+
+  boost::system::error_code ec;
+  std::shared_lock lock(implementation_->socket_mutex_);
+  boost::asio::write(implementation_->socket_, buffers, boost::asio::transfer_all(), ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("Error while writing to socket: {}", ec.message()));
+  }
+  statistics_.number_of_bytes_sent += message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_sent += 1;
+}
+
 static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v) {
   std::uint32_t result = 0;
   for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
@@ -120,16 +162,52 @@ static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v)
   return result;
 }
 
-std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
+void TcpTransport::SetBusyPoll(bool value, std::chrono::microseconds busy_poll_time) {
+  implementation_->busy_poll_ = value;
+#ifdef SO_BUSY_POLL
+  std::scoped_lock lock(implementation_->socket_mutex_);
+  // raising the time above net.core.busy_read needs CAP_NET_ADMIN, without it only the spinning
+  // in ReceiveMessage is used
+  const int microseconds = value ? static_cast<int>(busy_poll_time.count()) : 0;
+  ::setsockopt(implementation_->socket_.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &microseconds,
+               sizeof(microseconds));
+#else
+  (void)busy_poll_time;
+#endif
+}
+
+// spins until data or the end of the stream is available
+static void BusyWaitRead(tcp::socket& socket, boost::system::error_code& ec) {
+  std::uint8_t byte;
+  while (true) {
+    const auto result = ::recv(socket.native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (result >= 0) {
+      // the following read returns the data or detects the end of the stream
+      return;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      ec.assign(errno, boost::system::system_category());
+      return;
+    }
+  }
+}
+
+// waits for the next message and reads its size, returns std::nullopt if the connection has been
+// closed, the caller needs to hold the socket mutex
+static std::optional<std::uint32_t> ReadMessageSize(
+    detail::TcpTransportImplementation& implementation) {
   std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
   boost::system::error_code ec;
-  std::shared_lock lock(implementation_->socket_mutex_);
-  implementation_->socket_.wait(tcp::socket::wait_read, ec);
+  if (implementation.busy_poll_) {
+    BusyWaitRead(implementation.socket_, ec);
+  } else {
+    implementation.socket_.wait(tcp::socket::wait_read, ec);
+  }
   if (ec) {
     throw std::runtime_error(
         fmt::format("Error while wait read on socket: {} ({})", ec.message(), ec.value()));
   }
-  boost::asio::read(implementation_->socket_, boost::asio::buffer(message_size_buffer),
+  boost::asio::read(implementation.socket_, boost::asio::buffer(message_size_buffer),
                     boost::asio::transfer_exactly(message_size_buffer.size()), ec);
   if (ec) {
     if (ec.value() == boost::asio::error::misc_errors::eof) {
@@ -139,30 +217,71 @@ std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
     throw std::runtime_error(fmt::format("Error while reading message size from socket: {} ({})",
                                          ec.message(), ec.value()));
   }
-  std::uint32_t message_size = u8tou32(message_size_buffer);
-  std::vector<std::uint8_t> message_buffer(message_size);
+  return u8tou32(message_size_buffer);
+}
+
+std::optional<std::vector<std::uint8_t>> TcpTransport::ReceiveMessage() {
+  std::shared_lock lock(implementation_->socket_mutex_);
+  const auto message_size = ReadMessageSize(*implementation_);
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  boost::system::error_code ec;
   boost::asio::read(implementation_->socket_, boost::asio::buffer(message_buffer),
                     boost::asio::transfer_exactly(message_buffer.size()), ec);
   if (ec) {
     throw std::runtime_error(
         fmt::format("Error while reading message size socket: {} ({})", ec.message(), ec.value()));
   }
-  statistics_.number_of_bytes_received += message_size + sizeof(uint32_t);
+  statistics_.number_of_bytes_received += *message_size + sizeof(uint32_t);
   statistics_.number_of_messages_received += 1;
   return message_buffer;
 }
 
+bool TcpTransport::ReceiveMessageInto(std::span<std::uint8_t> destination) {
+  std::shared_lock lock(implementation_->socket_mutex_);
+  const auto message_size = ReadMessageSize(*implementation_);
+  if (!message_size.has_value()) {
+    return false;
+  }
+  if (*message_size != destination.size()) {
+    throw std::runtime_error(fmt::format("Expected message of {} B but received {} B",
+                                         destination.size(), *message_size));
+  }
+  boost::system::error_code ec;
+  boost::asio::read(implementation_->socket_,
+                    boost::asio::buffer(destination.data(), destination.size()),
+                    boost::asio::transfer_exactly(destination.size()), ec);
+  if (ec) {
+    throw std::runtime_error(
+        fmt::format("Error while reading message from socket: {} ({})", ec.message(), ec.value()));
+  }
+  statistics_.number_of_bytes_received += *message_size + sizeof(uint32_t);
+  statistics_.number_of_messages_received += 1;
+  return true;
+}
+
 using namespace std::chrono_literals;
 
 struct TcpSetupHelper::TcpSetupImplementation {
   [[nodiscard]] std::map<std::size_t, tcp::socket> accept_task();
-  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::string host,
-                                         std::uint16_t port);
+  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::size_t connection_index,
+                                         std::string host, std::uint16_t port);
+
+  // identifies the connection_index-th connection to party_id in sockets_ and in the handshake
+  std::size_t GetConnectionKey(std::size_t party_id, std::size_t connection_index) const {
+    return party_id + connection_index * number_of_parties_;
+  }
 
   std::size_t my_id_;
   std::size_t number_of_parties_;
-  int number_of_connection_retries_ = 10;
-  decltype(1s) retry_delay_ = 3s;
+  std::size_t number_of_connections_per_party_ = 1;
+  // failed connection attempts are retried with exponentially growing delays s.t. parties which
+  // start at about the same time connect quickly
+  std::chrono::milliseconds initial_retry_delay_ = 10ms;
+  std::chrono::milliseconds maximum_retry_delay_ = 1s;
+  std::chrono::milliseconds connection_timeout_ = 30s;
   boost::asio::ip::address bind_address_;
   std::uint16_t bind_port_;
   std::shared_ptr<boost::asio::io_context> io_context_;
@@ -201,18 +320,27 @@ TcpSetupHelper::~TcpSetupHelper() = default;
 std::vector<std::unique_ptr<Transport>> TcpSetupHelper::SetupConnections() {
   auto accept_future =
       std::async(std::launch::async, [this] { return implementation_->accept_task(); });
+  const auto number_of_connections = implementation_->number_of_connections_per_party_;
   std::vector<std::future<tcp::socket>> futures;
   for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
     auto party_configuration = parties_configuration_.at(party_id);
-    futures.emplace_back(std::async(std::launch::async, [this, party_id, party_configuration] {
-      return implementation_->connect_task(party_id, std::get<0>(party_configuration),
-                                           std::get<1>(party_configuration));
-    }));
+    for (std::size_t connection_i = 0; connection_i < number_of_connections; ++connection_i) {
+      futures.emplace_back(
+          std::async(std::launch::async, [this, party_id, connection_i, party_configuration] {
+            return implementation_->connect_task(party_id, connection_i,
+                                                 std::get<0>(party_configuration),
+                                                 std::get<1>(party_configuration));
+          }));
+    }
   }
   try {
     implementation_->sockets_ = accept_future.get();
     for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
-      implementation_->sockets_.emplace(party_id, futures.at(party_id).get());
+      for (std::size_t connection_i = 0; connection_i < number_of_connections; ++connection_i) {
+        implementation_->sockets_.emplace(
+            implementation_->GetConnectionKey(party_id, connection_i),
+            futures.at(party_id * number_of_connections + connection_i).get());
+      }
     }
   } catch (std::runtime_error& e) {
     // an error happened => close all other sockets
@@ -229,25 +357,106 @@ std::vector<std::unique_ptr<Transport>> TcpSetupHelper::SetupConnections() {
     throw;
   }
 
+#ifdef MOTION_IO_URING
+  // without io_uring support in the kernel, the connections fall back to TcpTransports
+  const bool use_io_uring{use_io_uring_ && IoUringTransport::IsAvailable()};
+#endif
+  auto make_transport = [&](tcp::socket&& socket) -> std::unique_ptr<Transport> {
+#ifdef MOTION_RDMA
+    if (rdma_device_configuration_) {
+      return std::make_unique<RdmaTransport>(socket.release(), *rdma_device_configuration_);
+    }
+#endif
+#ifdef MOTION_IO_URING
+    if (use_io_uring) {
+      // the transport takes over the native socket
+      return std::make_unique<IoUringTransport>(socket.release());
+    }
+#endif
+    auto transport_implementation = std::make_unique<detail::TcpTransportImplementation>(
+        implementation_->io_context_, std::move(socket));
+    auto transport = std::make_unique<TcpTransport>(std::move(transport_implementation));
+    if (busy_poll_) transport->SetBusyPoll();
+    return transport;
+  };
+
   std::vector<std::unique_ptr<Transport>> result(number_of_parties_);
-  std::for_each(std::begin(implementation_->sockets_), std::end(implementation_->sockets_),
-                [this, &result](auto& iterator) {
-                  auto transport_implementation =
-                      std::make_unique<detail::TcpTransportImplementation>(
-                          implementation_->io_context_, std::move(iterator.second));
-                  result.at(iterator.first) =
-                      std::make_unique<TcpTransport>(std::move(transport_implementation));
-                });
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    std::vector<std::unique_ptr<Transport>> transports;
+    for (std::size_t connection_i = 0; connection_i < number_of_connections; ++connection_i) {
+      auto& socket =
+          implementation_->sockets_.at(implementation_->GetConnectionKey(party_id, connection_i));
+      transports.emplace_back(make_transport(std::move(socket)));
+      if (!pre_shared_key_.empty()) {
+        // encrypt each connection s.t. striped transports encrypt in parallel, the handshakes
+        // happen in the same order on all parties
+        transports.back() = std::make_unique<EncryptedTransport>(
+            std::move(transports.back()), pre_shared_key_, my_id_ < party_id);
+      }
+    }
+    if (number_of_connections == 1) {
+      result.at(party_id) = std::move(transports.front());
+    } else {
+      result.at(party_id) = std::make_unique<StripedTransport>(std::move(transports));
+    }
+  }
+  implementation_->sockets_.clear();
   return result;
 }
 
+void TcpSetupHelper::SetNumberOfConnectionsPerParty(std::size_t number_of_connections) {
+  if (number_of_connections == 0 ||
+      number_of_connections > std::numeric_limits<std::uint8_t>::max()) {
+    throw std::invalid_argument(fmt::format(
+        "specified invalid number of connections per party: {}", number_of_connections));
+  }
+  implementation_->number_of_connections_per_party_ = number_of_connections;
+}
+
+void TcpSetupHelper::SetUseIoUring(bool value) {
+#ifndef MOTION_IO_URING
+  if (value) {
+    throw std::logic_error("MOTION was built without io_uring support");
+  }
+#endif
+  use_io_uring_ = value;
+}
+
+void TcpSetupHelper::SetUseRdma(bool value, RdmaDeviceConfiguration device_configuration) {
+#ifndef MOTION_RDMA
+  if (value) {
+    throw std::logic_error("MOTION was built without RDMA support");
+  }
+#endif
+  if (value) {
+    rdma_device_configuration_ = std::move(device_configuration);
+  } else {
+    rdma_device_configuration_.reset();
+  }
+}
+
+void TcpSetupHelper::SetBusyPoll(bool value) { busy_poll_ = value; }
+
+void TcpSetupHelper::SetPreSharedKey(std::vector<std::uint8_t> pre_shared_key) {
+  if (!pre_shared_key.empty() && pre_shared_key.size() < EncryptedTransport::kMinimumKeySize) {
+    throw std::invalid_argument(
+        fmt::format("pre-shared key of {} bytes is shorter than {} bytes", pre_shared_key.size(),
+                    EncryptedTransport::kMinimumKeySize));
+  }
+  pre_shared_key_ = std::move(pre_shared_key);
+}
+
 std::map<std::size_t, tcp::socket> TcpSetupHelper::TcpSetupImplementation::accept_task() {
   if (my_id_ == number_of_parties_ - 1) {
     return {};
   }
   std::map<std::size_t, tcp::socket> sockets;
   std::size_t number_of_accepted_connections = 0;
-  std::size_t expected_connections = number_of_parties_ - my_id_ - 1;
+  std::size_t expected_connections =
+      (number_of_parties_ - my_id_ - 1) * number_of_connections_per_party_;
   boost::system::error_code ec;
   tcp::acceptor acceptor(*io_context_, tcp::endpoint(bind_address_, bind_port_),
                          /* reuse_addr = */ true);
@@ -262,6 +471,7 @@ std::map<std::size_t, tcp::socket> TcpSetupHelper::TcpSetupImplementation::accep
       throw std::runtime_error(fmt::format("error occurred on accept: {}\n", ec.message()));
     }
     std::size_t other_id;
+    std::size_t connection_key;
     // receive other id
     {
       std::uint64_t received_id;
@@ -270,16 +480,18 @@ std::map<std::size_t, tcp::socket> TcpSetupHelper::TcpSetupImplementation::accep
         socket.close();
         continue;
       }
-      other_id = static_cast<std::size_t>(received_id);
+      connection_key = static_cast<std::size_t>(received_id);
+      other_id = connection_key % number_of_parties_;
     }
     // validate received id
-    if (other_id <= my_id_ || other_id >= number_of_parties_) {
+    if (other_id <= my_id_ ||
+        connection_key >= number_of_parties_ * number_of_connections_per_party_) {
       // invalid_id
       socket.close();
       continue;
     }
     // check if we are already connected to this party
-    if (auto iterator = sockets.find(static_cast<std::size_t>(other_id));
+    if (auto iterator = sockets.find(connection_key);
         iterator != sockets.end()) {
       socket.close();
       continue;
@@ -294,13 +506,14 @@ std::map<std::size_t, tcp::socket> TcpSetupHelper::TcpSetupImplementation::accep
       }
     }
     // success
-    sockets.emplace(std::make_pair(other_id, std::move(socket)));
+    sockets.emplace(std::make_pair(connection_key, std::move(socket)));
     ++number_of_accepted_connections;
   }
   return sockets;
 }
 
 tcp::socket TcpSetupHelper::TcpSetupImplementation::connect_task(std::size_t other_id,
+                                                                 std::size_t connection_index,
                                                                  std::string host,
                                                                  std::uint16_t port) {
   boost::system::error_code ec;
@@ -310,17 +523,26 @@ tcp::socket TcpSetupHelper::TcpSetupImplementation::connect_task(std::size_t oth
   if (ec) {
     throw std::runtime_error(fmt::format("cannot resolve {}:{}, {}\n", host, port, ec.message()));
   }
-  int connect_retry_i = 0;
-  for (; connect_retry_i < number_of_connection_retries_; ++connect_retry_i) {
+  const auto deadline = std::chrono::steady_clock::now() + connection_timeout_;
+  auto retry_delay = initial_retry_delay_;
+  bool connected = false;
+  for (bool first_try = true; !connected; first_try = false) {
+    if (!first_try) {
+      if (std::chrono::steady_clock::now() + retry_delay > deadline) {
+        break;
+      }
+      std::this_thread::sleep_for(retry_delay);
+      retry_delay = std::min(2 * retry_delay, maximum_retry_delay_);
+    }
     boost::asio::connect(socket, endpoints, ec);
     if (ec) {
-      std::this_thread::sleep_for(retry_delay_);
       continue;
     }
 
     // send my id to the peer
     {
-      std::uint64_t own_id = static_cast<std::uint64_t>(my_id_);
+      std::uint64_t own_id =
+          static_cast<std::uint64_t>(GetConnectionKey(my_id_, connection_index));
       boost::asio::write(socket, boost::asio::const_buffer(&own_id, sizeof(own_id)), ec);
       if (ec) {
         socket.close();
@@ -342,9 +564,9 @@ tcp::socket TcpSetupHelper::TcpSetupImplementation::connect_task(std::size_t oth
       }
     }
     // success
-    break;
+    connected = true;
   }
-  if (connect_retry_i == number_of_connection_retries_) {
+  if (!connected) {
     throw std::runtime_error(fmt::format(
         "too many errors while trying to connect to party {} at {}:{}, last error message: {}",
         other_id, host, port, ec.message()));
@@ -352,4 +574,81 @@ tcp::socket TcpSetupHelper::TcpSetupImplementation::connect_task(std::size_t oth
   return socket;
 }
 
+std::unique_ptr<Transport> TcpConnectToServer(
+    std::size_t my_id, const TcpConnectionConfiguration& server_configuration) {
+  constexpr int kNumberOfConnectionRetries = 10;
+  constexpr auto kRetryDelay = 3s;
+  const auto& [host, port] = server_configuration;
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  boost::system::error_code ec;
+  tcp::socket socket(*io_context);
+  tcp::resolver resolver(*io_context);
+  auto endpoints = resolver.resolve(host, std::to_string(port), ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("cannot resolve {}:{}, {}\n", host, port, ec.message()));
+  }
+  int connect_retry_i = 0;
+  for (; connect_retry_i < kNumberOfConnectionRetries; ++connect_retry_i) {
+    boost::asio::connect(socket, endpoints, ec);
+    if (ec) {
+      std::this_thread::sleep_for(kRetryDelay);
+      continue;
+    }
+    std::uint64_t own_id = static_cast<std::uint64_t>(my_id);
+    boost::asio::write(socket, boost::asio::const_buffer(&own_id, sizeof(own_id)), ec);
+    if (ec) {
+      socket.close();
+      continue;
+    }
+    break;
+  }
+  if (connect_retry_i == kNumberOfConnectionRetries) {
+    throw std::runtime_error(
+        fmt::format("too many errors while trying to connect to {}:{}, last error message: {}",
+                    host, port, ec.message()));
+  }
+  auto transport_implementation =
+      std::make_unique<detail::TcpTransportImplementation>(io_context, std::move(socket));
+  return std::make_unique<TcpTransport>(std::move(transport_implementation));
+}
+
+std::vector<std::unique_ptr<Transport>> TcpAcceptParties(
+    const TcpConnectionConfiguration& bind_configuration, std::size_t number_of_parties) {
+  const auto& [host, port] = bind_configuration;
+  boost::system::error_code ec;
+  auto bind_address = boost::asio::ip::make_address(host, ec);
+  if (ec) {
+    throw std::invalid_argument(
+        fmt::format("bind address ({}) is no IP address: {}", host, ec.message()));
+  }
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  tcp::acceptor acceptor(*io_context, tcp::endpoint(bind_address, port),
+                         /* reuse_addr = */ true);
+  acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("error occurred on listen: {}\n", ec.message()));
+  }
+  std::vector<std::unique_ptr<Transport>> result(number_of_parties);
+  std::size_t number_of_accepted_connections = 0;
+  while (number_of_accepted_connections < number_of_parties) {
+    tcp::socket socket(*io_context);
+    acceptor.accept(socket, ec);
+    if (ec) {
+      throw std::runtime_error(fmt::format("error occurred on accept: {}\n", ec.message()));
+    }
+    std::uint64_t received_id;
+    boost::asio::read(socket, boost::asio::mutable_buffer(&received_id, sizeof(received_id)), ec);
+    // ignore connections with invalid or duplicate ids
+    if (ec || received_id >= number_of_parties || result.at(received_id)) {
+      socket.close();
+      continue;
+    }
+    auto transport_implementation =
+        std::make_unique<detail::TcpTransportImplementation>(io_context, std::move(socket));
+    result.at(received_id) = std::make_unique<TcpTransport>(std::move(transport_implementation));
+    ++number_of_accepted_connections;
+  }
+  return result;
+}
+
 }  // namespace encrypto::motion::communication
@@ -22,11 +22,14 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 
+#include "rdma_transport.h"
 #include "transport.h"
 
 namespace encrypto::motion::communication {
@@ -47,11 +50,25 @@ class TcpTransport : public Transport {
 
   void SendMessage(std::span<const std::uint8_t> message) override;
 
+  // write the parts with a single vectored write without copying them
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override;
+
   bool Available() const override;
   std::optional<std::vector<std::uint8_t>> ReceiveMessage() override;
+  // reads the message directly into destination
+  bool ReceiveMessageInto(std::span<std::uint8_t> destination) override;
   void ShutdownSend() override;
   void Shutdown() override;
 
+  // default time the kernel busy polls in blocking reads
+  static constexpr std::chrono::microseconds kBusyPollTime{50};
+
+  // Spin with non-blocking reads while waiting for the next message instead of sleeping in the
+  // kernel, which occupies the CPU of the receiving thread but saves the wake-up latency.  Also
+  // asks the kernel to busy poll the device queue of the socket (SO_BUSY_POLL) for the given time
+  // in blocking reads if permitted.
+  void SetBusyPoll(bool value = true, std::chrono::microseconds busy_poll_time = kBusyPollTime);
+
  private:
   bool is_connected_;
   std::unique_ptr<detail::TcpTransportImplementation> implementation_;
@@ -76,13 +93,51 @@ class TcpSetupHelper {
   // Throws a std::runtime_error if something goes wrong.
   std::vector<std::unique_ptr<Transport>> SetupConnections();
 
+  // Open number_of_connections connections to each party, which are combined in a
+  // StripedTransport if more than one.  Needs to be the same for all parties.
+  void SetNumberOfConnectionsPerParty(std::size_t number_of_connections);
+
+  // Use IoUringTransports instead of TcpTransports for the connections, which fall back to
+  // TcpTransports if the kernel does not support io_uring, see IoUringTransport::IsAvailable.
+  // Throws a std::logic_error if MOTION was built without MOTION_USE_IO_URING.
+  void SetUseIoUring(bool value = true);
+
+  // Use RdmaTransports on the given device for the connections, where the TCP connections are
+  // only used to connect the queue pairs.  Takes precedence over SetUseIoUring.
+  // Throws a std::logic_error if MOTION was built without MOTION_USE_RDMA.
+  void SetUseRdma(bool value = true, RdmaDeviceConfiguration device_configuration = {});
+
+  // Let the TcpTransports busy poll while waiting for messages, see TcpTransport::SetBusyPoll.
+  // Pin the receive threads to dedicated CPUs with CommunicationLayer::SetThreadAffinity.
+  void SetBusyPoll(bool value = true);
+
+  // Encrypt and authenticate the connections with EncryptedTransports using pre_shared_key, which
+  // needs to be the same for all parties.  An empty key disables the encryption.
+  // Throws a std::invalid_argument if the key is shorter than EncryptedTransport::kMinimumKeySize.
+  void SetPreSharedKey(std::vector<std::uint8_t> pre_shared_key);
+
  private:
   struct TcpSetupImplementation;
 
+  bool use_io_uring_ = false;
+  bool busy_poll_ = false;
+  std::optional<RdmaDeviceConfiguration> rdma_device_configuration_;
+  std::vector<std::uint8_t> pre_shared_key_;
   std::size_t my_id_;
   std::size_t number_of_parties_;
   const TcpPartiesConfiguration parties_configuration_;
   std::unique_ptr<TcpSetupImplementation> implementation_;
 };
 
+// Connect to a server that serves several parties, e.g., the trusted dealer, and identify as
+// party my_id.  Throws a std::runtime_error if something goes wrong.
+std::unique_ptr<Transport> TcpConnectToServer(
+    std::size_t my_id, const TcpConnectionConfiguration& server_configuration);
+
+// Accept one connection from each of number_of_parties parties that connect via
+// TcpConnectToServer and return them ordered by the ids of the parties.
+// Throws a std::runtime_error if something goes wrong.
+std::vector<std::unique_ptr<Transport>> TcpAcceptParties(
+    const TcpConnectionConfiguration& bind_configuration, std::size_t number_of_parties);
+
 }  // namespace encrypto::motion::communication
@@ -22,8 +22,52 @@
 
 #include "transport.h"
 
+#include <algorithm>
+
+#include <fmt/format.h>
+
 namespace encrypto::motion::communication {
 
+std::string to_string(MessagePhase phase) {
+  switch (phase) {
+    case MessagePhase::kControl:
+      return "control";
+    case MessagePhase::kSetup:
+      return "setup";
+    case MessagePhase::kOnline:
+      return "online";
+  }
+  return "invalid";
+}
+
+void Transport::SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) {
+  std::size_t message_size = 0;
+  for (const auto& part : message_parts) {
+    message_size += part.size();
+  }
+  std::vector<std::uint8_t> message;
+  message.reserve(message_size);
+  for (const auto& part : message_parts) {
+    message.insert(message.end(), part.begin(), part.end());
+  }
+  SendOwnedMessage(std::move(message));
+}
+
+void Transport::SendOwnedMessage(std::vector<std::uint8_t>&& message) { SendMessage(message); }
+
+bool Transport::ReceiveMessageInto(std::span<std::uint8_t> destination) {
+  auto message = ReceiveMessage();
+  if (!message.has_value()) {
+    return false;
+  }
+  if (message->size() != destination.size()) {
+    throw std::runtime_error(fmt::format("Expected message of {} B but received {} B",
+                                         destination.size(), message->size()));
+  }
+  std::copy(message->begin(), message->end(), destination.begin());
+  return true;
+}
+
 const TransportStatistics& Transport::GetStatistics() const { return statistics_; }
 
 void Transport::ResetStatistics() {
@@ -31,6 +75,7 @@ void Transport::ResetStatistics() {
   statistics_.number_of_messages_received = 0;
   statistics_.number_of_bytes_sent = 0;
   statistics_.number_of_bytes_received = 0;
+  statistics_.message_types.clear();
 }
 
 }  // namespace encrypto::motion::communication
@@ -22,19 +22,57 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <span>
+#include <string>
 #include <vector>
 
 namespace encrypto::motion::communication {
 
+// phase a message type belongs to, where the setup includes the preprocessing
+enum class MessagePhase : std::uint8_t { kControl, kSetup, kOnline };
+
+std::string to_string(MessagePhase phase);
+
+// messages of one type counted by the CommunicationLayer, which counts the messages inside of
+// batches and compressed messages with their uncompressed size and without the framing of the
+// transport, s.t. the bytes of the types do not add up to the number of bytes of the transport
+struct MessageTypeStatistics {
+  MessagePhase phase = MessagePhase::kControl;
+  std::size_t number_of_messages_sent = 0;
+  std::size_t number_of_messages_received = 0;
+  std::size_t number_of_bytes_sent = 0;
+  std::size_t number_of_bytes_received = 0;
+  // summed time the sent messages waited in the send queue before being sent
+  std::chrono::nanoseconds send_queue_time{0};
+};
+
 struct TransportStatistics {
   std::size_t number_of_messages_sent = 0;
   std::size_t number_of_messages_received = 0;
   std::size_t number_of_bytes_sent = 0;
   std::size_t number_of_bytes_received = 0;
+  // size of the messages sent compressed before and after their compression
+  std::size_t number_of_bytes_before_compression = 0;
+  std::size_t number_of_bytes_after_compression = 0;
+  // maximum number of bytes in the send queue and how often and how long senders were suspended
+  // by its watermarks
+  std::size_t peak_send_queue_bytes = 0;
+  std::size_t number_of_send_queue_waits = 0;
+  std::chrono::nanoseconds send_queue_wait_time{0};
+  // last window the send thread waited for further messages to coalesce, how often it waited and
+  // how many messages these waits collected, see CommunicationLayer::SetRoundTripTime
+  std::chrono::nanoseconds coalescing_window{0};
+  std::size_t number_of_coalescing_waits = 0;
+  std::size_t number_of_messages_collected_by_waiting = 0;
+  // by the name of the message type, e.g., "kOtExtensionSender", only the types that were sent or
+  // received
+  std::map<std::string, MessageTypeStatistics> message_types;
 };
 
 // underlying transport between two parties
@@ -51,12 +89,25 @@ class Transport {
   // send a message
   virtual void SendMessage(std::span<const std::uint8_t> message) = 0;
 
+  // send a message whose buffer the transport may take over instead of copying it
+  // the default implementation sends it as above
+  virtual void SendOwnedMessage(std::vector<std::uint8_t>&& message);
+
+  // send a message which is given as the concatenation of several buffers
+  // the default implementation copies the parts into one buffer, which it sends as owned message
+  virtual void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts);
+
   // check if a new message is available
   virtual bool Available() const = 0;
 
   // receive message, possibly blocking
   virtual std::optional<std::vector<std::uint8_t>> ReceiveMessage() = 0;
 
+  // receive the next message into destination, which needs to have exactly the size of the
+  // message, returns false if the connection has been closed, possibly blocking
+  // the default implementation receives the message as above and copies it
+  virtual bool ReceiveMessageInto(std::span<std::uint8_t> destination);
+
   // shutdown the outgoing part of the transport to signal end of communication
   virtual void ShutdownSend() = 0;
 
@@ -0,0 +1,245 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "transport_multiplexer.h"
+
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fmt/format.h>
+
+#include "utility/synchronized_queue.h"
+
+// Undefine Windows macros that collide with function names in MOTION.
+#ifdef SendMessage
+#undef SendMessage
+#endif
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+namespace {
+
+constexpr std::size_t kSessionIdSize{sizeof(std::uint64_t)};
+
+using SessionQueue = SynchronizedQueue<std::vector<std::uint8_t>>;
+
+}  // namespace
+
+struct MultiplexedConnection {
+  std::unique_ptr<Transport> transport;
+  std::mutex send_mutex;
+  // queues of the sessions that are open or received messages, which are closed and removed when
+  // the other party ends the session
+  std::mutex sessions_mutex;
+  std::unordered_map<std::uint64_t, std::shared_ptr<SessionQueue>> queues;
+  std::unordered_set<std::uint64_t> open_sessions;
+  bool closed = false;
+  std::thread receive_thread;
+
+  // must be called with sessions_mutex locked
+  std::shared_ptr<SessionQueue>& GetQueue(std::uint64_t session_id) {
+    auto& queue{queues[session_id]};
+    if (!queue) {
+      queue = std::make_shared<SessionQueue>();
+      if (closed) queue->close();
+    }
+    return queue;
+  }
+
+  void Send(std::uint64_t session_id, std::span<const std::span<const std::uint8_t>> parts) {
+    std::array<std::uint8_t, kSessionIdSize> header;
+    std::memcpy(header.data(), &session_id, kSessionIdSize);
+    std::vector<std::span<const std::uint8_t>> message_parts;
+    message_parts.reserve(parts.size() + 1);
+    message_parts.emplace_back(header);
+    message_parts.insert(message_parts.end(), parts.begin(), parts.end());
+    std::scoped_lock lock(send_mutex);
+    transport->SendMessageParts(message_parts);
+  }
+
+  void Receive() {
+    while (auto message{transport->ReceiveMessage()}) {
+      if (message->size() < kSessionIdSize) break;
+      std::uint64_t session_id;
+      std::memcpy(&session_id, message->data(), kSessionIdSize);
+      std::scoped_lock lock(sessions_mutex);
+      auto& queue{GetQueue(session_id)};
+      if (message->size() == kSessionIdSize) {
+        // end of the session, later messages with the same id belong to the next session
+        queue->close();
+        queues.erase(session_id);
+      } else {
+        message->erase(message->begin(), message->begin() + kSessionIdSize);
+        queue->enqueue(std::move(*message));
+      }
+    }
+    // the connection was closed, which ends all sessions
+    std::scoped_lock lock(sessions_mutex);
+    closed = true;
+    for (auto& [session_id, queue] : queues) queue->close();
+    queues.clear();
+  }
+};
+
+namespace {
+
+// transport of one session, where a message that only consists of the session id marks the end
+// of the session in each direction
+class MultiplexedTransport : public Transport {
+ public:
+  MultiplexedTransport(std::shared_ptr<MultiplexedConnection> connection, std::uint64_t session_id,
+                       std::shared_ptr<SessionQueue> queue)
+      : connection_(std::move(connection)), session_id_(session_id), queue_(std::move(queue)) {}
+
+  ~MultiplexedTransport() { Shutdown(); }
+
+  void SendMessage(std::span<const std::uint8_t> message) override {
+    SendMessageParts(std::span<const std::span<const std::uint8_t>>(&message, 1));
+  }
+
+  void SendMessageParts(std::span<const std::span<const std::uint8_t>> message_parts) override {
+    std::size_t message_size = 0;
+    for (const auto& part : message_parts) {
+      message_size += part.size();
+    }
+    if (message_size == 0) {
+      throw std::invalid_argument("multiplexed sessions cannot send empty messages");
+    }
+    connection_->Send(session_id_, message_parts);
+    statistics_.number_of_messages_sent += 1;
+    statistics_.number_of_bytes_sent += message_size;
+  }
+
+  bool Available() const override { return !queue_->empty(); }
+
+  std::optional<std::vector<std::uint8_t>> ReceiveMessage() override {
+    auto message = queue_->dequeue();
+    if (message.has_value()) {
+      statistics_.number_of_messages_received += 1;
+      statistics_.number_of_bytes_received += message->size();
+    }
+    return message;
+  }
+
+  void ShutdownSend() override {
+    if (!end_of_session_sent_) {
+      connection_->Send(session_id_, {});
+      end_of_session_sent_ = true;
+    }
+  }
+
+  // consumes the rest of the session, s.t. its id may be reused afterwards
+  void Shutdown() override {
+    if (is_shutdown_) {
+      return;
+    }
+    ShutdownSend();
+    while (queue_->dequeue().has_value()) {
+    }
+    is_shutdown_ = true;
+    std::scoped_lock lock(connection_->sessions_mutex);
+    connection_->open_sessions.erase(session_id_);
+  }
+
+ private:
+  std::shared_ptr<MultiplexedConnection> connection_;
+  std::uint64_t session_id_;
+  std::shared_ptr<SessionQueue> queue_;
+  bool end_of_session_sent_ = false;
+  bool is_shutdown_ = false;
+};
+
+}  // namespace
+
+}  // namespace detail
+
+TransportMultiplexer::TransportMultiplexer(std::vector<std::unique_ptr<Transport>>&& transports) {
+  connections_.reserve(transports.size());
+  for (auto& transport : transports) {
+    if (transport) {
+      auto connection{std::make_shared<detail::MultiplexedConnection>()};
+      connection->transport = std::move(transport);
+      connection->receive_thread = std::thread([connection = connection.get()] {
+        connection->Receive();
+      });
+      connections_.emplace_back(std::move(connection));
+    } else {
+      // connection to myself
+      connections_.emplace_back(nullptr);
+    }
+  }
+}
+
+TransportMultiplexer::~TransportMultiplexer() {
+  for (auto& connection : connections_) {
+    if (connection) connection->transport->ShutdownSend();
+  }
+  // the receive threads end when the other parties closed their connections as well
+  for (auto& connection : connections_) {
+    if (connection) {
+      connection->receive_thread.join();
+      connection->transport->Shutdown();
+    }
+  }
+}
+
+std::vector<std::unique_ptr<Transport>> TransportMultiplexer::GetTransports(
+    std::uint64_t session_id) {
+  for (const auto& connection : connections_) {
+    if (!connection) continue;
+    std::scoped_lock lock(connection->sessions_mutex);
+    if (connection->open_sessions.contains(session_id)) {
+      throw std::logic_error(
+          fmt::format("session #{} of the TransportMultiplexer is already open", session_id));
+    }
+  }
+  std::vector<std::unique_ptr<Transport>> transports(connections_.size());
+  for (std::size_t i = 0; i < connections_.size(); ++i) {
+    auto& connection{connections_.at(i)};
+    if (!connection) continue;
+    std::scoped_lock lock(connection->sessions_mutex);
+    connection->open_sessions.insert(session_id);
+    transports.at(i) = std::make_unique<detail::MultiplexedTransport>(
+        connection, session_id, connection->GetQueue(session_id));
+  }
+  return transports;
+}
+
+std::size_t TransportMultiplexer::GetNumberOfOpenSessions() const {
+  for (const auto& connection : connections_) {
+    if (!connection) continue;
+    std::scoped_lock lock(connection->sessions_mutex);
+    return connection->open_sessions.size();
+  }
+  return 0;
+}
+
+}  // namespace encrypto::motion::communication
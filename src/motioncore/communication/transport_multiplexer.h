@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "transport.h"
+
+namespace encrypto::motion::communication {
+
+namespace detail {
+
+struct MultiplexedConnection;
+
+}  // namespace detail
+
+// Multiplexes several concurrent sessions over the connections to the other parties, e.g., the
+// CommunicationLayers of Party instances that evaluate independent circuits at the same time, s.t.
+// many small queries share the connections instead of each setting up its own.  Each message is
+// prefixed with the id of its session and one thread per connection routes the received messages
+// to their sessions.  The sessions with the same id on all parties communicate with each other and
+// messages of a session that was not opened yet are buffered until it is.
+class TransportMultiplexer {
+ public:
+  // takes the transports to the other parties, e.g., from TcpSetupHelper::SetupConnections
+  explicit TransportMultiplexer(std::vector<std::unique_ptr<Transport>>&& transports);
+
+  // closes the connections after the other parties closed theirs, s.t. the multiplexers of all
+  // parties need to be destroyed concurrently, see Party::Finish; all sessions need to be shut down
+  ~TransportMultiplexer();
+
+  TransportMultiplexer(const TransportMultiplexer&) = delete;
+
+  // Returns the transports of the session with id session_id, which may be passed to a
+  // CommunicationLayer.  Sessions must not send empty messages since they mark the end of a
+  // session.  The id may be reused after the session was shut down on all parties.
+  // Throws a std::logic_error if the session is already open.
+  std::vector<std::unique_ptr<Transport>> GetTransports(std::uint64_t session_id);
+
+  std::size_t GetNumberOfOpenSessions() const;
+
+ private:
+  std::vector<std::shared_ptr<detail::MultiplexedConnection>> connections_;
+};
+
+}  // namespace encrypto::motion::communication
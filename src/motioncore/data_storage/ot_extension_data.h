@@ -24,17 +24,21 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <span>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "statistics/memory_accounting.h"
 #include "utility/bit_matrix.h"
 #include "utility/bit_vector.h"
 #include "utility/block.h"
@@ -44,26 +48,128 @@ namespace encrypto::motion {
 class FiberCondition;
 class Logger;
 
+// Outputs of the OT extension, one BitVector per OT, which are stored in blocks of kBlockSize OTs.
+// A block is freed once the OTs of all of its outputs were released by their consumers, see
+// OtVector, and allocated anew if the OTs are extended again for another run.
+class OtOutputs {
+ public:
+  // number of OTs whose outputs are allocated and freed together
+  static constexpr std::size_t kBlockSize{std::size_t(1) << 14};
+
+  std::size_t GetSize() const noexcept { return size_; }
+
+  // makes space for the OTs up to size, which are registered before the OTs are extended
+  void Resize(std::size_t size) {
+    size_ = std::max(size_, size);
+    while (blocks_.size() * kBlockSize < size_) blocks_.emplace_back();
+  }
+
+  BitVector<>& operator[](std::size_t i) { return blocks_[i / kBlockSize].outputs[i % kBlockSize]; }
+
+  const BitVector<>& operator[](std::size_t i) const {
+    return blocks_[i / kBlockSize].outputs[i % kBlockSize];
+  }
+
+  // throws std::out_of_range if the output of OT i was released or was never extended
+  BitVector<>& at(std::size_t i) {
+    if (i >= size_ || blocks_[i / kBlockSize].outputs.size() <= i % kBlockSize) {
+      throw std::out_of_range("The output of the OT is not available");
+    }
+    return (*this)[i];
+  }
+
+  const BitVector<>& at(std::size_t i) const { return const_cast<OtOutputs&>(*this).at(i); }
+
+  // moves outputs to the OTs begin, begin + 1, ..., the blocks of the OTs are allocated if needed
+  // and need to be released again before they are freed
+  void Assign(std::size_t begin, std::span<BitVector<>> outputs) {
+    const std::size_t end{begin + outputs.size()};
+    for (std::size_t block_i = begin / kBlockSize; block_i * kBlockSize < end; ++block_i) {
+      auto& block{blocks_[block_i]};
+      const std::size_t block_size{std::min(kBlockSize, size_ - block_i * kBlockSize)};
+      if (block.outputs.size() < block_size) block.outputs.resize(block_size);
+      block.number_of_unreleased_ots.store(block_size, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+      auto& block{blocks_[(begin + i) / kBlockSize]};
+      auto& output{block.outputs[(begin + i) % kBlockSize]};
+      block.number_of_bytes += outputs[i].GetData().size();
+      block.number_of_bytes -= output.GetData().size();
+      number_of_bytes_.fetch_add(outputs[i].GetData().size(), std::memory_order_relaxed);
+      number_of_bytes_.fetch_sub(output.GetData().size(), std::memory_order_relaxed);
+      output = std::move(outputs[i]);
+    }
+  }
+
+  // marks the outputs of the OTs begin, ..., begin + number_of_ots - 1 as read in this run and
+  // frees the blocks whose OTs were all released, returns whether a block was freed
+  bool Release(std::size_t begin, std::size_t number_of_ots) {
+    if (number_of_ots == 0) return false;
+    const std::size_t end{begin + number_of_ots};
+    bool freed{false};
+    for (std::size_t block_i = begin / kBlockSize; block_i * kBlockSize < end; ++block_i) {
+      auto& block{blocks_[block_i]};
+      const std::size_t released{std::min(end, (block_i + 1) * kBlockSize) -
+                                 std::max(begin, block_i * kBlockSize)};
+      if (block.number_of_unreleased_ots.fetch_sub(released, std::memory_order_acq_rel) ==
+          released) {
+        number_of_bytes_.fetch_sub(block.number_of_bytes, std::memory_order_relaxed);
+        block.number_of_bytes = 0;
+        block.outputs = std::vector<BitVector<>>();
+        freed = true;
+      }
+    }
+    return freed;
+  }
+
+  // bytes of the outputs that were not freed
+  std::size_t GetNumberOfBytes() const noexcept {
+    return number_of_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Block {
+    std::vector<BitVector<>> outputs;
+    std::atomic<std::size_t> number_of_unreleased_ots{0};
+    std::size_t number_of_bytes{0};
+  };
+
+  std::size_t size_{0};
+  // a deque, s.t. the blocks with their atomic counters stay in place
+  std::deque<Block> blocks_;
+  std::atomic<std::size_t> number_of_bytes_{0};
+};
+
 struct OtExtensionReceiverData : public FiberSetupWaitable {
   OtExtensionReceiverData() = default;
   ~OtExtensionReceiverData() = default;
 
-  // matrix of the OT extension scheme
-  // XXX: can't we delete this after setup?
-  std::shared_ptr<BitMatrix> T;
-
-  // if many OTs are received in batches, it is not necessary to store all of the flags
-  // for received messages but only for the first OT id in the batch. Thus, use a hash table.
-  std::vector<BitVector<>> outputs;
+  // random receiver outputs, which are freed once they were read, see OtVector
+  OtOutputs outputs;
 
   // bit length of every OT
   std::vector<std::size_t> bitlengths;
 
+  // marks the 1-bit OTs, e.g., of XcOtBitReceiver, whose outputs are only stored in output_bits
+  BitVector<> packed;
+  BitVector<> output_bits;
+
   // random choices from OT precomputation
   std::unique_ptr<AlignedBitVector> random_choices;
 
+  // confirmations of the sender that it processed a chunk of masks, see OtExtensionData::chunk_size
+  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> chunk_acknowledgement_futures;
+
   // XXX: unused
   std::atomic<std::size_t> consumed_offset{0};
+
+  // bytes of the outputs and the random choices
+  MemoryAccount memory_account{MemorySubsystem::kOtExtension};
+
+  void UpdateMemoryAccount() {
+    memory_account.Set(outputs.GetNumberOfBytes() + output_bits.GetData().size() +
+                       (random_choices ? random_choices->GetData().size() : 0));
+  }
 };
 
 struct OtExtensionSenderData : public FiberSetupWaitable {
@@ -73,27 +179,50 @@ struct OtExtensionSenderData : public FiberSetupWaitable {
   // width of the bit matrix
   std::atomic<std::size_t> bit_size{0};
 
-  std::array<ReusableFiberFuture<std::vector<std::uint8_t>>, 128> u_futures;
-  // XXX: can't we delete this after setup?
-  std::shared_ptr<BitMatrix> V;
+  // masks of the receiver, 128 per chunk of the matrix
+  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> u_futures;
 
-  // random sender outputs
-  // XXX: why not aligned?
-  std::vector<BitVector<>> y0, y1;
+  // random sender outputs, which are freed once they were read, see OtVector
+  OtOutputs y0, y1;
 
   // bit length of every OT
   std::vector<std::size_t> bitlengths;
 
+  // marks the 1-bit OTs, e.g., of XcOtBitSender, whose outputs are only stored in y0_bits and
+  // y1_bits instead of a BitVector per OT in y0 and y1
+  BitVector<> packed;
+  BitVector<> y0_bits, y1_bits;
+
   // XXX: unused
   std::atomic<std::size_t> consumed_offset{0};
+
+  // bytes of the outputs
+  MemoryAccount memory_account{MemorySubsystem::kOtExtension};
+
+  void UpdateMemoryAccount() {
+    memory_account.Set(y0.GetNumberOfBytes() + y1.GetNumberOfBytes() +
+                       y0_bits.GetData().size() + y1_bits.GetData().size());
+  }
 };
 
+// number of OTs extended at once if not set otherwise, s.t. the matrix and the masks of a chunk
+// take 16 MiB each
+constexpr std::size_t kDefaultOtExtensionChunkSize{std::size_t(1) << 20};
+
 struct OtExtensionData {
+  // sends a message whose payload is written from its own buffer, see
+  // communication::CommunicationLayer::SendMessage
+  using SendPayloadFunction =
+      std::function<void(communication::MessageType, std::size_t, std::span<const std::uint8_t>,
+                         std::shared_ptr<const void>)>;
+
   OtExtensionData(std::size_t party_id,
                   std::function<void(flatbuffers::FlatBufferBuilder&&)> send_function,
+                  SendPayloadFunction send_payload_function,
                   communication::MessageManager& message_manager, std::shared_ptr<Logger> logger)
       : party_id(party_id),
         send_function(send_function),
+        send_payload_function(send_payload_function),
         message_manager(message_manager),
         logger(logger) {}
 
@@ -105,7 +234,19 @@ struct OtExtensionData {
 
   std::size_t party_id{std::numeric_limits<std::size_t>::max()};
   std::size_t base_ot_offset{std::numeric_limits<std::size_t>::max()};
+  // number of times the OTs were extended anew for another run of a compiled circuit, see
+  // OtProviderFromOtExtension::Clear
+  std::size_t run{0};
+  // expand large numbers of OTs with the silent OT extension, see
+  // oblivious_transfer/silent_ot/silent_ot_extension.h
+  bool use_silent_ot_extension{false};
+  // number of OTs whose matrix columns are extended and transposed at once, which bounds the
+  // memory needed besides the outputs, a multiple of 128
+  std::size_t chunk_size{kDefaultOtExtensionChunkSize};
+  // number of threads expanding the rows and transposing the blocks of the matrix
+  std::size_t number_of_threads{1};
   std::function<void(flatbuffers::FlatBufferBuilder&&)> send_function;
+  SendPayloadFunction send_payload_function;
   communication::MessageManager& message_manager;
   std::shared_ptr<Logger> logger;
 };
@@ -22,22 +22,191 @@
 
 #include "gate_executor.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/compiled_circuit.h"
+#include "base/configuration.h"
 #include "base/register.h"
 #include "protocols/gate.h"
+#include "protocols/wire.h"
 #include "statistics/run_time_statistics.h"
+#include "statistics/trace.h"
+#include "utility/fiber_condition.h"
 #include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/logger.h"
 
 namespace encrypto::motion {
 
 GateExecutor::GateExecutor(Register& reg, std::function<void(void)> presetup_function,
-                           std::shared_ptr<Logger> logger)
+                           std::shared_ptr<Logger> logger,
+                           std::shared_ptr<const Configuration> configuration)
     : register_(reg),
       presetup_function_(std::move(presetup_function)),
-      logger_(std::move(logger)) {}
+      logger_(std::move(logger)),
+      configuration_(std::move(configuration)) {}
+
+GateExecutor::~GateExecutor() = default;
+
+FiberTaskGroup& GateExecutor::GetFiberPool() {
+  if (shared_fiber_pool_) {
+    return *fiber_tasks_;
+  }
+  FiberPoolOptions options;
+  if (configuration_) {
+    options = {configuration_->GetNumberOfWorkerThreads(),
+               configuration_->GetWorkerThreadAffinity(), configuration_->GetNumaAwareStealing(),
+               configuration_->GetFiberStackSize()};
+  }
+  if (!fiber_pool_ || options != fiber_pool_options_) {
+    // join the old pool before its workers are replaced
+    std::scoped_lock lock(fiber_pool_mutex_);
+    fiber_tasks_.reset();
+    fiber_pool_.reset();
+    const auto& [number_of_workers, cpus, numa_aware_stealing, stack_size] = options;
+    fiber_pool_ = std::make_shared<FiberThreadPool>(number_of_workers, 0, true, cpus,
+                                                    numa_aware_stealing, stack_size);
+    fiber_tasks_ = std::make_unique<FiberTaskGroup>(*fiber_pool_);
+    fiber_pool_options_ = std::move(options);
+  }
+  return *fiber_tasks_;
+}
+
+void GateExecutor::SetFiberPool(std::shared_ptr<FiberThreadPool> fiber_pool) {
+  std::scoped_lock lock(fiber_pool_mutex_);
+  fiber_tasks_.reset();
+  fiber_pool_ = std::move(fiber_pool);
+  shared_fiber_pool_ = fiber_pool_ != nullptr;
+  if (shared_fiber_pool_) {
+    fiber_tasks_ = std::make_unique<FiberTaskGroup>(*fiber_pool_);
+  }
+}
+
+GateExecutor::FiberPoolStatistics GateExecutor::GetFiberPoolStatistics() {
+  std::scoped_lock lock(fiber_pool_mutex_);
+  if (!fiber_tasks_) {
+    return {};
+  }
+  return {fiber_tasks_->get_number_of_workers(), fiber_tasks_->get_number_of_pending_tasks()};
+}
+
+bool GateExecutor::IsInSetupPipeline(const Gate& gate) const {
+  return setup_pipeline_ && gate.NeedsSetup() && gate.HasIndependentSetup();
+}
+
+std::future<void> GateExecutor::StartSetupPipeline() {
+  setup_pipeline_ = configuration_ && configuration_->GetSetupPipeline();
+  if (!setup_pipeline_) {
+    return {};
+  }
+  // the gates are registered after the gates producing their parents, s.t. the pipeline never
+  // waits for a setup phase that has not been started yet
+  return std::async(std::launch::async, [this] {
+    std::size_t number_of_gates{0};
+    for (auto& gate : register_.GetGates()) {
+      if (IsInSetupPipeline(*gate)) {
+        EvaluateSetupPhase(*gate);
+        gate->SetSetupIsReady();
+        register_.IncrementEvaluatedGatesSetupCounter();
+        ++number_of_gates;
+      }
+    }
+    if (logger_) {
+      logger_->LogDebug("Finished the setup pipeline of {} gates", number_of_gates);
+    }
+  });
+}
+
+void GateExecutor::StartGateStatistics(RunTimeStatistics& statistics) {
+  gate_statistics_ = configuration_ && configuration_->GetGateStatistics();
+  gate_layers_.clear();
+  if (!gate_statistics_) {
+    return;
+  }
+  const auto& layers{register_.GetGateLayers()};
+  for (std::size_t layer = 0; layer < layers.size(); ++layer) {
+    for (const auto gate : layers[layer]) gate_layers_.emplace(gate, layer);
+  }
+  statistics.layer_statistics.resize(layers.size());
+}
+
+std::size_t GateExecutor::GetTracedPartyId() const {
+  return configuration_ ? configuration_->GetMyId() : Tracer::kUnknownParty;
+}
+
+void GateExecutor::EvaluateSetupPhase(Gate& gate) {
+  if (!Tracer::IsEnabled() || !gate.NeedsSetup()) {
+    gate.EvaluateSetup();
+    return;
+  }
+  Tracer::SetThreadPartyId(GetTracedPartyId());
+  const auto start{Tracer::ClockType::now()};
+  {
+    Tracer::FiberGateScope scope(gate.GetId());
+    gate.EvaluateSetup();
+  }
+  Tracer::Get().RecordGate(Tracer::Category::kGateSetup, typeid(gate), gate.GetId(),
+                           GetTracedPartyId(), start, Tracer::ClockType::now());
+}
+
+void GateExecutor::EvaluateOnline(Gate& gate, RunTimeStatistics& statistics) {
+  const bool tracing{Tracer::IsEnabled()};
+  if ((!gate_statistics_ && !tracing) || !gate.NeedsOnline()) {
+    gate.EvaluateOnline();
+    gate.SetOnlineIsReady();
+    return;
+  }
+  using ClockType = RunTimeStatistics::ClockType;
+  if (tracing) Tracer::SetThreadPartyId(GetTracedPartyId());
+  // waiting for the inputs ahead of the online phase separates the time the gate is blocked by its
+  // parents from the time of its own computation and communication
+  const auto start{ClockType::now()};
+  for (const auto& wire : gate.GetParentWires()) wire->GetIsReadyCondition().Wait();
+  const auto inputs_ready{ClockType::now()};
+  // the remaining fiber waits of the gate are for messages and preprocessed material
+  std::optional<Tracer::FiberGateScope> scope;
+  if (tracing) scope.emplace(gate.GetId());
+  gate.EvaluateOnline();
+  const auto end{ClockType::now()};
+  scope.reset();
+  if (tracing) {
+    Tracer::Get().RecordGate(Tracer::Category::kGateOnline, typeid(gate), gate.GetId(),
+                             GetTracedPartyId(), inputs_ready, end);
+  }
+  if (gate_statistics_) {
+    const auto number_of_bytes{gate.GetOnlineCost().number_of_bytes_per_party};
+    std::scoped_lock lock(gate_statistics_mutex_);
+    statistics.gate_statistics[GetGateClassName(gate)].Add(end - inputs_ready, inputs_ready - start,
+                                                           number_of_bytes);
+    if (auto layer{gate_layers_.find(&gate)}; layer != gate_layers_.end()) {
+      statistics.layer_statistics.at(layer->second)
+          .Add(end - inputs_ready, inputs_ready - start, number_of_bytes);
+    }
+  }
+  gate.SetOnlineIsReady();
+}
+
+void GateExecutor::EvaluateSetup(Gate& gate) {
+  if (IsInSetupPipeline(gate)) {
+    gate.WaitSetup();
+  } else {
+    EvaluateSetupPhase(gate);
+    gate.SetSetupIsReady();
+    if (gate.NeedsSetup()) {
+      register_.IncrementEvaluatedGatesSetupCounter();
+    }
+  }
+}
 
 void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartGateStatistics(statistics);
 
   presetup_function_();
 
@@ -46,9 +215,8 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
         "Start evaluating the circuit gates sequentially (online after all finished setup)");
   }
 
-  // create a pool with std::thread::hardware_concurrency() no. of threads
-  // to execute fibers
-  FiberThreadPool fiber_pool(0, 2 * register_.GetTotalNumberOfGates());
+  // the pool with the configured no. of threads to execute fibers, which is kept across runs
+  auto& fiber_pool{GetFiberPool()};
 
   // ------------------------------ setup phase ------------------------------
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kGatesSetup>();
@@ -57,7 +225,7 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
   for (auto& gate : register_.GetGates()) {
     if (gate->NeedsSetup()) {
       fiber_pool.post([&] {
-        gate->EvaluateSetup();
+        EvaluateSetupPhase(*gate);
         gate->SetSetupIsReady();
         register_.IncrementEvaluatedGatesSetupCounter();
       });
@@ -80,8 +248,7 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
   for (auto& gate : register_.GetGates()) {
     if (gate->NeedsOnline()) {
       fiber_pool.post([&] {
-        gate->EvaluateOnline();
-        gate->SetOnlineIsReady();
+        EvaluateOnline(*gate, statistics);
         register_.IncrementEvaluatedGatesOnlineCounter();
       });
     } else {
@@ -98,7 +265,7 @@ void GateExecutor::EvaluateSetupOnline(RunTimeStatistics& statistics) {
 
   // --------------------------------------------------------------------------
 
-  fiber_pool.join();
+  fiber_pool.wait_idle();
 
   statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
 }
@@ -108,27 +275,23 @@ void GateExecutor::Evaluate(RunTimeStatistics& statistics) {
       "Start evaluating the circuit gates in parallel (online as soon as some finished setup)");
 
   statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartGateStatistics(statistics);
 
   // Run preprocessing setup in a separate thread
   auto preprocessing_future = std::async(std::launch::async, [this] { presetup_function_(); });
+  auto setup_pipeline_future = StartSetupPipeline();
 
-  // create a pool with std::thread::hardware_concurrency() no. of threads
-  // to execute fibers
-  FiberThreadPool fiber_pool(0, register_.GetTotalNumberOfGates());
+  // the pool with the configured no. of threads to execute fibers, which is kept across runs
+  auto& fiber_pool{GetFiberPool()};
 
   // Evaluate all the gates
   for (auto& gate : register_.GetGates()) {
     if (gate->NeedsSetup() || gate->NeedsOnline()) {
       fiber_pool.post([&] {
-        gate->EvaluateSetup();
-        gate->SetSetupIsReady();
-        if (gate->NeedsSetup()) {
-          register_.IncrementEvaluatedGatesSetupCounter();
-        }
+        EvaluateSetup(*gate);
 
         // XXX: maybe insert a 'yield' here?
-        gate->EvaluateOnline();
-        gate->SetOnlineIsReady();
+        EvaluateOnline(*gate, statistics);
         if (gate->NeedsOnline()) {
           register_.IncrementEvaluatedGatesOnlineCounter();
         }
@@ -141,11 +304,259 @@ void GateExecutor::Evaluate(RunTimeStatistics& statistics) {
   }
 
   preprocessing_future.get();
+  if (setup_pipeline_future.valid()) setup_pipeline_future.get();
+
+  // we have to wait until all gates are evaluated before we close the pool
+  register_.CheckOnlineCondition();
+  register_.GetGatesOnlineDoneCondition()->Wait();
+  fiber_pool.wait_idle();
+
+  statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
+}
+
+void GateExecutor::EvaluateLayered(RunTimeStatistics& statistics) {
+  register_.SortGateLayersByLocality();
+  const auto& layers = register_.GetGateLayers();
+  const auto& unlayered_gates = register_.GetUnlayeredGates();
+
+  if (logger_) {
+    logger_->LogInfo("Start evaluating the circuit gates layer by layer ({} layers)",
+                     layers.size());
+  }
+
+  statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartGateStatistics(statistics);
+
+  // Run preprocessing setup in a separate thread
+  auto preprocessing_future = std::async(std::launch::async, [this] { presetup_function_(); });
+  auto setup_pipeline_future = StartSetupPipeline();
+
+  // only the gates of one layer and the unlayered gates are in the pool simultaneously
+  auto& fiber_pool{GetFiberPool()};
+
+  auto evaluate_gate = [this, &statistics](Gate& gate) {
+    EvaluateSetup(gate);
+    EvaluateOnline(gate, statistics);
+    if (gate.NeedsOnline()) {
+      register_.IncrementEvaluatedGatesOnlineCounter();
+    }
+  };
+
+  // Unlayered gates wait for wires that are set by other gates during their evaluation, so they
+  // are started right away and finish whenever the corresponding layer has been evaluated.
+  for (auto& gate : unlayered_gates) {
+    if (gate->NeedsSetup() || gate->NeedsOnline()) {
+      fiber_pool.post([&] { evaluate_gate(*gate); });
+    } else {
+      gate->SetSetupIsReady();
+      gate->SetOnlineIsReady();
+    }
+  }
+
+  std::size_t number_of_pending_gates = 0;
+  FiberCondition layer_done_condition([&number_of_pending_gates] {
+    return number_of_pending_gates == 0;
+  });
+
+  for (const auto& layer : layers) {
+    {
+      std::scoped_lock lock(layer_done_condition.GetMutex());
+      number_of_pending_gates = layer.size();
+    }
+    for (auto& gate : layer) {
+      if (gate->NeedsSetup() || gate->NeedsOnline()) {
+        fiber_pool.post([&] {
+          evaluate_gate(*gate);
+          {
+            std::scoped_lock lock(layer_done_condition.GetMutex());
+            --number_of_pending_gates;
+          }
+          layer_done_condition.NotifyAll();
+        });
+      } else {
+        // cannot be done earlier because output wires did not yet exist
+        gate->SetSetupIsReady();
+        gate->SetOnlineIsReady();
+        std::scoped_lock lock(layer_done_condition.GetMutex());
+        --number_of_pending_gates;
+      }
+    }
+    layer_done_condition.Wait();
+  }
+
+  preprocessing_future.get();
+  if (setup_pipeline_future.valid()) setup_pipeline_future.get();
 
   // we have to wait until all gates are evaluated before we close the pool
+  register_.CheckSetupCondition();
   register_.CheckOnlineCondition();
   register_.GetGatesOnlineDoneCondition()->Wait();
-  fiber_pool.join();
+  fiber_pool.wait_idle();
+
+  statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
+}
+
+void GateExecutor::EvaluateDataflow(RunTimeStatistics& statistics) {
+  EvaluateDataflow(CompiledCircuit(register_), statistics);
+}
+
+void GateExecutor::EvaluateDataflow(const CompiledCircuit& circuit,
+                                    RunTimeStatistics& statistics) {
+  const std::size_t number_of_gates{circuit.GetNumberOfGates()};
+  if (number_of_gates != register_.GetTotalNumberOfGates()) {
+    throw std::logic_error(
+        fmt::format("The circuit was compiled with {} gates, but the register contains {} gates",
+                    number_of_gates, register_.GetTotalNumberOfGates()));
+  }
+
+  const bool skip_dead_gates{configuration_ && configuration_->GetDeadGateElimination()};
+
+  if (logger_) {
+    logger_->LogInfo("Start evaluating the circuit gates in dataflow order ({} gates)",
+                     number_of_gates);
+    if (skip_dead_gates) {
+      logger_->LogInfo("Skipping {} gates that do not contribute to any output",
+                       number_of_gates - circuit.GetNumberOfLiveGates());
+    }
+  }
+
+  statistics.RecordStart<RunTimeStatistics::StatisticsId::kEvaluate>();
+  StartGateStatistics(statistics);
+
+  // Run preprocessing setup in a separate thread
+  auto preprocessing_future = std::async(std::launch::async, [this] { presetup_function_(); });
+  auto setup_pipeline_future = StartSetupPipeline();
+
+  // every gate is posted exactly once; posting from a worker fiber only suspends the fiber while
+  // the task queue is full
+  auto& fiber_pool{GetFiberPool()};
+
+  std::vector<std::atomic<std::size_t>> number_of_pending_parents(number_of_gates);
+  for (std::size_t i = 0; i < number_of_gates; ++i) {
+    number_of_pending_parents[i].store(circuit.GetFanIn(i).size(), std::memory_order_relaxed);
+  }
+
+  // gates that only read wires from outside of the gate graph, in ascending order
+  std::vector<std::size_t> root_gates;
+  for (std::size_t i = 0; i < number_of_gates; ++i) {
+    if (circuit.GetFanIn(i).empty()) {
+      root_gates.push_back(i);
+    }
+  }
+
+  // if the number of instances in flight is limited, the root gates of an instance are started
+  // once all gates of the instance that many places before it are finished
+  const std::size_t number_of_instances{circuit.GetNumberOfInstances()};
+  const std::size_t number_of_instances_in_flight{circuit.GetNumberOfInstancesInFlight()};
+  std::vector<std::atomic<std::size_t>> number_of_pending_gates(
+      number_of_instances_in_flight > 0 ? number_of_instances : 0);
+  for (std::size_t i = 0; i < number_of_pending_gates.size(); ++i) {
+    const auto instance_size{circuit.GetInstanceOffset(i + 1) - circuit.GetInstanceOffset(i)};
+    number_of_pending_gates[i].store(instance_size, std::memory_order_relaxed);
+  }
+  auto add_root_gates = [&](std::size_t instance, std::vector<std::size_t>& ready_gates) {
+    auto first{std::lower_bound(root_gates.begin(), root_gates.end(),
+                                circuit.GetInstanceOffset(instance))};
+    auto last{std::lower_bound(first, root_gates.end(), circuit.GetInstanceOffset(instance + 1))};
+    ready_gates.insert(ready_gates.end(), first, last);
+  };
+
+  // collects the children and, possibly, the root gates of the next instance that become ready
+  // after the gate with the given index has been finished
+  auto finish_gate = [&](std::size_t gate_index, std::vector<std::size_t>& ready_gates) {
+    for (auto child : circuit.GetFanOut(gate_index)) {
+      if (number_of_pending_parents[child].fetch_sub(1) == 1) {
+        ready_gates.push_back(child);
+      }
+    }
+    if (number_of_instances_in_flight > 0) {
+      const auto instance{circuit.GetInstance(gate_index)};
+      if (number_of_pending_gates[instance].fetch_sub(1) == 1 &&
+          instance + number_of_instances_in_flight < number_of_instances) {
+        add_root_gates(instance + number_of_instances_in_flight, ready_gates);
+      }
+    }
+  };
+
+  // evaluates the gate with the given index in the calling thread or fiber
+  auto evaluate_gate = [&](std::size_t gate_index) {
+    auto& gate{circuit.GetGate(gate_index)};
+    EvaluateSetup(gate);
+    EvaluateOnline(gate, statistics);
+    if (gate.NeedsOnline()) {
+      register_.IncrementEvaluatedGatesOnlineCounter();
+    }
+  };
+
+  // posts the given gates and those of their descendants that become ready without communication,
+  // using an explicit stack instead of a recursion to stay within the small fiber stacks.  Local
+  // gates are evaluated inline since their parents are finished and, thus, they never block, which
+  // saves a fiber per gate in chains of, e.g., XOR or addition gates
+  std::function<void(std::vector<std::size_t>)> release_gates =
+      [&](std::vector<std::size_t> ready_gates) {
+        while (!ready_gates.empty()) {
+          const auto index{ready_gates.back()};
+          ready_gates.pop_back();
+          auto& gate{circuit.GetGate(index)};
+          if (skip_dead_gates && !circuit.IsLive(index)) {
+            // the gate and all of its descendants are dead, none of them is evaluated, apart from
+            // the setup phases in the pipeline
+            if (IsInSetupPipeline(gate)) {
+              gate.WaitSetup();
+            } else {
+              gate.SetSetupIsReady();
+              if (gate.NeedsSetup()) {
+                register_.IncrementEvaluatedGatesSetupCounter();
+              }
+            }
+            gate.SetOnlineIsReady();
+            if (gate.NeedsOnline()) {
+              register_.IncrementEvaluatedGatesOnlineCounter();
+            }
+            finish_gate(index, ready_gates);
+          } else if (gate.IsLocal()) {
+            evaluate_gate(index);
+            finish_gate(index, ready_gates);
+          } else if (gate.NeedsSetup() || gate.NeedsOnline()) {
+            fiber_pool.post([&, index] {
+              evaluate_gate(index);
+              std::vector<std::size_t> next_gates;
+              finish_gate(index, next_gates);
+              if (!next_gates.empty()) {
+                release_gates(std::move(next_gates));
+              }
+            });
+          } else {
+            // cannot be done earlier because output wires did not yet exist
+            gate.SetSetupIsReady();
+            gate.SetOnlineIsReady();
+            finish_gate(index, ready_gates);
+          }
+        }
+      };
+
+  // start the root gates of the first instances, reversed s.t. the earliest gates are popped from
+  // the stack and posted first
+  std::vector<std::size_t> initial_gates;
+  if (number_of_instances_in_flight > 0) {
+    for (std::size_t instance = 0; instance < number_of_instances_in_flight; ++instance) {
+      add_root_gates(instance, initial_gates);
+    }
+  } else {
+    initial_gates = root_gates;
+  }
+  std::reverse(initial_gates.begin(), initial_gates.end());
+  release_gates(std::move(initial_gates));
+
+  preprocessing_future.get();
+  if (setup_pipeline_future.valid()) setup_pipeline_future.get();
+
+  // we have to wait until all gates are evaluated before we close the pool
+  register_.CheckSetupCondition();
+  register_.CheckOnlineCondition();
+  register_.GetGatesSetupDoneCondition()->Wait();
+  register_.GetGatesOnlineDoneCondition()->Wait();
+  fiber_pool.wait_idle();
 
   statistics.RecordEnd<RunTimeStatistics::StatisticsId::kEvaluate>();
 }
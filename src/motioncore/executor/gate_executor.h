@@ -23,33 +23,128 @@
 #pragma once
 
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace encrypto::motion {
 
 struct RunTimeStatistics;
 
+class CompiledCircuit;
+class Configuration;
+class FiberTaskGroup;
+class FiberThreadPool;
+class Gate;
 class Logger;
 class Register;
 
 // Evaluates all registered gates.
 class GateExecutor {
  public:
-  GateExecutor(Register&, std::function<void()> presetup_function, std::shared_ptr<Logger>);
+  GateExecutor(Register&, std::function<void()> presetup_function, std::shared_ptr<Logger>,
+               std::shared_ptr<const Configuration> configuration = nullptr);
+
+  ~GateExecutor();
 
   // Run the setup phases first for all gates before starting with the online
   // phases.
   void EvaluateSetupOnline(RunTimeStatistics& statistics);
   // Run setup and online phase of each gate as soon as possible.
   void Evaluate(RunTimeStatistics& statistics);
+  // Run the gates layer by layer, i.e., all gates of a depth layer are evaluated concurrently and
+  // the next layer is started after the previous one has been completed.  Only the gates of a
+  // single layer are alive as fibers at the same time.
+  void EvaluateLayered(RunTimeStatistics& statistics);
+  // Run the gates in dataflow order, i.e., each gate counts its unfinished parents and is posted
+  // to the work-stealing fiber pool as soon as all gates of its fan-in have been evaluated.  The
+  // gates thus never suspend waiting for their input wires.
+  void EvaluateDataflow(RunTimeStatistics& statistics);
+  // Same as above for a circuit compiled ahead of time.  If the circuit limits the number of its
+  // instances in flight, the gates of an instance are started only after all gates of the
+  // instance that many places before it have been evaluated.
+  void EvaluateDataflow(const CompiledCircuit& circuit, RunTimeStatistics& statistics);
+
+  struct FiberPoolStatistics {
+    std::size_t number_of_workers{0};
+    // posted gates of this executor that have not finished yet, including the ones blocked in a
+    // fiber
+    std::size_t number_of_pending_tasks{0};
+  };
+
+  // Current load of the fiber pool, which is empty before the first evaluation.  May be called
+  // concurrently with an evaluation.
+  FiberPoolStatistics GetFiberPoolStatistics();
+
+  // Evaluates the gates in the given fiber pool, which may be shared with the executors of other
+  // parties, e.g., to simulate several parties in one process without oversubscribing the machine.
+  // The thread options of the configuration are ignored then.  nullptr returns to a pool of this
+  // executor.  Must not be called during an evaluation.
+  void SetFiberPool(std::shared_ptr<FiberThreadPool> fiber_pool);
 
  private:
+  // Returns the tasks of this executor in the fiber pool, which is created on first use and kept
+  // for later evaluations, also after Register::Reset, unless the thread options of the
+  // configuration have changed.
+  FiberTaskGroup& GetFiberPool();
+
+  // Starts evaluating the setup phases of all gates with Gate::HasIndependentSetup in circuit order
+  // in a thread of their own if Configuration::GetSetupPipeline is set.  The returned future is
+  // invalid otherwise.
+  std::future<void> StartSetupPipeline();
+
+  // Evaluates the setup phase of the gate, or waits for it if the setup pipeline evaluates it.
+  void EvaluateSetup(Gate& gate);
+
+  bool IsInSetupPipeline(const Gate& gate) const;
+
+  // Reads Configuration::GetGateStatistics at the start of an evaluation and maps the gates to
+  // their layers, see Register::GetGateLayers.
+  void StartGateStatistics(RunTimeStatistics& statistics);
+
+  // Evaluates the online phase of the gate and sets it ready.  If gate statistics or the Tracer are
+  // enabled, the gate first waits for its input wires and then records the durations in statistics
+  // or the Tracer.
+  void EvaluateOnline(Gate& gate, RunTimeStatistics& statistics);
+
+  // Evaluates the setup phase of the gate, which is recorded in the Tracer if it is enabled.
+  void EvaluateSetupPhase(Gate& gate);
+
+  // this party's id in the trace, see Tracer::SetThreadPartyId
+  std::size_t GetTracedPartyId() const;
+
   Register& register_;
   // Presetup function is run prior to the setup function and is used to provide information about
   // objects that will be used in the setup phase, eg a multiplication triple registers an
   // oblivious transfer object and an OT provider registers base OT objects.
   std::function<void()> presetup_function_;
   std::shared_ptr<Logger> logger_;
+  // Number of workers, CPU pinning and NUMA-aware stealing of the fiber pool, uses the defaults of
+  // FiberThreadPool if nullptr.
+  std::shared_ptr<const Configuration> configuration_;
+
+  // number of workers, CPUs, NUMA-aware stealing and stack size
+  using FiberPoolOptions = std::tuple<std::size_t, std::vector<std::size_t>, bool, std::size_t>;
+  FiberPoolOptions fiber_pool_options_;
+  std::shared_ptr<FiberThreadPool> fiber_pool_;
+  // set by SetFiberPool
+  bool shared_fiber_pool_{false};
+  // the tasks of this executor in fiber_pool_, s.t. it only waits for its own gates
+  std::unique_ptr<FiberTaskGroup> fiber_tasks_;
+  // guards replacing fiber_pool_ against GetFiberPoolStatistics
+  std::mutex fiber_pool_mutex_;
+
+  // whether the setup pipeline runs in the current evaluation
+  bool setup_pipeline_{false};
+
+  // whether the gates of the current evaluation record their statistics, their layers, and the
+  // lock of the statistics, which are shared by all fibers
+  bool gate_statistics_{false};
+  std::unordered_map<const Gate*, std::size_t> gate_layers_;
+  std::mutex gate_statistics_mutex_;
 };
 
 }  // namespace encrypto::motion
@@ -24,7 +24,13 @@
 
 #include "mt_provider.h"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+
 #include "oblivious_transfer/ot_flavors.h"
+#include "paillier_mt_generator.h"
+#include "preprocessing_store.h"
 #include "statistics/run_time_statistics.h"
 #include "utility/constants.h"
 #include "utility/logger.h"
@@ -58,15 +64,99 @@ const BinaryMtVector& MtProvider::GetBinaryAll() const noexcept {
   return bit_mts_;
 }
 
+template <typename T>
+static void SaveMts(PreprocessingWriter& writer, const IntegerMtVector<T>& mts) {
+  writer.Write(mts.a);
+  writer.Write(mts.b);
+  writer.Write(mts.c);
+}
+
+template <typename T>
+static void LoadMts(PreprocessingReader& reader, IntegerMtVector<T>& mts,
+                    std::size_t number_of_mts) {
+  mts.a = reader.Read<T>(number_of_mts);
+  mts.b = reader.Read<T>(number_of_mts);
+  mts.c = reader.Read<T>(number_of_mts);
+}
+
+void MtProvider::Save(PreprocessingWriter& writer) const {
+  writer.Write(bit_mts_.a);
+  writer.Write(bit_mts_.b);
+  writer.Write(bit_mts_.c);
+  SaveMts(writer, mts8_);
+  SaveMts(writer, mts16_);
+  SaveMts(writer, mts32_);
+  SaveMts(writer, mts64_);
+}
+
+void MtProvider::Load(PreprocessingReader& reader) {
+  bit_mts_.a = reader.ReadBits(number_of_bit_mts_);
+  bit_mts_.b = reader.ReadBits(number_of_bit_mts_);
+  bit_mts_.c = reader.ReadBits(number_of_bit_mts_);
+  LoadMts(reader, mts8_, number_of_mts_8_);
+  LoadMts(reader, mts16_, number_of_mts_16_);
+  LoadMts(reader, mts32_, number_of_mts_32_);
+  LoadMts(reader, mts64_, number_of_mts_64_);
+  SetFinished();
+}
+
+void MtProvider::SetMts(BinaryMtVector&& bit_mts, IntegerMtVector<std::uint8_t>&& mts8,
+                        IntegerMtVector<std::uint16_t>&& mts16,
+                        IntegerMtVector<std::uint32_t>&& mts32,
+                        IntegerMtVector<std::uint64_t>&& mts64) {
+  if (bit_mts.a.GetSize() != number_of_bit_mts_ || mts8.a.size() != number_of_mts_8_ ||
+      mts16.a.size() != number_of_mts_16_ || mts32.a.size() != number_of_mts_32_ ||
+      mts64.a.size() != number_of_mts_64_) {
+    throw std::invalid_argument("Got a different number of MTs than requested");
+  }
+  bit_mts_ = std::move(bit_mts);
+  mts8_ = std::move(mts8);
+  mts16_ = std::move(mts16);
+  mts32_ = std::move(mts32);
+  mts64_ = std::move(mts64);
+  SetFinished();
+}
+
+void MtProvider::Clear() {
+  bit_mts_ = {};
+  mts8_ = {};
+  mts16_ = {};
+  mts32_ = {};
+  mts64_ = {};
+  memory_account_.Set(0);
+  std::scoped_lock lock(finished_condition_->GetMutex());
+  finished_ = false;
+  for (auto& number_of_ready_mts : number_of_ready_mts_) number_of_ready_mts = 0;
+}
+
+template <typename T>
+static std::size_t GetNumberOfBytes(const IntegerMtVector<T>& mts) {
+  return (mts.a.size() + mts.b.size() + mts.c.size()) * sizeof(T);
+}
+
+void MtProvider::SetFinished() {
+  memory_account_.Set(bit_mts_.a.GetData().size() + bit_mts_.b.GetData().size() +
+                      bit_mts_.c.GetData().size() + GetNumberOfBytes(mts8_) +
+                      GetNumberOfBytes(mts16_) + GetNumberOfBytes(mts32_) +
+                      GetNumberOfBytes(mts64_));
+  {
+    std::scoped_lock lock(finished_condition_->GetMutex());
+    finished_ = true;
+  }
+  finished_condition_->NotifyAll();
+}
+
 MtProvider::MtProvider(const std::size_t my_id, const std::size_t number_of_parties)
     : my_id_(my_id), number_of_parties_(number_of_parties) {
   finished_condition_ = std::make_shared<FiberCondition>([this]() { return finished_.load(); });
 }
 
-MtProviderFromOts::MtProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& ot_providers,
+MtProviderFromOts::MtProviderFromOts(communication::CommunicationLayer& communication_layer,
+                                     std::vector<std::unique_ptr<OtProvider>>& ot_providers,
                                      const std::size_t my_id, std::shared_ptr<Logger> logger,
                                      RunTimeStatistics& run_time_statistics)
     : MtProvider(my_id, ot_providers.size()),
+      communication_layer_(communication_layer),
       ot_providers_(ot_providers),
       ots_receiver_8_(number_of_parties_),
       ots_sender_8_(number_of_parties_),
@@ -83,6 +173,11 @@ MtProviderFromOts::MtProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& o
 
 MtProviderFromOts::~MtProviderFromOts() = default;
 
+void MtProviderFromOts::SetPaillierMts(bool value, std::size_t modulus_bit_length) {
+  use_paillier_ = value;
+  paillier_modulus_bit_length_ = modulus_bit_length;
+}
+
 void MtProviderFromOts::PreSetup() {
   if (!NeedMts()) {
     return;
@@ -112,42 +207,31 @@ void MtProviderFromOts::Setup() {
   }
   run_time_statistics_.RecordStart<RunTimeStatistics::StatisticsId::kMtSetup>();
 
+  const std::array<std::size_t, 4> number_of_mts{number_of_mts_8_, number_of_mts_16_,
+                                                 number_of_mts_32_, number_of_mts_64_};
+  for (std::size_t type = 0; type < number_of_mts.size(); ++type) {
+    const std::size_t number_of_batches{(number_of_mts[type] + kMaxBatchSize - 1) / kMaxBatchSize};
+    number_of_parsed_parties_[type].assign(number_of_batches, 0);
+    number_of_ready_batches_[type] = 0;
+  }
+  // the pipeline of a single other party runs in this thread
+  std::vector<std::future<void>> pipelines;
   for (auto i = 0ull; i < number_of_parties_; ++i) {
     if (i == my_id_) {
       continue;
     }
-    for (auto& ot : ots_sender_8_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint8_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_8_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_16_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint16_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_16_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_32_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint32_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_32_.at(i)) ot->SendCorrections();
-    for (auto& ot : ots_sender_64_.at(i)) {
-      dynamic_cast<AcOtSender<std::uint64_t>*>(ot.get())->SendMessages();
-    }
-    for (auto& ot : ots_receiver_64_.at(i)) ot->SendCorrections();
-
-    if (number_of_bit_mts_ > 0) {
-      assert(bit_ots_receiver_.at(i) != nullptr);
-      assert(bit_ots_sender_.at(i) != nullptr);
-      bit_ots_receiver_.at(i)->SendCorrections();
-      bit_ots_sender_.at(i)->SendMessages();
+    if (number_of_parties_ == 2) {
+      RunPipeline(i);
+    } else {
+      pipelines.emplace_back(std::async(std::launch::async, [this, i] { RunPipeline(i); }));
     }
   }
+  for (auto& pipeline : pipelines) pipeline.get();
 
-  ParseOutputs();
-  {
-    std::scoped_lock lock(finished_condition_->GetMutex());
-    finished_ = true;
+  if (paillier_mt_generator_) {
+    paillier_mt_generator_->AddCrossTerms(mts8_, mts16_, mts32_, mts64_);
   }
-
-  finished_condition_->NotifyAll();
+  SetFinished();
 
   run_time_statistics_.RecordEnd<RunTimeStatistics::StatisticsId::kMtSetup>();
   if constexpr (kDebug) {
@@ -174,11 +258,15 @@ static void GenerateRandomTriples(IntegerMtVector<T>& mts, std::size_t number_of
   }
 }
 
+// the OTs are registered in the first run and renewed for the later runs of a compiled circuit,
+// see Backend::Clear
 static void RegisterHelperBool(OtProvider& ot_provider, std::unique_ptr<XcOtBitSender>& ots_sender,
                                std::unique_ptr<XcOtBitReceiver>& ots_receiver,
                                const BinaryMtVector& bit_mts, std::size_t number_of_bit_mts) {
-  ots_sender = ot_provider.RegisterSendXcOtBit(number_of_bit_mts);
-  ots_receiver = ot_provider.RegisterReceiveXcOtBit(number_of_bit_mts);
+  if (!ots_sender) {
+    ots_sender = ot_provider.RegisterSendXcOtBit(number_of_bit_mts);
+    ots_receiver = ot_provider.RegisterReceiveXcOtBit(number_of_bit_mts);
+  }
 
   ots_sender->SetCorrelations(bit_mts.a);
   ots_receiver->SetChoices(bit_mts.b);
@@ -192,35 +280,24 @@ static void RegisterHelper(OtProvider& ot_provider,
                            std::size_t number_of_mts) {
   constexpr std::size_t bit_size = sizeof(T) * 8;
 
+  auto sender{ots_sender.begin()};
+  auto receiver{ots_receiver.begin()};
   for (std::size_t mt_id = 0; mt_id < number_of_mts;) {
     const auto batch_size = std::min(max_batch_size, number_of_mts - mt_id);
-    auto ptr_send{ot_provider.RegisterSendAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_send = dynamic_cast<AcOtSender<T>*>(ptr_send.get());
-    std::vector<T> vector_to_send;
-    vector_to_send.reserve(batch_size * bit_size);
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const T input = mts.a.at(mt_id + k) << bit_i;
-        vector_to_send.emplace_back(input);
-      }
+    if (sender == ots_sender.end()) {
+      sender = ots_sender.emplace(
+          sender, ot_provider.RegisterSendAcOt(batch_size * bit_size, sizeof(T) * 8));
+      receiver = ots_receiver.emplace(
+          receiver, ot_provider.RegisterReceiveAcOt(batch_size * bit_size, sizeof(T) * 8));
     }
-    ot_to_send->SetCorrelations(std::move(vector_to_send));
-
-    auto ptr_receive{ot_provider.RegisterReceiveAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ptr_receive.get());
-    BitVector<> choices;
-    choices.Reserve(batch_size * bit_size);
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const bool choice = ((mts.b.at(mt_id + k) >> bit_i) & 1u) == 1;
-        choices.Append(choice);
-      }
-    }
-    ot_to_receive->SetChoices(std::move(choices));
+    auto ot_to_send = dynamic_cast<AcOtSender<T>*>(sender->get());
+    ot_to_send->SetBitCorrelations(std::span(mts.a).subspan(mt_id, batch_size));
 
-    ots_sender.emplace_back(std::move(ptr_send));
-    ots_receiver.emplace_back(std::move(ptr_receive));
+    auto ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(receiver->get());
+    ot_to_receive->SetBitChoices(std::span(mts.b).subspan(mt_id, batch_size));
 
+    ++sender;
+    ++receiver;
     mt_id += batch_size;
   }
 }
@@ -234,6 +311,15 @@ void MtProviderFromOts::RegisterOts() {
   GenerateRandomTriples<std::uint32_t>(mts32_, number_of_mts_32_);
   GenerateRandomTriples<std::uint64_t>(mts64_, number_of_mts_64_);
 
+  if (use_paillier_) {
+    paillier_mt_generator_ =
+        std::make_unique<PaillierMtGenerator>(communication_layer_, paillier_modulus_bit_length_);
+    paillier_mt_generator_->RegisterMts(
+        {number_of_mts_8_, number_of_mts_16_, number_of_mts_32_, number_of_mts_64_});
+  } else {
+    paillier_mt_generator_.reset();
+  }
+
   for (auto i = 0ull; i < number_of_parties_; ++i) {
     if (i == my_id_) {
       continue;
@@ -242,6 +328,9 @@ void MtProviderFromOts::RegisterOts() {
       RegisterHelperBool(*ot_providers_.at(i), bit_ots_sender_.at(i), bit_ots_receiver_.at(i),
                          bit_mts_, number_of_bit_mts_);
     }
+    if (paillier_mt_generator_) {
+      continue;
+    }
     RegisterHelper<std::uint8_t>(*ot_providers_.at(i), ots_sender_8_.at(i), ots_receiver_8_.at(i),
                                  kMaxBatchSize, mts8_, number_of_mts_8_);
     RegisterHelper<std::uint16_t>(*ot_providers_.at(i), ots_sender_16_.at(i),
@@ -255,59 +344,104 @@ void MtProviderFromOts::RegisterOts() {
 
 static void ParseHelperBool(std::unique_ptr<XcOtBitSender>& ots_sender,
                             std::unique_ptr<XcOtBitReceiver>& ots_receiver,
-                            BinaryMtVector& bit_mts) {
+                            BinaryMtVector& bit_mts, std::mutex& bit_mts_mutex) {
   ots_sender->ComputeOutputs();
   ots_receiver->ComputeOutputs();
   const auto& output_sender = ots_sender->GetOutputs();
   const auto& output_receiver = ots_receiver->GetOutputs();
+  std::scoped_lock lock(bit_mts_mutex);
   bit_mts.c ^= output_sender;
   bit_mts.c ^= output_receiver;
 }
 
+// adds the OT outputs of a batch to cross_terms
 template <typename T>
-static void ParseHelper(std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
-                        std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver,
-                        std::size_t max_batch_size, IntegerMtVector<T>& mts,
-                        std::size_t number_of_mts) {
-  constexpr std::size_t bit_size = sizeof(T) * 8;
+static void ParseHelper(BasicOtSender& ots_sender, BasicOtReceiver& ots_receiver,
+                        std::span<T> cross_terms) {
+  auto& ot_to_send = dynamic_cast<AcOtSender<T>&>(ots_sender);
+  auto& ot_to_receive = dynamic_cast<AcOtReceiver<T>&>(ots_receiver);
+  ot_to_send.ComputeOutputs();
+  ot_to_receive.ComputeOutputs();
+  ot_to_receive.AccumulateBitOutputs(cross_terms, 1);
+  ot_to_send.AccumulateBitOutputs(cross_terms, static_cast<T>(-1));
+  ot_to_send.ReleaseOutputs();
+  ot_to_receive.ReleaseOutputs();
+}
 
-  for (std::size_t mt_id = 0; mt_id < number_of_mts;) {
-    const auto batch_size = std::min(max_batch_size, number_of_mts - mt_id);
-    const auto& ot_to_send = dynamic_cast<AcOtSender<T>*>(ots_sender.front().get());
-    const auto& ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ots_receiver.front().get());
-    ot_to_send->ComputeOutputs();
-    const auto& output_sender = ot_to_send->GetOutputs();
-    ot_to_receive->ComputeOutputs();
-    const auto& output_receiver = ot_to_receive->GetOutputs();
-    for (auto j = 0ull; j < batch_size; ++j) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        mts.c.at(mt_id + j) +=
-            output_receiver[j * bit_size + bit_i] - output_sender[j * bit_size + bit_i];
-      }
+template <typename T>
+void MtProviderFromOts::ParseIntegerOutputs(
+    std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
+    std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver, IntegerMtVector<T>& mts,
+    std::size_t number_of_mts) {
+  constexpr std::size_t kTypeIndex{GetTypeIndex<T>()};
+  std::vector<T> cross_terms;
+  auto sender{ots_sender.begin()};
+  auto receiver{ots_receiver.begin()};
+  for (std::size_t mt_id = 0, batch = 0; mt_id < number_of_mts; ++batch) {
+    const auto batch_size = std::min(kMaxBatchSize, number_of_mts - mt_id);
+    cross_terms.assign(batch_size, 0);
+    ParseHelper<T>(**sender++, **receiver++, std::span(cross_terms));
+
+    std::scoped_lock lock(integer_mts_mutexes_[kTypeIndex]);
+    std::transform(cross_terms.cbegin(), cross_terms.cend(), mts.c.cbegin() + mt_id,
+                   mts.c.begin() + mt_id, std::plus<T>());
+    auto& number_of_parsed_parties{number_of_parsed_parties_[kTypeIndex]};
+    ++number_of_parsed_parties[batch];
+    // the batches become ready in the order of the MTs, s.t. the gates using the first MTs can
+    // start while the OTs of the later batches are still running
+    auto& number_of_ready_batches{number_of_ready_batches_[kTypeIndex]};
+    const std::size_t previously_ready_batches{number_of_ready_batches};
+    while (number_of_ready_batches < number_of_parsed_parties.size() &&
+           number_of_parsed_parties[number_of_ready_batches] + 1 == number_of_parties_) {
+      ++number_of_ready_batches;
+    }
+    if (number_of_ready_batches > previously_ready_batches) {
+      SetReady<T>(std::min(number_of_ready_batches * kMaxBatchSize, number_of_mts));
     }
-    ots_sender.pop_front();
-    ots_receiver.pop_front();
     mt_id += batch_size;
   }
 }
 
-void MtProviderFromOts::ParseOutputs() {
-  for (auto i = 0ull; i < number_of_parties_; ++i) {
-    if (i == my_id_) {
-      continue;
-    }
+void MtProviderFromOts::RunPipeline(std::size_t party_id) {
+  for (auto& ot : ots_sender_8_.at(party_id)) {
+    dynamic_cast<AcOtSender<std::uint8_t>*>(ot.get())->SendMessages();
+  }
+  for (auto& ot : ots_receiver_8_.at(party_id)) ot->SendCorrections();
+  for (auto& ot : ots_sender_16_.at(party_id)) {
+    dynamic_cast<AcOtSender<std::uint16_t>*>(ot.get())->SendMessages();
+  }
+  for (auto& ot : ots_receiver_16_.at(party_id)) ot->SendCorrections();
+  for (auto& ot : ots_sender_32_.at(party_id)) {
+    dynamic_cast<AcOtSender<std::uint32_t>*>(ot.get())->SendMessages();
+  }
+  for (auto& ot : ots_receiver_32_.at(party_id)) ot->SendCorrections();
+  for (auto& ot : ots_sender_64_.at(party_id)) {
+    dynamic_cast<AcOtSender<std::uint64_t>*>(ot.get())->SendMessages();
+  }
+  for (auto& ot : ots_receiver_64_.at(party_id)) ot->SendCorrections();
 
-    if (number_of_bit_mts_ > 0) {
-      ParseHelperBool(bit_ots_sender_.at(i), bit_ots_receiver_.at(i), bit_mts_);
-    }
-    ParseHelper<std::uint8_t>(ots_sender_8_.at(i), ots_receiver_8_.at(i), kMaxBatchSize, mts8_,
-                              number_of_mts_8_);
-    ParseHelper<std::uint16_t>(ots_sender_16_.at(i), ots_receiver_16_.at(i), kMaxBatchSize, mts16_,
-                               number_of_mts_16_);
-    ParseHelper<std::uint32_t>(ots_sender_32_.at(i), ots_receiver_32_.at(i), kMaxBatchSize, mts32_,
-                               number_of_mts_32_);
-    ParseHelper<std::uint64_t>(ots_sender_64_.at(i), ots_receiver_64_.at(i), kMaxBatchSize, mts64_,
-                               number_of_mts_64_);
+  if (number_of_bit_mts_ > 0) {
+    assert(bit_ots_receiver_.at(party_id) != nullptr);
+    assert(bit_ots_sender_.at(party_id) != nullptr);
+    bit_ots_receiver_.at(party_id)->SendCorrections();
+    bit_ots_sender_.at(party_id)->SendMessages();
+  }
+
+  // the integer MTs come first since they become ready batch by batch, whereas the binary MTs
+  // are completed at once; the Paillier cross terms are added to all MTs at once
+  if (!paillier_mt_generator_) {
+    ParseIntegerOutputs<std::uint8_t>(ots_sender_8_.at(party_id), ots_receiver_8_.at(party_id),
+                                      mts8_, number_of_mts_8_);
+    ParseIntegerOutputs<std::uint16_t>(ots_sender_16_.at(party_id), ots_receiver_16_.at(party_id),
+                                       mts16_, number_of_mts_16_);
+    ParseIntegerOutputs<std::uint32_t>(ots_sender_32_.at(party_id), ots_receiver_32_.at(party_id),
+                                       mts32_, number_of_mts_32_);
+    ParseIntegerOutputs<std::uint64_t>(ots_sender_64_.at(party_id), ots_receiver_64_.at(party_id),
+                                       mts64_, number_of_mts_64_);
+  }
+  if (number_of_bit_mts_ > 0) {
+    ParseHelperBool(bit_ots_sender_.at(party_id), bit_ots_receiver_.at(party_id), bit_mts_,
+                    bit_mts_mutex_);
   }
 }
 
@@ -24,23 +24,43 @@
 
 #pragma once
 
+#include <array>
 #include <list>
+#include <mutex>
+#include <span>
 
 #include "oblivious_transfer/ot_flavors.h"
+#include "statistics/memory_accounting.h"
 #include "utility/bit_vector.h"
 #include "utility/fiber_condition.h"
 #include "utility/helpers.h"
 
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
 namespace encrypto::motion {
 
 struct RunTimeStatistics;
 class Logger;
+class PaillierMtGenerator;
+class PreprocessingReader;
+class PreprocessingWriter;
 
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 struct IntegerMtVector {
   std::vector<T> a, b, c;  // c[i] = a[i] * b[i]
 };
 
+/// \brief View of the MTs [offset, offset + n) in the memory of the MtProvider, which stays valid
+/// until MtProvider::Clear.
+template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+struct IntegerMtSpan {
+  std::span<const T> a, b, c;  // c[i] = a[i] * b[i]
+};
+
 struct BinaryMtVector {
   BitVector<> a, b, c;  // c[i] = a[i] ^ b[i]
 };
@@ -96,44 +116,70 @@ class MtProvider {
 
   const BinaryMtVector& GetBinaryAll() const noexcept;
 
+  // copies the MTs [offset, offset + n), see GetIntegerSpan for a view without copies
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   IntegerMtVector<T> GetInteger(const std::size_t offset, const std::size_t n = 1) const {
-    WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return GetInteger(mts8_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return GetInteger(mts16_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return GetInteger(mts32_, offset, n);
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return GetInteger(mts64_, offset, n);
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    const auto mts{GetIntegerSpan<T>(offset, n)};
+    return IntegerMtVector<T>{std::vector<T>(mts.a.begin(), mts.a.end()),
+                              std::vector<T>(mts.b.begin(), mts.b.end()),
+                              std::vector<T>(mts.c.begin(), mts.c.end())};
+  }
+
+  /// \brief Returns the MTs [offset, offset + n) without copying them, s.t. gates can compute on
+  /// the provider's memory directly.  Only waits until these MTs are ready, see WaitReady.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  IntegerMtSpan<T> GetIntegerSpan(const std::size_t offset, const std::size_t n) const {
+    WaitReady<T>(offset, n);
+    const auto& mts{GetIntegerStorage<T>()};
+    assert(mts.a.size() == mts.b.size());
+    assert(mts.c.size() == mts.b.size());
+    assert(offset + n <= mts.a.size());
+    return IntegerMtSpan<T>{std::span(mts.a).subspan(offset, n),
+                            std::span(mts.b).subspan(offset, n),
+                            std::span(mts.c).subspan(offset, n)};
   }
 
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   const IntegerMtVector<T>& GetIntegerAll() const noexcept {
     WaitFinished();
-    if constexpr (std::is_same_v<T, std::uint8_t>) {
-      return mts8_;
-    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-      return mts16_;
-    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-      return mts32_;
-    } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-      return mts64_;
-    } else {
-      throw std::runtime_error("Unknown type");
-    }
+    return GetIntegerStorage<T>();
   }
 
   virtual void PreSetup() = 0;
   virtual void Setup() = 0;
 
+  /// \brief Writes the generated MTs, needs a completed setup.
+  void Save(PreprocessingWriter& writer) const;
+
+  /// \brief Reads the requested number of MTs instead of running the setup.
+  void Load(PreprocessingReader& reader);
+
+  /// \brief Sets the MTs obtained from elsewhere, e.g., from a trusted dealer, instead of running
+  /// the setup.
+  void SetMts(BinaryMtVector&& bit_mts, IntegerMtVector<std::uint8_t>&& mts8,
+              IntegerMtVector<std::uint16_t>&& mts16, IntegerMtVector<std::uint32_t>&& mts32,
+              IntegerMtVector<std::uint64_t>&& mts64);
+
+  /// \brief Discards the MTs of the last run but keeps the requested numbers of MTs, s.t.
+  /// fresh MTs are provided at the same offsets, see Backend::Clear.
+  void Clear();
+
   // blocking wait
   void WaitFinished() const { finished_condition_->Wait(); }
 
+  /// \brief Blocks until the integer MTs [offset, offset + n) are ready.  The setup completes the
+  /// MTs in batches, s.t. gates using the first MTs can proceed while the others are generated.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  void WaitReady(const std::size_t offset, const std::size_t n) const {
+    const auto& number_of_ready_mts{number_of_ready_mts_[GetTypeIndex<T>()]};
+    if (number_of_ready_mts.load(std::memory_order_acquire) >= offset + n) {
+      return;
+    }
+    finished_condition_->WaitUntil([this, &number_of_ready_mts, end = offset + n] {
+      return finished_.load() || number_of_ready_mts.load() >= end;
+    });
+  }
+
  protected:
   MtProvider(std::size_t my_id, std::size_t number_of_parties);
   MtProvider() = delete;
@@ -153,27 +199,70 @@ class MtProvider {
 
   std::atomic<bool> finished_{false};
   std::shared_ptr<FiberCondition> finished_condition_;
+  // the integer MTs [0, number_of_ready_mts_[i]) of each type can be used before the setup finished
+  std::array<std::atomic<std::size_t>, 4> number_of_ready_mts_{};
 
- private:
-  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
-  inline IntegerMtVector<T> GetInteger(const IntegerMtVector<T>& mts, const std::size_t offset,
-                                       const std::size_t n) const {
-    assert(mts.a.size() == mts.b.size());
-    assert(mts.c.size() == mts.b.size());
-    assert(offset + n <= mts.a.size());
+  // accounts the MTs and notifies the waiting gates
+  void SetFinished();
 
-    return IntegerMtVector<T>{std::vector<T>(mts.a.begin() + offset, mts.a.begin + offset + n),
-                              std::vector<T>(mts.b.begin() + offset, mts.b.begin + offset + n),
-                              std::vector<T>(mts.c.begin() + offset, mts.c.begin + offset + n)};
+  // notifies the gates waiting for the integer MTs [0, number_of_mts) of type T
+  template <typename T>
+  void SetReady(const std::size_t number_of_mts) {
+    {
+      std::scoped_lock lock(finished_condition_->GetMutex());
+      number_of_ready_mts_[GetTypeIndex<T>()] = number_of_mts;
+    }
+    finished_condition_->NotifyAll();
   }
+
+  template <typename T>
+  static constexpr std::size_t GetTypeIndex() {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+      return 0;
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+      return 1;
+    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+      return 2;
+    } else {
+      static_assert(std::is_same_v<T, std::uint64_t>, "Unknown type");
+      return 3;
+    }
+  }
+
+  template <typename T>
+  const IntegerMtVector<T>& GetIntegerStorage() const noexcept {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+      return mts8_;
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+      return mts16_;
+    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+      return mts32_;
+    } else {
+      static_assert(std::is_same_v<T, std::uint64_t>, "Unknown type");
+      return mts64_;
+    }
+  }
+
+ private:
+  MemoryAccount memory_account_{MemorySubsystem::kPreprocessing};
 };
 
 class MtProviderFromOts final : public MtProvider {
  public:
-  MtProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& ot_providers, const std::size_t my_id,
+  static constexpr std::size_t kDefaultPaillierModulusBitLength{3072};
+
+  MtProviderFromOts(communication::CommunicationLayer& communication_layer,
+                    std::vector<std::unique_ptr<OtProvider>>& ot_providers, const std::size_t my_id,
                     std::shared_ptr<Logger> logger, RunTimeStatistics& run_time_statistics);
   ~MtProviderFromOts();
 
+  /// \brief Generate the arithmetic MTs with the Paillier cryptosystem and a modulus of
+  /// \p modulus_bit_length bits instead of OTs, see PaillierMtGenerator.  This needs much less
+  /// communication, especially for 64-bit MTs, but much more computation.  The binary MTs are
+  /// still generated with OTs.  Needs to be set by all parties alike before the presetup phase.
+  void SetPaillierMts(bool value = true,
+                      std::size_t modulus_bit_length = kDefaultPaillierModulusBitLength);
+
   void PreSetup() final override;
 
   // needs completed OTExtension
@@ -182,10 +271,24 @@ class MtProviderFromOts final : public MtProvider {
  private:
   void RegisterOts();
 
-  void ParseOutputs();
+  // sends the OTs with party_id and adds its cross terms to the MTs.  The pipelines of all other
+  // parties run in parallel and only synchronize to add the cross terms of a batch.
+  void RunPipeline(std::size_t party_id);
 
+  // adds the cross terms of the OTs with one party to the integer MTs of type T batch by batch and
+  // marks the batches ready whose cross terms of all parties were added
+  template <typename T>
+  void ParseIntegerOutputs(std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
+                           std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver,
+                           IntegerMtVector<T>& mts, std::size_t number_of_mts);
+
+  communication::CommunicationLayer& communication_layer_;
   std::vector<std::unique_ptr<OtProvider>>& ot_providers_;
 
+  bool use_paillier_{false};
+  std::size_t paillier_modulus_bit_length_{kDefaultPaillierModulusBitLength};
+  std::unique_ptr<PaillierMtGenerator> paillier_mt_generator_;
+
   // use alternating party roles for load balancing
   std::vector<std::list<std::unique_ptr<BasicOtReceiver>>> ots_receiver_8_;
   std::vector<std::list<std::unique_ptr<BasicOtSender>>> ots_sender_8_;
@@ -205,6 +308,13 @@ class MtProviderFromOts final : public MtProvider {
   // Should be divisible by 128
   static inline constexpr std::size_t kMaxBatchSize{128 * 128};
 
+  // guard the MTs of each integer type and the binary MTs, to which the pipelines add their cross
+  // terms, and the number of parties whose cross terms of each batch were added
+  std::array<std::mutex, 4> integer_mts_mutexes_;
+  std::mutex bit_mts_mutex_;
+  std::array<std::vector<std::size_t>, 4> number_of_parsed_parties_;
+  std::array<std::size_t, 4> number_of_ready_batches_{};
+
   std::shared_ptr<Logger> logger_;
   RunTimeStatistics& run_time_statistics_;
 };
@@ -0,0 +1,302 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "paillier_mt_generator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "primitives/paillier.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+using primitives::BignumPointer;
+using primitives::NewBignum;
+using primitives::NewBignumContext;
+
+static_assert(sizeof(BN_ULONG) >= sizeof(std::uint64_t));
+
+std::span<const std::uint8_t> GetPayload(const std::vector<std::uint8_t>& message) {
+  const auto payload{communication::GetMessage(message.data())->payload()};
+  return {payload->data(), payload->size()};
+}
+
+BignumPointer ToBignum(std::uint64_t value) {
+  auto result{NewBignum()};
+  if (BN_set_word(result.get(), value) != 1) {
+    throw std::runtime_error("OpenSSL BIGNUM operation failed");
+  }
+  return result;
+}
+
+// returns x mod 2^bit_length for bit_length <= 64 and overwrites x
+std::uint64_t GetLowBits(BIGNUM& x, std::size_t bit_length) {
+  // fails without changing x if x is shorter than bit_length bits
+  BN_mask_bits(&x, static_cast<int>(bit_length));
+  return BN_get_word(&x);
+}
+
+constexpr std::size_t GetSlotBitLength(std::size_t bit_length) {
+  // the sum of a product of two bit_length-bit values and a mask must not overflow into the next
+  // slot
+  return 2 * bit_length + PaillierMtGenerator::kStatisticalSecurityParameter + 1;
+}
+
+constexpr std::size_t GetNumberOfBatches(std::size_t number_of_mts, std::size_t max_batch_size) {
+  return (number_of_mts + max_batch_size - 1) / max_batch_size;
+}
+
+}  // namespace
+
+PaillierMtGenerator::PaillierMtGenerator(communication::CommunicationLayer& communication_layer,
+                                         std::size_t modulus_bit_length)
+    : communication_layer_(communication_layer),
+      my_id_(communication_layer.GetMyId()),
+      number_of_parties_(communication_layer.GetNumberOfParties()),
+      modulus_bit_length_(modulus_bit_length),
+      number_of_threads_(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+PaillierMtGenerator::~PaillierMtGenerator() = default;
+
+std::size_t PaillierMtGenerator::GetSlotsPerCiphertext(std::size_t bit_length) const {
+  // the packed plaintext needs to be less than the modulus, which has at least
+  // modulus_bit_length_ - 1 bits
+  return (modulus_bit_length_ - 1) / GetSlotBitLength(bit_length);
+}
+
+void PaillierMtGenerator::RegisterMts(const std::array<std::size_t, 4>& numbers_of_mts) {
+  std::size_t number_of_batches{0};
+  for (auto number_of_mts : numbers_of_mts) {
+    number_of_batches += GetNumberOfBatches(number_of_mts, kMaxBatchSize);
+  }
+
+  auto& message_manager{communication_layer_.GetMessageManager()};
+  public_key_futures_.clear();
+  public_key_futures_.resize(number_of_parties_);
+  ciphertext_futures_.clear();
+  ciphertext_futures_.resize(number_of_batches);
+  product_futures_.clear();
+  product_futures_.resize(number_of_batches);
+  if (number_of_batches == 0) {
+    return;
+  }
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    public_key_futures_.at(party_id) = message_manager.RegisterReceive(
+        party_id, communication::MessageType::kPaillierPublicKey, 0);
+  }
+  for (std::size_t batch_id = 0; batch_id < number_of_batches; ++batch_id) {
+    ciphertext_futures_.at(batch_id).resize(number_of_parties_);
+    product_futures_.at(batch_id).resize(number_of_parties_);
+    for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+      if (party_id == my_id_) {
+        continue;
+      }
+      ciphertext_futures_.at(batch_id).at(party_id) = message_manager.RegisterReceive(
+          party_id, communication::MessageType::kPaillierCiphertexts, batch_id);
+      product_futures_.at(batch_id).at(party_id) = message_manager.RegisterReceive(
+          party_id, communication::MessageType::kPaillierProducts, batch_id);
+    }
+  }
+}
+
+void PaillierMtGenerator::AddCrossTerms(IntegerMtVector<std::uint8_t>& mts_8,
+                                        IntegerMtVector<std::uint16_t>& mts_16,
+                                        IntegerMtVector<std::uint32_t>& mts_32,
+                                        IntegerMtVector<std::uint64_t>& mts_64) {
+  if (ciphertext_futures_.empty()) {
+    return;
+  }
+
+  private_key_ = std::make_unique<primitives::PaillierPrivateKey>(modulus_bit_length_);
+  auto modulus{std::make_shared<const std::vector<std::uint8_t>>(private_key_->GetModulus())};
+  communication_layer_.BroadcastMessage(communication::MessageType::kPaillierPublicKey, 0, *modulus,
+                                        modulus);
+
+  // all parties first send their ciphertexts s.t. no party waits for another one's products
+  std::size_t batch_id{0};
+  SendCiphertexts(mts_8.a, batch_id);
+  SendCiphertexts(mts_16.a, batch_id);
+  SendCiphertexts(mts_32.a, batch_id);
+  SendCiphertexts(mts_64.a, batch_id);
+
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    const auto message{public_key_futures_.at(party_id).get()};
+    const primitives::PaillierPublicKey public_key(GetPayload(message));
+    if (public_key.GetModulusBitLength() != modulus_bit_length_) {
+      throw std::runtime_error(fmt::format(
+          "Party#{} uses a Paillier modulus of {} bits for the MTs, but Party#{} uses {} bits",
+          party_id, public_key.GetModulusBitLength(), my_id_, modulus_bit_length_));
+    }
+    batch_id = 0;
+    SendProducts(party_id, public_key, mts_8, batch_id);
+    SendProducts(party_id, public_key, mts_16, batch_id);
+    SendProducts(party_id, public_key, mts_32, batch_id);
+    SendProducts(party_id, public_key, mts_64, batch_id);
+  }
+
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    batch_id = 0;
+    ReceiveProducts(party_id, mts_8.c, batch_id);
+    ReceiveProducts(party_id, mts_16.c, batch_id);
+    ReceiveProducts(party_id, mts_32.c, batch_id);
+    ReceiveProducts(party_id, mts_64.c, batch_id);
+  }
+  private_key_.reset();
+}
+
+template <typename T>
+void PaillierMtGenerator::SendCiphertexts(const std::vector<T>& a, std::size_t& batch_id) {
+  const auto ciphertext_byte_length{private_key_->GetCiphertextByteLength()};
+  for (std::size_t offset = 0; offset < a.size(); offset += kMaxBatchSize, ++batch_id) {
+    const auto batch_size{std::min(kMaxBatchSize, a.size() - offset)};
+    auto payload{std::make_shared<std::vector<std::uint8_t>>(batch_size * ciphertext_byte_length)};
+    ParallelFor(batch_size, number_of_threads_, [&](std::size_t k) {
+      auto context{NewBignumContext()};
+      const auto ciphertext{private_key_->Encrypt(*ToBignum(a[offset + k]), *context)};
+      private_key_->Serialize(*ciphertext, std::span(*payload).subspan(k * ciphertext_byte_length,
+                                                                         ciphertext_byte_length));
+    });
+    communication_layer_.BroadcastMessage(communication::MessageType::kPaillierCiphertexts,
+                                          batch_id, *payload, payload);
+  }
+}
+
+template <typename T>
+void PaillierMtGenerator::SendProducts(std::size_t party_id,
+                                       const primitives::PaillierPublicKey& public_key,
+                                       IntegerMtVector<T>& mts, std::size_t& batch_id) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t kSlotBitLength{GetSlotBitLength(kBitLength)};
+  const auto number_of_slots{GetSlotsPerCiphertext(kBitLength)};
+  const auto ciphertext_byte_length{public_key.GetCiphertextByteLength()};
+  // Enc(x)^(2^kSlotBitLength) = Enc(x * 2^kSlotBitLength) shifts x to the next slot
+  auto shift{NewBignum()};
+  if (BN_set_bit(shift.get(), static_cast<int>(kSlotBitLength)) != 1) {
+    throw std::runtime_error("OpenSSL BIGNUM operation failed");
+  }
+
+  for (std::size_t offset = 0; offset < mts.b.size(); offset += kMaxBatchSize, ++batch_id) {
+    const auto batch_size{std::min(kMaxBatchSize, mts.b.size() - offset)};
+    const auto message{ciphertext_futures_.at(batch_id).at(party_id).get()};
+    const auto ciphertexts{GetPayload(message)};
+    if (ciphertexts.size() != batch_size * ciphertext_byte_length) {
+      throw std::runtime_error(fmt::format(
+          "Received {} bytes of Paillier ciphertexts for MT batch {} from Party#{}, expected {}",
+          ciphertexts.size(), batch_id, party_id, batch_size * ciphertext_byte_length));
+    }
+
+    const auto number_of_ciphertexts{(batch_size + number_of_slots - 1) / number_of_slots};
+    const auto payload_size{number_of_ciphertexts * ciphertext_byte_length};
+    auto payload{std::make_shared<std::vector<std::uint8_t>>(payload_size)};
+    ParallelFor(number_of_ciphertexts, number_of_threads_, [&](std::size_t i) {
+      auto context{NewBignumContext()};
+      const auto begin{i * number_of_slots};
+      const auto end{std::min(begin + number_of_slots, batch_size)};
+      // Horner's scheme from the last slot, which ends up in the most significant bits
+      auto result{NewBignum()};
+      auto masks{NewBignum()};
+      auto mask{NewBignum()};
+      BN_one(result.get());
+      for (auto k = end; k-- > begin;) {
+        if (k + 1 < end) {
+          result = public_key.Multiply(*result, *shift, *context);
+        }
+        const auto a{public_key.Deserialize(
+            ciphertexts.subspan(k * ciphertext_byte_length, ciphertext_byte_length))};
+        public_key.Add(*result, *public_key.Multiply(*a, *ToBignum(mts.b[offset + k]), *context),
+                       *context);
+
+        if (BN_rand(mask.get(), static_cast<int>(2 * kBitLength + kStatisticalSecurityParameter),
+                    BN_RAND_TOP_ANY, BN_RAND_BOTTOM_ANY) != 1 ||
+            BN_lshift(masks.get(), masks.get(), static_cast<int>(kSlotBitLength)) != 1 ||
+            BN_add(masks.get(), masks.get(), mask.get()) != 1) {
+          throw std::runtime_error("OpenSSL BIGNUM operation failed");
+        }
+        mts.c[offset + k] -= static_cast<T>(GetLowBits(*mask, kBitLength));
+      }
+      // the fresh randomness of the encryption also hides b from the key owner
+      public_key.Add(*result, *public_key.Encrypt(*masks, *context), *context);
+      public_key.Serialize(*result, std::span(*payload).subspan(i * ciphertext_byte_length,
+                                                                ciphertext_byte_length));
+    });
+    communication_layer_.SendMessage(party_id, communication::MessageType::kPaillierProducts,
+                                     batch_id, *payload, payload);
+  }
+}
+
+template <typename T>
+void PaillierMtGenerator::ReceiveProducts(std::size_t party_id, std::vector<T>& c,
+                                          std::size_t& batch_id) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t kSlotBitLength{GetSlotBitLength(kBitLength)};
+  const auto number_of_slots{GetSlotsPerCiphertext(kBitLength)};
+  const auto ciphertext_byte_length{private_key_->GetCiphertextByteLength()};
+
+  for (std::size_t offset = 0; offset < c.size(); offset += kMaxBatchSize, ++batch_id) {
+    const auto batch_size{std::min(kMaxBatchSize, c.size() - offset)};
+    const auto number_of_ciphertexts{(batch_size + number_of_slots - 1) / number_of_slots};
+    const auto message{product_futures_.at(batch_id).at(party_id).get()};
+    const auto ciphertexts{GetPayload(message)};
+    if (ciphertexts.size() != number_of_ciphertexts * ciphertext_byte_length) {
+      throw std::runtime_error(fmt::format(
+          "Received {} bytes of Paillier products for MT batch {} from Party#{}, expected {}",
+          ciphertexts.size(), batch_id, party_id, number_of_ciphertexts * ciphertext_byte_length));
+    }
+
+    ParallelFor(number_of_ciphertexts, number_of_threads_, [&](std::size_t i) {
+      auto context{NewBignumContext()};
+      const auto begin{i * number_of_slots};
+      const auto end{std::min(begin + number_of_slots, batch_size)};
+      const auto ciphertext{private_key_->Deserialize(
+          ciphertexts.subspan(i * ciphertext_byte_length, ciphertext_byte_length))};
+      const auto plaintext{private_key_->Decrypt(*ciphertext, *context)};
+      auto slot{NewBignum()};
+      for (auto k = begin; k < end; ++k) {
+        const auto shift{static_cast<int>((k - begin) * kSlotBitLength)};
+        if (BN_rshift(slot.get(), plaintext.get(), shift) != 1) {
+          throw std::runtime_error("OpenSSL BIGNUM operation failed");
+        }
+        c[offset + k] += static_cast<T>(GetLowBits(*slot, kBitLength));
+      }
+    });
+  }
+}
+
+}  // namespace encrypto::motion
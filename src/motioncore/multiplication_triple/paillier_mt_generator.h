@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mt_provider.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::primitives {
+
+class PaillierPrivateKey;
+class PaillierPublicKey;
+
+}  // namespace encrypto::motion::primitives
+
+namespace encrypto::motion {
+
+/// \brief Computes the cross terms a_i * b_j of the arithmetic MTs of parties i != j with the
+/// Paillier cryptosystem instead of OTs.  Party i broadcasts an encryption of each of its a_i.
+/// Each party j raises them to its b_j, packs the products of GetSlotsPerCiphertext many MTs into
+/// the slots of one ciphertext, masks each slot statistically by a random r and sends the result
+/// back.  Then i adds a_i * b_j + r to its c and j subtracts r from its c.  Compared to the OTs,
+/// this trades computation, i.e., modular exponentiations modulo n^2, for communication, which no
+/// longer grows with the square of the bit length of the MTs.
+class PaillierMtGenerator {
+ public:
+  /// \brief The masks exceed the products by this many bits, s.t. the products are statistically
+  /// hidden from the key owner.
+  static constexpr std::size_t kStatisticalSecurityParameter{40};
+
+  /// \brief Each party generates a key pair whose modulus has \p modulus_bit_length bits, which
+  /// needs to be the same for all parties.
+  PaillierMtGenerator(communication::CommunicationLayer& communication_layer,
+                      std::size_t modulus_bit_length);
+  ~PaillierMtGenerator();
+
+  /// \brief Returns the number of products of \p bit_length bits that fit into one ciphertext.
+  std::size_t GetSlotsPerCiphertext(std::size_t bit_length) const;
+
+  /// \brief Registers for the messages of the given numbers of MTs per bit length 8, 16, 32 and
+  /// 64, needs to be called in the presetup phase by all parties alike.
+  void RegisterMts(const std::array<std::size_t, 4>& numbers_of_mts);
+
+  /// \brief Adds the cross terms of all pairs of parties to \p mts_8, ..., \p mts_64, whose c
+  /// already contain the local products a_i * b_i.
+  void AddCrossTerms(IntegerMtVector<std::uint8_t>& mts_8, IntegerMtVector<std::uint16_t>& mts_16,
+                     IntegerMtVector<std::uint32_t>& mts_32,
+                     IntegerMtVector<std::uint64_t>& mts_64);
+
+ private:
+  using FutureType = ReusableFiberFuture<std::vector<std::uint8_t>>;
+
+  template <typename T>
+  void SendCiphertexts(const std::vector<T>& a, std::size_t& batch_id);
+
+  template <typename T>
+  void SendProducts(std::size_t party_id, const primitives::PaillierPublicKey& public_key,
+                    IntegerMtVector<T>& mts, std::size_t& batch_id);
+
+  template <typename T>
+  void ReceiveProducts(std::size_t party_id, std::vector<T>& c, std::size_t& batch_id);
+
+  communication::CommunicationLayer& communication_layer_;
+  const std::size_t my_id_;
+  const std::size_t number_of_parties_;
+  const std::size_t modulus_bit_length_;
+  const std::size_t number_of_threads_;
+
+  std::unique_ptr<primitives::PaillierPrivateKey> private_key_;
+
+  // indexed by the party id, the own futures are not valid
+  std::vector<FutureType> public_key_futures_;
+  // indexed by the batch id and the party id
+  std::vector<std::vector<FutureType>> ciphertext_futures_;
+  std::vector<std::vector<FutureType>> product_futures_;
+
+  static constexpr std::size_t kMaxBatchSize{1024};
+};
+
+}  // namespace encrypto::motion
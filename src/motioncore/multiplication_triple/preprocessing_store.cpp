@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "preprocessing_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'M', 'O', 'T', 'I', 'O', 'N', 'P', 'P'};
+constexpr std::uint64_t kVersion{2};
+constexpr std::size_t kHeaderSize{kMagic.size() + 3 * sizeof(std::uint64_t)};
+
+}  // namespace
+
+PreprocessingWriter::PreprocessingWriter(const std::string& path, std::size_t my_id,
+                                         std::size_t number_of_parties)
+    : path_(path), stream_(path, std::ios::binary | std::ios::trunc) {
+  if (!stream_) {
+    throw std::runtime_error(fmt::format("Could not create preprocessing file {}", path_));
+  }
+  stream_.write(kMagic.data(), kMagic.size());
+  for (std::uint64_t value : {kVersion, std::uint64_t(my_id), std::uint64_t(number_of_parties)}) {
+    stream_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+}
+
+void PreprocessingWriter::Write(const BitVector<>& data) {
+  WriteSection(data.GetSize(), std::span(data.GetData().data(), data.GetData().size()));
+}
+
+void PreprocessingWriter::Close() {
+  stream_.close();
+  if (stream_.fail()) {
+    throw std::runtime_error(fmt::format("Could not write preprocessing file {}", path_));
+  }
+}
+
+void PreprocessingWriter::WriteSection(std::size_t number_of_elements,
+                                       std::span<const std::byte> data) {
+  for (std::uint64_t value : {std::uint64_t(number_of_elements), std::uint64_t(0)}) {
+    stream_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  stream_.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+PreprocessingReader::PreprocessingReader(const std::string& path, std::size_t my_id,
+                                         std::size_t number_of_parties)
+    : path_(path) {
+  // the consumed counters are written back to the file
+  int file_descriptor{open(path.c_str(), O_RDWR)};
+  if (file_descriptor < 0) {
+    throw std::runtime_error(fmt::format("Could not open preprocessing file {}: {}", path_,
+                                         std::strerror(errno)));
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0 ||
+      static_cast<std::size_t>(file_status.st_size) < kHeaderSize) {
+    close(file_descriptor);
+    throw std::runtime_error(fmt::format("Preprocessing file {} is truncated", path_));
+  }
+  size_ = file_status.st_size;
+  void* mapping{
+      mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0)};
+  // the mapping stays valid after closing the file
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Could not map preprocessing file {}: {}", path_,
+                                         std::strerror(errno)));
+  }
+  data_ = static_cast<std::byte*>(mapping);
+  // the sections are read once from front to back
+  madvise(mapping, size_, MADV_SEQUENTIAL);
+
+  std::array<std::uint64_t, 3> header;
+  std::memcpy(header.data(), data_ + kMagic.size(), sizeof(header));
+  if (std::memcmp(data_, kMagic.data(), kMagic.size()) != 0 || header[0] != kVersion) {
+    munmap(mapping, size_);
+    throw std::runtime_error(
+        fmt::format("{} is not a preprocessing file of version {}", path_, kVersion));
+  }
+  if (header[1] != my_id || header[2] != number_of_parties) {
+    munmap(mapping, size_);
+    throw std::runtime_error(fmt::format(
+        "Preprocessing file {} belongs to party #{} of {} but was loaded by party #{} of {}",
+        path_, header[1], header[2], my_id, number_of_parties));
+  }
+  position_ = kHeaderSize;
+}
+
+PreprocessingReader::~PreprocessingReader() {
+  msync(data_, size_, MS_SYNC);
+  munmap(data_, size_);
+}
+
+BitVector<> PreprocessingReader::ReadBits(std::size_t number_of_bits) {
+  auto data{ReadSection(number_of_bits, 0)};
+  return BitVector<>(data.data(), number_of_bits);
+}
+
+std::span<const std::byte> PreprocessingReader::ReadSection(std::size_t number_of_elements,
+                                                            std::size_t element_size) {
+  std::array<std::uint64_t, 2> counters;
+  if (size_ - position_ < sizeof(counters)) {
+    throw std::runtime_error(fmt::format("Preprocessing file {} is truncated", path_));
+  }
+  std::memcpy(counters.data(), data_ + position_, sizeof(counters));
+  const auto [stored_number_of_elements, number_of_consumed_elements] = counters;
+  if (number_of_consumed_elements > stored_number_of_elements) {
+    throw std::runtime_error(fmt::format("Preprocessing file {} is corrupted", path_));
+  }
+  if (stored_number_of_elements - number_of_consumed_elements < number_of_elements) {
+    throw std::runtime_error(fmt::format(
+        "Preprocessing file {} holds {} unconsumed elements but {} are needed", path_,
+        stored_number_of_elements - number_of_consumed_elements, number_of_elements));
+  }
+  // element size 0 denotes a section of bits, whose consumed bits are a multiple of 8
+  std::size_t stored_size{element_size == 0 ? BitsToBytes(stored_number_of_elements)
+                                            : stored_number_of_elements * element_size};
+  std::size_t offset{element_size == 0 ? number_of_consumed_elements / 8
+                                       : number_of_consumed_elements * element_size};
+  std::size_t size{element_size == 0 ? BitsToBytes(number_of_elements)
+                                     : number_of_elements * element_size};
+  if (size_ - position_ - sizeof(counters) < stored_size) {
+    throw std::runtime_error(fmt::format("Preprocessing file {} is truncated", path_));
+  }
+
+  // the elements are consumed before they are used, s.t. they are never handed out again
+  std::uint64_t consumed{std::min<std::uint64_t>(
+      stored_number_of_elements,
+      number_of_consumed_elements + (element_size == 0 ? 8 * size : number_of_elements))};
+  std::memcpy(data_ + position_ + sizeof(std::uint64_t), &consumed, sizeof(consumed));
+  position_ += sizeof(counters);
+  std::span<const std::byte> result(data_ + position_ + offset, size);
+  position_ += stored_size;
+  return result;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion {
+
+// Preprocessing material (MTs, SPs and SBs) can be dumped to a file by a run that only executes
+// the setup phase, see Configuration::SetPreprocessingOutputPath, and loaded by a later run, which
+// then skips generating it.  Loading consumes the material: each section records how many of its
+// elements were handed out, s.t. no MT, SP or SB is used by two runs.  A file holds the shares of
+// a single party and is laid out as a header followed by a sequence of sections:
+//   header:  magic || version || my_id || number_of_parties
+//   section: number of elements (or bits) as uint64 || number of consumed elements as uint64 ||
+//            raw data
+// The order of the sections is fixed by the providers that write and read them.
+
+/// \brief Writes preprocessing material to a file.
+class PreprocessingWriter {
+ public:
+  /// \brief Creates the file at \p path and writes the header.
+  /// \throws std::runtime_error if the file cannot be created
+  PreprocessingWriter(const std::string& path, std::size_t my_id, std::size_t number_of_parties);
+
+  template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+  void Write(const std::vector<T>& data) {
+    WriteSection(data.size(), std::as_bytes(std::span(data)));
+  }
+
+  void Write(const BitVector<>& data);
+
+  /// \brief Flushes the file.
+  /// \throws std::runtime_error if writing failed
+  void Close();
+
+ private:
+  void WriteSection(std::size_t number_of_elements, std::span<const std::byte> data);
+
+  std::string path_;
+  std::ofstream stream_;
+};
+
+/// \brief Reads preprocessing material from a memory-mapped file and marks it as consumed in the
+/// file.
+class PreprocessingReader {
+ public:
+  /// \brief Maps the file at \p path and checks that it was written by party \p my_id of
+  /// \p number_of_parties parties.
+  /// \throws std::runtime_error if the file cannot be mapped or does not match
+  PreprocessingReader(const std::string& path, std::size_t my_id, std::size_t number_of_parties);
+
+  /// \brief Writes the consumed counters back to the file.
+  ~PreprocessingReader();
+
+  PreprocessingReader(const PreprocessingReader&) = delete;
+  PreprocessingReader& operator=(const PreprocessingReader&) = delete;
+
+  /// \brief Reads the next section and returns its first \p number_of_elements elements that were
+  /// not consumed yet, which are consumed.
+  /// \throws std::runtime_error if the section holds fewer unconsumed elements
+  template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+  std::vector<T> Read(std::size_t number_of_elements) {
+    auto data{ReadSection(number_of_elements, sizeof(T))};
+    std::vector<T> result(number_of_elements);
+    std::copy_n(data.data(), data.size(), reinterpret_cast<std::byte*>(result.data()));
+    return result;
+  }
+
+  /// \brief Reads the next section and returns its first \p number_of_bits bits that were not
+  /// consumed yet.  The consumed bits are rounded up to whole bytes.
+  /// \throws std::runtime_error if the section holds fewer unconsumed bits
+  BitVector<> ReadBits(std::size_t number_of_bits);
+
+ private:
+  std::span<const std::byte> ReadSection(std::size_t number_of_elements, std::size_t element_size);
+
+  std::string path_;
+  std::byte* data_{nullptr};
+  std::size_t size_{0};
+  std::size_t position_{0};
+};
+
+}  // namespace encrypto::motion
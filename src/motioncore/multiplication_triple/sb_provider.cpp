@@ -26,10 +26,12 @@
 
 #include <cassert>
 #include <memory>
+#include <span>
 #include <type_traits>
 
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "preprocessing_store.h"
 #include "sb_impl.h"
 #include "sp_provider.h"
 #include "statistics/run_time_statistics.h"
@@ -47,6 +49,56 @@ SbProvider::SbProvider(const std::size_t my_id) : my_id_(my_id) {
   finished_condition_ = std::make_shared<FiberCondition>([this]() { return finished_; });
 }
 
+void SbProvider::Save(PreprocessingWriter& writer) const {
+  writer.Write(sbs_8_);
+  writer.Write(sbs_16_);
+  writer.Write(sbs_32_);
+  writer.Write(sbs_64_);
+}
+
+void SbProvider::Load(PreprocessingReader& reader) {
+  sbs_8_ = reader.Read<std::uint8_t>(number_of_sbs_8_);
+  sbs_16_ = reader.Read<std::uint16_t>(number_of_sbs_16_);
+  sbs_32_ = reader.Read<std::uint32_t>(number_of_sbs_32_);
+  sbs_64_ = reader.Read<std::uint64_t>(number_of_sbs_64_);
+  SetFinished();
+}
+
+void SbProvider::SetSbs(std::vector<std::uint8_t>&& sbs_8, std::vector<std::uint16_t>&& sbs_16,
+                        std::vector<std::uint32_t>&& sbs_32, std::vector<std::uint64_t>&& sbs_64) {
+  if (sbs_8.size() != number_of_sbs_8_ || sbs_16.size() != number_of_sbs_16_ ||
+      sbs_32.size() != number_of_sbs_32_ || sbs_64.size() != number_of_sbs_64_) {
+    throw std::invalid_argument("Got a different number of SBs than requested");
+  }
+  sbs_8_ = std::move(sbs_8);
+  sbs_16_ = std::move(sbs_16);
+  sbs_32_ = std::move(sbs_32);
+  sbs_64_ = std::move(sbs_64);
+  SetFinished();
+}
+
+void SbProvider::Clear() {
+  sbs_8_ = {};
+  sbs_16_ = {};
+  sbs_32_ = {};
+  sbs_64_ = {};
+  memory_account_.Set(0);
+  std::scoped_lock lock(finished_condition_->GetMutex());
+  finished_ = false;
+}
+
+void SbProvider::SetFinished() {
+  memory_account_.Set(sbs_8_.size() * sizeof(std::uint8_t) +
+                      sbs_16_.size() * sizeof(std::uint16_t) +
+                      sbs_32_.size() * sizeof(std::uint32_t) +
+                      sbs_64_.size() * sizeof(std::uint64_t));
+  {
+    std::scoped_lock lock(finished_condition_->GetMutex());
+    finished_ = true;
+  }
+  finished_condition_->NotifyAll();
+}
+
 SbProviderFromSps::SbProviderFromSps(communication::CommunicationLayer& communication_layer,
                                      std::shared_ptr<SpProvider> sp_provider,
                                      std::shared_ptr<Logger> logger,
@@ -92,12 +144,7 @@ void SbProviderFromSps::Setup() {
   sp_provider_->WaitFinished();
 
   ComputeSbs();
-
-  {
-    std::scoped_lock lock(finished_condition_->GetMutex());
-    finished_ = true;
-  }
-  finished_condition_->NotifyAll();
+  SetFinished();
 
   run_time_statistics_.RecordEnd<RunTimeStatistics::StatisticsId::kSbSetup>();
   if constexpr (kDebug) {
@@ -106,10 +153,23 @@ void SbProviderFromSps::Setup() {
 }
 
 void SbProviderFromSps::RegisterSps() {
-  offset_sps_16_ = sp_provider_->RequestSps<uint16_t>(number_of_sbs_8_);
-  offset_sps_32_ = sp_provider_->RequestSps<uint32_t>(number_of_sbs_16_);
-  offset_sps_64_ = sp_provider_->RequestSps<uint64_t>(number_of_sbs_32_);
-  offset_sps_128_ = sp_provider_->RequestSps<__uint128_t>(number_of_sbs_64_);
+  // the SPs stay requested for the later runs of a compiled circuit, see Backend::Clear
+  if (bit_size_ != 0) return;
+  const std::size_t number_of_sbs{number_of_sbs_8_ + number_of_sbs_16_ + number_of_sbs_32_ +
+                                  number_of_sbs_64_};
+  if (number_of_sbs_64_ > 0) {
+    bit_size_ = 64;
+    offset_sps_ = sp_provider_->RequestSps<__uint128_t>(number_of_sbs);
+  } else if (number_of_sbs_32_ > 0) {
+    bit_size_ = 32;
+    offset_sps_ = sp_provider_->RequestSps<std::uint64_t>(number_of_sbs);
+  } else if (number_of_sbs_16_ > 0) {
+    bit_size_ = 16;
+    offset_sps_ = sp_provider_->RequestSps<std::uint32_t>(number_of_sbs);
+  } else {
+    bit_size_ = 8;
+    offset_sps_ = sp_provider_->RequestSps<std::uint16_t>(number_of_sbs);
+  }
 }
 
 void SbProviderFromSps::RegisterForMessages() {
@@ -119,77 +179,15 @@ void SbProviderFromSps::RegisterForMessages() {
       communication::MessageType::kSharedBitsReconstruct, 0);
 }
 
-template <typename T>
-static constexpr auto GetByteSize(const std::vector<T>& v) {
-  auto size = v.size() * sizeof(typename std::remove_reference_t<decltype(v)>::value_type);
-  return size;
-}
-
-static std::vector<std::uint8_t> Gather(const std::vector<std::uint16_t>& ds_8,
-                                        const std::vector<std::uint32_t>& ds_16,
-                                        const std::vector<std::uint64_t>& ds_32,
-                                        const std::vector<__uint128_t>& ds_64) {
-  auto size_8 = GetByteSize(ds_8);
-  auto size_16 = GetByteSize(ds_16);
-  auto size_32 = GetByteSize(ds_32);
-  auto size_64 = GetByteSize(ds_64);
-
-  std::vector<std::uint8_t> buffer(size_8 + size_16 + size_32 + size_64);
-  auto start_8 = reinterpret_cast<std::uint16_t*>(buffer.data());
-  auto start_16 = reinterpret_cast<std::uint32_t*>(buffer.data() + size_8);
-  auto start_32 = reinterpret_cast<std::uint64_t*>(buffer.data() + size_8 + size_16);
-  auto start_64 = reinterpret_cast<__uint128_t*>(buffer.data() + size_8 + size_16 + size_32);
-  std::copy(ds_8.cbegin(), ds_8.cend(), start_8);
-  std::copy(ds_16.cbegin(), ds_16.cend(), start_16);
-  std::copy(ds_32.cbegin(), ds_32.cend(), start_32);
-  std::copy(ds_64.cbegin(), ds_64.cend(), start_64);
-  return buffer;
-}
-
-static std::vector<std::uint8_t> Scatter(std::vector<std::uint16_t>& ds_8,
-                                         std::vector<std::uint32_t>& ds_16,
-                                         std::vector<std::uint64_t>& ds_32,
-                                         std::vector<__uint128_t>& ds_64,
-                                         const std::vector<std::uint8_t>& buffer) {
-  auto size_8 = GetByteSize(ds_8);
-  auto size_16 = GetByteSize(ds_16);
-  auto size_32 = GetByteSize(ds_32);
-  [[maybe_unused]] auto size_64 = GetByteSize(ds_64);
-
-  assert(communication::GetMessage(buffer.data())->payload()->size() ==
-         size_8 + size_16 + size_32 + size_64);
-
-  const std::uint8_t* pointer{communication::GetMessage(buffer.data())->payload()->data()};
-
-  auto start_8 = reinterpret_cast<const std::uint16_t*>(pointer);
-  auto start_16 = reinterpret_cast<const std::uint32_t*>(pointer + size_8);
-  auto start_32 = reinterpret_cast<const std::uint64_t*>(pointer + size_8 + size_16);
-  auto start_64 = reinterpret_cast<const __uint128_t*>(pointer + size_8 + size_16 + size_32);
-  std::copy(start_8, start_8 + ds_8.size(), ds_8.begin());
-  std::copy(start_16, start_16 + ds_16.size(), ds_16.begin());
-  std::copy(start_32, start_32 + ds_32.size(), ds_32.begin());
-  std::copy(start_64, start_64 + ds_64.size(), ds_64.begin());
-  return buffer;
-}
-
 // reconstruct all the shared values packed into one message
+template <typename U>
 static void ReconstructionHelper(
-    std::vector<std::uint16_t>& xs_8, std::vector<std::uint32_t>& xs_16,
-    std::vector<std::uint64_t>& xs_32, std::vector<__uint128_t>& xs_64,
-    std::size_t number_of_parties,
-    std::function<void(const std::vector<uint8_t>&)> broadcast_function,
+    std::vector<U>& xs, std::size_t number_of_parties,
+    std::function<void(std::span<const std::uint8_t>)> broadcast_function,
     std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>>& futures) {
-  // Gather all shared in a single buffer
-  auto xs = Gather(xs_8, xs_16, xs_32, xs_64);
-
-  // prepare buffers to Scatter received shares into
-  std::vector<std::uint16_t> xs_8_o(xs_8.size());
-  std::vector<std::uint32_t> xs_16_o(xs_16.size());
-  std::vector<std::uint64_t> xs_32_o(xs_32.size());
-  std::vector<__uint128_t> xs_64_o(xs_64.size());
-
   // broadcast our share
-  broadcast_function(xs);
+  broadcast_function(std::span(reinterpret_cast<const std::uint8_t*>(xs.data()),
+                               xs.size() * sizeof(U)));
 
   // collect the other shares
   std::vector<std::vector<std::uint8_t>> received_xs;
@@ -206,25 +204,50 @@ static void ReconstructionHelper(
     if (xs_j.empty()) {
       continue;
     }
-    Scatter(xs_8_o, xs_16_o, xs_32_o, xs_64_o, xs_j);
-    std::transform(xs_8_o.cbegin(), xs_8_o.cend(), xs_8.cbegin(), xs_8.begin(),
-                   [](auto a_j, auto a_i) { return a_j + a_i; });
-    std::transform(xs_16_o.cbegin(), xs_16_o.cend(), xs_16.cbegin(), xs_16.begin(),
-                   [](auto a_j, auto a_i) { return a_j + a_i; });
-    std::transform(xs_32_o.cbegin(), xs_32_o.cend(), xs_32.cbegin(), xs_32.begin(),
-                   [](auto a_j, auto a_i) { return a_j + a_i; });
-    std::transform(xs_64_o.cbegin(), xs_64_o.cend(), xs_64.cbegin(), xs_64.begin(),
+    const auto payload{communication::GetMessage(xs_j.data())->payload()};
+    assert(payload->size() == xs.size() * sizeof(U));
+    const auto xs_j_begin{reinterpret_cast<const U*>(payload->data())};
+    std::transform(xs_j_begin, xs_j_begin + xs.size(), xs.cbegin(), xs.begin(),
                    [](auto a_j, auto a_i) { return a_j + a_i; });
   }
 
-  // now ds_.. contain the reconstructed ds (unreduced)
+  // now xs contains the reconstructed xs (unreduced)
+}
+
+// SBs in Z/2^kZ reduced to Z/2^lZ for l <= k
+template <typename T, typename U>
+static std::vector<T> Reduce(const std::vector<U>& sbs, const std::size_t offset,
+                             const std::size_t n) {
+  std::vector<T> reduced_sbs(n);
+  std::transform(sbs.cbegin() + offset, sbs.cbegin() + offset + n, reduced_sbs.begin(),
+                 [](auto sb) { return static_cast<T>(sb); });
+  return reduced_sbs;
 }
 
 void SbProviderFromSps::ComputeSbs() noexcept {
-  auto sps_16 = sp_provider_->GetSps<std::uint16_t>(offset_sps_16_, number_of_sbs_8_);
-  auto sps_32 = sp_provider_->GetSps<std::uint32_t>(offset_sps_32_, number_of_sbs_16_);
-  auto sps_64 = sp_provider_->GetSps<std::uint64_t>(offset_sps_64_, number_of_sbs_32_);
-  auto sps_128 = sp_provider_->GetSps<__uint128_t>(offset_sps_128_, number_of_sbs_64_);
+  switch (bit_size_) {
+    case 8:
+      ComputeSbs<std::uint8_t>();
+      break;
+    case 16:
+      ComputeSbs<std::uint16_t>();
+      break;
+    case 32:
+      ComputeSbs<std::uint32_t>();
+      break;
+    default:
+      assert(bit_size_ == 64);
+      ComputeSbs<std::uint64_t>();
+      break;
+  }
+}
+
+template <typename T>
+void SbProviderFromSps::ComputeSbs() {
+  using U = detail::get_expanded_type_t<T>;
+  const std::size_t number_of_sbs{number_of_sbs_8_ + number_of_sbs_16_ + number_of_sbs_32_ +
+                                  number_of_sbs_64_};
+  auto sps = sp_provider_->GetSps<U>(offset_sps_, number_of_sbs);
 
   auto broadcast_mask = [this](const auto& buffer) {
     auto msg{communication::BuildMessage(communication::MessageType::kSharedBitsMask, buffer)};
@@ -237,25 +260,23 @@ void SbProviderFromSps::ComputeSbs() noexcept {
     communication_layer_.BroadcastMessage(msg.Release());
   };
 
-  auto [wb1_8, wb2_8] = detail::compute_sbs_phase_1<std::uint8_t>(number_of_sbs_8_, my_id_, sps_16);
-  auto [wb1_16, wb2_16] =
-      detail::compute_sbs_phase_1<std::uint16_t>(number_of_sbs_16_, my_id_, sps_32);
-  auto [wb1_32, wb2_32] =
-      detail::compute_sbs_phase_1<std::uint32_t>(number_of_sbs_32_, my_id_, sps_64);
-  auto [wb1_64, wb2_64] =
-      detail::compute_sbs_phase_1<std::uint64_t>(number_of_sbs_64_, my_id_, sps_128);
-  ReconstructionHelper(wb2_8, wb2_16, wb2_32, wb2_64, number_of_parties_, broadcast_mask,
-                       mask_message_futures_);
-  detail::compute_sbs_phase_2<std::uint8_t>(wb1_8, wb2_8, my_id_, sps_16);
-  detail::compute_sbs_phase_2<std::uint16_t>(wb1_16, wb2_16, my_id_, sps_32);
-  detail::compute_sbs_phase_2<std::uint32_t>(wb1_32, wb2_32, my_id_, sps_64);
-  detail::compute_sbs_phase_2<std::uint64_t>(wb1_64, wb2_64, my_id_, sps_128);
-  ReconstructionHelper(wb2_8, wb2_16, wb2_32, wb2_64, number_of_parties_, broadcast_reconstruct,
+  auto [wb1, wb2] = detail::compute_sbs_phase_1<T>(number_of_sbs, my_id_, sps);
+  ReconstructionHelper(wb2, number_of_parties_, broadcast_mask, mask_message_futures_);
+  detail::compute_sbs_phase_2<T>(wb1, wb2, my_id_, sps);
+  ReconstructionHelper(wb2, number_of_parties_, broadcast_reconstruct,
                        reconstruct_message_futures_);
-  detail::compute_sbs_phase_3<std::uint8_t>(wb1_8, wb2_8, sbs_8_, my_id_);
-  detail::compute_sbs_phase_3<std::uint16_t>(wb1_16, wb2_16, sbs_16_, my_id_);
-  detail::compute_sbs_phase_3<std::uint32_t>(wb1_32, wb2_32, sbs_32_, my_id_);
-  detail::compute_sbs_phase_3<std::uint64_t>(wb1_64, wb2_64, sbs_64_, my_id_);
+  std::vector<T> sbs;
+  detail::compute_sbs_phase_3<T>(wb1, wb2, sbs, my_id_);
+
+  // the SBs are laid out by bit size in ascending order
+  std::size_t offset{0};
+  sbs_8_ = Reduce<std::uint8_t>(sbs, offset, number_of_sbs_8_);
+  offset += number_of_sbs_8_;
+  sbs_16_ = Reduce<std::uint16_t>(sbs, offset, number_of_sbs_16_);
+  offset += number_of_sbs_16_;
+  sbs_32_ = Reduce<std::uint32_t>(sbs, offset, number_of_sbs_32_);
+  offset += number_of_sbs_32_;
+  sbs_64_ = Reduce<std::uint64_t>(sbs, offset, number_of_sbs_64_);
 }
 
 }  // namespace encrypto::motion
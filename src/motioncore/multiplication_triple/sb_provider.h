@@ -24,11 +24,14 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <memory>
 #include <type_traits>
 #include <vector>
 
+#include "statistics/memory_accounting.h"
+#include "utility/bit_vector.h"
 #include "utility/fiber_condition.h"
 #include "utility/reusable_future.h"
 
@@ -41,12 +44,27 @@ class CommunicationLayer;
 namespace encrypto::motion {
 
 class Logger;
+class PreprocessingReader;
+class PreprocessingWriter;
 class SpProvider;
 struct RunTimeStatistics;
 struct SharedBitsData;
 
+/// \brief Sharings of random values r in Z/2^kZ together with the XOR sharings of their bits
+/// (edaBits).
+template <typename T>
+struct EdaBits {
+  // one share of r per SIMD value
+  std::vector<T> arithmetic_shares;
+  // the shares of bit i of all SIMD values in the i-th bit vector
+  std::vector<BitVector<>> boolean_shares;
+};
+
 // Provider for Shared Bits (SBs),
 // sharings of a random bit 0 or 1 in Z/2^kZ
+//
+// SBs are daBits as well: the least significant bits of the arithmetic shares of a bit are its
+// XOR shares, since the sum of the shares modulo 2 is their XOR.
 class SbProvider {
  public:
   bool NeedSbs() const noexcept;
@@ -103,6 +121,31 @@ class SbProvider {
     }
   }
 
+  /// \brief Requests \p number_of_edabits edaBits, each of which consists of sizeof(T) * 8 SBs,
+  /// and returns their offset for GetEdaBits.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  std::size_t RequestEdaBits(const std::size_t number_of_edabits) noexcept {
+    return RequestSbs<T>(number_of_edabits * sizeof(T) * 8);
+  }
+
+  /// \brief Composes \p n edaBits at \p offset from their SBs, i.e., r = sum_i 2^i * r_i, where
+  /// the SBs r_i of the edaBits are laid out bit by bit.
+  template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
+  EdaBits<T> GetEdaBits(const std::size_t offset, const std::size_t n) {
+    constexpr std::size_t kBitLength{sizeof(T) * 8};
+    const auto& sbs{GetSbsAll<T>()};
+    assert(offset + kBitLength * n <= sbs.size());
+    EdaBits<T> edabits{std::vector<T>(n, 0), std::vector<BitVector<>>(kBitLength, BitVector<>(n))};
+    for (std::size_t bit_i = 0; bit_i < kBitLength; ++bit_i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        const T sb{sbs[offset + bit_i * n + j]};
+        edabits.arithmetic_shares[j] += static_cast<T>(sb << bit_i);
+        edabits.boolean_shares[bit_i].Set((sb & 1) == 1, j);
+      }
+    }
+    return edabits;
+  }
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   const std::vector<T>& GetSbsAll() noexcept {
     WaitFinished();
@@ -122,6 +165,21 @@ class SbProvider {
   virtual void PreSetup() = 0;
   virtual void Setup() = 0;
 
+  /// \brief Writes the generated SBs, needs a completed setup.
+  void Save(PreprocessingWriter& writer) const;
+
+  /// \brief Reads the requested number of SBs instead of running the setup.
+  void Load(PreprocessingReader& reader);
+
+  /// \brief Sets the SBs obtained from elsewhere, e.g., from a trusted dealer, instead of running
+  /// the setup.
+  void SetSbs(std::vector<std::uint8_t>&& sbs_8, std::vector<std::uint16_t>&& sbs_16,
+              std::vector<std::uint32_t>&& sbs_32, std::vector<std::uint64_t>&& sbs_64);
+
+  /// \brief Discards the SBs of the last run but keeps the requested numbers of SBs, s.t.
+  /// fresh SBs are provided at the same offsets, see Backend::Clear.
+  void Clear();
+
   // blocking wait
   void WaitFinished() { finished_condition_->Wait(); }
 
@@ -141,7 +199,12 @@ class SbProvider {
   bool finished_ = false;
   std::shared_ptr<FiberCondition> finished_condition_;
 
+  // accounts the SBs and notifies the waiting gates
+  void SetFinished();
+
  private:
+  MemoryAccount memory_account_{MemorySubsystem::kPreprocessing};
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   inline std::vector<T> GetSbs(const std::vector<T>& sbs, const std::size_t offset,
                                const std::size_t n) const {
@@ -167,16 +230,20 @@ class SbProviderFromSps final : public SbProvider {
   void RegisterForMessages();
   void ComputeSbs() noexcept;
 
+  // computes all SBs in Z/2^kZ for the bit size k of T and reduces them to the smaller bit sizes
+  template <typename T>
+  void ComputeSbs();
+
   void ParseOutputs();
 
   communication::CommunicationLayer& communication_layer_;
   std::size_t number_of_parties_;
   std::shared_ptr<SpProvider> sp_provider_;
 
-  std::size_t offset_sps_16_;
-  std::size_t offset_sps_32_;
-  std::size_t offset_sps_64_;
-  std::size_t offset_sps_128_;
+  // the SBs of all bit sizes are computed from one batch of SPs for the largest requested bit
+  // size, since SBs in Z/2^kZ reduced modulo 2^l are SBs in Z/2^lZ for l <= k
+  std::size_t bit_size_{0};
+  std::size_t offset_sps_;
 
   std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> mask_message_futures_;
   std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> reconstruct_message_futures_;
@@ -24,6 +24,7 @@
 
 #include "sp_provider.h"
 #include "oblivious_transfer/ot_provider.h"
+#include "preprocessing_store.h"
 #include "statistics/run_time_statistics.h"
 #include "utility/constants.h"
 #include "utility/logger.h"
@@ -39,6 +40,78 @@ SpProvider::SpProvider(const std::size_t my_id) : my_id_(my_id) {
   finished_condition_ = std::make_shared<FiberCondition>([this]() { return finished_; });
 }
 
+template <typename T>
+static void SaveSps(PreprocessingWriter& writer, const SpVector<T>& sps) {
+  writer.Write(sps.a);
+  writer.Write(sps.c);
+}
+
+template <typename T>
+static void LoadSps(PreprocessingReader& reader, SpVector<T>& sps, std::size_t number_of_sps) {
+  sps.a = reader.Read<T>(number_of_sps);
+  sps.c = reader.Read<T>(number_of_sps);
+}
+
+void SpProvider::Save(PreprocessingWriter& writer) const {
+  SaveSps(writer, sps_8_);
+  SaveSps(writer, sps_16_);
+  SaveSps(writer, sps_32_);
+  SaveSps(writer, sps_64_);
+  SaveSps(writer, sps_128_);
+}
+
+void SpProvider::Load(PreprocessingReader& reader) {
+  LoadSps(reader, sps_8_, number_of_sps_8_);
+  LoadSps(reader, sps_16_, number_of_sps_16_);
+  LoadSps(reader, sps_32_, number_of_sps_32_);
+  LoadSps(reader, sps_64_, number_of_sps_64_);
+  LoadSps(reader, sps_128_, number_of_sps_128_);
+  SetFinished();
+}
+
+void SpProvider::SetSps(SpVector<std::uint8_t>&& sps_8, SpVector<std::uint16_t>&& sps_16,
+                        SpVector<std::uint32_t>&& sps_32, SpVector<std::uint64_t>&& sps_64,
+                        SpVector<__uint128_t>&& sps_128) {
+  if (sps_8.a.size() != number_of_sps_8_ || sps_16.a.size() != number_of_sps_16_ ||
+      sps_32.a.size() != number_of_sps_32_ || sps_64.a.size() != number_of_sps_64_ ||
+      sps_128.a.size() != number_of_sps_128_) {
+    throw std::invalid_argument("Got a different number of SPs than requested");
+  }
+  sps_8_ = std::move(sps_8);
+  sps_16_ = std::move(sps_16);
+  sps_32_ = std::move(sps_32);
+  sps_64_ = std::move(sps_64);
+  sps_128_ = std::move(sps_128);
+  SetFinished();
+}
+
+void SpProvider::Clear() {
+  sps_8_ = {};
+  sps_16_ = {};
+  sps_32_ = {};
+  sps_64_ = {};
+  sps_128_ = {};
+  memory_account_.Set(0);
+  std::scoped_lock lock(finished_condition_->GetMutex());
+  finished_ = false;
+}
+
+template <typename T>
+static std::size_t GetNumberOfBytes(const SpVector<T>& sps) {
+  return (sps.a.size() + sps.c.size()) * sizeof(T);
+}
+
+void SpProvider::SetFinished() {
+  memory_account_.Set(GetNumberOfBytes(sps_8_) + GetNumberOfBytes(sps_16_) +
+                      GetNumberOfBytes(sps_32_) + GetNumberOfBytes(sps_64_) +
+                      GetNumberOfBytes(sps_128_));
+  {
+    std::scoped_lock lock(finished_condition_->GetMutex());
+    finished_ = true;
+  }
+  finished_condition_->NotifyAll();
+}
+
 SpProviderFromOts::SpProviderFromOts(std::vector<std::unique_ptr<OtProvider>>& ot_providers,
                                      const std::size_t my_id, std::shared_ptr<Logger> logger,
                                      RunTimeStatistics& run_time_statistics)
@@ -113,11 +186,7 @@ void SpProviderFromOts::Setup() {
   }
 
   ParseOutputs();
-  {
-    std::scoped_lock lock(finished_condition_->GetMutex());
-    finished_ = true;
-  }
-  finished_condition_->NotifyAll();
+  SetFinished();
 
   run_time_statistics_.RecordEnd<RunTimeStatistics::StatisticsId::kSpSetup>();
   if constexpr (kDebug) {
@@ -135,6 +204,8 @@ static void GenerateRandomPairs(SpVector<T>& sps, std::size_t number_of_sps) {
   }
 }
 
+// the OTs are registered in the first run and renewed for the later runs of a compiled circuit,
+// see Backend::Clear
 template <typename T>
 static void RegisterHelperSend(OtProvider& ot_provider,
                                std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
@@ -142,19 +213,16 @@ static void RegisterHelperSend(OtProvider& ot_provider,
                                std::size_t number_of_sps) {
   constexpr std::size_t bit_size = sizeof(T) * 8;
 
+  auto ot{ots_sender.begin()};
   for (std::size_t sp_id = 0; sp_id < number_of_sps;) {
     const auto batch_size = std::min(max_batch_size, number_of_sps - sp_id);
-    auto ptr{ot_provider.RegisterSendAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_send = dynamic_cast<AcOtSender<T>*>(ptr.get());
-    std::vector<T> vector_to_send;
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const T input = sps.a.at(sp_id + k) << bit_i;
-        vector_to_send.emplace_back(input);
-      }
+    if (ot == ots_sender.end()) {
+      ot = ots_sender.emplace(ot,
+                              ot_provider.RegisterSendAcOt(batch_size * bit_size, sizeof(T) * 8));
     }
-    ot_to_send->SetCorrelations(std::move(vector_to_send));
-    ots_sender.emplace_back(std::move(ptr));
+    auto ot_to_send = dynamic_cast<AcOtSender<T>*>(ot->get());
+    ot_to_send->SetBitCorrelations(std::span(sps.a).subspan(sp_id, batch_size));
+    ++ot;
     sp_id += batch_size;
   }
 }
@@ -166,19 +234,16 @@ static void RegisterHelperReceptor(OtProvider& ot_provider,
                                    std::size_t number_of_sps) {
   constexpr std::size_t bit_size = sizeof(T) * 8;
 
+  auto ot{ots_receiver.begin()};
   for (std::size_t sp_id = 0; sp_id < number_of_sps;) {
     const auto batch_size = std::min(max_batch_size, number_of_sps - sp_id);
-    auto ptr{ot_provider.RegisterReceiveAcOt(batch_size * bit_size, sizeof(T) * 8)};
-    auto ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ptr.get());
-    BitVector<> choices;
-    for (auto k = 0ull; k < batch_size; ++k) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        const bool choice = ((sps.a.at(sp_id + k) >> bit_i) & 1u) == 1;
-        choices.Append(choice);
-      }
+    if (ot == ots_receiver.end()) {
+      ot = ots_receiver.emplace(
+          ot, ot_provider.RegisterReceiveAcOt(batch_size * bit_size, sizeof(T) * 8));
     }
-    ot_to_receive->SetChoices(std::move(choices));
-    ots_receiver.emplace_back(std::move(ptr));
+    auto ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ot->get());
+    ot_to_receive->SetBitChoices(std::span(sps.a).subspan(sp_id, batch_size));
+    ++ot;
     sp_id += batch_size;
   }
 }
@@ -226,19 +291,14 @@ template <typename T>
 static void ParseHelperSend(std::list<std::unique_ptr<BasicOtSender>>& ots_sender,
                             std::size_t max_batch_size, SpVector<T>& sps,
                             std::size_t number_of_sps) {
-  constexpr std::size_t bit_size = sizeof(T) * 8;
-
+  auto ot{ots_sender.begin()};
   for (std::size_t sp_id = 0; sp_id < number_of_sps;) {
     const auto batch_size = std::min(max_batch_size, number_of_sps - sp_id);
-    const auto& ot_to_send = dynamic_cast<AcOtSender<T>*>(ots_sender.front().get());
+    const auto& ot_to_send = dynamic_cast<AcOtSender<T>*>((ot++)->get());
     ot_to_send->ComputeOutputs();
-    const auto output_to_send = ot_to_send->GetOutputs();
-    for (auto j = 0ull; j < batch_size; ++j) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        sps.c.at(sp_id + j) -= 2 * output_to_send[j * bit_size + bit_i];
-      }
-    }
-    ots_sender.pop_front();
+    ot_to_send->AccumulateBitOutputs(std::span(sps.c).subspan(sp_id, batch_size),
+                                     static_cast<T>(-2));
+    ot_to_send->ReleaseOutputs();
     sp_id += batch_size;
   }
 }
@@ -247,19 +307,13 @@ template <typename T>
 static void ParseHelperReceive(std::list<std::unique_ptr<BasicOtReceiver>>& ots_receiver,
                                std::size_t max_batch_size, SpVector<T>& sps,
                                std::size_t number_of_sps) {
-  constexpr std::size_t bit_size = sizeof(T) * 8;
-
+  auto ot{ots_receiver.begin()};
   for (std::size_t sp_id = 0; sp_id < number_of_sps;) {
     const auto batch_size = std::min(max_batch_size, number_of_sps - sp_id);
-    const auto& ot_to_receive = dynamic_cast<AcOtReceiver<T>*>(ots_receiver.front().get());
+    const auto& ot_to_receive = dynamic_cast<AcOtReceiver<T>*>((ot++)->get());
     ot_to_receive->ComputeOutputs();
-    const auto output_to_receive = ot_to_receive->GetOutputs();
-    for (auto j = 0ull; j < batch_size; ++j) {
-      for (auto bit_i = 0u; bit_i < bit_size; ++bit_i) {
-        sps.c.at(sp_id + j) += 2 * output_to_receive[j * bit_size + bit_i];
-      }
-    }
-    ots_receiver.pop_front();
+    ot_to_receive->AccumulateBitOutputs(std::span(sps.c).subspan(sp_id, batch_size), 2);
+    ot_to_receive->ReleaseOutputs();
     sp_id += batch_size;
   }
 }
@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "oblivious_transfer/ot_flavors.h"
+#include "statistics/memory_accounting.h"
 #include "utility/fiber_condition.h"
 
 namespace encrypto::motion {
@@ -41,6 +42,8 @@ class OtVectorSender;
 class OtVectorReceiver;
 struct RunTimeStatistics;
 class Logger;
+class PreprocessingReader;
+class PreprocessingWriter;
 
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 struct SpVector {
@@ -135,6 +138,22 @@ class SpProvider {
   virtual void PreSetup() = 0;
   virtual void Setup() = 0;
 
+  /// \brief Writes the generated SPs, needs a completed setup.
+  void Save(PreprocessingWriter& writer) const;
+
+  /// \brief Reads the requested number of SPs instead of running the setup.
+  void Load(PreprocessingReader& reader);
+
+  /// \brief Sets the SPs obtained from elsewhere, e.g., from a trusted dealer, instead of running
+  /// the setup.
+  void SetSps(SpVector<std::uint8_t>&& sps_8, SpVector<std::uint16_t>&& sps_16,
+              SpVector<std::uint32_t>&& sps_32, SpVector<std::uint64_t>&& sps_64,
+              SpVector<__uint128_t>&& sps_128);
+
+  /// \brief Discards the SPs of the last run but keeps the requested numbers of SPs, s.t.
+  /// fresh SPs are provided at the same offsets, see Backend::Clear.
+  void Clear();
+
   // blocking wait
   void WaitFinished() { finished_condition_->Wait(); }
 
@@ -156,7 +175,12 @@ class SpProvider {
   bool finished_ = false;
   std::shared_ptr<FiberCondition> finished_condition_;
 
+  // accounts the SPs and notifies the waiting gates
+  void SetFinished();
+
  private:
+  MemoryAccount memory_account_{MemorySubsystem::kPreprocessing};
+
   template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
   inline SpVector<T> GetSps(const SpVector<T>& sps, const std::size_t offset,
                             const std::size_t n) const {
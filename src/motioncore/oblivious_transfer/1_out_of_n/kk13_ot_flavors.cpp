@@ -173,9 +173,10 @@ void GKk13Ot128Sender::SendMessages() {
   auto corrections_msg{corrections_future_.get()};
   const auto corrections{communication::GetMessage(corrections_msg.data())->payload()->data()};
 
+  // the rotated differences of one OT, shared by all OTs
+  Block128Vector differences(number_of_messages_);
   for (std::size_t i = 0; i < number_of_ots_; ++i) {
     if (corrections[i]) {
-      Block128Vector differences(number_of_messages_);
       for (std::size_t j = 0; j < number_of_messages_; ++j) {
         auto index = (j + corrections[i]) % number_of_messages_;
         differences[j] =
@@ -359,13 +360,18 @@ void GKk13OtReceiver::ComputeOutputs() {
             data_.receiver_data.random_choices->begin() + ot_id_ + number_of_ots_,
             random_choices_subset.begin());
 
+  BitSpan payload_span(const_cast<std::uint8_t*>(payload->data()),
+                       number_of_ots_ * bitlen_ * number_of_messages_);
   for (std::size_t i = 0; i < number_of_ots_; ++i) {
-    BitVector<> difference =
-        BitSpan(const_cast<std::uint8_t*>(payload->data()),
-                number_of_ots_ * bitlen_ * number_of_messages_)
-            .Subset(bitlen_ * (number_of_messages_ * i + random_choices_subset[i]),
-                    bitlen_ * (number_of_messages_ * i + random_choices_subset[i] + 1));;
-    outputs_[i] = difference ^ data_.receiver_data.outputs[ot_id_ + i];
+    const auto from{bitlen_ * (number_of_messages_ * i + random_choices_subset[i])};
+    if (bitlen_ % 8 == 0) {
+      // xor directly from the received message
+      outputs_[i] = data_.receiver_data.outputs[ot_id_ + i];
+      outputs_[i] ^= payload_span.Subspan(from, from + bitlen_);
+    } else {
+      BitVector<> difference = payload_span.Subset(from, from + bitlen_);
+      outputs_[i] = difference ^ data_.receiver_data.outputs[ot_id_ + i];
+    }
   }
   outputs_computed_ = true;
 }
@@ -177,7 +177,7 @@ void Kk13OtProviderFromKk13OtExtension::SendSetup() {
       throw std::runtime_error(
           fmt::format("Number of message {} must be at least 2", number_of_messages[i]));
     } else if (number_of_messages[i] > kKappa_accent) {
-      throw std::runtime_error(fmt::format("Number of message {} must be less than {}",
+      throw std::runtime_error(fmt::format("Number of message {} must be at most {}",
                                            number_of_messages[i], kKappa_accent));
     }
   }
@@ -293,7 +293,7 @@ void Kk13OtProviderFromKk13OtExtension::ReceiveSetup() {
       throw std::runtime_error(
           fmt::format("Number of message {} must be at least 2", number_of_messages[i]));
     } else if (number_of_messages[i] > kKappa_accent) {
-      throw std::runtime_error(fmt::format("Number of message {} must be less than {}",
+      throw std::runtime_error(fmt::format("Number of message {} must be at most {}",
                                            number_of_messages[i], kKappa_accent));
     }
   }
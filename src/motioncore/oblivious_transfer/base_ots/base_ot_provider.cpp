@@ -25,12 +25,21 @@
 #include "base_ot_provider.h"
 #include "ot_hl17.h"
 
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <openssl/rand.h>
+
 #include "base/configuration.h"
 #include "base/register.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/message_generated.h"
+#include "communication/message.h"
 #include "communication/message_manager.h"
 #include "data_storage/base_ot_data.h"
+#include "primitives/blake2b.h"
 #include "utility/fiber_condition.h"
 #include "utility/logger.h"
 
@@ -43,6 +52,9 @@ BaseOtProvider::BaseOtProvider(communication::CommunicationLayer& communication_
       number_of_parties_(communication_layer_.GetNumberOfParties()),
       my_id_(communication_layer_.GetMyId()),
       data_(number_of_parties_),
+      imported_receiver_base_ots_(number_of_parties_),
+      imported_sender_base_ots_(number_of_parties_),
+      resumption_nonce_futures_(number_of_parties_),
       logger_(communication_layer_.GetLogger()) {
   number_of_ots_.resize(number_of_parties_ - 1, 0);
 }
@@ -53,6 +65,16 @@ void BaseOtProvider::PreSetup() {
   for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
     if (party_id == my_id_) continue;
     std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
+    // too few imported base OTs are computed anew, which both parties decide the same way
+    const std::size_t number_of_ots{number_of_ots_[remapped_party_id]};
+    auto& imported_receiver{imported_receiver_base_ots_[party_id]};
+    if (imported_receiver && imported_receiver->messages_c.size() < number_of_ots) {
+      imported_receiver.reset();
+    }
+    auto& imported_sender{imported_sender_base_ots_[party_id]};
+    if (imported_sender && imported_sender->messages_0.size() < number_of_ots) {
+      imported_sender.reset();
+    }
     data_[party_id].receiver_futures.reserve(number_of_ots_[remapped_party_id]);
     data_[party_id].sender_futures.reserve(number_of_ots_[remapped_party_id]);
     for (std::size_t i = 0; i < number_of_ots_[remapped_party_id]; ++i) {
@@ -63,6 +85,11 @@ void BaseOtProvider::PreSetup() {
           communication_layer_.GetMessageManager().RegisterReceive(
               party_id, communication::MessageType::kBaseROtMessageSender, i));
     }
+    if (imported_receiver_base_ots_[party_id] || imported_sender_base_ots_[party_id]) {
+      resumption_nonce_futures_[party_id] =
+          communication_layer_.GetMessageManager().RegisterReceive(
+              party_id, communication::MessageType::kBaseOtResumptionNonce, 0);
+    }
   }
 }
 
@@ -107,9 +134,14 @@ void BaseOtProvider::ComputeBaseOts() {
   std::vector<std::future<void>> task_futures;
   std::vector<std::unique_ptr<OtHL17>> base_ots;
 
-  task_futures.reserve(2 * (number_of_parties_ - 1));
+  task_futures.reserve(3 * (number_of_parties_ - 1));
   base_ots.reserve(number_of_parties_);
 
+  // the base OTs in both directions with all parties run concurrently, each of them on its share
+  // of the hardware threads
+  const std::size_t number_of_threads_per_task{std::max<std::size_t>(
+      1, std::thread::hardware_concurrency() / (2 * (number_of_parties_ - 1)))};
+
   for (auto i = 0ull; i < number_of_parties_; ++i) {
     if (i == my_id_) {
       base_ots.emplace_back(nullptr);
@@ -121,35 +153,46 @@ void BaseOtProvider::ComputeBaseOts() {
     };
 
     auto& base_ots_data = data_.at(i);
-    base_ots.emplace_back(std::make_unique<OtHL17>(send_function, base_ots_data));
+    base_ots.emplace_back(
+        std::make_unique<OtHL17>(send_function, base_ots_data, number_of_threads_per_task));
     std::size_t remapped_party_id{i > my_id_ ? i - 1 : i};
 
-    task_futures.emplace_back(
-        std::async(std::launch::async, [this, &base_ots, i, remapped_party_id] {
-          auto choices = BitVector<>::SecureRandom(number_of_ots_.at(remapped_party_id));
-          auto chosen_messages = base_ots[i]->Receive(choices);  // sender base ots
-          auto& receiver_data = data_[i].GetReceiverData();
-          receiver_data.c = std::move(choices);
-          for (std::size_t i = 0; i < chosen_messages.size(); ++i) {
-            auto b = receiver_data.messages_c.at(i).begin();
-            std::copy(chosen_messages.at(i).begin(), chosen_messages.at(i).begin() + 16, b);
-          }
-        }));
-
-    task_futures.emplace_back(std::async(std::launch::async, [this, &base_ots, i,
-                                                              remapped_party_id] {
-      auto both_messages =
-          base_ots[i]->Send(number_of_ots_.at(remapped_party_id));  // receiver base ots
-      auto& sender_data = data_[i].GetSenderData();
-      for (std::size_t i = 0; i < both_messages.size(); ++i) {
-        auto b = sender_data.messages_0.at(i).begin();
-        std::copy(both_messages.at(i).first.begin(), both_messages.at(i).first.begin() + 16, b);
-      }
-      for (std::size_t i = 0; i < both_messages.size(); ++i) {
-        auto b = sender_data.messages_1.at(i).begin();
-        std::copy(both_messages.at(i).second.begin(), both_messages.at(i).second.begin() + 16, b);
-      }
-    }));
+    if (imported_receiver_base_ots_[i] || imported_sender_base_ots_[i]) {
+      task_futures.emplace_back(std::async(std::launch::async, [this, i] { ResumeBaseOts(i); }));
+    }
+
+    if (!imported_receiver_base_ots_[i]) {
+      task_futures.emplace_back(
+          std::async(std::launch::async, [this, &base_ots, i, remapped_party_id] {
+            auto choices = BitVector<>::SecureRandom(number_of_ots_.at(remapped_party_id));
+            auto chosen_messages = base_ots[i]->Receive(choices);  // sender base ots
+            auto& receiver_data = data_[i].GetReceiverData();
+            receiver_data.c = std::move(choices);
+            for (std::size_t i = 0; i < chosen_messages.size(); ++i) {
+              auto b = receiver_data.messages_c.at(i).begin();
+              std::copy(chosen_messages.at(i).begin(), chosen_messages.at(i).begin() + 16, b);
+            }
+          }));
+    }
+
+    if (!imported_sender_base_ots_[i]) {
+      task_futures.emplace_back(
+          std::async(std::launch::async, [this, &base_ots, i, remapped_party_id] {
+            auto both_messages =
+                base_ots[i]->Send(number_of_ots_.at(remapped_party_id));  // receiver base ots
+            auto& sender_data = data_[i].GetSenderData();
+            for (std::size_t i = 0; i < both_messages.size(); ++i) {
+              auto b = sender_data.messages_0.at(i).begin();
+              std::copy(both_messages.at(i).first.begin(), both_messages.at(i).first.begin() + 16,
+                        b);
+            }
+            for (std::size_t i = 0; i < both_messages.size(); ++i) {
+              auto b = sender_data.messages_1.at(i).begin();
+              std::copy(both_messages.at(i).second.begin(),
+                        both_messages.at(i).second.begin() + 16, b);
+            }
+          }));
+    }
   }
 
   std::for_each(task_futures.begin(), task_futures.end(), [](auto& f) { f.get(); });
@@ -162,72 +205,129 @@ void BaseOtProvider::ComputeBaseOts() {
   }
 }
 
-void BaseOtProvider::ImportBaseOts([[maybe_unused]] std::size_t party_id,
-                                   [[maybe_unused]] const ReceiverMessage& messages) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   auto& receiver_data = data_.at(party_id).GetReceiverData();
-   if (receiver_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Found previously computed receiver base OTs for Party#{}", party_id));
-
-   receiver_data.c = messages.c;
-   receiver_data.messages_c = messages.messages_c;
-
-   {
-     std::scoped_lock lock(receiver_data.is_ready_condition->GetMutex());
-     receiver_data.is_ready = true;
-   }
-   receiver_data.is_ready_condition->NotifyAll();*/
-}
-
-void BaseOtProvider::ImportBaseOts([[maybe_unused]] std::size_t party_id,
-                                   [[maybe_unused]] const SenderMessage& messages) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   auto& sender_data = data_.at(party_id).GetSenderData();
-   if (sender_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Found previously computed sender base OTs for Party#{}", party_id));
-
-   sender_data.messages_0 = messages.messages_0;
-   sender_data.messages_1 = messages.messages_1;
-
-   {
-     std::scoped_lock lock(sender_data.is_ready_condition->GetMutex());
-     sender_data.is_ready = true;
-   }
-   sender_data.is_ready_condition->NotifyAll();*/
-}
-
-std::pair<ReceiverMessage, SenderMessage> BaseOtProvider::ExportBaseOts(
-    [[maybe_unused]] std::size_t party_id) {
-  // TODO
-  throw std::runtime_error("Not completely implemented yet"); /*
-   if (party_id == my_id_)
-     throw std::runtime_error("Base OTs export is only possible for other parties");
-
-   auto& base_ot_data = data_.at(party_id);
-   auto& receiver_data = base_ot_data.GetReceiverData();
-   auto& sender_data = base_ot_data.GetSenderData();
+void BaseOtProvider::ResumeBaseOts(std::size_t party_id) {
+  constexpr std::size_t kNonceSize{16};
+  std::array<std::uint8_t, kNonceSize> my_nonce;
+  if (RAND_bytes(my_nonce.data(), my_nonce.size()) != 1) {
+    throw std::runtime_error("Error while generating the base OT resumption nonce");
+  }
+  communication_layer_.SendMessage(
+      party_id,
+      communication::BuildMessage(communication::MessageType::kBaseOtResumptionNonce, 0, my_nonce)
+          .Release());
+  const auto nonce_message{resumption_nonce_futures_[party_id].get()};
+  const auto other_nonce{communication::GetMessage(nonce_message.data())->payload()};
+  if (other_nonce->size() != kNonceSize) {
+    throw std::runtime_error(
+        fmt::format("Received base OT resumption nonce of invalid size from Party#{}", party_id));
+  }
 
-   if (!receiver_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Trying to export non-existing receiver base OTs for Party#{}", party_id));
+  // the new messages are Blake2b(message || nonce of lower id || nonce of higher id), where the
+  // nonces are the same for both parties
+  constexpr std::size_t kMessageSize{16};
+  constexpr std::size_t kInputSize{kMessageSize + 2 * kNonceSize};
+  std::array<std::uint8_t, 2 * kNonceSize> nonces;
+  auto lower_nonce{nonces.begin()}, higher_nonce{lower_nonce + kNonceSize};
+  std::copy(my_nonce.begin(), my_nonce.end(), my_id_ < party_id ? lower_nonce : higher_nonce);
+  std::copy(other_nonce->begin(), other_nonce->end(),
+            my_id_ < party_id ? higher_nonce : lower_nonce);
+  // derives the first number_of_ots results from the messages, hashed together by Blake2bBatch
+  auto derive = [&nonces](const BaseOtMessages& messages, BaseOtMessages& results,
+                          std::size_t number_of_ots) {
+    std::vector<std::uint8_t> inputs(number_of_ots * kInputSize);
+    std::vector<std::uint8_t> digests(number_of_ots * EVP_MAX_MD_SIZE);
+    std::vector<const std::uint8_t*> input_pointers(number_of_ots);
+    std::vector<std::uint8_t*> digest_pointers(number_of_ots);
+    for (std::size_t i = 0; i < number_of_ots; ++i) {
+      std::uint8_t* input{inputs.data() + i * kInputSize};
+      std::memcpy(input, messages[i].data(), kMessageSize);
+      std::copy(nonces.begin(), nonces.end(), input + kMessageSize);
+      input_pointers[i] = input;
+      digest_pointers[i] = digests.data() + i * EVP_MAX_MD_SIZE;
+    }
+    Blake2bBatch(input_pointers, kInputSize, digest_pointers);
+    for (std::size_t i = 0; i < number_of_ots; ++i) {
+      std::memcpy(results[i].data(), digest_pointers[i], kMessageSize);
+    }
+  };
 
-   if (!sender_data.is_ready)
-     throw std::runtime_error(
-         fmt::format("Trying to export non-existing sender base OTs for Party#{}", party_id));
+  std::size_t remapped_party_id{party_id > my_id_ ? party_id - 1 : party_id};
+  const std::size_t number_of_ots{number_of_ots_.at(remapped_party_id)};
+  if (const auto& imported = imported_receiver_base_ots_[party_id]) {
+    if (imported->messages_c.size() < number_of_ots) {
+      throw std::logic_error(fmt::format(
+          "{} receiver base OTs with Party#{} were imported, but {} are needed",
+          imported->messages_c.size(), party_id, number_of_ots));
+    }
+    auto& receiver_data{data_[party_id].GetReceiverData()};
+    receiver_data.c = imported->c.Subset(0, number_of_ots);
+    derive(imported->messages_c, receiver_data.messages_c, number_of_ots);
+  }
+  if (const auto& imported = imported_sender_base_ots_[party_id]) {
+    if (imported->messages_0.size() < number_of_ots) {
+      throw std::logic_error(fmt::format(
+          "{} sender base OTs with Party#{} were imported, but {} are needed",
+          imported->messages_0.size(), party_id, number_of_ots));
+    }
+    auto& sender_data{data_[party_id].GetSenderData()};
+    derive(imported->messages_0, sender_data.messages_0, number_of_ots);
+    derive(imported->messages_1, sender_data.messages_1, number_of_ots);
+  }
+}
 
-   std::pair<ReceiverMessage, SenderMessage> base_ots;
+void BaseOtProvider::ImportBaseOts(std::size_t party_id, const ReceiverMessage& messages) {
+  if (party_id == my_id_ || party_id >= number_of_parties_) {
+    throw std::invalid_argument(fmt::format("Cannot import base OTs with Party#{}", party_id));
+  }
+  if (messages.c.GetSize() != messages.messages_c.size()) {
+    throw std::invalid_argument(
+        fmt::format("Imported {} choice bits for {} receiver base OTs with Party#{}",
+                    messages.c.GetSize(), messages.messages_c.size(), party_id));
+  }
+  imported_receiver_base_ots_[party_id] = messages;
+}
 
-   std::get<0>(base_ots).c = receiver_data.c;
-   std::get<0>(base_ots).messages_c = receiver_data.messages_c;
+void BaseOtProvider::ImportBaseOts(std::size_t party_id, const SenderMessage& messages) {
+  if (party_id == my_id_ || party_id >= number_of_parties_) {
+    throw std::invalid_argument(fmt::format("Cannot import base OTs with Party#{}", party_id));
+  }
+  if (messages.messages_0.size() != messages.messages_1.size()) {
+    throw std::invalid_argument(
+        fmt::format("Imported {} and {} sender base OT messages with Party#{}",
+                    messages.messages_0.size(), messages.messages_1.size(), party_id));
+  }
+  imported_sender_base_ots_[party_id] = messages;
+}
 
-   std::get<1>(base_ots).messages_0 = sender_data.messages_0;
-   std::get<1>(base_ots).messages_1 = sender_data.messages_1;
+void BaseOtProvider::Clear() {
+  if (!HasWork() || !IsOnlineReady()) return;
+  for (std::size_t party_id = 0; party_id < number_of_parties_; ++party_id) {
+    if (party_id == my_id_) continue;
+    auto [receiver_base_ots, sender_base_ots] = ExportBaseOts(party_id);
+    imported_receiver_base_ots_[party_id] = std::move(receiver_base_ots);
+    imported_sender_base_ots_[party_id] = std::move(sender_base_ots);
+    // registered anew in PreSetup
+    data_[party_id].receiver_futures.clear();
+    data_[party_id].sender_futures.clear();
+  }
+  ResetOnlineIsReady();
+}
 
-   return base_ots;*/
+std::pair<ReceiverMessage, SenderMessage> BaseOtProvider::ExportBaseOts(std::size_t party_id) {
+  if (party_id == my_id_ || party_id >= number_of_parties_) {
+    throw std::invalid_argument(fmt::format("Cannot export base OTs with Party#{}", party_id));
+  }
+  WaitOnline();
+  const auto& base_ot_data{data_.at(party_id)};
+  const auto& receiver_data{base_ot_data.GetReceiverData()};
+  const auto& sender_data{base_ot_data.GetSenderData()};
+
+  std::pair<ReceiverMessage, SenderMessage> base_ots;
+  base_ots.first.c = receiver_data.c;
+  base_ots.first.messages_c = receiver_data.messages_c;
+  base_ots.second.messages_0 = sender_data.messages_0;
+  base_ots.second.messages_1 = sender_data.messages_1;
+  return base_ots;
 }
 
 }  // namespace encrypto::motion
@@ -26,6 +26,7 @@
 
 #include <array>
 #include <cstddef>
+#include <optional>
 
 #include "data_storage/base_ot_data.h"
 #include "utility/bit_vector.h"
@@ -62,9 +63,28 @@ class BaseOtProvider : public FiberOnlineWaitable {
   BaseOtProvider(communication::CommunicationLayer&);
   ~BaseOtProvider();
   void ComputeBaseOts();
+
+  /// \brief Resume the receiver base OTs with party_id from an earlier session instead of
+  /// computing them, where the other party needs to import the corresponding sender base OTs.
+  /// The messages are re-randomized with fresh nonces of both parties in ComputeBaseOts, s.t. the
+  /// OT extension never reuses the keys of the earlier session.  If fewer base OTs were imported
+  /// than requested, they are computed anew instead.  Must be called before PreSetup().
+  /// \throws std::invalid_argument if party_id is my id or the sizes of c and messages_c differ.
   void ImportBaseOts(std::size_t party_id, const ReceiverMessage& messages);
+
+  /// \brief See the overload above, for the sender base OTs.
   void ImportBaseOts(std::size_t party_id, const SenderMessage& messages);
+
+  /// \brief Returns the base OTs with party_id for importing them in a later session, blocks
+  /// until ComputeBaseOts is finished.
+  /// \throws std::invalid_argument if party_id is my id.
   std::pair<ReceiverMessage, SenderMessage> ExportBaseOts(std::size_t party_id);
+
+  /// \brief Prepares the base OTs for another run with the same requests, in which they are
+  /// resumed with fresh nonces like imported ones, see ImportBaseOts.  Does nothing if the base
+  /// OTs were not computed yet.
+  void Clear();
+
   BaseOtData& GetBaseOtsData(std::size_t party_id) { return data_.at(party_id); }
   const BaseOtData& GetBaseOtsData(std::size_t party_id) const { return data_.at(party_id); }
   void PreSetup();
@@ -82,9 +102,15 @@ class BaseOtProvider : public FiberOnlineWaitable {
   std::size_t number_of_parties_;
   std::size_t my_id_;
   std::vector<BaseOtData> data_;
+  std::vector<std::optional<ReceiverMessage>> imported_receiver_base_ots_;
+  std::vector<std::optional<SenderMessage>> imported_sender_base_ots_;
+  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> resumption_nonce_futures_;
   std::shared_ptr<Logger> logger_;
 
   Logger& GetLogger();
+
+  // derives the base OTs with party_id from the imported ones and nonces exchanged with party_id
+  void ResumeBaseOts(std::size_t party_id);
 };
 
 }  // namespace encrypto::motion
@@ -26,6 +26,7 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <exception>
 
 #include "base/backend.h"
 #include "communication/message.h"
@@ -37,8 +38,10 @@
 namespace encrypto::motion {
 
 OtHL17::OtHL17(std::function<void(flatbuffers::FlatBufferBuilder&&)> send,
-               BaseOtData& base_ots_data)
-    : send_function_(send), base_ots_data_(base_ots_data) {}
+               BaseOtData& base_ots_data, std::size_t number_of_threads)
+    : send_function_(send),
+      base_ots_data_(base_ots_data),
+      number_of_threads_(static_cast<int>(std::max<std::size_t>(number_of_threads, 1))) {}
 
 // Notation
 // * Group GG
@@ -204,23 +207,21 @@ std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> OtHL17::S
   std::vector<std::array<std::uint8_t, kCurve25519GeByteSize>> messages_s0(number_of_ots);
   std::vector<std::pair<std::vector<std::byte>, std::vector<std::byte>>> output(number_of_ots);
 
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
+  // the OTs are independent, so their scalar multiplications run in parallel
+  ParallelFor(number_of_ots, number_of_threads_, [&](std::size_t i) {
     Send0(states[i], messages_s0[i]);
-  }
-
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
     std::span s(reinterpret_cast<const std::uint8_t*>(messages_s0[i].data()),
                 messages_s0[i].size());
     auto msg{communication::BuildMessage(communication::MessageType::kBaseROtMessageSender, i, s)};
     send_function_(std::move(msg));
     Send1(states[i]);
-  }
+  });
 
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
+  ParallelFor(number_of_ots, number_of_threads_, [&](std::size_t i) {
     auto raw_message{base_ots_data_.receiver_futures[i].get()};
     auto payload{communication::GetMessage(raw_message.data())->payload()};
-    output.at(i) = Send2(states.at(i), std::span(payload->data(), payload->size()));
-  }
+    output[i] = Send2(states[i], std::span(payload->data(), payload->size()));
+  });
 
   base_ots_sender.SetOnlineIsReady();
 
@@ -241,7 +242,7 @@ std::vector<std::vector<std::byte>> OtHL17::Receive(const BitVector<>& choices)
     Receive0(states.at(i), choices.Get(i));
   }
 
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
+  ParallelFor(number_of_ots, number_of_threads_, [&](std::size_t i) {
     auto raw_message{base_ots_data_.sender_futures[i].get()};
     auto payload{communication::GetMessage(raw_message.data())->payload()};
     Receive1(states[i], messages_r1[i], std::span(payload->data(), payload->size()));
@@ -250,11 +251,10 @@ std::vector<std::vector<std::byte>> OtHL17::Receive(const BitVector<>& choices)
     auto msg{
         communication::BuildMessage(communication::MessageType::kBaseROtMessageReceiver, i, s)};
     send_function_(std::move(msg));
-  }
+  });
 
-  for (std::size_t i = 0; i < number_of_ots; ++i) {
-    output.at(i) = Receive2(states.at(i));
-  }
+  ParallelFor(number_of_ots, number_of_threads_,
+              [&](std::size_t i) { output[i] = Receive2(states[i]); });
 
   base_ots_receiver.SetOnlineIsReady();
 
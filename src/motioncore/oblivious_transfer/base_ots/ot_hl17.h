@@ -43,7 +43,12 @@ struct BaseOtData;
  */
 class OtHL17 final : public RandomOt {
  public:
-  OtHL17(std::function<void(flatbuffers::FlatBufferBuilder&&)> send, BaseOtData& data_storage);
+  /**
+   * The independent OTs of a batch are distributed over number_of_threads threads, since each
+   * of them needs several scalar multiplications.
+   */
+  OtHL17(std::function<void(flatbuffers::FlatBufferBuilder&&)> send, BaseOtData& data_storage,
+         std::size_t number_of_threads = 1);
 
   /**
    * Send/receive for a single random OT.
@@ -70,6 +75,8 @@ class OtHL17 final : public RandomOt {
 
   BaseOtData& base_ots_data_;
 
+  const int number_of_threads_;
+
   // public:  // for testing
   struct SenderState {
     SenderState(std::size_t ot_id) : i(ot_id) {}
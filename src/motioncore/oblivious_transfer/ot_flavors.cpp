@@ -22,21 +22,45 @@
 
 #include "ot_flavors.h"
 
+#include <bit>
+
 #include "communication/message.h"
 #include "data_storage/ot_extension_data.h"
 #include "utility/fiber_condition.h"
 
 namespace encrypto::motion {
 
+namespace {
+
+// sums[k] += factor * (outputs[k * bits] + ... + outputs[(k + 1) * bits - 1]) for the bits of T,
+// the inner sums run over contiguous values and are vectorized
+template <typename T>
+void AccumulateBitSums(const std::vector<T>& outputs, std::span<T> sums, T factor) {
+  constexpr std::size_t kBitSize{8 * sizeof(T)};
+  assert(outputs.size() == sums.size() * kBitSize);
+  const T* output{outputs.data()};
+  for (auto& sum : sums) {
+    T bit_sum{0};
+    for (std::size_t bit_i = 0; bit_i < kBitSize; ++bit_i) {
+      bit_sum += output[bit_i];
+    }
+    sum += factor * bit_sum;
+    output += kBitSize;
+  }
+}
+
+}  // namespace
+
 // ---------- BasicOtSender ----------
 
 BasicOtSender::BasicOtSender(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
-                             OtExtensionData& data)
+                             OtExtensionData& data, bool packed)
     : OtVector(ot_id, number_of_ots, bitlength, data) {
-  data_.sender_data.y0.resize(data_.sender_data.y0.size() + number_of_ots);
-  data_.sender_data.y1.resize(data_.sender_data.y1.size() + number_of_ots);
+  data_.sender_data.y0.Resize(data_.sender_data.y0.GetSize() + number_of_ots);
+  data_.sender_data.y1.Resize(data_.sender_data.y1.GetSize() + number_of_ots);
   data_.sender_data.bitlengths.resize(data_.sender_data.bitlengths.size() + number_of_ots,
                                       bitlength);
+  data_.sender_data.packed.Append(BitVector<>(number_of_ots, packed));
 }
 
 void BasicOtSender::WaitSetup() const { data_.sender_data.WaitSetup(); }
@@ -44,15 +68,19 @@ void BasicOtSender::WaitSetup() const { data_.sender_data.WaitSetup(); }
 // ---------- BasicOtReceiver ----------
 
 BasicOtReceiver::BasicOtReceiver(std::size_t ot_id, std::size_t number_of_ots,
-                                 std::size_t bitlength, OtExtensionData& data)
+                                 std::size_t bitlength, OtExtensionData& data, bool packed)
     : OtVector(ot_id, number_of_ots, bitlength, data) {
-  data_.receiver_data.outputs.resize(ot_id + number_of_ots);
+  data_.receiver_data.outputs.Resize(ot_id + number_of_ots);
   data_.receiver_data.bitlengths.resize(ot_id + number_of_ots, bitlength);
+  data_.receiver_data.packed.Resize(ot_id, true);
+  data_.receiver_data.packed.Append(BitVector<>(number_of_ots, packed));
 }
 
 void BasicOtReceiver::WaitSetup() const { data_.receiver_data.WaitSetup(); }
 
 void BasicOtReceiver::SendCorrections() {
+  // the corrections of a new run replace those of the last one
+  SynchronizeRun();
   assert(data_.receiver_data.IsSetupReady());
   if (choices_.Empty()) {
     throw std::runtime_error("Choices in must be set before calling SendCorrections()");
@@ -70,15 +98,17 @@ void BasicOtReceiver::SendCorrections() {
 ROtSender::ROtSender(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
                      OtExtensionData& data)
     : OtVector(ot_id, number_of_ots, bitlength, data) {
-  data_.sender_data.y0.resize(data_.sender_data.y0.size() + number_of_ots);
-  data_.sender_data.y1.resize(data_.sender_data.y1.size() + number_of_ots);
+  data_.sender_data.y0.Resize(data_.sender_data.y0.GetSize() + number_of_ots);
+  data_.sender_data.y1.Resize(data_.sender_data.y1.GetSize() + number_of_ots);
   data_.sender_data.bitlengths.resize(data_.sender_data.bitlengths.size() + number_of_ots,
                                       bitlength);
+  data_.sender_data.packed.Append(BitVector<>(number_of_ots, false));
 }
 
 void ROtSender::WaitSetup() const { data_.sender_data.WaitSetup(); }
 
 void ROtSender::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -96,6 +126,7 @@ void ROtSender::ComputeOutputs() {
     outputs_[i].Append(data_.sender_data.y0.at(ot_id_ + i));
     outputs_[i].Append(data_.sender_data.y1.at(ot_id_ + i));
   }
+  ReleaseSenderOutputs();
 
   // remember that we have done this
   outputs_computed_ = true;
@@ -104,13 +135,16 @@ void ROtSender::ComputeOutputs() {
 ROtReceiver::ROtReceiver(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
                          OtExtensionData& data)
     : OtVector(ot_id, number_of_ots, bitlength, data) {
-  data_.receiver_data.outputs.resize(ot_id + number_of_ots);
+  data_.receiver_data.outputs.Resize(ot_id + number_of_ots);
   data_.receiver_data.bitlengths.resize(ot_id + number_of_ots, bitlength);
+  data_.receiver_data.packed.Resize(ot_id, true);
+  data_.receiver_data.packed.Append(BitVector<>(number_of_ots, false));
 }
 
 void ROtReceiver::WaitSetup() const { data_.receiver_data.WaitSetup(); }
 
 void ROtReceiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -122,9 +156,12 @@ void ROtReceiver::ComputeOutputs() {
   // copy random choices to the internal buffer
   choices_ = data_.receiver_data.random_choices->Subset(ot_id_, ot_id_ + number_of_ots_);
 
-  // copy the selected random mask to the internal buffer
-  outputs_.assign(data_.receiver_data.outputs.begin() + ot_id_,
-                  data_.receiver_data.outputs.begin() + ot_id_ + number_of_ots_);
+  // move the selected random mask to the internal buffer
+  outputs_.resize(number_of_ots_);
+  for (std::size_t i = 0; i < number_of_ots_; ++i) {
+    outputs_[i] = std::move(data_.receiver_data.outputs.at(ot_id_ + i));
+  }
+  ReleaseReceiverOutputs();
 
   // flag that the outputs have been computed
   outputs_computed_ = true;
@@ -139,6 +176,7 @@ XcOtSender::XcOtSender(std::size_t ot_id, std::size_t number_of_ots, std::size_t
           data_.party_id, communication::MessageType::kOtExtensionReceiverCorrections, ot_id)) {}
 
 void XcOtSender::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -166,6 +204,7 @@ void XcOtSender::ComputeOutputs() {
     }
     outputs_[i].Append(correlations_[i] ^ outputs_[i]);
   }
+  ReleaseSenderOutputs(2);
 
   // remember that we have done this
   outputs_computed_ = true;
@@ -178,6 +217,7 @@ void XcOtSender::SendMessages() const {
     buffer.Append(correlations_[i] ^ data_.sender_data.y0.at(ot_id_ + i) ^
                   data_.sender_data.y1.at(ot_id_ + i));
   }
+  ReleaseSenderOutputs(2);
 
   auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
                              buffer.GetData().size())};
@@ -196,6 +236,7 @@ XcOtReceiver::XcOtReceiver(const std::size_t ot_id, const std::size_t number_of_
 }
 
 void XcOtReceiver::ComputeOutputs() {
+  SynchronizeRun();
   assert(data_.receiver_data.IsSetupReady());
   if (outputs_computed_) {
     // already done
@@ -216,9 +257,15 @@ void XcOtReceiver::ComputeOutputs() {
     outputs_[i] = std::move(data_.receiver_data.outputs[ot_id_ + i]);
     assert(outputs_[i].GetSize() == bitlength_);
     if (choices_[i]) {
-      outputs_[i] ^= sender_message_span.Subset(i * bitlength_, (i + 1) * bitlength_);
+      if (bitlength_ % 8 == 0) {
+        // xor directly from the received message
+        outputs_[i] ^= sender_message_span.Subspan(i * bitlength_, (i + 1) * bitlength_);
+      } else {
+        outputs_[i] ^= sender_message_span.Subset(i * bitlength_, (i + 1) * bitlength_);
+      }
     }
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -231,6 +278,7 @@ FixedXcOt128Sender::FixedXcOt128Sender(std::size_t ot_id, std::size_t number_of_
           data_.party_id, communication::MessageType::kOtExtensionReceiverCorrections, ot_id)) {}
 
 void FixedXcOt128Sender::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -257,6 +305,7 @@ void FixedXcOt128Sender::ComputeOutputs() {
       outputs_[i].LoadFromMemory(data_.sender_data.y0.at(ot_id_ + i).GetData().data());
     }
   }
+  ReleaseSenderOutputs(2);
 
   // remember that we have done this
   outputs_computed_ = true;
@@ -269,6 +318,7 @@ void FixedXcOt128Sender::SendMessages() const {
     buffer[i] ^= data_.sender_data.y0.at(ot_id_ + i).GetData().data();
     buffer[i] ^= data_.sender_data.y1.at(ot_id_ + i).GetData().data();
   }
+  ReleaseSenderOutputs(2);
 
   auto buffer_span{
       std::span(reinterpret_cast<const std::uint8_t*>(buffer.data()), buffer.ByteSize())};
@@ -287,6 +337,7 @@ FixedXcOt128Receiver::FixedXcOt128Receiver(const std::size_t ot_id, const std::s
 }
 
 void FixedXcOt128Receiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -307,6 +358,7 @@ void FixedXcOt128Receiver::ComputeOutputs() {
       outputs_[i] ^= Block128::MakeFromMemory(reinterpret_cast<const std::byte*>(pointer) + 16 * i);
     }
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -314,11 +366,12 @@ void FixedXcOt128Receiver::ComputeOutputs() {
 
 XcOtBitSender::XcOtBitSender(const std::size_t ot_id, const std::size_t number_of_ots,
                              OtExtensionData& data)
-    : BasicOtSender(ot_id, number_of_ots, 1, data),
+    : BasicOtSender(ot_id, number_of_ots, 1, data, true),
       corrections_future_(data.message_manager.RegisterReceive(
           data_.party_id, communication::MessageType::kOtExtensionReceiverCorrections, ot_id)) {}
 
 void XcOtBitSender::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -334,17 +387,14 @@ void XcOtBitSender::ComputeOutputs() {
   std::vector<std::uint8_t> corrections_message{corrections_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(corrections_message.data())->payload()->data());
-  BitSpan corrections_span{pointer, number_of_ots_};
+  BitVector<> corrections(reinterpret_cast<const std::byte*>(pointer), number_of_ots_);
 
-  // take one of the precomputed outputs
-  for (std::size_t i = 0; i < number_of_ots_; ++i) {
-    if (corrections_span[i]) {
-      // if the correction bit is 1, we need to swap
-      outputs_.Set(bool(data_.sender_data.y1.at(ot_id_ + i).GetData()[0] & kSetBitMask[0]), i);
-    } else {
-      outputs_.Set(bool(data_.sender_data.y0.at(ot_id_ + i).GetData()[0] & kSetBitMask[0]), i);
-    }
-  }
+  // take one of the precomputed outputs, if the correction bit is 1, we need to swap
+  const auto y0{data_.sender_data.y0_bits.Subset(ot_id_, ot_id_ + number_of_ots_)};
+  const auto y1{data_.sender_data.y1_bits.Subset(ot_id_, ot_id_ + number_of_ots_)};
+  outputs_ = y0 ^ (corrections & (y0 ^ y1));
+  // the packed outputs are kept, only the unused per-OT outputs are released
+  ReleaseSenderOutputs(2);
 
   // remember that we have done this
   outputs_computed_ = true;
@@ -353,13 +403,10 @@ void XcOtBitSender::ComputeOutputs() {
 void XcOtBitSender::SendMessages() const {
   WaitSetup();
 
-  auto buffer = correlations_;
-  for (std::size_t i = 0; i < number_of_ots_; ++i) {
-    auto tmp = buffer[i];
-    tmp ^= bool(data_.sender_data.y0.at(ot_id_ + i).GetData()[0] & kSetBitMask[0]);
-    tmp ^= bool(data_.sender_data.y1.at(ot_id_ + i).GetData()[0] & kSetBitMask[0]);
-    buffer.Set(tmp, i);
-  }
+  auto buffer = correlations_ ^
+                data_.sender_data.y0_bits.Subset(ot_id_, ot_id_ + number_of_ots_) ^
+                data_.sender_data.y1_bits.Subset(ot_id_, ot_id_ + number_of_ots_);
+  ReleaseSenderOutputs(2);
 
   auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
                              buffer.GetData().size())};
@@ -372,12 +419,13 @@ void XcOtBitSender::SendMessages() const {
 
 XcOtBitReceiver::XcOtBitReceiver(std::size_t ot_id, const std::size_t number_of_ots,
                                  OtExtensionData& data)
-    : BasicOtReceiver(ot_id, number_of_ots, 1, data), outputs_(number_of_ots) {
+    : BasicOtReceiver(ot_id, number_of_ots, 1, data, true), outputs_(number_of_ots) {
   sender_message_future_ = data_.message_manager.RegisterReceive(
       data_.party_id, communication::MessageType::kOtExtensionSender, ot_id);
 }
 
 void XcOtBitReceiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -392,13 +440,9 @@ void XcOtBitReceiver::ComputeOutputs() {
   std::vector<std::uint8_t> sender_message{sender_message_future_.get()};
   auto pointer = const_cast<std::uint8_t*>(
       communication::GetMessage(sender_message.data())->payload()->data());
-  outputs_ = choices_ & BitSpan(pointer, choices_.GetSize());
-
-  for (std::size_t i = 0; i < number_of_ots_; ++i) {
-    auto tmp = outputs_[i];
-    outputs_.Set(
-        tmp ^ bool(data_.receiver_data.outputs.at(ot_id_ + i).GetData()[0] & kSetBitMask[0]), i);
-  }
+  outputs_ = (choices_ & BitSpan(pointer, choices_.GetSize())) ^
+             data_.receiver_data.output_bits.Subset(ot_id_, ot_id_ + number_of_ots_);
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -412,8 +456,31 @@ AcOtSender<T>::AcOtSender(std::size_t ot_id, std::size_t number_of_ots, std::siz
       corrections_future_(data.message_manager.RegisterReceive(
           data_.party_id, communication::MessageType::kOtExtensionReceiverCorrections, ot_id)) {}
 
+template <typename T>
+void AcOtSender<T>::SetBitCorrelations(std::span<const T> values) {
+  constexpr std::size_t kBitSize{8 * sizeof(T)};
+  assert(vector_size_ == 1);
+  assert(values.size() * kBitSize == number_of_ots_);
+  correlations_.resize(number_of_ots_);
+  T* correlation{correlations_.data()};
+  for (const T value : values) {
+    for (std::size_t bit_i = 0; bit_i < kBitSize; ++bit_i) {
+      correlation[bit_i] = static_cast<T>(value << bit_i);
+    }
+    correlation += kBitSize;
+  }
+}
+
+template <typename T>
+void AcOtSender<T>::AccumulateBitOutputs(std::span<T> sums, T factor) const {
+  assert(outputs_computed_);
+  assert(vector_size_ == 1);
+  AccumulateBitSums(outputs_, sums, factor);
+}
+
 template <typename T>
 void AcOtSender<T>::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // the work was already done
     return;
@@ -457,6 +524,7 @@ void AcOtSender<T>::ComputeOutputs() {
       }
     }
   }
+  ReleaseSenderOutputs(2);
 
   // remember that we have done this
   outputs_computed_ = true;
@@ -486,6 +554,7 @@ void AcOtSender<T>::SendMessages() const {
     }
   }
   assert(buffer.size() == number_of_ots_ * vector_size_);
+  ReleaseSenderOutputs(2);
 
   auto buffer_span{
       std::span(reinterpret_cast<const std::uint8_t*>(buffer.data()), sizeof(T) * buffer.size())};
@@ -506,8 +575,25 @@ AcOtReceiver<T>::AcOtReceiver(std::size_t ot_id, std::size_t number_of_ots, std:
       data_.party_id, communication::MessageType::kOtExtensionSender, ot_id);
 }
 
+template <typename T>
+void AcOtReceiver<T>::SetBitChoices(std::span<const T> values) {
+  static_assert(std::endian::native == std::endian::little,
+                "the bits of the values are copied in the order of the BitVector");
+  assert(vector_size_ == 1);
+  assert(values.size() * 8 * sizeof(T) == number_of_ots_);
+  choices_ = BitVector<>(reinterpret_cast<const std::byte*>(values.data()), number_of_ots_);
+}
+
+template <typename T>
+void AcOtReceiver<T>::AccumulateBitOutputs(std::span<T> sums, T factor) const {
+  assert(outputs_computed_);
+  assert(vector_size_ == 1);
+  AccumulateBitSums(outputs_, sums, factor);
+}
+
 template <typename T>
 void AcOtReceiver<T>::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -548,6 +634,7 @@ void AcOtReceiver<T>::ComputeOutputs() {
       }
     }
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -588,6 +675,7 @@ void GOt128Sender::SendMessages() const {
       buffer[2 * i + 1] ^= data_.sender_data.y1.at(ot_id_ + i).GetData().data();
     }
   }
+  ReleaseSenderOutputs();
   auto buffer_span{
       std::span(reinterpret_cast<const std::uint8_t*>(buffer.data()->data()), buffer.ByteSize())};
   auto msg{communication::BuildMessage(communication::MessageType::kOtExtensionSender, ot_id_,
@@ -605,6 +693,7 @@ GOt128Receiver::GOt128Receiver(const std::size_t ot_id, const std::size_t number
 }
 
 void GOt128Receiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -627,6 +716,7 @@ void GOt128Receiver::ComputeOutputs() {
                                              2 * i * Block128::kBlockSize + offset)};
     outputs_[i] = difference ^ data_.receiver_data.outputs.at(ot_id_ + i).GetData().data();
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -654,6 +744,7 @@ void GOtBitSender::SendMessages() const {
     buffer.Set(b0 ^ data_.sender_data.y0.at(ot_id_ + i).Get(0), 2 * i);
     buffer.Set(b1 ^ data_.sender_data.y1.at(ot_id_ + i).Get(0), 2 * i + 1);
   }
+  ReleaseSenderOutputs();
 
   auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
                              buffer.GetData().size())};
@@ -666,12 +757,13 @@ void GOtBitSender::SendMessages() const {
 
 GOtBitReceiver::GOtBitReceiver(const std::size_t ot_id, const std::size_t number_of_ots,
                                OtExtensionData& data)
-    : BasicOtReceiver(ot_id, number_of_ots, 1, data), outputs_(number_of_ots) {
+    : BasicOtReceiver(ot_id, number_of_ots, 1, data, true), outputs_(number_of_ots) {
   sender_message_future_ = data_.message_manager.RegisterReceive(
       data_.party_id, communication::MessageType::kOtExtensionSender, ot_id);
 }
 
 void GOtBitReceiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -693,6 +785,7 @@ void GOtBitReceiver::ComputeOutputs() {
     bool difference = sender_message_span.Get(2 * i + static_cast<std::size_t>(random_choices[i]));
     outputs_.Set(difference ^ data_.receiver_data.outputs.at(ot_id_ + i).Get(0), i);
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
@@ -730,6 +823,7 @@ void GOtSender::SendMessages() const {
                     data_.sender_data.y1[ot_id_ + i]);
     }
   }
+  ReleaseSenderOutputs();
   auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
                              buffer.GetData().size())};
   auto msg{communication::BuildMessage(communication::MessageType::kOtExtensionSender, ot_id_,
@@ -747,6 +841,7 @@ GOtReceiver::GOtReceiver(const std::size_t ot_id, const std::size_t number_of_ot
 }
 
 void GOtReceiver::ComputeOutputs() {
+  SynchronizeRun();
   if (outputs_computed_) {
     // already done
     return;
@@ -772,6 +867,7 @@ void GOtReceiver::ComputeOutputs() {
     }
     outputs_[i] ^= data_.receiver_data.outputs.at(ot_id_ + i);
   }
+  ReleaseReceiverOutputs();
   outputs_computed_ = true;
 }
 
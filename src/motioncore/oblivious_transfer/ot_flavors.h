@@ -41,8 +41,9 @@ class BasicOtSender : public OtVector {
   void WaitSetup() const;
 
  protected:
+  // if packed, the 1-bit outputs are stored in OtExtensionSenderData::y0_bits and y1_bits
   BasicOtSender(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
-                OtExtensionData& data);
+                OtExtensionData& data, bool packed = false);
 };
 
 // base class capturing the common things among the receiver implementations
@@ -65,14 +66,20 @@ class BasicOtReceiver : public OtVector {
   void SendCorrections();
 
  protected:
+  // if packed, the 1-bit outputs are stored in OtExtensionReceiverData::output_bits
   BasicOtReceiver(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
-                  OtExtensionData& data);
+                  OtExtensionData& data, bool packed = false);
 
   // input of the receiver, the choices
   BitVector<> choices_;
 
   // if the corrections have been transmitted
   bool corrections_sent_ = false;
+
+  void ClearRun() override {
+    OtVector::ClearRun();
+    corrections_sent_ = false;
+  }
 };
 
 // sender implementation of batched random generic OTs
@@ -101,9 +108,6 @@ class ROtSender : public OtVector {
  private:
   // both output masks of the sender
   std::vector<BitVector<>> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // sender implementation of batched xor-correlated 128 bit string OT with a
@@ -138,9 +142,6 @@ class FixedXcOt128Sender : public BasicOtSender {
   // the "0 output" for the sender (the "1 output" can be computed by applying the correlation)
   Block128Vector outputs_;
 
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
-
   // future for the message containing client's corrections
   ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
 };
@@ -170,9 +171,6 @@ class FixedXcOt128Receiver : public BasicOtReceiver {
 
   // the output for the receiver
   Block128Vector outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // sender implementation of batched xor-correlated bit ots
@@ -214,9 +212,6 @@ class XcOtBitSender : public BasicOtSender {
   // the "0 output" for the sender (the "1 output" can be computed by applying the correlation)
   BitVector<> outputs_;
 
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
-
   // future for the message containing client's corrections
   ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
 };
@@ -261,9 +256,6 @@ class XcOtSender : public BasicOtSender {
   // the "0 output" for the sender (the "1 output" can be computed by applying the correlation)
   std::vector<BitVector<>> outputs_;
 
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
-
   // future for the message containing client's corrections
   ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
 };
@@ -299,9 +291,6 @@ class ROtReceiver : OtVector {
 
   // the output for the receiver
   std::vector<BitVector<>> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // receiver implementation of batched xor-correlated bit ots
@@ -326,9 +315,6 @@ class XcOtBitReceiver : public BasicOtReceiver {
 
   // the output for the receiver
   BitVector<> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // receiver implementation of batched xor-correlated generic ots
@@ -354,9 +340,6 @@ class XcOtReceiver : public BasicOtReceiver {
 
   // the output for the receiver
   std::vector<BitVector<>> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // sender implementation of batched additive-correlated ots
@@ -381,6 +364,10 @@ class AcOtSender : public BasicOtSender {
   // get the correlations for the OTs in this batch
   const std::vector<T>& GetCorrelations() const { return correlations_; }
 
+  /// \brief Sets the correlation of the OT k * 8 * sizeof(T) + i to values[k] << i, i.e., the
+  /// sender's side of Gilboa's multiplication for all bits of all \p values in one pass.
+  void SetBitCorrelations(std::span<const T> values);
+
   // compute the sender's outputs
   void ComputeOutputs();
 
@@ -390,6 +377,16 @@ class AcOtSender : public BasicOtSender {
     return outputs_;
   }
 
+  /// \brief Adds \p factor times the sum of the outputs of the OTs k * 8 * sizeof(T), ...,
+  /// (k + 1) * 8 * sizeof(T) - 1 to sums[k], see SetBitCorrelations.
+  void AccumulateBitOutputs(std::span<T> sums, T factor) const;
+
+  /// \brief Frees the outputs after they were used, the next run computes them anew.
+  void ReleaseOutputs() {
+    outputs_ = {};
+    outputs_computed_ = false;
+  }
+
   // send the sender's messages
   void SendMessages() const;
 
@@ -405,9 +402,6 @@ class AcOtSender : public BasicOtSender {
   // the "0 output" for the sender (the "1 output" can be computed by applying the correlation)
   std::vector<T> outputs_;
 
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
-
   // future for the message containing client's corrections
   ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
 };
@@ -421,6 +415,10 @@ class AcOtReceiver : public BasicOtReceiver {
   AcOtReceiver(std::size_t ot_id, std::size_t number_of_ots, std::size_t vector_size,
                OtExtensionData& data);
 
+  /// \brief Sets the choice of the OT k * 8 * sizeof(T) + i to bit i of values[k], which are
+  /// copied from the memory of \p values at once.
+  void SetBitChoices(std::span<const T> values);
+
   // compute the receiver's outputs
   void ComputeOutputs();
 
@@ -430,6 +428,16 @@ class AcOtReceiver : public BasicOtReceiver {
     return outputs_;
   }
 
+  /// \brief Adds \p factor times the sum of the outputs of the OTs k * 8 * sizeof(T), ...,
+  /// (k + 1) * 8 * sizeof(T) - 1 to sums[k], see SetBitChoices.
+  void AccumulateBitOutputs(std::span<T> sums, T factor) const;
+
+  /// \brief Frees the outputs after they were used, the next run computes them anew.
+  void ReleaseOutputs() {
+    outputs_ = {};
+    outputs_computed_ = false;
+  }
+
   [[nodiscard]] OtProtocol GetProtocol() const noexcept override { return OtProtocol::kAcOt; }
 
  private:
@@ -441,9 +449,6 @@ class AcOtReceiver : public BasicOtReceiver {
 
   // the output for the receiver
   std::vector<T> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // sender implementation of batched 128 bit string OT
@@ -490,9 +495,6 @@ class GOt128Receiver : public BasicOtReceiver {
 
   // the output for the receiver
   Block128Vector outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // sender implementation of batched string OT
@@ -564,9 +566,6 @@ class GOtBitReceiver : public BasicOtReceiver {
 
   // the output for the receiver
   BitVector<> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 // receiver implementation of batched string OT
@@ -592,9 +591,6 @@ class GOtReceiver : public BasicOtReceiver {
 
   // the output for the receiver
   std::vector<BitVector<>> outputs_;
-
-  // if the sender outputs have been computed
-  bool outputs_computed_ = false;
 };
 
 }  // namespace encrypto::motion
@@ -25,6 +25,11 @@
 #include "ot_provider.h"
 #include "base_ots/base_ot_provider.h"
 #include "ot_flavors.h"
+#include "random_ot_pool.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
 
 #include "base/motion_base_provider.h"
 #include "communication/communication_layer.h"
@@ -33,13 +38,50 @@
 #include "data_storage/base_ot_data.h"
 #include "data_storage/ot_extension_data.h"
 #include "primitives/pseudo_random_generator.h"
+#include "silent_ot/silent_ot_extension.h"
 #include "utility/bit_matrix.h"
 #include "utility/config.h"
 #include "utility/fiber_condition.h"
+#include "utility/helpers.h"
 #include "utility/logger.h"
 
 namespace encrypto::motion {
 
+namespace {
+
+// number of chunks the receiver may send before the sender confirmed that it processed the first
+// of them, s.t. at most this many chunks of masks are buffered by the sender
+constexpr std::size_t kNumberOfChunksInFlight{2};
+
+// number of chunks in which the masks for number_of_ots OTs are exchanged, where the silent OT
+// extension needs all base COTs at once and, thus, a single chunk
+std::size_t GetNumberOfChunks(const OtExtensionData& data, std::size_t number_of_ots) {
+  if (number_of_ots == 0 ||
+      (data.use_silent_ot_extension && SelectSilentOtParameters(number_of_ots))) {
+    return 1;
+  }
+  return (number_of_ots + data.chunk_size - 1) / data.chunk_size;
+}
+
+// number of instances of the silent OT extension needed for number_of_ots OTs
+std::size_t GetNumberOfSilentOtInstances(const SilentOtParameters& parameters,
+                                         std::size_t number_of_ots) {
+  return (number_of_ots + parameters.GetNumberOfOts() - 1) / parameters.GetNumberOfOts();
+}
+
+// replaces the 128 rows of the matrix by the rows of the bit_size_padded COTs in blocks
+void BlocksToMatrix(const Block128Vector& blocks, std::vector<AlignedBitVector>& matrix,
+                    std::size_t bit_size_padded) {
+  std::array<std::byte*, 128> pointers;
+  for (std::size_t i = 0; i < matrix.size(); ++i) {
+    matrix[i] = AlignedBitVector(bit_size_padded);
+    pointers[i] = matrix[i].GetMutableData().data();
+  }
+  TransposeBlocksToRows(std::span(blocks.data(), bit_size_padded), pointers);
+}
+
+}  // namespace
+
 std::size_t OtProviderFromOtExtension::GetPartyId() { return data_.party_id; }
 
 [[nodiscard]] std::unique_ptr<ROtSender> OtProviderFromOtExtension::RegisterSendROt(
@@ -158,18 +200,60 @@ OtProviderFromOtExtension::OtProviderFromOtExtension(OtExtensionData& data,
       motion_base_provider_(motion_base_provider),
       receiver_provider_(data_, party_id),
       sender_provider_(data_, party_id) {
-  for (std::size_t i = 0; i < data_.sender_data.u_futures.size(); ++i) {
-    data_.sender_data.u_futures[i] = data_.message_manager.RegisterReceive(
-        party_id, communication::MessageType::kOtExtensionReceiverMasks, i);
+  // the masks of the first chunk, further chunks are registered in PreSetup
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    data_.sender_data.u_futures.emplace_back(data_.message_manager.RegisterReceive(
+        party_id, communication::MessageType::kOtExtensionReceiverMasks, i));
   }
 }
 
+OtProviderFromOtExtension::~OtProviderFromOtExtension() = default;
+
+RandomOtPool& OtProviderFromOtExtension::EnableRandomOtPool(std::size_t batch_size,
+                                                            std::size_t low_watermark) {
+  if (random_ot_pool_) {
+    throw std::logic_error(
+        fmt::format("The random OT pool with Party#{} is already enabled", data_.party_id));
+  }
+  random_ot_pool_ = std::make_unique<RandomOtPool>(data_, base_ot_provider_, motion_base_provider_,
+                                                   batch_size, low_watermark);
+  return *random_ot_pool_;
+}
+
+RandomOtPool& OtProviderFromOtExtension::GetRandomOtPool() {
+  if (!random_ot_pool_) {
+    throw std::logic_error(
+        fmt::format("The random OT pool with Party#{} is not enabled", data_.party_id));
+  }
+  return *random_ot_pool_;
+}
+
 void OtProviderFromOtExtension::SetBaseOtOffset(std::size_t offset) {
   data_.base_ot_offset = offset;
 }
 
 std::size_t OtProviderFromOtExtension::GetBaseOtOffset() const { return data_.base_ot_offset; }
 
+void OtProviderFromOtExtension::SetSenderCorrelations(const Block128& delta, Block128Vector&& q) {
+  if (q.size() != sender_provider_.GetNumOts()) {
+    throw std::invalid_argument(fmt::format("Got {} correlated OTs but {} OTs are registered",
+                                            q.size(), sender_provider_.GetNumOts()));
+  }
+  dealer_delta_ = delta;
+  dealer_sender_ots_ = std::move(q);
+}
+
+void OtProviderFromOtExtension::SetReceiverCorrelations(AlignedBitVector&& r,
+                                                        Block128Vector&& t) {
+  if (r.GetSize() != t.size() || t.size() != receiver_provider_.GetNumOts()) {
+    throw std::invalid_argument(fmt::format(
+        "Got {} correlated OTs with {} choices but {} OTs are registered", t.size(), r.GetSize(),
+        receiver_provider_.GetNumOts()));
+  }
+  dealer_choices_ = std::move(r);
+  dealer_receiver_ots_ = std::move(t);
+}
+
 void OtProviderFromOtExtension::SendSetup() {
   // security parameter
   constexpr std::size_t kKappa = 128;
@@ -184,54 +268,140 @@ void OtProviderFromOtExtension::SendSetup() {
   if (bit_size == 0) return;  // no OTs needed
   data_.sender_data.bit_size = bit_size;
 
+  if (dealer_delta_) {
+    // the trusted dealer's correlated OTs are the columns of the matrix
+    const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
+    dealer_sender_ots_.resize(bit_size_padded, Block128::MakeZero());
+    std::vector<AlignedBitVector> v(kKappa);
+    BlocksToMatrix(dealer_sender_ots_, v, bit_size_padded);
+    BitVector<> delta(dealer_delta_->data(), kKappa);
+    dealer_delta_.reset();
+    dealer_sender_ots_ = Block128Vector();
+    FinishSendSetup(v, delta, bit_size_padded);
+    return;
+  }
+
   // XXX: index variable?
   std::size_t i;
 
-  // bit size of the matrix rounded to bytes
-  // XXX: maybe round to blocks?
-  const std::size_t byte_size = BitsToBytes(bit_size);
+  // with the silent OT extension, the matrix only contains the base COTs, which are expanded to
+  // bit_size OTs afterwards
+  const auto silent_parameters{data_.use_silent_ot_extension ? SelectSilentOtParameters(bit_size)
+                                                             : std::nullopt};
+  const std::size_t number_of_silent_instances{
+      silent_parameters ? GetNumberOfSilentOtInstances(*silent_parameters, bit_size) : 0};
+  const std::size_t extension_size{
+      silent_parameters ? number_of_silent_instances * silent_parameters->GetNumberOfBaseOts()
+                        : bit_size};
 
   // bit size rounded to blocks
   const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
+  const auto extension_size_padded = extension_size + kKappa - (extension_size % kKappa);
+
+  // the matrix is extended in chunks of columns, which are transposed before the next chunk
+  const std::size_t number_of_chunks{GetNumberOfChunks(data_, bit_size)};
+  const std::size_t chunk_size{number_of_chunks == 1 ? extension_size : data_.chunk_size};
+  const auto delta{
+      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kKappa)};
 
   // vector containing the matrix rows
   // XXX: note that rows/columns are swapped compared to the ALSZ paper
   std::vector<AlignedBitVector> v(kKappa);
 
-  // PRG which is used to expand the keys we got from the base OTs
-  primitives::Prg prgs_variable_key;
-
-  // fill the rows of the matrix, offset to differentiate other providers' base ots
-  for (i = 0; i < kKappa; ++i) {
-    // use the key we got from the base OTs as seed
-    prgs_variable_key.SetKey(base_ots_receiver_data.messages_c.at(data_.base_ot_offset + i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prgs_variable_key.SetOffset(data_.base_ot_offset);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prgs_variable_key.Encrypt(byte_size));
-    v[i] = AlignedBitVector(std::move(row), bit_size_padded);
-  }
-
-  // receive the vectors u one by one from the receiver
-  // and xor them to the expanded keys if the corresponding selection bit is 1
-  // transmitted one by one to prevent waiting for finishing all messages to start sending
-  // the vectors can be transmitted in the wrong order
-
-  for (i = 0; i < data_.sender_data.u_futures.size(); ++i) {
-    auto raw_message{data_.sender_data.u_futures[i].get()};
-    if (base_ots_receiver_data.c[data_.base_ot_offset + i]) {
-      BitSpan bit_span_u(const_cast<std::uint8_t*>(
-                             communication::GetMessage(raw_message.data())->payload()->data()),
-                         bit_size);
-      BitSpan bit_span_v(v[i].GetMutableData().data(), bit_size, true);
-      bit_span_v ^= bit_span_u;
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    const std::size_t chunk_begin{chunk * chunk_size};
+    const std::size_t chunk_end{std::min(chunk_begin + chunk_size, extension_size)};
+    const std::size_t chunk_bits{chunk_end - chunk_begin};
+    const auto chunk_bits_padded = chunk_bits + kKappa - (chunk_bits % kKappa);
+    // bit size of the chunk rounded to bytes
+    const std::size_t byte_size = BitsToBytes(chunk_bits);
+
+    // fill the rows of the matrix, offset to differentiate other providers' base ots, the rows
+    // are independent and expanded in parallel
+    ParallelFor(kKappa, data_.number_of_threads, [&](std::size_t row_index) {
+      // PRG which is used to expand the keys we got from the base OTs
+      primitives::Prg prg_variable_key;
+      // use the key we got from the base OTs as seed
+      prg_variable_key.SetKey(
+          base_ots_receiver_data.messages_c.at(data_.base_ot_offset + row_index).data());
+      // change the offset in the output stream since we might have already used
+      // the same base OTs previously, chunks start at a block of the stream
+      prg_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+      // expand the seed such that it fills one row of the chunk
+      auto row(prg_variable_key.Encrypt(byte_size));
+      v[row_index] = AlignedBitVector(std::move(row), chunk_bits_padded);
+    });
+
+    // receive the vectors u one by one from the receiver
+    // and xor them to the expanded keys if the corresponding selection bit is 1
+    // transmitted one by one to prevent waiting for finishing all messages to start sending
+    // the vectors can be transmitted in the wrong order
+    for (i = 0; i < kKappa; ++i) {
+      auto raw_message{data_.sender_data.u_futures[chunk * kKappa + i].get()};
+      if (base_ots_receiver_data.c[data_.base_ot_offset + i]) {
+        BitSpan bit_span_u(const_cast<std::uint8_t*>(
+                               communication::GetMessage(raw_message.data())->payload()->data()),
+                           chunk_bits);
+        BitSpan bit_span_v(v[i].GetMutableData().data(), chunk_bits, true);
+        bit_span_v ^= bit_span_u;
+      }
+    }
+
+    if (number_of_chunks > 1) {
+      TransposeSenderChunk(v, delta, chunk_begin, chunk_end, chunk_bits_padded);
+      // let the receiver send the chunk after the next one
+      if (chunk + kNumberOfChunksInFlight < number_of_chunks) {
+        data_.send_function(communication::BuildMessage(
+            communication::MessageType::kOtExtensionChunkAcknowledgement, chunk, {}));
+      }
     }
   }
 
+  if (number_of_chunks > 1) {
+    // we are done with the setup for the sender side
+    data_.sender_data.UpdateMemoryAccount();
+    data_.sender_data.SetSetupIsReady();
+    SetSetupIsReady();
+    return;
+  }
+
+  if (silent_parameters) {
+    // the columns of the matrix are the base COTs with offset s, i.e., the base OT choices
+    Block128Vector base_ots(extension_size_padded);
+    std::array<const std::byte*, kKappa> rows;
+    for (i = 0; i < kKappa; ++i) rows[i] = v[i].GetData().data();
+    TransposeRowsToBlocks(rows, std::span(base_ots.data(), base_ots.size()),
+                          extension_size_padded);
+    auto delta_block{Block128::MakeFromMemory(delta.GetData().data())};
+
+    const std::size_t instance_size{silent_parameters->GetNumberOfOts()};
+    const std::size_t instance_base_ots{silent_parameters->GetNumberOfBaseOts()};
+    Block128Vector extended_ots(std::max(number_of_silent_instances * instance_size, bit_size_padded),
+                                Block128::MakeZero());
+    for (std::size_t instance = 0; instance < number_of_silent_instances; ++instance) {
+      auto message{std::make_shared<Block128Vector>(silent_parameters->GetMessageSize())};
+      SilentOtSenderExpand(
+          *silent_parameters,
+          std::span(base_ots.data() + instance * instance_base_ots, instance_base_ots),
+          delta_block, std::span(message->data(), message->size()),
+          std::span(extended_ots.data() + instance * instance_size, instance_size));
+      auto payload{std::span(reinterpret_cast<const std::uint8_t*>(message->data()),
+                             message->size() * Block128::kBlockSize)};
+      data_.send_payload_function(communication::MessageType::kSilentOtExtensionSender, instance,
+                                  payload, std::move(message));
+    }
+    BlocksToMatrix(extended_ots, v, bit_size_padded);
+  }
+
+  FinishSendSetup(v, delta, bit_size_padded);
+}
+
+void OtProviderFromOtExtension::FinishSendSetup(const std::vector<AlignedBitVector>& v,
+                                                const BitVector<>& delta,
+                                                std::size_t bit_size_padded) {
   // array with pointers to each row of the matrix
   std::array<const std::byte*, kKappa> pointers;
-  for (i = 0u; i < pointers.size(); ++i) {
+  for (std::size_t i = 0u; i < pointers.size(); ++i) {
     pointers[i] = v[i].GetData().data();
   }
   const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
@@ -242,30 +412,67 @@ void OtProviderFromOtExtension::SendSetup() {
 
   // transpose the bit matrix
   // XXX: figure out how the result looks like
-  BitMatrix::SenderTranspose128AndEncrypt(
-      pointers, data_.sender_data.y0, data_.sender_data.y1,
-      base_ots_receiver_data.c.Subset(data_.base_ot_offset, data_.base_ot_offset + kKappa),
-      prg_fixed_key, bit_size_padded, data_.sender_data.bitlengths);
+  auto& sender_data{data_.sender_data};
+  const std::size_t number_of_ots{sender_data.y0.GetSize()};
+  std::vector<BitVector<>> y0(number_of_ots), y1(number_of_ots);
+  BitMatrix::SenderTranspose128AndEncrypt(pointers, y0, y1, delta, prg_fixed_key, bit_size_padded,
+                                          sender_data.bitlengths, data_.number_of_threads,
+                                          &sender_data.packed, &sender_data.y0_bits,
+                                          &sender_data.y1_bits);
+  sender_data.y0.Assign(0, std::span(y0.data(), number_of_ots));
+  sender_data.y1.Assign(0, std::span(y1.data(), number_of_ots));
 
   // we are done with the setup for the sender side
+  data_.sender_data.UpdateMemoryAccount();
   data_.sender_data.SetSetupIsReady();
   SetSetupIsReady();
 }
 
 void OtProviderFromOtExtension::ReceiveSetup() {
-  // some index variables
-  std::size_t i = 0, j = 0;
+  // index variable
+  std::size_t i = 0;
   // security parameter and number of base OTs
   constexpr std::size_t kKappa = 128;
   // number of OTs and width of the bit matrix
   const std::size_t bit_size = receiver_provider_.GetNumOts();
   if (bit_size == 0) return;  // nothing to do
 
+  if (dealer_choices_) {
+    // the trusted dealer's correlated OTs are the columns of the matrix
+    const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
+    data_.receiver_data.random_choices =
+        std::make_unique<AlignedBitVector>(std::move(*dealer_choices_));
+    dealer_choices_.reset();
+    dealer_receiver_ots_.resize(bit_size_padded, Block128::MakeZero());
+    std::vector<AlignedBitVector> v(kKappa);
+    BlocksToMatrix(dealer_receiver_ots_, v, bit_size_padded);
+    dealer_receiver_ots_ = Block128Vector();
+    FinishReceiveSetup(v, bit_size_padded);
+    return;
+  }
+
+  // with the silent OT extension, the matrix only contains the base COTs, which are expanded to
+  // bit_size OTs afterwards
+  const auto silent_parameters{data_.use_silent_ot_extension ? SelectSilentOtParameters(bit_size)
+                                                             : std::nullopt};
+  const std::size_t number_of_silent_instances{
+      silent_parameters ? GetNumberOfSilentOtInstances(*silent_parameters, bit_size) : 0};
+  const std::size_t extension_size{
+      silent_parameters ? number_of_silent_instances * silent_parameters->GetNumberOfBaseOts()
+                        : bit_size};
+  // the sender's messages are sent only after it got the masks below
+  std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> silent_message_futures;
+  for (std::size_t instance = 0; instance < number_of_silent_instances; ++instance) {
+    silent_message_futures.emplace_back(data_.message_manager.RegisterReceive(
+        data_.party_id, communication::MessageType::kSilentOtExtensionSender, instance));
+  }
+
   // rounded up to a multiple of the security parameter
   const auto bit_size_padded = bit_size + kKappa - (bit_size % kKappa);
+  const auto extension_size_padded = extension_size + kKappa - (extension_size % kKappa);
 
   // convert to bytes
-  const std::size_t byte_size = BitsToBytes(bit_size);
+  const std::size_t byte_size = BitsToBytes(extension_size);
   // XXX: if byte_size is 0 then bit_size was also zero (or an overflow happened
   if (byte_size == 0) {
     return;
@@ -276,76 +483,292 @@ void OtProviderFromOtExtension::ReceiveSetup() {
 
   // make random choices (this is precomputation, real inputs are not known yet)
   data_.receiver_data.random_choices =
-      std::make_unique<AlignedBitVector>(AlignedBitVector::SecureRandom(bit_size));
+      std::make_unique<AlignedBitVector>(AlignedBitVector::SecureRandom(extension_size));
+
+  // the matrix is extended in chunks of columns, which are transposed before the next chunk
+  const std::size_t number_of_chunks{GetNumberOfChunks(data_, bit_size)};
+  const std::size_t chunk_size{number_of_chunks == 1 ? extension_size : data_.chunk_size};
 
   // create matrix with kKappa rows
   std::vector<AlignedBitVector> v(kKappa);
 
-  // PRG we use with the fixed-key AES function
-
-  // PRG which is used to expand the keys we got from the base OTs
-  primitives::Prg prg_fixed_key, prg_variable_key;
-
-  // fill the rows of the matrix, offset to differentiate other providers' base ots
-  for (i = 0; i < kKappa; ++i) {
-    // generate rows of the matrix using the corresponding 0 key
-    // T[j] = Prg(s_{j,0})
-    prg_variable_key.SetKey(base_ots_sender_data.messages_0.at(data_.base_ot_offset + i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prg_variable_key.SetOffset(data_.base_ot_offset);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prg_variable_key.Encrypt(byte_size));
-    v.at(i) = AlignedBitVector(std::move(row), bit_size);
-    // take a copy of the row and XOR it with our choices
-    auto u = v.at(i);
-    // u_j = T[j] XOR r
-    u ^= *data_.receiver_data.random_choices;
-
-    // now mask the result with random stream expanded from the 1 key
-    // u_j = u_j XOR Prg(s_{j,1})
-    prg_variable_key.SetKey(base_ots_sender_data.messages_1.at(data_.base_ot_offset + i).data());
-    prg_variable_key.SetOffset(data_.base_ot_offset);
-    u ^= AlignedBitVector(prg_variable_key.Encrypt(byte_size), bit_size);
-
-    auto buffer_span{
-        std::span(reinterpret_cast<const std::uint8_t*>(u.GetData().data()), u.GetData().size())};
-    auto msg{communication::BuildMessage(communication::MessageType::kOtExtensionReceiverMasks, i,
-                                         buffer_span)};
-    // send this row
-    data_.send_function(std::move(msg));
+  // masks of the rows which are computed in parallel before they are sent in order
+  std::vector<std::shared_ptr<const AlignedBitVector>> masks(kKappa);
+
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    const std::size_t chunk_begin{chunk * chunk_size};
+    const std::size_t chunk_end{std::min(chunk_begin + chunk_size, extension_size)};
+    const std::size_t chunk_bits{chunk_end - chunk_begin};
+    const std::size_t chunk_byte_size{BitsToBytes(chunk_bits)};
+    AlignedBitVector choices_subset;
+    if (number_of_chunks > 1) {
+      choices_subset = data_.receiver_data.random_choices->Subset(chunk_begin, chunk_end);
+    }
+    const auto& chunk_choices{number_of_chunks == 1 ? *data_.receiver_data.random_choices
+                                                    : choices_subset};
+
+    // wait until the sender has processed enough of the previous chunks
+    if (chunk >= kNumberOfChunksInFlight) {
+      data_.receiver_data.chunk_acknowledgement_futures.at(chunk - kNumberOfChunksInFlight).get();
+    }
+
+    // fill the rows of the matrix, offset to differentiate other providers' base ots, the rows
+    // are computed in groups of one row per thread and the masks of a group are sent in order
+    // before the next group, s.t. the sender can start early
+    for (std::size_t group_begin = 0; group_begin < kKappa;
+         group_begin += data_.number_of_threads) {
+      const std::size_t group_end{std::min(group_begin + data_.number_of_threads, kKappa)};
+      ParallelFor(group_end - group_begin, data_.number_of_threads, [&](std::size_t k) {
+        const std::size_t row_index{group_begin + k};
+        // PRG which is used to expand the keys we got from the base OTs
+        primitives::Prg prg_variable_key;
+        // generate rows of the matrix using the corresponding 0 key
+        // T[j] = Prg(s_{j,0})
+        prg_variable_key.SetKey(
+            base_ots_sender_data.messages_0.at(data_.base_ot_offset + row_index).data());
+        // change the offset in the output stream since we might have already used
+        // the same base OTs previously, chunks start at a block of the stream
+        prg_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+        // expand the seed such that it fills one row of the chunk
+        auto row(prg_variable_key.Encrypt(chunk_byte_size));
+        v.at(row_index) = AlignedBitVector(std::move(row), chunk_bits);
+        // take a copy of the row and XOR it with our choices
+        auto u = v.at(row_index);
+        // u_j = T[j] XOR r
+        u ^= chunk_choices;
+
+        // now mask the result with random stream expanded from the 1 key
+        // u_j = u_j XOR Prg(s_{j,1})
+        prg_variable_key.SetKey(
+            base_ots_sender_data.messages_1.at(data_.base_ot_offset + row_index).data());
+        prg_variable_key.SetOffset(data_.base_ot_offset + chunk_begin / kKappa);
+        u ^= AlignedBitVector(prg_variable_key.Encrypt(chunk_byte_size), chunk_bits);
+        masks[row_index] = std::make_shared<const AlignedBitVector>(std::move(u));
+      });
+
+      for (i = group_begin; i < group_end; ++i) {
+        // send this row directly from its buffer
+        auto buffer_span{
+            std::span(reinterpret_cast<const std::uint8_t*>(masks[i]->GetData().data()),
+                      masks[i]->GetData().size())};
+        data_.send_payload_function(communication::MessageType::kOtExtensionReceiverMasks,
+                                    chunk * kKappa + i, buffer_span, std::move(masks[i]));
+      }
+    }
+
+    if (number_of_chunks > 1) {
+      TransposeReceiverChunk(v, chunk_begin, chunk_end,
+                             chunk_bits + kKappa - (chunk_bits % kKappa));
+    }
   }
 
-  // transpose matrix T
-  if (bit_size_padded != bit_size) {
-    for (i = 0u; i < v.size(); ++i) {
-      v.at(i).Resize(bit_size_padded, true);
+  if (number_of_chunks > 1) {
+    data_.receiver_data.UpdateMemoryAccount();
+    data_.receiver_data.SetSetupIsReady();
+    SetSetupIsReady();
+    return;
+  }
+
+  if (silent_parameters) {
+    // the columns of the matrix are the base COTs for the random choices
+    std::array<const std::byte*, kKappa> rows;
+    for (i = 0; i < kKappa; ++i) {
+      v[i].Resize(extension_size_padded, true);
+      rows[i] = v[i].GetData().data();
+    }
+    Block128Vector base_ots(extension_size_padded);
+    TransposeRowsToBlocks(rows, std::span(base_ots.data(), base_ots.size()),
+                          extension_size_padded);
+
+    const std::size_t instance_size{silent_parameters->GetNumberOfOts()};
+    const std::size_t instance_base_ots{silent_parameters->GetNumberOfBaseOts()};
+    const std::size_t message_size{silent_parameters->GetMessageSize()};
+    Block128Vector extended_ots(std::max(number_of_silent_instances * instance_size, bit_size_padded),
+                                Block128::MakeZero());
+    AlignedBitVector choices(number_of_silent_instances * instance_size);
+    for (std::size_t instance = 0; instance < number_of_silent_instances; ++instance) {
+      auto raw_message{silent_message_futures[instance].get()};
+      auto payload{communication::GetMessage(raw_message.data())->payload()};
+      if (payload->size() != message_size * Block128::kBlockSize) {
+        throw std::runtime_error(fmt::format(
+            "Received silent OT extension message of {} B from Party#{} but expected {} B",
+            payload->size(), data_.party_id, message_size * Block128::kBlockSize));
+      }
+      // copy to have the blocks aligned
+      Block128Vector message(message_size, payload->data());
+      auto base_choices{data_.receiver_data.random_choices->Subset(
+          instance * instance_base_ots, (instance + 1) * instance_base_ots)};
+      BitSpan base_choices_span(base_choices);
+      // instance_size is a multiple of 8, so each instance's choices start at a byte
+      BitSpan choices_span(choices.GetMutableData().data() + instance * instance_size / 8,
+                           instance_size);
+      SilentOtReceiverExpand(
+          *silent_parameters,
+          std::span(base_ots.data() + instance * instance_base_ots, instance_base_ots),
+          base_choices_span, std::span(message.data(), message.size()),
+          std::span(extended_ots.data() + instance * instance_size, instance_size),
+          choices_span);
     }
+    choices.Resize(bit_size);
+    *data_.receiver_data.random_choices = std::move(choices);
+    BlocksToMatrix(extended_ots, v, bit_size_padded);
+  }
+
+  FinishReceiveSetup(v, bit_size_padded);
+}
+
+void OtProviderFromOtExtension::FinishReceiveSetup(std::vector<AlignedBitVector>& v,
+                                                   std::size_t bit_size_padded) {
+  // transpose matrix T
+  for (auto& row : v) {
+    if (row.GetSize() != bit_size_padded) row.Resize(bit_size_padded, true);
   }
 
   std::array<const std::byte*, kKappa> pointers;
-  for (j = 0; j < pointers.size(); ++j) {
+  for (std::size_t j = 0; j < pointers.size(); ++j) {
     pointers.at(j) = v.at(j).GetMutableData().data();
   }
 
+  primitives::Prg prg_fixed_key;
   const auto& fixed_key_aes_key = motion_base_provider_.GetAesFixedKey();
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
-  BitMatrix::ReceiverTranspose128AndEncrypt(pointers, data_.receiver_data.outputs, prg_fixed_key,
-                                            bit_size_padded, data_.receiver_data.bitlengths);
-
+  auto& receiver_data{data_.receiver_data};
+  const std::size_t number_of_ots{receiver_data.outputs.GetSize()};
+  std::vector<BitVector<>> outputs(number_of_ots);
+  BitMatrix::ReceiverTranspose128AndEncrypt(pointers, outputs, prg_fixed_key, bit_size_padded,
+                                            receiver_data.bitlengths, data_.number_of_threads,
+                                            &receiver_data.packed, &receiver_data.output_bits);
+  receiver_data.outputs.Assign(0, std::span(outputs.data(), number_of_ots));
+
+  data_.receiver_data.UpdateMemoryAccount();
   data_.receiver_data.SetSetupIsReady();
   SetSetupIsReady();
 }
 
+void OtProviderFromOtExtension::TransposeSenderChunk(const std::vector<AlignedBitVector>& v,
+                                                     const BitVector<>& delta, std::size_t begin,
+                                                     std::size_t end,
+                                                     std::size_t chunk_size_padded) {
+  std::array<const std::byte*, kKappa> pointers;
+  for (std::size_t i = 0u; i < pointers.size(); ++i) {
+    pointers[i] = v[i].GetData().data();
+  }
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(motion_base_provider_.GetAesFixedKey().data());
+
+  // the outputs of the chunk are moved to their OTs, s.t. the transposition needs no offsets
+  auto& sender_data{data_.sender_data};
+  std::vector<BitVector<>> y0(end - begin), y1(end - begin);
+  const std::vector<std::size_t> bitlengths(sender_data.bitlengths.begin() + begin,
+                                            sender_data.bitlengths.begin() + end);
+  const auto packed{sender_data.packed.Subset(begin, end)};
+  BitVector<> y0_bits, y1_bits;
+  BitMatrix::SenderTranspose128AndEncrypt(pointers, y0, y1, delta, prg_fixed_key,
+                                          chunk_size_padded, bitlengths, data_.number_of_threads,
+                                          &packed, &y0_bits, &y1_bits);
+  sender_data.y0.Assign(begin, std::span(y0.data(), end - begin));
+  sender_data.y1.Assign(begin, std::span(y1.data(), end - begin));
+  // begin is a multiple of 128, so the packed outputs of the chunk start at a byte
+  if (sender_data.y0_bits.GetSize() < sender_data.y0.GetSize()) {
+    sender_data.y0_bits.Resize(sender_data.y0.GetSize(), true);
+    sender_data.y1_bits.Resize(sender_data.y1.GetSize(), true);
+  }
+  sender_data.y0_bits.Copy(begin, end, y0_bits);
+  sender_data.y1_bits.Copy(begin, end, y1_bits);
+}
+
+void OtProviderFromOtExtension::TransposeReceiverChunk(std::vector<AlignedBitVector>& v,
+                                                       std::size_t begin, std::size_t end,
+                                                       std::size_t chunk_size_padded) {
+  std::array<const std::byte*, kKappa> pointers;
+  for (std::size_t i = 0; i < pointers.size(); ++i) {
+    v[i].Resize(chunk_size_padded, true);
+    pointers[i] = v[i].GetData().data();
+  }
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(motion_base_provider_.GetAesFixedKey().data());
+
+  auto& receiver_data{data_.receiver_data};
+  std::vector<BitVector<>> outputs(end - begin);
+  const std::vector<std::size_t> bitlengths(receiver_data.bitlengths.begin() + begin,
+                                            receiver_data.bitlengths.begin() + end);
+  const auto packed{receiver_data.packed.Subset(begin, end)};
+  BitVector<> output_bits;
+  BitMatrix::ReceiverTranspose128AndEncrypt(pointers, outputs, prg_fixed_key, chunk_size_padded,
+                                            bitlengths, data_.number_of_threads, &packed,
+                                            &output_bits);
+  receiver_data.outputs.Assign(begin, std::span(outputs.data(), end - begin));
+  if (receiver_data.output_bits.GetSize() < receiver_data.outputs.GetSize()) {
+    receiver_data.output_bits.Resize(receiver_data.outputs.GetSize(), true);
+  }
+  receiver_data.output_bits.Copy(begin, end, output_bits);
+}
+
 void OtProviderFromOtExtension::PreSetup() {
-  if (HasWork()) {
+  // the base OTs are requested once, later runs resume them, see BaseOtProvider::Clear
+  if (HasWork() && data_.base_ot_offset == std::numeric_limits<std::size_t>::max()) {
     data_.base_ot_offset = base_ot_provider_.Request(kKappa, data_.party_id);
   }
+  // register the masks of all chunks and the confirmations of the sender before the other party
+  // may send them
+  const std::size_t number_of_sender_chunks{GetNumberOfChunks(data_, GetNumOtsSender())};
+  for (std::size_t i = data_.sender_data.u_futures.size(); i < number_of_sender_chunks * kKappa;
+       ++i) {
+    data_.sender_data.u_futures.emplace_back(data_.message_manager.RegisterReceive(
+        data_.party_id, communication::MessageType::kOtExtensionReceiverMasks, i));
+  }
+  const std::size_t number_of_receiver_chunks{GetNumberOfChunks(data_, GetNumOtsReceiver())};
+  auto& acknowledgement_futures{data_.receiver_data.chunk_acknowledgement_futures};
+  acknowledgement_futures.clear();
+  for (std::size_t chunk = 0; chunk + kNumberOfChunksInFlight < number_of_receiver_chunks;
+       ++chunk) {
+    acknowledgement_futures.emplace_back(data_.message_manager.RegisterReceive(
+        data_.party_id, communication::MessageType::kOtExtensionChunkAcknowledgement, chunk));
+  }
+}
+
+void OtProviderFromOtExtension::Clear() {
+  // the OTs keep their ids and the futures of their messages, only their outputs are renewed
+  ++data_.run;
+  data_.sender_data.ResetSetupIsReady();
+  data_.receiver_data.ResetSetupIsReady();
+  ResetSetupIsReady();
 }
 
 OtVector::OtVector(const std::size_t ot_id, const std::size_t number_of_ots,
                    const std::size_t bitlength, OtExtensionData& data)
-    : ot_id_(ot_id), number_of_ots_(number_of_ots), bitlength_(bitlength), data_(data) {}
+    : ot_id_(ot_id),
+      number_of_ots_(number_of_ots),
+      bitlength_(bitlength),
+      data_(data),
+      run_(data.run) {}
+
+void OtVector::SynchronizeRun() {
+  if (run_ != data_.run) {
+    run_ = data_.run;
+    ClearRun();
+  }
+}
+
+void OtVector::ReleaseSenderOutputs(std::size_t number_of_reads) const {
+  // the reads of a gate are not concurrent, e.g., SendMessages in the setup and ComputeOutputs in
+  // the online phase
+  if (sender_reads_run_ != data_.run) {
+    sender_reads_run_ = data_.run;
+    number_of_sender_reads_ = 0;
+  }
+  if (++number_of_sender_reads_ != number_of_reads) return;
+  auto& sender_data{data_.sender_data};
+  const bool y0_freed{sender_data.y0.Release(ot_id_, number_of_ots_)};
+  const bool y1_freed{sender_data.y1.Release(ot_id_, number_of_ots_)};
+  if (y0_freed || y1_freed) sender_data.UpdateMemoryAccount();
+}
+
+void OtVector::ReleaseReceiverOutputs() const {
+  if (data_.receiver_data.outputs.Release(ot_id_, number_of_ots_)) {
+    data_.receiver_data.UpdateMemoryAccount();
+  }
+}
 
 std::unique_ptr<ROtSender> OtProviderSender::RegisterROt(const std::size_t number_of_ots,
                                                          const std::size_t bitlength) {
@@ -354,8 +777,8 @@ std::unique_ptr<ROtSender> OtProviderSender::RegisterROt(const std::size_t numbe
   auto ot = std::make_unique<ROtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender ROt",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender ROt", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -368,8 +791,8 @@ std::unique_ptr<XcOtSender> OtProviderSender::RegisterXcOt(const std::size_t num
   auto ot = std::make_unique<XcOtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender XcOt",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender XcOt", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -382,9 +805,8 @@ std::unique_ptr<FixedXcOt128Sender> OtProviderSender::RegisterFixedXcOt128s(
   auto ot = std::make_unique<FixedXcOt128Sender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(
-          fmt::format("Party#{}: registered {} parallel {}-bit sender FixedXCOT128s", party_id_,
-                      number_of_ots, 128));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender FixedXCOT128s",
+                             party_id_, number_of_ots, 128);
     }
   }
   return ot;
@@ -396,8 +818,8 @@ std::unique_ptr<XcOtBitSender> OtProviderSender::RegisterXcOtBits(const std::siz
   auto ot = std::make_unique<XcOtBitSender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender XCOTBits",
-                                         party_id_, number_of_ots, 1));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender XCOTBits", party_id_,
+                             number_of_ots, 1);
     }
   }
   return ot;
@@ -411,8 +833,8 @@ std::unique_ptr<AcOtSender<T>> OtProviderSender::RegisterAcOt(std::size_t number
   auto ot = std::make_unique<AcOtSender<T>>(i, number_of_ots, vector_size, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender ACOTs",
-                                         party_id_, number_of_ots, 8 * sizeof(T)));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender ACOTs", party_id_,
+                             number_of_ots, 8 * sizeof(T));
     }
   }
   return ot;
@@ -436,8 +858,8 @@ std::unique_ptr<GOtSender> OtProviderSender::RegisterGOt(const std::size_t numbe
   auto ot = std::make_unique<GOtSender>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender GOTs",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender GOTs", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -449,8 +871,8 @@ std::unique_ptr<GOt128Sender> OtProviderSender::RegisterGOt128(const std::size_t
   auto ot = std::make_unique<GOt128Sender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender GOT128s",
-                                         party_id_, number_of_ots, 128));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender GOT128s", party_id_,
+                             number_of_ots, 128);
     }
   }
   return ot;
@@ -462,8 +884,8 @@ std::unique_ptr<GOtBitSender> OtProviderSender::RegisterGOtBit(const std::size_t
   auto ot = std::make_unique<GOtBitSender>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit sender GOTBits",
-                                         party_id_, number_of_ots, 1));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit sender GOTBits", party_id_,
+                             number_of_ots, 1);
     }
   }
   return ot;
@@ -490,8 +912,8 @@ std::unique_ptr<ROtReceiver> OtProviderReceiver::RegisterROt(const std::size_t n
   auto ot = std::make_unique<ROtReceiver>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver ROts",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver ROts", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -504,8 +926,8 @@ std::unique_ptr<XcOtReceiver> OtProviderReceiver::RegisterXcOt(const std::size_t
   auto ot = std::make_unique<XcOtReceiver>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver XcOts",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver XcOts", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -518,9 +940,8 @@ std::unique_ptr<FixedXcOt128Receiver> OtProviderReceiver::RegisterFixedXcOt128s(
   auto ot = std::make_unique<FixedXcOt128Receiver>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(
-          fmt::format("Party#{}: registered {} parallel {}-bit receiver FixedXCOT128s", party_id_,
-                      number_of_ots, 128));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver FixedXCOT128s",
+                             party_id_, number_of_ots, 128);
     }
   }
   return ot;
@@ -533,9 +954,8 @@ std::unique_ptr<XcOtBitReceiver> OtProviderReceiver::RegisterXcOtBits(
   auto ot = std::make_unique<XcOtBitReceiver>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(
-          fmt::format("Party#{}: registered {} parallel {}-bit receiver XCOTBits", party_id_,
-                      number_of_ots, 1));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver XCOTBits", party_id_,
+                             number_of_ots, 1);
     }
   }
   return ot;
@@ -549,8 +969,8 @@ std::unique_ptr<AcOtReceiver<T>> OtProviderReceiver::RegisterAcOt(std::size_t nu
   auto ot = std::make_unique<AcOtReceiver<T>>(i, number_of_ots, vector_size, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver ACOTs",
-                                         party_id_, number_of_ots, 8 * sizeof(T)));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver ACOTs", party_id_,
+                             number_of_ots, 8 * sizeof(T));
     }
   }
   return ot;
@@ -574,8 +994,8 @@ std::unique_ptr<GOtReceiver> OtProviderReceiver::RegisterGOt(const std::size_t n
   auto ot = std::make_unique<GOtReceiver>(i, number_of_ots, bitlength, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver GOTs",
-                                         party_id_, number_of_ots, bitlength));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver GOTs", party_id_,
+                             number_of_ots, bitlength);
     }
   }
   return ot;
@@ -588,8 +1008,8 @@ std::unique_ptr<GOt128Receiver> OtProviderReceiver::RegisterGOt128(
   auto ot = std::make_unique<GOt128Receiver>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver GOT128s",
-                                         party_id_, number_of_ots, 128));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver GOT128s", party_id_,
+                             number_of_ots, 128);
     }
   }
   return ot;
@@ -602,8 +1022,8 @@ std::unique_ptr<GOtBitReceiver> OtProviderReceiver::RegisterGOtBit(
   auto ot = std::make_unique<GOtBitReceiver>(i, number_of_ots, data_);
   if constexpr (kDebug) {
     if (data_.logger) {
-      data_.logger->LogDebug(fmt::format("Party#{}: registered {} parallel {}-bit receiver GOTBits",
-                                         party_id_, number_of_ots, 1));
+      data_.logger->LogDebug("Party#{}: registered {} parallel {}-bit receiver GOTBits", party_id_,
+                             number_of_ots, 1);
     }
   }
   return ot;
@@ -633,9 +1053,21 @@ OtProviderManager::OtProviderManager(communication::CommunicationLayer& communic
     auto send_function = [this, party_id](flatbuffers::FlatBufferBuilder&& message_builder) {
       communication_layer_.SendMessage(party_id, message_builder.Release());
     };
+    auto send_payload_function = [this, party_id](communication::MessageType message_type,
+                                                  std::size_t message_id,
+                                                  std::span<const std::uint8_t> payload,
+                                                  std::shared_ptr<const void> payload_owner) {
+      communication_layer_.SendMessage(party_id, message_type, message_id, payload,
+                                       std::move(payload_owner));
+    };
     data_.at(party_id) = std::make_unique<OtExtensionData>(
-        party_id, send_function, communication_layer_.GetMessageManager(), communication_layer_.GetLogger());
+        party_id, send_function, send_payload_function, communication_layer_.GetMessageManager(),
+        communication_layer_.GetLogger());
     data_.at(party_id)->party_id = party_id;
+    // the setups with all parties and in both directions run concurrently, see
+    // Backend::OtExtensionSetup, so they share the hardware threads
+    data_.at(party_id)->number_of_threads = std::max<std::size_t>(
+        1, std::thread::hardware_concurrency() / (2 * (providers_.size() - 1)));
     providers_.at(party_id) = std::make_unique<OtProviderFromOtExtension>(
         *data_.at(party_id), base_ot_provider, motion_base_provider, party_id);
   }
@@ -643,6 +1075,32 @@ OtProviderManager::OtProviderManager(communication::CommunicationLayer& communic
 
 OtProviderManager::~OtProviderManager() {}
 
+void OtProviderManager::SetSilentOtExtension(bool value) {
+  for (auto& data : data_) {
+    if (data) data->use_silent_ot_extension = value;
+  }
+}
+
+void OtProviderManager::SetOtExtensionChunkSize(std::size_t number_of_ots) {
+  if (number_of_ots == 0 || number_of_ots % kKappa != 0) {
+    throw std::invalid_argument(fmt::format(
+        "The OT extension chunk size must be a positive multiple of {} but is {}", kKappa,
+        number_of_ots));
+  }
+  for (auto& data : data_) {
+    if (data) data->chunk_size = number_of_ots;
+  }
+}
+
+void OtProviderManager::FinishRandomOtPools() {
+  for (auto& provider : providers_) {
+    auto ot_extension_provider{dynamic_cast<OtProviderFromOtExtension*>(provider.get())};
+    if (ot_extension_provider && ot_extension_provider->HasRandomOtPool()) {
+      ot_extension_provider->GetRandomOtPool().Finish();
+    }
+  }
+}
+
 bool OtProviderManager::HasWork() {
   for (auto& provider : providers_) {
     if (provider != nullptr && (provider->GetPartyId() != communication_layer_.GetMyId()) &&
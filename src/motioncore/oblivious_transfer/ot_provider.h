@@ -27,9 +27,12 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include <flatbuffers/flatbuffers.h>
+#include "utility/bit_vector.h"
+#include "utility/block.h"
 #include "utility/fiber_waitable.h"
 
 namespace encrypto::motion::communication {
@@ -48,6 +51,7 @@ struct OtExtensionReceiverData;
 struct OtExtensionSenderData;
 class Logger;
 class BaseProvider;
+class RandomOtPool;
 
 enum OtProtocol : unsigned int {
   kGOt = 0,   // general OT
@@ -96,12 +100,36 @@ class OtVector {
   OtVector(std::size_t ot_id, std::size_t number_of_ots, std::size_t bitlength,
            OtExtensionData& data);
 
+  // drops the state of the last run once the OTs were extended anew for another run, see
+  // OtProviderFromOtExtension::Clear, needs to be called before the state of a run is used
+  void SynchronizeRun();
+
+  // resets the state of a run
+  virtual void ClearRun() { outputs_computed_ = false; }
+
+  // releases the outputs of the OT extension of these OTs once they were read for the
+  // number_of_reads-th time in this run, e.g., by ComputeOutputs and SendMessages, s.t. they are
+  // freed before the end of the session, see OtOutputs::Release
+  void ReleaseSenderOutputs(std::size_t number_of_reads = 1) const;
+  void ReleaseReceiverOutputs() const;
+
   const std::size_t ot_id_;
   const std::size_t number_of_ots_;
   const std::size_t bitlength_;
 
   // reference to data storage and context
   OtExtensionData& data_;
+
+  // if the outputs of the current run have been computed
+  bool outputs_computed_ = false;
+
+ private:
+  // the run of the OT extension whose outputs this object uses
+  std::size_t run_;
+
+  // the reads of the sender outputs in the run sender_reads_run_, see ReleaseSenderOutputs
+  mutable std::size_t number_of_sender_reads_{0};
+  mutable std::size_t sender_reads_run_{0};
 };
 
 class OtProviderSender : public FiberSetupWaitable {
@@ -269,10 +297,26 @@ class OtProvider : public FiberSetupWaitable {
 
   virtual void PreSetup() = 0;
 
+  /// \brief Prepares the registered OTs for another run, in which they are generated anew at the
+  /// same offsets, see Backend::Clear.
   virtual void Clear() { throw std::runtime_error("not implemented"); }
 
   virtual void Reset() { throw std::runtime_error("not implemented"); }
 
+  /// \brief Creates the pool of random OTs with the other party, from which OTs can be taken in
+  /// the online phase without registering them, see RandomOtPool.  Needs to be called by both
+  /// parties before the setup phase.  The arithmetic GMW HybridMultiplicationGate and the OT-based
+  /// comparisons created afterwards take their OTs from the pool.
+  virtual RandomOtPool& EnableRandomOtPool([[maybe_unused]] std::size_t batch_size,
+                                           [[maybe_unused]] std::size_t low_watermark) {
+    throw std::runtime_error("not implemented");
+  }
+
+  /// \throws std::logic_error if the pool was not enabled.
+  virtual RandomOtPool& GetRandomOtPool() { throw std::runtime_error("not implemented"); }
+
+  virtual bool HasRandomOtPool() const noexcept { return false; }
+
  protected:
   OtProvider() = default;
 };
@@ -342,15 +386,37 @@ class OtProviderFromOtExtension final : public OtProvider {
 
   void PreSetup() final;
 
+  /// \brief Keeps the registered OTs, which are extended anew in the next setup using the base
+  /// OTs of the next run, see BaseOtProvider::Clear.
+  void Clear() final;
+
   OtProviderFromOtExtension(OtExtensionData& data, BaseOtProvider& base_ot_provider, BaseProvider&,
                             std::size_t party_id);
 
+  ~OtProviderFromOtExtension();
+
+  RandomOtPool& EnableRandomOtPool(std::size_t batch_size, std::size_t low_watermark) final;
+
+  RandomOtPool& GetRandomOtPool() final;
+
+  bool HasRandomOtPool() const noexcept final { return random_ot_pool_ != nullptr; }
+
   std::size_t GetPartyId() final;
 
   void SetBaseOtOffset(std::size_t offset);
 
   std::size_t GetBaseOtOffset() const;
 
+  /// \brief Use the correlated OTs q[i] = t[i] ^ r[i] * delta of a trusted dealer, in which this
+  /// party is the sender with \p delta and \p q, in the next setup instead of the OT extension.
+  /// Needs one OT for each OT registered as sender.
+  void SetSenderCorrelations(const Block128& delta, Block128Vector&& q);
+
+  /// \brief Use the correlated OTs of a trusted dealer, in which this party is the receiver with
+  /// the choices \p r and \p t, in the next setup instead of the OT extension.
+  /// Needs one OT for each OT registered as receiver.
+  void SetReceiverCorrelations(AlignedBitVector&& r, Block128Vector&& t);
+
   [[nodiscard]] std::size_t GetNumOtsReceiver() const final {
     return receiver_provider_.GetNumOts();
   }
@@ -358,15 +424,34 @@ class OtProviderFromOtExtension final : public OtProvider {
   [[nodiscard]] std::size_t GetNumOtsSender() const final { return sender_provider_.GetNumOts(); }
 
  private:
+  // hash the columns of the matrix of correlated OTs to the random OTs of the sender
+  void FinishSendSetup(const std::vector<AlignedBitVector>& v, const BitVector<>& delta,
+                       std::size_t bit_size_padded);
+
+  // hash the columns of the matrix of correlated OTs to the random OTs of the receiver
+  void FinishReceiveSetup(std::vector<AlignedBitVector>& v, std::size_t bit_size_padded);
+
+  // hash the columns of a chunk of the matrix to the random OTs [begin, end) of the sender
+  void TransposeSenderChunk(const std::vector<AlignedBitVector>& v, const BitVector<>& delta,
+                            std::size_t begin, std::size_t end, std::size_t chunk_size_padded);
+
+  // hash the columns of a chunk of the matrix to the random OTs [begin, end) of the receiver
+  void TransposeReceiverChunk(std::vector<AlignedBitVector>& v, std::size_t begin,
+                              std::size_t end, std::size_t chunk_size_padded);
+
   OtExtensionData& data_;
   BaseOtProvider& base_ot_provider_;
   BaseProvider& motion_base_provider_;
   OtProviderReceiver receiver_provider_;
   OtProviderSender sender_provider_;
-};
 
-class OtProviderFromThirdParty : public OtProvider {
-  // TODO
+  // correlated OTs of a trusted dealer that replace the OT extension in the next setup
+  std::optional<Block128> dealer_delta_;
+  Block128Vector dealer_sender_ots_;
+  std::optional<AlignedBitVector> dealer_choices_;
+  Block128Vector dealer_receiver_ots_;
+
+  std::unique_ptr<RandomOtPool> random_ot_pool_;
 };
 
 class OtProviderFromMultipleThirdParties : public OtProvider {
@@ -389,6 +474,28 @@ class OtProviderManager {
 
   bool HasWork();
 
+  /// \brief Generate the OTs with the silent OT extension from LPN if more OTs than the base OTs
+  /// it needs are requested, which reduces the communication of the OT extension setup.
+  /// Needs to be set to the same value by all parties before the setup phase.
+  void SetSilentOtExtension(bool value = true);
+
+  /// \brief Extend the OTs in chunks of \p number_of_ots OTs, each of which is transposed and
+  /// freed before the next one is extended, s.t. the memory needed besides the outputs does not
+  /// grow with the number of OTs.  Needs to be set to the same value by all parties before the
+  /// setup phase.
+  /// \throws std::invalid_argument if \p number_of_ots is not a positive multiple of 128.
+  void SetOtExtensionChunkSize(std::size_t number_of_ots);
+
+  /// \brief Finishes the random OT pools of all providers, see RandomOtPool::Finish.
+  void FinishRandomOtPools();
+
+  /// \brief Prepares the OTs of all providers for another run, see OtProvider::Clear.
+  void Clear() {
+    for (auto& provider : providers_) {
+      if (provider) provider->Clear();
+    }
+  }
+
  private:
   communication::CommunicationLayer& communication_layer_;
   std::vector<std::unique_ptr<OtProvider>> providers_;
@@ -0,0 +1,340 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "random_ot_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/motion_base_provider.h"
+#include "base_ots/base_ot_provider.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "data_storage/base_ot_data.h"
+#include "data_storage/ot_extension_data.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/bit_matrix.h"
+#include "utility/constants.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// passes the parts of the OTs from offset to offset + number_of_ots to copy, i.e., the OTs of a
+// batch, the range in the batch and the position in the result, and erases the batches all of
+// whose OTs were obtained
+template <typename Batches, typename CopyFunction>
+void TakeOts(Batches& batches, std::size_t batch_size, std::size_t offset,
+             std::size_t number_of_ots, CopyFunction copy) {
+  for (std::size_t position = offset; position < offset + number_of_ots;) {
+    const std::size_t batch_index{position / batch_size};
+    const std::size_t from{position % batch_size};
+    const std::size_t to{std::min(batch_size, offset + number_of_ots - batch_index * batch_size)};
+    auto batch{batches.find(batch_index)};
+    if (batch == batches.end()) {
+      throw std::logic_error(
+          fmt::format("The random OTs at offset {} were already obtained", position));
+    }
+    copy(batch->second.ots, from, to, position - offset);
+    batch->second.number_of_remaining_ots -= to - from;
+    if (batch->second.number_of_remaining_ots == 0) batches.erase(batch);
+    position += to - from;
+  }
+}
+
+}  // namespace
+
+RandomOtPool::RandomOtPool(OtExtensionData& data, BaseOtProvider& base_ot_provider,
+                           BaseProvider& motion_base_provider, std::size_t batch_size,
+                           std::size_t low_watermark)
+    : data_(data),
+      base_ot_provider_(base_ot_provider),
+      motion_base_provider_(motion_base_provider),
+      batch_size_(batch_size),
+      low_watermark_(low_watermark),
+      base_ot_offset_(base_ot_provider.Request(kKappa, data.party_id)) {
+  if (batch_size_ == 0 || batch_size_ % kKappa != 0) {
+    throw std::invalid_argument(fmt::format(
+        "The batch size of a random OT pool must be a positive multiple of {} but is {}", kKappa,
+        batch_size_));
+  }
+  // the receiver may send the first batch as soon as the online phase starts
+  RegisterMasks(1);
+}
+
+RandomOtPool::~RandomOtPool() {
+  // the thread only computes and sends a batch, so it finishes without the other party
+  if (receiver_batch_thread_.joinable()) receiver_batch_thread_.join();
+}
+
+void RandomOtPool::Finish() {
+  std::scoped_lock lock(receiver_mutex_);
+  if (receiver_batch_thread_.joinable()) receiver_batch_thread_.join();
+}
+
+void RandomOtPool::RegisterMasks(std::size_t number_of_batches) {
+  for (auto batch{number_of_sender_batches_ + masks_futures_.size()}; batch < number_of_batches;
+       ++batch) {
+    auto& futures{masks_futures_.emplace_back()};
+    futures.reserve(kKappa);
+    for (std::size_t i = 0; i < kKappa; ++i) {
+      futures.emplace_back(data_.message_manager.RegisterReceive(
+          data_.party_id, communication::MessageType::kRandomOtPoolMasks, batch * kKappa + i));
+    }
+  }
+}
+
+std::size_t RandomOtPool::ReserveSenderOts(std::size_t number_of_ots) {
+  std::scoped_lock lock(sender_mutex_);
+  const std::size_t offset{number_of_sender_ots_};
+  number_of_sender_ots_ += number_of_ots;
+  // the receiver sends the masks of reserved OTs without waiting for an acknowledgement
+  RegisterMasks(GetNumberOfBatches(number_of_sender_ots_));
+  return offset;
+}
+
+std::size_t RandomOtPool::ReserveReceiverOts(std::size_t number_of_ots) {
+  std::scoped_lock lock(receiver_mutex_);
+  const std::size_t offset{number_of_receiver_ots_};
+  number_of_receiver_ots_ += number_of_ots;
+  number_of_reserved_receiver_batches_ = GetNumberOfBatches(number_of_receiver_ots_);
+  return offset;
+}
+
+RandomSenderOts RandomOtPool::ObtainSenderOts(std::size_t number_of_ots) {
+  std::size_t offset;
+  {
+    std::scoped_lock lock(sender_mutex_);
+    offset = number_of_sender_ots_;
+    number_of_sender_ots_ += number_of_ots;
+  }
+  return ObtainSenderOts(offset, number_of_ots);
+}
+
+RandomSenderOts RandomOtPool::ObtainSenderOts(std::size_t offset, std::size_t number_of_ots) {
+  std::scoped_lock lock(sender_mutex_);
+  while (number_of_sender_batches_ < GetNumberOfBatches(offset + number_of_ots)) {
+    const std::size_t batch{number_of_sender_batches_};
+    sender_batches_.emplace(batch, Batch<RandomSenderOts>{ExtendSenderBatch(), batch_size_});
+  }
+  RandomSenderOts ots{Block128Vector(number_of_ots), Block128Vector(number_of_ots)};
+  TakeOts(sender_batches_, batch_size_, offset, number_of_ots,
+          [&ots](const RandomSenderOts& batch, std::size_t from, std::size_t to,
+                 std::size_t position) {
+            std::copy(batch.messages_0.begin() + from, batch.messages_0.begin() + to,
+                      ots.messages_0.begin() + position);
+            std::copy(batch.messages_1.begin() + from, batch.messages_1.begin() + to,
+                      ots.messages_1.begin() + position);
+          });
+  return ots;
+}
+
+RandomReceiverOts RandomOtPool::ObtainReceiverOts(std::size_t number_of_ots) {
+  std::size_t offset;
+  {
+    std::scoped_lock lock(receiver_mutex_);
+    offset = number_of_receiver_ots_;
+    number_of_receiver_ots_ += number_of_ots;
+  }
+  return ObtainReceiverOts(offset, number_of_ots);
+}
+
+RandomReceiverOts RandomOtPool::ObtainReceiverOts(std::size_t offset, std::size_t number_of_ots) {
+  std::scoped_lock lock(receiver_mutex_);
+  if (receiver_batch_future_.valid() &&
+      receiver_batch_future_.wait_for(std::chrono::seconds(0)) ==
+          boost::fibers::future_status::ready) {
+    CollectReceiverBatch();
+  }
+  const std::size_t end{offset + number_of_ots};
+  // the batch extended in the background is not collected yet
+  while (number_of_receiver_batches_ - (receiver_batch_future_.valid() ? 1 : 0) <
+         GetNumberOfBatches(end)) {
+    if (!receiver_batch_future_.valid()) StartReceiverBatch(true);
+    CollectReceiverBatch();
+  }
+
+  RandomReceiverOts ots{AlignedBitVector(), Block128Vector(number_of_ots)};
+  ots.choices.Reserve(number_of_ots);
+  TakeOts(receiver_batches_, batch_size_, offset, number_of_ots,
+          [&ots](const RandomReceiverOts& batch, std::size_t from, std::size_t to,
+                 std::size_t position) {
+            ots.choices.Append(batch.choices.Subset(from, to));
+            std::copy(batch.messages.begin() + from, batch.messages.begin() + to,
+                      ots.messages.begin() + position);
+          });
+  receiver_end_ = std::max(receiver_end_, end);
+
+  // extend the next batch in the background while the remaining OTs are used
+  if (number_of_receiver_batches_ * batch_size_ < receiver_end_ + low_watermark_ &&
+      !receiver_batch_future_.valid()) {
+    StartReceiverBatch(false);
+  }
+  return ots;
+}
+
+bool RandomOtPool::StartReceiverBatch(bool wait) {
+  const std::size_t batch{number_of_receiver_batches_};
+  // the sender registers the masks of a batch that was not reserved only after it processed the
+  // previous one
+  if (batch > 0 && batch >= number_of_reserved_receiver_batches_) {
+    if (!wait && !acknowledgement_future_.is_ready()) return false;
+    acknowledgement_future_.get();
+  }
+  ++number_of_receiver_batches_;
+  acknowledgement_future_ = data_.message_manager.RegisterReceive(
+      data_.party_id, communication::MessageType::kRandomOtPoolAcknowledgement, batch);
+
+  if (receiver_batch_thread_.joinable()) receiver_batch_thread_.join();
+  boost::fibers::packaged_task<RandomReceiverOts()> task(
+      [this, batch] { return ExtendReceiverBatch(batch); });
+  receiver_batch_future_ = task.get_future();
+  receiver_batch_thread_ = std::thread(std::move(task));
+  return true;
+}
+
+void RandomOtPool::CollectReceiverBatch() {
+  // only the last batch is extended in the background
+  const std::size_t batch{number_of_receiver_batches_ - 1};
+  receiver_batches_.emplace(batch,
+                            Batch<RandomReceiverOts>{receiver_batch_future_.get(), batch_size_});
+}
+
+RandomReceiverOts RandomOtPool::ExtendReceiverBatch(std::size_t batch) {
+  // the base OTs are ready in each run, which also keeps the batches of a run from being sent
+  // before the other party cleared the last run
+  const auto& base_ots_sender_data{
+      base_ot_provider_.GetBaseOtsData(data_.party_id).GetSenderData()};
+  base_ots_sender_data.WaitOnline();
+  if (receiver_base_ot_keys_0_.empty()) {
+    const auto first{base_ots_sender_data.messages_0.begin() + base_ot_offset_};
+    receiver_base_ot_keys_0_.assign(first, first + kKappa);
+    const auto first_1{base_ots_sender_data.messages_1.begin() + base_ot_offset_};
+    receiver_base_ot_keys_1_.assign(first_1, first_1 + kKappa);
+  }
+
+  const std::size_t byte_size{batch_size_ / 8};
+  // each batch uses its own part of the streams expanded from the base OTs
+  const std::size_t prg_offset{batch * (batch_size_ / kKappa + 1)};
+  RandomReceiverOts ots{AlignedBitVector::SecureRandom(batch_size_), Block128Vector(batch_size_)};
+
+  // same as the receiver of the OT extension, see OtProviderFromOtExtension::ReceiveSetup
+  std::vector<AlignedBitVector> v(kKappa);
+  primitives::Prg prg_variable_key;
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    // T[j] = Prg(s_{j,0})
+    prg_variable_key.SetKey(receiver_base_ot_keys_0_[i].data());
+    prg_variable_key.SetOffset(prg_offset);
+    v[i] = AlignedBitVector(prg_variable_key.Encrypt(byte_size), batch_size_);
+    // u_j = T[j] XOR r XOR Prg(s_{j,1})
+    auto u{v[i]};
+    u ^= ots.choices;
+    prg_variable_key.SetKey(receiver_base_ot_keys_1_[i].data());
+    prg_variable_key.SetOffset(prg_offset);
+    u ^= AlignedBitVector(prg_variable_key.Encrypt(byte_size), batch_size_);
+
+    auto u_pointer{std::make_shared<const AlignedBitVector>(std::move(u))};
+    auto buffer_span{std::span(reinterpret_cast<const std::uint8_t*>(u_pointer->GetData().data()),
+                               u_pointer->GetData().size())};
+    data_.send_payload_function(communication::MessageType::kRandomOtPoolMasks,
+                                batch * kKappa + i, buffer_span, std::move(u_pointer));
+  }
+
+  std::array<const std::byte*, kKappa> pointers;
+  for (std::size_t i = 0; i < kKappa; ++i) pointers[i] = v[i].GetData().data();
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(motion_base_provider_.GetAesFixedKey().data());
+  std::vector<BitVector<>> outputs(batch_size_);
+  BitMatrix::ReceiverTranspose128AndEncrypt(pointers, outputs, prg_fixed_key, batch_size_,
+                                            std::vector<std::size_t>(batch_size_, kKappa));
+  for (std::size_t j = 0; j < batch_size_; ++j) {
+    ots.messages.at(j) = Block128::MakeFromMemory(outputs[j].GetData().data());
+  }
+  return ots;
+}
+
+RandomSenderOts RandomOtPool::ExtendSenderBatch() {
+  const auto& base_ots_receiver_data{
+      base_ot_provider_.GetBaseOtsData(data_.party_id).GetReceiverData()};
+  base_ots_receiver_data.WaitOnline();
+  if (sender_base_ot_keys_.empty()) {
+    const auto first{base_ots_receiver_data.messages_c.begin() + base_ot_offset_};
+    sender_base_ot_keys_.assign(first, first + kKappa);
+    sender_base_ot_choices_ =
+        base_ots_receiver_data.c.Subset(base_ot_offset_, base_ot_offset_ + kKappa);
+  }
+  RegisterMasks(number_of_sender_batches_ + 1);
+  auto masks_futures{std::move(masks_futures_.front())};
+  masks_futures_.pop_front();
+
+  const std::size_t byte_size{batch_size_ / 8};
+  const std::size_t prg_offset{number_of_sender_batches_ * (batch_size_ / kKappa + 1)};
+
+  // same as the sender of the OT extension, see OtProviderFromOtExtension::SendSetup
+  std::vector<AlignedBitVector> v(kKappa);
+  primitives::Prg prg_variable_key;
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    prg_variable_key.SetKey(sender_base_ot_keys_[i].data());
+    prg_variable_key.SetOffset(prg_offset);
+    v[i] = AlignedBitVector(prg_variable_key.Encrypt(byte_size), batch_size_);
+  }
+  for (std::size_t i = 0; i < kKappa; ++i) {
+    auto raw_message{masks_futures[i].get()};
+    auto payload{communication::GetMessage(raw_message.data())->payload()};
+    if (payload->size() != byte_size) {
+      throw std::runtime_error(
+          fmt::format("Received random OT pool mask of {} B from Party#{} but expected {} B",
+                      payload->size(), data_.party_id, byte_size));
+    }
+    if (sender_base_ot_choices_.Get(i)) {
+      BitSpan bit_span_u(const_cast<std::uint8_t*>(payload->data()), batch_size_);
+      BitSpan bit_span_v(v[i].GetMutableData().data(), batch_size_, true);
+      bit_span_v ^= bit_span_u;
+    }
+  }
+
+  // let the receiver send the next batch
+  ++number_of_sender_batches_;
+  RegisterMasks(number_of_sender_batches_ + 1);
+  data_.send_function(communication::BuildMessage(
+      communication::MessageType::kRandomOtPoolAcknowledgement, number_of_sender_batches_ - 1, {}));
+
+  std::array<const std::byte*, kKappa> pointers;
+  for (std::size_t i = 0; i < kKappa; ++i) pointers[i] = v[i].GetData().data();
+  primitives::Prg prg_fixed_key;
+  prg_fixed_key.SetKey(motion_base_provider_.GetAesFixedKey().data());
+  std::vector<BitVector<>> y0(batch_size_), y1(batch_size_);
+  BitMatrix::SenderTranspose128AndEncrypt(pointers, y0, y1, sender_base_ot_choices_, prg_fixed_key,
+                                          batch_size_,
+                                          std::vector<std::size_t>(batch_size_, kKappa));
+  RandomSenderOts ots{Block128Vector(batch_size_), Block128Vector(batch_size_)};
+  for (std::size_t j = 0; j < batch_size_; ++j) {
+    ots.messages_0.at(j) = Block128::MakeFromMemory(y0[j].GetData().data());
+    ots.messages_1.at(j) = Block128::MakeFromMemory(y1[j].GetData().data());
+  }
+  return ots;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <boost/fiber/future.hpp>
+#include <boost/fiber/mutex.hpp>
+
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion {
+
+class BaseOtProvider;
+class BaseProvider;
+struct OtExtensionData;
+
+// number of OTs a RandomOtPool extends at once if not set otherwise
+constexpr std::size_t kDefaultRandomOtPoolBatchSize{std::size_t(1) << 16};
+
+/// \brief Random 1-out-of-2 OTs of 128-bit strings as held by the sender.
+struct RandomSenderOts {
+  Block128Vector messages_0;
+  Block128Vector messages_1;
+};
+
+/// \brief Random 1-out-of-2 OTs of 128-bit strings as held by the receiver, who got
+/// messages_0[i] if choices[i] is 0 and messages_1[i] otherwise.
+struct RandomReceiverOts {
+  AlignedBitVector choices;
+  Block128Vector messages;
+};
+
+/// \brief Random OTs with one other party that are extended in batches during the online phase.
+///
+/// Unlike the OT flavors of OtProvider, the OTs of the pool need not be registered before the
+/// setup, which suits workloads whose size is not known upfront.  The receiver extends the next
+/// batch in the background as soon as fewer than the low watermark of its OTs are left and blocks
+/// only if a request exceeds the OTs at hand.  The sender processes a batch when it needs its
+/// OTs.  The i-th OT obtained by the sender belongs to the i-th OT obtained by the receiver of the
+/// other party, so both parties need to obtain the OTs, e.g., of a gate, in the same order.
+/// Gates whose setup phases run concurrently instead reserve their OTs in their constructors and
+/// obtain them by offset, see ReserveSenderOts.
+/// Random OTs are turned into chosen-input OTs with one round of derandomization: the receiver
+/// sends its inputs XOR the random choices, and the sender masks its inputs with the messages,
+/// which it swaps where the received bit is 1.
+class RandomOtPool {
+ public:
+  /// \brief Creates the pool of the party with the other party of \p data, which needs to be done
+  /// by both parties before the setup phase, since it requests base OTs from \p base_ot_provider.
+  /// \throws std::invalid_argument if \p batch_size is not a positive multiple of 128.
+  RandomOtPool(OtExtensionData& data, BaseOtProvider& base_ot_provider,
+               BaseProvider& motion_base_provider,
+               std::size_t batch_size = kDefaultRandomOtPoolBatchSize,
+               std::size_t low_watermark = kDefaultRandomOtPoolBatchSize / 2);
+
+  ~RandomOtPool();
+
+  RandomOtPool(const RandomOtPool&) = delete;
+
+  /// \brief Reserves the next \p number_of_ots OTs in which this party is the sender and returns
+  /// their offset for ObtainSenderOts.  The other party needs to reserve the same OTs as receiver
+  /// in the same order, e.g., in the constructors of the gates, but outside of the online phase,
+  /// since the batches of reserved OTs are extended without waiting for the sender.
+  std::size_t ReserveSenderOts(std::size_t number_of_ots);
+
+  /// \brief Reserves the next \p number_of_ots OTs in which this party is the receiver, see
+  /// ReserveSenderOts.
+  std::size_t ReserveReceiverOts(std::size_t number_of_ots);
+
+  /// \brief Takes the next \p number_of_ots OTs in which this party is the sender.
+  RandomSenderOts ObtainSenderOts(std::size_t number_of_ots);
+
+  /// \brief Takes the \p number_of_ots OTs reserved at \p offset in which this party is the
+  /// sender, which may happen in any order.
+  RandomSenderOts ObtainSenderOts(std::size_t offset, std::size_t number_of_ots);
+
+  /// \brief Takes the next \p number_of_ots OTs in which this party is the receiver.
+  RandomReceiverOts ObtainReceiverOts(std::size_t number_of_ots);
+
+  /// \brief Takes the \p number_of_ots OTs reserved at \p offset in which this party is the
+  /// receiver, which may happen in any order.
+  RandomReceiverOts ObtainReceiverOts(std::size_t offset, std::size_t number_of_ots);
+
+  /// \brief Waits until the batch extended in the background has been sent, which needs to be
+  /// done before the communication layer is shut down, see Party::Finish.
+  void Finish();
+
+  std::size_t GetBatchSize() const noexcept { return batch_size_; }
+
+  std::size_t GetNumberOfSenderBatches() const noexcept { return number_of_sender_batches_; }
+
+  std::size_t GetNumberOfReceiverBatches() const noexcept { return number_of_receiver_batches_; }
+
+ private:
+  // the OTs of a batch and how many of them were not obtained yet
+  template <typename Ots>
+  struct Batch {
+    Ots ots;
+    std::size_t number_of_remaining_ots;
+  };
+
+  // the number of batches that hold the first number_of_ots OTs
+  std::size_t GetNumberOfBatches(std::size_t number_of_ots) const {
+    return (number_of_ots + batch_size_ - 1) / batch_size_;
+  }
+
+  // waits for the masks of the next batch and computes the sender's OTs
+  RandomSenderOts ExtendSenderBatch();
+
+  // computes the receiver's OTs of batch and sends the masks
+  RandomReceiverOts ExtendReceiverBatch(std::size_t batch);
+
+  // starts extending the next batch of the receiver in a separate thread unless the sender has not
+  // confirmed the previous batch yet and wait is false
+  bool StartReceiverBatch(bool wait);
+
+  // moves the batch extended in the background to the receiver's batches
+  void CollectReceiverBatch();
+
+  // registers the masks of the sender's batches up to number_of_batches
+  void RegisterMasks(std::size_t number_of_batches);
+
+  OtExtensionData& data_;
+  BaseOtProvider& base_ot_provider_;
+  BaseProvider& motion_base_provider_;
+  const std::size_t batch_size_;
+  const std::size_t low_watermark_;
+  const std::size_t base_ot_offset_;
+
+  boost::fibers::mutex sender_mutex_;
+  std::map<std::size_t, Batch<RandomSenderOts>> sender_batches_;
+  // the number of OTs reserved or obtained so far
+  std::size_t number_of_sender_ots_{0};
+  std::size_t number_of_sender_batches_{0};
+  // the masks of the batches from number_of_sender_batches_ on that are registered
+  std::deque<std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>>> masks_futures_;
+  // the base OTs of the pool as receiver, copied before the first batch s.t. renewing the base OTs
+  // for another run, see BaseOtProvider::Clear, does not change the keys of later batches
+  std::vector<std::array<std::byte, 16>> sender_base_ot_keys_;
+  BitVector<> sender_base_ot_choices_;
+
+  boost::fibers::mutex receiver_mutex_;
+  std::map<std::size_t, Batch<RandomReceiverOts>> receiver_batches_;
+  // the number of OTs reserved or obtained so far
+  std::size_t number_of_receiver_ots_{0};
+  // the end of the OTs obtained so far, which determines when the next batch is extended
+  std::size_t receiver_end_{0};
+  std::size_t number_of_receiver_batches_{0};
+  // the sender registers the masks of these batches when the OTs are reserved
+  std::size_t number_of_reserved_receiver_batches_{0};
+  ReusableFiberFuture<std::vector<std::uint8_t>> acknowledgement_future_;
+  boost::fibers::future<RandomReceiverOts> receiver_batch_future_;
+  std::thread receiver_batch_thread_;
+  // the base OTs of the pool as sender, see sender_base_ot_keys_
+  std::vector<std::array<std::byte, 16>> receiver_base_ot_keys_0_;
+  std::vector<std::array<std::byte, 16>> receiver_base_ot_keys_1_;
+};
+
+}  // namespace encrypto::motion
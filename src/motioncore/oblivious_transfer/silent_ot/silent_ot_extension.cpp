@@ -0,0 +1,327 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "silent_ot_extension.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "primitives/aes/aesni_primitives.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// parameter sets for 128 bit computational security from Ferret, Table 2
+constexpr SilentOtParameters kSmallParameters{36'288, 1'269, 9};
+constexpr SilentOtParameters kLargeParameters{589'760, 1'295, 13};
+
+// public fixed keys for the GGM tree's PRG, the hash and the LPN matrix
+struct FixedKeys {
+  alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> left;
+  alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> right;
+  alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> hash;
+  alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> lpn;
+};
+
+const FixedKeys& GetFixedKeys() {
+  static const FixedKeys keys{[] {
+    FixedKeys result;
+    std::size_t key_index{0};
+    for (auto* round_keys : {&result.left, &result.right, &result.hash, &result.lpn}) {
+      for (std::size_t i = 0; i < kAesKeySize128; ++i) {
+        (*round_keys)[i] = std::byte(0x5A ^ (16 * key_index + i));
+      }
+      AesniKeyExpansion128(round_keys->data());
+      ++key_index;
+    }
+    return result;
+  }()};
+  return keys;
+}
+
+// length-doubling PRG of the GGM tree
+inline void ExpandNode(const Block128& node, Block128& left, Block128& right) {
+  const auto& keys{GetFixedKeys()};
+  left = node;
+  right = node;
+  AesniMmoSingle(keys.left.data(), left.data());
+  AesniMmoSingle(keys.right.data(), right.data());
+}
+
+// hash breaking the correlation of the base COTs, tweaked by the index of the base COT
+inline Block128 Hash(const Block128& x, std::uint64_t tweak) {
+  Block128 result{x};
+  std::uint64_t word;
+  std::memcpy(&word, result.data(), sizeof(word));
+  word ^= tweak;
+  std::memcpy(result.data(), &word, sizeof(word));
+  AesniMmoSingle(GetFixedKeys().hash.data(), result.data());
+  return result;
+}
+
+// fills the GGM tree's leaves in place, level by level from the seed at position 0
+void ExpandTree(std::span<Block128> nodes, std::size_t depth, std::span<Block128> left_sums,
+                std::span<Block128> right_sums) {
+  for (std::size_t level = 0; level < depth; ++level) {
+    std::size_t number_of_nodes{std::size_t(1) << level};
+    left_sums[level].SetToZero();
+    right_sums[level].SetToZero();
+    // iterate backwards to not overwrite nodes that are still to be expanded
+    for (std::size_t j = number_of_nodes; j-- > 0;) {
+      Block128 node{nodes[j]};
+      ExpandNode(node, nodes[2 * j], nodes[2 * j + 1]);
+      left_sums[level] ^= nodes[2 * j];
+      right_sums[level] ^= nodes[2 * j + 1];
+    }
+  }
+}
+
+// computes outputs[j] ^= XOR of lpn_secret[a] for the kLpnWeight indices a of column j
+void MultiplyLpnMatrix(std::span<const Block128> lpn_secret, std::span<Block128> outputs) {
+  constexpr std::size_t kBlocksPerColumn{(kLpnWeight + 3) / 4};
+  constexpr std::size_t kBatchSize{1024};
+  alignas(kAesBlockSize) std::array<std::uint32_t, 4 * kBlocksPerColumn * kBatchSize> indices;
+  const auto& keys{GetFixedKeys()};
+  std::uint64_t counter{0};
+  for (std::size_t offset = 0; offset < outputs.size(); offset += kBatchSize) {
+    std::size_t batch_size{std::min(kBatchSize, outputs.size() - offset)};
+    AesniCtrStreamBlocks128(keys.lpn.data(), &counter, indices.data(),
+                            kBlocksPerColumn * batch_size);
+    counter += kBlocksPerColumn * batch_size;
+    for (std::size_t j = 0; j < batch_size; ++j) {
+      auto* column_indices{indices.data() + 4 * kBlocksPerColumn * j};
+      auto& output{outputs[offset + j]};
+      for (std::size_t w = 0; w < kLpnWeight; ++w) {
+        output ^= lpn_secret[column_indices[w] % lpn_secret.size()];
+      }
+    }
+  }
+}
+
+// computes outputs[j] ^= parity of the LPN secret's bits selected by column j
+void MultiplyLpnMatrix(const BitSpan& lpn_secret, BitSpan& outputs) {
+  constexpr std::size_t kBlocksPerColumn{(kLpnWeight + 3) / 4};
+  constexpr std::size_t kBatchSize{1024};
+  alignas(kAesBlockSize) std::array<std::uint32_t, 4 * kBlocksPerColumn * kBatchSize> indices;
+  const auto& keys{GetFixedKeys()};
+  const auto* secret{reinterpret_cast<const std::uint8_t*>(lpn_secret.GetData())};
+  auto* output_bits{reinterpret_cast<std::uint8_t*>(outputs.GetMutableData())};
+  std::uint64_t counter{0};
+  for (std::size_t offset = 0; offset < outputs.GetSize(); offset += kBatchSize) {
+    std::size_t batch_size{std::min(kBatchSize, outputs.GetSize() - offset)};
+    AesniCtrStreamBlocks128(keys.lpn.data(), &counter, indices.data(),
+                            kBlocksPerColumn * batch_size);
+    counter += kBlocksPerColumn * batch_size;
+    for (std::size_t j = 0; j < batch_size; ++j) {
+      auto* column_indices{indices.data() + 4 * kBlocksPerColumn * j};
+      std::uint8_t bit{0};
+      for (std::size_t w = 0; w < kLpnWeight; ++w) {
+        std::size_t index{column_indices[w] % lpn_secret.GetSize()};
+        bit ^= (secret[index / 8] >> (index % 8)) & 1;
+      }
+      output_bits[(offset + j) / 8] ^= bit << ((offset + j) % 8);
+    }
+  }
+}
+
+// transposes a 128x128 bit matrix given as 16 B rows
+void Transpose128x128(const std::array<const std::byte*, 128>& input,
+                      const std::array<std::byte*, 128>& output) {
+  auto in = [&input](std::size_t row, std::size_t column) {
+    return static_cast<char>(input[row][column / 8]);
+  };
+  for (std::size_t r = 0; r < 128; r += 16) {
+    for (std::size_t c = 0; c < 128; c += 8) {
+#if defined(__ARM_NEON)
+      std::array<std::uint8_t, 16> bytes;
+      for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = in(r + i, c);
+      uint8x16_t vec{vld1q_u8(bytes.data())};
+      const uint8x16_t kWeights{1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+      // the most significant bits of the bytes are the bits of column c + 7 - i, which are
+      // gathered as by _mm_movemask_epi8
+      for (int i = 0; i < 8; vec = vshlq_n_u8(vec, 1), ++i) {
+        const uint8x16_t weighted_bits{
+            vandq_u8(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(vec), 7)), kWeights)};
+        std::uint16_t bits = vaddv_u8(vget_low_u8(weighted_bits)) |
+                             (vaddv_u8(vget_high_u8(weighted_bits)) << 8);
+        std::memcpy(output[c + 7 - i] + r / 8, &bits, sizeof(bits));
+      }
+#elif defined(__SSE2__)
+      __m128i vec{_mm_set_epi8(in(r + 15, c), in(r + 14, c), in(r + 13, c), in(r + 12, c),
+                               in(r + 11, c), in(r + 10, c), in(r + 9, c), in(r + 8, c),
+                               in(r + 7, c), in(r + 6, c), in(r + 5, c), in(r + 4, c),
+                               in(r + 3, c), in(r + 2, c), in(r + 1, c), in(r + 0, c))};
+      // the most significant bits of the bytes are the bits of column c + 7 - i
+      for (int i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
+        std::uint16_t bits = _mm_movemask_epi8(vec);
+        std::memcpy(output[c + 7 - i] + r / 8, &bits, sizeof(bits));
+      }
+#else
+      // bit j of the bits of column c + 7 - i is the bit of row r + j
+      for (int i = 0; i < 8; ++i) {
+        std::uint16_t bits{0};
+        for (std::size_t j = 0; j < 16; ++j) {
+          bits |= ((static_cast<std::uint8_t>(in(r + j, c)) >> (7 - i)) & 1u) << j;
+        }
+        std::memcpy(output[c + 7 - i] + r / 8, &bits, sizeof(bits));
+      }
+#endif
+    }
+  }
+}
+
+}  // namespace
+
+std::optional<SilentOtParameters> SelectSilentOtParameters(std::size_t number_of_ots) {
+  auto cost = [number_of_ots](const SilentOtParameters& parameters) {
+    std::size_t number_of_instances{(number_of_ots + parameters.GetNumberOfOts() - 1) /
+                                    parameters.GetNumberOfOts()};
+    return number_of_instances * parameters.GetNumberOfBaseOts();
+  };
+  const auto& parameters{cost(kSmallParameters) <= cost(kLargeParameters) ? kSmallParameters
+                                                                          : kLargeParameters};
+  // only worth the additional computation if it at least halves the number of base OTs
+  if (2 * cost(parameters) > number_of_ots) return std::nullopt;
+  return parameters;
+}
+
+void SilentOtSenderExpand(const SilentOtParameters& parameters,
+                          std::span<const Block128> base_ots, const Block128& delta,
+                          std::span<Block128> message, std::span<Block128> outputs) {
+  const std::size_t depth{parameters.tree_depth}, block_size{std::size_t(1) << depth};
+  assert(base_ots.size() == parameters.GetNumberOfBaseOts());
+  assert(message.size() == parameters.GetMessageSize());
+  assert(outputs.size() == parameters.GetNumberOfOts());
+
+  std::vector<Block128> left_sums(depth), right_sums(depth);
+  for (std::size_t i = 0; i < parameters.number_of_noise_blocks; ++i) {
+    auto leaves{outputs.subspan(i * block_size, block_size)};
+    leaves[0] = Block128::MakeRandom();
+    ExpandTree(leaves, depth, left_sums, right_sums);
+
+    // the receiver learns the sums of the siblings of its path, which is the negation of the
+    // random choices of the base COTs
+    auto block_message{message.subspan(i * (2 * depth + 1), 2 * depth + 1)};
+    for (std::size_t level = 0; level < depth; ++level) {
+      std::size_t base_ot_index{parameters.lpn_secret_size + i * depth + level};
+      const auto& q{base_ots[base_ot_index]};
+      block_message[2 * level] = left_sums[level] ^ Hash(q, base_ot_index);
+      block_message[2 * level + 1] = right_sums[level] ^ Hash(q ^ delta, base_ot_index);
+    }
+    // allows the receiver to compute the punctured leaf xor delta
+    Block128 sum{delta};
+    for (const auto& leaf : leaves) sum ^= leaf;
+    block_message[2 * depth] = sum;
+  }
+
+  MultiplyLpnMatrix(base_ots.first(parameters.lpn_secret_size), outputs);
+}
+
+void SilentOtReceiverExpand(const SilentOtParameters& parameters,
+                            std::span<const Block128> base_ots, const BitSpan& base_choices,
+                            std::span<const Block128> message, std::span<Block128> outputs,
+                            BitSpan& choices) {
+  const std::size_t depth{parameters.tree_depth}, block_size{std::size_t(1) << depth};
+  assert(base_ots.size() == parameters.GetNumberOfBaseOts());
+  assert(base_choices.GetSize() == parameters.GetNumberOfBaseOts());
+  assert(message.size() == parameters.GetMessageSize());
+  assert(outputs.size() == parameters.GetNumberOfOts());
+  assert(choices.GetSize() == parameters.GetNumberOfOts());
+
+  choices.Set(false);
+  for (std::size_t i = 0; i < parameters.number_of_noise_blocks; ++i) {
+    auto leaves{outputs.subspan(i * block_size, block_size)};
+    auto block_message{message.subspan(i * (2 * depth + 1), 2 * depth + 1)};
+    // index of the unknown node on the current level
+    std::size_t punctured_index{0};
+    for (std::size_t level = 0; level < depth; ++level) {
+      std::size_t base_ot_index{parameters.lpn_secret_size + i * depth + level};
+      // the receiver obtains the sum for its random choice and goes the other way
+      bool sibling_is_right{base_choices.Get(base_ot_index)};
+      Block128 sibling_sum{block_message[2 * level + sibling_is_right] ^
+                           Hash(base_ots[base_ot_index], base_ot_index)};
+
+      for (std::size_t j = std::size_t(1) << level; j-- > 0;) {
+        if (j == punctured_index) {
+          leaves[2 * j].SetToZero();
+          leaves[2 * j + 1].SetToZero();
+        } else {
+          Block128 node{leaves[j]};
+          ExpandNode(node, leaves[2 * j], leaves[2 * j + 1]);
+        }
+      }
+      // the sibling of the punctured node is the only node whose parent is unknown
+      for (std::size_t j = sibling_is_right; j < (std::size_t(2) << level); j += 2) {
+        sibling_sum ^= leaves[j];
+      }
+      leaves[2 * punctured_index + sibling_is_right] = sibling_sum;
+      punctured_index = 2 * punctured_index + !sibling_is_right;
+    }
+    Block128 punctured_leaf{block_message[2 * depth]};
+    for (const auto& leaf : leaves) punctured_leaf ^= leaf;
+    leaves[punctured_index] = punctured_leaf;
+    // the noise vector has a single one in each block at the punctured leaf
+    choices.Set(true, i * block_size + punctured_index);
+  }
+
+  MultiplyLpnMatrix(base_ots.first(parameters.lpn_secret_size), outputs);
+  MultiplyLpnMatrix(base_choices.Subspan(0, parameters.lpn_secret_size), choices);
+}
+
+void TransposeRowsToBlocks(const std::array<const std::byte*, 128>& rows,
+                           std::span<Block128> blocks, std::size_t number_of_columns) {
+  assert(number_of_columns % 128 == 0);
+  assert(blocks.size() >= number_of_columns);
+  std::array<const std::byte*, 128> input;
+  std::array<std::byte*, 128> output;
+  for (std::size_t column = 0; column < number_of_columns; column += 128) {
+    for (std::size_t i = 0; i < 128; ++i) {
+      input[i] = rows[i] + column / 8;
+      output[i] = blocks[column + i].data();
+    }
+    Transpose128x128(input, output);
+  }
+}
+
+void TransposeBlocksToRows(std::span<const Block128> blocks,
+                           const std::array<std::byte*, 128>& rows) {
+  assert(blocks.size() % 128 == 0);
+  std::array<const std::byte*, 128> input;
+  std::array<std::byte*, 128> output;
+  for (std::size_t column = 0; column < blocks.size(); column += 128) {
+    for (std::size_t i = 0; i < 128; ++i) {
+      input[i] = blocks[column + i].data();
+      output[i] = rows[i] + column / 8;
+    }
+    Transpose128x128(input, output);
+  }
+}
+
+}  // namespace encrypto::motion
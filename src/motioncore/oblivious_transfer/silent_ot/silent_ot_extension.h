@@ -0,0 +1,104 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+namespace encrypto::motion {
+
+// Silent OT extension from primal LPN with regular noise as in Ferret (Yang et al., CCS'20,
+// https://eprint.iacr.org/2020/924), semi-honest variant.
+//
+// An instance consumes GetNumberOfBaseOts() random correlated OTs (COTs), i.e., the sender holds
+// q_i and the global offset delta, the receiver holds a random choice bit r_i and
+// t_i = q_i ^ r_i * delta, and expands them into GetNumberOfOts() COTs with the same delta:
+// - the first lpn_secret_size base COTs are a sharing of the LPN secret s,
+// - the remaining ones are used to obliviously transfer all but one leaf of a GGM tree for each
+//   of the number_of_noise_blocks blocks of the noise vector e (single-point COT),
+// - the outputs are the sharings of s * A ^ e for a public sparse matrix A with kLpnWeight ones
+//   per column.
+// Besides the base COTs, only GetMessageSize() blocks are sent from the sender to the receiver.
+
+struct SilentOtParameters {
+  std::size_t lpn_secret_size;
+  std::size_t number_of_noise_blocks;
+  // log2 of the size of a noise block
+  std::size_t tree_depth;
+
+  std::size_t GetNumberOfOts() const noexcept { return number_of_noise_blocks << tree_depth; }
+
+  std::size_t GetNumberOfBaseOts() const noexcept {
+    return lpn_secret_size + number_of_noise_blocks * tree_depth;
+  }
+
+  /// \brief Number of blocks the sender sends to the receiver per instance.
+  std::size_t GetMessageSize() const noexcept {
+    return number_of_noise_blocks * (2 * tree_depth + 1);
+  }
+};
+
+// number of ones in each column of the LPN matrix
+constexpr std::size_t kLpnWeight{10};
+
+/// \brief Selects the parameters for extending \p number_of_ots OTs or returns std::nullopt if
+/// the silent OT extension would not save communication for so few OTs.
+std::optional<SilentOtParameters> SelectSilentOtParameters(std::size_t number_of_ots);
+
+/// \brief Sender side of one instance.
+/// \param base_ots GetNumberOfBaseOts() sender parts q_i of the base COTs
+/// \param delta global offset of the COTs
+/// \param message output, GetMessageSize() blocks that need to be sent to the receiver
+/// \param outputs output, GetNumberOfOts() sender parts of the extended COTs
+void SilentOtSenderExpand(const SilentOtParameters& parameters,
+                          std::span<const Block128> base_ots, const Block128& delta,
+                          std::span<Block128> message, std::span<Block128> outputs);
+
+/// \brief Receiver side of one instance.
+/// \param base_ots GetNumberOfBaseOts() receiver parts t_i of the base COTs
+/// \param base_choices random choice bits r_i of the base COTs
+/// \param message GetMessageSize() blocks received from the sender
+/// \param outputs output, GetNumberOfOts() receiver parts of the extended COTs
+/// \param choices output, GetNumberOfOts() random choice bits of the extended COTs
+void SilentOtReceiverExpand(const SilentOtParameters& parameters,
+                            std::span<const Block128> base_ots, const BitSpan& base_choices,
+                            std::span<const Block128> message, std::span<Block128> outputs,
+                            BitSpan& choices);
+
+/// \brief Transposes a matrix of 128 rows of \p number_of_columns bits into one block per
+/// column, i.e., bit i of block j is bit j of row i.
+/// \pre number_of_columns is a multiple of 128 and the rows are 16 B aligned
+void TransposeRowsToBlocks(const std::array<const std::byte*, 128>& rows,
+                           std::span<Block128> blocks, std::size_t number_of_columns);
+
+/// \brief Inverse of TransposeRowsToBlocks.
+/// \pre blocks.size() is a multiple of 128 and the rows are 16 B aligned
+void TransposeBlocksToRows(std::span<const Block128> blocks,
+                           const std::array<std::byte*, 128>& rows);
+
+}  // namespace encrypto::motion
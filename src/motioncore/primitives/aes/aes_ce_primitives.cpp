@@ -0,0 +1,370 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// Implementation of the functions declared in aesni_primitives.h with the ARMv8 Cryptography
+// Extensions, which is compiled instead of aesni_primitives.cpp on AArch64.  The outputs are
+// identical to the ones of the AES-NI implementation.
+
+#include "aesni_primitives.h"
+#include <arm_neon.h>
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#if !defined(__ARM_FEATURE_AES) && !defined(__ARM_FEATURE_CRYPTO)
+#error "the ARMv8 Cryptography Extensions are required, e.g., -march=armv8-a+crypto"
+#endif
+
+namespace {
+
+using RoundKeys = std::array<uint8x16_t, kAesNumRoundKeys128>;
+
+RoundKeys LoadRoundKeys(const void* round_keys_input) {
+  auto round_keys_pointer = reinterpret_cast<const std::uint8_t*>(round_keys_input);
+  RoundKeys round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    round_keys[r] = vld1q_u8(round_keys_pointer + r * kAesBlockSize);
+  }
+  return round_keys;
+}
+
+inline uint8x16_t LoadBlock(const void* pointer) {
+  return vld1q_u8(reinterpret_cast<const std::uint8_t*>(pointer));
+}
+
+inline void StoreBlock(void* pointer, uint8x16_t block) {
+  vst1q_u8(reinterpret_cast<std::uint8_t*>(pointer), block);
+}
+
+// the block holding the 128-bit integer low + 2^64 * high in little-endian byte order, as
+// _mm_set_epi64x(high, low)
+inline uint8x16_t MakeBlock(std::uint64_t high, std::uint64_t low) {
+  return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(low), vcreate_u64(high)));
+}
+
+inline uint8x16_t TweakBlock(__uint128_t tweak) {
+  return MakeBlock(static_cast<std::uint64_t>(tweak >> 64), static_cast<std::uint64_t>(tweak));
+}
+
+// AES on kWidth independent blocks inplace, s.t. kWidth blocks are in flight in the AES pipeline.
+// AESE includes the AddRoundKey preceding SubBytes and ShiftRows, so the last round key is xored
+// explicitly.
+template <std::size_t kWidth>
+inline void AesCeEncryptWide(const RoundKeys& round_keys, uint8x16_t* blocks) {
+  for (std::size_t r = 0; r < kAesNumRoundKeys128 - 2; ++r) {
+    for (std::size_t j = 0; j < kWidth; ++j) {
+      blocks[j] = vaesmcq_u8(vaeseq_u8(blocks[j], round_keys[r]));
+    }
+  }
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    blocks[j] = veorq_u8(vaeseq_u8(blocks[j], round_keys[kAesNumRoundKeys128 - 2]),
+                         round_keys[kAesNumRoundKeys128 - 1]);
+  }
+}
+
+// Number of blocks that are encrypted together by the CTR streams
+constexpr std::size_t kCtrWidth{8};
+
+void CtrStreamBlocks(const void* round_keys_input, std::uint64_t* counter_input_pointer,
+                     void* output_input_pointer, std::size_t number_of_blocks) {
+  const RoundKeys round_keys{LoadRoundKeys(round_keys_input)};
+  auto output = reinterpret_cast<std::uint8_t*>(output_input_pointer);
+  auto counter = *counter_input_pointer;
+  std::array<uint8x16_t, kCtrWidth> wb;
+
+  auto batch_blocks = number_of_blocks - number_of_blocks % kCtrWidth;
+  for (std::size_t i = 0; i < batch_blocks; i += kCtrWidth) {
+    for (std::size_t j = 0; j < kCtrWidth; ++j) wb[j] = MakeBlock(0, counter + j);
+    AesCeEncryptWide<kCtrWidth>(round_keys, wb.data());
+    for (std::size_t j = 0; j < kCtrWidth; ++j) StoreBlock(output + (i + j) * kAesBlockSize, wb[j]);
+    counter += kCtrWidth;
+  }
+
+  // do the remaining blocks
+  for (std::size_t i = batch_blocks; i < number_of_blocks; ++i) {
+    wb[0] = MakeBlock(0, counter);
+    AesCeEncryptWide<1>(round_keys, wb.data());
+    StoreBlock(output + i * kAesBlockSize, wb[0]);
+    ++counter;
+  }
+
+  // write the new counter back
+  *counter_input_pointer = counter;
+}
+
+// TMMO on kWidth independent blocks, each with its own tweak, see AesniTmmoWide
+template <std::size_t kWidth>
+inline void TmmoWide(const RoundKeys& round_keys, std::uint8_t* input, const uint8x16_t* tweaks) {
+  std::array<uint8x16_t, kWidth> wb_1;
+  std::array<uint8x16_t, kWidth> wb_2;
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kWidth; ++j) wb_1[j] = LoadBlock(input + j * kAesBlockSize);
+  AesCeEncryptWide<kWidth>(round_keys, wb_1.data());
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kWidth; ++j) wb_2[j] = veorq_u8(wb_1[j], tweaks[j]);
+  AesCeEncryptWide<kWidth>(round_keys, wb_2.data());
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    StoreBlock(input + j * kAesBlockSize, veorq_u8(wb_2[j], wb_1[j]));
+  }
+}
+
+// MMO on kWidth independent blocks inplace, see AesniMmoWide
+template <std::size_t kWidth>
+inline void MmoWide(const RoundKeys& round_keys, uint8x16_t* input) {
+  std::array<uint8x16_t, kWidth> wb;
+  std::copy(input, input + kWidth, wb.data());
+  AesCeEncryptWide<kWidth>(round_keys, wb.data());
+  // store \pi(x) ^ x
+  for (std::size_t j = 0; j < kWidth; ++j) input[j] = veorq_u8(wb[j], input[j]);
+}
+
+// Number of blocks that are hashed together by TmmoGates, see AesniTmmoGates
+constexpr std::size_t kTmmoGatesWidth{12};
+
+template <std::size_t kBlocksPerGate, std::size_t kTweaksPerGate>
+void TmmoGates(const void* round_keys_input, void* input, __uint128_t tweak,
+               std::size_t number_of_gates) {
+  static_assert(kBlocksPerGate % kTweaksPerGate == 0 && kTmmoGatesWidth % kBlocksPerGate == 0);
+  constexpr std::size_t kBlocksPerTweak{kBlocksPerGate / kTweaksPerGate};
+  constexpr std::size_t kGatesPerBatch{kTmmoGatesWidth / kBlocksPerGate};
+  const RoundKeys round_keys{LoadRoundKeys(round_keys_input)};
+  std::array<uint8x16_t, kTmmoGatesWidth> tweaks;
+  auto input_pointer = reinterpret_cast<std::uint8_t*>(input);
+
+  // tweak of the first block of the current gate
+  tweak *= kTweaksPerGate;
+  tweak -= kTweaksPerGate;
+  for (std::size_t gate_i = 0; gate_i < number_of_gates; gate_i += kGatesPerBatch) {
+    const std::size_t batch_size{std::min(kGatesPerBatch, number_of_gates - gate_i)};
+    for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+      for (std::size_t j = 0; j < kBlocksPerGate; ++j) {
+        tweaks[batch_i * kBlocksPerGate + j] = TweakBlock(tweak + j / kBlocksPerTweak);
+      }
+      tweak += kTweaksPerGate;
+    }
+    std::uint8_t* blocks{input_pointer + gate_i * kBlocksPerGate * kAesBlockSize};
+    if (batch_size == kGatesPerBatch) {
+      TmmoWide<kTmmoGatesWidth>(round_keys, blocks, tweaks.data());
+    } else {
+      // the remaining gates
+      [&]<std::size_t... kBatchSizes>(std::index_sequence<kBatchSizes...>) {
+        ((batch_size == kBatchSizes + 1
+              ? TmmoWide<(kBatchSizes + 1) * kBlocksPerGate>(round_keys, blocks, tweaks.data())
+              : void()),
+         ...);
+      }(std::make_index_sequence<kGatesPerBatch - 1>{});
+    }
+  }
+}
+
+// doubling in GF(2^128) exactly as by AesniMixKeys, which shifts the two 64-bit halves of the
+// block separately
+inline uint64x2_t MixKeysDouble(uint64x2_t x) {
+  const bool msb{(vgetq_lane_u64(x, 1) >> 63) != 0};
+  x = vshlq_n_u64(x, 1);
+  if (msb) x = veorq_u64(x, vcombine_u64(vcreate_u64(0x87), vcreate_u64(0)));
+  return x;
+}
+
+inline uint8x16_t MixKeys(uint8x16_t key_a, uint8x16_t key_b) {
+  uint64x2_t mixed_keys{MixKeysDouble(vreinterpretq_u64_u8(key_a))};
+  mixed_keys = veorq_u64(mixed_keys, vreinterpretq_u64_u8(key_b));
+  return vreinterpretq_u8_u64(MixKeysDouble(mixed_keys));
+}
+
+// Number of DKC invocations that are kept in flight together by AesniBmrDkcBatch
+constexpr std::size_t kBmrDkcWidth{8};
+
+}  // namespace
+
+void AesniKeyExpansion128(void* round_keys_input) {
+  auto round_keys = reinterpret_cast<std::uint8_t*>(round_keys_input);
+  constexpr std::array<std::uint32_t, 10> kRoundConstants{0x01, 0x02, 0x04, 0x08, 0x10,
+                                                          0x20, 0x40, 0x80, 0x1b, 0x36};
+  std::array<std::uint32_t, 4 * kAesNumRoundKeys128> words;
+  std::copy_n(round_keys, kAesKeySize128, reinterpret_cast<std::uint8_t*>(words.data()));
+  for (std::size_t i = 4; i < words.size(); i += 4) {
+    // RotWord, since the words are little endian
+    std::uint32_t word{(words[i - 1] >> 8) | (words[i - 1] << 24)};
+    // SubWord by AESE with a zero key on the word broadcast to all columns, which makes ShiftRows
+    // the identity
+    word = vgetq_lane_u32(
+        vreinterpretq_u32_u8(vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0))),
+        0);
+    words[i] = words[i - 4] ^ word ^ kRoundConstants[i / 4 - 1];
+    for (std::size_t j = 1; j < 4; ++j) words[i + j] = words[i + j - 4] ^ words[i + j - 1];
+  }
+  std::copy_n(reinterpret_cast<const std::uint8_t*>(words.data()), kAesRoundKeysSize128,
+              round_keys);
+}
+
+void AesniCtrStreamBlocks128(const void* round_keys, std::uint64_t* counter, void* output,
+                             std::size_t number_of_blocks) {
+  CtrStreamBlocks(round_keys, counter, output, number_of_blocks);
+}
+
+void AesniCtrStreamBlocks128Unaligned(const void* round_keys, std::uint64_t* counter,
+                                      void* output, std::size_t number_of_blocks) {
+  // NEON loads and stores do not require alignment
+  CtrStreamBlocks(round_keys, counter, output, number_of_blocks);
+}
+
+void AesniCtrStreamSingleBlock128Unaligned(const void* round_keys, std::uint64_t* counter,
+                                           void* output) {
+  CtrStreamBlocks(round_keys, counter, output, 1);
+}
+
+void AesniTmmoBatch4(const void* round_keys, void* input, __uint128_t tweak) {
+  std::array<uint8x16_t, 4> tweaks;
+  tweaks.fill(TweakBlock(tweak));
+  TmmoWide<4>(LoadRoundKeys(round_keys), reinterpret_cast<std::uint8_t*>(input), tweaks.data());
+}
+
+void AesniTmmoBatch6(const void* round_keys, void* input, __uint128_t tweak) {
+  std::array<uint8x16_t, 6> tweaks;
+  // each two blocks share one of the tweaks 3i - 3, 3i - 2 and 3i - 1
+  tweak *= 3;
+  tweak -= 3;
+  for (std::size_t j = 0; j < 6; ++j) tweaks[j] = TweakBlock(tweak + j / 2);
+  TmmoWide<6>(LoadRoundKeys(round_keys), reinterpret_cast<std::uint8_t*>(input), tweaks.data());
+}
+
+void AesniTmmoBatch3(const void* round_keys, void* input, __uint128_t tweak) {
+  std::array<uint8x16_t, 3> tweaks;
+  // the blocks use the tweaks 3i - 3, 3i - 2 and 3i - 1
+  tweak *= 3;
+  tweak -= 3;
+  for (std::size_t j = 0; j < 3; ++j) tweaks[j] = TweakBlock(tweak + j);
+  TmmoWide<3>(LoadRoundKeys(round_keys), reinterpret_cast<std::uint8_t*>(input), tweaks.data());
+}
+
+void AesniTmmoGatesBatch6(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  TmmoGates<6, 3>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniTmmoGatesBatch3(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  TmmoGates<3, 3>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniTmmoGatesBatch4(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  TmmoGates<4, 2>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniTmmoGatesBatch2(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  TmmoGates<2, 2>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniMmoSingle(const void* round_keys, void* input) {
+  uint8x16_t block{LoadBlock(input)};
+  MmoWide<1>(LoadRoundKeys(round_keys), &block);
+  StoreBlock(input, block);
+}
+
+void AesniMmoBatch4(const void* round_keys, void* input) {
+  auto input_pointer = reinterpret_cast<std::uint8_t*>(input);
+  std::array<uint8x16_t, 4> blocks;
+  for (std::size_t j = 0; j < 4; ++j) blocks[j] = LoadBlock(input_pointer + j * kAesBlockSize);
+  MmoWide<4>(LoadRoundKeys(round_keys), blocks.data());
+  for (std::size_t j = 0; j < 4; ++j) StoreBlock(input_pointer + j * kAesBlockSize, blocks[j]);
+}
+
+// hashes the blocks in batches of the CTR stream width
+void AesniMmoBlocks(const void* round_keys_input, void* input, std::size_t number_of_blocks) {
+  const RoundKeys round_keys{LoadRoundKeys(round_keys_input)};
+  auto input_pointer = reinterpret_cast<std::uint8_t*>(input);
+  std::array<uint8x16_t, kCtrWidth> blocks;
+  for (std::size_t i = 0; i < number_of_blocks; i += kCtrWidth) {
+    const std::size_t width{std::min(kCtrWidth, number_of_blocks - i)};
+    for (std::size_t j = 0; j < width; ++j) {
+      blocks[j] = LoadBlock(input_pointer + (i + j) * kAesBlockSize);
+    }
+    if (width == kCtrWidth) {
+      MmoWide<kCtrWidth>(round_keys, blocks.data());
+    } else {
+      for (std::size_t j = 0; j < width; ++j) MmoWide<1>(round_keys, blocks.data() + j);
+    }
+    for (std::size_t j = 0; j < width; ++j) {
+      StoreBlock(input_pointer + (i + j) * kAesBlockSize, blocks[j]);
+    }
+  }
+}
+
+void AesniBmrDkc(const void* round_keys, const void* key_a, const void* key_b,
+                 std::uint64_t gate_id, std::size_t number_of_parties, void* output) {
+  AesniBmrDkcBatch(round_keys, key_a, key_b, gate_id, 1, number_of_parties, output,
+                   number_of_parties);
+}
+
+void AesniBmrDkcBatch(const void* round_keys_input, const void* keys_a, const void* keys_b,
+                      std::uint64_t gate_id, std::size_t number_of_keys,
+                      std::size_t number_of_parties, void* output_input_pointer,
+                      std::size_t output_stride) {
+  const RoundKeys round_keys{LoadRoundKeys(round_keys_input)};
+  auto keys_a_pointer = reinterpret_cast<const std::uint8_t*>(keys_a);
+  auto keys_b_pointer = reinterpret_cast<const std::uint8_t*>(keys_b);
+  auto out = reinterpret_cast<std::uint8_t*>(output_input_pointer);
+  auto mix_keys = [&](std::size_t key_id) {
+    return MixKeys(LoadBlock(keys_a_pointer + key_id * kAesBlockSize),
+                   LoadBlock(keys_b_pointer + key_id * kAesBlockSize));
+  };
+
+  // the invocations are enumerated key-major, i.e., i = key_id * number_of_parties + party_id
+  const std::size_t number_of_invocations{number_of_keys * number_of_parties};
+  std::array<uint8x16_t, kBmrDkcWidth> wb;
+  std::size_t key_id{0}, party_id{0};
+  uint8x16_t mixed_keys{vdupq_n_u8(0)};
+  if (number_of_keys > 0) mixed_keys = mix_keys(0);
+  for (std::size_t i = 0; i < number_of_invocations; i += kBmrDkcWidth) {
+    const std::size_t width{std::min(kBmrDkcWidth, number_of_invocations - i)};
+
+    // prepare the DKC inputs K = 4A + 2B + T
+    std::size_t batch_key_id{key_id}, batch_party_id{party_id};
+    for (std::size_t j = 0; j < width; ++j) {
+      wb[j] = veorq_u8(mixed_keys, MakeBlock(gate_id, party_id));
+      if (++party_id == number_of_parties && ++key_id < number_of_keys) {
+        party_id = 0;
+        mixed_keys = mix_keys(key_id);
+      }
+    }
+    // the unused blocks of the last batch are encrypted but ignored
+    MmoWide<kBmrDkcWidth>(round_keys, wb.data());
+
+    // xor the outputs in the order of the invocations since the outputs may overlap
+    for (std::size_t j = 0; j < width; ++j) {
+      std::uint8_t* block{out + (batch_key_id * output_stride + batch_party_id) * kAesBlockSize};
+      StoreBlock(block, veorq_u8(LoadBlock(block), wb[j]));
+      if (++batch_party_id == number_of_parties) {
+        batch_party_id = 0;
+        ++batch_key_id;
+      }
+    }
+  }
+}
@@ -24,6 +24,7 @@
 #include <immintrin.h>
 #include <algorithm>
 #include <array>
+#include <utility>
 
 template <int round_constant>
 static __m128i AesKeyExpand(__m128i xmm1) {
@@ -89,6 +90,31 @@ void AesniKeyExpansion128(void* round_keys_input) {
   // movdqa 0xa0[rdi], xmm1
 }
 
+#if defined(MOTION_AVX512_VAES)
+// Number of blocks that are encrypted together by the VAES path of the CTR streams
+constexpr std::size_t kCtrVaesWidth{16};
+
+// encrypt the kCtrVaesWidth counters starting at counter with four blocks per instruction
+static inline void AesniCtrVaes(const std::array<__m512i, kAesNumRoundKeys128>& wide_round_keys,
+                                std::uint64_t counter, __m128i* output) {
+  alignas(64) std::array<__m512i, kCtrVaesWidth / 4> wb;
+  for (std::size_t j = 0; j < kCtrVaesWidth / 4; ++j) {
+    const std::uint64_t c{counter + 4 * j};
+    wb[j] = _mm512_set_epi64(0, c + 3, 0, c + 2, 0, c + 1, 0, c);
+    wb[j] = _mm512_xor_si512(wb[j], wide_round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kCtrVaesWidth / 4; ++j) {
+      wb[j] = _mm512_aesenc_epi128(wb[j], wide_round_keys[r]);
+    }
+  }
+  for (std::size_t j = 0; j < kCtrVaesWidth / 4; ++j) {
+    wb[j] = _mm512_aesenclast_epi128(wb[j], wide_round_keys[kAesNumRoundKeys128 - 1]);
+    _mm512_storeu_si512(output + 4 * j, wb[j]);
+  }
+}
+#endif
+
 void AesniCtrStreamBlocks128(const void* round_keys_input, std::uint64_t* counter_input_pointer,
                              void* output_input_pointer, std::size_t number_of_blocks) {
   alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
@@ -106,10 +132,24 @@ void AesniCtrStreamBlocks128(const void* round_keys_input, std::uint64_t* counte
                 kAesNumRoundKeys128,
             round_keys.data());
 
+  std::size_t vaes_blocks{0};
+#if defined(MOTION_AVX512_VAES)
+  // encrypt batches of kCtrVaesWidth blocks with VAES first
+  alignas(64) std::array<__m512i, kAesNumRoundKeys128> wide_round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    wide_round_keys[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+  vaes_blocks = number_of_blocks - number_of_blocks % kCtrVaesWidth;
+  for (std::size_t i = 0; i < vaes_blocks; i += kCtrVaesWidth) {
+    AesniCtrVaes(wide_round_keys, counter, output + i);
+    counter += kCtrVaesWidth;
+  }
+#endif
+
   // do as many blocks as possible in 4er batches
   // since the aesenc instructions have a latency of 4
   auto batch_blocks = number_of_blocks & (~0b11);
-  for (size_t i = 0; i < batch_blocks; i += 4) {
+  for (size_t i = vaes_blocks; i < batch_blocks; i += 4) {
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_set_epi64x(0, counter + j);
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_xor_si128(wb[j], round_keys[0]);
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[1]);
@@ -167,10 +207,24 @@ void AesniCtrStreamBlocks128Unaligned(const void* round_keys_input,
                 kAesNumRoundKeys128,
             round_keys.data());
 
+  std::size_t vaes_blocks{0};
+#if defined(MOTION_AVX512_VAES)
+  // encrypt batches of kCtrVaesWidth blocks with VAES first
+  alignas(64) std::array<__m512i, kAesNumRoundKeys128> wide_round_keys;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    wide_round_keys[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+  vaes_blocks = number_of_blocks - number_of_blocks % kCtrVaesWidth;
+  for (std::size_t i = 0; i < vaes_blocks; i += kCtrVaesWidth) {
+    AesniCtrVaes(wide_round_keys, counter, output + i);
+    counter += kCtrVaesWidth;
+  }
+#endif
+
   // do as many blocks as possible in batches of 4
   // since the aesenc instructions have a latency of 4
   auto batch_blocks = number_of_blocks & (~0b11);
-  for (size_t i = 0; i < batch_blocks; i += 4) {
+  for (size_t i = vaes_blocks; i < batch_blocks; i += 4) {
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_set_epi64x(0, counter + j);
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_xor_si128(wb[j], round_keys[0]);
     for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[1]);
@@ -232,10 +286,142 @@ void AesniCtrStreamSingleBlock128Unaligned(const void* round_keys_input, std::ui
   _mm_storeu_si128(output_pointer, wb);
 }
 
+#if defined(MOTION_AVX512_VAES)
+// mask of the 64-bit lanes of vector j of a kWidth-block batch with four blocks per vector, s.t.
+// the blocks beyond kWidth in the last vector are neither loaded nor stored
+template <std::size_t kWidth>
+static inline __mmask8 VaesBlockMask(std::size_t j) {
+  constexpr std::size_t kTail{kWidth % 4};
+  if (kTail != 0 && j == kWidth / 4) return static_cast<__mmask8>((1u << (2 * kTail)) - 1);
+  return 0xFF;
+}
+#endif
+
+// TMMO on kWidth independent blocks, each with its own tweak, s.t. kWidth blocks are in flight in
+// the AES pipeline.  With VAES, four blocks are processed by each instruction.
+template <std::size_t kWidth>
+static inline void AesniTmmoWide(const std::array<__m128i, kAesNumRoundKeys128>& round_keys,
+                                 __m128i* input, const __m128i* tweaks) {
+#if defined(MOTION_AVX512_VAES)
+  constexpr std::size_t kNumberOfVectors{(kWidth + 3) / 4};
+  alignas(64) std::array<__m512i, kAesNumRoundKeys128> wide_round_keys;
+  alignas(64) std::array<__m512i, kNumberOfVectors> wb_1;
+  alignas(64) std::array<__m512i, kNumberOfVectors> wb_2;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    wide_round_keys[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    wb_1[j] = _mm512_xor_si512(_mm512_maskz_loadu_epi64(VaesBlockMask<kWidth>(j), input + 4 * j),
+                               wide_round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+      wb_1[j] = _mm512_aesenc_epi128(wb_1[j], wide_round_keys[r]);
+    }
+  }
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    wb_1[j] = _mm512_aesenclast_epi128(wb_1[j], wide_round_keys[kAesNumRoundKeys128 - 1]);
+  }
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    wb_2[j] = _mm512_xor_si512(
+        wb_1[j], _mm512_maskz_loadu_epi64(VaesBlockMask<kWidth>(j), tweaks + 4 * j));
+    wb_2[j] = _mm512_xor_si512(wb_2[j], wide_round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+      wb_2[j] = _mm512_aesenc_epi128(wb_2[j], wide_round_keys[r]);
+    }
+  }
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    wb_2[j] = _mm512_aesenclast_epi128(wb_2[j], wide_round_keys[kAesNumRoundKeys128 - 1]);
+  }
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    _mm512_mask_storeu_epi64(input + 4 * j, VaesBlockMask<kWidth>(j),
+                             _mm512_xor_si512(wb_2[j], wb_1[j]));
+  }
+#else
+  alignas(16) std::array<__m128i, kWidth> wb_1;
+  alignas(16) std::array<__m128i, kWidth> wb_2;
+
+  // compute wb_1 <- \pi(x)
+  for (std::size_t j = 0; j < kWidth; ++j) wb_1[j] = _mm_xor_si128(input[j], round_keys[0]);
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kWidth; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[kAesNumRoundKeys128 - 1]);
+  }
+
+  // compute wb_2 <- \pi(\pi(x) ^ i)
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    wb_2[j] = _mm_xor_si128(_mm_xor_si128(wb_1[j], tweaks[j]), round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kWidth; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[kAesNumRoundKeys128 - 1]);
+  }
+
+  // store \pi(\pi(x) ^ i) ^ \pi(x)
+  for (std::size_t j = 0; j < kWidth; ++j) input[j] = _mm_xor_si128(wb_2[j], wb_1[j]);
+#endif
+}
+
+// MMO on kWidth independent blocks inplace, s.t. kWidth blocks are in flight in the AES pipeline.
+// With VAES, four blocks are processed by each instruction.
+template <std::size_t kWidth>
+static inline void AesniMmoWide(const __m128i* round_keys, __m128i* input) {
+#if defined(MOTION_AVX512_VAES)
+  constexpr std::size_t kNumberOfVectors{(kWidth + 3) / 4};
+  alignas(64) std::array<__m512i, kAesNumRoundKeys128> wide_round_keys;
+  alignas(64) std::array<__m512i, kNumberOfVectors> x;
+  alignas(64) std::array<__m512i, kNumberOfVectors> wb;
+  for (std::size_t r = 0; r < kAesNumRoundKeys128; ++r) {
+    wide_round_keys[r] = _mm512_broadcast_i32x4(round_keys[r]);
+  }
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    x[j] = _mm512_maskz_loadu_epi64(VaesBlockMask<kWidth>(j), input + 4 * j);
+    wb[j] = _mm512_xor_si512(x[j], wide_round_keys[0]);
+  }
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+      wb[j] = _mm512_aesenc_epi128(wb[j], wide_round_keys[r]);
+    }
+  }
+  // store \pi(x) ^ x
+  for (std::size_t j = 0; j < kNumberOfVectors; ++j) {
+    wb[j] = _mm512_aesenclast_epi128(wb[j], wide_round_keys[kAesNumRoundKeys128 - 1]);
+    _mm512_mask_storeu_epi64(input + 4 * j, VaesBlockMask<kWidth>(j),
+                             _mm512_xor_si512(wb[j], x[j]));
+  }
+#else
+  alignas(16) std::array<__m128i, kWidth> wb;
+  for (std::size_t j = 0; j < kWidth; ++j) wb[j] = _mm_xor_si128(input[j], round_keys[0]);
+  for (std::size_t r = 1; r < kAesNumRoundKeys128 - 1; ++r) {
+    for (std::size_t j = 0; j < kWidth; ++j) wb[j] = _mm_aesenc_si128(wb[j], round_keys[r]);
+  }
+  // store \pi(x) ^ x
+  for (std::size_t j = 0; j < kWidth; ++j) {
+    wb[j] = _mm_aesenclast_si128(wb[j], round_keys[kAesNumRoundKeys128 - 1]);
+    input[j] = _mm_xor_si128(wb[j], input[j]);
+  }
+#endif
+}
+
+static inline __m128i AesniTweakBlock(__uint128_t tweak) {
+  return _mm_set_epi64x(static_cast<std::uint64_t>(tweak >> 64), static_cast<std::uint64_t>(tweak));
+}
+
 void AesniTmmoBatch4(const void* round_keys_input, void* input, __uint128_t tweak) {
   alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
-  alignas(16) std::array<__m128i, 4> wb_1;
-  alignas(16) std::array<__m128i, 4> wb_2;
+  alignas(64) std::array<__m128i, 4> tweaks;
 
   // copy the round keys onto the stack
   // -> compiler will put them into registers
@@ -243,44 +429,31 @@ void AesniTmmoBatch4(const void* round_keys_input, void* input, __uint128_t twea
             reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
                 kAesNumRoundKeys128,
             round_keys.data());
-  auto input_pointer = reinterpret_cast<__m128i*>(input);
-  auto tweak_pointer = reinterpret_cast<__m128i*>(&tweak);
+  tweaks.fill(AesniTweakBlock(tweak));
+  AesniTmmoWide<4>(round_keys, reinterpret_cast<__m128i*>(input), tweaks.data());
+}
 
-  // compute wb_1 <- \pi(x)
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_xor_si128(input_pointer[j], round_keys[0]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[1]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[2]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[3]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[4]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[5]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[6]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[7]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[8]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[9]);
-  for (std::size_t j = 0; j < 4; ++j) wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[10]);
+void AesniTmmoBatch6(const void* round_keys_input, void* input, __uint128_t tweak) {
+  alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
+  alignas(64) std::array<__m128i, 6> tweaks;
 
-  // compute wb_2 <- \pi(\pi(x) ^ i)
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_xor_si128(wb_1[j], *tweak_pointer);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_xor_si128(wb_2[j], round_keys[0]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[1]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[2]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[3]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[4]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[5]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[6]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[7]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[8]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[9]);
-  for (std::size_t j = 0; j < 4; ++j) wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[10]);
+  // copy the round keys onto the stack
+  // -> compiler will put them into registers
+  std::copy(reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)),
+            reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
+                kAesNumRoundKeys128,
+            round_keys.data());
 
-  // store \pi(\pi(x) ^ i) ^ \pi(x)
-  for (std::size_t j = 0; j < 4; ++j) input_pointer[j] = _mm_xor_si128(wb_2[j], wb_1[j]);
+  // each two blocks share one of the tweaks 3i - 3, 3i - 2 and 3i - 1
+  tweak *= 3;
+  tweak -= 3;
+  for (std::size_t j = 0; j < 6; ++j) tweaks[j] = AesniTweakBlock(tweak + j / 2);
+  AesniTmmoWide<6>(round_keys, reinterpret_cast<__m128i*>(input), tweaks.data());
 }
 
-void AesniTmmoBatch6(const void* round_keys_input, void* input, __uint128_t tweak) {
+void AesniTmmoBatch3(const void* round_keys_input, void* input, __uint128_t tweak) {
   alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
-  alignas(16) std::array<__m128i, 6> wb_1;
-  alignas(16) std::array<__m128i, 6> wb_2;
+  alignas(64) std::array<__m128i, 3> tweaks;
 
   // copy the round keys onto the stack
   // -> compiler will put them into registers
@@ -288,53 +461,30 @@ void AesniTmmoBatch6(const void* round_keys_input, void* input, __uint128_t twea
             reinterpret_cast<__m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)) +
                 kAesNumRoundKeys128,
             round_keys.data());
-  auto input_pointer = reinterpret_cast<__m128i*>(input);
-  auto tweak_pointer = reinterpret_cast<__m128i*>(&tweak);
-
-  // compute wb_1 <- \pi(x)
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_xor_si128(input_pointer[j], round_keys[0]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[1]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[2]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[3]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[4]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[5]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[6]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[7]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[8]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[9]);
-  for (std::size_t j = 0; j < 6; ++j) wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[10]);
 
-  // compute wb_2 <- \pi(\pi(x) ^ i)
+  // the blocks use the tweaks 3i - 3, 3i - 2 and 3i - 1
   tweak *= 3;
   tweak -= 3;
-  wb_2[0] = _mm_xor_si128(wb_1[0], *tweak_pointer);
-  wb_2[1] = _mm_xor_si128(wb_1[1], *tweak_pointer);
-  ++tweak;
-  wb_2[2] = _mm_xor_si128(wb_1[2], *tweak_pointer);
-  wb_2[3] = _mm_xor_si128(wb_1[3], *tweak_pointer);
-  ++tweak;
-  wb_2[4] = _mm_xor_si128(wb_1[4], *tweak_pointer);
-  wb_2[5] = _mm_xor_si128(wb_1[5], *tweak_pointer);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_xor_si128(wb_2[j], round_keys[0]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[1]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[2]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[3]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[4]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[5]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[6]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[7]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[8]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[9]);
-  for (std::size_t j = 0; j < 6; ++j) wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[10]);
-
-  // store \pi(\pi(x) ^ i) ^ \pi(x)
-  for (std::size_t j = 0; j < 6; ++j) input_pointer[j] = _mm_xor_si128(wb_2[j], wb_1[j]);
+  for (std::size_t j = 0; j < 3; ++j) tweaks[j] = AesniTweakBlock(tweak + j);
+  AesniTmmoWide<3>(round_keys, reinterpret_cast<__m128i*>(input), tweaks.data());
 }
 
-void AesniTmmoBatch3(const void* round_keys_input, void* input, __uint128_t tweak) {
+// Number of blocks that are hashed together by AesniTmmoGates, e.g., 2 gates for TMMO on 6 blocks
+// per gate and 4 gates for 3 blocks per gate
+constexpr std::size_t kTmmoGatesWidth{12};
+
+// TMMO on the kBlocksPerGate blocks of each of number_of_gates gates, where the blocks of gate g
+// use the tweaks kTweaksPerGate * (tweak + g - 1) + k for k < kTweaksPerGate, each for
+// kBlocksPerGate / kTweaksPerGate consecutive blocks.  The blocks of several gates are kept in
+// flight together.
+template <std::size_t kBlocksPerGate, std::size_t kTweaksPerGate>
+static void AesniTmmoGates(const void* round_keys_input, void* input, __uint128_t tweak,
+                           std::size_t number_of_gates) {
+  static_assert(kBlocksPerGate % kTweaksPerGate == 0 && kTmmoGatesWidth % kBlocksPerGate == 0);
+  constexpr std::size_t kBlocksPerTweak{kBlocksPerGate / kTweaksPerGate};
+  constexpr std::size_t kGatesPerBatch{kTmmoGatesWidth / kBlocksPerGate};
   alignas(16) std::array<__m128i, kAesNumRoundKeys128> round_keys;
-  alignas(16) std::array<__m128i, 3> wb_1;
-  alignas(16) std::array<__m128i, 3> wb_2;
+  alignas(64) std::array<__m128i, kTmmoGatesWidth> tweaks;
 
   // copy the round keys onto the stack
   // -> compiler will put them into registers
@@ -343,43 +493,51 @@ void AesniTmmoBatch3(const void* round_keys_input, void* input, __uint128_t twea
                 kAesNumRoundKeys128,
             round_keys.data());
   auto input_pointer = reinterpret_cast<__m128i*>(input);
-  auto tweak_pointer = reinterpret_cast<__m128i*>(&tweak);
 
-  // compute wb_1 <- \pi(x)
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_xor_si128(input_pointer[j], round_keys[0]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[1]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[2]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[3]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[4]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[5]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[6]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[7]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[8]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys[9]);
-  for (std::size_t j = 0; j < 3; ++j) wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys[10]);
+  // tweak of the first block of the current gate
+  tweak *= kTweaksPerGate;
+  tweak -= kTweaksPerGate;
+  for (std::size_t gate_i = 0; gate_i < number_of_gates; gate_i += kGatesPerBatch) {
+    const std::size_t batch_size{std::min(kGatesPerBatch, number_of_gates - gate_i)};
+    for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+      for (std::size_t j = 0; j < kBlocksPerGate; ++j) {
+        tweaks[batch_i * kBlocksPerGate + j] = AesniTweakBlock(tweak + j / kBlocksPerTweak);
+      }
+      tweak += kTweaksPerGate;
+    }
+    __m128i* blocks{input_pointer + gate_i * kBlocksPerGate};
+    if (batch_size == kGatesPerBatch) {
+      AesniTmmoWide<kTmmoGatesWidth>(round_keys, blocks, tweaks.data());
+    } else {
+      // the remaining gates
+      [&]<std::size_t... kBatchSizes>(std::index_sequence<kBatchSizes...>) {
+        ((batch_size == kBatchSizes + 1
+              ? AesniTmmoWide<(kBatchSizes + 1) * kBlocksPerGate>(round_keys, blocks, tweaks.data())
+              : void()),
+         ...);
+      }(std::make_index_sequence<kGatesPerBatch - 1>{});
+    }
+  }
+}
 
-  // compute wb_2 <- \pi(\pi(x) ^ i)
-  tweak *= 3;
-  tweak -= 3;
-  wb_2[0] = _mm_xor_si128(wb_1[0], *tweak_pointer);
-  ++tweak;
-  wb_2[1] = _mm_xor_si128(wb_1[1], *tweak_pointer);
-  ++tweak;
-  wb_2[2] = _mm_xor_si128(wb_1[2], *tweak_pointer);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_xor_si128(wb_2[j], round_keys[0]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[1]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[2]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[3]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[4]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[5]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[6]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[7]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[8]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenc_si128(wb_2[j], round_keys[9]);
-  for (std::size_t j = 0; j < 3; ++j) wb_2[j] = _mm_aesenclast_si128(wb_2[j], round_keys[10]);
+void AesniTmmoGatesBatch6(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  AesniTmmoGates<6, 3>(round_keys, input, tweak, number_of_gates);
+}
 
-  // store \pi(\pi(x) ^ i) ^ \pi(x)
-  for (std::size_t j = 0; j < 3; ++j) input_pointer[j] = _mm_xor_si128(wb_2[j], wb_1[j]);
+void AesniTmmoGatesBatch3(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  AesniTmmoGates<3, 3>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniTmmoGatesBatch4(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  AesniTmmoGates<4, 2>(round_keys, input, tweak, number_of_gates);
+}
+
+void AesniTmmoGatesBatch2(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates) {
+  AesniTmmoGates<2, 2>(round_keys, input, tweak, number_of_gates);
 }
 
 void AesniMmoSingle(const void* round_keys_input, void* input) {
@@ -407,6 +565,31 @@ void AesniMmoSingle(const void* round_keys_input, void* input) {
   *input_pointer = _mm_xor_si128(wb_1, input_block);
 }
 
+void AesniMmoBatch4(const void* round_keys_input, void* input) {
+  AesniMmoWide<4>(
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize)),
+      reinterpret_cast<__m128i*>(__builtin_assume_aligned(input, kAesBlockSize)));
+}
+
+// Number of blocks that are hashed together by AesniMmoBlocks
+#if defined(MOTION_AVX512_VAES)
+constexpr std::size_t kMmoBlocksWidth{16};
+#else
+constexpr std::size_t kMmoBlocksWidth{8};
+#endif
+
+void AesniMmoBlocks(const void* round_keys_input, void* input, std::size_t number_of_blocks) {
+  auto round_keys =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize));
+  auto blocks = reinterpret_cast<__m128i*>(__builtin_assume_aligned(input, kAesBlockSize));
+  std::size_t i{0};
+  for (; i + kMmoBlocksWidth <= number_of_blocks; i += kMmoBlocksWidth) {
+    AesniMmoWide<kMmoBlocksWidth>(round_keys, blocks + i);
+  }
+  for (; i + 4 <= number_of_blocks; i += 4) AesniMmoWide<4>(round_keys, blocks + i);
+  for (; i < number_of_blocks; ++i) AesniMmoWide<1>(round_keys, blocks + i);
+}
+
 static __m128i AesniMixKeys(__m128i key_a, __m128i key_b) {
   const __m128i modulus = _mm_set_epi32(0, 0, 0, 0x87);
   const __m128i msb_mask = _mm_set_epi32(0x80000000, 0, 0, 0);
@@ -425,35 +608,57 @@ static __m128i AesniMixKeys(__m128i key_a, __m128i key_b) {
   return mixed_keys;
 }
 
-static __m128i AesniXorEncrypt(const __m128i* round_keys, __m128i in) {
-  __m128i wb;
-  wb = _mm_xor_si128(in, round_keys[0]);
-  wb = _mm_aesenc_si128(wb, round_keys[1]);
-  wb = _mm_aesenc_si128(wb, round_keys[2]);
-  wb = _mm_aesenc_si128(wb, round_keys[3]);
-  wb = _mm_aesenc_si128(wb, round_keys[4]);
-  wb = _mm_aesenc_si128(wb, round_keys[5]);
-  wb = _mm_aesenc_si128(wb, round_keys[6]);
-  wb = _mm_aesenc_si128(wb, round_keys[7]);
-  wb = _mm_aesenc_si128(wb, round_keys[8]);
-  wb = _mm_aesenc_si128(wb, round_keys[9]);
-  wb = _mm_aesenclast_si128(wb, round_keys[10]);
-  return wb ^ in;
-}
-
 void AesniBmrDkc(const void* round_keys_input, const void* key_a, const void* key_b,
                  std::uint64_t gate_id, std::size_t number_of_parties, void* output_input_pointer) {
-  auto key_a_pointer =
-      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(key_a, kAesBlockSize));
-  auto key_b_pointer =
-      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(key_b, kAesBlockSize));
+  // a single key pair keeps the DKC invocations of all parties in flight together
+  AesniBmrDkcBatch(round_keys_input, key_a, key_b, gate_id, 1, number_of_parties,
+                   output_input_pointer, number_of_parties);
+}
+
+// Number of DKC invocations that are kept in flight together by AesniBmrDkcBatch
+constexpr std::size_t kBmrDkcWidth{8};
+
+void AesniBmrDkcBatch(const void* round_keys_input, const void* keys_a, const void* keys_b,
+                      std::uint64_t gate_id, std::size_t number_of_keys,
+                      std::size_t number_of_parties, void* output_input_pointer,
+                      std::size_t output_stride) {
+  auto keys_a_pointer =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(keys_a, kAesBlockSize));
+  auto keys_b_pointer =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(keys_b, kAesBlockSize));
   auto round_keys =
       reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_input, kAesBlockSize));
   auto out =
       reinterpret_cast<__m128i*>(__builtin_assume_aligned(output_input_pointer, kAesBlockSize));
-  __m128i mixed_keys = AesniMixKeys(*key_a_pointer, *key_b_pointer);
-  for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
-    __m128i tmp = mixed_keys ^ _mm_set_epi64x(gate_id, party_id);
-    out[party_id] ^= AesniXorEncrypt(round_keys, tmp);
+
+  // the invocations are enumerated key-major, i.e., i = key_id * number_of_parties + party_id
+  const std::size_t number_of_invocations{number_of_keys * number_of_parties};
+  alignas(64) std::array<__m128i, kBmrDkcWidth> wb;
+  std::size_t key_id{0}, party_id{0};
+  __m128i mixed_keys{};
+  if (number_of_keys > 0) mixed_keys = AesniMixKeys(keys_a_pointer[0], keys_b_pointer[0]);
+  for (std::size_t i = 0; i < number_of_invocations; i += kBmrDkcWidth) {
+    const std::size_t width{std::min(kBmrDkcWidth, number_of_invocations - i)};
+
+    // prepare the DKC inputs K = 4A + 2B + T
+    std::size_t batch_key_id{key_id}, batch_party_id{party_id};
+    for (std::size_t j = 0; j < width; ++j) {
+      wb[j] = mixed_keys ^ _mm_set_epi64x(gate_id, party_id);
+      if (++party_id == number_of_parties && ++key_id < number_of_keys) {
+        party_id = 0;
+        mixed_keys = AesniMixKeys(keys_a_pointer[key_id], keys_b_pointer[key_id]);
+      }
+    }
+    // the unused blocks of the last batch are encrypted but ignored
+    AesniMmoWide<kBmrDkcWidth>(round_keys, wb.data());
+
+    // xor the outputs in the order of the invocations since the outputs may overlap
+    for (std::size_t j = 0; j < width; ++j) {
+      out[batch_key_id * output_stride + batch_party_id] ^= wb[j];
+      if (++batch_party_id == number_of_parties) {
+        batch_party_id = 0;
+        ++batch_key_id;
+      }
+    }
   }
 }
@@ -25,6 +25,9 @@
 #include <cstddef>
 #include <cstdint>
 
+// The functions are implemented with AES-NI in aesni_primitives.cpp and with the ARMv8
+// Cryptography Extensions in aes_ce_primitives.cpp on AArch64, both computing the same outputs.
+
 constexpr std::size_t kAesKeySize128 = 16;
 constexpr std::size_t kAesBlockSize = 16;
 constexpr std::size_t kAesRoundKeysSize128 = 176;
@@ -35,7 +38,7 @@ constexpr std::size_t kAesNumRoundKeys128 = 11;
 // * round_keys is 16B aligned
 void AesniKeyExpansion128(void* round_keys);
 
-// generate number_of_blocks of random bytes using AES in counter mode
+// generate number_of_blocks of random bytes using AES in counter mode, uses VAES if enabled
 // * round_keys and output are 16B aligned
 void AesniCtrStreamBlocks128(const void* round_keys, std::uint64_t* counter, void* output,
                              std::size_t number_of_blocks);
@@ -55,6 +58,8 @@ void AesniCtrStreamSingleBlock128Unaligned(const void* round_keys, std::uint64_t
 //
 // TMMO^\pi(x, i) = \pi(\pi(x) ^ i) ^ \pi(x)
 //
+// Uses VAES if enabled.
+//
 // * round_keys and output are 16B aligned
 void AesniTmmoBatch4(const void* round_keys, void* input, __uint128_t tweak);
 
@@ -63,6 +68,8 @@ void AesniTmmoBatch4(const void* round_keys, void* input, __uint128_t tweak);
 //
 // TMMO^\pi(x, i) = \pi(\pi(x) ^ i) ^ \pi(x)
 //
+// Uses VAES if enabled.
+//
 // * round_keys and output are 16B-bit aligned
 // TODO tests
 void AesniTmmoBatch6(const void* round_keys, void* input, __uint128_t tweak);
@@ -72,10 +79,43 @@ void AesniTmmoBatch6(const void* round_keys, void* input, __uint128_t tweak);
 //
 // TMMO^\pi(x, i) = \pi(\pi(x) ^ i) ^ \pi(x)
 //
+// Uses VAES if enabled.
+//
 // * round_keys and output are 16B-bit aligned
 // TODO tests
 void AesniTmmoBatch3(const void* round_keys, void* input, __uint128_t tweak);
 
+// Compute the fixed-key contruction TMMO^\pi from Guo et al.
+// (https://eprint.iacr.org/2019/074) on the six input blocks of each of number_of_gates gates
+// inplace.  Gate g is hashed as by AesniTmmoBatch6 with tweak + g, but up to 16 blocks of
+// consecutive gates are processed together to fill the AES pipeline.  Uses VAES if enabled.
+//
+// * round_keys and output are 16B aligned
+void AesniTmmoGatesBatch6(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates);
+
+// Same as AesniTmmoGatesBatch6, but on the three input blocks of each gate as by AesniTmmoBatch3.
+//
+// * round_keys and output are 16B aligned
+void AesniTmmoGatesBatch3(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates);
+
+// Compute the fixed-key contruction TMMO^\pi from Guo et al.
+// (https://eprint.iacr.org/2019/074) on the four input blocks of each of number_of_gates gates
+// inplace for half-gates garbling.  The first two blocks of gate g use the tweak
+// 2 * (tweak + g) - 2 and the last two blocks the tweak 2 * (tweak + g) - 1.
+//
+// * round_keys and output are 16B aligned
+void AesniTmmoGatesBatch4(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates);
+
+// Same as AesniTmmoGatesBatch4, but on the two input blocks of each gate, which use the tweaks
+// 2 * (tweak + g) - 2 and 2 * (tweak + g) - 1, respectively.
+//
+// * round_keys and output are 16B aligned
+void AesniTmmoGatesBatch2(const void* round_keys, void* input, __uint128_t tweak,
+                          std::size_t number_of_gates);
+
 // Compute the fixed-key contruction MMO^\pi from Guo et al.
 // (https://eprint.iacr.org/2019/074).
 //
@@ -84,6 +124,22 @@ void AesniTmmoBatch3(const void* round_keys, void* input, __uint128_t tweak);
 // * round_keys are 16B aligned
 void AesniMmoSingle(const void* round_keys, void* input);
 
+// Compute the fixed-key contruction MMO^\pi from Guo et al.
+// (https://eprint.iacr.org/2019/074) on four input blocks inplace.
+//
+// MMO^\pi(x) = \pi(x) ^ x
+//
+// Uses VAES if enabled.
+//
+// * round_keys and input are 16B aligned
+void AesniMmoBatch4(const void* round_keys, void* input);
+
+// Compute MMO^\pi as by AesniMmoBatch4 on number_of_blocks input blocks inplace, where up to 16
+// blocks are kept in flight together in the AES pipeline.  Uses VAES if enabled.
+//
+// * round_keys and input are 16B aligned
+void AesniMmoBlocks(const void* round_keys, void* input, std::size_t number_of_blocks);
+
 // Compute the dual-key cipher A2/D1 by Bellare et al.
 // (https://eprint.iacr.org/2013/426).
 //
@@ -94,6 +150,17 @@ void AesniMmoSingle(const void* round_keys, void* input);
 // - K = 4A + 2B + T and with multiplication in GF(2^128)
 // - T = gate_id || party_id
 // - `party_id` ranges from 0 to number_of_parties - 1
-// The output is xored into `output`.
+// The output is xored into `output`.  The invocations are processed together as by
+// AesniBmrDkcBatch.
 void AesniBmrDkc(const void* round_keys, const void* key_a, const void* key_b,
                  std::uint64_t gate_id, std::size_t number_of_parties, void* output);
+
+// Computes AesniBmrDkc for `number_of_keys` pairs of keys (keys_a[k], keys_b[k]) with the same
+// gate_id, where the outputs for the k-th pair are xored into output + k * output_stride blocks.
+// The invocations for all pairs and parties are kept in flight together in the AES pipeline,
+// using VAES if available.  With output_stride = 0, all outputs are xored into the same blocks.
+//
+// * round_keys, keys_a, keys_b and output are 16B aligned
+void AesniBmrDkcBatch(const void* round_keys, const void* keys_a, const void* keys_b,
+                      std::uint64_t gate_id, std::size_t number_of_keys,
+                      std::size_t number_of_parties, void* output, std::size_t output_stride);
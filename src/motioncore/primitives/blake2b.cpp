@@ -24,6 +24,11 @@
 
 #include "blake2b.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
 namespace encrypto::motion {
 Blake2bCtx NewBlakeCtx() {
   return Blake2bCtx(EVP_MD_CTX_new(), [](EVP_MD_CTX* context) { EVP_MD_CTX_free(context); });
@@ -62,4 +67,151 @@ void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::s
              Blake2bCtx& b) {
   Blake2b(message, digest, length, b.get());
 }
+
+namespace {
+
+// fill one SIMD register with the words of all lanes
+#if defined(MOTION_AVX512)
+constexpr std::size_t kBlake2bLanes{8};
+#elif defined(MOTION_AVX2)
+constexpr std::size_t kBlake2bLanes{4};
+#else
+constexpr std::size_t kBlake2bLanes{2};
+#endif
+
+// one 64-bit word of each lane, which the compiler maps to SIMD registers
+using Blake2bWords =
+    std::uint64_t __attribute__((vector_size(kBlake2bLanes * sizeof(std::uint64_t))));
+
+constexpr std::size_t kBlake2bBlockSize{128};
+constexpr std::size_t kBlake2bDigestSize{64};
+constexpr std::size_t kBlake2bRounds{12};
+
+constexpr std::array<std::uint64_t, 8> kBlake2bIv{
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+constexpr std::array<std::array<std::uint8_t, 16>, 10> kBlake2bSigma{{
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+}};
+
+template <int kBits>
+inline Blake2bWords RotateRight(Blake2bWords x) {
+  return (x >> kBits) | (x << (64 - kBits));
+}
+
+inline void Blake2bMix(std::array<Blake2bWords, 16>& v, std::size_t a, std::size_t b,
+                       std::size_t c, std::size_t d, const Blake2bWords& x,
+                       const Blake2bWords& y) {
+  v[a] += v[b] + x;
+  v[d] = RotateRight<32>(v[d] ^ v[a]);
+  v[c] += v[d];
+  v[b] = RotateRight<24>(v[b] ^ v[c]);
+  v[a] += v[b] + y;
+  v[d] = RotateRight<16>(v[d] ^ v[a]);
+  v[c] += v[d];
+  v[b] = RotateRight<63>(v[b] ^ v[c]);
+}
+
+// the compression function F of RFC 7693 on one block of each lane, where all lanes have the same
+// message length and hence the same counter
+void Blake2bCompress(std::array<Blake2bWords, 8>& h, const std::array<Blake2bWords, 16>& m,
+                     std::uint64_t counter, bool last) {
+  std::array<Blake2bWords, 16> v;
+  for (std::size_t i = 0; i < 8; ++i) {
+    v[i] = h[i];
+    v[i + 8] = Blake2bWords{} + kBlake2bIv[i];
+  }
+  v[12] ^= counter;
+  if (last) v[14] = ~v[14];
+  for (std::size_t r = 0; r < kBlake2bRounds; ++r) {
+    const auto& s{kBlake2bSigma[r % kBlake2bSigma.size()]};
+    Blake2bMix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+    Blake2bMix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+    Blake2bMix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+    Blake2bMix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+    Blake2bMix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+    Blake2bMix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    Blake2bMix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+    Blake2bMix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+  }
+  for (std::size_t i = 0; i < 8; ++i) h[i] ^= v[i] ^ v[i + 8];
+}
+
+// Blake2b-512 without key of the messages of up to kBlake2bLanes lanes, where the digests of the
+// unused lanes are nullptr
+void Blake2bLanes(const std::array<const std::uint8_t*, kBlake2bLanes>& messages,
+                  std::size_t length, const std::array<std::uint8_t*, kBlake2bLanes>& digests) {
+  std::array<Blake2bWords, 8> h;
+  for (std::size_t i = 0; i < 8; ++i) h[i] = Blake2bWords{} + kBlake2bIv[i];
+  // parameter block: digest length 64, no key, fanout and depth 1
+  h[0] ^= 0x01010000 | kBlake2bDigestSize;
+
+  std::array<Blake2bWords, 16> m{};
+  std::array<std::uint8_t, kBlake2bBlockSize> padded_block;
+  std::size_t offset{0};
+  do {
+    const std::size_t block_size{std::min(kBlake2bBlockSize, length - offset)};
+    const bool last{offset + block_size == length};
+    for (std::size_t lane = 0; lane < kBlake2bLanes; ++lane) {
+      if (digests[lane] == nullptr) continue;
+      const std::uint8_t* block{messages[lane] + offset};
+      if (block_size < kBlake2bBlockSize) {
+        // the last block is padded with zeros
+        padded_block.fill(0);
+        std::copy_n(block, block_size, padded_block.begin());
+        block = padded_block.data();
+      }
+      for (std::size_t w = 0; w < 16; ++w) {
+        // the words are little endian like the host
+        std::uint64_t word;
+        std::memcpy(&word, block + w * sizeof(word), sizeof(word));
+        m[w][lane] = word;
+      }
+    }
+    offset += block_size;
+    Blake2bCompress(h, m, offset, last);
+  } while (offset < length);
+
+  for (std::size_t lane = 0; lane < kBlake2bLanes; ++lane) {
+    if (digests[lane] == nullptr) continue;
+    for (std::size_t i = 0; i < 8; ++i) {
+      const std::uint64_t word{h[i][lane]};
+      std::memcpy(digests[lane] + i * sizeof(word), &word, sizeof(word));
+    }
+  }
+}
+
+}  // namespace
+
+void Blake2bBatch(std::span<const std::uint8_t* const> messages, std::size_t length,
+                  std::span<std::uint8_t* const> digests) {
+  assert(messages.size() == digests.size());
+#if (OPENSSL_VERSION_NUMBER < 0x1010000fL)
+  // Blake2b falls back to SHA-512
+  auto context{NewBlakeCtx()};
+  for (std::size_t i = 0; i < messages.size(); ++i) {
+    Blake2b(const_cast<std::uint8_t*>(messages[i]), digests[i], length, context);
+  }
+#else
+  for (std::size_t i = 0; i < messages.size(); i += kBlake2bLanes) {
+    std::array<const std::uint8_t*, kBlake2bLanes> lane_messages{};
+    std::array<std::uint8_t*, kBlake2bLanes> lane_digests{};
+    for (std::size_t lane = 0; lane < std::min(kBlake2bLanes, messages.size() - i); ++lane) {
+      lane_messages[lane] = messages[i + lane];
+      lane_digests[lane] = digests[i + lane];
+    }
+    Blake2bLanes(lane_messages, length, lane_digests);
+  }
+#endif
+}
 }  // namespace encrypto::motion
@@ -24,8 +24,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 
 #include <openssl/evp.h>
 
@@ -41,4 +43,12 @@ void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::s
 void Blake2b(std::uint8_t* message, std::uint8_t digest[EVP_MAX_MD_SIZE], std::size_t length,
              Blake2bCtx& b);
 
+/// \brief Hashes each of the messages of \p length bytes into the digest of the same index as by
+///        Blake2b, where the messages are processed together in independent SIMD lanes, 8 with
+///        AVX-512, 4 with AVX2 and 2 otherwise.  This is faster than single calls of Blake2b for
+///        many short messages, such as the ones hashed per OT.
+/// \pre messages.size() == digests.size() and each digest has EVP_MAX_MD_SIZE bytes
+void Blake2bBatch(std::span<const std::uint8_t* const> messages, std::size_t length,
+                  std::span<std::uint8_t* const> digests);
+
 }  // namespace encrypto::motion
\ No newline at end of file
@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "paillier.h"
+
+#include <new>
+#include <tuple>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion::primitives {
+
+namespace {
+
+constexpr std::size_t kMinimumModulusBitLength{1024};
+
+void Check(int result) {
+  if (result != 1) {
+    throw std::runtime_error("OpenSSL BIGNUM operation failed");
+  }
+}
+
+template <typename T>
+T* CheckAllocation(T* pointer) {
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+// clears the value of secret numbers when freeing them
+BignumPointer NewSecretBignum() {
+  return BignumPointer(CheckAllocation(BN_new()), &BN_clear_free);
+}
+
+// returns a uniformly random number in [1, n)
+BignumPointer RandomUnit(const BIGNUM& n) {
+  auto r{NewSecretBignum()};
+  do {
+    Check(BN_rand_range(r.get(), &n));
+  } while (BN_is_zero(r.get()));
+  return r;
+}
+
+// multiplies the randomness r^n by g^m = 1 + m * n mod n^2
+BignumPointer MultiplyGeneratorPower(const BIGNUM& randomness, const BIGNUM& plaintext,
+                                     const BIGNUM& n, const BIGNUM& n_squared, BN_CTX& context) {
+  auto result{NewBignum()};
+  Check(BN_mul(result.get(), &plaintext, &n, &context));
+  Check(BN_add_word(result.get(), 1));
+  Check(BN_mod_mul(result.get(), result.get(), &randomness, &n_squared, &context));
+  return result;
+}
+
+// computes m mod p = L_p(c^(p - 1) mod p^2) * h_p mod p with L_p(x) = (x - 1) / p
+BignumPointer DecryptModPrime(const BIGNUM& ciphertext, const BIGNUM& p, const BIGNUM& p_squared,
+                              const BIGNUM& h_p, BN_CTX& context) {
+  auto exponent{NewSecretBignum()};
+  BN_set_flags(exponent.get(), BN_FLG_CONSTTIME);
+  CheckAllocation(BN_copy(exponent.get(), &p));
+  Check(BN_sub_word(exponent.get(), 1));
+
+  auto x{NewSecretBignum()};
+  Check(BN_mod_exp(x.get(), &ciphertext, exponent.get(), &p_squared, &context));
+  Check(BN_sub_word(x.get(), 1));
+  auto result{NewSecretBignum()};
+  Check(BN_div(result.get(), nullptr, x.get(), &p, &context));
+  Check(BN_mod_mul(result.get(), result.get(), &h_p, &p, &context));
+  return result;
+}
+
+}  // namespace
+
+BignumPointer NewBignum() { return BignumPointer(CheckAllocation(BN_new()), &BN_free); }
+
+BignumContextPointer NewBignumContext() {
+  return BignumContextPointer(CheckAllocation(BN_CTX_new()), &BN_CTX_free);
+}
+
+PaillierPublicKey::PaillierPublicKey()
+    : n_(NewBignum()),
+      n_squared_(NewBignum()),
+      n_squared_montgomery_(CheckAllocation(BN_MONT_CTX_new()), &BN_MONT_CTX_free) {}
+
+PaillierPublicKey::PaillierPublicKey(std::span<const std::uint8_t> modulus) : PaillierPublicKey() {
+  BignumPointer n(
+      CheckAllocation(BN_bin2bn(modulus.data(), static_cast<int>(modulus.size()), nullptr)),
+      &BN_free);
+  const std::size_t bit_length = BN_num_bits(n.get());
+  if (bit_length < kMinimumModulusBitLength || !BN_is_odd(n.get())) {
+    throw std::invalid_argument(
+        fmt::format("Paillier modulus needs to be odd and have at least {} bits, got {} bits",
+                    kMinimumModulusBitLength, bit_length));
+  }
+  SetModulus(*n);
+}
+
+PaillierPublicKey::~PaillierPublicKey() = default;
+
+void PaillierPublicKey::SetModulus(const BIGNUM& n) {
+  auto context{NewBignumContext()};
+  CheckAllocation(BN_copy(n_.get(), &n));
+  Check(BN_sqr(n_squared_.get(), n_.get(), context.get()));
+  Check(BN_MONT_CTX_set(n_squared_montgomery_.get(), n_squared_.get(), context.get()));
+  ciphertext_byte_length_ = BN_num_bytes(n_squared_.get());
+}
+
+std::size_t PaillierPublicKey::GetModulusBitLength() const { return BN_num_bits(n_.get()); }
+
+std::vector<std::uint8_t> PaillierPublicKey::GetModulus() const {
+  std::vector<std::uint8_t> modulus(BN_num_bytes(n_.get()));
+  BN_bn2bin(n_.get(), modulus.data());
+  return modulus;
+}
+
+BignumPointer PaillierPublicKey::Encrypt(const BIGNUM& plaintext, BN_CTX& context) const {
+  auto r{RandomUnit(*n_)};
+  auto randomness{NewSecretBignum()};
+  Check(BN_mod_exp_mont(randomness.get(), r.get(), n_.get(), n_squared_.get(), &context,
+                        n_squared_montgomery_.get()));
+  return MultiplyGeneratorPower(*randomness, plaintext, *n_, *n_squared_, context);
+}
+
+BignumPointer PaillierPublicKey::Multiply(const BIGNUM& ciphertext, const BIGNUM& scalar,
+                                          BN_CTX& context) const {
+  auto result{NewBignum()};
+  Check(BN_mod_exp_mont(result.get(), &ciphertext, &scalar, n_squared_.get(), &context,
+                        n_squared_montgomery_.get()));
+  return result;
+}
+
+void PaillierPublicKey::Add(BIGNUM& ciphertext, const BIGNUM& summand, BN_CTX& context) const {
+  Check(BN_mod_mul(&ciphertext, &ciphertext, &summand, n_squared_.get(), &context));
+}
+
+void PaillierPublicKey::Serialize(const BIGNUM& ciphertext, std::span<std::uint8_t> output) const {
+  if (output.size() != ciphertext_byte_length_ ||
+      BN_bn2binpad(&ciphertext, output.data(), static_cast<int>(output.size())) < 0) {
+    throw std::invalid_argument(fmt::format(
+        "Paillier ciphertext does not fit into {} bytes, expected {} bytes", output.size(),
+        ciphertext_byte_length_));
+  }
+}
+
+BignumPointer PaillierPublicKey::Deserialize(std::span<const std::uint8_t> input) const {
+  if (input.size() != ciphertext_byte_length_) {
+    throw std::invalid_argument(fmt::format("Paillier ciphertext has {} bytes, expected {} bytes",
+                                            input.size(), ciphertext_byte_length_));
+  }
+  BignumPointer ciphertext(
+      CheckAllocation(BN_bin2bn(input.data(), static_cast<int>(input.size()), nullptr)),
+      &BN_free);
+  if (BN_cmp(ciphertext.get(), n_squared_.get()) >= 0) {
+    throw std::invalid_argument("Paillier ciphertext is not less than the squared modulus");
+  }
+  return ciphertext;
+}
+
+PaillierPrivateKey::PaillierPrivateKey(std::size_t modulus_bit_length)
+    : p_(NewSecretBignum()),
+      q_(NewSecretBignum()),
+      p_squared_(NewSecretBignum()),
+      q_squared_(NewSecretBignum()),
+      exponent_p_(NewSecretBignum()),
+      exponent_q_(NewSecretBignum()),
+      h_p_(NewSecretBignum()),
+      h_q_(NewSecretBignum()),
+      q_inverse_(NewSecretBignum()),
+      q_squared_inverse_(NewSecretBignum()) {
+  if (modulus_bit_length < kMinimumModulusBitLength) {
+    throw std::invalid_argument(fmt::format("Paillier modulus needs at least {} bits, got {} bits",
+                                            kMinimumModulusBitLength, modulus_bit_length));
+  }
+  auto context{NewBignumContext()};
+  auto n{NewBignum()};
+  do {
+    Check(BN_generate_prime_ex(p_.get(), static_cast<int>((modulus_bit_length + 1) / 2), 0,
+                               nullptr, nullptr, nullptr));
+    Check(BN_generate_prime_ex(q_.get(), static_cast<int>(modulus_bit_length / 2), 0, nullptr,
+                               nullptr, nullptr));
+    Check(BN_mul(n.get(), p_.get(), q_.get(), context.get()));
+  } while (BN_cmp(p_.get(), q_.get()) == 0 ||
+           static_cast<std::size_t>(BN_num_bits(n.get())) != modulus_bit_length);
+  SetModulus(*n);
+
+  Check(BN_sqr(p_squared_.get(), p_.get(), context.get()));
+  Check(BN_sqr(q_squared_.get(), q_.get(), context.get()));
+
+  auto generator{NewBignum()};
+  CheckAllocation(BN_copy(generator.get(), n_.get()));
+  Check(BN_add_word(generator.get(), 1));
+  auto totient{NewSecretBignum()};
+  for (auto [prime, prime_squared, exponent, h] :
+       {std::tuple{p_.get(), p_squared_.get(), exponent_p_.get(), h_p_.get()},
+        std::tuple{q_.get(), q_squared_.get(), exponent_q_.get(), h_q_.get()}}) {
+    // phi(p^2) = p * (p - 1)
+    CheckAllocation(BN_copy(totient.get(), prime));
+    Check(BN_sub_word(totient.get(), 1));
+    Check(BN_mul(totient.get(), totient.get(), prime, context.get()));
+    Check(BN_mod(exponent, n_.get(), totient.get(), context.get()));
+    BN_set_flags(exponent, BN_FLG_CONSTTIME);
+
+    // h_p = L_p(g^(p - 1) mod p^2)^(-1) mod p, i.e., the inverse of the decryption of g
+    auto l{DecryptModPrime(*generator, *prime, *prime_squared, *BN_value_one(), *context)};
+    CheckAllocation(BN_mod_inverse(h, l.get(), prime, context.get()));
+  }
+  CheckAllocation(BN_mod_inverse(q_inverse_.get(), q_.get(), p_.get(), context.get()));
+  CheckAllocation(
+      BN_mod_inverse(q_squared_inverse_.get(), q_squared_.get(), p_squared_.get(), context.get()));
+}
+
+PaillierPrivateKey::~PaillierPrivateKey() = default;
+
+BignumPointer PaillierPrivateKey::Encrypt(const BIGNUM& plaintext, BN_CTX& context) const {
+  auto r{RandomUnit(*n_)};
+
+  // r^n mod n^2 from r^n mod p^2 and r^n mod q^2
+  auto x_p{NewSecretBignum()}, x_q{NewSecretBignum()};
+  Check(BN_mod_exp(x_p.get(), r.get(), exponent_p_.get(), p_squared_.get(), &context));
+  Check(BN_mod_exp(x_q.get(), r.get(), exponent_q_.get(), q_squared_.get(), &context));
+  auto randomness{NewSecretBignum()};
+  Check(BN_mod_sub(randomness.get(), x_p.get(), x_q.get(), p_squared_.get(), &context));
+  Check(BN_mod_mul(randomness.get(), randomness.get(), q_squared_inverse_.get(), p_squared_.get(),
+                   &context));
+  Check(BN_mul(randomness.get(), randomness.get(), q_squared_.get(), &context));
+  Check(BN_add(randomness.get(), randomness.get(), x_q.get()));
+
+  return MultiplyGeneratorPower(*randomness, plaintext, *n_, *n_squared_, context);
+}
+
+BignumPointer PaillierPrivateKey::Decrypt(const BIGNUM& ciphertext, BN_CTX& context) const {
+  auto m_p{DecryptModPrime(ciphertext, *p_, *p_squared_, *h_p_, context)};
+  auto m_q{DecryptModPrime(ciphertext, *q_, *q_squared_, *h_q_, context)};
+
+  // m = m_q + q * ((m_p - m_q) * q^(-1) mod p)
+  auto plaintext{NewBignum()};
+  Check(BN_mod_sub(plaintext.get(), m_p.get(), m_q.get(), p_.get(), &context));
+  Check(BN_mod_mul(plaintext.get(), plaintext.get(), q_inverse_.get(), p_.get(), &context));
+  Check(BN_mul(plaintext.get(), plaintext.get(), q_.get(), &context));
+  Check(BN_add(plaintext.get(), plaintext.get(), m_q.get()));
+  return plaintext;
+}
+
+}  // namespace encrypto::motion::primitives
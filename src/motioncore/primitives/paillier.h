@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <openssl/bn.h>
+
+namespace encrypto::motion::primitives {
+
+using BignumPointer = std::unique_ptr<BIGNUM, decltype(&BN_free)>;
+using BignumContextPointer = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+
+/// \brief Returns a new BIGNUM with value 0.
+/// \throws std::bad_alloc if OpenSSL could not allocate it.
+BignumPointer NewBignum();
+
+/// \brief Returns a new context for the temporary variables of the BN_* functions, which must not
+/// be shared between threads.
+/// \throws std::bad_alloc if OpenSSL could not allocate it.
+BignumContextPointer NewBignumContext();
+
+/// \brief Public key of the Paillier cryptosystem with the generator g = n + 1, which supports the
+/// additively homomorphic operations on ciphertexts.  Ciphertexts are serialized as big-endian
+/// byte strings of GetCiphertextByteLength() bytes.  All member functions are const and can be
+/// called concurrently if each thread passes its own context.
+class PaillierPublicKey {
+ public:
+  /// \brief Creates the key from the modulus n in big-endian byte order, see GetModulus.
+  /// \throws std::invalid_argument if \p modulus is not an odd number of at least 1024 bits.
+  explicit PaillierPublicKey(std::span<const std::uint8_t> modulus);
+
+  virtual ~PaillierPublicKey();
+
+  std::size_t GetModulusBitLength() const;
+
+  std::size_t GetCiphertextByteLength() const noexcept { return ciphertext_byte_length_; }
+
+  /// \brief Returns the modulus n in big-endian byte order.
+  std::vector<std::uint8_t> GetModulus() const;
+
+  const BIGNUM& GetModulusBignum() const noexcept { return *n_; }
+
+  /// \brief Encrypts \p plaintext, which must be less than n, with fresh randomness.
+  virtual BignumPointer Encrypt(const BIGNUM& plaintext, BN_CTX& context) const;
+
+  /// \brief Returns an encryption of m * \p scalar for the encryption \p ciphertext of m.
+  BignumPointer Multiply(const BIGNUM& ciphertext, const BIGNUM& scalar, BN_CTX& context) const;
+
+  /// \brief Replaces the encryption \p ciphertext of m0 by an encryption of m0 + m1, where
+  /// \p summand is an encryption of m1.
+  void Add(BIGNUM& ciphertext, const BIGNUM& summand, BN_CTX& context) const;
+
+  /// \brief Writes \p ciphertext to the GetCiphertextByteLength() bytes at \p output.
+  void Serialize(const BIGNUM& ciphertext, std::span<std::uint8_t> output) const;
+
+  /// \throws std::invalid_argument if \p input is not a ciphertext of this key.
+  BignumPointer Deserialize(std::span<const std::uint8_t> input) const;
+
+ protected:
+  PaillierPublicKey();
+
+  void SetModulus(const BIGNUM& n);
+
+  BignumPointer n_;
+  BignumPointer n_squared_;
+  std::unique_ptr<BN_MONT_CTX, decltype(&BN_MONT_CTX_free)> n_squared_montgomery_;
+  std::size_t ciphertext_byte_length_{0};
+};
+
+/// \brief Key pair of the Paillier cryptosystem.  Encryption and decryption compute modulo p^2 and
+/// q^2 instead of n^2 and combine the results with the CRT, which makes encryption about 2 times
+/// faster than with the public key.
+class PaillierPrivateKey final : public PaillierPublicKey {
+ public:
+  /// \brief Generates a new key pair whose modulus n has \p modulus_bit_length bits.
+  /// \throws std::invalid_argument if \p modulus_bit_length is less than 1024.
+  explicit PaillierPrivateKey(std::size_t modulus_bit_length);
+
+  ~PaillierPrivateKey();
+
+  BignumPointer Encrypt(const BIGNUM& plaintext, BN_CTX& context) const final override;
+
+  BignumPointer Decrypt(const BIGNUM& ciphertext, BN_CTX& context) const;
+
+ private:
+  BignumPointer p_, q_, p_squared_, q_squared_;
+  // n mod phi(p^2) and n mod phi(q^2) for computing r^n mod p^2 and mod q^2
+  BignumPointer exponent_p_, exponent_q_;
+  // L_p(g^(p - 1) mod p^2)^(-1) mod p and the same for q
+  BignumPointer h_p_, h_q_;
+  BignumPointer q_inverse_, q_squared_inverse_;
+};
+
+}  // namespace encrypto::motion::primitives
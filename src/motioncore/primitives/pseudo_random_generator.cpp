@@ -148,4 +148,8 @@ void Prg::FixedKeyAes(const std::byte* input, const uint128_t tweak, std::byte*
 
 void Prg::Mmo(std::byte* input) { AesniMmoSingle(round_keys_.data(), input); }
 
+void Prg::Mmo(std::byte* input, std::size_t number_of_blocks) {
+  AesniMmoBlocks(round_keys_.data(), input, number_of_blocks);
+}
+
 }  // namespace encrypto::motion::primitives
@@ -65,6 +65,10 @@ class Prg {
   std::vector<std::byte> FixedKeyAes(const std::byte* x, const uint128_t i);
   void Mmo(std::byte* input);
 
+  // MMO of number_of_blocks consecutive AES blocks, four of them are hashed at once
+  // input has to be 16B aligned
+  void Mmo(std::byte* input, std::size_t number_of_blocks);
+
   // Implementation of TMMO^\pi
   // of https://eprint.iacr.org/2019/074
   // with input x and tweak i
@@ -25,17 +25,32 @@
 #include "sharing_randomness_generator.h"
 #include "blake2b.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <openssl/aes.h>
 
+#include "aes/aesni_primitives.h"
 #include "utility/helpers.h"
+#include "utility/pool_allocator.h"
 
 namespace encrypto::motion::primitives {
 
-SharingRandomnessGenerator::SharingRandomnessGenerator(std::size_t party_id)
-    : party_id_(party_id), context_arithmetic_(MakeCipherCtx()), context_boolean_(MakeCipherCtx()) {
-  if (!context_arithmetic_ || !context_boolean_) {
-    throw(std::runtime_error(fmt::format("Could not initialize EVP context")));
+namespace {
+
+// Per-thread buffer for the AES-CTR key stream, which is reused across calls and generators
+std::byte* GetKeyStreamBuffer(std::size_t number_of_blocks) {
+  thread_local std::vector<std::byte, PooledAlignedAllocator<std::byte, kAesBlockSize>> buffer;
+  if (buffer.size() < number_of_blocks * kAesBlockSize) {
+    buffer.resize(number_of_blocks * kAesBlockSize);
   }
+  return buffer.data();
+}
+
+}  // namespace
+
+SharingRandomnessGenerator::SharingRandomnessGenerator(std::size_t party_id)
+    : party_id_(party_id) {
   initialized_condition_ = std::make_unique<FiberCondition>([this]() { return initialized_; });
 }
 
@@ -47,18 +62,10 @@ void SharingRandomnessGenerator::Initialize(
     auto digest = HashKey(master_seed_, KeyType::kArithmeticGmwKey);
     std::copy(digest.data(), digest.data() + kAesKeySize, raw_key_arithmetic_);
   }
-  {
-    auto digest = HashKey(master_seed_, KeyType::kArithmeticGmwNonce);
-    std::copy(digest.data(), digest.data() + AES_BLOCK_SIZE / 2, aes_ctr_nonce_arithmetic_);
-  }
   {
     auto digest = HashKey(master_seed_, KeyType::kBooleanGmwKey);
     std::copy(digest.data(), digest.data() + kAesKeySize, raw_key_boolean_);
   }
-  {
-    auto digest = HashKey(master_seed_, KeyType::kBooleanGmwNonce);
-    std::copy(digest.data(), digest.data() + AES_BLOCK_SIZE / 2, aes_ctr_nonce_boolean_);
-  }
 
   prg_a.SetKey(raw_key_arithmetic_);
   prg_b.SetKey(raw_key_boolean_);
@@ -72,8 +79,6 @@ void SharingRandomnessGenerator::Initialize(
 
 BitVector<> SharingRandomnessGenerator::GetBits(const std::size_t gate_id,
                                                 const std::size_t number_of_bits) {
-  std::scoped_lock lock(random_bits_mutex_);
-
   if (number_of_bits == 0) {
     return {};  // return an empty vector if number_of_gates is zero
   }
@@ -82,44 +87,22 @@ BitVector<> SharingRandomnessGenerator::GetBits(const std::size_t gate_id,
     initialized_condition_->Wait();
   }
 
-  constexpr std::size_t kBitsInCiphertext = AES_BLOCK_SIZE * 8;
-  constexpr std::size_t kCipherTextsInBatch = 100;
-  // initialization for the encryption is costly, so perform random bit generation in a batch
-  constexpr std::size_t kBitsInBatch = kBitsInCiphertext * kCipherTextsInBatch;
-  constexpr std::size_t kBytesInBatch = kBitsInBatch / 8;
-
-  while (random_bits_.GetSize() < (gate_id - random_bits_offset_ + number_of_bits)) {
-    std::vector<std::byte> input(kBytesInBatch + AES_BLOCK_SIZE),
-        output(kBytesInBatch + AES_BLOCK_SIZE);
-    for (auto offset = random_bits_.GetSize() / kAesBlockSize; offset < kCipherTextsInBatch;
-         ++offset) {
-      auto pointer = reinterpret_cast<std::uint8_t*>(input.data()) + offset * kAesBlockSize;
-      // copy nonce
-      std::copy(std::begin(aes_ctr_nonce_boolean_), std::end(aes_ctr_nonce_boolean_), pointer);
-      // copy counter value
-      *reinterpret_cast<uint64_t*>(pointer + kAesBlockSize / 2) = offset;
-    }
-
-    // encrypt as in CTR mode, but without sequentially incrementing the counter
-    // after each encryption
-    std::vector<std::byte> output_bytes =
-        prg_b.Encrypt(input.data(), kCipherTextsInBatch * AES_BLOCK_SIZE);
-
-    for (auto i = 0ull; i < kBytesInBatch; ++i) {
-      output_bytes.push_back(std::byte(output.at(i)));
-    }
-    auto randomness = BitVector(std::move(output_bytes), kBitsInBatch);
-    random_bits_.Append(randomness);
-  }
-
-  const auto requested = gate_id - random_bits_offset_ + number_of_bits;
-  if (requested > random_bits_used_) {
-    random_bits_used_ = requested;
+  std::size_t position;
+  {
+    std::scoped_lock lock(random_bits_mutex_);
+    random_bits_used_ = std::max(random_bits_used_, gate_id + number_of_bits);
+    position = random_bits_offset_ + gate_id;
   }
 
-  assert(gate_id >= random_bits_offset_);
-  return random_bits_.Subset(gate_id - random_bits_offset_,
-                             gate_id + number_of_bits - random_bits_offset_);
+  // bit i of the key stream is bit i % 128 of the block with counter i / 128
+  constexpr std::size_t kBitsInBlock = kAesBlockSize * 8;
+  const std::size_t shift = position % kBitsInBlock;
+  const std::size_t number_of_blocks = (shift + number_of_bits + kBitsInBlock - 1) / kBitsInBlock;
+  std::uint64_t counter = position / kBitsInBlock;
+  std::byte* key_stream = GetKeyStreamBuffer(number_of_blocks);
+  AesniCtrStreamBlocks128(prg_b.GetRoundKeys(), &counter, key_stream, number_of_blocks);
+  return BitSpan(key_stream, number_of_blocks * kBitsInBlock)
+      .Subset<BitVector<>>(shift, shift + number_of_bits);
 }
 
 std::vector<std::uint8_t> SharingRandomnessGenerator::HashKey(
@@ -149,42 +132,21 @@ std::vector<std::uint8_t> SharingRandomnessGenerator::GetSeed() {
   return std::vector<std::uint8_t>(master_seed_, master_seed_ + sizeof(master_seed_));
 }
 
-void SharingRandomnessGenerator::ClearBitPool() { random_bits_ = BitVector<>(); }
+void SharingRandomnessGenerator::ClearBitPool() {
+  // the bits are generated on demand, so there is nothing cached to clear
+}
 
 void SharingRandomnessGenerator::ResetBitPool() {
-  if (random_bits_used_ == random_bits_.GetSize()) {
-    random_bits_.Clear();
-  } else {
-    random_bits_ = random_bits_.Subset(random_bits_used_, random_bits_.GetSize() - 1);
-  }
+  std::scoped_lock lock(random_bits_mutex_);
   random_bits_offset_ += random_bits_used_;
   random_bits_used_ = 0;
 }
 
 template <typename T>
 T SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id) {
-  initialized_condition_->Wait();
-
-  std::byte input[AES_BLOCK_SIZE];
-
-  std::copy(std::begin(aes_ctr_nonce_arithmetic_), std::end(aes_ctr_nonce_arithmetic_),
-            reinterpret_cast<std::uint8_t*>(input));
-  std::copy(reinterpret_cast<const std::byte*>(&gate_id),
-            reinterpret_cast<const std::byte*>(&gate_id) + sizeof(gate_id),
-            input + SharingRandomnessGenerator::kCounterOffset);
-
-  auto output = prg_a.Encrypt(input, AES_BLOCK_SIZE);
-
-  // combine resulting randomness xored with the gate_id, which is the actual
-  // input to AES-CTR
-  __uint128_t result = reinterpret_cast<std::uint64_t*>(output.data())[0],
-              modulus = std::numeric_limits<T>::max();
-  result <<= 64;
-  result ^= reinterpret_cast<std::uint64_t*>(output.data())[1] ^ gate_id;
-  result %= modulus;
-
-  return static_cast<T>(result);  // static-cast the result to the smaller
-                                  // ring
+  T result;
+  GetUnsigned<T>(gate_id, std::span(&result, 1));
+  return result;
 }
 
 template std::uint8_t SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id);
@@ -196,41 +158,30 @@ template uint128_t SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id);
 template <typename T>
 std::vector<T> SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
                                                        std::size_t number_of_gates) {
-  if (number_of_gates == 0) {
-    return {};  // return an empty vector if number_of_gates is zero
+  std::vector<T> results(number_of_gates);
+  GetUnsigned<T>(gate_id, std::span(results));
+  return results;
+}
+
+template <typename T>
+void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id, std::span<T> output) {
+  if (output.empty()) {
+    return;
   }
 
   initialized_condition_->Wait();
 
-  // Pre-initialize output vector
-  std::vector<T> results;
-  results.reserve(number_of_gates);
-
-  auto size_in_bytes = AES_BLOCK_SIZE * (number_of_gates);
-  std::vector<std::byte> input(size_in_bytes + AES_BLOCK_SIZE);
-
-  auto gate_id_copy = gate_id;
-  for (auto i = 0u; i < number_of_gates; ++i, ++gate_id_copy) {
-    std::copy(std::begin(aes_ctr_nonce_arithmetic_), std::end(aes_ctr_nonce_arithmetic_),
-              reinterpret_cast<std::uint8_t*>(input.data()) + i * AES_BLOCK_SIZE);
-    std::copy(reinterpret_cast<std::byte*>(&gate_id_copy),
-              reinterpret_cast<std::byte*>(&gate_id_copy) + sizeof(gate_id_copy),
-              input.data() + i * AES_BLOCK_SIZE + SharingRandomnessGenerator::kCounterOffset);
-  }
-
-  auto output = prg_a.Encrypt(input.data(), number_of_gates * AES_BLOCK_SIZE);
-  __uint128_t modulus = std::numeric_limits<T>::max(), single_result;
-  // combine resulting randomness xored with the gate_id, which is the actual
-  // input to AES-CTR
-  for (auto i = 0u; i < number_of_gates; ++i) {
-    single_result = reinterpret_cast<std::uint64_t*>(output.data())[i * 2];
-    single_result <<= 64;
-    single_result ^= reinterpret_cast<std::uint64_t*>(output.data())[i * 2 + 1] ^ gate_id++;
-    single_result %= modulus;
-    results.push_back(static_cast<T>(single_result));  // static-cast the result to the smaller ring
+  // each value takes the lowest bytes of the block with its sharing id as counter, s.t. the
+  // values of different bit lengths never share a block
+  std::uint64_t counter = gate_id;
+  std::byte* key_stream = GetKeyStreamBuffer(std::min(output.size(), kBlocksInBatch));
+  for (std::size_t i = 0; i < output.size(); i += kBlocksInBatch) {
+    const std::size_t number_of_blocks = std::min(output.size() - i, kBlocksInBatch);
+    AesniCtrStreamBlocks128(prg_a.GetRoundKeys(), &counter, key_stream, number_of_blocks);
+    for (std::size_t j = 0; j < number_of_blocks; ++j) {
+      std::memcpy(&output[i + j], key_stream + j * kAesBlockSize, sizeof(T));
+    }
   }
-
-  return results;
 }
 
 template std::vector<std::uint8_t> SharingRandomnessGenerator::GetUnsigned(
@@ -244,4 +195,15 @@ template std::vector<std::uint64_t> SharingRandomnessGenerator::GetUnsigned(
 template std::vector<uint128_t> SharingRandomnessGenerator::GetUnsigned(
     std::size_t gate_id, std::size_t number_of_gates);
 
+template void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
+                                                      std::span<std::uint8_t> output);
+template void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
+                                                      std::span<std::uint16_t> output);
+template void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
+                                                      std::span<std::uint32_t> output);
+template void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
+                                                      std::span<std::uint64_t> output);
+template void SharingRandomnessGenerator::GetUnsigned(std::size_t gate_id,
+                                                      std::span<uint128_t> output);
+
 }  // namespace encrypto::motion::primitives
@@ -26,6 +26,7 @@
 
 #include <boost/fiber/mutex.hpp>
 #include <limits>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -77,12 +78,21 @@ class SharingRandomnessGenerator {
 
   SharingRandomnessGenerator() = delete;
 
+  /// \brief Returns the value of the sharing id \p gate_id, which is derived from the AES-CTR
+  ///        block with counter \p gate_id of the arithmetic key.
   template <typename T>
   T GetUnsigned(const std::size_t gate_id);
 
   template <typename T>
   std::vector<T> GetUnsigned(std::size_t gate_id, std::size_t number_of_gates);
 
+  /// \brief Fills \p output with the values of the sharing ids gate_id, ...,
+  ///        gate_id + output.size() - 1 in one wide batch of AES-NI counter mode.
+  template <typename T>
+  void GetUnsigned(std::size_t gate_id, std::span<T> output);
+
+  /// \brief Returns the bits [gate_id, gate_id + number_of_bits) of the AES-CTR key stream of the
+  ///        Boolean key.
   BitVector<> GetBits(std::size_t gate_id, std::size_t number_of_bits);
 
   void ClearBitPool();
@@ -90,24 +100,15 @@ class SharingRandomnessGenerator {
   void ResetBitPool();
 
  private:
-  static constexpr std::size_t kCounterOffset =
-      AES_BLOCK_SIZE / 2;  /// Byte length of the AES-CTR nonce
+  // number of AES blocks generated at once into the per-thread key stream buffer
+  static constexpr std::size_t kBlocksInBatch = 1024;
   std::int64_t party_id_ = -1;
 
-  /// AES context, created only once and reused further
-  using EvpCipherCtxPointer = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
-  static constexpr auto MakeCipherCtx = []() {
-    return EvpCipherCtxPointer(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
-  };
-  EvpCipherCtxPointer context_arithmetic_, context_boolean_;
-
   std::uint8_t master_seed_[SharingRandomnessGenerator::kMasterSeedByteLength] = {0};
   std::uint8_t raw_key_arithmetic_[kAesKeySize] = {0};
   std::uint8_t raw_key_boolean_[kAesKeySize] = {0};  /// AES key in raw std::uint8_t format
-  std::uint8_t aes_ctr_nonce_arithmetic_[AES_BLOCK_SIZE / 2] = {0};
-  std::uint8_t aes_ctr_nonce_boolean_[AES_BLOCK_SIZE / 2] = {0};  /// Raw AES CTR nonce that is used
-  /// in the left part of IV
 
+  // hold the AES-NI round keys of the arithmetic and the Boolean key
   primitives::Prg prg_a, prg_b;
 
   enum KeyType : unsigned int {
@@ -123,8 +124,6 @@ class SharingRandomnessGenerator {
 
   bool initialized_ = false;
 
-  BitVector<> random_bits_;
-
   std::size_t random_bits_offset_ = 0;
   std::size_t random_bits_used_ = 0;
 
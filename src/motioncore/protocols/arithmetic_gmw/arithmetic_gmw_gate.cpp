@@ -26,8 +26,13 @@
 
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <span>
+#include <stdexcept>
 
 #include "base/backend.h"
 #include "base/register.h"
@@ -35,7 +40,10 @@
 #include "communication/message.h"
 #include "communication/message_manager.h"
 #include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
 #include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/random_ot_pool.h"
+#include "primitives/pseudo_random_generator.h"
 #include "primitives/sharing_randomness_generator.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
@@ -65,15 +73,34 @@ void InputGate<T>::InitializationHelper() {
 
   arithmetic_sharing_id_ = GetRegister().NextArithmeticSharingId(input_.size());
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Created an arithmetic_gmw::InputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created an arithmetic_gmw::InputGate with global id {}", gate_id_);
   }
   output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(input_, backend_)};
 
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, owner {}", sizeof(T) * 8, gate_id_, input_owner_id_);
-  GetLogger().LogDebug(fmt::format(
-      "Allocate an arithmetic_gmw::InputGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Allocate an arithmetic_gmw::InputGate with following properties: {}",
+                       gate_info);
+}
+
+template <typename T>
+void InputGate<T>::SetInput(std::vector<T>&& input) {
+  if (input.size() != input_.size()) {
+    throw std::invalid_argument(
+        fmt::format("arithmetic_gmw::InputGate#{} expects an input of {} SIMD values", gate_id_,
+                    input_.size()));
+  }
+  input_ = std::move(input);
+}
+
+template <typename T>
+void InputGate<T>::SetInput(std::span<const T> input) {
+  if (input.size() != input_.size()) {
+    throw std::invalid_argument(
+        fmt::format("arithmetic_gmw::InputGate#{} expects an input of {} SIMD values", gate_id_,
+                    input_.size()));
+  }
+  std::copy(input.begin(), input.end(), input_.begin());
 }
 
 template <typename T>
@@ -103,13 +130,9 @@ void InputGate<T>::EvaluateOnline() {
       if constexpr (kVerboseDebug) {
         log_string.append(fmt::format("id#{}:{} ", party_id, randomness.at(0)));
       }
-      for (auto j = 0u; j < result.size(); ++j) {
-        result.at(j) += randomness.at(j);
-      }
-    }
-    for (auto j = 0u; j < result.size(); ++j) {
-      result.at(j) = input_.at(j) - result.at(j);
+      AddVectors<T>(result, randomness, result);
     }
+    SubVectors<T>(input_, result, result);
 
     if constexpr (kVerboseDebug) {
       auto s = fmt::format(
@@ -134,7 +157,7 @@ void InputGate<T>::EvaluateOnline() {
   assert(my_wire);
   my_wire->GetMutableValues() = std::move(result);
 
-  GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::InputGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::InputGate with id#{}", gate_id_);
 }
 
 // perhaps, we should return a copy of the pointer and not move it for the
@@ -142,7 +165,7 @@ void InputGate<T>::EvaluateOnline() {
 template <typename T>
 arithmetic_gmw::SharePointer<T> InputGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = GetOutputArithmeticWire();
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -194,9 +217,15 @@ OutputGate<T>::OutputGate(const arithmetic_gmw::WirePointer<T>& parent, std::siz
   output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
       backend_, parent->GetNumberOfSimdValues())};
 
+  auto& output_batcher{backend_.GetOutputBatcher()};
+  const auto layer{GetRegister().ComputeLayer(parent_)};
+  if (output_batcher.GetOutputBatching() && layer) {
+    output_position_ = output_batcher.AssignOutput(
+        *layer, sizeof(T) * 8, output_owner_, parent->GetNumberOfSimdValues() * sizeof(T));
+  }
   // Tell the DataStorages that we want to receive OutputMessages from the
   // other parties.
-  if (is_my_output_) {
+  else if (is_my_output_) {
     output_message_futures_ = GetCommunicationLayer().GetMessageManager().RegisterReceiveAll(
         communication::MessageType::kOutputMessage, gate_id_);
   }
@@ -204,8 +233,8 @@ OutputGate<T>::OutputGate(const arithmetic_gmw::WirePointer<T>& parent, std::siz
   if constexpr (kDebug) {
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, owner {}", sizeof(T) * 8, gate_id_, output_owner_);
-    GetLogger().LogDebug(fmt::format(
-        "Allocate an arithmetic_gmw::OutputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Allocate an arithmetic_gmw::OutputGate with following properties: {}",
+                         gate_info);
   }
 }
 
@@ -241,6 +270,21 @@ void OutputGate<T>::EvaluateOnline() {
   // initialize output with local share
   auto output = arithmetic_wire->GetValues();
 
+  if (output_position_) {
+    const auto payload{ToByteVector<T>(output)};
+    const auto values{backend_.GetOutputBatcher().Reconstruct(*output_position_, payload)};
+    if (is_my_output_) {
+      auto arithmetic_output_wire =
+          std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+      assert(arithmetic_output_wire);
+      arithmetic_output_wire->GetMutableValues() = FromByteVector<T>(values);
+    }
+    if constexpr (kDebug) {
+      GetLogger().LogDebug("Evaluated batched arithmetic_gmw::OutputGate with id#{}", gate_id_);
+    }
+    return;
+  }
+
   // we need to send shares to one other party:
   if (!is_my_output_) {
     auto payload = ToByteVector<T>(output);
@@ -296,16 +340,15 @@ void OutputGate<T>::EvaluateOnline() {
         shares.append(fmt::format("id#{}:{} ", i, to_string(shared_outputs.at(i))));
       }
       auto result = to_string(output);
-      GetLogger().LogTrace(
-          fmt::format("Received output shares: {} from other parties, "
-                      "reconstructed result is {}",
-                      shares, result));
+      GetLogger().LogTrace("Received output shares: {} from other parties, "
+                           "reconstructed result is {}",
+                           shares, result);
     }
   }
 
   // we are done with this gate
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::OutputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated arithmetic_gmw::OutputGate with id#{}", gate_id_);
   }
 }
 
@@ -313,7 +356,7 @@ template <typename T>
 arithmetic_gmw::SharePointer<T> OutputGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -323,6 +366,44 @@ template class OutputGate<std::uint32_t>;
 template class OutputGate<std::uint64_t>;
 template class OutputGate<__uint128_t>;
 
+template <typename T>
+RandomGate<T>::RandomGate(std::size_t number_of_simd, Backend& backend) : Gate(backend) {
+  if (number_of_simd == 0) {
+    throw std::invalid_argument("arithmetic_gmw::RandomGate needs at least one SIMD value");
+  }
+  arithmetic_sharing_id_ = GetRegister().NextArithmeticSharingId(number_of_simd);
+  output_wires_ = {
+      GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_, number_of_simd)};
+}
+
+template <typename T>
+void RandomGate<T>::EvaluateOnline() {
+  // the private seed is chosen in the base provider's setup
+  GetBaseProvider().WaitSetup();
+
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto& values{arithmetic_wire->GetMutableValues()};
+  values.resize(arithmetic_wire->GetNumberOfSimdValues());
+  GetBaseProvider()
+      .GetMyRandomnessGenerator(GetCommunicationLayer().GetMyId())
+      .template GetUnsigned<T>(arithmetic_sharing_id_, std::span<T>(values));
+}
+
+template <typename T>
+arithmetic_gmw::SharePointer<T> RandomGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  return result;
+}
+
+template class RandomGate<std::uint8_t>;
+template class RandomGate<std::uint16_t>;
+template class RandomGate<std::uint32_t>;
+template class RandomGate<std::uint64_t>;
+template class RandomGate<__uint128_t>;
+
 template <typename T>
 AdditionGate<T>::AdditionGate(const arithmetic_gmw::WirePointer<T>& a,
                               const arithmetic_gmw::WirePointer<T>& b)
@@ -338,8 +419,8 @@ AdditionGate<T>::AdditionGate(const arithmetic_gmw::WirePointer<T>& a,
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                   parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::AdditionGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Created an arithmetic_gmw::AdditionGate with following properties: {}",
+                       gate_info);
 }
 
 template <typename T>
@@ -357,20 +438,19 @@ void AdditionGate<T>::EvaluateOnline() {
   assert(wire_a);
   assert(wire_b);
 
-  std::vector<T> output;
-  output = RestrictAddVectors<T>(wire_a->GetValues(), wire_b->GetValues());
-
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-  arithmetic_wire->GetMutableValues() = std::move(output);
+  auto& output{arithmetic_wire->GetMutableValues()};
+  output.resize(wire_a->GetValues().size());
+  AddVectors<T>(wire_a->GetValues(), wire_b->GetValues(), output);
 
-  GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::AdditionGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::AdditionGate with id#{}", gate_id_);
 }
 
 template <typename T>
 arithmetic_gmw::SharePointer<T> AdditionGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -395,8 +475,8 @@ SubtractionGate<T>::SubtractionGate(const arithmetic_gmw::WirePointer<T>& a,
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                   parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::SubtractionGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Created an arithmetic_gmw::SubtractionGate with following properties: {}",
+                       gate_info);
 }
 
 template <typename T>
@@ -414,20 +494,19 @@ void SubtractionGate<T>::EvaluateOnline() {
   assert(wire_a);
   assert(wire_b);
 
-  std::vector<T> output = SubVectors<T>(wire_a->GetValues(), wire_b->GetValues());
-
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-  arithmetic_wire->GetMutableValues() = std::move(output);
+  auto& output{arithmetic_wire->GetMutableValues()};
+  output.resize(wire_a->GetValues().size());
+  SubVectors<T>(wire_a->GetValues(), wire_b->GetValues(), output);
 
-  GetLogger().LogDebug(
-      fmt::format("Evaluated arithmetic_gmw::SubtractionGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::SubtractionGate with id#{}", gate_id_);
 }
 
 template <typename T>
 arithmetic_gmw::SharePointer<T> SubtractionGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -446,13 +525,16 @@ MultiplicationGate<T>::MultiplicationGate(const arithmetic_gmw::WirePointer<T>&
 
   assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
 
-  d_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
-                                                                   a->GetNumberOfSimdValues());
-  e_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
-                                                                   a->GetNumberOfSimdValues());
-
-  d_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(d_);
-  e_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(e_);
+  auto& arithmetic_gmw_provider{backend_.GetArithmeticGmwProvider()};
+  const auto layer{GetRegister().ComputeLayer(GetParentWires())};
+  if (arithmetic_gmw_provider.GetOpeningBatching() && layer) {
+    opening_position_ = arithmetic_gmw_provider.AssignOpening(
+        *layer, sizeof(T) * 8, 2 * a->GetNumberOfSimdValues() * sizeof(T));
+  } else {
+    d_e_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
+        backend_, 2 * a->GetNumberOfSimdValues());
+    d_e_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(d_e_);
+  }
 
   output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
       backend_, a->GetNumberOfSimdValues())};
@@ -463,8 +545,8 @@ MultiplicationGate<T>::MultiplicationGate(const arithmetic_gmw::WirePointer<T>&
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                   parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::MultiplicationGate with following properties: {}", gate_info));
+  GetLogger().LogDebug(
+       "Created an arithmetic_gmw::MultiplicationGate with following properties: {}", gate_info);
 }
 
 template <typename T>
@@ -476,84 +558,59 @@ void MultiplicationGate<T>::EvaluateOnline() {
   parent_a_.at(0)->GetIsReadyCondition().Wait();
   parent_b_.at(0)->GetIsReadyCondition().Wait();
 
-  auto& mt_provider = GetMtProvider();
-  mt_provider.WaitFinished();
-  const auto& mts = mt_provider.template GetIntegerAll<T>();
-  {
-    const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-    assert(x);
-    d_->GetMutableValues() = std::vector<T>(
-        mts.a.begin() + mt_offset_, mts.a.begin() + mt_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ d_v = d_->GetMutableValues().data();
-    const T* __restrict__ x_v = x->GetValues().data();
-    const auto number_of_simd_values{x->GetNumberOfSimdValues()};
-
-    std::transform(x_v, x_v + number_of_simd_values, d_v, d_v,
-                   [](const T& a, const T& b) { return a + b; });
-    d_->SetOnlineFinished();
-
-    const auto y = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-    assert(y);
-    e_->GetMutableValues() = std::vector<T>(
-        mts.b.begin() + mt_offset_, mts.b.begin() + mt_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ e_v = e_->GetMutableValues().data();
-    const T* __restrict__ y_v = y->GetValues().data();
-    std::transform(y_v, y_v + number_of_simd_values, e_v, e_v,
-                   [](const T& a, const T& b) { return a + b; });
-    e_->SetOnlineFinished();
-  }
-
-  d_output_->WaitOnline();
-  e_output_->WaitOnline();
-
-  const auto& d_clear = d_output_->GetOutputWires().at(0);
-  const auto& e_clear = e_output_->GetOutputWires().at(0);
-
-  d_clear->GetIsReadyCondition().Wait();
-  e_clear->GetIsReadyCondition().Wait();
-
-  const auto d_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(d_clear);
+  const auto number_of_simd_values{parent_a_.at(0)->GetNumberOfSimdValues()};
+  // the masks are computed directly on the provider's memory, without copying the MTs
+  const auto mts{GetMtProvider().template GetIntegerSpan<T>(mt_offset_, number_of_simd_values)};
   const auto x_i_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-  const auto e_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(e_clear);
   const auto y_i_w = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-
-  assert(d_w);
   assert(x_i_w);
-  assert(e_w);
   assert(y_i_w);
 
+  // d and e are opened together
+  std::vector<T> d_e_shares(2 * number_of_simd_values);
+  std::span d_e_span(d_e_shares);
+  AddVectors<T>(x_i_w->GetValues(), mts.a, d_e_span.first(number_of_simd_values));
+  AddVectors<T>(y_i_w->GetValues(), mts.b, d_e_span.last(number_of_simd_values));
+
+  std::vector<T> d_e_values;
+  if (opening_position_) {
+    d_e_values = backend_.GetArithmeticGmwProvider().Open<T>(*opening_position_, d_e_shares);
+  } else {
+    d_e_->GetMutableValues() = std::move(d_e_shares);
+    d_e_->SetOnlineFinished();
+
+    d_e_output_->WaitOnline();
+    const auto d_e_clear = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(
+        d_e_output_->GetOutputWires().at(0));
+    assert(d_e_clear);
+    d_e_clear->GetIsReadyCondition().Wait();
+    d_e_values = d_e_clear->GetValues();
+  }
+
   auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(output);
-  output->GetMutableValues() =
-      std::vector<T>(mts.c.begin() + mt_offset_,
-                     mts.c.begin() + mt_offset_ + parent_a_.at(0)->GetNumberOfSimdValues());
-
-  const T* __restrict__ d{d_w->GetValues().data()};
-  const T* __restrict__ s_x{x_i_w->GetValues().data()};
-  const T* __restrict__ e{e_w->GetValues().data()};
-  const T* __restrict__ s_y{y_i_w->GetValues().data()};
-  T* __restrict__ output_pointer{output->GetMutableValues().data()};
+  auto& output_values{output->GetMutableValues()};
+  output_values.resize(number_of_simd_values);
 
+  const auto d{std::span<const T>(d_e_values).first(number_of_simd_values)};
+  const auto e{std::span<const T>(d_e_values).last(number_of_simd_values)};
+  // c + d * s_y + e * s_x, one party subtracts e * d, i.e., uses e * (s_x - d)
   if (GetCommunicationLayer().GetMyId() ==
       (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
-    for (auto i = 0ull; i < output->GetNumberOfSimdValues(); ++i) {
-      output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]) - (e[i] * d[i]);
-    }
+    SubVectors<T>(x_i_w->GetValues(), d, output_values);
+    MultiplyAddVectors<T>(d, y_i_w->GetValues(), e, output_values, mts.c, output_values);
   } else {
-    for (auto i = 0ull; i < output->GetNumberOfSimdValues(); ++i) {
-      output_pointer[i] += (d[i] * s_y[i]) + (e[i] * s_x[i]);
-    }
+    MultiplyAddVectors<T>(d, y_i_w->GetValues(), e, x_i_w->GetValues(), mts.c, output_values);
   }
 
-  GetLogger().LogDebug(
-      fmt::format("Evaluated arithmetic_gmw::MultiplicationGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::MultiplicationGate with id#{}", gate_id_);
 }
 
 template <typename T>
 arithmetic_gmw::SharePointer<T> MultiplicationGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -583,51 +640,71 @@ HybridMultiplicationGate<T>::HybridMultiplicationGate(const boolean_gmw::WirePoi
 
   for (std::size_t i = 0; i < number_of_parties; ++i) {
     if (i == my_id) continue;
-    ot_sender_ =
-        GetOtProvider(i).RegisterSendAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
-    ot_receiver_ =
-        GetOtProvider(i).RegisterReceiveAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
+    if (auto& ot_provider{GetOtProvider(i)}; ot_provider.HasRandomOtPool()) {
+      random_ot_pool_ = &ot_provider.GetRandomOtPool();
+      ReserveRandomOts();
+    } else {
+      ot_sender_ =
+          ot_provider.RegisterSendAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
+      ot_receiver_ =
+          ot_provider.RegisterReceiveAcOt(parent_a_[0]->GetNumberOfSimdValues(), sizeof(T) * 8);
+    }
+    corrections_future_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
+        i, communication::MessageType::kHybridMultiplicationGate, gate_id_);
   }
 
   auto gate_info =
       fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                   parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::HybridMultiplicationGate with following properties: {}",
-      gate_info));
+  GetLogger().LogDebug(
+       "Created an arithmetic_gmw::HybridMultiplicationGate with following properties: {}",
+      gate_info);
 }
 
 template <typename T>
-void HybridMultiplicationGate<T>::EvaluateSetup() {}
+void HybridMultiplicationGate<T>::ReserveRandomOts() {
+  // both parties create their gates in the same order, s.t. the reservations match even though
+  // the setup phases of the gates run concurrently
+  const auto number_of_simd_values{parent_a_.at(0)->GetNumberOfSimdValues()};
+  random_sender_ots_offset_ = random_ot_pool_->ReserveSenderOts(number_of_simd_values);
+  random_receiver_ots_offset_ = random_ot_pool_->ReserveReceiverOts(number_of_simd_values);
+}
 
 template <typename T>
-void HybridMultiplicationGate<T>::EvaluateOnline() {
-  // nothing to setup, no need to wait/check
-  parent_a_.at(0)->GetIsReadyCondition().Wait();
-  parent_b_.at(0)->GetIsReadyCondition().Wait();
-
-  const auto bw = std::dynamic_pointer_cast<boolean_gmw::Wire>(parent_a_.at(0));
-  assert(bw);
-  const auto aw = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-  assert(aw);
-
-  auto a_out = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-  assert(a_out);
-  a_out->GetMutableValues().reserve(aw->GetNumberOfSimdValues());
-
-  auto& bv = bw->GetValues();
-  auto& av = aw->GetValues();
+void HybridMultiplicationGate<T>::Clear() {
+  Gate::Clear();
+  // the OTs of the pool are used once, so the next run needs other ones
+  if (random_ot_pool_) ReserveRandomOts();
+}
 
-  std::vector<T> ot_data;
-  ot_data.reserve(bv.GetSize());
-  for (std::size_t i = 0; i != bv.GetSize(); ++i) {
-    // (-1)^<b>_i^B * <v>_i^A + r as AC-OT msgs for party i-1
-    ot_data.emplace_back(bv[i] ? -av[i] : av[i]);
-    // Locally calculate <b>_i^B * <v>_i^A
-    a_out->GetMutableValues().emplace_back(bv[i] ? av[i] : static_cast<T>(0));
+template <typename T>
+void HybridMultiplicationGate<T>::EvaluateSetup() {
+  const auto number_of_simd_values{parent_a_.at(0)->GetNumberOfSimdValues()};
+  if (random_ot_pool_) {
+    // the receiver's OTs first, since the other party's sender waits for them
+    const auto receiver_ots{random_ot_pool_->ObtainReceiverOts(random_receiver_ots_offset_,
+                                                               number_of_simd_values)};
+    const auto sender_ots{
+        random_ot_pool_->ObtainSenderOts(random_sender_ots_offset_, number_of_simd_values)};
+    auto to_value = [](const Block128& block) {
+      T value;
+      std::memcpy(&value, block.data(), sizeof(T));
+      return value;
+    };
+    random_choices_ = BitVector<>(receiver_ots.choices);
+    random_correlations_.resize(number_of_simd_values);
+    random_sender_outputs_.resize(number_of_simd_values);
+    random_receiver_outputs_.resize(number_of_simd_values);
+    for (std::size_t i = 0; i < number_of_simd_values; ++i) {
+      random_sender_outputs_[i] = to_value(sender_ots.messages_0.at(i));
+      random_correlations_[i] = to_value(sender_ots.messages_1.at(i)) - random_sender_outputs_[i];
+      random_receiver_outputs_[i] = to_value(receiver_ots.messages.at(i));
+    }
+    return;
   }
 
-  // AcOt Send and Recieve
+  random_choices_ = BitVector<>::SecureRandom(number_of_simd_values);
+  random_correlations_ = RandomVector<T>(number_of_simd_values);
 
   auto casted_ot_sender{dynamic_cast<AcOtSender<T>*>(ot_sender_.get())};
   auto casted_ot_receiver{dynamic_cast<AcOtReceiver<T>*>(ot_receiver_.get())};
@@ -635,34 +712,97 @@ void HybridMultiplicationGate<T>::EvaluateOnline() {
   assert(casted_ot_receiver);
 
   casted_ot_sender->WaitSetup();
-  casted_ot_sender->SetCorrelations(ot_data);
+  casted_ot_sender->SetCorrelations(random_correlations_);
   casted_ot_sender->SendMessages();
 
   casted_ot_receiver->WaitSetup();
-  casted_ot_receiver->SetChoices(bv);
+  casted_ot_receiver->SetChoices(random_choices_);
   casted_ot_receiver->SendCorrections();
 
   casted_ot_sender->ComputeOutputs();
   casted_ot_receiver->ComputeOutputs();
+  random_sender_outputs_ = casted_ot_sender->GetOutputs();
+  random_receiver_outputs_ = casted_ot_receiver->GetOutputs();
+}
+
+template <typename T>
+void HybridMultiplicationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
 
-  // parse OT outputs
-  std::vector<T> ot_sender_output{casted_ot_sender->GetOutputs()};
-  std::vector<T> ot_receiver_output{casted_ot_receiver->GetOutputs()};
+  const auto bw = std::dynamic_pointer_cast<boolean_gmw::Wire>(parent_a_.at(0));
+  assert(bw);
+  const auto aw = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(parent_b_.at(0));
+  assert(aw);
 
-  // Compute the result
-  for (std::size_t simd_i = 0; simd_i < parent_a_[0]->GetNumberOfSimdValues(); ++simd_i) {
-    a_out->GetMutableValues()[simd_i] += ot_receiver_output[simd_i] - ot_sender_output[simd_i];
+  auto a_out = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(a_out);
+
+  const auto number_of_simd_values{aw->GetNumberOfSimdValues()};
+  auto& bv = bw->GetValues();
+  auto& av = aw->GetValues();
+
+  // (-1)^<b>_i^B * <v>_i^A are the correlations of the OTs to the other party
+  std::vector<T> correlations;
+  correlations.reserve(number_of_simd_values);
+  for (std::size_t i = 0; i != number_of_simd_values; ++i) {
+    correlations.emplace_back(bv[i] ? -av[i] : av[i]);
   }
 
-  GetLogger().LogDebug(
-      fmt::format("Evaluated arithmetic_gmw::HybridMultiplicationGate with id#{}", gate_id_));
+  // send the choice corrections e directly followed by the correlation corrections f
+  const auto own_choice_corrections{bv ^ random_choices_};
+  const std::size_t choice_corrections_size{BitsToBytes(number_of_simd_values)};
+  {
+    std::vector<T> correlation_corrections(number_of_simd_values);
+    SubVectors<T>(correlations, random_correlations_, correlation_corrections);
+    std::vector<std::uint8_t> payload(choice_corrections_size +
+                                      number_of_simd_values * sizeof(T));
+    std::copy_n(reinterpret_cast<const std::uint8_t*>(own_choice_corrections.GetData().data()),
+                choice_corrections_size, payload.begin());
+    std::copy_n(reinterpret_cast<const std::uint8_t*>(correlation_corrections.data()),
+                number_of_simd_values * sizeof(T), payload.begin() + choice_corrections_size);
+    const std::size_t other_id{1 - GetCommunicationLayer().GetMyId()};
+    auto message{communication::BuildMessage(communication::MessageType::kHybridMultiplicationGate,
+                                             gate_id_, payload)};
+    GetCommunicationLayer().SendMessage(other_id, message.Release());
+  }
+
+  const auto message{corrections_future_.get()};
+  const auto payload{communication::GetMessage(message.data())->payload()};
+  assert(payload->size() == choice_corrections_size + number_of_simd_values * sizeof(T));
+  const BitVector<> other_choice_corrections(payload->data(), number_of_simd_values);
+  const auto other_correlation_corrections{FromByteVector<T>(
+      {payload->data() + choice_corrections_size, number_of_simd_values * sizeof(T)})};
+
+  // with the random OTs (c, delta) and the corrections e = b ^ c and f = corr - delta, the product
+  // b * corr = (1 - 2e) * c * corr + e * corr, where c * corr = c * delta + c * f and the OT
+  // outputs are shares of c * delta, i.e., the receiver's share is (1 - 2e) * (y + c * f) and the
+  // sender's share is -(1 - 2e) * x + e * corr
+  auto& output = a_out->GetMutableValues();
+  output.resize(number_of_simd_values);
+  for (std::size_t i = 0; i < number_of_simd_values; ++i) {
+    // locally calculate <b>_i^B * <v>_i^A
+    T value{bv[i] ? av[i] : static_cast<T>(0)};
+    // the OT in which this party chose its bit
+    T receiver_output{random_receiver_outputs_[i]};
+    if (random_choices_[i]) receiver_output += other_correlation_corrections[i];
+    value += own_choice_corrections[i] ? -receiver_output : receiver_output;
+    // the OT in which the other party chose its bit
+    T sender_output{random_sender_outputs_[i]};
+    if (other_choice_corrections[i]) sender_output = -sender_output - correlations[i];
+    value -= sender_output;
+    output[i] = value;
+  }
+
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::HybridMultiplicationGate with id#{}", gate_id_);
 }
 
 template <typename T>
 arithmetic_gmw::SharePointer<T> HybridMultiplicationGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -672,6 +812,253 @@ template class HybridMultiplicationGate<std::uint32_t>;
 template class HybridMultiplicationGate<std::uint64_t>;
 // template class HybridMultiplicationGate<__uint128_t>; not yet supported
 
+// adds the product of the m x k matrix a and the k x n matrix b in row-major order to the m x n
+// matrix output, where the loops are ordered s.t. the rows of b and output are traversed linearly
+template <typename T>
+static void MultiplyAddMatrices(std::span<const T> a, std::span<const T> b, std::span<T> output,
+                                std::size_t m, std::size_t k, std::size_t n) {
+  for (std::size_t row = 0; row < m; ++row) {
+    for (std::size_t inner = 0; inner < k; ++inner) {
+      const T a_entry{a[row * k + inner]};
+      const auto b_row{b.subspan(inner * n, n)};
+      auto output_row{output.subspan(row * n, n)};
+      for (std::size_t column = 0; column < n; ++column) {
+        output_row[column] += a_entry * b_row[column];
+      }
+    }
+  }
+}
+
+template <typename T>
+MatrixMultiplicationGate<T>::MatrixMultiplicationGate(std::vector<motion::WirePointer> matrix_a,
+                                                      std::vector<motion::WirePointer> matrix_b,
+                                                      std::size_t number_of_rows,
+                                                      std::size_t number_of_columns)
+    : TwoGate((assert(!matrix_a.empty()), matrix_a[0]->GetBackend())),
+      m_(number_of_rows),
+      k_(number_of_rows == 0 ? 0 : matrix_a.size() / number_of_rows),
+      n_(number_of_columns) {
+  if (m_ == 0 || n_ == 0 || m_ * k_ != matrix_a.size() || k_ * n_ != matrix_b.size()) {
+    throw std::invalid_argument(fmt::format(
+        "Cannot multiply a matrix of {} entries with {} rows by a matrix of {} entries with {} "
+        "columns",
+        matrix_a.size(), m_, matrix_b.size(), n_));
+  }
+  parent_a_ = std::move(matrix_a);
+  parent_b_ = std::move(matrix_b);
+
+  const auto number_of_simd_values{parent_a_[0]->GetNumberOfSimdValues()};
+  for (const auto& wire : parent_a_) assert(wire->GetNumberOfSimdValues() == number_of_simd_values);
+  for (const auto& wire : parent_b_) assert(wire->GetNumberOfSimdValues() == number_of_simd_values);
+
+  const std::size_t number_of_masked_values{(m_ * k_ + k_ * n_) * number_of_simd_values};
+  auto& arithmetic_gmw_provider{backend_.GetArithmeticGmwProvider()};
+  const auto layer{GetRegister().ComputeLayer(GetParentWires())};
+  if (arithmetic_gmw_provider.GetOpeningBatching() && layer) {
+    opening_position_ = arithmetic_gmw_provider.AssignOpening(*layer, sizeof(T) * 8,
+                                                              number_of_masked_values * sizeof(T));
+  } else {
+    d_e_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
+                                                                       number_of_masked_values);
+    d_e_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(d_e_);
+  }
+
+  output_wires_.reserve(m_ * n_);
+  for (std::size_t entry = 0; entry < m_ * n_; ++entry) {
+    output_wires_.emplace_back(GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
+        backend_, number_of_simd_values));
+  }
+
+  // one OT per bit of each entry of A, which transfers a row of B
+  const std::size_t number_of_ots{number_of_simd_values * m_ * k_ * sizeof(T) * 8};
+  const std::size_t number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+  const std::size_t my_id{GetCommunicationLayer().GetMyId()};
+  ot_senders_.resize(number_of_parties);
+  ot_receivers_.resize(number_of_parties);
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    if (i == my_id) continue;
+    ot_senders_[i] = GetOtProvider(i).RegisterSendAcOt(number_of_ots, sizeof(T) * 8, n_);
+    ot_receivers_[i] = GetOtProvider(i).RegisterReceiveAcOt(number_of_ots, sizeof(T) * 8, n_);
+  }
+
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, dimensions: {}x{} * {}x{}",
+                               sizeof(T) * 8, gate_id_, m_, k_, k_, n_);
+  GetLogger().LogDebug(
+       "Created an arithmetic_gmw::MatrixMultiplicationGate with following properties: {}",
+      gate_info);
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateSetup() {
+  constexpr std::size_t kBitSize{sizeof(T) * 8};
+  const auto number_of_simd_values{parent_a_[0]->GetNumberOfSimdValues()};
+  const std::size_t number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+  const std::size_t my_id{GetCommunicationLayer().GetMyId()};
+
+  a_ = RandomVector<T>(number_of_simd_values * m_ * k_);
+  b_ = RandomVector<T>(number_of_simd_values * k_ * n_);
+  c_.assign(number_of_simd_values * m_ * n_, 0);
+  for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+    MultiplyAddMatrices<T>(std::span<const T>(a_).subspan(simd_i * m_ * k_, m_ * k_),
+                           std::span<const T>(b_).subspan(simd_i * k_ * n_, k_ * n_),
+                           std::span(c_).subspan(simd_i * m_ * n_, m_ * n_), m_, k_, n_);
+  }
+
+  // the OT of bit j of entry (row, inner) of A correlates row inner of B shifted by j, s.t. the
+  // outputs of the OTs of a row of A sum up to shares of the cross term A_i * B_j of the row
+  std::vector<T> correlations;
+  correlations.reserve(number_of_simd_values * m_ * k_ * kBitSize * n_);
+  BitVector<> choices;
+  choices.Reserve(number_of_simd_values * m_ * k_ * kBitSize);
+  for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+    for (std::size_t row = 0; row < m_; ++row) {
+      for (std::size_t inner = 0; inner < k_; ++inner) {
+        const T a_entry{a_[(simd_i * m_ + row) * k_ + inner]};
+        const auto b_row{std::span<const T>(b_).subspan((simd_i * k_ + inner) * n_, n_)};
+        for (std::size_t bit_i = 0; bit_i < kBitSize; ++bit_i) {
+          for (const T b_entry : b_row) correlations.emplace_back(b_entry << bit_i);
+          choices.Append(((a_entry >> bit_i) & 1u) == 1);
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    if (i == my_id) continue;
+    auto ot_sender{dynamic_cast<AcOtSender<T>*>(ot_senders_[i].get())};
+    auto ot_receiver{dynamic_cast<AcOtReceiver<T>*>(ot_receivers_[i].get())};
+    assert(ot_sender);
+    assert(ot_receiver);
+    ot_sender->WaitSetup();
+    ot_sender->SetCorrelations(correlations);
+    ot_sender->SendMessages();
+    ot_receiver->WaitSetup();
+    ot_receiver->SetChoices(choices);
+    ot_receiver->SendCorrections();
+  }
+
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    if (i == my_id) continue;
+    auto ot_sender{dynamic_cast<AcOtSender<T>*>(ot_senders_[i].get())};
+    auto ot_receiver{dynamic_cast<AcOtReceiver<T>*>(ot_receivers_[i].get())};
+    ot_sender->ComputeOutputs();
+    ot_receiver->ComputeOutputs();
+    const auto& sender_outputs{ot_sender->GetOutputs()};
+    const auto& receiver_outputs{ot_receiver->GetOutputs()};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+      for (std::size_t row = 0; row < m_; ++row) {
+        auto c_row{std::span(c_).subspan((simd_i * m_ + row) * n_, n_)};
+        const std::size_t first_ot{(simd_i * m_ + row) * k_ * kBitSize};
+        for (std::size_t ot_i = first_ot; ot_i < first_ot + k_ * kBitSize; ++ot_i) {
+          for (std::size_t column = 0; column < n_; ++column) {
+            c_row[column] +=
+                receiver_outputs[ot_i * n_ + column] - sender_outputs[ot_i * n_ + column];
+          }
+        }
+      }
+    }
+    ot_senders_[i].reset();
+    ot_receivers_[i].reset();
+  }
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  for (const auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  for (const auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
+
+  const auto number_of_simd_values{parent_a_[0]->GetNumberOfSimdValues()};
+  const std::size_t size_a{m_ * k_}, size_b{k_ * n_}, size_c{m_ * n_};
+  auto get_value{[this](const std::vector<motion::WirePointer>& wires, std::size_t entry,
+                        std::size_t simd_i) {
+    const auto wire{std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(wires[entry])};
+    assert(wire);
+    return wire->GetValues()[simd_i];
+  }};
+
+  // d = X - A for all SIMD values is directly followed by e = Y - B, the entries of each SIMD value
+  // are in row-major order
+  std::vector<T> d_e_shares((size_a + size_b) * number_of_simd_values);
+  const std::span d_shares{std::span(d_e_shares).first(size_a * number_of_simd_values)};
+  const std::span e_shares{std::span(d_e_shares).last(size_b * number_of_simd_values)};
+  for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+    for (std::size_t entry = 0; entry < size_a; ++entry) {
+      d_shares[simd_i * size_a + entry] =
+          get_value(parent_a_, entry, simd_i) - a_[simd_i * size_a + entry];
+    }
+    for (std::size_t entry = 0; entry < size_b; ++entry) {
+      e_shares[simd_i * size_b + entry] =
+          get_value(parent_b_, entry, simd_i) - b_[simd_i * size_b + entry];
+    }
+  }
+
+  std::vector<T> d_e_values;
+  if (opening_position_) {
+    d_e_values = backend_.GetArithmeticGmwProvider().Open<T>(*opening_position_, d_e_shares);
+  } else {
+    d_e_->GetMutableValues() = std::move(d_e_shares);
+    d_e_->SetOnlineFinished();
+
+    d_e_output_->WaitOnline();
+    const auto d_e_clear = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(
+        d_e_output_->GetOutputWires().at(0));
+    assert(d_e_clear);
+    d_e_clear->GetIsReadyCondition().Wait();
+    d_e_values = d_e_clear->GetValues();
+  }
+  const std::span<const T> d{std::span<const T>(d_e_values).first(size_a * number_of_simd_values)};
+  const std::span<const T> e{std::span<const T>(d_e_values).last(size_b * number_of_simd_values)};
+
+  // X * Y = (D + A) * (E + B) = C + D * B + A * E + D * E, where one party adds D * E, i.e.,
+  // computes D * (B + E) instead of D * B
+  const bool adds_d_e{GetCommunicationLayer().GetMyId() ==
+                      (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  std::vector<T> b_or_b_plus_e(b_);
+  if (adds_d_e) AddVectors<T>(b_, e, b_or_b_plus_e);
+  std::vector<T> z(c_);
+  for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+    const auto z_i{std::span(z).subspan(simd_i * size_c, size_c)};
+    MultiplyAddMatrices<T>(d.subspan(simd_i * size_a, size_a),
+                           std::span<const T>(b_or_b_plus_e).subspan(simd_i * size_b, size_b), z_i,
+                           m_, k_, n_);
+    MultiplyAddMatrices<T>(std::span<const T>(a_).subspan(simd_i * size_a, size_a),
+                           e.subspan(simd_i * size_b, size_b), z_i, m_, k_, n_);
+  }
+
+  for (std::size_t entry = 0; entry < size_c; ++entry) {
+    auto output{std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_[entry])};
+    assert(output);
+    auto& output_values{output->GetMutableValues()};
+    output_values.resize(number_of_simd_values);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd_values; ++simd_i) {
+      output_values[simd_i] = z[simd_i * size_c + entry];
+    }
+  }
+
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::MatrixMultiplicationGate with id#{}", gate_id_);
+}
+
+template <typename T>
+std::vector<arithmetic_gmw::SharePointer<T>>
+MatrixMultiplicationGate<T>::GetOutputsAsArithmeticShares() {
+  std::vector<arithmetic_gmw::SharePointer<T>> result;
+  result.reserve(output_wires_.size());
+  for (const auto& wire : output_wires_) {
+    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(wire);
+    assert(arithmetic_wire);
+    result.emplace_back(
+        backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire));
+  }
+  return result;
+}
+
+template class MatrixMultiplicationGate<std::uint8_t>;
+template class MatrixMultiplicationGate<std::uint16_t>;
+template class MatrixMultiplicationGate<std::uint32_t>;
+template class MatrixMultiplicationGate<std::uint64_t>;
+// template class MatrixMultiplicationGate<__uint128_t>; not yet supported
+
 template <typename T>
 SquareGate<T>::SquareGate(const arithmetic_gmw::WirePointer<T>& a) : OneGate(a->GetBackend()) {
   parent_ = {std::static_pointer_cast<motion::Wire>(a)};
@@ -688,8 +1075,8 @@ SquareGate<T>::SquareGate(const arithmetic_gmw::WirePointer<T>& a) : OneGate(a->
 
   auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}", sizeof(T) * 8, gate_id_,
                                parent_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::SquareGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Created an arithmetic_gmw::SquareGate with following properties: {}",
+                       gate_info);
 }
 
 template <typename T>
@@ -706,13 +1093,10 @@ void SquareGate<T>::EvaluateOnline() {
   {
     const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
     assert(x);
-    d_->GetMutableValues() = std::vector<T>(
-        sps.a.begin() + sp_offset_, sps.a.begin() + sp_offset_ + x->GetNumberOfSimdValues());
-    T* __restrict__ d_v{d_->GetMutableValues().data()};
-    const T* __restrict__ x_v{x->GetValues().data()};
     const auto number_of_simd_values{x->GetNumberOfSimdValues()};
-    std::transform(x_v, x_v + number_of_simd_values, d_v, d_v,
-                   [](const T& a, const T& b) { return a + b; });
+    d_->GetMutableValues().resize(number_of_simd_values);
+    AddVectors<T>(x->GetValues(), std::span(sps.a).subspan(sp_offset_, number_of_simd_values),
+                  d_->GetMutableValues());
     d_->SetOnlineFinished();
   }
 
@@ -748,14 +1132,14 @@ void SquareGate<T>::EvaluateOnline() {
     }
   }
 
-  GetLogger().LogDebug(fmt::format("Evaluated arithmetic_gmw::SquareGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::SquareGate with id#{}", gate_id_);
 }
 
 template <typename T>
 arithmetic_gmw::SharePointer<T> SquareGate<T>::GetOutputAsArithmeticShare() {
   auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
   assert(arithmetic_wire);
-  auto result = std::make_shared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
   return result;
 }
 
@@ -766,122 +1150,443 @@ template class SquareGate<std::uint64_t>;
 template class SquareGate<__uint128_t>;
 
 template <typename T>
-GreaterThanGate<T>::GreaterThanGate(arithmetic_gmw::WirePointer<T>& a,
-                                    arithmetic_gmw::WirePointer<T>& b, std::size_t l_s)
-    : TwoGate(a->GetBackend()), chunk_bit_length_(l_s) {
-  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
-  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
+TruncationGate<T>::TruncationGate(const arithmetic_gmw::WirePointer<T>& a,
+                                  std::size_t number_of_truncated_bits)
+    : OneGate(a->GetBackend()), number_of_truncated_bits_(number_of_truncated_bits) {
+  constexpr auto kBitSize{sizeof(T) * 8};
+  if (number_of_truncated_bits_ + 2 > kBitSize) {
+    throw std::invalid_argument(fmt::format(
+        "Cannot truncate {} bits of uint{}_t values", number_of_truncated_bits_, kBitSize));
+  }
+  parent_ = {std::static_pointer_cast<motion::Wire>(a)};
 
-  assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
+  c_ = GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(backend_,
+                                                                   a->GetNumberOfSimdValues());
+  c_output_ = GetRegister().template EmplaceGate<OutputGate<T>>(c_);
 
-  // the plaintext numbers have to be smaller than 2^{bit_length - 1}
-  assert(parent_a_.at(0)->GetBitLength() == parent_b_.at(0)->GetBitLength());
-  auto bit_length = parent_a_.at(0)->GetBitLength();
+  output_wires_ = {GetRegister().template EmplaceWire<arithmetic_gmw::Wire<T>>(
+      backend_, a->GetNumberOfSimdValues())};
 
-  const auto& communication_layer = GetCommunicationLayer();
-  number_of_parties_ = communication_layer.GetNumberOfParties();
-  number_of_simd_ = parent_a_.at(0)->GetNumberOfSimdValues();
-  my_id_ = communication_layer.GetMyId();
+  // one shared bit per bit of the mask
+  number_of_sbs_ = kBitSize * a->GetNumberOfSimdValues();
+  sb_offset_ = GetSbProvider().template RequestSbs<T>(number_of_sbs_);
 
-  output_wires_ = {
-      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}, truncated bits: {}",
+                                 kBitSize, gate_id_, parent_.at(0)->GetWireId(),
+                                 number_of_truncated_bits_);
+    GetLogger().LogDebug("Created an arithmetic_gmw::TruncationGate with following properties: {}",
+                         gate_info);
+  }
+}
 
-  auto number_of_intermediate_iterations = 0u;  // how many times while-loop will run
-  auto ot_bit_length = chunk_bit_length_ - 1;
-  if (my_id_ == 0) {
-    // register party 0 as receiver for 1ooN-OT
-    if (bit_length > chunk_bit_length_) {
-      number_of_intermediate_iterations = std::ceil(
-          static_cast<float>(bit_length - 1 - chunk_bit_length_) / (chunk_bit_length_ - 1));
-      ot_1oon_receiver_.push_back(
-          GetKk13OtProvider(1).RegisterReceiveGOtBit(number_of_simd_, pow(2, chunk_bit_length_)));
+template <typename T>
+void TruncationGate<T>::EvaluateSetup() {}
+
+template <typename T>
+void TruncationGate<T>::EvaluateOnline() {
+  constexpr auto kBitSize{sizeof(T) * 8};
+  const auto m{number_of_truncated_bits_};
+  const bool is_first_party{GetCommunicationLayer().GetMyId() == 0};
+
+  parent_.at(0)->GetIsReadyCondition().Wait();
+
+  auto& sb_provider = GetSbProvider();
+  sb_provider.WaitFinished();
+  const auto& sbs = sb_provider.template GetSbsAll<T>();
+
+  const auto number_of_simd_values{parent_.at(0)->GetNumberOfSimdValues()};
+  // the mask of the j-th value is r = sum_i 2^i * sbs[sb_offset_ + i * number_of_simd + j]
+  auto shared_bit = [&sbs, this, number_of_simd_values](std::size_t i, std::size_t j) {
+    return sbs.at(sb_offset_ + i * number_of_simd_values + j);
+  };
+
+  // c = x + 2^(l-2) + r, where the offset makes the masked value non-negative
+  const auto x = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
+  assert(x);
+  auto& c_values{c_->GetMutableValues()};
+  c_values.resize(number_of_simd_values);
+  for (std::size_t j = 0; j < number_of_simd_values; ++j) {
+    T r{0};
+    for (std::size_t i = 0; i < kBitSize; ++i) {
+      r += T(shared_bit(i, j) << i);
     }
+    c_values[j] = x->GetValues()[j] + r;
+    if (is_first_party) c_values[j] += T(1) << (kBitSize - 2);
+  }
+  c_->SetOnlineFinished();
 
-    for (auto i = 0u; i < number_of_intermediate_iterations; i++) {
-      // number of messages of the last iterations
-      if (i == number_of_intermediate_iterations - 1) {
-        ot_bit_length =
-            bit_length - 2 - number_of_intermediate_iterations * (chunk_bit_length_ - 1);
-      }
-      ot_1oon_receiver_.push_back(
-          GetKk13OtProvider(1).RegisterReceiveGOtBit(number_of_simd_, 2 * pow(2, ot_bit_length)));
+  c_output_->WaitOnline();
+  const auto c_clear =
+      std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(c_output_->GetOutputWires().at(0));
+  assert(c_clear);
+  c_clear->GetIsReadyCondition().Wait();
+
+  // with y = x + 2^(l-2) < 2^(l-1), c' = c mod 2^(l-1), r' = r mod 2^(l-1) and the carry
+  // u = c_(l-1) xor r_(l-1) into the most significant bit, y = c' - r' + 2^(l-1) * u, so
+  // y >> m = (c' >> m) - (r' >> m) + 2^(l-1-m) * u up to the borrow of the lower m bits
+  auto output = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(output);
+  auto& output_values{output->GetMutableValues()};
+  output_values.resize(number_of_simd_values);
+  constexpr T kLowerBitsMask{(T(1) << (kBitSize - 1)) - 1};
+  for (std::size_t j = 0; j < number_of_simd_values; ++j) {
+    const T c{c_clear->GetValues()[j]};
+    const T c_msb{T(c >> (kBitSize - 1))};
+    T result{0};
+    for (std::size_t i = m; i + 1 < kBitSize; ++i) {
+      result -= T(shared_bit(i, j) << (i - m));
     }
-  } else {
-    // register party 1 as sender for 1ooN-OT
-    if (bit_length > chunk_bit_length_) {
-      number_of_intermediate_iterations = std::ceil(
-          static_cast<float>(bit_length - 1 - chunk_bit_length_) / (chunk_bit_length_ - 1));
-      ot_1oon_sender_.push_back(
-          GetKk13OtProvider(0).RegisterSendGOtBit(number_of_simd_, pow(2, chunk_bit_length_)));
+    // u = c_(l-1) + r_(l-1) - 2 * c_(l-1) * r_(l-1)
+    const T u{T(T(1 - 2 * c_msb) * shared_bit(kBitSize - 1, j))};
+    result += T(u << (kBitSize - 1 - m));
+    if (is_first_party) {
+      result += T(T(c & kLowerBitsMask) >> m);
+      result += T(c_msb << (kBitSize - 1 - m));
+      result -= T(T(1) << (kBitSize - 2 - m));
+    }
+    output_values[j] = result;
+  }
+
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::TruncationGate with id#{}", gate_id_);
+}
+
+template <typename T>
+arithmetic_gmw::SharePointer<T> TruncationGate<T>::GetOutputAsArithmeticShare() {
+  auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+  assert(arithmetic_wire);
+  auto result = backend_.GetRegister()->EmplaceShared<arithmetic_gmw::Share<T>>(arithmetic_wire);
+  return result;
+}
+
+template class TruncationGate<std::uint8_t>;
+template class TruncationGate<std::uint16_t>;
+template class TruncationGate<std::uint32_t>;
+template class TruncationGate<std::uint64_t>;
+
+namespace {
+
+// expands a message of a random OT to one bit per message of a 1-out-of-number_of_messages OT
+BitVector<> ExpandRandomOtMessage(const Block128& message, std::size_t number_of_messages) {
+  primitives::Prg prg;
+  prg.SetKey(message.data());
+  return BitVector<>(prg.Encrypt(BitsToBytes(number_of_messages)), number_of_messages);
+}
+
+// estimated costs of GreaterThanGate besides the network
+// synchronization of the parties' fibers in each round of OTs
+constexpr double kGreaterThanTimePerRound{20e-6};
+// extension, transposition and hashing of the column of one KK13 OT
+constexpr double kGreaterThanTimePerOt{100e-9};
+// hashing and masking of one message of a KK13 OT
+constexpr double kGreaterThanTimePerMessage{5e-9};
+
+// returns the numbers of messages of the 1ooN-OTs of GreaterThanGate in the order they are run:
+// the first chunk of l_s bits and then chunks of l_s - 1 bits doubled by the previous carry, the
+// most significant bit is not compared
+std::vector<std::size_t> GetGreaterThanOtMessages(std::size_t bit_length, std::size_t l_s) {
+  std::vector<std::size_t> number_of_messages{std::size_t(1) << l_s};
+  for (std::size_t bit_length_last = l_s; bit_length_last < bit_length - 1;) {
+    const auto bit_length_difference{std::min(l_s - 1, bit_length - bit_length_last - 1)};
+    number_of_messages.emplace_back(std::size_t(2) << bit_length_difference);
+    bit_length_last += bit_length_difference;
+  }
+  return number_of_messages;
+}
+
+}  // namespace
+
+std::size_t SelectGreaterThanChunkBitLength(std::size_t bit_length, std::size_t number_of_simd,
+                                            std::chrono::microseconds round_trip_time,
+                                            double bandwidth) {
+  if (bit_length < 3) {
+    throw std::invalid_argument(
+        fmt::format("GreaterThanGate needs a bit length of at least 3 but got {}", bit_length));
+  }
+  const std::size_t max_chunk_bit_length{std::min(kMaxGreaterThanChunkBitLength, bit_length - 1)};
+  const double round_trip_seconds{std::chrono::duration<double>(round_trip_time).count()};
+
+  std::size_t best_chunk_bit_length{2};
+  double best_time{std::numeric_limits<double>::infinity()};
+  for (std::size_t l_s = 2; l_s <= max_chunk_bit_length; ++l_s) {
+    const auto number_of_messages{GetGreaterThanOtMessages(bit_length, l_s)};
+    const std::size_t number_of_ots{number_of_messages.size()};
+    std::size_t total_messages{0};
+    for (const auto n : number_of_messages) total_messages += n;
+    // each OT takes a round trip of the receiver's correction and the sender's messages
+    double time{number_of_ots * (round_trip_seconds + kGreaterThanTimePerRound)};
+    time += number_of_simd *
+            (number_of_ots * kGreaterThanTimePerOt + total_messages * kGreaterThanTimePerMessage);
+    if (bandwidth > 0) {
+      // the sender's one-bit messages, the receiver's 8-bit corrections and 256-bit matrix columns
+      time += number_of_simd * (total_messages + number_of_ots * (8 + 256)) / bandwidth;
     }
+    if (time < best_time) {
+      best_time = time;
+      best_chunk_bit_length = l_s;
+    }
+  }
+  return best_chunk_bit_length;
+}
 
-    for (auto i = 0u; i < number_of_intermediate_iterations; i++) {
-      // number of messages of the last iterations
-      if (i == number_of_intermediate_iterations - 1) {
-        ot_bit_length =
-            bit_length - 2 - number_of_intermediate_iterations * (chunk_bit_length_ - 1);
+template <typename T>
+MostSignificantBitExtraction<T>::MostSignificantBitExtraction(Backend& backend,
+                                                              std::size_t gate_id,
+                                                              std::size_t number_of_values,
+                                                              std::size_t l_s)
+    : communication_layer_(backend.GetCommunicationLayer()),
+      gate_id_(gate_id),
+      number_of_values_(number_of_values),
+      chunk_bit_length_(l_s),
+      random_ots_(backend.GetArithmeticGmwProvider().GetRandomComparisonOts()) {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  if (chunk_bit_length_ < 2 ||
+      chunk_bit_length_ > std::min(kMaxGreaterThanChunkBitLength, kBitLength - 1)) {
+    throw std::invalid_argument(
+        fmt::format("The chunk bit length of GreaterThanGate must be in [2, {}] but is {}",
+                    std::min(kMaxGreaterThanChunkBitLength, kBitLength - 1), chunk_bit_length_));
+  }
+
+  if (communication_layer_.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("The OT-based arithmetic GMW comparisons need 2 parties but there are {}",
+                    communication_layer_.GetNumberOfParties()));
+  }
+  my_id_ = communication_layer_.GetMyId();
+  if (auto& ot_provider{backend.GetOtProvider(1 - my_id_)}; ot_provider.HasRandomOtPool()) {
+    random_ot_pool_ = &ot_provider.GetRandomOtPool();
+    random_ots_ = true;
+  }
+
+  number_of_messages_ = GetGreaterThanOtMessages(kBitLength, chunk_bit_length_);
+  auto& message_manager = communication_layer_.GetMessageManager();
+  for (std::size_t ot_index = 0; ot_index < number_of_messages_.size(); ++ot_index) {
+    const auto number_of_messages{number_of_messages_[ot_index]};
+    if (random_ots_) {
+      if (my_id_ == 0) {
+        if (!random_ot_pool_) {
+          random_ot_receivers_.push_back(backend.GetKk13OtProvider(1).RegisterReceiveROt(
+              number_of_values_, 1, number_of_messages));
+        }
+        message_futures_.push_back(message_manager.RegisterReceive(
+            1, communication::MessageType::kMsbExtractionMessages, GetMessageId(ot_index)));
+      } else {
+        if (!random_ot_pool_) {
+          random_ot_senders_.push_back(backend.GetKk13OtProvider(0).RegisterSendROt(
+              number_of_values_, 1, number_of_messages));
+        }
+        message_futures_.push_back(message_manager.RegisterReceive(
+            0, communication::MessageType::kMsbExtractionOffsets, GetMessageId(ot_index)));
       }
+    } else if (my_id_ == 0) {
+      // register party 0 as receiver for 1ooN-OT
+      ot_1oon_receiver_.push_back(backend.GetKk13OtProvider(1).RegisterReceiveGOtBit(
+          number_of_values_, number_of_messages));
+    } else {
+      // register party 1 as sender for 1ooN-OT
       ot_1oon_sender_.push_back(
-          GetKk13OtProvider(0).RegisterSendGOtBit(number_of_simd_, 2 * pow(2, ot_bit_length)));
+          backend.GetKk13OtProvider(0).RegisterSendGOtBit(number_of_values_, number_of_messages));
     }
   }
+  if (random_ot_pool_) ReserveRandomOts();
+}
 
-  auto gate_info =
-      fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
-                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-  GetLogger().LogDebug(fmt::format(
-      "Created an arithmetic_gmw::GreaterThanGate with following properties: {}", gate_info));
+template <typename T>
+void MostSignificantBitExtraction<T>::ReserveRandomOts() {
+  // both parties create their gates in the same order, s.t. the reservations match even though
+  // the setup phases of the gates run concurrently
+  random_ot_pool_offsets_.clear();
+  for (const auto number_of_messages : number_of_messages_) {
+    const std::size_t number_of_ots{number_of_values_ *
+                                    static_cast<std::size_t>(std::countr_zero(number_of_messages))};
+    random_ot_pool_offsets_.push_back(my_id_ == 0
+                                          ? random_ot_pool_->ReserveReceiverOts(number_of_ots)
+                                          : random_ot_pool_->ReserveSenderOts(number_of_ots));
+  }
 }
 
 template <typename T>
-void GreaterThanGate<T>::RunSender1ooNOt(encrypto::motion::BitVector<> messages,
-                                         std::size_t ot_index) {
-  ot_1oon_sender_[ot_index]->WaitSetup();
+void MostSignificantBitExtraction<T>::Clear() {
+  // the OTs of the pool are used once, so the next run needs other ones
+  if (random_ot_pool_) ReserveRandomOts();
+}
+
+template <typename T>
+void MostSignificantBitExtraction<T>::SetupFromRandomOtPool() {
+  for (std::size_t ot_index = 0; ot_index < number_of_messages_.size(); ++ot_index) {
+    const auto number_of_messages{number_of_messages_[ot_index]};
+    const std::size_t number_of_bits{
+        static_cast<std::size_t>(std::countr_zero(number_of_messages))};
+    const std::size_t number_of_ots{number_of_values_ * number_of_bits};
+    if (my_id_ == 0) {
+      const auto ots{
+          random_ot_pool_->ObtainReceiverOts(random_ot_pool_offsets_[ot_index], number_of_ots)};
+      std::vector<std::uint8_t> choices(number_of_values_);
+      BitVector<> masks(number_of_values_);
+      for (std::size_t i = 0; i < number_of_values_; ++i) {
+        std::size_t choice{0};
+        for (std::size_t j = 0; j < number_of_bits; ++j) {
+          if (ots.choices.Get(i * number_of_bits + j)) choice |= std::size_t(1) << j;
+        }
+        bool mask{false};
+        for (std::size_t j = 0; j < number_of_bits; ++j) {
+          mask ^= ExpandRandomOtMessage(ots.messages.at(i * number_of_bits + j), number_of_messages)
+                      .Get(choice);
+        }
+        choices[i] = static_cast<std::uint8_t>(choice);
+        masks.Set(mask, i);
+      }
+      random_choices_.push_back(std::move(choices));
+      random_masks_.push_back(std::move(masks));
+    } else {
+      const auto ots{
+          random_ot_pool_->ObtainSenderOts(random_ot_pool_offsets_[ot_index], number_of_ots)};
+      BitVector<> masks(number_of_values_ * number_of_messages);
+      std::vector<BitVector<>> expanded_messages(2 * number_of_bits);
+      for (std::size_t i = 0; i < number_of_values_; ++i) {
+        for (std::size_t j = 0; j < number_of_bits; ++j) {
+          const auto ot{i * number_of_bits + j};
+          expanded_messages[2 * j] =
+              ExpandRandomOtMessage(ots.messages_0.at(ot), number_of_messages);
+          expanded_messages[2 * j + 1] =
+              ExpandRandomOtMessage(ots.messages_1.at(ot), number_of_messages);
+        }
+        for (std::size_t x = 0; x < number_of_messages; ++x) {
+          bool mask{false};
+          for (std::size_t j = 0; j < number_of_bits; ++j) {
+            mask ^= expanded_messages[2 * j + ((x >> j) & 1)].Get(x);
+          }
+          masks.Set(mask, number_of_messages * i + x);
+        }
+      }
+      random_masks_.push_back(std::move(masks));
+    }
+  }
+}
+
+template <typename T>
+void MostSignificantBitExtraction<T>::Setup() {
+  if (!random_ots_) return;
+
+  // the outputs of the last run are replaced
+  random_choices_.clear();
+  random_masks_.clear();
+  if (random_ot_pool_) {
+    SetupFromRandomOtPool();
+    return;
+  }
 
-  ot_1oon_sender_[ot_index]->SetInputs(messages);
-  ot_1oon_sender_[ot_index]->SendMessages();
+  if (my_id_ == 0) {
+    for (auto& ot_receiver : random_ot_receivers_) {
+      ot_receiver->ComputeOutputs();
+      random_choices_.push_back(ot_receiver->GetChoices());
+      BitVector<> masks;
+      masks.Reserve(number_of_values_);
+      for (const auto& output : ot_receiver->GetOutputs()) masks.Append(output);
+      random_masks_.push_back(std::move(masks));
+    }
+  } else {
+    for (std::size_t ot_index = 0; ot_index < random_ot_senders_.size(); ++ot_index) {
+      auto& ot_sender = random_ot_senders_[ot_index];
+      ot_sender->ComputeOutputs();
+      BitVector<> masks;
+      masks.Reserve(number_of_values_ * number_of_messages_[ot_index]);
+      for (const auto& output : ot_sender->GetOutputs()) masks.Append(output);
+      random_masks_.push_back(std::move(masks));
+    }
+  }
 }
 
 template <typename T>
-BitVector<> GreaterThanGate<T>::RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index,
-                                               std::size_t ot_index) {
-  ot_1oon_receiver_[ot_index]->WaitSetup();
+void MostSignificantBitExtraction<T>::RunSender1ooNOt(encrypto::motion::BitVector<> messages,
+                                                      std::size_t ot_index) {
+  if (!random_ots_) {
+    ot_1oon_sender_[ot_index]->WaitSetup();
+
+    ot_1oon_sender_[ot_index]->SetInputs(messages);
+    ot_1oon_sender_[ot_index]->SendMessages();
+    return;
+  }
 
-  ot_1oon_receiver_[ot_index]->SetChoices(selection_index);
-  ot_1oon_receiver_[ot_index]->SendCorrections();
+  const auto number_of_messages{number_of_messages_[ot_index]};
+  const auto& masks{random_masks_[ot_index]};
+  const auto offsets_message{message_futures_[ot_index].get()};
+  const auto payload{communication::GetMessage(offsets_message.data())->payload()};
+  assert(payload->size() == number_of_values_);
+  const auto offsets{payload->data()};
+
+  // rotate the messages by the receiver's offsets and mask them with the random OT masks, such
+  // that the receiver unmasks the message of its choice at the position of its random choice
+  BitVector<> masked_messages(number_of_values_ * number_of_messages);
+  for (std::size_t i = 0; i < number_of_values_; ++i) {
+    const std::size_t offset{offsets[i]};
+    for (std::size_t j = 0; j < number_of_messages; ++j) {
+      const auto position{number_of_messages * i + j};
+      masked_messages.Set(
+          messages.Get(number_of_messages * i + (j + offset) % number_of_messages) !=
+              masks.Get(position),
+          position);
+    }
+  }
 
-  ot_1oon_receiver_[ot_index]->ComputeOutputs();
-  return ot_1oon_receiver_[ot_index]->GetOutputs();
+  auto message{communication::BuildMessage(
+      communication::MessageType::kMsbExtractionMessages, GetMessageId(ot_index),
+      std::span(reinterpret_cast<const std::uint8_t*>(masked_messages.GetData().data()),
+                masked_messages.GetData().size()))};
+  communication_layer_.SendMessage(0, message.Release());
 }
 
 template <typename T>
-void GreaterThanGate<T>::EvaluateOnline() {
-  WaitSetup();
-  assert(setup_is_ready_);
+BitVector<> MostSignificantBitExtraction<T>::RunReceiver1ooNOt(
+    std::vector<std::uint8_t> selection_index, std::size_t ot_index) {
+  if (!random_ots_) {
+    ot_1oon_receiver_[ot_index]->WaitSetup();
 
-  parent_a_.at(0)->GetIsReadyCondition().Wait();
-  parent_b_.at(0)->GetIsReadyCondition().Wait();
+    ot_1oon_receiver_[ot_index]->SetChoices(selection_index);
+    ot_1oon_receiver_[ot_index]->SendCorrections();
 
-  auto bit_length = parent_a_.at(0)->GetBitLength();
+    ot_1oon_receiver_[ot_index]->ComputeOutputs();
+    return ot_1oon_receiver_[ot_index]->GetOutputs();
+  }
 
-  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
-  const auto b = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
-  assert(a);
-  assert(b);
+  const auto number_of_messages{number_of_messages_[ot_index]};
+  const auto& random_choices{random_choices_[ot_index]};
+  std::vector<std::uint8_t> offsets(number_of_values_);
+  for (std::size_t i = 0; i < number_of_values_; ++i) {
+    offsets[i] = static_cast<std::uint8_t>(
+        (number_of_messages + selection_index[i] - random_choices[i]) % number_of_messages);
+  }
+  auto message{communication::BuildMessage(communication::MessageType::kMsbExtractionOffsets,
+                                           GetMessageId(ot_index), offsets)};
+  communication_layer_.SendMessage(1, message.Release());
+
+  const auto masked_messages_message{message_futures_[ot_index].get()};
+  const auto payload{communication::GetMessage(masked_messages_message.data())->payload()};
+  assert(payload->size() == BitsToBytes(number_of_values_ * number_of_messages));
+  const BitSpan masked_messages(const_cast<std::uint8_t*>(payload->data()),
+                                number_of_values_ * number_of_messages);
+
+  const auto& masks{random_masks_[ot_index]};
+  BitVector<> outputs(number_of_values_);
+  for (std::size_t i = 0; i < number_of_values_; ++i) {
+    outputs.Set(masked_messages.Get(number_of_messages * i + random_choices[i]) != masks.Get(i), i);
+  }
+  return outputs;
+}
 
-  auto a_values = a->GetValues();
-  auto b_values = b->GetValues();
+template <typename T>
+BitVector<> MostSignificantBitExtraction<T>::Evaluate(std::vector<T> delta) {
+  assert(delta.size() == number_of_values_);
+  constexpr std::size_t bit_length{sizeof(T) * 8};
 
   // some variables for the protocol
   std::size_t number_of_messages, ot_index = 0;
-  BitVector<> r, c(number_of_simd_), messages;
-  std::vector<std::uint8_t> selection_index(number_of_simd_);
+  BitVector<> r, c(number_of_values_), messages;
+  std::vector<std::uint8_t> selection_index(number_of_values_);
 
   // step 3
-  std::vector<T> delta(number_of_simd_);
-  std::vector<BitSpan> delta_bs(number_of_simd_);
-  for (auto i = 0u; i < number_of_simd_; i++) {
-    delta.at(i) = b_values.at(i) - a_values.at(i);
+  std::vector<BitSpan> delta_bs(number_of_values_);
+  for (auto i = 0u; i < number_of_values_; i++) {
     delta_bs.at(i) = BitSpan(reinterpret_cast<std::byte*>(&delta.at(i)), sizeof(delta.at(i)) * 8);
   }
 
@@ -894,10 +1599,10 @@ void GreaterThanGate<T>::EvaluateOnline() {
 
     // step 8
     if (my_id_ == 1) {
-      r = BitVector<>::SecureRandom(number_of_simd_);
+      r = BitVector<>::SecureRandom(number_of_values_);
     }
 
-    for (auto i = 0u; i < number_of_simd_; i++) {
+    for (auto i = 0u; i < number_of_values_; i++) {
       auto delta_subset = delta_bs.at(i).Subset(0, chunk_bit_length_);
       auto delta_subset_value = static_cast<std::uint8_t>(delta_subset.GetMutableData()[0]);
 
@@ -944,10 +1649,10 @@ void GreaterThanGate<T>::EvaluateOnline() {
     // step 20 : save randomized r in another variable, because r is still needed in step 19
     BitVector<> r_for_xor;
     if (my_id_ == 1) {
-      r_for_xor = BitVector<>::SecureRandom(number_of_simd_);
+      r_for_xor = BitVector<>::SecureRandom(number_of_values_);
     }
 
-    for (auto i = 0u; i < number_of_simd_; i++) {
+    for (auto i = 0u; i < number_of_values_; i++) {
       auto delta_subset = delta_bs.at(i).Subset(bit_length_last, bit_length_next);
       auto delta_subset_value = static_cast<std::uint8_t>(delta_subset.GetMutableData()[0]);
 
@@ -996,24 +1701,84 @@ void GreaterThanGate<T>::EvaluateOnline() {
   }
 
   // step 23
-  BitVector<> output_vector(number_of_simd_);
-  for (auto i = 0u; i < number_of_simd_; i++) {
+  BitVector<> output_vector(number_of_values_);
+  for (auto i = 0u; i < number_of_values_; i++) {
     auto output = ((my_id_ == 0) ? c.Get(i) : r.Get(i)) != delta_bs.at(i).Get(bit_length - 1);
     output_vector.Set(output, i);
   }
+  return output_vector;
+}
+
+template class MostSignificantBitExtraction<std::uint8_t>;
+template class MostSignificantBitExtraction<std::uint16_t>;
+template class MostSignificantBitExtraction<std::uint32_t>;
+template class MostSignificantBitExtraction<std::uint64_t>;
+template class MostSignificantBitExtraction<__uint128_t>;
+
+template <typename T>
+GreaterThanGate<T>::GreaterThanGate(arithmetic_gmw::WirePointer<T>& a,
+                                    arithmetic_gmw::WirePointer<T>& b, std::size_t l_s)
+    : TwoGate(a->GetBackend()),
+      number_of_simd_(a->GetNumberOfSimdValues()),
+      msb_extraction_(a->GetBackend(), gate_id_, a->GetNumberOfSimdValues(), l_s) {
+  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
+  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
+
+  assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
+
+  // the plaintext numbers have to be smaller than 2^{bit_length - 1}
+  assert(parent_a_.at(0)->GetBitLength() == parent_b_.at(0)->GetBitLength());
+
+  output_wires_ = {
+      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
+
+  auto gate_info =
+      fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
+                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
+  GetLogger().LogDebug("Created an arithmetic_gmw::GreaterThanGate with following properties: {}",
+                       gate_info);
+}
+
+template <typename T>
+void GreaterThanGate<T>::RunSender1ooNOt(encrypto::motion::BitVector<> messages,
+                                         std::size_t ot_index) {
+  msb_extraction_.RunSender1ooNOt(std::move(messages), ot_index);
+}
+
+template <typename T>
+BitVector<> GreaterThanGate<T>::RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index,
+                                               std::size_t ot_index) {
+  return msb_extraction_.RunReceiver1ooNOt(std::move(selection_index), ot_index);
+}
+
+template <typename T>
+void GreaterThanGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+
+  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
+  const auto b = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
+  assert(a);
+  assert(b);
+
+  // a > b iff the most significant bit of b - a is set
+  std::vector<T> delta(number_of_simd_);
+  SubVectors<T>(b->GetValues(), a->GetValues(), delta);
 
   // place the output in output_wires_
   auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
   assert(output_wire);
-  output_wire->GetMutableValues() = output_vector;
+  output_wire->GetMutableValues() = msb_extraction_.Evaluate(std::move(delta));
 
-  GetLogger().LogDebug(
-      fmt::format("Evaluated arithmetic_gmw::GreaterThanGate with id#{}", gate_id_));
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::GreaterThanGate with id#{}", gate_id_);
 }
 
 template <typename T>
 const boolean_gmw::SharePointer GreaterThanGate<T>::GetOutputAsGmwShare() {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -1024,4 +1789,114 @@ template class GreaterThanGate<std::uint32_t>;
 template class GreaterThanGate<std::uint64_t>;
 template class GreaterThanGate<__uint128_t>;
 
+template <typename T>
+EqualityGate<T>::EqualityGate(arithmetic_gmw::WirePointer<T>& a,
+                              arithmetic_gmw::WirePointer<T>& b, std::size_t l_s)
+    : TwoGate(a->GetBackend()),
+      number_of_simd_(a->GetNumberOfSimdValues()),
+      msb_extraction_(a->GetBackend(), gate_id_, 2 * a->GetNumberOfSimdValues(), l_s) {
+  parent_a_ = {std::static_pointer_cast<motion::Wire>(a)};
+  parent_b_ = {std::static_pointer_cast<motion::Wire>(b)};
+
+  assert(parent_a_.at(0)->GetNumberOfSimdValues() == parent_b_.at(0)->GetNumberOfSimdValues());
+
+  output_wires_ = {
+      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
+
+  auto gate_info =
+      fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
+                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
+  GetLogger().LogDebug("Created an arithmetic_gmw::EqualityGate with following properties: {}",
+                       gate_info);
+}
+
+template <typename T>
+void EqualityGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+
+  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_a_.at(0));
+  const auto b = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_b_.at(0));
+  assert(a);
+  assert(b);
+
+  // b - a followed by a - b, at most one of which is negative, so a == b iff neither is
+  std::vector<T> deltas(2 * number_of_simd_);
+  std::span deltas_span(deltas);
+  SubVectors<T>(b->GetValues(), a->GetValues(), deltas_span.first(number_of_simd_));
+  SubVectors<T>(a->GetValues(), b->GetValues(), deltas_span.last(number_of_simd_));
+  const auto msbs{msb_extraction_.Evaluate(std::move(deltas))};
+
+  auto output = msbs.Subset(0, number_of_simd_) ^ msbs.Subset(number_of_simd_, 2 * number_of_simd_);
+  if (GetCommunicationLayer().GetMyId() == 0) output.Invert();
+
+  auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
+  assert(output_wire);
+  output_wire->GetMutableValues() = std::move(output);
+
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::EqualityGate with id#{}", gate_id_);
+}
+
+template <typename T>
+const boolean_gmw::SharePointer EqualityGate<T>::GetOutputAsGmwShare() {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+template class EqualityGate<std::uint8_t>;
+template class EqualityGate<std::uint16_t>;
+template class EqualityGate<std::uint32_t>;
+template class EqualityGate<std::uint64_t>;
+template class EqualityGate<__uint128_t>;
+
+template <typename T>
+SignGate<T>::SignGate(arithmetic_gmw::WirePointer<T>& a, std::size_t l_s)
+    : OneGate(a->GetBackend()),
+      number_of_simd_(a->GetNumberOfSimdValues()),
+      msb_extraction_(a->GetBackend(), gate_id_, a->GetNumberOfSimdValues(), l_s) {
+  parent_ = {std::static_pointer_cast<motion::Wire>(a)};
+
+  output_wires_ = {
+      GetRegister().template EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd_)};
+
+  auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}", sizeof(T) * 8, gate_id_,
+                               parent_.at(0)->GetWireId());
+  GetLogger().LogDebug("Created an arithmetic_gmw::SignGate with following properties: {}",
+                       gate_info);
+}
+
+template <typename T>
+void SignGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+
+  parent_.at(0)->GetIsReadyCondition().Wait();
+
+  const auto a = std::dynamic_pointer_cast<const arithmetic_gmw::Wire<T>>(parent_.at(0));
+  assert(a);
+
+  auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(0));
+  assert(output_wire);
+  output_wire->GetMutableValues() = msb_extraction_.Evaluate(a->GetValues());
+
+  GetLogger().LogDebug("Evaluated arithmetic_gmw::SignGate with id#{}", gate_id_);
+}
+
+template <typename T>
+const boolean_gmw::SharePointer SignGate<T>::GetOutputAsGmwShare() {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+template class SignGate<std::uint8_t>;
+template class SignGate<std::uint16_t>;
+template class SignGate<std::uint32_t>;
+template class SignGate<std::uint64_t>;
+template class SignGate<__uint128_t>;
+
 }  // namespace encrypto::motion::proto::arithmetic_gmw
@@ -24,20 +24,31 @@
 
 #pragma once
 
+#include "arithmetic_gmw_provider.h"
 #include "arithmetic_gmw_share.h"
 #include "arithmetic_gmw_wire.h"
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <span>
+#include <vector>
 
 #include "base/motion_base_provider.h"
 #include "multiplication_triple/mt_provider.h"
 #include "multiplication_triple/sp_provider.h"
 #include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
 #include "protocols/gate.h"
+#include "protocols/output_batcher.h"
 #include "utility/reusable_future.h"
 
 //  Forward Declaration
+namespace encrypto::motion {
+
+class RandomOtPool;
+
+}  // namespace encrypto::motion
+
 namespace encrypto::motion::proto::boolean_gmw {
 
 class Wire;
@@ -78,6 +89,14 @@ class InputGate final : public motion::InputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  /// \brief Replaces the input for the next evaluation, see CompiledCircuit::SetInput.
+  /// \throws std::invalid_argument if the size of \p input differs from the current input.
+  void SetInput(std::vector<T>&& input);
+
+  /// \brief Copies \p input into the existing input buffer, e.g., a chunk of a MappedColumn.
+  /// \throws std::invalid_argument if the size of \p input differs from the current input.
+  void SetInput(std::span<const T> input);
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -102,6 +121,7 @@ class OutputGate final : public motion::OutputGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -115,9 +135,37 @@ class OutputGate final : public motion::OutputGate {
 
   std::vector<motion::ReusableFiberFuture<std::vector<std::uint8_t>>> output_message_futures_;
 
+  // set if the output is reconstructed together with the other outputs of its layer
+  std::optional<OutputBatcher::OutputPosition> output_position_;
+
   std::mutex m;
 };
 
+/// \brief Outputs shares of uniformly random values without any communication.  Each party derives
+/// its shares from its private seed, i.e., pseudo-random secret sharing with the 1-party sets of a
+/// dishonest majority, s.t. the shared value is unknown to any n - 1 colluding parties.
+template <typename T>
+class RandomGate final : public motion::Gate {
+ public:
+  RandomGate(std::size_t number_of_simd, Backend& backend);
+  ~RandomGate() final = default;
+
+  void EvaluateSetup() final override {}
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+  RandomGate() = delete;
+  RandomGate(Gate&) = delete;
+
+ private:
+  std::size_t arithmetic_sharing_id_;
+};
+
 template <typename T>
 class AdditionGate final : public motion::TwoGate {
  public:
@@ -129,6 +177,8 @@ class AdditionGate final : public motion::TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -148,6 +198,8 @@ class SubtractionGate final : public motion::TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the case we need it
   // multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
@@ -165,6 +217,8 @@ class MultiplicationGate final : public motion::TwoGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+  // the masked inputs d and e
+  OnlineCost GetOnlineCost() const final override { return {1, 2 * GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -176,14 +230,30 @@ class MultiplicationGate final : public motion::TwoGate {
   MultiplicationGate(Gate&) = delete;
 
  private:
-  arithmetic_gmw::WirePointer<T> d_, e_;
-  std::shared_ptr<OutputGate<T>> d_output_, e_output_;
+  // the masked inputs d directly followed by e, opened by a single output gate if the openings are
+  // not batched
+  arithmetic_gmw::WirePointer<T> d_e_;
+  std::shared_ptr<OutputGate<T>> d_e_output_;
+
+  // position of d and e in the batched openings of the gate's layer, see
+  // Provider::SetOpeningBatching
+  std::optional<Provider::OpeningPosition> opening_position_;
 
   std::size_t number_of_mts_, mt_offset_;
 };
 
 // Multiplication of an arithmetic share with a boolean bit.
 // Based on [ST21]: https://iacr.org/2021/029.pdf
+//
+// The setup runs AC-OTs with random choices c and random correlations delta in both directions.
+// The online phase derandomizes them with a single message per party, which holds the choice
+// corrections e = b ^ c of the OTs the party receives and the correlation corrections
+// f = (-1)^b * v - delta of the OTs it sends.
+//
+// If the random OT pool with the other party is enabled when the gate is created, see
+// OtProvider::EnableRandomOtPool, the random AC-OTs are derived from the OTs of the pool without
+// any message: the sender's output is its first message, delta is the difference of its messages
+// and the receiver's output is the message of its choice.
 template <typename T>
 class HybridMultiplicationGate final : public motion::TwoGate {
  public:
@@ -194,8 +264,13 @@ class HybridMultiplicationGate final : public motion::TwoGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
-
-  bool NeedsSetup() const override { return false; }
+  // reserves the OTs of the next run in the random OT pool
+  void Clear() final override;
+  // the corrections e and f
+  OnlineCost GetOnlineCost() const final override {
+    const auto number_of_simd_values{parent_a_.at(0)->GetNumberOfSimdValues()};
+    return {1, BitsToBytes(number_of_simd_values) + number_of_simd_values * sizeof(T)};
+  }
 
   // perhaps, we should return a copy of the pointer and not move it for the
   // case we need it multiple times
@@ -206,8 +281,79 @@ class HybridMultiplicationGate final : public motion::TwoGate {
   HybridMultiplicationGate(Gate&) = delete;
 
  private:
+  // reserves the OTs of the gate in the random OT pool in both directions
+  void ReserveRandomOts();
+
   std::unique_ptr<BasicOtReceiver> ot_receiver_;
   std::unique_ptr<BasicOtSender> ot_sender_;
+
+  // the pool the random AC-OTs are derived from instead of the OT extension if it is enabled
+  RandomOtPool* random_ot_pool_{nullptr};
+  std::size_t random_sender_ots_offset_{0};
+  std::size_t random_receiver_ots_offset_{0};
+
+  // the random AC-OTs of the setup, the receiver output is the sender output plus choice * delta
+  BitVector<> random_choices_;
+  std::vector<T> random_correlations_;
+  std::vector<T> random_sender_outputs_;
+  std::vector<T> random_receiver_outputs_;
+
+  // the corrections of the other party
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> corrections_future_;
+};
+
+/// \brief Multiplies an m x k matrix X by a k x n matrix Y in each SIMD value using a matrix
+/// triple (A, B, C = A * B) of the same shapes instead of m * k * n multiplication triples.
+///
+/// The matrices are given as the wires of their entries in row-major order, where each wire holds
+/// one value of the matrix per SIMD value, and the output wires are the m * n entries of the
+/// product in row-major order.  The online phase opens D = X - A and E = Y - B, i.e., m * k + k * n
+/// values per SIMD value in a single round, and computes C + D * B + A * E + D * E locally.  The
+/// triple is generated in the setup by pairwise additively correlated OTs, where the choices are
+/// the bits of the own A and the correlations are the rows of the other party's B, s.t. each OT
+/// transfers a whole row of n values.  An inner product is the special case m = n = 1.
+template <typename T>
+class MatrixMultiplicationGate final : public motion::TwoGate {
+ public:
+  MatrixMultiplicationGate(std::vector<motion::WirePointer> matrix_a,
+                           std::vector<motion::WirePointer> matrix_b, std::size_t number_of_rows,
+                           std::size_t number_of_columns);
+  ~MatrixMultiplicationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+  // the masked matrices d and e
+  OnlineCost GetOnlineCost() const final override {
+    return {1, (m_ * k_ + k_ * n_) * parent_a_.at(0)->GetNumberOfSimdValues() * sizeof(T)};
+  }
+
+  // one share per entry of the product in row-major order, since arithmetic shares have one wire
+  std::vector<arithmetic_gmw::SharePointer<T>> GetOutputsAsArithmeticShares();
+
+  MatrixMultiplicationGate() = delete;
+  MatrixMultiplicationGate(Gate&) = delete;
+
+ private:
+  // number of rows of A, columns of A resp. rows of B, and columns of B
+  std::size_t m_, k_, n_;
+
+  // the matrix triple of each SIMD value in row-major order, i.e., a has m * k entries per SIMD
+  // value, b has k * n entries and c has m * n entries
+  std::vector<T> a_, b_, c_;
+
+  // for each other party, the bits of the own A are the choices and the rows of the own B are the
+  // correlations of the OTs
+  std::vector<std::unique_ptr<BasicOtSender>> ot_senders_;
+  std::vector<std::unique_ptr<BasicOtReceiver>> ot_receivers_;
+
+  // the masked matrices d directly followed by e, opened by a single output gate if the openings
+  // are not batched
+  arithmetic_gmw::WirePointer<T> d_e_;
+  std::shared_ptr<OutputGate<T>> d_e_output_;
+
+  // position of d and e in the batched openings of the gate's layer, see
+  // Provider::SetOpeningBatching
+  std::optional<Provider::OpeningPosition> opening_position_;
 };
 
 template <typename T>
@@ -218,6 +364,7 @@ class SquareGate final : public motion::OneGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -235,9 +382,130 @@ class SquareGate final : public motion::OneGate {
   std::size_t number_of_sps_, sp_offset_;
 };
 
+/// \brief Probabilistic truncation, i.e., arithmetic shift of the two's complement values x to the
+/// right by m bits, which are masked with random values r composed of shared bits and opened in a
+/// single round.  The result is floor(x / 2^m) + b, where the error b in {0, 1} depends on
+/// the masked lower m bits.  Requires -2^(l-2) <= x < 2^(l-2) for the bit length l of T.
+/// Based on [DEK20]: https://eprint.iacr.org/2019/131
+template <typename T>
+class TruncationGate final : public motion::OneGate {
+ public:
+  TruncationGate(const arithmetic_gmw::WirePointer<T>& a, std::size_t number_of_truncated_bits);
+  ~TruncationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+  // the masked input c
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  bool NeedsSetup() const override { return false; }
+
+  arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare();
+
+  TruncationGate() = delete;
+  TruncationGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_truncated_bits_;
+
+  arithmetic_gmw::WirePointer<T> c_;
+  std::shared_ptr<OutputGate<T>> c_output_;
+
+  std::size_t number_of_sbs_, sb_offset_;
+};
+
+// the choices of the 1-out-of-N OTs are bytes, which bounds the chunk bit length of GreaterThanGate
+constexpr std::size_t kMaxGreaterThanChunkBitLength{8};
+
+/// \brief Selects the chunk bit length l_s of GreaterThanGate, which compares l_s bits at once with
+/// 1-out-of-2^l_s OTs, for \p number_of_simd comparisons of \p bit_length-bit values.  Longer
+/// chunks need fewer rounds but exponentially more OT messages, so the l_s with the smallest
+/// estimated run time on a network with \p round_trip_time and \p bandwidth in bits per second is
+/// chosen, where a bandwidth of 0 means unlimited.
+std::size_t SelectGreaterThanChunkBitLength(std::size_t bit_length, std::size_t number_of_simd,
+                                            std::chrono::microseconds round_trip_time,
+                                            double bandwidth);
+
+/// \brief Computes XOR shares of the most significant bits of values additively shared between
+/// two parties with a chain of 1-out-of-N OTs, which process l_s bits of the shares at once.
+/// Party 0 is the receiver and party 1 the sender of the OTs.  This is the core of the
+/// OT-based comparisons GreaterThanGate, EqualityGate and SignGate.
+///
+/// If Provider::GetRandomComparisonOts() is set, random 1-out-of-N OTs are fetched in the setup
+/// phase, see Setup(), and derandomized in the online phase by rotating the sender's messages by
+/// the receiver's offsets (choice - random choice) mod N, which are exchanged as
+/// kMsbExtractionOffsets and kMsbExtractionMessages messages of the gate.  If the random OT pool
+/// with the other party is enabled when the gate is created, see OtProvider::EnableRandomOtPool,
+/// each random 1-out-of-N OT is built from log2(N) random OTs of the pool as by Naor and Pinkas:
+/// the random choice consists of their choice bits and the mask of message x is the XOR of the
+/// bits at position x of the strings expanded from the messages selected by the bits of x.
+template <typename T>
+class MostSignificantBitExtraction {
+ public:
+  /// \brief Registers the OTs for \p number_of_values values of the gate with id \p gate_id.
+  /// \throws std::invalid_argument if \p l_s is not in [2, min(kMaxGreaterThanChunkBitLength,
+  ///         bit length - 1)] or if there are not exactly 2 parties.
+  MostSignificantBitExtraction(Backend& backend, std::size_t gate_id, std::size_t number_of_values,
+                               std::size_t l_s);
+
+  /// \brief Returns true if the random OTs need to be fetched with Setup() in the setup phase.
+  bool UsesRandomOts() const noexcept { return random_ots_; }
+
+  /// \brief Fetches the outputs of the random OTs, does nothing without random OTs.
+  void Setup();
+
+  /// \brief Reserves the OTs of the next run in the random OT pool if it is used.
+  void Clear();
+
+  /// \brief Returns the XOR shares of the most significant bits of the values shared by \p delta.
+  BitVector<> Evaluate(std::vector<T> delta);
+
+  void RunSender1ooNOt(encrypto::motion::BitVector<> messages, std::size_t ot_index);
+
+  BitVector<> RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index, std::size_t ot_index);
+
+ private:
+  // the message id of the derandomization messages of the OT with index ot_index
+  std::size_t GetMessageId(std::size_t ot_index) const { return (gate_id_ << 8) | ot_index; }
+
+  // reserves log2(N) OTs per value for each 1-out-of-N OT in the random OT pool
+  void ReserveRandomOts();
+
+  // derives the random 1-out-of-N OTs from the OTs of the random OT pool
+  void SetupFromRandomOtPool();
+
+  communication::CommunicationLayer& communication_layer_;
+  std::size_t gate_id_, number_of_values_, my_id_, chunk_bit_length_;
+  bool random_ots_;
+
+  std::vector<std::unique_ptr<GKk13OtBitReceiver>> ot_1oon_receiver_;
+  std::vector<std::unique_ptr<GKk13OtBitSender>> ot_1oon_sender_;
+
+  // the random OTs, their number of messages and, after Setup(), the receiver's random choices and
+  // the selected masks or the sender's number of messages masks per OT
+  std::vector<std::unique_ptr<RKk13OtReceiver>> random_ot_receivers_;
+  std::vector<std::unique_ptr<RKk13OtSender>> random_ot_senders_;
+
+  // the pool the random OTs are taken from instead of the 1-out-of-N OT extension if it is enabled
+  // and the offsets of the OTs of each 1-out-of-N OT
+  RandomOtPool* random_ot_pool_{nullptr};
+  std::vector<std::size_t> random_ot_pool_offsets_;
+  std::vector<std::size_t> number_of_messages_;
+  std::vector<std::vector<std::uint8_t>> random_choices_;
+  std::vector<BitVector<>> random_masks_;
+
+  // the receiver waits for the masked messages and the sender for the offsets
+  std::vector<motion::ReusableFiberFuture<std::vector<std::uint8_t>>> message_futures_;
+};
+
+/// \brief Computes a Boolean GMW share of a > b as the most significant bit of b - a, which
+/// requires the plaintext values to be smaller than 2^(l-1) or, in two's complement, to lie in
+/// [-2^(l-2), 2^(l-2)) for the bit length l of T.
 template <typename T>
 class GreaterThanGate final : public motion::TwoGate {
  public:
+  /// \throws std::invalid_argument if \p l_s is not in [2, min(kMaxGreaterThanChunkBitLength,
+  ///         bit length - 1)].
   GreaterThanGate(arithmetic_gmw::WirePointer<T>& a, arithmetic_gmw::WirePointer<T>& b,
                   std::size_t l_s);
 
@@ -247,11 +515,18 @@ class GreaterThanGate final : public motion::TwoGate {
 
   BitVector<> RunReceiver1ooNOt(std::vector<std::uint8_t> selection_index, std::size_t ot_index);
 
-  bool NeedsSetup() const override { return false; }
+  bool NeedsSetup() const override { return msb_extraction_.UsesRandomOts(); }
+
+  void EvaluateSetup() override { msb_extraction_.Setup(); }
 
-  void EvaluateSetup() override{};
+  void Clear() override {
+    Gate::Clear();
+    msb_extraction_.Clear();
+  }
 
   void EvaluateOnline() override;
+  // at least one round, the OT-based comparison is not estimated
+  OnlineCost GetOnlineCost() const final override { return {1, 0}; }
 
   const boolean_gmw::SharePointer GetOutputAsGmwShare();
 
@@ -259,10 +534,77 @@ class GreaterThanGate final : public motion::TwoGate {
   GreaterThanGate(Gate&) = delete;
 
  private:
-  std::size_t number_of_parties_, number_of_simd_, my_id_, chunk_bit_length_;
+  std::size_t number_of_simd_;
 
-  std::vector<std::unique_ptr<GKk13OtBitReceiver>> ot_1oon_receiver_;
-  std::vector<std::unique_ptr<GKk13OtBitSender>> ot_1oon_sender_;
+  MostSignificantBitExtraction<T> msb_extraction_;
+};
+
+/// \brief Computes a Boolean GMW share of a == b from the most significant bits of b - a and
+/// a - b, which are extracted in the same OTs, under the same requirements as GreaterThanGate.
+template <typename T>
+class EqualityGate final : public motion::TwoGate {
+ public:
+  /// \throws std::invalid_argument, see MostSignificantBitExtraction.
+  EqualityGate(arithmetic_gmw::WirePointer<T>& a, arithmetic_gmw::WirePointer<T>& b,
+               std::size_t l_s);
+
+  ~EqualityGate() override {}
+
+  bool NeedsSetup() const override { return msb_extraction_.UsesRandomOts(); }
+
+  void EvaluateSetup() override { msb_extraction_.Setup(); }
+
+  void Clear() override {
+    Gate::Clear();
+    msb_extraction_.Clear();
+  }
+
+  void EvaluateOnline() override;
+  // at least one round, the OT-based comparison is not estimated
+  OnlineCost GetOnlineCost() const final override { return {1, 0}; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare();
+
+  EqualityGate() = delete;
+  EqualityGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_simd_;
+
+  MostSignificantBitExtraction<T> msb_extraction_;
+};
+
+/// \brief Computes a Boolean GMW share of the sign bit of a in two's complement, i.e., of a < 0.
+template <typename T>
+class SignGate final : public motion::OneGate {
+ public:
+  /// \throws std::invalid_argument, see MostSignificantBitExtraction.
+  SignGate(arithmetic_gmw::WirePointer<T>& a, std::size_t l_s);
+
+  ~SignGate() override {}
+
+  bool NeedsSetup() const override { return msb_extraction_.UsesRandomOts(); }
+
+  void EvaluateSetup() override { msb_extraction_.Setup(); }
+
+  void Clear() override {
+    Gate::Clear();
+    msb_extraction_.Clear();
+  }
+
+  void EvaluateOnline() override;
+  // at least one round, the OT-based comparison is not estimated
+  OnlineCost GetOnlineCost() const final override { return {1, 0}; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare();
+
+  SignGate() = delete;
+  SignGate(Gate&) = delete;
+
+ private:
+  std::size_t number_of_simd_;
+
+  MostSignificantBitExtraction<T> msb_extraction_;
 };
 
 }  // namespace encrypto::motion::proto::arithmetic_gmw
@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "arithmetic_gmw_provider.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "utility/constants.h"
+#include "utility/helpers.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion::proto::arithmetic_gmw {
+
+Provider::Provider(communication::CommunicationLayer& communication_layer)
+    : communication_layer_(communication_layer) {}
+
+Provider::~Provider() {}
+
+Provider::OpeningPosition Provider::AssignOpening(std::size_t layer, std::size_t bit_size,
+                                                  std::size_t number_of_bytes) {
+  assert(opening_batching_);
+  auto [iterator, inserted] = group_indices_.try_emplace({layer, bit_size}, opening_groups_.size());
+  if (inserted) {
+    auto& group{*opening_groups_.emplace_back(std::make_unique<OpeningGroup>())};
+    group.message_id = next_message_id_++;
+    group.message_futures = communication_layer_.GetMessageManager().RegisterReceiveAll(
+        communication::MessageType::kArithmeticGmwOpening, group.message_id);
+  }
+  auto& group{*opening_groups_.at(iterator->second)};
+  OpeningPosition position{iterator->second, group.number_of_bytes};
+  group.number_of_bytes += number_of_bytes;
+  ++group.number_of_gates;
+  return position;
+}
+
+template <typename T>
+std::vector<T> Provider::Open(const OpeningPosition& position, std::span<const T> shares) {
+  assert(position.group_index < opening_groups_.size());
+  auto& group{*opening_groups_[position.group_index]};
+  const auto number_of_bytes{shares.size_bytes()};
+  std::unique_lock lock(group.mutex);
+  assert(position.offset + number_of_bytes <= group.number_of_bytes);
+  if (!group.buffer) {
+    group.buffer = std::shared_ptr<std::uint8_t[]>(new std::uint8_t[group.number_of_bytes]);
+  }
+  std::memcpy(group.buffer.get() + position.offset, shares.data(), number_of_bytes);
+  assert(group.number_of_deposited_gates < group.number_of_gates);
+  if (++group.number_of_deposited_gates == group.number_of_gates) {
+    if constexpr (kDebug) {
+      communication_layer_.GetLogger()->LogDebug(
+          fmt::format("Broadcast openings #{} of {} arithmetic GMW multiplication gates ({} B)",
+                      position.group_index, group.number_of_gates, group.number_of_bytes));
+    }
+    // the shares are not modified anymore, so they can be sent while we keep them for combining
+    std::span payload(static_cast<const std::uint8_t*>(group.buffer.get()), group.number_of_bytes);
+    communication_layer_.BroadcastMessage(communication::MessageType::kArithmeticGmwOpening,
+                                          group.message_id, payload,
+                                          std::shared_ptr<const std::uint8_t[]>(group.buffer));
+    group.deposited_condition.notify_all();
+  } else {
+    group.deposited_condition.wait(
+        lock, [&group] { return group.number_of_deposited_gates == group.number_of_gates; });
+  }
+
+  if (!group.reconstructed) {
+    std::span<const std::uint8_t> buffer(group.buffer.get(), group.number_of_bytes);
+    auto values{FromByteVector<T>(buffer)};
+    group.buffer.reset();
+    for (auto& message_future : group.message_futures) {
+      const auto message{message_future.get()};
+      const auto payload{communication::GetMessage(message.data())->payload()};
+      assert(payload->size() == group.number_of_bytes);
+      AddVectors<T>(values, FromByteVector<T>(std::span(payload->data(), payload->size())), values);
+    }
+    group.values = ToByteVector<T>(values);
+    group.reconstructed = true;
+  }
+
+  auto result{FromByteVector<T>(
+      std::span<const std::uint8_t>(group.values.data() + position.offset, number_of_bytes))};
+  assert(group.number_of_opened_gates < group.number_of_gates);
+  if (++group.number_of_opened_gates == group.number_of_gates) {
+    // prepare the group for another evaluation of the circuit, see Backend::Clear
+    group.values = std::vector<std::uint8_t>();
+    group.number_of_deposited_gates = 0;
+    group.number_of_opened_gates = 0;
+    group.reconstructed = false;
+  }
+  return result;
+}
+
+template std::vector<std::uint8_t> Provider::Open<std::uint8_t>(const OpeningPosition&,
+                                                                 std::span<const std::uint8_t>);
+template std::vector<std::uint16_t> Provider::Open<std::uint16_t>(const OpeningPosition&,
+                                                                   std::span<const std::uint16_t>);
+template std::vector<std::uint32_t> Provider::Open<std::uint32_t>(const OpeningPosition&,
+                                                                   std::span<const std::uint32_t>);
+template std::vector<std::uint64_t> Provider::Open<std::uint64_t>(const OpeningPosition&,
+                                                                   std::span<const std::uint64_t>);
+
+void Provider::Reset() {
+  opening_groups_.clear();
+  group_indices_.clear();
+}
+
+}  // namespace encrypto::motion::proto::arithmetic_gmw
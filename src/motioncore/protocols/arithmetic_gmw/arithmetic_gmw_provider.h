@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::proto::arithmetic_gmw {
+
+/// \brief Opens the masked inputs d and e of the multiplication gates of one circuit layer
+/// together.  Instead of one message per gate and peer, the d and e shares of all multiplication
+/// gates of the same layer and bit size are collected in a group, which is broadcast in a single
+/// message as soon as all of its gates deposited their shares, and reconstructed at once.
+class Provider {
+ public:
+  using future_type = ReusableFiberFuture<std::vector<std::uint8_t>>;
+  Provider(communication::CommunicationLayer& communication_layer);
+  ~Provider();
+
+  /// \brief Enables batching of the openings in multiplication gates, see Register::GetGateLayers.
+  /// The gates of a group wait for each other, so all gates of a layer need to be evaluated
+  /// concurrently, which excludes dead gate elimination and limiting the instances in flight of
+  /// compiled circuits.  Needs to be set to the same value by all parties before constructing the
+  /// circuit.
+  void SetOpeningBatching(bool value = true) { opening_batching_ = value; }
+
+  bool GetOpeningBatching() const noexcept { return opening_batching_; }
+
+  /// \brief Lets the OT-based comparisons like GreaterThanGate use random 1-out-of-N OTs, which
+  /// are fetched from the OT extension in the setup phase and derandomized with a rotation offset
+  /// by the gate's own online messages, see MostSignificantBitExtraction.  Needs to be set to the
+  /// same value by all parties before constructing the circuit.
+  void SetRandomComparisonOts(bool value = true) { random_comparison_ots_ = value; }
+
+  bool GetRandomComparisonOts() const noexcept { return random_comparison_ots_; }
+
+  /// \brief Position of the values opened by a multiplication gate in the batched openings.
+  struct OpeningPosition {
+    std::size_t group_index;
+    // in bytes
+    std::size_t offset;
+  };
+
+  /// \brief Assigns the openings of a newly constructed multiplication gate of \p number_of_bytes
+  /// bytes in circuit layer \p layer to the group of the layer and \p bit_size.
+  OpeningPosition AssignOpening(std::size_t layer, std::size_t bit_size,
+                                std::size_t number_of_bytes);
+
+  /// \brief Deposits the shares of a gate, broadcasts the group if all of its gates are done and
+  /// returns the reconstructed values at \p position, waits until all shares are received.
+  template <typename T>
+  std::vector<T> Open(const OpeningPosition& position, std::span<const T> shares);
+
+  /// \brief Forgets the groups of the gates, see Backend::Reset.
+  void Reset();
+
+ private:
+  struct OpeningGroup {
+    // message ids are not reused after Reset, s.t. late registrations do not mix up groups
+    std::size_t message_id{0};
+    std::size_t number_of_bytes{0};
+    std::size_t number_of_gates{0};
+    std::size_t number_of_deposited_gates{0};
+    std::size_t number_of_opened_gates{0};
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable deposited_condition;
+    // our shares, kept until they are reconstructed
+    std::shared_ptr<std::uint8_t[]> buffer;
+    // shares of the other parties
+    std::vector<future_type> message_futures;
+    // reconstructed values
+    std::vector<std::uint8_t> values;
+    bool reconstructed{false};
+  };
+
+  bool opening_batching_{false};
+  bool random_comparison_ots_{false};
+
+  // groups are only appended while constructing the circuit, so no synchronization is needed
+  std::vector<std::unique_ptr<OpeningGroup>> opening_groups_;
+
+  // (layer, bit size) -> index of the group in opening_groups_
+  std::map<std::pair<std::size_t, std::size_t>, std::size_t> group_indices_;
+
+  std::size_t next_message_id_{0};
+
+  communication::CommunicationLayer& communication_layer_;
+};
+
+}  // namespace encrypto::motion::proto::arithmetic_gmw
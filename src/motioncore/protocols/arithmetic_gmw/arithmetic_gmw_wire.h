@@ -56,6 +56,8 @@ class Wire final : public motion::Wire {
 
   std::size_t GetBitLength() const final { return sizeof(T) * 8; }
 
+  std::size_t GetNumberOfBytes() const final { return values_.size() * sizeof(T); }
+
   bool IsConstant() const noexcept final { return false; }
 
  private:
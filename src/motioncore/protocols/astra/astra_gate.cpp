@@ -22,10 +22,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <mutex>
 #include <type_traits>
 
 #include "astra_gate.h"
+#include "astra_provider.h"
 #include "astra_share.h"
 #include "astra_wire.h"
 #include "communication/message_manager.h"
@@ -59,8 +61,7 @@ InputGate<T>::InputGate(std::vector<T> input, std::size_t input_owner, Backend&
   if constexpr (kDebug) {
     auto gate_info = fmt::format("uint{}_t type, gate id {}, owner {}", sizeof(T) * 8, gate_id_,
                                  input_owner_id_);
-    GetLogger().LogDebug(
-        fmt::format("Allocate an astra::InputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Allocate an astra::InputGate with following properties: {}", gate_info);
   }
 }
 
@@ -249,6 +250,11 @@ void InputGate<T>::EvaluateOnline() {
   } else if (my_id != 0) {
     auto input_message{input_future_.get()};
     auto payload{communication::GetMessage(input_message.data())->payload()};
+    // the helper party could send different values to both evaluators
+    auto& astra_provider{backend_.GetAstraProvider()};
+    if (input_owner_id_ == 0 && astra_provider.GetVerification()) {
+      astra_provider.Record(my_id == 1 ? 2 : 1, gate_id_, {payload->Data(), payload->size()});
+    }
     auto buffer = FromByteVector<T>({payload->Data(), payload->size()});
     assert(buffer.size() == values.size());
     for (auto i = 0u; i != buffer.size(); ++i) {
@@ -257,7 +263,7 @@ void InputGate<T>::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::InputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::InputGate with id#{}", gate_id_);
   }
 }
 
@@ -265,7 +271,7 @@ template <typename T>
 astra::SharePointer<T> InputGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class InputGate<std::uint8_t>;
@@ -331,6 +337,9 @@ void OutputGate<T>::EvaluateOnline() {
 
   auto& communication_layer = GetCommunicationLayer();
   auto my_id = static_cast<std::int64_t>(communication_layer.GetMyId());
+  // each party receives values which the third party knows as well
+  auto& astra_provider{backend_.GetAstraProvider()};
+  const bool verification{astra_provider.GetVerification()};
 
   switch (my_id) {
     case 0: {
@@ -338,6 +347,11 @@ void OutputGate<T>::EvaluateOnline() {
       for (auto i = 0u; i != message_lambda1s.size(); ++i) {
         message_lambda1s[i] = in_values[i].lambda1;
       }
+      if (verification && (output_owner_ == 1 || output_owner_ == kAll)) {
+        std::vector<T> lambda2s(in_values.size());
+        for (auto i = 0u; i != lambda2s.size(); ++i) lambda2s[i] = in_values[i].lambda2;
+        astra_provider.Record(1, gate_id_, ToByteVector<T>(lambda2s));
+      }
 
       // send output message
       if (output_owner_ == 2 || output_owner_ == kAll) {
@@ -350,6 +364,7 @@ void OutputGate<T>::EvaluateOnline() {
 
       const auto output_message{output_future_.get()};
       const auto payload{communication::GetMessage(output_message.data())->payload()};
+      if (verification) astra_provider.Record(2, gate_id_, {payload->Data(), payload->size()});
       auto received_values = FromByteVector<T>({payload->Data(), payload->size()});
       assert(received_values.size() == in_values.size());
       for (auto i = 0u; i != received_values.size(); ++i) {
@@ -370,10 +385,16 @@ void OutputGate<T>::EvaluateOnline() {
                                                  gate_id_, payload)};
         communication_layer.SendMessage(0, message.Release());
       }
+      if (verification && (output_owner_ == 2 || output_owner_ == kAll)) {
+        std::vector<T> lambda1s(in_values.size());
+        for (auto i = 0u; i != lambda1s.size(); ++i) lambda1s[i] = in_values[i].lambda1;
+        astra_provider.Record(2, gate_id_, ToByteVector<T>(lambda1s));
+      }
 
       if (output_owner_ == my_id || output_owner_ == kAll) {
         const auto message{output_future_.get()};
         const auto payload{communication::GetMessage(message.data())->payload()};
+        if (verification) astra_provider.Record(0, gate_id_, {payload->Data(), payload->size()});
         auto received_lambda2s = FromByteVector<T>({payload->Data(), payload->size()});
         assert(received_lambda2s.size() == in_values.size());
         for (auto i = 0u; i != received_lambda2s.size(); ++i) {
@@ -395,10 +416,16 @@ void OutputGate<T>::EvaluateOnline() {
                                                  gate_id_, payload)};
         communication_layer.SendMessage(1, message.Release());
       }
+      if (verification && (output_owner_ == 0 || output_owner_ == kAll)) {
+        std::vector<T> values(in_values.size());
+        for (auto i = 0u; i != values.size(); ++i) values[i] = in_values[i].value;
+        astra_provider.Record(0, gate_id_, ToByteVector<T>(values));
+      }
 
       if (output_owner_ == my_id || output_owner_ == kAll) {
         const auto message{output_future_.get()};
         const auto payload{communication::GetMessage(message.data())->payload()};
+        if (verification) astra_provider.Record(1, gate_id_, {payload->Data(), payload->size()});
         auto received_lambda1s = FromByteVector<T>({payload->Data(), payload->size()});
         assert(received_lambda1s.size() == in_values.size());
         for (auto i = 0u; i != received_lambda1s.size(); ++i) {
@@ -414,7 +441,7 @@ void OutputGate<T>::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::OutputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::OutputGate with id#{}", gate_id_);
   }
 }
 
@@ -422,7 +449,7 @@ template <typename T>
 astra::SharePointer<T> OutputGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class OutputGate<std::uint8_t>;
@@ -446,8 +473,7 @@ AdditionGate<T>::AdditionGate(const astra::WirePointer<T>& a, const astra::WireP
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                     parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created an astra::AdditionGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created an astra::AdditionGate with following properties: {}", gate_info);
   }
 }
 
@@ -538,7 +564,7 @@ void AdditionGate<T>::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::AdditionGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::AdditionGate with id#{}", gate_id_);
   }
 }
 
@@ -546,7 +572,7 @@ template <typename T>
 astra::SharePointer<T> AdditionGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class AdditionGate<std::uint8_t>;
@@ -570,8 +596,7 @@ SubtractionGate<T>::SubtractionGate(const astra::WirePointer<T>& a, const astra:
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                     parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created an astra::Subtraction with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created an astra::Subtraction with following properties: {}", gate_info);
   }
 }
 
@@ -660,7 +685,7 @@ void SubtractionGate<T>::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::SubtractionGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::SubtractionGate with id#{}", gate_id_);
   }
 }
 
@@ -668,7 +693,7 @@ template <typename T>
 astra::SharePointer<T> SubtractionGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class SubtractionGate<std::uint8_t>;
@@ -677,6 +702,272 @@ template class SubtractionGate<std::uint32_t>;
 template class SubtractionGate<std::uint64_t>;
 template class SubtractionGate<__uint128_t>;
 
+template <typename T>
+ConstantMultiplicationGate<T>::ConstantMultiplicationGate(const astra::WirePointer<T>& parent,
+                                                          std::vector<T> constants)
+    : Base(parent->GetBackend()), constants_(std::move(constants)) {
+  if (constants_.size() != parent->GetNumberOfSimdValues()) {
+    throw std::invalid_argument(fmt::format("Got {} constants for {} SIMD values",
+                                            constants_.size(), parent->GetNumberOfSimdValues()));
+  }
+  parent_ = {parent};
+
+  std::vector<typename astra::Wire<T>::value_type> v(parent->GetNumberOfSimdValues());
+  auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  output_wires_ = {std::move(w)};
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}", sizeof(T) * 8, gate_id_,
+                                 parent_.at(0)->GetWireId());
+    GetLogger().LogDebug(
+         "Created an astra::ConstantMultiplicationGate with following properties: {}", gate_info);
+  }
+}
+
+template <typename T>
+void ConstantMultiplicationGate<T>::EvaluateSetup() {
+  auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(out_wire);
+  auto in_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+  assert(in_wire);
+  in_wire->GetSetupReadyCondition()->Wait();
+
+  auto& out_values = out_wire->GetMutableValues();
+  auto const& in_values = in_wire->GetMutableValues();
+
+  // the shares of the mask that a party does not hold are unused
+  for (auto i = 0u; i != out_values.size(); ++i) {
+    out_values[i].lambda1 = constants_[i] * in_values[i].lambda1;
+    out_values[i].lambda2 = constants_[i] * in_values[i].lambda2;
+  }
+
+  out_wire->SetSetupIsReady();
+}
+
+template <typename T>
+void ConstantMultiplicationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  parent_.at(0)->GetIsReadyCondition().Wait();
+
+  auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(out_wire);
+  auto in_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+  assert(in_wire);
+
+  auto& out_values = out_wire->GetMutableValues();
+  auto const& in_values = in_wire->GetMutableValues();
+
+  if (GetCommunicationLayer().GetMyId() != 0) {
+    for (auto i = 0u; i != out_values.size(); ++i) {
+      out_values[i].value = constants_[i] * in_values[i].value;
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Evaluated astra::ConstantMultiplicationGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+astra::SharePointer<T> ConstantMultiplicationGate<T>::GetOutputAsAstraShare() {
+  auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
+}
+
+template class ConstantMultiplicationGate<std::uint8_t>;
+template class ConstantMultiplicationGate<std::uint16_t>;
+template class ConstantMultiplicationGate<std::uint32_t>;
+template class ConstantMultiplicationGate<std::uint64_t>;
+template class ConstantMultiplicationGate<__uint128_t>;
+
+template <typename T>
+TruncationGate<T>::TruncationGate(const astra::WirePointer<T>& parent, std::size_t number_of_bits)
+    : Base(parent->GetBackend()), number_of_bits_(number_of_bits) {
+  if (number_of_bits_ + 2 > sizeof(T) * 8) {
+    throw std::invalid_argument(fmt::format("Cannot truncate {} bits of a {}-bit value",
+                                            number_of_bits_, sizeof(T) * 8));
+  }
+  parent_ = {parent};
+
+  std::vector<typename astra::Wire<T>::value_type> v(parent->GetNumberOfSimdValues());
+  auto w = GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v));
+  output_wires_ = {std::move(w)};
+
+  std::size_t my_id{GetCommunicationLayer().GetMyId()};
+  auto& message_manager{GetCommunicationLayer().GetMessageManager()};
+  if (my_id == 1) {
+    truncation_future_online_ = message_manager.RegisterReceive(
+        2, communication::MessageType::kAstraOnlineTruncationGate, gate_id_);
+  } else if (my_id == 2) {
+    truncation_future_setup_ = message_manager.RegisterReceive(
+        0, communication::MessageType::kAstraSetupTruncationGate, gate_id_);
+    truncation_future_online_ = message_manager.RegisterReceive(
+        1, communication::MessageType::kAstraOnlineTruncationGate, gate_id_);
+  }
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("uint{}_t type, gate id {}, parent: {}, truncated bits: {}",
+                                 sizeof(T) * 8, gate_id_, parent_.at(0)->GetWireId(),
+                                 number_of_bits_);
+    GetLogger().LogDebug("Created an astra::TruncationGate with following properties: {}",
+                         gate_info);
+  }
+}
+
+template <typename T>
+void TruncationGate<T>::EvaluateSetup() {
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = communication_layer.GetMyId();
+  auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(out_wire);
+  auto a_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+  assert(a_wire);
+
+  a_wire->GetSetupReadyCondition()->Wait();
+
+  auto& out_values = out_wire->GetMutableValues();
+  const std::size_t number_of_simd{out_values.size()};
+
+  switch (my_id) {
+    case 0: {
+      // the output masks and evaluator 1's shares of the corrections
+      auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
+      auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
+      std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, 3 * number_of_simd);
+      std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, number_of_simd);
+      assert(randoms1.size() == 3 * number_of_simd);
+      assert(randoms2.size() == number_of_simd);
+
+      constexpr std::size_t kBitLength{sizeof(T) * 8};
+      constexpr T kLowerBits{std::numeric_limits<T>::max() >> 1};
+      auto const& a_values = a_wire->GetValues();
+      // evaluator 2's shares of the corrections
+      std::vector<T> message_corrections(2 * number_of_simd);
+      for (auto i = 0u; i != number_of_simd; ++i) {
+        auto& out = out_values[i];
+        out.lambda1 = randoms1[i];
+        out.lambda2 = randoms2[i];
+
+        const T lambda_a = a_values[i].lambda1 + a_values[i].lambda2;
+        const T msb_correction = static_cast<T>(lambda_a >> (kBitLength - 1))
+                                 << (kBitLength - 1 - number_of_bits_);
+        const T lower_mask = static_cast<T>(lambda_a & kLowerBits) >> number_of_bits_;
+        message_corrections[i] = msb_correction - randoms1[number_of_simd + i];
+        message_corrections[number_of_simd + i] = lower_mask - randoms1[2 * number_of_simd + i];
+      }
+
+      auto payload = ToByteVector<T>(message_corrections);
+      auto message{communication::BuildMessage(
+          communication::MessageType::kAstraSetupTruncationGate, gate_id_, payload)};
+      communication_layer.SendMessage(2, message.Release());
+      break;
+    }
+    case 1: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, 3 * number_of_simd);
+      assert(randoms0.size() == 3 * number_of_simd);
+      for (auto i = 0u; i != number_of_simd; ++i) out_values[i].lambda1 = randoms0[i];
+      msb_corrections_.assign(randoms0.begin() + number_of_simd,
+                              randoms0.begin() + 2 * number_of_simd);
+      lower_masks_.assign(randoms0.begin() + 2 * number_of_simd, randoms0.end());
+      break;
+    }
+    case 2: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, number_of_simd);
+      assert(randoms0.size() == number_of_simd);
+      for (auto i = 0u; i != number_of_simd; ++i) out_values[i].lambda2 = randoms0[i];
+
+      const auto message{truncation_future_setup_.get()};
+      const auto payload{communication::GetMessage(message.data())->payload()};
+      std::vector<T> message_corrections = FromByteVector<T>({payload->Data(), payload->size()});
+      assert(message_corrections.size() == 2 * number_of_simd);
+      msb_corrections_.assign(message_corrections.begin(),
+                              message_corrections.begin() + number_of_simd);
+      lower_masks_.assign(message_corrections.begin() + number_of_simd, message_corrections.end());
+      break;
+    }
+  }
+
+  out_wire->SetSetupIsReady();
+}
+
+template <typename T>
+void TruncationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+  parent_.at(0)->GetIsReadyCondition().Wait();
+
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = communication_layer.GetMyId();
+
+  if (my_id != 0) {
+    auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+    assert(out_wire);
+    auto a_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_.at(0));
+    assert(a_wire);
+
+    constexpr std::size_t kBitLength{sizeof(T) * 8};
+    constexpr T kLowerBits{std::numeric_limits<T>::max() >> 1};
+    // shifting x + 2^(l-2) instead of x makes the carry into the most significant bit of the
+    // masked value the only wrap-around
+    constexpr T kOffset{T(1) << (kBitLength - 2)};
+    const T offset_quotient = kOffset >> number_of_bits_;
+    const T msb_weight = static_cast<T>(T(1) << (kBitLength - 1 - number_of_bits_));
+
+    auto& out_values = out_wire->GetMutableValues();
+    auto const& a_values = a_wire->GetValues();
+    std::vector<T> message_values(out_values.size());
+    for (auto i = 0u; i != out_values.size(); ++i) {
+      auto& out = out_values[i];
+      const T masked_value = a_values[i].value + kOffset;
+      const bool msb = (masked_value >> (kBitLength - 1)) != 0;
+      // 2^(l-1-m) * (msb(v) ^ msb(lambda)) = msb(v) * 2^(l-1-m) +- 2^(l-1-m) * msb(lambda)
+      const T msb_correction = msb ? T(-msb_corrections_[i]) : msb_corrections_[i];
+      out.value = msb_correction - lower_masks_[i];
+      if (my_id == 1) {
+        out.value += static_cast<T>(masked_value & kLowerBits) >> number_of_bits_;
+        out.value += (msb ? msb_weight : T(0)) - offset_quotient + out.lambda1;
+      } else {
+        out.value += out.lambda2;
+      }
+      message_values[i] = out.value;
+    }
+
+    {
+      auto payload = ToByteVector<T>(message_values);
+      auto message{communication::BuildMessage(
+          communication::MessageType::kAstraOnlineTruncationGate, gate_id_, payload)};
+      communication_layer.SendMessage(my_id == 1 ? 2 : 1, message.Release());
+    }
+
+    const auto message{truncation_future_online_.get()};
+    const auto payload{communication::GetMessage(message.data())->payload()};
+    message_values = FromByteVector<T>({payload->Data(), payload->size()});
+    assert(message_values.size() == out_values.size());
+
+    for (auto i = 0u; i != out_values.size(); ++i) out_values[i].value += message_values[i];
+  }
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Evaluated astra::TruncationGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+astra::SharePointer<T> TruncationGate<T>::GetOutputAsAstraShare() {
+  auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
+  assert(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
+}
+
+template class TruncationGate<std::uint8_t>;
+template class TruncationGate<std::uint16_t>;
+template class TruncationGate<std::uint32_t>;
+template class TruncationGate<std::uint64_t>;
+template class TruncationGate<__uint128_t>;
+
 template <typename T>
 MultiplicationGate<T>::MultiplicationGate(const astra::WirePointer<T>& a,
                                           const astra::WirePointer<T>& b)
@@ -705,8 +996,8 @@ MultiplicationGate<T>::MultiplicationGate(const astra::WirePointer<T>& a,
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                     parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(fmt::format(
-        "Created an astra::MultiplicationGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created an astra::MultiplicationGate with following properties: {}",
+                         gate_info);
   }
 }
 
@@ -895,7 +1186,7 @@ void MultiplicationGate<T>::EvaluateOnline() {
     }
   }
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::MultiplicationGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::MultiplicationGate with id#{}", gate_id_);
   }
 }
 
@@ -903,7 +1194,7 @@ template <typename T>
 astra::SharePointer<T> MultiplicationGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class MultiplicationGate<std::uint8_t>;
@@ -1120,14 +1411,14 @@ void DotProductGate<T>::EvaluateOnline() {
     }
   }
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated astra::DotProductGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated astra::DotProductGate with id#{}", gate_id_);
   }
 }
 template <typename T>
 astra::SharePointer<T> DotProductGate<T>::GetOutputAsAstraShare() {
   auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_.at(0));
   assert(wire);
-  return std::make_shared<astra::Share<T>>(wire);
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(wire);
 }
 
 template class DotProductGate<std::uint8_t>;
@@ -1136,4 +1427,331 @@ template class DotProductGate<std::uint32_t>;
 template class DotProductGate<std::uint64_t>;
 template class DotProductGate<__uint128_t>;
 
+namespace {
+
+// side length of the square blocks in which the local matrix products are computed, s.t. a block
+// of each of the three matrices fits into the L2 cache for all supported types
+constexpr std::size_t kMatrixBlockSize{64};
+
+// c += a * b for a row-major m x k matrix a, k x n matrix b and m x n matrix c
+template <typename T>
+void MultiplyAccumulate(const T* a, const T* b, T* c, std::size_t m, std::size_t k,
+                        std::size_t n) {
+  // types smaller than unsigned int are multiplied as unsigned int, since their promotion to int
+  // may overflow
+  using U = std::conditional_t<(sizeof(T) < sizeof(unsigned)), unsigned, T>;
+  for (std::size_t i_0 = 0; i_0 < m; i_0 += kMatrixBlockSize) {
+    const std::size_t i_end{std::min(i_0 + kMatrixBlockSize, m)};
+    for (std::size_t l_0 = 0; l_0 < k; l_0 += kMatrixBlockSize) {
+      const std::size_t l_end{std::min(l_0 + kMatrixBlockSize, k)};
+      for (std::size_t j_0 = 0; j_0 < n; j_0 += kMatrixBlockSize) {
+        const std::size_t j_end{std::min(j_0 + kMatrixBlockSize, n)};
+        for (std::size_t i = i_0; i < i_end; ++i) {
+          T* c_row{c + i * n};
+          for (std::size_t l = l_0; l < l_end; ++l) {
+            const U a_il{a[i * k + l]};
+            const T* b_row{b + l * n};
+            for (std::size_t j = j_0; j < j_end; ++j) {
+              c_row[j] = static_cast<T>(c_row[j] + a_il * static_cast<U>(b_row[j]));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Gathers projection(value) of the wires of the entries of a row-major matrix into one contiguous
+// row-major matrix per SIMD value, i.e., entry e of SIMD value s is at s * wires.size() + e.
+template <typename T, typename Projection>
+std::vector<T> GatherMatrices(const std::vector<motion::WirePointer>& wires,
+                              std::size_t number_of_simd, Projection projection) {
+  std::vector<T> matrices(wires.size() * number_of_simd);
+  for (std::size_t entry = 0; entry < wires.size(); ++entry) {
+    auto wire = std::dynamic_pointer_cast<astra::Wire<T>>(wires[entry]);
+    assert(wire);
+    const auto& values{wire->GetValues()};
+    assert(values.size() == number_of_simd);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      matrices[simd_i * wires.size() + entry] = projection(values[simd_i]);
+    }
+  }
+  return matrices;
+}
+
+// Computes the product of the gathered matrices a and b in each SIMD value.
+template <typename T>
+std::vector<T> MultiplyMatrices(const std::vector<T>& a, const std::vector<T>& b, std::size_t m,
+                                std::size_t k, std::size_t n, std::size_t number_of_simd) {
+  std::vector<T> c(m * n * number_of_simd, 0);
+  for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+    MultiplyAccumulate(a.data() + simd_i * m * k, b.data() + simd_i * k * n,
+                       c.data() + simd_i * m * n, m, k, n);
+  }
+  return c;
+}
+
+}  // namespace
+
+template <typename T>
+MatrixMultiplicationGate<T>::MatrixMultiplicationGate(std::vector<motion::WirePointer> matrix_a,
+                                                      std::vector<motion::WirePointer> matrix_b,
+                                                      std::size_t number_of_rows,
+                                                      std::size_t number_of_columns)
+    : Base((assert(!matrix_a.empty()), matrix_a[0]->GetBackend())),
+      m_(number_of_rows),
+      k_(number_of_rows == 0 ? 0 : matrix_a.size() / number_of_rows),
+      n_(number_of_columns) {
+  if (m_ == 0 || n_ == 0 || m_ * k_ != matrix_a.size() || k_ * n_ != matrix_b.size()) {
+    throw std::invalid_argument(fmt::format(
+        "Cannot multiply a matrix of {} entries with {} rows by a matrix of {} entries with {} "
+        "columns",
+        matrix_a.size(), m_, matrix_b.size(), n_));
+  }
+  parent_a_ = std::move(matrix_a);
+  parent_b_ = std::move(matrix_b);
+
+  const auto number_of_simd_values = parent_a_[0]->GetNumberOfSimdValues();
+  for (const auto& wire : parent_a_) assert(wire->GetNumberOfSimdValues() == number_of_simd_values);
+  for (const auto& wire : parent_b_) assert(wire->GetNumberOfSimdValues() == number_of_simd_values);
+
+  output_wires_.reserve(m_ * n_);
+  for (std::size_t entry = 0; entry < m_ * n_; ++entry) {
+    std::vector<typename astra::Wire<T>::value_type> v(number_of_simd_values);
+    output_wires_.emplace_back(
+        GetRegister().template EmplaceWire<astra::Wire<T>>(backend_, std::move(v)));
+  }
+
+  std::size_t my_id{GetCommunicationLayer().GetMyId()};
+  auto& message_manager{GetCommunicationLayer().GetMessageManager()};
+  if (my_id == 1) {
+    matrix_multiplication_future_online_ = message_manager.RegisterReceive(
+        2, communication::MessageType::kAstraOnlineMatrixMultiplicationGate, gate_id_);
+  } else if (my_id == 2) {
+    matrix_multiplication_future_setup_ = message_manager.RegisterReceive(
+        0, communication::MessageType::kAstraSetupMatrixMultiplicationGate, gate_id_);
+    matrix_multiplication_future_online_ = message_manager.RegisterReceive(
+        1, communication::MessageType::kAstraOnlineMatrixMultiplicationGate, gate_id_);
+  }
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("uint{}_t type, gate id {}, dimensions: {}x{} * {}x{}",
+                                 sizeof(T) * 8, gate_id_, m_, k_, k_, n_);
+    GetLogger().LogDebug("Created an astra::MatrixMultiplicationGate with following properties: {}",
+                         gate_info);
+  }
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateSetup() {
+  for (auto i = 0u; i != parent_a_.size(); ++i) {
+    auto a_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_a_[i]);
+    assert(a_wire);
+    a_wire->GetSetupReadyCondition()->Wait();
+  }
+  for (auto i = 0u; i != parent_b_.size(); ++i) {
+    auto b_wire = std::dynamic_pointer_cast<astra::Wire<T>>(parent_b_[i]);
+    assert(b_wire);
+    b_wire->GetSetupReadyCondition()->Wait();
+  }
+
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = communication_layer.GetMyId();
+  const std::size_t number_of_simd{output_wires_.at(0)->GetNumberOfSimdValues()};
+  const std::size_t number_of_entries{m_ * n_};
+  // all values of the output are laid out entry after entry as the output wires
+  const std::size_t number_of_values{number_of_entries * number_of_simd};
+
+  switch (my_id) {
+    case 0: {
+      auto& rng1 = GetBaseProvider().GetMyRandomnessGenerator(1);
+      auto& rng2 = GetBaseProvider().GetMyRandomnessGenerator(2);
+      std::vector<T> randoms1 = rng1.template GetUnsigned<T>(gate_id_, 2 * number_of_values);
+      std::vector<T> randoms2 = rng2.template GetUnsigned<T>(gate_id_, number_of_values);
+      assert(randoms1.size() == 2 * number_of_values);
+      assert(randoms2.size() == number_of_values);
+
+      auto lambda = [](const auto& x) -> T { return x.lambda1 + x.lambda2; };
+      const auto lambda_a{GatherMatrices<T>(parent_a_, number_of_simd, lambda)};
+      const auto lambda_b{GatherMatrices<T>(parent_b_, number_of_simd, lambda)};
+      const auto gamma_ab{MultiplyMatrices(lambda_a, lambda_b, m_, k_, n_, number_of_simd)};
+
+      std::vector<T> message_gamma_ab_2(number_of_values);
+      for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+        auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_[entry]);
+        assert(out_wire);
+        auto& out_values = out_wire->GetMutableValues();
+        for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+          const std::size_t i{entry * number_of_simd + simd_i};
+          out_values[simd_i].lambda1 = randoms1[i];
+          out_values[simd_i].lambda2 = randoms2[i];
+          const T gamma_ab_1{randoms1[number_of_values + i]};
+          message_gamma_ab_2[i] = gamma_ab[simd_i * number_of_entries + entry] - gamma_ab_1;
+        }
+      }
+
+      auto payload = ToByteVector<T>(message_gamma_ab_2);
+      auto message{communication::BuildMessage(
+          communication::MessageType::kAstraSetupMatrixMultiplicationGate, gate_id_, payload)};
+      communication_layer.SendMessage(2, message.Release());
+      break;
+    }
+    case 1: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, 2 * number_of_values);
+      assert(randoms0.size() == 2 * number_of_values);
+
+      for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+        auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_[entry]);
+        assert(out_wire);
+        auto& out_values = out_wire->GetMutableValues();
+        for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+          const std::size_t i{entry * number_of_simd + simd_i};
+          out_values[simd_i].lambda1 = randoms0[i];
+          // We store gamma_ab_1 in the free out.lambda2 space
+          out_values[simd_i].lambda2 = randoms0[number_of_values + i];
+        }
+      }
+      break;
+    }
+    case 2: {
+      auto& rng0 = GetBaseProvider().GetTheirRandomnessGenerator(0);
+      std::vector<T> randoms0 = rng0.template GetUnsigned<T>(gate_id_, number_of_values);
+      assert(randoms0.size() == number_of_values);
+
+      const auto message{matrix_multiplication_future_setup_.get()};
+      const auto payload{communication::GetMessage(message.data())->payload()};
+      std::vector<T> message_gamma_ab_2 = FromByteVector<T>({payload->Data(), payload->size()});
+      assert(message_gamma_ab_2.size() == number_of_values);
+
+      for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+        auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_[entry]);
+        assert(out_wire);
+        auto& out_values = out_wire->GetMutableValues();
+        for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+          const std::size_t i{entry * number_of_simd + simd_i};
+          out_values[simd_i].lambda2 = randoms0[i];
+          // We store gamma_ab_2 in the free out.lambda1 space
+          out_values[simd_i].lambda1 = message_gamma_ab_2[i];
+        }
+      }
+      break;
+    }
+  }
+
+  for (auto& wire : output_wires_) {
+    auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(wire);
+    assert(out_wire);
+    out_wire->SetSetupIsReady();
+  }
+}
+
+template <typename T>
+void MatrixMultiplicationGate<T>::EvaluateOnline() {
+  WaitSetup();
+  assert(setup_is_ready_);
+
+  for (auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  for (auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
+
+  auto& communication_layer = GetCommunicationLayer();
+  auto my_id = communication_layer.GetMyId();
+
+  if (my_id != 0) {
+    const std::size_t number_of_simd{output_wires_.at(0)->GetNumberOfSimdValues()};
+    const std::size_t number_of_entries{m_ * n_};
+    const std::size_t number_of_values{number_of_entries * number_of_simd};
+
+    // party 1 computes -(a.value * b.lambda1) - b.value * a.lambda1 and party 2
+    // a.value * b.value - a.value * b.lambda2 - b.value * a.lambda2 summed over the inner
+    // dimension, which are two matrix products each
+    auto value = [](const auto& x) -> T { return x.value; };
+    std::vector<T> products;
+    switch (my_id) {
+      case 1: {
+        auto minus_value = [](const auto& x) -> T { return -x.value; };
+        auto minus_lambda = [](const auto& x) -> T { return -x.lambda1; };
+        auto lambda = [](const auto& x) -> T { return x.lambda1; };
+        products = MultiplyMatrices(GatherMatrices<T>(parent_a_, number_of_simd, minus_value),
+                                    GatherMatrices<T>(parent_b_, number_of_simd, lambda), m_, k_,
+                                    n_, number_of_simd);
+        const auto minus_lambda_a{GatherMatrices<T>(parent_a_, number_of_simd, minus_lambda)};
+        const auto value_b{GatherMatrices<T>(parent_b_, number_of_simd, value)};
+        for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+          MultiplyAccumulate(minus_lambda_a.data() + simd_i * m_ * k_,
+                             value_b.data() + simd_i * k_ * n_,
+                             products.data() + simd_i * number_of_entries, m_, k_, n_);
+        }
+        break;
+      }
+      case 2: {
+        auto value_minus_lambda = [](const auto& x) -> T { return x.value - x.lambda2; };
+        auto minus_lambda = [](const auto& x) -> T { return -x.lambda2; };
+        products = MultiplyMatrices(
+            GatherMatrices<T>(parent_a_, number_of_simd, value),
+            GatherMatrices<T>(parent_b_, number_of_simd, value_minus_lambda), m_, k_, n_,
+            number_of_simd);
+        const auto minus_lambda_a{GatherMatrices<T>(parent_a_, number_of_simd, minus_lambda)};
+        const auto value_b{GatherMatrices<T>(parent_b_, number_of_simd, value)};
+        for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+          MultiplyAccumulate(minus_lambda_a.data() + simd_i * m_ * k_,
+                             value_b.data() + simd_i * k_ * n_,
+                             products.data() + simd_i * number_of_entries, m_, k_, n_);
+        }
+        break;
+      }
+      default: {
+        assert(false);
+      }
+    }
+
+    std::vector<T> message_values(number_of_values);
+    for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+      auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_[entry]);
+      assert(out_wire);
+      auto& out_values = out_wire->GetMutableValues();
+      for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+        auto& out = out_values[simd_i];
+        out.value = products[simd_i * number_of_entries + entry] + out.lambda1 + out.lambda2;
+        message_values[entry * number_of_simd + simd_i] = out.value;
+      }
+    }
+
+    {
+      auto payload = ToByteVector<T>(message_values);
+      auto message{communication::BuildMessage(
+          communication::MessageType::kAstraOnlineMatrixMultiplicationGate, gate_id_, payload)};
+      communication_layer.SendMessage(my_id == 1 ? 2 : 1, message.Release());
+    }
+
+    const auto message{matrix_multiplication_future_online_.get()};
+    const auto payload{communication::GetMessage(message.data())->payload()};
+    message_values = FromByteVector<T>({payload->Data(), payload->size()});
+    assert(message_values.size() == number_of_values);
+
+    for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+      auto out_wire = std::dynamic_pointer_cast<astra::Wire<T>>(output_wires_[entry]);
+      assert(out_wire);
+      auto& out_values = out_wire->GetMutableValues();
+      for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+        out_values[simd_i].value += message_values[entry * number_of_simd + simd_i];
+      }
+    }
+  }
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Evaluated astra::MatrixMultiplicationGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+astra::SharePointer<T> MatrixMultiplicationGate<T>::GetOutputAsAstraShare() {
+  return backend_.GetRegister()->EmplaceShared<astra::Share<T>>(output_wires_);
+}
+
+template class MatrixMultiplicationGate<std::uint8_t>;
+template class MatrixMultiplicationGate<std::uint16_t>;
+template class MatrixMultiplicationGate<std::uint32_t>;
+template class MatrixMultiplicationGate<std::uint64_t>;
+template class MatrixMultiplicationGate<__uint128_t>;
+
 }  // namespace encrypto::motion::proto::astra
@@ -44,6 +44,8 @@ class InputGate final : public motion::InputGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
   
   astra::SharePointer<T> GetOutputAsAstraShare();
   
@@ -64,6 +66,7 @@ class OutputGate final : public motion::OutputGate {
 
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
   
@@ -84,6 +87,10 @@ class AdditionGate final : public TwoGate {
   
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
+  
+  bool IsLocal() const final override { return true; }
   
   astra::SharePointer<T> GetOutputAsAstraShare();
 };
@@ -99,8 +106,73 @@ class SubtractionGate final : public TwoGate {
   
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
   
+  bool IsLocal() const final override { return true; }
+  
+  astra::SharePointer<T> GetOutputAsAstraShare();
+};
+
+/// \brief Multiplication by public constants, which is local since the masked value and the
+/// shares of its mask are multiplied by the constant.
+template <typename T>
+class ConstantMultiplicationGate final : public OneGate {
+  using Base = motion::OneGate;
+
+ public:
+  /// \param constants the constant of each SIMD value of parent
+  ConstantMultiplicationGate(const astra::WirePointer<T>& parent, std::vector<T> constants);
+
+  ~ConstantMultiplicationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
+
+  bool IsLocal() const final override { return true; }
+
   astra::SharePointer<T> GetOutputAsAstraShare();
+
+ private:
+  std::vector<T> constants_;
+};
+
+/// \brief Probabilistic truncation, i.e., arithmetic shift of the two's complement values x to the
+/// right by m bits, s.t. the result is floor(x / 2^m) + b for an error b in {0, 1}.  Requires
+/// -2^(l-2) <= x < 2^(l-2) and m <= l - 2 for the bit length l of T.
+///
+/// The evaluators shift the lower l - 1 bits of the public masked value v + 2^(l-2) locally.  The
+/// carry into its most significant bit, which depends on the most significant bit of the mask, and
+/// the shifted lower bits of the mask are corrected by additive shares that the helper party
+/// distributes in the setup phase, and the resulting additive shares of the evaluators are masked
+/// and exchanged in a single online round.
+template <typename T>
+class TruncationGate final : public OneGate {
+  using Base = motion::OneGate;
+
+ public:
+  TruncationGate(const astra::WirePointer<T>& parent, std::size_t number_of_bits);
+
+  ~TruncationGate() final = default;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  bool HasIndependentSetup() const final override { return true; }
+
+  astra::SharePointer<T> GetOutputAsAstraShare();
+
+ private:
+  std::size_t number_of_bits_;
+
+  // evaluator's additive shares of 2^(l-1-m) * msb(lambda) and of (lambda mod 2^(l-1)) >> m
+  std::vector<T> msb_corrections_, lower_masks_;
+
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> truncation_future_setup_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> truncation_future_online_;
 };
 
 template<typename T>
@@ -114,6 +186,9 @@ class MultiplicationGate final : public TwoGate {
   
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
   
   astra::SharePointer<T> GetOutputAsAstraShare();
   
@@ -134,6 +209,9 @@ class DotProductGate final : public TwoGate {
   
   void EvaluateSetup() final override;
   void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
   
   astra::SharePointer<T> GetOutputAsAstraShare();
   
@@ -142,5 +220,41 @@ class DotProductGate final : public TwoGate {
   motion::ReusableFiberFuture<std::vector<std::uint8_t>> dot_product_future_online_;
 };
 
+/// \brief Multiplies an m x k matrix by a k x n matrix in each SIMD value.
+///
+/// The matrices are given as the wires of their entries in row-major order, where each wire holds
+/// one value of the matrix per SIMD value, and the output wires are the m * n entries of the
+/// product in row-major order.  Unlike composing the product from m * n DotProductGates, the gate
+/// sends a single setup and a single online message for the whole matrix and computes the local
+/// products of the value and lambda matrices by cache-blocked kernels.
+template <typename T>
+class MatrixMultiplicationGate final : public TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  MatrixMultiplicationGate(std::vector<motion::WirePointer> matrix_a,
+                           std::vector<motion::WirePointer> matrix_b, std::size_t number_of_rows,
+                           std::size_t number_of_columns);
+
+  ~MatrixMultiplicationGate() final = default;
+
+  MatrixMultiplicationGate(MatrixMultiplicationGate&) = delete;
+
+  void EvaluateSetup() final override;
+  void EvaluateOnline() final override;
+
+  bool HasIndependentSetup() const final override { return true; }
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  astra::SharePointer<T> GetOutputAsAstraShare();
+
+ private:
+  // number of rows of A, columns of A resp. rows of B, and columns of B
+  std::size_t m_, k_, n_;
+
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> matrix_multiplication_future_setup_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> matrix_multiplication_future_online_;
+};
+
     
 } //namespace encrypto::motion::proto::astra
\ No newline at end of file
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "astra_provider.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "primitives/blake2b.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion::proto::astra {
+
+Provider::Provider(communication::CommunicationLayer& communication_layer)
+    : communication_layer_(communication_layer) {}
+
+Provider::~Provider() {}
+
+void Provider::SetVerification(bool value) {
+  if (value && communication_layer_.GetNumberOfParties() != 3) {
+    throw std::invalid_argument("ASTRA verification needs exactly 3 parties");
+  }
+  if (value && !verification_) {
+    records_.resize(communication_layer_.GetNumberOfParties());
+    RegisterVerification();
+  }
+  verification_ = value;
+}
+
+void Provider::RegisterVerification() {
+  const auto my_id{communication_layer_.GetMyId()};
+  auto& message_manager{communication_layer_.GetMessageManager()};
+  verification_futures_.clear();
+  verification_futures_.resize(communication_layer_.GetNumberOfParties());
+  for (std::size_t party_id = 0; party_id < verification_futures_.size(); ++party_id) {
+    if (party_id == my_id) continue;
+    verification_futures_[party_id] = message_manager.RegisterReceive(
+        party_id, communication::MessageType::kAstraVerification, next_message_id_);
+  }
+}
+
+void Provider::Record(std::size_t other_party, std::size_t gate_id,
+                      std::span<const std::uint8_t> data) {
+  assert(verification_);
+  assert(other_party < records_.size());
+  assert(other_party != communication_layer_.GetMyId());
+  std::array<std::uint8_t, EVP_MAX_MD_SIZE> digest;
+  Blake2b(const_cast<std::uint8_t*>(data.data()), digest.data(), data.size());
+  std::pair<std::size_t, std::array<std::uint8_t, kDigestSize>> record{gate_id, {}};
+  std::copy_n(digest.begin(), kDigestSize, record.second.begin());
+  std::scoped_lock lock(records_mutex_);
+  records_[other_party].emplace_back(std::move(record));
+}
+
+void Provider::Verify() {
+  if (!verification_) return;
+  const auto my_id{communication_layer_.GetMyId()};
+  std::vector<std::array<std::uint8_t, EVP_MAX_MD_SIZE>> digests(records_.size());
+  for (std::size_t party_id = 0; party_id < records_.size(); ++party_id) {
+    if (party_id == my_id) continue;
+    // the gates are evaluated in a different order by each party
+    auto& records{records_[party_id]};
+    std::sort(records.begin(), records.end());
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(records.size() * (sizeof(std::size_t) + kDigestSize));
+    for (const auto& [gate_id, digest] : records) {
+      const auto gate_id_bytes{reinterpret_cast<const std::uint8_t*>(&gate_id)};
+      buffer.insert(buffer.end(), gate_id_bytes, gate_id_bytes + sizeof(gate_id));
+      buffer.insert(buffer.end(), digest.begin(), digest.end());
+    }
+    Blake2b(buffer.data(), digests[party_id].data(), buffer.size());
+    records.clear();
+
+    std::span payload(static_cast<const std::uint8_t*>(digests[party_id].data()), kDigestSize);
+    auto message{communication::BuildMessage(communication::MessageType::kAstraVerification,
+                                             next_message_id_, payload)};
+    communication_layer_.SendMessage(party_id, message.Release());
+  }
+
+  std::optional<std::size_t> inconsistent_party;
+  for (std::size_t party_id = 0; party_id < records_.size(); ++party_id) {
+    if (party_id == my_id) continue;
+    const auto message{verification_futures_[party_id].get()};
+    const auto payload{communication::GetMessage(message.data())->payload()};
+    if (payload->size() != kDigestSize ||
+        std::memcmp(payload->data(), digests[party_id].data(), kDigestSize) != 0) {
+      inconsistent_party = party_id;
+    }
+  }
+
+  // prepare the verification of the next evaluation of the circuit, see Backend::Clear
+  ++next_message_id_;
+  RegisterVerification();
+
+  if (inconsistent_party) {
+    throw std::runtime_error(fmt::format(
+        "ASTRA verification failed: the messages are inconsistent with party {}, abort",
+        *inconsistent_party));
+  }
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug("ASTRA verification succeeded");
+  }
+}
+
+}  // namespace encrypto::motion::proto::astra
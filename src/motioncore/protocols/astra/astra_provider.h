@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <boost/fiber/mutex.hpp>
+
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::proto::astra {
+
+/// \brief Checks the consistency of the ASTRA messages that a third party can recompute.  Values
+/// that one party sends to another and that the third party knows as well, i.e., the masked values
+/// of the helper party's inputs and the values and masks sent in output gates, are recorded by the
+/// receiver and by the third party alike.  Instead of checking every gate, the records are hashed
+/// and the digests are compared once per circuit evaluation, which costs one short message per
+/// pair of parties independent of the size of the circuit.
+///
+/// This is not security against a malicious party: the masked values computed by the evaluators
+/// in multiplication gates are known to no other party and thus are not covered, s.t. an evaluator
+/// can add an error to any product without being detected.  Covering them needs a sharing in which
+/// each online message is known to two parties, which ASTRA does not have.
+class Provider {
+ public:
+  using future_type = ReusableFiberFuture<std::vector<std::uint8_t>>;
+  // BLAKE2b-512
+  static constexpr std::size_t kDigestSize{64};
+
+  Provider(communication::CommunicationLayer& communication_layer);
+  ~Provider();
+
+  /// \brief Enables the consistency check of the circuits.  Needs to be set to the same value by
+  /// all parties before constructing the circuit.
+  void SetVerification(bool value = true);
+
+  bool GetVerification() const noexcept { return verification_; }
+
+  /// \brief Records \p data of gate \p gate_id, which party \p other_party records as well.
+  void Record(std::size_t other_party, std::size_t gate_id, std::span<const std::uint8_t> data);
+
+  /// \brief Compares the digests of the records with the other parties after the online phase
+  /// and throws std::runtime_error if any of them differ, which aborts the evaluation.
+  void Verify();
+
+ private:
+  void RegisterVerification();
+
+  bool verification_{false};
+
+  // other party -> (gate id, digest of the recorded data)
+  std::vector<std::vector<std::pair<std::size_t, std::array<std::uint8_t, kDigestSize>>>>
+      records_;
+  // gates record their data concurrently
+  boost::fibers::mutex records_mutex_;
+
+  // indexed by the other party
+  std::vector<future_type> verification_futures_;
+
+  // message ids are not reused, s.t. each evaluation of the circuit is verified on its own
+  std::size_t next_message_id_{0};
+
+  communication::CommunicationLayer& communication_layer_;
+};
+
+}  // namespace encrypto::motion::proto::astra
@@ -56,6 +56,8 @@ class Wire final : public motion::Wire {
   virtual bool IsConstant() const noexcept final { return false; };
   
   virtual std::size_t GetBitLength() const final { return sizeof(T) * 8; };
+
+  std::size_t GetNumberOfBytes() const final { return values_.size() * sizeof(Data); }
   
   const std::vector<Data>& GetValues() const { return values_; }
   
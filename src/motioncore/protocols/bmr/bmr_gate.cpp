@@ -29,6 +29,7 @@
 #include <span>
 
 #include "base/backend.h"
+#include "base/configuration.h"
 #include "base/motion_base_provider.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
@@ -37,9 +38,23 @@
 #include "primitives/pseudo_random_generator.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "utility/block.h"
+#include "utility/helpers.h"
 
 namespace encrypto::motion::proto::bmr {
 
+namespace {
+
+// minimum number of DKC invocations per thread for which using more threads pays off
+constexpr std::size_t kMinimumNumberOfDkcsPerThread{4096};
+
+std::size_t GetNumberOfDkcThreads(const Configuration& configuration,
+                                  std::size_t number_of_dkcs) {
+  return std::max<std::size_t>(
+      1, std::min(number_of_dkcs / kMinimumNumberOfDkcsPerThread, configuration.GetNumOfThreads()));
+}
+
+}  // namespace
+
 InputGate::InputGate(std::size_t number_of_simd, std::size_t bit_size, std::size_t input_owner_id,
                      Backend& backend)
     : InputGate::Base(backend), number_of_simd_(number_of_simd), bit_size_(bit_size) {
@@ -93,6 +108,7 @@ void InputGate::InitializationHelper() {
   assert(gate_id_ >= 0);
 
   auto& bmr_provider = backend_.GetBmrProvider();
+  inputs_in_setup_ = bmr_provider.GetInputsInSetup();
 
   // if this is someone else's input, prepare for receiving the *public values*
   // (if it is our's then we would compute it ourselves)
@@ -105,15 +121,13 @@ void InputGate::InitializationHelper() {
 
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, input owner {}", gate_id_, input_owner_id_);
-    GetLogger().LogDebug(
-        fmt::format("Created a bmr::InputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a bmr::InputGate with following properties: {}", gate_info);
   }
 }
 
 void InputGate::EvaluateSetup() {
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating setup phase of bmr::InputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating setup phase of bmr::InputGate with id#{}", gate_id_);
   }
 
   const auto my_id = GetCommunicationLayer().GetMyId();
@@ -147,15 +161,17 @@ void InputGate::EvaluateSetup() {
       if (!keys_0.empty()) keys_0.erase(keys_0.size() - 1);
       if (!keys_1.empty()) keys_1.erase(keys_1.size() - 1);
 
-      GetLogger().LogTrace(
-          fmt::format("Created a BMR wire #{} with permutation bits {}, keys 0 {}, "
-                      "and keys 1 {}",
-                      wire->GetWireId(), wire->GetPermutationBits().AsString(), keys_0, keys_1));
+      GetLogger().LogTrace("Created a BMR wire #{} with permutation bits {}, keys 0 {}, "
+                           "and keys 1 {}",
+                           wire->GetWireId(), wire->GetPermutationBits().AsString(), keys_0,
+                           keys_1);
     }
   }
+  // the gates reading the output wires only need the keys and permutation bits in their setup
+  // phases, so they are not blocked while the inputs are published
+  if (inputs_in_setup_) PublishInputs();
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating setup phase of bmr::InputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating setup phase of bmr::InputGate with id#{}", gate_id_);
   }
 }
 
@@ -163,10 +179,25 @@ void InputGate::EvaluateOnline() {
   WaitSetup();
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating online phase of bmr::InputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of bmr::InputGate with id#{}", gate_id_);
+  }
+
+  if (!inputs_in_setup_) PublishInputs();
+
+  for (auto& wire : output_wires_) {
+    const auto bmr_wire = std::dynamic_pointer_cast<const bmr::Wire>(wire);
+    assert(bmr_wire);
+    assert(!bmr_wire->GetPermutationBits().Empty());
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Finished evaluating online phase of bmr::InputGate with id#{}", gate_id_);
   }
 
+  assert(!online_is_ready_);
+}
+
+void InputGate::PublishInputs() {
   const auto& R = backend_.GetBmrProvider().GetGlobalOffset();
   auto& communication_layer = GetCommunicationLayer();
   const auto my_id = communication_layer.GetMyId();
@@ -217,16 +248,10 @@ void InputGate::EvaluateOnline() {
     const auto wire = std::dynamic_pointer_cast<const bmr::Wire>(output_wires_.at(wire_i));
     assert(wire);
     const auto& keys = wire->GetSecretKeys();
-    // copy the "0 keys" into the buffer
-    std::copy(std::begin(keys), std::end(keys),
-              std::begin(my_keys_buffer) + wire_i * number_of_simd);
     const auto& public_values = wire->GetPublicValues();
-    for (auto simd_j = 0ull; simd_j < number_of_simd; ++simd_j) {
-      // xor the offset on a key if the corresponding public value is 1
-      if (public_values[simd_j]) {
-        my_keys_buffer.at(wire_i * number_of_simd + simd_j) ^= R;
-      }
-    }
+    // copy the "0 keys" into the buffer and xor the offset on the keys whose public value is 1
+    ConditionalXorBlocks(my_keys_buffer.data() + wire_i * number_of_simd, keys.data(),
+                         public_values.GetData().data(), R, number_of_simd);
   }
 
   // send the selected keys to all other parties
@@ -299,22 +324,10 @@ void InputGate::EvaluateOnline() {
     }
     GetLogger().LogTrace(s);
   }
-  if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating online phase of bmr::InputGate with id#{}", gate_id_));
-  }
-
-  for (auto& wire : output_wires_) {
-    const auto bmr_wire = std::dynamic_pointer_cast<const bmr::Wire>(wire);
-    assert(bmr_wire);
-    assert(!bmr_wire->GetPermutationBits().Empty());
-  }
-
-  assert(!online_is_ready_);
 }
 
 const bmr::SharePointer InputGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -367,7 +380,7 @@ OutputGate::OutputGate(const motion::SharePointer& parent, std::size_t output_ow
     w = GetRegister().EmplaceWire<boolean_gmw::Wire>(dummy_bitvector, backend_);
   }
 
-  gmw_output_share_ = std::make_shared<boolean_gmw::Share>(gmw_wires);
+  gmw_output_share_ = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(gmw_wires);
   output_gate_ =
       GetRegister().EmplaceGate<boolean_gmw::OutputGate>(gmw_output_share_, output_owner_);
 
@@ -383,8 +396,7 @@ OutputGate::OutputGate(const motion::SharePointer& parent, std::size_t output_ow
   if constexpr (kDebug) {
     auto gate_info =
         fmt::format("bitlength {}, gate id {}, owner {}", output_.size(), gate_id_, output_owner_);
-    GetLogger().LogDebug(
-        fmt::format("Created a BMR OutputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BMR OutputGate with following properties: {}", gate_info);
   }
 }
 
@@ -395,8 +407,8 @@ void OutputGate::EvaluateOnline() {
   std::size_t i;
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Starting online phase evaluation for BMR OutputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Starting online phase evaluation for BMR OutputGate with id#{}",
+                         gate_id_);
   }
 
   auto& wires = gmw_output_share_->GetMutableWires();
@@ -433,13 +445,12 @@ void OutputGate::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Evaluated online phase of BMR OutputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated online phase of BMR OutputGate with id#{}", gate_id_);
   }
 }
 
 const bmr::SharePointer OutputGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -470,15 +481,13 @@ XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
                                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created a BMR XOR gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BMR XOR gate with following properties: {}", gate_info);
   }
 }
 
 void XorGate::EvaluateSetup() {
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating setup phase of BMR XOR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating setup phase of BMR XOR Gate with id#{}", gate_id_);
   }
 
   for (auto i = 0ull; i < output_wires_.size(); ++i) {
@@ -498,16 +507,14 @@ void XorGate::EvaluateSetup() {
     bmr_output->SetSetupIsReady();
   }
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating setup phase of BMR XOR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating setup phase of BMR XOR Gate with id#{}", gate_id_);
   }
 }
 
 void XorGate::EvaluateOnline() {
   WaitSetup();
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating online phase of BMR XOR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of BMR XOR Gate with id#{}", gate_id_);
   }
 
   for (auto i = 0ull; i < parent_a_.size(); ++i) {
@@ -528,8 +535,7 @@ void XorGate::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating online phase of BMR XOR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating online phase of BMR XOR Gate with id#{}", gate_id_);
   }
 
   for (auto& wire : output_wires_) {
@@ -542,7 +548,7 @@ void XorGate::EvaluateOnline() {
 }
 
 const bmr::SharePointer XorGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -572,15 +578,13 @@ InvGate::InvGate(const motion::SharePointer& parent) : OneGate(parent->GetBacken
     for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
     gate_info.append(" output wires: ");
     for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
-    GetLogger().LogDebug(
-        fmt::format("Created a BMR INV gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BMR INV gate with following properties: {}", gate_info);
   }
 }
 
 void InvGate::EvaluateSetup() {
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating setup phase of BMR INV Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating setup phase of BMR INV Gate with id#{}", gate_id_);
   }
 
   auto& communication_layer = GetCommunicationLayer();
@@ -607,16 +611,14 @@ void InvGate::EvaluateSetup() {
     bmr_output->SetSetupIsReady();
   }
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating setup phase of BMR INV Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating setup phase of BMR INV Gate with id#{}", gate_id_);
   }
 }
 
 void InvGate::EvaluateOnline() {
   WaitSetup();
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating online phase of BMR INV Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of BMR INV Gate with id#{}", gate_id_);
   }
 
   for (auto i = 0ull; i < parent_.size(); ++i) {
@@ -634,8 +636,7 @@ void InvGate::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating online phase of BMR INV Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating online phase of BMR INV Gate with id#{}", gate_id_);
   }
 
   for (auto& wire : output_wires_) {
@@ -648,7 +649,7 @@ void InvGate::EvaluateOnline() {
 }
 
 const bmr::SharePointer InvGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -683,42 +684,39 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
     w = GetRegister().template EmplaceWire<bmr::Wire>(tmp_bv, backend_);
   }
 
+  // the OTs of all wires are registered as one contiguous batch per party, structure:
+  // wires X simd for the 1-bit C-OTs and wires X simd X 3 for the string C-OTs
+  const auto number_of_values{number_of_wires * number_of_simd};
   sender_ots_1_.resize(number_of_parties);
-  for (auto& v : sender_ots_1_) v.resize(number_of_wires);
   sender_ots_kappa_.resize(number_of_parties);
-  for (auto& v : sender_ots_kappa_) v.resize(number_of_wires);
   receiver_ots_1_.resize(number_of_parties);
-  for (auto& v : receiver_ots_1_) v.resize(number_of_wires);
   receiver_ots_kappa_.resize(number_of_parties);
-  for (auto& v : receiver_ots_kappa_) v.resize(number_of_wires);
-  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
-    for (auto party_j = 0ull; party_j < number_of_parties; ++party_j) {
-      if (party_j == my_id) continue;
-      // we need 1 bit C-OT and ...
-      sender_ots_1_.at(party_j).at(wire_i) =
-          GetOtProvider(party_j).RegisterSendXcOtBit(number_of_simd);
-      receiver_ots_1_.at(party_j).at(wire_i) =
-          GetOtProvider(party_j).RegisterReceiveXcOtBit(number_of_simd);
-      // ... 3 string C-OTs per gate (in each direction)
-      sender_ots_kappa_.at(party_j).at(wire_i) =
-          GetOtProvider(party_j).RegisterSendFixedXcOt128(3 * number_of_simd);
-      receiver_ots_kappa_.at(party_j).at(wire_i) =
-          GetOtProvider(party_j).RegisterReceiveFixedXcOt128(3 * number_of_simd);
-    }
+  for (auto party_j = 0ull; party_j < number_of_parties; ++party_j) {
+    if (party_j == my_id) continue;
+    // we need 1 bit C-OT and ...
+    sender_ots_1_.at(party_j) = GetOtProvider(party_j).RegisterSendXcOtBit(number_of_values);
+    receiver_ots_1_.at(party_j) = GetOtProvider(party_j).RegisterReceiveXcOtBit(number_of_values);
+    // ... 3 string C-OTs per gate (in each direction)
+    sender_ots_kappa_.at(party_j) =
+        GetOtProvider(party_j).RegisterSendFixedXcOt128(3 * number_of_values);
+    receiver_ots_kappa_.at(party_j) =
+        GetOtProvider(party_j).RegisterReceiveFixedXcOt128(3 * number_of_values);
   }
 
-  // allocate enough space for number_of_wires * number_of_simd garbled tables
-  garbled_tables_.resize(size_of_all_garbled_tables);
-  garbled_tables_.SetToZero();
-
-  // store futures for the (partial) garbled tables we will receive during garbling
-  received_garbled_rows_ = backend_.GetBmrProvider().RegisterForGarbledRows(gate_id_);
+  auto& bmr_provider{backend_.GetBmrProvider()};
+  if (bmr_provider.GetGarbledTablesChunkSize() > 0) {
+    auto position{bmr_provider.AssignGarbledTablesChunk(size_of_all_garbled_tables)};
+    garbled_tables_chunk_index_ = position.chunk_index;
+    garbled_tables_chunk_offset_ = position.offset;
+  } else {
+    // store futures for the (partial) garbled tables we will receive during garbling
+    received_garbled_rows_ = bmr_provider.RegisterForGarbledRows(gate_id_);
+  }
 
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
                                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created a BMR AND gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BMR AND gate with following properties: {}", gate_info);
   }
 }
 
@@ -744,12 +742,13 @@ void AndGate::GenerateRandomness() {
         assert(bmr_b);
         bmr_a->GetSetupReadyCondition()->Wait();
         bmr_b->GetSetupReadyCondition()->Wait();
-        GetLogger().LogTrace(fmt::format(
+        GetLogger().LogTrace(
+            
             "Gate#{} (BMR AND gate) Party#{} wire_i {} simd_i {} perm_bits (a {} b {} out {}) key0 "
             "{} key 1 {}\n",
             gate_id_, my_id, wire_i, simd_i, bmr_a->GetPermutationBits().AsString(),
             bmr_b->GetPermutationBits().AsString(), bmr_output->GetPermutationBits().AsString(),
-            key_0.AsString(), key_1.AsString()));
+            key_0.AsString(), key_1.AsString());
       }
     }
     bmr_output->SetSetupIsReady();
@@ -758,8 +757,7 @@ void AndGate::GenerateRandomness() {
 
 void AndGate::EvaluateSetup() {
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating setup phase of BMR AND Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating setup phase of BMR AND Gate with id#{}", gate_id_);
   }
   const auto& R{backend_.GetBmrProvider().GetGlobalOffset()};
   const auto number_of_wires{parent_a_.size()};
@@ -777,8 +775,7 @@ void AndGate::EvaluateSetup() {
   };
 
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Gate#{} (BMR AND gate) Party#{} R {}\n", gate_id_, my_id, R.AsString()));
+    GetLogger().LogTrace("Gate#{} (BMR AND gate) Party#{} R {}\n", gate_id_, my_id, R.AsString());
   }
 
   // generate random keys and masking bits for the outgoing wires
@@ -786,10 +783,11 @@ void AndGate::EvaluateSetup() {
 
   // 1-bit OTs
 
-  // structure: parties X wires X choice bits
-  std::vector<std::vector<motion::BitVector<>>> choices(
-      number_of_parties, std::vector<motion::BitVector<>>(number_of_wires));
-
+  // the permutation bits of all wires, concatenated in the order of the OTs
+  motion::BitVector<> a_permutation_bits, b_permutation_bits, out_permutation_bits;
+  a_permutation_bits.Reserve(number_of_wires * number_of_simd);
+  b_permutation_bits.Reserve(number_of_wires * number_of_simd);
+  out_permutation_bits.Reserve(number_of_wires * number_of_simd);
   for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
     auto bmr_output{std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i))};
     const auto bmr_a{std::dynamic_pointer_cast<const bmr::Wire>(parent_a_.at(wire_i))};
@@ -799,224 +797,210 @@ void AndGate::EvaluateSetup() {
     assert(bmr_b);
     bmr_a->GetSetupReadyCondition()->Wait();
     bmr_b->GetSetupReadyCondition()->Wait();
+    a_permutation_bits.Append(bmr_a->GetPermutationBits());
+    b_permutation_bits.Append(bmr_b->GetPermutationBits());
+    out_permutation_bits.Append(bmr_output->GetPermutationBits());
+  }
 
-    const motion::BitVector<>& a_permutation_bits = bmr_a->GetPermutationBits();
-    const motion::BitVector<>& b_permutation_bits = bmr_b->GetPermutationBits();
+  // compute C-OTs for the real value, ie, b = (lambda_u ^ alpha) * (lambda_v ^ beta)
+  for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+    if (party_i == my_id) continue;
+    auto& receiver_ot_1{receiver_ots_1_.at(party_i)};
+    auto& sender_ot_1{sender_ots_1_.at(party_i)};
 
-    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-      if (party_i == my_id) {
-        choices.at(party_i).at(wire_i) = a_permutation_bits & b_permutation_bits;
-        continue;
-      }
+    receiver_ot_1->WaitSetup();
+    sender_ot_1->WaitSetup();
 
-      auto& receiver_ot_1{receiver_ots_1_.at(party_i).at(wire_i)};
-      auto& sender_ot_1{sender_ots_1_.at(party_i).at(wire_i)};
+    receiver_ot_1->SetChoices(b_permutation_bits);
+    receiver_ot_1->SendCorrections();
 
-      if constexpr (kVerboseDebug) {
-        GetLogger().LogTrace(fmt::format(
-            "Gate#{} (BMR AND gate)  Party#{}-#{} bit-C-OTs wire_i {} perm_bits {} bits_a {} "
-            "bits_b {} a&b {}\n",
-            gate_id_, my_id, party_i, wire_i, bmr_output->GetPermutationBits().AsString(),
-            bmr_a->GetPermutationBits().AsString(), bmr_b->GetPermutationBits().AsString(),
-            choices.at(party_i).at(wire_i).AsString()));
-      }
-      // compute C-OTs for the real value, ie, b = (lambda_u ^ alpha) * (lambda_v ^ beta)
+    sender_ot_1->SetCorrelations(a_permutation_bits);
+    sender_ot_1->SendMessages();
+  }
 
-      receiver_ot_1->WaitSetup();
-      sender_ot_1->WaitSetup();
+  // our share of \lambda_{uv}: our own product and the products with the other parties
+  auto lambda_uv{a_permutation_bits & b_permutation_bits};
+  for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+    if (party_i == my_id) continue;
+    auto& receiver_ot_1{receiver_ots_1_.at(party_i)};
+    auto& sender_ot_1{sender_ots_1_.at(party_i)};
 
-      receiver_ot_1->SetChoices(b_permutation_bits);
-      receiver_ot_1->SendCorrections();
+    assert(receiver_ot_1->AreChoicesSet());
+    receiver_ot_1->ComputeOutputs();
+    sender_ot_1->ComputeOutputs();
+    lambda_uv ^= receiver_ot_1->GetOutputs();
+    lambda_uv ^= sender_ot_1->GetOutputs();
 
-      sender_ot_1->SetCorrelations(a_permutation_bits);
-      sender_ot_1->SendMessages();
-    }  // for each party
-  }    // for each wire
+    if constexpr (kVerboseDebug) {
+      GetLogger().LogTrace(
+          "Gate#{} (BMR AND gate) Party#{}-#{} bit-C-OTs bits_a {} bits_b {} bits from C-OTs r {} "
+          "s {}\n",
+          gate_id_, my_id, party_i, a_permutation_bits.AsString(), b_permutation_bits.AsString(),
+          receiver_ot_1->GetOutputs().AsString(), sender_ot_1->GetOutputs().AsString());
+    }
+  }
 
   // kKappa-bit OTs
 
-  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
-    auto bmr_output{std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i))};
-    const auto bmr_a{std::dynamic_pointer_cast<const bmr::Wire>(parent_a_.at(wire_i))};
-    const auto bmr_b{std::dynamic_pointer_cast<const bmr::Wire>(parent_b_.at(wire_i))};
-    assert(bmr_output);
-    assert(bmr_a);
-    assert(bmr_b);
-    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-      if (party_i == my_id) continue;
-      auto& receiver_ot_1{receiver_ots_1_.at(party_i).at(wire_i)};
-      auto& sender_ot_1{sender_ots_1_.at(party_i).at(wire_i)};
-
-      assert(receiver_ot_1->AreChoicesSet());
-      receiver_ot_1->ComputeOutputs();
-      const auto& receiver_bitvector = receiver_ot_1->GetOutputs();
-      sender_ot_1->ComputeOutputs();
-      const auto& sender_bitvector = sender_ot_1->GetOutputs();
-
-      choices.at(party_i).at(wire_i) = receiver_bitvector ^ sender_bitvector;
-
-      if constexpr (kVerboseDebug) {
-        const auto& receiver_bitvector_check = receiver_ot_1->GetChoices();
-        const auto& sender_bitvector_check = sender_ot_1->GetCorrelations();
-        GetLogger().LogTrace(fmt::format(
-            "Gate#{} (BMR AND gate) Party#{}-#{} bit-C-OTs wire_i {} bits from C-OTs r {} s {} "
-            "result {} (r {} s {})\n",
-            gate_id_, my_id, party_i, wire_i, receiver_bitvector.AsString(),
-            sender_bitvector.AsString(), choices.at(party_i).at(wire_i).AsString(),
-            receiver_bitvector_check.AsString(), sender_bitvector_check.AsString()));
-      }
-    }  // for each party
-  }    // for each wire
-
-  // choices contain now shares of \lambda_{uv}^i
-
-  std::vector<motion::BitVector<>> aggregated_choices(number_of_wires);
-
-  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
-    auto bmr_output{std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i))};
-    const auto bmr_a{std::dynamic_pointer_cast<const bmr::Wire>(parent_a_.at(wire_i))};
-    const auto bmr_b{std::dynamic_pointer_cast<const bmr::Wire>(parent_b_.at(wire_i))};
-    assert(bmr_output);
-    assert(bmr_a);
-    assert(bmr_b);
+  // the shares of \lambda_w ^ \lambda_{uv}, \lambda_w ^ \lambda_{uv} ^ \lambda_u and
+  // \lambda_w ^ \lambda_{uv} ^ \lambda_v of each value, interleaved in the order of the OTs
+  const auto bit_values{out_permutation_bits ^ lambda_uv};
+  const auto bit_values_a{bit_values ^ a_permutation_bits};
+  const auto bit_values_b{bit_values ^ b_permutation_bits};
+  motion::BitVector<> aggregated_choices(3 * number_of_wires * number_of_simd);
+  for (auto bit_i = 0ull; bit_i < number_of_wires * number_of_simd; ++bit_i) {
+    aggregated_choices.Set(bit_values.Get(bit_i), bit_i * 3);
+    aggregated_choices.Set(bit_values_a.Get(bit_i), bit_i * 3 + 1);
+    aggregated_choices.Set(bit_values_b.Get(bit_i), bit_i * 3 + 2);
+  }
 
-    const auto& out_permutation_bits = bmr_output->GetPermutationBits();
-    const auto& a_permutation_bits = bmr_a->GetPermutationBits();
-    const auto& b_permutation_bits = bmr_b->GetPermutationBits();
-
-    assert(choices.at(0).at(wire_i).GetSize() == number_of_simd);
-    auto& aggregated_choices_fw = aggregated_choices.at(wire_i);
-    aggregated_choices_fw = motion::BitVector<>(3 * number_of_simd, false);
-    for (auto bit_i = 0ull; bit_i < number_of_simd; ++bit_i) {
-      bool bit_value = out_permutation_bits.Get(bit_i);  // \lambda_w^i
-      for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-        bit_value ^= choices.at(party_i).at(wire_i).Get(bit_i);  // \lambda_uv^i
-      }
-      aggregated_choices_fw.Set(bit_value, bit_i * 3);
-      aggregated_choices_fw.Set(bit_value ^ a_permutation_bits[bit_i], bit_i * 3 + 1);
-      aggregated_choices_fw.Set(bit_value ^ b_permutation_bits[bit_i], bit_i * 3 + 2);
-    }
+  for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+    if (party_i == my_id) continue;
+    // multiply individual parties' R's with the secret-shared real value XORed with
+    // the permutation bit of the output wire, ie, R * (b ^ lambda_w)
+    receiver_ots_kappa_.at(party_i)->SetChoices(aggregated_choices);
+    receiver_ots_kappa_.at(party_i)->SendCorrections();
 
-    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-      if (party_i == my_id) continue;
-      // multiply individual parties' R's with the secret-shared real value XORed with
-      // the permutation bit of the output wire, ie, R * (b ^ lambda_w)
-      receiver_ots_kappa_.at(party_i).at(wire_i)->SetChoices(aggregated_choices.at(wire_i));
-      receiver_ots_kappa_.at(party_i).at(wire_i)->SendCorrections();
-
-      sender_ots_kappa_.at(party_i).at(wire_i)->SetCorrelation(R);
-      sender_ots_kappa_.at(party_i).at(wire_i)->SendMessages();
-    }
-  }  // for each wire
+    sender_ots_kappa_.at(party_i)->SetCorrelation(R);
+    sender_ots_kappa_.at(party_i)->SendMessages();
+  }
 
   // AES key expansion
   motion::primitives::Prg prg;
   prg.SetKey(GetBaseProvider().GetAesFixedKey().data());
   const auto aes_round_keys = prg.GetRoundKeys();
 
+  // compute the outputs of the kKappa-bit OTs upfront, since this may wait for the other parties
+  std::vector<const motion::Block128*> sender_outputs_kappa(number_of_parties, nullptr),
+      receiver_outputs_kappa(number_of_parties, nullptr);
+  for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+    if (party_i == my_id) continue;
+    assert(receiver_ots_kappa_.at(party_i)->AreChoicesSet());
+    receiver_ots_kappa_.at(party_i)->ComputeOutputs();
+    sender_ots_kappa_.at(party_i)->ComputeOutputs();
+    assert(receiver_ots_kappa_.at(party_i)->GetOutputs().size() == aggregated_choices.GetSize());
+    assert(sender_ots_kappa_.at(party_i)->GetOutputs().size() == aggregated_choices.GetSize());
+    receiver_outputs_kappa[party_i] = receiver_ots_kappa_.at(party_i)->GetOutputs().data();
+    sender_outputs_kappa[party_i] = sender_ots_kappa_.at(party_i)->GetOutputs().data();
+  }
+
+  std::vector<const bmr::Wire*> wires_a(number_of_wires), wires_b(number_of_wires),
+      wires_out(number_of_wires);
+  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
+    wires_a[wire_i] = dynamic_cast<const bmr::Wire*>(parent_a_.at(wire_i).get());
+    wires_b[wire_i] = dynamic_cast<const bmr::Wire*>(parent_b_.at(wire_i).get());
+    wires_out[wire_i] = dynamic_cast<const bmr::Wire*>(output_wires_.at(wire_i).get());
+    assert(wires_a[wire_i]);
+    assert(wires_b[wire_i]);
+    assert(wires_out[wire_i]);
+  }
+
+  auto& bmr_provider{backend_.GetBmrProvider()};
+  motion::Block128* garbled_tables;
+  if (garbled_tables_chunk_index_) {
+    garbled_tables = bmr_provider.GetGarbledTablesChunkBuffer(*garbled_tables_chunk_index_) +
+                     garbled_tables_chunk_offset_;
+  } else {
+    // allocate enough space for number_of_wires * number_of_simd garbled tables
+    garbled_tables_.resize(number_of_wires * number_of_simd * 4 * number_of_parties);
+    garbled_tables_.SetToZero();
+    garbled_tables = garbled_tables_.data();
+  }
+
   // Compute garbled rows
   // First, set rows to PRG outputs XOR key
-  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
-    auto bmr_output{std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i))};
-    assert(bmr_output);
-    const auto bmr_a{std::dynamic_pointer_cast<const bmr::Wire>(parent_a_.at(wire_i))};
-    const auto bmr_b{std::dynamic_pointer_cast<const bmr::Wire>(parent_b_.at(wire_i))};
-    assert(bmr_a);
-    assert(bmr_b);
+  const auto number_of_threads{
+      GetNumberOfDkcThreads(*backend_.GetConfiguration(),
+                            number_of_wires * number_of_simd * 4 * number_of_parties)};
+  ParallelFor(number_of_wires * number_of_simd, number_of_threads, [&](std::size_t i) {
+    const auto wire_i{i / number_of_simd};
+    const auto simd_i{i % number_of_simd};
+    const auto bmr_output{wires_out[wire_i]};
+    const auto bmr_a{wires_a[wire_i]};
+    const auto bmr_b{wires_b[wire_i]};
+
+    const auto& key_a_0{bmr_a->GetSecretKeys().at(simd_i)};
+    const auto& key_b_0{bmr_b->GetSecretKeys().at(simd_i)};
+
+    // TODO: fix gate id computation
+    const auto gate_id = static_cast<uint64_t>(bmr_output->GetWireId() + simd_i);
+
+    // the key pairs of the rows 00, 01, 10, 11, encrypted in a single batch
+    const std::array<motion::Block128, 4> keys_a{key_a_0, key_a_0, key_a_0 ^ R, key_a_0 ^ R};
+    const std::array<motion::Block128, 4> keys_b{key_b_0, key_b_0 ^ R, key_b_0, key_b_0 ^ R};
+    AesniBmrDkcBatch(aes_round_keys, keys_a.data(), keys_b.data(), gate_id, keys_a.size(),
+                     number_of_parties,
+                     &garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 0, 0)],
+                     number_of_parties);
+
+    const auto& key_w_0 = bmr_output->GetSecretKeys()[simd_i];
+    garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 0, my_id)] ^= key_w_0;
+    garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 1, my_id)] ^= key_w_0;
+    garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 2, my_id)] ^= key_w_0;
+    garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 3, my_id)] ^= key_w_0 ^ R;
 
-    for (auto simd_i = 0ull; simd_i < number_of_simd; ++simd_i) {
-      const auto& key_a_0{bmr_a->GetSecretKeys().at(simd_i)};
-      const auto& key_a_1{key_a_0 ^ R};
-      const auto& key_b_0{bmr_b->GetSecretKeys().at(simd_i)};
-      const auto& key_b_1{key_b_0 ^ R};
-
-      // TODO: fix gate id computation
-      const auto gate_id = static_cast<uint64_t>(bmr_output->GetWireId() + simd_i);
-
-      AesniBmrDkc(aes_round_keys, key_a_0.data(), key_b_0.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 0, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_0.data(), key_b_1.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 1, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_1.data(), key_b_0.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 2, 0)]);
-      AesniBmrDkc(aes_round_keys, key_a_1.data(), key_b_1.data(), gate_id, number_of_parties,
-                  &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 3, 0)]);
-
-      const auto& key_w_0 = bmr_output->GetSecretKeys()[simd_i];
-      garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 0, my_id)] ^= key_w_0;
-      garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 1, my_id)] ^= key_w_0;
-      garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 2, my_id)] ^= key_w_0;
-      garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 3, my_id)] ^= key_w_0 ^ R;
-
-      for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-        std::array<motion::Block128, 3> shared_R;
-        const auto zero_block = motion::Block128::MakeZero();
-
-        if (party_i == my_id) {
-          shared_R.at(0) = aggregated_choices.at(wire_i)[simd_i * 3] ? R : zero_block;
-          shared_R.at(1) = aggregated_choices.at(wire_i)[simd_i * 3 + 1] ? R : zero_block;
-          shared_R.at(2) = aggregated_choices.at(wire_i)[simd_i * 3 + 2] ? R : zero_block;
-        } else {
-          shared_R.at(0) = shared_R.at(1) = shared_R.at(2) = zero_block;
-        }
+    for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
+      std::array<motion::Block128, 3> shared_R;
+      const auto zero_block = motion::Block128::MakeZero();
 
-        // R's from C-OTs
-        if (party_i == my_id) {
-          for (auto party_j = 0ull; party_j < number_of_parties; ++party_j) {
-            if (party_j == my_id) continue;
-
-            sender_ots_kappa_.at(party_j).at(wire_i)->ComputeOutputs();
-            const auto& sender_output = sender_ots_kappa_.at(party_j).at(wire_i)->GetOutputs();
-            assert(sender_output.size() == number_of_simd * 3);
-            const auto R00 = sender_output[simd_i * 3];
-            const auto R01 = sender_output[simd_i * 3 + 1];
-            const auto R10 = sender_output[simd_i * 3 + 2];
-
-            shared_R.at(0) ^= R00;
-            shared_R.at(1) ^= R01;
-            shared_R.at(2) ^= R10;
-
-            if (kVerboseDebug) {
-              GetLogger().LogTrace(fmt::format(
-                  "Gate#{} (BMR AND gate) Me#{}: Party#{} received R's \n00 ({}) \n01 ({}) \n10 "
-                  "({})\n",
-                  gate_id_, my_id, party_i, R00.AsString(), R01.AsString(), R10.AsString()));
-            }
-          }
-        } else {
-          assert(receiver_ots_kappa_.at(party_i).at(wire_i)->AreChoicesSet());
-          receiver_ots_kappa_.at(party_i).at(wire_i)->ComputeOutputs();
-          const auto& receiver_output = receiver_ots_kappa_.at(party_i).at(wire_i)->GetOutputs();
-          assert(receiver_output.size() == number_of_simd * 3);
-          const auto R00 = receiver_output[simd_i * 3];
-          const auto R01 = receiver_output[simd_i * 3 + 1];
-          const auto R10 = receiver_output[simd_i * 3 + 2];
+      if (party_i == my_id) {
+        shared_R.at(0) = aggregated_choices[i * 3] ? R : zero_block;
+        shared_R.at(1) = aggregated_choices[i * 3 + 1] ? R : zero_block;
+        shared_R.at(2) = aggregated_choices[i * 3 + 2] ? R : zero_block;
+      } else {
+        shared_R.at(0) = shared_R.at(1) = shared_R.at(2) = zero_block;
+      }
+
+      // R's from C-OTs
+      if (party_i == my_id) {
+        for (auto party_j = 0ull; party_j < number_of_parties; ++party_j) {
+          if (party_j == my_id) continue;
+
+          const auto sender_output{sender_outputs_kappa[party_j]};
+          const auto R00 = sender_output[i * 3];
+          const auto R01 = sender_output[i * 3 + 1];
+          const auto R10 = sender_output[i * 3 + 2];
 
           shared_R.at(0) ^= R00;
           shared_R.at(1) ^= R01;
           shared_R.at(2) ^= R10;
-        }
 
-        if constexpr (kVerboseDebug) {
-          GetLogger().LogTrace(
-              fmt::format("Gate#{} (BMR AND gate) Me#{}: Shared R's \n00 ({}) \n01 ({}) \n10 "
-                          "({})\n",
-                          gate_id_, my_id, party_i, shared_R.at(0).AsString(),
-                          shared_R.at(1).AsString(), shared_R.at(2).AsString()));
+          if (kVerboseDebug) {
+            GetLogger().LogTrace(
+                
+                "Gate#{} (BMR AND gate) Me#{}: Party#{} received R's \n00 ({}) \n01 ({}) \n10 "
+                "({})\n",
+                gate_id_, my_id, party_i, R00.AsString(), R01.AsString(), R10.AsString());
+          }
         }
+      } else {
+        const auto receiver_output{receiver_outputs_kappa[party_i]};
+        const auto R00 = receiver_output[i * 3];
+        const auto R01 = receiver_output[i * 3 + 1];
+        const auto R10 = receiver_output[i * 3 + 2];
+
+        shared_R.at(0) ^= R00;
+        shared_R.at(1) ^= R01;
+        shared_R.at(2) ^= R10;
+      }
 
-        garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 0, party_i)] ^= shared_R[0];
-        garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 1, party_i)] ^= shared_R[1];
-        garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 2, party_i)] ^= shared_R[2];
-        garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, 3, party_i)] ^=
-            shared_R[0] ^ shared_R[1] ^ shared_R[2];
-      }  // for each party
-    }    // for each simd
-  }      // for each wire
+      if constexpr (kVerboseDebug) {
+        GetLogger().LogTrace("Gate#{} (BMR AND gate) Me#{}: Shared R's \n00 ({}) \n01 ({}) \n10 "
+                             "({})\n",
+                             gate_id_, my_id, party_i, shared_R.at(0).AsString(),
+                             shared_R.at(1).AsString(), shared_R.at(2).AsString());
+      }
+
+      garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 0, party_i)] ^= shared_R[0];
+      garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 1, party_i)] ^= shared_R[1];
+      garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 2, party_i)] ^= shared_R[2];
+      garbled_tables[GetGarbledTableIndex(wire_i, simd_i, 3, party_i)] ^=
+          shared_R[0] ^ shared_R[1] ^ shared_R[2];
+    }  // for each party
+  });  // for each wire and simd
 
   if constexpr (kVerboseDebug) {
     std::string s{fmt::format("Me#{}: ", my_id)};
-    assert(garbled_tables_.size() == number_of_wires * number_of_simd * 4 * number_of_parties);
     for (auto wire_j = 0ull; wire_j < number_of_wires; ++wire_j) {
       s.append(fmt::format(" Wire #{}: ", wire_j));
       for (auto simd_k = 0ull; simd_k < number_of_simd; ++simd_k) {
@@ -1027,7 +1011,7 @@ void AndGate::EvaluateSetup() {
             s.append(fmt::format("\nParty #{}: ", party_i));
             s.append(
                 fmt::format(" garbled rows {} ",
-                            garbled_tables_.at(GetGarbledTableIndex(wire_j, simd_k, row_l, party_i))
+                            garbled_tables[GetGarbledTableIndex(wire_j, simd_k, row_l, party_i)]
                                 .AsString()));
           }
         }
@@ -1037,6 +1021,15 @@ void AndGate::EvaluateSetup() {
     GetLogger().LogTrace(s);
   }
 
+  // the chunk is broadcast by the provider and combined when it is evaluated
+  if (garbled_tables_chunk_index_) {
+    bmr_provider.FinishGarbledTables(*garbled_tables_chunk_index_);
+    if constexpr (kDebug) {
+      GetLogger().LogDebug("Finished evaluating setup phase of BMR AND Gate with id#{}", gate_id_);
+    }
+    return;
+  }
+
   // send out our partial garbled tables
   std::span send_message_buffer(reinterpret_cast<const std::uint8_t*>(garbled_tables_.data()),
                                 garbled_tables_.ByteSize());
@@ -1054,13 +1047,12 @@ void AndGate::EvaluateSetup() {
     assert(communication::GetMessage(garbled_rows_message.data())->payload()->size() ==
            garbled_tables_.size() * kKappa / 8);
     std::transform(pointer, pointer + garbled_tables_.size() * Block128::size(),
-                   garbled_tables_[0].data(), garbled_tables_[0].data(), std::bit_xor<std::byte>());
+                   garbled_tables[0].data(), garbled_tables_[0].data(), std::bit_xor<std::byte>());
   }
 
   // mark this gate as setup-ready to proceed with the online phase
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Finished evaluating setup phase of BMR AND Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating setup phase of BMR AND Gate with id#{}", gate_id_);
   }
 }
 
@@ -1068,8 +1060,7 @@ void AndGate::EvaluateOnline() {
   WaitSetup();
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(
-        fmt::format("Start evaluating online phase of BMR AND Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of BMR AND Gate with id#{}", gate_id_);
   }
 
   auto& communication_layer = GetCommunicationLayer();
@@ -1091,16 +1082,24 @@ void AndGate::EvaluateOnline() {
            row_i * number_of_parties + party_i;
   };
 
+  auto& bmr_provider{backend_.GetBmrProvider()};
+  motion::Block128* garbled_tables;
+  if (garbled_tables_chunk_index_) {
+    garbled_tables = bmr_provider.GetGarbledTablesChunk(*garbled_tables_chunk_index_) +
+                     garbled_tables_chunk_offset_;
+  } else {
+    garbled_tables = garbled_tables_.data();
+  }
+
   if constexpr (kVerboseDebug) {
     for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
       for (auto simd_j = 0ull; simd_j < number_of_simd; ++simd_j) {
         for (auto row_l = 0ull; row_l < 4; ++row_l) {
           for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
             GetLogger().LogTrace(
-                fmt::format("Party#{}: reconstructed gr for Party#{} Wire#{} SIMD#{} Row#{}: {}\n",
-                            my_id, party_i, wire_i, simd_j, row_l,
-                            garbled_tables_.at(GetGarbledTableIndex(wire_i, simd_j, row_l, party_i))
-                                .AsString()));
+                 "Party#{}: reconstructed gr for Party#{} Wire#{} SIMD#{} Row#{}: {}\n", my_id,
+                party_i, wire_i, simd_j, row_l,
+                garbled_tables[GetGarbledTableIndex(wire_i, simd_j, row_l, party_i)] .AsString());
           }
         }
       }
@@ -1112,53 +1111,64 @@ void AndGate::EvaluateOnline() {
   prg.SetKey(GetBaseProvider().GetAesFixedKey().data());
   const auto aes_round_keys = prg.GetRoundKeys();
 
+  std::vector<const bmr::Wire*> wires_a(number_of_wires), wires_b(number_of_wires);
+  std::vector<bmr::Wire*> wires_out(number_of_wires);
   for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
-    auto bmr_output = std::dynamic_pointer_cast<bmr::Wire>(output_wires_.at(wire_i));
-    assert(bmr_output);
-    const auto wire_a = std::dynamic_pointer_cast<const bmr::Wire>(parent_a_.at(wire_i));
-    const auto wire_b = std::dynamic_pointer_cast<const bmr::Wire>(parent_b_.at(wire_i));
-    assert(wire_a);
-    assert(wire_b);
+    wires_a[wire_i] = dynamic_cast<const bmr::Wire*>(parent_a_.at(wire_i).get());
+    wires_b[wire_i] = dynamic_cast<const bmr::Wire*>(parent_b_.at(wire_i).get());
+    wires_out[wire_i] = dynamic_cast<bmr::Wire*>(output_wires_.at(wire_i).get());
+    assert(wires_a[wire_i]);
+    assert(wires_b[wire_i]);
+    assert(wires_out[wire_i]);
+
+    wires_a[wire_i]->GetIsReadyCondition().Wait();
+    wires_b[wire_i]->GetIsReadyCondition().Wait();
+  }
 
-    wire_a->GetIsReadyCondition().Wait();
-    wire_b->GetIsReadyCondition().Wait();
+  const auto number_of_dkcs{number_of_wires * number_of_simd * number_of_parties *
+                            number_of_parties};
+  const auto number_of_threads{GetNumberOfDkcThreads(*backend_.GetConfiguration(), number_of_dkcs)};
+  ParallelFor(number_of_wires * number_of_simd, number_of_threads, [&](std::size_t i) {
+    const auto wire_i{i / number_of_simd};
+    const auto simd_i{i % number_of_simd};
+    const auto bmr_output{wires_out[wire_i]};
+    const auto wire_a{wires_a[wire_i]};
+    const auto wire_b{wires_b[wire_i]};
+
+    // TODO: fix gate id computation
+    const auto gate_id = static_cast<uint64_t>(bmr_output->GetWireId() + simd_i);
+
+    // compute index of the correct row in the garbled table
+    const bool alpha = wire_a->GetPublicValues()[simd_i], beta = wire_b->GetPublicValues()[simd_i];
+    const std::size_t row_index =
+        static_cast<std::size_t>(alpha) * 2 + static_cast<std::size_t>(beta);
+
+    // decrypt that row of the garbled table with all parties' keys in a single batch
+    AesniBmrDkcBatch(aes_round_keys, &wire_a->GetPublicKeys().at(PublicKeyIndex(simd_i, 0)),
+                     &wire_b->GetPublicKeys().at(PublicKeyIndex(simd_i, 0)), gate_id,
+                     number_of_parties, number_of_parties,
+                     &garbled_tables[GetGarbledTableIndex(wire_i, simd_i, row_index, 0)], 0);
+
+    // copy decrypted public keys to outgoing wire
+    std::copy(garbled_tables + GetGarbledTableIndex(wire_i, simd_i, row_index, 0),
+              garbled_tables + GetGarbledTableIndex(wire_i, simd_i, row_index + 1, 0),
+              std::begin(bmr_output->GetMutablePublicKeys()) + PublicKeyIndex(simd_i, 0));
 
-    for (auto simd_i = 0ull; simd_i < number_of_simd; ++simd_i) {
-      // TODO: fix gate id computation
-      const auto gate_id = static_cast<uint64_t>(bmr_output->GetWireId() + simd_i);
-
-      // compute index of the correct row in the garbled table
-      const bool alpha = wire_a->GetPublicValues()[simd_i],
-                 beta = wire_b->GetPublicValues()[simd_i];
-      const std::size_t row_index =
-          static_cast<std::size_t>(alpha) * 2 + static_cast<std::size_t>(beta);
-
-      // decrypt that row of the garbled table
-      for (auto party_i = 0ull; party_i < number_of_parties; ++party_i) {
-        const auto& key_a = wire_a->GetPublicKeys().at(PublicKeyIndex(simd_i, party_i));
-        const auto& key_b = wire_b->GetPublicKeys().at(PublicKeyIndex(simd_i, party_i));
-        AesniBmrDkc(aes_round_keys, key_a.data(), key_b.data(), gate_id, number_of_parties,
-                    &garbled_tables_[GetGarbledTableIndex(wire_i, simd_i, row_index, 0)]);
-      }
-
-      // copy decrypted public keys to outgoing wire
-      std::copy(
-          std::begin(garbled_tables_) + GetGarbledTableIndex(wire_i, simd_i, row_index, 0),
-          std::begin(garbled_tables_) + GetGarbledTableIndex(wire_i, simd_i, row_index + 1, 0),
-          std::begin(bmr_output->GetMutablePublicKeys()) + PublicKeyIndex(simd_i, 0));
+    if constexpr (kVerboseDebug) {
+      std::string s;
+      s.append(fmt::format("Me#{}: wire#{} simd#{} result\n", my_id, wire_i, simd_i));
+      s.append(fmt::format("Public values a {} b {} ", wire_a->GetPublicValues().AsString(),
+                           wire_b->GetPublicValues().AsString()));
+      s.append("\n");
+      s.append(fmt::format("output skey0 {} skey1 {}\n",
+                           bmr_output->GetSecretKeys().at(simd_i).AsString(),
+                           (bmr_output->GetSecretKeys().at(simd_i) ^ R).AsString()));
+      GetLogger().LogTrace(s);
+    }
+  });  // for each wire and simd
 
-      if constexpr (kVerboseDebug) {
-        std::string s;
-        s.append(fmt::format("Me#{}: wire#{} simd#{} result\n", my_id, wire_i, simd_i));
-        s.append(fmt::format("Public values a {} b {} ", wire_a->GetPublicValues().AsString(),
-                             wire_b->GetPublicValues().AsString()));
-        s.append("\n");
-        s.append(fmt::format("output skey0 {} skey1 {}\n",
-                             bmr_output->GetSecretKeys().at(simd_i).AsString(),
-                             (bmr_output->GetSecretKeys().at(simd_i) ^ R).AsString()));
-        GetLogger().LogTrace(s);
-      }
-    }  // for each simd
+  for (auto wire_i = 0ull; wire_i < number_of_wires; ++wire_i) {
+    const auto bmr_output{wires_out[wire_i]};
 
     // figure out the public value of the outputs
     for (auto simd_i = 0ull; simd_i < number_of_simd; ++simd_i) {
@@ -1173,13 +1183,20 @@ void AndGate::EvaluateOnline() {
       bmr_output->GetMutablePublicValues().Set(different_to_0_key, simd_i);
     }
     if constexpr (kVerboseDebug) {
-      GetLogger().LogTrace(fmt::format("Party#{} wire#{} public values result {}\n", my_id, wire_i,
-                                       bmr_output->GetPublicValues().AsString()));
+      GetLogger().LogTrace("Party#{} wire#{} public values result {}\n", my_id, wire_i,
+                           bmr_output->GetPublicValues().AsString());
     }
   }  // for each wire
 
+  // the garbled tables are not needed anymore
+  if (garbled_tables_chunk_index_) {
+    bmr_provider.ReleaseGarbledTablesChunk(*garbled_tables_chunk_index_);
+  } else {
+    garbled_tables_ = motion::Block128Vector();
+  }
+
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated BMR AND Gate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated BMR AND Gate with id#{}", gate_id_);
   }
 
   if constexpr (kDebug) {
@@ -1194,7 +1211,7 @@ void AndGate::EvaluateOnline() {
 }
 
 const bmr::SharePointer AndGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -27,6 +27,7 @@
 #include "bmr_share.h"
 
 #include <future>
+#include <optional>
 #include <span>
 
 #include "protocols/boolean_gmw/boolean_gmw_gate.h"
@@ -67,6 +68,12 @@ class InputGate final : public motion::InputGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  // the public values of the inputs, which are published in the setup phase if
+  // Provider::SetInputsInSetup is enabled
+  OnlineCost GetOnlineCost() const final override {
+    if (inputs_in_setup_) return {};
+    return {1, GetNumberOfOutputBytes()};
+  }
 
   const bmr::SharePointer GetOutputAsBmrShare() const;
 
@@ -81,6 +88,13 @@ class InputGate final : public motion::InputGate {
   std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_public_keys_;
   ReusableFiberFuture<std::vector<BitVector<>>> input_future_;
   ReusableFiberPromise<std::vector<BitVector<>>> input_promise_;
+  // see Provider::SetInputsInSetup
+  bool inputs_in_setup_{false};
+
+ private:
+  /// \brief Publishes the public values, i.e., the inputs masked with the permutation bits, and
+  /// the keys corresponding to them, and sets the public keys of the output wires.
+  void PublishInputs();
 };
 
 constexpr std::size_t kAll = std::numeric_limits<std::int64_t>::max();
@@ -96,6 +110,7 @@ class OutputGate final : public motion::OutputGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -172,17 +187,24 @@ class AndGate final : public TwoGate {
   AndGate(const Gate&) = delete;
 
  private:
-  std::vector<std::vector<std::unique_ptr<motion::XcOtBitSender>>> sender_ots_1_;
-  std::vector<std::vector<std::unique_ptr<motion::FixedXcOt128Sender>>> sender_ots_kappa_;
-  std::vector<std::vector<std::unique_ptr<motion::XcOtBitReceiver>>> receiver_ots_1_;
-  std::vector<std::vector<std::unique_ptr<motion::FixedXcOt128Receiver>>> receiver_ots_kappa_;
+  // the OTs of all wires with each party, see the constructor for their structure
+  std::vector<std::unique_ptr<motion::XcOtBitSender>> sender_ots_1_;
+  std::vector<std::unique_ptr<motion::FixedXcOt128Sender>> sender_ots_kappa_;
+  std::vector<std::unique_ptr<motion::XcOtBitReceiver>> receiver_ots_1_;
+  std::vector<std::unique_ptr<motion::FixedXcOt128Receiver>> receiver_ots_kappa_;
 
   std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> received_garbled_rows_;
 
-  // buffer to store all garbled tables for all wires
+  // buffer to store all garbled tables for all wires if garbled tables are not streamed, which
+  // is allocated in the setup phase and freed after the evaluation
   // structure: wires X (simd X (row_00 || row_01 || row_10 || row_11))
   motion::Block128Vector garbled_tables_;
 
+  // position of the garbled tables in the provider's chunks if garbled tables are streamed, see
+  // Provider::SetGarbledTablesChunkSize
+  std::optional<std::size_t> garbled_tables_chunk_index_;
+  std::size_t garbled_tables_chunk_offset_{0};
+
   void GenerateRandomness();
 };
 
@@ -1,8 +1,18 @@
 #include "bmr_provider.h"
 
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <span>
+
+#include <fmt/format.h>
+
 #include "communication/communication_layer.h"
+#include "communication/message.h"
 #include "communication/message_manager.h"
 #include "communication/message_manager.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
 
 namespace encrypto::motion::proto::bmr {
 
@@ -46,4 +56,89 @@ std::vector<Provider::future_type> Provider::RegisterForGarbledRows(std::size_t
   return futures;
 }
 
+Provider::GarbledTablesPosition Provider::AssignGarbledTablesChunk(std::size_t number_of_blocks) {
+  assert(garbled_tables_chunk_size_ > 0);
+  if (garbled_tables_chunks_.empty() ||
+      garbled_tables_chunks_.back()->number_of_blocks * Block128::size() >=
+          garbled_tables_chunk_size_) {
+    auto& chunk{*garbled_tables_chunks_.emplace_back(std::make_unique<GarbledTablesChunk>())};
+    chunk.message_futures = communication_layer_.GetMessageManager().RegisterReceiveAll(
+        communication::MessageType::kBmrGarbledTablesChunk, garbled_tables_chunks_.size() - 1);
+  }
+  auto& chunk{*garbled_tables_chunks_.back()};
+  GarbledTablesPosition position{garbled_tables_chunks_.size() - 1, chunk.number_of_blocks};
+  chunk.number_of_blocks += number_of_blocks;
+  ++chunk.number_of_gates;
+  return position;
+}
+
+Block128* Provider::GetGarbledTablesChunkBuffer(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::scoped_lock lock(chunk.mutex);
+  if (!chunk.buffer) {
+    chunk.buffer = std::shared_ptr<Block128[]>(new Block128[chunk.number_of_blocks]);
+    std::fill_n(chunk.buffer.get(), chunk.number_of_blocks, Block128::MakeZero());
+  }
+  return chunk.buffer.get();
+}
+
+void Provider::FinishGarbledTables(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::shared_ptr<Block128[]> buffer;
+  {
+    std::scoped_lock lock(chunk.mutex);
+    assert(chunk.number_of_garbled_gates < chunk.number_of_gates);
+    if (++chunk.number_of_garbled_gates < chunk.number_of_gates) return;
+    // the tables are not modified anymore, so they can be sent while we keep them for combining
+    buffer = chunk.buffer;
+  }
+  chunk.garbled_condition.notify_all();
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug(
+        fmt::format("Broadcast chunk #{} of {} garbled BMR AND gates ({} B)", chunk_index,
+                    chunk.number_of_gates, chunk.number_of_blocks * Block128::size()));
+  }
+  std::span payload(reinterpret_cast<const std::uint8_t*>(buffer.get()),
+                    chunk.number_of_blocks * Block128::size());
+  communication_layer_.BroadcastMessage(communication::MessageType::kBmrGarbledTablesChunk,
+                                        chunk_index, payload,
+                                        std::shared_ptr<const Block128[]>(std::move(buffer)));
+}
+
+Block128* Provider::GetGarbledTablesChunk(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::unique_lock lock(chunk.mutex);
+  chunk.garbled_condition.wait(
+      lock, [&chunk] { return chunk.number_of_garbled_gates == chunk.number_of_gates; });
+  if (!chunk.combined) {
+    chunk.tables = Block128Vector(chunk.number_of_blocks, chunk.buffer.get());
+    chunk.buffer.reset();
+    auto tables_pointer{chunk.tables[0].data()};
+    for (auto& message_future : chunk.message_futures) {
+      const auto message{message_future.get()};
+      const auto payload{communication::GetMessage(message.data())->payload()};
+      assert(payload->size() == chunk.tables.ByteSize());
+      auto pointer{reinterpret_cast<const std::byte*>(payload->data())};
+      std::transform(pointer, pointer + chunk.tables.ByteSize(), tables_pointer, tables_pointer,
+                     std::bit_xor<std::byte>());
+    }
+    chunk.message_futures.clear();
+    chunk.combined = true;
+  }
+  return chunk.tables.data();
+}
+
+void Provider::ReleaseGarbledTablesChunk(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::scoped_lock lock(chunk.mutex);
+  assert(chunk.number_of_evaluated_gates < chunk.number_of_gates);
+  if (++chunk.number_of_evaluated_gates == chunk.number_of_gates) {
+    chunk.tables = Block128Vector();
+  }
+}
+
 }  // namespace encrypto::motion::proto::bmr
@@ -25,6 +25,9 @@
 #include <memory>
 #include <vector>
 
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/reusable_future.h"
@@ -50,7 +53,82 @@ class Provider {
   std::vector<future_type> RegisterForInputKeys(std::size_t gate_id);
   std::vector<future_type> RegisterForGarbledRows(std::size_t gate_id);
 
+  /// \brief Enables streaming of garbled tables: instead of one broadcast per AND gate, the
+  /// partial garbled tables of consecutively constructed AND gates are collected in chunks of at
+  /// least \p chunk_size bytes, which are broadcast as soon as all their gates are garbled.  The
+  /// tables of a chunk are only combined when its first gate is evaluated and are freed after all
+  /// of its gates are evaluated, s.t. only the tables of the chunks being evaluated are held.
+  /// Together with layer-by-layer evaluation, see Backend::EvaluateLayered, the circuit is garbled
+  /// and evaluated in windows of chunks.  Needs to be set to the same value by all parties before
+  /// constructing the circuit.
+  /// \param chunk_size 0 (default) disables streaming
+  void SetGarbledTablesChunkSize(std::size_t chunk_size) {
+    garbled_tables_chunk_size_ = chunk_size;
+  }
+
+  std::size_t GetGarbledTablesChunkSize() const noexcept { return garbled_tables_chunk_size_; }
+
+  /// \brief Publishes the masked inputs and the corresponding keys of the input gates in the
+  /// setup phase instead of in two rounds of the online phase, s.t. the online phase of the input
+  /// gates is local.  The inputs need to be passed when the input gates are constructed or before
+  /// the setup phase of the input gates waits for them.  Needs to be set to the same value by all
+  /// parties before constructing the circuit.
+  void SetInputsInSetup(bool value = true) { inputs_in_setup_ = value; }
+
+  bool GetInputsInSetup() const noexcept { return inputs_in_setup_; }
+
+  /// \brief Position of the garbled tables of an AND gate in the stream of chunks.
+  struct GarbledTablesPosition {
+    std::size_t chunk_index;
+    // in blocks
+    std::size_t offset;
+  };
+
+  /// \brief Assigns the garbled tables of a newly constructed AND gate of \p number_of_blocks
+  /// blocks to a chunk.
+  GarbledTablesPosition AssignGarbledTablesChunk(std::size_t number_of_blocks);
+
+  /// \brief Returns the zero-initialized buffer of a chunk, into which the AND gates garble their
+  /// partial tables.
+  Block128* GetGarbledTablesChunkBuffer(std::size_t chunk_index);
+
+  /// \brief Marks the tables of one gate of the chunk as garbled and broadcasts the chunk if all
+  /// of its gates are done.
+  void FinishGarbledTables(std::size_t chunk_index);
+
+  /// \brief Returns the garbled tables of a chunk combined from the partial tables of all
+  /// parties, waits until they are garbled and received.  The AND gates decrypt their rows in
+  /// place.
+  Block128* GetGarbledTablesChunk(std::size_t chunk_index);
+
+  /// \brief Marks one gate of the chunk as evaluated and frees the chunk if all of its gates are
+  /// done.
+  void ReleaseGarbledTablesChunk(std::size_t chunk_index);
+
  private:
+  struct GarbledTablesChunk {
+    std::size_t number_of_blocks{0};
+    std::size_t number_of_gates{0};
+    std::size_t number_of_garbled_gates{0};
+    std::size_t number_of_evaluated_gates{0};
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable garbled_condition;
+    // our partial tables, kept until they are combined
+    std::shared_ptr<Block128[]> buffer;
+    // partial tables of the other parties
+    std::vector<future_type> message_futures;
+    // combined tables
+    Block128Vector tables;
+    bool combined{false};
+  };
+
+  std::size_t garbled_tables_chunk_size_{0};
+
+  bool inputs_in_setup_{false};
+
+  // chunks are only appended while constructing the circuit, so no synchronization is needed
+  std::vector<std::unique_ptr<GarbledTablesChunk>> garbled_tables_chunks_;
+
   communication::CommunicationLayer& communication_layer_;
   std::size_t my_id_;
   std::size_t number_of_parties_;
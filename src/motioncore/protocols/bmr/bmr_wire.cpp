@@ -56,6 +56,7 @@ Wire::Wire(bool value, Backend& backend)
 void Wire::InitializationHelperBmr() {
   const auto number_of_parties = backend_.GetCommunicationLayer().GetNumberOfParties();
   public_keys_.resize(number_of_simd_ * number_of_parties);
+  memory_account_ = MemoryAccount(MemorySubsystem::kGarbledLabels);
 
   setup_ready_cond_ = std::make_unique<FiberCondition>([this]() { return setup_ready_.load(); });
 }
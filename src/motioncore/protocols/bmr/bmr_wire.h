@@ -81,6 +81,11 @@ class Wire final : public BooleanWire {
 
   const auto& GetSetupReadyCondition() const { return setup_ready_cond_; }
 
+  std::size_t GetNumberOfBytes() const final {
+    return public_values_.GetData().size() + shared_permutation_bits_.GetData().size() +
+           secret_0_keys_.ByteSize() + public_keys_.ByteSize();
+  }
+
   bool IsConstant() const noexcept final { return false; }
 
  protected:
@@ -26,8 +26,13 @@
 #include "boolean_gmw_wire.h"
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <span>
+#include <stdexcept>
 
+#include "algorithm/psi.h"
 #include "base/backend.h"
 #include "base/register.h"
 #include "communication/communication_layer.h"
@@ -39,6 +44,67 @@
 
 namespace encrypto::motion::proto::boolean_gmw {
 
+namespace {
+
+// the value of a wire with a single SIMD value, which is read without copying the wire pointer
+bool GetScalar(const motion::WirePointer& wire) {
+  assert(std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire));
+  return static_cast<const boolean_gmw::Wire&>(*wire).GetValues().Get(0);
+}
+
+// sets the value of a wire with a single SIMD value in place, s.t. later runs of a compiled
+// circuit reuse the storage of the first one
+void SetScalar(const motion::WirePointer& wire, bool value) {
+  assert(std::dynamic_pointer_cast<boolean_gmw::Wire>(wire));
+  auto& values{static_cast<boolean_gmw::Wire&>(*wire).GetMutableValues()};
+  if (values.GetSize() == 1) {
+    values.Set(value, 0);
+  } else {
+    values = BitVector<>(1, value);
+  }
+}
+
+// packs the values of the wires into one bit-sliced matrix with a row of SIMD values per wire
+BitVector<> PackWires(const std::vector<motion::WirePointer>& wires) {
+  BitVector<> packed;
+  packed.Reserve(wires.size() * wires.at(0)->GetNumberOfSimdValues());
+  for (const auto& wire : wires) {
+    const auto gmw_wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(wire);
+    assert(gmw_wire);
+    packed.Append(gmw_wire->GetValues());
+  }
+  return packed;
+}
+
+// outputs shares of uniformly random bits, which do not depend on any input
+class RandomMaskGate final : public Gate {
+ public:
+  RandomMaskGate(std::size_t number_of_wires, std::size_t number_of_simd, Backend& backend)
+      : Gate(backend) {
+    output_wires_.reserve(number_of_wires);
+    for (std::size_t i = 0; i < number_of_wires; ++i) {
+      output_wires_.emplace_back(
+          GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd));
+    }
+  }
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override {
+    for (auto& wire : output_wires_) {
+      auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(wire);
+      assert(gmw_wire);
+      gmw_wire->GetMutableValues() = BitVector<>::SecureRandom(gmw_wire->GetNumberOfSimdValues());
+    }
+  }
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+};
+
+}  // namespace
+
 InputGate::InputGate(std::span<const BitVector<>> input, std::size_t party_id, Backend& backend)
     : InputGate::Base(backend), input_(std::vector(input.begin(), input.end())) {
   input_owner_id_ = party_id;
@@ -70,7 +136,7 @@ void InputGate::InitializationHelper() {
   boolean_sharing_id_ = _register.NextBooleanGmwSharingId(input_.size() * bits_);
 
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Created a BooleanGmwInputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created a BooleanGmwInputGate with global id {}", gate_id_);
   }
 
   output_wires_.reserve(input_.size());
@@ -80,11 +146,21 @@ void InputGate::InitializationHelper() {
 
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {},", gate_id_);
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGmwInputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGmwInputGate with following properties: {}", gate_info);
   }
 }
 
+void InputGate::SetInput(std::vector<BitVector<>>&& input) {
+  const bool same_simd{std::all_of(input.begin(), input.end(),
+                                   [this](const auto& v) { return v.GetSize() == bits_; })};
+  if (input.size() != input_.size() || !same_simd) {
+    throw std::invalid_argument(fmt::format(
+        "BooleanGmwInputGate#{} expects an input of {} wires with {} SIMD values", gate_id_,
+        input_.size(), bits_));
+  }
+  input_ = std::move(input);
+}
+
 void InputGate::EvaluateSetup() {}
 
 void InputGate::EvaluateOnline() {
@@ -145,12 +221,12 @@ void InputGate::EvaluateOnline() {
     my_wire->GetMutableValues() = buf;
   }
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated Boolean InputGate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated Boolean InputGate with id#{}", gate_id_);
   }
 }
 
 const boolean_gmw::SharePointer InputGate::GetOutputAsGmwShare() {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -193,9 +269,16 @@ OutputGate::OutputGate(const motion::SharePointer& parent, std::size_t output_ow
         backend_, parent_.at(0)->GetNumberOfSimdValues()));
   }
 
+  auto& output_batcher{backend_.GetOutputBatcher()};
+  const auto layer{GetRegister().ComputeLayer(parent_)};
+  if (output_batcher.GetOutputBatching() && layer) {
+    output_position_ = output_batcher.AssignOutput(
+        *layer, OutputBatcher::kBoolean, output_owner_,
+        BitsToBytes(parent_.at(0)->GetNumberOfSimdValues() * number_of_wires));
+  }
   // Tell the DataStorages that we want to receive OutputMessages from the
   // other parties.
-  if (is_my_output_) {
+  else if (is_my_output_) {
     output_message_futures_ = GetCommunicationLayer().GetMessageManager().RegisterReceiveAll(
         communication::MessageType::kOutputMessage, gate_id_);
   }
@@ -204,8 +287,8 @@ OutputGate::OutputGate(const motion::SharePointer& parent, std::size_t output_ow
     auto gate_info =
         fmt::format("bitlength {}, gate id {}, owner {}", number_of_wires, gate_id_, output_owner_);
 
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGMW OutputGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGMW OutputGate with following properties: {}",
+                         gate_info);
   }
 }
 
@@ -233,6 +316,27 @@ void OutputGate::EvaluateOnline() {
 
   const std::size_t bit_size = output.at(0).GetSize();
 
+  if (output_position_) {
+    BitVector<> buffer;
+    buffer.Reserve(bit_size * number_of_wires);
+    for (auto& o : output) buffer.Append(o);
+    std::span s(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
+                buffer.GetData().size());
+    auto values{backend_.GetOutputBatcher().Reconstruct(*output_position_, s)};
+    if (is_my_output_) {
+      BitSpan bit_span(values.data(), bit_size * number_of_wires);
+      for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+        auto wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
+        assert(wire);
+        wire->GetMutableValues() = bit_span.Subset(i * bit_size, (i + 1) * bit_size);
+      }
+    }
+    if constexpr (kDebug) {
+      GetLogger().LogDebug("Evaluated batched Boolean OutputGate with id#{}", gate_id_);
+    }
+    return;
+  }
+
   // we need to send shares
   if (!is_my_output_ || output_owner_ == kAll) {
     // prepare payloads
@@ -278,12 +382,7 @@ void OutputGate::EvaluateOnline() {
       // handle each wire
       for (std::size_t j = 0; j < number_of_wires; ++j) {
         // copy the subset to a bit vector
-        auto subset_bv = bit_span.Subset(j * bit_size, (j + 1) * bit_size);
-        // steal the data
-        auto byte_vector = std::move(subset_bv.GetMutableData());
-        // ... and construct a new BitVector
-        shared_outputs.at(i).emplace_back(std::move(byte_vector),
-                                          parent_.at(0)->GetNumberOfSimdValues());
+        shared_outputs.at(i).emplace_back(bit_span.Subset(j * bit_size, (j + 1) * bit_size));
       }
       assert(shared_outputs.at(i).size() == number_of_wires);
     }
@@ -311,21 +410,20 @@ void OutputGate::EvaluateOnline() {
             fmt::format("id#{}:{} ", party_id, shared_outputs.at(party_id).at(0).AsString()));
       }
 
-      GetLogger().LogTrace(
-          fmt::format("Received output shares: {} from other parties, "
-                      "reconstructed result is {}",
-                      shares, output.at(0).AsString()));
+      GetLogger().LogTrace("Received output shares: {} from other parties, "
+                           "reconstructed result is {}",
+                           shares, output.at(0).AsString());
     }
   }
 
   // we are done with this gate
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format("Evaluated Boolean OutputGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated Boolean OutputGate with id#{}", gate_id_);
   }
 }
 
 const boolean_gmw::SharePointer OutputGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -336,6 +434,40 @@ const motion::SharePointer OutputGate::GetOutputAsShare() const {
   return result;
 }
 
+RandomGate::RandomGate(std::size_t number_of_wires, std::size_t number_of_simd, Backend& backend)
+    : Gate(backend), number_of_simd_(number_of_simd) {
+  if (number_of_wires == 0 || number_of_simd == 0) {
+    throw std::invalid_argument("BooleanGmwRandomGate needs at least one wire and one SIMD value");
+  }
+  boolean_sharing_id_ = GetRegister().NextBooleanGmwSharingId(number_of_wires * number_of_simd);
+  output_wires_.reserve(number_of_wires);
+  for (std::size_t i = 0; i < number_of_wires; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd));
+  }
+}
+
+void RandomGate::EvaluateOnline() {
+  // the private seed is chosen in the base provider's setup
+  GetBaseProvider().WaitSetup();
+
+  auto& randomness_generator{
+      GetBaseProvider().GetMyRandomnessGenerator(GetCommunicationLayer().GetMyId())};
+  auto sharing_id{boolean_sharing_id_};
+  for (auto& wire : output_wires_) {
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(wire);
+    assert(gmw_wire);
+    gmw_wire->GetMutableValues() = randomness_generator.GetBits(sharing_id, number_of_simd_);
+    sharing_id += number_of_simd_;
+  }
+}
+
+const boolean_gmw::SharePointer RandomGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
 XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
     : TwoGate(a->GetBackend()) {
   parent_a_ = a->GetWires();
@@ -357,8 +489,7 @@ XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
                                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGMW XOR gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGMW XOR gate with following properties: {}", gate_info);
   }
 }
 
@@ -374,6 +505,17 @@ void XorGate::EvaluateOnline() {
     wire->GetIsReadyCondition().Wait();
   }
 
+  // scalar gates skip the temporary BitVectors and the reference counting of the wire pointers
+  if (parent_a_.at(0)->GetNumberOfSimdValues() == 1) {
+    for (auto i = 0ull; i < parent_a_.size(); ++i) {
+      SetScalar(output_wires_[i], GetScalar(parent_a_[i]) != GetScalar(parent_b_[i]));
+    }
+    if constexpr (kVerboseDebug) {
+      GetLogger().LogTrace("Evaluated BooleanGMW XOR Gate with id#{}", gate_id_);
+    }
+    return;
+  }
+
   for (auto i = 0ull; i < parent_a_.size(); ++i) {
     auto wire_a = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_.at(i));
     auto wire_b = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_b_.at(i));
@@ -391,12 +533,12 @@ void XorGate::EvaluateOnline() {
 
   // we are done with this gate
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW XOR Gate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated BooleanGMW XOR Gate with id#{}", gate_id_);
   }
 }
 
 const boolean_gmw::SharePointer XorGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -427,8 +569,7 @@ InvGate::InvGate(const motion::SharePointer& parent) : OneGate(parent->GetBacken
     for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
     gate_info.append(" output wires: ");
     for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGMW INV gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGMW INV gate with following properties: {}", gate_info);
   }
 }
 
@@ -436,6 +577,20 @@ void InvGate::EvaluateSetup() {}
 
 void InvGate::EvaluateOnline() {
   // nothing to setup, no need to wait/check
+  if (parent_.at(0)->GetNumberOfSimdValues() == 1) {
+    const auto number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+    const auto my_id{GetCommunicationLayer().GetMyId()};
+    for (auto i = 0ull; i < parent_.size(); ++i) {
+      parent_[i]->GetIsReadyCondition().Wait();
+      const bool invert = (parent_[i]->GetWireId() % number_of_parties) == my_id;
+      SetScalar(output_wires_[i], GetScalar(parent_[i]) != invert);
+    }
+    if constexpr (kVerboseDebug) {
+      GetLogger().LogTrace("Evaluated BooleanGMW INV Gate with id#{}", gate_id_);
+    }
+    return;
+  }
+
   for (auto i = 0ull; i < parent_.size(); ++i) {
     auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_.at(i));
     assert(wire);
@@ -448,12 +603,12 @@ void InvGate::EvaluateOnline() {
   }
 
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW INV Gate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated BooleanGMW INV Gate with id#{}", gate_id_);
   }
 }
 
 const boolean_gmw::SharePointer InvGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -464,6 +619,102 @@ const motion::SharePointer InvGate::GetOutputAsShare() const {
   return result;
 }
 
+FusedXorGate::FusedXorGate(std::vector<motion::WirePointer>&& parents,
+                           std::vector<std::vector<std::size_t>>&& output_terms,
+                           std::vector<bool>&& output_inversions, Backend& backend)
+    : OneGate(backend),
+      output_terms_(std::move(output_terms)),
+      output_inversions_(std::move(output_inversions)) {
+  parent_ = std::move(parents);
+
+  assert(parent_.size() > 0);
+  assert(output_terms_.size() > 0);
+  assert(output_terms_.size() == output_inversions_.size());
+
+  const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+  if constexpr (kDebug) {
+    for (const auto& wire : parent_) assert(wire->GetNumberOfSimdValues() == number_of_simd);
+    for (const auto& terms : output_terms_) {
+      for (const auto term : terms) assert(term < parent_.size());
+    }
+  }
+
+  // create output wires
+  output_wires_.reserve(output_terms_.size());
+  for (std::size_t i = 0; i < output_terms_.size(); ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd));
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Created a BooleanGMW fused XOR gate with id {}, {} parent wires and {} output wires",
+        gate_id_, parent_.size(), output_wires_.size());
+  }
+}
+
+void FusedXorGate::EvaluateSetup() {}
+
+void FusedXorGate::EvaluateOnline() {
+  // nothing to setup, no need to wait/check
+  std::vector<const std::byte*> parent_data(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_[i]);
+    assert(wire);
+    wire->GetIsReadyCondition().Wait();
+    parent_data[i] = wire->GetValues().GetData().data();
+  }
+
+  const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+  const auto number_of_bytes{BitsToBytes(number_of_simd)};
+  const auto number_of_parties{GetCommunicationLayer().GetNumberOfParties()};
+  const auto my_id{GetCommunicationLayer().GetMyId()};
+  for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+    const auto& terms{output_terms_[i]};
+    BitVector<> output(number_of_simd);
+    std::byte* output_data{output.GetMutableData().data()};
+    std::size_t byte_i = 0;
+    for (; byte_i + sizeof(std::uint64_t) <= number_of_bytes; byte_i += sizeof(std::uint64_t)) {
+      std::uint64_t word{0};
+      for (const auto term : terms) {
+        std::uint64_t term_word;
+        std::memcpy(&term_word, parent_data[term] + byte_i, sizeof(std::uint64_t));
+        word ^= term_word;
+      }
+      std::memcpy(output_data + byte_i, &word, sizeof(std::uint64_t));
+    }
+    for (; byte_i < number_of_bytes; ++byte_i) {
+      std::byte value{0};
+      for (const auto term : terms) value ^= parent_data[term][byte_i];
+      output_data[byte_i] = value;
+    }
+    // like for InvGate, a single party inverts its share
+    if (output_inversions_[i] && output_wires_[i]->GetWireId() % number_of_parties == my_id) {
+      output.Invert();
+    }
+
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[i]);
+    assert(gmw_wire);
+    gmw_wire->GetMutableValues() = std::move(output);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated BooleanGMW fused XOR Gate with id#{}", gate_id_);
+  }
+}
+
+const boolean_gmw::SharePointer FusedXorGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer FusedXorGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
 AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
     : TwoGate(a->GetBackend()) {
   parent_a_ = a->GetWires();
@@ -489,11 +740,13 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
   }
 
   // TODO: replace Gate objects with Futures from CommunicationManager
-  d_ = std::make_shared<boolean_gmw::Share>(dummy_wires_d);
-  e_ = std::make_shared<boolean_gmw::Share>(dummy_wires_e);
+  d_ = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(dummy_wires_d);
+  e_ = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(dummy_wires_e);
 
-  d_output_ = _register.EmplaceGate<OutputGate>(d_);
-  e_output_ = _register.EmplaceGate<OutputGate>(e_);
+  std::vector<motion::WirePointer> dummy_wires_d_e(dummy_wires_d);
+  dummy_wires_d_e.insert(dummy_wires_d_e.end(), dummy_wires_e.begin(), dummy_wires_e.end());
+  d_e_output_ = _register.EmplaceGate<OutputGate>(
+      _register.EmplaceShared<boolean_gmw::Share>(dummy_wires_d_e));
 
   // create output wires
   output_wires_.reserve(number_of_wires);
@@ -509,8 +762,7 @@ AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
   if constexpr (kDebug) {
     auto gate_info = fmt::format("gate id {}, parents: {}, {}", gate_id_,
                                  parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGMW AND gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGMW AND gate with following properties: {}", gate_info);
   }
 }
 
@@ -530,90 +782,555 @@ void AndGate::EvaluateOnline() {
   mt_provider.WaitFinished();
   const auto& mts = mt_provider.GetBinaryAll();
 
+  const auto number_of_simd{parent_a_.at(0)->GetNumberOfSimdValues()};
+  if (number_of_simd == 1) {
+    EvaluateOnlineScalar();
+    return;
+  }
+
+  // all wires are processed as one bit-sliced matrix, s.t. each step is a single operation on
+  // contiguous memory with a single lookup per MT component
+  const auto x{PackWires(parent_a_)};
+  const auto y{PackWires(parent_b_)};
+
+  auto d{mts.a.Subset(mt_offset_, mt_offset_ + mt_bitlen_)};
+  d ^= x;
   auto& d_mutable_wires = d_->GetMutableWires();
   for (auto i = 0ull; i < d_mutable_wires.size(); ++i) {
-    auto d = std::dynamic_pointer_cast<boolean_gmw::Wire>(d_mutable_wires.at(i));
-    const auto x = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_.at(i));
-    assert(d);
-    assert(x);
-    d->GetMutableValues() = mts.a.Subset(mt_offset_ + i * x->GetNumberOfSimdValues(),
-                                         mt_offset_ + (i + 1) * x->GetNumberOfSimdValues());
-    d->GetMutableValues() ^= x->GetValues();
-    d->SetOnlineFinished();
+    auto d_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(d_mutable_wires.at(i));
+    assert(d_wire);
+    d_wire->GetMutableValues() = d.Subset(i * number_of_simd, (i + 1) * number_of_simd);
+    d_wire->SetOnlineFinished();
   }
 
+  auto e{mts.b.Subset(mt_offset_, mt_offset_ + mt_bitlen_)};
+  e ^= y;
   auto& e_mutable_wires = e_->GetMutableWires();
   for (auto i = 0ull; i < e_mutable_wires.size(); ++i) {
-    auto e = std::dynamic_pointer_cast<boolean_gmw::Wire>(e_mutable_wires.at(i));
-    const auto y = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_b_.at(i));
-    assert(e);
-    assert(y);
-    e->GetMutableValues() = mts.b.Subset(mt_offset_ + i * y->GetNumberOfSimdValues(),
-                                         mt_offset_ + (i + 1) * y->GetNumberOfSimdValues());
-    e->GetMutableValues() ^= y->GetValues();
-    e->SetOnlineFinished();
+    auto e_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(e_mutable_wires.at(i));
+    assert(e_wire);
+    e_wire->GetMutableValues() = e.Subset(i * number_of_simd, (i + 1) * number_of_simd);
+    e_wire->SetOnlineFinished();
   }
 
-  d_output_->WaitOnline();
-  e_output_->WaitOnline();
+  d_e_output_->WaitOnline();
+  const auto& d_e_clear_wires = d_e_output_->GetOutputWires();
+  for (auto& wire : d_e_clear_wires) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const auto d_e_clear{PackWires(d_e_clear_wires)};
+  const auto d_clear{d_e_clear.Subset(0, mt_bitlen_)};
+  const auto e_clear{d_e_clear.Subset(mt_bitlen_, 2 * mt_bitlen_)};
+  auto output{mts.c.Subset(mt_offset_, mt_offset_ + mt_bitlen_)};
+  if (GetCommunicationLayer().GetMyId() ==
+      (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
+    output ^= (d_clear & y) ^ (e_clear & x) ^ (e_clear & d_clear);
+  } else {
+    output ^= (d_clear & y) ^ (e_clear & x);
+  }
+
+  for (auto i = 0ull; i < output_wires_.size(); ++i) {
+    auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
+    assert(output_wire);
+    output_wire->GetMutableValues() = output.Subset(i * number_of_simd, (i + 1) * number_of_simd);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated BooleanGMW AND Gate with id#{}", gate_id_);
+  }
+}
+
+void AndGate::EvaluateOnlineScalar() {
+  const auto& mts = GetMtProvider().GetBinaryAll();
+  const auto number_of_wires{parent_a_.size()};
+  auto& d_wires = d_->GetMutableWires();
+  auto& e_wires = e_->GetMutableWires();
+  for (auto i = 0ull; i < number_of_wires; ++i) {
+    SetScalar(d_wires[i], mts.a.Get(mt_offset_ + i) != GetScalar(parent_a_[i]));
+    d_wires[i]->SetOnlineFinished();
+    SetScalar(e_wires[i], mts.b.Get(mt_offset_ + i) != GetScalar(parent_b_[i]));
+    e_wires[i]->SetOnlineFinished();
+  }
+
+  d_e_output_->WaitOnline();
+  const auto& d_e_clear_wires = d_e_output_->GetOutputWires();
+  for (auto& wire : d_e_clear_wires) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const bool adds_d_e{GetCommunicationLayer().GetMyId() ==
+                      (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  for (auto i = 0ull; i < number_of_wires; ++i) {
+    const bool d{GetScalar(d_e_clear_wires[i])};
+    const bool e{GetScalar(d_e_clear_wires[number_of_wires + i])};
+    const bool x{GetScalar(parent_a_[i])}, y{GetScalar(parent_b_[i])};
+    const bool output{mts.c.Get(mt_offset_ + i) != ((d && y) != (e && x)) != (adds_d_e && d && e)};
+    SetScalar(output_wires_[i], output);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated scalar BooleanGMW AND Gate with id#{}", gate_id_);
+  }
+}
+
+const boolean_gmw::SharePointer AndGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const motion::SharePointer AndGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+MultiInputAndGate::MultiInputAndGate(const std::vector<motion::SharePointer>& inputs)
+    : OneGate(inputs.at(0)->GetBackend()), number_of_inputs_(inputs.size()) {
+  if (number_of_inputs_ < 2 || number_of_inputs_ > kMaxAndFanIn) {
+    throw std::invalid_argument(fmt::format("A MultiInputAndGate needs 2 to {} inputs but got {}",
+                                            kMaxAndFanIn, number_of_inputs_));
+  }
+  const auto number_of_wires{inputs.at(0)->GetBitLength()};
+  const auto number_of_simd{inputs.at(0)->GetNumberOfSimdValues()};
+  for (const auto& input : inputs) {
+    if (input->GetBitLength() != number_of_wires ||
+        input->GetNumberOfSimdValues() != number_of_simd) {
+      throw std::invalid_argument(
+          "The inputs of a MultiInputAndGate need the same numbers of wires and SIMD values");
+    }
+    parent_.insert(parent_.end(), input->GetWires().begin(), input->GetWires().end());
+  }
+
+  auto& _register = GetRegister();
+  // the masks r_i come from a gate without parents, s.t. the AND gates of their products run
+  // ahead of the inputs
+  const auto mask_gate{
+      _register.EmplaceGate<RandomMaskGate>(number_of_inputs_ * number_of_wires, number_of_simd,
+                                            backend_)};
+  const auto& mask_wires{mask_gate->GetOutputWires()};
+  const std::size_t number_of_subsets{std::size_t(1) << number_of_inputs_};
+  mask_products_.resize(number_of_subsets);
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    mask_products_[std::size_t(1) << i] =
+        _register.EmplaceShared<boolean_gmw::Share>(std::vector<motion::WirePointer>(
+            mask_wires.begin() + i * number_of_wires,
+            mask_wires.begin() + (i + 1) * number_of_wires));
+  }
+  // r_S = r_S1 & r_S2 for the halves S1, S2 of S, where subsets of sizes in (2^(l-1), 2^l] are
+  // computed by the l-th layer of AND gates, each layer batched into a single AND gate
+  for (std::size_t layer = 1; (std::size_t(1) << (layer - 1)) < number_of_inputs_; ++layer) {
+    std::vector<std::size_t> subsets;
+    std::vector<motion::WirePointer> a, b;
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset) {
+      const std::size_t size = std::popcount(subset);
+      if (size <= (std::size_t(1) << (layer - 1)) || size > (std::size_t(1) << layer)) continue;
+      // the lowest ceil(size / 2) elements of the subset
+      std::size_t low_half{0}, remaining{subset};
+      for (std::size_t k = 0; k < (size + 1) / 2; ++k) {
+        low_half |= remaining & -remaining;
+        remaining &= remaining - 1;
+      }
+      subsets.push_back(subset);
+      const auto& low_wires{mask_products_[low_half]->GetWires()};
+      const auto& high_wires{mask_products_[subset ^ low_half]->GetWires()};
+      a.insert(a.end(), low_wires.begin(), low_wires.end());
+      b.insert(b.end(), high_wires.begin(), high_wires.end());
+    }
+    auto and_gate{_register.EmplaceGate<AndGate>(_register.EmplaceShared<boolean_gmw::Share>(a),
+                                                 _register.EmplaceShared<boolean_gmw::Share>(b))};
+    const auto& products{and_gate->GetOutputWires()};
+    for (std::size_t k = 0; k < subsets.size(); ++k) {
+      mask_products_[subsets[k]] = _register.EmplaceShared<boolean_gmw::Share>(
+          std::vector<motion::WirePointer>(products.begin() + k * number_of_wires,
+                                           products.begin() + (k + 1) * number_of_wires));
+    }
+  }
+
+  // TODO: replace Gate objects with Futures from CommunicationManager
+  std::vector<motion::WirePointer> dummy_wires_d(number_of_inputs_ * number_of_wires);
+  for (auto& w : dummy_wires_d) {
+    w = _register.EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd);
+  }
+  d_ = _register.EmplaceShared<boolean_gmw::Share>(dummy_wires_d);
+  d_output_ = _register.EmplaceGate<OutputGate>(d_);
+
+  // create output wires
+  output_wires_.reserve(number_of_wires);
+  for (std::size_t i = 0; i < number_of_wires; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd));
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a BooleanGMW {}-input AND gate with id {} and {} output wires",
+                         number_of_inputs_, gate_id_, number_of_wires);
+  }
+}
 
-  const auto& d_clear = d_output_->GetOutputWires();
-  const auto& e_clear = e_output_->GetOutputWires();
+void MultiInputAndGate::EvaluateSetup() {}
 
-  for (auto& wire : d_clear) {
+void MultiInputAndGate::EvaluateOnline() {
+  const auto number_of_wires{output_wires_.size()};
+  const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+  const auto number_of_bits{number_of_wires * number_of_simd};
+
+  for (auto& wire : parent_) {
     wire->GetIsReadyCondition().Wait();
   }
-  for (auto& wire : e_clear) {
+
+  auto& d_mutable_wires{d_->GetMutableWires()};
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    const auto& mask_wires{mask_products_[std::size_t(1) << i]->GetWires()};
+    for (auto& wire : mask_wires) wire->GetIsReadyCondition().Wait();
+    auto d{PackWires(std::vector<motion::WirePointer>(
+        parent_.begin() + i * number_of_wires, parent_.begin() + (i + 1) * number_of_wires))};
+    d ^= PackWires(mask_wires);
+    for (std::size_t w = 0; w < number_of_wires; ++w) {
+      auto d_wire =
+          std::dynamic_pointer_cast<boolean_gmw::Wire>(d_mutable_wires[i * number_of_wires + w]);
+      assert(d_wire);
+      d_wire->GetMutableValues() = d.Subset(w * number_of_simd, (w + 1) * number_of_simd);
+      d_wire->SetOnlineFinished();
+    }
+  }
+
+  d_output_->WaitOnline();
+  const auto& d_clear_wires{d_output_->GetOutputWires()};
+  for (auto& wire : d_clear_wires) {
     wire->GetIsReadyCondition().Wait();
   }
+  const auto d_clear_all{PackWires(d_clear_wires)};
+  std::vector<BitVector<>> d_clear;
+  d_clear.reserve(number_of_inputs_);
+  for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+    d_clear.emplace_back(d_clear_all.Subset(i * number_of_bits, (i + 1) * number_of_bits));
+  }
+
+  // XOR over all subsets S of (AND of d_i for i not in S) & r_S, where only one party adds the
+  // public term of the empty subset, as in AndGate
+  const bool adds_public_term{GetCommunicationLayer().GetMyId() ==
+                              (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  const std::size_t number_of_subsets{mask_products_.size()};
+  BitVector<> output(number_of_bits);
+  for (std::size_t subset = 0; subset < number_of_subsets; ++subset) {
+    if (subset == 0 && !adds_public_term) continue;
+    BitVector<> term(number_of_bits, true);
+    for (std::size_t i = 0; i < number_of_inputs_; ++i) {
+      if ((subset & (std::size_t(1) << i)) == 0) term &= d_clear[i];
+    }
+    if (subset != 0) {
+      const auto& product_wires{mask_products_[subset]->GetWires()};
+      for (auto& wire : product_wires) wire->GetIsReadyCondition().Wait();
+      term &= PackWires(product_wires);
+    }
+    output ^= term;
+  }
+
+  for (std::size_t w = 0; w < number_of_wires; ++w) {
+    auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[w]);
+    assert(output_wire);
+    output_wire->GetMutableValues() = output.Subset(w * number_of_simd, (w + 1) * number_of_simd);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated BooleanGMW multi-input AND Gate with id#{}", gate_id_);
+  }
+}
 
-  for (auto i = 0ull; i < d_clear.size(); ++i) {
-    const auto d_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(d_clear.at(i));
-    const auto x_i_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_.at(i));
-    const auto e_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(e_clear.at(i));
-    const auto y_i_w = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_b_.at(i));
+const boolean_gmw::SharePointer MultiInputAndGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
 
-    assert(d_w);
-    assert(x_i_w);
-    assert(e_w);
-    assert(y_i_w);
+const motion::SharePointer MultiInputAndGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
 
-    auto output = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_.at(i));
-    assert(output);
-    output->GetMutableValues() =
-        mts.c.Subset(mt_offset_ + i * parent_a_.at(0)->GetNumberOfSimdValues(),
-                     mt_offset_ + (i + 1) * parent_a_.at(0)->GetNumberOfSimdValues());
+LookupTableGate::LookupTableGate(const motion::SharePointer& input,
+                                 std::vector<BitVector<>> truth_tables)
+    : OneGate(input->GetBackend()), truth_tables_(std::move(truth_tables)) {
+  parent_ = input->GetWires();
 
-    const auto& d = d_w->GetValues();
-    const auto& x_i = x_i_w->GetValues();
-    const auto& e = e_w->GetValues();
-    const auto& y_i = y_i_w->GetValues();
+  const std::size_t number_of_inputs{parent_.size()};
+  if (number_of_inputs == 0 || number_of_inputs > kMaxLookupTableInputs) {
+    throw std::invalid_argument(fmt::format("A LookupTableGate needs 1 to {} inputs but got {}",
+                                            kMaxLookupTableInputs, number_of_inputs));
+  }
+  if (truth_tables_.empty()) {
+    throw std::invalid_argument("A LookupTableGate needs at least one truth table");
+  }
+  const std::size_t number_of_entries{std::size_t(1) << number_of_inputs};
+  for (const auto& truth_table : truth_tables_) {
+    if (truth_table.GetSize() != number_of_entries) {
+      throw std::invalid_argument(
+          fmt::format("The truth tables of a LookupTableGate with {} inputs need {} bits, got {}",
+                      number_of_inputs, number_of_entries, truth_table.GetSize()));
+    }
+  }
+  const auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("The OT-based LookupTableGate needs 2 parties but there are {}",
+                    communication_layer.GetNumberOfParties()));
+  }
 
-    if (GetCommunicationLayer().GetMyId() ==
-        (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
-      output->GetMutableValues() ^= (d & y_i) ^ (e & x_i) ^ (e & d);
-    } else {
-      output->GetMutableValues() ^= (d & y_i) ^ (e & x_i);
+  const auto number_of_simd{input->GetNumberOfSimdValues()};
+  const auto number_of_outputs{truth_tables_.size()};
+  output_wires_.reserve(number_of_outputs);
+  for (std::size_t i = 0; i < number_of_outputs; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_simd));
+  }
+  number_of_message_bytes_ = (number_of_simd * number_of_entries * number_of_outputs + 7) / 8;
+
+  // party 0 is the receiver and party 1 the sender of the 1ooN-OTs
+  if (communication_layer.GetMyId() == 0) {
+    ot_receiver_ = backend_.GetKk13OtProvider(1).RegisterReceiveGOt(
+        number_of_simd, number_of_outputs, number_of_entries);
+  } else {
+    ot_sender_ = backend_.GetKk13OtProvider(0).RegisterSendGOt(number_of_simd, number_of_outputs,
+                                                               number_of_entries);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a BooleanGMW LUT gate with id {}, {} inputs and {} outputs",
+                         gate_id_, number_of_inputs, number_of_outputs);
+  }
+}
+
+void LookupTableGate::EvaluateSetup() {}
+
+void LookupTableGate::EvaluateOnline() {
+  for (auto& wire : parent_) {
+    wire->GetIsReadyCondition().Wait();
+  }
+
+  const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+  const auto number_of_outputs{truth_tables_.size()};
+
+  // this party's shares of the table indices
+  std::vector<std::uint8_t> indices(number_of_simd, 0);
+  for (std::size_t input_i = 0; input_i < parent_.size(); ++input_i) {
+    auto wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_[input_i]);
+    assert(wire);
+    const auto& values{wire->GetValues()};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      if (values.Get(simd_i)) indices[simd_i] |= static_cast<std::uint8_t>(1u << input_i);
     }
   }
 
+  std::vector<BitVector<>> outputs(number_of_outputs, BitVector<>(number_of_simd));
+  if (ot_receiver_) {
+    ot_receiver_->WaitSetup();
+    ot_receiver_->SetChoices(std::move(indices));
+    ot_receiver_->SendCorrections();
+    ot_receiver_->ComputeOutputs();
+    const auto ot_outputs{ot_receiver_->GetOutputs()};
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      for (std::size_t output_i = 0; output_i < number_of_outputs; ++output_i) {
+        outputs[output_i].Set(ot_outputs[simd_i].Get(output_i), simd_i);
+      }
+    }
+  } else {
+    ot_sender_->WaitSetup();
+    const std::size_t number_of_entries{truth_tables_.at(0).GetSize()};
+    // the sender's output shares
+    const auto masks{BitVector<>::SecureRandom(number_of_simd * number_of_outputs)};
+    std::vector<BitVector<>> messages(number_of_simd);
+    for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+      auto& message{messages[simd_i]};
+      message.Reserve(number_of_entries * number_of_outputs);
+      // message i is f(i ^ x_1) ^ r
+      for (std::size_t entry = 0; entry < number_of_entries; ++entry) {
+        const std::size_t x{entry ^ indices[simd_i]};
+        for (std::size_t output_i = 0; output_i < number_of_outputs; ++output_i) {
+          message.Append(truth_tables_[output_i].Get(x) !=
+                         masks.Get(simd_i * number_of_outputs + output_i));
+        }
+      }
+      for (std::size_t output_i = 0; output_i < number_of_outputs; ++output_i) {
+        outputs[output_i].Set(masks.Get(simd_i * number_of_outputs + output_i), simd_i);
+      }
+    }
+    ot_sender_->SetInputs(std::move(messages));
+    ot_sender_->SendMessages();
+  }
+
+  for (std::size_t output_i = 0; output_i < number_of_outputs; ++output_i) {
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[output_i]);
+    assert(gmw_wire);
+    gmw_wire->GetMutableValues() = std::move(outputs[output_i]);
+  }
+
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW AND Gate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated BooleanGMW LUT Gate with id#{}", gate_id_);
   }
 }
 
-const boolean_gmw::SharePointer AndGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+const boolean_gmw::SharePointer LookupTableGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
 
-const motion::SharePointer AndGate::GetOutputAsShare() const {
+const motion::SharePointer LookupTableGate::GetOutputAsShare() const {
   auto result = std::static_pointer_cast<motion::Share>(GetOutputAsGmwShare());
   assert(result);
   return result;
 }
 
+PrivateSetIntersectionGate::PrivateSetIntersectionGate(std::span<const std::uint64_t> set,
+                                                       std::size_t receiver_set_size,
+                                                       std::size_t sender_set_size,
+                                                       Backend& backend)
+    : Gate(backend) {
+  const auto& communication_layer = GetCommunicationLayer();
+  if (communication_layer.GetNumberOfParties() != 2) {
+    throw std::invalid_argument(
+        fmt::format("The OT-based PrivateSetIntersectionGate needs 2 parties but there are {}",
+                    communication_layer.GetNumberOfParties()));
+  }
+  const bool is_receiver{communication_layer.GetMyId() == 0};
+  const std::size_t set_size{is_receiver ? receiver_set_size : sender_set_size};
+  if (set.size() != set_size) {
+    throw std::invalid_argument(
+        fmt::format("The PSI {} has {} items but the public size of its set is {}",
+                    is_receiver ? "receiver" : "sender", set.size(), set_size));
+  }
+  std::vector<std::uint64_t> sorted_set(set.begin(), set.end());
+  std::sort(sorted_set.begin(), sorted_set.end());
+  if (std::adjacent_find(sorted_set.begin(), sorted_set.end()) != sorted_set.end()) {
+    throw std::invalid_argument("The set of a PSI must not contain duplicates");
+  }
+
+  const auto parameters{algorithm::GetPsiParameters(receiver_set_size, sender_set_size)};
+  number_of_bins_ = parameters.number_of_bins;
+  max_bin_size_ = parameters.max_bin_size;
+
+  // the tags of the items, of the receiver's empty bins and of the sender's padding
+  constexpr std::uint8_t kItemTag{0}, kEmptyTag{1}, kPaddingTag{2};
+  const auto to_chunks = [](std::uint64_t item, std::uint8_t tag) {
+    std::array<std::uint8_t, kNumberOfChunks> chunks;
+    for (std::size_t k = 0; k + 1 < kNumberOfChunks; ++k) {
+      chunks[k] = static_cast<std::uint8_t>(item >> (8 * k));
+    }
+    chunks.back() = tag;
+    return chunks;
+  };
+  if (is_receiver) {
+    bin_items_ = algorithm::CuckooHash(set, number_of_bins_);
+    chunks_.reserve(number_of_bins_);
+    for (const auto& item_index : bin_items_) {
+      chunks_.push_back(item_index ? to_chunks(set[*item_index], kItemTag)
+                                   : to_chunks(0, kEmptyTag));
+    }
+  } else {
+    const auto bins{algorithm::SimpleHash(set, number_of_bins_)};
+    chunks_.assign(number_of_bins_ * max_bin_size_, to_chunks(0, kPaddingTag));
+    for (std::size_t bin = 0; bin < number_of_bins_; ++bin) {
+      if (bins[bin].size() > max_bin_size_) {
+        throw std::runtime_error(fmt::format("PSI bin {} holds {} items, more than the maximum {}",
+                                             bin, bins[bin].size(), max_bin_size_));
+      }
+      for (std::size_t slot = 0; slot < bins[bin].size(); ++slot) {
+        chunks_[bin * max_bin_size_ + slot] = to_chunks(bins[bin][slot], kItemTag);
+      }
+    }
+  }
+
+  output_wires_.reserve(kNumberOfChunks * max_bin_size_);
+  for (std::size_t i = 0; i < kNumberOfChunks * max_bin_size_; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<boolean_gmw::Wire>(backend_, number_of_bins_));
+  }
+
+  // party 0 is the receiver and party 1 the sender of the 1ooN-OTs
+  number_of_message_bytes_ = 0;
+  for (std::size_t k = 0; k < kNumberOfChunks; ++k) {
+    // the chunks of the item have 8 bits and the tag has 2 bits
+    const std::size_t number_of_messages{k + 1 < kNumberOfChunks ? 256u : 4u};
+    number_of_message_bytes_ += (number_of_bins_ * number_of_messages * max_bin_size_ + 7) / 8;
+    if (is_receiver) {
+      ot_receivers_.push_back(backend_.GetKk13OtProvider(1).RegisterReceiveGOt(
+          number_of_bins_, max_bin_size_, number_of_messages));
+    } else {
+      ot_senders_.push_back(backend_.GetKk13OtProvider(0).RegisterSendGOt(
+          number_of_bins_, max_bin_size_, number_of_messages));
+    }
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a BooleanGMW PSI gate with id {}, {} bins of at most {} items",
+                         gate_id_, number_of_bins_, max_bin_size_);
+  }
+}
+
+void PrivateSetIntersectionGate::EvaluateOnline() {
+  std::vector<BitVector<>> outputs(output_wires_.size(), BitVector<>(number_of_bins_));
+  if (!ot_receivers_.empty()) {
+    // the corrections of all chunks are sent at once, s.t. the comparison takes one round
+    for (std::size_t k = 0; k < kNumberOfChunks; ++k) {
+      std::vector<std::uint8_t> choices(number_of_bins_);
+      for (std::size_t bin = 0; bin < number_of_bins_; ++bin) choices[bin] = chunks_[bin][k];
+      ot_receivers_[k]->WaitSetup();
+      ot_receivers_[k]->SetChoices(std::move(choices));
+      ot_receivers_[k]->SendCorrections();
+    }
+    for (std::size_t k = 0; k < kNumberOfChunks; ++k) {
+      ot_receivers_[k]->ComputeOutputs();
+      const auto ot_outputs{ot_receivers_[k]->GetOutputs()};
+      for (std::size_t bin = 0; bin < number_of_bins_; ++bin) {
+        for (std::size_t slot = 0; slot < max_bin_size_; ++slot) {
+          outputs[k * max_bin_size_ + slot].Set(ot_outputs[bin].Get(slot), bin);
+        }
+      }
+    }
+  } else {
+    for (std::size_t k = 0; k < kNumberOfChunks; ++k) {
+      const std::size_t number_of_messages{ot_senders_[k]->GetNumMessages()};
+      // the sender's output shares
+      const auto masks{BitVector<>::SecureRandom(number_of_bins_ * max_bin_size_)};
+      std::vector<BitVector<>> messages(number_of_bins_);
+      for (std::size_t bin = 0; bin < number_of_bins_; ++bin) {
+        const auto bin_masks{masks.Subset(bin * max_bin_size_, (bin + 1) * max_bin_size_)};
+        auto& message{messages[bin]};
+        message.Reserve(number_of_messages * max_bin_size_);
+        for (std::size_t v = 0; v < number_of_messages; ++v) message.Append(bin_masks);
+        // message v is [v == chunk of slot] ^ r_slot
+        for (std::size_t slot = 0; slot < max_bin_size_; ++slot) {
+          const std::size_t position{chunks_[bin * max_bin_size_ + slot][k] * max_bin_size_ + slot};
+          message.Set(!message.Get(position), position);
+          outputs[k * max_bin_size_ + slot].Set(bin_masks.Get(slot), bin);
+        }
+      }
+      ot_senders_[k]->WaitSetup();
+      ot_senders_[k]->SetInputs(std::move(messages));
+      ot_senders_[k]->SendMessages();
+    }
+  }
+
+  for (std::size_t i = 0; i < output_wires_.size(); ++i) {
+    auto gmw_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[i]);
+    assert(gmw_wire);
+    gmw_wire->GetMutableValues() = std::move(outputs[i]);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated BooleanGMW PSI Gate with id#{}", gate_id_);
+  }
+}
+
+const boolean_gmw::SharePointer PrivateSetIntersectionGate::GetOutputAsGmwShare() const {
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
 MuxGate::MuxGate(const motion::SharePointer& a, const motion::SharePointer& b,
                  const motion::SharePointer& c)
     : ThreeGate(a->GetBackend()) {
@@ -656,8 +1373,7 @@ MuxGate::MuxGate(const motion::SharePointer& a, const motion::SharePointer& b,
     auto gate_info =
         fmt::format("gate id {}, parents: {}, {}, {}", gate_id_, parent_a_.at(0)->GetWireId(),
                     parent_b_.at(0)->GetWireId(), parent_c_.at(0)->GetWireId());
-    GetLogger().LogDebug(
-        fmt::format("Created a BooleanGMW MUX gate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created a BooleanGMW MUX gate with following properties: {}", gate_info);
   }
 }
 
@@ -748,12 +1464,12 @@ void MuxGate::EvaluateOnline() {
   }
 
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(fmt::format("Evaluated BooleanGMW AND Gate with id#{}", gate_id_));
+    GetLogger().LogTrace("Evaluated BooleanGMW AND Gate with id#{}", gate_id_);
   }
 }
 
 const boolean_gmw::SharePointer MuxGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -26,10 +26,15 @@
 
 #include "boolean_gmw_share.h"
 
+#include <array>
+#include <optional>
 #include <span>
+#include <vector>
 
+#include "oblivious_transfer/1_out_of_n/kk13_ot_flavors.h"
 #include "oblivious_transfer/ot_flavors.h"
 #include "protocols/gate.h"
+#include "protocols/output_batcher.h"
 #include "utility/bit_vector.h"
 #include "utility/reusable_future.h"
 
@@ -53,6 +58,10 @@ class InputGate final : public motion::InputGate {
 
   bool NeedsSetup() const override { return false; }
 
+  /// \brief Replaces the input for the next evaluation, see CompiledCircuit::SetInput.
+  /// \throws std::invalid_argument if the dimensions of \p input differ from the current input.
+  void SetInput(std::vector<BitVector<>>&& input);
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare();
 
  protected:
@@ -77,6 +86,7 @@ class OutputGate final : public motion::OutputGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -90,9 +100,40 @@ class OutputGate final : public motion::OutputGate {
 
   std::vector<ReusableFiberFuture<std::vector<std::uint8_t>>> output_message_futures_;
 
+  // set if the output is reconstructed together with the other outputs of its layer
+  std::optional<OutputBatcher::OutputPosition> output_position_;
+
   std::mutex m_;
 };
 
+/// \brief Outputs shares of uniformly random bits without any communication.  Each party derives
+/// its shares from its private seed, i.e., pseudo-random secret sharing with the 1-party sets of a
+/// dishonest majority, s.t. the shared value is unknown to any n - 1 colluding parties.
+class RandomGate final : public Gate {
+ public:
+  RandomGate(std::size_t number_of_wires, std::size_t number_of_simd, Backend& backend);
+
+  ~RandomGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  RandomGate() = delete;
+
+  RandomGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_simd_;
+  std::size_t boolean_sharing_id_;
+};
+
 class XorGate final : public TwoGate {
  public:
   XorGate(const motion::SharePointer& a, const motion::SharePointer& b);
@@ -105,6 +146,8 @@ class XorGate final : public TwoGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -126,6 +169,8 @@ class InvGate final : public OneGate {
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
 
   const motion::SharePointer GetOutputAsShare() const;
@@ -135,6 +180,39 @@ class InvGate final : public OneGate {
   InvGate(const Gate&) = delete;
 };
 
+/// \brief Fused evaluation of a linear subcircuit, i.e., of XOR and INV gates, which replaces a
+/// gate, a wire and a BitVector per XOR by one pass over 64-bit words per output wire, see
+/// ShareWrapper::Evaluate.  Output wire i is the XOR of the parent wires at the indices
+/// output_terms[i], inverted if output_inversions[i].
+class FusedXorGate final : public OneGate {
+ public:
+  FusedXorGate(std::vector<motion::WirePointer>&& parents,
+               std::vector<std::vector<std::size_t>>&& output_terms,
+               std::vector<bool>&& output_inversions, Backend& backend);
+
+  ~FusedXorGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  FusedXorGate() = delete;
+
+  FusedXorGate(const Gate&) = delete;
+
+ private:
+  std::vector<std::vector<std::size_t>> output_terms_;
+  std::vector<bool> output_inversions_;
+};
+
 class AndGate final : public TwoGate {
  public:
   AndGate(const motion::SharePointer& a, const motion::SharePointer& b);
@@ -144,6 +222,8 @@ class AndGate final : public TwoGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  // the masked inputs d and e
+  OnlineCost GetOnlineCost() const final override { return {1, 2 * GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -160,7 +240,147 @@ class AndGate final : public TwoGate {
   std::size_t mt_bitlen_;
 
   std::shared_ptr<motion::Share> d_, e_;
-  std::shared_ptr<OutputGate> d_output_, e_output_;
+  // opens d and e with a single message
+  std::shared_ptr<OutputGate> d_e_output_;
+
+  // EvaluateOnline for a single SIMD value, which computes each wire by bit operations instead of
+  // BitVectors
+  void EvaluateOnlineScalar();
+};
+
+/// \brief the maximum fan-in of a MultiInputAndGate, whose multi-fan-in triple has 2^N - N - 1
+/// products of masks
+constexpr std::size_t kMaxAndFanIn{8};
+
+/// \brief Computes the AND of N inputs with one round that depends on the inputs instead of
+/// log2(N) rounds of binary ANDs.  Each input x_i is masked by a random r_i, and
+/// x_1 & ... & x_N = XOR over all subsets S of (AND of d_i = x_i ^ r_i for i not in S) & r_S
+/// is linear in the shares of the products r_S.  The products form a multi-fan-in triple, which
+/// internal AND gates compute in ceil(log2(N)) layers that do not depend on the inputs.
+class MultiInputAndGate final : public OneGate {
+ public:
+  /// \param inputs N Boolean GMW shares with the same numbers of wires and SIMD values
+  /// \throws std::invalid_argument if N is not in [2, kMaxAndFanIn] or the shares do not match
+  MultiInputAndGate(const std::vector<motion::SharePointer>& inputs);
+
+  ~MultiInputAndGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+  // the masked inputs d_i
+  OnlineCost GetOnlineCost() const final override {
+    return {1, number_of_inputs_ * GetNumberOfOutputBytes()};
+  }
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  MultiInputAndGate() = delete;
+
+  MultiInputAndGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_inputs_;
+
+  // the shares of r_S, indexed by the bit mask of S
+  std::vector<boolean_gmw::SharePointer> mask_products_;
+  std::shared_ptr<motion::Share> d_;
+  std::shared_ptr<OutputGate> d_output_;
+};
+
+/// \brief the maximum number of inputs of a LookupTableGate, which is limited by the 8-bit choices
+/// of the KK13 1-out-of-N OTs
+constexpr std::size_t kMaxLookupTableInputs{8};
+
+/// \brief Evaluates a lookup table with k inputs and m outputs in one round independent of its AND
+/// depth, e.g., an AES S-box, with one 1-out-of-2^k KK13 OT of m-bit strings per SIMD value.
+/// Party 0 chooses its share x_0 of the inputs and receives f(x_0 ^ x_1) ^ r, party 1 sends
+/// f(i ^ x_1) ^ r for all i and keeps its random r, hence exactly 2 parties are supported.  A
+/// TrustedDealer serves only 1-out-of-2 OTs, so the KK13 OTs are extended from base OTs between
+/// the parties even if a dealer is configured.
+class LookupTableGate final : public OneGate {
+ public:
+  /// \param truth_tables one table of 2^k bits per output wire, bit x of which is the output for
+  ///        the inputs x, where the first input wire is the least significant bit of x
+  /// \throws std::invalid_argument if k is not in [1, kMaxLookupTableInputs], if a table does not
+  ///         have 2^k bits or if there are not exactly 2 parties
+  LookupTableGate(const motion::SharePointer& input, std::vector<BitVector<>> truth_tables);
+
+  ~LookupTableGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+  // the sender's 2^k m-bit messages per SIMD value outweigh the receiver's 8-bit corrections
+  OnlineCost GetOnlineCost() const final override { return {1, number_of_message_bytes_}; }
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const motion::SharePointer GetOutputAsShare() const;
+
+  LookupTableGate() = delete;
+
+  LookupTableGate(const Gate&) = delete;
+
+ private:
+  std::vector<BitVector<>> truth_tables_;
+  std::size_t number_of_message_bytes_;
+
+  std::unique_ptr<GKk13OtSender> ot_sender_;
+  std::unique_ptr<GKk13OtReceiver> ot_receiver_;
+};
+
+/// \brief Computes XOR shares of the equalities of the receiver's item in each cuckoo bin and the
+/// sender's items in the same simple hashing bin for algorithm::PrivateSetIntersection.  The items
+/// are extended by a 2-bit tag, which distinguishes the empty bins of the receiver and the padding
+/// of the sender from all items, and are compared in 8 chunks of 8 bits and the chunk of the tag.
+/// For each bin and chunk, party 0 chooses the chunk of its item in one 1-out-of-N KK13 OT of
+/// max_bin_size-bit strings, in which party 1 sends [v == chunk of slot j] ^ r_j for all v and j
+/// and keeps its random r_j, hence exactly 2 parties are supported.  Output wire
+/// k * max_bin_size + j holds the equalities of chunk k and slot j with one SIMD value per bin.
+class PrivateSetIntersectionGate final : public motion::Gate {
+ public:
+  static constexpr std::size_t kNumberOfChunks{9};
+
+  /// \throws std::invalid_argument, see algorithm::PrivateSetIntersection
+  PrivateSetIntersectionGate(std::span<const std::uint64_t> set, std::size_t receiver_set_size,
+                             std::size_t sender_set_size, Backend& backend);
+
+  ~PrivateSetIntersectionGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+  // the sender's N max_bin_size-bit messages per OT outweigh the receiver's 8-bit corrections
+  OnlineCost GetOnlineCost() const final override { return {1, number_of_message_bytes_}; }
+
+  bool NeedsSetup() const override { return false; }
+
+  const boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  /// \brief the receiver's index of the item in each bin, see algorithm::CuckooHash, which is empty
+  /// for the sender
+  const std::vector<std::optional<std::size_t>>& GetBinItems() const { return bin_items_; }
+
+  PrivateSetIntersectionGate() = delete;
+
+  PrivateSetIntersectionGate(const Gate&) = delete;
+
+ private:
+  std::size_t number_of_bins_, max_bin_size_, number_of_message_bytes_;
+  std::vector<std::optional<std::size_t>> bin_items_;
+  // the chunks of the receiver's item of each bin or of the sender's item of each slot, where the
+  // slots of bin b are at b * max_bin_size_
+  std::vector<std::array<std::uint8_t, kNumberOfChunks>> chunks_;
+
+  std::vector<std::unique_ptr<GKk13OtSender>> ot_senders_;
+  std::vector<std::unique_ptr<GKk13OtReceiver>> ot_receivers_;
 };
 
 class MuxGate final : public ThreeGate {
@@ -177,6 +397,8 @@ class MuxGate final : public ThreeGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  // the OT corrections
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
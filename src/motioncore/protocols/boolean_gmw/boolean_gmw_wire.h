@@ -59,6 +59,8 @@ class Wire final : public BooleanWire {
 
   BitVector<>& GetMutableValues() { return values_; }
 
+  std::size_t GetNumberOfBytes() const final { return values_.GetData().size(); }
+
   bool IsConstant() const noexcept final { return false; }
 
  private:
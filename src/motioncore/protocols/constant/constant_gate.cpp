@@ -26,6 +26,11 @@
 #include "constant_share.h"
 #include "constant_wire.h"
 
+#include "base/backend.h"
+#include "base/register.h"
+#include "protocols/boolean_gmw/boolean_gmw_share.h"
+#include "protocols/boolean_gmw/boolean_gmw_wire.h"
+
 namespace encrypto::motion::proto {
 
 ConstantBooleanInputGate::ConstantBooleanInputGate(std::vector<BitVector<>>&& v, Backend& backend)
@@ -33,8 +38,7 @@ ConstantBooleanInputGate::ConstantBooleanInputGate(std::vector<BitVector<>>&& v,
   assert(output_wires_.empty());
   output_wires_.reserve(v.size());
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Created a ConstantBooleanInputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created a ConstantBooleanInputGate with global id {}", gate_id_);
   }
 
   for (const auto& i : v) {
@@ -42,8 +46,8 @@ ConstantBooleanInputGate::ConstantBooleanInputGate(std::vector<BitVector<>>&& v,
   }
 
   auto gate_info = fmt::format("gate id {}", gate_id_);
-  GetLogger().LogDebug(
-      fmt::format("Allocated a ConstantBooleanInputGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Allocated a ConstantBooleanInputGate with following properties: {}",
+                       gate_info);
 }
 
 ConstantBooleanInputGate::ConstantBooleanInputGate(const std::vector<BitVector<>>& v,
@@ -52,8 +56,7 @@ ConstantBooleanInputGate::ConstantBooleanInputGate(const std::vector<BitVector<>
   assert(output_wires_.empty());
   output_wires_.reserve(v.size());
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Created a ConstantBooleanInputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created a ConstantBooleanInputGate with global id {}", gate_id_);
   }
 
   for (const auto& i : v) {
@@ -61,12 +64,104 @@ ConstantBooleanInputGate::ConstantBooleanInputGate(const std::vector<BitVector<>
   }
 
   auto gate_info = fmt::format("gate id {}", gate_id_);
-  GetLogger().LogDebug(
-      fmt::format("Allocated a ConstantBooleanInputGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Allocated a ConstantBooleanInputGate with following properties: {}",
+                       gate_info);
 }
 
 motion::SharePointer ConstantBooleanInputGate::GetOutputAsShare() const {
-  return std::make_shared<ConstantBooleanShare>(output_wires_);
+  return backend_.GetRegister()->EmplaceShared<ConstantBooleanShare>(output_wires_);
+}
+
+namespace {
+
+// creates the output wires of a gate combining a Boolean GMW share with a public constant
+void InitializeConstantBooleanGate(std::vector<WirePointer>& parent_a,
+                                   std::vector<WirePointer>& parent_b,
+                                   std::vector<WirePointer>& output_wires,
+                                   const motion::SharePointer& non_constant,
+                                   const motion::SharePointer& constant, Backend& backend) {
+  assert(non_constant->GetProtocol() == MpcProtocol::kBooleanGmw);
+  assert(constant->GetProtocol() == MpcProtocol::kBooleanConstant);
+  assert(non_constant->GetBitLength() == constant->GetBitLength());
+  parent_a = non_constant->GetWires();
+  parent_b = constant->GetWires();
+  output_wires.reserve(parent_a.size());
+  for (std::size_t i = 0; i < parent_a.size(); ++i) {
+    assert(parent_a[i]->GetNumberOfSimdValues() == parent_b[i]->GetNumberOfSimdValues());
+    output_wires.emplace_back(backend.GetRegister()->EmplaceWire<boolean_gmw::Wire>(
+        backend, non_constant->GetNumberOfSimdValues()));
+  }
+}
+
+}  // namespace
+
+ConstantBooleanXorGate::ConstantBooleanXorGate(const motion::SharePointer& non_constant,
+                                               const motion::SharePointer& constant)
+    : TwoGate(non_constant->GetBackend()) {
+  InitializeConstantBooleanGate(parent_a_, parent_b_, output_wires_, non_constant, constant,
+                                backend_);
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a ConstantBooleanXorGate with id {} and {} wires", gate_id_,
+                         parent_a_.size());
+  }
+}
+
+void ConstantBooleanXorGate::EvaluateOnline() {
+  for (auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  // only one party adds the constant to its share, as in ConstantArithmeticAdditionGate
+  const bool adds_constant{GetCommunicationLayer().GetMyId() ==
+                           (gate_id_ % GetCommunicationLayer().GetNumberOfParties())};
+  for (std::size_t i = 0; i < parent_a_.size(); ++i) {
+    auto non_constant_wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_[i]);
+    auto constant_wire = std::dynamic_pointer_cast<const ConstantBooleanWire>(parent_b_[i]);
+    auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[i]);
+    assert(non_constant_wire);
+    assert(constant_wire);
+    assert(output_wire);
+    if (adds_constant) {
+      output_wire->GetMutableValues() = non_constant_wire->GetValues() ^ constant_wire->GetValues();
+    } else {
+      output_wire->GetMutableValues() = non_constant_wire->GetValues();
+    }
+  }
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated ConstantBooleanXorGate with id#{}", gate_id_);
+  }
+}
+
+motion::SharePointer ConstantBooleanXorGate::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
+}
+
+ConstantBooleanAndGate::ConstantBooleanAndGate(const motion::SharePointer& non_constant,
+                                               const motion::SharePointer& constant)
+    : TwoGate(non_constant->GetBackend()) {
+  InitializeConstantBooleanGate(parent_a_, parent_b_, output_wires_, non_constant, constant,
+                                backend_);
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a ConstantBooleanAndGate with id {} and {} wires", gate_id_,
+                         parent_a_.size());
+  }
+}
+
+void ConstantBooleanAndGate::EvaluateOnline() {
+  for (auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  for (std::size_t i = 0; i < parent_a_.size(); ++i) {
+    auto non_constant_wire = std::dynamic_pointer_cast<const boolean_gmw::Wire>(parent_a_[i]);
+    auto constant_wire = std::dynamic_pointer_cast<const ConstantBooleanWire>(parent_b_[i]);
+    auto output_wire = std::dynamic_pointer_cast<boolean_gmw::Wire>(output_wires_[i]);
+    assert(non_constant_wire);
+    assert(constant_wire);
+    assert(output_wire);
+    output_wire->GetMutableValues() = non_constant_wire->GetValues() & constant_wire->GetValues();
+  }
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated ConstantBooleanAndGate with id#{}", gate_id_);
+  }
+}
+
+motion::SharePointer ConstantBooleanAndGate::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<boolean_gmw::Share>(output_wires_);
 }
 
 template <typename T>
@@ -76,16 +171,15 @@ ConstantArithmeticInputGate<T>::ConstantArithmeticInputGate(const std::vector<T>
   assert(output_wires_.empty());
   static_assert(!std::is_same_v<T, bool>);
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Created a ConstantArithmeticInputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created a ConstantArithmeticInputGate with global id {}", gate_id_);
   }
 
   output_wires_.emplace_back(
       GetRegister().template EmplaceWire<ConstantArithmeticWire<T>>(v, backend));
 
   auto gate_info = fmt::format("uint{}_t type, gate id {}", sizeof(T) * 8, gate_id_);
-  GetLogger().LogDebug(fmt::format(
-      "Allocated a ConstantArithmeticInputGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Allocated a ConstantArithmeticInputGate with following properties: {}",
+                       gate_info);
 }
 
 template <typename T>
@@ -94,21 +188,20 @@ ConstantArithmeticInputGate<T>::ConstantArithmeticInputGate(std::vector<T>&& v,
   assert(output_wires_.empty());
   static_assert(!std::is_same_v<T, bool>);
   if constexpr (kVerboseDebug) {
-    GetLogger().LogTrace(
-        fmt::format("Created a ConstantArithmeticInputGate with global id {}", gate_id_));
+    GetLogger().LogTrace("Created a ConstantArithmeticInputGate with global id {}", gate_id_);
   }
 
   output_wires_.emplace_back(
       GetRegister().template EmplaceWire<ConstantArithmeticWire<T>>(v, backend));
 
   auto gate_info = fmt::format("uint{}_t type, gate id {}", sizeof(T) * 8, gate_id_);
-  GetLogger().LogDebug(fmt::format(
-      "Allocated a ConstantArithmeticInputGate with following properties: {}", gate_info));
+  GetLogger().LogDebug("Allocated a ConstantArithmeticInputGate with following properties: {}",
+                       gate_info);
 }
 
 template <typename T>
 motion::SharePointer ConstantArithmeticInputGate<T>::GetOutputAsShare() const {
-  return std::make_shared<ConstantArithmeticShare<T>>(output_wires_);
+  return backend_.GetRegister()->EmplaceShared<ConstantArithmeticShare<T>>(output_wires_);
 }
 
 template class ConstantArithmeticInputGate<std::uint8_t>;
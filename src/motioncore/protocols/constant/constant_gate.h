@@ -69,6 +69,47 @@ class ConstantBooleanInputGate final : public Gate {
   motion::SharePointer GetOutputAsShare() const;
 };
 
+/// \brief XORs a Boolean GMW share with a public constant, whose values may differ between the
+/// SIMD values of a wire.  Constants that are 0 or 1 in every SIMD value are folded into wiring
+/// or INV gates by ShareWrapper instead.
+class ConstantBooleanXorGate final : public TwoGate {
+ public:
+  ConstantBooleanXorGate(const motion::SharePointer& non_constant,
+                         const motion::SharePointer& constant);
+
+  ~ConstantBooleanXorGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  motion::SharePointer GetOutputAsShare() const;
+};
+
+/// \brief ANDs a Boolean GMW share with a public constant, whose values may differ between the
+/// SIMD values of a wire.
+class ConstantBooleanAndGate final : public TwoGate {
+ public:
+  ConstantBooleanAndGate(const motion::SharePointer& non_constant,
+                         const motion::SharePointer& constant);
+
+  ~ConstantBooleanAndGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  motion::SharePointer GetOutputAsShare() const;
+};
+
 // constant input gates do not inherit from InputGate, since they have no owner
 template <typename T>
 class ConstantArithmeticInputGate final : public Gate {
@@ -119,8 +160,8 @@ class ConstantArithmeticAdditionGate final : public TwoGate {
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                     parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(fmt::format(
-        "Created an ConstantArithmeticAdditionGate with following properties: {}", gate_info));
+    GetLogger().LogDebug("Created an ConstantArithmeticAdditionGate with following properties: {}",
+                         gate_info);
   }
 
   ~ConstantArithmeticAdditionGate() final = default;
@@ -143,23 +184,23 @@ class ConstantArithmeticAdditionGate final : public TwoGate {
     assert(non_constant_wire);
     assert(constant_wire);
 
-    std::vector<T> output;
+    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
+    auto& output{arithmetic_wire->GetMutableValues()};
     if (GetCommunicationLayer().GetMyId() ==
         (gate_id_ % GetCommunicationLayer().GetNumberOfParties())) {
-      output = RestrictAddVectors<T>(constant_wire->GetValues(), non_constant_wire->GetValues());
+      output.resize(non_constant_wire->GetValues().size());
+      AddVectors<T>(constant_wire->GetValues(), non_constant_wire->GetValues(), output);
     } else {
       output = non_constant_wire->GetValues();
     }
 
-    auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-    arithmetic_wire->GetMutableValues() = std::move(output);
-
-    GetLogger().LogDebug(
-        fmt::format("Evaluated arithmetic_gmw::AdditionGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated arithmetic_gmw::AdditionGate with id#{}", gate_id_);
   }
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the
   // case we need it multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare() {
@@ -202,8 +243,9 @@ class ConstantArithmeticMultiplicationGate final : public TwoGate {
     auto gate_info =
         fmt::format("uint{}_t type, gate id {}, parents: {}, {}", sizeof(T) * 8, gate_id_,
                     parent_a_.at(0)->GetWireId(), parent_b_.at(0)->GetWireId());
-    GetLogger().LogDebug(fmt::format(
-        "Created an ConstantArithmeticMultiplicationGate with following properties: {}", gate_info));
+    GetLogger().LogDebug(
+         "Created an ConstantArithmeticMultiplicationGate with following properties: {}",
+        gate_info);
   }
 
   ~ConstantArithmeticMultiplicationGate() final = default;
@@ -226,18 +268,18 @@ class ConstantArithmeticMultiplicationGate final : public TwoGate {
     assert(non_constant_wire);
     assert(constant_wire);
 
-    std::vector<T> output =
-        RestrictMulVectors<T>(constant_wire->GetValues(), non_constant_wire->GetValues());
-
     auto arithmetic_wire = std::dynamic_pointer_cast<arithmetic_gmw::Wire<T>>(output_wires_.at(0));
-    arithmetic_wire->GetMutableValues() = std::move(output);
+    auto& output{arithmetic_wire->GetMutableValues()};
+    output.resize(non_constant_wire->GetValues().size());
+    MultiplyVectors<T>(constant_wire->GetValues(), non_constant_wire->GetValues(), output);
 
-    GetLogger().LogDebug(
-        fmt::format("Evaluated arithmetic_gmw::MultiplicationGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated arithmetic_gmw::MultiplicationGate with id#{}", gate_id_);
   }
 
   bool NeedsSetup() const override { return false; }
 
+  bool IsLocal() const final override { return true; }
+
   // perhaps, we should return a copy of the pointer and not move it for the
   // case we need it multiple times
   arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare() {
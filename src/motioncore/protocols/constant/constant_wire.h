@@ -57,6 +57,8 @@ class ConstantArithmeticWire final : public Wire {
 
   std::size_t GetBitLength() const final { return sizeof(T) * 8; }
 
+  std::size_t GetNumberOfBytes() const final { return values_.size() * sizeof(T); }
+
   bool IsConstant() const noexcept final { return true; }
 
  private:
@@ -90,6 +92,8 @@ class ConstantBooleanWire final : public BooleanWire {
 
   BitVector<>& GetMutableValues() { return values_; }
 
+  std::size_t GetNumberOfBytes() const final { return values_.GetData().size(); }
+
   bool IsConstant() const noexcept final { return true; }
 
  private:
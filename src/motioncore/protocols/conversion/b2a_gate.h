@@ -40,13 +40,17 @@ namespace encrypto::motion {
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 class GmwToArithmeticGate final : public OneGate {
  public:
-  GmwToArithmeticGate(const SharePointer& parent) : OneGate(parent->GetBackend()) {
+  /// \brief converts the bits of parent, least significant bit first, to an arithmetic share of
+  /// their value, or, if is_hamming_weight, to an arithmetic share of their sum, i.e., of their
+  /// Hamming weight, from any number of parent wires.
+  GmwToArithmeticGate(const SharePointer& parent, bool is_hamming_weight = false)
+      : OneGate(parent->GetBackend()), is_hamming_weight_(is_hamming_weight) {
     parent_ = parent->GetWires();
     const auto number_of_simd{parent->GetNumberOfSimdValues()};
-    constexpr auto bit_size = sizeof(T) * 8;
+    const auto bit_size{parent_.size()};
 
     // check that we have enough input wires to represent an element of T
-    assert(parent_.size() == bit_size);
+    assert(is_hamming_weight || bit_size == sizeof(T) * 8);
     for ([[maybe_unused]] const auto& wire : parent_) {
       assert(wire->GetBitLength() == 1);
       assert(wire->GetNumberOfSimdValues() == number_of_simd);
@@ -75,9 +79,9 @@ class GmwToArithmeticGate final : public OneGate {
       auto gate_info = fmt::format("gate id {}, parent wires: ", gate_id_);
       for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
       gate_info.append(fmt::format(" output wire: {}", output_wires_.at(0)->GetWireId()));
-      GetLogger().LogDebug(fmt::format(
-          "Created a Boolean GMW to Arithmetic GMW conversion gate with following properties: {}",
-          gate_info));
+      GetLogger().LogDebug(
+           "Created a Boolean GMW to Arithmetic GMW conversion gate with following properties: {}",
+          gate_info);
     }
   }
 
@@ -85,6 +89,9 @@ class GmwToArithmeticGate final : public OneGate {
 
   void EvaluateSetup() final {}
 
+  // the masked bits
+  OnlineCost GetOnlineCost() const final { return {1, GetNumberOfOutputBytes()}; }
+
   void EvaluateOnline() final {
     // nothing to setup, no need to wait/check
 
@@ -98,7 +105,9 @@ class GmwToArithmeticGate final : public OneGate {
     sb_provider.WaitFinished();
 
     const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
-    constexpr auto bit_size = sizeof(T) * 8;
+    const auto bit_size{parent_.size()};
+    // the Hamming weight sums the converted bits without their weights
+    const auto shift = [this](std::size_t wire_i) { return is_hamming_weight_ ? 0 : wire_i; };
 
     // mask the input bits with the shared bits
     // and assign the result to t
@@ -134,17 +143,17 @@ class GmwToArithmeticGate final : public OneGate {
         if (GetCommunicationLayer().GetMyId() == 0) {
           T t(ts_clear_b.at(wire_i)->GetValues().Get(j));         // the masked bit
           T r(sbs.at(sb_offset_ + wire_i * number_of_simd + j));  // the arithmetically shared bit
-          output_value += T(t + r - 2 * t * r) << wire_i;
+          output_value += T(t + r - 2 * t * r) << shift(wire_i);
         } else {
           T t(ts_clear_b.at(wire_i)->GetValues().Get(j));         // the masked bit
           T r(sbs.at(sb_offset_ + wire_i * number_of_simd + j));  // the arithmetically shared bit
-          output_value += T(r - 2 * t * r) << wire_i;
+          output_value += T(r - 2 * t * r) << shift(wire_i);
         }
       }
       output->GetMutableValues().at(j) = output_value;
     }
 
-    GetLogger().LogDebug(fmt::format("Evaluated B2AGate with id#{}", gate_id_));
+    GetLogger().LogDebug("Evaluated B2AGate with id#{}", gate_id_);
   }
 
   bool NeedsSetup() const override { return false; }
@@ -166,6 +175,7 @@ class GmwToArithmeticGate final : public OneGate {
   GmwToArithmeticGate(const Gate&) = delete;
 
  private:
+  bool is_hamming_weight_;
   std::size_t number_of_sbs_;
   std::size_t sb_offset_;
   proto::boolean_gmw::SharePointer ts_;
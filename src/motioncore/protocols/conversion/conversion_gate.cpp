@@ -29,19 +29,72 @@
 #include "base/backend.h"
 #include "communication/communication_layer.h"
 #include "communication/message.h"
+#include "multiplication_triple/sb_provider.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
+#include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
+#include "protocols/astra/astra_share.h"
+#include "protocols/astra/astra_wire.h"
 #include "protocols/bmr/bmr_gate.h"
 #include "protocols/bmr/bmr_provider.h"
 #include "protocols/bmr/bmr_share.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_share.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
+#include "protocols/constant/constant_wire.h"
+#include "protocols/replicated/replicated_gate.h"
+#include "protocols/replicated/replicated_share.h"
+#include "protocols/replicated/replicated_wire.h"
+#include "protocols/garbled_circuit/garbled_circuit_gate.h"
+#include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "protocols/garbled_circuit/garbled_circuit_share.h"
+#include "protocols/garbled_circuit/garbled_circuit_wire.h"
 #include "secure_type/secure_unsigned_integer.h"
 #include "utility/bit_vector.h"
 #include "utility/constants.h"
 #include "utility/fiber_condition.h"
+#include "utility/helpers.h"
 
 namespace encrypto::motion {
 
+namespace {
+
+// sets the input of this party's share of the arithmetic GMW wire to the input promise
+void SetArithmeticInput(const WirePointer& wire,
+                        ReusableFiberPromise<std::vector<BitVector<>>>& input_promise) {
+  const auto bitlength{wire->GetBitLength()};
+  switch (bitlength) {
+    case 8: {
+      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint8_t>>(wire)};
+      assert(w);
+      input_promise.set_value(ToInput(w->GetValues()));
+      break;
+    }
+    case 16: {
+      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint16_t>>(wire)};
+      assert(w);
+      input_promise.set_value(ToInput(w->GetValues()));
+      break;
+    }
+    case 32: {
+      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint32_t>>(wire)};
+      assert(w);
+      input_promise.set_value(ToInput(w->GetValues()));
+      break;
+    }
+    case 64: {
+      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint64_t>>(wire)};
+      assert(w);
+      input_promise.set_value(ToInput(w->GetValues()));
+      break;
+    }
+    default:
+      throw std::logic_error(fmt::format("Illegal bitlength: {}", bitlength));
+  }
+}
+
+}  // namespace
+
 BmrToBooleanGmwGate::BmrToBooleanGmwGate(const SharePointer& parent)
     : OneGate(parent->GetBackend()) {
   parent_ = parent->GetWires();
@@ -65,8 +118,8 @@ BmrToBooleanGmwGate::BmrToBooleanGmwGate(const SharePointer& parent)
     for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
     gate_info.append(" output wires: ");
     for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
-    GetLogger().LogDebug(fmt::format(
-        "Created a BMR to Boolean GMW conversion gate with following properties: {}", gate_info));
+    GetLogger().LogDebug(
+         "Created a BMR to Boolean GMW conversion gate with following properties: {}", gate_info);
   }
 }
 
@@ -75,8 +128,8 @@ void BmrToBooleanGmwGate::EvaluateSetup() {}
 void BmrToBooleanGmwGate::EvaluateOnline() {
   // nothing to setup, no need to wait/check
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Start evaluating online phase of BMR to Boolean GMW Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of BMR to Boolean GMW Gate with id#{}",
+                         gate_id_);
   }
 
   for (auto i = 0ull; i < parent_.size(); ++i) {
@@ -101,13 +154,13 @@ void BmrToBooleanGmwGate::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Finished evaluating online phase of BMR to Boolean GMW Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating online phase of BMR to Boolean GMW Gate with id#{}",
+                         gate_id_);
   }
 }
 
 const proto::boolean_gmw::SharePointer BmrToBooleanGmwGate::GetOutputAsGmwShare() const {
-  auto result = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -143,15 +196,15 @@ BooleanGmwToBmrGate::BooleanGmwToBmrGate(const SharePointer& parent)
     for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
     gate_info.append(" output wires: ");
     for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
-    GetLogger().LogDebug(fmt::format(
-        "Created a Boolean GMW to BMR conversion gate with following properties: {}", gate_info));
+    GetLogger().LogDebug(
+         "Created a Boolean GMW to BMR conversion gate with following properties: {}", gate_info);
   }
 }
 
 void BooleanGmwToBmrGate::EvaluateSetup() {
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Start evaluating setup phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating setup phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 
   for (auto wire_i = 0ull; wire_i < output_wires_.size(); ++wire_i) {
@@ -162,16 +215,16 @@ void BooleanGmwToBmrGate::EvaluateSetup() {
     bmr_output->SetSetupIsReady();
   }
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Finished evaluating setup phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating setup phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 }
 
 void BooleanGmwToBmrGate::EvaluateOnline() {
   WaitSetup();
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Start evaluating online phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 
   const auto number_of_simd{output_wires_.at(0)->GetNumberOfSimdValues()};
@@ -222,16 +275,10 @@ void BooleanGmwToBmrGate::EvaluateOnline() {
     const auto wire = std::dynamic_pointer_cast<const proto::bmr::Wire>(output_wires_[wire_i]);
     assert(wire);
     const auto& keys = wire->GetSecretKeys();
-    // copy the "0 keys" into the buffer
-    std::copy(std::begin(keys), std::end(keys),
-              std::begin(my_keys_buffer) + wire_i * number_of_simd);
     const auto& public_values = wire->GetPublicValues();
-    for (std::size_t simd_j = 0; simd_j < number_of_simd; ++simd_j) {
-      // xor the offset on a key if the corresponding public value is 1
-      if (public_values[simd_j]) {
-        my_keys_buffer.at(wire_i * number_of_simd + simd_j) ^= R;
-      }
-    }
+    // copy the "0 keys" into the buffer and xor the offset on the keys whose public value is 1
+    ConditionalXorBlocks(my_keys_buffer.data() + wire_i * number_of_simd, keys.data(),
+                         public_values.GetData().data(), R, number_of_simd);
   }
 
   // send the selected keys to all other parties
@@ -281,13 +328,13 @@ void BooleanGmwToBmrGate::EvaluateOnline() {
   }
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Finished evaluating online phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating online phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 }
 
 const proto::bmr::SharePointer BooleanGmwToBmrGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<proto::bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<proto::bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -346,8 +393,8 @@ ArithmeticGmwToBmrGate::ArithmeticGmwToBmrGate(const SharePointer& parent)
     gate_info.append(" output wires: ");
     for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
     GetLogger().LogDebug(
-        fmt::format("Created a Arithmetic GMW to BMR conversion gate with following properties: {}",
-                    gate_info));
+         "Created a Arithmetic GMW to BMR conversion gate with following properties: {}",
+        gate_info);
   }
 }
 
@@ -356,50 +403,21 @@ void ArithmeticGmwToBmrGate::EvaluateSetup() {}
 void ArithmeticGmwToBmrGate::EvaluateOnline() {
   // nothing to setup, no need to wait/check
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Start evaluating online phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Start evaluating online phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 
-  const auto bitlength = parent_[0]->GetBitLength();
   parent_[0]->GetIsReadyCondition().Wait();
-
-  switch (bitlength) {
-    case 8: {
-      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint8_t>>(parent_[0])};
-      assert(w);
-      input_promise_->set_value(ToInput(w->GetValues()));
-      break;
-    }
-    case 16: {
-      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint16_t>>(parent_[0])};
-      assert(w);
-      input_promise_->set_value(ToInput(w->GetValues()));
-      break;
-    }
-    case 32: {
-      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint32_t>>(parent_[0])};
-      assert(w);
-      input_promise_->set_value(ToInput(w->GetValues()));
-      break;
-    }
-    case 64: {
-      auto w{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<std::uint64_t>>(parent_[0])};
-      assert(w);
-      input_promise_->set_value(ToInput(w->GetValues()));
-      break;
-    }
-    default:
-      throw std::logic_error(fmt::format("Illegal bitlength: {}", bitlength));
-  }
+  SetArithmeticInput(parent_[0], *input_promise_);
 
   if constexpr (kDebug) {
-    GetLogger().LogDebug(fmt::format(
-        "Finished evaluating online phase of Boolean GMW to BMR Gate with id#{}", gate_id_));
+    GetLogger().LogDebug("Finished evaluating online phase of Boolean GMW to BMR Gate with id#{}",
+                         gate_id_);
   }
 }
 
 const proto::bmr::SharePointer ArithmeticGmwToBmrGate::GetOutputAsBmrShare() const {
-  auto result = std::make_shared<proto::bmr::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<proto::bmr::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -410,4 +428,730 @@ const SharePointer ArithmeticGmwToBmrGate::GetOutputAsShare() const {
   return result;
 }
 
+BooleanGmwToGarbledCircuitGate::BooleanGmwToGarbledCircuitGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  for ([[maybe_unused]] const auto& wire : parent_)
+    assert(wire->GetProtocol() == MpcProtocol::kBooleanGmw);
+
+  // the output wires are the output wires of the XOR of the parties' inputs, thus
+  // Gate::SetOnlineReady should not mark the output wires online-ready
+  own_output_wires_ = false;
+
+  const auto my_id{GetCommunicationLayer().GetMyId()};
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+
+  // each party inputs its XOR shares into the garbled circuit, the evaluator obtains the labels of
+  // its own shares by OTs
+  std::vector<ShareWrapper> shares;
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    const auto input_gate{proto::garbled_circuit::Provider::MakeInputGate(
+        party_id, parent_.size(), number_of_simd, backend_)};
+    if (party_id == my_id) input_promise_ = &input_gate->GetInputPromise();
+    shares.emplace_back(input_gate->GetOutputAsGarbledCircuitShare());
+  }
+  output_wires_ = (shares[0] ^ shares[1])->GetWires();
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wires: ", gate_id_);
+    for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    gate_info.append(" output wires: ");
+    for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    GetLogger().LogDebug(
+         "Created a Boolean GMW to garbled circuit conversion gate with following properties: {}",
+        gate_info);
+  }
+}
+
+void BooleanGmwToGarbledCircuitGate::EvaluateSetup() {}
+
+void BooleanGmwToGarbledCircuitGate::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Start evaluating online phase of Boolean GMW to garbled circuit Gate with id#{}",
+        gate_id_);
+  }
+
+  std::vector<BitVector<>> inputs;
+  inputs.reserve(parent_.size());
+  for (const auto& wire : parent_) {
+    auto gmw_input{std::dynamic_pointer_cast<const proto::boolean_gmw::Wire>(wire)};
+    assert(gmw_input);
+    gmw_input->GetIsReadyCondition().Wait();
+    inputs.emplace_back(gmw_input->GetValues());
+  }
+  input_promise_->set_value(std::move(inputs));
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Finished evaluating online phase of Boolean GMW to garbled circuit Gate with id#{}",
+        gate_id_);
+  }
+}
+
+const proto::garbled_circuit::SharePointer
+BooleanGmwToGarbledCircuitGate::GetOutputAsGarbledCircuitShare() const {
+  auto result =
+      backend_.GetRegister()->EmplaceShared<proto::garbled_circuit::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const SharePointer BooleanGmwToGarbledCircuitGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<Share>(GetOutputAsGarbledCircuitShare());
+  assert(result);
+  return result;
+}
+
+ArithmeticGmwToGarbledCircuitGate::ArithmeticGmwToGarbledCircuitGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == 1);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kArithmeticGmw);
+
+  // the output wires are the output wires of the garbled addition circuit, thus
+  // Gate::SetOnlineReady should not mark the output wires online-ready
+  own_output_wires_ = false;
+
+  const auto my_id{GetCommunicationLayer().GetMyId()};
+  const auto bitlength{parent_[0]->GetBitLength()};
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+
+  std::vector<SecureUnsignedInteger> shares;
+  shares.reserve(2);
+  for (std::size_t party_id = 0; party_id < 2; ++party_id) {
+    const auto input_gate{proto::garbled_circuit::Provider::MakeInputGate(
+        party_id, bitlength, number_of_simd, backend_)};
+    if (party_id == my_id) input_promise_ = &input_gate->GetInputPromise();
+    shares.emplace_back(ShareWrapper(input_gate->GetOutputAsGarbledCircuitShare()));
+  }
+  output_wires_ = (shares[0] + shares[1]).Get()->GetWires();
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wire: {} output wires: ", gate_id_,
+                                 parent_[0]->GetWireId());
+    for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    GetLogger().LogDebug(
+        
+        "Created an arithmetic GMW to garbled circuit conversion gate with following properties: "
+        "{}",
+        gate_info);
+  }
+}
+
+void ArithmeticGmwToGarbledCircuitGate::EvaluateSetup() {}
+
+void ArithmeticGmwToGarbledCircuitGate::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Start evaluating online phase of arithmetic GMW to garbled circuit Gate with id#{}",
+        gate_id_);
+  }
+
+  parent_[0]->GetIsReadyCondition().Wait();
+  SetArithmeticInput(parent_[0], *input_promise_);
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Finished evaluating online phase of arithmetic GMW to garbled circuit Gate with id#{}",
+        gate_id_);
+  }
+}
+
+const proto::garbled_circuit::SharePointer
+ArithmeticGmwToGarbledCircuitGate::GetOutputAsGarbledCircuitShare() const {
+  auto result =
+      backend_.GetRegister()->EmplaceShared<proto::garbled_circuit::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const SharePointer ArithmeticGmwToGarbledCircuitGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<Share>(GetOutputAsGarbledCircuitShare());
+  assert(result);
+  return result;
+}
+
+GarbledCircuitToBooleanGmwGate::GarbledCircuitToBooleanGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  for ([[maybe_unused]] const auto& wire : parent_)
+    assert(wire->GetProtocol() == MpcProtocol::kGarbledCircuit);
+
+  output_wires_.reserve(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    output_wires_.emplace_back(GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(
+        backend_, parent_[0]->GetNumberOfSimdValues()));
+  }
+
+  // the keys are read for their permutation bits, see Provider::SetFreeKeysAfterLastUse
+  if (GetGarbledCircuitProvider().GetFreeKeysAfterLastUse()) {
+    for (auto& wire : parent_) {
+      auto gc_wire{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(wire)};
+      assert(gc_wire);
+      gc_wire->AddKeyConsumer();
+    }
+  }
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wires: ", gate_id_);
+    for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    gate_info.append(" output wires: ");
+    for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    GetLogger().LogDebug(
+         "Created a garbled circuit to Boolean GMW conversion gate with following properties: {}",
+        gate_info);
+  }
+}
+
+void GarbledCircuitToBooleanGmwGate::EvaluateSetup() {}
+
+void GarbledCircuitToBooleanGmwGate::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Start evaluating online phase of garbled circuit to Boolean GMW Gate with id#{}",
+        gate_id_);
+  }
+
+  auto& provider{GetGarbledCircuitProvider()};
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    auto gc_input{std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(parent_[i])};
+    assert(gc_input);
+    auto gmw_output{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[i])};
+    assert(gmw_output);
+    gc_input->GetIsReadyCondition().Wait();
+    // the permutation bits of the garbler's zero keys and of the evaluator's active labels differ
+    // exactly if the value is 1, cf. proto::garbled_circuit::OutputGate
+    gmw_output->GetMutableValues() = gc_input->CopyPermutationBits();
+    if (provider.GetFreeKeysAfterLastUse()) gc_input->ReleaseKeys();
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Finished evaluating online phase of garbled circuit to Boolean GMW Gate with id#{}",
+        gate_id_);
+  }
+}
+
+const proto::boolean_gmw::SharePointer GarbledCircuitToBooleanGmwGate::GetOutputAsGmwShare()
+    const {
+  auto result = backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires_);
+  assert(result);
+  return result;
+}
+
+const SharePointer GarbledCircuitToBooleanGmwGate::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<Share>(GetOutputAsGmwShare());
+  assert(result);
+  return result;
+}
+
+template <typename T>
+GarbledCircuitToArithmeticGmwGate<T>::GarbledCircuitToArithmeticGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == sizeof(T) * 8);
+  for ([[maybe_unused]] const auto& wire : parent_)
+    assert(wire->GetProtocol() == MpcProtocol::kGarbledCircuit);
+
+  constexpr auto kGarbler{static_cast<std::size_t>(GarbledCircuitRole::kGarbler)};
+  constexpr auto kEvaluator{static_cast<std::size_t>(GarbledCircuitRole::kEvaluator)};
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+
+  output_wires_ = {
+      GetRegister().template EmplaceWire<proto::arithmetic_gmw::Wire<T>>(backend_, number_of_simd)};
+
+  // the garbler inputs its random share r and the evaluator learns x - r
+  const auto mask_gate{proto::garbled_circuit::Provider::MakeInputGate(
+      kGarbler, sizeof(T) * 8, number_of_simd, backend_)};
+  if (GetCommunicationLayer().GetMyId() == kGarbler) mask_promise_ = &mask_gate->GetInputPromise();
+  SecureUnsignedInteger value{ShareWrapper(parent)};
+  SecureUnsignedInteger mask{ShareWrapper(mask_gate->GetOutputAsGarbledCircuitShare())};
+  masked_output_ = GetRegister().template EmplaceGate<proto::garbled_circuit::OutputGate>(
+      (value - mask).Get().Get(), kEvaluator);
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wires: ", gate_id_);
+    for (const auto& wire : parent_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    gate_info.append(fmt::format(" output wire: {}", output_wires_[0]->GetWireId()));
+    GetLogger().LogDebug(
+        
+        "Created a garbled circuit to arithmetic GMW conversion gate with following properties: "
+        "{}",
+        gate_info);
+  }
+}
+
+template <typename T>
+void GarbledCircuitToArithmeticGmwGate<T>::EvaluateSetup() {}
+
+template <typename T>
+void GarbledCircuitToArithmeticGmwGate<T>::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Start evaluating online phase of garbled circuit to arithmetic GMW Gate with id#{}",
+        gate_id_);
+  }
+
+  auto arithmetic_output{
+      std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(output_wires_[0])};
+  assert(arithmetic_output);
+  if (mask_promise_) {  // garbler
+    auto mask{RandomVector<T>(arithmetic_output->GetNumberOfSimdValues())};
+    mask_promise_->set_value(ToInput(mask));
+    arithmetic_output->GetMutableValues() = std::move(mask);
+  } else {  // evaluator
+    masked_output_->WaitOnline();
+    std::vector<BitVector<>> masked_bits;
+    masked_bits.reserve(sizeof(T) * 8);
+    for (const auto& wire : masked_output_->GetOutputWires()) {
+      auto constant_wire{std::dynamic_pointer_cast<ConstantBooleanWire>(wire)};
+      assert(constant_wire);
+      masked_bits.emplace_back(constant_wire->GetValues());
+    }
+    arithmetic_output->GetMutableValues() = ToVectorOutput<T>(std::move(masked_bits));
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Finished evaluating online phase of garbled circuit to arithmetic GMW Gate with id#{}",
+        gate_id_);
+  }
+}
+
+template <typename T>
+const proto::arithmetic_gmw::SharePointer<T>
+GarbledCircuitToArithmeticGmwGate<T>::GetOutputAsArithmeticShare() const {
+  auto arithmetic_wire{
+      std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(output_wires_[0])};
+  assert(arithmetic_wire);
+  return std::make_shared<proto::arithmetic_gmw::Share<T>>(arithmetic_wire);
+}
+
+template <typename T>
+const SharePointer GarbledCircuitToArithmeticGmwGate<T>::GetOutputAsShare() const {
+  auto result = std::static_pointer_cast<Share>(GetOutputAsArithmeticShare());
+  assert(result);
+  return result;
+}
+
+template class GarbledCircuitToArithmeticGmwGate<std::uint8_t>;
+template class GarbledCircuitToArithmeticGmwGate<std::uint16_t>;
+template class GarbledCircuitToArithmeticGmwGate<std::uint32_t>;
+template class GarbledCircuitToArithmeticGmwGate<std::uint64_t>;
+
+template <typename T>
+ArithmeticGmwToBooleanGmwGate<T>::ArithmeticGmwToBooleanGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == 1);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kArithmeticGmw);
+  assert(parent_[0]->GetBitLength() == sizeof(T) * 8);
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+
+  // the wires of the propagate bits followed by the wires of the generate bits
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  output_wires_.reserve(2 * kBitLength);
+  for (std::size_t i = 0; i < 2 * kBitLength; ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(backend_, number_of_simd));
+  }
+
+  auto masked_wire{
+      GetRegister().template EmplaceWire<proto::arithmetic_gmw::Wire<T>>(backend_, number_of_simd)};
+  masked_share_ = std::make_shared<proto::arithmetic_gmw::Share<T>>(masked_wire);
+  masked_output_ = GetRegister().template EmplaceGate<proto::arithmetic_gmw::OutputGate<T>>(
+      masked_share_, OutputGate::kAll);
+
+  edabit_offset_ = GetSbProvider().template RequestEdaBits<T>(number_of_simd);
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wire: {} output wires: ", gate_id_,
+                                 parent_[0]->GetWireId());
+    for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    GetLogger().LogDebug(
+         "Created an arithmetic GMW to Boolean GMW conversion gate with following properties: {}",
+        gate_info);
+  }
+}
+
+template <typename T>
+void ArithmeticGmwToBooleanGmwGate<T>::EvaluateSetup() {}
+
+template <typename T>
+void ArithmeticGmwToBooleanGmwGate<T>::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Start evaluating online phase of arithmetic GMW to Boolean GMW Gate with id#{}",
+        gate_id_);
+  }
+
+  auto arithmetic_input{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(parent_.at(0))};
+  assert(arithmetic_input);
+  arithmetic_input->GetIsReadyCondition().Wait();
+
+  auto& sb_provider{GetSbProvider()};
+  sb_provider.WaitFinished();
+  const auto number_of_simd{arithmetic_input->GetNumberOfSimdValues()};
+  const auto edabits{sb_provider.template GetEdaBits<T>(edabit_offset_, number_of_simd)};
+
+  // open c = x - r
+  auto masked_wire{masked_share_->GetArithmeticWire()};
+  auto& masked_values{masked_wire->GetMutableValues()};
+  masked_values.resize(number_of_simd);
+  const auto& input_values{arithmetic_input->GetValues()};
+  for (std::size_t j = 0; j < number_of_simd; ++j) {
+    masked_values[j] = input_values[j] - edabits.arithmetic_shares[j];
+  }
+  masked_wire->SetOnlineFinished();
+  masked_output_->WaitOnline();
+  auto opened_wire{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(
+      masked_output_->GetOutputWires()[0])};
+  assert(opened_wire);
+  const auto masked_bits{ToInput(opened_wire->GetValues())};
+
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  const bool provides_public_bits{GetCommunicationLayer().GetMyId() == 0};
+  for (std::size_t i = 0; i < kBitLength; ++i) {
+    auto propagate{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[i])};
+    auto generate{
+        std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[kBitLength + i])};
+    assert(propagate && generate);
+    propagate->GetMutableValues() = edabits.boolean_shares[i];
+    if (provides_public_bits) propagate->GetMutableValues() ^= masked_bits[i];
+    generate->GetMutableValues() = edabits.boolean_shares[i] & masked_bits[i];
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug(
+         "Finished evaluating online phase of arithmetic GMW to Boolean GMW Gate with id#{}",
+        gate_id_);
+  }
+}
+
+template <typename T>
+const proto::boolean_gmw::SharePointer
+ArithmeticGmwToBooleanGmwGate<T>::GetPropagateAsBooleanShare() const {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  std::vector<WirePointer> wires(output_wires_.begin(), output_wires_.begin() + kBitLength);
+  return backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(wires);
+}
+
+template <typename T>
+const proto::boolean_gmw::SharePointer
+ArithmeticGmwToBooleanGmwGate<T>::GetGenerateAsBooleanShare() const {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  std::vector<WirePointer> wires(output_wires_.begin() + kBitLength, output_wires_.end());
+  return backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(wires);
+}
+
+template class ArithmeticGmwToBooleanGmwGate<std::uint8_t>;
+template class ArithmeticGmwToBooleanGmwGate<std::uint16_t>;
+template class ArithmeticGmwToBooleanGmwGate<std::uint32_t>;
+template class ArithmeticGmwToBooleanGmwGate<std::uint64_t>;
+
+template <typename T>
+AstraToBooleanGmwGate<T>::AstraToBooleanGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == 1);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kAstra);
+  assert(parent_[0]->GetBitLength() == sizeof(T) * 8);
+  if (GetCommunicationLayer().GetNumberOfParties() != 3) {
+    throw std::invalid_argument("ASTRA to Boolean GMW conversion requires exactly 3 parties");
+  }
+
+  // the wires of the masked value followed by the wires of the mask
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  output_wires_.reserve(2 * kBitLength);
+  for (std::size_t i = 0; i < 2 * kBitLength; ++i) {
+    output_wires_.emplace_back(GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(
+        backend_, parent_[0]->GetNumberOfSimdValues()));
+  }
+
+  if constexpr (kDebug) {
+    auto gate_info = fmt::format("gate id {}, parent wire: {} output wires: ", gate_id_,
+                                 parent_[0]->GetWireId());
+    for (const auto& wire : output_wires_) gate_info.append(fmt::format("{} ", wire->GetWireId()));
+    GetLogger().LogDebug(
+         "Created an ASTRA to Boolean GMW conversion gate with following properties: {}",
+        gate_info);
+  }
+}
+
+template <typename T>
+void AstraToBooleanGmwGate<T>::EvaluateSetup() {}
+
+template <typename T>
+void AstraToBooleanGmwGate<T>::EvaluateOnline() {
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Start evaluating online phase of ASTRA to Boolean GMW Gate with id#{}",
+                         gate_id_);
+  }
+
+  auto astra_input{std::dynamic_pointer_cast<proto::astra::Wire<T>>(parent_.at(0))};
+  assert(astra_input);
+  astra_input->GetSetupReadyCondition()->Wait();
+  astra_input->GetIsReadyCondition().Wait();
+
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  const auto my_id{GetCommunicationLayer().GetMyId()};
+  const auto& values{astra_input->GetValues()};
+
+  // both evaluators know the masked value, the one providing it is chosen based on the gate id
+  // for the purpose of load balancing
+  std::vector<BitVector<>> bits;
+  if (my_id == 1 + static_cast<std::size_t>(gate_id_) % 2) {
+    std::vector<T> masked_values(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) masked_values[i] = values[i].value;
+    bits = ToInput(masked_values);
+  } else if (my_id == 0) {
+    std::vector<T> masks(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      masks[i] = values[i].lambda1 + values[i].lambda2;
+    }
+    bits = ToInput(masks);
+  }
+
+  const std::size_t first_wire{my_id == 0 ? kBitLength : 0};
+  for (std::size_t i = 0; i < kBitLength && !bits.empty(); ++i) {
+    auto gmw_output{
+        std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_.at(first_wire + i))};
+    assert(gmw_output);
+    gmw_output->GetMutableValues() = std::move(bits[i]);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Finished evaluating online phase of ASTRA to Boolean GMW Gate with id#{}",
+                         gate_id_);
+  }
+}
+
+template <typename T>
+const proto::boolean_gmw::SharePointer AstraToBooleanGmwGate<T>::GetMaskedValueAsBooleanShare()
+    const {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  std::vector<WirePointer> wires(output_wires_.begin(), output_wires_.begin() + kBitLength);
+  return backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(wires);
+}
+
+template <typename T>
+const proto::boolean_gmw::SharePointer AstraToBooleanGmwGate<T>::GetMaskAsBooleanShare() const {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  std::vector<WirePointer> wires(output_wires_.begin() + kBitLength, output_wires_.end());
+  return backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(wires);
+}
+
+template class AstraToBooleanGmwGate<std::uint8_t>;
+template class AstraToBooleanGmwGate<std::uint16_t>;
+template class AstraToBooleanGmwGate<std::uint32_t>;
+template class AstraToBooleanGmwGate<std::uint64_t>;
+
+template <typename T>
+ArithmeticReplicatedToArithmeticGmwGate<T>::ArithmeticReplicatedToArithmeticGmwGate(
+    const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == 1);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kArithmeticReplicated);
+  assert(parent_[0]->GetBitLength() == sizeof(T) * 8);
+
+  output_wires_ = {GetRegister().EmplaceWire<proto::arithmetic_gmw::Wire<T>>(
+      backend_, parent_[0]->GetNumberOfSimdValues())};
+}
+
+template <typename T>
+void ArithmeticReplicatedToArithmeticGmwGate<T>::EvaluateOnline() {
+  auto replicated_input{
+      std::dynamic_pointer_cast<const proto::replicated::ArithmeticWire<T>>(parent_.at(0))};
+  assert(replicated_input);
+  replicated_input->GetIsReadyCondition().Wait();
+
+  auto gmw_output{std::dynamic_pointer_cast<proto::arithmetic_gmw::Wire<T>>(output_wires_.at(0))};
+  assert(gmw_output);
+  gmw_output->GetMutableValues() = replicated_input->GetValues();
+}
+
+template <typename T>
+const SharePointer ArithmeticReplicatedToArithmeticGmwGate<T>::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<proto::arithmetic_gmw::Share<T>>(output_wires_);
+}
+
+template class ArithmeticReplicatedToArithmeticGmwGate<std::uint8_t>;
+template class ArithmeticReplicatedToArithmeticGmwGate<std::uint16_t>;
+template class ArithmeticReplicatedToArithmeticGmwGate<std::uint32_t>;
+template class ArithmeticReplicatedToArithmeticGmwGate<std::uint64_t>;
+template class ArithmeticReplicatedToArithmeticGmwGate<__uint128_t>;
+
+BooleanReplicatedToBooleanGmwGate::BooleanReplicatedToBooleanGmwGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kBooleanReplicated);
+
+  output_wires_.reserve(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    output_wires_.emplace_back(GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(
+        backend_, parent_[0]->GetNumberOfSimdValues()));
+  }
+}
+
+void BooleanReplicatedToBooleanGmwGate::EvaluateOnline() {
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    auto replicated_input{
+        std::dynamic_pointer_cast<const proto::replicated::BooleanWire>(parent_.at(i))};
+    assert(replicated_input);
+    replicated_input->GetIsReadyCondition().Wait();
+
+    auto gmw_output{std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_.at(i))};
+    assert(gmw_output);
+    gmw_output->GetMutableValues() = replicated_input->GetValues();
+  }
+}
+
+const SharePointer BooleanReplicatedToBooleanGmwGate::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires_);
+}
+
+template <typename T>
+ArithmeticGmwToArithmeticReplicatedGate<T>::ArithmeticGmwToArithmeticReplicatedGate(
+    const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() == 1);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kArithmeticGmw);
+  assert(parent_[0]->GetBitLength() == sizeof(T) * 8);
+  auto& communication_layer{GetCommunicationLayer()};
+  if (communication_layer.GetNumberOfParties() != 3) {
+    throw std::invalid_argument("Conversions to replicated shares require exactly 3 parties");
+  }
+
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  output_wires_ = {GetRegister().EmplaceWire<proto::replicated::ArithmeticWire<T>>(
+      backend_, number_of_simd)};
+  sharing_id_ = GetRegister().NextArithmeticSharingId(number_of_simd);
+
+  reshare_future_ = communication_layer.GetMessageManager().RegisterReceive(
+      (communication_layer.GetMyId() + 1) % 3, communication::MessageType::kReplicatedReshareGate,
+      gate_id_);
+}
+
+template <typename T>
+void ArithmeticGmwToArithmeticReplicatedGate<T>::EvaluateOnline() {
+  auto gmw_input{std::dynamic_pointer_cast<const proto::arithmetic_gmw::Wire<T>>(parent_.at(0))};
+  assert(gmw_input);
+  gmw_input->GetIsReadyCondition().Wait();
+
+  const auto number_of_simd{gmw_input->GetNumberOfSimdValues()};
+  auto values{proto::replicated::ArithmeticZeroSharing<T>(backend_, sharing_id_, number_of_simd)};
+  for (std::size_t i = 0; i < number_of_simd; ++i) values[i] += gmw_input->GetValues()[i];
+
+  auto& communication_layer{GetCommunicationLayer()};
+  auto payload{ToByteVector<T>(values)};
+  auto message{communication::BuildMessage(communication::MessageType::kReplicatedReshareGate,
+                                           gate_id_, payload)};
+  communication_layer.SendMessage((communication_layer.GetMyId() + 2) % 3, message.Release());
+
+  auto replicated_output{
+      std::dynamic_pointer_cast<proto::replicated::ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(replicated_output);
+  replicated_output->GetMutableValues() = std::move(values);
+  const auto next_message{reshare_future_.get()};
+  auto next_payload{communication::GetMessage(next_message.data())->payload()};
+  replicated_output->GetMutableNextValues() =
+      FromByteVector<T>({next_payload->data(), next_payload->size()});
+  assert(replicated_output->GetNextValues().size() == number_of_simd);
+}
+
+template <typename T>
+const SharePointer ArithmeticGmwToArithmeticReplicatedGate<T>::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<proto::replicated::ArithmeticShare<T>>(
+      output_wires_);
+}
+
+template class ArithmeticGmwToArithmeticReplicatedGate<std::uint8_t>;
+template class ArithmeticGmwToArithmeticReplicatedGate<std::uint16_t>;
+template class ArithmeticGmwToArithmeticReplicatedGate<std::uint32_t>;
+template class ArithmeticGmwToArithmeticReplicatedGate<std::uint64_t>;
+template class ArithmeticGmwToArithmeticReplicatedGate<__uint128_t>;
+
+BooleanGmwToBooleanReplicatedGate::BooleanGmwToBooleanReplicatedGate(const SharePointer& parent)
+    : OneGate(parent->GetBackend()) {
+  parent_ = parent->GetWires();
+
+  assert(parent_.size() > 0);
+  assert(parent_[0]->GetProtocol() == MpcProtocol::kBooleanGmw);
+  auto& communication_layer{GetCommunicationLayer()};
+  if (communication_layer.GetNumberOfParties() != 3) {
+    throw std::invalid_argument("Conversions to replicated shares require exactly 3 parties");
+  }
+
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  output_wires_.reserve(parent_.size());
+  for (std::size_t i = 0; i < parent_.size(); ++i) {
+    output_wires_.emplace_back(
+        GetRegister().EmplaceWire<proto::replicated::BooleanWire>(backend_, number_of_simd));
+  }
+  sharing_id_ = GetRegister().NextBooleanGmwSharingId(parent_.size() * number_of_simd);
+
+  reshare_future_ = communication_layer.GetMessageManager().RegisterReceive(
+      (communication_layer.GetMyId() + 1) % 3, communication::MessageType::kReplicatedReshareGate,
+      gate_id_);
+}
+
+void BooleanGmwToBooleanReplicatedGate::EvaluateOnline() {
+  const auto number_of_wires{parent_.size()};
+  const auto number_of_simd{parent_[0]->GetNumberOfSimdValues()};
+  const auto zero_sharing{proto::replicated::BooleanZeroSharing(backend_, sharing_id_,
+                                                                number_of_wires * number_of_simd)};
+
+  // the rerandomized shares of all wires are sent in a single message
+  std::vector<BitVector<>> values;
+  values.reserve(number_of_wires);
+  BitVector<> buffer;
+  for (std::size_t i = 0; i < number_of_wires; ++i) {
+    auto gmw_input{std::dynamic_pointer_cast<const proto::boolean_gmw::Wire>(parent_.at(i))};
+    assert(gmw_input);
+    gmw_input->GetIsReadyCondition().Wait();
+    values.emplace_back(gmw_input->GetValues() ^
+                        zero_sharing.Subset(i * number_of_simd, (i + 1) * number_of_simd));
+    buffer.Append(values.back());
+  }
+
+  auto& communication_layer{GetCommunicationLayer()};
+  std::span payload(reinterpret_cast<const std::uint8_t*>(buffer.GetData().data()),
+                    buffer.GetData().size());
+  auto message{communication::BuildMessage(communication::MessageType::kReplicatedReshareGate,
+                                           gate_id_, payload)};
+  communication_layer.SendMessage((communication_layer.GetMyId() + 2) % 3, message.Release());
+
+  const auto next_message{reshare_future_.get()};
+  auto next_payload{communication::GetMessage(next_message.data())->payload()};
+  BitSpan next_bits(const_cast<std::uint8_t*>(next_payload->data()),
+                    number_of_wires * number_of_simd);
+  for (std::size_t i = 0; i < number_of_wires; ++i) {
+    auto replicated_output{
+        std::dynamic_pointer_cast<proto::replicated::BooleanWire>(output_wires_.at(i))};
+    assert(replicated_output);
+    replicated_output->GetMutableValues() = std::move(values[i]);
+    replicated_output->GetMutableNextValues() =
+        next_bits.Subset(i * number_of_simd, (i + 1) * number_of_simd);
+  }
+}
+
+const SharePointer BooleanGmwToBooleanReplicatedGate::GetOutputAsShare() const {
+  return backend_.GetRegister()->EmplaceShared<proto::replicated::BooleanShare>(output_wires_);
+}
+
 }  // namespace encrypto::motion
@@ -29,6 +29,17 @@
 #include "utility/block.h"
 #include "utility/reusable_future.h"
 
+namespace encrypto::motion::proto::arithmetic_gmw {
+
+template <typename T>
+class OutputGate;
+template <typename T>
+class Share;
+template <typename T>
+using SharePointer = std::shared_ptr<Share<T>>;
+
+}  // namespace encrypto::motion::proto::arithmetic_gmw
+
 namespace encrypto::motion::proto::bmr {
 
 class Share;
@@ -36,6 +47,14 @@ using SharePointer = std::shared_ptr<Share>;
 
 }  // namespace encrypto::motion::proto::bmr
 
+namespace encrypto::motion::proto::garbled_circuit {
+
+class OutputGate;
+class Share;
+using SharePointer = std::shared_ptr<Share>;
+
+}  // namespace encrypto::motion::proto::garbled_circuit
+
 namespace encrypto::motion::proto::boolean_gmw {
 
 class Share;
@@ -80,6 +99,8 @@ class BooleanGmwToBmrGate final : public OneGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  // the public values, the keys are not estimated
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   const proto::bmr::SharePointer GetOutputAsBmrShare() const;
 
@@ -103,6 +124,8 @@ class ArithmeticGmwToBmrGate final : public OneGate {
   void EvaluateSetup() final override;
 
   void EvaluateOnline() final override;
+  // the public values, the keys are not estimated
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
 
   bool NeedsSetup() const override { return false; }
 
@@ -118,4 +141,280 @@ class ArithmeticGmwToBmrGate final : public OneGate {
   ReusableFiberPromise<std::vector<BitVector<>>>* input_promise_;
 };
 
+/// \brief Converts Boolean GMW shares into shares of the two-party garbled circuit protocol.  Both
+/// parties input their XOR shares into the garbled circuit, where the evaluator obtains the labels
+/// of its shares by OTs, and the shares are combined by free XORs.
+class BooleanGmwToGarbledCircuitGate final : public OneGate {
+ public:
+  BooleanGmwToGarbledCircuitGate(const SharePointer& parent);
+
+  ~BooleanGmwToGarbledCircuitGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const proto::garbled_circuit::SharePointer GetOutputAsGarbledCircuitShare() const;
+
+  const SharePointer GetOutputAsShare() const;
+
+  BooleanGmwToGarbledCircuitGate() = delete;
+
+  BooleanGmwToGarbledCircuitGate(const Gate&) = delete;
+
+ private:
+  ReusableFiberPromise<std::vector<BitVector<>>>* input_promise_;
+};
+
+/// \brief Converts an arithmetic GMW share into a share of the two-party garbled circuit
+/// protocol.  Both parties input the bits of their shares into the garbled circuit as in
+/// BooleanGmwToGarbledCircuitGate, which are then added by a garbled addition circuit.
+class ArithmeticGmwToGarbledCircuitGate final : public OneGate {
+ public:
+  ArithmeticGmwToGarbledCircuitGate(const SharePointer& parent);
+
+  ~ArithmeticGmwToGarbledCircuitGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const proto::garbled_circuit::SharePointer GetOutputAsGarbledCircuitShare() const;
+
+  const SharePointer GetOutputAsShare() const;
+
+  ArithmeticGmwToGarbledCircuitGate() = delete;
+
+  ArithmeticGmwToGarbledCircuitGate(const Gate&) = delete;
+
+ private:
+  ReusableFiberPromise<std::vector<BitVector<>>>* input_promise_;
+};
+
+/// \brief Converts shares of the two-party garbled circuit protocol into Boolean GMW shares.  The
+/// permutation bits of the garbler's zero keys and of the evaluator's labels are XOR shares of the
+/// values, so the conversion is local.
+class GarbledCircuitToBooleanGmwGate final : public OneGate {
+ public:
+  GarbledCircuitToBooleanGmwGate(const SharePointer& parent);
+
+  ~GarbledCircuitToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  const proto::boolean_gmw::SharePointer GetOutputAsGmwShare() const;
+
+  const SharePointer GetOutputAsShare() const;
+
+  GarbledCircuitToBooleanGmwGate() = delete;
+
+  GarbledCircuitToBooleanGmwGate(const Gate&) = delete;
+};
+
+/// \brief Converts a share x of the two-party garbled circuit protocol into arithmetic GMW shares
+/// by a masked reveal.  The garbler inputs a random r, the garbled circuit computes x - r, which
+/// is revealed to the evaluator only, and the garbler's share is r.
+template <typename T>
+class GarbledCircuitToArithmeticGmwGate final : public OneGate {
+ public:
+  GarbledCircuitToArithmeticGmwGate(const SharePointer& parent);
+
+  ~GarbledCircuitToArithmeticGmwGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  const proto::arithmetic_gmw::SharePointer<T> GetOutputAsArithmeticShare() const;
+
+  const SharePointer GetOutputAsShare() const;
+
+  GarbledCircuitToArithmeticGmwGate() = delete;
+
+  GarbledCircuitToArithmeticGmwGate(const Gate&) = delete;
+
+ private:
+  // the garbler's input of r
+  ReusableFiberPromise<std::vector<BitVector<>>>* mask_promise_{nullptr};
+  // reveals x - r to the evaluator
+  std::shared_ptr<proto::garbled_circuit::OutputGate> masked_output_;
+};
+
+/// \brief Converts an arithmetic GMW share x into Boolean GMW shares with an edaBit r, see
+/// SbProvider::GetEdaBits.  The parties open c = x - r in one round and output the Boolean shares
+/// of the propagate bits c ^ r and of the generate bits c & r of the addition x = c + r, which are
+/// local since c is public.  The carries are then computed by a parallel prefix circuit, see
+/// ShareWrapper::Convert.
+template <typename T>
+class ArithmeticGmwToBooleanGmwGate final : public OneGate {
+ public:
+  ArithmeticGmwToBooleanGmwGate(const SharePointer& parent);
+
+  ~ArithmeticGmwToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  // the first sizeof(T) * 8 output wires
+  const proto::boolean_gmw::SharePointer GetPropagateAsBooleanShare() const;
+
+  // the last sizeof(T) * 8 output wires
+  const proto::boolean_gmw::SharePointer GetGenerateAsBooleanShare() const;
+
+  ArithmeticGmwToBooleanGmwGate() = delete;
+
+  ArithmeticGmwToBooleanGmwGate(const Gate&) = delete;
+
+ private:
+  std::size_t edabit_offset_;
+  // the shares of c, which are opened by masked_output_
+  proto::arithmetic_gmw::SharePointer<T> masked_share_;
+  std::shared_ptr<proto::arithmetic_gmw::OutputGate<T>> masked_output_;
+};
+
+/// \brief Converts an ASTRA share x = v - lambda into Boolean GMW shares of the public masked value
+/// v, which evaluator 1 provides, and of the mask lambda = lambda_1 + lambda_2, which the helper
+/// party provides.  The bits of x are then computed by a Boolean subtraction circuit, see
+/// ShareWrapper::Convert.  The gate is local, since each of the sharings is held by a single party
+/// and the shares of the other parties are zero.
+template <typename T>
+class AstraToBooleanGmwGate final : public OneGate {
+ public:
+  AstraToBooleanGmwGate(const SharePointer& parent);
+
+  ~AstraToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final override;
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  // the first sizeof(T) * 8 output wires
+  const proto::boolean_gmw::SharePointer GetMaskedValueAsBooleanShare() const;
+
+  // the last sizeof(T) * 8 output wires
+  const proto::boolean_gmw::SharePointer GetMaskAsBooleanShare() const;
+
+  AstraToBooleanGmwGate() = delete;
+
+  AstraToBooleanGmwGate(const Gate&) = delete;
+};
+
+/// \brief Converts a replicated share (x_i, x_{i+1}) into a GMW share of the same circuit type.
+/// The conversion is local, since x_i already is an additive resp. XOR share of x.
+template <typename T>
+class ArithmeticReplicatedToArithmeticGmwGate final : public OneGate {
+ public:
+  ArithmeticReplicatedToArithmeticGmwGate(const SharePointer& parent);
+
+  ~ArithmeticReplicatedToArithmeticGmwGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  const SharePointer GetOutputAsShare() const;
+
+  ArithmeticReplicatedToArithmeticGmwGate() = delete;
+
+  ArithmeticReplicatedToArithmeticGmwGate(const Gate&) = delete;
+};
+
+class BooleanReplicatedToBooleanGmwGate final : public OneGate {
+ public:
+  BooleanReplicatedToBooleanGmwGate(const SharePointer& parent);
+
+  ~BooleanReplicatedToBooleanGmwGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  const SharePointer GetOutputAsShare() const;
+
+  BooleanReplicatedToBooleanGmwGate() = delete;
+
+  BooleanReplicatedToBooleanGmwGate(const Gate&) = delete;
+};
+
+/// \brief Converts a 3-party GMW share a_i into a replicated share by resharing: party i
+/// rerandomizes x_i = a_i + alpha_i with a zero sharing alpha, sends x_i to party i - 1 and
+/// receives x_{i+1} from party i + 1 in a single round.
+template <typename T>
+class ArithmeticGmwToArithmeticReplicatedGate final : public OneGate {
+ public:
+  ArithmeticGmwToArithmeticReplicatedGate(const SharePointer& parent);
+
+  ~ArithmeticGmwToArithmeticReplicatedGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  const SharePointer GetOutputAsShare() const;
+
+  ArithmeticGmwToArithmeticReplicatedGate() = delete;
+
+  ArithmeticGmwToArithmeticReplicatedGate(const Gate&) = delete;
+
+ private:
+  std::size_t sharing_id_;
+  ReusableFiberFuture<std::vector<std::uint8_t>> reshare_future_;
+};
+
+class BooleanGmwToBooleanReplicatedGate final : public OneGate {
+ public:
+  BooleanGmwToBooleanReplicatedGate(const SharePointer& parent);
+
+  ~BooleanGmwToBooleanReplicatedGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  const SharePointer GetOutputAsShare() const;
+
+  BooleanGmwToBooleanReplicatedGate() = delete;
+
+  BooleanGmwToBooleanReplicatedGate(const Gate&) = delete;
+
+ private:
+  std::size_t sharing_id_;
+  ReusableFiberFuture<std::vector<std::uint8_t>> reshare_future_;
+};
+
 }  // namespace encrypto::motion
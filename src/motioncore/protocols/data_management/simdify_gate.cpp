@@ -24,6 +24,7 @@
 
 #include "simdify_gate.h"
 
+#include "base/backend.h"
 #include "base/configuration.h"
 #include "base/register.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
@@ -416,25 +417,29 @@ SharePointer SimdifyGate::GetOutputAsShare() {
     case encrypto::motion::MpcProtocol::kArithmeticConstant: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint8_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint8_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 16: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint16_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint16_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 32: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint32_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint32_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 64: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint64_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint64_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
@@ -449,25 +454,29 @@ SharePointer SimdifyGate::GetOutputAsShare() {
     case encrypto::motion::MpcProtocol::kArithmeticGmw: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 16: {
-          auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 32: {
-          auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 64: {
-          auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
@@ -482,25 +491,29 @@ SharePointer SimdifyGate::GetOutputAsShare() {
     case encrypto::motion::MpcProtocol::kAstra: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          auto tmp = std::make_shared<proto::astra::Share<std::uint8_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::astra::Share<std::uint8_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 16: {
-          auto tmp = std::make_shared<proto::astra::Share<std::uint16_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::astra::Share<std::uint16_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 32: {
-          auto tmp = std::make_shared<proto::astra::Share<std::uint32_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::astra::Share<std::uint32_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 64: {
-          auto tmp = std::make_shared<proto::astra::Share<std::uint64_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::astra::Share<std::uint64_t>>(output_wires_);
           assert(tmp);
           share = std::static_pointer_cast<Share>(tmp);
           break;
@@ -513,19 +526,19 @@ SharePointer SimdifyGate::GetOutputAsShare() {
       break;
     }
     case encrypto::motion::MpcProtocol::kBmr: {
-      auto tmp = std::make_shared<proto::bmr::Share>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::bmr::Share>(output_wires_);
       assert(tmp);
       share = std::static_pointer_cast<Share>(tmp);
       break;
     }
     case encrypto::motion::MpcProtocol::kBooleanConstant: {
-      auto tmp = std::make_shared<proto::ConstantBooleanShare>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::ConstantBooleanShare>(output_wires_);
       assert(tmp);
       share = std::static_pointer_cast<Share>(tmp);
       break;
     }
     case encrypto::motion::MpcProtocol::kBooleanGmw: {
-      auto tmp = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires_);
       assert(tmp);
       share = std::static_pointer_cast<Share>(tmp);
       break;
@@ -55,6 +55,8 @@ class SimdifyGate final : public OneGate {
 
   void EvaluateOnline() override;
 
+  bool IsLocal() const final override { return true; }
+
   SharePointer GetOutputAsShare();
 
   SimdifyGate() = delete;
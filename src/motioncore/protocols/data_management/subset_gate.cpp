@@ -24,6 +24,7 @@
 
 #include "subset_gate.h"
 
+#include "base/backend.h"
 #include "base/configuration.h"
 #include "base/register.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
@@ -41,7 +42,8 @@
 namespace encrypto::motion {
 
 SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& position_ids)
-    : OneGate(parent->GetBackend()), position_ids_(std::move(position_ids)) {
+    : OneGate(parent->GetBackend()),
+      position_ids_(std::make_shared<const std::vector<std::size_t>>(std::move(position_ids))) {
   parent_ = parent->GetWires();
 
   if constexpr (kDebug) {
@@ -49,7 +51,7 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
       throw std::invalid_argument(
           fmt::format("Input share in SubsetGate#{} has no wires", gate_id_));
     }
-    if (position_ids_.empty()) {
+    if (position_ids_->empty()) {
       throw std::invalid_argument(
           fmt::format("The list of position ids in SubsetGate#{} is empty", gate_id_));
     }
@@ -84,25 +86,25 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
           case 8: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::ConstantArithmeticWire<std::uint8_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 16: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::ConstantArithmeticWire<std::uint16_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 32: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::ConstantArithmeticWire<std::uint32_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 64: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::ConstantArithmeticWire<std::uint64_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           default:
@@ -117,25 +119,25 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
           case 8: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::arithmetic_gmw::Wire<std::uint8_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 16: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::arithmetic_gmw::Wire<std::uint16_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 32: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::arithmetic_gmw::Wire<std::uint32_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           case 64: {
             output_wires_.emplace_back(
                 GetRegister().EmplaceWire<proto::arithmetic_gmw::Wire<std::uint64_t>>(
-                    backend_, position_ids_.size()));
+                    backend_, position_ids_->size()));
             break;
           }
           default:
@@ -147,23 +149,37 @@ SubsetGate::SubsetGate(const SharePointer& parent, std::vector<std::size_t>&& po
       }
       case encrypto::motion::MpcProtocol::kBmr: {
         output_wires_.emplace_back(
-            GetRegister().EmplaceWire<proto::bmr::Wire>(backend_, position_ids_.size()));
+            GetRegister().EmplaceWire<proto::bmr::Wire>(backend_, position_ids_->size()));
         break;
       }
       case encrypto::motion::MpcProtocol::kBooleanConstant: {
         output_wires_.emplace_back(
-            GetRegister().EmplaceWire<proto::ConstantBooleanWire>(backend_, position_ids_.size()));
+            GetRegister().EmplaceWire<proto::ConstantBooleanWire>(backend_, position_ids_->size()));
         break;
       }
       case encrypto::motion::MpcProtocol::kBooleanGmw: {
         output_wires_.emplace_back(
-            GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(backend_, position_ids_.size()));
+            GetRegister().EmplaceWire<proto::boolean_gmw::Wire>(backend_, position_ids_->size()));
         break;
       }
       default:
         throw std::invalid_argument(fmt::format("Unrecognized MpcProtocol in SubsetGate"));
     }
   }
+
+  // the output wires are views of the parent wires or of their sources if they are views
+  const SimdView view{ResolveSimdView(parent_)};
+  auto view_positions{position_ids_};
+  if (view.positions) {
+    std::vector<std::size_t> source_positions(position_ids_->size());
+    for (std::size_t i = 0; i < source_positions.size(); ++i) {
+      source_positions[i] = view.positions->at((*position_ids_)[i]);
+    }
+    view_positions = std::make_shared<const std::vector<std::size_t>>(std::move(source_positions));
+  }
+  for (std::size_t i = 0; i < number_of_wires; ++i) {
+    output_wires_[i]->SetSimdView(view.sources[i], view_positions);
+  }
 }
 
 SubsetGate::SubsetGate(const SharePointer& parent, std::span<const std::size_t> position_ids)
@@ -200,10 +216,10 @@ void SubsetGate::EvaluateSetup() {
 
       for (std::size_t j = 0; j < parent_.size(); ++j) {
         BitVectorSubsetImplementation(in->GetPermutationBits(), out->GetMutablePermutationBits(),
-                                      position_ids_);
-        out->GetMutableSecretKeys().resize(position_ids_.size());
-        for (std::size_t k = 0; k < position_ids_.size(); ++k) {
-          out->GetMutableSecretKeys()[k] = in->GetSecretKeys()[position_ids_[k]];
+                                      *position_ids_);
+        out->GetMutableSecretKeys().resize(position_ids_->size());
+        for (std::size_t k = 0; k < position_ids_->size(); ++k) {
+          out->GetMutableSecretKeys()[k] = in->GetSecretKeys()[(*position_ids_)[k]];
         }
       }
       out->SetSetupIsReady();
@@ -260,22 +276,23 @@ void SubsetGate::EvaluateOnline() {
     case encrypto::motion::MpcProtocol::kArithmeticConstant: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          ArithmeticConstantSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticConstantSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0],
+                                                       *position_ids_);
           break;
         }
         case 16: {
           ArithmeticConstantSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+                                                        *position_ids_);
           break;
         }
         case 32: {
           ArithmeticConstantSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+                                                        *position_ids_);
           break;
         }
         case 64: {
           ArithmeticConstantSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0],
-                                                        position_ids_);
+                                                        *position_ids_);
           break;
         }
         default:
@@ -288,19 +305,19 @@ void SubsetGate::EvaluateOnline() {
     case encrypto::motion::MpcProtocol::kArithmeticGmw: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          ArithmeticGmwSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint8_t>(parent_[0], output_wires_[0], *position_ids_);
           break;
         }
         case 16: {
-          ArithmeticGmwSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint16_t>(parent_[0], output_wires_[0], *position_ids_);
           break;
         }
         case 32: {
-          ArithmeticGmwSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint32_t>(parent_[0], output_wires_[0], *position_ids_);
           break;
         }
         case 64: {
-          ArithmeticGmwSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0], position_ids_);
+          ArithmeticGmwSubsetOnline<std::uint64_t>(parent_[0], output_wires_[0], *position_ids_);
           break;
         }
         default:
@@ -318,10 +335,10 @@ void SubsetGate::EvaluateOnline() {
         auto out = std::dynamic_pointer_cast<proto::bmr::Wire>(output_wires_[i]);
         assert(out);
         BitVectorSubsetImplementation(in->GetPublicValues(), out->GetMutablePublicValues(),
-                                      position_ids_);
-        out->GetMutablePublicKeys().resize(position_ids_.size() * number_of_parties);
-        for (std::size_t j = 0; j < position_ids_.size(); ++j) {
-          std::copy_n(in->GetPublicKeys().begin() + position_ids_[j] * number_of_parties,
+                                      *position_ids_);
+        out->GetMutablePublicKeys().resize(position_ids_->size() * number_of_parties);
+        for (std::size_t j = 0; j < position_ids_->size(); ++j) {
+          std::copy_n(in->GetPublicKeys().begin() + (*position_ids_)[j] * number_of_parties,
                       number_of_parties,
                       out->GetMutablePublicKeys().begin() + j * number_of_parties);
         }
@@ -335,7 +352,7 @@ void SubsetGate::EvaluateOnline() {
         auto out = std::dynamic_pointer_cast<proto::ConstantBooleanWire>(output_wires_[i]);
         assert(out);
         out->GetMutableValues().Resize(in->GetValues().GetSize());
-        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), position_ids_);
+        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), *position_ids_);
       }
       break;
     }
@@ -346,7 +363,7 @@ void SubsetGate::EvaluateOnline() {
         auto out = std::dynamic_pointer_cast<proto::boolean_gmw::Wire>(output_wires_[i]);
         assert(out);
         out->GetMutableValues().Resize(in->GetValues().GetSize());
-        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), position_ids_);
+        BitVectorSubsetImplementation(in->GetValues(), out->GetMutableValues(), *position_ids_);
       }
       break;
     }
@@ -362,25 +379,29 @@ const SharePointer SubsetGate::GetOutputAsShare() {
     case encrypto::motion::MpcProtocol::kArithmeticConstant: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint8_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint8_t>>(output_wires_);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 16: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint16_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint16_t>>(output_wires_);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 32: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint32_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint32_t>>(output_wires_);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 64: {
-          auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint64_t>>(output_wires_);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::ConstantArithmeticShare<std::uint64_t>>(output_wires_);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
@@ -395,28 +416,32 @@ const SharePointer SubsetGate::GetOutputAsShare() {
     case encrypto::motion::MpcProtocol::kArithmeticGmw: {
       switch (parent_[0]->GetBitLength()) {
         case 8: {
-          auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires_[0]);
+          auto tmp = backend_.GetRegister()->EmplaceShared<
+              proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires_[0]);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 16: {
           auto tmp =
-              std::make_shared<proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires_[0]);
+              backend_.GetRegister()->EmplaceShared<
+                  proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires_[0]);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 32: {
           auto tmp =
-              std::make_shared<proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires_[0]);
+              backend_.GetRegister()->EmplaceShared<
+                  proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires_[0]);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
         }
         case 64: {
           auto tmp =
-              std::make_shared<proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires_[0]);
+              backend_.GetRegister()->EmplaceShared<
+                  proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires_[0]);
           assert(tmp);
           result = std::static_pointer_cast<Share>(tmp);
           break;
@@ -429,19 +454,19 @@ const SharePointer SubsetGate::GetOutputAsShare() {
       break;
     }
     case encrypto::motion::MpcProtocol::kBmr: {
-      auto tmp = std::make_shared<proto::bmr::Share>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::bmr::Share>(output_wires_);
       assert(tmp);
       result = std::static_pointer_cast<Share>(tmp);
       break;
     }
     case encrypto::motion::MpcProtocol::kBooleanConstant: {
-      auto tmp = std::make_shared<proto::ConstantBooleanShare>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::ConstantBooleanShare>(output_wires_);
       assert(tmp);
       result = std::static_pointer_cast<Share>(tmp);
       break;
     }
     case encrypto::motion::MpcProtocol::kBooleanGmw: {
-      auto tmp = std::make_shared<proto::boolean_gmw::Share>(output_wires_);
+      auto tmp = backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires_);
       assert(tmp);
       result = std::static_pointer_cast<Share>(tmp);
       break;
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -52,6 +53,8 @@ class SubsetGate final : public OneGate {
 
   void EvaluateOnline() override;
 
+  bool IsLocal() const final override { return true; }
+
   const SharePointer GetOutputAsShare();
 
   SubsetGate() = delete;
@@ -59,7 +62,8 @@ class SubsetGate final : public OneGate {
   SubsetGate(const Gate&) = delete;
 
  private:
-  const std::vector<std::size_t> position_ids_;
+  // shared with the output wires as their SIMD view, see Wire::SetSimdView
+  const std::shared_ptr<const std::vector<std::size_t>> position_ids_;
 };
 
 }  // namespace encrypto::motion
\ No newline at end of file
@@ -24,6 +24,7 @@
 
 #include "unsimdify_gate.h"
 
+#include "base/backend.h"
 #include "base/configuration.h"
 #include "base/register.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
@@ -189,6 +190,15 @@ UnsimdifyGate::UnsimdifyGate(const SharePointer& parent) : OneGate(parent->GetBa
         throw std::invalid_argument(fmt::format("Unrecognized MpcProtocol in UnsimdifyGate"));
     }
   }
+
+  // wire j of output share i holds SIMD value i of parent wire j, which may itself be a view
+  const SimdView view{ResolveSimdView(parent_)};
+  for (std::size_t i = 0; i < parent_[0]->GetNumberOfSimdValues(); ++i) {
+    const auto positions{std::make_shared<const std::vector<std::size_t>>(1, view.GetPosition(i))};
+    for (std::size_t j = 0; j < parent_.size(); ++j) {
+      output_wires_[i * parent_.size() + j]->SetSimdView(view.sources[j], positions);
+    }
+  }
 }
 
 void UnsimdifyGate::EvaluateSetup() {
@@ -394,28 +404,32 @@ std::vector<SharePointer> UnsimdifyGate::GetOutputAsVectorOfShares() {
       case encrypto::motion::MpcProtocol::kArithmeticConstant: {
         switch (parent_[0]->GetBitLength()) {
           case 8: {
-            auto tmp = std::make_shared<proto::ConstantArithmeticShare<std::uint8_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::ConstantArithmeticShare<std::uint8_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 16: {
             auto tmp =
-                std::make_shared<proto::ConstantArithmeticShare<std::uint16_t>>(output_wires);
+                backend_.GetRegister()->EmplaceShared<
+                    proto::ConstantArithmeticShare<std::uint16_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 32: {
             auto tmp =
-                std::make_shared<proto::ConstantArithmeticShare<std::uint32_t>>(output_wires);
+                backend_.GetRegister()->EmplaceShared<
+                    proto::ConstantArithmeticShare<std::uint32_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 64: {
             auto tmp =
-                std::make_shared<proto::ConstantArithmeticShare<std::uint64_t>>(output_wires);
+                backend_.GetRegister()->EmplaceShared<
+                    proto::ConstantArithmeticShare<std::uint64_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
@@ -430,25 +444,29 @@ std::vector<SharePointer> UnsimdifyGate::GetOutputAsVectorOfShares() {
       case encrypto::motion::MpcProtocol::kArithmeticGmw: {
         switch (parent_[0]->GetBitLength()) {
           case 8: {
-            auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::arithmetic_gmw::Share<std::uint8_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 16: {
-            auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::arithmetic_gmw::Share<std::uint16_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 32: {
-            auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::arithmetic_gmw::Share<std::uint32_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 64: {
-            auto tmp = std::make_shared<proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::arithmetic_gmw::Share<std::uint64_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
@@ -463,25 +481,29 @@ std::vector<SharePointer> UnsimdifyGate::GetOutputAsVectorOfShares() {
       case encrypto::motion::MpcProtocol::kAstra: {
         switch (parent_[0]->GetBitLength()) {
           case 8: {
-            auto tmp = std::make_shared<proto::astra::Share<std::uint8_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::astra::Share<std::uint8_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 16: {
-            auto tmp = std::make_shared<proto::astra::Share<std::uint16_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::astra::Share<std::uint16_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 32: {
-            auto tmp = std::make_shared<proto::astra::Share<std::uint32_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::astra::Share<std::uint32_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
           }
           case 64: {
-            auto tmp = std::make_shared<proto::astra::Share<std::uint64_t>>(output_wires);
+            auto tmp = backend_.GetRegister()->EmplaceShared<
+                proto::astra::Share<std::uint64_t>>(output_wires);
             assert(tmp);
             share = std::static_pointer_cast<Share>(tmp);
             break;
@@ -494,19 +516,19 @@ std::vector<SharePointer> UnsimdifyGate::GetOutputAsVectorOfShares() {
         break;
       }
       case encrypto::motion::MpcProtocol::kBmr: {
-        auto tmp = std::make_shared<proto::bmr::Share>(output_wires);
+        auto tmp = backend_.GetRegister()->EmplaceShared<proto::bmr::Share>(output_wires);
         assert(tmp);
         share = std::static_pointer_cast<Share>(tmp);
         break;
       }
       case encrypto::motion::MpcProtocol::kBooleanConstant: {
-        auto tmp = std::make_shared<proto::ConstantBooleanShare>(output_wires);
+        auto tmp = backend_.GetRegister()->EmplaceShared<proto::ConstantBooleanShare>(output_wires);
         assert(tmp);
         share = std::static_pointer_cast<Share>(tmp);
         break;
       }
       case encrypto::motion::MpcProtocol::kBooleanGmw: {
-        auto tmp = std::make_shared<proto::boolean_gmw::Share>(output_wires);
+        auto tmp = backend_.GetRegister()->EmplaceShared<proto::boolean_gmw::Share>(output_wires);
         assert(tmp);
         share = std::static_pointer_cast<Share>(tmp);
         break;
@@ -37,4 +37,8 @@ static constexpr std::size_t kGarbledRowByteSize{kGarbledRowBitSize / 8};
 static constexpr std::size_t kGarbledTableBitSize{kGarbledRowBitSize * 3};
 static constexpr std::size_t kGarbledTableByteSize{kGarbledTableBitSize / 8};
 
+// a half-gates table consists of the ciphertexts of the generator and the evaluator half gate
+static constexpr std::size_t kHalfGatesGarbledTableBitSize{kKappa * 2};
+static constexpr std::size_t kHalfGatesGarbledTableByteSize{kHalfGatesGarbledTableBitSize / 8};
+
 }  // namespace encrypto::motion::proto::garbled_circuit
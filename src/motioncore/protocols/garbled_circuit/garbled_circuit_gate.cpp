@@ -34,6 +34,44 @@
 
 namespace encrypto::motion::proto::garbled_circuit {
 
+namespace {
+
+// registers the gate reading the keys of wires, see Provider::SetFreeKeysAfterLastUse
+void AddKeyConsumer(Provider& provider, const std::vector<motion::WirePointer>& wires) {
+  if (!provider.GetFreeKeysAfterLastUse()) return;
+  for (auto& wire : wires) {
+    auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(wire)};
+    assert(gc_wire);
+    gc_wire->AddKeyConsumer();
+  }
+}
+
+// called by a gate after it last read the keys of the wire
+void ReleaseKeys(Provider& provider, garbled_circuit::Wire& wire) {
+  if (provider.GetFreeKeysAfterLastUse()) wire.ReleaseKeys();
+}
+
+// Calls function(wire_i) for the wires of an AND gate.  The provider splits the SIMD values of
+// wide wires into ranges processed in parallel; gates with many narrower wires are processed in
+// parallel over the wires instead if they have at least Provider::kParallelSimdThreshold SIMD
+// values in total.  For three-halves, this requires number_of_simd % 8 == 0, s.t. no two wires
+// write their garbled control bits into the same byte.
+template <typename Function>
+void ForEachAndGateWire(std::size_t number_of_wires, std::size_t number_of_simd,
+                        bool control_bits, Function&& function) {
+  const bool parallel{number_of_wires > 1 && number_of_simd < Provider::kParallelSimdThreshold &&
+                      number_of_wires * number_of_simd >= Provider::kParallelSimdThreshold &&
+                      (!control_bits || number_of_simd % 8 == 0)};
+  if (!parallel) {
+    for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) function(wire_i);
+    return;
+  }
+#pragma omp parallel for
+  for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) function(wire_i);
+}
+
+}  // namespace
+
 InputGate::InputGate(std::size_t input_owner_id, std::size_t number_of_wires,
                      std::size_t number_of_simd, Backend& backend)
     : Base(backend),
@@ -70,7 +108,7 @@ ReusableFiberPromise<InputGate::ValueType>& InputGate::GetInputPromise() {
 }
 
 const SharePointer InputGate::GetOutputAsGarbledCircuitShare() {
-  auto result = std::make_shared<garbled_circuit::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<garbled_circuit::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -78,12 +116,21 @@ const SharePointer InputGate::GetOutputAsGarbledCircuitShare() {
 InputGateGarbler::InputGateGarbler(std::size_t input_owner_id, std::size_t number_of_wires,
                                    std::size_t number_of_simd, Backend& backend)
     : Base(input_owner_id, number_of_wires, number_of_simd, backend) {
-  // If this is not the garbler's input, the evaluator obtains the label via OT, so register the
-  // sender OT object.
+  auto& provider{GetGarbledCircuitProvider()};
+  // If this is not the garbler's input, the evaluator obtains the label via a random OT, so
+  // register the sender OT object.
   if (!is_my_input_) {
-    ots_for_evaluators_inputs_ =
-        GetOtProvider(input_owner_id).RegisterSendGOt128(number_of_wires * number_of_simd);
+    random_ots_for_evaluators_inputs_ =
+        GetOtProvider(input_owner_id).RegisterSendROt(number_of_wires * number_of_simd, kKappa);
+    auto position{provider.AssignEvaluatorInputsBatch(number_of_wires * number_of_simd)};
+    evaluator_inputs_batch_index_ = position.batch_index;
+    evaluator_inputs_offset_ = position.offset;
+  }
+  if (provider.GetOfflineGarbling()) {
+    provider.RegisterOfflineGarbledGate([this] { GenerateKeys(); });
   }
+  // the keys are read to send the labels of the inputs
+  AddKeyConsumer(provider, output_wires_);
 }
 
 InputGateGarbler::InputGateGarbler([[maybe_unused]] std::span<const BitVector<>> input,
@@ -101,6 +148,12 @@ InputGateGarbler::InputGateGarbler(std::vector<BitVector<>>&& input, std::size_t
 }
 
 void InputGateGarbler::EvaluateSetup() {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) return provider.WaitGarbledOffline();
+  GenerateKeys();
+}
+
+void InputGateGarbler::GenerateKeys() {
   for (auto& wire : output_wires_) {
     auto gc_wire = std::dynamic_pointer_cast<garbled_circuit::Wire>(wire);
     assert(gc_wire);
@@ -149,6 +202,7 @@ void InputGateGarbler::EvaluateOnline() {
         std::transform(lhs_data, lhs_data + Block128::kBlockSize, rhs_data, output_data,
                        [](const std::uint8_t& lhs, const std::uint8_t& rhs) { return lhs ^ rhs; });
       }
+      ReleaseKeys(provider, *gc_wire);
     }
     // Send garbler's input labels to the evaluator.
     flatbuffers::FlatBufferBuilder builder{communication::BuildMessage(
@@ -158,35 +212,49 @@ void InputGateGarbler::EvaluateOnline() {
         static_cast<std::size_t>(GarbledCircuitRole::kEvaluator), builder.Release());
   } else {  // evaluator's input
     if constexpr (kDebug) {
-      if (!ots_for_evaluators_inputs_) {
+      if (!random_ots_for_evaluators_inputs_) {
         throw std::logic_error("OT object must be instantiated for evaluator's input gates");
       }
     }
-    auto& provider{dynamic_cast<ThreeHalvesGarblerProvider&>(GetGarbledCircuitProvider())};
-    const Block128& offset = provider.GetOffset();
-    // a pair of labels for each wire and simd value
-    Block128Vector labels(2 * number_of_wires_ * number_of_simd_);
+    const std::size_t number_of_ots{number_of_wires_ * number_of_simd_};
+    random_ots_for_evaluators_inputs_->ComputeOutputs();
+    const auto random_messages{random_ots_for_evaluators_inputs_->GetOutputs()};
+    const auto corrections{provider.GetEvaluatorInputCorrections(
+        {evaluator_inputs_batch_index_, evaluator_inputs_offset_}, number_of_ots)};
+    // a pair of labels for each wire and simd value, where label b is masked with the random
+    // message b ^ correction, s.t. the evaluator can unmask the label of its choice with the
+    // random message of its random choice
+    Block128Vector masked_labels(2 * number_of_ots);
     for (std::size_t wire_i = 0; wire_i < number_of_wires_; ++wire_i) {
       auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
       for (std::size_t simd_j = 0; simd_j < number_of_simd_; ++simd_j) {
-        labels[2 * (wire_i * number_of_simd_ + simd_j)] = gc_wire->GetKeys()[simd_j];
-        labels[2 * (wire_i * number_of_simd_ + simd_j) + 1] = gc_wire->GetKeys()[simd_j] ^ offset;
+        const std::size_t ot_i{wire_i * number_of_simd_ + simd_j};
+        const auto y{reinterpret_cast<const std::byte*>(random_messages[ot_i].GetData().data())};
+        const Block128 y0{Block128::MakeFromMemory(y)};
+        const Block128 y1{Block128::MakeFromMemory(y + Block128::kBlockSize)};
+        const bool correction{corrections.Get(ot_i)};
+        masked_labels[2 * ot_i] = gc_wire->GetKeys()[simd_j] ^ (correction ? y1 : y0);
+        masked_labels[2 * ot_i + 1] = gc_wire->GetKeys()[simd_j] ^ offset ^ (correction ? y0 : y1);
       }
+      ReleaseKeys(provider, *gc_wire);
     }
-    ots_for_evaluators_inputs_->WaitSetup();
-    ots_for_evaluators_inputs_->SetInputs(std::move(labels));
-    ots_for_evaluators_inputs_->SendMessages();
+    provider.SendEvaluatorInputMaskedLabels(
+        {evaluator_inputs_batch_index_, evaluator_inputs_offset_}, masked_labels);
   }
 }
 
 InputGateEvaluator::InputGateEvaluator(std::size_t input_owner_id, std::size_t number_of_wires,
                                        std::size_t number_of_simd, Backend& backend)
     : Base(input_owner_id, number_of_wires, number_of_simd, backend) {
-  // If this is not the garbler's input, the evaluator obtains the label via OT, so register the
-  // sender OT object
+  // If this is not the garbler's input, the evaluator obtains the label via a random OT, so
+  // register the receiver OT object
   if (is_my_input_) {
     label_source_ = backend.GetOtProvider(1 - input_owner_id)
-                        .RegisterReceiveGOt128(number_of_wires * number_of_simd);
+                        .RegisterReceiveROt(number_of_wires * number_of_simd, kKappa);
+    auto position{GetGarbledCircuitProvider().AssignEvaluatorInputsBatch(number_of_wires *
+                                                                         number_of_simd)};
+    evaluator_inputs_batch_index_ = position.batch_index;
+    evaluator_inputs_offset_ = position.offset;
   } else {  // garbler's input
     label_source_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
         static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
@@ -212,22 +280,31 @@ void InputGateEvaluator::EvaluateSetup() {}
 
 void InputGateEvaluator::EvaluateOnline() {
   if (is_my_input_) {
-    auto& ot_receiver{std::get<std::unique_ptr<GOt128Receiver>>(label_source_)};
-    ot_receiver->WaitSetup();
+    auto& random_ots{std::get<std::unique_ptr<ROtReceiver>>(label_source_)};
+    auto& provider{dynamic_cast<ThreeHalvesEvaluatorProvider&>(GetGarbledCircuitProvider())};
+    const std::size_t number_of_ots{number_of_wires_ * number_of_simd_};
+    random_ots->ComputeOutputs();
     BitVector<> choices;
-    choices.Reserve(number_of_wires_ * number_of_simd_);
+    choices.Reserve(number_of_ots);
     assert(input_promise_future_.has_value());
     auto inputs{input_promise_future_->second.get()};
     for (auto& bit_vector : inputs) choices.Append(bit_vector);
-    ot_receiver->SetChoices(std::move(choices));
-    ot_receiver->SendCorrections();
-    ot_receiver->ComputeOutputs();
-    const Block128Vector& output_labels{ot_receiver->GetOutputs()};
+    provider.SendEvaluatorInputCorrections(
+        {evaluator_inputs_batch_index_, evaluator_inputs_offset_},
+        choices ^ random_ots->GetChoices());
+    const auto masked_labels{provider.GetEvaluatorInputMaskedLabels(
+        {evaluator_inputs_batch_index_, evaluator_inputs_offset_}, number_of_ots)};
+    const auto random_messages{random_ots->GetOutputs()};
     for (std::size_t wire_i = 0; wire_i < number_of_wires_; ++wire_i) {
-      Block128Vector labels(output_labels.begin() + wire_i * number_of_simd_,
-                            output_labels.begin() + (wire_i + 1) * number_of_simd_);
       auto gc_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
-      gc_wire->GetMutableKeys() = std::move(labels);
+      auto& keys{gc_wire->GetMutableKeys()};
+      keys.resize(number_of_simd_);
+      for (std::size_t simd_j = 0; simd_j < number_of_simd_; ++simd_j) {
+        const std::size_t ot_i{wire_i * number_of_simd_ + simd_j};
+        keys[simd_j] = masked_labels[2 * ot_i + choices.Get(ot_i)] ^
+                       Block128::MakeFromMemory(reinterpret_cast<const std::byte*>(
+                           random_messages[ot_i].GetData().data()));
+      }
     }
   } else {  // garbler's input
     auto& label_future{std::get<ReusableFiberFuture<std::vector<std::uint8_t>>>(label_source_)};
@@ -257,6 +334,7 @@ OutputGate::OutputGate(motion::SharePointer parent, std::size_t output_owner)
     wire = GetRegister().EmplaceWire<ConstantBooleanWire>(backend_,
                                                           parent_[0]->GetNumberOfSimdValues());
   }
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_);
   if (my_output_) {
     std::size_t other_party_id{1 - GetCommunicationLayer().GetMyId()};
     output_future_ = std::optional{GetCommunicationLayer().GetMessageManager().RegisterReceive(
@@ -266,7 +344,7 @@ OutputGate::OutputGate(motion::SharePointer parent, std::size_t output_owner)
 }
 
 const std::shared_ptr<ConstantBooleanShare> OutputGate::GetOutputAsConstantShare() {
-  auto result = std::make_shared<ConstantBooleanShare>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<ConstantBooleanShare>(output_wires_);
   assert(result);
   return result;
 }
@@ -285,6 +363,8 @@ void OutputGate::EvaluateOnline() {
       auto gc_parent_wire{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_[wire_i])};
       assert(gc_parent_wire);
       permutation_bits.Append(gc_parent_wire->CopyPermutationBits());
+      // the evaluator needs its own permutation bits below
+      if (!my_output_) ReleaseKeys(GetGarbledCircuitProvider(), *gc_parent_wire);
     }
     auto fbb{communication::BuildMessage(
         communication::MessageType::kGarbledCircuitOutput, gate_id_,
@@ -310,6 +390,7 @@ void OutputGate::EvaluateOnline() {
       output_wire->GetMutableValues() = gc_parent_wire->CopyPermutationBits();
       output_wire->GetMutableValues() ^=
           permutation_bits_span.Subset(wire_i * number_of_simd, (wire_i + 1) * number_of_simd);
+      ReleaseKeys(GetGarbledCircuitProvider(), *gc_parent_wire);
     }
   }
 }
@@ -324,10 +405,23 @@ XorGate::XorGate(motion::SharePointer parent_a, motion::SharePointer parent_b)
     wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
                                                             parent_a_[0]->GetNumberOfSimdValues());
   }
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_a_);
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_b_);
+}
+
+void XorGate::XorKeys(Provider& provider, garbled_circuit::Wire& wire_a,
+                      garbled_circuit::Wire& wire_b, garbled_circuit::Wire& wire_out) {
+  const Block128Vector& keys_a{wire_a.GetKeys()};
+  const Block128Vector& keys_b{wire_b.GetKeys()};
+  Block128Vector keys_out{provider.AcquireKeys(keys_a.size())};
+  XorBlocks(keys_out.data(), keys_a.data(), keys_b.data(), keys_out.size());
+  wire_out.GetMutableKeys() = std::move(keys_out);
+  ReleaseKeys(provider, wire_a);
+  ReleaseKeys(provider, wire_b);
 }
 
 SharePointer XorGate::GetOutputAsGarbledCircuitShare() const {
-  auto result = std::make_shared<garbled_circuit::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<garbled_circuit::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -337,9 +431,21 @@ encrypto::motion::SharePointer XorGate::GetOutputAsShare() const {
 }
 
 XorGateGarbler::XorGateGarbler(motion::SharePointer parent_a, motion::SharePointer parent_b)
-    : XorGate(parent_a, parent_b) {}
+    : XorGate(parent_a, parent_b) {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) {
+    provider.RegisterOfflineGarbledGate([this] { ComputeKeys(); });
+  }
+}
 
 void XorGateGarbler::EvaluateSetup() {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) return provider.WaitGarbledOffline();
+  ComputeKeys();
+}
+
+void XorGateGarbler::ComputeKeys() {
+  auto& provider{GetGarbledCircuitProvider()};
   for (std::size_t wire_i = 0; wire_i < parent_a_.size(); ++wire_i) {
     auto gc_wire_a{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_a_[wire_i])};
     auto gc_wire_b{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_b_[wire_i])};
@@ -349,7 +455,7 @@ void XorGateGarbler::EvaluateSetup() {
     assert(gc_wire_out);
     gc_wire_a->WaitSetup();
     gc_wire_b->WaitSetup();
-    gc_wire_out->GetMutableKeys() = gc_wire_a->GetKeys() ^ gc_wire_b->GetKeys();
+    XorKeys(provider, *gc_wire_a, *gc_wire_b, *gc_wire_out);
     gc_wire_out->SetSetupIsReady();
   }
 }
@@ -363,6 +469,7 @@ void XorGateEvaluator::EvaluateSetup() {}
 
 void XorGateEvaluator::EvaluateOnline() {
   WaitSetup();
+  auto& provider{GetGarbledCircuitProvider()};
   for (std::size_t wire_i = 0; wire_i < parent_a_.size(); ++wire_i) {
     auto gc_wire_a{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_a_[wire_i])};
     auto gc_wire_b{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_b_[wire_i])};
@@ -372,7 +479,7 @@ void XorGateEvaluator::EvaluateOnline() {
     assert(gc_wire_out);
     gc_wire_a->GetIsReadyCondition().Wait();
     gc_wire_b->GetIsReadyCondition().Wait();
-    gc_wire_out->GetMutableKeys() = gc_wire_a->GetKeys() ^ gc_wire_b->GetKeys();
+    XorKeys(provider, *gc_wire_a, *gc_wire_b, *gc_wire_out);
   }
 }
 
@@ -383,10 +490,11 @@ InvGate::InvGate(motion::SharePointer parent) : Base(parent->GetBackend()) {
     wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
                                                             parent_[0]->GetNumberOfSimdValues());
   }
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_);
 }
 
 SharePointer InvGate::GetOutputAsGarbledCircuitShare() const {
-  auto result = std::make_shared<garbled_circuit::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<garbled_circuit::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -395,9 +503,20 @@ encrypto::motion::SharePointer InvGate::GetOutputAsShare() const {
   return GetOutputAsGarbledCircuitShare();
 }
 
-InvGateGarbler::InvGateGarbler(motion::SharePointer parent) : InvGate(parent) {}
+InvGateGarbler::InvGateGarbler(motion::SharePointer parent) : InvGate(parent) {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) {
+    provider.RegisterOfflineGarbledGate([this] { ComputeKeys(); });
+  }
+}
 
 void InvGateGarbler::EvaluateSetup() {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) return provider.WaitGarbledOffline();
+  ComputeKeys();
+}
+
+void InvGateGarbler::ComputeKeys() {
   // xor offset to each key
   auto& garbled_circuit_provider{
       dynamic_cast<ThreeHalvesGarblerProvider&>(GetGarbledCircuitProvider())};
@@ -409,8 +528,11 @@ void InvGateGarbler::EvaluateSetup() {
     assert(gc_wire_in);
     assert(gc_wire_out);
     gc_wire_in->WaitSetup();
-    gc_wire_out->GetMutableKeys() = gc_wire_in->GetKeys();
-    for (auto& key : gc_wire_out->GetMutableKeys()) key ^= offset;
+    const Block128Vector& keys_in{gc_wire_in->GetKeys()};
+    Block128Vector keys_out{garbled_circuit_provider.AcquireKeys(keys_in.size())};
+    XorBlocks(keys_out.data(), keys_in.data(), offset, keys_out.size());
+    gc_wire_out->GetMutableKeys() = std::move(keys_out);
+    ReleaseKeys(garbled_circuit_provider, *gc_wire_in);
     gc_wire_out->SetSetupIsReady();
   }
 }
@@ -423,6 +545,7 @@ void InvGateEvaluator::EvaluateSetup() {}
 
 void InvGateEvaluator::EvaluateOnline() {
   WaitSetup();
+  auto& provider{GetGarbledCircuitProvider()};
   // only copy keys
   for (std::size_t wire_i = 0; wire_i < parent_.size(); ++wire_i) {
     auto gc_wire_in{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_[wire_i])};
@@ -430,12 +553,17 @@ void InvGateEvaluator::EvaluateOnline() {
     assert(gc_wire_in);
     assert(gc_wire_out);
     gc_wire_in->GetIsReadyCondition().Wait();
-    gc_wire_out->GetMutableKeys() = gc_wire_in->GetKeys();
+    const Block128Vector& keys_in{gc_wire_in->GetKeys()};
+    Block128Vector keys_out{provider.AcquireKeys(keys_in.size())};
+    std::copy(keys_in.begin(), keys_in.end(), keys_out.begin());
+    gc_wire_out->GetMutableKeys() = std::move(keys_out);
+    ReleaseKeys(provider, *gc_wire_in);
   }
 }
 
 AndGate::AndGate(motion::SharePointer parent_a, motion::SharePointer parent_b)
-    : Base(parent_a->GetBackend()) {
+    : Base(parent_a->GetBackend()),
+      scheme_(parent_a->GetBackend().GetGarbledCircuitProvider().GetScheme()) {
   assert(parent_a->GetNumberOfSimdValues() == parent_b->GetNumberOfSimdValues());
   parent_a_ = parent_a->GetWires();
   parent_b_ = parent_b->GetWires();
@@ -446,10 +574,12 @@ AndGate::AndGate(motion::SharePointer parent_a, motion::SharePointer parent_b)
     wire = GetRegister().EmplaceWire<garbled_circuit::Wire>(backend_,
                                                             parent_a_[0]->GetNumberOfSimdValues());
   }
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_a_);
+  AddKeyConsumer(GetGarbledCircuitProvider(), parent_b_);
 }
 
 SharePointer AndGate::GetOutputAsGarbledCircuitShare() const {
-  auto result = std::make_shared<garbled_circuit::Share>(output_wires_);
+  auto result = backend_.GetRegister()->EmplaceShared<garbled_circuit::Share>(output_wires_);
   assert(result);
   return result;
 }
@@ -458,27 +588,59 @@ encrypto::motion::SharePointer AndGate::GetOutputAsShare() const {
   return GetOutputAsGarbledCircuitShare();
 }
 
+std::size_t AndGate::GetGarbledTablesPayloadSize() const {
+  std::size_t total_number_of_wires{parent_a_.size() * parent_a_[0]->GetNumberOfSimdValues()};
+  return BitsToBytes(total_number_of_wires * (Provider::GetGarbledTableBitSize(scheme_) +
+                                              Provider::GetGarbledControlBitsBitSize(scheme_)));
+}
+
+std::size_t AndGate::GetGarbledTablesByteSize() const {
+  std::size_t total_number_of_wires{parent_a_.size() * parent_a_[0]->GetNumberOfSimdValues()};
+  return total_number_of_wires * Provider::GetGarbledTableBitSize(scheme_) / 8;
+}
+
 AndGateGarbler::AndGateGarbler(motion::SharePointer parent_a, motion::SharePointer parent_b)
-    : Base(parent_a, parent_b) {}
+    : Base(parent_a, parent_b) {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetGarbledTablesChunkSize() > 0) {
+    auto position{provider.AssignGarbledTablesChunk(GetGarbledTablesPayloadSize())};
+    garbled_tables_chunk_index_ = position.chunk_index;
+    garbled_tables_chunk_offset_ = position.offset;
+  }
+  if (provider.GetOfflineGarbling()) provider.RegisterOfflineGarbledGate([this] { Garble(); });
+}
 
 void AndGateGarbler::EvaluateSetup() {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) return provider.WaitGarbledOffline();
+  Garble();
+}
+
+void AndGateGarbler::Garble() {
   auto& provider{dynamic_cast<ThreeHalvesGarblerProvider&>(GetGarbledCircuitProvider())};
   provider.WaitSetup();
   std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
-  std::size_t total_number_of_wires{parent_a_.size() * number_of_simd};
-  std::size_t tables_byte_size{total_number_of_wires * kGarbledTableByteSize};
+  std::size_t tables_byte_size{GetGarbledTablesByteSize()};
+  std::size_t payload_size{GetGarbledTablesPayloadSize()};
   // avoid using std::vector to not initialize the memory
-  std::size_t payload_size{
-      BitsToBytes(total_number_of_wires * (kGarbledTableBitSize + kGarbledControlBitsBitSize))};
-  auto garbled_tables_and_control_bits{std::make_unique<std::byte[]>(payload_size)};
-  std::byte* control_bits{(garbled_tables_and_control_bits.get()) + tables_byte_size};
+  std::unique_ptr<std::byte[]> own_buffer;
+  std::byte* garbled_tables;
+  if (garbled_tables_chunk_index_) {
+    garbled_tables = provider.GetGarbledTablesChunkBuffer(*garbled_tables_chunk_index_) +
+                     garbled_tables_chunk_offset_;
+  } else {
+    own_buffer = std::make_unique<std::byte[]>(payload_size);
+    garbled_tables = own_buffer.get();
+  }
+  std::byte* control_bits{garbled_tables + tables_byte_size};
 
   // Remark: it's not necessary to wait for the provider's setup phase, since all the required
   // information (hash and aes key) is generated in the constructor.
+  std::vector<garbled_circuit::Wire*> gc_wires_a, gc_wires_b, gc_wires_out;
   for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
-    auto gc_wire_a{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_a_[wire_i])};
-    auto gc_wire_b{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_b_[wire_i])};
-    auto gc_wire_out{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
+    auto gc_wire_a{dynamic_cast<garbled_circuit::Wire*>(parent_a_[wire_i].get())};
+    auto gc_wire_b{dynamic_cast<garbled_circuit::Wire*>(parent_b_[wire_i].get())};
+    auto gc_wire_out{dynamic_cast<garbled_circuit::Wire*>(output_wires_[wire_i].get())};
     assert(gc_wire_a);
     assert(gc_wire_b);
     gc_wire_a->WaitSetup();
@@ -490,34 +652,73 @@ void AndGateGarbler::EvaluateSetup() {
                                       gc_wire_out->GetWireId())};
       GetLogger().LogDebug(std::move(message));
     }
-    gc_wire_out->GetMutableKeys().resize(number_of_simd);
-    provider.Garble(gc_wire_a->GetKeys(), gc_wire_b->GetKeys(), gc_wire_out->GetMutableKeys(),
-                    garbled_tables_and_control_bits.get(), control_bits, wire_i * number_of_simd,
-                    gate_id_ + wire_i);
-    gc_wire_out->SetSetupIsReady();
+    gc_wire_out->GetMutableKeys() = provider.AcquireKeys(number_of_simd);
+    gc_wires_a.push_back(gc_wire_a);
+    gc_wires_b.push_back(gc_wire_b);
+    gc_wires_out.push_back(gc_wire_out);
+  }
+  const bool half_gates{scheme_ == GarbledCircuitScheme::kHalfGates};
+  ForEachAndGateWire(output_wires_.size(), number_of_simd, !half_gates, [&](std::size_t wire_i) {
+    if (half_gates) {
+      provider.GarbleHalfGates(gc_wires_a[wire_i]->GetKeys(), gc_wires_b[wire_i]->GetKeys(),
+                               gc_wires_out[wire_i]->GetMutableKeys(), garbled_tables,
+                               wire_i * number_of_simd, gate_id_ + wire_i);
+    } else {
+      provider.Garble(gc_wires_a[wire_i]->GetKeys(), gc_wires_b[wire_i]->GetKeys(),
+                      gc_wires_out[wire_i]->GetMutableKeys(), garbled_tables, control_bits,
+                      wire_i * number_of_simd, gate_id_ + wire_i);
+    }
+  });
+  for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
+    ReleaseKeys(provider, *gc_wires_a[wire_i]);
+    ReleaseKeys(provider, *gc_wires_b[wire_i]);
+    gc_wires_out[wire_i]->SetSetupIsReady();
   }
 
-  auto builder{communication::BuildMessage(
-      communication::MessageType::kGarbledCircuitGarbledTables, gate_id_,
-      std::span(reinterpret_cast<const std::uint8_t*>(garbled_tables_and_control_bits.get()),
-                payload_size))};
+  if (garbled_tables_chunk_index_) {
+    provider.FinishGarbledTables(*garbled_tables_chunk_index_);
+    return;
+  }
+  // the tables are written to the network directly from this buffer
+  std::span payload(reinterpret_cast<const std::uint8_t*>(garbled_tables), payload_size);
   backend_.GetCommunicationLayer().SendMessage(
-      static_cast<std::size_t>(GarbledCircuitRole::kEvaluator), builder.Release());
+      static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+      communication::MessageType::kGarbledCircuitGarbledTables, gate_id_, payload,
+      std::shared_ptr<const std::byte[]>(std::move(own_buffer)));
 }
 
 void AndGateGarbler::EvaluateOnline() {}
 
 AndGateEvaluator::AndGateEvaluator(motion::SharePointer parent_a, motion::SharePointer parent_b)
     : Base(parent_a, parent_b) {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) {
+    provider.RegisterOfflineGarbledGate([this] { ReceiveGarbledTables(); });
+  }
+  if (provider.GetGarbledTablesChunkSize() > 0) {
+    auto position{provider.AssignGarbledTablesChunk(GetGarbledTablesPayloadSize())};
+    garbled_tables_chunk_index_ = position.chunk_index;
+    garbled_tables_chunk_offset_ = position.offset;
+    return;
+  }
   garbled_tables_msg_future_ = GetCommunicationLayer().GetMessageManager().RegisterReceive(
       static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
       communication::MessageType::kGarbledCircuitGarbledTables, gate_id_);
 }
 
 void AndGateEvaluator::EvaluateSetup() {
+  auto& provider{GetGarbledCircuitProvider()};
+  if (provider.GetOfflineGarbling()) return provider.WaitGarbledOffline();
+  ReceiveGarbledTables();
+}
+
+void AndGateEvaluator::ReceiveGarbledTables() {
   auto& provider{dynamic_cast<ThreeHalvesEvaluatorProvider&>(GetGarbledCircuitProvider())};
   provider.WaitSetup();
-  garbled_tables_msg_future_.wait(); }
+  // streamed chunks are only waited for in the online phase, so that gates can be evaluated as
+  // soon as their chunk arrived
+  if (!garbled_tables_chunk_index_) garbled_tables_msg_future_.wait();
+}
 
 void AndGateEvaluator::EvaluateOnline() {
   auto& provider{dynamic_cast<ThreeHalvesEvaluatorProvider&>(GetGarbledCircuitProvider())};
@@ -525,12 +726,21 @@ void AndGateEvaluator::EvaluateOnline() {
   for (auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
   std::size_t number_of_simd{parent_a_[0]->GetNumberOfSimdValues()};
 
-  auto garbled_tables_msg{garbled_tables_msg_future_.get()};
-  auto garbled_tables{communication::GetMessage(garbled_tables_msg.data())->payload()};
+  std::vector<std::uint8_t> garbled_tables_msg;
+  const std::byte* garbled_tables;
+  if (garbled_tables_chunk_index_) {
+    garbled_tables = provider.GetGarbledTablesChunk(*garbled_tables_chunk_index_) +
+                     garbled_tables_chunk_offset_;
+  } else {
+    garbled_tables_msg = garbled_tables_msg_future_.get();
+    garbled_tables = reinterpret_cast<const std::byte*>(
+        communication::GetMessage(garbled_tables_msg.data())->payload()->data());
+  }
+  std::vector<garbled_circuit::Wire*> gc_wires_a, gc_wires_b, gc_wires_out;
   for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
-    auto gc_wire_a{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_a_[wire_i])};
-    auto gc_wire_b{std::dynamic_pointer_cast<garbled_circuit::Wire>(parent_b_[wire_i])};
-    auto gc_wire_out{std::dynamic_pointer_cast<garbled_circuit::Wire>(output_wires_[wire_i])};
+    auto gc_wire_a{dynamic_cast<garbled_circuit::Wire*>(parent_a_[wire_i].get())};
+    auto gc_wire_b{dynamic_cast<garbled_circuit::Wire*>(parent_b_[wire_i].get())};
+    auto gc_wire_out{dynamic_cast<garbled_circuit::Wire*>(output_wires_[wire_i].get())};
     assert(gc_wire_a);
     assert(gc_wire_b);
     assert(gc_wire_out);
@@ -540,13 +750,29 @@ void AndGateEvaluator::EvaluateOnline() {
                                       gc_wire_out->GetWireId())};
       GetLogger().LogDebug(std::move(message));
     }
-    gc_wire_out->GetMutableKeys().resize(number_of_simd);
-    std::size_t tables_size{output_wires_.size() * number_of_simd * kGarbledTableByteSize};
-    provider.Evaluate(gc_wire_a->GetKeys(), gc_wire_b->GetKeys(), gc_wire_out->GetMutableKeys(),
-                      reinterpret_cast<const std::byte*>(garbled_tables->data()),
-                      reinterpret_cast<const std::byte*>(garbled_tables->data() + tables_size),
-                      wire_i * number_of_simd, gate_id_ + wire_i);
+    gc_wire_out->GetMutableKeys() = provider.AcquireKeys(number_of_simd);
+    gc_wires_a.push_back(gc_wire_a);
+    gc_wires_b.push_back(gc_wire_b);
+    gc_wires_out.push_back(gc_wire_out);
+  }
+  const bool half_gates{scheme_ == GarbledCircuitScheme::kHalfGates};
+  ForEachAndGateWire(output_wires_.size(), number_of_simd, !half_gates, [&](std::size_t wire_i) {
+    if (half_gates) {
+      provider.EvaluateHalfGates(gc_wires_a[wire_i]->GetKeys(), gc_wires_b[wire_i]->GetKeys(),
+                                 gc_wires_out[wire_i]->GetMutableKeys(), garbled_tables,
+                                 wire_i * number_of_simd, gate_id_ + wire_i);
+    } else {
+      provider.Evaluate(gc_wires_a[wire_i]->GetKeys(), gc_wires_b[wire_i]->GetKeys(),
+                        gc_wires_out[wire_i]->GetMutableKeys(), garbled_tables,
+                        garbled_tables + GetGarbledTablesByteSize(), wire_i * number_of_simd,
+                        gate_id_ + wire_i);
+    }
+  });
+  for (std::size_t wire_i = 0; wire_i < output_wires_.size(); ++wire_i) {
+    ReleaseKeys(provider, *gc_wires_a[wire_i]);
+    ReleaseKeys(provider, *gc_wires_b[wire_i]);
   }
+  if (garbled_tables_chunk_index_) provider.ReleaseGarbledTablesChunk(*garbled_tables_chunk_index_);
 }
 
 }  // namespace encrypto::motion::proto::garbled_circuit
\ No newline at end of file
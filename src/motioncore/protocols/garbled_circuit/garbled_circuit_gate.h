@@ -25,6 +25,7 @@
 #pragma once
 
 #include <limits>
+#include <optional>
 #include <span>
 #include <variant>
 
@@ -40,8 +41,8 @@
 
 namespace encrypto::motion {
 
-class GOt128Receiver;
-class GOt128Sender;
+class ROtReceiver;
+class ROtSender;
 
 namespace proto {
 
@@ -116,10 +117,19 @@ class InputGateGarbler final : public garbled_circuit::InputGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+  // a 128 bit label per input bit
+  OnlineCost GetOnlineCost() const override { return {1, 16 * GetNumberOfOutputBits()}; }
 
  private:
-  /// Promise is only required if the gate for own input is created.
-  std::unique_ptr<GOt128Sender> ots_for_evaluators_inputs_{nullptr};
+  /// \brief Samples the keys of the output wires, called by EvaluateSetup or, with offline
+  /// garbling, during the preprocessing.
+  void GenerateKeys();
+
+  /// If this is the evaluator's input, the labels are obtained via random OTs, which are
+  /// derandomized in a batch of all input gates of the evaluator.
+  std::unique_ptr<ROtSender> random_ots_for_evaluators_inputs_{nullptr};
+  std::size_t evaluator_inputs_batch_index_{0};
+  std::size_t evaluator_inputs_offset_{0};
 };
 
 class InputGateEvaluator final : public garbled_circuit::InputGate {
@@ -154,13 +164,18 @@ class InputGateEvaluator final : public garbled_circuit::InputGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+  // the OT corrections
+  OnlineCost GetOnlineCost() const override { return {1, GetNumberOfOutputBytes()}; }
 
  private:
-  /// If this is the evaluator's input, the input label is obtained via OT. If this is the garbler's
-  /// input, the corresponding label is simply transmitted to the evaluator by the garbler and
-  /// retrieved by the evaluator from the future object.
-  std::variant<ReusableFiberFuture<std::vector<std::uint8_t>>, std::unique_ptr<GOt128Receiver>>
+  /// If this is the evaluator's input, the input label is obtained via a random OT, which is
+  /// derandomized in a batch of all input gates of the evaluator. If this is the garbler's input,
+  /// the corresponding label is simply transmitted to the evaluator by the garbler and retrieved
+  /// by the evaluator from the future object.
+  std::variant<ReusableFiberFuture<std::vector<std::uint8_t>>, std::unique_ptr<ROtReceiver>>
       label_source_;
+  std::size_t evaluator_inputs_batch_index_{0};
+  std::size_t evaluator_inputs_offset_{0};
 };
 
 class OutputGate : public motion::OutputGate {
@@ -184,6 +199,7 @@ class OutputGate : public motion::OutputGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+  OnlineCost GetOnlineCost() const override { return {1, GetNumberOfOutputBytes()}; }
 
  protected:
   /// The id of the output owner.
@@ -212,6 +228,11 @@ class XorGate : public motion::TwoGate {
   encrypto::motion::SharePointer GetOutputAsShare() const;
 
   ~XorGate() override = default;
+
+ protected:
+  /// \brief Sets the keys of \p wire_out to the XOR of the keys of \p wire_a and \p wire_b.
+  static void XorKeys(Provider& provider, garbled_circuit::Wire& wire_a,
+                      garbled_circuit::Wire& wire_b, garbled_circuit::Wire& wire_out);
 };
 
 class XorGateGarbler final : public XorGate {
@@ -229,6 +250,13 @@ class XorGateGarbler final : public XorGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+  bool IsLocal() const final override { return true; }
+
+ private:
+  /// \brief Computes the keys of the output wires, called by EvaluateSetup or, with offline
+  /// garbling, during the preprocessing.
+  void ComputeKeys();
 };
 
 class XorGateEvaluator final : public XorGate {
@@ -246,6 +274,8 @@ class XorGateEvaluator final : public XorGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+  bool IsLocal() const final override { return true; }
 };
 
 class InvGate : public motion::OneGate {
@@ -280,6 +310,11 @@ class InvGateGarbler final : public InvGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+ private:
+  /// \brief Computes the keys of the output wires, called by EvaluateSetup or, with offline
+  /// garbling, during the preprocessing.
+  void ComputeKeys();
 };
 
 class InvGateEvaluator final : public InvGate {
@@ -297,6 +332,8 @@ class InvGateEvaluator final : public InvGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+  bool IsLocal() const final override { return true; }
 };
 
 class AndGate : public motion::TwoGate {
@@ -315,6 +352,20 @@ class AndGate : public motion::TwoGate {
 
  protected:
   AndGate(motion::SharePointer parent_a, motion::SharePointer parent_b);
+
+  /// \brief Byte size of the garbled tables and control bits of this gate.
+  std::size_t GetGarbledTablesPayloadSize() const;
+
+  /// \brief Byte size of the garbled tables of this gate without the control bits.
+  std::size_t GetGarbledTablesByteSize() const;
+
+  // garbling scheme, see Provider::GetScheme
+  const GarbledCircuitScheme scheme_;
+
+  // position of the garbled tables in the provider's chunks if garbled tables are streamed, see
+  // Provider::SetGarbledTablesChunkSize
+  std::optional<std::size_t> garbled_tables_chunk_index_;
+  std::size_t garbled_tables_chunk_offset_{0};
 };
 
 //  /// Index that is used as a tweak in the (T)MMO construction. The wire id cannot be used for
@@ -336,6 +387,11 @@ class AndGateGarbler final : public AndGate {
 
   /// \brief Evaluates the online phase.
   void EvaluateOnline() override;
+
+ private:
+  /// \brief Garbles the gate and sends the garbled tables, called by EvaluateSetup or, with
+  /// offline garbling, during the preprocessing.
+  void Garble();
 };
 
 class AndGateEvaluator final : public AndGate {
@@ -353,6 +409,10 @@ class AndGateEvaluator final : public AndGate {
   void EvaluateOnline() override;
 
  private:
+  /// \brief Waits for the garbled tables unless they are streamed, called by EvaluateSetup or,
+  /// with offline garbling, during the preprocessing.
+  void ReceiveGarbledTables();
+
   ReusableFiberFuture<std::vector<std::uint8_t>> garbled_tables_msg_future_;
 };
 
@@ -24,17 +24,69 @@
 
 #include "garbled_circuit_provider.h"
 
+#include <algorithm>
+#include <mutex>
+
+#include "base/configuration.h"
 #include "communication/communication_layer.h"
 #include "communication/fbs_headers/garbled_circuit_message_generated.h"
 #include "communication/garbled_circuit_message.h"
+#include "communication/message.h"
 #include "garbled_circuit_constants.h"
 #include "garbled_circuit_utility.h"
 #include "garbled_circuit_wire.h"
 
 namespace encrypto::motion::proto::garbled_circuit {
 
-Provider::Provider(communication::CommunicationLayer& communication_layer)
-    : communication_layer_(communication_layer) {
+namespace {
+
+// cost model of SelectGarbledCircuitScheme: the slower of garbler and evaluator per AND gate,
+// measured with AES-NI including the linear algebra of three-halves
+constexpr double kThreeHalvesTimePerAndGate{40e-9};
+constexpr double kHalfGatesTimePerAndGate{20e-9};
+constexpr double kThreeHalvesBitsPerAndGate{kGarbledTableBitSize + kGarbledControlBitsBitSize};
+constexpr double kHalfGatesBitsPerAndGate{kHalfGatesGarbledTableBitSize};
+
+// Calls function(simd_begin, simd_end) for consecutive ranges covering [0, number_of_simd).  Wide
+// gates are split into ranges of Provider::kParallelSimdRangeSize SIMD values, which are processed
+// in parallel.  The ranges start at multiples of 8 AND gates w.r.t. the beginning of the garbled
+// tables, s.t. no two ranges write the garbled control bits of three-halves into the same byte.
+template <typename Function>
+void ForEachSimdRange(std::size_t number_of_simd, std::size_t table_offset, Function&& function) {
+  if (number_of_simd < Provider::kParallelSimdThreshold) {
+    function(0, number_of_simd);
+    return;
+  }
+  constexpr std::size_t kRangeSize{Provider::kParallelSimdRangeSize};
+  static_assert(kRangeSize % 8 == 0);
+  const std::size_t head{(8 - table_offset % 8) % 8};
+  const std::size_t number_of_ranges{(number_of_simd - head + kRangeSize - 1) / kRangeSize};
+#pragma omp parallel for
+  for (std::size_t range_i = 0; range_i < number_of_ranges; ++range_i) {
+    const std::size_t simd_begin{range_i == 0 ? 0 : head + range_i * kRangeSize};
+    const std::size_t simd_end{std::min(number_of_simd, head + (range_i + 1) * kRangeSize)};
+    function(simd_begin, simd_end);
+  }
+}
+
+}  // namespace
+
+GarbledCircuitScheme SelectGarbledCircuitScheme(double bandwidth) {
+  if (bandwidth <= 0) return GarbledCircuitScheme::kHalfGates;
+  const double three_halves_time{
+      std::max(kThreeHalvesTimePerAndGate, kThreeHalvesBitsPerAndGate / bandwidth)};
+  const double half_gates_time{
+      std::max(kHalfGatesTimePerAndGate, kHalfGatesBitsPerAndGate / bandwidth)};
+  return half_gates_time < three_halves_time ? GarbledCircuitScheme::kHalfGates
+                                             : GarbledCircuitScheme::kThreeHalves;
+}
+
+Provider::Provider(communication::CommunicationLayer& communication_layer,
+                   ConfigurationPointer configuration)
+    : communication_layer_(communication_layer),
+      configuration_(std::move(configuration)),
+      garbled_offline_condition_(
+          std::make_unique<FiberCondition>([this] { return garbled_offline_.load(); })) {
   if (communication_layer_.GetNumberOfParties() != 2) {
     throw std::invalid_argument(
         fmt::format("Garbled circuits can only be run with exactly two parties but #parties={}",
@@ -42,6 +94,116 @@ Provider::Provider(communication::CommunicationLayer& communication_layer)
   }
 }
 
+GarbledCircuitScheme Provider::GetScheme() const {
+  if (!configuration_) return GarbledCircuitScheme::kThreeHalves;
+  const GarbledCircuitScheme scheme{configuration_->GetGarbledCircuitScheme()};
+  if (scheme == GarbledCircuitScheme::kAuto) {
+    return SelectGarbledCircuitScheme(configuration_->GetNetworkBandwidth());
+  }
+  return scheme;
+}
+
+Provider::GarbledTablesPosition Provider::AssignGarbledTablesChunk(std::size_t size) {
+  assert(garbled_tables_chunk_size_ > 0);
+  // a chunk that was already (partially) processed belongs to a previous evaluation of the circuit
+  if (garbled_tables_chunks_.empty() ||
+      garbled_tables_chunks_.back()->size >= garbled_tables_chunk_size_ ||
+      garbled_tables_chunks_.back()->number_of_finished_gates > 0) {
+    garbled_tables_chunks_.emplace_back(std::make_unique<GarbledTablesChunk>());
+    OnNewGarbledTablesChunk(garbled_tables_chunks_.size() - 1);
+  }
+  auto& chunk{*garbled_tables_chunks_.back()};
+  GarbledTablesPosition position{garbled_tables_chunks_.size() - 1, chunk.size};
+  chunk.size += size;
+  ++chunk.number_of_gates;
+  return position;
+}
+
+Provider::EvaluatorInputsPosition Provider::AssignEvaluatorInputsBatch(std::size_t number_of_ots) {
+  // a batch that was already (partially) sent belongs to a previous evaluation of the circuit
+  if (evaluator_inputs_batches_.empty() ||
+      evaluator_inputs_batches_.back()->number_of_sent_gates > 0) {
+    evaluator_inputs_batches_.emplace_back(std::make_unique<EvaluatorInputsBatch>());
+    OnNewEvaluatorInputsBatch(evaluator_inputs_batches_.size() - 1);
+  }
+  auto& batch{*evaluator_inputs_batches_.back()};
+  EvaluatorInputsPosition position{evaluator_inputs_batches_.size() - 1, batch.number_of_ots};
+  batch.number_of_ots += number_of_ots;
+  ++batch.number_of_gates;
+  return position;
+}
+
+const std::uint8_t* Provider::GetEvaluatorInputsMessage(EvaluatorInputsBatch& batch) {
+  if (batch.message.empty()) batch.message = batch.message_future.get();
+  return communication::GetMessage(batch.message.data())->payload()->data();
+}
+
+void Provider::GarbleOffline() {
+  if (!offline_garbling_) return;
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug("Set up {} garbled circuit gates offline",
+                                               offline_garbled_gates_.size());
+  }
+  // the gates were registered in topological order, so their input wires are always ready
+  for (auto& setup : offline_garbled_gates_) setup();
+  {
+    std::scoped_lock lock(garbled_offline_condition_->GetMutex());
+    garbled_offline_ = true;
+  }
+  garbled_offline_condition_->NotifyAll();
+}
+
+Block128Vector Provider::AcquireKeys(std::size_t number_of_simd) {
+  {
+    std::scoped_lock lock(key_pool_mutex_);
+    if (auto iterator{key_pool_.find(number_of_simd)};
+        iterator != key_pool_.end() && !iterator->second.empty()) {
+      Block128Vector keys{std::move(iterator->second.back())};
+      iterator->second.pop_back();
+      return keys;
+    }
+  }
+  return Block128Vector(number_of_simd);
+}
+
+void Provider::RecycleKeys(Block128Vector&& keys) {
+  if (keys.size() == 0) return;
+  std::scoped_lock lock(key_pool_mutex_);
+  auto& buffers{key_pool_[keys.size()]};
+  if (buffers.size() < kMaxNumberOfPooledKeyBuffers) buffers.emplace_back(std::move(keys));
+}
+
+void Provider::WaitGarbledOffline() const { garbled_offline_condition_->Wait(); }
+
+void Provider::Clear() {
+  {
+    std::scoped_lock lock(garbled_offline_condition_->GetMutex());
+    garbled_offline_ = false;
+  }
+  // the gates keep the positions of their tables and OTs, so the chunks and batches are sent and
+  // received anew under the same message ids, whose futures are reusable
+  for (auto& chunk : garbled_tables_chunks_) {
+    chunk->number_of_finished_gates = 0;
+    chunk->buffer.reset();
+    chunk->message.clear();
+  }
+  for (auto& batch : evaluator_inputs_batches_) {
+    batch->number_of_sent_gates = 0;
+    batch->number_of_received_gates = 0;
+    batch->corrections = BitVector<>();
+    batch->masked_labels.reset();
+    batch->message.clear();
+  }
+}
+
+void Provider::Reset() {
+  // the chunks and batches of the next circuit are numbered from 0 again
+  garbled_tables_chunks_.clear();
+  evaluator_inputs_batches_.clear();
+  Clear();
+  offline_garbled_gates_.clear();
+}
+
 void ThreeHalvesGarblerProvider::Setup() {
   if constexpr (kDebug) {
     communication_layer_.GetLogger()->LogDebug(
@@ -57,6 +219,8 @@ void ThreeHalvesGarblerProvider::Setup() {
 
   SetSetupIsReady();
 
+  GarbleOffline();
+
   if constexpr (kDebug) {
     communication_layer_.GetLogger()->LogDebug(
         "Finished evaluating setup phase of ThreeHalvesGarblerProvider");
@@ -82,6 +246,14 @@ void ThreeHalvesEvaluatorProvider::Setup() {
 
   SetSetupIsReady();
 
+  GarbleOffline();
+  if (offline_garbling_) {
+    // prefetch the streamed chunks, whose gates do not wait for them in their setup phase
+    for (std::size_t chunk_i = 0; chunk_i < garbled_tables_chunks_.size(); ++chunk_i) {
+      GetGarbledTablesChunk(chunk_i);
+    }
+  }
+
   if constexpr (kDebug) {
     communication_layer_.GetLogger()->LogDebug(
         "Finished evaluating setup phase of ThreeHalvesEvaluatorProvider");
@@ -89,13 +261,15 @@ void ThreeHalvesEvaluatorProvider::Setup() {
 }
 
 std::unique_ptr<garbled_circuit::Provider> Provider::MakeProvider(
-    communication::CommunicationLayer& communication_layer) {
+    communication::CommunicationLayer& communication_layer, ConfigurationPointer configuration) {
   assert(communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kGarbler) ||
          communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kEvaluator));
   if (communication_layer.GetMyId() == static_cast<std::size_t>(GarbledCircuitRole::kGarbler)) {
-    return std::make_unique<ThreeHalvesGarblerProvider>(communication_layer);
+    return std::make_unique<ThreeHalvesGarblerProvider>(communication_layer,
+                                                        std::move(configuration));
   } else {
-    return std::make_unique<ThreeHalvesEvaluatorProvider>(communication_layer);
+    return std::make_unique<ThreeHalvesEvaluatorProvider>(communication_layer,
+                                                          std::move(configuration));
   }
 }
 
@@ -121,8 +295,9 @@ void Provider::AesNiFixedKeyForThreeHalvesGatesBatch3(std::span<const std::byte>
                                                       const Block128& hash_key,
                                                       std::size_t gate_index,
                                                       std::span<Block128> input) {
-  for (auto& block : input) block ^= hash_key;
-  AesniTmmoBatch3(round_keys.data(), input.data(), gate_index);
+  assert(input.size() % 3 == 0);
+  XorBlocks(input.data(), input.data(), hash_key, input.size());
+  AesniTmmoGatesBatch3(round_keys.data(), input.data(), gate_index, input.size() / 3);
 }
 
 std::shared_ptr<garbled_circuit::AndGate> ThreeHalvesGarblerProvider::MakeAndGate(
@@ -168,8 +343,9 @@ std::shared_ptr<garbled_circuit::XorGate> ThreeHalvesEvaluatorProvider::MakeXorG
 }
 
 ThreeHalvesGarblerProvider::ThreeHalvesGarblerProvider(
-    communication::CommunicationLayer& communication_layer)
-    : Provider(communication_layer), random_key_offset_(Block128::MakeRandom()) {
+    communication::CommunicationLayer& communication_layer, ConfigurationPointer configuration)
+    : Provider(communication_layer, std::move(configuration)),
+      random_key_offset_(Block128::MakeRandom()) {
   BitSpan random_key_offset_span(random_key_offset_.data(), kKappa);
   // Set 1 at the position of the permutation bit.
   random_key_offset_span.Set(true, kKappa - 1);
@@ -264,19 +440,60 @@ void ThreeHalvesGarblerProvider::Garble(const Block128Vector& keys_a, const Bloc
                                         Block128Vector& keys_out, std::byte* garbled_tables,
                                         std::byte* garbled_control_bits, std::size_t table_offset,
                                         std::size_t gate_index) {
-  static_assert(kGarbledControlBitsBitSize == 5, "Garbling may not work for other bit-lengths");
-  static_assert(kGarbledRowBitSize == 64, "Garbling may not work for other bit-lengths");
   const std::size_t number_of_simd{keys_a.size()};
   keys_out.resize(number_of_simd);
 
   auto randomness_pool_for_R{BitVector<>::SecureRandom(2 * number_of_simd)};
 
-  for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+  ForEachSimdRange(number_of_simd, table_offset, [&](std::size_t simd_begin, std::size_t simd_end) {
+    GarbleSimdRange(keys_a, keys_b, keys_out, garbled_tables, garbled_control_bits,
+                    randomness_pool_for_R, table_offset, gate_index, simd_begin, simd_end);
+  });
+}
+
+void ThreeHalvesGarblerProvider::GarbleSimdRange(
+    const Block128Vector& keys_a, const Block128Vector& keys_b, Block128Vector& keys_out,
+    std::byte* garbled_tables, std::byte* garbled_control_bits,
+    const BitVector<>& randomness_pool_for_R, std::size_t table_offset, std::size_t gate_index,
+    std::size_t simd_begin, std::size_t simd_end) {
+  static_assert(kGarbledControlBitsBitSize == 5, "Garbling may not work for other bit-lengths");
+  static_assert(kGarbledRowBitSize == 64, "Garbling may not work for other bit-lengths");
+
+  // hash the keys of up to kHashBatchSize SIMD values at once to fill the AES pipeline
+  Block128Vector hashes(6 * std::min(simd_end - simd_begin, kHashBatchSize));
+
+  for (std::size_t simd_i = simd_begin; simd_i < simd_end; ++simd_i) {
     bool p_a{GetBit<7>(keys_a[simd_i].data()[Block128::kBlockSize - 1])};
     bool p_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
     // compute "zero keys"
     Block128 key_a_0{p_a ? keys_a[simd_i] ^ random_key_offset_ : keys_a[simd_i]};
     Block128 key_b_0{p_b ? keys_b[simd_i] ^ random_key_offset_ : keys_b[simd_i]};
+
+    if ((simd_i - simd_begin) % kHashBatchSize == 0) {
+      // Compute H(A_0), H(A_1), H(B_0), H(B_1), H(A_0 ^ B_0), H(A_0 ^ B_1) for the next batch
+      const std::size_t batch_size{std::min(kHashBatchSize, simd_end - simd_i)};
+      for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+        const Block128& key_a{keys_a[simd_i + batch_i]};
+        const Block128& key_b{keys_b[simd_i + batch_i]};
+        Block128 batch_key_a_0{GetBit<7>(key_a.data()[Block128::kBlockSize - 1])
+                                   ? key_a ^ random_key_offset_
+                                   : key_a};
+        Block128 batch_key_b_0{GetBit<7>(key_b.data()[Block128::kBlockSize - 1])
+                                   ? key_b ^ random_key_offset_
+                                   : key_b};
+        Block128* hash_inputs{&hashes[6 * batch_i]};
+        hash_inputs[0] = batch_key_a_0;
+        hash_inputs[1] = batch_key_a_0 ^ random_key_offset_;
+        hash_inputs[2] = batch_key_b_0;
+        hash_inputs[3] = batch_key_b_0 ^ random_key_offset_;
+        hash_inputs[4] = batch_key_a_0 ^ batch_key_b_0;
+        hash_inputs[5] = batch_key_a_0 ^ batch_key_b_0 ^ random_key_offset_;
+      }
+      // compute AES in-place
+      AesNiFixedKeyForThreeHalvesGatesBatch6(
+          round_keys_, public_data_.hash_key, gate_index + simd_i,
+          std::span<Block128>(&hashes[0], 6 * batch_size));
+    }
     //  Sample compressed wire mapping r
     //  Decoded by multiplying with
     //  S1 = | 1 1 | 1 0 |   and   S2 = | 1 0 | 0 1 |
@@ -408,14 +625,8 @@ void ThreeHalvesGarblerProvider::Garble(const Block128Vector& keys_a, const Bloc
     Xor64BitsIntoLeft(&result[3], &R_times_wires[1], &R_times_wires[2], &R_times_wires[3]);
     Xor64BitsIntoLeft(&result[4], &R_times_wires[6]);
 
-    // Compute H(A_0), H(A_1), H(B_0), H(B_1), H(A_0 ^ B_0), H(A_0 ^ B_1)
-    std::array<Block128, 6> hash_inputs = {
-        key_a_0,           key_a_0 ^ random_key_offset_,
-        key_b_0,           key_b_0 ^ random_key_offset_,
-        key_a_0 ^ key_b_0, key_a_0 ^ key_b_0 ^ random_key_offset_};
-    // compute AES in-place
-    AesNiFixedKeyForThreeHalvesGatesBatch6(round_keys_, public_data_.hash_key, gate_index + simd_i,
-                                           hash_inputs);
+    // H(A_0), H(A_1), H(B_0), H(B_1), H(A_0 ^ B_0), H(A_0 ^ B_1), computed above
+    const Block128* hash_inputs{&hashes[6 * ((simd_i - simd_begin) % kHashBatchSize)]};
 
     // V^-1 * M * H = | 1 0 | 0 0 | 1 0 |  * H = | H(A_0) ^ H(A_0 ^ B_0)                |
     //                | 0 0 | 1 0 | 1 0 |        | H(B_0) ^ H(A_0 ^ B_0)                |
@@ -458,8 +669,9 @@ void ThreeHalvesGarblerProvider::Garble(const Block128Vector& keys_a, const Bloc
 void ThreeHalvesGarblerProvider::AesNiFixedKeyForThreeHalvesGatesBatch6(
     std::span<const std::byte> round_keys, const Block128& hash_key, std::size_t gate_index,
     std::span<Block128> input) {
-  for (auto& block : input) block ^= hash_key;
-  AesniTmmoBatch6(round_keys.data(), input.data(), gate_index);
+  assert(input.size() % 6 == 0);
+  XorBlocks(input.data(), input.data(), hash_key, input.size());
+  AesniTmmoGatesBatch6(round_keys.data(), input.data(), gate_index, input.size() / 6);
 }
 
 inline std::byte ExtractGarbledControlBits(const std::byte* data, std::size_t bit_offset) {
@@ -481,7 +693,36 @@ void ThreeHalvesEvaluatorProvider::Evaluate(const Block128Vector& keys_a,
                                             std::size_t table_offset, std::size_t gate_index) {
   const std::size_t number_of_simd{keys_a.size()};
   keys_out.resize(number_of_simd);
-  for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+
+  ForEachSimdRange(number_of_simd, table_offset, [&](std::size_t simd_begin, std::size_t simd_end) {
+    EvaluateSimdRange(keys_a, keys_b, keys_out, garbled_tables, garbled_control_bits, table_offset,
+                      gate_index, simd_begin, simd_end);
+  });
+}
+
+void ThreeHalvesEvaluatorProvider::EvaluateSimdRange(
+    const Block128Vector& keys_a, const Block128Vector& keys_b, Block128Vector& keys_out,
+    const std::byte* garbled_tables, const std::byte* garbled_control_bits,
+    std::size_t table_offset, std::size_t gate_index, std::size_t simd_begin,
+    std::size_t simd_end) {
+  // hash the keys of up to kHashBatchSize SIMD values at once to fill the AES pipeline
+  Block128Vector hashes(3 * std::min(simd_end - simd_begin, kHashBatchSize));
+
+  for (std::size_t simd_i = simd_begin; simd_i < simd_end; ++simd_i) {
+    if ((simd_i - simd_begin) % kHashBatchSize == 0) {
+      // Compute H = H(A), H(B), H(A ^ B) for the next batch
+      const std::size_t batch_size{std::min(kHashBatchSize, simd_end - simd_i)};
+      for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+        hashes[3 * batch_i] = keys_a[simd_i + batch_i];
+        hashes[3 * batch_i + 1] = keys_b[simd_i + batch_i];
+        hashes[3 * batch_i + 2] = keys_a[simd_i + batch_i] ^ keys_b[simd_i + batch_i];
+      }
+      // compute AES in-place
+      AesNiFixedKeyForThreeHalvesGatesBatch3(round_keys_, public_data_.hash_key,
+                                             gate_index + simd_i,
+                                             std::span<Block128>(&hashes[0], 3 * batch_size));
+    }
+
     std::byte z{ExtractGarbledControlBits(garbled_control_bits,
                                           (table_offset + simd_i) * kGarbledControlBitsBitSize)};
 
@@ -540,12 +781,8 @@ void ThreeHalvesEvaluatorProvider::Evaluate(const Block128Vector& keys_a,
         break;
     }
 
-    // Compute H = H(A), H(B), H(A ^ B)
-    std::array<Block128, 3> hash_inputs = {keys_a[simd_i], keys_b[simd_i],
-                                           keys_a[simd_i] ^ keys_b[simd_i]};
-    // compute AES in-place
-    AesNiFixedKeyForThreeHalvesGatesBatch3(round_keys_, public_data_.hash_key, gate_index + simd_i,
-                                           hash_inputs);
+    // H = H(A), H(B), H(A ^ B), computed above
+    const Block128* hash_inputs{&hashes[3 * ((simd_i - simd_begin) % kHashBatchSize)]};
 
     // Inline computation of | 1 0 1 | * H
     //                       | 0 1 1 |
@@ -606,9 +843,279 @@ void ThreeHalvesEvaluatorProvider::Evaluate(const Block128Vector& keys_a,
   }
 }
 
+void ThreeHalvesGarblerProvider::GarbleHalfGates(const Block128Vector& keys_a,
+                                                 const Block128Vector& keys_b,
+                                                 Block128Vector& keys_out,
+                                                 std::byte* garbled_tables,
+                                                 std::size_t table_offset,
+                                                 std::size_t gate_index) {
+  const std::size_t number_of_simd{keys_a.size()};
+  keys_out.resize(number_of_simd);
+
+  ForEachSimdRange(number_of_simd, table_offset, [&](std::size_t simd_begin, std::size_t simd_end) {
+    GarbleHalfGatesSimdRange(keys_a, keys_b, keys_out, garbled_tables, table_offset, gate_index,
+                             simd_begin, simd_end);
+  });
+}
+
+void ThreeHalvesGarblerProvider::GarbleHalfGatesSimdRange(
+    const Block128Vector& keys_a, const Block128Vector& keys_b, Block128Vector& keys_out,
+    std::byte* garbled_tables, std::size_t table_offset, std::size_t gate_index,
+    std::size_t simd_begin, std::size_t simd_end) {
+  // hash the keys of up to kHashBatchSize SIMD values at once to fill the AES pipeline
+  Block128Vector hashes(4 * std::min(simd_end - simd_begin, kHashBatchSize));
+
+  for (std::size_t simd_i = simd_begin; simd_i < simd_end; ++simd_i) {
+    if ((simd_i - simd_begin) % kHashBatchSize == 0) {
+      // Compute H(A_0), H(A_1) with tweak j and H(B_0), H(B_1) with tweak j' for the next batch
+      const std::size_t batch_size{std::min(kHashBatchSize, simd_end - simd_i)};
+      for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+        Block128* hash_inputs{&hashes[4 * batch_i]};
+        hash_inputs[0] = keys_a[simd_i + batch_i];
+        hash_inputs[1] = keys_a[simd_i + batch_i] ^ random_key_offset_;
+        hash_inputs[2] = keys_b[simd_i + batch_i];
+        hash_inputs[3] = keys_b[simd_i + batch_i] ^ random_key_offset_;
+      }
+      XorBlocks(hashes.data(), hashes.data(), public_data_.hash_key, 4 * batch_size);
+      AesniTmmoGatesBatch4(round_keys_.data(), hashes.data(), gate_index + simd_i, batch_size);
+    }
+    const Block128* hashed_keys{&hashes[4 * ((simd_i - simd_begin) % kHashBatchSize)]};
+    // the keys of the wires are the keys of 0, whose permutation bits are p_a and p_b
+    const Block128& key_a_0{keys_a[simd_i]};
+    bool p_a{GetBit<7>(key_a_0.data()[Block128::kBlockSize - 1])};
+    bool p_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
+
+    // generator half gate: T_G = H(A_0) ^ H(A_1) ^ p_b * offset, W_G = H(A_0) ^ p_a * T_G
+    Block128 table_generator{hashed_keys[0] ^ hashed_keys[1]};
+    if (p_b) table_generator ^= random_key_offset_;
+    Block128 key_out{hashed_keys[0]};
+    if (p_a) key_out ^= table_generator;
+
+    // evaluator half gate: T_E = H(B_0) ^ H(B_1) ^ A_0, W_E = H(B_0) ^ p_b * (T_E ^ A_0)
+    Block128 table_evaluator{hashed_keys[2] ^ hashed_keys[3] ^ key_a_0};
+    key_out ^= hashed_keys[2];
+    if (p_b) key_out ^= hashed_keys[2] ^ hashed_keys[3];
+
+    keys_out[simd_i] = key_out;
+    std::byte* table{garbled_tables + (table_offset + simd_i) * kHalfGatesGarbledTableByteSize};
+    std::copy_n(table_generator.data(), Block128::kBlockSize, table);
+    std::copy_n(table_evaluator.data(), Block128::kBlockSize, table + Block128::kBlockSize);
+  }
+}
+
+std::byte* ThreeHalvesGarblerProvider::GetGarbledTablesChunkBuffer(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::scoped_lock lock(chunk.mutex);
+  // avoid using std::vector to not initialize the memory
+  if (!chunk.buffer) chunk.buffer = std::shared_ptr<std::byte[]>(new std::byte[chunk.size]);
+  return chunk.buffer.get();
+}
+
+void ThreeHalvesGarblerProvider::FinishGarbledTables(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::shared_ptr<std::byte[]> buffer;
+  {
+    std::scoped_lock lock(chunk.mutex);
+    assert(chunk.number_of_finished_gates < chunk.number_of_gates);
+    if (++chunk.number_of_finished_gates < chunk.number_of_gates) return;
+    // the communication layer keeps the buffer alive until the chunk is sent
+    buffer = std::move(chunk.buffer);
+  }
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug("Send chunk #{} of {} garbled AND gates ({} B)",
+                                               chunk_index, chunk.number_of_gates, chunk.size);
+  }
+  std::span payload(reinterpret_cast<const std::uint8_t*>(buffer.get()), chunk.size);
+  communication_layer_.SendMessage(static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+                                   communication::MessageType::kGarbledCircuitGarbledTablesChunk,
+                                   chunk_index, payload,
+                                   std::shared_ptr<const std::byte[]>(std::move(buffer)));
+}
+
+void ThreeHalvesGarblerProvider::OnNewEvaluatorInputsBatch(std::size_t batch_index) {
+  evaluator_inputs_batches_[batch_index]->message_future =
+      communication_layer_.GetMessageManager().RegisterReceive(
+          static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+          communication::MessageType::kGarbledCircuitEvaluatorInputCorrections, batch_index);
+}
+
+BitVector<> ThreeHalvesGarblerProvider::GetEvaluatorInputCorrections(
+    const EvaluatorInputsPosition& position, std::size_t number_of_ots) {
+  assert(position.batch_index < evaluator_inputs_batches_.size());
+  auto& batch{*evaluator_inputs_batches_[position.batch_index]};
+  std::scoped_lock lock(batch.mutex);
+  assert(position.offset + number_of_ots <= batch.number_of_ots);
+  const BitSpan corrections(const_cast<std::uint8_t*>(GetEvaluatorInputsMessage(batch)),
+                            batch.number_of_ots);
+  auto result{corrections.Subset<BitVector<>>(position.offset, position.offset + number_of_ots)};
+  assert(batch.number_of_received_gates < batch.number_of_gates);
+  if (++batch.number_of_received_gates == batch.number_of_gates) {
+    batch.message.clear();
+    batch.message.shrink_to_fit();
+  }
+  return result;
+}
+
+void ThreeHalvesGarblerProvider::SendEvaluatorInputMaskedLabels(
+    const EvaluatorInputsPosition& position, const Block128Vector& masked_labels) {
+  assert(position.batch_index < evaluator_inputs_batches_.size());
+  auto& batch{*evaluator_inputs_batches_[position.batch_index]};
+  std::shared_ptr<Block128Vector> buffer;
+  {
+    std::scoped_lock lock(batch.mutex);
+    assert(batch.number_of_sent_gates < batch.number_of_gates);
+    if (!batch.masked_labels) {
+      batch.masked_labels = std::make_shared<Block128Vector>(2 * batch.number_of_ots);
+    }
+    assert(2 * position.offset + masked_labels.size() <= batch.masked_labels->size());
+    std::copy(masked_labels.begin(), masked_labels.end(),
+              batch.masked_labels->begin() + 2 * position.offset);
+    if (++batch.number_of_sent_gates < batch.number_of_gates) return;
+    // the communication layer keeps the buffer alive until the batch is sent
+    buffer = std::move(batch.masked_labels);
+  }
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug(
+        "Send the labels of batch #{} of {} evaluator input gates ({} OTs)", position.batch_index,
+        batch.number_of_gates, batch.number_of_ots);
+  }
+  std::span payload(reinterpret_cast<const std::uint8_t*>(buffer->data()->data()),
+                    buffer->ByteSize());
+  communication_layer_.SendMessage(
+      static_cast<std::size_t>(GarbledCircuitRole::kEvaluator),
+      communication::MessageType::kGarbledCircuitEvaluatorInputMaskedLabels, position.batch_index,
+      payload, std::shared_ptr<const void>(std::move(buffer)));
+}
+
+void ThreeHalvesEvaluatorProvider::EvaluateHalfGates(const Block128Vector& keys_a,
+                                                     const Block128Vector& keys_b,
+                                                     Block128Vector& keys_out,
+                                                     const std::byte* garbled_tables,
+                                                     std::size_t table_offset,
+                                                     std::size_t gate_index) {
+  const std::size_t number_of_simd{keys_a.size()};
+  keys_out.resize(number_of_simd);
+
+  ForEachSimdRange(number_of_simd, table_offset, [&](std::size_t simd_begin, std::size_t simd_end) {
+    EvaluateHalfGatesSimdRange(keys_a, keys_b, keys_out, garbled_tables, table_offset, gate_index,
+                               simd_begin, simd_end);
+  });
+}
+
+void ThreeHalvesEvaluatorProvider::EvaluateHalfGatesSimdRange(
+    const Block128Vector& keys_a, const Block128Vector& keys_b, Block128Vector& keys_out,
+    const std::byte* garbled_tables, std::size_t table_offset, std::size_t gate_index,
+    std::size_t simd_begin, std::size_t simd_end) {
+  // hash the keys of up to kHashBatchSize SIMD values at once to fill the AES pipeline
+  Block128Vector hashes(2 * std::min(simd_end - simd_begin, kHashBatchSize));
+
+  for (std::size_t simd_i = simd_begin; simd_i < simd_end; ++simd_i) {
+    if ((simd_i - simd_begin) % kHashBatchSize == 0) {
+      // Compute H(A) with tweak j and H(B) with tweak j' for the next batch
+      const std::size_t batch_size{std::min(kHashBatchSize, simd_end - simd_i)};
+      for (std::size_t batch_i = 0; batch_i < batch_size; ++batch_i) {
+        hashes[2 * batch_i] = keys_a[simd_i + batch_i] ^ public_data_.hash_key;
+        hashes[2 * batch_i + 1] = keys_b[simd_i + batch_i] ^ public_data_.hash_key;
+      }
+      AesniTmmoGatesBatch2(round_keys_.data(), hashes.data(), gate_index + simd_i, batch_size);
+    }
+    const Block128* hashed_keys{&hashes[2 * ((simd_i - simd_begin) % kHashBatchSize)]};
+    bool s_a{GetBit<7>(keys_a[simd_i].data()[Block128::kBlockSize - 1])};
+    bool s_b{GetBit<7>(keys_b[simd_i].data()[Block128::kBlockSize - 1])};
+    const std::byte* table{garbled_tables +
+                           (table_offset + simd_i) * kHalfGatesGarbledTableByteSize};
+
+    // W = H(A) ^ s_a * T_G ^ H(B) ^ s_b * (T_E ^ A)
+    Block128 key_out{hashed_keys[0] ^ hashed_keys[1]};
+    if (s_a) key_out ^= Block128::MakeFromMemory(table);
+    if (s_b) key_out ^= Block128::MakeFromMemory(table + Block128::kBlockSize) ^ keys_a[simd_i];
+    keys_out[simd_i] = key_out;
+  }
+}
+
+void ThreeHalvesEvaluatorProvider::OnNewGarbledTablesChunk(std::size_t chunk_index) {
+  garbled_tables_chunks_[chunk_index]->message_future =
+      communication_layer_.GetMessageManager().RegisterReceive(
+          static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
+          communication::MessageType::kGarbledCircuitGarbledTablesChunk, chunk_index);
+}
+
+const std::byte* ThreeHalvesEvaluatorProvider::GetGarbledTablesChunk(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::scoped_lock lock(chunk.mutex);
+  if (chunk.message.empty()) chunk.message = chunk.message_future.get();
+  auto payload{communication::GetMessage(chunk.message.data())->payload()};
+  assert(payload->size() == chunk.size);
+  return reinterpret_cast<const std::byte*>(payload->data());
+}
+
+void ThreeHalvesEvaluatorProvider::ReleaseGarbledTablesChunk(std::size_t chunk_index) {
+  assert(chunk_index < garbled_tables_chunks_.size());
+  auto& chunk{*garbled_tables_chunks_[chunk_index]};
+  std::scoped_lock lock(chunk.mutex);
+  assert(chunk.number_of_finished_gates < chunk.number_of_gates);
+  if (++chunk.number_of_finished_gates == chunk.number_of_gates) {
+    chunk.message.clear();
+    chunk.message.shrink_to_fit();
+  }
+}
+
+void ThreeHalvesEvaluatorProvider::OnNewEvaluatorInputsBatch(std::size_t batch_index) {
+  evaluator_inputs_batches_[batch_index]->message_future =
+      communication_layer_.GetMessageManager().RegisterReceive(
+          static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
+          communication::MessageType::kGarbledCircuitEvaluatorInputMaskedLabels, batch_index);
+}
+
+void ThreeHalvesEvaluatorProvider::SendEvaluatorInputCorrections(
+    const EvaluatorInputsPosition& position, const BitVector<>& corrections) {
+  assert(position.batch_index < evaluator_inputs_batches_.size());
+  auto& batch{*evaluator_inputs_batches_[position.batch_index]};
+  BitVector<> batch_corrections;
+  {
+    std::scoped_lock lock(batch.mutex);
+    assert(batch.number_of_sent_gates < batch.number_of_gates);
+    if (batch.number_of_sent_gates == 0) batch.corrections = BitVector<>(batch.number_of_ots);
+    batch.corrections.Copy(position.offset, corrections);
+    if (++batch.number_of_sent_gates < batch.number_of_gates) return;
+    batch_corrections = std::move(batch.corrections);
+  }
+  if constexpr (kDebug) {
+    communication_layer_.GetLogger()->LogDebug(
+        "Send the corrections of batch #{} of {} evaluator input gates ({} OTs)",
+        position.batch_index, batch.number_of_gates, batch.number_of_ots);
+  }
+  std::span payload(reinterpret_cast<const std::uint8_t*>(batch_corrections.GetData().data()),
+                    batch_corrections.GetData().size());
+  auto message{communication::BuildMessage(
+      communication::MessageType::kGarbledCircuitEvaluatorInputCorrections, position.batch_index,
+      payload)};
+  communication_layer_.SendMessage(static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
+                                   message.Release());
+}
+
+Block128Vector ThreeHalvesEvaluatorProvider::GetEvaluatorInputMaskedLabels(
+    const EvaluatorInputsPosition& position, std::size_t number_of_ots) {
+  assert(position.batch_index < evaluator_inputs_batches_.size());
+  auto& batch{*evaluator_inputs_batches_[position.batch_index]};
+  std::scoped_lock lock(batch.mutex);
+  assert(position.offset + number_of_ots <= batch.number_of_ots);
+  const std::uint8_t* payload{GetEvaluatorInputsMessage(batch)};
+  Block128Vector result(2 * number_of_ots, payload + 2 * position.offset * Block128::kBlockSize);
+  assert(batch.number_of_received_gates < batch.number_of_gates);
+  if (++batch.number_of_received_gates == batch.number_of_gates) {
+    batch.message.clear();
+    batch.message.shrink_to_fit();
+  }
+  return result;
+}
+
 ThreeHalvesEvaluatorProvider::ThreeHalvesEvaluatorProvider(
-    communication::CommunicationLayer& communication_layer)
-    : Provider(communication_layer) {
+    communication::CommunicationLayer& communication_layer, ConfigurationPointer configuration)
+    : Provider(communication_layer, std::move(configuration)) {
   three_halves_public_data_future_ = communication_layer.GetMessageManager().RegisterReceive(
       static_cast<std::size_t>(GarbledCircuitRole::kGarbler),
       communication::MessageType::kGarbledCircuitSetup, 0);
@@ -24,16 +24,22 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
+#include <boost/fiber/mutex.hpp>
+
 #include "communication/message_manager.h"
+#include "garbled_circuit_constants.h"
 #include "garbled_circuit_gate.h"
 #include "garbled_circuit_wire.h"
 #include "primitives/aes/aesni_primitives.h"
 #include "primitives/random/default_rng.h"
+#include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/constants.h"
+#include "utility/fiber_condition.h"
 #include "utility/fiber_waitable.h"
 #include "utility/typedefs.h"
 
@@ -41,6 +47,9 @@ namespace encrypto::motion {
 
 class Backend;
 
+class Configuration;
+using ConfigurationPointer = std::shared_ptr<Configuration>;
+
 namespace communication {
 class CommunicationLayer;
 }
@@ -58,10 +67,19 @@ struct ThreeHalvesGarblingPublicData {
   Block128 aes_key;
 };
 
+/// \brief Selects the garbling scheme with the smallest estimated time per AND gate on a network
+/// with \p bandwidth in bits per second, where 0 means unlimited.  The garbler and the evaluator
+/// work in parallel to the transfer of the tables, so the slowest of them determines the time:
+/// half-gates needs fewer AES calls but sends 256 instead of 197 bits per AND gate, thus wins for
+/// high bandwidths.
+GarbledCircuitScheme SelectGarbledCircuitScheme(double bandwidth);
+
 // The garbled circuit provider interface
 class Provider : public FiberSetupWaitable {
  public:
-  Provider(communication::CommunicationLayer& communication_layer);
+  /// \param configuration determines the garbling scheme, see GetScheme
+  Provider(communication::CommunicationLayer& communication_layer,
+           ConfigurationPointer configuration = nullptr);
 
   // delete the copy constructor
   Provider(const Provider&) = delete;
@@ -75,7 +93,25 @@ class Provider : public FiberSetupWaitable {
   /// \brief Depending on the party's id (obtained from the \p communication_layer) creates either a
   /// ThreeHalvesGarblerProvider or a ThreeHalvesEvaluatorProvider static_casted to their parent.
   static std::unique_ptr<garbled_circuit::Provider> MakeProvider(
-      communication::CommunicationLayer& communication_layer);
+      communication::CommunicationLayer& communication_layer,
+      ConfigurationPointer configuration = nullptr);
+
+  /// \brief Returns the garbling scheme of AND gates, which is three-halves (default) or
+  /// half-gates as set by Configuration::SetGarbledCircuitScheme.  The scheme of an AND gate is
+  /// fixed when it is constructed.
+  GarbledCircuitScheme GetScheme() const;
+
+  /// \brief Returns the number of bits of the garbled table of an AND gate on one SIMD value.
+  static std::size_t GetGarbledTableBitSize(GarbledCircuitScheme scheme) noexcept {
+    return scheme == GarbledCircuitScheme::kHalfGates ? kHalfGatesGarbledTableBitSize
+                                                      : kGarbledTableBitSize;
+  }
+
+  /// \brief Returns the number of control bits, which are sent after the tables, of an AND gate
+  /// on one SIMD value.
+  static std::size_t GetGarbledControlBitsBitSize(GarbledCircuitScheme scheme) noexcept {
+    return scheme == GarbledCircuitScheme::kHalfGates ? 0 : kGarbledControlBitsBitSize;
+  }
 
   /// \brief Constructs an Input gate. An InputGateGarbled is constructed for garbler and an
   /// InputGateEvaluator for the evaluator. The result is static_pointer_cast'ed to
@@ -97,25 +133,185 @@ class Provider : public FiberSetupWaitable {
   virtual std::shared_ptr<garbled_circuit::XorGate> MakeXorGate(motion::SharePointer parent_a,
                                                                 motion::SharePointer parent_b) = 0;
 
+  /// \brief Number of SIMD values of an AND gate whose keys are hashed by a single call to
+  /// AesNiFixedKeyForThreeHalvesGatesBatch3/6, s.t. the AES pipeline is kept busy.
+  static constexpr std::size_t kHashBatchSize{16};
+
+  /// \brief AND gates with at least kParallelSimdThreshold SIMD values are garbled and evaluated
+  /// by multiple threads, each of which processes ranges of kParallelSimdRangeSize SIMD values.
+  static constexpr std::size_t kParallelSimdThreshold{1 << 14};
+  static constexpr std::size_t kParallelSimdRangeSize{1 << 12};
+
+  /// \brief Hashes the 3 blocks of each of input.size() / 3 SIMD values in-place, where the i-th
+  /// triple uses the tweak gate_index + i.
   void AesNiFixedKeyForThreeHalvesGatesBatch3(std::span<const std::byte> round_keys,
                                               const Block128& hash_key, std::size_t gate_index,
                                               std::span<Block128> input);
 
+  /// \brief Enables streaming of garbled tables: instead of one message per AND gate, the tables
+  /// of consecutively constructed AND gates are collected in chunks of at least \p chunk_size
+  /// bytes, which are sent as soon as all their gates are garbled.  The evaluator evaluates a gate
+  /// as soon as its chunk arrived and frees the chunk after all of its gates are evaluated.
+  /// Needs to be set to the same value by both parties before constructing the circuit.
+  /// \param chunk_size 0 (default) disables streaming
+  void SetGarbledTablesChunkSize(std::size_t chunk_size) {
+    garbled_tables_chunk_size_ = chunk_size;
+  }
+
+  std::size_t GetGarbledTablesChunkSize() const noexcept { return garbled_tables_chunk_size_; }
+
+  /// \brief Enables offline garbling: the setup phases of all garbled circuit gates, i.e., the
+  /// garbling and the transfer of the garbled tables, are run during the preprocessing by Setup
+  /// instead of when the circuit is evaluated.  The evaluator receives all garbled tables before
+  /// the evaluation starts, so the online phase only consists of transferring the input labels
+  /// and evaluating the gates.  For circuits compiled with several instances, all of them are
+  /// garbled ahead of time.  Needs to be set to the same value by both parties before
+  /// constructing the circuit.
+  void SetOfflineGarbling(bool value = true) { offline_garbling_ = value; }
+
+  bool GetOfflineGarbling() const noexcept { return offline_garbling_; }
+
+  /// \brief Registers the setup phase of a gate, which is run by Setup if offline garbling is
+  /// enabled.  The gates are set up in the order of registration, i.e., parents before children.
+  void RegisterOfflineGarbledGate(std::function<void()> setup) {
+    offline_garbled_gates_.push_back(std::move(setup));
+  }
+
+  /// \brief Blocks until the setup phases of the gates were run offline, which replaces the setup
+  /// phases of the gates while evaluating the circuit.
+  void WaitGarbledOffline() const;
+
+  /// \brief Enables freeing the keys of a wire as soon as the last gate reading them is done, s.t.
+  /// the memory for the keys is bounded by the keys alive at the same time instead of the size of
+  /// the circuit.  The freed buffers are pooled and reused for the keys of later wires.  The keys
+  /// of wires read by garbled circuit gates can no longer be accessed after the evaluation, and
+  /// such wires must not be read by other gates, e.g., conversions.  Needs to be set before
+  /// constructing the circuit.
+  void SetFreeKeysAfterLastUse(bool value = true) { free_keys_after_last_use_ = value; }
+
+  bool GetFreeKeysAfterLastUse() const noexcept { return free_keys_after_last_use_; }
+
+  /// \brief Returns a buffer for \p number_of_simd keys, reusing a freed one if possible.  The
+  /// keys are uninitialized if the buffer is reused.
+  Block128Vector AcquireKeys(std::size_t number_of_simd);
+
+  /// \brief Returns the buffer of freed keys to the pool, see Wire::ReleaseKeys.
+  void RecycleKeys(Block128Vector&& keys);
+
+  /// \brief Prepares offline garbling and the chunks of garbled tables and batches of evaluator
+  /// inputs for another evaluation of the circuit, see Backend::Clear.
+  void Clear();
+
+  /// \brief Forgets the gates registered for offline garbling and the chunks and batches of their
+  /// messages, s.t. the message ids of the next circuit start at 0 again, see Backend::Reset.
+  void Reset();
+
+  /// \brief Position of the garbled tables of an AND gate in the stream of chunks.
+  struct GarbledTablesPosition {
+    std::size_t chunk_index;
+    std::size_t offset;
+  };
+
+  /// \brief Assigns the garbled tables of a newly constructed AND gate of \p size bytes to a chunk.
+  GarbledTablesPosition AssignGarbledTablesChunk(std::size_t size);
+
+  /// \brief Position of the random OTs of an input gate of the evaluator in the batch of OTs of all
+  /// such gates, whose derandomization is sent in one message per party.
+  struct EvaluatorInputsPosition {
+    std::size_t batch_index;
+    std::size_t offset;
+  };
+
+  /// \brief Assigns the \p number_of_ots random OTs of a newly constructed input gate of the
+  /// evaluator to a batch.
+  EvaluatorInputsPosition AssignEvaluatorInputsBatch(std::size_t number_of_ots);
+
  protected:
+  struct GarbledTablesChunk {
+    std::size_t size{0};
+    std::size_t number_of_gates{0};
+    std::size_t number_of_finished_gates{0};
+    boost::fibers::mutex mutex;
+    // garbler: buffer the tables are garbled into
+    std::shared_ptr<std::byte[]> buffer;
+    // evaluator: received chunk
+    ReusableFiberFuture<std::vector<std::uint8_t>> message_future;
+    std::vector<std::uint8_t> message;
+  };
+
+  /// \brief Called when a new chunk is started while constructing the circuit.
+  virtual void OnNewGarbledTablesChunk([[maybe_unused]] std::size_t chunk_index) {}
+
+  struct EvaluatorInputsBatch {
+    std::size_t number_of_ots{0};
+    std::size_t number_of_gates{0};
+    // gates that added their part to the message of this party resp. that read their part of the
+    // message of the other party
+    std::size_t number_of_sent_gates{0};
+    std::size_t number_of_received_gates{0};
+    boost::fibers::mutex mutex;
+    // evaluator: choices xor random choices of the OTs
+    BitVector<> corrections;
+    // garbler: both labels of each OT masked with the random OT messages
+    std::shared_ptr<Block128Vector> masked_labels;
+    // message of the other party
+    ReusableFiberFuture<std::vector<std::uint8_t>> message_future;
+    std::vector<std::uint8_t> message;
+  };
+
+  /// \brief Called when a new batch of evaluator inputs is started while constructing the circuit.
+  virtual void OnNewEvaluatorInputsBatch(std::size_t batch_index) = 0;
+
+  /// \brief Returns the payload of the other party's message of a batch, waits until it arrived.
+  /// The batch's mutex must be held.
+  const std::uint8_t* GetEvaluatorInputsMessage(EvaluatorInputsBatch& batch);
+
+  /// \brief Runs the setup phases of the gates registered for offline garbling.
+  void GarbleOffline();
+
   communication::CommunicationLayer& communication_layer_;
 
+  ConfigurationPointer configuration_;
+
+  std::size_t garbled_tables_chunk_size_{0};
+
+  // chunks are only appended while constructing the circuit, so no synchronization is needed
+  std::vector<std::unique_ptr<GarbledTablesChunk>> garbled_tables_chunks_;
+
   std::size_t number_of_garbled_tables_{0};
 
+  // batches are only appended while constructing the circuit, so no synchronization is needed
+  std::vector<std::unique_ptr<EvaluatorInputsBatch>> evaluator_inputs_batches_;
+
   alignas(kAesBlockSize) std::array<std::byte, kAesRoundKeysSize128> round_keys_;
 
   ThreeHalvesGarblingPublicData public_data_;
 
   std::atomic<bool> preprocessing_done_{false};
+
+  bool offline_garbling_{false};
+
+  std::vector<std::function<void()>> offline_garbled_gates_;
+
+  std::atomic<bool> garbled_offline_{false};
+  std::unique_ptr<FiberCondition> garbled_offline_condition_;
+
+  bool free_keys_after_last_use_{false};
+
+  // maximum number of buffers of the same size kept in the pool
+  static constexpr std::size_t kMaxNumberOfPooledKeyBuffers{1024};
+
+  // freed key buffers by their number of keys
+  boost::fibers::mutex key_pool_mutex_;
+  std::unordered_map<std::size_t, std::vector<Block128Vector>> key_pool_;
 };
 
+/// \brief The garbler's provider, which garbles AND gates with three-halves or half-gates, see
+/// Provider::GetScheme.
 class ThreeHalvesGarblerProvider final : public Provider {
  public:
-  ThreeHalvesGarblerProvider(communication::CommunicationLayer& communication_layer);
+  ThreeHalvesGarblerProvider(communication::CommunicationLayer& communication_layer,
+                             ConfigurationPointer configuration = nullptr);
 
   ~ThreeHalvesGarblerProvider() override = default;
 
@@ -135,17 +331,60 @@ class ThreeHalvesGarblerProvider final : public Provider {
               std::byte*, std::byte* garbled_control_bits,
               std::size_t table_offset, std::size_t gate_index);
 
+  /// \brief Hashes the 6 blocks of each of input.size() / 6 SIMD values in-place, where the i-th
+  /// sextuple uses the tweak gate_index + i.
   void AesNiFixedKeyForThreeHalvesGatesBatch6(std::span<const std::byte> round_keys,
                                               const Block128& hash_key, std::size_t gate_index,
                                               std::span<Block128> input);
 
+  /// \brief Garbles an AND gate with half-gates by Zahur et al.
+  /// (https://eprint.iacr.org/2014/756), which costs 4 hashes and 2 blocks per SIMD value instead
+  /// of 6 hashes and 1.5 blocks plus 5 control bits of three-halves.
+  void GarbleHalfGates(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                       Block128Vector& keys_out, std::byte* garbled_tables,
+                       std::size_t table_offset, std::size_t gate_index);
+
+  /// \brief Returns the buffer of a chunk, into which the AND gates garble their tables.
+  std::byte* GetGarbledTablesChunkBuffer(std::size_t chunk_index);
+
+  /// \brief Marks the tables of one gate of the chunk as garbled and sends the chunk if all of
+  /// its gates are done.
+  void FinishGarbledTables(std::size_t chunk_index);
+
+  /// \brief Returns the evaluator's corrections of the \p number_of_ots random OTs of a gate,
+  /// waits until the batch's corrections arrived.
+  BitVector<> GetEvaluatorInputCorrections(const EvaluatorInputsPosition& position,
+                                           std::size_t number_of_ots);
+
+  /// \brief Adds the masked label pairs of a gate to its batch and sends the batch if all of its
+  /// gates are done.
+  void SendEvaluatorInputMaskedLabels(const EvaluatorInputsPosition& position,
+                                      const Block128Vector& masked_labels);
+
+ protected:
+  void OnNewEvaluatorInputsBatch(std::size_t batch_index) override;
+
  private:
+  void GarbleSimdRange(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                       Block128Vector& keys_out, std::byte* garbled_tables,
+                       std::byte* garbled_control_bits, const BitVector<>& randomness_pool_for_R,
+                       std::size_t table_offset, std::size_t gate_index, std::size_t simd_begin,
+                       std::size_t simd_end);
+
+  void GarbleHalfGatesSimdRange(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                                Block128Vector& keys_out, std::byte* garbled_tables,
+                                std::size_t table_offset, std::size_t gate_index,
+                                std::size_t simd_begin, std::size_t simd_end);
+
   Block128 random_key_offset_;
 };
 
+/// \brief The evaluator's provider, which evaluates AND gates garbled with three-halves or
+/// half-gates, see Provider::GetScheme.
 class ThreeHalvesEvaluatorProvider final : public Provider {
  public:
-  ThreeHalvesEvaluatorProvider(communication::CommunicationLayer& communication_layer);
+  ThreeHalvesEvaluatorProvider(communication::CommunicationLayer& communication_layer,
+                               ConfigurationPointer configuration = nullptr);
 
   ~ThreeHalvesEvaluatorProvider() override = default;
 
@@ -156,6 +395,11 @@ class ThreeHalvesEvaluatorProvider final : public Provider {
                 const std::byte* garbled_control_bits, std::size_t table_offset,
                 std::size_t gate_index);
 
+  /// \brief Evaluates an AND gate garbled by ThreeHalvesGarblerProvider::GarbleHalfGates.
+  void EvaluateHalfGates(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                         Block128Vector& keys_out, const std::byte* garbled_tables,
+                         std::size_t table_offset, std::size_t gate_index);
+
   std::shared_ptr<garbled_circuit::AndGate> MakeAndGate(motion::SharePointer parent_a,
                                                         motion::SharePointer parent_b) override;
 
@@ -164,7 +408,39 @@ class ThreeHalvesEvaluatorProvider final : public Provider {
   std::shared_ptr<garbled_circuit::XorGate> MakeXorGate(motion::SharePointer parent_a,
                                                         motion::SharePointer parent_b) override;
 
+  /// \brief Returns the received chunk, waits until it arrived.
+  const std::byte* GetGarbledTablesChunk(std::size_t chunk_index);
+
+  /// \brief Marks one gate of the chunk as evaluated and frees the chunk if all of its gates are
+  /// done.
+  void ReleaseGarbledTablesChunk(std::size_t chunk_index);
+
+  /// \brief Adds the corrections of the random OTs of a gate to its batch and sends the batch if
+  /// all of its gates are done.
+  void SendEvaluatorInputCorrections(const EvaluatorInputsPosition& position,
+                                     const BitVector<>& corrections);
+
+  /// \brief Returns the masked label pairs of the \p number_of_ots random OTs of a gate, waits
+  /// until the batch's labels arrived.
+  Block128Vector GetEvaluatorInputMaskedLabels(const EvaluatorInputsPosition& position,
+                                               std::size_t number_of_ots);
+
+ protected:
+  void OnNewGarbledTablesChunk(std::size_t chunk_index) override;
+
+  void OnNewEvaluatorInputsBatch(std::size_t batch_index) override;
+
  private:
+  void EvaluateSimdRange(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                         Block128Vector& keys_out, const std::byte* garbled_tables,
+                         const std::byte* garbled_control_bits, std::size_t table_offset,
+                         std::size_t gate_index, std::size_t simd_begin, std::size_t simd_end);
+
+  void EvaluateHalfGatesSimdRange(const Block128Vector& keys_a, const Block128Vector& keys_b,
+                                  Block128Vector& keys_out, const std::byte* garbled_tables,
+                                  std::size_t table_offset, std::size_t gate_index,
+                                  std::size_t simd_begin, std::size_t simd_end);
+
   ReusableFiberFuture<std::vector<std::uint8_t>> three_halves_public_data_future_;
 };
 
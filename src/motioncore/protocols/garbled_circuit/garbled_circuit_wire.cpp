@@ -26,16 +26,32 @@
 
 #include "base/backend.h"
 #include "base/register.h"
+#include "garbled_circuit_provider.h"
 
 namespace encrypto::motion::proto::garbled_circuit {
 
-Wire::Wire(Backend& backend, size_t number_of_simd) : BooleanWire(backend, number_of_simd) {}
+Wire::Wire(Backend& backend, size_t number_of_simd) : BooleanWire(backend, number_of_simd) {
+  memory_account_ = MemoryAccount(MemorySubsystem::kGarbledLabels);
+}
 
 Wire::Wire(Block128Vector&& wire_labels, Backend& backend)
-    : BooleanWire(backend, wire_labels.size()), wire_labels_(std::move(wire_labels)) {}
+    : BooleanWire(backend, wire_labels.size()), wire_labels_(std::move(wire_labels)) {
+  memory_account_ = MemoryAccount(MemorySubsystem::kGarbledLabels);
+}
 
 Wire::Wire(const Block128Vector& wire_labels, Backend& backend)
-    : BooleanWire(backend, wire_labels.size()), wire_labels_(wire_labels) {}
+    : BooleanWire(backend, wire_labels.size()), wire_labels_(wire_labels) {
+  memory_account_ = MemoryAccount(MemorySubsystem::kGarbledLabels);
+}
+
+void Wire::ReleaseKeys() {
+  assert(number_of_pending_key_consumers_ > 0);
+  if (--number_of_pending_key_consumers_ == 0) {
+    GetBackend().GetGarbledCircuitProvider().RecycleKeys(std::move(wire_labels_));
+    wire_labels_ = Block128Vector();
+    memory_account_.Set(0);
+  }
+}
 
 BitVector<> Wire::CopyPermutationBits() const {
   return encrypto::motion::proto::garbled_circuit::CopyPermutationBits(wire_labels_);
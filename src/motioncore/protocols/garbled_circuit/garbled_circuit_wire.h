@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <span>
 
 #include "protocols/wire.h"
@@ -63,11 +64,31 @@ class Wire final : public BooleanWire, public FiberSetupWaitable {
 
   BitVector<> CopyPermutationBits() const;
 
+  std::size_t GetNumberOfBytes() const final { return wire_labels_.ByteSize(); }
+
   bool IsConstant() const noexcept final { return false; }
 
+  /// \brief Registers a gate that reads the keys and calls ReleaseKeys after its last read, see
+  /// Provider::SetFreeKeysAfterLastUse.
+  void AddKeyConsumer() noexcept {
+    ++number_of_key_consumers_;
+    ++number_of_pending_key_consumers_;
+  }
+
+  /// \brief Called by a consumer after it last read the keys.  After the last consumer, the keys
+  /// are freed and their buffer is returned to the provider's pool for reuse by other wires.
+  void ReleaseKeys();
+
  private:
+  // resets the consumers for the next evaluation
+  void DynamicClear() final { number_of_pending_key_consumers_ = number_of_key_consumers_.load(); }
+
   /// Generated wire labels of the garbler or evaluated/obtained wire labels of the evaluator.
   Block128Vector wire_labels_;
+
+  /// Number of gates reading the keys and the number of them that did not yet release the keys.
+  std::atomic<std::size_t> number_of_key_consumers_{0};
+  std::atomic<std::size_t> number_of_pending_key_consumers_{0};
 };
 
 using WirePointer = std::shared_ptr<Wire>;
@@ -60,6 +60,14 @@ void Gate::WaitSetup() const { setup_is_ready_condition_.Wait(); }
 
 void Gate::WaitOnline() const { online_is_ready_condition_.Wait(); }
 
+std::size_t Gate::GetNumberOfOutputBits() const {
+  std::size_t number_of_bits{0};
+  for (const auto& wire : output_wires_) {
+    number_of_bits += wire->GetBitLength() * wire->GetNumberOfSimdValues();
+  }
+  return number_of_bits;
+}
+
 void Gate::Clear() {
   setup_is_ready_ = false;
   online_is_ready_ = false;
@@ -78,12 +78,39 @@ class Gate {
 
   const std::vector<WirePointer>& GetOutputWires() const { return output_wires_; }
 
-  void Clear();
+  /// \brief Returns all wires this gate reads in its evaluation, which is used for ordering gates
+  ///        by their depth in the circuit.
+  virtual std::vector<WirePointer> GetParentWires() const { return {}; }
+
+  /// \brief Prepares the gate for another evaluation, see Register::Clear.
+  virtual void Clear();
 
   virtual bool NeedsSetup() const { return true; }
 
   virtual bool NeedsOnline() const { return true; }
 
+  /// \brief Returns true if the gate neither communicates nor waits for preprocessing, s.t. it can
+  ///        be evaluated inline by the thread that finished its last parent, see
+  ///        GateExecutor::EvaluateDataflow.
+  virtual bool IsLocal() const { return false; }
+
+  /// \brief Returns true if EvaluateSetup only waits for the setup of the parents and for the
+  ///        base provider, but never for the online phase of any gate, s.t. the setup phases of
+  ///        such gates can be evaluated in circuit order ahead of the online phase, see
+  ///        Configuration::SetSetupPipeline.
+  virtual bool HasIndependentSetup() const { return false; }
+
+  /// \brief Estimated communication of the online phase, see CircuitStatistics.
+  struct OnlineCost {
+    // rounds this gate adds to any path through it
+    std::size_t number_of_rounds{0};
+    // bytes sent to each other party, excluding message headers
+    std::size_t number_of_bytes_per_party{0};
+  };
+
+  /// \brief Returns the estimated online communication of this gate, which is zero for local gates.
+  virtual OnlineCost GetOnlineCost() const { return {}; }
+
   void SetSetupIsReady();
 
   void SetOnlineIsReady();
@@ -113,6 +140,12 @@ class Gate {
 
   Gate(Backend& backend);
 
+  // sum of the bit lengths times the numbers of SIMD values of the output wires
+  std::size_t GetNumberOfOutputBits() const;
+
+  // GetNumberOfOutputBits() rounded up to whole bytes
+  std::size_t GetNumberOfOutputBytes() const { return (GetNumberOfOutputBits() + 7) / 8; }
+
   Register& GetRegister();
   Configuration& GetConfiguration();
   Logger& GetLogger();
@@ -124,11 +157,6 @@ class Gate {
   OtProvider& GetOtProvider(std::size_t i);
   proto::garbled_circuit::Provider& GetGarbledCircuitProvider();
   Kk13OtProvider& GetKk13OtProvider(std::size_t i);
-
- private:
-  void IfReadyAddToProcessingQueue();
-
-  std::mutex mutex_;
 };
 
 using GatePointer = std::shared_ptr<Gate>;
@@ -151,6 +179,8 @@ class OneGate : public Gate {
 
   const std::vector<WirePointer>& GetParent() const { return parent_; }
 
+  std::vector<WirePointer> GetParentWires() const override { return parent_; }
+
  protected:
   std::vector<WirePointer> parent_;
 
@@ -229,6 +259,12 @@ class TwoGate : public Gate {
 
   const std::vector<WirePointer>& GetParentA() const { return parent_a_; }
   const std::vector<WirePointer>& GetParentB() const { return parent_b_; }
+
+  std::vector<WirePointer> GetParentWires() const override {
+    std::vector<WirePointer> parents(parent_a_);
+    parents.insert(parents.end(), parent_b_.begin(), parent_b_.end());
+    return parents;
+  }
 };
 
 //
@@ -255,6 +291,13 @@ class ThreeGate : public Gate {
   const std::vector<WirePointer>& GetParentA() const { return parent_a_; }
   const std::vector<WirePointer>& GetParentB() const { return parent_b_; }
   const std::vector<WirePointer>& GetParentC() const { return parent_c_; }
+
+  std::vector<WirePointer> GetParentWires() const override {
+    std::vector<WirePointer> parents(parent_a_);
+    parents.insert(parents.end(), parent_b_.begin(), parent_b_.end());
+    parents.insert(parents.end(), parent_c_.begin(), parent_c_.end());
+    return parents;
+  }
 };
 
 //
@@ -277,6 +320,8 @@ class NInputGate : public Gate {
   ~NInputGate() override = default;
 
   const std::vector<WirePointer>& GetParents() const { return parents_; }
+
+  std::vector<WirePointer> GetParentWires() const override { return parents_; }
 };
 
 }  // namespace encrypto::motion
@@ -0,0 +1,185 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "output_batcher.h"
+
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion::proto {
+
+namespace {
+
+// the shares are not necessarily aligned to T in the messages
+template <typename T>
+void AddShares(std::span<std::uint8_t> values, std::span<const std::uint8_t> shares) {
+  for (std::size_t i = 0; i + sizeof(T) <= values.size(); i += sizeof(T)) {
+    T value, share;
+    std::memcpy(&value, values.data() + i, sizeof(T));
+    std::memcpy(&share, shares.data() + i, sizeof(T));
+    value += share;
+    std::memcpy(values.data() + i, &value, sizeof(T));
+  }
+}
+
+}  // namespace
+
+OutputBatcher::OutputBatcher(communication::CommunicationLayer& communication_layer)
+    : communication_layer_(communication_layer) {}
+
+OutputBatcher::~OutputBatcher() {}
+
+OutputBatcher::OutputPosition OutputBatcher::AssignOutput(std::size_t layer, std::size_t bit_size,
+                                                          std::size_t output_owner,
+                                                          std::size_t number_of_bytes) {
+  assert(output_batching_);
+  auto [iterator, inserted] =
+      group_indices_.try_emplace({layer, bit_size, output_owner}, output_groups_.size());
+  if (inserted) {
+    auto& group{*output_groups_.emplace_back(std::make_unique<OutputGroup>())};
+    group.message_id = next_message_id_++;
+    group.bit_size = bit_size;
+    group.output_owner = output_owner;
+    group.is_my_output = output_owner == kAll || output_owner == communication_layer_.GetMyId();
+    if (group.is_my_output) {
+      group.message_futures = communication_layer_.GetMessageManager().RegisterReceiveAll(
+          communication::MessageType::kBatchedOutput, group.message_id);
+    }
+  }
+  auto& group{*output_groups_.at(iterator->second)};
+  OutputPosition position{iterator->second, group.number_of_bytes};
+  group.number_of_bytes += number_of_bytes;
+  ++group.number_of_gates;
+  return position;
+}
+
+std::vector<std::uint8_t> OutputBatcher::Reconstruct(const OutputPosition& position,
+                                                     std::span<const std::uint8_t> shares) {
+  assert(position.group_index < output_groups_.size());
+  auto& group{*output_groups_[position.group_index]};
+  std::unique_lock lock(group.mutex);
+  assert(position.offset + shares.size() <= group.number_of_bytes);
+  if (!group.buffer) {
+    group.buffer = std::shared_ptr<std::uint8_t[]>(new std::uint8_t[group.number_of_bytes]);
+  }
+  std::memcpy(group.buffer.get() + position.offset, shares.data(), shares.size());
+  assert(group.number_of_deposited_gates < group.number_of_gates);
+  if (++group.number_of_deposited_gates == group.number_of_gates) {
+    if constexpr (kDebug) {
+      communication_layer_.GetLogger()->LogDebug(
+          fmt::format("Send batched output #{} of {} output gates ({} B)", position.group_index,
+                      group.number_of_gates, group.number_of_bytes));
+    }
+    // the shares are not modified anymore, so they can be sent while we keep them for combining
+    std::span payload(static_cast<const std::uint8_t*>(group.buffer.get()), group.number_of_bytes);
+    std::shared_ptr<const std::uint8_t[]> payload_owner(group.buffer);
+    if (group.output_owner == kAll) {
+      communication_layer_.BroadcastMessage(communication::MessageType::kBatchedOutput,
+                                            group.message_id, payload, std::move(payload_owner));
+    } else if (!group.is_my_output) {
+      communication_layer_.SendMessage(group.output_owner,
+                                       communication::MessageType::kBatchedOutput,
+                                       group.message_id, payload, std::move(payload_owner));
+    }
+    if (!group.is_my_output) {
+      // prepare the group for another evaluation of the circuit, see Backend::Clear
+      group.buffer.reset();
+      group.number_of_deposited_gates = 0;
+      return {};
+    }
+    group.deposited_condition.notify_all();
+  } else if (!group.is_my_output) {
+    return {};
+  } else {
+    group.deposited_condition.wait(
+        lock, [&group] { return group.number_of_deposited_gates == group.number_of_gates; });
+  }
+
+  if (!group.reconstructed) {
+    Combine(group);
+    group.reconstructed = true;
+  }
+
+  const auto begin{group.values.begin() + position.offset};
+  std::vector<std::uint8_t> result(begin, begin + shares.size());
+  assert(group.number_of_reconstructed_gates < group.number_of_gates);
+  if (++group.number_of_reconstructed_gates == group.number_of_gates) {
+    // prepare the group for another evaluation of the circuit, see Backend::Clear
+    group.values = std::vector<std::uint8_t>();
+    group.number_of_deposited_gates = 0;
+    group.number_of_reconstructed_gates = 0;
+    group.reconstructed = false;
+  }
+  return result;
+}
+
+void OutputBatcher::Combine(OutputGroup& group) {
+  group.values.assign(group.buffer.get(), group.buffer.get() + group.number_of_bytes);
+  group.buffer.reset();
+  std::span<std::uint8_t> values(group.values);
+  for (auto& message_future : group.message_futures) {
+    const auto message{message_future.get()};
+    const auto payload{communication::GetMessage(message.data())->payload()};
+    assert(payload->size() == group.number_of_bytes);
+    std::span<const std::uint8_t> shares(payload->data(), payload->size());
+    switch (group.bit_size) {
+      case kBoolean:
+        for (std::size_t i = 0; i < values.size(); ++i) values[i] ^= shares[i];
+        break;
+      case 8:
+        AddShares<std::uint8_t>(values, shares);
+        break;
+      case 16:
+        AddShares<std::uint16_t>(values, shares);
+        break;
+      case 32:
+        AddShares<std::uint32_t>(values, shares);
+        break;
+      case 64:
+        AddShares<std::uint64_t>(values, shares);
+        break;
+      case 128:
+        AddShares<__uint128_t>(values, shares);
+        break;
+      default:
+        assert(false);
+    }
+  }
+}
+
+void OutputBatcher::Reset() {
+  output_groups_.clear();
+  group_indices_.clear();
+}
+
+}  // namespace encrypto::motion::proto
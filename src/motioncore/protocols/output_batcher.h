@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::communication {
+
+class CommunicationLayer;
+
+}  // namespace encrypto::motion::communication
+
+namespace encrypto::motion::proto {
+
+/// \brief Reconstructs the outputs of the Boolean and arithmetic GMW output gates of one circuit
+/// layer together.  Instead of one message per output gate and peer, the shares of all output
+/// gates of the same layer, sharing and output owner are collected in a group, which is sent in a
+/// single kBatchedOutput message as soon as all of its gates deposited their shares, and
+/// reconstructed at once.  Works like the batched openings of arithmetic_gmw::Provider.
+class OutputBatcher {
+ public:
+  using future_type = ReusableFiberFuture<std::vector<std::uint8_t>>;
+
+  /// \brief Bit size of the Boolean GMW shares, which are reconstructed by XOR instead of by
+  /// addition.
+  static constexpr std::size_t kBoolean{1};
+
+  /// \brief Output owner of outputs that are reconstructed by all parties.
+  static constexpr std::size_t kAll{std::numeric_limits<std::int64_t>::max()};
+
+  OutputBatcher(communication::CommunicationLayer& communication_layer);
+  ~OutputBatcher();
+
+  /// \brief Enables batching of the output gates, see Register::GetGateLayers.  The gates of a
+  /// group wait for each other, so all output gates of a layer need to be evaluated concurrently,
+  /// which excludes dead gate elimination and limiting the instances in flight of compiled
+  /// circuits.  Needs to be set to the same value by all parties before constructing the circuit.
+  void SetOutputBatching(bool value = true) { output_batching_ = value; }
+
+  bool GetOutputBatching() const noexcept { return output_batching_; }
+
+  /// \brief Position of the shares of an output gate in the batched outputs.
+  struct OutputPosition {
+    std::size_t group_index;
+    // in bytes
+    std::size_t offset;
+  };
+
+  /// \brief Assigns the shares of a newly constructed output gate of \p number_of_bytes bytes in
+  /// circuit layer \p layer to the group of the layer, \p bit_size and \p output_owner, where
+  /// \p bit_size is kBoolean for Boolean GMW shares and the bit size of the arithmetic GMW shares
+  /// otherwise.
+  OutputPosition AssignOutput(std::size_t layer, std::size_t bit_size, std::size_t output_owner,
+                              std::size_t number_of_bytes);
+
+  /// \brief Deposits the shares of a gate and sends the group if all of its gates are done.  If
+  /// the output is ours, waits until all shares are received and returns the reconstructed bytes at
+  /// \p position, otherwise returns an empty vector right away.
+  std::vector<std::uint8_t> Reconstruct(const OutputPosition& position,
+                                        std::span<const std::uint8_t> shares);
+
+  /// \brief Forgets the groups of the gates, see Backend::Reset.
+  void Reset();
+
+ private:
+  struct OutputGroup {
+    // message ids are not reused after Reset, s.t. late registrations do not mix up groups
+    std::size_t message_id{0};
+    std::size_t bit_size{0};
+    std::size_t output_owner{0};
+    bool is_my_output{false};
+    std::size_t number_of_bytes{0};
+    std::size_t number_of_gates{0};
+    std::size_t number_of_deposited_gates{0};
+    std::size_t number_of_reconstructed_gates{0};
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable deposited_condition;
+    // our shares, kept until they are reconstructed
+    std::shared_ptr<std::uint8_t[]> buffer;
+    // shares of the other parties
+    std::vector<future_type> message_futures;
+    // reconstructed values
+    std::vector<std::uint8_t> values;
+    bool reconstructed{false};
+  };
+
+  // adds or xors the shares of the other parties to our shares in group.buffer
+  void Combine(OutputGroup& group);
+
+  bool output_batching_{false};
+
+  // groups are only appended while constructing the circuit, so no synchronization is needed
+  std::vector<std::unique_ptr<OutputGroup>> output_groups_;
+
+  // (layer, bit size, output owner) -> index of the group in output_groups_
+  std::map<std::tuple<std::size_t, std::size_t, std::size_t>, std::size_t> group_indices_;
+
+  std::size_t next_message_id_{0};
+
+  communication::CommunicationLayer& communication_layer_;
+};
+
+}  // namespace encrypto::motion::proto
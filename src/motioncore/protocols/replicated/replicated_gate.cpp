@@ -0,0 +1,745 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "replicated_gate.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/motion_base_provider.h"
+#include "base/register.h"
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_manager.h"
+#include "primitives/sharing_randomness_generator.h"
+#include "utility/helpers.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion::proto::replicated {
+
+namespace {
+
+constexpr std::size_t kNumberOfParties{3};
+
+std::size_t Next(std::size_t party_id) { return (party_id + 1) % kNumberOfParties; }
+
+std::size_t Previous(std::size_t party_id) {
+  return (party_id + kNumberOfParties - 1) % kNumberOfParties;
+}
+
+void CheckNumberOfParties(communication::CommunicationLayer& communication_layer) {
+  if (communication_layer.GetNumberOfParties() != kNumberOfParties) {
+    throw std::invalid_argument(
+        fmt::format("The replicated secret sharing requires exactly {} parties, but there are {}",
+                    kNumberOfParties, communication_layer.GetNumberOfParties()));
+  }
+}
+
+void CheckOutputOwner(std::size_t output_owner) {
+  if (output_owner >= kNumberOfParties && output_owner != kAll) {
+    throw std::invalid_argument(
+        fmt::format("Invalid output owner: {} of {}", output_owner, kNumberOfParties));
+  }
+}
+
+template <typename T>
+std::vector<T> ValuesFromMessage(const std::vector<std::uint8_t>& message) {
+  auto payload{communication::GetMessage(message.data())->payload()};
+  return FromByteVector<T>({payload->data(), payload->size()});
+}
+
+// concatenates the bits of all wires, s.t. a single message suffices
+std::vector<std::uint8_t> ToPayload(const std::vector<BitVector<>>& bits) {
+  BitVector<> buffer;
+  for (const auto& wire_bits : bits) buffer.Append(wire_bits);
+  const auto* pointer{reinterpret_cast<const std::uint8_t*>(buffer.GetData().data())};
+  return {pointer, pointer + buffer.GetData().size()};
+}
+
+std::vector<BitVector<>> BitsFromMessage(const std::vector<std::uint8_t>& message,
+                                         std::size_t number_of_wires,
+                                         std::size_t number_of_simd) {
+  auto payload{communication::GetMessage(message.data())->payload()};
+  assert(payload->size() * 8 >= number_of_wires * number_of_simd);
+  BitSpan bit_span(const_cast<std::uint8_t*>(payload->data()), number_of_wires * number_of_simd);
+  std::vector<BitVector<>> result;
+  result.reserve(number_of_wires);
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    result.emplace_back(bit_span.Subset(j * number_of_simd, (j + 1) * number_of_simd));
+  }
+  return result;
+}
+
+std::vector<BitVector<>> SplitBits(const BitVector<>& bits, std::size_t number_of_wires) {
+  assert(bits.GetSize() % number_of_wires == 0);
+  const std::size_t number_of_simd{bits.GetSize() / number_of_wires};
+  std::vector<BitVector<>> result;
+  result.reserve(number_of_wires);
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    result.emplace_back(bits.Subset(j * number_of_simd, (j + 1) * number_of_simd));
+  }
+  return result;
+}
+
+template <typename T>
+ArithmeticWirePointer<T> CastArithmeticWire(const motion::SharePointer& share) {
+  assert(share);
+  auto wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(share->GetWires().at(0))};
+  if (!wire) {
+    throw std::invalid_argument(
+        fmt::format("Expected an arithmetic replicated share of {}-bit values, got a share of "
+                    "protocol {}",
+                    sizeof(T) * 8, to_string(share->GetProtocol())));
+  }
+  return wire;
+}
+
+void CheckBooleanWires(const std::vector<motion::WirePointer>& wires) {
+  if (wires.empty()) {
+    throw std::invalid_argument("Trying to construct a Boolean replicated gate with no wires");
+  }
+  for (const auto& wire : wires) {
+    if (wire->GetProtocol() != MpcProtocol::kBooleanReplicated) {
+      throw std::invalid_argument(
+          fmt::format("Expected a Boolean replicated share, got a share of protocol {}",
+                      to_string(wire->GetProtocol())));
+    }
+  }
+}
+
+std::vector<motion::WirePointer> MakeBooleanWires(Register& _register, Backend& backend,
+                                                  std::size_t number_of_wires,
+                                                  std::size_t number_of_simd) {
+  std::vector<motion::WirePointer> wires;
+  wires.reserve(number_of_wires);
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    wires.emplace_back(_register.EmplaceWire<BooleanWire>(backend, number_of_simd));
+  }
+  return wires;
+}
+
+}  // namespace
+
+template <typename T>
+std::vector<T> ArithmeticZeroSharing(Backend& backend, std::size_t sharing_id,
+                                     std::size_t number_of_values) {
+  auto& base_provider{backend.GetBaseProvider()};
+  const auto my_id{backend.GetCommunicationLayer().GetMyId()};
+  auto mine{base_provider.GetMyRandomnessGenerator(Next(my_id))
+                .template GetUnsigned<T>(sharing_id, number_of_values)};
+  auto theirs{base_provider.GetTheirRandomnessGenerator(Previous(my_id))
+                  .template GetUnsigned<T>(sharing_id, number_of_values)};
+  return SubVectors<T>(mine, theirs);
+}
+
+template std::vector<std::uint8_t> ArithmeticZeroSharing(Backend&, std::size_t, std::size_t);
+template std::vector<std::uint16_t> ArithmeticZeroSharing(Backend&, std::size_t, std::size_t);
+template std::vector<std::uint32_t> ArithmeticZeroSharing(Backend&, std::size_t, std::size_t);
+template std::vector<std::uint64_t> ArithmeticZeroSharing(Backend&, std::size_t, std::size_t);
+template std::vector<__uint128_t> ArithmeticZeroSharing(Backend&, std::size_t, std::size_t);
+
+BitVector<> BooleanZeroSharing(Backend& backend, std::size_t sharing_id,
+                               std::size_t number_of_bits) {
+  auto& base_provider{backend.GetBaseProvider()};
+  const auto my_id{backend.GetCommunicationLayer().GetMyId()};
+  return base_provider.GetMyRandomnessGenerator(Next(my_id)).GetBits(sharing_id, number_of_bits) ^
+         base_provider.GetTheirRandomnessGenerator(Previous(my_id))
+             .GetBits(sharing_id, number_of_bits);
+}
+
+template <typename T>
+ArithmeticInputGate<T>::ArithmeticInputGate(std::vector<T> input, std::size_t input_owner,
+                                            Backend& backend)
+    : Base(backend), input_(std::move(input)) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  if (input_owner >= kNumberOfParties) {
+    throw std::invalid_argument(
+        fmt::format("Invalid input owner: {} of {}", input_owner, kNumberOfParties));
+  }
+  input_owner_id_ = input_owner;
+
+  sharing_id_ = GetRegister().NextArithmeticSharingId(input_.size());
+  output_wires_ = {
+      GetRegister().template EmplaceWire<ArithmeticWire<T>>(backend_, input_.size())};
+
+  if (communication_layer.GetMyId() != input_owner) {
+    input_future_ = communication_layer.GetMessageManager().RegisterReceive(
+        input_owner, communication::MessageType::kReplicatedInputGate, gate_id_);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a replicated::ArithmeticInputGate<uint{}_t> with id#{}, owner {}",
+                         sizeof(T) * 8, gate_id_, input_owner_id_);
+  }
+}
+
+template <typename T>
+void ArithmeticInputGate<T>::EvaluateOnline() {
+  GetBaseProvider().WaitSetup();
+
+  auto& communication_layer{GetCommunicationLayer()};
+  auto& base_provider{GetBaseProvider()};
+  const auto my_id{communication_layer.GetMyId()};
+  const auto input_owner{static_cast<std::size_t>(input_owner_id_)};
+  const auto number_of_simd{input_.size()};
+
+  auto out_wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(out_wire);
+  auto& values{out_wire->GetMutableValues()};
+  auto& next_values{out_wire->GetMutableNextValues()};
+
+  // x_p and x_{p+1} of the input owner p are derived from the seeds it shares with the others
+  if (my_id == input_owner) {
+    values = base_provider.GetTheirRandomnessGenerator(Previous(my_id))
+                 .template GetUnsigned<T>(sharing_id_, number_of_simd);
+    next_values = base_provider.GetMyRandomnessGenerator(Next(my_id))
+                      .template GetUnsigned<T>(sharing_id_, number_of_simd);
+    std::vector<T> last_values(number_of_simd);
+    for (std::size_t i = 0; i < number_of_simd; ++i) {
+      last_values[i] = input_[i] - values[i] - next_values[i];
+    }
+    auto payload{ToByteVector<T>(last_values)};
+    auto message{communication::BuildMessage(communication::MessageType::kReplicatedInputGate,
+                                             gate_id_, payload)};
+    communication_layer.BroadcastMessage(message.Release());
+  } else if (my_id == Next(input_owner)) {
+    values = base_provider.GetTheirRandomnessGenerator(input_owner)
+                 .template GetUnsigned<T>(sharing_id_, number_of_simd);
+    next_values = ValuesFromMessage<T>(input_future_.get());
+  } else {
+    values = ValuesFromMessage<T>(input_future_.get());
+    next_values = base_provider.GetMyRandomnessGenerator(input_owner)
+                      .template GetUnsigned<T>(sharing_id_, number_of_simd);
+  }
+  assert(values.size() == number_of_simd && next_values.size() == number_of_simd);
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::ArithmeticInputGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+ArithmeticSharePointer<T> ArithmeticInputGate<T>::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<ArithmeticShare<T>>(output_wires_.at(0));
+}
+
+template class ArithmeticInputGate<std::uint8_t>;
+template class ArithmeticInputGate<std::uint16_t>;
+template class ArithmeticInputGate<std::uint32_t>;
+template class ArithmeticInputGate<std::uint64_t>;
+template class ArithmeticInputGate<__uint128_t>;
+
+template <typename T>
+ArithmeticOutputGate<T>::ArithmeticOutputGate(const ArithmeticWirePointer<T>& parent,
+                                              std::size_t output_owner)
+    : Base((assert(parent), parent->GetBackend())) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  CheckOutputOwner(output_owner);
+
+  parent_ = {parent};
+  output_owner_ = output_owner;
+  output_wires_ = {GetRegister().template EmplaceWire<ArithmeticWire<T>>(
+      backend_, parent->GetNumberOfSimdValues())};
+
+  const auto my_id{communication_layer.GetMyId()};
+  if (output_owner == kAll || output_owner == my_id) {
+    output_future_ = communication_layer.GetMessageManager().RegisterReceive(
+        Next(my_id), communication::MessageType::kReplicatedOutputGate, gate_id_);
+  }
+}
+
+template <typename T>
+ArithmeticOutputGate<T>::ArithmeticOutputGate(const motion::SharePointer& parent,
+                                              std::size_t output_owner)
+    : ArithmeticOutputGate(CastArithmeticWire<T>(parent), output_owner) {}
+
+template <typename T>
+void ArithmeticOutputGate<T>::EvaluateOnline() {
+  parent_.at(0)->GetIsReadyCondition().Wait();
+  auto parent{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_.at(0))};
+  assert(parent);
+
+  auto& communication_layer{GetCommunicationLayer()};
+  const auto my_id{communication_layer.GetMyId()};
+  const auto output_owner{static_cast<std::size_t>(output_owner_)};
+
+  // party i - 1 misses x_{i+1}, which is our next share
+  if (output_owner == kAll || output_owner == Previous(my_id)) {
+    auto payload{ToByteVector<T>(parent->GetNextValues())};
+    auto message{communication::BuildMessage(communication::MessageType::kReplicatedOutputGate,
+                                             gate_id_, payload)};
+    communication_layer.SendMessage(Previous(my_id), message.Release());
+  }
+
+  auto out_wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(out_wire);
+  const auto number_of_simd{parent->GetNumberOfSimdValues()};
+  if (output_owner == kAll || output_owner == my_id) {
+    auto last_values{ValuesFromMessage<T>(output_future_.get())};
+    assert(last_values.size() == number_of_simd);
+    std::vector<T> output(number_of_simd);
+    for (std::size_t i = 0; i < number_of_simd; ++i) {
+      output[i] = parent->GetValues()[i] + parent->GetNextValues()[i] + last_values[i];
+    }
+    out_wire->GetMutableValues() = std::move(output);
+  } else {
+    out_wire->GetMutableValues() = std::vector<T>(number_of_simd);
+  }
+  out_wire->GetMutableNextValues() = std::vector<T>(number_of_simd);
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::ArithmeticOutputGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+ArithmeticSharePointer<T> ArithmeticOutputGate<T>::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<ArithmeticShare<T>>(output_wires_.at(0));
+}
+
+template class ArithmeticOutputGate<std::uint8_t>;
+template class ArithmeticOutputGate<std::uint16_t>;
+template class ArithmeticOutputGate<std::uint32_t>;
+template class ArithmeticOutputGate<std::uint64_t>;
+template class ArithmeticOutputGate<__uint128_t>;
+
+template <typename T>
+AdditionGate<T>::AdditionGate(const ArithmeticWirePointer<T>& a, const ArithmeticWirePointer<T>& b)
+    : Base((assert(a), a->GetBackend())) {
+  CheckNumberOfParties(GetCommunicationLayer());
+  assert(b && a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+  parent_a_ = {a};
+  parent_b_ = {b};
+  output_wires_ = {
+      GetRegister().template EmplaceWire<ArithmeticWire<T>>(backend_, a->GetNumberOfSimdValues())};
+}
+
+template <typename T>
+void AdditionGate<T>::EvaluateOnline() {
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+  auto wire_a{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_a_.at(0))};
+  auto wire_b{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_b_.at(0))};
+  assert(wire_a && wire_b);
+
+  auto out_wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(out_wire);
+  out_wire->GetMutableValues() = AddVectors<T>(wire_a->GetValues(), wire_b->GetValues());
+  out_wire->GetMutableNextValues() =
+      AddVectors<T>(wire_a->GetNextValues(), wire_b->GetNextValues());
+}
+
+template <typename T>
+ArithmeticSharePointer<T> AdditionGate<T>::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<ArithmeticShare<T>>(output_wires_.at(0));
+}
+
+template class AdditionGate<std::uint8_t>;
+template class AdditionGate<std::uint16_t>;
+template class AdditionGate<std::uint32_t>;
+template class AdditionGate<std::uint64_t>;
+template class AdditionGate<__uint128_t>;
+
+template <typename T>
+SubtractionGate<T>::SubtractionGate(const ArithmeticWirePointer<T>& a,
+                                    const ArithmeticWirePointer<T>& b)
+    : Base((assert(a), a->GetBackend())) {
+  CheckNumberOfParties(GetCommunicationLayer());
+  assert(b && a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+  parent_a_ = {a};
+  parent_b_ = {b};
+  output_wires_ = {
+      GetRegister().template EmplaceWire<ArithmeticWire<T>>(backend_, a->GetNumberOfSimdValues())};
+}
+
+template <typename T>
+void SubtractionGate<T>::EvaluateOnline() {
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+  auto wire_a{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_a_.at(0))};
+  auto wire_b{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_b_.at(0))};
+  assert(wire_a && wire_b);
+
+  auto out_wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(out_wire);
+  out_wire->GetMutableValues() = SubVectors<T>(wire_a->GetValues(), wire_b->GetValues());
+  out_wire->GetMutableNextValues() =
+      SubVectors<T>(wire_a->GetNextValues(), wire_b->GetNextValues());
+}
+
+template <typename T>
+ArithmeticSharePointer<T> SubtractionGate<T>::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<ArithmeticShare<T>>(output_wires_.at(0));
+}
+
+template class SubtractionGate<std::uint8_t>;
+template class SubtractionGate<std::uint16_t>;
+template class SubtractionGate<std::uint32_t>;
+template class SubtractionGate<std::uint64_t>;
+template class SubtractionGate<__uint128_t>;
+
+template <typename T>
+MultiplicationGate<T>::MultiplicationGate(const ArithmeticWirePointer<T>& a,
+                                          const ArithmeticWirePointer<T>& b)
+    : Base((assert(a), a->GetBackend())) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  assert(b && a->GetNumberOfSimdValues() == b->GetNumberOfSimdValues());
+  parent_a_ = {a};
+  parent_b_ = {b};
+  output_wires_ = {
+      GetRegister().template EmplaceWire<ArithmeticWire<T>>(backend_, a->GetNumberOfSimdValues())};
+  sharing_id_ = GetRegister().NextArithmeticSharingId(a->GetNumberOfSimdValues());
+
+  multiply_future_ = communication_layer.GetMessageManager().RegisterReceive(
+      Next(communication_layer.GetMyId()),
+      communication::MessageType::kReplicatedMultiplicationGate, gate_id_);
+}
+
+template <typename T>
+void MultiplicationGate<T>::EvaluateOnline() {
+  parent_a_.at(0)->GetIsReadyCondition().Wait();
+  parent_b_.at(0)->GetIsReadyCondition().Wait();
+  auto wire_a{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_a_.at(0))};
+  auto wire_b{std::dynamic_pointer_cast<const ArithmeticWire<T>>(parent_b_.at(0))};
+  assert(wire_a && wire_b);
+
+  const auto number_of_simd{wire_a->GetNumberOfSimdValues()};
+  const auto& x{wire_a->GetValues()};
+  const auto& x_next{wire_a->GetNextValues()};
+  const auto& y{wire_b->GetValues()};
+  const auto& y_next{wire_b->GetNextValues()};
+
+  // the z_i of all parties form an additive sharing of x * y, which the zero sharing rerandomizes
+  std::vector<T> z{ArithmeticZeroSharing<T>(backend_, sharing_id_, number_of_simd)};
+  for (std::size_t i = 0; i < number_of_simd; ++i) {
+    z[i] += x[i] * y[i] + x[i] * y_next[i] + x_next[i] * y[i];
+  }
+
+  auto& communication_layer{GetCommunicationLayer()};
+  auto payload{ToByteVector<T>(z)};
+  auto message{communication::BuildMessage(
+      communication::MessageType::kReplicatedMultiplicationGate, gate_id_, payload)};
+  communication_layer.SendMessage(Previous(communication_layer.GetMyId()), message.Release());
+
+  auto out_wire{std::dynamic_pointer_cast<ArithmeticWire<T>>(output_wires_.at(0))};
+  assert(out_wire);
+  out_wire->GetMutableValues() = std::move(z);
+  out_wire->GetMutableNextValues() = ValuesFromMessage<T>(multiply_future_.get());
+  assert(out_wire->GetNextValues().size() == number_of_simd);
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::MultiplicationGate with id#{}", gate_id_);
+  }
+}
+
+template <typename T>
+ArithmeticSharePointer<T> MultiplicationGate<T>::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<ArithmeticShare<T>>(output_wires_.at(0));
+}
+
+template class MultiplicationGate<std::uint8_t>;
+template class MultiplicationGate<std::uint16_t>;
+template class MultiplicationGate<std::uint32_t>;
+template class MultiplicationGate<std::uint64_t>;
+template class MultiplicationGate<__uint128_t>;
+
+BooleanInputGate::BooleanInputGate(std::vector<BitVector<>> input, std::size_t input_owner,
+                                   Backend& backend)
+    : Base(backend), input_(std::move(input)) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  if (input_owner >= kNumberOfParties) {
+    throw std::invalid_argument(
+        fmt::format("Invalid input owner: {} of {}", input_owner, kNumberOfParties));
+  }
+  if (input_.empty() || input_.at(0).GetSize() == 0 ||
+      !BitVector<>::IsEqualSizeDimensions(input_)) {
+    throw std::invalid_argument(
+        "A Boolean replicated input needs at least one wire and equal SIMD lengths on all wires");
+  }
+  input_owner_id_ = input_owner;
+
+  const auto number_of_simd{input_.at(0).GetSize()};
+  sharing_id_ = GetRegister().NextBooleanGmwSharingId(input_.size() * number_of_simd);
+  output_wires_ = MakeBooleanWires(GetRegister(), backend_, input_.size(), number_of_simd);
+
+  if (communication_layer.GetMyId() != input_owner) {
+    input_future_ = communication_layer.GetMessageManager().RegisterReceive(
+        input_owner, communication::MessageType::kReplicatedInputGate, gate_id_);
+  }
+
+  if constexpr (kDebug) {
+    GetLogger().LogDebug("Created a replicated::BooleanInputGate with id#{}, owner {}", gate_id_,
+                         input_owner_id_);
+  }
+}
+
+void BooleanInputGate::EvaluateOnline() {
+  GetBaseProvider().WaitSetup();
+
+  auto& communication_layer{GetCommunicationLayer()};
+  auto& base_provider{GetBaseProvider()};
+  const auto my_id{communication_layer.GetMyId()};
+  const auto input_owner{static_cast<std::size_t>(input_owner_id_)};
+  const auto number_of_wires{input_.size()};
+  const auto number_of_simd{input_.at(0).GetSize()};
+  const auto number_of_bits{number_of_wires * number_of_simd};
+
+  std::vector<BitVector<>> values, next_values;
+  if (my_id == input_owner) {
+    values = SplitBits(base_provider.GetTheirRandomnessGenerator(Previous(my_id))
+                           .GetBits(sharing_id_, number_of_bits),
+                       number_of_wires);
+    next_values = SplitBits(
+        base_provider.GetMyRandomnessGenerator(Next(my_id)).GetBits(sharing_id_, number_of_bits),
+        number_of_wires);
+    std::vector<BitVector<>> last_values;
+    last_values.reserve(number_of_wires);
+    for (std::size_t j = 0; j < number_of_wires; ++j) {
+      last_values.emplace_back(input_[j] ^ values[j] ^ next_values[j]);
+    }
+    auto payload{ToPayload(last_values)};
+    auto message{communication::BuildMessage(communication::MessageType::kReplicatedInputGate,
+                                             gate_id_, payload)};
+    communication_layer.BroadcastMessage(message.Release());
+  } else if (my_id == Next(input_owner)) {
+    values = SplitBits(
+        base_provider.GetTheirRandomnessGenerator(input_owner).GetBits(sharing_id_, number_of_bits),
+        number_of_wires);
+    next_values = BitsFromMessage(input_future_.get(), number_of_wires, number_of_simd);
+  } else {
+    values = BitsFromMessage(input_future_.get(), number_of_wires, number_of_simd);
+    next_values = SplitBits(
+        base_provider.GetMyRandomnessGenerator(input_owner).GetBits(sharing_id_, number_of_bits),
+        number_of_wires);
+  }
+
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    auto wire{std::dynamic_pointer_cast<BooleanWire>(output_wires_.at(j))};
+    assert(wire);
+    wire->GetMutableValues() = std::move(values[j]);
+    wire->GetMutableNextValues() = std::move(next_values[j]);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::BooleanInputGate with id#{}", gate_id_);
+  }
+}
+
+BooleanSharePointer BooleanInputGate::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<BooleanShare>(output_wires_);
+}
+
+BooleanOutputGate::BooleanOutputGate(const motion::SharePointer& parent, std::size_t output_owner)
+    : Base((assert(parent), parent->GetBackend())) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  CheckOutputOwner(output_owner);
+  CheckBooleanWires(parent->GetWires());
+
+  parent_ = parent->GetWires();
+  output_owner_ = output_owner;
+  output_wires_ = MakeBooleanWires(GetRegister(), backend_, parent_.size(),
+                                   parent->GetNumberOfSimdValues());
+
+  const auto my_id{communication_layer.GetMyId()};
+  if (output_owner == kAll || output_owner == my_id) {
+    output_future_ = communication_layer.GetMessageManager().RegisterReceive(
+        Next(my_id), communication::MessageType::kReplicatedOutputGate, gate_id_);
+  }
+}
+
+void BooleanOutputGate::EvaluateOnline() {
+  for (auto& wire : parent_) wire->GetIsReadyCondition().Wait();
+
+  auto& communication_layer{GetCommunicationLayer()};
+  const auto my_id{communication_layer.GetMyId()};
+  const auto output_owner{static_cast<std::size_t>(output_owner_)};
+  const auto number_of_wires{parent_.size()};
+  const auto number_of_simd{parent_.at(0)->GetNumberOfSimdValues()};
+
+  std::vector<std::shared_ptr<const BooleanWire>> parents;
+  parents.reserve(number_of_wires);
+  for (const auto& wire : parent_) {
+    parents.emplace_back(std::dynamic_pointer_cast<const BooleanWire>(wire));
+    assert(parents.back());
+  }
+
+  // party i - 1 misses x_{i+1}, which is our next share
+  if (output_owner == kAll || output_owner == Previous(my_id)) {
+    std::vector<BitVector<>> next_values;
+    next_values.reserve(number_of_wires);
+    for (const auto& wire : parents) next_values.emplace_back(wire->GetNextValues());
+    auto payload{ToPayload(next_values)};
+    auto message{communication::BuildMessage(communication::MessageType::kReplicatedOutputGate,
+                                             gate_id_, payload)};
+    communication_layer.SendMessage(Previous(my_id), message.Release());
+  }
+
+  const bool is_my_output{output_owner == kAll || output_owner == my_id};
+  std::vector<BitVector<>> last_values;
+  if (is_my_output) {
+    last_values = BitsFromMessage(output_future_.get(), number_of_wires, number_of_simd);
+  }
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    auto out_wire{std::dynamic_pointer_cast<BooleanWire>(output_wires_.at(j))};
+    assert(out_wire);
+    out_wire->GetMutableValues() =
+        is_my_output ? parents[j]->GetValues() ^ parents[j]->GetNextValues() ^ last_values[j]
+                     : BitVector<>(number_of_simd);
+    out_wire->GetMutableNextValues() = BitVector<>(number_of_simd);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::BooleanOutputGate with id#{}", gate_id_);
+  }
+}
+
+BooleanSharePointer BooleanOutputGate::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<BooleanShare>(output_wires_);
+}
+
+XorGate::XorGate(const motion::SharePointer& a, const motion::SharePointer& b)
+    : Base((assert(a), a->GetBackend())) {
+  CheckNumberOfParties(GetCommunicationLayer());
+  CheckBooleanWires(a->GetWires());
+  CheckBooleanWires(b->GetWires());
+  assert(a->GetWires().size() == b->GetWires().size());
+  parent_a_ = a->GetWires();
+  parent_b_ = b->GetWires();
+  output_wires_ =
+      MakeBooleanWires(GetRegister(), backend_, parent_a_.size(), a->GetNumberOfSimdValues());
+}
+
+void XorGate::EvaluateOnline() {
+  for (auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  for (auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
+
+  for (std::size_t j = 0; j < parent_a_.size(); ++j) {
+    auto wire_a{std::dynamic_pointer_cast<const BooleanWire>(parent_a_.at(j))};
+    auto wire_b{std::dynamic_pointer_cast<const BooleanWire>(parent_b_.at(j))};
+    auto out_wire{std::dynamic_pointer_cast<BooleanWire>(output_wires_.at(j))};
+    assert(wire_a && wire_b && out_wire);
+    out_wire->GetMutableValues() = wire_a->GetValues() ^ wire_b->GetValues();
+    out_wire->GetMutableNextValues() = wire_a->GetNextValues() ^ wire_b->GetNextValues();
+  }
+}
+
+BooleanSharePointer XorGate::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<BooleanShare>(output_wires_);
+}
+
+InvGate::InvGate(const motion::SharePointer& parent)
+    : Base((assert(parent), parent->GetBackend())) {
+  CheckNumberOfParties(GetCommunicationLayer());
+  CheckBooleanWires(parent->GetWires());
+  parent_ = parent->GetWires();
+  output_wires_ =
+      MakeBooleanWires(GetRegister(), backend_, parent_.size(), parent->GetNumberOfSimdValues());
+}
+
+void InvGate::EvaluateOnline() {
+  const auto my_id{GetCommunicationLayer().GetMyId()};
+  for (std::size_t j = 0; j < parent_.size(); ++j) {
+    parent_.at(j)->GetIsReadyCondition().Wait();
+    auto wire{std::dynamic_pointer_cast<const BooleanWire>(parent_.at(j))};
+    auto out_wire{std::dynamic_pointer_cast<BooleanWire>(output_wires_.at(j))};
+    assert(wire && out_wire);
+    // x_0 is held by party 0 as its values and by party 2 as its next values
+    out_wire->GetMutableValues() = my_id == 0 ? ~wire->GetValues() : wire->GetValues();
+    out_wire->GetMutableNextValues() =
+        my_id == 2 ? ~wire->GetNextValues() : wire->GetNextValues();
+  }
+}
+
+BooleanSharePointer InvGate::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<BooleanShare>(output_wires_);
+}
+
+AndGate::AndGate(const motion::SharePointer& a, const motion::SharePointer& b)
+    : Base((assert(a), a->GetBackend())) {
+  auto& communication_layer{GetCommunicationLayer()};
+  CheckNumberOfParties(communication_layer);
+  CheckBooleanWires(a->GetWires());
+  CheckBooleanWires(b->GetWires());
+  assert(a->GetWires().size() == b->GetWires().size());
+  parent_a_ = a->GetWires();
+  parent_b_ = b->GetWires();
+  output_wires_ =
+      MakeBooleanWires(GetRegister(), backend_, parent_a_.size(), a->GetNumberOfSimdValues());
+  sharing_id_ =
+      GetRegister().NextBooleanGmwSharingId(parent_a_.size() * a->GetNumberOfSimdValues());
+
+  and_future_ = communication_layer.GetMessageManager().RegisterReceive(
+      Next(communication_layer.GetMyId()),
+      communication::MessageType::kReplicatedMultiplicationGate, gate_id_);
+}
+
+void AndGate::EvaluateOnline() {
+  for (auto& wire : parent_a_) wire->GetIsReadyCondition().Wait();
+  for (auto& wire : parent_b_) wire->GetIsReadyCondition().Wait();
+
+  const auto number_of_wires{parent_a_.size()};
+  const auto number_of_simd{parent_a_.at(0)->GetNumberOfSimdValues()};
+  auto z{SplitBits(BooleanZeroSharing(backend_, sharing_id_, number_of_wires * number_of_simd),
+                   number_of_wires)};
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    auto wire_a{std::dynamic_pointer_cast<const BooleanWire>(parent_a_.at(j))};
+    auto wire_b{std::dynamic_pointer_cast<const BooleanWire>(parent_b_.at(j))};
+    assert(wire_a && wire_b);
+    const auto& x{wire_a->GetValues()};
+    const auto& y{wire_b->GetValues()};
+    z[j] ^= (x & y) ^ (x & wire_b->GetNextValues()) ^ (wire_a->GetNextValues() & y);
+  }
+
+  auto& communication_layer{GetCommunicationLayer()};
+  auto payload{ToPayload(z)};
+  auto message{communication::BuildMessage(
+      communication::MessageType::kReplicatedMultiplicationGate, gate_id_, payload)};
+  communication_layer.SendMessage(Previous(communication_layer.GetMyId()), message.Release());
+
+  auto z_next{BitsFromMessage(and_future_.get(), number_of_wires, number_of_simd)};
+  for (std::size_t j = 0; j < number_of_wires; ++j) {
+    auto out_wire{std::dynamic_pointer_cast<BooleanWire>(output_wires_.at(j))};
+    assert(out_wire);
+    out_wire->GetMutableValues() = std::move(z[j]);
+    out_wire->GetMutableNextValues() = std::move(z_next[j]);
+  }
+
+  if constexpr (kVerboseDebug) {
+    GetLogger().LogTrace("Evaluated replicated::AndGate with id#{}", gate_id_);
+  }
+}
+
+BooleanSharePointer AndGate::GetOutputAsReplicatedShare() {
+  return backend_.GetRegister()->EmplaceShared<BooleanShare>(output_wires_);
+}
+
+}  // namespace encrypto::motion::proto::replicated
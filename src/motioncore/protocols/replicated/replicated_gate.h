@@ -0,0 +1,281 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "protocols/gate.h"
+#include "replicated_share.h"
+#include "utility/bit_vector.h"
+#include "utility/reusable_future.h"
+
+namespace encrypto::motion::proto::replicated {
+
+constexpr std::size_t kAll = std::numeric_limits<std::int64_t>::max();
+
+// All gates of the replicated secret sharing require exactly 3 parties and throw an
+// std::invalid_argument otherwise.  Randomness is derived from the pairwise seeds of the base
+// provider, so none of the gates needs a setup phase.
+
+/// \brief Returns party i's share alpha_i = r_{i,i+1} - r_{i-1,i} of zero, where r_{j,j+1} is
+/// derived from the seed of party j shared with party j + 1, s.t. alpha_0 + alpha_1 + alpha_2 = 0.
+template <typename T>
+std::vector<T> ArithmeticZeroSharing(Backend& backend, std::size_t sharing_id,
+                                     std::size_t number_of_values);
+
+/// \brief Boolean counterpart of ArithmeticZeroSharing with XOR.
+BitVector<> BooleanZeroSharing(Backend& backend, std::size_t sharing_id,
+                               std::size_t number_of_bits);
+
+/// \brief The input owner p derives x_p and x_{p+1} from the seeds it shares with parties p + 2
+/// resp. p + 1 and sends x_{p+2} = x - x_p - x_{p+1} to both other parties.
+template <typename T>
+class ArithmeticInputGate final : public motion::InputGate {
+  using Base = motion::InputGate;
+
+ public:
+  ArithmeticInputGate(std::vector<T> input, std::size_t input_owner, Backend& backend);
+
+  ~ArithmeticInputGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  ArithmeticSharePointer<T> GetOutputAsReplicatedShare();
+
+ private:
+  std::vector<T> input_;
+  std::size_t sharing_id_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> input_future_;
+};
+
+/// \brief Party i + 1 sends x_{i+2} to party i, which completes the shares of party i.
+template <typename T>
+class ArithmeticOutputGate final : public motion::OutputGate {
+  using Base = motion::OutputGate;
+
+ public:
+  ArithmeticOutputGate(const ArithmeticWirePointer<T>& parent, std::size_t output_owner = kAll);
+
+  ArithmeticOutputGate(const motion::SharePointer& parent, std::size_t output_owner = kAll);
+
+  ~ArithmeticOutputGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  ArithmeticSharePointer<T> GetOutputAsReplicatedShare();
+
+ private:
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> output_future_;
+};
+
+template <typename T>
+class AdditionGate final : public motion::TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  AdditionGate(const ArithmeticWirePointer<T>& a, const ArithmeticWirePointer<T>& b);
+
+  ~AdditionGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  ArithmeticSharePointer<T> GetOutputAsReplicatedShare();
+};
+
+template <typename T>
+class SubtractionGate final : public motion::TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  SubtractionGate(const ArithmeticWirePointer<T>& a, const ArithmeticWirePointer<T>& b);
+
+  ~SubtractionGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  ArithmeticSharePointer<T> GetOutputAsReplicatedShare();
+};
+
+/// \brief Party i computes z_i = x_i * y_i + x_i * y_{i+1} + x_{i+1} * y_i + alpha_i for a
+/// zero-sharing alpha, sends z_i to party i - 1 and receives z_{i+1} from party i + 1.
+template <typename T>
+class MultiplicationGate final : public motion::TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  MultiplicationGate(const ArithmeticWirePointer<T>& a, const ArithmeticWirePointer<T>& b);
+
+  ~MultiplicationGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  ArithmeticSharePointer<T> GetOutputAsReplicatedShare();
+
+ private:
+  std::size_t sharing_id_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> multiply_future_;
+};
+
+/// \brief Boolean counterpart of ArithmeticInputGate, one wire per input BitVector.
+class BooleanInputGate final : public motion::InputGate {
+  using Base = motion::InputGate;
+
+ public:
+  BooleanInputGate(std::vector<BitVector<>> input, std::size_t input_owner, Backend& backend);
+
+  ~BooleanInputGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  BooleanSharePointer GetOutputAsReplicatedShare();
+
+ private:
+  std::vector<BitVector<>> input_;
+  std::size_t sharing_id_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> input_future_;
+};
+
+class BooleanOutputGate final : public motion::OutputGate {
+  using Base = motion::OutputGate;
+
+ public:
+  BooleanOutputGate(const motion::SharePointer& parent, std::size_t output_owner = kAll);
+
+  ~BooleanOutputGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  BooleanSharePointer GetOutputAsReplicatedShare();
+
+ private:
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> output_future_;
+};
+
+class XorGate final : public motion::TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  XorGate(const motion::SharePointer& a, const motion::SharePointer& b);
+
+  ~XorGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  BooleanSharePointer GetOutputAsReplicatedShare();
+};
+
+/// \brief Inverts x_0, i.e., the values of party 0 and the next values of party 2.
+class InvGate final : public motion::OneGate {
+  using Base = motion::OneGate;
+
+ public:
+  InvGate(const motion::SharePointer& parent);
+
+  ~InvGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  bool IsLocal() const final override { return true; }
+
+  BooleanSharePointer GetOutputAsReplicatedShare();
+};
+
+/// \brief Boolean counterpart of MultiplicationGate with AND and XOR.
+class AndGate final : public motion::TwoGate {
+  using Base = motion::TwoGate;
+
+ public:
+  AndGate(const motion::SharePointer& a, const motion::SharePointer& b);
+
+  ~AndGate() final = default;
+
+  void EvaluateSetup() final override {}
+
+  void EvaluateOnline() final override;
+
+  bool NeedsSetup() const final override { return false; }
+
+  OnlineCost GetOnlineCost() const final override { return {1, GetNumberOfOutputBytes()}; }
+
+  BooleanSharePointer GetOutputAsReplicatedShare();
+
+ private:
+  std::size_t sharing_id_;
+  motion::ReusableFiberFuture<std::vector<std::uint8_t>> and_future_;
+};
+
+}  // namespace encrypto::motion::proto::replicated
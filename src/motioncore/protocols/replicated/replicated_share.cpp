@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "replicated_share.h"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion::proto::replicated {
+
+template <typename T>
+ArithmeticShare<T>::ArithmeticShare(const motion::WirePointer& wire)
+    : ArithmeticShare(std::vector<motion::WirePointer>{wire}) {}
+
+template <typename T>
+ArithmeticShare<T>::ArithmeticShare(const std::vector<motion::WirePointer>& wires)
+    : Base(wires.at(0)->GetBackend()) {
+  if (wires.size() != 1) {
+    throw std::invalid_argument(fmt::format(
+        "An arithmetic replicated share needs exactly 1 wire but got {} wires", wires.size()));
+  }
+  if (!std::dynamic_pointer_cast<ArithmeticWire<T>>(wires.at(0))) {
+    throw std::invalid_argument(
+        fmt::format("Trying to create an arithmetic replicated share of {}-bit values from a wire "
+                    "of protocol {}",
+                    sizeof(T) * 8, to_string(wires.at(0)->GetProtocol())));
+  }
+  wires_ = wires;
+}
+
+template <typename T>
+std::size_t ArithmeticShare<T>::GetNumberOfSimdValues() const noexcept {
+  return wires_.at(0)->GetNumberOfSimdValues();
+}
+
+template <typename T>
+std::vector<std::shared_ptr<motion::Share>> ArithmeticShare<T>::Split() const noexcept {
+  return {std::make_shared<ArithmeticShare<T>>(wires_)};
+}
+
+template <typename T>
+std::shared_ptr<motion::Share> ArithmeticShare<T>::GetWire(std::size_t i) const {
+  if (i >= wires_.size()) {
+    throw std::out_of_range(
+        fmt::format("Trying to access wire #{} out of {} wires", i, wires_.size()));
+  }
+  return std::make_shared<ArithmeticShare<T>>(wires_[i]);
+}
+
+template class ArithmeticShare<std::uint8_t>;
+template class ArithmeticShare<std::uint16_t>;
+template class ArithmeticShare<std::uint32_t>;
+template class ArithmeticShare<std::uint64_t>;
+template class ArithmeticShare<__uint128_t>;
+
+BooleanShare::BooleanShare(const std::vector<motion::WirePointer>& wires)
+    : motion::BooleanShare(wires.at(0)->GetBackend()) {
+  for (const auto& wire : wires) {
+    if (wire->GetProtocol() != MpcProtocol::kBooleanReplicated) {
+      throw std::invalid_argument(
+          fmt::format("Trying to create a Boolean replicated share from a wire of protocol {}",
+                      to_string(wire->GetProtocol())));
+    }
+    if (wire->GetNumberOfSimdValues() != wires.at(0)->GetNumberOfSimdValues()) {
+      throw std::invalid_argument(
+          "Trying to create a Boolean replicated share from wires of different SIMD lengths");
+    }
+  }
+  wires_ = wires;
+}
+
+std::size_t BooleanShare::GetNumberOfSimdValues() const noexcept {
+  return wires_.at(0)->GetNumberOfSimdValues();
+}
+
+std::vector<std::shared_ptr<motion::Share>> BooleanShare::Split() const noexcept {
+  std::vector<std::shared_ptr<motion::Share>> result;
+  result.reserve(wires_.size());
+  for (const auto& wire : wires_) {
+    result.emplace_back(std::make_shared<BooleanShare>(std::vector<motion::WirePointer>{wire}));
+  }
+  return result;
+}
+
+std::shared_ptr<motion::Share> BooleanShare::GetWire(std::size_t i) const {
+  if (i >= wires_.size()) {
+    throw std::out_of_range(
+        fmt::format("Trying to access wire #{} out of {} wires", i, wires_.size()));
+  }
+  return std::make_shared<BooleanShare>(std::vector<motion::WirePointer>{wires_[i]});
+}
+
+}  // namespace encrypto::motion::proto::replicated
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "protocols/share.h"
+#include "replicated_wire.h"
+
+namespace encrypto::motion::proto::replicated {
+
+template <typename T>
+class ArithmeticShare final : public motion::Share {
+  using Base = motion::Share;
+
+ public:
+  ArithmeticShare(const motion::WirePointer& wire);
+
+  ArithmeticShare(const std::vector<motion::WirePointer>& wires);
+
+  ~ArithmeticShare() override = default;
+
+  std::size_t GetNumberOfSimdValues() const noexcept final;
+
+  MpcProtocol GetProtocol() const noexcept final { return MpcProtocol::kArithmeticReplicated; }
+
+  CircuitType GetCircuitType() const noexcept final { return CircuitType::kArithmetic; }
+
+  const ArithmeticWirePointer<T> GetArithmeticWire() const {
+    auto wire = std::dynamic_pointer_cast<ArithmeticWire<T>>(wires_.at(0));
+    assert(wire);
+    return wire;
+  }
+
+  const std::vector<motion::WirePointer>& GetWires() const noexcept final { return wires_; }
+
+  std::vector<motion::WirePointer>& GetMutableWires() noexcept final { return wires_; }
+
+  std::size_t GetBitLength() const noexcept final { return sizeof(T) * 8; }
+
+  std::vector<std::shared_ptr<Base>> Split() const noexcept final;
+
+  std::shared_ptr<Base> GetWire(std::size_t i) const final;
+
+  ArithmeticShare(ArithmeticShare&) = delete;
+};
+
+template <typename T>
+using ArithmeticSharePointer = std::shared_ptr<ArithmeticShare<T>>;
+
+class BooleanShare final : public motion::BooleanShare {
+ public:
+  BooleanShare(const std::vector<motion::WirePointer>& wires);
+
+  ~BooleanShare() override = default;
+
+  std::size_t GetNumberOfSimdValues() const noexcept final;
+
+  MpcProtocol GetProtocol() const noexcept final { return MpcProtocol::kBooleanReplicated; }
+
+  CircuitType GetCircuitType() const noexcept final { return CircuitType::kBoolean; }
+
+  const std::vector<motion::WirePointer>& GetWires() const noexcept final { return wires_; }
+
+  std::vector<motion::WirePointer>& GetMutableWires() noexcept final { return wires_; }
+
+  std::size_t GetBitLength() const noexcept final { return wires_.size(); }
+
+  std::vector<std::shared_ptr<motion::Share>> Split() const noexcept final;
+
+  std::shared_ptr<motion::Share> GetWire(std::size_t i) const final;
+};
+
+using BooleanSharePointer = std::shared_ptr<BooleanShare>;
+
+}  // namespace encrypto::motion::proto::replicated
@@ -0,0 +1,58 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "replicated_wire.h"
+
+namespace encrypto::motion::proto::replicated {
+
+template <typename T>
+ArithmeticWire<T>::ArithmeticWire(Backend& backend, std::size_t number_of_simd)
+    : Base(backend, number_of_simd) {}
+
+template <typename T>
+ArithmeticWire<T>::ArithmeticWire(std::vector<T>&& values, std::vector<T>&& next_values,
+                                  Backend& backend)
+    : Base(backend, values.size()),
+      values_(std::move(values)),
+      next_values_(std::move(next_values)) {
+  assert(values_.size() == next_values_.size());
+}
+
+template class ArithmeticWire<std::uint8_t>;
+template class ArithmeticWire<std::uint16_t>;
+template class ArithmeticWire<std::uint32_t>;
+template class ArithmeticWire<std::uint64_t>;
+template class ArithmeticWire<__uint128_t>;
+
+BooleanWire::BooleanWire(Backend& backend, std::size_t number_of_simd)
+    : motion::BooleanWire(backend, number_of_simd) {}
+
+BooleanWire::BooleanWire(BitVector<>&& values, BitVector<>&& next_values, Backend& backend)
+    : motion::BooleanWire(backend, values.GetSize()),
+      values_(std::move(values)),
+      next_values_(std::move(next_values)) {
+  assert(values_.GetSize() == next_values_.GetSize());
+}
+
+}  // namespace encrypto::motion::proto::replicated
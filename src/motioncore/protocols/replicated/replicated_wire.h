@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+#include "protocols/wire.h"
+#include "utility/bit_vector.h"
+
+namespace encrypto::motion::proto::replicated {
+
+// In the 3-party replicated secret sharing, a value x is split into the shares x_0, x_1 and x_2
+// with x = x_0 + x_1 + x_2 in arithmetic circuits resp. x = x_0 ^ x_1 ^ x_2 in Boolean circuits,
+// and party i holds the pair (x_i, x_{i+1}) with indices modulo 3.  Any two parties know all
+// shares, while a single party learns nothing about x.  The values of a wire are x_i and its next
+// values are x_{i+1}, where x_i alone is an additive resp. XOR share as in GMW.
+
+template <typename T>
+class ArithmeticWire final : public motion::Wire {
+  using Base = motion::Wire;
+
+ public:
+  using value_type = T;
+
+  ArithmeticWire(Backend& backend, std::size_t number_of_simd);
+
+  ArithmeticWire(std::vector<T>&& values, std::vector<T>&& next_values, Backend& backend);
+
+  ~ArithmeticWire() final = default;
+
+  MpcProtocol GetProtocol() const final { return MpcProtocol::kArithmeticReplicated; }
+
+  CircuitType GetCircuitType() const final { return CircuitType::kArithmetic; }
+
+  const std::vector<T>& GetValues() const { return values_; }
+
+  std::vector<T>& GetMutableValues() { return values_; }
+
+  const std::vector<T>& GetNextValues() const { return next_values_; }
+
+  std::vector<T>& GetMutableNextValues() { return next_values_; }
+
+  std::size_t GetBitLength() const final { return sizeof(T) * 8; }
+
+  std::size_t GetNumberOfBytes() const final {
+    return (values_.size() + next_values_.size()) * sizeof(T);
+  }
+
+  bool IsConstant() const noexcept final { return false; }
+
+ private:
+  std::vector<T> values_, next_values_;
+};
+
+template <typename T>
+using ArithmeticWirePointer = std::shared_ptr<ArithmeticWire<T>>;
+
+class BooleanWire final : public motion::BooleanWire {
+ public:
+  BooleanWire(Backend& backend, std::size_t number_of_simd);
+
+  BooleanWire(BitVector<>&& values, BitVector<>&& next_values, Backend& backend);
+
+  ~BooleanWire() final = default;
+
+  MpcProtocol GetProtocol() const final { return MpcProtocol::kBooleanReplicated; }
+
+  std::size_t GetBitLength() const final { return 1; }
+
+  const BitVector<>& GetValues() const { return values_; }
+
+  BitVector<>& GetMutableValues() { return values_; }
+
+  const BitVector<>& GetNextValues() const { return next_values_; }
+
+  BitVector<>& GetMutableNextValues() { return next_values_; }
+
+  std::size_t GetNumberOfBytes() const final {
+    return values_.GetData().size() + next_values_.GetData().size();
+  }
+
+  bool IsConstant() const noexcept final { return false; }
+
+ private:
+  BitVector<> values_, next_values_;
+};
+
+using BooleanWirePointer = std::shared_ptr<BooleanWire>;
+
+}  // namespace encrypto::motion::proto::replicated
@@ -24,13 +24,26 @@
 
 #include "share_wrapper.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/arithmetic_algorithm_description.h"
+#include "algorithm/evaluation_template.h"
 #include "algorithm/low_depth_reduce.h"
+#include "algorithm/permutation_network.h"
 #include "base/backend.h"
+#include "base/configuration.h"
+#include "base/register.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_share.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
@@ -52,6 +65,10 @@
 #include "protocols/data_management/subset_gate.h"
 #include "protocols/data_management/unsimdify_gate.h"
 #include "protocols/garbled_circuit/garbled_circuit_provider.h"
+#include "protocols/garbled_circuit/garbled_circuit_wire.h"
+#include "protocols/replicated/replicated_gate.h"
+#include "protocols/replicated/replicated_share.h"
+#include "protocols/replicated/replicated_wire.h"
 #include "secure_type/secure_unsigned_integer.h"
 #include "share.h"
 #include "utility/bit_vector.h"
@@ -74,6 +91,186 @@ ShareWrapper ShareWrapper::operator/(const ShareWrapper& other) const {
 
 /****Modification end here****/
 
+namespace {
+
+bool IsBooleanConstant(const SharePointer& share) {
+  return share->GetProtocol() == MpcProtocol::kBooleanConstant;
+}
+
+const BitVector<>& GetConstantBits(const WirePointer& wire) {
+  auto constant_wire = std::dynamic_pointer_cast<proto::ConstantBooleanWire>(wire);
+  assert(constant_wire);
+  return constant_wire->GetValues();
+}
+
+ShareWrapper MakeConstantBooleanShare(std::vector<BitVector<>>&& values, Backend& backend) {
+  auto constant_gate{backend.GetRegister()->EmplaceGate<proto::ConstantBooleanInputGate>(
+      std::move(values), backend)};
+  return ShareWrapper(constant_gate->GetOutputAsShare());
+}
+
+// evaluates a Boolean operation on two public constants
+ShareWrapper FoldConstants(const ShareWrapper& a, const ShareWrapper& b,
+                           PrimitiveOperationType operation) {
+  assert(a->GetBitLength() == b->GetBitLength());
+  std::vector<BitVector<>> values;
+  values.reserve(a->GetBitLength());
+  for (std::size_t i = 0; i < a->GetBitLength(); ++i) {
+    const auto &a_i{GetConstantBits(a->GetWires()[i])}, &b_i{GetConstantBits(b->GetWires()[i])};
+    switch (operation) {
+      case PrimitiveOperationType::kXor:
+        values.emplace_back(a_i ^ b_i);
+        break;
+      case PrimitiveOperationType::kAnd:
+        values.emplace_back(a_i & b_i);
+        break;
+      case PrimitiveOperationType::kOr:
+        values.emplace_back(a_i | b_i);
+        break;
+      default:
+        throw std::invalid_argument("Invalid PrimitiveOperationType for folding constants");
+    }
+  }
+  return MakeConstantBooleanShare(std::move(values), a->GetBackend());
+}
+
+// Folds a Boolean operation on a non-constant share and a public constant wire by wire: XOR with
+// 0, AND with 1 and OR with 0 become wiring, XOR with 1 an INV gate, and AND with 0 and OR with 1
+// the local (x ^ x) and ~(x ^ x), s.t. the result stays in the protocol of x.  Only constants
+// whose SIMD values differ need ConstantBoolean{Xor,And}Gates, which exist for Boolean GMW.
+ShareWrapper FoldConstant(const ShareWrapper& non_constant, const ShareWrapper& constant,
+                          PrimitiveOperationType operation) {
+  assert(non_constant->GetBitLength() == constant->GetBitLength());
+  const auto x{non_constant.Split()};
+  const auto& constant_wires{constant->GetWires()};
+  const bool is_and{operation == PrimitiveOperationType::kAnd};
+  const bool is_or{operation == PrimitiveOperationType::kOr};
+
+  std::vector<ShareWrapper> output(x.size());
+  std::vector<std::size_t> inverted, zeros, ones, mixed;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    const auto& bits{GetConstantBits(constant_wires[i])};
+    const auto hamming_weight{bits.HammingWeight()};
+    if (hamming_weight != 0 && hamming_weight != bits.GetSize()) {
+      mixed.push_back(i);
+    } else if (hamming_weight == 0) {
+      if (is_and) {
+        zeros.push_back(i);
+      } else {
+        output[i] = x[i];
+      }
+    } else if (is_and) {
+      output[i] = x[i];
+    } else if (is_or) {
+      ones.push_back(i);
+    } else {
+      inverted.push_back(i);
+    }
+  }
+
+  // the result is constant and may be folded further
+  if (zeros.size() == x.size() || ones.size() == x.size()) {
+    return MakeConstantBooleanShare(
+        std::vector<BitVector<>>(x.size(),
+                                 BitVector<>(non_constant->GetNumberOfSimdValues(), is_or)),
+        non_constant->GetBackend());
+  }
+
+  const auto gather = [&x](const std::vector<std::size_t>& indices) {
+    std::vector<ShareWrapper> wires;
+    wires.reserve(indices.size());
+    for (const auto i : indices) wires.push_back(x[i]);
+    return ShareWrapper::Concatenate(wires);
+  };
+  const auto scatter = [&output](const std::vector<std::size_t>& indices,
+                                 const ShareWrapper& result) {
+    const auto wires{result.Split()};
+    for (std::size_t k = 0; k < indices.size(); ++k) output[indices[k]] = wires[k];
+  };
+
+  if (!inverted.empty()) scatter(inverted, ~gather(inverted));
+  if (!zeros.empty()) {
+    const auto x_zeros{gather(zeros)};
+    scatter(zeros, x_zeros ^ x_zeros);
+  }
+  if (!ones.empty()) {
+    const auto x_ones{gather(ones)};
+    scatter(ones, ~(x_ones ^ x_ones));
+  }
+  if (!mixed.empty()) {
+    if (non_constant->GetProtocol() != MpcProtocol::kBooleanGmw) {
+      throw std::invalid_argument(
+          "Public constants that differ between SIMD values are only supported in Boolean GMW");
+    }
+    auto& backend{non_constant->GetBackend()};
+    const auto x_mixed{gather(mixed)};
+    const auto make_constant = [&](bool invert) {
+      std::vector<BitVector<>> values;
+      values.reserve(mixed.size());
+      for (const auto i : mixed) {
+        values.emplace_back(invert ? ~GetConstantBits(constant_wires[i])
+                                   : GetConstantBits(constant_wires[i]));
+      }
+      return MakeConstantBooleanShare(std::move(values), backend);
+    };
+    const auto constant_xor = [&backend](const ShareWrapper& a, const ShareWrapper& c) {
+      return ShareWrapper(backend.GetRegister()
+                              ->EmplaceGate<proto::ConstantBooleanXorGate>(*a, *c)
+                              ->GetOutputAsShare());
+    };
+    const auto constant_and = [&backend](const ShareWrapper& a, const ShareWrapper& c) {
+      return ShareWrapper(backend.GetRegister()
+                              ->EmplaceGate<proto::ConstantBooleanAndGate>(*a, *c)
+                              ->GetOutputAsShare());
+    };
+    if (is_and) {
+      scatter(mixed, constant_and(x_mixed, make_constant(false)));
+    } else if (is_or) {
+      // x | c = (x & ~c) ^ c
+      const auto x_and_not_c{constant_and(x_mixed, make_constant(true))};
+      scatter(mixed, constant_xor(x_and_not_c, make_constant(false)));
+    } else {
+      scatter(mixed, constant_xor(x_mixed, make_constant(false)));
+    }
+  }
+  return ShareWrapper::Concatenate(output);
+}
+
+// folds a Boolean operation if at least one of its operands is a public constant
+std::optional<ShareWrapper> FoldBooleanOperation(const ShareWrapper& a, const ShareWrapper& b,
+                                                 PrimitiveOperationType operation) {
+  const bool a_is_constant{IsBooleanConstant(*a)}, b_is_constant{IsBooleanConstant(*b)};
+  if (a_is_constant && b_is_constant) return FoldConstants(a, b, operation);
+  if (a_is_constant) return FoldConstant(b, a, operation);
+  if (b_is_constant) return FoldConstant(a, b, operation);
+  return std::nullopt;
+}
+
+// converts a public constant into the protocol of the non-constant single-wire share reference
+ShareWrapper LiftConstant(const ShareWrapper& constant, const ShareWrapper& reference) {
+  assert(reference->GetBitLength() == 1);
+  const auto zero{reference ^ reference};
+  return FoldConstant(ShareWrapper::Concatenate(std::vector(constant->GetBitLength(), zero)),
+                      constant, PrimitiveOperationType::kXor);
+}
+
+// concatenates single-wire shares, where public constants are converted if they are mixed with
+// non-constant wires
+ShareWrapper ConcatenateLifted(std::vector<ShareWrapper> wires) {
+  const auto non_constant_wire{std::find_if(wires.begin(), wires.end(), [](const auto& wire) {
+    return !IsBooleanConstant(*wire);
+  })};
+  if (non_constant_wire != wires.end()) {
+    const auto reference{*non_constant_wire};
+    for (auto& wire : wires) {
+      if (IsBooleanConstant(*wire)) wire = LiftConstant(wire, reference);
+    }
+  }
+  return ShareWrapper::Concatenate(wires);
+}
+
+}  // namespace
+
 ShareWrapper ShareWrapper::operator~() const {
   assert(share_);
   if (share_->GetCircuitType() == CircuitType::kArithmetic) {
@@ -82,6 +279,12 @@ ShareWrapper ShareWrapper::operator~() const {
   }
 
   switch (share_->GetProtocol()) {
+    case MpcProtocol::kBooleanConstant: {
+      std::vector<BitVector<>> values;
+      values.reserve(share_->GetBitLength());
+      for (const auto& wire : share_->GetWires()) values.emplace_back(~GetConstantBits(wire));
+      return MakeConstantBooleanShare(std::move(values), share_->GetBackend());
+    }
     case MpcProtocol::kBmr: {
       auto bmr_share = std::dynamic_pointer_cast<proto::bmr::Share>(share_);
       assert(bmr_share);
@@ -100,6 +303,11 @@ ShareWrapper ShareWrapper::operator~() const {
       auto inv_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeInvGate(share_);
       return ShareWrapper(inv_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kBooleanReplicated: {
+      auto inv_gate =
+          share_->GetBackend().GetRegister()->EmplaceGate<proto::replicated::InvGate>(share_);
+      return ShareWrapper(inv_gate->GetOutputAsReplicatedShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an INV gate with id {}",
@@ -110,7 +318,8 @@ ShareWrapper ShareWrapper::operator~() const {
 ShareWrapper ShareWrapper::operator^(const ShareWrapper& other) const {
   assert(share_);
   assert(*other);
-  assert(share_->GetProtocol() == other->GetProtocol());
+  assert(share_->GetProtocol() == other->GetProtocol() || IsBooleanConstant(share_) ||
+         IsBooleanConstant(*other));
   assert(share_->GetBitLength() == other->GetBitLength());
 
   if (share_->GetCircuitType() == CircuitType::kArithmetic) {
@@ -118,6 +327,10 @@ ShareWrapper ShareWrapper::operator^(const ShareWrapper& other) const {
         "Boolean primitive operations are not supported for arithmetic circuits");
   }
 
+  if (auto folded = FoldBooleanOperation(*this, other, PrimitiveOperationType::kXor)) {
+    return *folded;
+  }
+
   switch (share_->GetProtocol()) {
     case MpcProtocol::kBmr: {
       auto this_b = std::dynamic_pointer_cast<proto::bmr::Share>(share_);
@@ -142,6 +355,11 @@ ShareWrapper ShareWrapper::operator^(const ShareWrapper& other) const {
       auto xor_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeXorGate(share_, *other);
       return ShareWrapper(xor_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kBooleanReplicated: {
+      auto xor_gate = share_->GetBackend().GetRegister()->EmplaceGate<proto::replicated::XorGate>(
+          share_, *other);
+      return ShareWrapper(xor_gate->GetOutputAsReplicatedShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an XOR gate with id {}",
@@ -152,7 +370,8 @@ ShareWrapper ShareWrapper::operator^(const ShareWrapper& other) const {
 ShareWrapper ShareWrapper::operator&(const ShareWrapper& other) const {
   assert(*other);
   assert(share_);
-  assert(share_->GetProtocol() == other->GetProtocol());
+  assert(share_->GetProtocol() == other->GetProtocol() || IsBooleanConstant(share_) ||
+         IsBooleanConstant(*other));
   assert(share_->GetBitLength() == other->GetBitLength());
 
   if (share_->GetCircuitType() == CircuitType::kArithmetic) {
@@ -160,6 +379,10 @@ ShareWrapper ShareWrapper::operator&(const ShareWrapper& other) const {
         "Boolean primitive operations are not supported for arithmetic circuits");
   }
 
+  if (auto folded = FoldBooleanOperation(*this, other, PrimitiveOperationType::kAnd)) {
+    return *folded;
+  }
+
   switch (share_->GetProtocol()) {
     case MpcProtocol::kBmr: {
       auto this_b = std::dynamic_pointer_cast<proto::bmr::Share>(share_);
@@ -181,6 +404,11 @@ ShareWrapper ShareWrapper::operator&(const ShareWrapper& other) const {
       auto and_gate = share_->GetBackend().GetGarbledCircuitProvider().MakeAndGate(share_, *other);
       return ShareWrapper(and_gate->GetOutputAsShare());
     }
+    case MpcProtocol::kBooleanReplicated: {
+      auto and_gate = share_->GetBackend().GetRegister()->EmplaceGate<proto::replicated::AndGate>(
+          share_, *other);
+      return ShareWrapper(and_gate->GetOutputAsReplicatedShare());
+    }
     default:
       throw std::runtime_error(
           fmt::format("Unknown protocol for constructing an AND gate with id {}",
@@ -191,7 +419,8 @@ ShareWrapper ShareWrapper::operator&(const ShareWrapper& other) const {
 ShareWrapper ShareWrapper::operator|(const ShareWrapper& other) const {
   assert(*other);
   assert(share_);
-  assert(share_->GetProtocol() == other->GetProtocol());
+  assert(share_->GetProtocol() == other->GetProtocol() || IsBooleanConstant(share_) ||
+         IsBooleanConstant(*other));
   assert(share_->GetBitLength() == other->GetBitLength());
 
   if (share_->GetCircuitType() == CircuitType::kArithmetic) {
@@ -199,6 +428,10 @@ ShareWrapper ShareWrapper::operator|(const ShareWrapper& other) const {
         "Boolean primitive operations are not supported for arithmetic circuits");
   }
 
+  if (auto folded = FoldBooleanOperation(*this, other, PrimitiveOperationType::kOr)) {
+    return *folded;
+  }
+
   // OR operatinos is equal to NOT ( ( NOT a ) AND ( NOT b ) )
   return ~((~*this) & ~other);
 }
@@ -208,8 +441,7 @@ ShareWrapper ShareWrapper::operator+(const ShareWrapper& other) const {
   assert(share_);
   assert(share_->GetCircuitType() == other->GetCircuitType());
   assert(share_->GetBitLength() == other->GetBitLength());
-  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw &&
-      other->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+  if (share_->GetCircuitType() == CircuitType::kBoolean &&
       share_->GetProtocol() == other->GetProtocol()) {
       SecureUnsignedInteger secure_uint_a = SecureUnsignedInteger(share_);
       SecureUnsignedInteger secure_uint_b = SecureUnsignedInteger(other);
@@ -238,8 +470,7 @@ ShareWrapper ShareWrapper::operator-(const ShareWrapper& other) const {
   assert(share_);
   assert(share_->GetCircuitType() == other->GetCircuitType());
   assert(share_->GetBitLength() == other->GetBitLength());
-  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw &&
-      other->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+  if (share_->GetCircuitType() == CircuitType::kBoolean &&
       share_->GetProtocol() == other->GetProtocol()) {
       SecureUnsignedInteger secure_uint_a = SecureUnsignedInteger(share_);
       SecureUnsignedInteger secure_uint_b = SecureUnsignedInteger(other);
@@ -305,12 +536,15 @@ ShareWrapper ShareWrapper::operator*(const ShareWrapper& other) const {
   assert(share_->GetNumberOfSimdValues() == other->GetNumberOfSimdValues());
   if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw &&
       other->GetProtocol() != MpcProtocol::kArithmeticGmw &&
-      share_->GetProtocol() != MpcProtocol::kAstra && other->GetProtocol() != MpcProtocol::kAstra) {
+      share_->GetProtocol() != MpcProtocol::kAstra && other->GetProtocol() != MpcProtocol::kAstra &&
+      share_->GetProtocol() != MpcProtocol::kArithmeticReplicated) {
     throw std::runtime_error(
-        "Arithmetic primitive operations are only supported for arithmetic GMW and Astra shares");
+        "Arithmetic primitive operations are only supported for arithmetic GMW, Astra and "
+        "replicated shares");
   }
 
-  if (share_ == other.share_) {  // squaring
+  // squaring, ASTRA multiplies a share with itself by its MultiplicationGate
+  if (share_ == other.share_ && share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
     if (share_->GetBitLength() == 8u) {
       return Square<std::uint8_t>(share_);
     } else if (share_->GetBitLength() == 16u) {
@@ -348,37 +582,24 @@ ShareWrapper ShareWrapper::operator==(const ShareWrapper& other) const {
         "Comparing shared bit strings of bit length 0 is not allowed");
   }
 
-  auto result = ~(*this ^ other);  // XNOR
-  const auto bitlength = result->GetBitLength();
-
-  if (bitlength == 1) {
-    return result;
-  } else if (IsPowerOfTwo(bitlength)) {
-    return LowDepthReduce(result.Split(), std::bit_and<>());
-  } else {  // bitlength is not a power of 2
-    while (result->GetBitLength() != 1) {
-      std::queue<ShareWrapper> q;
-      std::vector<ShareWrapper> output;
-      std::size_t offset{0};
-      const auto inner_bitlength{result->GetBitLength()};
-      output.reserve(std::ceil(std::log2(inner_bitlength)));
-      const auto split = result.Split();
-      for (auto i = 1ull; i <= inner_bitlength; i *= 2) {
-        if ((inner_bitlength & i) == i) {
-          const auto _begin = split.begin() + offset;
-          const auto _end = split.begin() + offset + i;
-          q.push(ShareWrapper::Concatenate(_begin, _end));
-          offset += i;
-        }
-      }
-      while (!q.empty()) {
-        output.emplace_back(LowDepthReduce(q.front().Split(), std::bit_and<>()));
-        q.pop();
-      }
-      result = ShareWrapper::Concatenate(output);
+  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw &&
+      other->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    if (share_->GetBitLength() == 8u) {
+      return Equal<std::uint8_t>(share_, *other);
+    } else if (share_->GetBitLength() == 16u) {
+      return Equal<std::uint16_t>(share_, *other);
+    } else if (share_->GetBitLength() == 32u) {
+      return Equal<std::uint32_t>(share_, *other);
+    } else if (share_->GetBitLength() == 64u) {
+      return Equal<std::uint64_t>(share_, *other);
+    } else {
+      throw std::bad_cast();
     }
-    return result;
   }
+
+  auto result = ~(*this ^ other);  // XNOR
+  // one round per level of multi-input ANDs in Boolean GMW
+  return result.AndReduce();
 }
 
 ShareWrapper ShareWrapper::operator>(const ShareWrapper& other) const {
@@ -393,6 +614,14 @@ ShareWrapper ShareWrapper::operator>(const ShareWrapper& other) const {
 
   assert(*other);
   assert(share_);
+  if (share_->GetProtocol() == MpcProtocol::kAstra &&
+      other->GetProtocol() == MpcProtocol::kAstra) {
+    // compare the Boolean GMW conversions, whose subtraction circuits are evaluated in parallel
+    SecureUnsignedInteger secure_uint_a{Convert<MpcProtocol::kBooleanGmw>()};
+    SecureUnsignedInteger secure_uint_b{other.Convert<MpcProtocol::kBooleanGmw>()};
+    ShareWrapper result = secure_uint_a > secure_uint_b;
+    return result;
+  }
   if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw ||
       other->GetProtocol() != MpcProtocol::kArithmeticGmw) {
     // throw std::runtime_error("GreaterThan operation is only supported for arithmetic GMW shares");
@@ -415,19 +644,132 @@ ShareWrapper ShareWrapper::operator>(const ShareWrapper& other) const {
   }
 }
 
+ShareWrapper ShareWrapper::Minimum(const ShareWrapper& other) const {
+  assert(share_);
+  assert(*other);
+  const auto greater_than{*this > other};
+  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    // this + [this > other] * (other - this)
+    return *this + greater_than * (other - *this);
+  }
+  return greater_than.Mux(other, *this);
+}
+
+ShareWrapper ShareWrapper::Maximum(const ShareWrapper& other) const {
+  assert(share_);
+  assert(*other);
+  const auto greater_than{*this > other};
+  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    // other + [this > other] * (this - other)
+    return other + greater_than * (*this - other);
+  }
+  return greater_than.Mux(*this, other);
+}
+
+ShareWrapper ShareWrapper::Sign() const {
+  assert(share_);
+  if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    // the most significant bit of the Boolean GMW conversion
+    return Convert<MpcProtocol::kBooleanGmw>().Split().back();
+  }
+  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::invalid_argument(
+        "ShareWrapper::Sign() is implemented only for the arithmetic GMW and ASTRA protocols");
+  }
+
+  // the OT-based SignGate needs exactly two parties
+  if (share_->GetBackend().GetCommunicationLayer().GetNumberOfParties() != 2) {
+    return MostSignificantBit();
+  }
+
+  if (share_->GetBitLength() == 8u) {
+    return Sign<std::uint8_t>(share_);
+  } else if (share_->GetBitLength() == 16u) {
+    return Sign<std::uint16_t>(share_);
+  } else if (share_->GetBitLength() == 32u) {
+    return Sign<std::uint32_t>(share_);
+  } else if (share_->GetBitLength() == 64u) {
+    return Sign<std::uint64_t>(share_);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::Truncate(std::size_t number_of_bits) const {
+  assert(share_);
+  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+      share_->GetProtocol() != MpcProtocol::kAstra) {
+    throw std::invalid_argument(
+        "ShareWrapper::Truncate() is implemented only for the arithmetic GMW and ASTRA protocols");
+  }
+
+  if (share_->GetBitLength() == 8u) {
+    return Truncate<std::uint8_t>(share_, number_of_bits);
+  } else if (share_->GetBitLength() == 16u) {
+    return Truncate<std::uint16_t>(share_, number_of_bits);
+  } else if (share_->GetBitLength() == 32u) {
+    return Truncate<std::uint32_t>(share_, number_of_bits);
+  } else if (share_->GetBitLength() == 64u) {
+    return Truncate<std::uint64_t>(share_, number_of_bits);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
+ShareWrapper ShareWrapper::ArithmeticSelection(std::size_t bitlength) const {
+  const auto bit{share_->GetProtocol() == MpcProtocol::kBooleanGmw
+                     ? share_
+                     : Convert<MpcProtocol::kBooleanGmw>().Get()};
+  // the Hamming weight of a single wire is the value of the bit
+  switch (bitlength) {
+    case 8u: {
+      auto selection_gate{
+          share_->GetRegister()->EmplaceGate<GmwToArithmeticGate<std::uint8_t>>(bit, true)};
+      return ShareWrapper(selection_gate->GetOutputAsShare());
+    }
+    case 16u: {
+      auto selection_gate{
+          share_->GetRegister()->EmplaceGate<GmwToArithmeticGate<std::uint16_t>>(bit, true)};
+      return ShareWrapper(selection_gate->GetOutputAsShare());
+    }
+    case 32u: {
+      auto selection_gate{
+          share_->GetRegister()->EmplaceGate<GmwToArithmeticGate<std::uint32_t>>(bit, true)};
+      return ShareWrapper(selection_gate->GetOutputAsShare());
+    }
+    case 64u: {
+      auto selection_gate{
+          share_->GetRegister()->EmplaceGate<GmwToArithmeticGate<std::uint64_t>>(bit, true)};
+      return ShareWrapper(selection_gate->GetOutputAsShare());
+    }
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+  }
+}
+
 ShareWrapper ShareWrapper::Mux(const ShareWrapper& a, const ShareWrapper& b) const {
   assert(*a);
   assert(*b);
   assert(share_);
-  assert(share_->GetProtocol() == a->GetProtocol());
-  assert(share_->GetProtocol() == b->GetProtocol());
+  assert(a->GetProtocol() == b->GetProtocol());
   assert(a->GetBitLength() == b->GetBitLength());
   assert(share_->GetBitLength() == 1);
 
-  if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) {
-    // TODO implement
-    throw std::runtime_error("C-OT-based Mux for Arithmetic GMW shares is not implemented yet");
+  if (a->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+    // b + s * (a - b) by a single multiplication with the selection bit
+    const auto difference{a - b};
+    if (share_->GetProtocol() == MpcProtocol::kArithmeticGmw) return b + *this * difference;
+    if (share_->GetBackend().GetCommunicationLayer().GetNumberOfParties() == 2) {
+      // multiplied by the AC-OTs of HybridMultiplicationGate
+      const auto selection{share_->GetProtocol() == MpcProtocol::kBooleanGmw
+                               ? *this
+                               : Convert<MpcProtocol::kBooleanGmw>()};
+      return b + selection * difference;
+    }
+    // HybridMultiplicationGate is two-party only, so the selection bit is converted
+    return b + ArithmeticSelection(a->GetBitLength()) * difference;
   }
+  assert(share_->GetProtocol() == a->GetProtocol());
 
   if (share_->GetProtocol() == MpcProtocol::kBooleanGmw) {
     auto this_gmw = std::dynamic_pointer_cast<proto::boolean_gmw::Share>(share_);
@@ -486,17 +828,82 @@ ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b) {
   }
 }
 
+std::vector<ShareWrapper> MatrixMultiplication(std::span<ShareWrapper> a, std::span<ShareWrapper> b,
+                                               std::size_t number_of_rows,
+                                               std::size_t number_of_columns) {
+  assert(a.size() > 0);
+  assert(b.size() > 0);
+  for (auto i = 0u; i != a.size(); ++i) {
+    assert(*a[i]);
+    assert(a[i]->GetCircuitType() == CircuitType::kArithmetic);
+    assert(a[i]->GetBitLength() == a[0]->GetBitLength());
+  }
+  for (auto i = 0u; i != b.size(); ++i) {
+    assert(*b[i]);
+    assert(b[i]->GetCircuitType() == CircuitType::kArithmetic);
+    assert(b[i]->GetBitLength() == a[0]->GetBitLength());
+  }
+
+  auto bit_length = a[0]->GetBitLength();
+  if (bit_length == 8u) {
+    return a[0].MatrixMultiplication<std::uint8_t>(a, b, number_of_rows, number_of_columns);
+  } else if (bit_length == 16u) {
+    return a[0].MatrixMultiplication<std::uint16_t>(a, b, number_of_rows, number_of_columns);
+  } else if (bit_length == 32u) {
+    return a[0].MatrixMultiplication<std::uint32_t>(a, b, number_of_rows, number_of_columns);
+  } else if (bit_length == 64u) {
+    return a[0].MatrixMultiplication<std::uint64_t>(a, b, number_of_rows, number_of_columns);
+  } else {
+    throw std::bad_cast();
+  }
+}
+
 template <MpcProtocol P>
 ShareWrapper ShareWrapper::Convert() const {
   constexpr auto kArithmeticGmw = MpcProtocol::kArithmeticGmw;
   constexpr auto kBooleanGmw = MpcProtocol::kBooleanGmw;
   constexpr auto kBmr = MpcProtocol::kBmr;
+  constexpr auto kGarbledCircuit = MpcProtocol::kGarbledCircuit;
   if (share_->GetProtocol() == P) {
     throw std::runtime_error("Trying to convert share to MpcProtocol it is already in");
   }
 
   assert(share_->GetProtocol() < MpcProtocol::kInvalid);
 
+  if (share_->GetProtocol() == MpcProtocol::kAstra) {
+    // kAstra -> kBooleanGmw, and over kBooleanGmw to the other protocols
+    if constexpr (P == kBooleanGmw) {
+      return AstraToBooleanGmw();
+    } else {
+      return AstraToBooleanGmw().Convert<P>();
+    }
+  }
+
+  if (share_->GetProtocol() == MpcProtocol::kArithmeticReplicated ||
+      share_->GetProtocol() == MpcProtocol::kBooleanReplicated) {
+    // locally to GMW of the same circuit type, and over it to the other protocols
+    auto gmw_share{ReplicatedToGmw()};
+    if (gmw_share->GetProtocol() == P) return gmw_share;
+    return gmw_share.Convert<P>();
+  }
+
+  if constexpr (P == MpcProtocol::kArithmeticReplicated || P == MpcProtocol::kBooleanReplicated) {
+    // resharing of GMW of the same circuit type, which the other protocols are converted to first
+    constexpr auto kGmw{P == MpcProtocol::kArithmeticReplicated ? kArithmeticGmw : kBooleanGmw};
+    if (share_->GetProtocol() == kGmw) return GmwToReplicated();
+    return this->Convert<kGmw>().GmwToReplicated();
+  }
+
+  if (share_->GetProtocol() == kGarbledCircuit) {
+    if constexpr (P == kBooleanGmw) {  // kGarbledCircuit -> kBooleanGmw
+      return GarbledCircuitToBooleanGmw();
+    } else if constexpr (P == kArithmeticGmw) {  // kGarbledCircuit -> kArithmeticGmw
+      return GarbledCircuitToArithmeticGmw();
+    } else {  // kGarbledCircuit --(over kBooleanGmw)--> kBmr
+      return GarbledCircuitToBooleanGmw().Convert<P>();
+    }
+  }
+
   if constexpr (P == kArithmeticGmw) {
     if (share_->GetProtocol() == kBooleanGmw) {  // kBooleanGmw -> kArithmeticGmw
       return BooleanGmwToArithmeticGmw();
@@ -504,8 +911,8 @@ ShareWrapper ShareWrapper::Convert() const {
       return this->Convert<kBooleanGmw>().Convert<kArithmeticGmw>();
     }
   } else if constexpr (P == kBooleanGmw) {
-    if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw --(over kBmr)--> kBooleanGmw
-      return this->Convert<kBmr>().Convert<kBooleanGmw>();
+    if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw -> kBooleanGmw
+      return ArithmeticGmwToBooleanGmw();
     } else {  // kBmr -> kBooleanGmw
       return BmrToBooleanGmw();
     }
@@ -515,6 +922,14 @@ ShareWrapper ShareWrapper::Convert() const {
     } else {  // kBooleanGmw -> kBmr
       return BooleanGmwToBmr();
     }
+  } else if constexpr (P == kGarbledCircuit) {
+    if (share_->GetProtocol() == kArithmeticGmw) {  // kArithmeticGmw -> kGarbledCircuit
+      return ArithmeticGmwToGarbledCircuit();
+    } else if (share_->GetProtocol() == kBooleanGmw) {  // kBooleanGmw -> kGarbledCircuit
+      return BooleanGmwToGarbledCircuit();
+    } else {  // kBmr --(over kBooleanGmw)--> kGarbledCircuit
+      return this->Convert<kBooleanGmw>().Convert<kGarbledCircuit>();
+    }
   } else {
     throw std::runtime_error("Unknown MpcProtocol");
   }
@@ -524,6 +939,9 @@ ShareWrapper ShareWrapper::Convert() const {
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kArithmeticGmw>() const;
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kBooleanGmw>() const;
 template ShareWrapper ShareWrapper::Convert<MpcProtocol::kBmr>() const;
+template ShareWrapper ShareWrapper::Convert<MpcProtocol::kGarbledCircuit>() const;
+template ShareWrapper ShareWrapper::Convert<MpcProtocol::kArithmeticReplicated>() const;
+template ShareWrapper ShareWrapper::Convert<MpcProtocol::kBooleanReplicated>() const;
 
 ShareWrapper ShareWrapper::ArithmeticGmwToBmr() const {
   auto arithmetic_gmw_to_bmr_gate{
@@ -531,6 +949,201 @@ ShareWrapper ShareWrapper::ArithmeticGmwToBmr() const {
   return ShareWrapper(arithmetic_gmw_to_bmr_gate->GetOutputAsShare());
 }
 
+namespace {
+
+// extracts bits [first_bit, first_bit + number_of_bits) of the share by an
+// ArithmeticGmwToBooleanGmwGate, a tree of depth log2(first_bit) for the carry into first_bit of
+// x = c + r and a Kogge-Stone prefix circuit of depth log2(number_of_bits) for the carries of the
+// extracted bits, which is the full conversion for first_bit = 0 and number_of_bits = l
+template <typename T>
+ShareWrapper ExtractArithmeticGmwBits(const SharePointer& share, std::size_t first_bit,
+                                      std::size_t number_of_bits) {
+  auto arithmetic_gmw_to_boolean_gmw_gate{
+      share->GetRegister()->EmplaceGate<ArithmeticGmwToBooleanGmwGate<T>>(share)};
+  const auto propagate{
+      ShareWrapper(arithmetic_gmw_to_boolean_gmw_gate->GetPropagateAsBooleanShare()).Split()};
+  const auto generate{
+      ShareWrapper(arithmetic_gmw_to_boolean_gmw_gate->GetGenerateAsBooleanShare()).Split()};
+
+  // the generate and propagate bits of the carry chain of the extracted bits, where the first
+  // element is the carry into first_bit, whose propagate bit is never used
+  std::vector<ShareWrapper> chain_generate, chain_propagate;
+  chain_generate.reserve(number_of_bits);
+  chain_propagate.reserve(number_of_bits);
+  if (first_bit > 0) {
+    // combine groups of adjacent bits pairwise, the propagate bit of the lowest group is not needed
+    std::vector<ShareWrapper> group_generate(generate.begin(), generate.begin() + first_bit);
+    std::vector<ShareWrapper> group_propagate(propagate.begin(), propagate.begin() + first_bit);
+    while (group_generate.size() > 1) {
+      std::vector<ShareWrapper> next_generate, next_propagate;
+      for (std::size_t i = 0; i + 1 < group_generate.size(); i += 2) {
+        next_generate.push_back(group_generate[i + 1] ^
+                                (group_propagate[i + 1] & group_generate[i]));
+        next_propagate.push_back(i == 0 ? group_propagate[i]
+                                        : group_propagate[i + 1] & group_propagate[i]);
+      }
+      if (group_generate.size() % 2 == 1) {
+        next_generate.push_back(group_generate.back());
+        next_propagate.push_back(group_propagate.back());
+      }
+      group_generate = std::move(next_generate);
+      group_propagate = std::move(next_propagate);
+    }
+    chain_generate.push_back(group_generate[0]);
+    chain_propagate.push_back(group_propagate[0]);
+  }
+  for (std::size_t i = first_bit; i + 1 < first_bit + number_of_bits; ++i) {
+    chain_generate.push_back(generate[i]);
+    chain_propagate.push_back(propagate[i]);
+  }
+
+  const std::size_t chain_length{chain_generate.size()};
+  auto group_propagate{chain_propagate};
+  for (std::size_t distance = 1; distance < chain_length; distance *= 2) {
+    // descending, s.t. the groups below i still hold the values of the previous level
+    for (std::size_t i = chain_length - 1; i >= distance; --i) {
+      chain_generate[i] = chain_generate[i] ^ (group_propagate[i] & chain_generate[i - distance]);
+      // the next level only combines the groups of bits 2 * distance and above
+      if (i >= 2 * distance) {
+        group_propagate[i] = group_propagate[i] & group_propagate[i - distance];
+      }
+    }
+  }
+  // chain_generate[i] is the carry into bit first_bit + i resp., for first_bit = 0, the carry out
+  // of bit i
+  std::vector<ShareWrapper> bits;
+  bits.reserve(number_of_bits);
+  for (std::size_t i = 0; i < number_of_bits; ++i) {
+    if (first_bit > 0) {
+      bits.push_back(propagate[first_bit + i] ^ chain_generate[i]);
+    } else if (i == 0) {
+      bits.push_back(propagate[0]);
+    } else {
+      bits.push_back(propagate[i] ^ chain_generate[i - 1]);
+    }
+  }
+  return number_of_bits == 1 ? bits[0] : ShareWrapper::Concatenate(bits);
+}
+
+// converts the share by an AstraToBooleanGmwGate followed by a Boolean subtraction circuit
+template <typename T>
+ShareWrapper ConvertAstraToBooleanGmw(const SharePointer& share) {
+  auto astra_to_boolean_gmw_gate{
+      share->GetRegister()->EmplaceGate<AstraToBooleanGmwGate<T>>(share)};
+  SecureUnsignedInteger masked_value{
+      ShareWrapper(astra_to_boolean_gmw_gate->GetMaskedValueAsBooleanShare())};
+  SecureUnsignedInteger mask{ShareWrapper(astra_to_boolean_gmw_gate->GetMaskAsBooleanShare())};
+  // x = v - lambda
+  return (masked_value - mask).Get();
+}
+
+// converts an arithmetic share by a conversion gate of the matching bit length
+template <template <typename> class ConversionGate>
+ShareWrapper ConvertArithmetic(const SharePointer& share) {
+  switch (share->GetBitLength()) {
+    case 8u:
+      return ShareWrapper(share->GetRegister()
+                              ->EmplaceGate<ConversionGate<std::uint8_t>>(share)
+                              ->GetOutputAsShare());
+    case 16u:
+      return ShareWrapper(share->GetRegister()
+                              ->EmplaceGate<ConversionGate<std::uint16_t>>(share)
+                              ->GetOutputAsShare());
+    case 32u:
+      return ShareWrapper(share->GetRegister()
+                              ->EmplaceGate<ConversionGate<std::uint32_t>>(share)
+                              ->GetOutputAsShare());
+    case 64u:
+      return ShareWrapper(share->GetRegister()
+                              ->EmplaceGate<ConversionGate<std::uint64_t>>(share)
+                              ->GetOutputAsShare());
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", share->GetBitLength()));
+  }
+}
+
+}  // namespace
+
+ShareWrapper ShareWrapper::ReplicatedToGmw() const {
+  if (share_->GetProtocol() == MpcProtocol::kBooleanReplicated) {
+    auto replicated_to_gmw_gate{
+        share_->GetRegister()->EmplaceGate<BooleanReplicatedToBooleanGmwGate>(share_)};
+    return ShareWrapper(replicated_to_gmw_gate->GetOutputAsShare());
+  }
+  return ConvertArithmetic<ArithmeticReplicatedToArithmeticGmwGate>(share_);
+}
+
+ShareWrapper ShareWrapper::GmwToReplicated() const {
+  if (share_->GetProtocol() == MpcProtocol::kBooleanGmw) {
+    auto gmw_to_replicated_gate{
+        share_->GetRegister()->EmplaceGate<BooleanGmwToBooleanReplicatedGate>(share_)};
+    return ShareWrapper(gmw_to_replicated_gate->GetOutputAsShare());
+  }
+  return ConvertArithmetic<ArithmeticGmwToArithmeticReplicatedGate>(share_);
+}
+
+ShareWrapper ShareWrapper::ArithmeticGmwToBooleanGmw() const {
+  const auto bitlength = share_->GetBitLength();
+  switch (bitlength) {
+    case 8u:
+      return ExtractArithmeticGmwBits<std::uint8_t>(share_, 0, bitlength);
+    case 16u:
+      return ExtractArithmeticGmwBits<std::uint16_t>(share_, 0, bitlength);
+    case 32u:
+      return ExtractArithmeticGmwBits<std::uint32_t>(share_, 0, bitlength);
+    case 64u:
+      return ExtractArithmeticGmwBits<std::uint64_t>(share_, 0, bitlength);
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+  }
+}
+
+ShareWrapper ShareWrapper::ExtractBits(std::size_t first_bit, std::size_t number_of_bits) const {
+  assert(share_);
+  if (share_->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::invalid_argument(
+        "ShareWrapper::ExtractBits() is implemented only for the arithmetic GMW protocol");
+  }
+  const auto bitlength = share_->GetBitLength();
+  if (number_of_bits == 0 || first_bit + number_of_bits > bitlength) {
+    throw std::invalid_argument(fmt::format("Cannot extract {} bits from bit {} of {}-bit values",
+                                            number_of_bits, first_bit, bitlength));
+  }
+  switch (bitlength) {
+    case 8u:
+      return ExtractArithmeticGmwBits<std::uint8_t>(share_, first_bit, number_of_bits);
+    case 16u:
+      return ExtractArithmeticGmwBits<std::uint16_t>(share_, first_bit, number_of_bits);
+    case 32u:
+      return ExtractArithmeticGmwBits<std::uint32_t>(share_, first_bit, number_of_bits);
+    case 64u:
+      return ExtractArithmeticGmwBits<std::uint64_t>(share_, first_bit, number_of_bits);
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+  }
+}
+
+ShareWrapper ShareWrapper::MostSignificantBit() const {
+  assert(share_);
+  return ExtractBits(share_->GetBitLength() - 1, 1);
+}
+
+ShareWrapper ShareWrapper::AstraToBooleanGmw() const {
+  const auto bitlength = share_->GetBitLength();
+  switch (bitlength) {
+    case 8u:
+      return ConvertAstraToBooleanGmw<std::uint8_t>(share_);
+    case 16u:
+      return ConvertAstraToBooleanGmw<std::uint16_t>(share_);
+    case 32u:
+      return ConvertAstraToBooleanGmw<std::uint32_t>(share_);
+    case 64u:
+      return ConvertAstraToBooleanGmw<std::uint64_t>(share_);
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+  }
+}
+
 ShareWrapper ShareWrapper::BooleanGmwToArithmeticGmw() const {
   const auto bitlength = share_->GetBitLength();
   switch (bitlength) {
@@ -574,6 +1187,202 @@ ShareWrapper ShareWrapper::BmrToBooleanGmw() const {
   return ShareWrapper(bmr_to_boolean_gmw_gate->GetOutputAsShare());
 }
 
+ShareWrapper ShareWrapper::BooleanGmwToGarbledCircuit() const {
+  auto boolean_gmw_to_garbled_circuit_gate{
+      share_->GetRegister()->EmplaceGate<BooleanGmwToGarbledCircuitGate>(share_)};
+  return ShareWrapper(boolean_gmw_to_garbled_circuit_gate->GetOutputAsShare());
+}
+
+ShareWrapper ShareWrapper::ArithmeticGmwToGarbledCircuit() const {
+  auto arithmetic_gmw_to_garbled_circuit_gate{
+      share_->GetRegister()->EmplaceGate<ArithmeticGmwToGarbledCircuitGate>(share_)};
+  return ShareWrapper(arithmetic_gmw_to_garbled_circuit_gate->GetOutputAsShare());
+}
+
+ShareWrapper ShareWrapper::GarbledCircuitToBooleanGmw() const {
+  auto garbled_circuit_to_boolean_gmw_gate{
+      share_->GetRegister()->EmplaceGate<GarbledCircuitToBooleanGmwGate>(share_)};
+  return ShareWrapper(garbled_circuit_to_boolean_gmw_gate->GetOutputAsShare());
+}
+
+ShareWrapper ShareWrapper::GarbledCircuitToArithmeticGmw() const {
+  const auto bitlength = share_->GetBitLength();
+  switch (bitlength) {
+    case 8u: {
+      auto garbled_circuit_to_arithmetic_gmw_gate{
+          share_->GetRegister()->EmplaceGate<GarbledCircuitToArithmeticGmwGate<std::uint8_t>>(
+              share_)};
+      return ShareWrapper(garbled_circuit_to_arithmetic_gmw_gate->GetOutputAsShare());
+    }
+    case 16u: {
+      auto garbled_circuit_to_arithmetic_gmw_gate{
+          share_->GetRegister()->EmplaceGate<GarbledCircuitToArithmeticGmwGate<std::uint16_t>>(
+              share_)};
+      return ShareWrapper(garbled_circuit_to_arithmetic_gmw_gate->GetOutputAsShare());
+    }
+    case 32u: {
+      auto garbled_circuit_to_arithmetic_gmw_gate{
+          share_->GetRegister()->EmplaceGate<GarbledCircuitToArithmeticGmwGate<std::uint32_t>>(
+              share_)};
+      return ShareWrapper(garbled_circuit_to_arithmetic_gmw_gate->GetOutputAsShare());
+    }
+    case 64u: {
+      auto garbled_circuit_to_arithmetic_gmw_gate{
+          share_->GetRegister()->EmplaceGate<GarbledCircuitToArithmeticGmwGate<std::uint64_t>>(
+              share_)};
+      return ShareWrapper(garbled_circuit_to_arithmetic_gmw_gate->GetOutputAsShare());
+    }
+    default:
+      throw std::runtime_error(fmt::format("Invalid bitlength {}", bitlength));
+  }
+}
+
+ShareWrapper ShareWrapper::MultiInputAnd(std::vector<ShareWrapper> inputs, std::size_t fan_in) {
+  if (inputs.empty()) throw std::invalid_argument("MultiInputAnd needs at least one input");
+  if (fan_in < 2) {
+    throw std::invalid_argument(fmt::format("The fan-in of MultiInputAnd is {} < 2", fan_in));
+  }
+
+  // constants are folded into wiring by the final AND
+  std::vector<ShareWrapper> constants;
+  std::erase_if(inputs, [&constants](const ShareWrapper& input) {
+    if (!IsBooleanConstant(*input)) return false;
+    constants.push_back(input);
+    return true;
+  });
+  std::optional<ShareWrapper> constant;
+  if (!constants.empty()) constant = LowDepthReduce(std::move(constants), std::bit_and<>());
+  if (inputs.empty()) return *constant;
+
+  if (inputs[0]->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    auto result{LowDepthReduce(std::move(inputs), std::bit_and<>())};
+    return constant ? result & *constant : result;
+  }
+
+  fan_in = std::min(fan_in, proto::boolean_gmw::kMaxAndFanIn);
+  auto& backend{inputs[0]->GetBackend()};
+  while (inputs.size() > 1) {
+    std::vector<ShareWrapper> next_inputs;
+    next_inputs.reserve((inputs.size() + fan_in - 1) / fan_in);
+    for (std::size_t i = 0; i < inputs.size(); i += fan_in) {
+      const auto end{std::min(i + fan_in, inputs.size())};
+      if (end - i == 1) {
+        next_inputs.push_back(inputs[i]);
+      } else if (end - i == 2) {
+        // a binary AND needs the same round and fewer MTs
+        next_inputs.push_back(inputs[i] & inputs[i + 1]);
+      } else {
+        std::vector<SharePointer> group;
+        group.reserve(end - i);
+        for (std::size_t k = i; k < end; ++k) group.push_back(*inputs[k]);
+        auto and_gate{
+            backend.GetRegister()->EmplaceGate<proto::boolean_gmw::MultiInputAndGate>(group)};
+        next_inputs.emplace_back(and_gate->GetOutputAsShare());
+      }
+    }
+    inputs = std::move(next_inputs);
+  }
+  return constant ? inputs[0] & *constant : inputs[0];
+}
+
+ShareWrapper ShareWrapper::MultiInputXor(std::vector<ShareWrapper> inputs) {
+  if (inputs.empty()) throw std::invalid_argument("MultiInputXor needs at least one input");
+
+  std::vector<ShareWrapper> constants;
+  std::erase_if(inputs, [&constants](const ShareWrapper& input) {
+    if (!IsBooleanConstant(*input)) return false;
+    constants.push_back(input);
+    return true;
+  });
+  std::optional<ShareWrapper> constant;
+  if (!constants.empty()) constant = LowDepthReduce(std::move(constants), std::bit_xor<>());
+  if (inputs.empty()) return *constant;
+  if (inputs.size() == 1) return constant ? inputs[0] ^ *constant : inputs[0];
+
+  if (inputs[0]->GetProtocol() != MpcProtocol::kBooleanGmw) {
+    auto result{LowDepthReduce(std::move(inputs), std::bit_xor<>())};
+    return constant ? result ^ *constant : result;
+  }
+
+  const std::size_t number_of_wires{inputs[0]->GetBitLength()};
+  std::vector<WirePointer> parents;
+  parents.reserve(inputs.size() * number_of_wires);
+  for (const auto& input : inputs) {
+    assert(input->GetBitLength() == number_of_wires);
+    const auto& wires{input->GetWires()};
+    parents.insert(parents.end(), wires.begin(), wires.end());
+  }
+  // output wire i is the XOR of wire i of all inputs
+  std::vector<std::vector<std::size_t>> output_terms(number_of_wires);
+  for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) {
+    auto& terms{output_terms[wire_i]};
+    terms.reserve(inputs.size());
+    for (std::size_t input_i = 0; input_i < inputs.size(); ++input_i) {
+      terms.push_back(input_i * number_of_wires + wire_i);
+    }
+  }
+  // a constant whose wires are the same in all SIMD values inverts outputs of the gate
+  std::vector<bool> output_inversions(number_of_wires, false);
+  if (constant) {
+    const auto& constant_wires{(*constant)->GetWires()};
+    const bool is_uniform{
+        std::all_of(constant_wires.begin(), constant_wires.end(), [](const WirePointer& wire) {
+          const auto hamming_weight{GetConstantBits(wire).HammingWeight()};
+          return hamming_weight == 0 || hamming_weight == wire->GetNumberOfSimdValues();
+        })};
+    if (is_uniform) {
+      for (std::size_t wire_i = 0; wire_i < number_of_wires; ++wire_i) {
+        output_inversions[wire_i] = GetConstantBits(constant_wires[wire_i]).HammingWeight() != 0;
+      }
+      constant.reset();
+    }
+  }
+
+  auto& backend{inputs[0]->GetBackend()};
+  auto fused_xor_gate{backend.GetRegister()->EmplaceGate<proto::boolean_gmw::FusedXorGate>(
+      std::move(parents), std::move(output_terms), std::move(output_inversions), backend)};
+  ShareWrapper result(fused_xor_gate->GetOutputAsShare());
+  return constant ? result ^ *constant : result;
+}
+
+ShareWrapper ShareWrapper::LookupTable(std::vector<BitVector<>> truth_tables) const {
+  assert(share_);
+  switch (share_->GetProtocol()) {
+    case MpcProtocol::kBooleanConstant: {
+      const std::size_t number_of_entries{std::size_t(1) << share_->GetBitLength()};
+      for (const auto& truth_table : truth_tables) {
+        if (truth_table.GetSize() != number_of_entries) {
+          throw std::invalid_argument(fmt::format(
+              "The truth tables of a lookup table with {} inputs need {} bits, got {}",
+              share_->GetBitLength(), number_of_entries, truth_table.GetSize()));
+        }
+      }
+      const auto number_of_simd{share_->GetNumberOfSimdValues()};
+      std::vector<BitVector<>> values(truth_tables.size(), BitVector<>(number_of_simd));
+      for (std::size_t simd_i = 0; simd_i < number_of_simd; ++simd_i) {
+        std::size_t x{0};
+        for (std::size_t input_i = 0; input_i < share_->GetBitLength(); ++input_i) {
+          if (GetConstantBits(share_->GetWires()[input_i]).Get(simd_i)) x |= 1ull << input_i;
+        }
+        for (std::size_t output_i = 0; output_i < truth_tables.size(); ++output_i) {
+          values[output_i].Set(truth_tables[output_i].Get(x), simd_i);
+        }
+      }
+      return MakeConstantBooleanShare(std::move(values), share_->GetBackend());
+    }
+    case MpcProtocol::kBooleanGmw: {
+      auto lookup_table_gate =
+          share_->GetBackend().GetRegister()->EmplaceGate<proto::boolean_gmw::LookupTableGate>(
+              share_, std::move(truth_tables));
+      return ShareWrapper(lookup_table_gate->GetOutputAsShare());
+    }
+    default:
+      throw std::invalid_argument(
+          fmt::format("Lookup tables are not supported for the protocol with id {}",
+                      static_cast<std::size_t>(share_->GetProtocol())));
+  }
+}
+
 ShareWrapper ShareWrapper::Out(std::size_t output_owner) const {
   assert(share_);
   auto& backend = share_->GetBackend();
@@ -627,10 +1436,38 @@ ShareWrapper ShareWrapper::Out(std::size_t output_owner) const {
         }
       }
     } break;
+    case MpcProtocol::kArithmeticReplicated: {
+      switch (share_->GetBitLength()) {
+        case 8u: {
+          result = backend.ArithmeticReplicatedOutput<std::uint8_t>(share_, output_owner);
+          break;
+        }
+        case 16u: {
+          result = backend.ArithmeticReplicatedOutput<std::uint16_t>(share_, output_owner);
+          break;
+        }
+        case 32u: {
+          result = backend.ArithmeticReplicatedOutput<std::uint32_t>(share_, output_owner);
+          break;
+        }
+        case 64u: {
+          result = backend.ArithmeticReplicatedOutput<std::uint64_t>(share_, output_owner);
+          break;
+        }
+        default: {
+          throw std::runtime_error(
+              fmt::format("Unknown arithmetic ring of {} bilength", share_->GetBitLength()));
+        }
+      }
+    } break;
     case MpcProtocol::kBooleanGmw: {
       result = backend.BooleanGmwOutput(share_, output_owner);
       break;
     }
+    case MpcProtocol::kBooleanReplicated: {
+      result = backend.BooleanReplicatedOutput(share_, output_owner);
+      break;
+    }
     case MpcProtocol::kBmr: {
       result = backend.BmrOutput(share_, output_owner);
       break;
@@ -659,28 +1496,11 @@ std::vector<ShareWrapper> ShareWrapper::Split() const {
 
 ShareWrapper ShareWrapper::GetWire(std::size_t i) const { return ShareWrapper(share_->GetWire(i)); }
 
-ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
-  if (input.empty()) throw std::runtime_error("ShareWrapper cannot be empty");
-  {
-    const auto protocol = input[0]->GetProtocol();
-    for (auto i = 1ull; i < input.size(); ++i) {
-      if (input[i]->GetProtocol() != protocol) {
-        throw std::runtime_error("Trying to join shares of different types");
-      }
-    }
-  }
-  std::vector<SharePointer> unwrapped_shares;
-  unwrapped_shares.reserve(input.size());
-  for (const auto& s : input) unwrapped_shares.emplace_back(*s);
-
-  std::size_t bit_size_wires{0};
-  for (const auto& s : input) bit_size_wires += s->GetBitLength();
+namespace {
 
-  std::vector<WirePointer> wires;
-  wires.reserve(bit_size_wires);
-  for (const auto& s : input)
-    for (const auto& w : s->GetWires()) wires.emplace_back(w);
-  switch (input[0]->GetProtocol()) {
+// wraps wires of the same protocol into a share
+ShareWrapper MakeShareFromWires(const std::vector<WirePointer>& wires) {
+  switch (wires.at(0)->GetProtocol()) {
     case MpcProtocol::kArithmeticGmw: {
       switch (wires.at(0)->GetBitLength()) {
         case 8: {
@@ -701,107 +1521,666 @@ ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
               wires.at(0)->GetBitLength()));
       }
     }
-    case MpcProtocol::kAstra: {
-      switch (wires.at(0)->GetBitLength()) {
-        case 8: {
-          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint8_t>>(wires.at(0)));
+    case MpcProtocol::kAstra: {
+      switch (wires.at(0)->GetBitLength()) {
+        case 8: {
+          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint8_t>>(wires.at(0)));
+        }
+        case 16: {
+          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint16_t>>(wires.at(0)));
+        }
+        case 32: {
+          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint32_t>>(wires.at(0)));
+        }
+        case 64: {
+          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint64_t>>(wires.at(0)));
+        }
+        default:
+          throw std::runtime_error(fmt::format(
+              "Incorrect bit length of arithmetic shares: {}, allowed are 8, 16, 32, 64",
+              wires.at(0)->GetBitLength()));
+      }
+    }
+    case MpcProtocol::kArithmeticConstant: {
+      switch (wires.at(0)->GetBitLength()) {
+        case 8: {
+          return ShareWrapper(
+              std::make_shared<proto::ConstantArithmeticShare<std::uint8_t>>(wires));
+        }
+        case 16: {
+          return ShareWrapper(
+              std::make_shared<proto::ConstantArithmeticShare<std::uint16_t>>(wires));
+        }
+        case 32: {
+          return ShareWrapper(
+              std::make_shared<proto::ConstantArithmeticShare<std::uint32_t>>(wires));
+        }
+        case 64: {
+          return ShareWrapper(
+              std::make_shared<proto::ConstantArithmeticShare<std::uint64_t>>(wires));
+        }
+        default:
+          throw std::runtime_error(fmt::format(
+              "Incorrect bit length of arithmetic shares: {}, allowed are 8, 16, 32, 64",
+              wires.at(0)->GetBitLength()));
+      }
+    }
+    case MpcProtocol::kBooleanConstant: {
+      return ShareWrapper(std::make_shared<proto::ConstantBooleanShare>(wires));
+    }
+    case MpcProtocol::kBooleanGmw: {
+      return ShareWrapper(std::make_shared<proto::boolean_gmw::Share>(wires));
+    }
+    case MpcProtocol::kBmr: {
+      return ShareWrapper(std::make_shared<proto::bmr::Share>(wires));
+    }
+    case MpcProtocol::kGarbledCircuit: {
+      return ShareWrapper(std::make_shared<proto::garbled_circuit::Share>(wires));
+    }
+    case MpcProtocol::kArithmeticReplicated: {
+      namespace replicated = proto::replicated;
+      switch (wires.at(0)->GetBitLength()) {
+        case 8: {
+          return ShareWrapper(std::make_shared<replicated::ArithmeticShare<std::uint8_t>>(wires));
+        }
+        case 16: {
+          return ShareWrapper(std::make_shared<replicated::ArithmeticShare<std::uint16_t>>(wires));
+        }
+        case 32: {
+          return ShareWrapper(std::make_shared<replicated::ArithmeticShare<std::uint32_t>>(wires));
+        }
+        case 64: {
+          return ShareWrapper(std::make_shared<replicated::ArithmeticShare<std::uint64_t>>(wires));
+        }
+        default:
+          throw std::runtime_error(fmt::format(
+              "Incorrect bit length of arithmetic shares: {}, allowed are 8, 16, 32, 64",
+              wires.at(0)->GetBitLength()));
+      }
+    }
+    case MpcProtocol::kBooleanReplicated: {
+      return ShareWrapper(std::make_shared<proto::replicated::BooleanShare>(wires));
+    }
+    default: {
+      throw std::runtime_error("Unknown MPC protocol");
+    }
+  }
+}
+
+}  // namespace
+
+ShareWrapper ShareWrapper::Concatenate(std::span<const ShareWrapper> input) {
+  if (input.empty()) throw std::runtime_error("ShareWrapper cannot be empty");
+  {
+    const auto protocol = input[0]->GetProtocol();
+    for (auto i = 1ull; i < input.size(); ++i) {
+      if (input[i]->GetProtocol() != protocol) {
+        throw std::runtime_error("Trying to join shares of different types");
+      }
+    }
+  }
+  std::vector<SharePointer> unwrapped_shares;
+  unwrapped_shares.reserve(input.size());
+  for (const auto& s : input) unwrapped_shares.emplace_back(*s);
+
+  std::size_t bit_size_wires{0};
+  for (const auto& s : input) bit_size_wires += s->GetBitLength();
+
+  std::vector<WirePointer> wires;
+  wires.reserve(bit_size_wires);
+  for (const auto& s : input)
+    for (const auto& w : s->GetWires()) wires.emplace_back(w);
+  return MakeShareFromWires(wires);
+}
+
+namespace {
+
+// Builds a circuit description in Boolean GMW with fused XOR gates.  XOR and INV gates are tracked
+// as linear combinations of materialized wires, i.e., of the inputs and of the outputs of
+// non-linear gates, and only computed by a FusedXorGate once a non-linear gate or the output needs
+// them.  ANDs, and ORs as a ^ b ^ (a & b), are collected until one depends on another collected
+// AND, s.t. a single FusedXorGate computes the inputs of the batch and a single AND gate the batch.
+class FusedXorCircuitBuilder {
+ public:
+  // inputs may contain public constants that are 0 or 1 in all SIMD values, but at least one
+  // Boolean GMW share
+  FusedXorCircuitBuilder(const AlgorithmDescription& algorithm, std::vector<ShareWrapper>&& inputs)
+      : algorithm_(algorithm), materialized_(std::move(inputs)) {
+    combinations_.resize(algorithm_.number_of_wires);
+    std::optional<std::size_t> reference;
+    for (std::size_t wire_i = 0; wire_i < materialized_.size(); ++wire_i) {
+      if (IsBooleanConstant(*materialized_[wire_i])) {
+        // constants are empty linear combinations, i.e., only the inversion
+        const auto& wire{materialized_[wire_i]->GetWires().at(0)};
+        combinations_[wire_i].inverted = GetConstantBits(wire).HammingWeight() != 0;
+      } else {
+        combinations_[wire_i].terms = {wire_i};
+        if (!reference) reference = wire_i;
+      }
+    }
+    assert(reference);
+    reference_ = *reference;
+  }
+
+  ShareWrapper Build() {
+    for (const auto& gate : algorithm_.gates) {
+      if (!lookup_tables_.empty() && (gate.type != PrimitiveOperationType::kLut ||
+                                      gate.lut_inputs != lookup_tables_.front()->lut_inputs)) {
+        EvaluateLookupTables();
+      }
+      switch (gate.type) {
+        case PrimitiveOperationType::kXor: {
+          assert(gate.parent_b);
+          const auto& a{combinations_.at(gate.parent_a)};
+          const auto& b{combinations_.at(*gate.parent_b)};
+          LinearCombination result{.terms = {}, .inverted = a.inverted != b.inverted};
+          result.terms.reserve(a.terms.size() + b.terms.size());
+          std::set_symmetric_difference(a.terms.begin(), a.terms.end(), b.terms.begin(),
+                                        b.terms.end(), std::back_inserter(result.terms));
+          combinations_.at(gate.output_wire) = std::move(result);
+          // bounds the cost of combining long XOR chains
+          if (combinations_.at(gate.output_wire).terms.size() > kMaximumNumberOfTerms) {
+            Materialize({gate.output_wire});
+          }
+          break;
         }
-        case 16: {
-          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint16_t>>(wires.at(0)));
+        case PrimitiveOperationType::kInv: {
+          auto result{combinations_.at(gate.parent_a)};
+          result.inverted = !result.inverted;
+          combinations_.at(gate.output_wire) = std::move(result);
+          break;
         }
-        case 32: {
-          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint32_t>>(wires.at(0)));
+        case PrimitiveOperationType::kAnd:
+        case PrimitiveOperationType::kOr: {
+          assert(gate.parent_b);
+          const auto& a{combinations_.at(gate.parent_a)};
+          const auto& b{combinations_.at(*gate.parent_b)};
+          if (a.terms.empty() || b.terms.empty()) {
+            // AND with 0 and OR with 1 are constant, AND with 1 and OR with 0 are the other input
+            const auto& constant{a.terms.empty() ? a : b};
+            const auto& other{a.terms.empty() ? b : a};
+            const bool is_or{gate.type == PrimitiveOperationType::kOr};
+            auto result{constant.inverted == is_or ? constant : other};
+            combinations_.at(gate.output_wire) = std::move(result);
+            break;
+          }
+          if (DependsOnBatch(gate.parent_a) || DependsOnBatch(*gate.parent_b)) EvaluateBatch();
+          const std::size_t and_index{materialized_.size()};
+          batch_.push_back({gate.parent_a, *gate.parent_b, and_index});
+          materialized_.emplace_back();
+          LinearCombination result{.terms = {and_index}, .inverted = false};
+          if (gate.type == PrimitiveOperationType::kOr) {
+            // a | b = a ^ b ^ (a & b), where the AND has the largest index so far
+            result.terms.clear();
+            std::set_symmetric_difference(a.terms.begin(), a.terms.end(), b.terms.begin(),
+                                          b.terms.end(), std::back_inserter(result.terms));
+            result.terms.push_back(and_index);
+            result.inverted = a.inverted != b.inverted;
+          }
+          combinations_.at(gate.output_wire) = std::move(result);
+          break;
         }
-        case 64: {
-          return ShareWrapper(std::make_shared<proto::astra::Share<std::uint64_t>>(wires.at(0)));
+        case PrimitiveOperationType::kLut: {
+          lookup_tables_.push_back(&gate);
+          break;
         }
         default:
-          throw std::runtime_error(fmt::format(
-              "Incorrect bit length of arithmetic shares: {}, allowed are 8, 16, 32, 64",
-              wires.at(0)->GetBitLength()));
+          throw std::runtime_error("Invalid PrimitiveOperationType");
       }
     }
-    case MpcProtocol::kBooleanGmw: {
-      return ShareWrapper(std::make_shared<proto::boolean_gmw::Share>(wires));
+    EvaluateLookupTables();
+    EvaluateBatch();
+
+    std::vector<std::size_t> output_wires(algorithm_.number_of_output_wires);
+    std::iota(output_wires.begin(), output_wires.end(),
+              algorithm_.number_of_wires - algorithm_.number_of_output_wires);
+    Materialize(output_wires);
+    std::vector<ShareWrapper> output;
+    output.reserve(output_wires.size());
+    for (const auto wire_i : output_wires) {
+      output.emplace_back(materialized_.at(combinations_.at(wire_i).terms.front()));
     }
-    case MpcProtocol::kBmr: {
-      return ShareWrapper(std::make_shared<proto::bmr::Share>(wires));
+    return ShareWrapper::Concatenate(output);
+  }
+
+ private:
+  // XOR of the materialized wires at the sorted indices terms, inverted if inverted
+  struct LinearCombination {
+    std::vector<std::size_t> terms;
+    bool inverted{false};
+  };
+
+  struct BatchedAnd {
+    std::size_t parent_a, parent_b, materialized_index;
+  };
+
+  static constexpr std::size_t kMaximumNumberOfTerms{128};
+
+  bool IsMaterialized(std::size_t wire_i) const {
+    const auto& combination{combinations_.at(wire_i)};
+    return combination.terms.size() == 1 && !combination.inverted;
+  }
+
+  bool DependsOnBatch(std::size_t wire_i) const {
+    const auto& terms{combinations_.at(wire_i).terms};
+    return std::any_of(terms.begin(), terms.end(),
+                       [this](std::size_t term) { return !materialized_.at(term).Get(); });
+  }
+
+  // computes the wires in wires_to_materialize with a single FusedXorGate
+  void Materialize(const std::vector<std::size_t>& wires_to_materialize) {
+    std::vector<std::size_t> wires;
+    std::unordered_set<std::size_t> unique_wires;
+    for (const auto wire_i : wires_to_materialize) {
+      if (!IsMaterialized(wire_i) && unique_wires.insert(wire_i).second) wires.push_back(wire_i);
     }
-    case MpcProtocol::kGarbledCircuit: {
-      return ShareWrapper(std::make_shared<proto::garbled_circuit::Share>(wires));
+    if (wires.empty()) return;
+    if (std::any_of(wires.begin(), wires.end(), [this](auto w) { return DependsOnBatch(w); })) {
+      EvaluateBatch();
     }
-    default: {
-      throw std::runtime_error("Unknown MPC protocol");
+
+    std::vector<WirePointer> parents;
+    std::unordered_map<std::size_t, std::size_t> parent_indices;
+    std::vector<std::vector<std::size_t>> output_terms;
+    std::vector<bool> output_inversions;
+    output_terms.reserve(wires.size());
+    output_inversions.reserve(wires.size());
+    for (const auto wire_i : wires) {
+      const auto& combination{combinations_.at(wire_i)};
+      auto& terms{output_terms.emplace_back()};
+      terms.reserve(combination.terms.size());
+      for (const auto term : combination.terms) {
+        auto [iterator, is_new] = parent_indices.try_emplace(term, parents.size());
+        if (is_new) parents.emplace_back(materialized_.at(term)->GetWires().at(0));
+        terms.push_back(iterator->second);
+      }
+      output_inversions.push_back(combination.inverted);
+    }
+    // a constant output, e.g., of x ^ x, still needs a parent for the number of SIMD values
+    if (parents.empty()) parents.emplace_back(materialized_.at(reference_)->GetWires().at(0));
+
+    auto& backend{materialized_.at(0)->GetBackend()};
+    auto fused_xor_gate{backend.GetRegister()->EmplaceGate<proto::boolean_gmw::FusedXorGate>(
+        std::move(parents), std::move(output_terms), std::move(output_inversions), backend)};
+    const auto outputs{ShareWrapper(fused_xor_gate->GetOutputAsShare()).Split()};
+    for (std::size_t i = 0; i < wires.size(); ++i) {
+      combinations_.at(wires[i]) = {.terms = {materialized_.size()}, .inverted = false};
+      materialized_.push_back(outputs[i]);
+    }
+  }
+
+  // evaluates the collected ANDs after materializing their inputs as a single AND gate, s.t. they
+  // share one block of MTs and one message
+  void EvaluateBatch() {
+    if (batch_.empty()) return;
+    std::vector<std::size_t> inputs;
+    inputs.reserve(2 * batch_.size());
+    for (const auto& batched_and : batch_) {
+      inputs.push_back(batched_and.parent_a);
+      inputs.push_back(batched_and.parent_b);
+    }
+    // the inputs do not depend on the batch, so this does not recurse
+    auto batch{std::move(batch_)};
+    batch_.clear();
+    Materialize(inputs);
+    std::vector<ShareWrapper> a, b;
+    a.reserve(batch.size());
+    b.reserve(batch.size());
+    for (const auto& batched_and : batch) {
+      a.push_back(materialized_.at(combinations_.at(batched_and.parent_a).terms.front()));
+      b.push_back(materialized_.at(combinations_.at(batched_and.parent_b).terms.front()));
+    }
+    const auto products{(ShareWrapper::Concatenate(a) & ShareWrapper::Concatenate(b)).Split()};
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      materialized_.at(batch[i].materialized_index) = products[i];
+    }
+  }
+
+  // evaluates the collected kLuts, which have the same inputs, with a single LookupTableGate
+  void EvaluateLookupTables() {
+    if (lookup_tables_.empty()) return;
+    auto lookup_tables{std::move(lookup_tables_)};
+    lookup_tables_.clear();
+    const auto& inputs{lookup_tables.front()->lut_inputs};
+    Materialize(inputs);
+    std::vector<ShareWrapper> input_wires;
+    input_wires.reserve(inputs.size());
+    for (const auto input : inputs) {
+      input_wires.push_back(materialized_.at(combinations_.at(input).terms.front()));
+    }
+    std::vector<BitVector<>> truth_tables;
+    truth_tables.reserve(lookup_tables.size());
+    for (const auto* lookup_table : lookup_tables) {
+      truth_tables.push_back(lookup_table->truth_table);
+    }
+    const auto outputs{
+        ShareWrapper::Concatenate(input_wires).LookupTable(std::move(truth_tables)).Split()};
+    for (std::size_t i = 0; i < lookup_tables.size(); ++i) {
+      combinations_.at(lookup_tables[i]->output_wire) = {.terms = {materialized_.size()},
+                                                         .inverted = false};
+      materialized_.push_back(outputs[i]);
+    }
+  }
+
+  const AlgorithmDescription& algorithm_;
+  // the outputs of the batch are empty until it is evaluated
+  std::vector<ShareWrapper> materialized_;
+  std::vector<LinearCombination> combinations_;
+  std::vector<BatchedAnd> batch_;
+  // consecutive kLuts on the same inputs
+  std::vector<const PrimitiveOperation*> lookup_tables_;
+  // a Boolean GMW input
+  std::size_t reference_;
+};
+
+// Instantiates an EvaluationTemplate with one gate per batch on the wires of all of its gates,
+// s.t. the shares and gates are allocated per batch instead of per wire.  The gate, wire and share
+// objects of each layer are allocated from one contiguous slab of the arena of the register, which
+// is sized by EvaluationTemplate::GetLayerSizes and the arena bytes per gate measured on the
+// previous layers.  The values of the wires are not in the slab.  Gates with a public constant
+// input are folded one by one, see FoldBooleanOperation.
+class BatchedCircuitBuilder {
+ public:
+  BatchedCircuitBuilder(const EvaluationTemplate& evaluation_template,
+                        const std::vector<ShareWrapper>& inputs)
+      : evaluation_template_(evaluation_template),
+        register_(*inputs.at(0)->GetRegister()),
+        wires_(evaluation_template.GetNumberOfWires()) {
+    for (std::size_t wire_i = 0; wire_i < inputs.size(); ++wire_i) {
+      wires_[wire_i] = inputs[wire_i]->GetWires().at(0);
+    }
+  }
+
+  ShareWrapper Build() {
+    std::vector<WirePointer> a, b;
+    std::vector<std::size_t> batched;
+    const auto& layer_sizes{evaluation_template_.GetLayerSizes()};
+    const auto& arena{register_.GetArena()};
+    // the arena bytes and the number of gates of the batches built so far, by which the slabs of
+    // the later layers are sized, the first layer is not reserved
+    std::size_t measured_bytes{0}, measured_gates{0};
+    std::size_t layer{0};
+    for (const auto& batch : evaluation_template_.GetBatches()) {
+      if (batch.layer != layer) {
+        layer = batch.layer;
+        if (measured_gates > 0) {
+          const auto bytes_per_gate{(measured_bytes + measured_gates - 1) / measured_gates};
+          register_.ReserveContiguous(layer_sizes[layer] * bytes_per_gate);
+        }
+      }
+      const auto allocated_bytes{arena.GetNumberOfAllocatedBytes()};
+      BuildBatch(batch, a, b, batched);
+      measured_bytes += arena.GetNumberOfAllocatedBytes() - allocated_bytes;
+      measured_gates += batch.output_wires.size();
+    }
+
+    const auto number_of_wires{evaluation_template_.GetNumberOfWires()};
+    std::vector<ShareWrapper> output;
+    output.reserve(evaluation_template_.GetNumberOfOutputWires());
+    for (auto wire_i = number_of_wires - evaluation_template_.GetNumberOfOutputWires();
+         wire_i < number_of_wires; ++wire_i) {
+      output.emplace_back(MakeShareFromWires({wires_[wire_i]}));
+    }
+    // constant outputs are converted if they cannot be concatenated with the non-constant ones
+    return ConcatenateLifted(std::move(output));
+  }
+
+ private:
+  // a, b and batched are reused by the batches
+  void BuildBatch(const EvaluationTemplate::Batch& batch, std::vector<WirePointer>& a,
+                  std::vector<WirePointer>& b, std::vector<std::size_t>& batched) {
+    if (batch.type == PrimitiveOperationType::kLut) {
+      EvaluateLookupTables(batch);
+      return;
+    }
+    const bool is_binary{batch.type != PrimitiveOperationType::kInv};
+    a.clear();
+    b.clear();
+    batched.clear();
+    for (std::size_t i = 0; i < batch.output_wires.size(); ++i) {
+      const auto& wire_a{wires_[batch.parents_a[i]]};
+      const auto* wire_b{is_binary ? &wires_[batch.parents_b[i]] : nullptr};
+      if (IsConstant(wire_a) || (wire_b && IsConstant(*wire_b))) {
+        const auto result{EvaluateGate(batch.type, MakeShareFromWires({wire_a}),
+                                       wire_b ? MakeShareFromWires({*wire_b}) : ShareWrapper())};
+        wires_[batch.output_wires[i]] = result->GetWires().at(0);
+      } else {
+        a.push_back(wire_a);
+        if (wire_b) b.push_back(*wire_b);
+        batched.push_back(i);
+      }
+    }
+    if (batched.empty()) return;
+    const auto result{EvaluateGate(batch.type, MakeShareFromWires(a),
+                                   is_binary ? MakeShareFromWires(b) : ShareWrapper())};
+    const auto& output_wires{result->GetWires()};
+    for (std::size_t j = 0; j < batched.size(); ++j) {
+      wires_[batch.output_wires[batched[j]]] = output_wires[j];
+    }
+  }
+
+  static bool IsConstant(const WirePointer& wire) {
+    return wire->GetProtocol() == MpcProtocol::kBooleanConstant;
+  }
+
+  static ShareWrapper EvaluateGate(PrimitiveOperationType type, const ShareWrapper& a,
+                                   const ShareWrapper& b) {
+    switch (type) {
+      case PrimitiveOperationType::kXor:
+        return a ^ b;
+      case PrimitiveOperationType::kAnd:
+        return a & b;
+      case PrimitiveOperationType::kOr:
+        return a | b;
+      case PrimitiveOperationType::kInv:
+        return ~a;
+      default:
+        throw std::runtime_error("Invalid PrimitiveOperationType");
     }
   }
+
+  void EvaluateLookupTables(const EvaluationTemplate::Batch& batch) {
+    std::vector<ShareWrapper> inputs;
+    inputs.reserve(batch.lut_inputs.size());
+    for (const auto input : batch.lut_inputs) inputs.push_back(MakeShareFromWires({wires_[input]}));
+    const auto result{ConcatenateLifted(std::move(inputs)).LookupTable(batch.truth_tables)};
+    const auto& output_wires{result->GetWires()};
+    for (std::size_t i = 0; i < batch.output_wires.size(); ++i) {
+      wires_[batch.output_wires[i]] = output_wires[i];
+    }
+  }
+
+  const EvaluationTemplate& evaluation_template_;
+  Register& register_;
+  std::vector<WirePointer> wires_;
+};
+
+void CheckNumberOfInputWires(std::size_t number_of_input_wires,
+                             const std::vector<ShareWrapper>& input_wires) {
+  if (input_wires.empty()) throw std::invalid_argument("ShareWrapper cannot be empty");
+  if (number_of_input_wires != input_wires.size()) {
+    throw std::invalid_argument(fmt::format(
+        "ShareWrapper::Evaluate: expected a share of bit length {}, got a share of bit length {}",
+        number_of_input_wires, input_wires.size()));
+  }
+}
+
+// Boolean GMW circuits whose constant inputs are the same in all SIMD values use fused XOR gates
+bool UseFusedXors(const std::vector<ShareWrapper>& input_wires) {
+  const auto non_constant_input{
+      std::find_if(input_wires.begin(), input_wires.end(),
+                   [](const ShareWrapper& wire) { return !IsBooleanConstant(*wire); })};
+  const bool has_uniform_constants{
+      std::all_of(input_wires.begin(), input_wires.end(), [](const auto& wire) {
+        if (!IsBooleanConstant(*wire)) return true;
+        const auto hamming_weight{GetConstantBits(wire->GetWires().at(0)).HammingWeight()};
+        return hamming_weight == 0 || hamming_weight == wire->GetNumberOfSimdValues();
+      })};
+  return non_constant_input != input_wires.end() &&
+         (*non_constant_input)->GetProtocol() == MpcProtocol::kBooleanGmw && has_uniform_constants;
 }
 
+}  // namespace
+
 ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm) const {
-  std::size_t number_of_input_wires = algorithm.number_of_input_wires_parent_a;
-  if (algorithm.number_of_input_wires_parent_b)
-    number_of_input_wires += *algorithm.number_of_input_wires_parent_b;
+  return Evaluate(algorithm, Split());
+}
 
-  if (number_of_input_wires != share_->GetBitLength()) {
-    share_->GetRegister()->GetLogger()->LogError(fmt::format(
-        "ShareWrapper::Evaluate: expected a share of bit length {}, got a share of bit length {}",
-        number_of_input_wires, share_->GetBitLength()));
+ShareWrapper ShareWrapper::Evaluate(
+    const std::shared_ptr<const AlgorithmDescription>& algorithm) const {
+  auto input_wires{Split()};
+  if (UseFusedXors(input_wires)) return Evaluate(*algorithm, std::move(input_wires));
+  return Evaluate(*share_->GetRegister()->GetEvaluationTemplate(algorithm),
+                  std::move(input_wires));
+}
+
+ShareWrapper ShareWrapper::Evaluate(const AlgorithmDescription& algorithm,
+                                    std::vector<ShareWrapper> share_split_in_wires) {
+  CheckNumberOfInputWires(algorithm.number_of_input_wires_parent_a +
+                              algorithm.number_of_input_wires_parent_b.value_or(0),
+                          share_split_in_wires);
+  if (UseFusedXors(share_split_in_wires)) {
+    return FusedXorCircuitBuilder(algorithm, std::move(share_split_in_wires)).Build();
   }
+  return Evaluate(EvaluationTemplate(algorithm), std::move(share_split_in_wires));
+}
 
-  auto share_split_in_wires{Split()};
-  std::vector<std::shared_ptr<ShareWrapper>> pointers_to_wires_of_split_share;
-  pointers_to_wires_of_split_share.reserve(share_split_in_wires.size());
-  for (const auto& w : share_split_in_wires)
-    pointers_to_wires_of_split_share.emplace_back(std::make_shared<ShareWrapper>(w.Get()));
+ShareWrapper ShareWrapper::Evaluate(const EvaluationTemplate& evaluation_template,
+                                    std::vector<ShareWrapper> input_wires) {
+  CheckNumberOfInputWires(evaluation_template.GetNumberOfInputWires(), input_wires);
+  return BatchedCircuitBuilder(evaluation_template, input_wires).Build();
+}
 
-  pointers_to_wires_of_split_share.resize(algorithm.number_of_wires, nullptr);
+std::vector<ShareWrapper> ShareWrapper::EvaluateSimd(const AlgorithmDescription& algorithm,
+                                                    std::span<const ShareWrapper> inputs) {
+  std::vector<ShareWrapper> outputs(inputs.size());
+  std::map<MpcProtocol, std::vector<std::size_t>> groups;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (!inputs[i].Get()) throw std::invalid_argument("ShareWrapper cannot be empty");
+    groups[inputs[i]->GetProtocol()].push_back(i);
+  }
+  for (const auto& [protocol, group] : groups) {
+    const bool has_single_simd_values{std::all_of(group.begin(), group.end(), [&inputs](auto i) {
+      return inputs[i]->GetNumberOfSimdValues() == 1;
+    })};
+    // batching constructs a SimdifyGate, the circuit and one UnsimdifyGate or a SubsetGate per
+    // input instead of the circuit per input
+    const std::size_t number_of_split_gates{has_single_simd_values ? 1 : group.size()};
+    const bool batch{protocol != MpcProtocol::kBooleanConstant &&
+                     (group.size() - 1) * algorithm.gates.size() > 1 + number_of_split_gates};
+    std::optional<ShareWrapper> result;
+    if (batch) {
+      std::vector<ShareWrapper> group_inputs;
+      group_inputs.reserve(group.size());
+      for (const auto i : group) group_inputs.push_back(inputs[i]);
+      result = Simdify(group_inputs).Evaluate(algorithm);
+    }
+    // a constant output cannot be split up by SubsetGates
+    if (!result || IsBooleanConstant(**result)) {
+      for (const auto i : group) outputs[i] = inputs[i].Evaluate(algorithm);
+    } else if (has_single_simd_values) {
+      const auto split{result->Unsimdify()};
+      for (std::size_t k = 0; k < group.size(); ++k) outputs[group[k]] = split[k];
+    } else {
+      std::size_t offset{0};
+      for (const auto i : group) {
+        std::vector<std::size_t> positions(inputs[i]->GetNumberOfSimdValues());
+        std::iota(positions.begin(), positions.end(), offset);
+        offset += positions.size();
+        outputs[i] = result->Subset(std::move(positions));
+      }
+    }
+  }
+  return outputs;
+}
 
-  assert((algorithm.number_of_gates + number_of_input_wires) ==
-         pointers_to_wires_of_split_share.size());
+namespace {
 
-  for (std::size_t wire_i = number_of_input_wires, gate_i = 0; wire_i < algorithm.number_of_wires;
-       ++wire_i, ++gate_i) {
-    const auto& gate = algorithm.gates.at(gate_i);
-    const auto type = gate.type;
-    switch (type) {
-      case PrimitiveOperationType::kXor: {
-        assert(gate.parent_b);
-        pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) ^
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+template <typename T>
+std::vector<ShareWrapper> EvaluateArithmeticCircuit(const ArithmeticAlgorithmDescription& algorithm,
+                                                    std::span<const ShareWrapper> inputs) {
+  Backend& backend{inputs[0]->GetBackend()};
+  const auto number_of_simd{inputs[0]->GetNumberOfSimdValues()};
+  std::vector<ShareWrapper> wires(algorithm.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  // one constant share per factor of kConstantMul
+  std::unordered_map<std::uint64_t, ShareWrapper> constants;
+  for (const auto& gate : algorithm.gates) {
+    const auto& inputs_of_gate{gate.inputs};
+    auto& output{wires[gate.output_wire]};
+    switch (gate.type) {
+      case ArithmeticOperationType::kAdd:
+        output = wires[inputs_of_gate[0]] + wires[inputs_of_gate[1]];
         break;
-      }
-      case PrimitiveOperationType::kAnd: {
-        assert(gate.parent_b);
-        pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) &
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+      case ArithmeticOperationType::kMul:
+        output = wires[inputs_of_gate[0]] * wires[inputs_of_gate[1]];
         break;
-      }
-      case PrimitiveOperationType::kOr: {
-        assert(gate.parent_b);
-        pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(*pointers_to_wires_of_split_share.at(gate.parent_a) |
-                                           *pointers_to_wires_of_split_share.at(*gate.parent_b));
+      case ArithmeticOperationType::kConstantMul: {
+        auto& constant{constants[gate.constant]};
+        if (!constant.Get()) {
+          constant = backend.ConstantArithmeticGmwInput<T>(
+              std::vector<T>(number_of_simd, static_cast<T>(gate.constant)));
+        }
+        output = wires[inputs_of_gate[0]] * constant;
         break;
       }
-      case PrimitiveOperationType::kInv: {
-        pointers_to_wires_of_split_share.at(gate.output_wire) =
-            std::make_shared<ShareWrapper>(~*pointers_to_wires_of_split_share.at(gate.parent_a));
+      case ArithmeticOperationType::kDot: {
+        const std::size_t length{inputs_of_gate.size() / 2};
+        std::vector<ShareWrapper> a, b;
+        a.reserve(length);
+        b.reserve(length);
+        for (std::size_t i = 0; i < length; ++i) {
+          a.push_back(wires[inputs_of_gate[i]]);
+          b.push_back(wires[inputs_of_gate[length + i]]);
+        }
+        // both ASTRA and arithmetic GMW compute the inner product in a single gate
+        output = DotProduct(a, b);
         break;
       }
       default:
-        throw std::runtime_error("Invalid PrimitiveOperationType");
+        throw std::invalid_argument(
+            fmt::format("Cannot evaluate arithmetic operation {}", to_string(gate.type)));
     }
   }
+  return {wires.end() - algorithm.number_of_output_wires, wires.end()};
+}
 
-  std::vector<ShareWrapper> output;
-  output.reserve(pointers_to_wires_of_split_share.size() - algorithm.number_of_output_wires);
-  for (auto i = pointers_to_wires_of_split_share.size() - algorithm.number_of_output_wires;
-       i < pointers_to_wires_of_split_share.size(); i++) {
-    output.emplace_back(*pointers_to_wires_of_split_share.at(i));
-  }
+}  // namespace
 
-  return ShareWrapper::Concatenate(output);
+std::vector<ShareWrapper> ShareWrapper::Evaluate(const ArithmeticAlgorithmDescription& algorithm,
+                                                 std::span<const ShareWrapper> inputs) {
+  if (inputs.size() != algorithm.number_of_input_wires) {
+    throw std::invalid_argument(fmt::format("Arithmetic circuit expects {} inputs but got {}",
+                                            algorithm.number_of_input_wires, inputs.size()));
+  }
+  if (inputs.empty()) throw std::invalid_argument("Arithmetic circuit has no inputs");
+  for (const auto& input : inputs) {
+    if (!input.Get()) throw std::invalid_argument("ShareWrapper cannot be empty");
+    if (input->GetProtocol() != inputs[0]->GetProtocol() ||
+        (input->GetProtocol() != MpcProtocol::kArithmeticGmw &&
+         input->GetProtocol() != MpcProtocol::kAstra)) {
+      throw std::invalid_argument(
+          "Arithmetic circuits are evaluated on arithmetic GMW or ASTRA shares of one protocol");
+    }
+    if (input->GetBitLength() != algorithm.bit_length ||
+        input->GetNumberOfSimdValues() != inputs[0]->GetNumberOfSimdValues()) {
+      throw std::invalid_argument(fmt::format(
+          "Arithmetic circuit expects inputs of {} bits and of the same number of SIMD values",
+          algorithm.bit_length));
+    }
+  }
+  switch (algorithm.bit_length) {
+    case 8:
+      return EvaluateArithmeticCircuit<std::uint8_t>(algorithm, inputs);
+    case 16:
+      return EvaluateArithmeticCircuit<std::uint16_t>(algorithm, inputs);
+    case 32:
+      return EvaluateArithmeticCircuit<std::uint32_t>(algorithm, inputs);
+    case 64:
+      return EvaluateArithmeticCircuit<std::uint64_t>(algorithm, inputs);
+    default:
+      throw std::bad_cast();
+  }
 }
 
 void ShareWrapper::ShareConsistencyCheck() const {
@@ -850,6 +2229,11 @@ T ShareWrapper::As() const {
       auto astra_wire = std::dynamic_pointer_cast<proto::astra::Wire<T>>(share_->GetWires()[0]);
       assert(astra_wire);
       return astra_wire->GetValues()[0].value;
+    } else if (share_->GetProtocol() == MpcProtocol::kArithmeticReplicated) {
+      auto replicated_wire =
+          std::dynamic_pointer_cast<proto::replicated::ArithmeticWire<T>>(share_->GetWires()[0]);
+      assert(replicated_wire);
+      return replicated_wire->GetValues()[0];
     } else {
       throw std::invalid_argument("Unsupported arithmetic protocol in ShareWrapper::As()");
     }
@@ -887,6 +2271,12 @@ T ShareWrapper::As() const {
         result[i] = values[i].value;
       }
       return result;
+    } else if (share_->GetProtocol() == MpcProtocol::kArithmeticReplicated) {
+      auto replicated_wire =
+          std::dynamic_pointer_cast<proto::replicated::ArithmeticWire<typename T::value_type>>(
+              share_->GetWires()[0]);
+      assert(replicated_wire);
+      return replicated_wire->GetValues();
     } else {
       throw std::invalid_argument("Unsupported arithmetic protocol in ShareWrapper::As()");
     }
@@ -932,6 +2322,11 @@ bool ShareWrapper::As<bool>() const {
     auto gc_wire = std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(share_->GetWires()[0]);
     assert(gc_wire);
     return gc_wire->CopyPermutationBits()[0];
+  } else if (share_->GetProtocol() == MpcProtocol::kBooleanReplicated) {
+    auto replicated_wire =
+        std::dynamic_pointer_cast<proto::replicated::BooleanWire>(share_->GetWires()[0]);
+    assert(replicated_wire);
+    return replicated_wire->GetValues()[0];
   } else {
     throw std::invalid_argument("Unsupported Boolean protocol in ShareWrapper::As()");
   }
@@ -962,6 +2357,11 @@ BitVector<> ShareWrapper::As() const {
     auto gc_wire = std::dynamic_pointer_cast<proto::garbled_circuit::Wire>(share_->GetWires()[0]);
     assert(gc_wire);
     return gc_wire->CopyPermutationBits();
+  } else if (share_->GetProtocol() == MpcProtocol::kBooleanReplicated) {
+    auto replicated_wire =
+        std::dynamic_pointer_cast<proto::replicated::BooleanWire>(share_->GetWires()[0]);
+    assert(replicated_wire);
+    return replicated_wire->GetValues();
   } else {
     throw std::invalid_argument("Unsupported Boolean protocol in ShareWrapper::As()");
   }
@@ -1047,6 +2447,19 @@ ShareWrapper ShareWrapper::Add(SharePointer share, SharePointer other) const {
 
       return ShareWrapper(result);
     }
+    case MpcProtocol::kArithmeticReplicated: {
+      auto this_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(share);
+      auto other_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(other);
+      if (!this_a || !other_a) {
+        throw std::invalid_argument(
+            "ShareWrapper::Add expects two arithmetic replicated shares of the same bit length");
+      }
+      auto addition_gate =
+          share_->GetRegister()->EmplaceGate<proto::replicated::AdditionGate<T>>(
+              this_a->GetArithmeticWire(), other_a->GetArithmeticWire());
+      auto result = std::static_pointer_cast<Share>(addition_gate->GetOutputAsReplicatedShare());
+      return ShareWrapper(result);
+    }
     default:
       throw std::invalid_argument("Unsupported Arithmetic protocol in ShareWrapper::Add");
   }
@@ -1093,6 +2506,19 @@ ShareWrapper ShareWrapper::Sub(SharePointer share, SharePointer other) const {
       auto result = std::static_pointer_cast<Share>(subtraction_gate->GetOutputAsAstraShare());
       return result;
     }
+    case MpcProtocol::kArithmeticReplicated: {
+      auto this_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(share);
+      auto other_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(other);
+      if (!this_a || !other_a) {
+        throw std::invalid_argument(
+            "ShareWrapper::Sub expects two arithmetic replicated shares of the same bit length");
+      }
+      auto subtraction_gate =
+          share_->GetRegister()->EmplaceGate<proto::replicated::SubtractionGate<T>>(
+              this_a->GetArithmeticWire(), other_a->GetArithmeticWire());
+      auto result = std::static_pointer_cast<Share>(subtraction_gate->GetOutputAsReplicatedShare());
+      return ShareWrapper(result);
+    }
     default:
       throw std::invalid_argument("Unsupported Arithmetic protocol in ShareWrapper::Sub");
   }
@@ -1158,6 +2584,17 @@ ShareWrapper ShareWrapper::Mul(SharePointer share, SharePointer other) const {
       assert(this_a);
       auto this_wire_a = this_a->GetAstraWire();
 
+      if (other->IsConstant()) {
+        auto constant_wire =
+            std::dynamic_pointer_cast<proto::ConstantArithmeticWire<T>>(other->GetWires()[0]);
+        assert(constant_wire);
+        auto multiplication_gate =
+            share_->GetRegister()->EmplaceGate<proto::astra::ConstantMultiplicationGate<T>>(
+                this_wire_a, constant_wire->GetValues());
+        return ShareWrapper(
+            std::static_pointer_cast<Share>(multiplication_gate->GetOutputAsAstraShare()));
+      }
+
       auto other_a = std::dynamic_pointer_cast<proto::astra::Share<T>>(other);
       assert(other_a);
       auto other_wire_a = other_a->GetAstraWire();
@@ -1168,6 +2605,20 @@ ShareWrapper ShareWrapper::Mul(SharePointer share, SharePointer other) const {
       auto result = std::static_pointer_cast<Share>(multiplication_gate->GetOutputAsAstraShare());
       return ShareWrapper(result);
     }
+    case MpcProtocol::kArithmeticReplicated: {
+      auto this_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(share);
+      auto other_a = std::dynamic_pointer_cast<proto::replicated::ArithmeticShare<T>>(other);
+      if (!this_a || !other_a) {
+        throw std::invalid_argument(
+            "ShareWrapper::Mul expects two arithmetic replicated shares of the same bit length");
+      }
+      auto multiplication_gate =
+          share_->GetRegister()->EmplaceGate<proto::replicated::MultiplicationGate<T>>(
+              this_a->GetArithmeticWire(), other_a->GetArithmeticWire());
+      auto result =
+          std::static_pointer_cast<Share>(multiplication_gate->GetOutputAsReplicatedShare());
+      return ShareWrapper(result);
+    }
     default:
       throw std::invalid_argument("Unsupported Arithmetic protocol in ShareWrapper::Mul");
   }
@@ -1190,16 +2641,56 @@ ShareWrapper ShareWrapper::GreaterThan(SharePointer share, SharePointer other) c
   assert(other_a);
   auto other_wire_a = other_a->GetArithmeticWire();
 
-  std::size_t l_s = 7;
-
   auto greater_than_gate =
       share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::GreaterThanGate<T>>(
-          this_wire_a, other_wire_a, l_s);
+          this_wire_a, other_wire_a, GetGreaterThanChunkBitLength());
   auto result = std::static_pointer_cast<Share>(greater_than_gate->GetOutputAsGmwShare());
 
   return ShareWrapper(result);
 }
 
+template <typename T>
+ShareWrapper ShareWrapper::Equal(SharePointer share, SharePointer other) const {
+  auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share);
+  assert(this_a);
+  auto this_wire_a = this_a->GetArithmeticWire();
+
+  auto other_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(other);
+  assert(other_a);
+  auto other_wire_a = other_a->GetArithmeticWire();
+
+  auto equality_gate =
+      share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::EqualityGate<T>>(
+          this_wire_a, other_wire_a, GetGreaterThanChunkBitLength());
+  auto result = std::static_pointer_cast<Share>(equality_gate->GetOutputAsGmwShare());
+
+  return ShareWrapper(result);
+}
+
+template <typename T>
+ShareWrapper ShareWrapper::Sign(SharePointer share) const {
+  auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share);
+  assert(this_a);
+  auto this_wire_a = this_a->GetArithmeticWire();
+
+  auto sign_gate = share_->GetRegister()->template EmplaceGate<proto::arithmetic_gmw::SignGate<T>>(
+      this_wire_a, GetGreaterThanChunkBitLength());
+  auto result = std::static_pointer_cast<Share>(sign_gate->GetOutputAsGmwShare());
+
+  return ShareWrapper(result);
+}
+
+std::size_t ShareWrapper::GetGreaterThanChunkBitLength() const {
+  const auto& configuration{share_->GetBackend().GetConfiguration()};
+  std::size_t l_s = configuration->GetGreaterThanChunkBitLength();
+  if (l_s == 0) {
+    l_s = proto::arithmetic_gmw::SelectGreaterThanChunkBitLength(
+        share_->GetBitLength(), share_->GetNumberOfSimdValues(),
+        configuration->GetNetworkRoundTripTime(), configuration->GetNetworkBandwidth());
+  }
+  return l_s;
+}
+
 template ShareWrapper ShareWrapper::GreaterThan<std::uint8_t>(SharePointer share,
                                                               SharePointer other) const;
 template ShareWrapper ShareWrapper::GreaterThan<std::uint16_t>(SharePointer share,
@@ -1244,6 +2735,26 @@ ShareWrapper ShareWrapper::Square(SharePointer share) const {
   return ShareWrapper(result);
 }
 
+template <typename T>
+ShareWrapper ShareWrapper::Truncate(SharePointer share, std::size_t number_of_bits) const {
+  if (share->GetProtocol() == MpcProtocol::kAstra) {
+    auto this_astra = std::dynamic_pointer_cast<proto::astra::Share<T>>(share);
+    assert(this_astra);
+    auto truncation_gate = share_->GetRegister()->EmplaceGate<proto::astra::TruncationGate<T>>(
+        this_astra->GetAstraWire(), number_of_bits);
+    return ShareWrapper(std::static_pointer_cast<Share>(truncation_gate->GetOutputAsAstraShare()));
+  }
+  auto this_a = std::dynamic_pointer_cast<proto::arithmetic_gmw::Share<T>>(share);
+  assert(this_a);
+  auto this_wire_a = this_a->GetArithmeticWire();
+
+  auto truncation_gate =
+      share_->GetRegister()->EmplaceGate<proto::arithmetic_gmw::TruncationGate<T>>(
+          this_wire_a, number_of_bits);
+  auto result = std::static_pointer_cast<Share>(truncation_gate->GetOutputAsArithmeticShare());
+  return ShareWrapper(result);
+}
+
 template ShareWrapper ShareWrapper::Mul<std::uint8_t>(SharePointer share, SharePointer other) const;
 template ShareWrapper ShareWrapper::Mul<std::uint16_t>(SharePointer share,
                                                        SharePointer other) const;
@@ -1283,6 +2794,10 @@ ShareWrapper ShareWrapper::DotProduct(std::span<ShareWrapper> a, std::span<Share
       auto result = std::static_pointer_cast<Share>(dot_product_gate->GetOutputAsAstraShare());
       return ShareWrapper(result);
     }
+    case MpcProtocol::kArithmeticGmw: {
+      // the inner product is the product of the 1 x k matrix a and the k x 1 matrix b
+      return MatrixMultiplication<T>(a, b, 1, 1)[0];
+    }
     default:
       throw std::invalid_argument("Unsupported Arithmetic protocol in ShareWrapper::DotProduct");
   }
@@ -1297,16 +2812,132 @@ template ShareWrapper ShareWrapper::DotProduct<std::uint32_t>(std::span<ShareWra
 template ShareWrapper ShareWrapper::DotProduct<std::uint64_t>(std::span<ShareWrapper> a,
                                                               std::span<ShareWrapper> b) const;
 
+template <typename T>
+std::vector<ShareWrapper> ShareWrapper::MatrixMultiplication(std::span<ShareWrapper> a,
+                                                             std::span<ShareWrapper> b,
+                                                             std::size_t number_of_rows,
+                                                             std::size_t number_of_columns) const {
+  switch (a[0]->GetProtocol()) {
+    case MpcProtocol::kAstra: {
+      auto collect_wires = [](std::span<ShareWrapper> matrix) {
+        std::vector<WirePointer> wires;
+        wires.reserve(matrix.size());
+        for (auto& entry : matrix) {
+          if (entry->GetProtocol() != MpcProtocol::kAstra) {
+            throw std::invalid_argument("Mixed protocols in ShareWrapper::MatrixMultiplication");
+          }
+          assert(entry->GetWires().size() == 1);
+          wires.emplace_back(entry->GetWires()[0]);
+        }
+        return std::make_shared<proto::astra::Share<T>>(wires);
+      };
+      auto product = share_->GetBackend().template AstraMatrixMultiplication<T>(
+          collect_wires(a), collect_wires(b), number_of_rows, number_of_columns);
+      return ShareWrapper(product).Split();
+    }
+    case MpcProtocol::kArithmeticGmw: {
+      auto collect_wires = [](std::span<ShareWrapper> matrix) {
+        std::vector<WirePointer> wires;
+        wires.reserve(matrix.size());
+        for (auto& entry : matrix) {
+          if (entry->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+            throw std::invalid_argument("Mixed protocols in ShareWrapper::MatrixMultiplication");
+          }
+          assert(entry->GetWires().size() == 1);
+          wires.emplace_back(entry->GetWires()[0]);
+        }
+        return wires;
+      };
+      auto gate = share_->GetRegister()
+                      ->EmplaceGate<proto::arithmetic_gmw::MatrixMultiplicationGate<T>>(
+                          collect_wires(a), collect_wires(b), number_of_rows, number_of_columns);
+      std::vector<ShareWrapper> result;
+      for (auto& entry : gate->GetOutputsAsArithmeticShares()) {
+        result.emplace_back(std::static_pointer_cast<Share>(entry));
+      }
+      return result;
+    }
+    default: {
+      // compose the product from dot products of the rows of a and the columns of b
+      if (number_of_rows == 0 || a.size() % number_of_rows != 0 || number_of_columns == 0 ||
+          b.size() != a.size() / number_of_rows * number_of_columns) {
+        throw std::invalid_argument("Mismatching dimensions in ShareWrapper::MatrixMultiplication");
+      }
+      const std::size_t inner_dimension{a.size() / number_of_rows};
+      std::vector<ShareWrapper> result;
+      result.reserve(number_of_rows * number_of_columns);
+      for (std::size_t i = 0; i < number_of_rows; ++i) {
+        for (std::size_t j = 0; j < number_of_columns; ++j) {
+          ShareWrapper entry{a[i * inner_dimension] * b[j]};
+          for (std::size_t l = 1; l < inner_dimension; ++l) {
+            entry = entry + a[i * inner_dimension + l] * b[l * number_of_columns + j];
+          }
+          result.emplace_back(std::move(entry));
+        }
+      }
+      return result;
+    }
+  }
+}
+
+template std::vector<ShareWrapper> ShareWrapper::MatrixMultiplication<std::uint8_t>(
+    std::span<ShareWrapper> a, std::span<ShareWrapper> b, std::size_t number_of_rows,
+    std::size_t number_of_columns) const;
+template std::vector<ShareWrapper> ShareWrapper::MatrixMultiplication<std::uint16_t>(
+    std::span<ShareWrapper> a, std::span<ShareWrapper> b, std::size_t number_of_rows,
+    std::size_t number_of_columns) const;
+template std::vector<ShareWrapper> ShareWrapper::MatrixMultiplication<std::uint32_t>(
+    std::span<ShareWrapper> a, std::span<ShareWrapper> b, std::size_t number_of_rows,
+    std::size_t number_of_columns) const;
+template std::vector<ShareWrapper> ShareWrapper::MatrixMultiplication<std::uint64_t>(
+    std::span<ShareWrapper> a, std::span<ShareWrapper> b, std::size_t number_of_rows,
+    std::size_t number_of_columns) const;
+
 ShareWrapper ShareWrapper::Subset(std::vector<std::size_t>&& positions) {
   return Subset(std::span<const std::size_t>(positions));
 }
 
-ShareWrapper ShareWrapper::Subset(std::span<const std::size_t> positions) {
-  auto subset_gate = share_->GetRegister()->EmplaceGate<SubsetGate>(share_, positions);
+namespace {
+
+bool IsIdentity(const std::vector<WirePointer>& sources, std::span<const std::size_t> positions) {
+  if (positions.size() != sources.at(0)->GetNumberOfSimdValues()) return false;
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    if (positions[i] != i) return false;
+  }
+  return true;
+}
+
+// selects the SIMD values at positions of the source wires, where selecting all of them in their
+// order needs no gate
+ShareWrapper SubsetOfSources(const std::vector<WirePointer>& sources,
+                             std::vector<std::size_t>&& positions) {
+  auto source_share{MakeShareFromWires(sources)};
+  if (IsIdentity(sources, positions)) return source_share;
+  auto subset_gate =
+      source_share->GetRegister()->EmplaceGate<SubsetGate>(*source_share, std::move(positions));
   return ShareWrapper(subset_gate->GetOutputAsShare());
 }
 
+}  // namespace
+
+ShareWrapper ShareWrapper::Subset(std::span<const std::size_t> positions) {
+  // a subset of a view is a subset of its sources, see Wire::SetSimdView
+  const SimdView view{ResolveSimdView(share_->GetWires())};
+  const std::size_t number_of_simd{view.GetNumberOfSimdValues()};
+  std::vector<std::size_t> source_positions(positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    if (positions[i] >= number_of_simd) {
+      throw std::out_of_range(
+          fmt::format("Trying to access SIMD value #{} out of {} SIMD values in Subset",
+                      positions[i], number_of_simd));
+    }
+    source_positions[i] = view.GetPosition(positions[i]);
+  }
+  return SubsetOfSources(view.sources, std::move(source_positions));
+}
+
 std::vector<ShareWrapper> ShareWrapper::Unsimdify() {
+  if (share_->GetNumberOfSimdValues() == 1) return {*this};
   auto unsimdify_gate = share_->GetRegister()->EmplaceGate<UnsimdifyGate>(share_);
   std::vector<SharePointer> shares{unsimdify_gate->GetOutputAsVectorOfShares()};
   std::vector<ShareWrapper> result(shares.size());
@@ -1324,10 +2955,181 @@ ShareWrapper ShareWrapper::Simdify(std::span<const ShareWrapper> input) {
 
 ShareWrapper ShareWrapper::Simdify(std::span<SharePointer> input) {
   if (input.empty()) throw std::invalid_argument("Empty inputs in ShareWrapper::Simdify");
-  auto simdify_gate = input[0]->GetRegister()->EmplaceGate<SimdifyGate>(input);
-  return simdify_gate->GetOutputAsShare();
+  // views of the same sources, e.g., from Unsimdify, are composed into a subset of the sources
+  std::vector<SimdView> views;
+  views.reserve(input.size());
+  for (const auto& share : input) {
+    views.emplace_back(ResolveSimdView(share->GetWires()));
+    if (views.back().sources != views.front().sources) {
+      auto simdify_gate = input[0]->GetRegister()->EmplaceGate<SimdifyGate>(input);
+      return simdify_gate->GetOutputAsShare();
+    }
+  }
+  std::vector<std::size_t> source_positions;
+  for (const auto& view : views) {
+    for (std::size_t i = 0; i < view.GetNumberOfSimdValues(); ++i) {
+      source_positions.emplace_back(view.GetPosition(i));
+    }
+  }
+  // SubsetGate does not support ASTRA
+  if (input[0]->GetProtocol() == MpcProtocol::kAstra &&
+      !IsIdentity(views.front().sources, source_positions)) {
+    auto simdify_gate = input[0]->GetRegister()->EmplaceGate<SimdifyGate>(input);
+    return simdify_gate->GetOutputAsShare();
+  }
+  return SubsetOfSources(views.front().sources, std::move(source_positions));
 }
 
 ShareWrapper ShareWrapper::Simdify(std::vector<ShareWrapper>&& input) { return Simdify(input); }
 
+namespace {
+
+template <typename T>
+SharePointer ArithmeticSwitchInput(Backend& backend, std::size_t permuting_party,
+                                   const std::vector<bool>& swaps) {
+  return backend.ArithmeticGmwInput<T>(permuting_party, std::vector<T>(swaps.begin(), swaps.end()));
+}
+
+// the switch bits of a layer of a permutation network as shares of protocol, with the bit length
+// of the permuted values for arithmetic GMW
+ShareWrapper SwitchInput(Backend& backend, MpcProtocol protocol, std::size_t bit_length,
+                         std::size_t permuting_party, const std::vector<bool>& swaps) {
+  switch (protocol) {
+    case MpcProtocol::kArithmeticGmw: {
+      switch (bit_length) {
+        case 8u:
+          return ArithmeticSwitchInput<std::uint8_t>(backend, permuting_party, swaps);
+        case 16u:
+          return ArithmeticSwitchInput<std::uint16_t>(backend, permuting_party, swaps);
+        case 32u:
+          return ArithmeticSwitchInput<std::uint32_t>(backend, permuting_party, swaps);
+        case 64u:
+          return ArithmeticSwitchInput<std::uint64_t>(backend, permuting_party, swaps);
+        default:
+          throw std::invalid_argument(
+              fmt::format("Invalid arithmetic bit length {} in Permute", bit_length));
+      }
+    }
+    case MpcProtocol::kBooleanGmw:
+      return backend.BooleanGmwInput(permuting_party, BitVector<>(swaps));
+    case MpcProtocol::kBmr:
+      return backend.BmrInput(permuting_party, BitVector<>(swaps));
+    default:
+      throw std::invalid_argument(
+          fmt::format("Permute does not support protocol {}", to_string(protocol)));
+  }
+}
+
+}  // namespace
+
+ShareWrapper ShareWrapper::Permute(std::span<const std::size_t> permutation,
+                                   std::size_t permuting_party) const {
+  assert(share_);
+  const MpcProtocol protocol{share_->GetProtocol()};
+  if (protocol != MpcProtocol::kArithmeticGmw && protocol != MpcProtocol::kBooleanGmw &&
+      protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Permute does not support protocol {}", to_string(protocol)));
+  }
+  auto& backend{share_->GetBackend()};
+  const std::size_t number_of_simd{share_->GetNumberOfSimdValues()};
+  const bool is_permuting_party{backend.GetConfiguration()->GetMyId() == permuting_party};
+  if (is_permuting_party && permutation.size() != number_of_simd) {
+    throw std::invalid_argument(
+        fmt::format("Permutation of {} values for a share of {} SIMD values", permutation.size(),
+                    number_of_simd));
+  }
+  if (number_of_simd == 1) return *this;
+
+  // the network positions beyond the SIMD values hold copies of SIMD value 0, stay at their
+  // positions and are dropped in the end.  The network is the same for all parties, the others
+  // route the identity.
+  const std::size_t size{std::bit_ceil(number_of_simd)};
+  std::vector<std::size_t> padded_permutation(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    padded_permutation[i] = is_permuting_party && i < number_of_simd ? permutation[i] : i;
+  }
+  const auto layers{algorithm::RoutePermutationNetwork(padded_permutation)};
+
+  // order[p] is the SIMD value of result that holds network position p
+  std::vector<std::size_t> order(size, 0);
+  for (std::size_t i = 0; i < number_of_simd; ++i) order[i] = i;
+  ShareWrapper result{*this};
+  const std::size_t half{size / 2};
+  for (const auto& layer : layers) {
+    std::vector<std::size_t> first(half), second(half);
+    for (std::size_t i = 0; i < half; ++i) {
+      first[i] = order[layer.first[i]];
+      second[i] = order[layer.second[i]];
+    }
+    auto a{result.Subset(std::move(first))};
+    auto b{result.Subset(std::move(second))};
+    const auto switches{
+        SwitchInput(backend, protocol, share_->GetBitLength(), permuting_party, layer.swaps)};
+    // a, b <- s ? b : a, s ? a : b
+    if (protocol == MpcProtocol::kArithmeticGmw) {
+      const auto difference{switches * (b - a)};
+      a += difference;
+      b -= difference;
+    } else {
+      const auto difference{
+          ShareWrapper::Concatenate(std::vector<ShareWrapper>(share_->GetBitLength(), switches)) &
+          (a ^ b)};
+      a ^= difference;
+      b ^= difference;
+    }
+    result = ShareWrapper::Simdify(std::vector<ShareWrapper>{a, b});
+    for (std::size_t i = 0; i < half; ++i) {
+      order[layer.first[i]] = i;
+      order[layer.second[i]] = half + i;
+    }
+  }
+  order.resize(number_of_simd);
+  return result.Subset(std::move(order));
+}
+
+ShareWrapper ShareWrapper::Shuffle() const {
+  assert(share_);
+  const auto& configuration{share_->GetBackend().GetConfiguration()};
+  ShareWrapper result{*this};
+  for (std::size_t party_id = 0; party_id < configuration->GetNumOfParties(); ++party_id) {
+    const auto permutation{party_id == configuration->GetMyId()
+                               ? algorithm::RandomPermutation(share_->GetNumberOfSimdValues())
+                               : std::vector<std::size_t>{}};
+    result = result.Permute(permutation, party_id);
+  }
+  return result;
+}
+
+ShareWrapper ShareWrapper::Scan(
+    const std::function<ShareWrapper(const ShareWrapper&, const ShareWrapper&)>& op) const {
+  assert(share_);
+  const MpcProtocol protocol{share_->GetProtocol()};
+  if (protocol != MpcProtocol::kArithmeticGmw && protocol != MpcProtocol::kBooleanGmw &&
+      protocol != MpcProtocol::kBmr) {
+    throw std::invalid_argument(
+        fmt::format("Scan does not support protocol {}", to_string(protocol)));
+  }
+  const std::size_t number_of_simd{share_->GetNumberOfSimdValues()};
+  // Hillis-Steele: after the level of distance d, SIMD value i holds the scan of the values
+  // (i - 2d, i], s.t. the values below distance are final and stay untouched
+  ShareWrapper result{*this};
+  for (std::size_t distance = 1; distance < number_of_simd; distance *= 2) {
+    std::vector<std::size_t> final_positions(distance), upper_positions(number_of_simd - distance),
+        lower_positions(number_of_simd - distance);
+    std::iota(final_positions.begin(), final_positions.end(), 0);
+    std::iota(upper_positions.begin(), upper_positions.end(), distance);
+    std::iota(lower_positions.begin(), lower_positions.end(), 0);
+    auto combined{op(result.Subset(std::move(upper_positions)),
+                     result.Subset(std::move(lower_positions)))};
+    result = ShareWrapper::Simdify(
+        std::vector<ShareWrapper>{result.Subset(std::move(final_positions)), combined});
+  }
+  return result;
+}
+
+ShareWrapper ShareWrapper::PrefixSum() const {
+  return Scan([](const ShareWrapper& a, const ShareWrapper& b) { return b + a; });
+}
+
 }  // namespace encrypto::motion
@@ -24,16 +24,20 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <span>
 #include <vector>
 
+#include "utility/bit_vector.h"
 #include "utility/typedefs.h"
 
 namespace encrypto::motion {
 
 struct AlgorithmDescription;
+struct ArithmeticAlgorithmDescription;
+class EvaluationTemplate;
 
 class SecureUnsignedInteger;
 
@@ -96,6 +100,23 @@ class ShareWrapper {
   
   friend ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b);
 
+/// \brief Multiplies the row-major matrix \p a of \p number_of_rows rows by the row-major matrix
+///        \p b of \p number_of_columns columns, where each share is one entry.
+///
+/// In ASTRA, the product is computed by a single MatrixMultiplicationGate, i.e., with one setup
+/// and one online message for the whole matrix.  In arithmetic GMW, the single
+/// MatrixMultiplicationGate uses a matrix triple and opens m * k + k * n instead of 2 * m * k * n
+/// values.
+/// \return the entries of the product in row-major order
+std::vector<ShareWrapper> MatrixMultiplication(std::span<ShareWrapper> a, std::span<ShareWrapper> b,
+                                               std::size_t number_of_rows,
+                                               std::size_t number_of_columns);
+
+  friend std::vector<ShareWrapper> MatrixMultiplication(std::span<ShareWrapper> a,
+                                                        std::span<ShareWrapper> b,
+                                                        std::size_t number_of_rows,
+                                                        std::size_t number_of_columns);
+
 
   ShareWrapper operator==(const ShareWrapper& other) const;
 
@@ -107,10 +128,55 @@ class ShareWrapper {
 
   /****End here****/
 
-  // use this as the selection bit
-  // returns this ? a : b
+  ShareWrapper operator<(const ShareWrapper& other) const { return other > *this; }
+
+  ShareWrapper operator<=(const ShareWrapper& other) const { return ~(*this > other); }
+
+  ShareWrapper operator>=(const ShareWrapper& other) const { return ~(other > *this); }
+
+  /// \brief Returns the smaller of this and \p other.  In arithmetic GMW, the comparison is
+  /// combined with a hybrid multiplication instead of a Boolean multiplexer.
+  ShareWrapper Minimum(const ShareWrapper& other) const;
+
+  /// \brief Returns the larger of this and \p other, see Minimum.
+  ShareWrapper Maximum(const ShareWrapper& other) const;
+
+  /// \brief Returns a Boolean GMW share of the sign bit of the two's complement values of an
+  /// arithmetic GMW share, i.e., of this < 0, see proto::arithmetic_gmw::SignGate, which needs
+  /// two parties and is replaced by MostSignificantBit otherwise.  ASTRA shares are converted to
+  /// Boolean GMW for this, see AstraToBooleanGmwGate.
+  ShareWrapper Sign() const;
+
+  /// \brief Returns a Boolean GMW share of the \p number_of_bits bits from bit \p first_bit on of
+  /// an arithmetic GMW share.  Unlike Convert, which computes the carries of all l bits, only the
+  /// carry into bit first_bit is computed by a tree of depth log2(first_bit) and the carries of the
+  /// extracted bits by a prefix circuit of depth log2(number_of_bits), which needs less than half
+  /// the AND gates for the top bits, e.g., the sign bit.
+  /// \throws std::invalid_argument if the share is not an arithmetic GMW share or if the bits are
+  ///         empty or exceed its bit length.
+  ShareWrapper ExtractBits(std::size_t first_bit, std::size_t number_of_bits) const;
+
+  /// \brief Returns ExtractBits(l - 1, 1), the two's complement sign bit of the l-bit values of an
+  /// arithmetic GMW share, for any number of parties.
+  ShareWrapper MostSignificantBit() const;
+
+  /// \brief Shifts the two's complement values of an arithmetic GMW or ASTRA share to the right by
+  /// \p number_of_bits bits with probabilistic truncation, i.e., the result may exceed the exact
+  /// one by 1, see proto::arithmetic_gmw::TruncationGate and proto::astra::TruncationGate.
+  ShareWrapper Truncate(std::size_t number_of_bits) const;
+
+  /// \brief Returns this ? a : b for this selection bit.  For arithmetic GMW shares a and b, the
+  /// result is b + this * (a - b) with a single multiplication by this, which may be a Boolean
+  /// share of 1 wire or an arithmetic GMW share of the value 0 or 1.  A Boolean selection bit is
+  /// multiplied by HybridMultiplicationGate for two parties and converted by GmwToArithmeticGate
+  /// otherwise, s.t. a and b are never converted.
   ShareWrapper Mux(const ShareWrapper& a, const ShareWrapper& b) const;
 
+  /// \brief Converts the share to protocol \p P.  Arithmetic GMW shares are converted to Boolean
+  /// GMW with edaBits in 1 + log2(l) rounds, see ArithmeticGmwToBooleanGmwGate.  Conversions
+  /// from and to the two-party garbled circuit protocol are direct for arithmetic and Boolean GMW,
+  /// see ArithmeticGmwToGarbledCircuitGate and GarbledCircuitToArithmeticGmwGate, and go over
+  /// Boolean GMW for BMR.
   template <MpcProtocol P>
   ShareWrapper Convert() const;
 
@@ -149,16 +215,75 @@ class ShareWrapper {
   /// numbers of SIMD values.
   static ShareWrapper Concatenate(std::span<const ShareWrapper> input);
 
-  /// \brief evaluates AlgorithmDescription also on this->share_ as input.
+  /// \brief evaluates AlgorithmDescription also on this->share_ as input.  Outside of Boolean
+  /// GMW, the EvaluationTemplate of algo is compiled once and reused by Register.
   /// \returns the output share of the evaluated circuit as ShareWrapper.
-  ShareWrapper Evaluate(const std::shared_ptr<const AlgorithmDescription>& algo) const {
-    return Evaluate(*algo);
-  }
+  ShareWrapper Evaluate(const std::shared_ptr<const AlgorithmDescription>& algo) const;
 
   /// \brief constructs a circuit from AlgorithmDescription algo and sets this->share_ as input.
   /// \returns a share over the output wires of the constructed circuit.
   ShareWrapper Evaluate(const AlgorithmDescription& algo) const;
 
+  /// \brief constructs a circuit from AlgorithmDescription algo on the single-wire shares in
+  /// input_wires, which may mix public constants (kBooleanConstant) with shares in one Boolean
+  /// protocol. Gates with constant inputs are folded, e.g., an AND with a constant becomes wiring.
+  /// \returns a share over the output wires of the constructed circuit.
+  static ShareWrapper Evaluate(const AlgorithmDescription& algo,
+                               std::vector<ShareWrapper> input_wires);
+
+  /// \brief constructs the circuit of evaluation_template on the single-wire shares in
+  /// input_wires like Evaluate(const AlgorithmDescription&, std::vector<ShareWrapper>), but with a
+  /// single gate per batch of the template, except for gates with constant inputs.  Boolean GMW
+  /// circuits of the AlgorithmDescription overloads use fused XOR gates instead.
+  /// \returns a share over the output wires of the constructed circuit.
+  static ShareWrapper Evaluate(const EvaluationTemplate& evaluation_template,
+                               std::vector<ShareWrapper> input_wires);
+
+  /// \brief evaluates algo on each of the independent inputs, e.g., one per record, and returns
+  /// their outputs in the same order.  Inputs of the same protocol are simdified and evaluated
+  /// together as one circuit of their total number of SIMD values, whose outputs are split up by
+  /// Unsimdify or Subset, if this constructs fewer gates than evaluating them one by one.  Public
+  /// constant inputs are evaluated one by one.
+  /// \throws invalid_argument if an input is empty
+  static std::vector<ShareWrapper> EvaluateSimd(const AlgorithmDescription& algo,
+                                                std::span<const ShareWrapper> inputs);
+
+  /// \brief constructs the arithmetic circuit algo on inputs, which are arithmetic GMW or ASTRA
+  /// shares of its bit length with the same number of SIMD values.  Each gate maps to the gate of
+  /// the protocol, i.e., kConstantMul to a local multiplication and kDot to a single
+  /// DotProductGate in ASTRA and to a single MatrixMultiplicationGate in arithmetic GMW.
+  /// \returns a share of each output wire of algo
+  /// \throws std::invalid_argument if the inputs do not fit algo
+  static std::vector<ShareWrapper> Evaluate(const ArithmeticAlgorithmDescription& algo,
+                                            std::span<const ShareWrapper> inputs);
+
+  /// \brief computes the AND of the inputs, which have the same bit length and one protocol or are
+  /// public constants, in ceil(log_fan_in(N)) rounds with Boolean GMW multi-input AND gates of
+  /// fan-in up to min(fan_in, proto::boolean_gmw::kMaxAndFanIn).  Other protocols use a balanced
+  /// tree of binary ANDs.
+  /// \throws std::invalid_argument if inputs is empty or fan_in < 2.
+  static ShareWrapper MultiInputAnd(std::vector<ShareWrapper> inputs, std::size_t fan_in = 4);
+
+  /// \brief computes the XOR of the inputs, which have the same bit length and one protocol or are
+  /// public constants.  In Boolean GMW, this is a single FusedXorGate instead of a chain of N - 1
+  /// XOR gates, and public constants that are 0 or 1 in all SIMD values invert its outputs.  Other
+  /// protocols use a balanced tree of binary XORs.  See also XorExpression.
+  /// \throws std::invalid_argument if inputs is empty.
+  static ShareWrapper MultiInputXor(std::vector<ShareWrapper> inputs);
+
+  /// \brief computes the AND of all wires of this share, see MultiInputAnd.
+  ShareWrapper AndReduce(std::size_t fan_in = 4) const { return MultiInputAnd(Split(), fan_in); }
+
+  /// \brief computes the OR of all wires of this share as ~AndReduce(~x), see MultiInputAnd.
+  ShareWrapper OrReduce(std::size_t fan_in = 4) const { return ~(~*this).AndReduce(fan_in); }
+
+  /// \brief evaluates a lookup table with the k wires of this share as inputs in one round, see
+  /// proto::boolean_gmw::LookupTableGate.  truth_tables holds one table of 2^k bits per output
+  /// wire, where the first wire of this share is the least significant bit of the table index.
+  /// Public constants are looked up directly.
+  /// \throws std::invalid_argument for protocols other than Boolean GMW and Boolean constants.
+  ShareWrapper LookupTable(std::vector<BitVector<>> truth_tables) const;
+
   /// \brief constructs a SubsetGate that returns values stored at positions in this->share_.
   /// Internally calls ShareWrapper Subset(std::span<std::size_t> positions).
   ShareWrapper Subset(std::vector<std::size_t>&& positions);
@@ -169,6 +294,8 @@ class ShareWrapper {
   /// order. Repetitions of the positions as well as the number of output SIMD values being greater
   /// the the number of the input SIMD values is allowed, e.g., subset of {0,0} of a share with only
   /// 1 SIMD value would yield an output share that stores the same value as SIMD twice.
+  /// Subsets of outputs of Subset and Unsimdify select from their sources, see Wire::SetSimdView,
+  /// and selecting all SIMD values of the sources in their order constructs no gate.
   /// \throws out_of_range if at least one of the indices in positions is out of range.
   ShareWrapper Subset(std::span<const std::size_t> positions);
 
@@ -176,13 +303,15 @@ class ShareWrapper {
   /// UnsimdifyGate decomposes this->share_ into shares with exactly 1 SIMD value, e.g., if
   /// this->share_ contained s_0, s_1, and s_2 and SIMD values in this->share_, it will return an
   /// std::vector {s_0, s_1, s_2} as separate shares with exactly one SIMD value in each share.
+  /// Shares with exactly 1 SIMD value are returned as they are.
   /// \throws invalid_argument if any of the shares internally has an inconsistent number of SIMD
   /// values across the wires.
   /// \throws invalid_argument if this->share_ is "empty", i.e., contains 0 SIMD values.
   std::vector<ShareWrapper> Unsimdify();
 
   /// \brief constructs a SimdifyGate that composes the shares in input into a "larger" share with
-  /// all the input shares as SIMD values in one share.
+  /// all the input shares as SIMD values in one share.  If all of the input shares are views of the
+  /// same sources, e.g., the outputs of Unsimdify, the result is a Subset of the sources instead.
   /// \throws invalid_argument the shares in input are "empty", i.e., contain 0 SIMD values.
   /// \throws invalid_argument if any of the shares have inconsistent number of wires.
   /// \throws invalid_argument if any of the shares internally has an inconsistent number of SIMD
@@ -193,6 +322,33 @@ class ShareWrapper {
   /// Simdify(std::span<SharePointer> input) on the result.
   static ShareWrapper Simdify(std::span<const ShareWrapper> input);
 
+  /// \brief obliviously permutes the SIMD values of this->share_ by the permutation of
+  /// permuting_party, which moves SIMD value i to position permutation[i].  The other parties pass
+  /// an empty permutation.  The permutation is routed through a Benes network on the SIMD values
+  /// padded to n = 2^k, whose switch bits permuting_party inputs, i.e., it costs (2k - 1) * n / 2
+  /// AND gates per wire, or multiplications in arithmetic GMW, in 2k - 1 rounds.
+  /// \throws invalid_argument for protocols other than arithmetic GMW, Boolean GMW and BMR.
+  /// \throws invalid_argument if permutation is not a permutation of the SIMD values.
+  ShareWrapper Permute(std::span<const std::size_t> permutation,
+                       std::size_t permuting_party) const;
+
+  /// \brief obliviously shuffles the SIMD values of this->share_ by a random permutation of each
+  /// party in turn, see Permute, s.t. no proper subset of the parties knows the permutation.
+  ShareWrapper Shuffle() const;
+
+  /// \brief computes the inclusive scan of the SIMD values x_0, ..., x_{n-1} of this->share_ with
+  /// the associative \p op, i.e., SIMD value i of the result is x_0 op ... op x_i, by a
+  /// Hillis-Steele network of ceil(log2(n)) levels.  The level of distance d applies op once to
+  /// the n - d SIMD values shifted by d by Subset, s.t. the depth is ceil(log2(n)) times that of
+  /// op instead of n - 1 for a chain.  op gets the later values as its first argument.
+  /// \throws invalid_argument for protocols other than arithmetic GMW, Boolean GMW and BMR.
+  ShareWrapper Scan(
+      const std::function<ShareWrapper(const ShareWrapper&, const ShareWrapper&)>& op) const;
+
+  /// \brief computes the running totals of the SIMD values of this->share_ by Scan with addition,
+  /// which is local in arithmetic GMW and an adder circuit per level for Boolean shares.
+  ShareWrapper PrefixSum() const;
+
   /// \brief internally extracts shares from each entry in input and calls
   /// Simdify(std::span<SharePointer> input) on the result.
   static ShareWrapper Simdify(std::vector<ShareWrapper>&& input);
@@ -208,6 +364,16 @@ class ShareWrapper {
   template <typename T>
   T As() const;
 
+  /// \brief converts each of the \p outputs to T, see As, e.g., to retrieve all results of a
+  /// circuit whose outputs are reconstructed together, see proto::OutputBatcher.
+  template <typename T>
+  static std::vector<T> AsAll(std::span<const ShareWrapper> outputs) {
+    std::vector<T> result;
+    result.reserve(outputs.size());
+    for (const auto& output : outputs) result.emplace_back(output.As<T>());
+    return result;
+  }
+
  private:
   SharePointer share_;
 
@@ -223,26 +389,114 @@ class ShareWrapper {
   template <typename T>
   ShareWrapper HybridMul(SharePointer share, SharePointer other) const;
 
+  // the arithmetic GMW share of bitlength bits of the value of this selection bit
+  ShareWrapper ArithmeticSelection(std::size_t bitlength) const;
+
   template <typename T>
   ShareWrapper GreaterThan(SharePointer share, SharePointer other) const;
 
+  template <typename T>
+  ShareWrapper Equal(SharePointer share, SharePointer other) const;
+
+  template <typename T>
+  ShareWrapper Sign(SharePointer share) const;
+
+  // chunk bit length of the OT-based comparisons in arithmetic GMW, see
+  // Configuration::SetGreaterThanChunkBitLength
+  std::size_t GetGreaterThanChunkBitLength() const;
+
   template <typename T>
   ShareWrapper Square(SharePointer share) const;
+
+  template <typename T>
+  ShareWrapper Truncate(SharePointer share, std::size_t number_of_bits) const;
   
   template <typename T>
   ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b) const;
 
+  template <typename T>
+  std::vector<ShareWrapper> MatrixMultiplication(std::span<ShareWrapper> a,
+                                                 std::span<ShareWrapper> b,
+                                                 std::size_t number_of_rows,
+                                                 std::size_t number_of_columns) const;
+
   ShareWrapper ArithmeticGmwToBmr() const;
 
+  ShareWrapper ArithmeticGmwToBooleanGmw() const;
+
   ShareWrapper BooleanGmwToArithmeticGmw() const;
 
+  ShareWrapper AstraToBooleanGmw() const;
+
+  // locally to GMW of the same circuit type, see ArithmeticReplicatedToArithmeticGmwGate
+  ShareWrapper ReplicatedToGmw() const;
+
+  // resharing of an arithmetic or Boolean GMW share, see ArithmeticGmwToArithmeticReplicatedGate
+  ShareWrapper GmwToReplicated() const;
+
   ShareWrapper BooleanGmwToBmr() const;
 
   ShareWrapper BmrToBooleanGmw() const;
 
+  ShareWrapper BooleanGmwToGarbledCircuit() const;
+
+  ShareWrapper ArithmeticGmwToGarbledCircuit() const;
+
+  ShareWrapper GarbledCircuitToBooleanGmw() const;
+
+  ShareWrapper GarbledCircuitToArithmeticGmw() const;
+
   void ShareConsistencyCheck() const;
 };
 
+/// \brief A chain of XORs that is constructed as a single ShareWrapper::MultiInputXor when it is
+///        converted to a ShareWrapper, e.g., ShareWrapper d{XorExpression(a) ^ b ^ c}, instead of
+///        as a gate per operator.  The operators move the inputs of rvalue chains.
+class XorExpression {
+ public:
+  explicit XorExpression(ShareWrapper input) { inputs_.push_back(std::move(input)); }
+
+  friend XorExpression operator^(XorExpression expression, ShareWrapper input) {
+    expression.inputs_.push_back(std::move(input));
+    return expression;
+  }
+
+  friend XorExpression operator^(XorExpression expression, XorExpression other) {
+    expression.inputs_.insert(expression.inputs_.end(),
+                              std::make_move_iterator(other.inputs_.begin()),
+                              std::make_move_iterator(other.inputs_.end()));
+    return expression;
+  }
+
+  XorExpression& operator^=(ShareWrapper input) {
+    inputs_.push_back(std::move(input));
+    return *this;
+  }
+
+  operator ShareWrapper() const& { return ShareWrapper::MultiInputXor(inputs_); }
+
+  operator ShareWrapper() && { return ShareWrapper::MultiInputXor(std::move(inputs_)); }
+
+  std::size_t GetNumberOfInputs() const { return inputs_.size(); }
+
+ private:
+  std::vector<ShareWrapper> inputs_;
+};
+
+/// \brief Computes the inner product of \p a and \p b by a single gate in ASTRA and arithmetic
+///        GMW.
 ShareWrapper DotProduct(std::span<ShareWrapper> a, std::span<ShareWrapper> b);
 
+/// \brief Multiplies the row-major matrix \p a of \p number_of_rows rows by the row-major matrix
+///        \p b of \p number_of_columns columns, where each share is one entry.
+///
+/// In ASTRA, the product is computed by a single MatrixMultiplicationGate, i.e., with one setup
+/// and one online message for the whole matrix.  In arithmetic GMW, the single
+/// MatrixMultiplicationGate uses a matrix triple and opens m * k + k * n instead of 2 * m * k * n
+/// values.
+/// \return the entries of the product in row-major order
+std::vector<ShareWrapper> MatrixMultiplication(std::span<ShareWrapper> a, std::span<ShareWrapper> b,
+                                               std::size_t number_of_rows,
+                                               std::size_t number_of_columns);
+
 }  // namespace encrypto::motion
@@ -25,6 +25,8 @@
 #include "wire.h"
 #include "gate.h"
 
+#include <algorithm>
+
 #include <fmt/format.h>
 
 #include "base/backend.h"
@@ -54,6 +56,7 @@ void Wire::SetOnlineFinished() {
     }
     is_done_ = true;
   }
+  memory_account_.Set(GetNumberOfBytes());
   is_done_condition_.NotifyAll();
 }
 
@@ -70,4 +73,17 @@ std::string Wire::PrintIds(const std::vector<std::shared_ptr<Wire>>& wires) {
 
 void Wire::InitializationHelper() { wire_id_ = backend_.GetRegister()->NextWireId(); }
 
+SimdView ResolveSimdView(std::span<const WirePointer> wires) {
+  assert(!wires.empty());
+  const auto& positions{wires[0]->GetSimdViewPositions()};
+  const bool is_view{positions && std::all_of(wires.begin(), wires.end(), [&positions](auto& w) {
+                       return w->GetSimdViewPositions() == positions;
+                     })};
+  if (!is_view) return {std::vector<WirePointer>(wires.begin(), wires.end()), nullptr};
+  SimdView view{{}, positions};
+  view.sources.reserve(wires.size());
+  for (const auto& wire : wires) view.sources.emplace_back(wire->GetSimdViewSource());
+  return view;
+}
+
 }  // namespace encrypto::motion
@@ -27,10 +27,12 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "statistics/memory_accounting.h"
 #include "utility/fiber_condition.h"
 #include "utility/typedefs.h"
 
@@ -66,6 +68,10 @@ class Wire {
 
   virtual std::size_t GetBitLength() const = 0;
 
+  /// \returns the bytes of the values of this wire, which are accounted in MemoryAccounting from
+  ///          the end of its online phase until the wire is destroyed
+  virtual std::size_t GetNumberOfBytes() const { return 0; }
+
   void Clear() {
     is_done_ = false;
     DynamicClear();
@@ -73,6 +79,23 @@ class Wire {
 
   virtual bool IsConstant() const noexcept = 0;
 
+  /// \brief Marks this wire as holding the SIMD values of \p source at \p positions, which is set
+  ///        by SubsetGate and UnsimdifyGate.  ShareWrapper resolves the data management operations
+  ///        on such wires on their sources, s.t. chains of them yield at most one gate and the ones
+  ///        restoring the source yield none.
+  void SetSimdView(std::shared_ptr<Wire> source,
+                   std::shared_ptr<const std::vector<std::size_t>> positions) {
+    simd_view_source_ = std::move(source);
+    simd_view_positions_ = std::move(positions);
+  }
+
+  /// \returns the source of this wire or nullptr if this wire is not a view, see SetSimdView
+  const std::shared_ptr<Wire>& GetSimdViewSource() const noexcept { return simd_view_source_; }
+
+  const std::shared_ptr<const std::vector<std::size_t>>& GetSimdViewPositions() const noexcept {
+    return simd_view_positions_;
+  }
+
   Wire(const Wire&) = delete;
 
  protected:
@@ -89,6 +112,10 @@ class Wire {
 
   std::int64_t wire_id_ = -1;
 
+  // set by SetOnlineFinished, the wires of garbled circuits and BMR account their keys in
+  // MemorySubsystem::kGarbledLabels instead
+  MemoryAccount memory_account_{MemorySubsystem::kWires};
+
   Wire(Backend& backend, std::size_t number_of_simd);
 
   virtual void DynamicClear(){};
@@ -96,11 +123,32 @@ class Wire {
  private:
   void InitializationHelper();
 
-  std::mutex mutex_;
+  std::shared_ptr<Wire> simd_view_source_;
+  std::shared_ptr<const std::vector<std::size_t>> simd_view_positions_;
 };
 
 using WirePointer = std::shared_ptr<Wire>;
 
+/// \brief Source wires of the wires of a share and the positions of the share's SIMD values in
+///        them, see Wire::SetSimdView.
+struct SimdView {
+  std::vector<WirePointer> sources;
+  // nullptr for all SIMD values of the sources in their order
+  std::shared_ptr<const std::vector<std::size_t>> positions;
+
+  std::size_t GetNumberOfSimdValues() const {
+    return positions ? positions->size() : sources.at(0)->GetNumberOfSimdValues();
+  }
+
+  std::size_t GetPosition(std::size_t simd_i) const {
+    return positions ? (*positions)[simd_i] : simd_i;
+  }
+};
+
+/// \returns the sources of \p wires if all of them are SIMD views at the same positions, and
+///          \p wires at all of their SIMD values otherwise
+SimdView ResolveSimdView(std::span<const WirePointer> wires);
+
 class BooleanWire : public Wire {
  public:
   ~BooleanWire() override = default;
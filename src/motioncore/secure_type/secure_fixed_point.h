@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "base/backend.h"
+#include "protocols/share.h"
+#include "protocols/share_wrapper.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+/// \brief implements an interface for signed fixed-point arithmetic on arithmetic GMW shares of
+/// the unsigned integer type T.  A real value v is represented by the two's complement of
+/// round(v * 2^FractionalBits).  Products are truncated with ShareWrapper::Truncate, so they may
+/// exceed the exact result by 2^-FractionalBits, and the absolute value of the untruncated product
+/// needs to stay below 2^(l-2) for the bit length l of T.
+template <typename T, std::size_t FractionalBits>
+class SecureFixedPoint {
+  static_assert(std::is_unsigned_v<T>);
+  static_assert(FractionalBits + 2 <= sizeof(T) * 8);
+
+ public:
+  using value_type = T;
+  static constexpr std::size_t kFractionalBits = FractionalBits;
+
+  SecureFixedPoint() = default;
+  SecureFixedPoint(ShareWrapper share) : share_(share) {}
+  SecureFixedPoint(SharePointer share) : share_(share) {}
+
+  /// \brief encodes \p value as fixed-point number, which can be used as input to Party::In.
+  static T Encode(double value) {
+    using S = std::make_signed_t<T>;
+    return ToTwosComplement(static_cast<S>(std::llround(std::ldexp(value, FractionalBits))));
+  }
+
+  static std::vector<T> Encode(const std::vector<double>& values) {
+    std::vector<T> result;
+    result.reserve(values.size());
+    for (const auto value : values) result.emplace_back(Encode(value));
+    return result;
+  }
+
+  static double Decode(T value) {
+    return std::ldexp(static_cast<double>(FromTwosComplement(value)), -int(FractionalBits));
+  }
+
+  ShareWrapper& Get() { return share_; }
+
+  const ShareWrapper& Get() const { return share_; }
+
+  SecureFixedPoint operator+(const SecureFixedPoint& other) const {
+    return share_ + other.share_;
+  }
+
+  SecureFixedPoint operator+(double constant) const { return share_ + Constant(constant); }
+
+  SecureFixedPoint& operator+=(const SecureFixedPoint& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  SecureFixedPoint operator-(const SecureFixedPoint& other) const {
+    return share_ - other.share_;
+  }
+
+  SecureFixedPoint operator-(double constant) const { return share_ + Constant(-constant); }
+
+  SecureFixedPoint& operator-=(const SecureFixedPoint& other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  /// \brief multiplies the shares and truncates the product by FractionalBits bits.
+  SecureFixedPoint operator*(const SecureFixedPoint& other) const {
+    return (share_ * other.share_).Truncate(FractionalBits);
+  }
+
+  SecureFixedPoint operator*(double constant) const {
+    return (share_ * Constant(constant)).Truncate(FractionalBits);
+  }
+
+  SecureFixedPoint& operator*=(const SecureFixedPoint& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  /// \brief multiplies by the integer \p factor, which needs no truncation.
+  SecureFixedPoint MultiplyByInteger(std::make_signed_t<T> factor) const {
+    return share_ * ConstantShare(ToTwosComplement(factor));
+  }
+
+  /// \brief constructs an output gate, which reconstructs the cleartext result. The default
+  /// parameter for the output owner corresponds to all parties being the output owners.
+  SecureFixedPoint Out(std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const {
+    return share_.Out(output_owner);
+  }
+
+  /// \brief decodes the values on the wire to double or std::vector<double>, see
+  /// ShareWrapper::As for reference.
+  template <typename U>
+  U As() const {
+    if constexpr (std::is_same_v<U, double>) {
+      return Decode(share_.As<T>());
+    } else {
+      static_assert(std::is_same_v<U, std::vector<double>>);
+      const auto values{share_.As<std::vector<T>>()};
+      std::vector<double> result;
+      result.reserve(values.size());
+      for (const auto value : values) result.emplace_back(Decode(value));
+      return result;
+    }
+  }
+
+ private:
+  ShareWrapper Constant(double constant) const { return ConstantShare(Encode(constant)); }
+
+  ShareWrapper ConstantShare(T value) const {
+    return share_->GetBackend().ConstantArithmeticGmwInput(
+        std::vector<T>(share_->GetNumberOfSimdValues(), value));
+  }
+
+  ShareWrapper share_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,142 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "secure_signed_integer.h"
+#include "secure_unsigned_integer.h"
+
+namespace encrypto::motion {
+
+/// \brief wraps an Integer, i.e., SecureUnsignedInteger or SecureSignedInteger, whose bit length
+/// is fixed to BitLength at compile time.  Operations on integers of different bit lengths do not
+/// compile, and the Boolean circuits of every BitLength are generated exactly for it, see
+/// SecureUnsignedInteger::GetGeneratedAlgorithm, s.t., e.g., 20-bit values need neither 32-bit
+/// circuits nor circuit files.
+template <typename Integer, std::size_t BitLength>
+class FixedWidthInteger {
+  static_assert(BitLength > 0);
+
+ public:
+  static constexpr std::size_t kBitLength = BitLength;
+
+  FixedWidthInteger() = default;
+
+  /// \throws std::invalid_argument if the bit length of integer is not BitLength
+  FixedWidthInteger(Integer integer) : integer_(std::move(integer)) {
+    const auto bit_length{integer_.Get()->GetBitLength()};
+    if (bit_length != BitLength) {
+      throw std::invalid_argument("Expected an integer of " + std::to_string(BitLength) +
+                                  " bits, but got " + std::to_string(bit_length) + " bits");
+    }
+  }
+
+  FixedWidthInteger(const ShareWrapper& share) : FixedWidthInteger(Integer(share)) {}
+
+  FixedWidthInteger(const SharePointer& share) : FixedWidthInteger(Integer(share)) {}
+
+  Integer& GetInteger() { return integer_; }
+
+  const Integer& GetInteger() const { return integer_; }
+
+  ShareWrapper& Get() { return integer_.Get(); }
+
+  const ShareWrapper& Get() const { return integer_.Get(); }
+
+  FixedWidthInteger operator+(const FixedWidthInteger& other) const {
+    return integer_ + other.integer_;
+  }
+
+  FixedWidthInteger& operator+=(const FixedWidthInteger& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  FixedWidthInteger operator-(const FixedWidthInteger& other) const {
+    return integer_ - other.integer_;
+  }
+
+  FixedWidthInteger& operator-=(const FixedWidthInteger& other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  FixedWidthInteger operator*(const FixedWidthInteger& other) const {
+    return integer_ * other.integer_;
+  }
+
+  FixedWidthInteger& operator*=(const FixedWidthInteger& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  FixedWidthInteger operator/(const FixedWidthInteger& other) const {
+    return integer_ / other.integer_;
+  }
+
+  FixedWidthInteger& operator/=(const FixedWidthInteger& other) {
+    *this = *this / other;
+    return *this;
+  }
+
+  ShareWrapper operator>(const FixedWidthInteger& other) const {
+    return integer_ > other.integer_;
+  }
+
+  ShareWrapper operator<(const FixedWidthInteger& other) const { return other > *this; }
+
+  ShareWrapper operator==(const FixedWidthInteger& other) const {
+    return integer_ == other.integer_;
+  }
+
+  /// \brief constructs an output gate, which reconstructs the cleartext result. The default
+  /// parameter for the output owner corresponds to all parties being the output owners.
+  FixedWidthInteger Out(
+      std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const {
+    return integer_.Out(output_owner);
+  }
+
+  /// \brief converts the information on the wires to T, see Integer::As.
+  template <typename T>
+  T As() const {
+    return integer_.template As<T>();
+  }
+
+ private:
+  Integer integer_;
+};
+
+template <std::size_t BitLength>
+using SecureUInt = FixedWidthInteger<SecureUnsignedInteger, BitLength>;
+
+template <std::size_t BitLength>
+using SecureInt = FixedWidthInteger<SecureSignedInteger, BitLength>;
+
+}  // namespace encrypto::motion
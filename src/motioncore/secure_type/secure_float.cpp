@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "secure_float.h"
+
+#include <fmt/format.h>
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/float_circuits.h"
+#include "base/backend.h"
+#include "base/register.h"
+#include "utility/constants.h"
+#include "utility/logger.h"
+
+namespace encrypto::motion {
+
+SecureFloat::SecureFloat(const ShareWrapper& other) : share_(other) {
+  if (share_->GetCircuitType() != CircuitType::kBoolean) {
+    throw std::invalid_argument("SecureFloat needs a Boolean share");
+  }
+  const auto bitlength{share_->GetBitLength()};
+  if (bitlength != 32 && bitlength != 64) {
+    throw std::invalid_argument(
+        fmt::format("SecureFloat needs a share of 32 or 64 wires, got {}", bitlength));
+  }
+  logger_ = share_->GetRegister()->GetLogger();
+}
+
+SecureFloat SecureFloat::operator+(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kAdd, other);
+}
+
+SecureFloat SecureFloat::operator-(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kSub, other);
+}
+
+SecureFloat SecureFloat::operator*(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kMul, other);
+}
+
+SecureFloat SecureFloat::operator/(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kDiv, other);
+}
+
+SecureFloat SecureFloat::operator-() const {
+  auto wires{share_.Split()};
+  wires.back() = ~wires.back();
+  return ShareWrapper::Concatenate(wires);
+}
+
+ShareWrapper SecureFloat::operator<(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kLt, other);
+}
+
+ShareWrapper SecureFloat::operator==(const SecureFloat& other) const {
+  return Evaluate(FloatingPointOperationType::kEq, other);
+}
+
+SecureFloat SecureFloat::Sqrt() const { return Evaluate(FloatingPointOperationType::kSqrt); }
+
+SecureFloat SecureFloat::Exp2() const { return Evaluate(FloatingPointOperationType::kExp2); }
+
+SecureFloat SecureFloat::Exp() const { return Evaluate(FloatingPointOperationType::kExp); }
+
+SecureFloat SecureFloat::Log2() const { return Evaluate(FloatingPointOperationType::kLog2); }
+
+SecureFloat SecureFloat::Log() const { return Evaluate(FloatingPointOperationType::kLog); }
+
+SecureFloat SecureFloat::Out(std::size_t output_owner) const {
+  return SecureFloat(share_.Out(output_owner));
+}
+
+SecureFloat SecureFloat::Evaluate(FloatingPointOperationType type) const {
+  return share_.Evaluate(GetGeneratedAlgorithm(type));
+}
+
+ShareWrapper SecureFloat::Evaluate(FloatingPointOperationType type,
+                                   const SecureFloat& other) const {
+  if (share_->GetBitLength() != other.share_->GetBitLength()) {
+    throw std::invalid_argument("SecureFloat operands need the same format");
+  }
+  const auto input{ShareWrapper::Concatenate(std::vector{share_, other.share_})};
+  return input.Evaluate(GetGeneratedAlgorithm(type));
+}
+
+std::shared_ptr<AlgorithmDescription> SecureFloat::GetGeneratedAlgorithm(
+    FloatingPointOperationType type) const {
+  const auto bitlength{share_->GetBitLength()};
+  const auto protocol{share_->GetProtocol()};
+  // BMR and garbled circuits use size-optimized circuits, GMW uses depth-optimized circuits
+  const auto objective{protocol == MpcProtocol::kBmr || protocol == MpcProtocol::kGarbledCircuit
+                           ? CircuitObjective::kSize
+                           : CircuitObjective::kDepth};
+  const auto name{fmt::format("generated/{}_{}_{}", to_string(type), bitlength,
+                              objective == CircuitObjective::kSize ? "size" : "depth")};
+  auto register_pointer{share_->GetRegister()};
+  if (auto algorithm{register_pointer->GetCachedAlgorithmDescription(name)}) {
+    if constexpr (kDebug) {
+      logger_->LogDebug("Found in cache Boolean floating-point circuit {}", name);
+    }
+    return algorithm;
+  }
+  // binary32 and binary64
+  const std::size_t exponent_bits{bitlength == 32 ? 8u : 11u};
+  auto algorithm{std::make_shared<AlgorithmDescription>(
+      MakeFloatingPointCircuit(type, exponent_bits, bitlength - 1 - exponent_bits, objective))};
+  // another thread may have added the same circuit in the meantime
+  if (!register_pointer->AddCachedAlgorithmDescription(name, algorithm)) {
+    algorithm = register_pointer->GetCachedAlgorithmDescription(name);
+  }
+  if constexpr (kDebug) {
+    logger_->LogDebug("Generated Boolean floating-point circuit {}", name);
+  }
+  return algorithm;
+}
+
+template <typename T>
+T SecureFloat::As() const {
+  const auto output{share_.As<std::vector<BitVector<>>>()};
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    using Integer = std::conditional_t<std::is_same_v<T, float>, std::uint32_t, std::uint64_t>;
+    return std::bit_cast<T>(ToOutput<Integer>(output));
+  } else {
+    using Integer = std::conditional_t<std::is_same_v<T, std::vector<float>>, std::uint32_t,
+                                       std::uint64_t>;
+    const auto integers{ToVectorOutput<Integer>(output)};
+    T result(integers.size());
+    for (std::size_t i = 0; i < integers.size(); ++i) {
+      result[i] = std::bit_cast<typename T::value_type>(integers[i]);
+    }
+    return result;
+  }
+}
+
+template float SecureFloat::As() const;
+template double SecureFloat::As() const;
+template std::vector<float> SecureFloat::As() const;
+template std::vector<double> SecureFloat::As() const;
+
+}  // namespace encrypto::motion
@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <limits>
+#include <memory>
+
+#include "protocols/share_wrapper.h"
+
+namespace encrypto::motion {
+
+class Logger;
+
+/// \brief an IEEE 754 binary32 or binary64 number shared as the 32 or 64 wires of a Boolean share
+/// in Boolean GMW, BMR or garbled circuits, least significant bit of the mantissa first.  The
+/// operations evaluate the circuits of MakeFloatingPointCircuit, which are generated once per
+/// format and cached in the register, on all SIMD values of the share at once.  Zeros and normal
+/// numbers are supported, subnormal results are flushed to zero, and infinities and NaNs are not
+/// supported, see MakeFloatingPointCircuit.
+class SecureFloat {
+ public:
+  SecureFloat() = default;
+
+  /// \throws std::invalid_argument if other is not a Boolean share of 32 or 64 wires
+  SecureFloat(const ShareWrapper& other);
+
+  SecureFloat(const SharePointer& other) : SecureFloat(ShareWrapper(other)) {}
+
+  SharePointer& Get() { return share_.Get(); }
+
+  const SharePointer& Get() const { return share_.Get(); }
+
+  const ShareWrapper& GetShareWrapper() const { return share_; }
+
+  SecureFloat operator+(const SecureFloat& other) const;
+
+  SecureFloat& operator+=(const SecureFloat& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  SecureFloat operator-(const SecureFloat& other) const;
+
+  SecureFloat& operator-=(const SecureFloat& other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  SecureFloat operator*(const SecureFloat& other) const;
+
+  SecureFloat& operator*=(const SecureFloat& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  /// \brief the result of a division by zero is undefined
+  SecureFloat operator/(const SecureFloat& other) const;
+
+  SecureFloat& operator/=(const SecureFloat& other) {
+    *this = *this / other;
+    return *this;
+  }
+
+  /// \brief negates the number by inverting the sign wire without communication
+  SecureFloat operator-() const;
+
+  /// \brief returns a share of a single wire, where +0 and -0 are equal
+  ShareWrapper operator<(const SecureFloat& other) const;
+
+  ShareWrapper operator>(const SecureFloat& other) const { return other < *this; }
+
+  ShareWrapper operator==(const SecureFloat& other) const;
+
+  /// \brief the result for negative numbers is undefined
+  SecureFloat Sqrt() const;
+
+  /// \brief 2^x, which is off by at most one unit in the last place
+  SecureFloat Exp2() const;
+
+  /// \brief e^x, which is off by at most one unit in the last place
+  SecureFloat Exp() const;
+
+  /// \brief log2(x) with an absolute error of about one unit in the last place of 1, which is
+  /// undefined if x is not positive
+  SecureFloat Log2() const;
+
+  /// \brief ln(x) with the error of Log2
+  SecureFloat Log() const;
+
+  /// \brief constructs an output gate, which reconstructs the cleartext result. The default
+  /// parameter for the output owner corresponds to all parties being the output owners.
+  SecureFloat Out(std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const;
+
+  /// \brief converts the output to T, which is float or double for a single SIMD value or
+  /// std::vector<float> or std::vector<double> for all SIMD values, according to the width of the
+  /// number.
+  template <typename T>
+  T As() const;
+
+ private:
+  ShareWrapper share_;
+  std::shared_ptr<Logger> logger_{nullptr};
+
+  /// \brief returns the circuit of MakeFloatingPointCircuit for the format of this number, which
+  /// is size-optimized for BMR and garbled circuits and depth-optimized otherwise.  The circuit is
+  /// generated once and cached in the register.
+  std::shared_ptr<AlgorithmDescription> GetGeneratedAlgorithm(
+      FloatingPointOperationType type) const;
+
+  SecureFloat Evaluate(FloatingPointOperationType type) const;
+
+  ShareWrapper Evaluate(FloatingPointOperationType type, const SecureFloat& other) const;
+};
+
+}  // namespace encrypto::motion
@@ -24,11 +24,100 @@
 
 #include "secure_signed_integer.h"
 
+#include <fmt/format.h>
+
 #include "protocols/share.h"
 #include "utility/bit_vector.h"
 
 namespace encrypto::motion {
 
+ShareWrapper SecureSignedInteger::operator>(const SecureSignedInteger& other) const {
+  if (share_.Get()->GetCircuitType() == CircuitType::kBoolean) {
+    return share_.Compare(other.share_, true);
+  }
+  if (share_.Get()->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Signed integer comparison is not implemented for this protocol");
+  }
+  return share_.Get() > other.share_.Get();
+}
+
+SecureSignedInteger SecureSignedInteger::Minimum(const SecureSignedInteger& other) const {
+  if (share_.Get()->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Signed integer comparison is only implemented for arithmetic GMW");
+  }
+  return share_.Get().Minimum(other.share_.Get());
+}
+
+SecureSignedInteger SecureSignedInteger::Maximum(const SecureSignedInteger& other) const {
+  if (share_.Get()->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Signed integer comparison is only implemented for arithmetic GMW");
+  }
+  return share_.Get().Maximum(other.share_.Get());
+}
+
+ShareWrapper SecureSignedInteger::IsNegative() const { return share_.Get().Sign(); }
+
+SecureSignedInteger SecureSignedInteger::Abs() const {
+  const auto& share{share_.Get()};
+  if (share->GetCircuitType() == CircuitType::kBoolean) {
+    return share.Evaluate(share_.GetGeneratedAlgorithm(IntegerOperationType::kAbs, true));
+  }
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Signed absolute value is not implemented for this protocol");
+  }
+  // the Boolean sign bit is multiplied by HybridMultiplicationGate as in ShareWrapper::Minimum
+  return share - IsNegative() * (share + share);
+}
+
+namespace {
+
+// the bits of a Boolean share with the sign bit repeated up to bitlength bits
+ShareWrapper RepeatSignBit(std::vector<ShareWrapper> bits, std::size_t bitlength) {
+  const auto sign_bit{bits.back()};
+  bits.resize(bitlength, sign_bit);
+  return ShareWrapper::Concatenate(bits);
+}
+
+}  // namespace
+
+SecureSignedInteger SecureSignedInteger::SignExtend(std::size_t bitlength) const {
+  const auto& share{share_.Get()};
+  if (bitlength < share->GetBitLength()) {
+    throw std::invalid_argument(fmt::format("Cannot sign-extend integers of {} bits to {} bits",
+                                            share->GetBitLength(), bitlength));
+  }
+  if (share->GetCircuitType() == CircuitType::kBoolean) {
+    return RepeatSignBit(share.Split(), bitlength);
+  }
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Sign extension is not implemented for this protocol");
+  }
+  if (bitlength == share->GetBitLength()) return *this;
+  return RepeatSignBit(share.Convert<MpcProtocol::kBooleanGmw>().Split(), bitlength)
+      .Convert<MpcProtocol::kArithmeticGmw>();
+}
+
+SecureSignedInteger SecureSignedInteger::ArithmeticRightShift(std::size_t number_of_bits) const {
+  const auto& share{share_.Get()};
+  const auto bitlength{share->GetBitLength()};
+  if (number_of_bits >= bitlength) {
+    throw std::invalid_argument(fmt::format("Cannot shift integers of {} bits by {} bits",
+                                            bitlength, number_of_bits));
+  }
+  if (number_of_bits == 0) return *this;
+  if (share->GetCircuitType() == CircuitType::kBoolean) {
+    auto bits{share.Split()};
+    bits.erase(bits.begin(), bits.begin() + number_of_bits);
+    return RepeatSignBit(std::move(bits), bitlength);
+  }
+  if (share->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+    throw std::runtime_error("Arithmetic right shift is not implemented for this protocol");
+  }
+  return RepeatSignBit(share.ExtractBits(number_of_bits, bitlength - number_of_bits).Split(),
+                       bitlength)
+      .Convert<MpcProtocol::kArithmeticGmw>();
+}
+
 SecureSignedInteger SecureSignedInteger::Simdify(std::span<SecureSignedInteger> input) {
   std::vector<SharePointer> input_as_shares;
   input_as_shares.reserve(input.size());
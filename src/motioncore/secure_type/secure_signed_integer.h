@@ -84,10 +84,10 @@ class SecureSignedInteger {
     return *this;
   }
 
+  /// \brief Returns the quotient rounded toward zero, see MakeSignedDivisionCircuit.  Arithmetic
+  /// GMW shares are converted to Boolean GMW for the division.
   SecureSignedInteger operator/(const SecureSignedInteger& other) const {
-    // TODO implement
-    throw std::runtime_error("Not implemented yet");
-    return this->share_ + other.share_;
+    return this->share_.Divide(other.share_, true);
   }
 
   SecureSignedInteger& operator/=(const SecureSignedInteger& other) {
@@ -95,16 +95,45 @@ class SecureSignedInteger {
     return *this;
   }
 
-  ShareWrapper operator>(const SecureSignedInteger& other) const {
-    // TODO implement
-    throw std::runtime_error("Not implemented yet");
-    return this->share_ > other.share_;
-  }
+  /// \brief Compares Boolean shares by MakeSignedGreaterThanCircuit and values in arithmetic GMW,
+  /// which need to lie in [-2^(l-2), 2^(l-2)) for the bit length l, see
+  /// proto::arithmetic_gmw::GreaterThanGate.
+  ShareWrapper operator>(const SecureSignedInteger& other) const;
+
+  ShareWrapper operator<(const SecureSignedInteger& other) const { return other > *this; }
 
   ShareWrapper operator==(const SecureSignedInteger& other) const {
     return this->share_ == other.share_;
   }
 
+  /// \brief Returns the smaller value in arithmetic GMW, see operator>.
+  SecureSignedInteger Minimum(const SecureSignedInteger& other) const;
+
+  /// \brief Returns the larger value in arithmetic GMW, see operator>.
+  SecureSignedInteger Maximum(const SecureSignedInteger& other) const;
+
+  /// \brief Returns a Boolean GMW share of this < 0 in arithmetic GMW, see ShareWrapper::Sign.
+  ShareWrapper IsNegative() const;
+
+  /// \brief Returns the absolute value, where the smallest integer is its own absolute value.
+  /// Boolean shares are negated conditioned on their sign bit by MakeAbsoluteValueCircuit, which
+  /// costs bitlength - 1 AND gates.  Arithmetic GMW shares are computed as this - 2 [this < 0] this
+  /// by IsNegative and a single hybrid multiplication.
+  SecureSignedInteger Abs() const;
+
+  /// \brief Extends the integers to bitlength bits by repeating the sign bit.  Boolean shares are
+  /// only rewired without any gates.  Arithmetic GMW shares are converted to Boolean GMW, rewired
+  /// and converted back to a ring of bitlength bits, which must be 8, 16, 32 or 64.
+  /// \throws std::invalid_argument if bitlength is smaller than the current bit length
+  SecureSignedInteger SignExtend(std::size_t bitlength) const;
+
+  /// \brief Shifts the integers to the right by number_of_bits bits and rounds toward negative
+  /// infinity as >> on signed integers in C++.  Boolean shares are only rewired without any gates.
+  /// Arithmetic GMW shares are shifted exactly, unlike ShareWrapper::Truncate, as only the upper
+  /// bits are extracted by ShareWrapper::ExtractBits and converted back to arithmetic GMW.
+  /// \throws std::invalid_argument if number_of_bits is not smaller than the bit length
+  SecureSignedInteger ArithmeticRightShift(std::size_t number_of_bits) const;
+
   /// \brief internally extracts the ShareWrapper/SharePointer from input and
   /// calls ShareWrapper::Simdify(std::span<SharePointer> input)
   static SecureSignedInteger Simdify(std::span<SecureSignedInteger> input);
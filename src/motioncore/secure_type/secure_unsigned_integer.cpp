@@ -28,6 +28,7 @@
 #include <iterator>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/integer_circuits.h"
 #include "base/backend.h"
 #include "base/register.h"
 #include "protocols/data_management/unsimdify_gate.h"
@@ -49,30 +50,7 @@ SecureUnsignedInteger SecureUnsignedInteger::operator+(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ + *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> addition_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kAdd, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kAdd, bitlength, "_depth");
-
-    if ((addition_algorithm = share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      addition_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(addition_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto addition_algorithm{GetGeneratedAlgorithm(IntegerOperationType::kAdd)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(addition_algorithm));
   }
@@ -83,31 +61,7 @@ SecureUnsignedInteger SecureUnsignedInteger::operator-(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ - *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> subtraction_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kSub, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kSub, bitlength, "_depth");
-
-    if ((subtraction_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      subtraction_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(subtraction_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto subtraction_algorithm{GetGeneratedAlgorithm(IntegerOperationType::kSub)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(subtraction_algorithm));
   }
@@ -118,65 +72,30 @@ SecureUnsignedInteger SecureUnsignedInteger::operator*(const SecureUnsignedInteg
     // use primitive operation in arithmetic GMW
     return *share_ * *other.share_;
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> multiplication_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kMul, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kMul, bitlength, "_depth");
-
-    if ((multiplication_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      multiplication_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(multiplication_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
+    const auto multiplication_algorithm{GetGeneratedAlgorithm(IntegerOperationType::kMul)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(multiplication_algorithm));
   }
 }
 
 SecureUnsignedInteger SecureUnsignedInteger::operator/(const SecureUnsignedInteger& other) const {
-  if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
-    // use primitive operation in arithmetic GMW
-    throw std::runtime_error("Integer division is not implemented for arithmetic GMW");
-  } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> division_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kDiv, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kDiv, bitlength, "_depth");
+  return Divide(other, false);
+}
 
-    if ((division_algorithm = share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      division_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(division_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
+SecureUnsignedInteger SecureUnsignedInteger::Divide(const SecureUnsignedInteger& other,
+                                                    bool is_signed) const {
+  if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
+    if (share_->Get()->GetProtocol() != MpcProtocol::kArithmeticGmw) {
+      throw std::runtime_error("Integer division is only implemented for arithmetic GMW");
     }
+    // the quotient is computed exactly by the division circuit on Boolean GMW shares
+    const SecureUnsignedInteger boolean_share{share_->Convert<MpcProtocol::kBooleanGmw>()};
+    const SecureUnsignedInteger boolean_other{other.share_->Convert<MpcProtocol::kBooleanGmw>()};
+    return boolean_share.Divide(boolean_other, is_signed)
+        .Get()
+        .Convert<MpcProtocol::kArithmeticGmw>();
+  } else {  // BooleanCircuitType
+    const auto division_algorithm{GetGeneratedAlgorithm(IntegerOperationType::kDiv, is_signed)};
     const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
     return SecureUnsignedInteger(share_input.Evaluate(division_algorithm));
   }
@@ -190,40 +109,24 @@ ShareWrapper SecureUnsignedInteger::operator>(const SecureUnsignedInteger& other
     // use primitive operation in arithmetic GMW
     throw std::runtime_error("Integer comparison is not implemented for arithmetic GMW");
   } else {  // BooleanCircuitType
-    const auto bitlength = share_->Get()->GetBitLength();
-    std::shared_ptr<AlgorithmDescription> is_greater_algorithm;
-    std::string path;
-
-    if (share_->Get()->GetProtocol() == MpcProtocol::kBmr ||
-        share_->Get()->GetProtocol() ==
-            MpcProtocol::kGarbledCircuit)  // BMR, use size-optimized circuit
-      path = ConstructPath(IntegerOperationType::kGt, bitlength, "_size");
-    else  // GMW, use depth-optimized circuit
-      path = ConstructPath(IntegerOperationType::kGt, bitlength, "_depth");
-
-    if ((is_greater_algorithm =
-             share_->Get()->GetRegister()->GetCachedAlgorithmDescription(path))) {
-      if constexpr (kDebug) {
-        logger_->LogDebug(
-            fmt::format("Found in cache Boolean integer addition circuit with file path {}", path));
-      }
-    } else {
-      is_greater_algorithm =
-          std::make_shared<AlgorithmDescription>(AlgorithmDescription::FromBristol(path));
-      assert(is_greater_algorithm);
-      if constexpr (kDebug) {
-        logger_->LogDebug(fmt::format("Read Boolean integer addition circuit from file {}", path));
-      }
-    }
-    const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
-    return share_input.Evaluate(is_greater_algorithm).Split().at(0);
+    return Compare(other, false);
   }
 }
 
+ShareWrapper SecureUnsignedInteger::Compare(const SecureUnsignedInteger& other,
+                                            bool is_signed) const {
+  const auto is_greater_algorithm{GetGeneratedAlgorithm(IntegerOperationType::kGt, is_signed)};
+  const auto share_input{ShareWrapper::Concatenate(std::vector{*share_, *other.share_})};
+  return share_input.Evaluate(is_greater_algorithm).Split().at(0);
+}
+
 ShareWrapper SecureUnsignedInteger::operator==(const SecureUnsignedInteger& other) const {
   if (share_->Get()->GetCircuitType() != CircuitType::kBoolean) {
-    // use primitive operation in arithmetic GMW
-    throw std::runtime_error("Integer comparison is not implemented for arithmetic GMW");
+    if (share_->Get()->GetProtocol() == MpcProtocol::kArithmeticGmw) {
+      // use the OT-based equality test of arithmetic GMW
+      return *share_ == *other.share_;
+    }
+    throw std::runtime_error("Integer comparison is only implemented for arithmetic GMW");
   } else {  // BooleanCircuitType
     if constexpr (kDebug) {
       if (other->GetProtocol() == MpcProtocol::kBmr) {
@@ -236,41 +139,63 @@ ShareWrapper SecureUnsignedInteger::operator==(const SecureUnsignedInteger& othe
   }
 }
 
-std::string SecureUnsignedInteger::ConstructPath(const IntegerOperationType type,
-                                                 const std::size_t bitlength,
-                                                 std::string suffix) const {
-  std::string operation_type_string;
+std::shared_ptr<AlgorithmDescription> SecureUnsignedInteger::GetGeneratedAlgorithm(
+    const IntegerOperationType type, bool is_signed) const {
+  const auto bitlength = share_->Get()->GetBitLength();
+  const auto protocol{share_->Get()->GetProtocol()};
+  // BMR and garbled circuits use size-optimized circuits, GMW uses depth-optimized circuits
+  const auto objective{protocol == MpcProtocol::kBmr || protocol == MpcProtocol::kGarbledCircuit
+                           ? CircuitObjective::kSize
+                           : CircuitObjective::kDepth};
+  // the name does not collide with the paths of circuit files in the cache of the register
+  const auto name{fmt::format("generated/{}{}_{}_{}", is_signed ? "SIGNED_" : "", to_string(type),
+                              bitlength, objective == CircuitObjective::kSize ? "size" : "depth")};
+  auto register_pointer{share_->Get()->GetRegister()};
+  if (auto algorithm{register_pointer->GetCachedAlgorithmDescription(name)}) {
+    if constexpr (kDebug) {
+      logger_->LogDebug("Found in cache Boolean integer circuit {}", name);
+    }
+    return algorithm;
+  }
+  std::shared_ptr<AlgorithmDescription> algorithm;
   switch (type) {
-    case IntegerOperationType::kAdd: {
-      operation_type_string = "add";
+    case IntegerOperationType::kAdd:
+      algorithm = std::make_shared<AlgorithmDescription>(MakeAdditionCircuit(bitlength, objective));
       break;
-    }
-    case IntegerOperationType::kDiv: {
-      operation_type_string = "div";
+    case IntegerOperationType::kSub:
+      algorithm =
+          std::make_shared<AlgorithmDescription>(MakeSubtractionCircuit(bitlength, objective));
       break;
-    }
-    case IntegerOperationType::kGt: {
-      operation_type_string = "gt";
+    case IntegerOperationType::kMul:
+      algorithm =
+          std::make_shared<AlgorithmDescription>(MakeMultiplicationCircuit(bitlength, objective));
       break;
-    }
-    case IntegerOperationType::kEq: {
-      operation_type_string = "eq";
+    case IntegerOperationType::kDiv:
+      algorithm = std::make_shared<AlgorithmDescription>(
+          is_signed ? MakeSignedDivisionCircuit(bitlength, objective)
+                    : MakeDivisionCircuit(bitlength, objective));
       break;
-    }
-    case IntegerOperationType::kMul: {
-      operation_type_string = "mul";
+    case IntegerOperationType::kGt:
+      algorithm = std::make_shared<AlgorithmDescription>(
+          is_signed ? MakeSignedGreaterThanCircuit(bitlength, objective)
+                    : MakeGreaterThanCircuit(bitlength, objective));
       break;
-    }
-    case IntegerOperationType::kSub: {
-      operation_type_string = "sub";
+    case IntegerOperationType::kAbs:
+      algorithm =
+          std::make_shared<AlgorithmDescription>(MakeAbsoluteValueCircuit(bitlength, objective));
       break;
-    }
     default:
-      throw std::runtime_error(
-          fmt::format("Invalid integer operation required: {}", to_string(type)));
+      throw std::invalid_argument(
+          fmt::format("No generated circuit for integer operation {}", to_string(type)));
+  }
+  // another thread may have added the same circuit in the meantime
+  if (!register_pointer->AddCachedAlgorithmDescription(name, algorithm)) {
+    algorithm = register_pointer->GetCachedAlgorithmDescription(name);
+  }
+  if constexpr (kDebug) {
+    logger_->LogDebug("Generated Boolean integer circuit {}", name);
   }
-  return fmt::format("{}/circuits/int/int_{}{}{}.bristol", kRootDir, operation_type_string,
-                     bitlength, suffix);
+  return algorithm;
 }
 
 SecureUnsignedInteger SecureUnsignedInteger::Simdify(std::span<SecureUnsignedInteger> input) {
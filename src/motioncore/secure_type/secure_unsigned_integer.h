@@ -93,6 +93,8 @@ class SecureUnsignedInteger {
     return *this;
   }
 
+  /// \brief Returns the quotient rounded down, or all ones for a divisor of zero, see
+  /// MakeDivisionCircuit.  Arithmetic GMW shares are converted to Boolean GMW for the division.
   SecureUnsignedInteger operator/(const SecureUnsignedInteger& other) const;
 
   SecureUnsignedInteger& operator/=(const SecureUnsignedInteger& other) {
@@ -102,8 +104,28 @@ class SecureUnsignedInteger {
 
   ShareWrapper operator>(const SecureUnsignedInteger& other) const;
 
+  ShareWrapper operator<(const SecureUnsignedInteger& other) const { return other > *this; }
+
   ShareWrapper operator==(const SecureUnsignedInteger& other) const;
 
+  /// \brief Returns the smaller value, see ShareWrapper::Minimum.
+  SecureUnsignedInteger Minimum(const SecureUnsignedInteger& other) const {
+    return share_->Minimum(*other.share_);
+  }
+
+  /// \brief Returns the larger value, see ShareWrapper::Maximum.
+  SecureUnsignedInteger Maximum(const SecureUnsignedInteger& other) const {
+    return share_->Maximum(*other.share_);
+  }
+
+  /// \brief Returns selection ? a : b for a Boolean share selection of 1 wire, see
+  /// ShareWrapper::Mux.  Arithmetic GMW integers stay in arithmetic GMW, i.e., the selection bit
+  /// is multiplied by a hybrid multiplication instead of converting a and b to Boolean GMW.
+  static SecureUnsignedInteger Mux(const ShareWrapper& selection, const SecureUnsignedInteger& a,
+                                   const SecureUnsignedInteger& b) {
+    return selection.Mux(*a.share_, *b.share_);
+  }
+
   /// \brief internally extracts the ShareWrapper/SharePointer from input and
   /// calls ShareWrapper::Simdify(std::span<SharePointer> input)
   static SecureUnsignedInteger Simdify(std::span<SecureUnsignedInteger> input);
@@ -139,8 +161,25 @@ class SecureUnsignedInteger {
   std::shared_ptr<ShareWrapper> share_{nullptr};
   std::shared_ptr<Logger> logger_{nullptr};
 
-  std::string ConstructPath(const IntegerOperationType type, const std::size_t bitlength,
-                            std::string suffix = "") const;
+  /// \brief returns the circuit of MakeAdditionCircuit, MakeSubtractionCircuit,
+  /// MakeMultiplicationCircuit or, depending on is_signed, MakeDivisionCircuit or
+  /// MakeSignedDivisionCircuit and MakeGreaterThanCircuit or MakeSignedGreaterThanCircuit, or
+  /// MakeAbsoluteValueCircuit for the bit length of this integer, which is size-optimized for BMR
+  /// and garbled circuits and depth-optimized otherwise.  The circuit is generated once and cached
+  /// in the register, s.t. every bit length gets an exact circuit without reading circuit files.
+  std::shared_ptr<AlgorithmDescription> GetGeneratedAlgorithm(const IntegerOperationType type,
+                                                              bool is_signed = false) const;
+
+  /// \brief divides by other as unsigned integers or, if is_signed, as integers in two's
+  /// complement, see SecureSignedInteger::operator/.  Arithmetic GMW shares are converted to
+  /// Boolean GMW for the division and back.
+  SecureUnsignedInteger Divide(const SecureUnsignedInteger& other, bool is_signed) const;
+
+  /// \brief returns this > other for Boolean shares as unsigned integers or, if is_signed, as
+  /// integers in two's complement.
+  ShareWrapper Compare(const SecureUnsignedInteger& other, bool is_signed) const;
+
+  friend class SecureSignedInteger;
 };
 
 }  // namespace encrypto::motion
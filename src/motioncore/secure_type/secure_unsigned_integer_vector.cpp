@@ -0,0 +1,170 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+
+
+#include "secure_unsigned_integer_vector.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "protocols/share.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+std::vector<std::size_t> Range(std::size_t begin, std::size_t end) {
+  std::vector<std::size_t> positions(end - begin);
+  std::iota(positions.begin(), positions.end(), begin);
+  return positions;
+}
+
+SecureUnsignedInteger SubsetOf(const SecureUnsignedInteger& integer,
+                               std::span<const std::size_t> positions) {
+  ShareWrapper unwrap{integer.Get()};
+  return unwrap.Subset(positions);
+}
+
+// combines the lower and the upper half of the remaining elements until one remains, s.t. the
+// tree has logarithmic depth and each level is a single SIMD operation
+template <typename Combine>
+SecureUnsignedInteger Reduce(const SecureUnsignedInteger& elements, Combine combine) {
+  std::size_t size{elements.Get()->GetNumberOfSimdValues()};
+  if (size == 0) throw std::invalid_argument("Cannot reduce an empty SecureUnsignedIntegerVector");
+  SecureUnsignedInteger remaining{elements};
+  while (size > 1) {
+    const std::size_t half{size / 2};
+    auto combined{combine(SubsetOf(remaining, Range(0, half)),
+                          SubsetOf(remaining, Range(half, 2 * half)))};
+    if (size % 2 == 1) {
+      const std::vector<std::size_t> last{size - 1};
+      remaining = ShareWrapper::Simdify(
+          std::vector<ShareWrapper>{combined.Get(), SubsetOf(remaining, last).Get()});
+    } else {
+      remaining = std::move(combined);
+    }
+    size = half + size % 2;
+  }
+  return remaining;
+}
+
+}  // namespace
+
+SecureUnsignedIntegerVector SecureUnsignedIntegerVector::FromElements(
+    std::span<const SecureUnsignedInteger> elements) {
+  std::vector<ShareWrapper> shares;
+  shares.reserve(elements.size());
+  for (const auto& element : elements) shares.emplace_back(element.Get());
+  return ShareWrapper::Simdify(shares);
+}
+
+SecureUnsignedIntegerVector SecureUnsignedIntegerVector::Broadcast(
+    const SecureUnsignedInteger& value, std::size_t size) {
+  if (value.Get()->GetNumberOfSimdValues() != 1) {
+    throw std::invalid_argument(fmt::format(
+        "Cannot broadcast a share with {} SIMD values", value.Get()->GetNumberOfSimdValues()));
+  }
+  return SubsetOf(value, std::vector<std::size_t>(size, 0));
+}
+
+std::size_t SecureUnsignedIntegerVector::GetSize() const {
+  return elements_.Get()->GetNumberOfSimdValues();
+}
+
+SecureUnsignedInteger SecureUnsignedIntegerVector::Sum() const {
+  return Reduce(elements_, [](const SecureUnsignedInteger& a, const SecureUnsignedInteger& b) {
+    return a + b;
+  });
+}
+
+SecureUnsignedInteger SecureUnsignedIntegerVector::SumWhere(const ShareWrapper& condition) const {
+  const ShareWrapper& elements{elements_.Get()};
+  // the difference of the elements with themselves is a zero without communication
+  const ShareWrapper zero{elements->GetCircuitType() == CircuitType::kArithmetic
+                              ? elements - elements
+                              : elements ^ elements};
+  return SecureUnsignedIntegerVector(condition.Mux(elements, zero)).Sum();
+}
+
+SecureUnsignedInteger SecureUnsignedIntegerVector::Minimum() const {
+  return Reduce(elements_, [](const SecureUnsignedInteger& a, const SecureUnsignedInteger& b) {
+    return a.Minimum(b);
+  });
+}
+
+SecureUnsignedInteger SecureUnsignedIntegerVector::Maximum() const {
+  return Reduce(elements_, [](const SecureUnsignedInteger& a, const SecureUnsignedInteger& b) {
+    return a.Maximum(b);
+  });
+}
+
+SecureUnsignedIntegerVector SecureUnsignedIntegerVector::PrefixSum() const {
+  const std::size_t size{GetSize()};
+  SecureUnsignedInteger sums{elements_};
+  // Hillis-Steele scan: after the round with distance, element i is the sum of the elements
+  // max(0, i - 2 * distance + 1)..i
+  for (std::size_t distance = 1; distance < size; distance *= 2) {
+    auto shifted_sums{SubsetOf(sums, Range(distance, size)) +
+                      SubsetOf(sums, Range(0, size - distance))};
+    sums = ShareWrapper::Simdify(
+        std::vector<ShareWrapper>{SubsetOf(sums, Range(0, distance)).Get(), shifted_sums.Get()});
+  }
+  return sums;
+}
+
+SecureUnsignedIntegerVector SecureUnsignedIntegerVector::Gather(
+    std::span<const std::size_t> positions) const {
+  return SubsetOf(elements_, positions);
+}
+
+SecureUnsignedIntegerVector SecureUnsignedIntegerVector::Scatter(
+    std::span<const std::size_t> positions, const SecureUnsignedIntegerVector& target) const {
+  const std::size_t size{GetSize()}, target_size{target.GetSize()};
+  if (positions.size() != size) {
+    throw std::invalid_argument(fmt::format(
+        "Scatter of {} elements to {} positions", size, positions.size()));
+  }
+  // the elements of this vector follow the elements of target in the combined share
+  auto source_positions{Range(0, target_size)};
+  std::vector<bool> is_scattered(target_size, false);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (positions[i] >= target_size) {
+      throw std::out_of_range(fmt::format("Scatter to position {} of a vector with {} elements",
+                                          positions[i], target_size));
+    }
+    if (is_scattered[positions[i]]) {
+      throw std::invalid_argument(
+          fmt::format("Scatter to position {} more than once", positions[i]));
+    }
+    is_scattered[positions[i]] = true;
+    source_positions[positions[i]] = target_size + i;
+  }
+  const SecureUnsignedInteger combined{ShareWrapper::Simdify(
+      std::vector<ShareWrapper>{target.elements_.Get(), elements_.Get()})};
+  return SubsetOf(combined, source_positions);
+}
+
+}  // namespace encrypto::motion
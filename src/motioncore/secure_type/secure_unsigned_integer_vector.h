@@ -0,0 +1,157 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+
+
+#pragma once
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "secure_unsigned_integer.h"
+
+namespace encrypto::motion {
+
+/// \brief a vector of unsigned integers stored as the SIMD values of a single share, s.t. the
+/// element-wise operators, reductions and prefix sums construct one gate per operation or per
+/// round instead of one per element, and gathering and scattering elements are Subset gates.
+class SecureUnsignedIntegerVector {
+ public:
+  SecureUnsignedIntegerVector() = default;
+
+  SecureUnsignedIntegerVector(const SecureUnsignedInteger& elements) : elements_(elements) {}
+
+  SecureUnsignedIntegerVector(SecureUnsignedInteger&& elements)
+      : elements_(std::move(elements)) {}
+
+  SecureUnsignedIntegerVector(const ShareWrapper& elements) : elements_(elements) {}
+
+  SecureUnsignedIntegerVector(const SharePointer& elements) : elements_(elements) {}
+
+  /// \brief composes the elements, which may have several SIMD values each, into a vector,
+  /// see ShareWrapper::Simdify.
+  static SecureUnsignedIntegerVector FromElements(std::span<const SecureUnsignedInteger> elements);
+
+  /// \brief returns a vector of size copies of value, which has to have exactly 1 SIMD value.
+  static SecureUnsignedIntegerVector Broadcast(const SecureUnsignedInteger& value,
+                                               std::size_t size);
+
+  SecureUnsignedInteger& Get() { return elements_; }
+
+  const SecureUnsignedInteger& Get() const { return elements_; }
+
+  /// \brief returns the number of elements, i.e., SIMD values.
+  std::size_t GetSize() const;
+
+  SecureUnsignedIntegerVector operator+(const SecureUnsignedIntegerVector& other) const {
+    return elements_ + other.elements_;
+  }
+
+  SecureUnsignedIntegerVector operator-(const SecureUnsignedIntegerVector& other) const {
+    return elements_ - other.elements_;
+  }
+
+  SecureUnsignedIntegerVector operator*(const SecureUnsignedIntegerVector& other) const {
+    return elements_ * other.elements_;
+  }
+
+  SecureUnsignedIntegerVector operator/(const SecureUnsignedIntegerVector& other) const {
+    return elements_ / other.elements_;
+  }
+
+  /// \brief returns the element-wise comparison as a Boolean share with 1 wire and GetSize() SIMD
+  /// values, which can select between two vectors via ShareWrapper::Mux.
+  ShareWrapper operator>(const SecureUnsignedIntegerVector& other) const {
+    return elements_ > other.elements_;
+  }
+
+  ShareWrapper operator<(const SecureUnsignedIntegerVector& other) const { return other > *this; }
+
+  ShareWrapper operator==(const SecureUnsignedIntegerVector& other) const {
+    return elements_ == other.elements_;
+  }
+
+  /// \brief returns selection ? a : b element-wise, where selection has 1 wire and the SIMD
+  /// values of the vectors, see SecureUnsignedInteger::Mux.
+  static SecureUnsignedIntegerVector Mux(const ShareWrapper& selection,
+                                         const SecureUnsignedIntegerVector& a,
+                                         const SecureUnsignedIntegerVector& b) {
+    return SecureUnsignedInteger::Mux(selection, a.elements_, b.elements_);
+  }
+
+  /// \brief returns the sum of all elements computed by a tree of ceil(log2(GetSize()))
+  /// additions, each of which adds the two halves of the remaining elements in one gate.
+  /// \throws invalid_argument if the vector is empty.
+  SecureUnsignedInteger Sum() const;
+
+  /// \brief returns the sum of the elements whose condition is one, i.e., SUM WHERE condition,
+  /// where condition has 1 wire and GetSize() SIMD values.  The other elements are replaced by
+  /// zero in one Mux, which needs no conversion of arithmetic GMW elements.
+  /// \throws invalid_argument if the vector is empty.
+  SecureUnsignedInteger SumWhere(const ShareWrapper& condition) const;
+
+  /// \brief returns the smallest element using the same tree as Sum().
+  /// \throws invalid_argument if the vector is empty.
+  SecureUnsignedInteger Minimum() const;
+
+  /// \brief returns the largest element using the same tree as Sum().
+  /// \throws invalid_argument if the vector is empty.
+  SecureUnsignedInteger Maximum() const;
+
+  /// \brief returns the inclusive prefix sums, i.e., element i is the sum of the elements 0..i,
+  /// using ceil(log2(GetSize())) rounds of additions, each of which adds the elements shifted by
+  /// 2^round in one gate.
+  SecureUnsignedIntegerVector PrefixSum() const;
+
+  /// \brief returns the vector of the elements at positions, which may repeat, see
+  /// ShareWrapper::Subset.
+  /// \throws out_of_range if a position is not smaller than GetSize().
+  SecureUnsignedIntegerVector Gather(std::span<const std::size_t> positions) const;
+
+  /// \brief returns a copy of target in which element positions[i] is replaced by element i of
+  /// this vector.
+  /// \throws invalid_argument if positions does not contain GetSize() distinct positions.
+  /// \throws out_of_range if a position is not smaller than target.GetSize().
+  SecureUnsignedIntegerVector Scatter(std::span<const std::size_t> positions,
+                                      const SecureUnsignedIntegerVector& target) const;
+
+  /// \brief decomposes the vector into its elements, see SecureUnsignedInteger::Unsimdify.
+  std::vector<SecureUnsignedInteger> Unsimdify() const { return elements_.Unsimdify(); }
+
+  /// \brief constructs an output gate, see SecureUnsignedInteger::Out.
+  SecureUnsignedIntegerVector Out(
+      std::size_t output_owner = std::numeric_limits<std::int64_t>::max()) const {
+    return elements_.Out(output_owner);
+  }
+
+  /// \brief returns the output elements, see SecureUnsignedInteger::As.
+  template <typename T>
+  std::vector<T> As() const {
+    return elements_.As<std::vector<T>>();
+  }
+
+ private:
+  SecureUnsignedInteger elements_;
+};
+
+}  // namespace encrypto::motion
@@ -22,13 +22,23 @@
 
 #include "analysis.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 #include <fmt/format.h>
 
+#include "base/backend.h"
+#include "base/compiled_circuit.h"
+#include "base/configuration.h"
+#include "circuit_statistics.h"
 #include "communication/transport.h"
+#include "protocols/gate.h"
 #include "utility/runtime_info.h"
 #include "utility/version.h"
 
@@ -40,14 +50,43 @@ static double ComputeDuration(const RunTimeStatistics::TimePointPair& tpp) {
   return d.count();
 }
 
+static double ComputeDuration(RunTimeStatistics::ClockType::duration duration) {
+  return std::chrono::duration<double, AccumulatedRunTimeStatistics::Resolution>(duration).count();
+}
+
+static double ToMebibytes(std::size_t number_of_bytes) {
+  return static_cast<double>(number_of_bytes) / (std::size_t(1) << 20);
+}
+
 void AccumulatedRunTimeStatistics::Add(const RunTimeStatistics& statistics) {
   for (std::size_t i = 0; i <= static_cast<std::size_t>(RunTimeStatistics::StatisticsId::kMax);
        ++i) {
     accumulators_[i](ComputeDuration(statistics.data[i]));
   }
+  for (const auto& [gate_class, gate_statistics] : statistics.gate_statistics) {
+    gate_accumulators_[gate_class].Add(gate_statistics);
+  }
+  if (layer_accumulators_.size() < statistics.layer_statistics.size()) {
+    layer_accumulators_.resize(statistics.layer_statistics.size());
+  }
+  for (std::size_t layer = 0; layer < statistics.layer_statistics.size(); ++layer) {
+    layer_accumulators_[layer].Add(statistics.layer_statistics[layer]);
+  }
+  for (std::size_t i = 0; i < kNumberOfMemorySubsystems; ++i) {
+    current_memory_accumulators_[i](ToMebibytes(statistics.memory_usage[i].current_bytes));
+    peak_memory_accumulators_[i](ToMebibytes(statistics.memory_usage[i].peak_bytes));
+  }
   ++count_;
 }
 
+void AccumulatedRunTimeStatistics::GateAccumulators::Add(
+    const RunTimeStatistics::GateStatistics& statistics) {
+  number_of_gates = statistics.number_of_gates;
+  number_of_bytes_per_party = statistics.number_of_bytes_per_party;
+  online_time(ComputeDuration(statistics.online_time));
+  wait_time(ComputeDuration(statistics.wait_time));
+}
+
 template <typename C>
 static typename C::value_type At(const C& container, RunTimeStatistics::StatisticsId id) {
   return container.at(static_cast<std::size_t>(id));
@@ -98,31 +137,68 @@ std::string AccumulatedRunTimeStatistics::PrintHumanReadable() const {
      << "---------------------------------------------------------------------------\n"
      << FormatLine("Circuit Evaluation", unit, At(accumulators_, StatId::kEvaluate), kFieldWidth);
 
+  ss << "---------------------------------------------------------------------------\n"
+     << "Peak memory\n";
+  for (std::size_t i = 0; i < kNumberOfMemorySubsystems; ++i) {
+    ss << FormatLine(to_string(static_cast<MemorySubsystem>(i)), "MiB",
+                     peak_memory_accumulators_[i], kFieldWidth);
+  }
+
   return ss.str();
 }
 
+static boost::json::object MakeTriple(const AccumulatedRunTimeStatistics::AccumulatorType& acc) {
+  return boost::json::object({{"mean", boost::accumulators::mean(acc)},
+                              {"median", boost::accumulators::median(acc)},
+                              // uncorrected standard deviation
+                              {"stddev", std::sqrt(boost::accumulators::variance(acc))}});
+}
+
+boost::json::object AccumulatedRunTimeStatistics::GateAccumulators::ToJson() const {
+  return {{"number_of_gates", number_of_gates},
+          {"bytes_per_party", number_of_bytes_per_party},
+          {"online_time", MakeTriple(online_time)},
+          {"wait_time", MakeTriple(wait_time)}};
+}
+
 boost::json::object AccumulatedRunTimeStatistics::ToJson() const {
   const auto make_triple = [this](const auto& stat_id) {
-    const auto& acc = At(accumulators_, stat_id);
-    return boost::json::object({{"mean", boost::accumulators::mean(acc)},
-                                {"median", boost::accumulators::median(acc)},
-                                // uncorrected standard deviation
-                                {"stddev", std::sqrt(boost::accumulators::variance(acc))}});
+    return MakeTriple(At(accumulators_, stat_id));
   };
-  return {{"repetitions", count_},
-          {"mt_presetup", make_triple(StatId::kMtPresetup)},
-          {"mt_setup", make_triple(StatId::kMtSetup)},
-          {"sp_presetup", make_triple(StatId::kSpPresetup)},
-          {"sp_setup", make_triple(StatId::kSpSetup)},
-          {"sb_presetup", make_triple(StatId::kSbPresetup)},
-          {"sb_setup", make_triple(StatId::kSbSetup)},
-          {"base_ots", make_triple(StatId::kBaseOts)},
-          {"ot_extension_setup", make_triple(StatId::kOtExtensionSetup)},
-          {"kk13_ot_extension_setup", make_triple(StatId::kKK13OtExtensionSetup)},
-          {"preprocessing", make_triple(StatId::kPreprocessing)},
-          {"gates_setup", make_triple(StatId::kGatesSetup)},
-          {"gates_online", make_triple(StatId::kGatesOnline)},
-          {"evaluate", make_triple(StatId::kEvaluate)}};
+  boost::json::object result{
+      {"repetitions", count_},
+      {"mt_presetup", make_triple(StatId::kMtPresetup)},
+      {"mt_setup", make_triple(StatId::kMtSetup)},
+      {"sp_presetup", make_triple(StatId::kSpPresetup)},
+      {"sp_setup", make_triple(StatId::kSpSetup)},
+      {"sb_presetup", make_triple(StatId::kSbPresetup)},
+      {"sb_setup", make_triple(StatId::kSbSetup)},
+      {"base_ots", make_triple(StatId::kBaseOts)},
+      {"ot_extension_setup", make_triple(StatId::kOtExtensionSetup)},
+      {"kk13_ot_extension_setup", make_triple(StatId::kKK13OtExtensionSetup)},
+      {"preprocessing", make_triple(StatId::kPreprocessing)},
+      {"gates_setup", make_triple(StatId::kGatesSetup)},
+      {"gates_online", make_triple(StatId::kGatesOnline)},
+      {"evaluate", make_triple(StatId::kEvaluate)}};
+  if (!gate_accumulators_.empty()) {
+    boost::json::object gates;
+    for (const auto& [gate_class, accumulators] : gate_accumulators_) {
+      gates[gate_class] = accumulators.ToJson();
+    }
+    boost::json::array layers;
+    for (const auto& accumulators : layer_accumulators_) layers.emplace_back(accumulators.ToJson());
+    result["gates"] = std::move(gates);
+    result["layers"] = std::move(layers);
+  }
+  boost::json::object memory;
+  for (std::size_t i = 0; i < kNumberOfMemorySubsystems; ++i) {
+    boost::json::object usage;
+    usage["current_mib"] = MakeTriple(current_memory_accumulators_[i]);
+    usage["peak_mib"] = MakeTriple(peak_memory_accumulators_[i]);
+    memory[to_string(static_cast<MemorySubsystem>(i))] = std::move(usage);
+  }
+  result["memory"] = std::move(memory);
+  return result;
 }
 
 void AccumulatedCommunicationStatistics::Add(const communication::TransportStatistics& statistics) {
@@ -130,9 +206,38 @@ void AccumulatedCommunicationStatistics::Add(const communication::TransportStati
   accumulators_[kIdxNumberOfMessagesReceived](statistics.number_of_messages_received);
   accumulators_[kIdxNumberOfBytesSent](statistics.number_of_bytes_sent);
   accumulators_[kIdxNumberOfBytesReceived](statistics.number_of_bytes_received);
+  for (const auto& [message_type, message_type_statistics] : statistics.message_types) {
+    message_type_sums_[message_type].Add(message_type_statistics);
+    phase_sums_[to_string(message_type_statistics.phase)].Add(message_type_statistics);
+  }
   ++count_;
 }
 
+void AccumulatedCommunicationStatistics::MessageTypeSums::Add(
+    const communication::MessageTypeStatistics& statistics) {
+  phase = to_string(statistics.phase);
+  sums[kIdxNumberOfMessagesSent] += statistics.number_of_messages_sent;
+  sums[kIdxNumberOfMessagesReceived] += statistics.number_of_messages_received;
+  sums[kIdxNumberOfBytesSent] += statistics.number_of_bytes_sent;
+  sums[kIdxNumberOfBytesReceived] += statistics.number_of_bytes_received;
+  send_queue_time += statistics.send_queue_time;
+}
+
+boost::json::object AccumulatedCommunicationStatistics::MessageTypeSums::ToJson(
+    std::size_t count) const {
+  const auto mean = [count](std::size_t sum) { return count == 0 ? 0 : sum / count; };
+  const auto number_of_messages_sent{sums[kIdxNumberOfMessagesSent]};
+  return {{"phase", phase},
+          {"bytes_sent", mean(sums[kIdxNumberOfBytesSent])},
+          {"num_messages_sent", mean(number_of_messages_sent)},
+          {"bytes_received", mean(sums[kIdxNumberOfBytesReceived])},
+          {"num_messages_received", mean(sums[kIdxNumberOfMessagesReceived])},
+          {"send_queue_time",
+           number_of_messages_sent == 0 ? 0.0
+                                        : ComputeDuration(send_queue_time) /
+                                              static_cast<double>(number_of_messages_sent)}};
+}
+
 void AccumulatedCommunicationStatistics::Add(
     const std::vector<communication::TransportStatistics>& statistics) {
   for (const auto& s : statistics) {
@@ -153,11 +258,33 @@ std::string AccumulatedCommunicationStatistics::PrintHumanReadable() const {
                     boost::accumulators::mean(accumulators_[kIdxNumberOfBytesReceived]) / kMiB,
                     static_cast<std::size_t>(
                         boost::accumulators::mean(accumulators_[kIdxNumberOfMessagesReceived])));
+  if (message_type_sums_.empty()) {
+    return ss.str();
+  }
+
+  const auto print_sums = [&ss, this](const std::string& name, const MessageTypeSums& sums) {
+    const auto count{static_cast<double>(std::max<std::size_t>(count_, 1))};
+    const auto number_of_messages_sent{sums.sums[kIdxNumberOfMessagesSent]};
+    ss << fmt::format(
+        "{:36s} {:7s} {:10.3f} {:9.0f} {:10.3f} {:9.0f} {:8.3f}\n", name, sums.phase,
+        sums.sums[kIdxNumberOfBytesSent] / count / kMiB, number_of_messages_sent / count,
+        sums.sums[kIdxNumberOfBytesReceived] / count / kMiB,
+        sums.sums[kIdxNumberOfMessagesReceived] / count,
+        number_of_messages_sent == 0
+            ? 0.0
+            : ComputeDuration(sums.send_queue_time) / static_cast<double>(number_of_messages_sent));
+  };
+  ss << "---------------------------------------------------------------------------\n"
+     << fmt::format("{:36s} {:7s} {:>10s} {:>9s} {:>10s} {:>9s} {:>8s}\n", "message type", "phase",
+                    "sent MiB", "messages", "recv MiB", "messages", "queue ms");
+  for (const auto& [message_type, sums] : message_type_sums_) print_sums(message_type, sums);
+  ss << "---------------------------------------------------------------------------\n";
+  for (const auto& [phase, sums] : phase_sums_) print_sums("total", sums);
   return ss.str();
 }
 
 boost::json::object AccumulatedCommunicationStatistics::ToJson() const {
-  return {
+  boost::json::object result{
       {"bytes_sent",
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[kIdxNumberOfBytesSent]))},
       {"num_messages_sent", static_cast<std::size_t>(boost::accumulators::mean(
@@ -166,6 +293,236 @@ boost::json::object AccumulatedCommunicationStatistics::ToJson() const {
                              boost::accumulators::mean(accumulators_[kIdxNumberOfBytesReceived]))},
       {"num_messages_received", static_cast<std::size_t>(boost::accumulators::mean(
                                     accumulators_[kIdxNumberOfMessagesReceived]))}};
+  if (!message_type_sums_.empty()) {
+    boost::json::object message_types, phases;
+    for (const auto& [message_type, sums] : message_type_sums_) {
+      message_types[message_type] = sums.ToJson(count_);
+    }
+    for (const auto& [phase, sums] : phase_sums_) phases[phase] = sums.ToJson(count_);
+    result["message_types"] = std::move(message_types);
+    result["phases"] = std::move(phases);
+  }
+  return result;
+}
+
+using Interval = std::pair<Tracer::TimePoint, Tracer::TimePoint>;
+
+// appends the parts of \p span that are not covered by \p waits, which are sorted and disjoint
+static void AppendComputation(const Interval& span, const std::vector<Interval>& waits,
+                              std::vector<Interval>& computation) {
+  auto start{span.first};
+  for (const auto& [wait_start, wait_end] : waits) {
+    if (wait_end <= start || wait_start >= span.second) continue;
+    if (wait_start > start) computation.emplace_back(start, wait_start);
+    start = std::max(start, wait_end);
+  }
+  if (start < span.second) computation.emplace_back(start, span.second);
+}
+
+// length of the union of \p intervals
+static ExecutionAnalysis::Duration GetLength(std::vector<Interval> intervals) {
+  std::sort(intervals.begin(), intervals.end());
+  ExecutionAnalysis::Duration length{0};
+  std::optional<Interval> current;
+  for (const auto& interval : intervals) {
+    if (current && interval.first <= current->second) {
+      current->second = std::max(current->second, interval.second);
+      continue;
+    }
+    if (current) length += current->second - current->first;
+    current = interval;
+  }
+  if (current) length += current->second - current->first;
+  return length;
+}
+
+ExecutionAnalysis::ExecutionAnalysis(Backend& backend, const std::vector<Tracer::Event>& events)
+    : party_id_(backend.GetConfiguration()->GetMyId()),
+      number_of_theoretical_rounds_(CircuitStatistics(backend).GetNumberOfRounds()) {
+  const auto* compiled_circuit{backend.GetCompiledCircuit()};
+  std::optional<CompiledCircuit> circuit;
+  if (compiled_circuit == nullptr) {
+    compiled_circuit = &circuit.emplace(*backend.GetRegister());
+  }
+  const auto number_of_gates{compiled_circuit->GetNumberOfGates()};
+  std::unordered_map<std::uint64_t, std::size_t> gate_indices;
+  for (std::size_t i = 0; i < number_of_gates; ++i) {
+    gate_indices.emplace(compiled_circuit->GetGate(i).GetId(), i);
+  }
+
+  // the events are ordered by their start, s.t. the waits of each gate are sorted and disjoint
+  std::vector<const Tracer::Event*> online_events(number_of_gates, nullptr);
+  std::vector<std::pair<std::size_t, Interval>> gate_spans;
+  std::vector<std::vector<Interval>> waits(number_of_gates);
+  std::vector<const Tracer::Event*> messages;
+  for (const auto& event : events) {
+    if (event.party_id != party_id_) continue;
+    if (event.category == Tracer::Category::kMessageSent ||
+        event.category == Tracer::Category::kMessageReceived) {
+      messages.push_back(&event);
+      continue;
+    }
+    // skips the fiber waits outside of gates and the gates of previously evaluated circuits
+    const auto gate_index{gate_indices.find(event.id)};
+    if (gate_index == gate_indices.end()) continue;
+    const Interval span{event.start, event.end};
+    if (event.category == Tracer::Category::kFiberWait) {
+      waits[gate_index->second].push_back(span);
+      continue;
+    }
+    if (event.category == Tracer::Category::kGateOnline) online_events[gate_index->second] = &event;
+    gate_spans.emplace_back(gate_index->second, span);
+  }
+
+  // the predecessor of a gate on the critical path is the traced gate that finished last among its
+  // ancestors, which skips the gates without an online phase
+  constexpr auto kNone{std::numeric_limits<std::size_t>::max()};
+  const auto finishes_later{[&online_events](std::size_t a, std::size_t b) {
+    return b == kNone || (a != kNone && online_events[a]->end > online_events[b]->end);
+  }};
+  std::vector<std::size_t> last_finished(number_of_gates, kNone), predecessors(number_of_gates,
+                                                                               kNone);
+  std::size_t end_of_path{kNone};
+  // the gates are in topological order
+  for (std::size_t i = 0; i < number_of_gates; ++i) {
+    std::size_t predecessor{kNone};
+    for (auto parent : compiled_circuit->GetFanIn(i)) {
+      if (finishes_later(last_finished[parent], predecessor)) predecessor = last_finished[parent];
+    }
+    if (online_events[i] == nullptr) {
+      last_finished[i] = predecessor;
+      continue;
+    }
+    last_finished[i] = i;
+    predecessors[i] = predecessor;
+    if (finishes_later(i, end_of_path)) end_of_path = i;
+  }
+  if (end_of_path == kNone) {
+    throw std::invalid_argument(
+        fmt::format("The trace contains no online phase of a gate of party {}", party_id_));
+  }
+
+  std::vector<std::size_t> path;
+  for (auto i = end_of_path; i != kNone; i = predecessors[i]) path.push_back(i);
+  std::reverse(path.begin(), path.end());
+  // the shortest wait of a gate is the estimate of the latency of a round
+  std::optional<Duration> shortest_wait;
+  std::size_t number_of_waiting_gates{0};
+  for (auto i : path) {
+    const Interval span{online_events[i]->start, online_events[i]->end};
+    std::vector<Interval> computation;
+    AppendComputation(span, waits[i], computation);
+    const auto computation_time{GetLength(std::move(computation))};
+    const auto wait_time{(span.second - span.first) - computation_time};
+    computation_time_ += computation_time;
+    communication_time_ += wait_time;
+    if (wait_time.count() > 0) {
+      shortest_wait = std::min(shortest_wait.value_or(wait_time), wait_time);
+      ++number_of_waiting_gates;
+    }
+    critical_path_.push_back(GetGateClassName(*online_events[i]->gate_type));
+  }
+  latency_time_ = shortest_wait.value_or(Duration(0)) * number_of_waiting_gates;
+  const auto end{online_events[end_of_path]->end};
+  critical_path_time_ = end - online_events[path.front()]->start;
+
+  std::vector<Interval> computation;
+  auto start{end}, online_start{end};
+  for (const auto& [gate_index, span] : gate_spans) {
+    start = std::min(start, span.first);
+    if (online_events[gate_index] != nullptr) {
+      online_start = std::min(online_start, online_events[gate_index]->start);
+    }
+    AppendComputation(span, waits[gate_index], computation);
+  }
+  evaluation_time_ = end - start;
+  idle_time_ = std::max(Duration(0), evaluation_time_ - GetLength(std::move(computation)));
+
+  // per other party: whether a message was received since the last one was sent, and the rounds
+  std::unordered_map<std::uint16_t, std::pair<bool, std::size_t>> rounds;
+  for (const auto* message : messages) {
+    if (message->start < online_start || message->start > end) continue;
+    auto& [received, number_of_rounds]{
+        rounds.try_emplace(message->other_party_id, true, 0).first->second};
+    if (message->category == Tracer::Category::kMessageReceived) {
+      received = true;
+    } else if (received) {
+      received = false;
+      ++number_of_rounds;
+    }
+  }
+  for (const auto& [other_party_id, party_rounds] : rounds) {
+    number_of_rounds_ = std::max(number_of_rounds_, party_rounds.second);
+  }
+}
+
+std::string ExecutionAnalysis::PrintHumanReadable() const {
+  std::stringstream ss;
+  const auto scheduling_time{
+      std::max(Duration(0), critical_path_time_ - computation_time_ - communication_time_)};
+  const auto percentage{[](Duration part, Duration total) {
+    return total.count() == 0 ? 0.0
+                              : 100.0 * static_cast<double>(part.count()) / total.count();
+  }};
+  const auto bandwidth_time{communication_time_ - latency_time_};
+  std::string bottleneck{"computation"};
+  if (communication_time_ > computation_time_ && communication_time_ >= scheduling_time) {
+    bottleneck = latency_time_ >= bandwidth_time ? "rounds" : "bandwidth";
+  } else if (scheduling_time > computation_time_) {
+    bottleneck = "scheduling";
+  }
+
+  // the classes that occur most often on the critical path
+  std::map<std::string, std::size_t> gate_classes;
+  for (const auto& gate_class : critical_path_) ++gate_classes[gate_class];
+  std::vector<std::pair<std::string, std::size_t>> sorted_classes(gate_classes.begin(),
+                                                                  gate_classes.end());
+  std::stable_sort(sorted_classes.begin(), sorted_classes.end(),
+                   [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  ss << fmt::format("Execution analysis of party {}\n", party_id_)
+     << "---------------------------------------------------------------------------\n"
+     << fmt::format("Evaluation: {:.3f} ms, idle {:.3f} ms ({:.1f} %)\n",
+                    ComputeDuration(evaluation_time_), ComputeDuration(idle_time_),
+                    percentage(idle_time_, evaluation_time_))
+     << fmt::format("Critical path of {} gates: {:.3f} ms\n", critical_path_.size(),
+                    ComputeDuration(critical_path_time_))
+     << fmt::format("  computation   {:10.3f} ms ({:.1f} %)\n", ComputeDuration(computation_time_),
+                    percentage(computation_time_, critical_path_time_))
+     << fmt::format("  communication {:10.3f} ms ({:.1f} %)\n",
+                    ComputeDuration(communication_time_),
+                    percentage(communication_time_, critical_path_time_))
+     << fmt::format("    latency     {:10.3f} ms\n", ComputeDuration(latency_time_))
+     << fmt::format("    bandwidth   {:10.3f} ms\n", ComputeDuration(bandwidth_time))
+     << fmt::format("  scheduling    {:10.3f} ms ({:.1f} %)\n", ComputeDuration(scheduling_time),
+                    percentage(scheduling_time, critical_path_time_));
+  for (std::size_t i = 0; i < std::min<std::size_t>(sorted_classes.size(), 3); ++i) {
+    ss << fmt::format("  {} x {}\n", sorted_classes[i].second, sorted_classes[i].first);
+  }
+  ss << fmt::format("Online rounds: {} taken, {} in the circuit\n", number_of_rounds_,
+                    number_of_theoretical_rounds_)
+     << fmt::format("Bottleneck: {}\n", bottleneck);
+  return ss.str();
+}
+
+boost::json::object ExecutionAnalysis::ToJson() const {
+  std::map<std::string, std::size_t> gate_classes;
+  for (const auto& gate_class : critical_path_) ++gate_classes[gate_class];
+  boost::json::object critical_path{{"number_of_gates", critical_path_.size()},
+                                    {"time", ComputeDuration(critical_path_time_)},
+                                    {"computation_time", ComputeDuration(computation_time_)},
+                                    {"communication_time", ComputeDuration(communication_time_)},
+                                    {"latency_time", ComputeDuration(latency_time_)}};
+  boost::json::object gates;
+  for (const auto& [gate_class, count] : gate_classes) gates[gate_class] = count;
+  critical_path["gates"] = std::move(gates);
+  boost::json::object result{{"party_id", party_id_},
+                             {"evaluation_time", ComputeDuration(evaluation_time_)},
+                             {"idle_time", ComputeDuration(idle_time_)},
+                             {"rounds", number_of_rounds_},
+                             {"theoretical_rounds", number_of_theoretical_rounds_}};
+  result["critical_path"] = std::move(critical_path);
+  return result;
 }
 
 std::string PrintMotionInfo() {
@@ -195,4 +552,28 @@ std::string PrintStatistics(const std::string& experiment_name,
   return ss.str();
 }
 
+std::string PrintStatistics(const std::string& experiment_name,
+                            const AccumulatedRunTimeStatistics& execution_statistics,
+                            const AccumulatedCommunicationStatistics& communication_statistics,
+                            const CircuitStatistics& circuit_statistics) {
+  std::stringstream ss;
+  ss << PrintStatistics(experiment_name, execution_statistics, communication_statistics)
+     << circuit_statistics.PrintHumanReadable()
+     << "===========================================================================\n";
+  return ss.str();
+}
+
+std::string PrintStatistics(const std::string& experiment_name,
+                            const AccumulatedRunTimeStatistics& execution_statistics,
+                            const AccumulatedCommunicationStatistics& communication_statistics,
+                            const CircuitStatistics& circuit_statistics,
+                            const ExecutionAnalysis& execution_analysis) {
+  std::stringstream ss;
+  ss << PrintStatistics(experiment_name, execution_statistics, communication_statistics,
+                        circuit_statistics)
+     << execution_analysis.PrintHumanReadable()
+     << "===========================================================================\n";
+  return ss.str();
+}
+
 }  // namespace encrypto::motion
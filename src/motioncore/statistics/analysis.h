@@ -30,16 +30,24 @@
 #include <boost/accumulators/statistics/variance.hpp>
 #include <boost/json.hpp>
 #include <list>
+#include <map>
+#include <string>
+#include <vector>
 #include "run_time_statistics.h"
+#include "trace.h"
 
 namespace encrypto::motion::communication {
 
+struct MessageTypeStatistics;
 struct TransportStatistics;
 
 }  // namespace encrypto::motion::communication
 
 namespace encrypto::motion {
 
+class Backend;
+class CircuitStatistics;
+
 class AccumulatedRunTimeStatistics {
  public:
   using ClockType = std::chrono::steady_clock;
@@ -52,14 +60,36 @@ class AccumulatedRunTimeStatistics {
 
   void Add(const RunTimeStatistics& statistics);
 
+  /// \brief Additionally prints the peak memory of the subsystems in MiB, see
+  ///        RunTimeStatistics::memory_usage.
   std::string PrintHumanReadable() const;
  
+  /// \brief Additionally contains the online times of the gates by class in "gates" and by layer in
+  ///        "layers" if any repetition recorded RunTimeStatistics::gate_statistics, and the memory
+  ///        of the subsystems at the end of the evaluations and their peaks in MiB in "memory".
   boost::json::object ToJson() const;
 
  private:
+  // the numbers of gates and bytes are the ones of the last repetition
+  struct GateAccumulators {
+    std::size_t number_of_gates = 0;
+    std::size_t number_of_bytes_per_party = 0;
+    AccumulatorType online_time;
+    AccumulatorType wait_time;
+
+    void Add(const RunTimeStatistics::GateStatistics& statistics);
+
+    boost::json::object ToJson() const;
+  };
+
   std::size_t count_ = 0;
   std::array<AccumulatorType, static_cast<std::size_t>(RunTimeStatistics::StatisticsId::kMax) + 1>
       accumulators_;
+  std::map<std::string, GateAccumulators> gate_accumulators_;
+  std::vector<GateAccumulators> layer_accumulators_;
+  // by MemorySubsystem in MiB
+  std::array<AccumulatorType, kNumberOfMemorySubsystems> current_memory_accumulators_;
+  std::array<AccumulatorType, kNumberOfMemorySubsystems> peak_memory_accumulators_;
 };
 
 class AccumulatedCommunicationStatistics {
@@ -77,16 +107,111 @@ class AccumulatedCommunicationStatistics {
 
   void Add(const std::vector<communication::TransportStatistics>& statistics);
 
+  /// \brief Additionally prints the communication by message type and phase, see
+  ///        communication::MessageTypeStatistics.
   std::string PrintHumanReadable() const;
  
+  /// \brief Additionally contains the communication by message type in "message_types" and by
+  ///        phase in "phases".
   boost::json::object ToJson() const;
 
  private:
+  // summed over the other parties and repetitions, the means divide by count_, s.t. a repetition
+  // without messages of a type counts as 0
+  struct MessageTypeSums {
+    std::string phase;
+    // indexed by kIdxNumberOfMessagesSent etc.
+    std::array<std::size_t, 4> sums{};
+    std::chrono::nanoseconds send_queue_time{0};
+
+    void Add(const communication::MessageTypeStatistics& statistics);
+
+    boost::json::object ToJson(std::size_t count) const;
+  };
+
   std::size_t count_ = 0;
   std::array<AccumulatorType, 4> accumulators_;
+  // by the name of the message type and by the name of the phase
+  std::map<std::string, MessageTypeSums> message_type_sums_;
+  std::map<std::string, MessageTypeSums> phase_sums_;
+};
+
+/// \brief Analysis of a traced evaluation of the circuit of a Backend, see Tracer, which tells
+///        whether the evaluation is limited by computation, by communication or by its rounds.
+///
+/// The critical path ends in the gate whose online phase finished last and continues with the
+/// parent that finished last, i.e., the one the gate waited for the longest.  The time of the path
+/// is split into the computation of its gates, their fiber waits for messages and preprocessed
+/// material, and the remaining gaps between a parent finishing and its child starting.  The
+/// shortest wait of a gate on the path estimates the latency of a round, the remaining
+/// communication time is attributed to the bandwidth.  A party is
+/// idle while none of its gates computes, i.e., all of them are blocked or none is scheduled.  The
+/// rounds taken are the most times the party sent a message to another party after receiving one
+/// from it during the online phase, which also counts the messages of an overlapping setup.
+class ExecutionAnalysis {
+ public:
+  using Duration = Tracer::ClockType::duration;
+
+  /// \param events e.g., Tracer::GetEvents() after Party::Run, the events of other parties in this
+  ///        process are ignored
+  /// \throws std::invalid_argument if \p events contains no online phase of a gate of the party
+  ExecutionAnalysis(Backend& backend, const std::vector<Tracer::Event>& events);
+
+  /// \brief Time from the first setup or online phase of a gate to the last online phase.
+  Duration GetEvaluationTime() const noexcept { return evaluation_time_; }
+
+  Duration GetIdleTime() const noexcept { return idle_time_; }
+
+  std::size_t GetCriticalPathNumberOfGates() const noexcept { return critical_path_.size(); }
+
+  Duration GetCriticalPathTime() const noexcept { return critical_path_time_; }
+
+  Duration GetCriticalPathComputationTime() const noexcept { return computation_time_; }
+
+  Duration GetCriticalPathCommunicationTime() const noexcept { return communication_time_; }
+
+  /// \brief Part of GetCriticalPathCommunicationTime() that is explained by the latency of the
+  ///        rounds of the critical path.
+  Duration GetCriticalPathLatencyTime() const noexcept { return latency_time_; }
+
+  /// \brief Class names of the gates on the critical path in evaluation order, see
+  ///        GetGateClassName.
+  const std::vector<std::string>& GetCriticalPath() const noexcept { return critical_path_; }
+
+  std::size_t GetNumberOfRounds() const noexcept { return number_of_rounds_; }
+
+  /// \brief Rounds of the circuit according to CircuitStatistics::GetNumberOfRounds.
+  std::size_t GetNumberOfTheoreticalRounds() const noexcept {
+    return number_of_theoretical_rounds_;
+  }
+
+  std::string PrintHumanReadable() const;
+
+  boost::json::object ToJson() const;
+
+ private:
+  std::size_t party_id_;
+  Duration evaluation_time_{0};
+  Duration idle_time_{0};
+  std::vector<std::string> critical_path_;
+  Duration critical_path_time_{0};
+  Duration computation_time_{0};
+  Duration communication_time_{0};
+  Duration latency_time_{0};
+  std::size_t number_of_rounds_{0};
+  std::size_t number_of_theoretical_rounds_{0};
 };
 
 std::string PrintStatistics(const std::string& experiment_name, const AccumulatedRunTimeStatistics&,
                             const AccumulatedCommunicationStatistics&);
 
+// additionally prints the static analysis of the circuit
+std::string PrintStatistics(const std::string& experiment_name, const AccumulatedRunTimeStatistics&,
+                            const AccumulatedCommunicationStatistics&, const CircuitStatistics&);
+
+// additionally prints the critical path and idle time of a traced evaluation
+std::string PrintStatistics(const std::string& experiment_name, const AccumulatedRunTimeStatistics&,
+                            const AccumulatedCommunicationStatistics&, const CircuitStatistics&,
+                            const ExecutionAnalysis&);
+
 }  // namespace encrypto::motion
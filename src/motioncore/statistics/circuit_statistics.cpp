@@ -0,0 +1,200 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "circuit_statistics.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "base/backend.h"
+#include "base/compiled_circuit.h"
+#include "base/register.h"
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "protocols/gate.h"
+#include "protocols/wire.h"
+
+namespace encrypto::motion {
+
+static bool IsConstant(MpcProtocol protocol) {
+  return protocol == MpcProtocol::kArithmeticConstant || protocol == MpcProtocol::kBooleanConstant;
+}
+
+// index into the arrays of 8, 16, 32, 64 and 128 bit counts
+static std::size_t BitLengthIndex(std::size_t bit_length, std::size_t size) {
+  for (std::size_t i = 0, l = 8; i < size; ++i, l *= 2) {
+    if (l == bit_length) return i;
+  }
+  throw std::invalid_argument(fmt::format("Unsupported bit length {}", bit_length));
+}
+
+CircuitStatistics::CircuitStatistics(Backend& backend) {
+  const auto* compiled_circuit{backend.GetCompiledCircuit()};
+  std::optional<CompiledCircuit> circuit;
+  if (compiled_circuit == nullptr) {
+    compiled_circuit = &circuit.emplace(*backend.GetRegister());
+  }
+  number_of_gates_ = compiled_circuit->GetNumberOfGates();
+  const auto& reg{*backend.GetRegister()};
+
+  // rounds of the longest path ending in each gate, in total and per protocol
+  using Depths = std::array<std::uint32_t, kNumberOfProtocols + 2>;
+  std::vector<Depths> depths(number_of_gates_);
+  for (std::size_t gate_index = 0; gate_index < number_of_gates_; ++gate_index) {
+    const auto& gate{compiled_circuit->GetGate(gate_index)};
+    auto& gate_depths{depths[gate_index]};
+    gate_depths.fill(0);
+    for (auto parent : compiled_circuit->GetFanIn(gate_index)) {
+      for (std::size_t i = 0; i < gate_depths.size(); ++i) {
+        gate_depths[i] = std::max(gate_depths[i], depths[parent][i]);
+      }
+    }
+
+    // the cost of a helper gate, e.g., the output gate opening the masked values of an AND gate,
+    // is part of the cost of its owner
+    if (reg.GetGateOwner(gate_index) != Register::kNoOwner) {
+      continue;
+    }
+    const auto cost{gate.GetOnlineCost()};
+    if (cost.number_of_rounds == 0) {
+      continue;
+    }
+    ++number_of_interactive_gates_;
+    number_of_bytes_per_party_ += cost.number_of_bytes_per_party;
+    gate_depths.back() += cost.number_of_rounds;
+    if (gate.GetOutputWires().empty()) {
+      continue;
+    }
+    const auto protocol{gate.GetOutputWires().front()->GetProtocol()};
+    if (static_cast<std::size_t>(protocol) < kNumberOfProtocols) {
+      gate_depths[static_cast<std::size_t>(protocol)] += cost.number_of_rounds;
+    }
+    const auto parent_wires{gate.GetParentWires()};
+    if (std::any_of(parent_wires.begin(), parent_wires.end(), [protocol](const auto& wire) {
+          return wire->GetProtocol() != protocol && !IsConstant(wire->GetProtocol());
+        })) {
+      gate_depths[kNumberOfProtocols] += cost.number_of_rounds;
+    }
+  }
+  for (const auto& gate_depths : depths) {
+    for (std::size_t i = 0; i < depths_.size(); ++i) {
+      depths_[i] = std::max<std::size_t>(depths_[i], gate_depths[i]);
+    }
+    number_of_rounds_ = std::max<std::size_t>(number_of_rounds_, gate_depths.back());
+  }
+
+  const auto& mt_provider{backend.GetMtProvider()};
+  number_of_mts_ = {mt_provider.GetNumberOfMts<bool>(), mt_provider.GetNumberOfMts<std::uint8_t>(),
+                    mt_provider.GetNumberOfMts<std::uint16_t>(),
+                    mt_provider.GetNumberOfMts<std::uint32_t>(),
+                    mt_provider.GetNumberOfMts<std::uint64_t>()};
+  const auto& sp_provider{backend.GetSpProvider()};
+  number_of_sps_ = {sp_provider.GetNumberOfSps<std::uint8_t>(),
+                    sp_provider.GetNumberOfSps<std::uint16_t>(),
+                    sp_provider.GetNumberOfSps<std::uint32_t>(),
+                    sp_provider.GetNumberOfSps<std::uint64_t>(),
+                    sp_provider.GetNumberOfSps<__uint128_t>()};
+  const auto& sb_provider{backend.GetSbProvider()};
+  number_of_sbs_ = {sb_provider.GetNumberOfSbs<std::uint8_t>(),
+                    sb_provider.GetNumberOfSbs<std::uint16_t>(),
+                    sb_provider.GetNumberOfSbs<std::uint32_t>(),
+                    sb_provider.GetNumberOfSbs<std::uint64_t>()};
+  for (const auto& ot_provider : backend.GetOtProviderManager().GetProviders()) {
+    if (ot_provider) {
+      number_of_ots_sent_ += ot_provider->GetNumOtsSender();
+      number_of_ots_received_ += ot_provider->GetNumOtsReceiver();
+    }
+  }
+}
+
+std::size_t CircuitStatistics::GetNumberOfMts(std::size_t bit_length) const {
+  return number_of_mts_.at(1 + BitLengthIndex(bit_length, number_of_mts_.size() - 1));
+}
+
+std::size_t CircuitStatistics::GetNumberOfSps(std::size_t bit_length) const {
+  return number_of_sps_.at(BitLengthIndex(bit_length, number_of_sps_.size()));
+}
+
+std::size_t CircuitStatistics::GetNumberOfSbs(std::size_t bit_length) const {
+  return number_of_sbs_.at(BitLengthIndex(bit_length, number_of_sbs_.size()));
+}
+
+std::string CircuitStatistics::PrintHumanReadable() const {
+  std::stringstream ss;
+  constexpr unsigned kMiB = 1024 * 1024;
+
+  ss << fmt::format("Circuit statistics of {} gates, {} interactive\n", number_of_gates_,
+                    number_of_interactive_gates_)
+     << "---------------------------------------------------------------------------\n"
+     << fmt::format("Online rounds: {}\n", number_of_rounds_);
+  for (std::size_t i = 0; i < kNumberOfProtocols; ++i) {
+    if (depths_[i] > 0) {
+      ss << fmt::format("{} depth: {}\n", to_string(static_cast<MpcProtocol>(i)), depths_[i]);
+    }
+  }
+  ss << fmt::format("Conversion depth: {}\n", depths_.back())
+     << fmt::format("Estimated online communication with each other party: {:0.3f} MiB\n",
+                    static_cast<double>(number_of_bytes_per_party_) / kMiB)
+     << "---------------------------------------------------------------------------\n"
+     << fmt::format("MTs: {} binary, {} 8 bit, {} 16 bit, {} 32 bit, {} 64 bit\n",
+                    number_of_mts_[0], number_of_mts_[1], number_of_mts_[2], number_of_mts_[3],
+                    number_of_mts_[4])
+     << fmt::format("SPs: {} 8 bit, {} 16 bit, {} 32 bit, {} 64 bit, {} 128 bit\n",
+                    number_of_sps_[0], number_of_sps_[1], number_of_sps_[2], number_of_sps_[3],
+                    number_of_sps_[4])
+     << fmt::format("SBs: {} 8 bit, {} 16 bit, {} 32 bit, {} 64 bit\n", number_of_sbs_[0],
+                    number_of_sbs_[1], number_of_sbs_[2], number_of_sbs_[3])
+     << fmt::format("OTs requested by gates: {} sent, {} received\n", number_of_ots_sent_,
+                    number_of_ots_received_);
+  return ss.str();
+}
+
+boost::json::object CircuitStatistics::ToJson() const {
+  boost::json::object depths;
+  for (std::size_t i = 0; i < kNumberOfProtocols; ++i) {
+    depths[to_string(static_cast<MpcProtocol>(i))] = depths_[i];
+  }
+  depths["conversion"] = depths_.back();
+  const auto to_array = [](const auto& values) {
+    return boost::json::array(values.begin(), values.end());
+  };
+  return {{"number_of_gates", number_of_gates_},
+          {"number_of_interactive_gates", number_of_interactive_gates_},
+          {"rounds", number_of_rounds_},
+          {"depths", std::move(depths)},
+          {"bytes_per_party", number_of_bytes_per_party_},
+          {"mts", to_array(number_of_mts_)},
+          {"sps", to_array(number_of_sps_)},
+          {"sbs", to_array(number_of_sbs_)},
+          {"ots_sent", number_of_ots_sent_},
+          {"ots_received", number_of_ots_received_}};
+}
+
+}  // namespace encrypto::motion
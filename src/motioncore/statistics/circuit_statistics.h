@@ -0,0 +1,104 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include <boost/json.hpp>
+
+#include "utility/typedefs.h"
+
+namespace encrypto::motion {
+
+class Backend;
+
+/// \brief Static analysis of the gates registered in a Backend, which is computed before the
+///        circuit is evaluated to size the preprocessing and compare protocols.
+///
+/// The rounds of a path through the circuit are the sum of Gate::GetOnlineCost() of its gates, the
+/// number of rounds of the circuit is the maximum over all paths.  The depth of a protocol counts
+/// only the rounds of the gates of that protocol, and the conversion depth those of the gates
+/// converting between protocols.  The bytes are an estimate of the online communication with each
+/// other party, which excludes message headers and the setup phase.  The preprocessing material
+/// is the one requested by the gates so far; the OTs needed to generate MTs, SPs and SBs are only
+/// registered in the presetup and are not included.
+class CircuitStatistics {
+ public:
+  explicit CircuitStatistics(Backend& backend);
+
+  /// \brief the number of all gates including the helper gates registered by other gates, see
+  /// Register::GetGateOwner
+  std::size_t GetNumberOfGates() const noexcept { return number_of_gates_; }
+
+  /// \brief the number of gates that communicate, where the helper gates are part of their owner
+  std::size_t GetNumberOfInteractiveGates() const noexcept { return number_of_interactive_gates_; }
+
+  std::size_t GetNumberOfRounds() const noexcept { return number_of_rounds_; }
+
+  std::size_t GetDepth(MpcProtocol protocol) const {
+    return depths_.at(static_cast<std::size_t>(protocol));
+  }
+
+  std::size_t GetConversionDepth() const noexcept { return depths_.back(); }
+
+  std::size_t GetNumberOfBytesPerParty() const noexcept { return number_of_bytes_per_party_; }
+
+  std::size_t GetNumberOfBinaryMts() const noexcept { return number_of_mts_.front(); }
+
+  /// \brief Number of MTs, SPs or SBs of \p bit_length bits, which is one of 8, 16, 32, 64 and,
+  ///        only for SPs, 128.
+  std::size_t GetNumberOfMts(std::size_t bit_length) const;
+  std::size_t GetNumberOfSps(std::size_t bit_length) const;
+  std::size_t GetNumberOfSbs(std::size_t bit_length) const;
+
+  std::size_t GetNumberOfOtsSent() const noexcept { return number_of_ots_sent_; }
+
+  std::size_t GetNumberOfOtsReceived() const noexcept { return number_of_ots_received_; }
+
+  std::string PrintHumanReadable() const;
+
+  boost::json::object ToJson() const;
+
+ private:
+  static constexpr std::size_t kNumberOfProtocols{static_cast<std::size_t>(MpcProtocol::kInvalid)};
+
+  std::size_t number_of_gates_{0};
+  std::size_t number_of_interactive_gates_{0};
+  std::size_t number_of_rounds_{0};
+  // one entry per protocol and the last one for conversions
+  std::array<std::size_t, kNumberOfProtocols + 1> depths_{};
+  std::size_t number_of_bytes_per_party_{0};
+
+  // binary, 8, 16, 32 and 64 bit
+  std::array<std::size_t, 5> number_of_mts_{};
+  // 8, 16, 32, 64 and 128 bit
+  std::array<std::size_t, 5> number_of_sps_{};
+  // 8, 16, 32 and 64 bit
+  std::array<std::size_t, 4> number_of_sbs_{};
+  std::size_t number_of_ots_sent_{0};
+  std::size_t number_of_ots_received_{0};
+};
+
+}  // namespace encrypto::motion
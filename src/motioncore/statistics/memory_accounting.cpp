@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "memory_accounting.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+struct AtomicMemoryUsage {
+  std::atomic<std::size_t> current_bytes{0};
+  std::atomic<std::size_t> peak_bytes{0};
+};
+
+// the subsystems are accounted by different threads, so they do not share a cache line
+struct alignas(64) PaddedMemoryUsage : AtomicMemoryUsage {};
+
+std::array<PaddedMemoryUsage, kNumberOfMemorySubsystems> memory_usages;
+
+AtomicMemoryUsage& GetUsage(MemorySubsystem subsystem) {
+  return memory_usages[static_cast<std::size_t>(subsystem)];
+}
+
+}  // namespace
+
+std::string to_string(MemorySubsystem subsystem) {
+  switch (subsystem) {
+    case MemorySubsystem::kOtExtension:
+      return "ot_extension";
+    case MemorySubsystem::kPreprocessing:
+      return "preprocessing";
+    case MemorySubsystem::kGarbledLabels:
+      return "garbled_labels";
+    case MemorySubsystem::kWires:
+      return "wires";
+    case MemorySubsystem::kMessageBuffers:
+      return "message_buffers";
+    default:
+      return "unknown";
+  }
+}
+
+void MemoryAccounting::Add(MemorySubsystem subsystem, std::size_t number_of_bytes) noexcept {
+  if (number_of_bytes == 0) return;
+  auto& usage{GetUsage(subsystem)};
+  const std::size_t current{
+      usage.current_bytes.fetch_add(number_of_bytes, std::memory_order_relaxed) +
+      number_of_bytes};
+  std::size_t peak{usage.peak_bytes.load(std::memory_order_relaxed)};
+  while (current > peak &&
+         !usage.peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryAccounting::Subtract(MemorySubsystem subsystem, std::size_t number_of_bytes) noexcept {
+  if (number_of_bytes == 0) return;
+  GetUsage(subsystem).current_bytes.fetch_sub(number_of_bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryAccounting::Get(MemorySubsystem subsystem) noexcept {
+  const auto& usage{GetUsage(subsystem)};
+  return {usage.current_bytes.load(std::memory_order_relaxed),
+          usage.peak_bytes.load(std::memory_order_relaxed)};
+}
+
+std::array<MemoryUsage, kNumberOfMemorySubsystems> MemoryAccounting::GetAll() noexcept {
+  std::array<MemoryUsage, kNumberOfMemorySubsystems> usages;
+  for (std::size_t i = 0; i < usages.size(); ++i) usages[i] = Get(static_cast<MemorySubsystem>(i));
+  return usages;
+}
+
+void MemoryAccounting::ResetPeaks() noexcept {
+  for (auto& usage : memory_usages) {
+    usage.peak_bytes.store(usage.current_bytes.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+  }
+}
+
+MemoryAccount& MemoryAccount::operator=(MemoryAccount&& other) noexcept {
+  if (this != &other) {
+    Set(0);
+    subsystem_ = other.subsystem_;
+    number_of_bytes_.store(other.number_of_bytes_.exchange(0, std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+void MemoryAccount::Set(std::size_t number_of_bytes) noexcept {
+  const std::size_t previous{number_of_bytes_.exchange(number_of_bytes, std::memory_order_relaxed)};
+  if (number_of_bytes > previous) {
+    MemoryAccounting::Add(subsystem_, number_of_bytes - previous);
+  } else {
+    MemoryAccounting::Subtract(subsystem_, previous - number_of_bytes);
+  }
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace encrypto::motion {
+
+/// \brief Subsystems whose memory is accounted by MemoryAccounting.
+enum class MemorySubsystem : std::size_t {
+  kOtExtension,     // outputs of the OT extensions, see OtExtensionSenderData
+  kPreprocessing,   // MTs, SPs and SBs in their providers
+  kGarbledLabels,   // wire labels of garbled circuits and keys of BMR
+  kWires,           // values of the other wires
+  kMessageBuffers,  // messages in the send queues and received messages waiting for dispatch
+  kMax              // maximal value of this Enum, use as size
+};
+
+constexpr std::size_t kNumberOfMemorySubsystems{static_cast<std::size_t>(MemorySubsystem::kMax)};
+
+std::string to_string(MemorySubsystem subsystem);
+
+struct MemoryUsage {
+  std::size_t current_bytes{0};
+  std::size_t peak_bytes{0};
+};
+
+/// \brief Bytes held by the subsystems of all parties in this process and their peaks, which
+///        show the subsystem that exhausts the memory of a large evaluation.
+///
+/// The bytes are the sizes of the data, not the capacities of the containers or the overhead of
+/// the allocator.  Accounting costs an atomic addition and, while the usage grows, a
+/// compare-and-swap of the peak.
+class MemoryAccounting {
+ public:
+  static void Add(MemorySubsystem subsystem, std::size_t number_of_bytes) noexcept;
+
+  static void Subtract(MemorySubsystem subsystem, std::size_t number_of_bytes) noexcept;
+
+  static MemoryUsage Get(MemorySubsystem subsystem) noexcept;
+
+  static std::array<MemoryUsage, kNumberOfMemorySubsystems> GetAll() noexcept;
+
+  /// \brief Sets the peaks to the current usages, s.t. the peaks of the next evaluation can be
+  ///        measured.  This also affects the other parties in this process.
+  static void ResetPeaks() noexcept;
+};
+
+/// \brief Bytes of one data structure that are accounted in a subsystem for the lifetime of the
+///        account.
+class MemoryAccount {
+ public:
+  explicit MemoryAccount(MemorySubsystem subsystem) noexcept : subsystem_(subsystem) {}
+
+  ~MemoryAccount() { Set(0); }
+
+  MemoryAccount(const MemoryAccount&) = delete;
+
+  /// \brief Releases the own bytes and takes over the ones of \p other.
+  MemoryAccount& operator=(MemoryAccount&& other) noexcept;
+
+  /// \brief Replaces the accounted bytes by \p number_of_bytes, may be called concurrently.
+  void Set(std::size_t number_of_bytes) noexcept;
+
+  std::size_t Get() const noexcept { return number_of_bytes_.load(std::memory_order_relaxed); }
+
+  MemorySubsystem GetSubsystem() const noexcept { return subsystem_; }
+
+ private:
+  MemorySubsystem subsystem_;
+  std::atomic<std::size_t> number_of_bytes_{0};
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,282 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "metrics.h"
+
+#include <chrono>
+#include <thread>
+
+#include <fmt/format.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include "base/backend.h"
+#include "base/configuration.h"
+#include "communication/communication_layer.h"
+#include "communication/transport.h"
+#include "executor/gate_executor.h"
+#include "memory_accounting.h"
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "run_time_statistics.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// from 1 ms to 1 min
+const std::vector<double> kTimeBuckets{0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25,
+                                       0.5,   1.0,    2.5,   5.0,  10.0,  30.0, 60.0};
+
+double GetSeconds(const RunTimeStatistics& statistics, RunTimeStatistics::StatisticsId id) {
+  const auto& [start, end]{statistics.Get(id)};
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void PrintHeader(std::string& output, const std::string& name, const char* type,
+                 const char* help) {
+  output += fmt::format("# TYPE {} {}\n# HELP {} {}\n", name, type, name, help);
+}
+
+}  // namespace
+
+Metrics::Histogram::Histogram(std::vector<double> bounds)
+    : bounds(std::move(bounds)), counts(this->bounds.size() + 1, 0) {}
+
+void Metrics::Histogram::Observe(double seconds) {
+  std::size_t bucket{0};
+  while (bucket < bounds.size() && seconds > bounds[bucket]) ++bucket;
+  ++counts[bucket];
+  sum += seconds;
+  ++count;
+}
+
+void Metrics::Histogram::Print(std::string& output, const std::string& name,
+                               const std::string& labels) const {
+  std::uint64_t cumulative_count{0};
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    cumulative_count += counts[i];
+    output += fmt::format("{}_bucket{{{},le=\"{}\"}} {}\n", name, labels, bounds[i],
+                          cumulative_count);
+  }
+  output += fmt::format("{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels, count);
+  output += fmt::format("{}_sum{{{}}} {}\n", name, labels, sum);
+  output += fmt::format("{}_count{{{}}} {}\n", name, labels, count);
+}
+
+Metrics::Metrics(Backend& backend)
+    : backend_(backend),
+      party_id_(backend.GetConfiguration()->GetMyId()),
+      preprocessing_time_(kTimeBuckets),
+      online_time_(kTimeBuckets),
+      evaluation_time_(kTimeBuckets) {}
+
+void Metrics::ObserveRun() {
+  using StatisticsId = RunTimeStatistics::StatisticsId;
+  const auto& statistics{backend_.GetRunTimeStatistics().back()};
+  auto& mt_provider{backend_.GetMtProvider()};
+  auto& sp_provider{backend_.GetSpProvider()};
+  auto& sb_provider{backend_.GetSbProvider()};
+  const std::array<std::pair<std::pair<std::string, std::size_t>, std::size_t>, 13> preprocessed{{
+      {{"mt", 1}, mt_provider.GetNumberOfMts<bool>()},
+      {{"mt", 8}, mt_provider.GetNumberOfMts<std::uint8_t>()},
+      {{"mt", 16}, mt_provider.GetNumberOfMts<std::uint16_t>()},
+      {{"mt", 32}, mt_provider.GetNumberOfMts<std::uint32_t>()},
+      {{"mt", 64}, mt_provider.GetNumberOfMts<std::uint64_t>()},
+      {{"sp", 8}, sp_provider.GetNumberOfSps<std::uint8_t>()},
+      {{"sp", 16}, sp_provider.GetNumberOfSps<std::uint16_t>()},
+      {{"sp", 32}, sp_provider.GetNumberOfSps<std::uint32_t>()},
+      {{"sp", 64}, sp_provider.GetNumberOfSps<std::uint64_t>()},
+      {{"sb", 8}, sb_provider.GetNumberOfSbs<std::uint8_t>()},
+      {{"sb", 16}, sb_provider.GetNumberOfSbs<std::uint16_t>()},
+      {{"sb", 32}, sb_provider.GetNumberOfSbs<std::uint32_t>()},
+      {{"sb", 64}, sb_provider.GetNumberOfSbs<std::uint64_t>()},
+  }};
+  const auto transport_statistics{backend_.GetCommunicationLayer().GetTransportStatistics()};
+
+  std::scoped_lock lock(mutex_);
+  ++number_of_runs_;
+  preprocessing_time_.Observe(GetSeconds(statistics, StatisticsId::kPreprocessing));
+  online_time_.Observe(GetSeconds(statistics, StatisticsId::kGatesOnline));
+  evaluation_time_.Observe(GetSeconds(statistics, StatisticsId::kEvaluate));
+  for (const auto& [kind, number] : preprocessed) number_of_preprocessed_[kind] += number;
+  // the transport statistics skip this party and count since the transports were created
+  for (std::size_t i = 0; i < transport_statistics.size(); ++i) {
+    const auto& transport{transport_statistics[i]};
+    peer_counters_[i < party_id_ ? i : i + 1] = {
+        transport.number_of_bytes_sent, transport.number_of_bytes_received,
+        transport.number_of_messages_sent, transport.number_of_messages_received};
+  }
+}
+
+std::string Metrics::Collect() {
+  const auto party_label{fmt::format("party=\"{}\"", party_id_)};
+  const auto send_queue_sizes{backend_.GetCommunicationLayer().GetSendQueueSizes()};
+  const auto fiber_pool{backend_.GetGateExecutor().GetFiberPoolStatistics()};
+
+  std::string output;
+  PrintHeader(output, "motion_send_queue_messages", "gauge",
+              "Messages waiting in the send queue of a peer.");
+  for (std::size_t peer = 0; peer < send_queue_sizes.size(); ++peer) {
+    if (peer != party_id_) {
+      output += fmt::format("motion_send_queue_messages{{{},peer=\"{}\"}} {}\n", party_label, peer,
+                            send_queue_sizes[peer]);
+    }
+  }
+  PrintHeader(output, "motion_fiber_pool_workers", "gauge",
+              "Worker threads of the fiber pool evaluating the gates.");
+  output += fmt::format("motion_fiber_pool_workers{{{}}} {}\n", party_label,
+                        fiber_pool.number_of_workers);
+  PrintHeader(output, "motion_fiber_pool_pending_tasks", "gauge",
+              "Gates posted to the fiber pool that have not finished, including blocked ones.");
+  output += fmt::format("motion_fiber_pool_pending_tasks{{{}}} {}\n", party_label,
+                        fiber_pool.number_of_pending_tasks);
+  const auto memory_usage{MemoryAccounting::GetAll()};
+  PrintHeader(output, "motion_memory_bytes", "gauge",
+              "Bytes held by a subsystem of the parties in this process.");
+  for (std::size_t i = 0; i < memory_usage.size(); ++i) {
+    output += fmt::format("motion_memory_bytes{{{},subsystem=\"{}\"}} {}\n", party_label,
+                          to_string(static_cast<MemorySubsystem>(i)),
+                          memory_usage[i].current_bytes);
+  }
+  PrintHeader(output, "motion_memory_peak_bytes", "gauge",
+              "Peak bytes held by a subsystem of the parties in this process.");
+  for (std::size_t i = 0; i < memory_usage.size(); ++i) {
+    output += fmt::format("motion_memory_peak_bytes{{{},subsystem=\"{}\"}} {}\n", party_label,
+                          to_string(static_cast<MemorySubsystem>(i)), memory_usage[i].peak_bytes);
+  }
+
+  std::scoped_lock lock(mutex_);
+  PrintHeader(output, "motion_runs", "counter", "Evaluated circuits.");
+  output += fmt::format("motion_runs_total{{{}}} {}\n", party_label, number_of_runs_);
+  PrintHeader(output, "motion_preprocessing_seconds", "histogram",
+              "Time of the preprocessing of a run, i.e., OTs, MTs, SPs and SBs.");
+  preprocessing_time_.Print(output, "motion_preprocessing_seconds", party_label);
+  PrintHeader(output, "motion_online_seconds", "histogram",
+              "Time of the online phase of the gates of a run.");
+  online_time_.Print(output, "motion_online_seconds", party_label);
+  PrintHeader(output, "motion_evaluation_seconds", "histogram", "Time of the evaluation of a run.");
+  evaluation_time_.Print(output, "motion_evaluation_seconds", party_label);
+  PrintHeader(output, "motion_preprocessed", "counter",
+              "Preprocessed MTs, SPs and SBs by bit length.");
+  for (const auto& [kind, number] : number_of_preprocessed_) {
+    output += fmt::format("motion_preprocessed_total{{{},kind=\"{}\",bits=\"{}\"}} {}\n",
+                          party_label, kind.first, kind.second, number);
+  }
+  const std::array<std::pair<const char*, const char*>, 4> peer_metrics{{
+      {"motion_peer_sent_bytes", "Bytes sent to a peer."},
+      {"motion_peer_received_bytes", "Bytes received from a peer."},
+      {"motion_peer_sent_messages", "Messages sent to a peer."},
+      {"motion_peer_received_messages", "Messages received from a peer."},
+  }};
+  for (std::size_t i = 0; i < peer_metrics.size(); ++i) {
+    PrintHeader(output, peer_metrics[i].first, "counter", peer_metrics[i].second);
+    for (const auto& [peer, counters] : peer_counters_) {
+      output += fmt::format("{}_total{{{},peer=\"{}\"}} {}\n", peer_metrics[i].first, party_label,
+                            peer, counters[i]);
+    }
+  }
+  output += "# EOF\n";
+  return output;
+}
+
+struct MetricsServer::MetricsServerImplementation {
+  using tcp = boost::asio::ip::tcp;
+
+  struct Connection {
+    explicit Connection(tcp::socket&& socket) : socket(std::move(socket)), request(kMaximumSize) {}
+
+    static constexpr std::size_t kMaximumSize = 8192;
+    tcp::socket socket;
+    boost::asio::streambuf request;
+    std::string response;
+  };
+
+  MetricsServerImplementation(std::uint16_t port, std::function<std::string()> collect)
+      : acceptor(io_context, tcp::endpoint(tcp::v4(), port)), collect(std::move(collect)) {}
+
+  void Accept() {
+    acceptor.async_accept([this](boost::system::error_code error, tcp::socket socket) {
+      if (error) {
+        return;
+      }
+      Serve(std::make_shared<Connection>(std::move(socket)));
+      Accept();
+    });
+  }
+
+  void Serve(std::shared_ptr<Connection> connection) {
+    boost::asio::async_read_until(
+        connection->socket, connection->request, "\r\n\r\n",
+        [this, connection](boost::system::error_code error, std::size_t) {
+          if (error) {
+            return;
+          }
+          std::istream request(&connection->request);
+          std::string method, target;
+          request >> method >> target;
+          if (method == "GET" && (target == "/metrics" || target.starts_with("/metrics?"))) {
+            const auto body{collect()};
+            connection->response = fmt::format(
+                "HTTP/1.1 200 OK\r\nContent-Type: application/openmetrics-text; version=1.0.0; "
+                "charset=utf-8\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}",
+                body.size(), body);
+          } else {
+            connection->response =
+                "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+          }
+          boost::asio::async_write(connection->socket, boost::asio::buffer(connection->response),
+                                   [connection](boost::system::error_code, std::size_t) {
+                                     boost::system::error_code ignored;
+                                     connection->socket.shutdown(tcp::socket::shutdown_both,
+                                                                 ignored);
+                                   });
+        });
+  }
+
+  boost::asio::io_context io_context;
+  tcp::acceptor acceptor;
+  std::function<std::string()> collect;
+  std::thread thread;
+};
+
+MetricsServer::MetricsServer(std::uint16_t port, std::function<std::string()> collect)
+    : implementation_(std::make_unique<MetricsServerImplementation>(port, std::move(collect))) {
+  implementation_->Accept();
+  implementation_->thread = std::thread([this] { implementation_->io_context.run(); });
+}
+
+MetricsServer::~MetricsServer() {
+  implementation_->io_context.stop();
+  implementation_->thread.join();
+}
+
+std::uint16_t MetricsServer::GetPort() const noexcept {
+  return implementation_->acceptor.local_endpoint().port();
+}
+
+}  // namespace encrypto::motion
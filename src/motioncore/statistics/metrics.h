@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace encrypto::motion {
+
+class Backend;
+
+/// \brief Metrics of a long-running party in the OpenMetrics text format, which Prometheus
+///        scrapes, e.g., via a MetricsServer.
+///
+/// The counters and histograms of the evaluations are updated by ObserveRun, which is called by
+/// the thread running the party after each Party::Run.  The depths of the send queues, the load
+/// of the fiber pool and the memory of the subsystems, see MemoryAccounting, are gauges sampled
+/// by Collect, which may be called concurrently from another thread.  All metrics are labeled
+/// with the id of the party, the ones per other party additionally with the id of the peer.
+class Metrics {
+ public:
+  explicit Metrics(Backend& backend);
+
+  /// \brief Records the last run of the backend, i.e., its preprocessing and online times, its
+  ///        MTs, SPs and SBs, and the bytes exchanged with the other parties so far.
+  void ObserveRun();
+
+  /// \brief Returns the metrics in the OpenMetrics text format terminated by "# EOF".
+  std::string Collect();
+
+ private:
+  struct Histogram {
+    // upper bounds in seconds, the implicit last bucket is +Inf
+    std::vector<double> bounds;
+    // not cumulative, the last entry counts the observations above all bounds
+    std::vector<std::uint64_t> counts;
+    double sum{0};
+    std::uint64_t count{0};
+
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double seconds);
+
+    void Print(std::string& output, const std::string& name, const std::string& labels) const;
+  };
+
+  Backend& backend_;
+  std::size_t party_id_;
+  // guards the metrics updated by ObserveRun
+  std::mutex mutex_;
+  std::uint64_t number_of_runs_{0};
+  Histogram preprocessing_time_;
+  Histogram online_time_;
+  Histogram evaluation_time_;
+  // by the kind of preprocessed material, e.g., "mt", and its bit length
+  std::map<std::pair<std::string, std::size_t>, std::uint64_t> number_of_preprocessed_;
+  // by the id of the peer, bytes and messages sent and received
+  std::map<std::size_t, std::array<std::size_t, 4>> peer_counters_;
+};
+
+/// \brief Serves the metrics returned by a function to HTTP GET requests of /metrics in a thread
+///        of its own, e.g., for a Prometheus scraper.
+class MetricsServer {
+ public:
+  /// \param port TCP port to listen on, 0 picks a free one, see GetPort
+  /// \throws boost::system::system_error if the port cannot be bound
+  MetricsServer(std::uint16_t port, std::function<std::string()> collect);
+
+  /// \brief Stops serving and joins the thread.
+  ~MetricsServer();
+
+  MetricsServer(const MetricsServer&) = delete;
+  MetricsServer& operator=(const MetricsServer&) = delete;
+
+  std::uint16_t GetPort() const noexcept;
+
+ private:
+  struct MetricsServerImplementation;
+
+  std::unique_ptr<MetricsServerImplementation> implementation_;
+};
+
+}  // namespace encrypto::motion
@@ -22,9 +22,14 @@
 
 #include "run_time_statistics.h"
 #include <fmt/format.h>
+#include <boost/core/demangle.hpp>
 #include <cmath>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+
+#include "protocols/gate.h"
 
 namespace encrypto::motion {
 
@@ -37,6 +42,27 @@ const RunTimeStatistics::TimePointPair& RunTimeStatistics::Get(StatisticsId id)
   return data.at(static_cast<std::size_t>(id));
 }
 
+void RunTimeStatistics::GateStatistics::Add(ClockType::duration online, ClockType::duration wait,
+                                             std::size_t number_of_bytes) {
+  ++number_of_gates;
+  online_time += online;
+  wait_time += wait;
+  number_of_bytes_per_party += number_of_bytes;
+}
+
+std::string GetGateClassName(const Gate& gate) { return GetGateClassName(typeid(gate)); }
+
+std::string GetGateClassName(const std::type_info& gate_type) {
+  std::string name{boost::core::demangle(gate_type.name())};
+  for (std::string_view prefix : {"encrypto::motion::proto::", "encrypto::motion::"}) {
+    for (auto position = name.find(prefix); position != std::string::npos;
+         position = name.find(prefix, position)) {
+      name.erase(position, prefix.size());
+    }
+  }
+  return name;
+}
+
 template <typename C>
 typename C::value_type At(const C& container, RunTimeStatistics::StatisticsId id) {
   return container.at(static_cast<std::size_t>(id));
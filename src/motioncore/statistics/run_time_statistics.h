@@ -24,11 +24,18 @@
 
 #include <array>
 #include <chrono>
+#include <map>
 #include <string>
+#include <typeinfo>
 #include <utility>
+#include <vector>
+
+#include "memory_accounting.h"
 
 namespace encrypto::motion {
 
+class Gate;
+
 struct RunTimeStatistics {
   using ClockType = std::chrono::steady_clock;
   using TimePoint = std::chrono::time_point<ClockType>;
@@ -67,9 +74,42 @@ struct RunTimeStatistics {
 
   const TimePointPair& Get(StatisticsId id) const;
 
+  /// \brief Online phase of the gates of one class or of one circuit layer, which is only recorded
+  ///        if Configuration::SetGateStatistics is set.
+  struct GateStatistics {
+    std::size_t number_of_gates{0};
+    // summed over the gates, i.e., concurrently evaluated gates are counted multiple times
+    ClockType::duration online_time{0};
+    // time the gates waited for their input wires before their online phase started
+    ClockType::duration wait_time{0};
+    // estimated by Gate::GetOnlineCost
+    std::size_t number_of_bytes_per_party{0};
+
+    void Add(ClockType::duration online, ClockType::duration wait, std::size_t number_of_bytes);
+  };
+
+  /// \brief Records the memory of the subsystems at the end of the evaluation, see
+  ///        MemoryAccounting.
+  void RecordMemoryUsage() { memory_usage = MemoryAccounting::GetAll(); }
+
   std::string PrintHumanReadable() const;
 
   std::array<TimePointPair, static_cast<std::size_t>(StatisticsId::kMax) + 1> data;
+
+  // by the class of the gates, e.g., "boolean_gmw::AndGate", see GetGateClassName
+  std::map<std::string, GateStatistics> gate_statistics;
+  // by the layer of the gates, see Register::GetGateLayers, unlayered gates are not included
+  std::vector<GateStatistics> layer_statistics;
+  // by MemorySubsystem, the peaks are the ones since the last MemoryAccounting::ResetPeaks of
+  // all parties in this process
+  std::array<MemoryUsage, kNumberOfMemorySubsystems> memory_usage;
 };
 
+/// \brief Returns the demangled class name of \p gate without the namespace prefixes of
+///        encrypto::motion::proto, e.g., "arithmetic_gmw::MultiplicationGate<unsigned int>".
+std::string GetGateClassName(const Gate& gate);
+
+/// \brief Same as above for the type of a gate, e.g., typeid(gate).
+std::string GetGateClassName(const std::type_info& gate_type);
+
 }  // namespace encrypto::motion
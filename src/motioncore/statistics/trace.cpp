@@ -0,0 +1,246 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+#include <boost/fiber/fss.hpp>
+#include <fmt/format.h>
+
+#include "run_time_statistics.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+thread_local std::uint16_t thread_party_id{Tracer::kUnknownParty};
+
+// points to the gate id of a FiberGateScope, which owns it
+boost::fibers::fiber_specific_ptr<std::uint64_t> fiber_gate_id([](std::uint64_t*) {});
+
+const char* ToString(Tracer::Category category) {
+  switch (category) {
+    case Tracer::Category::kGateSetup:
+      return "gate_setup";
+    case Tracer::Category::kGateOnline:
+      return "gate_online";
+    case Tracer::Category::kFiberWait:
+      return "fiber_wait";
+    case Tracer::Category::kMessageSent:
+      return "message_sent";
+    case Tracer::Category::kMessageReceived:
+      return "message_received";
+  }
+  return "unknown";
+}
+
+// the names are identifiers or demangled type names, which only need the JSON escapes of quotes
+// and backslashes
+std::string EscapeJson(std::string_view text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') escaped.push_back('\\');
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+std::string GetEventName(const Tracer::Event& event) {
+  if (event.gate_type != nullptr) return GetGateClassName(*event.gate_type);
+  return event.name == nullptr ? "" : event.name;
+}
+
+}  // namespace
+
+Tracer& Tracer::Get() {
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::Enable(std::size_t number_of_events_per_thread) {
+  if (number_of_events_per_thread == 0) {
+    throw std::invalid_argument("The trace buffers need to hold at least one event");
+  }
+  {
+    std::scoped_lock lock(buffers_mutex_);
+    number_of_events_per_thread_ = number_of_events_per_thread;
+    for (auto& buffer : buffers_) {
+      buffer->events.resize(number_of_events_per_thread);
+      buffer->number_of_events.store(0, std::memory_order_relaxed);
+    }
+  }
+  enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::SetThreadPartyId(std::size_t party_id) noexcept {
+  thread_party_id = static_cast<std::uint16_t>(party_id);
+}
+
+std::uint16_t Tracer::GetThreadPartyId() noexcept { return thread_party_id; }
+
+Tracer::FiberGateScope::FiberGateScope(std::uint64_t gate_id) : gate_id_(gate_id) {
+  fiber_gate_id.reset(&gate_id_);
+}
+
+Tracer::FiberGateScope::~FiberGateScope() { fiber_gate_id.reset(nullptr); }
+
+Tracer::ThreadBuffer& Tracer::GetThreadBuffer() {
+  thread_local ThreadBuffer* thread_buffer{nullptr};
+  if (thread_buffer == nullptr) {
+    std::scoped_lock lock(buffers_mutex_);
+    auto& buffer{buffers_.emplace_back(std::make_unique<ThreadBuffer>())};
+    buffer->thread_index = buffers_.size() - 1;
+    buffer->events.resize(number_of_events_per_thread_);
+    thread_buffer = buffer.get();
+  }
+  return *thread_buffer;
+}
+
+void Tracer::Record(const Event& event) {
+  auto& buffer{GetThreadBuffer()};
+  // only the owning thread writes, the counter is published for the export after the evaluation
+  const auto index{buffer.number_of_events.load(std::memory_order_relaxed)};
+  auto& entry{buffer.events[index % buffer.events.size()]};
+  entry = event;
+  entry.thread_index = static_cast<std::uint32_t>(buffer.thread_index);
+  buffer.number_of_events.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::RecordGate(Category category, const std::type_info& gate_type, std::size_t gate_id,
+                        std::size_t party_id, TimePoint start, TimePoint end) {
+  Record({nullptr, &gate_type, category, static_cast<std::uint16_t>(party_id), kUnknownParty,
+          gate_id, 0, start, end, 0});
+}
+
+void Tracer::RecordFiberWait(TimePoint start, TimePoint end) {
+  const auto* gate_id{fiber_gate_id.get()};
+  Record({"wait", nullptr, Category::kFiberWait, GetThreadPartyId(), kUnknownParty,
+          gate_id == nullptr ? kNoGate : *gate_id, 0, start, end, 0});
+}
+
+void Tracer::RecordMessage(Category category, const char* message_type, std::size_t party_id,
+                           std::size_t other_party_id, std::size_t number_of_bytes,
+                           TimePoint start, TimePoint end) {
+  Record({message_type, nullptr, category, static_cast<std::uint16_t>(party_id),
+          static_cast<std::uint16_t>(other_party_id), 0, number_of_bytes, start, end, 0});
+}
+
+std::vector<Tracer::Event> Tracer::GetEvents() const {
+  std::vector<Event> events;
+  std::scoped_lock lock(buffers_mutex_);
+  for (const auto& buffer : buffers_) {
+    const auto number_of_events{buffer->number_of_events.load(std::memory_order_acquire)};
+    const auto capacity{buffer->events.size()};
+    for (auto i = number_of_events > capacity ? number_of_events - capacity : 0;
+         i < number_of_events; ++i) {
+      events.push_back(buffer->events[i % capacity]);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const Event& a, const Event& b) { return a.start < b.start; });
+  return events;
+}
+
+std::string Tracer::ToChromeTraceJson() const {
+  const auto events{GetEvents()};
+
+  // the timestamps are in microseconds relative to the first event
+  const TimePoint origin{events.empty() ? TimePoint() : events.front().start};
+  const auto to_microseconds{[](ClockType::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  }};
+
+  std::string json{"{\"displayTimeUnit\":\"ns\",\"traceEvents\":["};
+  bool first{true};
+  const auto append{[&json, &first](const std::string& event) {
+    if (!first) json.push_back(',');
+    json.append(event);
+    first = false;
+  }};
+
+  std::set<std::uint16_t> parties;
+  for (const auto& event : events) {
+    parties.insert(event.party_id);
+    std::string arguments;
+    switch (event.category) {
+      case Category::kGateSetup:
+      case Category::kGateOnline:
+        arguments = fmt::format("{{\"gate_id\":{}}}", event.id);
+        break;
+      case Category::kMessageSent:
+        arguments = fmt::format("{{\"bytes\":{},\"to\":{}}}", event.number_of_bytes,
+                                event.other_party_id);
+        break;
+      case Category::kMessageReceived:
+        arguments = fmt::format("{{\"bytes\":{},\"from\":{}}}", event.number_of_bytes,
+                                event.other_party_id);
+        break;
+      case Category::kFiberWait:
+        arguments = event.id == kNoGate ? "{}" : fmt::format("{{\"gate_id\":{}}}", event.id);
+        break;
+    }
+    if (event.category == Category::kMessageReceived) {
+      append(fmt::format(
+          "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":{},"
+          "\"tid\":{},\"args\":{}}}",
+          EscapeJson(GetEventName(event)), ToString(event.category),
+          to_microseconds(event.start - origin), event.party_id, event.thread_index, arguments));
+    } else {
+      append(fmt::format(
+          "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},"
+          "\"tid\":{},\"args\":{}}}",
+          EscapeJson(GetEventName(event)), ToString(event.category),
+          to_microseconds(event.start - origin), to_microseconds(event.end - event.start),
+          event.party_id, event.thread_index, arguments));
+    }
+  }
+  for (auto party_id : parties) {
+    append(fmt::format(
+        "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+        party_id,
+        party_id == kUnknownParty ? std::string("unknown party")
+                                  : fmt::format("party {}", party_id)));
+  }
+  json.append("]}");
+  return json;
+}
+
+void Tracer::WriteChromeTrace(const std::string& path) const {
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot write the trace to {}", path));
+  }
+  file << ToChromeTraceJson();
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot write the trace to {}", path));
+  }
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,154 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace encrypto::motion {
+
+/// \brief Records a timeline of the gate phases, the fiber waits and the messages of all parties
+///        in this process, which is exported in the Chrome trace event format and can be viewed
+///        in chrome://tracing or Perfetto.
+///
+/// Each thread writes its events into a ring buffer of its own without any locking, s.t. tracing
+/// adds a few timestamps per gate and message.  If a buffer is full, the oldest events of the
+/// thread are overwritten.  When disabled, recording costs a single relaxed atomic load.  The
+/// events are read by ToChromeTraceJson, which must not run concurrently with an evaluation.
+class Tracer {
+ public:
+  using ClockType = std::chrono::steady_clock;
+  using TimePoint = ClockType::time_point;
+
+  enum class Category : std::uint8_t {
+    kGateSetup,
+    kGateOnline,
+    kFiberWait,
+    kMessageSent,
+    kMessageReceived
+  };
+
+  // party of the events recorded by threads that do not know their party
+  static constexpr std::uint16_t kUnknownParty = UINT16_MAX;
+
+  // id of the fiber waits outside of the evaluation of a gate
+  static constexpr std::uint64_t kNoGate = UINT64_MAX;
+
+  struct Event {
+    // static string, e.g., the message type, or nullptr for gates, which are named by gate_type
+    const char* name;
+    const std::type_info* gate_type;
+    Category category;
+    std::uint16_t party_id;
+    // receiver of sent and sender of received messages
+    std::uint16_t other_party_id;
+    // gate id of gate events and of the gate evaluated by the waiting fiber, or kNoGate
+    std::uint64_t id;
+    std::uint64_t number_of_bytes;
+    // start equals end for received messages
+    TimePoint start;
+    TimePoint end;
+    // index of the recording thread in the order of their first events
+    std::uint32_t thread_index;
+  };
+
+  static Tracer& Get();
+
+  /// \brief Starts recording with ring buffers of \p number_of_events_per_thread events and clears
+  ///        the events of previous recordings.
+  void Enable(std::size_t number_of_events_per_thread = 1 << 16);
+
+  void Disable() noexcept { enabled_.store(false, std::memory_order_relaxed); }
+
+  static bool IsEnabled() noexcept { return Get().enabled_.load(std::memory_order_relaxed); }
+
+  /// \brief Sets the party of the events recorded by the calling thread, e.g., of the fiber waits.
+  static void SetThreadPartyId(std::size_t party_id) noexcept;
+
+  static std::uint16_t GetThreadPartyId() noexcept;
+
+  /// \brief Attributes the fiber waits of the calling fiber to a gate while it exists.  Fibers
+  ///        can be resumed by other threads, which is why this is stored per fiber.
+  class FiberGateScope {
+   public:
+    explicit FiberGateScope(std::uint64_t gate_id);
+
+    ~FiberGateScope();
+
+    FiberGateScope(const FiberGateScope&) = delete;
+    FiberGateScope& operator=(const FiberGateScope&) = delete;
+
+   private:
+    std::uint64_t gate_id_;
+  };
+
+  void RecordGate(Category category, const std::type_info& gate_type, std::size_t gate_id,
+                  std::size_t party_id, TimePoint start, TimePoint end);
+
+  void RecordFiberWait(TimePoint start, TimePoint end);
+
+  void RecordMessage(Category category, const char* message_type, std::size_t party_id,
+                     std::size_t other_party_id, std::size_t number_of_bytes, TimePoint start,
+                     TimePoint end);
+
+  /// \brief Returns the recorded events of all threads ordered by their start.
+  std::vector<Event> GetEvents() const;
+
+  /// \brief Returns the events as JSON object in the Chrome trace event format, where each party
+  ///        is a process and each thread of this process is a thread of every party.
+  std::string ToChromeTraceJson() const;
+
+  /// \throws std::runtime_error if \p path cannot be written.
+  void WriteChromeTrace(const std::string& path) const;
+
+ private:
+  struct ThreadBuffer {
+    std::size_t thread_index;
+    std::vector<Event> events;
+    // number of events written so far, the last events.size() of which are in the buffer
+    std::atomic<std::size_t> number_of_events{0};
+  };
+
+  Tracer() = default;
+
+  void Record(const Event& event);
+
+  ThreadBuffer& GetThreadBuffer();
+
+  std::atomic<bool> enabled_{false};
+  std::size_t number_of_events_per_thread_{1 << 16};
+  // the buffers outlive their threads, s.t. the events can be exported after the evaluation
+  mutable std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,497 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "trusted_dealer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/transport.h"
+#include "primitives/pseudo_random_generator.h"
+#include "utility/helpers.h"
+
+namespace encrypto::motion {
+
+namespace {
+
+// expands a seed into a stream of pseudorandom bytes with AES in counter mode
+class SeedExpander {
+ public:
+  explicit SeedExpander(const Block128& seed) { prg_.SetKey(seed.data()); }
+
+  std::vector<std::byte> Next(std::size_t number_of_bytes) {
+    // Prg::Encrypt handles less than 2 GiB at once
+    constexpr std::size_t kChunkSize{std::size_t(1) << 26};
+    std::vector<std::byte> result;
+    result.reserve(number_of_bytes);
+    while (result.size() < number_of_bytes) {
+      const std::size_t size{std::min(kChunkSize, number_of_bytes - result.size())};
+      prg_.SetOffset(offset_);
+      auto chunk{prg_.Encrypt(size)};
+      result.insert(result.end(), chunk.begin(), chunk.begin() + size);
+      offset_ += (size + 15) / 16;
+    }
+    return result;
+  }
+
+  template <typename T>
+  std::vector<T> NextIntegers(std::size_t number_of_integers) {
+    std::vector<T> result(number_of_integers);
+    if (number_of_integers > 0) {
+      auto bytes{Next(number_of_integers * sizeof(T))};
+      std::memcpy(result.data(), bytes.data(), bytes.size());
+    }
+    return result;
+  }
+
+  template <typename BitVectorType = BitVector<>>
+  BitVectorType NextBits(std::size_t number_of_bits) {
+    if (number_of_bits == 0) return {};
+    return BitVectorType(Next(BitsToBytes(number_of_bits)).data(), number_of_bits);
+  }
+
+  Block128Vector NextBlocks(std::size_t number_of_blocks) {
+    if (number_of_blocks == 0) return {};
+    return Block128Vector(number_of_blocks, Next(number_of_blocks * Block128::kBlockSize).data());
+  }
+
+ private:
+  primitives::Prg prg_;
+  std::size_t offset_{0};
+};
+
+// reads the correction words of a response
+class ResponseParser {
+ public:
+  explicit ResponseParser(std::span<const std::uint8_t> data) : data_(data) {}
+
+  std::span<const std::uint8_t> Next(std::size_t number_of_bytes) {
+    if (number_of_bytes > data_.size() - position_) {
+      throw std::runtime_error("Received a truncated response from the trusted dealer");
+    }
+    auto result{data_.subspan(position_, number_of_bytes)};
+    position_ += number_of_bytes;
+    return result;
+  }
+
+  template <typename T>
+  void ReadIntegers(std::vector<T>& output) {
+    if (output.empty()) return;
+    auto bytes{Next(output.size() * sizeof(T))};
+    std::memcpy(output.data(), bytes.data(), bytes.size());
+  }
+
+  void ReadBits(BitVector<>& output) {
+    if (output.GetSize() == 0) return;
+    output = BitVector<>(Next(BitsToBytes(output.GetSize())).data(), output.GetSize());
+  }
+
+  Block128Vector ReadBlocks(std::size_t number_of_blocks) {
+    if (number_of_blocks == 0) return {};
+    return Block128Vector(number_of_blocks, Next(number_of_blocks * Block128::kBlockSize).data());
+  }
+
+  bool AtEnd() const { return position_ == data_.size(); }
+
+ private:
+  std::span<const std::uint8_t> data_;
+  std::size_t position_{0};
+};
+
+template <typename T>
+void Append(std::vector<std::uint8_t>& buffer, std::span<const T> data) {
+  auto bytes{std::as_bytes(data)};
+  auto pointer{reinterpret_cast<const std::uint8_t*>(bytes.data())};
+  buffer.insert(buffer.end(), pointer, pointer + bytes.size());
+}
+
+// corrects party 0's shares of c such that c = a * b
+template <typename T>
+void CorrectMts(std::vector<DealerCorrelations>& correlations,
+                IntegerMtVector<T> DealerCorrelations::*mts) {
+  auto& first{correlations[0].*mts};
+  for (std::size_t j = 0; j < first.a.size(); ++j) {
+    T a{0}, b{0}, c{0};
+    for (std::size_t i = 0; i < correlations.size(); ++i) {
+      a += (correlations[i].*mts).a[j];
+      b += (correlations[i].*mts).b[j];
+      if (i > 0) c += (correlations[i].*mts).c[j];
+    }
+    first.c[j] = T(a * b - c);
+  }
+}
+
+// corrects party 0's shares of c such that c = a^2
+template <typename T>
+void CorrectSps(std::vector<DealerCorrelations>& correlations,
+                SpVector<T> DealerCorrelations::*sps) {
+  auto& first{correlations[0].*sps};
+  for (std::size_t j = 0; j < first.a.size(); ++j) {
+    T a{0}, c{0};
+    for (std::size_t i = 0; i < correlations.size(); ++i) {
+      a += (correlations[i].*sps).a[j];
+      if (i > 0) c += (correlations[i].*sps).c[j];
+    }
+    first.c[j] = T(a * a - c);
+  }
+}
+
+// corrects party 0's shares such that the SBs are sharings of random bits
+template <typename T>
+void CorrectSbs(std::vector<DealerCorrelations>& correlations,
+                std::vector<T> DealerCorrelations::*sbs) {
+  auto& first{correlations[0].*sbs};
+  if (first.empty()) return;
+  auto bits{BitVector<>::SecureRandom(first.size())};
+  for (std::size_t j = 0; j < first.size(); ++j) {
+    T share{T(bits.Get(j))};
+    for (std::size_t i = 1; i < correlations.size(); ++i) share -= (correlations[i].*sbs)[j];
+    first[j] = share;
+  }
+}
+
+// corrects party 0's shares of the MTs, SPs and SBs given the shares of all parties
+void CorrectFirstShares(std::vector<DealerCorrelations>& correlations) {
+  {
+    auto& first{correlations[0]};
+    auto a{first.bit_mts.a}, b{first.bit_mts.b}, c{BitVector<>(first.bit_mts.c.GetSize())};
+    for (std::size_t i = 1; i < correlations.size(); ++i) {
+      a ^= correlations[i].bit_mts.a;
+      b ^= correlations[i].bit_mts.b;
+      c ^= correlations[i].bit_mts.c;
+    }
+    first.bit_mts.c = (a & b) ^ c;
+  }
+  CorrectMts(correlations, &DealerCorrelations::mts_8);
+  CorrectMts(correlations, &DealerCorrelations::mts_16);
+  CorrectMts(correlations, &DealerCorrelations::mts_32);
+  CorrectMts(correlations, &DealerCorrelations::mts_64);
+  CorrectSps(correlations, &DealerCorrelations::sps_8);
+  CorrectSps(correlations, &DealerCorrelations::sps_16);
+  CorrectSps(correlations, &DealerCorrelations::sps_32);
+  CorrectSps(correlations, &DealerCorrelations::sps_64);
+  CorrectSps(correlations, &DealerCorrelations::sps_128);
+  CorrectSbs(correlations, &DealerCorrelations::sbs_8);
+  CorrectSbs(correlations, &DealerCorrelations::sbs_16);
+  CorrectSbs(correlations, &DealerCorrelations::sbs_32);
+  CorrectSbs(correlations, &DealerCorrelations::sbs_64);
+}
+
+// the index-th seed derived from the shared seed of MakeInsecureFakeCorrelations
+Block128 DeriveSeed(const Block128& seed, std::size_t index) {
+  primitives::Prg prg;
+  prg.SetKey(seed.data());
+  prg.SetOffset(index);
+  return Block128::MakeFromMemory(prg.Encrypt(Block128::kBlockSize).data());
+}
+
+void CheckRequests(const std::vector<DealerRequest>& requests) {
+  const std::size_t number_of_parties{requests.size()};
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    const auto& request{requests[i]};
+    if (request.my_id != i || request.number_of_parties != number_of_parties) {
+      throw std::runtime_error(
+          fmt::format("Party#{} sent a request as Party#{} of {} parties to the trusted dealer", i,
+                      request.my_id, request.number_of_parties));
+    }
+    if (request.number_of_mts != requests[0].number_of_mts ||
+        request.number_of_sps != requests[0].number_of_sps ||
+        request.number_of_sbs != requests[0].number_of_sbs) {
+      throw std::runtime_error(fmt::format(
+          "Party#{} and Party#0 requested different numbers of MTs, SPs or SBs", i));
+    }
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      if (request.number_of_ots_sender[j] != requests[j].number_of_ots_receiver[i]) {
+        throw std::runtime_error(fmt::format(
+            "Party#{} requested {} OTs as sender but Party#{} requested {} OTs as receiver", i,
+            request.number_of_ots_sender[j], j, requests[j].number_of_ots_receiver[i]));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<std::uint8_t> DealerRequest::Serialize() const {
+  std::vector<std::uint64_t> values{my_id, number_of_parties};
+  values.insert(values.end(), number_of_mts.begin(), number_of_mts.end());
+  values.insert(values.end(), number_of_sps.begin(), number_of_sps.end());
+  values.insert(values.end(), number_of_sbs.begin(), number_of_sbs.end());
+  values.insert(values.end(), number_of_ots_sender.begin(), number_of_ots_sender.end());
+  values.insert(values.end(), number_of_ots_receiver.begin(), number_of_ots_receiver.end());
+  std::vector<std::uint8_t> message;
+  Append(message, std::span<const std::uint64_t>(values));
+  return message;
+}
+
+DealerRequest DealerRequest::Deserialize(std::span<const std::uint8_t> message) {
+  constexpr std::size_t kNumberOfFixedValues{2 + 5 + 5 + 4};
+  if (message.size() % sizeof(std::uint64_t) != 0 ||
+      message.size() < kNumberOfFixedValues * sizeof(std::uint64_t)) {
+    throw std::runtime_error("Received a malformed request for the trusted dealer");
+  }
+  std::vector<std::uint64_t> values(message.size() / sizeof(std::uint64_t));
+  std::memcpy(values.data(), message.data(), message.size());
+  DealerRequest request;
+  request.my_id = values[0];
+  request.number_of_parties = values[1];
+  if (values.size() != kNumberOfFixedValues + 2 * request.number_of_parties) {
+    throw std::runtime_error("Received a malformed request for the trusted dealer");
+  }
+  auto iterator{values.begin() + 2};
+  std::copy_n(iterator, 5, request.number_of_mts.begin());
+  std::copy_n(iterator + 5, 5, request.number_of_sps.begin());
+  std::copy_n(iterator + 10, 4, request.number_of_sbs.begin());
+  iterator += 14;
+  request.number_of_ots_sender.assign(iterator, iterator + request.number_of_parties);
+  iterator += request.number_of_parties;
+  request.number_of_ots_receiver.assign(iterator, iterator + request.number_of_parties);
+  return request;
+}
+
+DealerCorrelations ExpandDealerSeed(const DealerRequest& request, const Block128& seed) {
+  SeedExpander expander(seed);
+  DealerCorrelations result;
+  auto expand_mts = [&expander](auto& mts, std::size_t number_of_mts) {
+    using T = typename std::remove_reference_t<decltype(mts.a)>::value_type;
+    mts.a = expander.NextIntegers<T>(number_of_mts);
+    mts.b = expander.NextIntegers<T>(number_of_mts);
+    mts.c = expander.NextIntegers<T>(number_of_mts);
+  };
+  auto expand_sps = [&expander](auto& sps, std::size_t number_of_sps) {
+    using T = typename std::remove_reference_t<decltype(sps.a)>::value_type;
+    sps.a = expander.NextIntegers<T>(number_of_sps);
+    sps.c = expander.NextIntegers<T>(number_of_sps);
+  };
+
+  result.bit_mts.a = expander.NextBits(request.number_of_mts[0]);
+  result.bit_mts.b = expander.NextBits(request.number_of_mts[0]);
+  result.bit_mts.c = expander.NextBits(request.number_of_mts[0]);
+  expand_mts(result.mts_8, request.number_of_mts[1]);
+  expand_mts(result.mts_16, request.number_of_mts[2]);
+  expand_mts(result.mts_32, request.number_of_mts[3]);
+  expand_mts(result.mts_64, request.number_of_mts[4]);
+  expand_sps(result.sps_8, request.number_of_sps[0]);
+  expand_sps(result.sps_16, request.number_of_sps[1]);
+  expand_sps(result.sps_32, request.number_of_sps[2]);
+  expand_sps(result.sps_64, request.number_of_sps[3]);
+  expand_sps(result.sps_128, request.number_of_sps[4]);
+  result.sbs_8 = expander.NextIntegers<std::uint8_t>(request.number_of_sbs[0]);
+  result.sbs_16 = expander.NextIntegers<std::uint16_t>(request.number_of_sbs[1]);
+  result.sbs_32 = expander.NextIntegers<std::uint32_t>(request.number_of_sbs[2]);
+  result.sbs_64 = expander.NextIntegers<std::uint64_t>(request.number_of_sbs[3]);
+
+  result.ots.resize(request.number_of_parties);
+  for (std::size_t j = 0; j < request.number_of_parties; ++j) {
+    if (j == request.my_id) continue;
+    auto& ots{result.ots[j]};
+    if (request.number_of_ots_sender[j] > 0) {
+      ots.delta = expander.NextBlocks(1)[0];
+      ots.sender_ots = expander.NextBlocks(request.number_of_ots_sender[j]);
+    }
+    if (request.number_of_ots_receiver[j] > 0) {
+      ots.choices = expander.NextBits<AlignedBitVector>(request.number_of_ots_receiver[j]);
+    }
+  }
+  return result;
+}
+
+DealerCorrelations MakeInsecureFakeCorrelations(const DealerRequest& request,
+                                                const Block128& seed) {
+  const std::size_t number_of_parties{request.number_of_parties};
+  // the MTs, SPs and SBs are expanded from seeds 0, ..., n - 1 as if the dealer had sent them
+  DealerRequest shares_request{request};
+  std::fill(shares_request.number_of_ots_sender.begin(), shares_request.number_of_ots_sender.end(),
+            0);
+  std::fill(shares_request.number_of_ots_receiver.begin(),
+            shares_request.number_of_ots_receiver.end(), 0);
+  DealerCorrelations result;
+  if (request.my_id == 0) {
+    std::vector<DealerCorrelations> correlations;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      shares_request.my_id = i;
+      correlations.emplace_back(ExpandDealerSeed(shares_request, DeriveSeed(seed, i)));
+    }
+    CorrectFirstShares(correlations);
+    result = std::move(correlations[0]);
+  } else {
+    result = ExpandDealerSeed(shares_request, DeriveSeed(seed, request.my_id));
+  }
+
+  // the OTs from sender i to receiver j are expanded from seed n + i * n + j, which yields delta
+  // and q for both parties followed by the choices of the receiver
+  auto ot_seed = [&seed, number_of_parties](std::size_t sender_id, std::size_t receiver_id) {
+    return DeriveSeed(seed, number_of_parties * (1 + sender_id) + receiver_id);
+  };
+  for (std::size_t j = 0; j < number_of_parties; ++j) {
+    if (j == request.my_id) continue;
+    auto& ots{result.ots[j]};
+    if (const auto number_of_ots{request.number_of_ots_sender[j]}; number_of_ots > 0) {
+      SeedExpander expander(ot_seed(request.my_id, j));
+      ots.delta = expander.NextBlocks(1)[0];
+      ots.sender_ots = expander.NextBlocks(number_of_ots);
+    }
+    if (const auto number_of_ots{request.number_of_ots_receiver[j]}; number_of_ots > 0) {
+      SeedExpander expander(ot_seed(j, request.my_id));
+      const auto delta{expander.NextBlocks(1)[0]};
+      ots.receiver_ots = expander.NextBlocks(number_of_ots);
+      ots.choices = expander.NextBits<AlignedBitVector>(number_of_ots);
+      // t = q ^ r * delta
+      ots.receiver_ots.ConditionalXor(ots.choices.GetData().data(), delta);
+    }
+  }
+  return result;
+}
+
+TrustedDealer::TrustedDealer(std::vector<std::unique_ptr<communication::Transport>> transports)
+    : transports_(std::move(transports)) {
+  if (transports_.size() < 2) {
+    throw std::invalid_argument("The trusted dealer needs at least two parties");
+  }
+}
+
+TrustedDealer::~TrustedDealer() = default;
+
+bool TrustedDealer::ServeRequests() {
+  const std::size_t number_of_parties{transports_.size()};
+  std::vector<std::optional<std::vector<std::uint8_t>>> messages;
+  for (auto& transport : transports_) messages.emplace_back(transport->ReceiveMessage());
+  // an empty response rejects the request
+  auto reject = [this, &messages] {
+    for (std::size_t i = 0; i < transports_.size(); ++i) {
+      if (messages[i]) transports_[i]->SendMessage({});
+    }
+  };
+  if (std::any_of(messages.begin(), messages.end(), [](auto& m) { return !m.has_value(); })) {
+    reject();
+    return false;
+  }
+
+  std::vector<DealerRequest> requests;
+  try {
+    for (auto& message : messages) requests.emplace_back(DealerRequest::Deserialize(*message));
+    CheckRequests(requests);
+  } catch (std::runtime_error&) {
+    reject();
+    throw;
+  }
+
+  std::vector<Block128> seeds;
+  std::vector<DealerCorrelations> correlations;
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    seeds.emplace_back(Block128::MakeRandom());
+    correlations.emplace_back(ExpandDealerSeed(requests[i], seeds[i]));
+  }
+
+  // party 0 gets the correction words for the MTs, SPs and SBs
+  CorrectFirstShares(correlations);
+
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    std::vector<std::uint8_t> response;
+    Append(response, std::span<const Block128>(&seeds[i], 1));
+    if (i == 0) {
+      const auto& first{correlations[0]};
+      const auto& bit_mts_c{first.bit_mts.c.GetData()};
+      Append(response, std::span(bit_mts_c.data(), bit_mts_c.size()));
+      Append(response, std::span(first.mts_8.c));
+      Append(response, std::span(first.mts_16.c));
+      Append(response, std::span(first.mts_32.c));
+      Append(response, std::span(first.mts_64.c));
+      Append(response, std::span(first.sps_8.c));
+      Append(response, std::span(first.sps_16.c));
+      Append(response, std::span(first.sps_32.c));
+      Append(response, std::span(first.sps_64.c));
+      Append(response, std::span(first.sps_128.c));
+      Append(response, std::span(first.sbs_8));
+      Append(response, std::span(first.sbs_16));
+      Append(response, std::span(first.sbs_32));
+      Append(response, std::span(first.sbs_64));
+    }
+    // t = q ^ r * delta for the OTs in which party i is the receiver
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      if (j == i || requests[i].number_of_ots_receiver[j] == 0) continue;
+      const auto& sender{correlations[j].ots[i]};
+      const auto& choices{correlations[i].ots[j].choices};
+      Block128Vector receiver_ots(sender.sender_ots);
+      for (std::size_t k = 0; k < receiver_ots.size(); ++k) {
+        if (choices.Get(k)) receiver_ots[k] ^= sender.delta;
+      }
+      Append(response, std::span<const Block128>(receiver_ots.data(), receiver_ots.size()));
+    }
+    transports_[i]->SendMessage(response);
+  }
+  return true;
+}
+
+void TrustedDealer::Run() {
+  while (ServeRequests()) {
+  }
+}
+
+TrustedDealerClient::TrustedDealerClient(std::unique_ptr<communication::Transport> transport)
+    : transport_(std::move(transport)) {}
+
+TrustedDealerClient::~TrustedDealerClient() { transport_->ShutdownSend(); }
+
+DealerCorrelations TrustedDealerClient::Request(const DealerRequest& request) {
+  transport_->SendMessage(request.Serialize());
+  auto response{transport_->ReceiveMessage()};
+  if (!response) {
+    throw std::runtime_error("The trusted dealer closed the connection");
+  }
+  if (response->empty()) {
+    throw std::runtime_error("The trusted dealer rejected the request");
+  }
+  ResponseParser parser(*response);
+  auto result{ExpandDealerSeed(request,
+                               Block128::MakeFromMemory(reinterpret_cast<const std::byte*>(
+                                   parser.Next(Block128::kBlockSize).data())))};
+  if (request.my_id == 0) {
+    parser.ReadBits(result.bit_mts.c);
+    parser.ReadIntegers(result.mts_8.c);
+    parser.ReadIntegers(result.mts_16.c);
+    parser.ReadIntegers(result.mts_32.c);
+    parser.ReadIntegers(result.mts_64.c);
+    parser.ReadIntegers(result.sps_8.c);
+    parser.ReadIntegers(result.sps_16.c);
+    parser.ReadIntegers(result.sps_32.c);
+    parser.ReadIntegers(result.sps_64.c);
+    parser.ReadIntegers(result.sps_128.c);
+    parser.ReadIntegers(result.sbs_8);
+    parser.ReadIntegers(result.sbs_16);
+    parser.ReadIntegers(result.sbs_32);
+    parser.ReadIntegers(result.sbs_64);
+  }
+  for (std::size_t j = 0; j < request.number_of_parties; ++j) {
+    if (j == request.my_id) continue;
+    result.ots[j].receiver_ots = parser.ReadBlocks(request.number_of_ots_receiver[j]);
+  }
+  if (!parser.AtEnd()) {
+    throw std::runtime_error("Received a response of unexpected size from the trusted dealer");
+  }
+  return result;
+}
+
+}  // namespace encrypto::motion
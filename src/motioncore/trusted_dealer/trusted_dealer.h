@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "utility/bit_vector.h"
+#include "utility/block.h"
+
+namespace encrypto::motion {
+
+namespace communication {
+
+class Transport;
+
+}  // namespace communication
+
+// A trusted dealer is an auxiliary, semi-trusted node that generates the MTs, SPs, SBs and
+// correlated OTs for all parties, so that the parties do not need to run the OT extension.  In
+// each round, every party sends a DealerRequest with the numbers of correlations it needs.  The
+// dealer answers each party with a random seed, from which the party expands all of its shares,
+// plus the correction words that cannot be derived from a seed:
+//   - party 0 receives its shares of c for the MTs and SPs and its shares of the SBs,
+//   - the receiver of each correlated OT receives t = q ^ r * delta, where the sender expands
+//     delta and q and the receiver expands the choice r from their seeds.
+// Only semi-honest security is provided, and the dealer must not collude with any party.  The
+// 1-out-of-N OTs of boolean_gmw::LookupTableGate are not served, since one-time truth tables
+// depend on the table of each gate, which the requests, consisting only of numbers, do not carry.
+
+/// \brief Numbers of correlations that a party requests from the trusted dealer.
+struct DealerRequest {
+  std::size_t my_id{0};
+  std::size_t number_of_parties{0};
+  // binary, 8, 16, 32 and 64 bit MTs
+  std::array<std::size_t, 5> number_of_mts{};
+  // 8, 16, 32, 64 and 128 bit SPs
+  std::array<std::size_t, 5> number_of_sps{};
+  // 8, 16, 32 and 64 bit SBs
+  std::array<std::size_t, 4> number_of_sbs{};
+  // number of correlated OTs with each party in which this party is the sender or the receiver
+  std::vector<std::size_t> number_of_ots_sender;
+  std::vector<std::size_t> number_of_ots_receiver;
+
+  std::vector<std::uint8_t> Serialize() const;
+
+  /// \throws std::runtime_error if the message is malformed
+  static DealerRequest Deserialize(std::span<const std::uint8_t> message);
+};
+
+/// \brief Correlated OTs with one other party, where sender_ots[i] = receiver_ots[i] ^
+/// choices[i] * delta holds for the OTs of the sender and the receiver.
+struct DealerOtCorrelations {
+  Block128 delta;
+  Block128Vector sender_ots;
+  AlignedBitVector choices;
+  Block128Vector receiver_ots;
+};
+
+/// \brief The shares of a party, see DealerRequest for the layout of the arrays.
+struct DealerCorrelations {
+  BinaryMtVector bit_mts;
+  IntegerMtVector<std::uint8_t> mts_8;
+  IntegerMtVector<std::uint16_t> mts_16;
+  IntegerMtVector<std::uint32_t> mts_32;
+  IntegerMtVector<std::uint64_t> mts_64;
+  SpVector<std::uint8_t> sps_8;
+  SpVector<std::uint16_t> sps_16;
+  SpVector<std::uint32_t> sps_32;
+  SpVector<std::uint64_t> sps_64;
+  SpVector<__uint128_t> sps_128;
+  std::vector<std::uint8_t> sbs_8;
+  std::vector<std::uint16_t> sbs_16;
+  std::vector<std::uint32_t> sbs_32;
+  std::vector<std::uint64_t> sbs_64;
+  // indexed by the other party's id, the entry of this party is empty
+  std::vector<DealerOtCorrelations> ots;
+};
+
+/// \brief Expands the part of the requested correlations that is derived from \p seed.
+DealerCorrelations ExpandDealerSeed(const DealerRequest& request, const Block128& seed);
+
+/// \brief INSECURE, for benchmarking the online phase only: generates the correlations of a party
+/// locally without the trusted dealer, where all parties derive the seeds of all parties from the
+/// shared \p seed, s.t. every party can compute the shares of the others.  The parties need to pass
+/// the same seed and requests that the trusted dealer would accept.  Party#0 expands the shares
+/// of all parties to compute its corrections of the MTs, SPs and SBs.
+DealerCorrelations MakeInsecureFakeCorrelations(const DealerRequest& request, const Block128& seed);
+
+/// \brief Serves the requests of the parties, where transports[i] is connected to Party#i.
+class TrustedDealer {
+ public:
+  explicit TrustedDealer(std::vector<std::unique_ptr<communication::Transport>> transports);
+  ~TrustedDealer();
+
+  /// \brief Answers one request of each party.
+  /// \returns false if the parties closed their connections instead of sending requests
+  /// \throws std::runtime_error if the requests of the parties do not match, in which case the
+  /// parties are notified
+  bool ServeRequests();
+
+  /// \brief Serves requests until the parties close their connections.
+  void Run();
+
+ private:
+  std::vector<std::unique_ptr<communication::Transport>> transports_;
+};
+
+/// \brief Requests the correlations of a party from the trusted dealer.
+class TrustedDealerClient {
+ public:
+  explicit TrustedDealerClient(std::unique_ptr<communication::Transport> transport);
+
+  /// \brief Closes the connection, so that the dealer stops serving it.
+  ~TrustedDealerClient();
+
+  /// \brief Sends \p request to the dealer and waits for the correlations.
+  /// \throws std::runtime_error if the dealer rejected the request or closed the connection
+  DealerCorrelations Request(const DealerRequest& request);
+
+ private:
+  std::unique_ptr<communication::Transport> transport_;
+};
+
+}  // namespace encrypto::motion
@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "arena.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace encrypto::motion {
+
+Arena::Arena(std::size_t chunk_size) : chunk_size_(chunk_size) {
+  if (chunk_size_ == 0) {
+    throw std::invalid_argument("The chunk size of an arena must be positive");
+  }
+}
+
+void* Arena::Allocate(std::size_t size, std::size_t alignment) {
+  allocated_bytes_ += size;
+  ++number_of_allocations_;
+  // large objects get a chunk of their own, s.t. the current chunk is not wasted
+  if (size + alignment > chunk_size_ / 4) {
+    void* pointer{AllocateChunk(size + alignment)};
+    std::size_t space{size + alignment};
+    return std::align(alignment, size, pointer, space);
+  }
+  void* pointer{current_};
+  if (current_ == nullptr || std::align(alignment, size, pointer, remaining_) == nullptr) {
+    current_ = static_cast<std::byte*>(AllocateChunk(chunk_size_));
+    remaining_ = chunk_size_;
+    pointer = current_;
+    std::align(alignment, size, pointer, remaining_);
+  }
+  current_ = static_cast<std::byte*>(pointer) + size;
+  remaining_ -= size;
+  return pointer;
+}
+
+void Arena::Reserve(std::size_t size) {
+  if (current_ != nullptr && remaining_ >= size) return;
+  const auto chunk_size{std::max(size, chunk_size_)};
+  current_ = static_cast<std::byte*>(AllocateChunk(chunk_size));
+  remaining_ = chunk_size;
+}
+
+void* Arena::AllocateChunk(std::size_t size) {
+  chunks_.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size));
+  reserved_bytes_ += size;
+  return chunks_.back().get();
+}
+
+void Arena::Release() {
+  if (HasLiveObjects()) {
+    throw std::logic_error("Objects allocated from the arena are still alive");
+  }
+  chunks_.clear();
+  current_ = nullptr;
+  remaining_ = 0;
+  allocated_bytes_ = 0;
+  reserved_bytes_ = 0;
+  number_of_allocations_ = 0;
+  number_of_deallocations_ = 0;
+}
+
+}  // namespace encrypto::motion
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace encrypto::motion {
+
+/// \brief Bump allocator handing out memory from large chunks, which are all freed at once by
+///        Release or when the arena is destroyed.
+///
+/// Used for the gates, wires and shares of a Register, see Register::EmplaceShared.  Allocating
+/// them next to each other avoids the fragmentation and the per-object overhead of the general
+/// purpose allocator.  Allocate and Reserve are not synchronized, since only the thread building
+/// the circuit creates objects.  Objects may be destroyed by any thread.
+class Arena {
+ public:
+  static constexpr std::size_t kDefaultChunkSize{1 << 20};
+
+  explicit Arena(std::size_t chunk_size = kDefaultChunkSize);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /// \brief Returns \p size bytes aligned to \p alignment, which stay valid until the arena is
+  ///        released.
+  void* Allocate(std::size_t size, std::size_t alignment);
+
+  /// \brief Marks an allocation as no longer used, see HasLiveObjects.  Thread-safe.
+  void Deallocate() noexcept { number_of_deallocations_.fetch_add(1, std::memory_order_release); }
+
+  /// \brief Continues in a new chunk of at least \p size bytes unless the current chunk has
+  ///        \p size bytes left, s.t. the next allocations of up to \p size bytes in total are
+  ///        adjacent, e.g., the gates and wires of a circuit layer.  The rest of the new chunk is
+  ///        used by later allocations, but the rest of the current chunk is left unused, so
+  ///        reserving more than needed wastes memory whenever it starts a new chunk.
+  void Reserve(std::size_t size);
+
+  /// \brief Whether some allocation was not deallocated yet.
+  bool HasLiveObjects() const noexcept {
+    return number_of_deallocations_.load(std::memory_order_acquire) != number_of_allocations_;
+  }
+
+  /// \brief Frees all chunks, s.t. the arena starts over.
+  /// \throws std::logic_error if objects allocated from the arena are still alive
+  void Release();
+
+  /// \brief Number of bytes handed out by Allocate since the last Release.
+  std::size_t GetNumberOfAllocatedBytes() const noexcept { return allocated_bytes_; }
+
+  /// \brief Number of bytes reserved from the system since the last Release.
+  std::size_t GetNumberOfReservedBytes() const noexcept { return reserved_bytes_; }
+
+ private:
+  void* AllocateChunk(std::size_t size);
+
+  const std::size_t chunk_size_;
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  std::byte* current_{nullptr};
+  std::size_t remaining_{0};
+  std::size_t allocated_bytes_{0};
+  std::size_t reserved_bytes_{0};
+  std::size_t number_of_allocations_{0};
+  // objects may be destroyed by other threads than the one allocating them
+  std::atomic<std::size_t> number_of_deallocations_{0};
+};
+
+/// \brief Allocator for std::allocate_shared that places the object and its control block in an
+///        Arena.  The allocator does not own the arena, so the owner of the arena must not
+///        release it while objects are alive, see Arena::HasLiveObjects.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  // the memory is freed together with the arena
+  void deallocate(T*, std::size_t) noexcept { arena_->Deallocate(); }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ == other.arena_;
+  }
+
+ private:
+  template <typename U>
+  friend class ArenaAllocator;
+
+  Arena* arena_;
+};
+
+}  // namespace encrypto::motion
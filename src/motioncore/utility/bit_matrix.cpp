@@ -24,16 +24,117 @@
 
 #include "bit_matrix.h"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
 #include <immintrin.h>
+#endif
 #include <omp.h>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
+#include "block.h"
 #include "helpers.h"
 #include "primitives/pseudo_random_generator.h"
 
 namespace encrypto::motion {
 
+namespace {
+
+#if defined(__ARM_NEON)
+// gathers the bytes holding column c of the rows [r, r + 16)
+template <typename Input>
+inline uint8x16_t Gather16Rows(const Input& input, std::size_t r, std::size_t c) {
+  std::array<std::uint8_t, 16> bytes;
+  for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = input(r + i, c);
+  return vld1q_u8(bytes.data());
+}
+
+// the most significant bits of the bytes of vec as by _mm_movemask_epi8
+inline std::uint16_t MoveMask(uint8x16_t vec) {
+  const uint8x16_t kWeights{1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  // spread the most significant bit of each byte over the byte and keep the bit of its position
+  const uint8x16_t bits{
+      vandq_u8(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(vec), 7)), kWeights)};
+  return static_cast<std::uint16_t>(vaddv_u8(vget_low_u8(bits)) |
+                                    (vaddv_u8(vget_high_u8(bits)) << 8));
+}
+#elif defined(__SSE2__)
+// gathers the bytes holding column c of the rows [r, r + 16)
+template <typename Input>
+inline __m128i Gather16Rows(const Input& input, std::size_t r, std::size_t c) {
+  return _mm_set_epi8(input(r + 15, c), input(r + 14, c), input(r + 13, c), input(r + 12, c),
+                      input(r + 11, c), input(r + 10, c), input(r + 9, c), input(r + 8, c),
+                      input(r + 7, c), input(r + 6, c), input(r + 5, c), input(r + 4, c),
+                      input(r + 3, c), input(r + 2, c), input(r + 1, c), input(r + 0, c));
+}
+#endif
+
+// Transposes the bits of the rows [0, kNumberOfRows) in the columns [column_begin, column_end),
+// where input(r, c) returns the byte of row r that holds column c and output(c) the row of the
+// transposed matrix for column c.  Each step gathers one byte of several rows into a vector
+// register and extracts the 8 transposed bit strings with movemask, so wider registers need
+// proportionally fewer steps.  The register width is chosen by MOTION_USE_AVX at build time, NEON
+// is used on ARM, and targets without SSE2 or NEON gather the bits one by one.
+template <std::size_t kNumberOfRows, typename Input, typename Output>
+inline void TransposeColumns(const Input& input, const Output& output, std::size_t column_begin,
+                             std::size_t column_end) {
+#if defined(MOTION_AVX512)
+  constexpr std::size_t kRowsPerStep{64};
+#elif defined(MOTION_AVX2)
+  constexpr std::size_t kRowsPerStep{32};
+#else
+  constexpr std::size_t kRowsPerStep{16};
+#endif
+  static_assert(kNumberOfRows % kRowsPerStep == 0);
+  for (std::size_t r = 0; r < kNumberOfRows; r += kRowsPerStep) {
+    for (std::size_t c = column_begin; c < column_end; c += 8) {
+#if defined(MOTION_AVX512)
+      const __m256i low{
+          _mm256_set_m128i(Gather16Rows(input, r + 16, c), Gather16Rows(input, r, c))};
+      const __m256i high{
+          _mm256_set_m128i(Gather16Rows(input, r + 48, c), Gather16Rows(input, r + 32, c))};
+      __m512i vec{_mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1)};
+      for (std::size_t i = 0; i < 8; vec = _mm512_slli_epi64(vec, 1), ++i) {
+        const std::uint64_t mask{_mm512_movepi8_mask(vec)};
+        std::memcpy(output(c + 7 - i) + r / 8, &mask, sizeof(mask));
+      }
+#elif defined(MOTION_AVX2)
+      __m256i vec{_mm256_set_m128i(Gather16Rows(input, r + 16, c), Gather16Rows(input, r, c))};
+      for (std::size_t i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
+        const std::uint32_t mask = _mm256_movemask_epi8(vec);
+        std::memcpy(output(c + 7 - i) + r / 8, &mask, sizeof(mask));
+      }
+#elif defined(__ARM_NEON)
+      uint8x16_t vec{Gather16Rows(input, r, c)};
+      for (std::size_t i = 0; i < 8; vec = vshlq_n_u8(vec, 1), ++i) {
+        const std::uint16_t mask{MoveMask(vec)};
+        std::memcpy(output(c + 7 - i) + r / 8, &mask, sizeof(mask));
+      }
+#elif defined(__SSE2__)
+      __m128i vec{Gather16Rows(input, r, c)};
+      for (std::size_t i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
+        const std::uint16_t mask = _mm_movemask_epi8(vec);
+        std::memcpy(output(c + 7 - i) + r / 8, &mask, sizeof(mask));
+      }
+#else
+      for (std::size_t i = 0; i < 8; ++i) {
+        // bit j of the mask is bit 7 - i of the byte of row r + j, as gathered by movemask
+        std::uint16_t mask{0};
+        for (std::size_t j = 0; j < kRowsPerStep; ++j) {
+          mask |= ((static_cast<std::uint8_t>(input(r + j, c)) >> (7 - i)) & 1u) << j;
+        }
+        std::memcpy(output(c + 7 - i) + r / 8, &mask, sizeof(mask));
+      }
+#endif
+    }
+  }
+}
+
+}  // namespace
+
 void BitMatrix::Transpose() {
   std::size_t number_of_rows = data_.size();
   if (number_of_rows == 0 || number_of_columns_ == 0 ||
@@ -475,29 +576,14 @@ void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
   };
 
   constexpr std::uint64_t kNumberOfRows = 128;
-  std::vector<std::uint8_t, boost::alignment::aligned_allocator<std::uint8_t, 16>> output(
+  std::vector<std::uint8_t, PooledAlignedAllocator<std::uint8_t, 16>> output(
       ((kNumberOfRows * number_of_colums) + 7) / 8, 0);
 
-  auto out = [&output](auto r, auto c) { return &output[(r)*kNumberOfRows / 8 + (c) / 8]; };
-
-  uint64_t rr, cc;
-  int i;
+  auto out = [&output](std::size_t c) { return &output[c * kNumberOfRows / 8]; };
 
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  // Do the main body in 16x8 blocks:
-  for (rr = 0; rr <= kNumberOfRows - 16; rr += 16) {
-    for (cc = 0; cc < number_of_colums; cc += 8) {
-      vec = _mm_set_epi8(inp(rr + 15, cc), inp(rr + 14, cc), inp(rr + 13, cc), inp(rr + 12, cc),
-                         inp(rr + 11, cc), inp(rr + 10, cc), inp(rr + 9, cc), inp(rr + 8, cc),
-                         inp(rr + 7, cc), inp(rr + 6, cc), inp(rr + 5, cc), inp(rr + 4, cc),
-                         inp(rr + 3, cc), inp(rr + 2, cc), inp(rr + 1, cc), inp(rr + 0, cc));
-      for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        *(uint16_t* __restrict__)out(cc + 7 - i, rr) = _mm_movemask_epi8(vec);
-      }
-    }
-  }
+  TransposeColumns<kNumberOfRows>(inp, out, 0, number_of_colums);
 
   for (auto j = 0ull; j < number_of_colums; ++j) {
     std::copy(reinterpret_cast<const std::uint8_t* __restrict__>(output.data()) + j * 16,
@@ -514,7 +600,9 @@ void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
 void BitMatrix::SenderTranspose128AndEncrypt(
     const std::array<const std::byte*, 128>& matrix, std::vector<BitVector<>>& y0,
     std::vector<BitVector<>>& y1, const BitVector<> choices, primitives::Prg& prg_fixed_key,
-    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths) {
+    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths,
+    std::size_t number_of_threads, const BitVector<>* packed, BitVector<>* y0_bits,
+    BitVector<>* y1_bits) {
   constexpr std::size_t kKappa{128}, kNumberOfRows{128};
   auto inp = [&matrix](auto r, auto c) {
     return reinterpret_cast<const std::uint8_t* __restrict__>(
@@ -527,68 +615,76 @@ void BitMatrix::SenderTranspose128AndEncrypt(
     y0.resize(number_of_colums);
     y1.resize(number_of_colums);
   }
-
-  for (auto& block_vector : y0)
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
+  if (packed) {
+    assert(y0_bits && y1_bits && packed->GetSize() >= original_size);
+    if (y0_bits->GetSize() < number_of_colums) y0_bits->Resize(number_of_colums, true);
+    if (y1_bits->GetSize() < number_of_colums) y1_bits->Resize(number_of_colums, true);
+  }
 
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 128x128 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
+  const auto choices_block{Block128::MakeFromMemory(choices.GetData().data())};
+  // the 128x128 blocks are independent and processed in parallel, each thread uses its own PRG
+  // for the seed compression of long string OTs
+  const std::size_t number_of_blocks{(number_of_colums + kNumberOfRows - 1) / kNumberOfRows};
+  ParallelFor(number_of_blocks, number_of_threads, [&](std::size_t block) {
+    primitives::Prg prg_var_key;
+    const std::size_t c_begin{block * kNumberOfRows};
+    const std::size_t c_end{std::min(c_begin + kNumberOfRows, original_size)};
+    // the blocks of only padding columns have no outputs
+    if (c_end <= c_begin) return;
+    // the block is transposed into a scratch buffer, s.t. BitVectors are only allocated for
+    // the OTs that keep their outputs in y0 and y1
+    Block128Vector columns(kNumberOfRows);
+    auto out = [&columns, c_begin](std::size_t c) {
+      return reinterpret_cast<std::uint8_t*>(columns[c - c_begin].data());
+    };
+    TransposeColumns<kNumberOfRows>(inp, out, c_begin, c_begin + kNumberOfRows);
+
+    // the outputs of all OTs of the block are hashed in a batch by the fixed-key MMO, columns
+    // holds the hashes of the outputs for choice 0 afterwards
+    const std::size_t block_size{c_end - c_begin};
+    Block128Vector outputs_1(block_size);
+    for (std::size_t i = 0; i < block_size; ++i) outputs_1[i] = columns[i] ^ choices_block;
+    prg_fixed_key.Mmo(columns.data()->data(), block_size);
+    prg_fixed_key.Mmo(outputs_1.data()->data(), block_size);
+
+    for (std::size_t c = c_begin; c < c_end; ++c) {
+      const auto& hash_0{columns[c - c_begin]};
+      const auto& hash_1{outputs_1[c - c_begin]};
+      if (packed && packed->Get(c)) {
+        // only the first bits of packed OTs are kept, the blocks cover disjoint bytes
+        y0_bits->Set(bool(hash_0.data()[0] & kSetBitMask[0]), c);
+        y1_bits->Set(bool(hash_1.data()[0] & kSetBitMask[0]), c);
+        continue;
       }
-    }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& out0 = y0[c_old];
-      auto& out1 = y1[c_old];
 
       // bit length of the OT
-      const auto bitlength = bitlengths[c_old];
-
-      out1 = choices ^ out0;
-      assert(out0.GetSize() == 128);
-      assert(out1.GetSize() == 128);
-      // compute the sender outputs
+      const auto bitlength = bitlengths[c];
       if (bitlength <= kKappa) {
         // the bit length is smaller than 128 bit
-        prg_fixed_key.Mmo(out0.GetMutableData().data());
-        prg_fixed_key.Mmo(out1.GetMutableData().data());
-        out0.Resize(bitlength);
-        out1.Resize(bitlength);
+        y0[c] = BitVector<>(hash_0.data(), bitlength);
+        y1[c] = BitVector<>(hash_1.data(), bitlength);
       } else {
         // string OT with bit length > 128 bit
         // -> do seed compression and send later only 128 bit seeds
-        prg_fixed_key.Mmo(out0.GetMutableData().data());
-        prg_fixed_key.Mmo(out1.GetMutableData().data());
-        prg_var_key.SetKey(out0.GetData().data());
-        out0 = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
-        prg_var_key.SetKey(out1.GetData().data());
-        out1 = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        prg_var_key.SetKey(hash_0.data());
+        y0[c] = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        prg_var_key.SetKey(hash_1.data());
+        y1[c] = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
       }
     }
-  }
+  });
 }
 
 void BitMatrix::ReceiverTranspose128AndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                                std::vector<BitVector<>>& output,
                                                primitives::Prg& prg_fixed_key,
                                                const std::size_t number_of_colums,
-                                               const std::vector<std::size_t>& bitlengths) {
+                                               const std::vector<std::size_t>& bitlengths,
+                                               std::size_t number_of_threads,
+                                               const BitVector<>* packed,
+                                               BitVector<>* output_bits) {
   constexpr std::size_t kKappa{128}, kNumberOfRows{128};
   auto inp = [&matrix](auto r, auto c) {
     return reinterpret_cast<const std::uint8_t* __restrict__>(
@@ -599,53 +695,55 @@ void BitMatrix::ReceiverTranspose128AndEncrypt(const std::array<const std::byte*
   if (difference) {
     output.resize(number_of_colums);
   }
-
-  for (auto& block_vector : output)
-    block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
+  if (packed) {
+    assert(output_bits && packed->GetSize() >= original_size);
+    if (output_bits->GetSize() < number_of_colums) output_bits->Resize(number_of_colums, true);
+  }
 
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 128x128 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(output[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
+  // the 128x128 blocks are independent and processed in parallel, each thread uses its own PRG
+  // for the seed compression of long string OTs
+  const std::size_t number_of_blocks{(number_of_colums + kNumberOfRows - 1) / kNumberOfRows};
+  ParallelFor(number_of_blocks, number_of_threads, [&](std::size_t block) {
+    primitives::Prg prg_var_key;
+    const std::size_t c_begin{block * kNumberOfRows};
+    const std::size_t c_end{std::min(c_begin + kNumberOfRows, original_size)};
+    // the blocks of only padding columns have no outputs
+    if (c_end <= c_begin) return;
+    Block128Vector columns(kNumberOfRows);
+    auto out = [&columns, c_begin](std::size_t c) {
+      return reinterpret_cast<std::uint8_t*>(columns[c - c_begin].data());
+    };
+    TransposeColumns<kNumberOfRows>(inp, out, c_begin, c_begin + kNumberOfRows);
+
+    // the outputs of all OTs of the block are hashed inplace in a batch by the fixed-key MMO
+    const std::size_t block_size{c_end - c_begin};
+    prg_fixed_key.Mmo(columns.data()->data(), block_size);
+
+    for (std::size_t c = c_begin; c < c_end; ++c) {
+      const auto& hash{columns[c - c_begin]};
+      if (packed && packed->Get(c)) {
+        // only the first bits of packed OTs are kept, the blocks cover disjoint bytes
+        output_bits->Set(bool(hash.data()[0] & kSetBitMask[0]), c);
+        continue;
       }
-    }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& o = output[c_old];
-      assert(o.GetSize() == 128);
-      const std::size_t bitlength = bitlengths[c_old];
-
+      const std::size_t bitlength = bitlengths[c];
       if (bitlength <= kKappa) {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
-        o.Resize(bitlength);
+        output[c] = BitVector<>(hash.data(), bitlength);
       } else {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
-        prg_var_key.SetKey(o.GetData().data());
-        o = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
+        prg_var_key.SetKey(hash.data());
+        output[c] = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
       }
     }
-  }
+  });
 }
 
 void BitMatrix::SenderTranspose256AndEncrypt(
     const std::array<const std::byte*, 256>& matrix, std::vector<std::vector<BitVector<>>>& y,
     const BitVector<> choices, std::vector<AlignedBitVector> x_a, primitives::Prg& prg_fixed_key,
-    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths) {
+    const std::size_t number_of_colums, const std::vector<std::size_t>& bitlengths,
+    std::size_t number_of_threads) {
   std::size_t n;
   constexpr std::size_t kKappa{256}, kNumberOfRows{256};
   auto inp = [&matrix](auto r, auto c) {
@@ -665,76 +763,93 @@ void BitMatrix::SenderTranspose256AndEncrypt(
     }
   }
 
-  // do a bit wise AND between choices and the generated x_a
-  std::vector<BitVector<>> choices_and_x_a;
-  for (n = 0; n < x_a.size(); n++) {
-    choices_and_x_a.push_back(choices & x_a.at(n));
+  // do a bit wise AND between choices and the generated x_a, the masked codewords are split into
+  // their lower and upper 128 bits, s.t. they are combined with the columns block-wise
+  const std::size_t number_of_messages{y.size()};
+  assert(number_of_messages <= x_a.size());
+  Block128Vector codewords_low(number_of_messages), codewords_high(number_of_messages);
+  for (n = 0; n < number_of_messages; n++) {
+    const auto choices_and_x_a{choices & x_a.at(n)};
+    codewords_low[n] = Block128::MakeFromMemory(choices_and_x_a.GetData().data());
+    codewords_high[n] =
+        Block128::MakeFromMemory(choices_and_x_a.GetData().data() + Block128::kBlockSize);
   }
 
   for (auto& block_vector : y.at(0))
     block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
 
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_colums % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 256x256 blocks
-  while (c < number_of_colums) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 256 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(
-              y.at(0)[c + 7 - i].GetMutableData().data() + r / 8) = _mm_movemask_epi8(vec);
-        }
+  auto out = [&y](std::size_t c) {
+    return reinterpret_cast<std::uint8_t*>(y.at(0)[c].GetMutableData().data());
+  };
+  // the 256x256 blocks are independent and processed in parallel, each thread uses its own PRG
+  // for the seed compression of long string OTs
+  const std::size_t number_of_blocks{(number_of_colums + kNumberOfRows - 1) / kNumberOfRows};
+  ParallelFor(number_of_blocks, number_of_threads, [&](std::size_t block) {
+    primitives::Prg prg_var_key;
+    // the outputs of all OTs of the block for all messages before they are hashed, s.t. the
+    // candidates of the whole block are hashed with one pipelined multi-block MMO
+    Block128Vector outputs_low(kNumberOfRows * number_of_messages),
+        outputs_high(kNumberOfRows * number_of_messages);
+    const std::size_t c_begin{block * kNumberOfRows};
+    const std::size_t c_end{std::min(c_begin + kNumberOfRows, original_size)};
+    TransposeColumns<kNumberOfRows>(inp, out, c_begin, c_begin + kNumberOfRows);
+    if (c_begin >= c_end) {
+      return;
+    }
+    for (std::size_t c_old = c_begin; c_old < c_end; ++c_old) {
+      assert(y.at(0)[c_old].GetSize() == 256);
+      const auto column{y.at(0)[c_old].GetData().data()};
+      const auto column_low{Block128::MakeFromMemory(column)};
+      const auto column_high{Block128::MakeFromMemory(column + Block128::kBlockSize)};
+      const std::size_t offset{(c_old - c_begin) * number_of_messages};
+      for (std::size_t n = 0; n < number_of_messages; n++) {
+        outputs_low[offset + n] = column_low ^ codewords_low[n];
+        outputs_high[offset + n] = column_high ^ codewords_high[n];
       }
     }
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      //  copy the content of y[0] to all y[n]
-      for (n = 0; n < y.size() - 1; n++) {
-        y.at(n + 1)[c_old] = y.at(n)[c_old];
-      }
+    // the hash only covers the lower 128 bits, as in ReceiverTranspose256AndEncrypt
+    prg_fixed_key.Mmo(outputs_low.data()->data(), (c_end - c_begin) * number_of_messages);
 
-      for (n = 0; n < y.size(); n++) {
-        y.at(n)[c_old] ^= choices_and_x_a.at(n);
-        assert(y.at(n)[c_old].GetSize() == 256);
-      }
+    for (std::size_t c_old = c_begin; c_old < c_end; ++c_old) {
+      const std::size_t offset{(c_old - c_begin) * number_of_messages};
 
       // bit length of the OT
       const auto bitlength = bitlengths[c_old];
 
       // compute the sender outputs
-      if (bitlength <= kKappa) {
-        for (n = 0; n < y.size(); n++) {
-          // the bit length is smaller than 256 bit
-          prg_fixed_key.Mmo(y.at(n)[c_old].GetMutableData().data());
-          y.at(n)[c_old].Resize(bitlength);
+      if (bitlength <= kKappa / 2) {
+        for (std::size_t n = 0; n < number_of_messages; n++) {
+          y.at(n)[c_old] = BitVector<>(outputs_low[offset + n].data(), bitlength);
+        }
+      } else if (bitlength <= kKappa) {
+        // the bit length is smaller than 256 bit
+        for (std::size_t n = 0; n < number_of_messages; n++) {
+          std::array<std::byte, kKappa / 8> output;
+          std::copy_n(outputs_low[offset + n].data(), Block128::kBlockSize, output.data());
+          std::copy_n(outputs_high[offset + n].data(), Block128::kBlockSize,
+                      output.data() + Block128::kBlockSize);
+          y.at(n)[c_old] = BitVector<>(output.data(), bitlength);
         }
       } else {
         // string OT with bit length > 256 bit
         // -> do seed compression and send later only 256 bit seeds
-        for (n = 0; n < y.size(); n++) {
-          prg_fixed_key.Mmo(y.at(n)[c_old].GetMutableData().data());
-          prg_var_key.SetKey(y.at(n)[c_old].GetData().data());
+        for (std::size_t n = 0; n < number_of_messages; n++) {
+          prg_var_key.SetKey(outputs_low[offset + n].data());
           y.at(n)[c_old] = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
         }
       }
     }
-  }
+  });
 }
 
 void BitMatrix::ReceiverTranspose256AndEncrypt(const std::array<const std::byte*, 256>& matrix,
                                                std::vector<BitVector<>>& output,
                                                primitives::Prg& prg_fixed_key,
                                                const std::size_t number_of_columns,
-                                               const std::vector<std::size_t>& bitlengths) {
+                                               const std::vector<std::size_t>& bitlengths,
+                                               std::size_t number_of_threads) {
   constexpr std::size_t kKappa{256}, kNumberOfRows{256};
   auto inp = [&matrix](auto r, auto c) {
     return reinterpret_cast<const std::uint8_t* __restrict__>(
@@ -749,43 +864,42 @@ void BitMatrix::ReceiverTranspose256AndEncrypt(const std::array<const std::byte*
   for (auto& block_vector : output)
     block_vector = BitVector(std::vector<std::byte>(kKappa / 8), kKappa);
 
-  std::uint64_t r{0}, c{0};
-  int i{0};
-
   assert(kNumberOfRows % 8 == 0 && number_of_columns % 8 == 0);
 
-  __m128i vec;
-  primitives::Prg prg_var_key;
-  // process 256x256 blocks
-  while (c < number_of_columns) {
-    auto c_old{c};
-    for (r = 0; r <= kNumberOfRows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 256 != 0); c += 8) {
-        vec = _mm_set_epi8(inp(r + 15, c), inp(r + 14, c), inp(r + 13, c), inp(r + 12, c),
-                           inp(r + 11, c), inp(r + 10, c), inp(r + 9, c), inp(r + 8, c),
-                           inp(r + 7, c), inp(r + 6, c), inp(r + 5, c), inp(r + 4, c),
-                           inp(r + 3, c), inp(r + 2, c), inp(r + 1, c), inp(r + 0, c));
-        for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-          *reinterpret_cast<std::uint16_t* __restrict__>(output[c + 7 - i].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
-    }
-    for (; c_old < c && c_old < original_size; ++c_old) {
+  auto out = [&output](std::size_t c) {
+    return reinterpret_cast<std::uint8_t*>(output[c].GetMutableData().data());
+  };
+  // the 256x256 blocks are independent and processed in parallel, each thread uses its own PRG
+  // for the seed compression of long string OTs
+  const std::size_t number_of_blocks{(number_of_columns + kNumberOfRows - 1) / kNumberOfRows};
+  ParallelFor(number_of_blocks, number_of_threads, [&](std::size_t block) {
+    primitives::Prg prg_var_key;
+    const std::size_t c_begin{block * kNumberOfRows};
+    const std::size_t c_end{std::min(c_begin + kNumberOfRows, original_size)};
+    TransposeColumns<kNumberOfRows>(inp, out, c_begin, c_begin + kNumberOfRows);
+    if (c_begin >= c_end) {
+      return;
+    }
+    // the lower 128 bits of the columns of the block are hashed with one multi-block MMO
+    Block128Vector hashes(c_end - c_begin);
+    for (std::size_t c_old = c_begin; c_old < c_end; ++c_old) {
+      assert(output[c_old].GetSize() == 256);
+      hashes[c_old - c_begin] = Block128::MakeFromMemory(output[c_old].GetData().data());
+    }
+    prg_fixed_key.Mmo(hashes.data()->data(), hashes.size());
+    for (std::size_t c_old = c_begin; c_old < c_end; ++c_old) {
       auto& o = output[c_old];
-      assert(o.GetSize() == 256);
       const std::size_t bitlength = bitlengths[c_old];
+      std::copy_n(hashes[c_old - c_begin].data(), Block128::kBlockSize, o.GetMutableData().data());
 
       if (bitlength <= kKappa) {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
         o.Resize(bitlength);
       } else {
-        prg_fixed_key.Mmo(o.GetMutableData().data());
         prg_var_key.SetKey(o.GetData().data());
         o = BitVector<>(prg_var_key.Encrypt(BitsToBytes(bitlength)), bitlength);
       }
     }
-  }
+  });
 }
 
 bool BitMatrix::operator==(const BitMatrix& other) const {
@@ -187,6 +187,12 @@ class BitMatrix {
   /// \param prg_fixed_key
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads The number of threads processing the blocks of columns in parallel.
+  /// \param packed If not null, the set bits mark the 1-bit OTs whose outputs are only written to
+  ///        \p y0_bits and \p y1_bits, which are resized to number_of_columns if shorter, instead
+  ///        of allocating a BitVector per OT in \p y0 and \p y1.
+  /// \param y0_bits
+  /// \param y1_bits
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   ///      - y0 and y1 must be of equal size
@@ -195,7 +201,11 @@ class BitMatrix {
                                            std::vector<BitVector<>>& y1, const BitVector<> choices,
                                            primitives::Prg& prg_fixed_key,
                                            const std::size_t number_of_columns,
-                                           const std::vector<std::size_t>& bitlengths);
+                                           const std::vector<std::size_t>& bitlengths,
+                                           std::size_t number_of_threads = 1,
+                                           const BitVector<>* packed = nullptr,
+                                           BitVector<>* y0_bits = nullptr,
+                                           BitVector<>* y1_bits = nullptr);
 
   /// \brief Transposes a matrix of 128 rows and arbitrary column size and encrypts it for the
   /// recipient role.
@@ -205,13 +215,20 @@ class BitMatrix {
   /// \param prg_fixed_key
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads The number of threads processing the blocks of columns in parallel.
+  /// \param packed If not null, the set bits mark the 1-bit OTs whose outputs are only written to
+  ///        \p output_bits, which is resized to number_of_columns if shorter.
+  /// \param output_bits
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   static void ReceiverTranspose128AndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                              std::vector<BitVector<>>& output,
                                              primitives::Prg& prg_fixed_key,
                                              const std::size_t number_of_columns,
-                                             const std::vector<std::size_t>& bitlengths);
+                                             const std::vector<std::size_t>& bitlengths,
+                                             std::size_t number_of_threads = 1,
+                                             const BitVector<>* packed = nullptr,
+                                             BitVector<>* output_bits = nullptr);
 
   /// \brief Transposes a matrix of 256 rows and arbitrary column size and encrypts it for the
   /// sender role.
@@ -221,6 +238,7 @@ class BitMatrix {
   /// \param x_a
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads The number of threads processing the blocks of columns in parallel.
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   ///      - all vectors in y must be of equal size
@@ -229,7 +247,8 @@ class BitMatrix {
                                            const BitVector<> choices,
                                            std::vector<AlignedBitVector> x_a, primitives::Prg&,
                                            const std::size_t number_of_colums,
-                                           const std::vector<std::size_t>& bitlengths);
+                                           const std::vector<std::size_t>& bitlengths,
+                                           std::size_t number_of_threads = 1);
 
   /// \brief Transposes a matrix of 256 rows and arbitrary column size and encrypts it for the
   /// recipient role.
@@ -237,13 +256,15 @@ class BitMatrix {
   /// \param[out] output Output from sender.
   /// \param number_of_columns
   /// \param bitlengths
+  /// \param number_of_threads The number of threads processing the blocks of columns in parallel.
   /// \pre - All rows must be of size equal to number_of_columns
   ///      - const std::byte* in matrix is (number_of_columns)-bit aligned
   static void ReceiverTranspose256AndEncrypt(const std::array<const std::byte*, 256>& matrix,
                                              std::vector<BitVector<>>& output,
                                              primitives::Prg& prg_fixed_key,
                                              const std::size_t number_of_columns,
-                                             const std::vector<std::size_t>& bitlengths);
+                                             const std::vector<std::size_t>& bitlengths,
+                                           std::size_t number_of_threads = 1);
 
   /// \brief Compare with another BitMatrix for equality
   /// \param other
@@ -24,7 +24,10 @@
 
 #include "bit_vector.h"
 
+#include <algorithm>
 #include <bit>
+#include <cstring>
+#include <functional>
 #include <span>
 
 #include "primitives/random/default_rng.h"
@@ -47,13 +50,7 @@ inline void TruncateToFitImplementation(std::byte* pointer, const std::size_t bi
 inline void SetImplementation(std::byte* pointer, const bool value,
                               const std::size_t bit_size) noexcept {
   const std::size_t byte_size{NumberOfBitsToNumberOfBytes(bit_size)};
-  for (auto i = 0ull; i < byte_size; ++i) {
-    if (value) {  // set
-      *(pointer + i) |= std::byte(0xFFu);
-    } else {  // unset
-      *(pointer + i) &= std::byte(0u);
-    }
-  }
+  std::fill(pointer, pointer + byte_size, value ? std::byte(0xFFu) : std::byte(0u));
 
   if (value) {
     TruncateToFitImplementation(pointer, bit_size);
@@ -100,64 +97,90 @@ inline bool AlignedEqualImplementation(const T* pointer1, const U* pointer2,
   return std::equal(pointer1_cast, pointer1_cast + byte_size, pointer2_cast);
 }
 
+// Unaligned 64-bit loads and stores, which compile to single moves on x86
+inline std::uint64_t LoadWord(const std::byte* pointer) noexcept {
+  std::uint64_t word;
+  std::memcpy(&word, pointer, sizeof(word));
+  return word;
+}
+
+inline void StoreWord(std::byte* pointer, const std::uint64_t word) noexcept {
+  std::memcpy(pointer, &word, sizeof(word));
+}
+
+// Applies `operation` to 64-bit words of `input` and `result` and to the remaining bytes.  The
+// word loop is vectorized by the compiler, using AVX2 if MOTION_USE_AVX enables it.
+template <typename Operation>
+inline void BinaryWordImplementation(const std::byte* input, std::byte* result,
+                                     const std::size_t byte_size, Operation operation) noexcept {
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    StoreWord(result + i, operation(LoadWord(input + i), LoadWord(result + i)));
+  }
+  for (; i < byte_size; ++i) {
+    result[i] = operation(input[i], result[i]);
+  }
+}
+
+inline void InvertImplementation(std::byte* pointer, const std::size_t byte_size) noexcept {
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    StoreWord(pointer + i, ~LoadWord(pointer + i));
+  }
+  for (; i < byte_size; ++i) pointer[i] = ~pointer[i];
+}
+
 template <typename T, typename U>
 inline void XorImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  BinaryWordImplementation(reinterpret_cast<const std::byte*>(input),
+                           reinterpret_cast<std::byte*>(result), byte_size, std::bit_xor<>());
 }
 
-// TODO: check how good this is vectorized
 template <typename T, typename U>
 inline void AlignedXorImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  BinaryWordImplementation(
+      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment)),
+      reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment)), byte_size,
+      std::bit_xor<>());
 }
 
 template <typename T, typename U>
 inline void AndImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  BinaryWordImplementation(reinterpret_cast<const std::byte*>(input),
+                           reinterpret_cast<std::byte*>(result), byte_size, std::bit_and<>());
 }
 
 template <typename T, typename U>
 inline void AlignedAndImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  BinaryWordImplementation(
+      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment)),
+      reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment)), byte_size,
+      std::bit_and<>());
 }
 
 template <typename T, typename U>
 inline void OrImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{reinterpret_cast<const std::byte*>(input)};
-  auto result_cast{reinterpret_cast<std::byte*>(result)};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  BinaryWordImplementation(reinterpret_cast<const std::byte*>(input),
+                           reinterpret_cast<std::byte*>(result), byte_size, std::bit_or<>());
 }
 
 template <typename T, typename U>
 inline void AlignedOrImplementation(const T* input, U* result, const std::size_t byte_size) {
-  const auto input_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment))};
-  auto result_cast{reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment))};
-  std::transform(input_cast, input_cast + byte_size, result_cast, result_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  BinaryWordImplementation(
+      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(input, kAlignment)),
+      reinterpret_cast<std::byte*>(__builtin_assume_aligned(result, kAlignment)), byte_size,
+      std::bit_or<>());
 }
 
+// Copies the bits [0, to - from) of `source` to the bits [from, to) of `destination` and keeps
+// the other bits of `destination`.  If `from` is not a multiple of 8, each destination word is
+// funnel-shifted from two overlapping source words.
 inline void CopyImplementation(const std::size_t from, const std::size_t to,
                                const std::byte* source, std::byte* destination) {
   if (from > to) {
     throw std::logic_error(fmt::format(
-        "Got `from`={} and `to`={} in Copy, but `from` should be greater than or equal to `to`",
-        from, to));
+        "Got `from`={} and `to`={} in Copy, but `from` should be less than or equal to `to`", from,
+        to));
   }
 
   if (from == to) {
@@ -165,55 +188,49 @@ inline void CopyImplementation(const std::size_t from, const std::size_t to,
   }
 
   const auto number_of_bits = to - from;
+  const auto shift = from % 8;
+  // the last destination byte is written only partially if tail > 0
+  const auto tail = (shift + number_of_bits) % 8;
+  const auto number_of_complete_bytes = (shift + number_of_bits) / 8;
+  destination += from / 8;
+
+  if (number_of_complete_bytes == 0) {
+    const auto mask = TruncationBitMask[number_of_bits] << shift;
+    destination[0] &= ~mask;
+    destination[0] |= (source[0] << shift) & mask;
+    return;
+  }
 
-  const auto destination_to_offset = to % 8;
-  const auto destination_from_offset = from % 8;
-  const auto from_bytes = from / 8;
-
-  if (destination_from_offset + number_of_bits < 8) {
-    const auto mask = TruncationBitMask[number_of_bits] << destination_from_offset;
-    destination[from_bytes] &= ~mask;
-    destination[from_bytes] |= (source[0] << destination_from_offset) & mask;
-  } else if ((from % 8) == 0) {
-    const auto number_of_bytes = BitsToBytes(number_of_bits);
-    const bool has_remainder = destination_to_offset > 0;
-    for (std::size_t i = 0; i < number_of_bytes - (has_remainder ? 1 : 0); ++i) {
-      destination[from_bytes + i] = source[i];
-    }
-    if (destination_to_offset > 0) {
-      const auto mask = TruncationBitMask[destination_to_offset];
-      destination[from_bytes + number_of_bytes - 1] &= ~mask;
-      destination[from_bytes + number_of_bytes - 1] |= source[number_of_bytes - 1] & mask;
-    }
-  } else {
-    const auto number_of_bytes = BitsToBytes(destination_from_offset + number_of_bits);
-    const auto number_of_complete_bytes =
-        BitsToBytes(number_of_bits - (8 - destination_from_offset) - destination_to_offset);
-    const auto destination_from_offset = from % 8;
-
-    destination[from_bytes] &= TruncationBitMask[destination_from_offset];
-    destination[from_bytes] |= source[0] << destination_from_offset;
-
-    for (std::size_t byte_i = 1; byte_i <= number_of_complete_bytes; ++byte_i) {
-      std::byte lower_part{source[byte_i - 1] >> (8 - destination_from_offset)};
-      std::byte upper_part{source[byte_i] << destination_from_offset};
-      destination[from_bytes + byte_i] = lower_part | upper_part;
+  if (shift == 0) {
+    std::copy(source, source + number_of_complete_bytes, destination);
+    if (tail > 0) {
+      const auto mask = TruncationBitMask[tail];
+      destination[number_of_complete_bytes] &= ~mask;
+      destination[number_of_complete_bytes] |= source[number_of_complete_bytes] & mask;
     }
+    return;
+  }
 
-    if (destination_to_offset > 0) {
-      destination[from_bytes + number_of_bytes - 1] &= ~TruncationBitMask[destination_to_offset];
-      std::size_t mask_index{destination_to_offset > destination_from_offset
-                                 ? destination_from_offset
-                                 : destination_to_offset};
-      std::byte mask1{TruncationBitMask[mask_index]};
-      destination[from_bytes + number_of_bytes - 1] |=
-          (source[number_of_bytes - 2] >> (8 - destination_from_offset)) & mask1;
-      if (destination_to_offset > destination_from_offset) {
-        std::byte mask2{TruncationBitMask[destination_to_offset - destination_from_offset]};
-        destination[from_bytes + number_of_bytes - 1] |= (source[number_of_bytes - 1] & mask2)
-                                                         << destination_from_offset;
-      }
-    }
+  destination[0] &= TruncationBitMask[shift];
+  destination[0] |= source[0] << shift;
+
+  // the destination bytes [i, i + 8) need the source bytes [i - 1, i + 8)
+  std::size_t i = 1;
+  for (; i + sizeof(std::uint64_t) <= number_of_complete_bytes; i += sizeof(std::uint64_t)) {
+    StoreWord(destination + i,
+              (LoadWord(source + i - 1) >> (8 - shift)) | (LoadWord(source + i) << shift));
+  }
+  for (; i < number_of_complete_bytes; ++i) {
+    destination[i] = (source[i - 1] >> (8 - shift)) | (source[i] << shift);
+  }
+
+  if (tail > 0) {
+    // source byte i holds bits of the last destination byte only if tail > shift
+    std::byte bits{source[i - 1] >> (8 - shift)};
+    if (tail > shift) bits |= source[i] << shift;
+    const auto mask = TruncationBitMask[tail];
+    destination[i] &= ~mask;
+    destination[i] |= bits & mask;
   }
 }
 
@@ -227,30 +244,28 @@ inline BitVector<Allocator> SubsetImplementation(const std::size_t from, const s
 
   result.Resize(to - from);
 
-  const auto from_bit_offset = from % 8;
+  const auto shift = from % 8;
+  const auto result_byte_size = BitsToBytes(to - from);
+  const auto source_byte_size = BitsToBytes(to) - from / 8;
+  source += from / 8;
+  auto result_pointer = result.GetMutableData().data();
 
-  if (from_bit_offset == 0u) {
-    std::copy(source + (from / 8), source + (BitsToBytes(to)), result.GetMutableData().data());
-  } else if (from_bit_offset + result.GetSize() <= 8u) {
-    result.GetMutableData()[0] = source[from / 8];
-    result.GetMutableData()[0] >>= from_bit_offset;
+  if (shift == 0u) {
+    std::copy(source, source + result_byte_size, result_pointer);
   } else {
-    auto new_byte_offset = 0ull;
-    auto bit_counter = 0ull;
-    const auto max = result.GetSize();
-    for (; bit_counter < max; ++new_byte_offset) {
-      auto left_part = source[(from / 8) + new_byte_offset] >> from_bit_offset;
-      result.GetMutableData()[new_byte_offset] |= left_part;
-      bit_counter += 8 - from_bit_offset;
-      if (bit_counter < max) {
-        auto right_part = source[(from / 8) + new_byte_offset + 1] << (8 - from_bit_offset);
-        result.GetMutableData()[new_byte_offset] |= right_part;
-        bit_counter += from_bit_offset;
-      }
+    // the result bytes [i, i + 8) need the source bytes [i, i + 9)
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) < source_byte_size; i += sizeof(std::uint64_t)) {
+      StoreWord(result_pointer + i,
+                (LoadWord(source + i) >> shift) | (LoadWord(source + i + 1) << (8 - shift)));
+    }
+    for (; i < result_byte_size; ++i) {
+      result_pointer[i] = source[i] >> shift;
+      if (i + 1 < source_byte_size) result_pointer[i] |= source[i + 1] << (8 - shift);
     }
   }
 
-  TruncateToFitImplementation(result.GetMutableData().data(), result.GetSize());
+  TruncateToFitImplementation(result_pointer, result.GetSize());
 
   return result;
 }
@@ -260,8 +275,8 @@ std::size_t HammingWeightImplementation(std::span<const std::byte> data) {
   if (data.empty()) return count;
 
   std::size_t i = 0;
-  for (; i + 8 < data.size(); i += 8) {
-    count += std::popcount(*reinterpret_cast<std::uint64_t const*>(&data[i]));
+  for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t)) {
+    count += std::popcount(LoadWord(&data[i]));
   }
   for (; i < data.size(); ++i) {
     count += std::popcount(static_cast<std::uint8_t>(data[i]));
@@ -316,8 +331,12 @@ BitVector<Allocator>::BitVector(std::vector<std::byte, Allocator>&& data,
   if (byte_size > data.size()) {
     throw std::out_of_range(fmt::format("BitVector: accessing {} of {}", byte_size, data.size()));
   }
-  data_vector_ = std::move(data);
-  data_vector_.resize(byte_size);
+  if constexpr (std::is_same_v<BitVectorStorage<Allocator>, std::vector<std::byte, Allocator>>) {
+    data_vector_ = std::move(data);
+    data_vector_.resize(byte_size);
+  } else {
+    data_vector_.assign(data.cbegin(), data.cbegin() + byte_size);
+  }
   TruncateToFit();
 }
 
@@ -345,9 +364,7 @@ BitVector<Allocator>::BitVector(const std::vector<bool>& data, std::size_t numbe
 
 template <typename Allocator>
 void BitVector<Allocator>::Invert() {
-  for (auto i = 0ull; i < data_vector_.size(); ++i) {
-    data_vector_.at(i) = ~data_vector_.at(i);
-  }
+  InvertImplementation(data_vector_.data(), data_vector_.size());
 
   TruncateToFit();
 }
@@ -815,19 +832,17 @@ BitVector<Allocator> BitVector<Allocator>::SecureRandom(const std::size_t bit_si
 
 template <typename Allocator>
 bool BitVector<Allocator>::AndReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return true;
-  } else {
-    std::size_t remaining_bit_size = bit_vector.bit_size_;
-    std::size_t i = 0;
-    while (remaining_bit_size > 0) {
-      std::size_t remainder = remaining_bit_size >= 8u ? 8 : remaining_bit_size;
-      remaining_bit_size -= remainder;
-      std::byte mask = remainder == 8 ? std::byte(0xFF) : TruncationBitMask[remainder];
-      if (bit_vector.data_vector_[i++] != mask) return false;
-    }
-    return true;
+  const std::size_t complete_bytes{bit_vector.bit_size_ / 8};
+  const std::byte* pointer{bit_vector.data_vector_.data()};
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= complete_bytes; i += sizeof(std::uint64_t)) {
+    if (LoadWord(pointer + i) != std::numeric_limits<std::uint64_t>::max()) return false;
+  }
+  for (; i < complete_bytes; ++i) {
+    if (pointer[i] != std::byte(0xFF)) return false;
   }
+  const std::size_t remainder{bit_vector.bit_size_ % 8};
+  return remainder == 0 || pointer[complete_bytes] == TruncationBitMask[remainder];
 }
 
 template <typename Allocator>
@@ -849,32 +864,18 @@ BitVector<Allocator> BitVector<Allocator>::AndBitVectors(
 
 template <typename Allocator>
 bool BitVector<Allocator>::OrReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return {};
-  } else if (bit_vector.GetSize() == 1) {
-    return bit_vector.Get(0);
-  } else if (bit_vector.GetSize() <= 64) {
-    bool result = bit_vector.Get(0);
-    for (auto i = 1ull; i < bit_vector.GetSize(); ++i) {
-      result |= bit_vector.Get(i);
-    }
-    return result;
-  } else {
-    auto raw_vector = bit_vector.GetData();
-    std::byte b = raw_vector.at(0);
-
-    for (auto i = 1ull; i < raw_vector.size(); ++i) {
-      b |= raw_vector.at(i);
-    }
-    BitVector tmp({b}, 8);
-    bool result = tmp.Get(0);
-
-    for (auto i = 1; i < 8; ++i) {
-      result |= tmp.Get(i);
-    }
-
-    return result;
+  // the bits behind bit_size_ are zero, so OR-ing the whole words is safe
+  const std::byte* pointer{bit_vector.data_vector_.data()};
+  const std::size_t byte_size{bit_vector.data_vector_.size()};
+  std::uint64_t accumulator{0};
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    accumulator |= LoadWord(pointer + i);
+  }
+  for (; i < byte_size; ++i) {
+    accumulator |= std::to_integer<std::uint64_t>(pointer[i]);
   }
+  return accumulator != 0;
 }
 
 template <typename Allocator>
@@ -927,32 +928,18 @@ std::vector<BitVector<Allocator>> BitVector<Allocator>::AndBitVectors(
 
 template <typename Allocator>
 bool BitVector<Allocator>::XorReduceBitVector(const BitVector& bit_vector) {
-  if (bit_vector.GetSize() == 0) {
-    return {};
-  } else if (bit_vector.GetSize() == 1) {
-    return bit_vector.Get(0);
-  } else if (bit_vector.GetSize() <= 64) {
-    bool result = bit_vector.Get(0);
-    for (auto i = 1ull; i < bit_vector.GetSize(); ++i) {
-      result ^= bit_vector.Get(i);
-    }
-    return result;
-  } else {
-    auto raw_vector = bit_vector.GetData();
-    std::byte b = raw_vector.at(0);
-
-    for (auto i = 1ull; i < raw_vector.size(); ++i) {
-      b ^= raw_vector.at(i);
-    }
-    BitVector tmp({b}, 8);
-    bool result = tmp.Get(0);
-
-    for (auto i = 1; i < 8; ++i) {
-      result ^= tmp.Get(i);
-    }
-
-    return result;
+  // the bits behind bit_size_ are zero, so XOR-ing the whole words is safe
+  const std::byte* pointer{bit_vector.data_vector_.data()};
+  const std::size_t byte_size{bit_vector.data_vector_.size()};
+  std::uint64_t accumulator{0};
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= byte_size; i += sizeof(std::uint64_t)) {
+    accumulator ^= LoadWord(pointer + i);
+  }
+  for (; i < byte_size; ++i) {
+    accumulator ^= std::to_integer<std::uint64_t>(pointer[i]);
   }
+  return (std::popcount(accumulator) & 1) == 1;
 }
 
 template <typename Allocator>
@@ -1042,7 +1029,7 @@ void BitVector<Allocator>::BoundsCheckInRange([[maybe_unused]] const std::size_t
 
 template <typename Allocator>
 std::size_t BitVector<Allocator>::HammingWeight() const {
-  return HammingWeightImplementation(data_vector_);
+  return HammingWeightImplementation(std::span(data_vector_.data(), data_vector_.size()));
 }
 
 template class BitVector<StdAllocator>;
@@ -1406,8 +1393,7 @@ void BitSpan::Set(const bool value, const std::size_t position) {
 }
 
 void BitSpan::Invert() {
-  std::transform(pointer_, pointer_ + NumberOfBitsToNumberOfBytes(bit_size_), pointer_,
-                 [](std::byte& b) { return ~b; });
+  InvertImplementation(pointer_, NumberOfBitsToNumberOfBytes(bit_size_));
   TruncateToFitImplementation(pointer_, bit_size_);
 }
 
@@ -1425,6 +1411,18 @@ template BitVector<StdAllocator> BitSpan::Subset(const std::size_t from,
 template BitVector<AlignedAllocator> BitSpan::Subset(const std::size_t from,
                                                      const std::size_t to) const;
 
+BitSpan BitSpan::Subspan(const std::size_t from, const std::size_t to) const {
+  if (from > to || to > bit_size_) {
+    throw std::out_of_range(
+        fmt::format("Accessing positions {} to {} in BitSpan of bit_size {}", from, to, bit_size_));
+  }
+  if (from % 8 != 0 || (to % 8 != 0 && to != bit_size_)) {
+    throw std::invalid_argument(
+        fmt::format("Subspan from {} to {} does not start and end at byte boundaries", from, to));
+  }
+  return BitSpan(pointer_ + from / 8, to - from, aligned_ && from == 0);
+}
+
 std::string BitSpan::AsString() const noexcept {
   std::string result;
   for (auto i = 0ull; i < bit_size_; ++i) {
@@ -29,13 +29,15 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <fmt/format.h>
-#include <boost/align/aligned_allocator.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include "config.h"
 #include "helpers.h"
+#include "pool_allocator.h"
 
 namespace encrypto::motion {
 
@@ -57,7 +59,19 @@ constexpr std::byte TruncationBitMask[] = {
 class BitSpan;
 
 using StdAllocator = std::allocator<std::byte>;
-using AlignedAllocator = boost::alignment::aligned_allocator<std::byte, kAlignment>;
+using AlignedAllocator = PooledAlignedAllocator<std::byte, kAlignment>;
+
+// number of bytes a BitVector<StdAllocator> stores inline, i.e., without a heap allocation
+constexpr std::size_t kBitVectorInlineBytes{16};
+
+/// \brief Buffer of a BitVector.  BitVector<StdAllocator> uses a small buffer, s.t. the
+///        single-bit and short shares of non-SIMD circuits do not allocate.  Aligned BitVectors
+///        keep std::vector, since the inline buffer does not have the alignment of kAlignment.
+template <typename Allocator>
+using BitVectorStorage = std::conditional_t<
+    std::is_same_v<Allocator, StdAllocator>,
+    boost::container::small_vector<std::byte, kBitVectorInlineBytes, Allocator>,
+    std::vector<std::byte, Allocator>>;
 
 /// \brief Class representing a series of bits and providing single bit access.
 template <typename Allocator = std::allocator<std::byte>>
@@ -417,7 +431,7 @@ class BitVector {
   std::size_t HammingWeight() const;
 
  private:
-  std::vector<std::byte, Allocator> data_vector_;
+  BitVectorStorage<Allocator> data_vector_;
 
   std::size_t bit_size_;
 
@@ -647,6 +661,12 @@ class BitSpan {
   template <typename BitVectorType = AlignedBitVector>
   BitVectorType Subset(const std::size_t from, const std::size_t to) const;
 
+  /// \brief Returns a BitSpan over the bits of this BitSpan between positions \p from and \p to
+  /// without copying them, e.g., to operate directly on a received message.
+  /// \param from needs to be a multiple of 8
+  /// \param to needs to be a multiple of 8 or the end of this BitSpan
+  BitSpan Subspan(const std::size_t from, const std::size_t to) const;
+
   /// \brief Check if BitSpan is empty.
   bool Empty() const noexcept { return bit_size_; }
 
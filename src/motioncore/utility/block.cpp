@@ -21,14 +21,147 @@
 // SOFTWARE.
 
 #include "block.h"
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#else
+#include <immintrin.h>
+#endif
 #include <algorithm>
 #include <boost/algorithm/hex.hpp>
 #include <cassert>
+#include <cstdint>
 #include "primitives/random/default_rng.h"
 
-
 namespace encrypto::motion {
 
+namespace {
+
+static_assert(sizeof(Block128) == Block128::kBlockSize);
+
+inline bool GetBit(const std::byte* bits, std::size_t i) {
+  return std::to_integer<unsigned>(bits[i / 8] >> (i % 8)) & 1;
+}
+
+// single blocks are processed in 128 bit registers
+#if defined(__ARM_NEON)
+using Register = uint8x16_t;
+inline Register Load(const Block128* pointer) {
+  return vld1q_u8(reinterpret_cast<const std::uint8_t*>(pointer));
+}
+inline void Store(Block128* pointer, Register value) {
+  vst1q_u8(reinterpret_cast<std::uint8_t*>(pointer), value);
+}
+inline Register Xor(Register a, Register b) { return veorq_u8(a, b); }
+inline Register And(Register a, Register b) { return vandq_u8(a, b); }
+inline Register Mask(const std::byte* bits, std::size_t i) {
+  return vdupq_n_u8(-static_cast<std::uint8_t>(GetBit(bits, i)));
+}
+#else
+using Register = __m128i;
+inline Register Load(const Block128* pointer) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pointer));
+}
+inline void Store(Block128* pointer, Register value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(pointer), value);
+}
+inline Register Xor(Register a, Register b) { return _mm_xor_si128(a, b); }
+inline Register And(Register a, Register b) { return _mm_and_si128(a, b); }
+inline Register Mask(const std::byte* bits, std::size_t i) {
+  return _mm_set1_epi64x(-static_cast<std::int64_t>(GetBit(bits, i)));
+}
+#endif
+
+// the bulk of the blocks is processed in the widest registers chosen by MOTION_USE_AVX, where
+// WideMask(bits, i) is all-ones in the blocks i + j with a set bit
+#if defined(MOTION_AVX512)
+using WideRegister = __m512i;
+constexpr std::size_t kBlocksPerWideRegister{4};
+inline WideRegister LoadWide(const Block128* pointer) { return _mm512_loadu_si512(pointer); }
+inline void StoreWide(Block128* pointer, WideRegister value) {
+  _mm512_storeu_si512(pointer, value);
+}
+inline WideRegister Broadcast(const Block128& block) {
+  return _mm512_broadcast_i32x4(Load(&block));
+}
+inline WideRegister Xor(WideRegister a, WideRegister b) { return _mm512_xor_si512(a, b); }
+inline WideRegister And(WideRegister a, WideRegister b) { return _mm512_and_si512(a, b); }
+inline WideRegister WideMask(const std::byte* bits, std::size_t i) {
+  __mmask8 mask{0};
+  for (std::size_t j = 0; j < kBlocksPerWideRegister; ++j) {
+    if (GetBit(bits, i + j)) mask |= 0b11 << (2 * j);
+  }
+  return _mm512_maskz_set1_epi64(mask, -1);
+}
+#elif defined(MOTION_AVX2)
+using WideRegister = __m256i;
+constexpr std::size_t kBlocksPerWideRegister{2};
+inline WideRegister LoadWide(const Block128* pointer) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pointer));
+}
+inline void StoreWide(Block128* pointer, WideRegister value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(pointer), value);
+}
+inline WideRegister Broadcast(const Block128& block) {
+  return _mm256_broadcastsi128_si256(Load(&block));
+}
+inline WideRegister Xor(WideRegister a, WideRegister b) { return _mm256_xor_si256(a, b); }
+inline WideRegister And(WideRegister a, WideRegister b) { return _mm256_and_si256(a, b); }
+inline WideRegister WideMask(const std::byte* bits, std::size_t i) {
+  const std::int64_t low{-static_cast<std::int64_t>(GetBit(bits, i))};
+  const std::int64_t high{-static_cast<std::int64_t>(GetBit(bits, i + 1))};
+  return _mm256_set_epi64x(high, high, low, low);
+}
+#else
+using WideRegister = Register;
+constexpr std::size_t kBlocksPerWideRegister{1};
+inline WideRegister LoadWide(const Block128* pointer) { return Load(pointer); }
+inline void StoreWide(Block128* pointer, WideRegister value) { Store(pointer, value); }
+inline WideRegister Broadcast(const Block128& block) { return Load(&block); }
+inline WideRegister WideMask(const std::byte* bits, std::size_t i) { return Mask(bits, i); }
+#endif
+
+// output[i] = operation(a[i], b[i]), where operation is called with both register types
+template <typename Operation>
+inline void Transform(Block128* output, const Block128* a, const Block128* b, std::size_t n,
+                      Operation operation) {
+  std::size_t i{0};
+  for (; i + kBlocksPerWideRegister <= n; i += kBlocksPerWideRegister) {
+    StoreWide(output + i, operation(LoadWide(a + i), LoadWide(b + i)));
+  }
+  for (; i < n; ++i) Store(output + i, operation(Load(a + i), Load(b + i)));
+}
+
+}  // namespace
+
+void XorBlocks(Block128* output, const Block128* a, const Block128* b, std::size_t n) {
+  Transform(output, a, b, n, [](auto x, auto y) { return Xor(x, y); });
+}
+
+void XorBlocks(Block128* output, const Block128* a, const Block128& b, std::size_t n) {
+  const WideRegister wide_b{Broadcast(b)};
+  const Register single_b{Load(&b)};
+  std::size_t i{0};
+  for (; i + kBlocksPerWideRegister <= n; i += kBlocksPerWideRegister) {
+    StoreWide(output + i, Xor(LoadWide(a + i), wide_b));
+  }
+  for (; i < n; ++i) Store(output + i, Xor(Load(a + i), single_b));
+}
+
+void AndBlocks(Block128* output, const Block128* a, const Block128* b, std::size_t n) {
+  Transform(output, a, b, n, [](auto x, auto y) { return And(x, y); });
+}
+
+void ConditionalXorBlocks(Block128* output, const Block128* a, const std::byte* bits,
+                          const Block128& b, std::size_t n) {
+  const WideRegister wide_b{Broadcast(b)};
+  const Register single_b{Load(&b)};
+  std::size_t i{0};
+  for (; i + kBlocksPerWideRegister <= n; i += kBlocksPerWideRegister) {
+    StoreWide(output + i, Xor(LoadWide(a + i), And(WideMask(bits, i), wide_b)));
+  }
+  for (; i < n; ++i) Store(output + i, Xor(Load(a + i), And(Mask(bits, i), single_b)));
+}
+
 void Block128::SetToRandom() {
   auto& rng = DefaultRng::GetThreadInstance();
   rng.RandomBlocksAligned(byte_array.data(), 1);
@@ -24,9 +24,11 @@
 
 #include <algorithm>
 #include <array>
-#include <boost/align/aligned_allocator.hpp>
+#include <cassert>
+#include <cstddef>
 #include <vector>
 #include "config.h"
+#include "pool_allocator.h"
 
 namespace encrypto::motion {
 
@@ -166,12 +168,30 @@ struct Block128 {
   alignas(kBlockAlignment) std::array<std::byte, 16> byte_array;
 };
 
+// Bulk operations over arrays of Block128, which use the widest vector registers enabled by
+// MOTION_USE_AVX.  The output may be identical to an input for in-place operations, but must not
+// overlap it partially.
+
+/// \brief Computes output[i] = a[i] ^ b[i] for i in [0, n).
+void XorBlocks(Block128* output, const Block128* a, const Block128* b, std::size_t n);
+
+/// \brief Computes output[i] = a[i] ^ b for i in [0, n).
+void XorBlocks(Block128* output, const Block128* a, const Block128& b, std::size_t n);
+
+/// \brief Computes output[i] = a[i] & b[i] for i in [0, n).
+void AndBlocks(Block128* output, const Block128* a, const Block128* b, std::size_t n);
+
+/// \brief Computes output[i] = bits_i ? a[i] ^ b : a[i] for i in [0, n), where bit i is bit i % 8
+///        of byte i / 8 of \p bits as in BitVector.
+void ConditionalXorBlocks(Block128* output, const Block128* a, const std::byte* bits,
+                          const Block128& b, std::size_t n);
+
 // XXX this should be a class due to its many functions (see
 // https://google.github.io/styleguide/cppguide.html#Structs_vs._Classes).
 /// \brief Vector of 128 bit / 16 B blocks.
 struct Block128Vector {
   static constexpr std::size_t kBlockAlignment = kAlignment;
-  using Allocator = boost::alignment::aligned_allocator<Block128, kBlockAlignment>;
+  using Allocator = PooledAlignedAllocator<Block128, kBlockAlignment>;
   using Container = std::vector<Block128, Allocator>;
 
   // create an empty vector
@@ -286,13 +306,9 @@ struct Block128Vector {
   ///        and the Block128 in a different one of same size.
   /// \param other
   /// \pre \p other is has the same size as this Block128Vector.
-  Block128Vector& operator^=(const Block128Vector& __restrict__ other) {
+  Block128Vector& operator^=(const Block128Vector& other) {
     assert(size() == other.size());
-    auto k0 = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(block_vector.data(), kBlockAlignment));
-    auto k1 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(other.block_vector.data(), kBlockAlignment));
-    std::transform(k0, k0 + 16 * size(), k1, k0, [](auto a, auto b) { return a ^ b; });
+    XorBlocks(data(), data(), other.data(), size());
     return *this;
   }
 
@@ -300,19 +316,57 @@ struct Block128Vector {
   ///        and the Block128 in a different one of same size.
   /// \param other
   /// \pre \p other is has the same size as this Block128Vector.
-  Block128Vector operator^(const Block128Vector& __restrict__ other) const {
+  Block128Vector operator^(const Block128Vector& other) const {
     assert(size() == other.size());
     Block128Vector result(size());
-    auto k0 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(block_vector.data(), kBlockAlignment));
-    auto k1 = reinterpret_cast<const std::byte* __restrict__>(
-        __builtin_assume_aligned(other.block_vector.data(), kBlockAlignment));
-    auto kout = reinterpret_cast<std::byte* __restrict__>(
-        __builtin_assume_aligned(result.block_vector.data(), kBlockAlignment));
-    std::transform(k0, k0 + 16 * size(), k1, kout, [](auto a, auto b) { return a ^ b; });
+    XorBlocks(result.data(), data(), other.data(), size());
     return result;
   }
 
+  /// \brief Perform a XOR-assign operation between all the Block128 in this vector and \p block.
+  /// \param block
+  Block128Vector& operator^=(const Block128& block) {
+    XorBlocks(data(), data(), block, size());
+    return *this;
+  }
+
+  /// \brief Perform a XOR operation between all the Block128 in this vector and \p block.
+  /// \param block
+  Block128Vector operator^(const Block128& block) const {
+    Block128Vector result(size());
+    XorBlocks(result.data(), data(), block, size());
+    return result;
+  }
+
+  /// \brief Perform an AND-assign operation between all the Block128 in this vector
+  ///        and the Block128 in a different one of same size.
+  /// \param other
+  /// \pre \p other is has the same size as this Block128Vector.
+  Block128Vector& operator&=(const Block128Vector& other) {
+    assert(size() == other.size());
+    AndBlocks(data(), data(), other.data(), size());
+    return *this;
+  }
+
+  /// \brief Perform an AND operation between all the Block128 in this vector
+  ///        and the Block128 in a different one of same size.
+  /// \param other
+  /// \pre \p other is has the same size as this Block128Vector.
+  Block128Vector operator&(const Block128Vector& other) const {
+    assert(size() == other.size());
+    Block128Vector result(size());
+    AndBlocks(result.data(), data(), other.data(), size());
+    return result;
+  }
+
+  /// \brief XORs \p block onto the i-th Block128 in this vector if the i-th bit of \p bits is set,
+  ///        e.g., to select the free-XOR keys K_i ^ bits_i * offset.
+  /// \param bits Bits in the layout of BitVector, i.e., bit i is bit i % 8 of byte i / 8.
+  /// \param block
+  void ConditionalXor(const std::byte* bits, const Block128& block) {
+    ConditionalXorBlocks(data(), data(), bits, block, size());
+  }
+
   /// \brief Access Block128 at \p index. Undefined behaviour if index is out of bounds.
   /// \param index
   Block128& operator[](std::size_t index) { return block_vector[index]; };
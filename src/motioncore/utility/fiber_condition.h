@@ -28,6 +28,8 @@
 #include <boost/fiber/mutex.hpp>
 #include <functional>
 
+#include "statistics/trace.h"
+
 namespace encrypto::motion {
 
 /// \brief Wraps a boost::fibers::condition_variable with a boost::fibers::mutex
@@ -50,11 +52,32 @@ class FiberCondition {
   // }
 
   /// \brief Blocks until fiber is notified and condition_function_ returns true.
+  ///        Waits that actually block are recorded in the Tracer if it is enabled.
   void Wait() const {
     std::unique_lock<decltype(mutex_)> lock(mutex_);
+    if (Tracer::IsEnabled() && !condition_function_()) {
+      const auto start{Tracer::ClockType::now()};
+      condition_variable_.wait(lock, condition_function_);
+      Tracer::Get().RecordFiberWait(start, Tracer::ClockType::now());
+      return;
+    }
     condition_variable_.wait(lock, condition_function_);
   }
 
+  /// \brief Blocks until fiber is notified and \p predicate returns true, for waiters that wait
+  ///        for different states of the variables guarded by the mutex.
+  template <typename Predicate>
+  void WaitUntil(Predicate predicate) const {
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    if (Tracer::IsEnabled() && !predicate()) {
+      const auto start{Tracer::ClockType::now()};
+      condition_variable_.wait(lock, predicate);
+      Tracer::Get().RecordFiberWait(start, Tracer::ClockType::now());
+      return;
+    }
+    condition_variable_.wait(lock, predicate);
+  }
+
   /// \brief Blocks until fiber is notified and condition_function_ returns true
   ///        or \p duration time has passed.
   template <typename Tick, typename Period>
@@ -42,11 +42,16 @@
 namespace encrypto::motion {
 
 FiberThreadPool::FiberThreadPool(std::size_t number_of_workers, std::size_t number_of_tasks,
-                                 bool suspend_scheduler)
+                                 bool suspend_scheduler, std::vector<std::size_t> cpus,
+                                 bool numa_aware_stealing, std::size_t stack_size)
     : number_of_workers_(number_of_workers > 0 ? number_of_workers
                          : std::thread::hardware_concurrency()),
       running_(false),
       suspend_scheduler_(suspend_scheduler),
+      cpus_(std::move(cpus)),
+      numa_aware_stealing_(numa_aware_stealing && !cpus_.empty()),
+      stack_size_(stack_size > 0 ? stack_size : kFiberStackSize),
+      number_of_pending_tasks_(0),
       task_queue_(std::make_unique<boost::fibers::buffered_channel<task_t>>(64)),
       worker_barrier_(std::make_unique<boost::fibers::barrier>(number_of_workers_)) {
     if (number_of_workers_ == 1) {
@@ -55,6 +60,22 @@ FiberThreadPool::FiberThreadPool(std::size_t number_of_workers, std::size_t numb
 
     (void)number_of_tasks;
 
+    if (kFiberStackAllocator == FiberStackAllocator::kPooledFixedSize &&
+        stack_size_ != kFiberStackSize) {
+        throw std::invalid_argument(
+            fmt::format("The pooled fiber stack allocator only supports stacks of {} B",
+                        kFiberStackSize));
+    }
+
+    // check the CPUs before any worker is started, since the workers wait for
+    // each other and cannot be stopped once some of them are started
+    for (auto cpu : cpus_) {
+        if (!IsCpuAvailable(cpu)) {
+            throw std::invalid_argument(
+                fmt::format("FiberThreadPool cannot pin a worker to unavailable CPU {}", cpu));
+        }
+    }
+
     // create the worker threads
     create_threads();
 }
@@ -69,7 +90,8 @@ FiberThreadPool::~FiberThreadPool() {
 template <typename StackAllocator>
 static void worker_fctn(std::shared_ptr<pool_ctx> pool_ctx,
                         boost::fibers::buffered_channel<FiberThreadPool::task_t>& task_queue,
-                        boost::fibers::barrier& barrier) {
+                        boost::fibers::barrier& barrier, std::uint32_t numa_node,
+                        std::size_t stack_size) {
     LockedFiberQueue<boost::fibers::fiber> cleanup_channel;
 
     // start cleanup thread for joining the created fibers
@@ -80,13 +102,13 @@ static void worker_fctn(std::shared_ptr<pool_ctx> pool_ctx,
     });
 
     // register this thread with the pool
-    boost::fibers::use_scheduling_algorithm<pooled_work_stealing>(pool_ctx);
+    boost::fibers::use_scheduling_algorithm<pooled_work_stealing>(pool_ctx, numa_node);
 
     FiberThreadPool::task_t task;
 
     // allocator the the fibers' stacks
     StackAllocator stack_allocator(
-        std::max(kFiberStackSize, StackAllocator::traits_type::minimum_size()));
+        std::max(stack_size, StackAllocator::traits_type::minimum_size()));
 
     // try to get new tasks from the queue until the channel is closed and empty,
     // which is the signal to therminate the pool
@@ -109,7 +131,8 @@ void FiberThreadPool::create_threads() {
 
     // create a pool context which is used to coordinate the worker threads'
     // schedulers
-    pool_ctx_ = pooled_work_stealing::create_pool_ctx(number_of_workers_, suspend_scheduler_);
+    pool_ctx_ = pooled_work_stealing::create_pool_ctx(number_of_workers_, suspend_scheduler_,
+                                                      numa_aware_stealing_);
 
     std::function<decltype(worker_fctn<boost::context::fixedsize_stack>)> worker_function;
     switch (kFiberStackAllocator) {
@@ -127,8 +150,17 @@ void FiberThreadPool::create_threads() {
     // create the worker threads
     worker_threads_.reserve(number_of_workers_);
     for (std::size_t i = 0; i < number_of_workers_; ++i) {
+        std::uint32_t numa_node = 0;
+        if (numa_aware_stealing_) {
+            numa_node = static_cast<std::uint32_t>(GetNumaNodeOfCpu(cpus_[i % cpus_.size()]));
+        }
         auto& t = worker_threads_.emplace_back(worker_function, pool_ctx_, std::ref(*task_queue_),
-                                               std::ref(*worker_barrier_));
+                                               std::ref(*worker_barrier_), numa_node,
+                                               stack_size_);
+
+        if (!cpus_.empty()) {
+            ThreadSetAffinity(t, cpus_[i % cpus_.size()]);
+        }
 
         if constexpr (kDebug) {
             ThreadSetName(t, fmt::format("pool-worker-{}", i));
@@ -147,7 +179,51 @@ void FiberThreadPool::join() {
 
 void FiberThreadPool::post(std::function<void()> fctn) {
     assert(running_);
-    task_queue_->push(fctn);
+    {
+        std::scoped_lock lock(pending_tasks_mutex_);
+        ++number_of_pending_tasks_;
+    }
+    task_queue_->push([this, fctn = std::move(fctn)] {
+        fctn();
+        std::scoped_lock lock(pending_tasks_mutex_);
+        if (--number_of_pending_tasks_ == 0) {
+            pending_tasks_condition_.notify_all();
+        }
+    });
+}
+
+std::size_t FiberThreadPool::get_number_of_pending_tasks() {
+    std::scoped_lock lock(pending_tasks_mutex_);
+    return number_of_pending_tasks_;
+}
+
+void FiberThreadPool::wait_idle() {
+    std::unique_lock lock(pending_tasks_mutex_);
+    pending_tasks_condition_.wait(lock, [this] { return number_of_pending_tasks_ == 0; });
+}
+
+void FiberTaskGroup::post(FiberThreadPool::task_t task) {
+    {
+        std::scoped_lock lock(pending_tasks_mutex_);
+        ++number_of_pending_tasks_;
+    }
+    pool_.post([this, task = std::move(task)] {
+        task();
+        std::scoped_lock lock(pending_tasks_mutex_);
+        if (--number_of_pending_tasks_ == 0) {
+            pending_tasks_condition_.notify_all();
+        }
+    });
+}
+
+std::size_t FiberTaskGroup::get_number_of_pending_tasks() {
+    std::scoped_lock lock(pending_tasks_mutex_);
+    return number_of_pending_tasks_;
+}
+
+void FiberTaskGroup::wait_idle() {
+    std::unique_lock lock(pending_tasks_mutex_);
+    pending_tasks_condition_.wait(lock, [this] { return number_of_pending_tasks_ == 0; });
 }
 
 }  // namespace encrypto::motion
@@ -21,8 +21,10 @@
 #ifndef FIBER_THREAD_POOL_HPP
 #define FIBER_THREAD_POOL_HPP
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -50,8 +52,17 @@ public:
     //   number of tasks that are to be expected
     // - suspend_scheduler
     //   suspend if there is no work to be done
+    // - cpus
+    //   logical CPUs the workers are pinned to in round-robin order,
+    //   if empty then the workers are not pinned
+    // - numa_aware_stealing
+    //   idle workers steal from workers on the same NUMA node first,
+    //   only takes effect if the workers are pinned
+    // - stack_size
+    //   size of the fibers' stacks, if 0 then kFiberStackSize is used
     FiberThreadPool(std::size_t number_of_workers, std::size_t number_of_tasks = 0,
-                    bool suspend_scheduler = true);
+                    bool suspend_scheduler = true, std::vector<std::size_t> cpus = {},
+                    bool numa_aware_stealing = false, std::size_t stack_size = 0);
 
     // Destructor, calls join() if necessary
     ~FiberThreadPool();
@@ -60,6 +71,10 @@ public:
     // This may block if the task queue is currently full
     void post(task_t task);
 
+    // Block until all tasks posted so far have been completed, s.t. the pool
+    // can be reused for further tasks.  Must not be called from a task.
+    void wait_idle();
+
     // Close the pool.  No new tasks can be posted to the pool.
     // Note: Be sure that all previously posted tasks has been completed before
     // you call this method.
@@ -69,18 +84,58 @@ public:
     // No new fibers must be created during this call.
     void join_fibers();
 
+    std::size_t get_number_of_workers() const noexcept { return number_of_workers_; }
+
+    // Number of tasks that were posted and have not completed yet, which
+    // includes the tasks of fibers that are blocked.
+    std::size_t get_number_of_pending_tasks();
+
 private:
     void create_threads();
 
     std::size_t number_of_workers_;
     bool running_;
     bool suspend_scheduler_;
+    std::vector<std::size_t> cpus_;
+    bool numa_aware_stealing_;
+    std::size_t stack_size_;
+    std::size_t number_of_pending_tasks_;
+    std::mutex pending_tasks_mutex_;
+    std::condition_variable pending_tasks_condition_;
     std::unique_ptr<boost::fibers::buffered_channel<task_t>> task_queue_;
     std::unique_ptr<boost::fibers::barrier> worker_barrier_;
     std::vector<std::thread> worker_threads_;
     std::shared_ptr<pool_ctx> pool_ctx_;
 };
 
+// Tasks posted to a FiberThreadPool which can be waited for independently of
+// the other tasks of the pool, e.g., the gates of one of several parties that
+// share the pool in a simulation.
+class FiberTaskGroup {
+public:
+    explicit FiberTaskGroup(FiberThreadPool& pool) noexcept : pool_(pool) {}
+
+    // Post a new task of the group to the pool, see FiberThreadPool::post
+    void post(FiberThreadPool::task_t task);
+
+    // Block until all tasks of the group posted so far have been completed.
+    // Must not be called from a task.
+    void wait_idle();
+
+    FiberThreadPool& get_pool() noexcept { return pool_; }
+
+    std::size_t get_number_of_workers() const noexcept { return pool_.get_number_of_workers(); }
+
+    // Number of tasks of the group that were posted and have not completed yet
+    std::size_t get_number_of_pending_tasks();
+
+private:
+    FiberThreadPool& pool_;
+    std::size_t number_of_pending_tasks_ = 0;
+    std::mutex pending_tasks_mutex_;
+    std::condition_variable pending_tasks_condition_;
+};
+
 }  // namespace encrypto::motion
 
 #endif  // FIBER_THREAD_POOL_HPP
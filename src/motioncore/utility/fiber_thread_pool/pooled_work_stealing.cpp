@@ -19,34 +19,52 @@
 // clang-format off
 
 struct pool_ctx {
-    pool_ctx(std::uint32_t thread_count, bool suspend)
+    pool_ctx(std::uint32_t thread_count, bool suspend, bool numa_aware)
         : thread_count_(thread_count),
           suspend_(suspend),
+          numa_aware_(numa_aware),
           counter_(0),
           schedulers_(thread_count, nullptr),
+          numa_nodes_(thread_count, 0),
           barrier_(thread_count) {
         BOOST_ASSERT(thread_count > 1);
     }
     const std::uint32_t thread_count_;
     const bool suspend_;
+    const bool numa_aware_;
     std::atomic<std::uint32_t> counter_;
     std::vector<pooled_work_stealing*> schedulers_;
+    std::vector<std::uint32_t> numa_nodes_;
     boost::barrier barrier_;
 };
 
 std::shared_ptr<pool_ctx> pooled_work_stealing::create_pool_ctx(std::uint32_t thread_count,
-        bool suspend) {
-    auto ctx = std::make_shared<pool_ctx>(thread_count, suspend);
+        bool suspend, bool numa_aware) {
+    auto ctx = std::make_shared<pool_ctx>(thread_count, suspend, numa_aware);
     return ctx;
 }
 
-pooled_work_stealing::pooled_work_stealing(std::shared_ptr<pool_ctx> pool_ctx)
+pooled_work_stealing::pooled_work_stealing(std::shared_ptr<pool_ctx> pool_ctx,
+        std::uint32_t numa_node)
     : pool_ctx_{pool_ctx},
       id_{pool_ctx_->counter_++},
       thread_count_{pool_ctx_->thread_count_},
       suspend_{pool_ctx_->suspend_} {
     pool_ctx_->schedulers_[id_] = this;
+    pool_ctx_->numa_nodes_[id_] = numa_node;
     pool_ctx_->barrier_.wait();
+    // all schedulers are registered after the barrier
+    if (pool_ctx_->numa_aware_) {
+        for (std::uint32_t id = 0; id < thread_count_; ++id) {
+            if (id != id_ && pool_ctx_->numa_nodes_[id] == numa_node) {
+                local_ids_.push_back(id);
+            }
+        }
+        // no distinction if all schedulers are on this node
+        if (local_ids_.size() + 1 == thread_count_) {
+            local_ids_.clear();
+        }
+    }
 }
 
 pooled_work_stealing::~pooled_work_stealing() {
@@ -71,6 +89,23 @@ boost::fibers::context* pooled_work_stealing::pick_next() noexcept {
         }
     }
     else {
+        // try the schedulers of the local NUMA node first to keep the data of
+        // the stolen fibers close to their memory
+        if (!local_ids_.empty()) {
+            static thread_local std::minstd_rand local_generator{std::random_device{}()};
+            std::uniform_int_distribution<std::size_t> local_distribution{
+                0, local_ids_.size() - 1};
+            for (std::size_t i = 0; nullptr == victim && i < local_ids_.size(); ++i) {
+                victim = pool_ctx_->schedulers_[local_ids_[local_distribution(local_generator)]]
+                             ->steal();
+            }
+            if (nullptr != victim) {
+                boost::context::detail::prefetch_range(victim, sizeof(boost::fibers::context));
+                BOOST_ASSERT(!victim->is_context(boost::fibers::type::pinned_context));
+                boost::fibers::context::active()->attach(victim);
+                return victim;
+            }
+        }
         std::uint32_t id = 0;
         std::size_t count = 0, size = pool_ctx_->schedulers_.size();
         static thread_local std::minstd_rand generator{std::random_device{}()};
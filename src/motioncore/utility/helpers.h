@@ -31,6 +31,7 @@
 #include <cassert>
 #include <concepts>
 #include <cstdint>
+#include <exception>
 #include <random>
 #include <span>
 #include <string>
@@ -43,6 +44,28 @@
 
 namespace encrypto::motion {
 
+/// \brief Runs \p function(i) for i in [0, \p n) on \p number_of_threads OpenMP threads and
+/// rethrows the first exception thrown by \p function after all iterations finished.
+/// Without OpenMP, the iterations run sequentially.
+template <typename Function>
+void ParallelFor(std::size_t n, std::size_t number_of_threads, Function function) {
+  std::exception_ptr exception;
+#pragma omp parallel for num_threads(static_cast<int>(std::max<std::size_t>(number_of_threads, 1)))
+  for (std::size_t i = 0; i < n; ++i) {
+    try {
+      function(i);
+    } catch (...) {
+#pragma omp critical
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
 /// \brief Returns a vector of \p length random unsigned integral values.
 /// \tparam UnsignedIntegralType
 /// \param length
@@ -75,8 +98,86 @@ inline std::vector<UnsignedIntegralType> FromByteVector(std::span<const std::uin
   return result;
 }
 
+// The following kernels write to an output parameter instead of allocating a new vector. The
+// output may be one of the inputs to compute in place, but must not overlap them otherwise, s.t.
+// the loops are vectorized with the instruction set selected by MOTION_USE_AVX.
+
+/// \brief Writes a[i] + b[i] to \p output[i].
+/// \pre \p a, \p b and \p output must be of equal size.
+template <typename T>
+inline void AddVectors(std::span<const T> a, std::span<const T> b, std::span<T> output) {
+  assert(a.size() == b.size() && a.size() == output.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* output_pointer{output.data()};
+#pragma omp simd
+  for (std::size_t i = 0; i < output.size(); ++i) output_pointer[i] = a_pointer[i] + b_pointer[i];
+}
+
+/// \brief Writes a[i] - b[i] to \p output[i].
+/// \pre \p a, \p b and \p output must be of equal size.
+template <typename T>
+inline void SubVectors(std::span<const T> a, std::span<const T> b, std::span<T> output) {
+  assert(a.size() == b.size() && a.size() == output.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* output_pointer{output.data()};
+#pragma omp simd
+  for (std::size_t i = 0; i < output.size(); ++i) output_pointer[i] = a_pointer[i] - b_pointer[i];
+}
+
+/// \brief Writes a[i] * b[i] to \p output[i].
+/// \pre \p a, \p b and \p output must be of equal size.
+template <typename T>
+inline void MultiplyVectors(std::span<const T> a, std::span<const T> b, std::span<T> output) {
+  assert(a.size() == b.size() && a.size() == output.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  T* output_pointer{output.data()};
+#pragma omp simd
+  for (std::size_t i = 0; i < output.size(); ++i) output_pointer[i] = a_pointer[i] * b_pointer[i];
+}
+
+/// \brief Writes c[i] + a[i] * b[i] to \p output[i].
+/// \pre \p a, \p b, \p c and \p output must be of equal size.
+template <typename T>
+inline void MultiplyAddVectors(std::span<const T> a, std::span<const T> b, std::span<const T> c,
+                               std::span<T> output) {
+  assert(a.size() == b.size() && a.size() == c.size() && a.size() == output.size());
+  const T* a_pointer{a.data()};
+  const T* b_pointer{b.data()};
+  const T* c_pointer{c.data()};
+  T* output_pointer{output.data()};
+#pragma omp simd
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    output_pointer[i] = c_pointer[i] + a_pointer[i] * b_pointer[i];
+  }
+}
+
+/// \brief Writes c[i] + a0[i] * b0[i] + a1[i] * b1[i] to \p output[i], e.g., to recombine the
+/// product of two shares from a multiplication triple in one pass.
+/// \pre All spans must be of equal size.
+template <typename T>
+inline void MultiplyAddVectors(std::span<const T> a0, std::span<const T> b0,
+                               std::span<const T> a1, std::span<const T> b1,
+                               std::span<const T> c, std::span<T> output) {
+  assert(a0.size() == b0.size() && a0.size() == a1.size() && a0.size() == b1.size());
+  assert(a0.size() == c.size() && a0.size() == output.size());
+  const T* a0_pointer{a0.data()};
+  const T* b0_pointer{b0.data()};
+  const T* a1_pointer{a1.data()};
+  const T* b1_pointer{b1.data()};
+  const T* c_pointer{c.data()};
+  T* output_pointer{output.data()};
+#pragma omp simd
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    output_pointer[i] =
+        c_pointer[i] + a0_pointer[i] * b0_pointer[i] + a1_pointer[i] * b1_pointer[i];
+  }
+}
+
 /// \brief Adds each element in \p a and \p b and returns the result.
-/// \tparam T type of the elements in the vectors. T must provide the += operator.
+/// \tparam T type of the elements in the vectors. T must provide the binary + operator.
 /// \param a
 /// \param b
 /// \return A vector containing at position i the sum the ith element in a and b.
@@ -87,16 +188,13 @@ inline std::vector<T> AddVectors(std::span<const T> a, std::span<const T> b) {
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-#pragma omp simd
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] += b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  AddVectors<T>(a, b, result);
   return result;
 }
 
 /// \brief Subtracts each element in \p a and \p b and returns the result.
-/// \tparam T type of the elements in the vectors. T must provide the -= operator.
+/// \tparam T type of the elements in the vectors. T must provide the binary - operator.
 /// \param a
 /// \param b
 /// \return A vector containing at position i the difference the ith element in a and b.
@@ -107,15 +205,13 @@ inline std::vector<T> SubVectors(std::span<const T> a, std::span<const T> b) {
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] -= b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  SubVectors<T>(a, b, result);
   return result;
 }
 
 /// \brief Multiplies each element in \p a and \p b and returns the result.
-/// \tparam T type of the elements in the vectors. T must provide the *= operator.
+/// \tparam T type of the elements in the vectors. T must provide the binary * operator.
 /// \param a
 /// \param b
 /// \return A vector containing at position i the product the ith element in a and b.
@@ -126,16 +222,13 @@ inline std::vector<T> MultiplyVectors(std::span<const T> a, std::span<const T> b
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result(a.begin(), a.end());
-
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result[j] *= b[j];  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  MultiplyVectors<T>(a, b, result);
   return result;
 }
 
 /// \brief Performs the AddVectors operation on an arbitrary number of vectors.
-/// \tparam T type of the elements in the vectors. T must provide the += operator.
+/// \tparam T type of the elements in the vectors. T must provide the binary + operator.
 /// \param vectors A vector of vectors.
 /// \return A vector containing at position i the sum of each element
 ///         at position i of the input vectors.
@@ -151,9 +244,7 @@ inline std::vector<T> AddVectors(std::span<const std::vector<T>> vectors) {
   for (auto i = 1ull; i < vectors.size(); ++i) {
     auto& inner_vector = vectors[i];
     assert(inner_vector.size() == result.size());  // expect the vectors to be of the same size
-    for (auto j = 0ull; j < result.size(); ++j) {
-      result[j] += inner_vector[j];  // TODO: implement using AVX2 and AVX512
-    }
+    AddVectors<T>(result, inner_vector, result);
   }
   return result;
 }
@@ -303,17 +394,16 @@ inline std::vector<T> RowSumReduction(std::span<const std::vector<T>> values) {
   if (values.size() == 0) {
     return {};
   } else {
-    std::vector<T> sum(values[0].size());
+    std::vector<T> sum(values[0]);
     for (auto i = 1ull; i < values.size(); ++i) {
       assert(values[0].size() == values[i].size());
     }
 
-    for (auto i = 0ull; i < sum.size(); ++i) {
-      for (auto j = 0ull; j < values.size(); ++j) {
-        sum[i] += values[j][i];
-      }
+    // row by row, s.t. the additions are vectorized
+    for (auto j = 1ull; j < values.size(); ++j) {
+      AddVectors<T>(sum, values[j], sum);
     }
-    return std::move(sum);
+    return sum;
   }
 }
 
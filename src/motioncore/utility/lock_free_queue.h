@@ -0,0 +1,280 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+namespace encrypto::motion {
+
+/**
+ * Closable multi-producer single-consumer queue for elements of type T.
+ *
+ * The queue has the same interface as BasicSynchronizedQueue, but producers do not take a lock:
+ * an element is linked into an intrusive list with a single atomic exchange (Vyukov's MPSC
+ * queue).  The mutex and condition variable are only used if the consumer has to block, i.e.,
+ * producers pay for a notification only if the consumer announced that it waits.  Any number of
+ * threads or fibers may enqueue, but only one may dequeue at a time.
+ */
+template <typename T, typename MutexType, typename ConditionVariableType>
+class BasicLockFreeQueue {
+ public:
+  BasicLockFreeQueue() = default;
+  BasicLockFreeQueue(const BasicLockFreeQueue&) = delete;
+  BasicLockFreeQueue& operator=(const BasicLockFreeQueue&) = delete;
+
+  ~BasicLockFreeQueue() {
+    while (Node* node = Pop()) {
+      delete node;
+    }
+  }
+
+  /**
+   * Check if queue is empty.
+   */
+  bool empty() const noexcept { return size_.load(std::memory_order_acquire) == 0; }
+
+  /**
+   * Number of elements in the queue.
+   */
+  std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+  /**
+   * Check if queue is closed.
+   */
+  bool IsClosed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+  /**
+   * Check if queue is closed and empty.
+   */
+  bool IsClosedAndEmpty() const noexcept { return IsClosed() && empty(); }
+
+  /**
+   * Close the queue.
+   */
+  void close() noexcept {
+    closed_.store(true, std::memory_order_seq_cst);
+    std::scoped_lock lock(mutex_);
+    condition_variable_.notify_all();
+  }
+
+  /**
+   * Add a new element to the queue.
+   */
+  void enqueue(const T& item) { Push(new Node(item)); }
+
+  void enqueue(T&& item) { Push(new Node(std::move(item))); }
+
+  /**
+   * Extract an element from the queue.
+   */
+  std::optional<T> dequeue() noexcept {
+    while (true) {
+      if (Node* node = Pop()) {
+        std::optional<T> item(std::move(node->value));
+        delete node;
+        return item;
+      }
+      if (!Wait()) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  /**
+   * Extract all elements of the queue.
+   */
+  std::optional<std::queue<T>> BatchDequeue() noexcept {
+    while (true) {
+      auto output = TryBatchDequeue();
+      if (!output.empty()) {
+        return std::optional<std::queue<T>>(std::move(output));
+      }
+      if (!Wait()) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  /**
+   * Extract all elements of the queue without waiting, i.e., the result is empty if the queue is.
+   */
+  std::queue<T> TryBatchDequeue() noexcept {
+    std::queue<T> output;
+    while (Node* node = Pop()) {
+      output.push(std::move(node->value));
+      delete node;
+    }
+    return output;
+  }
+
+  /**
+   * Extract all elements of the queue, waiting for elements at most until the deadline, i.e., the
+   * result is empty if the queue stayed empty until then or is closed.
+   */
+  template <typename Clock, typename Duration>
+  std::queue<T> TryBatchDequeueUntil(
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    while (true) {
+      auto output = TryBatchDequeue();
+      if (!output.empty() || !WaitUntil(deadline)) {
+        return output;
+      }
+    }
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    template <typename Argument>
+    explicit Node(Argument&& argument) : value(std::forward<Argument>(argument)) {}
+
+    std::atomic<Node*> next = nullptr;
+    T value{};
+  };
+
+  // the list always contains at least the stub node, s.t. producers never see an empty list
+  Node stub_;
+  // producers append at the head
+  std::atomic<Node*> head_ = &stub_;
+  // the consumer removes at the tail, only the consumer accesses it
+  Node* tail_ = &stub_;
+
+  std::atomic<std::size_t> size_ = 0;
+  std::atomic<bool> closed_ = false;
+  // set while the consumer blocks on the condition variable
+  std::atomic<bool> waiting_ = false;
+  MutexType mutex_;
+  ConditionVariableType condition_variable_;
+
+  void Push(Node* node) {
+    if (closed_.load(std::memory_order_acquire)) {
+      delete node;
+      throw std::logic_error("Tried to enqueue in closed BasicLockFreeQueue");
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    Link(node);
+    // pairs with the fence in Wait, either we see the waiting consumer or it sees the element
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+      std::scoped_lock lock(mutex_);
+      condition_variable_.notify_one();
+    }
+  }
+
+  void Link(Node* node) noexcept {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  // removes the oldest element, returns nullptr if the queue is empty or the oldest producer has
+  // not finished linking its element yet
+  Node* Pop() noexcept {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next == nullptr) {
+      if (tail != head_.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      // tail is the last element, put the stub behind it to be able to unlink it
+      Link(&stub_);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        return nullptr;
+      }
+    }
+    tail_ = next;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return tail;
+  }
+
+  // true if Pop will find an element as soon as the producers finished linking
+  bool HasElement() const noexcept {
+    return tail_ != &stub_ || stub_.next.load(std::memory_order_acquire) != nullptr;
+  }
+
+  // blocks until there is an element or the queue is closed, returns false if the queue is closed
+  // and there are no elements left
+  bool Wait() noexcept {
+    if (HasElement()) {
+      // a producer is in the middle of linking, the element becomes visible in a moment
+      return true;
+    }
+    if (IsClosed()) {
+      return false;
+    }
+    std::unique_lock lock(mutex_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    condition_variable_.wait(lock, [this] { return HasElement() || IsClosed(); });
+    waiting_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+
+  // as Wait, but also returns false if there is no element at the deadline
+  template <typename Clock, typename Duration>
+  bool WaitUntil(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    if (HasElement()) {
+      return true;
+    }
+    if (IsClosed()) {
+      return false;
+    }
+    std::unique_lock lock(mutex_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool woken = condition_variable_.wait_until(
+        lock, deadline, [this] { return HasElement() || IsClosed(); });
+    waiting_.store(false, std::memory_order_relaxed);
+    return woken && HasElement();
+  }
+};
+
+template <typename T>
+using LockFreeQueue = BasicLockFreeQueue<T, std::mutex, std::condition_variable>;
+
+template <typename T>
+using LockFreeFiberQueue =
+    BasicLockFreeQueue<T, boost::fibers::mutex, boost::fibers::condition_variable>;
+
+}  // namespace encrypto::motion
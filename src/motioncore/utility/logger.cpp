@@ -37,6 +37,7 @@
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/console.hpp>
 #include <boost/log/utility/setup/file.hpp>
+#include <boost/make_shared.hpp>
 
 #include <fmt/format.h>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -69,20 +70,21 @@ Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_l
   stream << std::put_time(localtime_r(&time, &temporary_time), "%Y.%m.%d--%H-%M-%S");
   const auto filename = fmt::format("log/id{}_{}_%N.log", my_id_, stream.str());
 
-  std::lock_guard<std::mutex> lock(boost_log_core_mutex_);
-  g_file_sink_ = logging::add_file_log(
-      keywords::file_name = filename,
-      keywords::format =
-          (expr::stream << expr::format_date_time<boost::posix_time::ptime>("TimeStamp",
-                                                                            "%Y-%m-%d %H:%M:%S.%f")
-                        << ": <" << logging::trivial::severity << "> " << expr::smessage),
-      keywords::filter = id_channel == my_id_, keywords::auto_flush = kAutoFlush,
+  auto backend = boost::make_shared<sinks::text_file_backend>(
+      keywords::file_name = filename, keywords::auto_flush = kAutoFlush,
       keywords::open_mode = std::ios_base::app | std::ios_base::out,
       keywords::rotation_size = 100 * kMb);
+  // the records are written by the dedicated thread of the asynchronous sink
+  g_file_sink_ = boost::make_shared<SinkType>(std::move(backend));
+  g_file_sink_->set_formatter(
+      expr::stream << expr::format_date_time<boost::posix_time::ptime>("TimeStamp",
+                                                                       "%Y-%m-%d %H:%M:%S.%f")
+                   << ": <" << logging::trivial::severity << "> " << expr::smessage);
+  // the severity level is filtered by the sink such that it only applies to this Logger
+  g_file_sink_->set_filter(id_channel == my_id_ && logging::trivial::severity >= severity_level);
 
-  // FIXME: set this filter for the sinks, otherwise its level is changed for
-  // all Logger instances
-  logging::core::get()->set_filter(logging::trivial::severity >= severity_level);
+  std::lock_guard<std::mutex> lock(boost_log_core_mutex_);
+  logging::core::get()->add_sink(g_file_sink_);
   logging::add_common_attributes();
   logger_ = std::make_unique<LoggerType>(keywords::channel = my_id);
 }
@@ -90,85 +92,22 @@ Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_l
 Logger::~Logger() {
   std::lock_guard<std::mutex> lock(boost_log_core_mutex_);
   logging::core::get()->remove_sink(g_file_sink_);
+  // write the queued records before the sink is destroyed
+  g_file_sink_->stop();
+  g_file_sink_->flush();
   g_file_sink_.reset();
 }
 
 void Logger::Log(logging::trivial::severity_level severity_level, const std::string& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, severity_level) << message;
-  }
+  if (logging_enabled_) Write(severity_level, message);
 }
 
 void Logger::Log(logging::trivial::severity_level severity_level, std::string&& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, severity_level) << message;
-  }
+  if (logging_enabled_) Write(severity_level, message);
 }
 
-void Logger::LogTrace(const std::string& message) {
-  if constexpr (kDebug && kVerboseDebug) {
-    if (logging_enabled_) {
-      std::scoped_lock<std::mutex> lock(write_mutex_);
-      BOOST_LOG_SEV(*logger_, logging::trivial::trace) << message;
-    }
-  }
-}
-
-void Logger::LogTrace(std::string&& message) {
-  if constexpr (kDebug && kVerboseDebug) {
-    if (logging_enabled_) {
-      std::scoped_lock<std::mutex> lock(write_mutex_);
-      BOOST_LOG_SEV(*logger_, logging::trivial::trace) << message;
-    }
-  }
-}
-
-void Logger::LogInfo(const std::string& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, logging::trivial::info) << message;
-  }
-}
-
-void Logger::LogInfo(std::string&& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, logging::trivial::info) << message;
-  }
-}
-
-void Logger::LogDebug(const std::string& message) {
-  if constexpr (kDebug) {
-    if (logging_enabled_) {
-      std::scoped_lock<std::mutex> lock(write_mutex_);
-      BOOST_LOG_SEV(*logger_, logging::trivial::debug) << message;
-    }
-  }
-}
-
-void Logger::LogDebug(std::string&& message) {
-  if constexpr (kDebug) {
-    if (logging_enabled_) {
-      std::scoped_lock<std::mutex> lock(write_mutex_);
-      BOOST_LOG_SEV(*logger_, logging::trivial::debug) << message;
-    }
-  }
-}
-
-void Logger::LogError(const std::string& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, logging::trivial::error) << message;
-  }
-}
-
-void Logger::LogError(std::string&& message) {
-  if (logging_enabled_) {
-    std::scoped_lock<std::mutex> lock(write_mutex_);
-    BOOST_LOG_SEV(*logger_, logging::trivial::error) << message;
-  }
+void Logger::Write(logging::trivial::severity_level severity_level, const std::string& message) {
+  BOOST_LOG_SEV(*logger_, severity_level) << message;
 }
 
 void Logger::SetEnabled(bool enable) {
@@ -177,4 +116,6 @@ void Logger::SetEnabled(bool enable) {
   boost::log::core::get()->set_logging_enabled(enable);
 }
 
+void Logger::Flush() { g_file_sink_->flush(); }
+
 }  // namespace encrypto::motion
@@ -25,18 +25,39 @@
 #pragma once
 
 #include <atomic>
-#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/unbounded_fifo_queue.hpp>
 #include <boost/log/sources/severity_channel_logger.hpp>
 #include <boost/log/trivial.hpp>
 #include <memory>
 #include <mutex>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "utility/constants.h"
 
 namespace encrypto::motion {
 
 using LoggerType =
-    boost::log::sources::severity_channel_logger<boost::log::trivial::severity_level, std::size_t>;
-
+    boost::log::sources::severity_channel_logger_mt<boost::log::trivial::severity_level,
+                                                    std::size_t>;
+
+/// \brief Lowest severity level that is compiled into MOTION, i.e., trace messages are only
+///        compiled with kVerboseDebug and debug messages only with kDebug.  The calls of the
+///        lower levels are empty and do not format their messages.
+constexpr boost::log::trivial::severity_level kMinimumLogLevel{
+    kVerboseDebug ? boost::log::trivial::trace
+                  : (kDebug ? boost::log::trivial::debug : boost::log::trivial::info)};
+
+/// \brief Writes the messages of one party to log/id<my id>_<time>_<n>.log.
+///
+/// The messages are handed to a dedicated thread over the lock-free queue of the asynchronous sink
+/// of Boost.Log, so that the logging threads do not wait for the file.  The overloads taking a
+/// format string and its arguments format the message only if its level is compiled and logging is
+/// enabled, e.g., LogDebug("Evaluated gate #{}", gate_id) instead of
+/// LogDebug(fmt::format("Evaluated gate #{}", gate_id)).
 class Logger {
  public:
   // multiple instantiations of Logger in one application will cause duplicates
@@ -49,33 +70,80 @@ class Logger {
 
   void Log(boost::log::trivial::severity_level severity_level, std::string&& message);
 
-  void LogTrace(const std::string& message);
+  void LogTrace(const std::string& message) { Log<boost::log::trivial::trace>(message); }
+
+  void LogTrace(std::string&& message) { Log<boost::log::trivial::trace>(std::move(message)); }
 
-  void LogTrace(std::string&& message);
+  template <typename... Args>
+  requires(sizeof...(Args) > 0) void LogTrace(fmt::format_string<Args...> format,
+                                              Args&&... arguments) {
+    Log<boost::log::trivial::trace>(format, std::forward<Args>(arguments)...);
+  }
 
-  void LogInfo(const std::string& message);
+  void LogInfo(const std::string& message) { Log<boost::log::trivial::info>(message); }
 
-  void LogInfo(std::string&& message);
+  void LogInfo(std::string&& message) { Log<boost::log::trivial::info>(std::move(message)); }
 
-  void LogDebug(const std::string& message);
+  template <typename... Args>
+  requires(sizeof...(Args) > 0) void LogInfo(fmt::format_string<Args...> format,
+                                             Args&&... arguments) {
+    Log<boost::log::trivial::info>(format, std::forward<Args>(arguments)...);
+  }
 
-  void LogDebug(std::string&& message);
+  void LogDebug(const std::string& message) { Log<boost::log::trivial::debug>(message); }
 
-  void LogError(const std::string& message);
+  void LogDebug(std::string&& message) { Log<boost::log::trivial::debug>(std::move(message)); }
 
-  void LogError(std::string&& message);
+  template <typename... Args>
+  requires(sizeof...(Args) > 0) void LogDebug(fmt::format_string<Args...> format,
+                                              Args&&... arguments) {
+    Log<boost::log::trivial::debug>(format, std::forward<Args>(arguments)...);
+  }
+
+  void LogError(const std::string& message) { Log<boost::log::trivial::error>(message); }
+
+  void LogError(std::string&& message) { Log<boost::log::trivial::error>(std::move(message)); }
+
+  template <typename... Args>
+  requires(sizeof...(Args) > 0) void LogError(fmt::format_string<Args...> format,
+                                              Args&&... arguments) {
+    Log<boost::log::trivial::error>(format, std::forward<Args>(arguments)...);
+  }
 
   bool IsEnabled() { return logging_enabled_; }
 
   void SetEnabled(bool enable = true);
 
+  /// \brief Blocks until the queued messages are written to the log file.
+  void Flush();
+
  private:
-  boost::shared_ptr<boost::log::sinks::synchronous_sink<boost::log::sinks::text_file_backend>>
-      g_file_sink_;
+  template <boost::log::trivial::severity_level kSeverityLevel, typename Message>
+  void Log(Message&& message) {
+    if constexpr (kSeverityLevel >= kMinimumLogLevel) {
+      if (logging_enabled_) Write(kSeverityLevel, std::forward<Message>(message));
+    }
+  }
+
+  template <boost::log::trivial::severity_level kSeverityLevel, typename... Args>
+  void Log(fmt::format_string<Args...> format, Args&&... arguments) {
+    if constexpr (kSeverityLevel >= kMinimumLogLevel) {
+      if (logging_enabled_) {
+        Write(kSeverityLevel, fmt::format(format, std::forward<Args>(arguments)...));
+      }
+    }
+  }
+
+  void Write(boost::log::trivial::severity_level severity_level, const std::string& message);
+
+  using SinkType =
+      boost::log::sinks::asynchronous_sink<boost::log::sinks::text_file_backend,
+                                           boost::log::sinks::unbounded_fifo_queue>;
+
+  boost::shared_ptr<SinkType> g_file_sink_;
   std::unique_ptr<LoggerType> logger_;
   const std::size_t my_id_;
   std::atomic<bool> logging_enabled_ = true;
-  std::mutex write_mutex_;
 
   // aquire this on calls to boost::log::core
   static std::mutex boost_log_core_mutex_;
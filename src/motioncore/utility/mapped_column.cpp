@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mapped_column.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace encrypto::motion {
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {
+  const int file_descriptor{open(path_.c_str(), O_RDONLY)};
+  if (file_descriptor < 0) {
+    throw std::runtime_error(fmt::format("Could not open {}: {}", path_, std::strerror(errno)));
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0) {
+    const int error{errno};
+    close(file_descriptor);
+    throw std::runtime_error(fmt::format("Could not stat {}: {}", path_, std::strerror(error)));
+  }
+  size_ = file_status.st_size;
+  // mmap rejects empty mappings
+  if (size_ == 0) {
+    close(file_descriptor);
+    return;
+  }
+  void* mapping{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0)};
+  const int error{errno};
+  // the mapping stays valid after closing the file
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Could not map {}: {}", path_, std::strerror(error)));
+  }
+  data_ = static_cast<const std::byte*>(mapping);
+  madvise(mapping, size_, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) munmap(const_cast<std::byte*>(data_), size_);
+}
+
+template <typename T>
+MappedColumn<T>::MappedColumn(const std::string& path) : file_(path) {
+  const auto bytes{file_.GetBytes()};
+  if (bytes.size() % sizeof(T) != 0) {
+    throw std::runtime_error(fmt::format("Size of column {} is no multiple of {} bytes", path,
+                                         sizeof(T)));
+  }
+  // page-aligned mappings satisfy the alignment of all value types
+  values_ = {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+}
+
+template class MappedColumn<std::uint8_t>;
+template class MappedColumn<std::uint16_t>;
+template class MappedColumn<std::uint32_t>;
+template class MappedColumn<std::uint64_t>;
+template class MappedColumn<__uint128_t>;
+
+}  // namespace encrypto::motion
@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace encrypto::motion {
+
+/// \brief Read-only memory mapping of a whole file, which is unmapped on destruction.
+/// \throws std::runtime_error if the file cannot be opened or mapped.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const std::string& GetPath() const { return path_; }
+
+  /// \brief The mapped bytes, empty if the file is empty.
+  std::span<const std::byte> GetBytes() const { return {data_, size_}; }
+
+ private:
+  std::string path_;
+  const std::byte* data_{nullptr};
+  std::size_t size_{0};
+};
+
+/// \brief Column of fixed-width values of type T stored back to back in native byte order in a
+///        binary file, e.g., one column of a dataset exported in a columnar format.
+///
+/// The file is memory mapped instead of read, so datasets larger than the available memory can be
+/// fed into the input gates chunk by chunk: the values of a chunk are only paged in when they are
+/// copied into the gates via CompiledCircuit::SetInput, and consumed chunks can be dropped by the
+/// kernel again.
+template <typename T>
+class MappedColumn {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  /// \throws std::runtime_error if the file cannot be mapped or its size is no multiple of
+  ///         sizeof(T).
+  explicit MappedColumn(const std::string& path);
+
+  /// \brief Number of values in the column.
+  std::size_t GetSize() const { return values_.size(); }
+
+  std::span<const T> GetValues() const { return values_; }
+
+  /// \brief Number of chunks of \p chunk_size values, where the last chunk may be shorter.
+  std::size_t GetNumberOfChunks(std::size_t chunk_size) const {
+    return (GetSize() + chunk_size - 1) / chunk_size;
+  }
+
+  /// \brief The \p chunk_index-th chunk of \p chunk_size values, which is shorter than
+  ///        \p chunk_size if it is the last chunk and the size of the column is no multiple of
+  ///        \p chunk_size.
+  std::span<const T> GetChunk(std::size_t chunk_index, std::size_t chunk_size) const {
+    const std::size_t begin{std::min(chunk_index * chunk_size, GetSize())};
+    return values_.subspan(begin, std::min(chunk_size, GetSize() - begin));
+  }
+
+ private:
+  MappedFile file_;
+  std::span<const T> values_;
+};
+
+}  // namespace encrypto::motion
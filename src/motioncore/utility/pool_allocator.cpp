@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pool_allocator.h"
+
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace encrypto::motion {
+
+namespace {
+
+constexpr std::size_t kNumberOfSizeClasses{
+    std::countr_zero(AlignedMemoryPool::kMaximumBlockSize) -
+    std::countr_zero(AlignedMemoryPool::kMinimumBlockSize) + 1};
+
+bool IsPooled(std::size_t size, std::size_t alignment) noexcept {
+  return size <= AlignedMemoryPool::kMaximumBlockSize &&
+         alignment <= AlignedMemoryPool::kPoolAlignment;
+}
+
+std::size_t GetBlockSize(std::size_t size) noexcept {
+  return std::bit_ceil(std::max(size, AlignedMemoryPool::kMinimumBlockSize));
+}
+
+std::size_t GetSizeClass(std::size_t block_size) noexcept {
+  return std::countr_zero(block_size) - std::countr_zero(AlignedMemoryPool::kMinimumBlockSize);
+}
+
+class ThreadLocalPool {
+ public:
+  ~ThreadLocalPool() {
+    Release();
+    destroyed_ = true;
+  }
+
+  void* Pop(std::size_t size_class, std::size_t block_size) noexcept {
+    auto& blocks{free_blocks_[size_class]};
+    if (blocks.empty()) return nullptr;
+    void* pointer{blocks.back()};
+    blocks.pop_back();
+    cached_bytes_ -= block_size;
+    return pointer;
+  }
+
+  // returns false if the block was not taken by the pool
+  bool Push(void* pointer, std::size_t size_class, std::size_t block_size) noexcept {
+    if (cached_bytes_ + block_size > AlignedMemoryPool::kMaximumCachedBytes) return false;
+    try {
+      free_blocks_[size_class].push_back(pointer);
+    } catch (const std::bad_alloc&) {
+      return false;
+    }
+    cached_bytes_ += block_size;
+    return true;
+  }
+
+  void Release() noexcept {
+    for (std::size_t i = 0; i < free_blocks_.size(); ++i) {
+      for (void* pointer : free_blocks_[i]) {
+        ::operator delete(pointer, std::align_val_t(AlignedMemoryPool::kPoolAlignment));
+      }
+      free_blocks_[i].clear();
+    }
+    cached_bytes_ = 0;
+  }
+
+  std::size_t GetNumberOfCachedBytes() const noexcept { return cached_bytes_; }
+
+  // blocks released by objects destroyed after the pool of their thread are freed directly
+  static bool IsDestroyed() noexcept { return destroyed_; }
+
+ private:
+  std::array<std::vector<void*>, kNumberOfSizeClasses> free_blocks_;
+  std::size_t cached_bytes_{0};
+  static thread_local bool destroyed_;
+};
+
+thread_local bool ThreadLocalPool::destroyed_{false};
+
+ThreadLocalPool& GetThreadLocalPool() {
+  thread_local ThreadLocalPool pool;
+  return pool;
+}
+
+}  // namespace
+
+void* AlignedMemoryPool::Allocate(std::size_t size, std::size_t alignment) {
+  if (!IsPooled(size, alignment)) return ::operator new(size, std::align_val_t(alignment));
+  const std::size_t block_size{GetBlockSize(size)};
+  if (!ThreadLocalPool::IsDestroyed()) {
+    void* pointer{GetThreadLocalPool().Pop(GetSizeClass(block_size), block_size)};
+    if (pointer != nullptr) return pointer;
+  }
+  return ::operator new(block_size, std::align_val_t(kPoolAlignment));
+}
+
+void AlignedMemoryPool::Deallocate(void* pointer, std::size_t size,
+                                   std::size_t alignment) noexcept {
+  if (pointer == nullptr) return;
+  if (!IsPooled(size, alignment)) {
+    ::operator delete(pointer, std::align_val_t(alignment));
+    return;
+  }
+  const std::size_t block_size{GetBlockSize(size)};
+  if (ThreadLocalPool::IsDestroyed() ||
+      !GetThreadLocalPool().Push(pointer, GetSizeClass(block_size), block_size)) {
+    ::operator delete(pointer, std::align_val_t(kPoolAlignment));
+  }
+}
+
+std::size_t AlignedMemoryPool::GetNumberOfCachedBytes() noexcept {
+  return ThreadLocalPool::IsDestroyed() ? 0 : GetThreadLocalPool().GetNumberOfCachedBytes();
+}
+
+void AlignedMemoryPool::Release() noexcept {
+  if (!ThreadLocalPool::IsDestroyed()) GetThreadLocalPool().Release();
+}
+
+}  // namespace encrypto::motion
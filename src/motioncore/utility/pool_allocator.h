@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "config.h"
+
+namespace encrypto::motion {
+
+/// \brief Thread-local pools of aligned memory blocks in size classes of powers of two.
+///
+/// Used by PooledAlignedAllocator for the buffers of AlignedBitVector and Block128Vector, which
+/// are allocated and released for every gate in OT extension and garbling.  Released blocks are
+/// kept in the pool of the releasing thread and reused by later allocations of the same size
+/// class, also across runs.  Allocations larger than kMaximumBlockSize or with an alignment
+/// larger than kPoolAlignment bypass the pools.
+class AlignedMemoryPool {
+ public:
+  static constexpr std::size_t kPoolAlignment{std::max<std::size_t>(kAlignment, 64)};
+  static constexpr std::size_t kMinimumBlockSize{64};
+  static constexpr std::size_t kMaximumBlockSize{std::size_t(1) << 24};
+  // bytes each thread keeps at most in its pools, further released blocks are freed
+  static constexpr std::size_t kMaximumCachedBytes{std::size_t(1) << 26};
+
+  /// \brief Returns at least \p size bytes aligned to \p alignment.
+  /// \throws std::bad_alloc if the memory cannot be allocated
+  static void* Allocate(std::size_t size, std::size_t alignment);
+
+  /// \brief Returns \p pointer to the pool of this thread.
+  /// \pre \p pointer was returned by Allocate with the same \p size and \p alignment
+  static void Deallocate(void* pointer, std::size_t size, std::size_t alignment) noexcept;
+
+  /// \brief Number of bytes in the pools of this thread.
+  static std::size_t GetNumberOfCachedBytes() noexcept;
+
+  /// \brief Frees the blocks in the pools of this thread.
+  static void Release() noexcept;
+};
+
+/// \brief Stateless allocator of memory aligned to Alignment from the AlignedMemoryPool.
+template <typename T, std::size_t Alignment = alignof(T)>
+class PooledAlignedAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = PooledAlignedAllocator<U, Alignment>;
+  };
+
+  PooledAlignedAllocator() noexcept = default;
+
+  template <typename U>
+  PooledAlignedAllocator(const PooledAlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+    return static_cast<T*>(AlignedMemoryPool::Allocate(n * sizeof(T), kAllocationAlignment));
+  }
+
+  void deallocate(T* pointer, std::size_t n) noexcept {
+    AlignedMemoryPool::Deallocate(pointer, n * sizeof(T), kAllocationAlignment);
+  }
+
+  template <typename U>
+  bool operator==(const PooledAlignedAllocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+
+ private:
+  static constexpr std::size_t kAllocationAlignment{std::max(Alignment, alignof(T))};
+};
+
+}  // namespace encrypto::motion
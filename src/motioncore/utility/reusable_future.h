@@ -29,7 +29,9 @@
 #pragma once
 
 #include <boost/fiber/future.hpp>
+#include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <future>
 #include <mutex>
 #include <type_traits>
@@ -39,12 +41,17 @@ namespace encrypto::motion {
 namespace detail {
 
 // shared state to be used by ReusableFuture and ReusablePromise
+//
+// The state of the value is an atomic, s.t. setting a value that nobody waits for and taking a
+// value that is already there do not lock.  Only a consumer that needs to wait announces itself
+// and takes the lock, and only then the producer takes the lock for the notification.
 template <typename R, typename MutexType, typename ConditionVariableType>
 class ReusableSharedState {
  public:
-  ReusableSharedState() : contains_value_(false) {}
+  ReusableSharedState() = default;
   ~ReusableSharedState() {
-    if (contains_value_) {
+    if ((state_.load(std::memory_order_acquire) & (kContainsValue | kContainsException)) ==
+        kContainsValue) {
       // delete the object
       delete_helper();
     }
@@ -53,64 +60,114 @@ class ReusableSharedState {
   // set value
   template <typename Argument>
   void set(Argument&& argument) {
-    {
-      std::scoped_lock lock(mutex_);
-      if (contains_value_) {
+    // claim the storage, the consumer does not touch it until the value is published
+    auto state = state_.load(std::memory_order_relaxed);
+    do {
+      if (state & (kContainsValue | kSetting)) {
         throw std::future_error(std::future_errc::promise_already_satisfied);
       }
+    } while (!state_.compare_exchange_weak(state, state | kSetting, std::memory_order_acquire,
+                                           std::memory_order_relaxed));
+    try {
       // construct R from argument in the pre-allocated value_storage
       new (&value_storage_) R(std::forward<Argument>(argument));
-      contains_value_ = true;
+    } catch (...) {
+      state_.fetch_and(~kSetting, std::memory_order_release);
+      throw;
+    }
+    state = state_.fetch_xor(kSetting | kContainsValue, std::memory_order_seq_cst);
+    if (state & kWaiting) {
+      // the lock orders the notification after the waiter's check of the state
+      std::scoped_lock lock(mutex_);
+      condition_variable_.notify_all();
+    }
+  }
+
+  // set an exception instead of a value, which get() rethrows
+  void set_exception(std::exception_ptr exception) {
+    auto state = state_.load(std::memory_order_relaxed);
+    do {
+      if (state & (kContainsValue | kSetting)) {
+        throw std::future_error(std::future_errc::promise_already_satisfied);
+      }
+    } while (!state_.compare_exchange_weak(state, state | kSetting, std::memory_order_acquire,
+                                           std::memory_order_relaxed));
+    exception_ = std::move(exception);
+    state = state_.fetch_xor(kSetting | kContainsValue | kContainsException,
+                             std::memory_order_seq_cst);
+    if (state & kWaiting) {
+      std::scoped_lock lock(mutex_);
+      condition_variable_.notify_all();
     }
-    condition_variable_.notify_all();
   }
 
   // remove value if present
   void reset() noexcept {
-    std::unique_lock lock(mutex_);
-    if (contains_value_) {
+    const auto state = state_.load(std::memory_order_acquire);
+    if (state & kContainsValue) {
       // destroy object
-      delete_helper();
-      contains_value_ = false;
+      if (state & kContainsException) {
+        exception_ = nullptr;
+      } else {
+        delete_helper();
+      }
+      state_.fetch_and(~(kContainsValue | kContainsException), std::memory_order_release);
     }
   }
 
   // wait until there is a value
-  void wait() const noexcept {
-    std::unique_lock lock(mutex_);
-    wait_helper(lock);
-  }
-
-  // move value out of the shared state
-  R move() noexcept {
-    std::unique_lock lock(mutex_);
-    wait_helper(lock);
-    contains_value_ = false;
-    return std::move(*reinterpret_cast<R*>(&value_storage_));
+  void wait() const noexcept { wait_helper(); }
+
+  // move value out of the shared state or rethrow the exception that was set instead
+  R move() {
+    wait_helper();
+    if (state_.load(std::memory_order_acquire) & kContainsException) {
+      auto exception{std::move(exception_)};
+      exception_ = nullptr;
+      state_.fetch_and(~(kContainsValue | kContainsException), std::memory_order_release);
+      std::rethrow_exception(exception);
+    }
+    R value(std::move(*reinterpret_cast<R*>(&value_storage_)));
+    delete_helper();
+    state_.fetch_and(~kContainsValue, std::memory_order_release);
+    return value;
   }
 
   // check if there is some value stored
   bool contains_value() const noexcept {
-    std::scoped_lock lock(mutex_);
-    return contains_value_;
+    return state_.load(std::memory_order_acquire) & kContainsValue;
   }
 
  private:
+  static constexpr unsigned kContainsValue = 1;
+  // a producer is constructing the value
+  static constexpr unsigned kSetting = 2;
+  // a consumer waits for the value
+  static constexpr unsigned kWaiting = 4;
+  // the value is an exception, see set_exception
+  static constexpr unsigned kContainsException = 8;
+
   // storage for the value
   std::aligned_storage_t<sizeof(R), std::alignment_of_v<R>> value_storage_;
 
-  // status: true -> there is a value in the shared state
-  bool contains_value_;
+  mutable std::atomic<unsigned> state_ = 0;
+
+  std::exception_ptr exception_;
 
-  // synchronization stuff
+  // synchronization stuff, only used for waiting
   mutable MutexType mutex_;
   mutable ConditionVariableType condition_variable_;
 
   // helper functions
-  void wait_helper(std::unique_lock<decltype(mutex_)>& lock) const noexcept {
-    if (!contains_value_) {
-      condition_variable_.wait(lock, [this] { return contains_value_; });
+  void wait_helper() const noexcept {
+    if (state_.load(std::memory_order_acquire) & kContainsValue) {
+      return;
     }
+    std::unique_lock lock(mutex_);
+    state_.fetch_or(kWaiting, std::memory_order_seq_cst);
+    condition_variable_.wait(
+        lock, [this] { return state_.load(std::memory_order_seq_cst) & kContainsValue; });
+    state_.fetch_and(~kWaiting, std::memory_order_relaxed);
   }
 
   // delete the stored object
@@ -168,6 +225,9 @@ class ReusableFuture {
   // wait until the future gets ready
   void wait() const { shared_state_->wait(); }
 
+  // check if the future holds a value, i.e., whether get() would return without blocking
+  bool is_ready() const { return shared_state_->contains_value(); }
+
   // TODO: wait_for, wait_until
 
  private:
@@ -238,6 +298,14 @@ class ReusablePromise {
     shared_state_->set(std::move(value));
   }
 
+  // set an exception, which the next get() of the future rethrows
+  void set_exception(std::exception_ptr exception) {
+    if (!shared_state_) {
+      throw std::future_error(std::future_errc::no_state);
+    }
+    shared_state_->set_exception(std::move(exception));
+  }
+
   // returns future associated with the shared state of the promise
   ReusableFuture<R, MutexType, ConditionVariableType> get_future() {
     if (!shared_state_) {
@@ -67,6 +67,14 @@ class BasicSynchronizedQueue {
     return queue_.empty();
   }
 
+  /**
+   * Number of elements in the queue.
+   */
+  std::size_t size() const noexcept {
+    std::scoped_lock lock(mutex_);
+    return queue_.size();
+  }
+
   /**
    * Check if queue is closed.
    */
@@ -160,6 +168,16 @@ class BasicSynchronizedQueue {
     return std::optional<std::queue<T>>(std::move(output));
   }
 
+  /**
+   * Extract all elements of the queue without waiting, i.e., the result is empty if the queue is.
+   */
+  std::queue<T> TryBatchDequeue() noexcept {
+    std::queue<T> output;
+    std::scoped_lock lock(mutex_);
+    std::swap(queue_, output);
+    return output;
+  }
+
  private:
   bool closed_ = false;
   std::queue<T> queue_;
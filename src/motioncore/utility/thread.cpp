@@ -20,10 +20,17 @@
 
 #include "thread.h"
 #include <pthread.h>
+#include <sched.h>
 #include <cassert>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
 #include <string>
 #include <thread>
 
+#include <fmt/format.h>
+
 namespace encrypto::motion {
 
 void ThreadSetName(std::thread& thread, const std::string& name) {
@@ -32,4 +39,46 @@ void ThreadSetName(std::thread& thread, const std::string& name) {
   pthread_setname_np(handle, name.c_str());
 }
 
+void ThreadSetAffinity(std::thread& thread, std::size_t cpu) {
+  if (cpu >= CPU_SETSIZE) {
+    throw std::runtime_error(fmt::format("CPU id {} exceeds the maximum of {}", cpu, CPU_SETSIZE));
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  auto handle = thread.native_handle();
+  if (int error = pthread_setaffinity_np(handle, sizeof(cpu_set), &cpu_set); error != 0) {
+    throw std::runtime_error(
+        fmt::format("Failed to pin thread to CPU {}: {}", cpu, std::strerror(error)));
+  }
+}
+
+bool IsCpuAvailable(std::size_t cpu) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (cpu >= CPU_SETSIZE || sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    return false;
+  }
+  return CPU_ISSET(cpu, &cpu_set);
+}
+
+std::size_t GetNumaNodeOfCpu(std::size_t cpu) {
+  // the sysfs links the NUMA node of each CPU as /sys/devices/system/cpu/cpu<i>/node<j>
+  std::error_code error;
+  const std::filesystem::path cpu_path{fmt::format("/sys/devices/system/cpu/cpu{}", cpu)};
+  for (std::filesystem::directory_iterator it{cpu_path, error}, end; !error && it != end;
+       it.increment(error)) {
+    const auto file_name{it->path().filename().string()};
+    if (file_name.starts_with("node")) {
+      std::size_t node;
+      auto [pointer, result] =
+          std::from_chars(file_name.data() + 4, file_name.data() + file_name.size(), node);
+      if (result == std::errc() && pointer == file_name.data() + file_name.size()) {
+        return node;
+      }
+    }
+  }
+  return 0;
+}
+
 }  // namespace encrypto::motion
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <thread>
 
@@ -29,4 +30,16 @@ namespace encrypto::motion {
 // - name.size() <= 16
 void ThreadSetName(std::thread& thread, const std::string& name);
 
+// Restrict the thread to run on the logical CPU with the given id only.
+// Throws std::runtime_error if the CPU does not exist or is not available.
+void ThreadSetAffinity(std::thread& thread, std::size_t cpu);
+
+// Returns true if the calling process may run on the logical CPU with the
+// given id.
+bool IsCpuAvailable(std::size_t cpu);
+
+// Returns the NUMA node the logical CPU with the given id belongs to, or 0 if
+// the system does not expose this information.
+std::size_t GetNumaNodeOfCpu(std::size_t cpu);
+
 }  // namespace encrypto::motion
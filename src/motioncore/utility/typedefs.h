@@ -40,6 +40,7 @@ enum class PrimitiveOperationType : std::uint8_t {
   kMux,  // for Boolean circuit only
   kInv,  // for Boolean circuit only
   kOr,   // for Boolean circuit only
+  kLut,  // for Boolean GMW only
   kAdd,  // for arithmetic circuit only
   kMul,  // for arithmetic circuit only
   kSqr,  // for arithmetic circuit only
@@ -70,6 +71,9 @@ inline std::string to_string(PrimitiveOperationType t) {
     case PrimitiveOperationType::kOr: {
       return "OR";
     }
+    case PrimitiveOperationType::kLut: {
+      return "LUT";
+    }
     case PrimitiveOperationType::kAdd: {
       return "ADD";
     }
@@ -108,7 +112,16 @@ inline std::string to_string(PrimitiveOperationType t) {
   }
 }
 
-enum class IntegerOperationType : unsigned int { kAdd, kDiv, kGt, kEq, kMul, kSub, kInvalid };
+enum class IntegerOperationType : unsigned int {
+  kAdd,
+  kDiv,
+  kGt,
+  kEq,
+  kMul,
+  kSub,
+  kAbs,
+  kInvalid
+};
 
 inline std::string to_string(IntegerOperationType p) {
   switch (p) {
@@ -130,11 +143,69 @@ inline std::string to_string(IntegerOperationType p) {
     case IntegerOperationType::kSub: {
       return "INT_SUB";
     }
+    case IntegerOperationType::kAbs: {
+      return "INT_ABS";
+    }
     default:
       throw std::invalid_argument("Invalid IntegerOperationType");
   }
 }
 
+enum class FloatingPointOperationType : unsigned int {
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kLt,
+  kEq,
+  kSqrt,
+  kExp2,
+  kLog2,
+  kExp,
+  kLog,
+  kInvalid
+};
+
+inline std::string to_string(FloatingPointOperationType p) {
+  switch (p) {
+    case FloatingPointOperationType::kAdd: {
+      return "FLOAT_ADD";
+    }
+    case FloatingPointOperationType::kSub: {
+      return "FLOAT_SUB";
+    }
+    case FloatingPointOperationType::kMul: {
+      return "FLOAT_MUL";
+    }
+    case FloatingPointOperationType::kDiv: {
+      return "FLOAT_DIV";
+    }
+    case FloatingPointOperationType::kLt: {
+      return "FLOAT_LT";
+    }
+    case FloatingPointOperationType::kEq: {
+      return "FLOAT_EQ";
+    }
+    case FloatingPointOperationType::kSqrt: {
+      return "FLOAT_SQRT";
+    }
+    case FloatingPointOperationType::kExp2: {
+      return "FLOAT_EXP2";
+    }
+    case FloatingPointOperationType::kLog2: {
+      return "FLOAT_LOG2";
+    }
+    case FloatingPointOperationType::kExp: {
+      return "FLOAT_EXP";
+    }
+    case FloatingPointOperationType::kLog: {
+      return "FLOAT_LOG";
+    }
+    default:
+      throw std::invalid_argument("Invalid FloatingPointOperationType");
+  }
+}
+
 enum class MpcProtocol : unsigned int {
   // MPC protocols
   kArithmeticGmw,
@@ -142,6 +213,8 @@ enum class MpcProtocol : unsigned int {
   kBooleanGmw,
   kBmr,
   kGarbledCircuit,
+  kArithmeticReplicated,
+  kBooleanReplicated,
   // Constants
   kArithmeticConstant,
   kBooleanConstant,
@@ -165,6 +238,12 @@ inline std::string to_string(MpcProtocol p) {
     case MpcProtocol::kGarbledCircuit: {
       return "GarbledCircuit";
     }
+    case MpcProtocol::kArithmeticReplicated: {
+      return "ArithmeticReplicated";
+    }
+    case MpcProtocol::kBooleanReplicated: {
+      return "BooleanReplicated";
+    }
     default:
       return std::string("InvalidProtocol with value ") + std::to_string(static_cast<int>(p));
   }
@@ -188,4 +267,10 @@ enum class GarbledCircuitRole : unsigned int {
   kInvalid = 2  // for checking whether the value is valid
 };
 
+enum class GarbledCircuitScheme : unsigned int {
+  kThreeHalves,  // fewest bits per AND gate, for bandwidth-bound networks
+  kHalfGates,    // fewest AES calls per AND gate, for CPU-bound networks
+  kAuto          // selected by the network profile, see SelectGarbledCircuitScheme
+};
+
 }  // namespace encrypto::motion
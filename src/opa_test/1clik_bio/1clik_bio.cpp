@@ -13,6 +13,7 @@
 #include "statistics/analysis.h"
 #include "utility/typedefs.h"
 #include "secure_type/secure_unsigned_integer.h"
+#include "secure_type/secure_unsigned_integer_vector.h"
 #include "statistics/run_time_statistics.h"
 namespace mo = encrypto::motion;
 namespace program_options = boost::program_options;
@@ -21,6 +22,7 @@ std::pair<program_options::variables_map, std::vector<bool>> ParseProgramOptions
 encrypto::motion::PartyPointer CreateParty(const program_options::variables_map& user_options);
 mo::RunTimeStatistics EvaluateProtocol(mo::PartyPointer& party, std::vector<std::vector<uint32_t>> input);
 mo::ShareWrapper CreateShare(mo::PartyPointer& party, std::string protocol, uint32_t input, uint32_t party_id);
+mo::ShareWrapper CreateShare(mo::PartyPointer& party, std::string protocol, const std::vector<uint32_t>& input, uint32_t party_id);
 mo::ShareWrapper ConvertShare(mo::ShareWrapper sw, std::string protocol);
 
 int main(int ac, char* av[]) {
@@ -139,63 +141,24 @@ encrypto::motion::PartyPointer CreateParty(const program_options::variables_map&
 //playground.cpp from here
 mo::RunTimeStatistics EvaluateProtocol(mo::PartyPointer& party, std::vector<std::vector<uint32_t>> input) {
     std::vector<mo::SecureUnsignedInteger> output;
-	std::vector<std::vector<mo::ShareWrapper>> r1(4);
-	for(int i = 0; i < 4; i++){
-		r1[i] = std::vector<mo::ShareWrapper> (4);
-	}
-	int i23 = 0;
-	for(; i23 < 4;) {
-		int i24_1 = 0;
-		for(; i24_1 < 4;) {
-			int ti20 = i23 * 4;
-			int ti21 = ti20 + i24_1;
-			mo::ShareWrapper ti22 = CreateShare(party, "y", input[0][ti21], 0);
-			r1[i23][i24_1] = ti22;
-			i24_1 = i24_1 + 1;
-		}
-		i23 = i23 + 1;
-	}
-	std::vector<mo::ShareWrapper> r9(4);
-	int i25 = 0;
-	for(; i25 < 4;) {
-		mo::ShareWrapper ti19 = CreateShare(party, "y", input[1][i25], 1);
-		r9[i25] = ti19;
-		i25 = i25 + 1;
-	}
-	std::vector<mo::ShareWrapper> r10(4);
-	std::vector<mo::ShareWrapper> r2(4);
-	int i26 = 0;
-	for(; i26 < 4;) {
-		mo::ShareWrapper ti18 = CreateShare(party, "y", input[2][i26], 0);
-		r2[i26] = ti18;
-		i26 = i26 + 1;
-	}
-	int i27 = 0;
-	for(; i27 < 4;) {
-		mo::ShareWrapper ti6 = r1[i27][0];
-		mo::ShareWrapper ti5 = r9[0];
-		mo::ShareWrapper ti10 = ti6 - ti5;
-		mo::ShareWrapper ti8 = r1[i27][0];
-		mo::ShareWrapper ti7 = r9[0];
-		mo::ShareWrapper ti9 = ti8 - ti7;
-		mo::ShareWrapper i28_1 = ti10 * ti9;
-		int i29_1 = 1;
-		for(; i29_1 < 4;) {
-			mo::ShareWrapper ti12 = r1[i27][i29_1];
-			mo::ShareWrapper ti11 = r9[i29_1];
-			mo::ShareWrapper ti16 = ti12 - ti11;
-			mo::ShareWrapper ti14 = r1[i27][i29_1];
-			mo::ShareWrapper ti13 = r9[i29_1];
-			mo::ShareWrapper ti15 = ti14 - ti13;
-			mo::ShareWrapper ti17 = ti16 * ti15;
-			i28_1 = i28_1 + ti17;
-			i29_1 = i29_1 + 1;
-		}
-		r10[i27] = i28_1;
-		i27 = i27 + 1;
+	// the 4x4 matrix r1 row by row, the query r9 and the labels r2 are one SIMD share each
+	mo::SecureUnsignedIntegerVector r1 = CreateShare(party, "y", input[0], 0);
+	mo::SecureUnsignedIntegerVector r9 = CreateShare(party, "y", input[1], 1);
+	mo::SecureUnsignedIntegerVector r2 = CreateShare(party, "y", input[2], 0);
+	// r10[i] is the squared distance between row i of r1 and r9
+	std::vector<std::size_t> query_positions(16);
+	for (std::size_t k = 0; k < query_positions.size(); ++k) query_positions[k] = k % 4;
+	mo::SecureUnsignedIntegerVector differences = r1 - r9.Gather(query_positions);
+	mo::SecureUnsignedIntegerVector squares = differences * differences;
+	mo::SecureUnsignedIntegerVector distances = squares.Gather(std::vector<std::size_t>{0, 4, 8, 12});
+	for (std::size_t j = 1; j < 4; ++j) {
+		distances = distances + squares.Gather(std::vector<std::size_t>{j, 4 + j, 8 + j, 12 + j});
 	}
+	std::vector<mo::ShareWrapper> r10, r2_elements;
+	for (auto& distance : distances.Unsimdify()) r10.push_back(distance.Get());
+	for (auto& label : r2.Unsimdify()) r2_elements.push_back(label.Get());
 	mo::ShareWrapper i30 = r10[0];
-	mo::ShareWrapper i31 = r2[0];
+	mo::ShareWrapper i31 = r2_elements[0];
 	int i32 = 1;
 	for(; i32 < 4;) {
 		mo::ShareWrapper i2 = i30;
@@ -204,7 +167,7 @@ mo::RunTimeStatistics EvaluateProtocol(mo::PartyPointer& party, std::vector<std:
 		mo::ShareWrapper j68_gt = i30 > ti4;
 		mo::ShareWrapper j68 = ~j68_gt;
 		mo::ShareWrapper i30_2 = r10[i32];
-		mo::ShareWrapper i31_2 = r2[i32];
+		mo::ShareWrapper i31_2 = r2_elements[i32];
 		mo::ShareWrapper i30_3 = i2;
 		mo::ShareWrapper i31_3 = i3;
 		i31 = j68.Mux(i31_3, i31_2);
@@ -237,6 +200,20 @@ mo::ShareWrapper CreateShare(mo::PartyPointer& party, std::string protocol, uint
   return ret_share;
 }
 
+mo::ShareWrapper CreateShare(mo::PartyPointer& party, std::string protocol, const std::vector<uint32_t>& input, uint32_t party_id) {
+  mo::ShareWrapper ret_share;
+  if(protocol == "a"){
+    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kArithmeticGmw>(input, party_id));
+  } else if(protocol == "b" || protocol == "default"){
+    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(input), party_id));
+  } else if(protocol == "y"){
+    ret_share = mo::ShareWrapper(party->In<mo::MpcProtocol::kBmr>(mo::ToInput(input), party_id));
+  } else {
+    throw std::invalid_argument("Invalid MPC protocol");
+  }
+  return ret_share;
+}
+
 mo::ShareWrapper ConvertShare(mo::ShareWrapper sw, std::string protocol){
   mo::ShareWrapper ret_share;
   if(protocol == "b2a" || protocol == "y2a"){
@@ -0,0 +1,239 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "algorithm/aes_128.h"
+#include "algorithm/algorithm_description.h"
+#include "algorithm/evaluation_template.h"
+#include "algorithm/sha_256.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+#include "utility/config.h"
+
+namespace {
+
+using encrypto::motion::BitVector;
+
+// wire i is bit i of the bytes read as a big-endian integer, one SIMD value per byte string
+std::vector<BitVector<>> BytesToWires(const std::vector<std::vector<std::uint8_t>>& bytes) {
+  std::vector<BitVector<>> wires(8 * bytes.at(0).size());
+  for (const auto& simd_value : bytes) {
+    for (std::size_t wire_i = 0; wire_i < wires.size(); ++wire_i) {
+      const std::size_t byte_k{simd_value.size() - 1 - wire_i / 8};
+      wires[wire_i].Append(((simd_value[byte_k] >> (wire_i % 8)) & 1) == 1);
+    }
+  }
+  return wires;
+}
+
+std::vector<BitVector<>> WordsToWires(const std::vector<std::vector<std::uint32_t>>& words) {
+  std::vector<std::vector<std::uint8_t>> bytes;
+  for (const auto& simd_value : words) {
+    auto& simd_bytes{bytes.emplace_back()};
+    for (const auto word : simd_value) {
+      for (std::size_t i = 4; i-- > 0;) {
+        simd_bytes.push_back(static_cast<std::uint8_t>(word >> 8 * i));
+      }
+    }
+  }
+  return BytesToWires(bytes);
+}
+
+// AES-128 test vectors from FIPS-197, Appendix C.1, and for the all-zero key and plaintext
+const std::vector<std::vector<std::uint8_t>> kAesKeys{
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+     0x0f},
+    std::vector<std::uint8_t>(16, 0)};
+const std::vector<std::vector<std::uint8_t>> kAesPlaintexts{
+    {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee,
+     0xff},
+    std::vector<std::uint8_t>(16, 0)};
+const std::vector<std::vector<std::uint8_t>> kAesCiphertexts{
+    {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5,
+     0x5a},
+    {0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b, 0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b,
+     0x2e}};
+
+// the padded single blocks of "abc" and of the empty message
+const std::vector<std::vector<std::uint32_t>> kShaBlocks{
+    {0x61626380, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x18},
+    {0x80000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+const std::vector<std::vector<std::uint32_t>> kShaDigests{
+    {0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223, 0xb00361a3, 0x96177a9c, 0xb410ff61,
+     0xf20015ad},
+    {0xe3b0c442, 0x98fc1c14, 0x9afbf4c8, 0x996fb924, 0x27ae41e4, 0x649b934c, 0xa495991b,
+     0x7852b855}};
+
+std::vector<BitVector<>> GetShaInitialState() {
+  const std::vector<std::uint32_t> initial_hash_value(
+      encrypto::motion::algorithm::kSha256InitialHashValue.begin(),
+      encrypto::motion::algorithm::kSha256InitialHashValue.end());
+  return WordsToWires({initial_hash_value, initial_hash_value});
+}
+
+TEST(Aes128, PlaintextEvaluation) {
+  using namespace encrypto::motion::algorithm;
+  const auto key{BytesToWires(kAesKeys)};
+  const auto plaintext{BytesToWires(kAesPlaintexts)};
+  const auto round_keys{ExpandAes128Key(key)};
+  ASSERT_EQ(round_keys.size(), kAes128RoundKeysBitSize);
+  // the first round key is the key itself
+  EXPECT_TRUE(std::equal(key.begin(), key.end(), round_keys.begin()));
+  EXPECT_EQ(Aes128Encryption<BitVector<>>(round_keys, plaintext), BytesToWires(kAesCiphertexts));
+}
+
+TEST(Sha256, PlaintextEvaluation) {
+  using namespace encrypto::motion::algorithm;
+  const auto block{WordsToWires(kShaBlocks)};
+  const auto state{GetShaInitialState()};
+  EXPECT_EQ(Sha256CompressionFunction<BitVector<>>(block, state), WordsToWires(kShaDigests));
+}
+
+TEST(Aes128, GarbledCircuit) {
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  const auto key{BytesToWires(kAesKeys)};
+  const auto plaintext{BytesToWires(kAesPlaintexts)};
+  const std::vector<BitVector<>> dummy_input(128, BitVector<>(2));
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      encrypto::motion::ShareWrapper key_share{
+          parties[party_id]->In<kGarbledCircuit>(party_id == 0 ? key : dummy_input, 0)};
+      encrypto::motion::ShareWrapper plaintext_share{
+          parties[party_id]->In<kGarbledCircuit>(party_id == 1 ? plaintext : dummy_input, 1)};
+      auto output{encrypto::motion::algorithm::Aes128(key_share, plaintext_share).Out()};
+      parties[party_id]->Run();
+      EXPECT_EQ(output.As<std::vector<BitVector<>>>(), BytesToWires(kAesCiphertexts));
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(Aes128, BooleanGmwWithRoundKeysMatchesBristol) {
+  constexpr auto kBooleanGmw{encrypto::motion::MpcProtocol::kBooleanGmw};
+  const auto key{BytesToWires(kAesKeys)};
+  const auto round_keys{encrypto::motion::algorithm::ExpandAes128Key(key)};
+  const auto plaintext{BytesToWires(kAesPlaintexts)};
+  const std::vector<BitVector<>> dummy_key(128, BitVector<>(2)),
+      dummy_round_keys(round_keys.size(), BitVector<>(2)), dummy_plaintext(128, BitVector<>(2));
+  const auto aes_algorithm{encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/advanced/aes_128.bristol")};
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      const bool is_key_owner{party_id == 0};
+      encrypto::motion::ShareWrapper key_share{
+          parties[party_id]->In<kBooleanGmw>(is_key_owner ? key : dummy_key, 0)};
+      encrypto::motion::ShareWrapper round_keys_share{
+          parties[party_id]->In<kBooleanGmw>(is_key_owner ? round_keys : dummy_round_keys, 0)};
+      encrypto::motion::ShareWrapper plaintext_share{
+          parties[party_id]->In<kBooleanGmw>(is_key_owner ? dummy_plaintext : plaintext, 1)};
+      auto output{encrypto::motion::algorithm::Aes128WithRoundKeys(round_keys_share,
+                                                                   plaintext_share)
+                      .Out()};
+      auto bristol_output{
+          encrypto::motion::ShareWrapper::Concatenate({key_share, plaintext_share})
+              .Evaluate(aes_algorithm)
+              .Out()};
+      parties[party_id]->Run();
+      EXPECT_EQ(output.As<std::vector<BitVector<>>>(), BytesToWires(kAesCiphertexts));
+      EXPECT_EQ(bristol_output.As<std::vector<BitVector<>>>(), BytesToWires(kAesCiphertexts));
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(Aes128, BmrEvaluationTemplateMatchesBristol) {
+  constexpr auto kBmr{encrypto::motion::MpcProtocol::kBmr};
+  const auto key{BytesToWires(kAesKeys)};
+  const auto plaintext{BytesToWires(kAesPlaintexts)};
+  const std::vector<BitVector<>> dummy_input(128, BitVector<>(2));
+  const auto aes_algorithm{encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/advanced/aes_128.bristol")};
+  const encrypto::motion::EvaluationTemplate aes_template(aes_algorithm);
+  // one gate per layer and operation instead of one per Bristol gate
+  EXPECT_LT(aes_template.GetBatches().size(), aes_algorithm.gates.size() / 10);
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      encrypto::motion::ShareWrapper key_share{
+          parties[party_id]->In<kBmr>(party_id == 0 ? key : dummy_input, 0)};
+      encrypto::motion::ShareWrapper plaintext_share{
+          parties[party_id]->In<kBmr>(party_id == 1 ? plaintext : dummy_input, 1)};
+      const auto input{encrypto::motion::ShareWrapper::Concatenate({key_share, plaintext_share})};
+      // the template is reused for both evaluations
+      std::vector<encrypto::motion::ShareWrapper> outputs;
+      for (std::size_t i = 0; i < 2; ++i) {
+        outputs.push_back(
+            encrypto::motion::ShareWrapper::Evaluate(aes_template, input.Split()).Out());
+      }
+      parties[party_id]->Run();
+      for (const auto& output : outputs) {
+        EXPECT_EQ(output.As<std::vector<BitVector<>>>(), BytesToWires(kAesCiphertexts));
+      }
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(Sha256, BooleanGmw) {
+  constexpr auto kBooleanGmw{encrypto::motion::MpcProtocol::kBooleanGmw};
+  const auto block{WordsToWires(kShaBlocks)};
+  const auto state{GetShaInitialState()};
+  const std::vector<BitVector<>> dummy_block(512, BitVector<>(2)), dummy_state(256, BitVector<>(2));
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      encrypto::motion::ShareWrapper block_share{
+          parties[party_id]->In<kBooleanGmw>(party_id == 0 ? block : dummy_block, 0)};
+      encrypto::motion::ShareWrapper state_share{
+          parties[party_id]->In<kBooleanGmw>(party_id == 1 ? state : dummy_state, 1)};
+      auto output{encrypto::motion::algorithm::Sha256Compression(block_share, state_share).Out()};
+      parties[party_id]->Run();
+      EXPECT_EQ(output.As<std::vector<BitVector<>>>(), WordsToWires(kShaDigests));
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
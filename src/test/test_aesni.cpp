@@ -22,6 +22,10 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include "test_constants.h"
 
 #include "primitives/aes/aesni_primitives.h"
@@ -131,6 +135,38 @@ TEST(AesNi128, CtrStreamBlockwise) {
   EXPECT_EQ(output, kExpectedOutput);
 }
 
+TEST(AesNi128, CtrStreamLong) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  // long enough for the wide batches of the stream and their remainders
+  constexpr std::size_t kNumberOfBlocks{71};
+  std::vector<std::uint8_t> expected_output(kNumberOfBlocks * kAesBlockSize);
+  std::uint64_t counter = 0x0123456789abcdef;
+  for (std::size_t i = 0; i < kNumberOfBlocks; ++i) {
+    AesniCtrStreamSingleBlock128Unaligned(round_keys.data(), &counter,
+                                          expected_output.data() + i * kAesBlockSize);
+  }
+
+  alignas(kAesBlockSize) std::array<std::uint8_t, kNumberOfBlocks * kAesBlockSize> output;
+  std::vector<std::uint8_t> unaligned_output(kNumberOfBlocks * kAesBlockSize + 1);
+  for (std::size_t n = 1; n <= kNumberOfBlocks; n += 5) {
+    counter = 0x0123456789abcdef;
+    AesniCtrStreamBlocks128(round_keys.data(), &counter, output.data(), n);
+    EXPECT_EQ(counter, 0x0123456789abcdef + n);
+    EXPECT_TRUE(std::equal(std::begin(output), std::begin(output) + n * kAesBlockSize,
+                           std::begin(expected_output)));
+    counter = 0x0123456789abcdef;
+    AesniCtrStreamBlocks128Unaligned(round_keys.data(), &counter, unaligned_output.data() + 1, n);
+    EXPECT_TRUE(std::equal(std::begin(unaligned_output) + 1,
+                           std::begin(unaligned_output) + 1 + n * kAesBlockSize,
+                           std::begin(expected_output)));
+  }
+}
+
 TEST(AesNi128, TmmoBatch4) {
   std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -157,6 +193,83 @@ TEST(AesNi128, TmmoBatch4) {
   EXPECT_EQ(output, kExpectedOutput);
 }
 
+TEST(AesNi128, TmmoGatesBatch) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  std::mt19937 mersenne_twister(std::random_device{}());
+  std::uniform_int_distribution<std::uint8_t> distribution;
+  const __uint128_t tweak = 0xdeadbeefcafebeef;
+  // covers full 16 block batches and all tail lengths
+  for (std::size_t number_of_gates : {1, 2, 3, 5, 7, 8, 11, 17}) {
+    std::vector<std::uint8_t> input(6 * number_of_gates * kAesBlockSize);
+    std::generate(input.begin(), input.end(), [&] { return distribution(mersenne_twister); });
+
+    // batch 6: compare with hashing gate by gate
+    {
+      std::vector<std::array<std::uint8_t, 6 * kAesBlockSize>> expected_output(number_of_gates);
+      for (std::size_t gate_i = 0; gate_i < number_of_gates; ++gate_i) {
+        alignas(kAesBlockSize) std::array<std::uint8_t, 6 * kAesBlockSize> gate_input;
+        std::copy_n(input.data() + gate_i * 6 * kAesBlockSize, 6 * kAesBlockSize,
+                    gate_input.data());
+        AesniTmmoBatch6(round_keys.data(), gate_input.data(), tweak + gate_i);
+        expected_output[gate_i] = gate_input;
+      }
+      auto output{input};
+      AesniTmmoGatesBatch6(round_keys.data(), output.data(), tweak, number_of_gates);
+      for (std::size_t gate_i = 0; gate_i < number_of_gates; ++gate_i) {
+        EXPECT_TRUE(std::equal(expected_output[gate_i].begin(), expected_output[gate_i].end(),
+                               output.begin() + gate_i * 6 * kAesBlockSize));
+      }
+    }
+
+    // batch 3: compare with hashing gate by gate
+    {
+      std::vector<std::array<std::uint8_t, 3 * kAesBlockSize>> expected_output(number_of_gates);
+      for (std::size_t gate_i = 0; gate_i < number_of_gates; ++gate_i) {
+        alignas(kAesBlockSize) std::array<std::uint8_t, 3 * kAesBlockSize> gate_input;
+        std::copy_n(input.data() + gate_i * 3 * kAesBlockSize, 3 * kAesBlockSize,
+                    gate_input.data());
+        AesniTmmoBatch3(round_keys.data(), gate_input.data(), tweak + gate_i);
+        expected_output[gate_i] = gate_input;
+      }
+      std::vector<std::uint8_t> output(input.begin(),
+                                       input.begin() + 3 * number_of_gates * kAesBlockSize);
+      AesniTmmoGatesBatch3(round_keys.data(), output.data(), tweak, number_of_gates);
+      for (std::size_t gate_i = 0; gate_i < number_of_gates; ++gate_i) {
+        EXPECT_TRUE(std::equal(expected_output[gate_i].begin(), expected_output[gate_i].end(),
+                               output.begin() + gate_i * 3 * kAesBlockSize));
+      }
+    }
+
+    // batches 4 and 2: compare with hashing the blocks of each tweak separately
+    for (std::size_t blocks_per_gate : {4, 2}) {
+      const std::size_t blocks_per_tweak{blocks_per_gate / 2};
+      std::vector<std::uint8_t> expected_output(input.begin(),
+                                                input.begin() + blocks_per_gate *
+                                                                    number_of_gates *
+                                                                    kAesBlockSize);
+      for (std::size_t tweak_i = 0; tweak_i < 2 * number_of_gates; ++tweak_i) {
+        alignas(kAesBlockSize) std::array<std::uint8_t, 4 * kAesBlockSize> tweak_input{};
+        auto blocks{expected_output.begin() + tweak_i * blocks_per_tweak * kAesBlockSize};
+        std::copy_n(blocks, blocks_per_tweak * kAesBlockSize, tweak_input.begin());
+        AesniTmmoBatch4(round_keys.data(), tweak_input.data(), 2 * (tweak - 1) + tweak_i);
+        std::copy_n(tweak_input.begin(), blocks_per_tweak * kAesBlockSize, blocks);
+      }
+      std::vector<std::uint8_t> output(input.begin(), input.begin() + expected_output.size());
+      if (blocks_per_gate == 4) {
+        AesniTmmoGatesBatch4(round_keys.data(), output.data(), tweak, number_of_gates);
+      } else {
+        AesniTmmoGatesBatch2(round_keys.data(), output.data(), tweak, number_of_gates);
+      }
+      EXPECT_EQ(output, expected_output);
+    }
+  }
+}
+
 TEST(AesNi128, MmoSingle) {
   std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -173,3 +286,85 @@ TEST(AesNi128, MmoSingle) {
   AesniMmoSingle(round_keys.data(), output.data());
   EXPECT_EQ(output, kExpectedOutput);
 }
+
+TEST(AesNi128, MmoBatch4) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  alignas(kAesBlockSize) std::array<std::uint8_t, 4 * kAesBlockSize> output;
+  for (std::size_t i = 0; i < output.size(); ++i) output[i] = 0x41 + i / kAesBlockSize;
+  // the batch computes the same as four single MMOs
+  alignas(kAesBlockSize) auto expected_output{output};
+  for (std::size_t i = 0; i < 4; ++i) {
+    AesniMmoSingle(round_keys.data(), expected_output.data() + i * kAesBlockSize);
+  }
+  AesniMmoBatch4(round_keys.data(), output.data());
+  EXPECT_EQ(output, expected_output);
+  const std::array<std::uint8_t, kAesBlockSize> kExpectedFirstBlock = {
+      0x2d, 0x6b, 0x7e, 0x98, 0x7b, 0xe6, 0xf5, 0x56,
+      0x84, 0x02, 0xcc, 0x67, 0xe5, 0x20, 0xd4, 0x58};
+  EXPECT_TRUE(std::equal(std::begin(kExpectedFirstBlock), std::end(kExpectedFirstBlock),
+                         std::begin(output)));
+}
+
+TEST(AesNi128, MmoBlocks) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  std::mt19937_64 random_engine(42);
+  // sizes around the batch widths of the AES-NI, VAES and ARMv8 implementations
+  for (std::size_t number_of_blocks : {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 45}) {
+    struct alignas(kAesBlockSize) Block {
+      std::array<std::uint64_t, 2> data;
+      bool operator==(const Block&) const = default;
+    };
+    std::vector<Block> output(number_of_blocks);
+    for (auto& block : output) block.data = {random_engine(), random_engine()};
+    auto expected_output{output};
+    for (auto& block : expected_output) AesniMmoSingle(round_keys.data(), block.data.data());
+    AesniMmoBlocks(round_keys.data(), output.data(), number_of_blocks);
+    EXPECT_EQ(output, expected_output) << number_of_blocks;
+  }
+}
+
+TEST(AesNi128, BmrDkcBatch) {
+  std::array<std::uint8_t, kAesKeySize128> kKey = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(kAesBlockSize) std::array<std::uint8_t, kAesRoundKeysSize128> round_keys;
+  std::copy(std::begin(kKey), std::end(kKey), std::begin(round_keys));
+  AesniKeyExpansion128(round_keys.data());
+
+  std::mt19937_64 random_engine(42);
+  constexpr std::uint64_t kGateId{1234};
+  for (std::size_t number_of_parties : {2, 3, 5}) {
+    for (std::size_t number_of_keys : {1, 4, 7}) {
+      for (std::size_t output_stride : {std::size_t(0), number_of_parties}) {
+        const std::size_t output_size{(number_of_keys - 1) * output_stride + number_of_parties};
+        struct alignas(kAesBlockSize) Block {
+          std::array<std::uint64_t, 2> data;
+          bool operator==(const Block&) const = default;
+        };
+        std::vector<Block> keys_a(number_of_keys), keys_b(number_of_keys), output(output_size);
+        for (auto& block : keys_a) block.data = {random_engine(), random_engine()};
+        for (auto& block : keys_b) block.data = {random_engine(), random_engine()};
+        for (auto& block : output) block.data = {random_engine(), random_engine()};
+
+        // the batch computes the same as one AesniBmrDkc per pair of keys
+        auto expected_output{output};
+        for (std::size_t k = 0; k < number_of_keys; ++k) {
+          AesniBmrDkc(round_keys.data(), &keys_a[k], &keys_b[k], kGateId, number_of_parties,
+                      &expected_output[k * output_stride]);
+        }
+        AesniBmrDkcBatch(round_keys.data(), keys_a.data(), keys_b.data(), kGateId, number_of_keys,
+                         number_of_parties, output.data(), output_stride);
+        EXPECT_TRUE(output == expected_output);
+      }
+    }
+  }
+}
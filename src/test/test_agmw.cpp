@@ -23,12 +23,20 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <array>
+#include <filesystem>
 #include <future>
+#include <numeric>
 
+#include "algorithm/arithmetic_algorithm_description.h"
+#include "base/backend.h"
 #include "base/party.h"
+#include "base/register.h"
+#include "oblivious_transfer/ot_provider.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_gate.h"
 #include "protocols/arithmetic_gmw/arithmetic_gmw_wire.h"
 #include "protocols/share_wrapper.h"
+#include "secure_type/secure_fixed_point.h"
 #include "secure_type/secure_signed_integer.h"
 #include "test_constants.h"
 #include "test_helpers.h"
@@ -488,6 +496,211 @@ TEST(ArithmeticGmw, Multiplication_1_100_Simd_2_3_parties) {
   }
 }
 
+TEST(ArithmeticGmw, BatchedOpeningPolynomial_100_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    const std::vector<T> kZeroV(kNumberOfSimd, 0);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> x{::RandomVector<T>(kNumberOfSimd)}, y{::RandomVector<T>(kNumberOfSimd)};
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      const bool layered{random_value() % 2 == 1};
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetLayeredEvaluation(layered);
+        party->GetBackend()->GetArithmeticGmwProvider().SetOpeningBatching();
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, &motion_parties, &x, &y,
+                                                             &kZeroV] {
+          auto& party{*motion_parties.at(party_id)};
+          encrypto::motion::ShareWrapper share_x{
+              party.In<kArithmeticGmw>(party_id == 0 ? x : kZeroV, 0)};
+          encrypto::motion::ShareWrapper share_y{
+              party.In<kArithmeticGmw>(party_id == 1 ? y : kZeroV, 1)};
+
+          // the multiplications of each layer are opened together: x * x and x * y, then
+          // x^2 * x^2 and x^2 * y and finally x^4 * (x^2 * y)
+          auto share_x2{share_x * share_x};
+          auto share_xy{share_x * share_y};
+          auto share_x4{share_x2 * share_x2};
+          auto share_x2y{share_x2 * share_y};
+          auto share_x6y{share_x4 * share_x2y};
+          auto share_output{(share_x6y + share_xy).Out()};
+
+          party.Run();
+
+          const auto circuit_result{share_output.template As<std::vector<T>>()};
+          for (auto i = 0u; i < kNumberOfSimd; ++i) {
+            const T x2 = x[i] * x[i];
+            const T expected_result = x2 * x2 * x2 * y[i] + x[i] * y[i];
+            EXPECT_EQ(circuit_result.at(i), expected_result);
+          }
+          party.Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  for (auto i = 0ull; i < kTestIterations; ++i) {
+    template_test(static_cast<std::uint8_t>(0));
+    template_test(static_cast<std::uint16_t>(0));
+    template_test(static_cast<std::uint32_t>(0));
+    template_test(static_cast<std::uint64_t>(0));
+  }
+}
+
+TEST(ArithmeticGmw, RandomShare_100_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    const std::vector<T> kZeroV(kNumberOfSimd, 0);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::vector<T> x{::RandomVector<T>(kNumberOfSimd)};
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      }
+      std::vector<std::vector<T>> masks(number_of_parties);
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, &motion_parties, &x,
+                                                             &kZeroV, &masks] {
+          auto& party{*motion_parties.at(party_id)};
+          encrypto::motion::ShareWrapper share_x{
+              party.In<kArithmeticGmw>(party_id == 0 ? x : kZeroV, 0)};
+          // the random shares are created without an input gate or communication
+          encrypto::motion::ShareWrapper share_r{
+              party.GetBackend()->template RandomArithmeticShare<T>(kNumberOfSimd)};
+          auto share_output_r{share_r.Out()};
+          auto share_output_masked{(share_x + share_r).Out()};
+
+          party.Run();
+
+          masks.at(party_id) = share_output_r.template As<std::vector<T>>();
+          const auto masked{share_output_masked.template As<std::vector<T>>()};
+          for (auto i = 0u; i < kNumberOfSimd; ++i) {
+            EXPECT_EQ(static_cast<T>(masked.at(i) - masks.at(party_id).at(i)), x.at(i));
+          }
+          party.Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+      for (auto party_id = 1u; party_id < number_of_parties; ++party_id) {
+        EXPECT_EQ(masks.at(party_id), masks.at(0));
+      }
+    }
+  };
+  for (auto i = 0ull; i < kTestIterations; ++i) {
+    template_test(static_cast<std::uint8_t>(0));
+    template_test(static_cast<std::uint16_t>(0));
+    template_test(static_cast<std::uint32_t>(0));
+    template_test(static_cast<std::uint64_t>(0));
+  }
+}
+
+TEST(ArithmeticGmw, Truncation_100_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  auto template_test = [](auto template_variable) {
+    using T = decltype(template_variable);
+    using S = std::make_signed_t<T>;
+    constexpr std::size_t kBitSize{sizeof(T) * 8};
+    const std::vector<T> kZeroV(kNumberOfSimd, 0);
+    for (auto number_of_parties : {2u, 3u}) {
+      const std::size_t number_of_bits{random_value() % (kBitSize - 1)};
+      // two's complement values in [-2^(l-2), 2^(l-2))
+      std::vector<T> x{::RandomVector<T>(kNumberOfSimd)};
+      for (auto& value : x) {
+        value = T(S(value) >> 1);
+      }
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+      }
+      std::vector<std::future<void>> futures;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [party_id, number_of_bits,
+                                                             &motion_parties, &x, &kZeroV] {
+          auto& party{*motion_parties.at(party_id)};
+          encrypto::motion::ShareWrapper share_x{
+              party.In<kArithmeticGmw>(party_id == 0 ? x : kZeroV, 0)};
+          auto share_output{share_x.Truncate(number_of_bits).Out()};
+
+          party.Run();
+
+          const auto circuit_result{share_output.template As<std::vector<T>>()};
+          for (auto i = 0u; i < kNumberOfSimd; ++i) {
+            const T expected_result = T(S(x[i]) >> number_of_bits);
+            const T error = circuit_result.at(i) - expected_result;
+            EXPECT_TRUE(error == 0 || error == 1);
+          }
+          party.Finish();
+        }));
+      }
+      for (auto& f : futures) f.get();
+    }
+  };
+  for (auto i = 0ull; i < kTestIterations; ++i) {
+    template_test(static_cast<std::uint8_t>(0));
+    template_test(static_cast<std::uint16_t>(0));
+    template_test(static_cast<std::uint32_t>(0));
+    template_test(static_cast<std::uint64_t>(0));
+  }
+}
+
+TEST(ArithmeticGmw, SecureFixedPoint_100_Simd_2_3_parties) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  using FixedPoint = encrypto::motion::SecureFixedPoint<std::uint64_t, 16>;
+  std::srand(0);
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<double> a(kNumberOfSimd), b(kNumberOfSimd);
+    for (auto i = 0u; i < kNumberOfSimd; ++i) {
+      a[i] = (std::rand() % 200000 - 100000) / 1000.0;
+      b[i] = (std::rand() % 200000 - 100000) / 1000.0;
+    }
+    const std::vector<std::uint64_t> kZeroV(kNumberOfSimd, 0);
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+    std::vector<std::future<void>> futures;
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      futures.emplace_back(
+          std::async(std::launch::async, [party_id, &motion_parties, &a, &b, &kZeroV] {
+            auto& party{*motion_parties.at(party_id)};
+            FixedPoint share_a{
+                party.In<kArithmeticGmw>(party_id == 0 ? FixedPoint::Encode(a) : kZeroV, 0)};
+            FixedPoint share_b{
+                party.In<kArithmeticGmw>(party_id == 1 ? FixedPoint::Encode(b) : kZeroV, 1)};
+            // a * b + 0.5 * a - b - 1.25
+            auto share_result{share_a * share_b + share_a * 0.5 - share_b - 1.25};
+            auto share_output{share_result.Out()};
+
+            party.Run();
+
+            const auto circuit_result{share_output.As<std::vector<double>>()};
+            for (auto i = 0u; i < kNumberOfSimd; ++i) {
+              const double expected_result = a[i] * b[i] + 0.5 * a[i] - b[i] - 1.25;
+              // rounding of the inputs and at most one unit in the last place per truncation
+              EXPECT_NEAR(circuit_result.at(i), expected_result, 1e-2);
+            }
+            party.Finish();
+          }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
 TEST(ArithmeticGmw, ConstantMultiplication_1_1K_Simd_2_3_4_5_10_parties) {
   constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
   constexpr auto kArithmeticConstant = encrypto::motion::MpcProtocol::kArithmeticConstant;
@@ -692,6 +905,394 @@ TYPED_TEST(ArithmeticGmwTest, GreaterThan_1_1000_Simd_2_parties) {
   }
 }
 
+TYPED_TEST(ArithmeticGmwTest, ArithmeticCircuit_100_Simd_3_parties) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfParties{3}, kNumberOfSimd{100};
+  std::vector<std::vector<T>> inputs(kNumberOfParties);
+  for (auto& input : inputs) input = RandomVector<T>(kNumberOfSimd);
+  const auto path{WriteArithmeticTestCircuit(sizeof(T) * 8)};
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+  }
+  std::vector<std::thread> threads(kNumberOfParties);
+  for (auto party_id = 0u; party_id < kNumberOfParties; ++party_id) {
+    threads.at(party_id) = std::thread([party_id, &motion_parties, &inputs, &path]() {
+      std::vector<ShareWrapper> shares;
+      for (auto j = 0u; j < kNumberOfParties; ++j) {
+        shares.push_back(motion_parties.at(party_id)->In<kArithmeticGmw>(
+            party_id == j ? inputs.at(j) : std::vector<T>(kNumberOfSimd, 0), j));
+      }
+      const auto algorithm{motion_parties.at(party_id)
+                               ->GetBackend()
+                               ->GetRegister()
+                               ->GetCachedArithmeticAlgorithmDescription(path)};
+      auto outputs{ShareWrapper::Evaluate(*algorithm, shares)};
+      ASSERT_EQ(outputs.size(), 1);
+      auto share_output{outputs[0].Out()};
+
+      motion_parties.at(party_id)->Run();
+
+      const auto circuit_result{share_output.As<std::vector<T>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(circuit_result.at(i),
+                  ArithmeticTestCircuit(inputs[0][i], inputs[1][i], inputs[2][i]));
+      }
+      motion_parties.at(party_id)->Finish();
+    });
+  }
+  for (auto& t : threads) t.join();
+  std::filesystem::remove(path);
+}
+
+TYPED_TEST(ArithmeticGmwTest, MatrixMultiplication_10_Simd_2_3_parties) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kRows{3}, kInner{7}, kColumns{4}, kNumberOfSimd{10};
+  std::array<std::vector<std::vector<T>>, 2> matrices;
+  matrices[0].resize(kRows * kInner);
+  matrices[1].resize(kInner * kColumns);
+  for (auto& matrix : matrices) {
+    for (auto& entry : matrix) entry = ::RandomVector<T>(kNumberOfSimd);
+  }
+
+  std::vector<std::vector<T>> expected_product(kRows * kColumns, std::vector<T>(kNumberOfSimd, 0));
+  std::vector<T> expected_dot_product(kNumberOfSimd, 0);
+  for (std::size_t s = 0; s < kNumberOfSimd; ++s) {
+    for (std::size_t i = 0; i < kRows; ++i) {
+      for (std::size_t j = 0; j < kColumns; ++j) {
+        for (std::size_t l = 0; l < kInner; ++l) {
+          expected_product[i * kColumns + j][s] += static_cast<T>(
+              matrices[0][i * kInner + l][s] *
+              static_cast<std::uint64_t>(matrices[1][l * kColumns + j][s]));
+        }
+      }
+    }
+    // the inner product of the first row of the first matrix and the first column of the second
+    for (std::size_t l = 0; l < kInner; ++l) {
+      expected_dot_product[s] += static_cast<T>(
+          matrices[0][l][s] * static_cast<std::uint64_t>(matrices[1][l * kColumns][s]));
+    }
+  }
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+    }
+    std::vector<std::thread> threads(number_of_parties);
+    for (auto party_id = 0u; party_id < number_of_parties; ++party_id) {
+      threads.at(party_id) = std::thread([party_id, &motion_parties, &matrices, &expected_product,
+                                          &expected_dot_product]() {
+        // the first matrix is input by party 0 and the second one by party 1
+        std::array<std::vector<ShareWrapper>, 2> shared_matrices;
+        for (std::size_t matrix_i : {0, 1}) {
+          for (const auto& entry : matrices[matrix_i]) {
+            shared_matrices[matrix_i].push_back(motion_parties.at(party_id)->In<kArithmeticGmw>(
+                party_id == matrix_i ? entry : std::vector<T>(kNumberOfSimd, 0), matrix_i));
+          }
+        }
+        auto product{MatrixMultiplication(shared_matrices[0], shared_matrices[1], kRows, kColumns)};
+        ASSERT_EQ(product.size(), kRows * kColumns);
+        std::vector<ShareWrapper> outputs;
+        for (auto& entry : product) outputs.push_back(entry.Out());
+
+        std::vector<ShareWrapper> row(shared_matrices[0].begin(),
+                                      shared_matrices[0].begin() + kInner);
+        std::vector<ShareWrapper> column;
+        for (std::size_t l = 0; l < kInner; ++l) column.push_back(shared_matrices[1][l * kColumns]);
+        auto dot_product_output{DotProduct(row, column).Out()};
+
+        motion_parties.at(party_id)->Run();
+
+        for (std::size_t entry = 0; entry < outputs.size(); ++entry) {
+          EXPECT_EQ(outputs[entry].As<std::vector<T>>(), expected_product[entry]);
+        }
+        EXPECT_EQ(dot_product_output.As<std::vector<T>>(), expected_dot_product);
+        motion_parties.at(party_id)->Finish();
+      });
+    }
+    for (auto& t : threads) t.join();
+  }
+}
+
+TYPED_TEST(ArithmeticGmwTest, GreaterThanWithChunkBitLengths) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  const auto bit_length = sizeof(T) * 8;
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<T> dist(0, (T(1) << (bit_length - 1)) - 1);
+
+  // the shortest and the longest chunks, which use 1-out-of-256 OTs for the larger types, with
+  // both the general and the derandomized random OTs
+  for (std::size_t l_s :
+       {std::size_t(2),
+        std::min(encrypto::motion::proto::arithmetic_gmw::kMaxGreaterThanChunkBitLength,
+                 bit_length - 1)}) {
+    for (bool random_ots : {false, true}) {
+      std::array<std::vector<T>, 2> inputs;
+      for (auto& input : inputs) {
+        input.resize(kNumberOfSimd);
+        for (auto& value : input) value = dist(gen);
+      }
+
+      std::vector<PartyPointer> motion_parties(
+          std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+      for (auto& party : motion_parties) {
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        party->GetConfiguration()->SetGreaterThanChunkBitLength(l_s);
+        party->GetBackend()->GetArithmeticGmwProvider().SetRandomComparisonOts(random_ots);
+      }
+
+      std::vector<std::thread> threads(2);
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        threads.at(party_id) = std::thread([party_id, &motion_parties, &inputs]() {
+          const std::vector<T> kZeros(kNumberOfSimd, 0);
+          encrypto::motion::ShareWrapper a = motion_parties.at(party_id)->In<kArithmeticGmw>(
+              party_id == 0 ? inputs.at(0) : kZeros, 0);
+          encrypto::motion::ShareWrapper b = motion_parties.at(party_id)->In<kArithmeticGmw>(
+              party_id == 1 ? inputs.at(1) : kZeros, 1);
+          auto output = (a > b).Out();
+
+          motion_parties.at(party_id)->Run();
+
+          const auto result = output.template As<std::vector<BitVector<>>>();
+          for (auto i = 0u; i < kNumberOfSimd; ++i) {
+            EXPECT_EQ(result.at(0).Get(i), inputs.at(0).at(i) > inputs.at(1).at(i));
+          }
+          motion_parties.at(party_id)->Finish();
+        });
+      }
+      for (auto& t : threads) t.join();
+    }
+  }
+}
+
+TYPED_TEST(ArithmeticGmwTest, GreaterThanAndHybridMultiplicationFromRandomOtPool) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  // small batches s.t. the OTs of the gates span several batches
+  constexpr std::size_t kBatchSize{1'024}, kLowWatermark{512};
+  const auto bit_length = sizeof(T) * 8;
+  std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<std::uint64_t> dist(0, (std::uint64_t(1) << (bit_length - 1)) - 1);
+  std::bernoulli_distribution bit_dist;
+
+  for (std::size_t l_s :
+       {std::size_t(2),
+        std::min(encrypto::motion::proto::arithmetic_gmw::kMaxGreaterThanChunkBitLength,
+                 bit_length - 1)}) {
+    std::array<std::vector<T>, 2> inputs;
+    for (auto& input : inputs) {
+      input.resize(kNumberOfSimd);
+      for (auto& value : input) value = static_cast<T>(dist(gen));
+    }
+    BitVector<> bits(kNumberOfSimd);
+    for (std::size_t i = 0; i < kNumberOfSimd; ++i) bits.Set(bit_dist(gen), i);
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetGreaterThanChunkBitLength(l_s);
+    }
+
+    std::vector<std::thread> threads(2);
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      threads.at(party_id) = std::thread([party_id, &motion_parties, &inputs, &bits]() {
+        auto& party{motion_parties.at(party_id)};
+        // the gates take their OTs from the pool, none of them is registered at the OT extension
+        party->GetBackend()->GetOtProvider(1 - party_id).EnableRandomOtPool(kBatchSize,
+                                                                            kLowWatermark);
+        const std::vector<T> kZeros(kNumberOfSimd, 0);
+        encrypto::motion::ShareWrapper a =
+            party->In<kArithmeticGmw>(party_id == 0 ? inputs.at(0) : kZeros, 0);
+        encrypto::motion::ShareWrapper b =
+            party->In<kArithmeticGmw>(party_id == 1 ? inputs.at(1) : kZeros, 1);
+        encrypto::motion::ShareWrapper bit =
+            party->In<kBooleanGmw>(party_id == 0 ? bits : BitVector<>(kNumberOfSimd), 0);
+        auto greater_output = (a > b).Out();
+        auto product_output = (bit * b).Out();
+
+        party->Run();
+
+        const auto greater = greater_output.template As<std::vector<BitVector<>>>();
+        const auto product = product_output.template As<std::vector<T>>();
+        for (auto i = 0u; i < kNumberOfSimd; ++i) {
+          EXPECT_EQ(greater.at(0).Get(i), inputs.at(0).at(i) > inputs.at(1).at(i));
+          EXPECT_EQ(product.at(i), bits.Get(i) ? inputs.at(1).at(i) : T(0));
+        }
+        party->Finish();
+      });
+    }
+    for (auto& t : threads) t.join();
+  }
+}
+
+TYPED_TEST(ArithmeticGmwTest, Comparisons_1000_Simd_2_parties) {
+  using T = TypeParam;
+  using S = std::make_signed_t<T>;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{1000};
+  const std::vector<T> kZeroV(kNumberOfSimd, 0);
+
+  // two's complement values in [-2^(l-2), 2^(l-2)), every fourth pair is equal
+  std::vector<T> a{::RandomVector<T>(kNumberOfSimd)}, b{::RandomVector<T>(kNumberOfSimd)};
+  for (auto i = 0u; i < kNumberOfSimd; ++i) {
+    a[i] = T(S(a[i]) >> 1);
+    b[i] = i % 4 == 0 ? a[i] : T(S(b[i]) >> 1);
+  }
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+  }
+  std::vector<std::future<void>> futures;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    futures.emplace_back(
+        std::async(std::launch::async, [party_id, &motion_parties, &a, &b, &kZeroV] {
+          auto& party{*motion_parties.at(party_id)};
+          encrypto::motion::ShareWrapper share_a{
+              party.In<kArithmeticGmw>(party_id == 0 ? a : kZeroV, 0)};
+          encrypto::motion::ShareWrapper share_b{
+              party.In<kArithmeticGmw>(party_id == 1 ? b : kZeroV, 1)};
+
+          auto share_equal{(share_a == share_b).Out()};
+          auto share_less{(share_a < share_b).Out()};
+          auto share_sign{share_a.Sign().Out()};
+          auto share_minimum{share_a.Minimum(share_b).Out()};
+          auto share_maximum{share_a.Maximum(share_b).Out()};
+
+          party.Run();
+
+          const auto equal{share_equal.As<BitVector<>>()};
+          const auto less{share_less.As<BitVector<>>()};
+          const auto sign{share_sign.As<BitVector<>>()};
+          const auto minimum{share_minimum.As<std::vector<T>>()};
+          const auto maximum{share_maximum.As<std::vector<T>>()};
+          for (auto i = 0u; i < kNumberOfSimd; ++i) {
+            EXPECT_EQ(equal.Get(i), a[i] == b[i]);
+            EXPECT_EQ(less.Get(i), S(a[i]) < S(b[i]));
+            EXPECT_EQ(sign.Get(i), S(a[i]) < 0);
+            EXPECT_EQ(minimum.at(i), T(std::min(S(a[i]), S(b[i]))));
+            EXPECT_EQ(maximum.at(i), T(std::max(S(a[i]), S(b[i]))));
+          }
+          party.Finish();
+        }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(ArithmeticGmwTest, ExtractBits_100_Simd_3_parties) {
+  using T = TypeParam;
+  using S = std::make_signed_t<T>;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{100};
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t kFirstBit{kBitLength / 2 - 1}, kNumberOfBits{kBitLength / 4 + 1};
+  const std::vector<T> kZeroV(kNumberOfSimd, 0);
+  const std::vector<T> a{::RandomVector<T>(kNumberOfSimd)};
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(3, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+  }
+  std::vector<std::future<void>> futures;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &motion_parties, &a, &kZeroV] {
+      auto& party{*motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper share_a{
+          party.In<kArithmeticGmw>(party_id == 0 ? a : kZeroV, 0)};
+
+      auto share_bits{share_a.ExtractBits(kFirstBit, kNumberOfBits).Out()};
+      auto share_msb{share_a.MostSignificantBit().Out()};
+      auto share_sign{share_a.Sign().Out()};
+      EXPECT_THROW(share_a.ExtractBits(kBitLength - 1, 2), std::invalid_argument);
+
+      party.Run();
+
+      const auto bits{share_bits.As<std::vector<BitVector<>>>()};
+      const auto msb{share_msb.As<BitVector<>>()};
+      const auto sign{share_sign.As<BitVector<>>()};
+      ASSERT_EQ(bits.size(), kNumberOfBits);
+      for (auto i = 0u; i < kNumberOfSimd; ++i) {
+        for (auto j = 0u; j < kNumberOfBits; ++j) {
+          EXPECT_EQ(bits.at(j).Get(i), ((a[i] >> (kFirstBit + j)) & 1) == 1);
+        }
+        EXPECT_EQ(msb.Get(i), S(a[i]) < 0);
+        EXPECT_EQ(sign.Get(i), S(a[i]) < 0);
+      }
+      party.Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(ArithmeticGmwTest, PrefixSum_37_Simd_3_parties) {
+  using T = TypeParam;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfSimd{37};
+  const std::vector<T> kZeroV(kNumberOfSimd, 0);
+  const std::vector<T> a{::RandomVector<T>(kNumberOfSimd)};
+  std::vector<T> expected(kNumberOfSimd);
+  std::partial_sum(a.begin(), a.end(), expected.begin(), [](T x, T y) { return T(x + y); });
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(3, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(random_value() % 2 == 1);
+  }
+  std::vector<std::future<void>> futures;
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    futures.emplace_back(
+        std::async(std::launch::async, [party_id, &motion_parties, &a, &expected, &kZeroV] {
+          auto& party{*motion_parties.at(party_id)};
+          encrypto::motion::ShareWrapper share_a{
+              party.In<kArithmeticGmw>(party_id == 0 ? a : kZeroV, 0)};
+
+          auto share_sum{share_a.PrefixSum().Out()};
+
+          party.Run();
+
+          EXPECT_EQ(share_sum.As<std::vector<T>>(), expected);
+          party.Finish();
+        }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(ArithmeticGmw, SelectGreaterThanChunkBitLength) {
+  using encrypto::motion::proto::arithmetic_gmw::SelectGreaterThanChunkBitLength;
+  using namespace std::chrono_literals;
+  for (std::size_t bit_length : {8, 16, 32, 64}) {
+    for (std::size_t number_of_simd : {1, 1'000, 100'000}) {
+      const auto lan{SelectGreaterThanChunkBitLength(bit_length, number_of_simd, 0us, 0)};
+      const auto wan{SelectGreaterThanChunkBitLength(bit_length, number_of_simd, 100ms, 1e8)};
+      EXPECT_GE(lan, 2);
+      EXPECT_LE(wan, std::min<std::size_t>(8, bit_length - 1));
+      // a higher latency favors fewer rounds, i.e., longer chunks
+      EXPECT_GE(wan, lan);
+    }
+  }
+  // single comparisons are bound by the rounds
+  EXPECT_EQ(SelectGreaterThanChunkBitLength(64, 1, 100ms, 1e8), 8);
+  EXPECT_THROW(SelectGreaterThanChunkBitLength(2, 1, 0us, 0), std::invalid_argument);
+}
+
 class PartyGenerator {
  protected:
   void GenerateParties(bool online_after_setup) {
@@ -833,6 +1434,48 @@ TYPED_TEST(TypedHybridAgmwTest, HybridMultiplication_1_1K_Simd_2_parties) {
   for (auto& future : futures) future.get();
 }
 
+TYPED_TEST(TypedHybridAgmwTest, Mux_1K_Simd_2_parties) {
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id]() {
+      auto& party{this->parties_.at(party_id)};
+      std::vector<TypeParam> my_values_1K =
+          party_id == 0 ? this->values_1k_ : std::vector<TypeParam>(this->values_1k_.size(), 0);
+      auto my_bits_1K = party_id == 0
+                            ? this->bits_1k_
+                            : encrypto::motion::BitVector<>(this->bits_1k_.GetSize(), false);
+      // b is a reversed copy of a
+      std::vector<TypeParam> my_reversed_values_1K(my_values_1K.rbegin(), my_values_1K.rend());
+
+      const encrypto::motion::ShareWrapper share_a{
+          party->template In<encrypto::motion::MpcProtocol::kArithmeticGmw>(my_values_1K, 0)};
+      const encrypto::motion::ShareWrapper share_b{
+          party->template In<encrypto::motion::MpcProtocol::kArithmeticGmw>(
+              my_reversed_values_1K, 0)};
+      const encrypto::motion::ShareWrapper share_bits_1K{
+          party->template In<encrypto::motion::MpcProtocol::kBooleanGmw>(my_bits_1K, 0)};
+
+      auto share_output_1K = share_bits_1K.Mux(share_a, share_b).Out();
+
+      party->Run();
+
+      std::vector<TypeParam> circuit_result_1K{share_output_1K.As<std::vector<TypeParam>>()};
+      std::vector<TypeParam> expected_result_1K;
+      expected_result_1K.reserve(circuit_result_1K.size());
+      for (std::size_t i = 0; i < this->values_1k_.size(); ++i) {
+        expected_result_1K.emplace_back(this->bits_1k_[i]
+                                            ? this->values_1k_[i]
+                                            : this->values_1k_[this->values_1k_.size() - 1 - i]);
+      }
+      EXPECT_EQ(circuit_result_1K, expected_result_1K);
+
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
 template <typename T>
 class TypedSignedAgmwTest : public testing::Test,
                             public PartyGenerator,
@@ -897,4 +1540,37 @@ TYPED_TEST(TypedSignedAgmwTest, SignedSubtraction_1K_Simd_2_parties) {
   for (auto& future : futures) future.get();
 }
 
+TYPED_TEST(TypedSignedAgmwTest, SignedAbs_1K_Simd_2_parties) {
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id]() {
+      std::vector<TypeParam> selected_values_a_ =
+          party_id == 0 ? this->values_a_ : std::vector<TypeParam>(this->values_a_.size(), 0);
+
+      encrypto::motion::SecureSignedInteger share_values_a_ =
+          this->parties_.at(party_id)->template In<encrypto::motion::MpcProtocol::kArithmeticGmw>(
+              selected_values_a_, 0);
+
+      auto share_output = share_values_a_.Abs().Out();
+
+      this->parties_.at(party_id)->Run();
+
+      auto circuit_result = share_output.As<std::vector<TypeParam>>();
+      std::vector<TypeParam> expected_result;
+      expected_result.reserve(circuit_result.size());
+      for (std::size_t i = 0; i < this->values_a_.size(); ++i) {
+        using UnsignedType = std::make_unsigned_t<TypeParam>;
+        UnsignedType value = static_cast<UnsignedType>(this->values_a_[i]);
+        expected_result.emplace_back(static_cast<TypeParam>(
+            this->values_a_[i] < 0 ? static_cast<UnsignedType>(UnsignedType(0) - value) : value));
+      }
+      EXPECT_EQ(circuit_result, expected_result);
+
+      this->parties_.at(party_id)->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
 }  // namespace
\ No newline at end of file
@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/arithmetic_algorithm_description.h"
+#include "test_helpers.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+TEST(ArithmeticAlgorithmDescription, FromFile) {
+  const auto path{WriteArithmeticTestCircuit(32)};
+  const auto algorithm{mo::ArithmeticAlgorithmDescription::FromFile(path)};
+  std::filesystem::remove(path);
+  EXPECT_EQ(algorithm.bit_length, 32);
+  EXPECT_EQ(algorithm.number_of_input_wires, 3);
+  EXPECT_EQ(algorithm.number_of_output_wires, 1);
+  EXPECT_EQ(algorithm.number_of_wires, 9);
+  ASSERT_EQ(algorithm.gates.size(), 6);
+
+  const auto& constant_mul{algorithm.gates[1]};
+  EXPECT_EQ(constant_mul.type, mo::ArithmeticOperationType::kConstantMul);
+  EXPECT_EQ(constant_mul.inputs, std::vector<std::size_t>{3});
+  EXPECT_EQ(constant_mul.constant, 3);
+  EXPECT_EQ(constant_mul.output_wire, 4);
+
+  const auto& dot{algorithm.gates[2]};
+  EXPECT_EQ(dot.type, mo::ArithmeticOperationType::kDot);
+  EXPECT_EQ(dot.inputs, (std::vector<std::size_t>{0, 1, 2, 2}));
+  EXPECT_EQ(dot.output_wire, 5);
+
+  EXPECT_THROW(mo::ArithmeticAlgorithmDescription::FromFile(path), std::runtime_error);
+}
+
+TEST(ArithmeticAlgorithmDescription, RejectsInvalidCircuits) {
+  const auto parse = [](const std::string& circuit) {
+    std::istringstream stream(circuit);
+    return mo::ArithmeticAlgorithmDescription::FromStream(stream);
+  };
+  EXPECT_NO_THROW(parse("1 3\n8 2 1\n\n2 1 0 1 2 ADD\n"));
+  // unsupported bit length
+  EXPECT_THROW(parse("1 3\n12 2 1\n\n2 1 0 1 2 ADD\n"), std::runtime_error);
+  // reads wire 3 before it is assigned
+  EXPECT_THROW(parse("1 4\n8 2 1\n\n2 1 0 3 2 ADD\n"), std::runtime_error);
+  // the constant exceeds 8 bits
+  EXPECT_THROW(parse("1 3\n8 2 1\n\n1 1 0 2 CMUL 256\n"), std::runtime_error);
+  // DOT on vectors of different lengths
+  EXPECT_THROW(parse("1 3\n8 2 1\n\n3 1 0 1 1 2 DOT\n"), std::runtime_error);
+  // the output wire is not assigned
+  EXPECT_THROW(parse("1 4\n8 2 1\n\n2 1 0 1 2 MUL\n"), std::runtime_error);
+  // wrong number of gates
+  EXPECT_THROW(parse("2 3\n8 2 1\n\n2 1 0 1 2 ADD\n"), std::runtime_error);
+}
+
+}  // namespace
@@ -24,8 +24,13 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <filesystem>
 
+#include "algorithm/arithmetic_algorithm_description.h"
+#include "base/backend.h"
 #include "base/party.h"
+#include "base/register.h"
+#include "protocols/astra/astra_provider.h"
 #include "protocols/share_wrapper.h"
 #include "test_constants.h"
 #include "test_helpers.h"
@@ -311,4 +316,258 @@ TYPED_TEST(AstraTest, DotPdoruct) {
     });
   }
   for (auto& f : futures) f.get();
-}
\ No newline at end of file
+}
+
+TYPED_TEST(AstraTest, MatrixMultiplication) {
+  // the inner dimension spans more than one block of the local kernel
+  constexpr std::size_t kRows{3}, kInner{70}, kColumns{4}, kSimd{10};
+  std::mt19937_64 mt(this->seed_);
+  std::uniform_int_distribution<TypeParam> dist;
+  std::array<std::vector<std::vector<TypeParam>>, 2> matrices;
+  matrices[0].resize(kRows * kInner);
+  matrices[1].resize(kInner * kColumns);
+  for (auto& matrix : matrices) {
+    for (auto& entry : matrix) {
+      entry.resize(kSimd);
+      for (TypeParam& t : entry) t = dist(mt);
+    }
+  }
+
+  std::vector<std::vector<TypeParam>> expected_result(kRows * kColumns,
+                                                      std::vector<TypeParam>(kSimd, 0));
+  for (std::size_t i = 0; i < kRows; ++i) {
+    for (std::size_t j = 0; j < kColumns; ++j) {
+      for (std::size_t l = 0; l < kInner; ++l) {
+        for (std::size_t s = 0; s < kSimd; ++s) {
+          expected_result[i * kColumns + j][s] += static_cast<TypeParam>(
+              matrices[0][i * kInner + l][s] *
+              static_cast<std::uint64_t>(matrices[1][l * kColumns + j][s]));
+        }
+      }
+    }
+  }
+
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id, &matrices, &expected_result]() {
+      // the first matrix is input by party 0 and the second one by party 1
+      std::array<std::vector<mo::ShareWrapper>, 2> shared_matrices;
+      for (std::size_t matrix_i : {0, 1}) {
+        for (const auto& entry : matrices[matrix_i]) {
+          shared_matrices[matrix_i].emplace_back(
+              party_id == matrix_i
+                  ? this->parties_.at(party_id)->template In<kAstra>(entry, matrix_i)
+                  : this->parties_.at(party_id)->template In<kAstra>(
+                        std::vector<TypeParam>(kSimd, 0), matrix_i));
+        }
+      }
+      auto product =
+          mo::MatrixMultiplication(shared_matrices[0], shared_matrices[1], kRows, kColumns);
+      ASSERT_EQ(product.size(), kRows * kColumns);
+      std::vector<mo::ShareWrapper> outputs;
+      for (auto& entry : product) outputs.emplace_back(entry.Out());
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t entry = 0; entry < outputs.size(); ++entry) {
+        EXPECT_EQ(outputs[entry].template As<std::vector<TypeParam>>(), expected_result[entry]);
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, ArithmeticCircuit) {
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  const auto path{WriteArithmeticTestCircuit(sizeof(TypeParam) * 8)};
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id, &path]() {
+      const auto& registry{this->parties_[party_id]->GetBackend()->GetRegister()};
+      const auto algorithm{registry->GetCachedArithmeticAlgorithmDescription(path)};
+      EXPECT_EQ(registry->GetCachedArithmeticAlgorithmDescription(path), algorithm);
+      const auto& inputs{this->shared_inputs_simd_[party_id]};
+      auto outputs{mo::ShareWrapper::Evaluate(*algorithm, inputs)};
+      ASSERT_EQ(outputs.size(), 1);
+      auto share_output{outputs[0].Out()};
+
+      this->parties_[party_id]->Run();
+
+      const auto circuit_result{share_output.template As<std::vector<TypeParam>>()};
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        const auto& x{this->inputs_simd_};
+        EXPECT_EQ(circuit_result[i], ArithmeticTestCircuit(x[0][i], x[1][i], x[2][i]));
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+  std::filesystem::remove(path);
+}
+
+TYPED_TEST(AstraTest, SetupPipeline) {
+  for (auto& party : this->parties_) {
+    party->GetConfiguration()->SetSetupPipeline(true);
+    party->GetConfiguration()->SetDataflowEvaluation(true);
+  }
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      const auto& inputs{this->shared_inputs_simd_[party_id]};
+      auto share_result = (inputs[0] * inputs[1] + inputs[2]) * inputs[2] - inputs[0];
+      auto share_output = share_result.Out();
+
+      this->parties_[party_id]->Run();
+
+      const std::vector<TypeParam> circuit_result =
+          share_output.template As<std::vector<TypeParam>>();
+      std::vector<TypeParam> expected_result(this->number_of_simd_);
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        const auto& x{this->inputs_simd_};
+        // multiply in TypeParam to avoid overflows of the promoted integers
+        TypeParam t = static_cast<TypeParam>(x[0][i] * static_cast<std::uint64_t>(x[1][i]));
+        t = static_cast<TypeParam>(t + x[2][i]);
+        t = static_cast<TypeParam>(t * static_cast<std::uint64_t>(x[2][i]));
+        expected_result[i] = static_cast<TypeParam>(t - x[0][i]);
+      }
+      EXPECT_EQ(circuit_result, expected_result);
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, ConversionToBooleanGmw) {
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      const auto& inputs{this->shared_inputs_simd_[party_id]};
+      auto share_conversion = inputs[1].template Convert<mo::MpcProtocol::kBooleanGmw>();
+      EXPECT_TRUE(share_conversion->GetProtocol() == mo::MpcProtocol::kBooleanGmw);
+      auto share_output = share_conversion.Out();
+
+      this->parties_[party_id]->Run();
+
+      const auto output_bit_vector{share_output.template As<std::vector<mo::BitVector<>>>()};
+      EXPECT_EQ(mo::ToVectorOutput<TypeParam>(output_bit_vector), this->inputs_simd_[1]);
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, GreaterThan) {
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      const auto& inputs{this->shared_inputs_simd_[party_id]};
+      auto share_output = (inputs[0] > inputs[2]).Out();
+
+      this->parties_[party_id]->Run();
+
+      const auto circuit_result{share_output.template As<mo::BitVector<>>()};
+      ASSERT_EQ(circuit_result.GetSize(), this->number_of_simd_);
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        EXPECT_EQ(circuit_result.Get(i), this->inputs_simd_[0][i] > this->inputs_simd_[2][i]);
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, TruncationAndSign) {
+  using S = std::make_signed_t<TypeParam>;
+  constexpr std::size_t kBitLength{sizeof(TypeParam) * 8};
+  this->GenerateDiverseInputs();
+  // two's complement values in [-2^(l-2), 2^(l-2))
+  for (auto& value : this->inputs_simd_[0]) value = TypeParam(S(value) >> 1);
+  std::array<std::future<void>, 3> futures;
+  for (std::size_t number_of_bits : {std::size_t(0), std::size_t(1), kBitLength - 2}) {
+    // the parties of the fixture can only run once
+    if (number_of_bits != 0) this->InstantiateParties();
+    this->ShareDiverseInputs();
+    for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+      futures[party_id] = std::async([this, party_id, number_of_bits]() {
+        const auto& inputs{this->shared_inputs_simd_[party_id]};
+        auto share_truncation = inputs[0].Truncate(number_of_bits).Out();
+        auto share_sign = inputs[0].Sign().Out();
+
+        this->parties_[party_id]->Run();
+
+        const auto truncation_result{share_truncation.template As<std::vector<TypeParam>>()};
+        const auto sign_result{share_sign.template As<mo::BitVector<>>()};
+        for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+          const TypeParam x{this->inputs_simd_[0][i]};
+          const TypeParam expected_result = TypeParam(S(x) >> number_of_bits);
+          const TypeParam error = truncation_result.at(i) - expected_result;
+          EXPECT_TRUE(error == 0 || error == 1);
+          EXPECT_EQ(sign_result.Get(i), S(x) < 0);
+        }
+        this->parties_[party_id]->Finish();
+      });
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+TYPED_TEST(AstraTest, Verification) {
+  for (auto& party : this->parties_) party->GetBackend()->GetAstraProvider().SetVerification();
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      const auto& inputs{this->shared_inputs_simd_[party_id]};
+      auto share_output = (inputs[0] * inputs[1] + inputs[2]).Out();
+
+      EXPECT_NO_THROW(this->parties_[party_id]->Run());
+
+      const std::vector<TypeParam> circuit_result =
+          share_output.template As<std::vector<TypeParam>>();
+      std::vector<TypeParam> expected_result(this->number_of_simd_);
+      for (std::size_t i = 0; i < this->number_of_simd_; ++i) {
+        const auto& x{this->inputs_simd_};
+        expected_result[i] = static_cast<TypeParam>(
+            static_cast<TypeParam>(x[0][i] * static_cast<std::uint64_t>(x[1][i])) + x[2][i]);
+      }
+      EXPECT_EQ(circuit_result, expected_result);
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+TYPED_TEST(AstraTest, VerificationAbortsOnInconsistentMessages) {
+  for (auto& party : this->parties_) party->GetBackend()->GetAstraProvider().SetVerification();
+  this->GenerateDiverseInputs();
+  this->ShareDiverseInputs();
+  std::array<std::future<void>, 3> futures;
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures[party_id] = std::async([this, party_id]() {
+      auto share_output = this->shared_inputs_simd_[party_id][0].Out();
+      // evaluators 1 and 2 pretend to have received different values
+      if (party_id != 0) {
+        const std::vector<std::uint8_t> data(8, static_cast<std::uint8_t>(party_id));
+        this->parties_[party_id]->GetBackend()->GetAstraProvider().Record(
+            3 - party_id, std::numeric_limits<std::size_t>::max(), data);
+      }
+
+      if (party_id == 0) {
+        EXPECT_NO_THROW(this->parties_[party_id]->Run());
+      } else {
+        EXPECT_THROW(this->parties_[party_id]->Run(), std::runtime_error);
+      }
+      this->parties_[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
@@ -139,3 +139,81 @@ TEST(ObliviousTransfer, BaseOt) {
     }
   }
 }
+
+TEST(ObliviousTransfer, BaseOtResumption) {
+  constexpr std::size_t kNumberOfParties = 3;
+  constexpr std::size_t kNumberOfBaseOts = 128;
+
+  auto run_session = [](std::vector<std::unique_ptr<Party>>& parties) {
+    for (auto& party : parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetBackend()->GetBaseOtProvider().Request(kNumberOfBaseOts);
+      party->GetBackend()->GetBaseOtProvider().PreSetup();
+    }
+    std::vector<std::future<void>> futures;
+    for (auto& party : parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party]() {
+        party->GetBackend()->Synchronize();
+        party->GetBackend()->ComputeBaseOts();
+      }));
+    }
+    std::for_each(std::begin(futures), std::end(futures), [](auto& fut) { fut.get(); });
+  };
+
+  // exported[i][j] are the base OTs of party i with party j
+  using ExportedBaseOts = std::vector<std::vector<std::pair<ReceiverMessage, SenderMessage>>>;
+  auto export_base_ots = [](std::vector<std::unique_ptr<Party>>& parties) {
+    ExportedBaseOts exported(kNumberOfParties);
+    for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+      exported.at(i).resize(kNumberOfParties);
+      for (std::size_t j = 0; j < kNumberOfParties; ++j) {
+        if (i != j) {
+          exported.at(i).at(j) = parties.at(i)->GetBackend()->GetBaseOtProvider().ExportBaseOts(j);
+        }
+      }
+    }
+    return exported;
+  };
+
+  auto first_parties = MakeLocallyConnectedParties(kNumberOfParties, 0);
+  run_session(first_parties);
+  const auto first_base_ots = export_base_ots(first_parties);
+  for (auto& party : first_parties) {
+    party->Finish();
+  }
+
+  auto second_parties = MakeLocallyConnectedParties(kNumberOfParties, 0);
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    auto& base_ot_provider = second_parties.at(i)->GetBackend()->GetBaseOtProvider();
+    const auto& some_base_ots{first_base_ots.at(i).at((i + 1) % kNumberOfParties)};
+    EXPECT_THROW(base_ot_provider.ImportBaseOts(i, some_base_ots.first), std::invalid_argument);
+    for (std::size_t j = 0; j < kNumberOfParties; ++j) {
+      if (i != j) {
+        base_ot_provider.ImportBaseOts(j, first_base_ots.at(i).at(j).first);
+        base_ot_provider.ImportBaseOts(j, first_base_ots.at(i).at(j).second);
+      }
+    }
+  }
+  run_session(second_parties);
+  const auto second_base_ots = export_base_ots(second_parties);
+  for (auto& party : second_parties) {
+    party->Finish();
+  }
+
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    for (std::size_t j = 0; j < kNumberOfParties; ++j) {
+      if (i == j) {
+        continue;
+      }
+      const auto& receiver = second_base_ots.at(i).at(j).first;
+      const auto& sender = second_base_ots.at(j).at(i).second;
+      // the choice bits are reused, but the messages are fresh
+      EXPECT_EQ(receiver.c, first_base_ots.at(i).at(j).first.c);
+      for (std::size_t k = 0; k < kNumberOfBaseOts; ++k) {
+        EXPECT_EQ(receiver.messages_c.at(k),
+                  receiver.c.Get(k) ? sender.messages_1.at(k) : sender.messages_0.at(k));
+        EXPECT_NE(receiver.messages_c.at(k), first_base_ots.at(i).at(j).first.messages_c.at(k));
+      }
+    }
+  }
+}
@@ -23,10 +23,12 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include "algorithm/algorithm_description.h"
 #include "base/party.h"
 #include "protocols/boolean_gmw/boolean_gmw_gate.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/share_wrapper.h"
+#include "secure_type/secure_fixed_width_integer.h"
 #include "secure_type/secure_signed_integer.h"
 #include "test_constants.h"
 #include "test_helpers.h"
@@ -707,6 +709,44 @@ TEST(BooleanGmw, And_64_bit_10_Simd_2_3_parties) {
   }
 }
 
+TEST(BooleanGmw, Scalar_And_Xor_Inv_64_bit_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  for (auto number_of_parties : {2u, 3u}) {
+    // one SIMD value per wire takes the scalar paths of the gates
+    std::vector<encrypto::motion::BitVector<>> global_input_a(64), global_input_b(64);
+    for (auto& wire : global_input_a) wire = encrypto::motion::BitVector<>::SecureRandom(1);
+    for (auto& wire : global_input_b) wire = encrypto::motion::BitVector<>::SecureRandom(1);
+    const std::vector<encrypto::motion::BitVector<>> dummy_input(
+        64, encrypto::motion::BitVector<>(1, false));
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      encrypto::motion::ShareWrapper a{
+          party->In<kBooleanGmw>(party_id == 0 ? global_input_a : dummy_input, 0)};
+      encrypto::motion::ShareWrapper b{
+          party->In<kBooleanGmw>(party_id == 1 ? global_input_b : dummy_input, 1)};
+      auto share_output{(~((a & b) ^ a)).Out()};
+
+      party->Run();
+
+      for (auto j = 0ull; j < 64; ++j) {
+        const bool bit_a{global_input_a[j].Get(0)}, bit_b{global_input_b[j].Get(0)};
+        auto wire = std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+            share_output->GetWires().at(j));
+        assert(wire);
+        EXPECT_EQ(wire->GetValues().Get(0), !((bit_a && bit_b) != bit_a));
+      }
+      party->Finish();
+    }
+  }
+}
+
 TEST(BooleanGmw, Or_1_bit_1_1K_Simd_2_3_parties) {
   for (auto i = 0ull; i < kTestIterations; ++i) {
     constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
@@ -982,4 +1022,564 @@ TYPED_TEST(TypedSignedBgmwTest, SignedSubtraction_1K_Simd_2_parties) {
   for (auto& future : futures) future.get();
 }
 
-}
\ No newline at end of file
+TYPED_TEST(TypedSignedBgmwTest, SignedGreaterThan_1K_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id]() {
+      std::vector<TypeParam> selected_values_a_ =
+          party_id == 0 ? this->values_a_ : std::vector<TypeParam>(this->values_a_.size(), 0);
+      std::vector<TypeParam> selected_values_b_ =
+          party_id == 0 ? this->values_b_ : std::vector<TypeParam>(this->values_b_.size(), 0);
+      // equal values are compared, too
+      selected_values_b_.front() = selected_values_a_.front();
+
+      encrypto::motion::SecureSignedInteger share_values_a_{
+          this->parties_.at(party_id)->template In<kBooleanGmw>(ToInput(selected_values_a_), 0)};
+      encrypto::motion::SecureSignedInteger share_values_b_{
+          this->parties_.at(party_id)->template In<kBooleanGmw>(ToInput(selected_values_b_), 0)};
+
+      auto share_output = (share_values_a_ > share_values_b_).Out();
+
+      this->parties_.at(party_id)->Run();
+
+      const auto circuit_result{share_output.As<encrypto::motion::BitVector<>>()};
+      for (std::size_t i = 0; i < this->values_a_.size(); ++i) {
+        const TypeParam b{i == 0 ? this->values_a_[i] : this->values_b_[i]};
+        EXPECT_EQ(circuit_result.Get(i), this->values_a_[i] > b);
+      }
+
+      this->parties_.at(party_id)->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TYPED_TEST(TypedSignedBgmwTest, SignedAbsAndRightShift_1K_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kShift{3};
+  std::vector<std::future<void>> futures;
+
+  for (auto party_id = 0u; party_id < this->parties_.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [this, party_id]() {
+      auto values{this->values_a_};
+      // the smallest integer is its own absolute value
+      values.front() = std::numeric_limits<TypeParam>::min();
+      std::vector<TypeParam> selected_values =
+          party_id == 0 ? values : std::vector<TypeParam>(values.size(), 0);
+
+      encrypto::motion::SecureSignedInteger share_values{
+          this->parties_.at(party_id)->template In<kBooleanGmw>(ToInput(selected_values), 0)};
+
+      auto share_abs{share_values.Abs().Out()};
+      auto share_shift{share_values.ArithmeticRightShift(kShift).Out()};
+
+      this->parties_.at(party_id)->Run();
+
+      using U = std::make_unsigned_t<TypeParam>;
+      std::vector<TypeParam> expected_abs, expected_shift;
+      for (const auto value : values) {
+        expected_abs.push_back(
+            static_cast<TypeParam>(value < 0 ? U(-static_cast<U>(value)) : U(value)));
+        expected_shift.push_back(static_cast<TypeParam>(value >> kShift));
+      }
+      EXPECT_EQ(share_abs.As<std::vector<TypeParam>>(), expected_abs);
+      EXPECT_EQ(share_shift.As<std::vector<TypeParam>>(), expected_shift);
+
+      this->parties_.at(party_id)->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(BooleanGmw, SecureUInt_20_Bit_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kBitLength = 20, kNumberOfSimd = 100;
+  constexpr std::uint32_t kMask = (1u << kBitLength) - 1;
+  std::mt19937 mersenne_twister(0);
+  std::vector<std::uint32_t> values_a(kNumberOfSimd), values_b(kNumberOfSimd);
+  for (auto& value : values_a) value = mersenne_twister() & kMask;
+  for (auto& value : values_b) value = mersenne_twister() & kMask;
+  // one bit per wire, least significant bit first
+  const auto to_input = [](const std::vector<std::uint32_t>& values) {
+    std::vector<encrypto::motion::BitVector<>> input(kBitLength);
+    for (std::size_t bit = 0; bit < kBitLength; ++bit) {
+      for (const auto value : values) input[bit].Append(((value >> bit) & 1) == 1);
+    }
+    return input;
+  };
+  const auto from_output = [](const std::vector<encrypto::motion::BitVector<>>& output) {
+    std::vector<std::uint32_t> values(output.at(0).GetSize(), 0);
+    for (std::size_t bit = 0; bit < output.size(); ++bit) {
+      for (std::size_t i = 0; i < values.size(); ++i) values[i] |= output[bit].Get(i) << bit;
+    }
+    return values;
+  };
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      const std::vector<std::uint32_t> zeros(kNumberOfSimd, 0);
+      encrypto::motion::SecureUInt<kBitLength> a{motion_parties.at(party_id)->In<kBooleanGmw>(
+          to_input(party_id == 0 ? values_a : zeros), 0)};
+      encrypto::motion::SecureUInt<kBitLength> b{motion_parties.at(party_id)->In<kBooleanGmw>(
+          to_input(party_id == 1 ? values_b : zeros), 1)};
+      const auto sum{(a + b).Out()};
+      const auto difference{(a - b).Out()};
+      const auto product{(a * b).Out()};
+      const auto is_greater{(a > b).Out()};
+
+      motion_parties.at(party_id)->Run();
+
+      const auto sums{from_output(sum.Get().As<std::vector<encrypto::motion::BitVector<>>>())};
+      const auto differences{
+          from_output(difference.Get().As<std::vector<encrypto::motion::BitVector<>>>())};
+      const auto products{
+          from_output(product.Get().As<std::vector<encrypto::motion::BitVector<>>>())};
+      const auto comparisons{is_greater.As<encrypto::motion::BitVector<>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(sums[i], (values_a[i] + values_b[i]) & kMask);
+        EXPECT_EQ(differences[i], (values_a[i] - values_b[i]) & kMask);
+        EXPECT_EQ(products[i], (values_a[i] * values_b[i]) & kMask);
+        EXPECT_EQ(comparisons.Get(i), values_a[i] > values_b[i]);
+      }
+      motion_parties.at(party_id)->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, LayeredEvaluation_And_Xor_1K_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd = 1000;
+  constexpr std::size_t kDepth = 5;
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<encrypto::motion::BitVector<>> global_input(number_of_parties);
+    for (auto& input : global_input) {
+      input = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    }
+    // ((x_0 & x_1) ^ x_1) & x_0 ^ ... alternating over kDepth AND layers
+    auto expected_result = global_input.at(0);
+    for (auto j = 0ull; j < kDepth; ++j) {
+      const auto& other = global_input.at((j + 1) % number_of_parties);
+      expected_result = (expected_result & other) ^ other;
+    }
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetLayeredEvaluation(true);
+    }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      std::vector<encrypto::motion::ShareWrapper> share_input;
+      for (auto j = 0ull; j < number_of_parties; ++j) {
+        if (j == party_id) {
+          share_input.push_back(
+              motion_parties.at(party_id)->In<kBooleanGmw>(global_input.at(j), j));
+        } else {
+          share_input.push_back(motion_parties.at(party_id)->In<kBooleanGmw>(
+              encrypto::motion::BitVector<>(kNumberOfSimd, false), j));
+        }
+      }
+
+      auto share_result = share_input.at(0);
+      for (auto j = 0ull; j < kDepth; ++j) {
+        const auto& other = share_input.at((j + 1) % number_of_parties);
+        share_result = (share_result & other) ^ other;
+      }
+      auto share_output = share_result.Out();
+
+      // inputs, kDepth times (AND, XOR) and the output gate
+      EXPECT_EQ(motion_parties.at(party_id)->GetBackend()->GetRegister()->GetNumberOfLayers(),
+                2 * kDepth + 2);
+
+      motion_parties.at(party_id)->Run();
+
+      auto wire = std::dynamic_pointer_cast<encrypto::motion::proto::boolean_gmw::Wire>(
+          share_output->GetWires().at(0));
+      assert(wire);
+      EXPECT_EQ(wire->GetValues(), expected_result);
+      motion_parties.at(party_id)->Finish();
+    }
+  }
+}
+
+
+
+TEST(BooleanGmw, LayeredEvaluationSortsLayersByLocality) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : motion_parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetLayeredEvaluation(true);
+  }
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    auto& party{motion_parties.at(party_id)};
+    encrypto::motion::ShareWrapper a{
+        party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, party_id == 0), 0)};
+    encrypto::motion::ShareWrapper b{
+        party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, false), 1)};
+    // created in the reverse order of their earliest parents
+    const auto b_and_b{b & b}, a_and_a{a & a}, b_and_a{b & a};
+    const auto b_and_b_twice{b_and_b & b_and_b}, a_and_a_twice{a_and_a & a_and_a};
+    const auto output{(a_and_a_twice ^ b_and_b_twice ^ b_and_a).Out()};
+
+    const auto get_output_wires = [](const auto& layer) {
+      std::vector<const encrypto::motion::Wire*> wires;
+      for (const auto& gate : layer) wires.push_back(gate->GetOutputWires().at(0).get());
+      return wires;
+    };
+    const auto get_wire = [](const auto& share) -> const encrypto::motion::Wire* {
+      return share->GetWires().at(0).get();
+    };
+    auto& register_pointer{*party->GetBackend()->GetRegister()};
+    register_pointer.SortGateLayersByLocality();
+    const auto& layers{register_pointer.GetGateLayers()};
+    EXPECT_GE(layers.size(), 3);
+    if (layers.size() >= 3) {
+      EXPECT_EQ(get_output_wires(layers[1]),
+                (std::vector{get_wire(a_and_a), get_wire(b_and_a), get_wire(b_and_b)}));
+      EXPECT_EQ(get_output_wires(layers[2]),
+                (std::vector{get_wire(a_and_a_twice), get_wire(b_and_b_twice)}));
+    }
+
+    party->Run();
+    EXPECT_EQ(output.As<bool>(), true);
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, FusedXorEvaluation_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd = 100;
+  using encrypto::motion::PrimitiveOperationType;
+  // XOR chains, INVs, a constant wire and ANDs/ORs that depend on each other
+  encrypto::motion::AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = 3;
+  algorithm.gates = {{PrimitiveOperationType::kXor, 0, 1, std::nullopt, 3},
+                     {PrimitiveOperationType::kXor, 3, 2, std::nullopt, 4},
+                     {PrimitiveOperationType::kInv, 4, std::nullopt, std::nullopt, 5},
+                     {PrimitiveOperationType::kAnd, 5, 1, std::nullopt, 6},
+                     {PrimitiveOperationType::kXor, 4, 3, std::nullopt, 7},
+                     {PrimitiveOperationType::kXor, 6, 7, std::nullopt, 8},
+                     {PrimitiveOperationType::kAnd, 8, 4, std::nullopt, 9},
+                     {PrimitiveOperationType::kXor, 9, 9, std::nullopt, 10},
+                     {PrimitiveOperationType::kInv, 10, std::nullopt, std::nullopt, 11},
+                     {PrimitiveOperationType::kOr, 9, 0, std::nullopt, 12},
+                     {PrimitiveOperationType::kXor, 12, 11, std::nullopt, 13}};
+  algorithm.number_of_gates = algorithm.gates.size();
+  algorithm.number_of_wires = 3 + algorithm.number_of_gates;
+  algorithm.number_of_output_wires = 4;
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<encrypto::motion::BitVector<>> global_input(3);
+    for (auto& input : global_input) {
+      input = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    }
+    const auto &x_0{global_input[0]}, &x_1{global_input[1]}, &x_2{global_input[2]};
+    const auto w_4{x_0 ^ x_1 ^ x_2};
+    const auto w_9{((~w_4 & x_1) ^ x_2) & w_4};
+    const auto w_12{w_9 | x_0};
+    const std::vector<encrypto::motion::BitVector<>> expected_result{
+        encrypto::motion::BitVector<>(kNumberOfSimd, false),
+        encrypto::motion::BitVector<>(kNumberOfSimd, true), w_12, ~w_12};
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      const std::vector<encrypto::motion::BitVector<>> dummy_input(
+          3, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+      encrypto::motion::ShareWrapper share_input{motion_parties.at(party_id)->In<kBooleanGmw>(
+          party_id == 0 ? global_input : dummy_input, 0)};
+      auto share_output = share_input.Evaluate(algorithm).Out();
+
+      // all XORs and INVs are fused, w_6, w_9 and the OR are in consecutive AND layers
+      const auto& gates{motion_parties.at(party_id)->GetBackend()->GetRegister()->GetGates()};
+      std::size_t number_of_and_gates{0};
+      for (const auto& gate : gates) {
+        EXPECT_FALSE(std::dynamic_pointer_cast<proto::boolean_gmw::XorGate>(gate));
+        EXPECT_FALSE(std::dynamic_pointer_cast<proto::boolean_gmw::InvGate>(gate));
+        if (std::dynamic_pointer_cast<proto::boolean_gmw::AndGate>(gate)) ++number_of_and_gates;
+      }
+      EXPECT_EQ(number_of_and_gates, 3u);
+
+      motion_parties.at(party_id)->Run();
+
+      EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_result);
+      motion_parties.at(party_id)->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, ConstantFolding_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr auto kBooleanConstant = encrypto::motion::MpcProtocol::kBooleanConstant;
+  constexpr std::size_t kNumberOfSimd = 100, kNumberOfWires = 3;
+  using encrypto::motion::PrimitiveOperationType;
+  // the AND and the OR with the constant 1 are folded, only the last AND remains
+  encrypto::motion::AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = 2;
+  algorithm.gates = {{PrimitiveOperationType::kAnd, 0, 1, std::nullopt, 2},
+                     {PrimitiveOperationType::kOr, 2, 1, std::nullopt, 3},
+                     {PrimitiveOperationType::kXor, 3, 0, std::nullopt, 4},
+                     {PrimitiveOperationType::kAnd, 4, 2, std::nullopt, 5}};
+  algorithm.number_of_gates = algorithm.gates.size();
+  algorithm.number_of_wires = 2 + algorithm.number_of_gates;
+  algorithm.number_of_output_wires = 2;
+
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<encrypto::motion::BitVector<>> global_input(kNumberOfWires);
+    for (auto& input : global_input) {
+      input = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    }
+    // constant 0, constant 1 and a constant that differs between the SIMD values
+    const std::vector<encrypto::motion::BitVector<>> constant{
+        encrypto::motion::BitVector<>(kNumberOfSimd, false),
+        encrypto::motion::BitVector<>(kNumberOfSimd, true),
+        encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd)};
+    std::vector<encrypto::motion::BitVector<>> expected_and, expected_xor, expected_or;
+    for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+      expected_and.emplace_back(global_input[i] & constant[i]);
+      expected_xor.emplace_back(global_input[i] ^ constant[i]);
+      expected_or.emplace_back(global_input[i] | constant[i]);
+    }
+    const std::vector<encrypto::motion::BitVector<>> expected_evaluation{
+        ~global_input[0], encrypto::motion::BitVector<>(kNumberOfSimd, false)};
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      const std::vector<encrypto::motion::BitVector<>> dummy_input(
+          kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+      encrypto::motion::ShareWrapper x{
+          party->In<kBooleanGmw>(party_id == 0 ? global_input : dummy_input, 0)};
+      encrypto::motion::ShareWrapper c{party->In<kBooleanConstant>(constant)};
+
+      auto share_and{(x & c).Out()};
+      auto share_xor{(c ^ x).Out()};
+      auto share_or{(x | c).Out()};
+      auto share_constant{(c & ~c)};
+      auto share_evaluation{encrypto::motion::ShareWrapper::Evaluate(
+                                algorithm, {x.GetWire(0), c.GetWire(1)})
+                                .Out()};
+
+      // no AND gate is needed for the constants, one for the evaluated circuit
+      std::size_t number_of_and_gates{0};
+      for (const auto& gate : party->GetBackend()->GetRegister()->GetGates()) {
+        if (std::dynamic_pointer_cast<proto::boolean_gmw::AndGate>(gate)) ++number_of_and_gates;
+      }
+      EXPECT_EQ(number_of_and_gates, 1u);
+      EXPECT_TRUE(share_constant->GetProtocol() == kBooleanConstant);
+
+      party->Run();
+
+      EXPECT_EQ(share_and.As<std::vector<encrypto::motion::BitVector<>>>(), expected_and);
+      EXPECT_EQ(share_xor.As<std::vector<encrypto::motion::BitVector<>>>(), expected_xor);
+      EXPECT_EQ(share_or.As<std::vector<encrypto::motion::BitVector<>>>(), expected_or);
+      EXPECT_EQ(share_constant.As<std::vector<encrypto::motion::BitVector<>>>(),
+                std::vector<encrypto::motion::BitVector<>>(
+                    kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, false)));
+      EXPECT_EQ(share_evaluation.As<std::vector<encrypto::motion::BitVector<>>>(),
+                expected_evaluation);
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, LookupTable_100_Simd_2_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd = 100, kNumberOfInputs = 3, kNumberOfOutputs = 2;
+  using encrypto::motion::PrimitiveOperationType;
+  std::vector<encrypto::motion::BitVector<>> truth_tables(kNumberOfOutputs);
+  for (auto& truth_table : truth_tables) {
+    truth_table = encrypto::motion::BitVector<>::SecureRandom(1 << kNumberOfInputs);
+  }
+  // both kLuts share one gate, the XOR combines their outputs
+  encrypto::motion::AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = kNumberOfInputs;
+  algorithm.gates = {{PrimitiveOperationType::kLut, 0, std::nullopt, std::nullopt, 3, {0, 1, 2},
+                      truth_tables[0]},
+                     {PrimitiveOperationType::kLut, 0, std::nullopt, std::nullopt, 4, {0, 1, 2},
+                      truth_tables[1]},
+                     {PrimitiveOperationType::kXor, 3, 4, std::nullopt, 5}};
+  algorithm.number_of_gates = algorithm.gates.size();
+  algorithm.number_of_wires = kNumberOfInputs + algorithm.number_of_gates;
+  algorithm.number_of_output_wires = 1;
+
+  std::vector<encrypto::motion::BitVector<>> global_input(kNumberOfInputs);
+  for (auto& input : global_input) {
+    input = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+  }
+  std::vector<encrypto::motion::BitVector<>> expected_result(
+      kNumberOfOutputs, encrypto::motion::BitVector<>(kNumberOfSimd));
+  for (std::size_t simd_i = 0; simd_i < kNumberOfSimd; ++simd_i) {
+    std::size_t x{0};
+    for (std::size_t input_i = 0; input_i < kNumberOfInputs; ++input_i) {
+      if (global_input[input_i].Get(simd_i)) x |= 1 << input_i;
+    }
+    for (std::size_t output_i = 0; output_i < kNumberOfOutputs; ++output_i) {
+      expected_result[output_i].Set(truth_tables[output_i].Get(x), simd_i);
+    }
+  }
+  const std::vector<encrypto::motion::BitVector<>> expected_evaluation{expected_result[0] ^
+                                                                       expected_result[1]};
+
+  std::vector<PartyPointer> motion_parties(
+      std::move(MakeLocallyConnectedParties(2, kPortOffset)));
+  for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+  for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+    auto& party{motion_parties.at(party_id)};
+    const std::vector<encrypto::motion::BitVector<>> dummy_input(
+        kNumberOfInputs, encrypto::motion::BitVector<>(kNumberOfSimd, false));
+    encrypto::motion::ShareWrapper x{
+        party->In<kBooleanGmw>(party_id == 1 ? global_input : dummy_input, 1)};
+
+    auto share_output{x.LookupTable(truth_tables).Out()};
+    auto share_evaluation{x.Evaluate(algorithm).Out()};
+
+    std::size_t number_of_lookup_table_gates{0};
+    for (const auto& gate : party->GetBackend()->GetRegister()->GetGates()) {
+      EXPECT_FALSE(std::dynamic_pointer_cast<proto::boolean_gmw::AndGate>(gate));
+      if (std::dynamic_pointer_cast<proto::boolean_gmw::LookupTableGate>(gate)) {
+        ++number_of_lookup_table_gates;
+      }
+    }
+    EXPECT_EQ(number_of_lookup_table_gates, 2u);
+
+    party->Run();
+
+    EXPECT_EQ(share_output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_result);
+    EXPECT_EQ(share_evaluation.As<std::vector<encrypto::motion::BitVector<>>>(),
+              expected_evaluation);
+    party->Finish();
+  }
+}
+
+TEST(BooleanGmw, MultiInputAnd_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfSimd = 100, kNumberOfInputs = 13, kNumberOfWires = 2;
+  for (auto number_of_parties : {2u, 3u}) {
+    // biased towards 1, s.t. the ANDs are not almost always 0
+    std::vector<encrypto::motion::BitVector<>> global_input(kNumberOfInputs * kNumberOfWires);
+    for (auto& input : global_input) {
+      input = encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd) |
+              encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd) |
+              encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd);
+    }
+    std::vector<encrypto::motion::BitVector<>> expected_and(
+        kNumberOfWires, encrypto::motion::BitVector<>(kNumberOfSimd, true));
+    encrypto::motion::BitVector<> expected_or(kNumberOfSimd, false);
+    for (std::size_t i = 0; i < kNumberOfInputs; ++i) {
+      for (std::size_t w = 0; w < kNumberOfWires; ++w) {
+        expected_and[w] &= global_input[i * kNumberOfWires + w];
+      }
+      expected_or |= ~global_input[i * kNumberOfWires];
+    }
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      const std::vector<encrypto::motion::BitVector<>> dummy_input(
+          global_input.size(), encrypto::motion::BitVector<>(kNumberOfSimd, false));
+      const auto wires{encrypto::motion::ShareWrapper(
+                           party->In<kBooleanGmw>(party_id == 0 ? global_input : dummy_input, 0))
+                           .Split()};
+      std::vector<encrypto::motion::ShareWrapper> inputs, first_wires;
+      for (std::size_t i = 0; i < kNumberOfInputs; ++i) {
+        inputs.push_back(encrypto::motion::ShareWrapper::Concatenate(
+            wires.begin() + i * kNumberOfWires, wires.begin() + (i + 1) * kNumberOfWires));
+        first_wires.push_back(~wires[i * kNumberOfWires]);
+      }
+
+      // 13 inputs need 3 + 1 gates of fan-in 4 in 2 levels
+      auto share_and{encrypto::motion::ShareWrapper::MultiInputAnd(inputs).Out()};
+      std::size_t number_of_multi_input_and_gates{0};
+      for (const auto& gate : party->GetBackend()->GetRegister()->GetGates()) {
+        if (std::dynamic_pointer_cast<proto::boolean_gmw::MultiInputAndGate>(gate)) {
+          ++number_of_multi_input_and_gates;
+        }
+      }
+      EXPECT_EQ(number_of_multi_input_and_gates, 4u);
+      auto share_or{encrypto::motion::ShareWrapper::Concatenate(first_wires).OrReduce(8).Out()};
+
+      party->Run();
+
+      EXPECT_EQ(share_and.As<std::vector<encrypto::motion::BitVector<>>>(), expected_and);
+      EXPECT_EQ(share_or.As<encrypto::motion::BitVector<>>(), expected_or);
+      party->Finish();
+    }
+  }
+}
+
+TEST(BooleanGmw, MultiInputXor_100_Simd_2_3_parties) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr auto kBooleanConstant = encrypto::motion::MpcProtocol::kBooleanConstant;
+  constexpr std::size_t kNumberOfSimd = 100, kNumberOfWires = 3;
+  for (auto number_of_parties : {2u, 3u}) {
+    std::vector<encrypto::motion::BitVector<>> global_input;
+    for (std::size_t i = 0; i < 4 * kNumberOfWires; ++i) {
+      global_input.push_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+    }
+    // one wire of the constant is set in all SIMD values and is an inversion
+    const std::vector<encrypto::motion::BitVector<>> constant{
+        encrypto::motion::BitVector<>(kNumberOfSimd, true),
+        encrypto::motion::BitVector<>(kNumberOfSimd, false),
+        encrypto::motion::BitVector<>(kNumberOfSimd, false)};
+    std::vector<encrypto::motion::BitVector<>> expected_xor(constant);
+    for (std::size_t i = 0; i < 4; ++i) {
+      for (std::size_t w = 0; w < kNumberOfWires; ++w) {
+        expected_xor[w] ^= global_input[i * kNumberOfWires + w];
+      }
+    }
+
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties, kPortOffset)));
+    for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+#pragma omp parallel for num_threads(motion_parties.size() + 1)
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      auto& party{motion_parties.at(party_id)};
+      const std::vector<encrypto::motion::BitVector<>> dummy_input(
+          global_input.size(), encrypto::motion::BitVector<>(kNumberOfSimd, false));
+      const auto wires{encrypto::motion::ShareWrapper(
+                           party->In<kBooleanGmw>(party_id == 0 ? global_input : dummy_input, 0))
+                           .Split()};
+      std::vector<encrypto::motion::ShareWrapper> inputs;
+      for (std::size_t i = 0; i < 4; ++i) {
+        inputs.push_back(encrypto::motion::ShareWrapper::Concatenate(
+            wires.begin() + i * kNumberOfWires, wires.begin() + (i + 1) * kNumberOfWires));
+      }
+      encrypto::motion::ShareWrapper c{party->In<kBooleanConstant>(constant)};
+
+      // the chain and the constant are a single fused XOR gate
+      const auto number_of_gates{party->GetBackend()->GetRegister()->GetGates().size()};
+      encrypto::motion::ShareWrapper share_xor{encrypto::motion::XorExpression(inputs[0]) ^
+                                               inputs[1] ^ c ^ inputs[2] ^ inputs[3]};
+      EXPECT_EQ(party->GetBackend()->GetRegister()->GetGates().size(), number_of_gates + 1);
+      auto output{share_xor.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(output.As<std::vector<encrypto::motion::BitVector<>>>(), expected_xor);
+      party->Finish();
+    }
+  }
+}
+
+}
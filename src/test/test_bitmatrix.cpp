@@ -26,11 +26,12 @@
 
 #include <gtest/gtest.h>
 
+#include "primitives/pseudo_random_generator.h"
 #include "utility/bit_matrix.h"
+#include "utility/block.h"
 
 #include "test_constants.h"
 
-#include <emmintrin.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -165,4 +166,55 @@ TEST(BitMatrix, Transpose128InPlaceOnRawPointersBitSlicing) {
   }
 }*/
 
+// hashes the lower 128 bits of column like the KK13 OT extension and returns the first bitlength
+// bits of the result
+encrypto::motion::BitVector<> HashColumn(encrypto::motion::primitives::Prg& prg,
+                                         const encrypto::motion::BitVector<>& column,
+                                         std::size_t bitlength) {
+  auto block{encrypto::motion::Block128::MakeFromMemory(column.GetData().data())};
+  prg.Mmo(block.data());
+  return encrypto::motion::BitVector<>(block.data(), bitlength);
+}
+
+TEST(BitMatrix, Transpose256AndEncryptHashesAllColumnsOfABlock) {
+  constexpr std::size_t kNumberOfRows{256}, kNumberOfColumns{512}, kNumberOfOts{300};
+  constexpr std::size_t kNumberOfMessages{5}, kBitlength{100};
+  std::vector<encrypto::motion::AlignedBitVector> rows(kNumberOfRows);
+  std::array<const std::byte*, kNumberOfRows> pointers;
+  for (std::size_t i = 0; i < kNumberOfRows; ++i) {
+    rows[i] = encrypto::motion::AlignedBitVector::SecureRandom(kNumberOfColumns);
+    pointers[i] = rows[i].GetData().data();
+  }
+  const auto key{encrypto::motion::BitVector<>::SecureRandom(128)};
+  encrypto::motion::primitives::Prg prg;
+  prg.SetKey(key.GetData().data());
+  const std::vector<std::size_t> bitlengths(kNumberOfOts, kBitlength);
+
+  std::vector<encrypto::motion::BitVector<>> receiver_outputs(kNumberOfOts);
+  encrypto::motion::BitMatrix::ReceiverTranspose256AndEncrypt(pointers, receiver_outputs, prg,
+                                                              kNumberOfColumns, bitlengths, 2);
+
+  const auto choices{encrypto::motion::BitVector<>::SecureRandom(kNumberOfRows)};
+  std::vector<encrypto::motion::AlignedBitVector> x_a(kNumberOfMessages);
+  for (auto& codeword : x_a) {
+    codeword = encrypto::motion::AlignedBitVector::SecureRandom(kNumberOfRows);
+  }
+  std::vector<std::vector<encrypto::motion::BitVector<>>> sender_outputs(
+      kNumberOfMessages, std::vector<encrypto::motion::BitVector<>>(kNumberOfOts));
+  encrypto::motion::BitMatrix::SenderTranspose256AndEncrypt(
+      pointers, sender_outputs, choices, x_a, prg, kNumberOfColumns, bitlengths, 2);
+
+  for (std::size_t c = 0; c < kNumberOfOts; ++c) {
+    encrypto::motion::BitVector<> column(kNumberOfRows);
+    for (std::size_t r = 0; r < kNumberOfRows; ++r) {
+      column.Set(rows[r].Get(c), r);
+    }
+    EXPECT_EQ(receiver_outputs[c], HashColumn(prg, column, kBitlength));
+    for (std::size_t n = 0; n < kNumberOfMessages; ++n) {
+      const encrypto::motion::BitVector<> masked_codeword{choices & x_a[n]};
+      EXPECT_EQ(sender_outputs[n][c], HashColumn(prg, column ^ masked_codeword, kBitlength));
+    }
+  }
+}
+
 }  // namespace
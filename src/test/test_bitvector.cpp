@@ -286,6 +286,36 @@ TEST(BitVector, Append) {
   }
 }
 
+TEST(BitVector, InlineStorage) {
+  constexpr auto kInlineBits{encrypto::motion::kBitVectorInlineBytes * 8};
+  std::mt19937_64 mersenne_twister(0);
+  std::uniform_int_distribution<uint64_t> distribution(0, 1);
+  std::vector<bool> stl_vector;
+  encrypto::motion::BitVector<> bit_vector;
+  // grow across the boundary between the inline buffer and the heap
+  for (auto i = 0ull; i < 2 * kInlineBits; ++i) {
+    stl_vector.push_back(distribution(mersenne_twister));
+    bit_vector.Append(stl_vector.back());
+
+    auto copy{bit_vector};
+    auto aligned_copy{encrypto::motion::AlignedBitVector(bit_vector)};
+    auto moved{std::move(copy)};
+    ASSERT_EQ(moved, bit_vector);
+    ASSERT_EQ(aligned_copy, bit_vector);
+    for (auto j = 0ull; j <= i; ++j) ASSERT_EQ(moved.Get(j), stl_vector.at(j));
+  }
+
+  std::vector<std::byte> bytes(encrypto::motion::BitsToBytes(kInlineBits), std::byte(0xFF));
+  encrypto::motion::BitVector<> from_bytes(std::move(bytes), kInlineBits - 3);
+  EXPECT_EQ(from_bytes.GetSize(), kInlineBits - 3);
+  EXPECT_EQ(from_bytes.HammingWeight(), kInlineBits - 3);
+
+  bit_vector.Clear();
+  EXPECT_TRUE(bit_vector.Empty());
+  bit_vector.Append(true);
+  EXPECT_TRUE(bit_vector.Get(0));
+}
+
 TEST(BitVector, Subset) {
   std::mt19937_64 mersenne_twister(0);
   for (std::size_t test_i = 0; test_i < kTestIterations; ++test_i) {
@@ -520,6 +550,28 @@ TEST(BitSpan, AllBitsOperations) {
   }
 }
 
+TEST(BitSpan, Subspan) {
+  for (std::size_t test_i = 0; test_i < kTestIterations; ++test_i) {
+    for (auto size = 1ull; size <= 100'000u; size *= 10) {
+      auto bit_vector(encrypto::motion::BitVector<>::RandomSeeded(size, size));
+      encrypto::motion::BitSpan bit_span{bit_vector};
+      for (std::size_t from = 0; from < size; from += 8) {
+        const auto to = std::min(from + 64, static_cast<std::size_t>(size));
+        auto subspan = bit_span.Subspan(from, to);
+        ASSERT_EQ(subspan.GetSize(), to - from);
+        ASSERT_EQ(bit_vector.Subset(from, to), subspan);
+        // the subspan is a view into the underlying buffer
+        ASSERT_EQ(subspan.GetData(), bit_vector.GetData().data() + from / 8);
+      }
+      if (size > 8) {
+        ASSERT_THROW(bit_span.Subspan(1, 8), std::invalid_argument);
+        ASSERT_THROW(bit_span.Subspan(0, 7), std::invalid_argument);
+      }
+      ASSERT_THROW(bit_span.Subspan(0, size + 1), std::out_of_range);
+    }
+  }
+}
+
 TEST(BitSpan, SpanSpanOperations) {
   for (std::size_t test_i = 0; test_i < kTestIterations; ++test_i) {
     for (auto size = 1ull; size <= 100'000u; size *= 10) {
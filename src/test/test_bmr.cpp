@@ -33,6 +33,7 @@
 
 #include "base/party.h"
 #include "multiplication_triple/mt_provider.h"
+#include "protocols/bmr/bmr_provider.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
 #include "protocols/share_wrapper.h"
@@ -347,6 +348,149 @@ TEST_P(BmrHeavyTest, And) {
   }
 }
 
+TEST_P(BmrHeavyTest, AndStreamed) {
+  constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
+  constexpr std::size_t kDepth{8};
+  std::srand(0);
+  const std::size_t output_owner = std::rand() % number_of_parties_;
+  std::vector<std::vector<encrypto::motion::BitVector<>>> global_input(number_of_parties_);
+  for (auto& bv_v : global_input) {
+    bv_v.resize(number_of_wires_);
+    for (auto& bv : bv_v) {
+      bv = encrypto::motion::BitVector<>::SecureRandom(number_of_simd_);
+    }
+  }
+  std::vector<encrypto::motion::BitVector<>> dummy_input(
+      number_of_wires_, encrypto::motion::BitVector<>(number_of_simd_, false));
+
+  try {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties_, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(this->online_after_setup_);
+      // small chunks so that the circuit spans several of them
+      party->GetBackend()->GetBmrProvider().SetGarbledTablesChunkSize(256);
+    }
+    std::vector<std::thread> threads;
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      threads.emplace_back(
+          [party_id, &motion_parties, this, output_owner, &global_input, &dummy_input]() {
+            std::vector<encrypto::motion::ShareWrapper> share_input;
+
+            for (auto j = 0ull; j < this->number_of_parties_; ++j) {
+              if (j == motion_parties.at(party_id)->GetConfiguration()->GetMyId()) {
+                share_input.push_back(motion_parties.at(party_id)->In<kBmr>(global_input.at(j), j));
+              } else {
+                share_input.push_back(motion_parties.at(party_id)->In<kBmr>(dummy_input, j));
+              }
+            }
+
+            // a chain of ANDs over the inputs of all parties
+            auto share_and = share_input.at(0) & share_input.at(1);
+            for (auto j = 2ull; j < kDepth; ++j) {
+              share_and = share_and & share_input.at(j % this->number_of_parties_);
+            }
+
+            auto share_output = share_and.Out(output_owner);
+
+            motion_parties.at(party_id)->Run();
+
+            if (party_id == output_owner) {
+              for (auto j = 0ull; j < share_output->GetWires().size(); ++j) {
+                auto wire_single = std::dynamic_pointer_cast<encrypto::motion::proto::bmr::Wire>(
+                    share_output->GetWires().at(j));
+                assert(wire_single);
+
+                std::vector<encrypto::motion::BitVector<>> global_input_single;
+                for (auto k = 0ull; k < this->number_of_parties_; ++k) {
+                  global_input_single.push_back(global_input.at(k).at(j));
+                }
+
+                EXPECT_EQ(wire_single->GetPublicValues(),
+                          encrypto::motion::BitVector<>::AndBitVectors(global_input_single));
+              }
+            }
+            motion_parties.at(party_id)->Finish();
+          });
+    }
+    for (auto& t : threads)
+      if (t.joinable()) t.join();
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+TEST_P(BmrHeavyTest, AndInputsInSetup) {
+  constexpr auto kBmr = encrypto::motion::MpcProtocol::kBmr;
+  std::srand(0);
+  const std::size_t output_owner = std::rand() % number_of_parties_;
+  std::vector<std::vector<encrypto::motion::BitVector<>>> global_input(number_of_parties_);
+  for (auto& bv_v : global_input) {
+    bv_v.resize(number_of_wires_);
+    for (auto& bv : bv_v) {
+      bv = encrypto::motion::BitVector<>::SecureRandom(number_of_simd_);
+    }
+  }
+  std::vector<encrypto::motion::BitVector<>> dummy_input(
+      number_of_wires_, encrypto::motion::BitVector<>(number_of_simd_, false));
+
+  try {
+    std::vector<PartyPointer> motion_parties(
+        std::move(MakeLocallyConnectedParties(number_of_parties_, kPortOffset)));
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetConfiguration()->SetOnlineAfterSetup(this->online_after_setup_);
+      party->GetBackend()->GetBmrProvider().SetInputsInSetup();
+    }
+    std::vector<std::thread> threads;
+    for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+      threads.emplace_back(
+          [party_id, &motion_parties, this, output_owner, &global_input, &dummy_input]() {
+            std::vector<encrypto::motion::ShareWrapper> share_input;
+
+            for (auto j = 0ull; j < this->number_of_parties_; ++j) {
+              if (j == motion_parties.at(party_id)->GetConfiguration()->GetMyId()) {
+                share_input.push_back(motion_parties.at(party_id)->In<kBmr>(global_input.at(j), j));
+              } else {
+                share_input.push_back(motion_parties.at(party_id)->In<kBmr>(dummy_input, j));
+              }
+            }
+
+            auto share_and = share_input.at(0) & share_input.at(1);
+            for (auto j = 2ull; j < this->number_of_parties_; ++j) {
+              share_and = share_and & share_input.at(j);
+            }
+
+            auto share_output = share_and.Out(output_owner);
+
+            motion_parties.at(party_id)->Run();
+
+            if (party_id == output_owner) {
+              for (auto j = 0ull; j < share_output->GetWires().size(); ++j) {
+                auto wire_single = std::dynamic_pointer_cast<encrypto::motion::proto::bmr::Wire>(
+                    share_output->GetWires().at(j));
+                assert(wire_single);
+
+                std::vector<encrypto::motion::BitVector<>> global_input_single;
+                for (auto k = 0ull; k < this->number_of_parties_; ++k) {
+                  global_input_single.push_back(global_input.at(k).at(j));
+                }
+
+                EXPECT_EQ(wire_single->GetPublicValues(),
+                          encrypto::motion::BitVector<>::AndBitVectors(global_input_single));
+              }
+            }
+            motion_parties.at(party_id)->Finish();
+          });
+    }
+    for (auto& t : threads)
+      if (t.joinable()) t.join();
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
 TEST_P(BmrHeavyTest, Or) {
   EXPECT_NE(number_of_parties_, 0);
   EXPECT_NE(number_of_wires_, 0);
@@ -299,4 +299,47 @@ TEST_F(HammingWeightTest, EightBitsAllPossibleInputs) {
   for (auto& f : futures) f.get();
 }
 
+TEST_F(HammingWeightTest, SimdInBooleanGmwAndArithmeticGmw) {
+  constexpr std::size_t kNumberOfBits{100}, kNumberOfSimd{10};
+  std::vector<encrypto::motion::BitVector<>> bits;
+  for (std::size_t i = 0; i < kNumberOfBits; ++i) {
+    bits.emplace_back(encrypto::motion::BitVector<>::RandomSeeded(kNumberOfSimd, i));
+  }
+  std::vector<std::uint16_t> expected_values(kNumberOfSimd, 0);
+  for (std::size_t j = 0; j < kNumberOfSimd; ++j) {
+    for (const auto& wire : bits) expected_values[j] += wire.Get(j);
+  }
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &bits, &expected_values,
+                                                         this]() {
+      auto& party{this->parties_[party_id]};
+      const std::vector<encrypto::motion::BitVector<>> dummy_bits(
+          kNumberOfBits, encrypto::motion::BitVector<>(kNumberOfSimd));
+      encrypto::motion::ShareWrapper input{
+          party->In<encrypto::motion::MpcProtocol::kBooleanGmw>(party_id == 0 ? bits : dummy_bits,
+                                                                0)};
+      auto boolean_output{encrypto::motion::algorithm::HammingWeight(input).Out()};
+      auto arithmetic_output{
+          encrypto::motion::algorithm::ArithmeticHammingWeight<std::uint16_t>(input).Out()};
+
+      party->Run();
+
+      const auto computed_bvs{boolean_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      EXPECT_EQ(computed_bvs.size(), std::bit_width(kNumberOfBits));
+      for (std::size_t j = 0; j < kNumberOfSimd; ++j) {
+        std::uint16_t computed_value{0};
+        for (std::size_t bit_k = 0; bit_k < computed_bvs.size(); ++bit_k) {
+          if (computed_bvs[bit_k].Get(j)) computed_value += std::uint16_t(1) << bit_k;
+        }
+        EXPECT_EQ(computed_value, expected_values[j]);
+      }
+      EXPECT_EQ(arithmetic_output.As<std::vector<std::uint16_t>>(), expected_values);
+      party->Finish();
+    }));
+  }
+
+  for (auto& f : futures) f.get();
+}
+
 }  // namespace
\ No newline at end of file
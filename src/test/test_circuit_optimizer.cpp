@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_optimizer.h"
+#include "utility/config.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+using T = mo::PrimitiveOperationType;
+
+std::vector<bool> EvaluatePlain(const mo::AlgorithmDescription& algorithm,
+                                const std::vector<bool>& inputs) {
+  std::vector<bool> wires(algorithm.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  for (const auto& gate : algorithm.gates) {
+    switch (gate.type) {
+      case T::kXor:
+        wires[gate.output_wire] = wires[gate.parent_a] != wires[*gate.parent_b];
+        break;
+      case T::kAnd:
+        wires[gate.output_wire] = wires[gate.parent_a] && wires[*gate.parent_b];
+        break;
+      case T::kOr:
+        wires[gate.output_wire] = wires[gate.parent_a] || wires[*gate.parent_b];
+        break;
+      case T::kInv:
+        wires[gate.output_wire] = !wires[gate.parent_a];
+        break;
+      default:
+        throw std::invalid_argument("Unsupported gate");
+    }
+  }
+  return {wires.end() - algorithm.number_of_output_wires, wires.end()};
+}
+
+mo::PrimitiveOperation Gate(T type, std::size_t parent_a, std::optional<std::size_t> parent_b,
+                            std::size_t output_wire) {
+  return {.type = type, .parent_a = parent_a, .parent_b = parent_b, .output_wire = output_wire};
+}
+
+// builds a circuit of number_of_inputs inputs of parent a, whose last gates are the outputs
+mo::AlgorithmDescription MakeCircuit(std::size_t number_of_inputs, std::size_t number_of_outputs,
+                                     const std::vector<mo::PrimitiveOperation>& gates) {
+  mo::AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = number_of_inputs;
+  algorithm.number_of_output_wires = number_of_outputs;
+  algorithm.number_of_gates = gates.size();
+  algorithm.number_of_wires = number_of_inputs + gates.size();
+  algorithm.gates = gates;
+  return algorithm;
+}
+
+void ExpectEquivalent(const mo::AlgorithmDescription& original,
+                      const mo::AlgorithmDescription& optimized, std::size_t number_of_tests) {
+  const std::size_t number_of_inputs{original.number_of_input_wires_parent_a +
+                                     original.number_of_input_wires_parent_b.value_or(0)};
+  ASSERT_EQ(optimized.number_of_input_wires_parent_a, original.number_of_input_wires_parent_a);
+  ASSERT_EQ(optimized.number_of_input_wires_parent_b, original.number_of_input_wires_parent_b);
+  ASSERT_EQ(optimized.number_of_output_wires, original.number_of_output_wires);
+  ASSERT_EQ(optimized.number_of_wires, number_of_inputs + optimized.gates.size());
+  ASSERT_EQ(optimized.number_of_gates, optimized.gates.size());
+  std::mt19937_64 mersenne_twister(0);
+  std::bernoulli_distribution distribution;
+  for (std::size_t test = 0; test < number_of_tests; ++test) {
+    std::vector<bool> inputs(number_of_inputs);
+    if (number_of_tests == (std::size_t(1) << number_of_inputs)) {
+      for (std::size_t i = 0; i < number_of_inputs; ++i) inputs[i] = (test >> i) & 1;
+    } else {
+      for (std::size_t i = 0; i < number_of_inputs; ++i) inputs[i] = distribution(mersenne_twister);
+    }
+    EXPECT_EQ(EvaluatePlain(optimized, inputs), EvaluatePlain(original, inputs));
+  }
+}
+
+TEST(CircuitOptimizer, PreservesIntegerCircuits) {
+  for (const std::string name : {"int_add8_size", "int_add8_depth", "int_mul8_size",
+                                 "int_div8_size", "int_gt8_size", "int_gt8_depth"}) {
+    const auto original{mo::AlgorithmDescription::FromBristol(
+        std::string(mo::kRootDir) + "/circuits/int/" + name + ".bristol")};
+    const auto original_statistics{mo::GetAlgorithmStatistics(original)};
+    for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+      const auto optimized{mo::OptimizeCircuit(original, objective)};
+      const auto statistics{mo::GetAlgorithmStatistics(optimized)};
+      EXPECT_LE(statistics.number_of_and_gates, original_statistics.number_of_and_gates) << name;
+      if (objective == mo::CircuitObjective::kDepth) {
+        EXPECT_LE(statistics.and_depth, original_statistics.and_depth) << name;
+      }
+      ExpectEquivalent(original, optimized, 100);
+    }
+  }
+}
+
+TEST(CircuitOptimizer, RemovesRedundantAndGates) {
+  // (a & b) ^ (a & c) with a duplicate and a dead gate on the inputs a, b and c
+  const auto original{MakeCircuit(3, 1,
+                                  {Gate(T::kAnd, 0, 1, 3),
+                                   Gate(T::kAnd, 0, 2, 4),
+                                   Gate(T::kAnd, 1, 2, 5),
+                                   Gate(T::kAnd, 2, 0, 6),
+                                   Gate(T::kXor, 3, 6, 7)})};
+  EXPECT_EQ(mo::GetAlgorithmStatistics(original).number_of_and_gates, 4);
+  for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+    const auto optimized{mo::OptimizeCircuit(original, objective)};
+    EXPECT_EQ(mo::GetAlgorithmStatistics(optimized).number_of_and_gates, 1);
+    ExpectEquivalent(original, optimized, 8);
+  }
+}
+
+TEST(CircuitOptimizer, RebalancesAndChains) {
+  // a_0 & ... & a_7 and a_0 | ... | a_7 as chains of depth 7, whose last gates are the outputs
+  const std::array types{T::kAnd, T::kOr};
+  std::array<std::size_t, 2> previous{0, 0};
+  std::vector<mo::PrimitiveOperation> gates;
+  std::size_t next_wire{8};
+  for (std::size_t chain = 0; chain < types.size(); ++chain) {
+    for (std::size_t i = 1; i < 7; ++i) {
+      gates.push_back(Gate(types[chain], previous[chain], i, next_wire));
+      previous[chain] = next_wire++;
+    }
+  }
+  for (std::size_t chain = 0; chain < types.size(); ++chain) {
+    gates.push_back(Gate(types[chain], previous[chain], 7, next_wire++));
+  }
+  const auto original{MakeCircuit(8, 2, gates)};
+  ASSERT_EQ(mo::GetAlgorithmStatistics(original).and_depth, 7);
+
+  const auto size_optimized{mo::OptimizeCircuit(original, mo::CircuitObjective::kSize)};
+  EXPECT_EQ(mo::GetAlgorithmStatistics(size_optimized).number_of_and_gates, 14);
+  ExpectEquivalent(original, size_optimized, 256);
+
+  const auto depth_optimized{mo::OptimizeCircuit(original, mo::CircuitObjective::kDepth)};
+  const auto statistics{mo::GetAlgorithmStatistics(depth_optimized)};
+  EXPECT_EQ(statistics.number_of_and_gates, 14);
+  EXPECT_EQ(statistics.and_depth, 3);
+  ExpectEquivalent(original, depth_optimized, 256);
+}
+
+TEST(CircuitOptimizer, ConstantAndCopiedOutputs) {
+  // a ^ a, ~(a ^ a), a & a, ~a and b
+  const auto original{MakeCircuit(2, 5,
+                                  {Gate(T::kXor, 0, 0, 2),
+                                   Gate(T::kInv, 2, std::nullopt, 3),
+                                   Gate(T::kAnd, 0, 0, 4),
+                                   Gate(T::kInv, 0, std::nullopt, 5),
+                                   Gate(T::kOr, 1, 1, 6)})};
+  const auto optimized{mo::OptimizeCircuit(original, mo::CircuitObjective::kSize)};
+  EXPECT_EQ(mo::GetAlgorithmStatistics(optimized).number_of_and_gates, 0);
+  ExpectEquivalent(original, optimized, 4);
+}
+
+TEST(CircuitOptimizer, RejectsUnsupportedGates) {
+  auto mux{Gate(T::kMux, 0, 1, 3)};
+  mux.selection_bit = 2;
+  const auto circuit{MakeCircuit(3, 1, {mux})};
+  EXPECT_THROW(mo::OptimizeCircuit(circuit, mo::CircuitObjective::kSize), std::invalid_argument);
+  EXPECT_THROW(mo::GetAlgorithmStatistics(circuit), std::invalid_argument);
+}
+
+}  // namespace
@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <future>
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "statistics/analysis.h"
+#include "statistics/circuit_statistics.h"
+#include "statistics/memory_accounting.h"
+#include "statistics/metrics.h"
+#include "statistics/run_time_statistics.h"
+#include "statistics/trace.h"
+
+namespace {
+
+constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+
+TEST(CircuitStatistics, RoundsDepthsAndPreprocessing) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      // three AND gates on the critical path and a parallel multiplication
+      auto c{((a & b) & b) & a};
+      auto bit_output{(c ^ a).Out()};
+      encrypto::motion::ShareWrapper x{party->In<kArithmeticGmw>(std::uint32_t(0), 0)};
+      encrypto::motion::ShareWrapper y{party->In<kArithmeticGmw>(std::uint32_t(0), 1)};
+      auto integer_output{(x * y).Out()};
+
+      encrypto::motion::CircuitStatistics statistics(*party->GetBackend());
+      // including the helper output gates of the 3 ANDs and the multiplication
+      EXPECT_EQ(statistics.GetNumberOfGates(), 15u);
+      EXPECT_EQ(statistics.GetNumberOfInteractiveGates(), 6u);
+      EXPECT_EQ(statistics.GetNumberOfRounds(), 4u);
+      EXPECT_EQ(statistics.GetDepth(kBooleanGmw), 4u);
+      EXPECT_EQ(statistics.GetDepth(kArithmeticGmw), 2u);
+      EXPECT_EQ(statistics.GetConversionDepth(), 0u);
+      // 3 ANDs with 2 bytes, the bit output with 1, the multiplication with 8 and its output with 4
+      EXPECT_EQ(statistics.GetNumberOfBytesPerParty(), 19u);
+      EXPECT_EQ(statistics.GetNumberOfBinaryMts(), 3u);
+      EXPECT_EQ(statistics.GetNumberOfMts(32), 1u);
+      EXPECT_EQ(statistics.GetNumberOfMts(64), 0u);
+      EXPECT_THROW(statistics.GetNumberOfSbs(128), std::invalid_argument);
+      EXPECT_FALSE(statistics.PrintHumanReadable().empty());
+
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(RunTimeStatistics, GateStatisticsByClassAndLayer) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    motion_parties.at(i)->GetConfiguration()->SetGateStatistics();
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      auto bit_output{(((a & b) & b) ^ a).Out()};
+      encrypto::motion::ShareWrapper x{party->In<kArithmeticGmw>(std::uint32_t(0), 0)};
+      encrypto::motion::ShareWrapper y{party->In<kArithmeticGmw>(std::uint32_t(0), 1)};
+      auto integer_output{(x * y).Out()};
+
+      party->Run();
+      party->Finish();
+
+      const auto& statistics{party->GetBackend()->GetRunTimeStatistics().back()};
+      const auto& and_gates{statistics.gate_statistics.at("boolean_gmw::AndGate")};
+      EXPECT_EQ(and_gates.number_of_gates, 2u);
+      EXPECT_EQ(and_gates.number_of_bytes_per_party, 4u);
+      EXPECT_GT(and_gates.online_time.count(), 0);
+      const auto& multiplication_gates{
+          statistics.gate_statistics.at("arithmetic_gmw::MultiplicationGate<unsigned int>")};
+      EXPECT_EQ(multiplication_gates.number_of_gates, 1u);
+      EXPECT_EQ(multiplication_gates.number_of_bytes_per_party, 8u);
+
+      // the inputs are in layer 0, the two ANDs in layers 1 and 2
+      ASSERT_GE(statistics.layer_statistics.size(), 3u);
+      std::size_t number_of_layered_gates{0};
+      for (const auto& layer : statistics.layer_statistics) {
+        number_of_layered_gates += layer.number_of_gates;
+      }
+      std::size_t number_of_gates{0};
+      for (const auto& [gate_class, gate_statistics] : statistics.gate_statistics) {
+        number_of_gates += gate_statistics.number_of_gates;
+      }
+      EXPECT_LE(number_of_layered_gates, number_of_gates);
+
+      encrypto::motion::AccumulatedRunTimeStatistics accumulated_statistics;
+      accumulated_statistics.Add(statistics);
+      const auto json{accumulated_statistics.ToJson()};
+      EXPECT_TRUE(json.contains("gates"));
+      EXPECT_TRUE(json.contains("layers"));
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Tracer, GatesAndMessagesOfTwoParties) {
+  using encrypto::motion::Tracer;
+  auto& tracer{Tracer::Get()};
+  tracer.Enable();
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      auto output{(a & b).Out()};
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  tracer.Disable();
+
+  const auto events{tracer.GetEvents()};
+  bool has_and_gate{false}, has_sent_message{false}, has_received_message{false};
+  for (const auto& event : events) {
+    EXPECT_LE(event.start, event.end);
+    if (event.category == Tracer::Category::kGateOnline) {
+      EXPECT_LT(event.party_id, 2u);
+      if (encrypto::motion::GetGateClassName(*event.gate_type) == "boolean_gmw::AndGate") {
+        has_and_gate = true;
+      }
+    } else if (event.category == Tracer::Category::kMessageSent) {
+      EXPECT_GT(event.number_of_bytes, 0u);
+      EXPECT_NE(event.party_id, event.other_party_id);
+      has_sent_message = true;
+    } else if (event.category == Tracer::Category::kMessageReceived) {
+      has_received_message = true;
+    }
+  }
+  EXPECT_TRUE(has_and_gate);
+  EXPECT_TRUE(has_sent_message);
+  EXPECT_TRUE(has_received_message);
+
+  const auto json{tracer.ToChromeTraceJson()};
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find("boolean_gmw::AndGate"), std::string::npos);
+  EXPECT_THROW(tracer.Enable(0), std::invalid_argument);
+}
+
+TEST(ExecutionAnalysis, CriticalPathIdleTimeAndRounds) {
+  using encrypto::motion::Tracer;
+  auto& tracer{Tracer::Get()};
+  tracer.Enable();
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      auto output{((a & b) & a).Out()};
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  tracer.Disable();
+
+  const auto events{tracer.GetEvents()};
+  for (auto& party : motion_parties) {
+    encrypto::motion::ExecutionAnalysis analysis(*party->GetBackend(), events);
+    // the two ANDs and the output gate
+    EXPECT_GE(analysis.GetCriticalPathNumberOfGates(), 3u);
+    EXPECT_EQ(analysis.GetCriticalPath().back(), "boolean_gmw::OutputGate");
+    EXPECT_EQ(analysis.GetNumberOfTheoreticalRounds(), 3u);
+    EXPECT_GE(analysis.GetNumberOfRounds(), 1u);
+    EXPECT_LE(analysis.GetCriticalPathComputationTime() +
+                  analysis.GetCriticalPathCommunicationTime(),
+              analysis.GetCriticalPathTime());
+    EXPECT_LE(analysis.GetCriticalPathLatencyTime(),
+              analysis.GetCriticalPathCommunicationTime());
+    EXPECT_LE(analysis.GetIdleTime(), analysis.GetEvaluationTime());
+    EXPECT_LE(analysis.GetCriticalPathTime(), analysis.GetEvaluationTime());
+    EXPECT_FALSE(analysis.PrintHumanReadable().empty());
+    EXPECT_TRUE(analysis.ToJson().contains("critical_path"));
+  }
+  EXPECT_THROW(encrypto::motion::ExecutionAnalysis(*motion_parties.front()->GetBackend(), {}),
+               std::invalid_argument);
+}
+
+TEST(Metrics, OpenMetricsOfRunsAndServer) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::unique_ptr<encrypto::motion::Metrics>> metrics;
+  for (auto& party : motion_parties) {
+    metrics.emplace_back(std::make_unique<encrypto::motion::Metrics>(*party->GetBackend()));
+  }
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, &metrics, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      auto output{(a & b).Out()};
+      party->Run();
+      metrics.at(i)->ObserveRun();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+
+  const auto text{metrics.front()->Collect()};
+  EXPECT_NE(text.find("motion_runs_total{party=\"0\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("motion_online_seconds_count{party=\"0\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("motion_preprocessed_total{party=\"0\",kind=\"mt\",bits=\"1\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("motion_peer_sent_bytes_total{party=\"0\",peer=\"1\"}"), std::string::npos);
+  EXPECT_NE(text.find("motion_send_queue_messages{party=\"0\",peer=\"1\"}"), std::string::npos);
+  EXPECT_TRUE(text.ends_with("# EOF\n"));
+
+  encrypto::motion::MetricsServer server(0, [&metrics] { return metrics.front()->Collect(); });
+  const auto get{[&server](const std::string& target) {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect({boost::asio::ip::address_v4::loopback(), server.GetPort()});
+    const auto request{"GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n"};
+    boost::asio::write(socket, boost::asio::buffer(request));
+    std::string response;
+    boost::system::error_code error;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), error);
+    return response;
+  }};
+  const auto response{get("/metrics")};
+  EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK"));
+  EXPECT_NE(response.find("motion_runs_total"), std::string::npos);
+  EXPECT_TRUE(get("/other").starts_with("HTTP/1.1 404"));
+}
+
+TEST(MemoryAccounting, AccountsAndPeaksOfAnEvaluation) {
+  using encrypto::motion::MemoryAccount;
+  using encrypto::motion::MemoryAccounting;
+  using encrypto::motion::MemorySubsystem;
+  MemoryAccounting::ResetPeaks();
+  const auto before{MemoryAccounting::Get(MemorySubsystem::kWires)};
+  {
+    MemoryAccount account(MemorySubsystem::kWires);
+    account.Set(1000);
+    account.Set(400);
+    MemoryAccount other(MemorySubsystem::kWires);
+    other = std::move(account);
+    EXPECT_EQ(other.Get(), 400);
+    EXPECT_EQ(account.Get(), 0);
+    const auto usage{MemoryAccounting::Get(MemorySubsystem::kWires)};
+    EXPECT_EQ(usage.current_bytes, before.current_bytes + 400);
+    EXPECT_GE(usage.peak_bytes, before.current_bytes + 1000);
+  }
+  EXPECT_EQ(MemoryAccounting::Get(MemorySubsystem::kWires).current_bytes, before.current_bytes);
+
+  constexpr std::size_t kNumberOfSimd{1000};
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{
+          party->In<kBooleanGmw>(encrypto::motion::BitVector<>(kNumberOfSimd), 0)};
+      encrypto::motion::ShareWrapper b{
+          party->In<kBooleanGmw>(encrypto::motion::BitVector<>(kNumberOfSimd), 1)};
+      auto output{(a & b).Out()};
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+
+  const auto& memory_usage{
+      motion_parties.front()->GetBackend()->GetRunTimeStatistics().back().memory_usage};
+  const auto peak{[&memory_usage](MemorySubsystem subsystem) {
+    return memory_usage.at(static_cast<std::size_t>(subsystem)).peak_bytes;
+  }};
+  // the MTs of both parties, each consisting of a, b and c
+  EXPECT_GE(peak(MemorySubsystem::kPreprocessing), 2 * 3 * kNumberOfSimd / 8);
+  EXPECT_GE(peak(MemorySubsystem::kWires), kNumberOfSimd / 8);
+  EXPECT_GT(peak(MemorySubsystem::kOtExtension), 0);
+  EXPECT_GT(peak(MemorySubsystem::kMessageBuffers), 0);
+
+  encrypto::motion::AccumulatedRunTimeStatistics statistics;
+  statistics.Add(motion_parties.front()->GetBackend()->GetRunTimeStatistics().back());
+  EXPECT_NE(statistics.PrintHumanReadable().find("preprocessing"), std::string::npos);
+  EXPECT_TRUE(statistics.ToJson().at("memory").as_object().contains("wires"));
+}
+
+}  // namespace
@@ -25,8 +25,16 @@
 #include <boost/log/trivial.hpp>
 
 #include "communication/communication_layer.h"
+#include "communication/connection_pool.h"
+#include "communication/dummy_transport.h"
+#include "communication/encrypted_transport.h"
 #include "communication/message.h"
+#include "communication/message_compression.h"
 #include "communication/message_manager.h"
+#include "communication/network_emulation_transport.h"
+#include "communication/shared_memory_transport.h"
+#include "communication/transport_multiplexer.h"
+#include "statistics/analysis.h"
 #include "utility/logger.h"
 
 namespace {
@@ -97,6 +105,824 @@ TEST(CommunicationLayer, Dummy) {
   std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
 }
 
+TEST(CommunicationLayer, DummySynchronizationModes) {
+  constexpr std::size_t kNumberOfSynchronizations = 10;
+  for (auto mode :
+       {comm::SynchronizationMode::kAllToAll, comm::SynchronizationMode::kDissemination}) {
+    for (std::size_t number_of_parties : {2, 3, 5}) {
+      auto communication_layers = comm::MakeDummyCommunicationLayers(number_of_parties);
+      for (auto& cl : communication_layers) {
+        cl->SetSynchronizationMode(mode);
+        cl->Start();
+      }
+      // no party leaves a synchronization before all parties have entered it
+      std::atomic<std::size_t> number_of_arrivals = 0;
+      std::vector<std::future<void>> futures;
+      for (std::size_t party_id = 0; party_id < number_of_parties; ++party_id) {
+        futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+          auto& cl = communication_layers.at(party_id);
+          for (std::size_t i = 0; i < kNumberOfSynchronizations; ++i) {
+            ++number_of_arrivals;
+            // start early on some parties, which must not change the result
+            if (party_id % 2 == 0) cl->StartSynchronization();
+            cl->Synchronize();
+            EXPECT_GE(number_of_arrivals.load(), (i + 1) * number_of_parties);
+          }
+        }));
+      }
+      std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+
+      communication_layers.at(0)->StartSynchronization();
+      EXPECT_THROW(communication_layers.at(0)->SetSynchronizationMode(mode), std::logic_error);
+      futures.clear();
+      for (auto& cl : communication_layers) {
+        futures.emplace_back(std::async(std::launch::async, [&cl] {
+          cl->Synchronize();
+          cl->Shutdown();
+        }));
+      }
+      std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+    }
+  }
+}
+
+TEST(CommunicationLayer, DummyMessageCoalescing) {
+  constexpr std::size_t kNumberOfMessages = 100;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+
+  // messages queued before the start are sent together
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    const std::vector<std::uint8_t> message(i + 1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), i + 1);
+    for (std::size_t j = 0; j < payload->size(); ++j) EXPECT_EQ(payload->Get(j), i);
+  }
+  EXPECT_LT(communication_layer_alice->GetTransportStatistics().at(0).number_of_messages_sent,
+            kNumberOfMessages);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyAdaptiveMessageCoalescing) {
+  constexpr std::size_t kNumberOfMessages = 100;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+  EXPECT_THROW(communication_layer_alice->SetRoundTripTime(std::chrono::microseconds(-1)),
+               std::invalid_argument);
+  // results in the maximum window of 1 ms
+  communication_layer_alice->SetRoundTripTime(std::chrono::seconds(1));
+
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  // messages trickling in are collected by the send thread
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    const std::vector<std::uint8_t> message(i + 1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+  }
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), i + 1);
+    for (std::size_t j = 0; j < payload->size(); ++j) EXPECT_EQ(payload->Get(j), i);
+  }
+  const auto statistics_alice = communication_layer_alice->GetTransportStatistics().at(0);
+  EXPECT_GT(statistics_alice.number_of_coalescing_waits, 0);
+  EXPECT_GT(statistics_alice.coalescing_window.count(), 0);
+  EXPECT_LE(statistics_alice.coalescing_window, std::chrono::milliseconds(1));
+  EXPECT_LE(statistics_alice.number_of_messages_sent +
+                statistics_alice.number_of_messages_collected_by_waiting,
+            kNumberOfMessages);
+  // bob does not know the round-trip time and never waits
+  EXPECT_EQ(communication_layer_bob->GetTransportStatistics().at(0).number_of_coalescing_waits, 0);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyMessagePrioritization) {
+  constexpr std::size_t kNumberOfMessages = 10;
+  // large enough to be sent in several fragments
+  constexpr std::size_t kBulkMessageSize = 1000 * 1000;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+  communication_layer_alice->SetMessagePrioritization();
+
+  auto bulk_future = communication_layer_bob->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOtExtensionSender, 0);
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+
+  // the online messages overtake the bulk message queued before them
+  std::vector<std::uint8_t> bulk_message(kBulkMessageSize);
+  for (std::size_t i = 0; i < kBulkMessageSize; ++i) {
+    bulk_message[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  communication_layer_alice->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kOtExtensionSender, 0, bulk_message).Release());
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    const std::vector<std::uint8_t> message(i + 1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), i + 1);
+    for (std::size_t j = 0; j < payload->size(); ++j) EXPECT_EQ(payload->Get(j), i);
+  }
+  auto received_bulk_message = bulk_future.get();
+  auto bulk_payload = comm::GetMessage(received_bulk_message.data())->payload();
+  ASSERT_EQ(bulk_payload->size(), kBulkMessageSize);
+  EXPECT_TRUE(std::equal(bulk_payload->begin(), bulk_payload->end(), bulk_message.begin()));
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummySendQueueWatermarks) {
+  constexpr std::size_t kNumberOfMessages = 64;
+  constexpr std::size_t kMessageSize = 100 * 1024;
+  constexpr std::size_t kHighWatermark = 4 * kMessageSize;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+  EXPECT_THROW(communication_layer_alice->SetSendQueueWatermarks(1, 2), std::invalid_argument);
+  communication_layer_alice->SetSendQueueWatermarks(kHighWatermark, kHighWatermark / 2);
+
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOtExtensionSender, i));
+  }
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  // the sender is suspended while the queue is full, so it needs to run concurrently
+  auto sender = std::async(std::launch::async, [&communication_layer_alice] {
+    for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+      const std::vector<std::uint8_t> message(kMessageSize, static_cast<std::uint8_t>(i));
+      communication_layer_alice->SendMessage(
+          1, comm::BuildMessage(comm::MessageType::kOtExtensionSender, i, message).Release());
+    }
+  });
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), kMessageSize);
+    EXPECT_EQ(payload->Get(0), static_cast<std::uint8_t>(i));
+  }
+  sender.get();
+
+  EXPECT_EQ(communication_layer_alice->GetSendQueueBytes().at(1), 0);
+  const auto statistics = communication_layer_alice->GetTransportStatistics().at(0);
+  EXPECT_GT(statistics.peak_send_queue_bytes, 0);
+  // the queue may exceed the high watermark by at most one message
+  EXPECT_LT(statistics.peak_send_queue_bytes, kHighWatermark + 2 * kMessageSize);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyMessageStream) {
+  constexpr std::size_t kPayloadSize = 1000 * 1000;
+  constexpr std::size_t kFragmentSize = 64 * 1024;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+
+  // one message is consumed in fragments and the other one is reassembled
+  auto stream = communication_layer_bob->GetMessageManager().RegisterReceiveStream(
+      0, comm::MessageType::kGarbledCircuitGarbledTables, 0);
+  auto message_future = communication_layer_bob->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kGarbledCircuitGarbledTables, 1);
+
+  auto payload = std::make_shared<std::vector<std::uint8_t>>(kPayloadSize);
+  for (std::size_t i = 0; i < kPayloadSize; ++i) {
+    (*payload)[i] = static_cast<std::uint8_t>(i * 13);
+  }
+  for (std::size_t message_id = 0; message_id < 2; ++message_id) {
+    communication_layer_alice->SendMessageStream(
+        1, comm::MessageType::kGarbledCircuitGarbledTables, message_id, *payload, payload,
+        kFragmentSize);
+  }
+  EXPECT_THROW(communication_layer_alice->SendMessageStream(
+                   1, comm::MessageType::kGarbledCircuitGarbledTables, 2, *payload, payload, 0),
+               std::invalid_argument);
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  std::vector<std::uint8_t> streamed_payload;
+  std::size_t number_of_fragments = 0;
+  while (auto fragment = stream->dequeue()) {
+    EXPECT_LE(fragment->size(), kFragmentSize);
+    streamed_payload.insert(streamed_payload.end(), fragment->begin(), fragment->end());
+    ++number_of_fragments;
+  }
+  EXPECT_EQ(number_of_fragments, (kPayloadSize + kFragmentSize - 1) / kFragmentSize);
+  EXPECT_EQ(streamed_payload, *payload);
+
+  auto received_message = message_future.get();
+  auto received_payload = comm::GetMessage(received_message.data())->payload();
+  ASSERT_EQ(received_payload->size(), kPayloadSize);
+  EXPECT_TRUE(std::equal(received_payload->begin(), received_payload->end(), payload->begin()));
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyMessageTypeStatistics) {
+  constexpr std::size_t kNumberOfMessages = 10;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+  message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kSharedBitsMask, 0));
+
+  // the small messages are counted one by one although they are sent in a batch
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    const std::vector<std::uint8_t> message(i + 1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+  const std::vector<std::uint8_t> mask(1024, 0x42);
+  communication_layer_alice->SendMessage(
+      1, comm::BuildMessage(comm::MessageType::kSharedBitsMask, 0, mask).Release());
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+  for (auto& message_future : message_futures) message_future.get();
+
+  const auto alice_statistics = communication_layer_alice->GetTransportStatistics().at(0);
+  const auto bob_statistics = communication_layer_bob->GetTransportStatistics().at(0);
+  const auto& outputs_sent = alice_statistics.message_types.at("kOutputMessage");
+  const auto& outputs_received = bob_statistics.message_types.at("kOutputMessage");
+  EXPECT_EQ(outputs_sent.phase, comm::MessagePhase::kOnline);
+  EXPECT_EQ(outputs_sent.number_of_messages_sent, kNumberOfMessages);
+  EXPECT_EQ(outputs_received.number_of_messages_received, kNumberOfMessages);
+  EXPECT_EQ(outputs_sent.number_of_bytes_sent, outputs_received.number_of_bytes_received);
+  EXPECT_EQ(outputs_sent.number_of_messages_received, 0u);
+  const auto& masks_sent = alice_statistics.message_types.at("kSharedBitsMask");
+  EXPECT_EQ(masks_sent.phase, comm::MessagePhase::kSetup);
+  EXPECT_EQ(masks_sent.number_of_messages_sent, 1u);
+  EXPECT_GT(masks_sent.number_of_bytes_sent, mask.size());
+  EXPECT_FALSE(alice_statistics.message_types.contains("kBatchedMessage"));
+
+  encrypto::motion::AccumulatedCommunicationStatistics accumulated_statistics;
+  accumulated_statistics.Add(alice_statistics);
+  const auto json = accumulated_statistics.ToJson();
+  EXPECT_TRUE(json.contains("message_types"));
+  EXPECT_TRUE(json.contains("phases"));
+  EXPECT_NE(accumulated_statistics.PrintHumanReadable().find("kSharedBitsMask"),
+            std::string::npos);
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyDispatchThread) {
+  constexpr std::size_t kNumberOfMessages = 100;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+  // alice verifies the messages in her dispatch thread, bob trusts the link
+  communication_layer_alice->SetMessageDispatchThread();
+  communication_layer_bob->SetMessageDispatchThread();
+  communication_layer_bob->SetMessageVerification(false);
+
+  std::vector<comm::MessageManager::future_type> message_futures;
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, i));
+  }
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    const std::vector<std::uint8_t> message(10 * i + 1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, i, message).Release());
+  }
+  for (std::size_t i = 0; i < kNumberOfMessages; ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), 10 * i + 1);
+    for (std::size_t j = 0; j < payload->size(); ++j) EXPECT_EQ(payload->Get(j), i);
+  }
+
+  // the dispatch thread handles the termination messages
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyMessageCompression) {
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+  if (!comm::IsMessageCompressionAvailable()) {
+    EXPECT_THROW(
+        communication_layer_alice->SetMessageCompression(comm::MessageType::kOutputMessage),
+        std::logic_error);
+    // the layers have to be started before they can be shut down
+    std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                  [](auto& cl) { cl->Start(); });
+  } else {
+    communication_layer_alice->SetMessageCompression(comm::MessageType::kOutputMessage);
+    auto message_future{communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, 0)};
+    std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                  [](auto& cl) { cl->Start(); });
+
+    // mostly constant messages compress well
+    const std::vector<std::uint8_t> message(64 * 1024, 0x42);
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, 0, message).Release());
+    auto received_message = message_future.get();
+    auto payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(payload->size(), message.size());
+    for (std::size_t i = 0; i < message.size(); ++i) EXPECT_EQ(payload->Get(i), message[i]);
+
+    const auto statistics = communication_layer_alice->GetTransportStatistics().at(0);
+    EXPECT_GT(statistics.number_of_bytes_before_compression, message.size());
+    EXPECT_LT(statistics.number_of_bytes_after_compression, message.size() / 10);
+    EXPECT_LT(statistics.number_of_bytes_sent, message.size() / 10);
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyBroadcastHub) {
+  constexpr std::size_t kNumberOfParties = 4;
+  constexpr std::size_t kHub = 1;
+  auto communication_layers = comm::MakeDummyCommunicationLayers(kNumberOfParties);
+  for (auto& cl : communication_layers) cl->SetBroadcastHub(kHub);
+  EXPECT_THROW(communication_layers.at(0)->SetBroadcastHub(kNumberOfParties),
+               std::invalid_argument);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  // every party receives the broadcast of every other party from the original sender
+  std::vector<std::vector<comm::MessageManager::future_type>> message_futures(kNumberOfParties);
+  for (std::size_t receiver_id = 0; receiver_id < kNumberOfParties; ++receiver_id) {
+    for (std::size_t sender_id = 0; sender_id < kNumberOfParties; ++sender_id) {
+      if (sender_id != receiver_id) {
+        message_futures.at(receiver_id)
+            .emplace_back(communication_layers.at(receiver_id)->GetMessageManager().RegisterReceive(
+                sender_id, comm::MessageType::kOutputMessage, 7));
+      }
+    }
+  }
+  for (std::size_t sender_id = 0; sender_id < kNumberOfParties; ++sender_id) {
+    const std::vector<std::uint8_t> message(100, static_cast<std::uint8_t>(sender_id));
+    communication_layers.at(sender_id)->BroadcastMessage(
+        comm::BuildMessage(comm::MessageType::kOutputMessage, 7, message).Release());
+  }
+  for (std::size_t receiver_id = 0; receiver_id < kNumberOfParties; ++receiver_id) {
+    for (std::size_t i = 0; i < kNumberOfParties - 1; ++i) {
+      const std::size_t sender_id = i < receiver_id ? i : i + 1;
+      auto received_message = message_futures.at(receiver_id).at(i).get();
+      auto payload = comm::GetMessage(received_message.data())->payload();
+      ASSERT_EQ(payload->size(), 100u);
+      EXPECT_EQ(payload->Get(0), sender_id);
+    }
+  }
+
+  // synchronization messages are broadcasted through the hub as well
+  {
+    std::vector<std::future<void>> futures;
+    for (auto& cl : communication_layers) {
+      futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Synchronize(); }));
+    }
+    std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+  }
+  // the other parties only sent messages to the hub
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    if (party_id == kHub) {
+      continue;
+    }
+    const auto statistics = communication_layers.at(party_id)->GetTransportStatistics();
+    for (std::size_t i = 0; i < kNumberOfParties - 1; ++i) {
+      const std::size_t other_id = i < party_id ? i : i + 1;
+      if (other_id != kHub) {
+        EXPECT_EQ(statistics.at(i).number_of_messages_sent, 0u);
+      }
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummyMessageIdsAcrossSlotChunks) {
+  using MessageManager = comm::MessageManager;
+  // ids in the first chunk, in a later chunk and beyond the slot table
+  const std::vector<std::size_t> message_ids = {
+      0, MessageManager::kChunkSize - 1, 3 * MessageManager::kChunkSize + 5,
+      MessageManager::kChunkSize * MessageManager::kNumberOfChunks + 42};
+  auto communication_layers = comm::MakeDummyCommunicationLayers(2);
+  auto& communication_layer_alice = communication_layers.at(0);
+  auto& communication_layer_bob = communication_layers.at(1);
+
+  std::vector<MessageManager::future_type> message_futures;
+  for (auto message_id : message_ids) {
+    message_futures.emplace_back(communication_layer_bob->GetMessageManager().RegisterReceive(
+        0, comm::MessageType::kOutputMessage, message_id));
+  }
+  // a second registration for the same id replaces the first one
+  message_futures.back() = communication_layer_bob->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, message_ids.back());
+
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  for (std::size_t i = 0; i < message_ids.size(); ++i) {
+    const std::vector<std::uint8_t> message(1, static_cast<std::uint8_t>(i));
+    communication_layer_alice->SendMessage(
+        1, comm::BuildMessage(comm::MessageType::kOutputMessage, message_ids.at(i), message)
+               .Release());
+  }
+  for (std::size_t i = 0; i < message_ids.size(); ++i) {
+    auto received_message = message_futures.at(i).get();
+    auto fb_message = comm::GetMessage(received_message.data());
+    EXPECT_EQ(fb_message->message_id(), message_ids.at(i));
+    ASSERT_EQ(fb_message->payload()->size(), 1u);
+    EXPECT_EQ(fb_message->payload()->Get(0), i);
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, DummySendPayloadFromBuffer) {
+  auto communication_layers = comm::MakeDummyCommunicationLayers(3);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  // large enough to be sent from its own buffer
+  auto payload = std::make_shared<std::vector<std::uint8_t>>(1'000'000);
+  for (std::size_t i = 0; i < payload->size(); ++i) {
+    payload->at(i) = static_cast<std::uint8_t>(i);
+  }
+
+  auto message_future_b{communication_layers.at(1)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 42)};
+  auto message_future_c{communication_layers.at(2)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 42)};
+  communication_layers.at(0)->BroadcastMessage(comm::MessageType::kOutputMessage, 42, *payload,
+                                               payload);
+
+  for (auto* future : {&message_future_b, &message_future_c}) {
+    auto received_message = future->get();
+    auto message = comm::GetMessage(received_message.data());
+    EXPECT_EQ(message->message_id(), 42);
+    auto received_payload = message->payload();
+    ASSERT_EQ(received_payload->size(), payload->size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), received_payload->data()));
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
+TEST(CommunicationLayer, ConnectionPool) {
+  constexpr std::size_t kNumberOfParties = 3;
+  std::vector<std::vector<std::unique_ptr<comm::Transport>>> transports(kNumberOfParties);
+  for (auto& party_transports : transports) {
+    party_transports.resize(kNumberOfParties);
+  }
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    for (std::size_t j = i + 1; j < kNumberOfParties; ++j) {
+      std::tie(transports.at(i).at(j), transports.at(j).at(i)) =
+          comm::DummyTransport::MakeTransportPair();
+    }
+  }
+  std::vector<std::unique_ptr<comm::ConnectionPool>> pools;
+  for (auto& party_transports : transports) {
+    pools.emplace_back(std::make_unique<comm::ConnectionPool>(std::move(party_transports)));
+  }
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  // the second session uses dispatch threads, which read until the end of the session
+  for (std::size_t session_i = 0; session_i < 2; ++session_i) {
+    std::vector<std::unique_ptr<comm::CommunicationLayer>> communication_layers;
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      communication_layers.emplace_back(std::make_unique<comm::CommunicationLayer>(
+          party_id, pools.at(party_id)->GetTransports()));
+      communication_layers.back()->SetMessageDispatchThread(session_i == 1);
+    }
+    EXPECT_THROW(pools.at(0)->GetTransports(), std::logic_error);
+    std::vector<comm::MessageManager::future_type> futures;
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      futures.emplace_back(communication_layers.at(party_id)->GetMessageManager().RegisterReceive(
+          (party_id + 1) % kNumberOfParties, comm::MessageType::kOutputMessage, session_i));
+      communication_layers.at(party_id)->Start();
+    }
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      communication_layers.at(party_id)->SendMessage(
+          (party_id + kNumberOfParties - 1) % kNumberOfParties,
+          comm::BuildMessage(comm::MessageType::kOutputMessage, session_i, message).Release());
+    }
+    for (auto& future : futures) {
+      auto received_message = future.get();
+      auto received_payload = comm::GetMessage(received_message.data())->payload();
+      ASSERT_EQ(received_payload->size(), message.size());
+      EXPECT_TRUE(std::equal(message.begin(), message.end(), received_payload->data()));
+    }
+
+    std::vector<std::future<void>> shutdown_futures;
+    for (auto& cl : communication_layers) {
+      shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+    }
+    std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                  [](auto& f) { f.get(); });
+  }
+  for (auto& pool : pools) {
+    EXPECT_EQ(pool->GetNumberOfSessions(), 2u);
+  }
+}
+
+TEST(CommunicationLayer, TransportMultiplexer) {
+  constexpr std::size_t kNumberOfParties = 3;
+  constexpr std::size_t kNumberOfSessions = 4;
+  std::vector<std::vector<std::unique_ptr<comm::Transport>>> transports(kNumberOfParties);
+  for (auto& party_transports : transports) {
+    party_transports.resize(kNumberOfParties);
+  }
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    for (std::size_t j = i + 1; j < kNumberOfParties; ++j) {
+      std::tie(transports.at(i).at(j), transports.at(j).at(i)) =
+          comm::DummyTransport::MakeTransportPair();
+    }
+  }
+  std::vector<std::unique_ptr<comm::TransportMultiplexer>> multiplexers;
+  for (auto& party_transports : transports) {
+    multiplexers.emplace_back(
+        std::make_unique<comm::TransportMultiplexer>(std::move(party_transports)));
+  }
+
+  // the sessions run concurrently and the second round reuses their ids
+  for (std::size_t round_i = 0; round_i < 2; ++round_i) {
+    std::vector<std::future<void>> session_futures;
+    for (std::size_t session_id = 0; session_id < kNumberOfSessions; ++session_id) {
+      session_futures.emplace_back(std::async(std::launch::async, [&multiplexers, session_id] {
+        const std::vector<std::uint8_t> message(session_id + 1, std::uint8_t(session_id));
+        std::vector<std::unique_ptr<comm::CommunicationLayer>> communication_layers;
+        for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+          communication_layers.emplace_back(std::make_unique<comm::CommunicationLayer>(
+              party_id, multiplexers.at(party_id)->GetTransports(session_id)));
+        }
+        EXPECT_THROW(multiplexers.at(0)->GetTransports(session_id), std::logic_error);
+        std::vector<comm::MessageManager::future_type> futures;
+        for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+          futures.emplace_back(
+              communication_layers.at(party_id)->GetMessageManager().RegisterReceive(
+                  (party_id + 1) % kNumberOfParties, comm::MessageType::kOutputMessage, 0));
+          communication_layers.at(party_id)->Start();
+        }
+        for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+          communication_layers.at(party_id)->SendMessage(
+              (party_id + kNumberOfParties - 1) % kNumberOfParties,
+              comm::BuildMessage(comm::MessageType::kOutputMessage, 0, message).Release());
+        }
+        for (auto& future : futures) {
+          auto received_message = future.get();
+          auto received_payload = comm::GetMessage(received_message.data())->payload();
+          ASSERT_EQ(received_payload->size(), message.size());
+          EXPECT_TRUE(std::equal(message.begin(), message.end(), received_payload->data()));
+        }
+
+        std::vector<std::future<void>> shutdown_futures;
+        for (auto& cl : communication_layers) {
+          shutdown_futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+        }
+        std::for_each(std::begin(shutdown_futures), std::end(shutdown_futures),
+                      [](auto& f) { f.get(); });
+      }));
+    }
+    std::for_each(std::begin(session_futures), std::end(session_futures),
+                  [](auto& f) { f.get(); });
+    for (auto& multiplexer : multiplexers) {
+      EXPECT_EQ(multiplexer->GetNumberOfOpenSessions(), 0u);
+    }
+  }
+
+  std::vector<std::future<void>> destruction_futures;
+  for (auto& multiplexer : multiplexers) {
+    destruction_futures.emplace_back(
+        std::async(std::launch::async, [&multiplexer] { multiplexer.reset(); }));
+  }
+  std::for_each(std::begin(destruction_futures), std::end(destruction_futures),
+                [](auto& f) { f.get(); });
+}
+
+// constructs the EncryptedTransports concurrently since the handshakes block
+std::pair<std::unique_ptr<comm::EncryptedTransport>, std::unique_ptr<comm::EncryptedTransport>>
+MakeEncryptedTransportPair(const std::vector<std::uint8_t>& key_a,
+                           const std::vector<std::uint8_t>& key_b) {
+  auto [transport_a, transport_b] = comm::DummyTransport::MakeTransportPair();
+  auto future_a = std::async(std::launch::async, [&transport_a, &key_a] {
+    return std::make_unique<comm::EncryptedTransport>(std::move(transport_a), key_a, true);
+  });
+  auto encrypted_b = std::make_unique<comm::EncryptedTransport>(std::move(transport_b), key_b,
+                                                                false);
+  return {future_a.get(), std::move(encrypted_b)};
+}
+
+TEST(EncryptedTransport, RoundTrip) {
+  const std::vector<std::uint8_t> key(32, 0x42);
+  auto [transport_a, transport_b] = MakeEncryptedTransportPair(key, key);
+
+  std::vector<std::uint8_t> large_message(100'000);
+  for (std::size_t i = 0; i < large_message.size(); ++i) {
+    large_message.at(i) = static_cast<std::uint8_t>(i);
+  }
+  const std::vector<std::uint8_t> small_message = {0xde, 0xad, 0xbe, 0xef};
+  const std::array<std::span<const std::uint8_t>, 2> parts = {small_message, large_message};
+
+  transport_a->SendMessage(small_message);
+  transport_a->SendMessageParts(parts);
+  transport_a->SendMessage(std::span<const std::uint8_t>());
+  transport_b->SendMessage(large_message);
+
+  EXPECT_EQ(transport_b->ReceiveMessage(), small_message);
+  auto concatenated = small_message;
+  concatenated.insert(concatenated.end(), large_message.begin(), large_message.end());
+  EXPECT_EQ(transport_b->ReceiveMessage(), concatenated);
+  EXPECT_EQ(transport_b->ReceiveMessage(), std::vector<std::uint8_t>());
+  EXPECT_EQ(transport_a->ReceiveMessage(), large_message);
+
+  // statistics count the plaintexts
+  EXPECT_EQ(transport_a->GetStatistics().number_of_messages_sent, 3u);
+  EXPECT_EQ(transport_a->GetStatistics().number_of_bytes_sent, concatenated.size() + 4);
+  EXPECT_EQ(transport_b->GetStatistics().number_of_bytes_received, concatenated.size() + 4);
+
+  transport_a->ShutdownSend();
+  EXPECT_FALSE(transport_b->ReceiveMessage().has_value());
+}
+
+TEST(EncryptedTransport, WrongKey) {
+  EXPECT_THROW(MakeEncryptedTransportPair(std::vector<std::uint8_t>(8), {}),
+               std::invalid_argument);
+
+  const std::vector<std::uint8_t> key_a(16, 1), key_b(16, 2);
+  auto [transport_a, transport_b] = MakeEncryptedTransportPair(key_a, key_b);
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  transport_a->SendMessage(message);
+  EXPECT_THROW(transport_b->ReceiveMessage(), std::runtime_error);
+}
+
+TEST(NetworkEmulationTransport, LatencyAndBandwidth) {
+  using namespace std::chrono_literals;
+  using Clock = std::chrono::steady_clock;
+  comm::NetworkEmulationConfiguration configuration;
+  configuration.round_trip_time = 100ms;
+  configuration.jitter = 10ms;
+  // 10'000 bytes take 80ms
+  configuration.bandwidth = 1e6;
+  auto [dummy_a, dummy_b] = comm::DummyTransport::MakeTransportPair();
+  comm::NetworkEmulationTransport transport_a(std::move(dummy_a), configuration);
+
+  const std::vector<std::uint8_t> small_message = {0xde, 0xad, 0xbe, 0xef};
+  const std::vector<std::uint8_t> large_message(10'000, 0x42);
+  const auto start = Clock::now();
+  transport_a.SendMessage(small_message);
+  transport_a.SendMessage(large_message);
+  // the sender is not blocked by the emulated link
+  EXPECT_LT(Clock::now() - start, 40ms);
+
+  EXPECT_EQ(dummy_b->ReceiveMessage(), small_message);
+  EXPECT_GE(Clock::now() - start, 40ms);
+  EXPECT_EQ(dummy_b->ReceiveMessage(), large_message);
+  EXPECT_GE(Clock::now() - start, 120ms);
+
+  // outstanding messages are forwarded before the shutdown
+  transport_a.SendMessage(small_message);
+  transport_a.ShutdownSend();
+  EXPECT_EQ(dummy_b->ReceiveMessage(), small_message);
+  EXPECT_FALSE(dummy_b->ReceiveMessage().has_value());
+}
+
+TEST(CommunicationLayer, SharedMemory) {
+  auto communication_layers = comm::MakeSharedMemoryCommunicationLayers(3);
+  std::for_each(std::begin(communication_layers), std::end(communication_layers),
+                [](auto& cl) { cl->Start(); });
+
+  // larger than the ring buffers, s.t. it is written in several steps
+  auto payload = std::make_shared<std::vector<std::uint8_t>>(
+      2 * comm::SharedMemoryTransport::kDefaultCapacity + 17);
+  for (std::size_t i = 0; i < payload->size(); ++i) {
+    payload->at(i) = static_cast<std::uint8_t>(i);
+  }
+  const std::vector<std::uint8_t> small_message = {0xde, 0xad, 0xbe, 0xef};
+
+  auto message_future_b{communication_layers.at(1)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 0)};
+  auto message_future_c{communication_layers.at(2)->GetMessageManager().RegisterReceive(
+      0, comm::MessageType::kOutputMessage, 0)};
+  auto message_future_a{communication_layers.at(0)->GetMessageManager().RegisterReceive(
+      2, comm::MessageType::kOutputMessage, 1)};
+  communication_layers.at(0)->BroadcastMessage(comm::MessageType::kOutputMessage, 0, *payload,
+                                               payload);
+  communication_layers.at(2)->SendMessage(
+      0, comm::BuildMessage(comm::MessageType::kOutputMessage, 1, small_message).Release());
+
+  for (auto* future : {&message_future_b, &message_future_c}) {
+    auto received_message = future->get();
+    auto received_payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(received_payload->size(), payload->size());
+    EXPECT_TRUE(std::equal(payload->begin(), payload->end(), received_payload->data()));
+  }
+  {
+    auto received_message = message_future_a.get();
+    auto received_payload = comm::GetMessage(received_message.data())->payload();
+    ASSERT_EQ(received_payload->size(), small_message.size());
+    EXPECT_TRUE(
+        std::equal(small_message.begin(), small_message.end(), received_payload->data()));
+  }
+
+  std::vector<std::future<void>> futures;
+  for (auto& cl : communication_layers) {
+    futures.emplace_back(std::async(std::launch::async, [&cl] { cl->Shutdown(); }));
+  }
+  std::for_each(std::begin(futures), std::end(futures), [](auto& f) { f.get(); });
+}
+
 class CommunicationLayerTest : public testing::TestWithParam<bool> {};
 
 TEST_P(CommunicationLayerTest, Tcp) {
@@ -0,0 +1,430 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <numeric>
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/compiled_circuit.h"
+#include "base/party.h"
+#include "base/register.h"
+#include "protocols/share_wrapper.h"
+#include "utility/mapped_column.h"
+
+namespace {
+
+constexpr auto kNumberOfPartiesList = {2u, 3u};
+constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+
+TEST(CompiledCircuit, FanInFanOut) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 0)};
+      encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1), 1)};
+      auto c{a ^ b};
+      auto output{(c ^ a).Out()};
+      const auto& circuit{party->Compile()};
+
+      ASSERT_EQ(circuit.GetNumberOfGates(), 5u);
+      EXPECT_EQ(circuit.GetInputGates(), (std::vector<std::size_t>{0, 1}));
+      EXPECT_EQ(std::vector(circuit.GetFanIn(2).begin(), circuit.GetFanIn(2).end()),
+                (std::vector<std::size_t>{0, 1}));
+      EXPECT_EQ(std::vector(circuit.GetFanIn(3).begin(), circuit.GetFanIn(3).end()),
+                (std::vector<std::size_t>{0, 2}));
+      EXPECT_EQ(std::vector(circuit.GetFanOut(0).begin(), circuit.GetFanOut(0).end()),
+                (std::vector<std::size_t>{2, 3}));
+      EXPECT_TRUE(circuit.GetFanOut(4).empty());
+      const auto gate_id_offset{party->GetBackend()->GetRegister()->GetGateIdOffset()};
+      for (std::size_t gate = 0; gate < circuit.GetNumberOfGates(); ++gate) {
+        EXPECT_EQ(circuit.GetGate(gate).GetId(), static_cast<std::int64_t>(gate_id_offset + gate));
+        for (auto parent : circuit.GetFanIn(gate)) {
+          EXPECT_LT(parent, gate);
+          const auto fan_out{circuit.GetFanOut(parent)};
+          EXPECT_NE(std::find(fan_out.begin(), fan_out.end(), gate), fan_out.end());
+        }
+      }
+
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(CompiledCircuit, RerunWithFreshInputs) {
+  constexpr std::size_t kNumberOfRuns{3};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::vector<std::pair<bool, std::uint32_t>>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        // party 0 provides the bit and party 1 the integer, the others only know the dimensions
+        auto bit_input = [i](std::size_t run) {
+          return std::vector{encrypto::motion::BitVector<>(1, i == 0 && run % 2 == 1)};
+        };
+        auto integer_input = [i](std::size_t run) {
+          return std::vector<std::uint32_t>{i == 1 ? std::uint32_t(1000 + run) : 0};
+        };
+        encrypto::motion::ShareWrapper bit{party->In<kBooleanGmw>(bit_input(0), 0)};
+        encrypto::motion::ShareWrapper constant_bit{party->In<kBooleanGmw>(
+            encrypto::motion::BitVector<>(1, i == 1), 1)};
+        encrypto::motion::ShareWrapper integer{
+            party->In<kArithmeticGmw>(integer_input(0), 1)};
+        auto bit_output{(bit ^ constant_bit).Out()};
+        auto integer_output{(integer + integer).Out()};
+        auto& circuit{party->Compile()};
+
+        std::vector<std::pair<bool, std::uint32_t>> results;
+        for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+          if (run > 0) {
+            party->Clear();
+            circuit.SetInput(0, bit_input(run));
+            circuit.SetInput(2, integer_input(run));
+          }
+          party->Run();
+          results.emplace_back(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+        }
+        EXPECT_THROW(circuit.SetInput(0, std::vector<std::uint32_t>{0}), std::invalid_argument);
+        EXPECT_THROW(circuit.SetInput(2, std::vector<std::uint32_t>{0, 0}),
+                     std::invalid_argument);
+        party->Finish();
+        return results;
+      }));
+    }
+    for (auto& future : futures) {
+      const auto results{future.get()};
+      ASSERT_EQ(results.size(), kNumberOfRuns);
+      for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+        EXPECT_EQ(results[run].first, run % 2 == 0);
+        EXPECT_EQ(results[run].second, std::uint32_t(2 * (1000 + run)));
+      }
+    }
+  }
+}
+
+TEST(CompiledCircuit, StreamMappedColumn) {
+  constexpr std::size_t kChunkSize{4};
+  std::vector<std::uint32_t> column(3 * kChunkSize);
+  std::iota(column.begin(), column.end(), 1000);
+  const auto path{(std::filesystem::temp_directory_path() / "motion_mapped_column.bin").string()};
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(column[0]));
+  }
+  {
+    std::ofstream(path + ".truncated", std::ios::binary).write("abc", 3);
+    EXPECT_THROW(encrypto::motion::MappedColumn<std::uint32_t>(path + ".truncated"),
+                 std::runtime_error);
+    std::filesystem::remove(path + ".truncated");
+  }
+  const encrypto::motion::MappedColumn<std::uint32_t> mapped_column(path);
+  ASSERT_EQ(mapped_column.GetSize(), column.size());
+  ASSERT_EQ(mapped_column.GetNumberOfChunks(kChunkSize), 3u);
+  EXPECT_EQ(mapped_column.GetNumberOfChunks(5), 3u);
+  EXPECT_EQ(mapped_column.GetChunk(2, 5).size(), 2u);
+
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<std::vector<std::uint32_t>>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, &mapped_column, i] {
+      auto& party{motion_parties.at(i)};
+      // party 0 owns the column, party 1 only knows the chunk size
+      const std::vector<std::uint32_t> zeros(kChunkSize);
+      auto chunk = [&mapped_column, &zeros, i](std::size_t chunk_index) {
+        return i == 0 ? mapped_column.GetChunk(chunk_index, kChunkSize)
+                      : std::span<const std::uint32_t>(zeros);
+      };
+      const auto first_chunk{chunk(0)};
+      encrypto::motion::ShareWrapper input{party->In<kArithmeticGmw>(
+          std::vector<std::uint32_t>(first_chunk.begin(), first_chunk.end()), 0)};
+      auto output{(input + input).Out()};
+      auto& circuit{party->Compile()};
+
+      std::vector<std::uint32_t> results;
+      for (std::size_t chunk_index = 0;
+           chunk_index < mapped_column.GetNumberOfChunks(kChunkSize); ++chunk_index) {
+        if (chunk_index > 0) {
+          party->Clear();
+          circuit.SetInput(0, chunk(chunk_index));
+        }
+        party->Run();
+        const auto values{output.As<std::vector<std::uint32_t>>()};
+        results.insert(results.end(), values.begin(), values.end());
+      }
+      EXPECT_THROW(circuit.SetInput(0, mapped_column.GetChunk(0, kChunkSize + 1)),
+                   std::invalid_argument);
+      party->Finish();
+      return results;
+    }));
+  }
+  for (auto& future : futures) {
+    const auto results{future.get()};
+    ASSERT_EQ(results.size(), column.size());
+    for (std::size_t j = 0; j < column.size(); ++j) EXPECT_EQ(results[j], 2 * column[j]);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(CompiledCircuit, RerunWithOtBasedPreprocessing) {
+  constexpr std::size_t kNumberOfRuns{3};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::vector<std::pair<bool, std::uint32_t>>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        // parties 0 and 1 provide the inputs, the MTs are generated from the OT extension
+        auto bit_input = [i](std::size_t run) {
+          return std::vector{encrypto::motion::BitVector<>(1, i < 2 && (run + i) % 3 != 0)};
+        };
+        auto integer_input = [i](std::size_t run) {
+          return std::vector<std::uint32_t>{i < 2 ? std::uint32_t(100 * (i + 1) + run) : 0};
+        };
+        encrypto::motion::ShareWrapper a{party->In<kBooleanGmw>(bit_input(0), 0)};
+        encrypto::motion::ShareWrapper b{party->In<kBooleanGmw>(bit_input(0), 1)};
+        encrypto::motion::ShareWrapper x{party->In<kArithmeticGmw>(integer_input(0), 0)};
+        encrypto::motion::ShareWrapper y{party->In<kArithmeticGmw>(integer_input(0), 1)};
+        auto bit_output{(a & b).Out()};
+        auto integer_output{(x * y).Out()};
+        auto& circuit{party->Compile()};
+
+        std::vector<std::pair<bool, std::uint32_t>> results;
+        for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+          if (run > 0) {
+            party->Clear();
+            for (std::size_t input = 0; input < 2; ++input) {
+              circuit.SetInput(input, bit_input(run));
+              circuit.SetInput(input + 2, integer_input(run));
+            }
+          }
+          party->Run();
+          results.emplace_back(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+        }
+        party->Finish();
+        return results;
+      }));
+    }
+    for (auto& future : futures) {
+      const auto results{future.get()};
+      ASSERT_EQ(results.size(), kNumberOfRuns);
+      for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+        EXPECT_EQ(results[run].first, run % 3 != 0 && (run + 1) % 3 != 0);
+        EXPECT_EQ(results[run].second, std::uint32_t((100 + run) * (200 + run)));
+      }
+    }
+  }
+}
+
+TEST(CompiledCircuit, DataflowEvaluation) {
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::pair<bool, std::uint32_t>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetConfiguration()->SetDataflowEvaluation();
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        encrypto::motion::ShareWrapper bit_0{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 0), 0)};
+        encrypto::motion::ShareWrapper bit_1{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 1), 1)};
+        encrypto::motion::ShareWrapper integer_0{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 3 : 0), 0)};
+        encrypto::motion::ShareWrapper integer_1{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 5 : 0), 1)};
+        // a chain of interactive gates, each one waits for its predecessor
+        auto bit{bit_0 & bit_1};
+        auto integer{integer_0 * integer_1};
+        for (std::size_t j = 0; j < 4; ++j) {
+          bit = (bit & bit_1) ^ bit_0;
+          integer = integer * integer_1 + integer_0;
+        }
+        auto bit_output{bit.Out()};
+        auto integer_output{integer.Out()};
+        party->Run();
+        party->Finish();
+        return std::make_pair(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+      }));
+    }
+    std::uint32_t expected{15};
+    for (std::size_t j = 0; j < 4; ++j) expected = expected * 5 + 3;
+    for (auto& future : futures) {
+      auto [bit, integer] = future.get();
+      EXPECT_TRUE(bit);
+      EXPECT_EQ(integer, expected);
+    }
+  }
+}
+
+TEST(CompiledCircuit, InlineLocalGates) {
+  constexpr std::size_t kChainLength{1'000};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::pair<bool, std::uint32_t>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetConfiguration()->SetDataflowEvaluation();
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        encrypto::motion::ShareWrapper bit_0{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 0), 0)};
+        encrypto::motion::ShareWrapper bit_1{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 1), 1)};
+        encrypto::motion::ShareWrapper integer_0{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 3 : 0), 0)};
+        encrypto::motion::ShareWrapper integer_1{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 5 : 0), 1)};
+        // long chains of local gates around a single interactive gate, the local gates are
+        // evaluated inline by the fiber that finished their parent
+        auto bit{bit_0 ^ bit_1};
+        auto integer{integer_0 + integer_1};
+        for (std::size_t j = 0; j < kChainLength; ++j) {
+          bit = bit ^ bit_1;
+          integer = integer + integer_0;
+          if (j == kChainLength / 2) {
+            bit = bit & bit_0;
+            integer = integer * integer_1;
+          }
+        }
+        auto bit_output{bit.Out()};
+        auto integer_output{integer.Out()};
+        party->Run();
+        party->Finish();
+        return std::make_pair(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+      }));
+    }
+    // the bit starts at 0 and is flipped 501 times before the AND with 1 and 499 times after it
+    std::uint32_t expected{8 + 3 * (kChainLength / 2 + 1)};
+    expected = expected * 5 + 3 * (kChainLength / 2 - 1);
+    for (auto& future : futures) {
+      auto [bit, integer] = future.get();
+      EXPECT_FALSE(bit);
+      EXPECT_EQ(integer, expected);
+    }
+  }
+}
+
+TEST(CompiledCircuit, PipelinedInstances) {
+  static constexpr std::size_t kNumberOfInstances{5}, kNumberOfInstancesInFlight{2};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::vector<std::uint32_t>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        std::vector<encrypto::motion::ShareWrapper> outputs;
+        auto& circuit{party->CompilePipelined(
+            kNumberOfInstances, kNumberOfInstancesInFlight, [&](std::size_t instance) {
+              encrypto::motion::ShareWrapper x{party->In<kArithmeticGmw>(
+                  std::uint32_t(i == 0 ? 10 + instance : 0), 0)};
+              encrypto::motion::ShareWrapper y{party->In<kArithmeticGmw>(
+                  std::uint32_t(i == 1 ? 3 : 0), 1)};
+              outputs.push_back((x * y + x).Out());
+            })};
+
+        EXPECT_EQ(circuit.GetNumberOfInstances(), kNumberOfInstances);
+        EXPECT_EQ(circuit.GetNumberOfInstancesInFlight(), kNumberOfInstancesInFlight);
+        EXPECT_EQ(circuit.GetInstanceOffset(kNumberOfInstances), circuit.GetNumberOfGates());
+        for (std::size_t instance = 0; instance < kNumberOfInstances; ++instance) {
+          EXPECT_EQ(circuit.GetFirstInputOfInstance(instance), 2 * instance);
+          EXPECT_EQ(circuit.GetInstance(circuit.GetInstanceOffset(instance)), instance);
+        }
+        EXPECT_THROW(encrypto::motion::CompiledCircuit(*party->GetBackend()->GetRegister(), {0, 0}),
+                     std::invalid_argument);
+
+        party->Run();
+        party->Finish();
+        std::vector<std::uint32_t> results;
+        for (auto& output : outputs) results.push_back(output.As<std::uint32_t>());
+        return results;
+      }));
+    }
+    for (auto& future : futures) {
+      const auto results{future.get()};
+      ASSERT_EQ(results.size(), kNumberOfInstances);
+      for (std::size_t instance = 0; instance < kNumberOfInstances; ++instance) {
+        EXPECT_EQ(results[instance], std::uint32_t(4 * (10 + instance)));
+      }
+    }
+  }
+}
+
+TEST(CompiledCircuit, DeadGateElimination) {
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::uint32_t>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetConfiguration()->SetDeadGateElimination();
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        encrypto::motion::ShareWrapper x{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 6 : 0), 0)};
+        encrypto::motion::ShareWrapper y{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 7 : 0), 1)};
+        // speculative helper values that are never revealed
+        auto unused{x * y};
+        for (std::size_t j = 0; j < 3; ++j) unused = unused * y;
+        auto output{(x + y).Out()};
+        const auto& circuit{party->Compile()};
+        // each multiplication registers a helper output gate of its masked values before itself
+        EXPECT_EQ(circuit.GetNumberOfGates(), 12u);
+        const auto& reg{*party->GetBackend()->GetRegister()};
+        EXPECT_EQ(reg.GetGateOwner(2), 3u);
+        EXPECT_EQ(reg.GetGateOwner(3), encrypto::motion::Register::kNoOwner);
+        // the inputs, the addition and the output gate, but not the helpers of the multiplications
+        EXPECT_EQ(circuit.GetNumberOfLiveGates(), 4u);
+        EXPECT_TRUE(circuit.IsLive(circuit.GetNumberOfGates() - 1));
+        EXPECT_FALSE(circuit.IsLive(2));
+        EXPECT_FALSE(circuit.IsLive(3));
+        party->Run();
+        party->Finish();
+        return output.As<std::uint32_t>();
+      }));
+    }
+    for (auto& future : futures) EXPECT_EQ(future.get(), 13u);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <filesystem>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "test_constants.h"
+
+#include "base/configuration.h"
+#include "base/configuration_tuner.h"
+#include "base/party.h"
+#include "utility/logger.h"
+
+namespace {
+
+TEST(ConfigurationTuner, SaveAndLoadProfile) {
+  const auto path{(std::filesystem::temp_directory_path() / "motion_tuning_profile.json").string()};
+  std::filesystem::remove(path);
+  EXPECT_FALSE(encrypto::motion::TuningProfile::Load(path).has_value());
+
+  encrypto::motion::TuningProfile profile;
+  profile.number_of_hardware_threads = 12;
+  profile.aes_blocks_per_second = 4e8;
+  profile.transpose_bits_per_second = 2e10;
+  profile.round_trip_time = std::chrono::microseconds(25'000);
+  profile.bandwidth = 1e8;
+  profile.Save(path);
+  const auto loaded{encrypto::motion::TuningProfile::Load(path)};
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->number_of_hardware_threads, profile.number_of_hardware_threads);
+  EXPECT_EQ(loaded->aes_blocks_per_second, profile.aes_blocks_per_second);
+  EXPECT_EQ(loaded->transpose_bits_per_second, profile.transpose_bits_per_second);
+  EXPECT_EQ(loaded->round_trip_time, profile.round_trip_time);
+  EXPECT_EQ(loaded->bandwidth, profile.bandwidth);
+  std::filesystem::remove(path);
+}
+
+TEST(ConfigurationTuner, ApplyProfile) {
+  encrypto::motion::TuningProfile profile;
+  profile.number_of_hardware_threads = 16;
+  profile.aes_blocks_per_second = 4e8;
+  profile.transpose_bits_per_second = 2e10;
+
+  // local network: computation bound
+  profile.round_trip_time = std::chrono::microseconds(100);
+  profile.bandwidth = 0;
+  encrypto::motion::Configuration local(0, 2);
+  encrypto::motion::ApplyTuningProfile(profile, local);
+  EXPECT_EQ(local.GetNumberOfWorkerThreads(), 16u);
+  EXPECT_TRUE(local.GetDataflowEvaluation());
+  EXPECT_TRUE(local.GetMessageDispatchThread());
+  EXPECT_FALSE(local.GetSilentOtExtension());
+  EXPECT_EQ(local.GetOtExtensionChunkSize(), 0u);
+  EXPECT_TRUE(local.GetGarbledCircuitScheme() == encrypto::motion::GarbledCircuitScheme::kAuto);
+
+  // slow wide area network: communication bound
+  profile.round_trip_time = std::chrono::microseconds(80'000);
+  profile.bandwidth = 1e7;
+  encrypto::motion::Configuration wide_area(0, 2);
+  encrypto::motion::ApplyTuningProfile(profile, wide_area);
+  EXPECT_FALSE(wide_area.GetDataflowEvaluation());
+  EXPECT_FALSE(wide_area.GetMessageDispatchThread());
+  EXPECT_TRUE(wide_area.GetSilentOtExtension());
+  EXPECT_GT(wide_area.GetOtExtensionChunkSize(), 0u);
+  EXPECT_EQ(wide_area.GetOtExtensionChunkSize() % 128, 0u);
+  EXPECT_EQ(wide_area.GetNetworkRoundTripTime(), profile.round_trip_time);
+  EXPECT_EQ(wide_area.GetNetworkBandwidth(), profile.bandwidth);
+}
+
+TEST(ConfigurationTuner, PartiesAgreeOnMeasuredProfile) {
+  constexpr std::size_t kNumberOfParties{3};
+  std::vector<std::string> paths;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    paths.emplace_back((std::filesystem::temp_directory_path() /
+                        ("motion_tuning_profile_" + std::to_string(party_id) + ".json"))
+                           .string());
+    std::filesystem::remove(paths.back());
+  }
+  // 2nd run: only party 0 lost its profile, s.t. all parties measure the network again
+  for (std::size_t run = 0; run < 2; ++run) {
+    if (run == 1) std::filesystem::remove(paths[0]);
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<encrypto::motion::TuningProfile>> futures;
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [party_id, &parties, &paths] {
+        return parties[party_id]->TuneConfiguration(paths[party_id]);
+      }));
+    }
+    std::vector<encrypto::motion::TuningProfile> profiles;
+    for (auto& future : futures) profiles.emplace_back(future.get());
+    for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+      EXPECT_TRUE(std::filesystem::exists(paths[party_id]));
+      EXPECT_GT(profiles[party_id].aes_blocks_per_second, 0);
+      EXPECT_GT(profiles[party_id].transpose_bits_per_second, 0);
+      EXPECT_EQ(profiles[party_id].round_trip_time, profiles[0].round_trip_time);
+      EXPECT_EQ(profiles[party_id].bandwidth, profiles[0].bandwidth);
+      EXPECT_EQ(profiles[party_id].aes_blocks_per_second, profiles[0].aes_blocks_per_second);
+      const auto configuration{parties[party_id]->GetConfiguration()};
+      EXPECT_EQ(configuration->GetSilentOtExtension(),
+                parties[0]->GetConfiguration()->GetSilentOtExtension());
+      EXPECT_EQ(configuration->GetOtExtensionChunkSize(),
+                parties[0]->GetConfiguration()->GetOtExtensionChunkSize());
+    }
+  }
+  for (const auto& path : paths) std::filesystem::remove(path);
+}
+
+}  // namespace
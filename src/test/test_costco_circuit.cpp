@@ -0,0 +1,107 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <future>
+#include <sstream>
+
+#include "algorithm/costco_circuit.h"
+#include "base/party.h"
+#include "test_constants.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+constexpr auto kCircuit{
+    "# sum and product of the inputs\n"
+    "INPUT0_0 ADD_2 MUL_3\n"
+    "INPUT1_1 ADD_2 MUL_3\n"
+    "ADD_2 OUTPUT_4\n"
+    "MUL_3 OUTPUT_5\n"
+    "OUTPUT_4\n"
+    "OUTPUT_5\n"};
+
+mo::CostcoCircuit Parse(const std::string& text) {
+  std::istringstream stream(text);
+  return mo::CostcoCircuit::FromText(stream);
+}
+
+TEST(CostcoCircuit, ParseIntoDenseIds) {
+  const auto circuit{Parse(kCircuit)};
+  ASSERT_EQ(circuit.GetNumberOfGates(), 6u);
+  EXPECT_TRUE(circuit.gate_types[3] == mo::CostcoGateType::kMultiplication);
+  EXPECT_TRUE(circuit.GetInputs(0).empty());
+  EXPECT_EQ(std::vector(circuit.GetInputs(3).begin(), circuit.GetInputs(3).end()),
+            (std::vector<std::uint32_t>{0, 1}));
+  EXPECT_EQ(std::vector(circuit.GetInputs(5).begin(), circuit.GetInputs(5).end()),
+            (std::vector<std::uint32_t>{3}));
+
+  EXPECT_THROW(Parse("FOO_0\n"), std::invalid_argument);
+  EXPECT_THROW(Parse("INPUT0_0 OUTPUT_1\n"), std::invalid_argument);
+  EXPECT_THROW(Parse("INPUT0_0 ADD_1\nADD_1\n"), std::invalid_argument);
+  EXPECT_THROW(Parse("OUTPUT_1\nINPUT0_0 OUTPUT_1\n"), std::invalid_argument);
+}
+
+TEST(CostcoCircuit, BinaryRoundTrip) {
+  const auto circuit{Parse(kCircuit)};
+  const auto path{(std::filesystem::temp_directory_path() / "motion_costco_circuit.bin").string()};
+  circuit.ToBinary(path);
+  const auto loaded{mo::CostcoCircuit::FromFile(path)};
+  std::filesystem::remove(path);
+  EXPECT_TRUE(loaded.gate_types == circuit.gate_types);
+  EXPECT_EQ(loaded.input_offsets, circuit.input_offsets);
+  EXPECT_EQ(loaded.inputs, circuit.inputs);
+}
+
+TEST(CostcoCircuit, RebuildAcrossRounds) {
+  constexpr std::size_t kNumberOfSimd{5};
+  const auto circuit{Parse(kCircuit)};
+  auto motion_parties = mo::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, &circuit, i] {
+      auto& party{*motion_parties.at(i)};
+      for (std::uint32_t input_value : {1, 3}) {
+        if (input_value > 1) party.Reset();
+        const auto outputs{
+            circuit.Build(party, mo::MpcProtocol::kArithmeticGmw, kNumberOfSimd, input_value)};
+        party.Run();
+        ASSERT_EQ(outputs.size(), 2u);
+        EXPECT_EQ(outputs[0].As<std::vector<std::uint32_t>>(),
+                  std::vector<std::uint32_t>(kNumberOfSimd, 2 * input_value));
+        EXPECT_EQ(outputs[1].As<std::vector<std::uint32_t>>(),
+                  std::vector<std::uint32_t>(kNumberOfSimd, input_value * input_value));
+      }
+      EXPECT_THROW(circuit.Build(party, mo::MpcProtocol::kAstra, kNumberOfSimd),
+                   std::invalid_argument);
+      party.Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+}  // namespace
@@ -39,3 +39,17 @@ TEST(DummyTransport, Dummy) {
 
   EXPECT_EQ(ReceivedMessage, message);
 }
+
+TEST(DummyTransport, SendOwnedMessage) {
+  auto [transport_alice, transport_bob] = DummyTransport::MakeTransportPair();
+
+  std::vector<std::uint8_t> message(1024, 0x42);
+  const auto* message_data = message.data();
+  transport_alice->SendOwnedMessage(std::move(message));
+  auto received_message = transport_bob->ReceiveMessage();
+  ASSERT_TRUE(received_message.has_value());
+  // the buffer was moved to bob
+  EXPECT_EQ(received_message->data(), message_data);
+  EXPECT_EQ(*received_message, std::vector<std::uint8_t>(1024, 0x42));
+  EXPECT_EQ(transport_alice->GetStatistics().number_of_bytes_sent, 1024);
+}
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <future>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/epistasis.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+
+TEST(Epistasis, ContingencyTablesAndChiSquaredStatistics) {
+  constexpr std::size_t kNumberOfIndividuals{30}, kNumberOfSnps{4}, kFractionalBits{8};
+  const std::vector<std::pair<std::size_t, std::size_t>> kSnpPairs{{0, 1}, {2, 3}, {0, 3}, {1, 1}};
+  std::mt19937 random(0);
+  std::vector<std::vector<std::size_t>> genotypes(kNumberOfSnps,
+                                                  std::vector<std::size_t>(kNumberOfIndividuals));
+  // SNP 3 never has genotype 2, s.t. some columns are empty
+  for (std::size_t s = 0; s < kNumberOfSnps; ++s) {
+    for (auto& genotype : genotypes[s]) genotype = random() % (s == 3 ? 2 : 3);
+  }
+  std::vector<std::uint64_t> phenotypes(kNumberOfIndividuals);
+  for (auto& phenotype : phenotypes) phenotype = random() % 2;
+  std::uint64_t number_of_cases{0};
+  for (const auto phenotype : phenotypes) number_of_cases += phenotype;
+  const std::uint64_t number_of_controls{kNumberOfIndividuals - number_of_cases};
+
+  // the one-hot genotype indicators and the plaintext tables and statistics
+  std::vector<std::vector<std::uint64_t>> indicators(
+      kNumberOfSnps, std::vector<std::uint64_t>(3 * kNumberOfIndividuals, 0));
+  for (std::size_t s = 0; s < kNumberOfSnps; ++s) {
+    for (std::size_t i = 0; i < kNumberOfIndividuals; ++i) {
+      indicators[s][genotypes[s][i] * kNumberOfIndividuals + i] = 1;
+    }
+  }
+  std::vector<std::uint64_t> controls(9 * kSnpPairs.size(), 0), cases(9 * kSnpPairs.size(), 0);
+  for (std::size_t p = 0; p < kSnpPairs.size(); ++p) {
+    const auto [first, second] = kSnpPairs[p];
+    for (std::size_t i = 0; i < kNumberOfIndividuals; ++i) {
+      const std::size_t column{9 * p + 3 * genotypes[first][i] + genotypes[second][i]};
+      ++(phenotypes[i] == 1 ? cases : controls)[column];
+    }
+  }
+  std::vector<std::uint64_t> statistics(kSnpPairs.size(), 0);
+  for (std::size_t j = 0; j < cases.size(); ++j) {
+    const std::uint64_t size{cases[j] + controls[j]};
+    if (size == 0) continue;
+    const std::int64_t difference{std::int64_t(cases[j] * number_of_controls) -
+                                  std::int64_t(controls[j] * number_of_cases)};
+    statistics[j / 9] += (std::uint64_t(difference * difference) << kFractionalBits) / size;
+  }
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      // the genotypes are owned by party 0 and the phenotypes by party 1
+      const auto in = [&](const std::vector<std::uint64_t>& values, std::size_t owner) {
+        return mo::ShareWrapper(party->In<kArithmeticGmw>(
+            party_id == owner ? values : std::vector<std::uint64_t>(values.size(), 0), owner));
+      };
+      std::vector<mo::ShareWrapper> genotype_shares;
+      for (const auto& snp_indicators : indicators) {
+        genotype_shares.emplace_back(in(snp_indicators, 0));
+      }
+      const auto tables{
+          mo::algorithm::CountContingencyTables(genotype_shares, in(phenotypes, 1), kSnpPairs)};
+      const auto statistic_share{mo::algorithm::ChiSquaredStatistics(
+          tables, number_of_cases, number_of_controls, kFractionalBits)};
+      auto controls_output{tables.controls.Out()};
+      auto cases_output{tables.cases.Out()};
+      auto statistic_output{statistic_share.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(controls_output.As<std::vector<std::uint64_t>>(), controls);
+      EXPECT_EQ(cases_output.As<std::vector<std::uint64_t>>(), cases);
+      EXPECT_EQ(statistic_output.As<std::vector<std::uint64_t>>(), statistics);
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
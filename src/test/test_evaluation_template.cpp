@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/evaluation_template.h"
+#include "utility/config.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+TEST(EvaluationTemplate, BatchesRespectDependencies) {
+  const auto algorithm{mo::AlgorithmDescription::FromBristol(
+      std::string(mo::kRootDir) + "/circuits/int/int_add8_size.bristol")};
+  const mo::EvaluationTemplate evaluation_template(algorithm);
+  EXPECT_EQ(evaluation_template.GetNumberOfInputWires(), 16);
+  EXPECT_EQ(evaluation_template.GetNumberOfWires(), 50);
+  EXPECT_EQ(evaluation_template.GetNumberOfOutputWires(), 8);
+  EXPECT_LT(evaluation_template.GetBatches().size(), algorithm.gates.size());
+
+  // each gate is in exactly one batch, after the batches of its parents
+  std::vector<std::optional<std::size_t>> batch_of_wire(algorithm.number_of_wires);
+  for (std::size_t wire_i = 0; wire_i < 16; ++wire_i) batch_of_wire[wire_i] = 0;
+  std::size_t number_of_gates{0};
+  const auto& batches{evaluation_template.GetBatches()};
+  for (std::size_t batch_i = 0; batch_i < batches.size(); ++batch_i) {
+    const auto& batch{batches[batch_i]};
+    ASSERT_EQ(batch.parents_a.size(), batch.output_wires.size());
+    for (std::size_t i = 0; i < batch.output_wires.size(); ++i) {
+      ASSERT_TRUE(batch_of_wire[batch.parents_a[i]]);
+      EXPECT_LE(*batch_of_wire[batch.parents_a[i]], batch_i);
+      if (batch.type != mo::PrimitiveOperationType::kInv) {
+        ASSERT_TRUE(batch_of_wire[batch.parents_b.at(i)]);
+        EXPECT_LE(*batch_of_wire[batch.parents_b[i]], batch_i);
+      }
+    }
+    for (const auto wire_i : batch.output_wires) {
+      EXPECT_FALSE(batch_of_wire[wire_i]);
+      batch_of_wire[wire_i] = batch_i + 1;
+    }
+    number_of_gates += batch.output_wires.size();
+  }
+  EXPECT_EQ(number_of_gates, algorithm.gates.size());
+
+  // the layers of the batches ascend and their sizes add up to the number of gates
+  const auto& layer_sizes{evaluation_template.GetLayerSizes()};
+  std::vector<std::size_t> counted_sizes(layer_sizes.size(), 0);
+  for (std::size_t batch_i = 0; batch_i < batches.size(); ++batch_i) {
+    EXPECT_GT(batches[batch_i].layer, 0);
+    if (batch_i > 0) EXPECT_GE(batches[batch_i].layer, batches[batch_i - 1].layer);
+    ASSERT_LT(batches[batch_i].layer, layer_sizes.size());
+    counted_sizes[batches[batch_i].layer] += batches[batch_i].output_wires.size();
+  }
+  EXPECT_EQ(counted_sizes, layer_sizes);
+}
+
+TEST(EvaluationTemplate, RejectsInvalidCircuits) {
+  using T = mo::PrimitiveOperationType;
+  mo::AlgorithmDescription algorithm;
+  algorithm.number_of_input_wires_parent_a = 2;
+  algorithm.number_of_output_wires = 1;
+  algorithm.number_of_gates = 2;
+  algorithm.number_of_wires = 4;
+  // reads wire 3 before it is assigned
+  algorithm.gates = {{T::kXor, 0, 3, std::nullopt, 2}, {T::kAnd, 0, 1, std::nullopt, 3}};
+  EXPECT_THROW(mo::EvaluationTemplate{algorithm}, std::invalid_argument);
+  // assigns wire 2 twice
+  algorithm.gates = {{T::kXor, 0, 1, std::nullopt, 2}, {T::kAnd, 0, 1, std::nullopt, 2}};
+  EXPECT_THROW(mo::EvaluationTemplate{algorithm}, std::invalid_argument);
+  // kMux is not evaluated
+  algorithm.gates = {{T::kXor, 0, 1, std::nullopt, 2}, {T::kMux, 0, 1, 2, 3}};
+  EXPECT_THROW(mo::EvaluationTemplate{algorithm}, std::invalid_argument);
+  algorithm.gates = {{T::kXor, 0, 1, std::nullopt, 2}, {T::kAnd, 2, 1, std::nullopt, 3}};
+  EXPECT_EQ(mo::EvaluationTemplate{algorithm}.GetBatches().size(), 2);
+  // an and group must not read its own outputs
+  algorithm.and_groups = {{0, 2}};
+  algorithm.gates = {{T::kAnd, 0, 1, std::nullopt, 2}, {T::kAnd, 2, 1, std::nullopt, 3}};
+  EXPECT_THROW(mo::EvaluationTemplate{algorithm}, std::invalid_argument);
+  // an and group contains only kAnd
+  algorithm.gates = {{T::kXor, 0, 1, std::nullopt, 2}, {T::kAnd, 0, 1, std::nullopt, 3}};
+  EXPECT_THROW(mo::EvaluationTemplate{algorithm}, std::invalid_argument);
+}
+
+}  // namespace
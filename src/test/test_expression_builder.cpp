@@ -0,0 +1,174 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <array>
+#include <filesystem>
+#include <future>
+#include <numeric>
+
+#include "base/compiled_circuit.h"
+#include "base/expression_builder.h"
+#include "test_constants.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+using Operation = mo::ExpressionBuilder::Operation;
+
+TEST(ExpressionBuilder, BulkOperationsOnScalarNodes) {
+  constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+  constexpr auto kBooleanGmw{mo::MpcProtocol::kBooleanGmw};
+  constexpr std::size_t kNumberOfValues{8};
+  std::array<std::uint32_t, kNumberOfValues> x, y;
+  std::iota(x.begin(), x.end(), 1);
+  std::iota(y.begin(), y.end(), 100);
+  const std::array<std::uint32_t, kNumberOfValues> zeros{};
+  const std::vector a{mo::BitVector<>(std::vector{true, true, false, false})};
+  const std::vector b{mo::BitVector<>(std::vector{true, false, true, false})};
+  const std::vector zero_bits{mo::BitVector<>(4)};
+
+  auto motion_parties = mo::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&, i] {
+      mo::ExpressionBuilder builder(*motion_parties.at(i));
+      builder.Reserve(100);
+      std::array<mo::ExpressionBuilder::Node, kNumberOfValues> x_nodes, y_nodes, products, sums;
+      builder.Inputs<kArithmeticGmw>(std::span<const std::uint32_t>(i == 0 ? x : zeros), 0,
+                                     std::span(x_nodes));
+      builder.Inputs<kArithmeticGmw>(std::span<const std::uint32_t>(i == 1 ? y : zeros), 1,
+                                     std::span(y_nodes));
+      // the multiplications share one SIMD gate, the additions are evaluated one by one
+      builder.Apply(Operation::kMultiply, x_nodes, y_nodes, products);
+      builder.Apply(Operation::kAdd, products, x_nodes, sums);
+      const auto integer_output{builder.Outputs(sums)};
+      EXPECT_THROW(builder.Apply(Operation::kAdd, x_nodes, std::span(y_nodes).first(1), sums),
+                   std::invalid_argument);
+
+      const auto a_node{builder.Input<kBooleanGmw>(std::span(i == 0 ? a : zero_bits), 0)};
+      const auto b_node{builder.Input<kBooleanGmw>(std::span(i == 1 ? b : zero_bits), 1)};
+      const auto and_node{builder.Apply(Operation::kAnd, a_node, b_node)};
+      const auto bit_output{builder.Output(builder.Not(and_node))};
+
+      motion_parties.at(i)->Run();
+      const auto values{builder.Get(integer_output).As<std::vector<std::uint32_t>>()};
+      ASSERT_EQ(values.size(), kNumberOfValues);
+      for (std::size_t j = 0; j < kNumberOfValues; ++j) EXPECT_EQ(values[j], x[j] * y[j] + x[j]);
+      EXPECT_EQ(builder.Get(bit_output).As<mo::BitVector<>>(),
+                mo::BitVector<>(std::vector{false, true, true, true}));
+      EXPECT_THROW(builder.Get(builder.GetNumberOfNodes()), std::out_of_range);
+      motion_parties.at(i)->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(ExpressionBuilder, ReplayRecordedProgram) {
+  constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+  constexpr auto kBooleanGmw{mo::MpcProtocol::kBooleanGmw};
+  constexpr auto kBooleanConstant{mo::MpcProtocol::kBooleanConstant};
+  constexpr std::size_t kNumberOfValues{4};
+  const std::array<std::uint32_t, kNumberOfValues> zeros{};
+  const std::vector zero_bits{mo::BitVector<>(4)};
+  const std::vector mask{mo::BitVector<>(std::vector{false, true, false, true})};
+  const auto path{(std::filesystem::temp_directory_path() / "motion_expression_program.mep")};
+
+  // the parties record the program, which is written by party 0
+  mo::ExpressionBuilder::Node integer_output{0}, bit_output{0};
+  {
+    auto motion_parties = mo::MakeLocallyConnectedParties(2, kPortOffset);
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      futures.emplace_back(std::async(std::launch::async, [&, i] {
+        mo::ExpressionProgram program;
+        mo::ExpressionBuilder builder(*motion_parties.at(i), &program);
+        std::array<mo::ExpressionBuilder::Node, kNumberOfValues> x_nodes, y_nodes, products;
+        builder.Inputs<kArithmeticGmw>(std::span<const std::uint32_t>(zeros), 0,
+                                       std::span(x_nodes));
+        builder.Inputs<kArithmeticGmw>(std::span<const std::uint32_t>(zeros), 1,
+                                       std::span(y_nodes));
+        builder.Apply(Operation::kMultiply, x_nodes, y_nodes, products);
+        const auto a_node{builder.Input<kBooleanGmw>(std::span(zero_bits), 0)};
+        const auto b_node{builder.Input<kBooleanGmw>(std::span(zero_bits), 1)};
+        const auto mask_node{builder.Input<kBooleanConstant>(std::span(mask), 0)};
+        const auto and_node{builder.Apply(Operation::kAnd, a_node, b_node)};
+        const auto integers{builder.Outputs(products)};
+        const auto bits{
+            builder.Output(builder.Not(builder.Apply(Operation::kXor, and_node, mask_node)))};
+        EXPECT_THROW(builder.Insert(builder.Get(and_node)), std::logic_error);
+        EXPECT_EQ(program.GetNumberOfInputGates(), 4);
+        if (i == 0) {
+          integer_output = integers;
+          bit_output = bits;
+          program.ToBinary(path);
+        }
+        motion_parties.at(i)->Run();
+        motion_parties.at(i)->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+
+  // other parties rebuild the gates from the file and set their inputs
+  std::array<std::uint32_t, kNumberOfValues> x, y;
+  std::iota(x.begin(), x.end(), 1);
+  std::iota(y.begin(), y.end(), 100);
+  const std::vector a{mo::BitVector<>(std::vector{true, true, false, false})};
+  const std::vector b{mo::BitVector<>(std::vector{true, false, true, false})};
+  auto motion_parties = mo::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&, i] {
+      const auto program{mo::ExpressionProgram::FromBinary(path)};
+      mo::ExpressionBuilder builder(*motion_parties.at(i));
+      program.Replay(builder);
+      EXPECT_THROW(program.Replay(builder), std::invalid_argument);
+      auto& circuit{motion_parties.at(i)->Compile()};
+      ASSERT_EQ(circuit.GetInputGates().size(), program.GetNumberOfInputGates());
+      const auto& x_input{i == 0 ? x : zeros};
+      const auto& y_input{i == 1 ? y : zeros};
+      circuit.SetInput(0, std::vector<std::uint32_t>(x_input.begin(), x_input.end()));
+      circuit.SetInput(1, std::vector<std::uint32_t>(y_input.begin(), y_input.end()));
+      circuit.SetInput(2, std::vector(i == 0 ? a : zero_bits));
+      circuit.SetInput(3, std::vector(i == 1 ? b : zero_bits));
+
+      motion_parties.at(i)->Run();
+      const auto values{builder.Get(integer_output).As<std::vector<std::uint32_t>>()};
+      ASSERT_EQ(values.size(), kNumberOfValues);
+      for (std::size_t j = 0; j < kNumberOfValues; ++j) EXPECT_EQ(values[j], x[j] * y[j]);
+      EXPECT_EQ(builder.Get(bit_output).As<mo::BitVector<>>(),
+                mo::BitVector<>(std::vector{false, false, true, false}));
+      motion_parties.at(i)->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+  std::filesystem::remove(path);
+}
+
+}  // namespace
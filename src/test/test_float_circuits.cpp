@@ -0,0 +1,233 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_optimizer.h"
+#include "algorithm/float_circuits.h"
+#include "utility/config.h"
+#include "utility/typedefs.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+using T = mo::PrimitiveOperationType;
+using F = mo::FloatingPointOperationType;
+
+std::vector<bool> EvaluatePlain(const mo::AlgorithmDescription& algorithm,
+                                const std::vector<bool>& inputs) {
+  std::vector<bool> wires(algorithm.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  for (const auto& gate : algorithm.gates) {
+    switch (gate.type) {
+      case T::kXor:
+        wires[gate.output_wire] = wires[gate.parent_a] != wires[*gate.parent_b];
+        break;
+      case T::kAnd:
+        wires[gate.output_wire] = wires[gate.parent_a] && wires[*gate.parent_b];
+        break;
+      case T::kInv:
+        wires[gate.output_wire] = !wires[gate.parent_a];
+        break;
+      default:
+        throw std::invalid_argument("Unsupported gate");
+    }
+  }
+  return {wires.end() - algorithm.number_of_output_wires, wires.end()};
+}
+
+template <typename FloatType>
+using Bits = std::conditional_t<sizeof(FloatType) == 4, std::uint32_t, std::uint64_t>;
+
+template <typename FloatType>
+constexpr std::size_t kExponentBits{sizeof(FloatType) == 4 ? 8 : 11};
+
+template <typename FloatType>
+constexpr std::size_t kMantissaBits{std::numeric_limits<FloatType>::digits - 1};
+
+template <typename FloatType>
+mo::AlgorithmDescription MakeCircuit(F type, mo::CircuitObjective objective) {
+  return mo::MakeFloatingPointCircuit(type, kExponentBits<FloatType>, kMantissaBits<FloatType>,
+                                      objective);
+}
+
+// evaluates the circuit on the numbers a and, if it has a parent b, b
+template <typename FloatType>
+Bits<FloatType> Evaluate(const mo::AlgorithmDescription& algorithm, FloatType a,
+                         FloatType b = 0) {
+  constexpr std::size_t kBitlength{8 * sizeof(FloatType)};
+  const auto a_bits{std::bit_cast<Bits<FloatType>>(a)}, b_bits{std::bit_cast<Bits<FloatType>>(b)};
+  std::vector<bool> inputs(algorithm.number_of_input_wires_parent_b ? 2 * kBitlength : kBitlength);
+  for (std::size_t i = 0; i < kBitlength; ++i) {
+    inputs[i] = (a_bits >> i) & 1;
+    if (algorithm.number_of_input_wires_parent_b) inputs[kBitlength + i] = (b_bits >> i) & 1;
+  }
+  const auto outputs{EvaluatePlain(algorithm, inputs)};
+  Bits<FloatType> result{0};
+  for (std::size_t i = 0; i < outputs.size(); ++i) result |= Bits<FloatType>(outputs[i]) << i;
+  return result;
+}
+
+// a random normal number of a random sign whose unbiased exponent is in [-range, range]
+template <typename FloatType>
+FloatType RandomNumber(std::mt19937_64& mersenne_twister, int range) {
+  std::uniform_real_distribution<FloatType> mantissa(1, 2);
+  std::uniform_int_distribution<int> exponent(-range, range);
+  const FloatType x{std::ldexp(mantissa(mersenne_twister), exponent(mersenne_twister))};
+  return mersenne_twister() % 2 ? -x : x;
+}
+
+// the results that are subnormal in IEEE 754 are flushed to zero by the circuits
+template <typename FloatType>
+FloatType FlushToZero(FloatType x) {
+  return std::fpclassify(x) == FP_SUBNORMAL ? std::copysign(FloatType(0), x) : x;
+}
+
+template <typename FloatType>
+class FloatCircuitsTest : public ::testing::Test {};
+
+using FloatTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(FloatCircuitsTest, FloatTypes);
+
+TYPED_TEST(FloatCircuitsTest, ArithmeticIsRoundedToNearestEven) {
+  using FloatType = TypeParam;
+  std::mt19937_64 mersenne_twister(0);
+  for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+    const auto addition{MakeCircuit<FloatType>(F::kAdd, objective)};
+    const auto subtraction{MakeCircuit<FloatType>(F::kSub, objective)};
+    const auto multiplication{MakeCircuit<FloatType>(F::kMul, objective)};
+    const auto division{MakeCircuit<FloatType>(F::kDiv, objective)};
+    const auto square_root{MakeCircuit<FloatType>(F::kSqrt, objective)};
+    for (std::size_t test = 0; test < 200; ++test) {
+      FloatType a{RandomNumber<FloatType>(mersenne_twister, 30)};
+      FloatType b{RandomNumber<FloatType>(mersenne_twister, 30)};
+      // zeros, exact cancellations, and operands that differ in their last bits only
+      if (test < 4) a = test % 2 ? FloatType(-0.0) : FloatType(0);
+      if (test % 4 == 0) b = test % 8 == 0 ? -a : std::copysign(b, a);
+      if (test % 4 == 1) b = std::nextafter(std::nextafter(-a, FloatType(0)), FloatType(0));
+      const auto expect = [](FloatType x) { return std::bit_cast<Bits<FloatType>>(x); };
+      EXPECT_EQ(Evaluate(addition, a, b), expect(FlushToZero(a + b))) << a << " + " << b;
+      EXPECT_EQ(Evaluate(subtraction, a, b), expect(FlushToZero(a - b))) << a << " - " << b;
+      EXPECT_EQ(Evaluate(multiplication, a, b), expect(FlushToZero(a * b))) << a << " * " << b;
+      if (b != 0) {
+        EXPECT_EQ(Evaluate(division, a, b), expect(FlushToZero(a / b))) << a << " / " << b;
+      }
+      const FloatType c{std::abs(a)};
+      EXPECT_EQ(Evaluate(square_root, c), expect(std::sqrt(c))) << "sqrt " << c;
+    }
+  }
+}
+
+TYPED_TEST(FloatCircuitsTest, Comparisons) {
+  using FloatType = TypeParam;
+  std::mt19937_64 mersenne_twister(1);
+  for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+    const auto less{MakeCircuit<FloatType>(F::kLt, objective)};
+    const auto equal{MakeCircuit<FloatType>(F::kEq, objective)};
+    ASSERT_EQ(less.number_of_output_wires, 1);
+    ASSERT_EQ(equal.number_of_output_wires, 1);
+    std::vector<FloatType> numbers{0, -0.0, 1, -1, std::nextafter(FloatType(1), FloatType(2))};
+    for (std::size_t i = 0; i < 20; ++i) {
+      numbers.push_back(RandomNumber<FloatType>(mersenne_twister, 100));
+    }
+    for (const auto a : numbers) {
+      for (const auto b : numbers) {
+        EXPECT_EQ(Evaluate(less, a, b), a < b) << a << " < " << b;
+        EXPECT_EQ(Evaluate(equal, a, b), a == b) << a << " == " << b;
+      }
+    }
+  }
+}
+
+// the error of the result in units of the last place of the exact value
+template <typename FloatType>
+long double GetUlpError(Bits<FloatType> result, long double exact) {
+  const int exponent{std::ilogb(exact) - std::numeric_limits<FloatType>::digits + 1};
+  return std::abs(std::bit_cast<FloatType>(result) - exact) / std::ldexp(1.0L, exponent);
+}
+
+TYPED_TEST(FloatCircuitsTest, ExponentialsAreOffByAtMostOneUlp) {
+  using FloatType = TypeParam;
+  std::mt19937_64 mersenne_twister(2);
+  // the results are normal numbers of both types
+  std::uniform_real_distribution<FloatType> distribution(-80, 80);
+  const auto objective{mo::CircuitObjective::kSize};
+  const auto exp2{MakeCircuit<FloatType>(F::kExp2, objective)};
+  const auto exp{MakeCircuit<FloatType>(F::kExp, objective)};
+  EXPECT_EQ(Evaluate(exp2, FloatType(0)), std::bit_cast<Bits<FloatType>>(FloatType(1)));
+  EXPECT_EQ(Evaluate(exp2, FloatType(-3)), std::bit_cast<Bits<FloatType>>(FloatType(0.125)));
+  // results below the smallest normal number are zero
+  EXPECT_EQ(Evaluate(exp2, FloatType(-1e4)), 0);
+  for (std::size_t test = 0; test < 100; ++test) {
+    const FloatType x{test < 50 ? distribution(mersenne_twister)
+                                : RandomNumber<FloatType>(mersenne_twister, 5)};
+    EXPECT_LE(GetUlpError<FloatType>(Evaluate(exp2, x), std::exp2(static_cast<long double>(x))),
+              1)
+        << "exp2 " << x;
+    EXPECT_LE(GetUlpError<FloatType>(Evaluate(exp, x), std::exp(static_cast<long double>(x))), 1)
+        << "exp " << x;
+  }
+}
+
+TYPED_TEST(FloatCircuitsTest, LogarithmsHaveASmallAbsoluteError) {
+  using FloatType = TypeParam;
+  std::mt19937_64 mersenne_twister(3);
+  const auto objective{mo::CircuitObjective::kSize};
+  const auto log2{MakeCircuit<FloatType>(F::kLog2, objective)};
+  const auto log{MakeCircuit<FloatType>(F::kLog, objective)};
+  EXPECT_EQ(Evaluate(log2, FloatType(1)), 0);
+  EXPECT_EQ(Evaluate(log2, FloatType(0.25)), std::bit_cast<Bits<FloatType>>(FloatType(-2)));
+  const long double bound{std::ldexp(1.0L, -static_cast<int>(kMantissaBits<FloatType>) - 2)};
+  for (std::size_t test = 0; test < 100; ++test) {
+    const FloatType x{std::abs(RandomNumber<FloatType>(mersenne_twister, 100))};
+    const long double exact_log2{std::log2(static_cast<long double>(x))};
+    const long double exact_log{std::log(static_cast<long double>(x))};
+    // the absolute error and the rounding of the result
+    EXPECT_LE(std::abs(std::bit_cast<FloatType>(Evaluate(log2, x)) - exact_log2),
+              bound + std::abs(exact_log2) * std::numeric_limits<FloatType>::epsilon())
+        << "log2 " << x;
+    EXPECT_LE(std::abs(std::bit_cast<FloatType>(Evaluate(log, x)) - exact_log),
+              bound + std::abs(exact_log) * std::numeric_limits<FloatType>::epsilon())
+        << "log " << x;
+  }
+}
+
+TEST(FloatCircuits, InvalidFormatsThrow) {
+  EXPECT_THROW(mo::MakeFloatingPointCircuit(F::kAdd, 1, 23, mo::CircuitObjective::kSize),
+               std::invalid_argument);
+  EXPECT_THROW(mo::MakeFloatingPointCircuit(F::kAdd, 8, 0, mo::CircuitObjective::kSize),
+               std::invalid_argument);
+  EXPECT_THROW(mo::MakeFloatingPointCircuit(F::kInvalid, 8, 23, mo::CircuitObjective::kSize),
+               std::invalid_argument);
+}
+
+}  // namespace
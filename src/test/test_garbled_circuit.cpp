@@ -22,8 +22,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <functional>
 #include <iterator>
+#include <random>
 
 #include "base/party.h"
 #include "protocols/garbled_circuit/garbled_circuit_constants.h"
@@ -406,6 +410,250 @@ TEST_P(GarbledCircuitTest, And) {
     }
   }
 }
+
+TEST_P(GarbledCircuitTest, StreamedAnd) {
+  constexpr std::size_t kDepth{10};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      // small chunks so that the circuit spans several of them
+      this->parties_[party_id]->GetBackend()->GetGarbledCircuitProvider().SetGarbledTablesChunkSize(
+          256);
+      auto [input_share_0, input_promise_0] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              0, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_0(input_share_0);
+
+      auto [input_share_1, input_promise_1] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              1, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_1(input_share_1);
+
+      if (party_id == 0) {
+        input_promise_0->set_value(this->global_inputs_[0]);
+      } else {  // party_id == 1
+        input_promise_1->set_value(this->global_inputs_[1]);
+      }
+
+      auto result{input_0 & input_1};
+      for (std::size_t i = 1; i < kDepth; ++i) result = (i % 2 == 0 ? input_1 : input_0) & result;
+
+      auto output{result.Out()};
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                  this->global_inputs_[0][i] & this->global_inputs_[1][i]);
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+// the chunks of the second circuit are numbered from 0 again
+TEST_P(GarbledCircuitTest, StreamedAndAfterReset) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      auto& party{this->parties_[party_id]};
+      party->GetBackend()->GetGarbledCircuitProvider().SetGarbledTablesChunkSize(256);
+      for (std::size_t run = 0; run < 2; ++run) {
+        auto [input_share_0, input_promise_0] =
+            party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(0, this->number_of_wires_,
+                                                                      this->number_of_simd_);
+        encrypto::motion::ShareWrapper input_0(input_share_0);
+        auto [input_share_1, input_promise_1] =
+            party->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(1, this->number_of_wires_,
+                                                                      this->number_of_simd_);
+        encrypto::motion::ShareWrapper input_1(input_share_1);
+        if (party_id == 0) {
+          input_promise_0->set_value(this->global_inputs_[0]);
+        } else {  // party_id == 1
+          input_promise_1->set_value(this->global_inputs_[1]);
+        }
+
+        auto output{((input_0 & input_1) & input_0).Out()};
+        party->Run();
+        for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+          EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                    this->global_inputs_[0][i] & this->global_inputs_[1][i]);
+        }
+        if (run == 0) party->Reset();
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST_P(GarbledCircuitTest, OfflineGarbling) {
+  constexpr std::size_t kDepth{10};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      auto& provider{this->parties_[party_id]->GetBackend()->GetGarbledCircuitProvider()};
+      provider.SetOfflineGarbling();
+      // also prefetch streamed chunks
+      if (this->number_of_wires_ > 1) provider.SetGarbledTablesChunkSize(256);
+      auto [input_share_0, input_promise_0] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              0, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_0(input_share_0);
+
+      auto [input_share_1, input_promise_1] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              1, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_1(input_share_1);
+
+      if (party_id == 0) {
+        input_promise_0->set_value(this->global_inputs_[0]);
+      } else {  // party_id == 1
+        input_promise_1->set_value(this->global_inputs_[1]);
+      }
+
+      // (a & b) ^ ~a, then alternately AND with a and b
+      auto result{(input_0 & input_1) ^ ~input_0};
+      for (std::size_t i = 1; i < kDepth; ++i) result = (i % 2 == 0 ? input_1 : input_0) & result;
+
+      auto output{result.Out()};
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+        const auto& a{this->global_inputs_[0][i]};
+        const auto& b{this->global_inputs_[1][i]};
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(), a & b & ((a & b) ^ ~a));
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST_P(GarbledCircuitTest, FreeKeysAfterLastUse) {
+  constexpr std::size_t kDepth{10};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      auto& provider{this->parties_[party_id]->GetBackend()->GetGarbledCircuitProvider()};
+      provider.SetFreeKeysAfterLastUse();
+      auto [input_share_0, input_promise_0] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              0, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_0(input_share_0);
+
+      auto [input_share_1, input_promise_1] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              1, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_1(input_share_1);
+
+      if (party_id == 0) {
+        input_promise_0->set_value(this->global_inputs_[0]);
+      } else {  // party_id == 1
+        input_promise_1->set_value(this->global_inputs_[1]);
+      }
+
+      // (a & b) ^ ~a, then alternately AND with a and b, s.t. the keys of the intermediate wires
+      // are freed and their buffers reused
+      auto result{(input_0 & input_1) ^ ~input_0};
+      for (std::size_t i = 1; i < kDepth; ++i) result = (i % 2 == 0 ? input_1 : input_0) & result;
+
+      auto output{result.Out()};
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+        const auto& a{this->global_inputs_[0][i]};
+        const auto& b{this->global_inputs_[1][i]};
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(), a & b & ((a & b) ^ ~a));
+        // all gates reading the keys of the inputs are done
+        auto gc_wire{std::dynamic_pointer_cast<encrypto::motion::proto::garbled_circuit::Wire>(
+            input_share_0->GetWires()[i])};
+        EXPECT_EQ(gc_wire->GetKeys().size(), 0);
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST_P(GarbledCircuitTest, HalfGates) {
+  constexpr std::size_t kDepth{10};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      this->parties_[party_id]->GetConfiguration()->SetGarbledCircuitScheme(
+          encrypto::motion::GarbledCircuitScheme::kHalfGates);
+      auto& provider{this->parties_[party_id]->GetBackend()->GetGarbledCircuitProvider()};
+      EXPECT_TRUE(provider.GetScheme() == encrypto::motion::GarbledCircuitScheme::kHalfGates);
+      // also stream the tables, whose size differs from three-halves
+      if (this->number_of_wires_ > 1) provider.SetGarbledTablesChunkSize(256);
+      auto [input_share_0, input_promise_0] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              0, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_0(input_share_0);
+
+      auto [input_share_1, input_promise_1] =
+          this->parties_[party_id]->In<encrypto::motion::MpcProtocol::kGarbledCircuit>(
+              1, this->number_of_wires_, this->number_of_simd_);
+      encrypto::motion::ShareWrapper input_1(input_share_1);
+
+      if (party_id == 0) {
+        input_promise_0->set_value(this->global_inputs_[0]);
+      } else {  // party_id == 1
+        input_promise_1->set_value(this->global_inputs_[1]);
+      }
+
+      // (a & b) ^ ~a, then alternately AND with a and b
+      auto result{(input_0 & input_1) ^ ~input_0};
+      for (std::size_t i = 1; i < kDepth; ++i) result = (i % 2 == 0 ? input_1 : input_0) & result;
+
+      auto output{result.Out()};
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+        const auto& a{this->global_inputs_[0][i]};
+        const auto& b{this->global_inputs_[1][i]};
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(), a & b & ((a & b) ^ ~a));
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST_P(GarbledCircuitTest, BooleanGmwConversions) {
+  constexpr auto kBooleanGmw{encrypto::motion::MpcProtocol::kBooleanGmw};
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, this]() {
+      encrypto::motion::ShareWrapper input_0(
+          this->parties_[party_id]->In<kBooleanGmw>(this->global_inputs_[0], 0));
+      encrypto::motion::ShareWrapper input_1(
+          this->parties_[party_id]->In<kBooleanGmw>(this->global_inputs_[1], 1));
+
+      // B2Y, AND in the garbled circuit and Y2B
+      auto result{(input_0.Convert<kGarbledCircuit>() & input_1.Convert<kGarbledCircuit>())
+                      .Convert<kBooleanGmw>()};
+      EXPECT_TRUE(result->GetProtocol() == kBooleanGmw);
+      auto output{result.Out()};
+
+      this->parties_[party_id]->Run();
+
+      for (std::size_t i = 0; i < this->number_of_wires_; ++i) {
+        EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                  this->global_inputs_[0][i] & this->global_inputs_[1][i]);
+      }
+      this->parties_[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
 constexpr std::array<std::size_t, 3> kGarbledCircuitNumberOfWires{1, 64, 100};
 constexpr std::array<std::size_t, 3> kGarbledCircuitNumberOfSimd{1, 64, 100};
 constexpr std::array<bool, 2> kGarbledCircuitOnlineAfterSetup{false, true};
@@ -424,3 +672,170 @@ INSTANTIATE_TEST_SUITE_P(GarbledCircuitTestSuite, GarbledCircuitTest,
                          });
 
 }  // namespace
+
+TEST(GarbledCircuit, SelectGarbledCircuitScheme) {
+  using encrypto::motion::GarbledCircuitScheme;
+  using encrypto::motion::proto::garbled_circuit::SelectGarbledCircuitScheme;
+  // unlimited and 10 Gbit/s links are CPU-bound, 1 Gbit/s and slower are bandwidth-bound
+  EXPECT_TRUE(SelectGarbledCircuitScheme(0) == GarbledCircuitScheme::kHalfGates);
+  EXPECT_TRUE(SelectGarbledCircuitScheme(10e9) == GarbledCircuitScheme::kHalfGates);
+  EXPECT_TRUE(SelectGarbledCircuitScheme(1e9) == GarbledCircuitScheme::kThreeHalves);
+  EXPECT_TRUE(SelectGarbledCircuitScheme(100e6) == GarbledCircuitScheme::kThreeHalves);
+}
+
+TEST(GarbledCircuit, ArithmeticGmwConversions) {
+  constexpr auto kArithmeticGmw{encrypto::motion::MpcProtocol::kArithmeticGmw};
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  constexpr std::size_t kNumberOfSimd{100};
+  std::mt19937 mersenne_twister(0);
+  std::vector<std::vector<std::uint32_t>> inputs(2, std::vector<std::uint32_t>(kNumberOfSimd));
+  for (auto& v : inputs) std::generate(v.begin(), v.end(), std::ref(mersenne_twister));
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [party_id, &parties, &inputs]() {
+      encrypto::motion::ShareWrapper input_0(parties[party_id]->In<kArithmeticGmw>(inputs[0], 0));
+      encrypto::motion::ShareWrapper input_1(parties[party_id]->In<kArithmeticGmw>(inputs[1], 1));
+
+      // the sum in arithmetic GMW, A2Y and Y2A
+      auto sum{(input_0 + input_1).Convert<kGarbledCircuit>()};
+      EXPECT_TRUE(sum->GetProtocol() == kGarbledCircuit);
+      auto result{sum.Convert<kArithmeticGmw>()};
+      EXPECT_TRUE(result->GetProtocol() == kArithmeticGmw);
+      auto output{result.Out()};
+
+      parties[party_id]->Run();
+
+      const auto values{output.As<std::vector<std::uint32_t>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(values[i], static_cast<std::uint32_t>(inputs[0][i] + inputs[1][i]));
+      }
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(GarbledCircuit, WideAndInParallel) {
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  using encrypto::motion::proto::garbled_circuit::Provider;
+  // more SIMD values than the threshold and not a multiple of 8, s.t. the 2nd and 3rd wire start
+  // in the middle of a byte of garbled control bits
+  constexpr std::size_t kNumberOfSimd{Provider::kParallelSimdThreshold + 13};
+  constexpr std::size_t kNumberOfWires{3};
+  for (auto scheme : {encrypto::motion::GarbledCircuitScheme::kThreeHalves,
+                      encrypto::motion::GarbledCircuitScheme::kHalfGates}) {
+    std::vector<std::vector<encrypto::motion::BitVector<>>> inputs(2);
+    for (auto& input : inputs) {
+      for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+        input.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+      }
+    }
+
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [party_id, scheme, &parties, &inputs]() {
+        parties[party_id]->GetConfiguration()->SetGarbledCircuitScheme(scheme);
+        encrypto::motion::ShareWrapper input_0(
+            parties[party_id]->In<kGarbledCircuit>(inputs[0], 0));
+        encrypto::motion::ShareWrapper input_1(
+            parties[party_id]->In<kGarbledCircuit>(inputs[1], 1));
+        auto output{(input_0 & input_1).Out()};
+
+        parties[party_id]->Run();
+
+        for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+          EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                    inputs[0][i] & inputs[1][i]);
+        }
+        parties[party_id]->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+TEST(GarbledCircuit, ManyNarrowAndWiresInParallel) {
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  using encrypto::motion::proto::garbled_circuit::Provider;
+  // fewer SIMD values per wire than the threshold, but more in total, s.t. the wires are garbled
+  // and evaluated in parallel
+  constexpr std::size_t kNumberOfSimd{Provider::kParallelSimdThreshold / 4};
+  constexpr std::size_t kNumberOfWires{9};
+  for (auto scheme : {encrypto::motion::GarbledCircuitScheme::kThreeHalves,
+                      encrypto::motion::GarbledCircuitScheme::kHalfGates}) {
+    std::vector<std::vector<encrypto::motion::BitVector<>>> inputs(2);
+    for (auto& input : inputs) {
+      for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+        input.emplace_back(encrypto::motion::BitVector<>::SecureRandom(kNumberOfSimd));
+      }
+    }
+
+    auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+      futures.emplace_back(std::async(std::launch::async, [party_id, scheme, &parties, &inputs]() {
+        parties[party_id]->GetConfiguration()->SetGarbledCircuitScheme(scheme);
+        encrypto::motion::ShareWrapper input_0(
+            parties[party_id]->In<kGarbledCircuit>(inputs[0], 0));
+        encrypto::motion::ShareWrapper input_1(
+            parties[party_id]->In<kGarbledCircuit>(inputs[1], 1));
+        auto output{(input_0 & input_1).Out()};
+
+        parties[party_id]->Run();
+
+        for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+          EXPECT_EQ(output.GetWire(i).As<encrypto::motion::BitVector<>>(),
+                    inputs[0][i] & inputs[1][i]);
+        }
+        parties[party_id]->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+TEST(GarbledCircuit, ManyEvaluatorInputsInOneBatch) {
+  constexpr auto kGarbledCircuit{encrypto::motion::MpcProtocol::kGarbledCircuit};
+  constexpr auto kEvaluator{
+      static_cast<std::size_t>(encrypto::motion::GarbledCircuitRole::kEvaluator)};
+  constexpr auto kGarbler{static_cast<std::size_t>(encrypto::motion::GarbledCircuitRole::kGarbler)};
+  // the OTs of the gates are not byte-aligned in the batch of corrections
+  constexpr std::array<std::size_t, 5> kNumbersOfSimd{1, 3, 13, 100, 7};
+  std::vector<encrypto::motion::BitVector<>> evaluator_inputs, garbler_inputs;
+  for (auto number_of_simd : kNumbersOfSimd) {
+    evaluator_inputs.emplace_back(encrypto::motion::BitVector<>::SecureRandom(number_of_simd));
+    garbler_inputs.emplace_back(encrypto::motion::BitVector<>::SecureRandom(number_of_simd));
+  }
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+    futures.emplace_back(
+        std::async(std::launch::async, [party_id, &parties, &evaluator_inputs, &garbler_inputs]() {
+          std::vector<encrypto::motion::ShareWrapper> outputs;
+          for (std::size_t i = 0; i < evaluator_inputs.size(); ++i) {
+            encrypto::motion::ShareWrapper evaluator_input(
+                parties[party_id]->In<kGarbledCircuit>(evaluator_inputs[i], kEvaluator));
+            encrypto::motion::ShareWrapper garbler_input(
+                parties[party_id]->In<kGarbledCircuit>(garbler_inputs[i], kGarbler));
+            outputs.emplace_back((evaluator_input & garbler_input).Out());
+          }
+
+          parties[party_id]->Run();
+
+          for (std::size_t i = 0; i < evaluator_inputs.size(); ++i) {
+            EXPECT_EQ(outputs[i].As<encrypto::motion::BitVector<>>(),
+                      evaluator_inputs[i] & garbler_inputs[i]);
+          }
+          parties[party_id]->Finish();
+        }));
+  }
+  for (auto& f : futures) f.get();
+}
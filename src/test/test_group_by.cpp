@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/group_by.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+using mo::algorithm::AggregationType;
+
+constexpr std::size_t kNumberOfCategories{7};
+
+// few distinct keys for large groups, some of which are not smaller than kNumberOfCategories
+std::vector<std::uint16_t> RandomKeys(std::size_t size, std::mt19937& random) {
+  std::vector<std::uint16_t> keys(size);
+  std::generate(keys.begin(), keys.end(), [&]() { return random() % (kNumberOfCategories + 2); });
+  return keys;
+}
+
+std::uint32_t Aggregate(const std::vector<std::uint32_t>& values, AggregationType type) {
+  switch (type) {
+    case AggregationType::kSum: {
+      std::uint32_t sum{0};
+      for (const auto v : values) sum += v;
+      return sum;
+    }
+    case AggregationType::kCount:
+      return static_cast<std::uint32_t>(values.size());
+    case AggregationType::kMax:
+      return values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+  }
+  return 0;
+}
+
+template <mo::MpcProtocol P>
+void TestGroupBy(std::size_t number_of_parties, std::size_t number_of_rows,
+                 AggregationType type) {
+  std::mt19937 random(number_of_rows);
+  const auto keys{RandomKeys(number_of_rows, random)};
+  std::vector<std::uint32_t> values(number_of_rows);
+  std::generate(values.begin(), values.end(), [&]() { return random() % 1000; });
+  std::map<std::uint16_t, std::vector<std::uint32_t>> groups;
+  for (std::size_t i = 0; i < number_of_rows; ++i) groups[keys[i]].push_back(values[i]);
+  auto expected_keys{keys};
+  std::sort(expected_keys.begin(), expected_keys.end());
+
+  auto parties{mo::MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper key_share{party->In<P>(mo::ToInput(keys), 0)};
+      mo::ShareWrapper value_share{party->In<P>(mo::ToInput(values), 1)};
+
+      auto result{mo::algorithm::GroupBy(key_share, value_share, type)};
+      auto keys_output{result.keys.Out()};
+      auto ends_output{result.is_group_end.Out()};
+      auto aggregates_output{result.aggregates.Out()};
+      mo::SecureUnsignedIntegerVector categories_output;
+      if constexpr (P == mo::MpcProtocol::kBooleanGmw) {
+        categories_output = mo::algorithm::GroupByCategories(key_share, value_share,
+                                                             kNumberOfCategories, type)
+                                .Out();
+      }
+
+      party->Run();
+
+      const auto sorted_keys{
+          mo::ToVectorOutput<std::uint16_t>(keys_output.As<std::vector<mo::BitVector<>>>())};
+      EXPECT_EQ(sorted_keys, expected_keys);
+      const auto is_group_end{ends_output.As<mo::BitVector<>>()};
+      const auto aggregates{aggregates_output.As<std::uint32_t>()};
+      std::size_t number_of_groups{0};
+      for (std::size_t i = 0; i < number_of_rows; ++i) {
+        const bool expected_end{i + 1 == number_of_rows || sorted_keys[i] != sorted_keys[i + 1]};
+        EXPECT_EQ(is_group_end.Get(i), expected_end);
+        if (!expected_end) continue;
+        ++number_of_groups;
+        EXPECT_EQ(aggregates[i], Aggregate(groups[sorted_keys[i]], type));
+      }
+      EXPECT_EQ(number_of_groups, groups.size());
+      if constexpr (P == mo::MpcProtocol::kBooleanGmw) {
+        const auto categories{categories_output.As<std::uint32_t>()};
+        ASSERT_EQ(categories.size(), kNumberOfCategories);
+        for (std::uint16_t c = 0; c < kNumberOfCategories; ++c) {
+          EXPECT_EQ(categories[c], Aggregate(groups[c], type));
+        }
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(GroupBy, BooleanGmwTwoParties) {
+  for (const auto type : {AggregationType::kSum, AggregationType::kCount, AggregationType::kMax}) {
+    TestGroupBy<mo::MpcProtocol::kBooleanGmw>(2, 37, type);
+  }
+}
+
+TEST(GroupBy, BooleanGmwThreeParties) {
+  TestGroupBy<mo::MpcProtocol::kBooleanGmw>(3, 20, AggregationType::kSum);
+  TestGroupBy<mo::MpcProtocol::kBooleanGmw>(3, 1, AggregationType::kCount);
+}
+
+TEST(GroupBy, Bmr) {
+  TestGroupBy<mo::MpcProtocol::kBmr>(2, 16, AggregationType::kSum);
+  TestGroupBy<mo::MpcProtocol::kBmr>(2, 16, AggregationType::kMax);
+}
+
+}  // namespace
@@ -22,11 +22,53 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <gtest/gtest.h>
 #include <openssl/rand.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <string>
 #include <vector>
 
+// writes the arithmetic circuit of ArithmeticTestCircuit on inputs of bit_length bits to a
+// temporary file and returns its path, which is unique per process and test s.t. test binaries
+// running in parallel do not overwrite each other's circuits
+inline std::string WriteArithmeticTestCircuit(std::size_t bit_length) {
+  std::string test_name;
+  if (const auto* test_info{::testing::UnitTest::GetInstance()->current_test_info()}) {
+    // names of typed and parameterized tests contain slashes
+    test_name = std::string(test_info->test_suite_name()) + "_" + test_info->name();
+    for (auto& c : test_name) {
+      if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+  }
+  const auto path{(std::filesystem::temp_directory_path() /
+                   ("motion_arithmetic_test_circuit_" + std::to_string(::getpid()) + "_" +
+                    test_name + "_" + std::to_string(bit_length) + ".txt"))
+                      .string()};
+  std::ofstream(path) << "6 9\n"
+                      << bit_length << " 3 1\n"
+                      << "\n"
+                         "2 1 0 1 3 MUL\n"
+                         "1 1 3 4 CMUL 3\n"
+                         "4 1 0 1 2 2 5 DOT\n"
+                         "2 1 4 5 6 ADD\n"
+                         "2 1 2 2 7 MUL\n"
+                         "2 1 6 7 8 ADD\n";
+  return path;
+}
+
+// 3 * x0 * x1 + (x0, x1) . (x2, x2) + x2 * x2
+template <typename T>
+inline T ArithmeticTestCircuit(T x0, T x1, T x2) {
+  const std::uint64_t a{x0}, b{x1}, c{x2};
+  return static_cast<T>(3 * a * b + a * c + b * c + c * c);
+}
+
 template <typename T>
 inline T Rand() {
   unsigned char buf[sizeof(T)];
@@ -0,0 +1,302 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/algorithm_description.h"
+#include "algorithm/circuit_optimizer.h"
+#include "algorithm/integer_circuits.h"
+#include "utility/config.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+using T = mo::PrimitiveOperationType;
+using uint128_t = unsigned __int128;
+
+std::vector<bool> EvaluatePlain(const mo::AlgorithmDescription& algorithm,
+                                const std::vector<bool>& inputs) {
+  std::vector<bool> wires(algorithm.number_of_wires);
+  std::copy(inputs.begin(), inputs.end(), wires.begin());
+  for (const auto& gate : algorithm.gates) {
+    switch (gate.type) {
+      case T::kXor:
+        wires[gate.output_wire] = wires[gate.parent_a] != wires[*gate.parent_b];
+        break;
+      case T::kAnd:
+        wires[gate.output_wire] = wires[gate.parent_a] && wires[*gate.parent_b];
+        break;
+      case T::kInv:
+        wires[gate.output_wire] = !wires[gate.parent_a];
+        break;
+      default:
+        throw std::invalid_argument("Unsupported gate");
+    }
+  }
+  return {wires.end() - algorithm.number_of_output_wires, wires.end()};
+}
+
+// evaluates the circuit on the integers a and b of bitlength bits, least significant bit first
+uint128_t EvaluateOnIntegers(const mo::AlgorithmDescription& algorithm, std::size_t bitlength,
+                             uint128_t a, uint128_t b) {
+  std::vector<bool> inputs(2 * bitlength);
+  for (std::size_t i = 0; i < bitlength; ++i) {
+    inputs[i] = (a >> i) & 1;
+    inputs[bitlength + i] = (b >> i) & 1;
+  }
+  const auto outputs{EvaluatePlain(algorithm, inputs)};
+  uint128_t result{0};
+  for (std::size_t i = 0; i < outputs.size(); ++i) result |= uint128_t(outputs[i]) << i;
+  return result;
+}
+
+constexpr std::size_t kBitlengths[]{1, 2, 3, 7, 8, 13, 16, 31, 32, 64, 100, 128};
+
+uint128_t GetMask(std::size_t bitlength) {
+  return bitlength == 128 ? ~uint128_t(0) : (uint128_t(1) << bitlength) - 1;
+}
+
+// the two's complement value of the lower bitlength bits of x
+__int128 ToSigned(uint128_t x, std::size_t bitlength) {
+  const std::size_t shift{128 - bitlength};
+  return static_cast<__int128>(x << shift) >> shift;
+}
+
+// checks the circuits of generator against operation(a, b, bitlength) on random integers
+template <typename Generator, typename Operation>
+void ExpectComputes(Generator generator, Operation operation) {
+  std::mt19937_64 mersenne_twister(0);
+  const auto random = [&mersenne_twister]() {
+    return (uint128_t(mersenne_twister()) << 64) | mersenne_twister();
+  };
+  for (const auto bitlength : kBitlengths) {
+    const uint128_t mask{GetMask(bitlength)};
+    for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+      const auto algorithm{generator(bitlength, objective)};
+      ASSERT_EQ(algorithm.number_of_input_wires_parent_a, bitlength);
+      ASSERT_EQ(algorithm.number_of_input_wires_parent_b, bitlength);
+      ASSERT_EQ(algorithm.number_of_output_wires, bitlength);
+      ASSERT_EQ(algorithm.number_of_wires, 2 * bitlength + algorithm.gates.size());
+      ASSERT_EQ(algorithm.number_of_gates, algorithm.gates.size());
+      for (std::size_t test = 0; test < 40; ++test) {
+        const uint128_t a{random() & mask};
+        // all ones make every carry propagate through all bits, zero and shorter values are
+        // divisors of all results
+        uint128_t b{random() & mask};
+        if (test == 0) {
+          b = mask;
+        } else if (test == 1) {
+          b = 0;
+        } else if (test % 2 == 0) {
+          b >>= mersenne_twister() % bitlength;
+        }
+        EXPECT_TRUE(EvaluateOnIntegers(algorithm, bitlength, a, b) ==
+                    (operation(a, b, bitlength) & mask))
+            << bitlength;
+      }
+    }
+  }
+}
+
+std::size_t CeilLog2(std::size_t x) {
+  std::size_t result{0};
+  while ((std::size_t(1) << result) < x) ++result;
+  return result;
+}
+
+TEST(IntegerCircuits, AdditionComputesSum) {
+  ExpectComputes(mo::MakeAdditionCircuit,
+                 [](uint128_t a, uint128_t b, std::size_t) { return a + b; });
+}
+
+TEST(IntegerCircuits, SubtractionComputesDifference) {
+  ExpectComputes(mo::MakeSubtractionCircuit,
+                 [](uint128_t a, uint128_t b, std::size_t) { return a - b; });
+}
+
+TEST(IntegerCircuits, GreaterThanCompares) {
+  std::mt19937_64 mersenne_twister(0);
+  for (const auto bitlength : kBitlengths) {
+    const uint128_t mask{GetMask(bitlength)};
+    for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+      const auto unsigned_algorithm{mo::MakeGreaterThanCircuit(bitlength, objective)};
+      const auto signed_algorithm{mo::MakeSignedGreaterThanCircuit(bitlength, objective)};
+      ASSERT_EQ(unsigned_algorithm.number_of_output_wires, 1);
+      ASSERT_EQ(signed_algorithm.number_of_output_wires, 1);
+      const auto unsigned_statistics{mo::GetAlgorithmStatistics(unsigned_algorithm)};
+      const auto signed_statistics{mo::GetAlgorithmStatistics(signed_algorithm)};
+      if (objective == mo::CircuitObjective::kSize) {
+        EXPECT_EQ(unsigned_statistics.number_of_and_gates, bitlength);
+        EXPECT_EQ(signed_statistics.number_of_and_gates, bitlength);
+      } else {
+        EXPECT_LE(unsigned_statistics.and_depth, CeilLog2(bitlength + 1));
+        EXPECT_LE(signed_statistics.and_depth, CeilLog2(bitlength + 1));
+      }
+      for (std::size_t test = 0; test < 40; ++test) {
+        const uint128_t a{(uint128_t(mersenne_twister()) << 64 | mersenne_twister()) & mask};
+        // equal values and values that only differ in the lowest bits
+        uint128_t b{(uint128_t(mersenne_twister()) << 64 | mersenne_twister()) & mask};
+        if (test == 0) {
+          b = a;
+        } else if (test % 2 == 0) {
+          b = a ^ (b >> (mersenne_twister() % bitlength));
+        }
+        EXPECT_EQ(EvaluateOnIntegers(unsigned_algorithm, bitlength, a, b), a > b) << bitlength;
+        EXPECT_EQ(EvaluateOnIntegers(signed_algorithm, bitlength, a, b),
+                  ToSigned(a, bitlength) > ToSigned(b, bitlength))
+            << bitlength;
+      }
+    }
+  }
+}
+
+TEST(IntegerCircuits, MultiplicationComputesProduct) {
+  ExpectComputes(mo::MakeMultiplicationCircuit,
+                 [](uint128_t a, uint128_t b, std::size_t) { return a * b; });
+}
+
+TEST(IntegerCircuits, DivisionComputesQuotient) {
+  ExpectComputes(mo::MakeDivisionCircuit, [](uint128_t a, uint128_t b, std::size_t) {
+    return b == 0 ? ~uint128_t(0) : a / b;
+  });
+}
+
+TEST(IntegerCircuits, SignedDivisionComputesQuotient) {
+  ExpectComputes(mo::MakeSignedDivisionCircuit, [](uint128_t a, uint128_t b,
+                                                   std::size_t bitlength) {
+    const auto signed_a{ToSigned(a, bitlength)}, signed_b{ToSigned(b, bitlength)};
+    if (signed_b == 0) return static_cast<uint128_t>(signed_a < 0 ? 1 : -1);
+    // the quotient of the smallest integer by -1 wraps around
+    if (signed_b == -1) return static_cast<uint128_t>(-static_cast<uint128_t>(signed_a));
+    return static_cast<uint128_t>(signed_a / signed_b);
+  });
+}
+
+TEST(IntegerCircuits, AbsoluteValueNegatesNegativeIntegers) {
+  std::mt19937_64 mersenne_twister(0);
+  for (const auto bitlength : kBitlengths) {
+    const uint128_t mask{GetMask(bitlength)};
+    for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+      const auto algorithm{mo::MakeAbsoluteValueCircuit(bitlength, objective)};
+      ASSERT_EQ(algorithm.number_of_input_wires_parent_a, bitlength);
+      ASSERT_FALSE(algorithm.number_of_input_wires_parent_b);
+      ASSERT_EQ(algorithm.number_of_output_wires, bitlength);
+      if (objective == mo::CircuitObjective::kSize) {
+        EXPECT_LE(mo::GetAlgorithmStatistics(algorithm).number_of_and_gates,
+                  std::max<std::size_t>(bitlength, 2) - 1);
+      }
+      for (std::size_t test = 0; test < 40; ++test) {
+        // zero, all ones, the smallest integer and random integers
+        uint128_t x{(uint128_t(mersenne_twister()) << 64) | mersenne_twister()};
+        if (test == 0) x = 0;
+        if (test == 1) x = mask;
+        if (test == 2) x = uint128_t(1) << (bitlength - 1);
+        x &= mask;
+        std::vector<bool> bits(bitlength);
+        for (std::size_t i = 0; i < bitlength; ++i) bits[i] = (x >> i) & 1;
+        const auto outputs{EvaluatePlain(algorithm, bits)};
+        uint128_t result{0};
+        for (std::size_t i = 0; i < outputs.size(); ++i) result |= uint128_t(outputs[i]) << i;
+        const auto signed_x{ToSigned(x, bitlength)};
+        const uint128_t expected{signed_x < 0 ? -static_cast<uint128_t>(signed_x)
+                                              : static_cast<uint128_t>(signed_x)};
+        EXPECT_EQ(result, expected & mask) << bitlength;
+      }
+    }
+  }
+}
+
+TEST(IntegerCircuits, HammingWeightCountsOnes) {
+  std::mt19937_64 mersenne_twister(0);
+  for (const std::size_t number_of_bits : {1, 2, 3, 4, 7, 8, 13, 64, 100, 1000}) {
+    for (const auto objective : {mo::CircuitObjective::kSize, mo::CircuitObjective::kDepth}) {
+      const auto algorithm{mo::MakeHammingWeightCircuit(number_of_bits, objective)};
+      ASSERT_EQ(algorithm.number_of_input_wires_parent_a, number_of_bits);
+      ASSERT_FALSE(algorithm.number_of_input_wires_parent_b);
+      ASSERT_EQ(algorithm.number_of_output_wires, std::bit_width(number_of_bits));
+      ASSERT_EQ(algorithm.number_of_wires, number_of_bits + algorithm.gates.size());
+      const auto statistics{mo::GetAlgorithmStatistics(algorithm)};
+      if (objective == mo::CircuitObjective::kSize) {
+        EXPECT_LT(statistics.number_of_and_gates, std::max<std::size_t>(number_of_bits, 1));
+      } else {
+        EXPECT_LE(statistics.and_depth, 2 * CeilLog2(number_of_bits));
+      }
+      for (std::size_t test = 0; test < 20; ++test) {
+        // all zeros and all ones besides random bits
+        std::vector<bool> bits(number_of_bits, test == 1);
+        if (test > 1) {
+          for (std::size_t i = 0; i < number_of_bits; ++i) bits[i] = mersenne_twister() & 1;
+        }
+        const auto outputs{EvaluatePlain(algorithm, bits)};
+        std::size_t hamming_weight{0};
+        for (std::size_t i = 0; i < outputs.size(); ++i) hamming_weight |= outputs[i] << i;
+        EXPECT_EQ(hamming_weight, std::count(bits.begin(), bits.end(), true)) << number_of_bits;
+      }
+    }
+  }
+}
+
+TEST(IntegerCircuits, AdditionHasMinimalCost) {
+  for (const auto bitlength : kBitlengths) {
+    const auto size{mo::GetAlgorithmStatistics(
+        mo::MakeAdditionCircuit(bitlength, mo::CircuitObjective::kSize))};
+    EXPECT_EQ(size.number_of_and_gates, bitlength - 1);
+    const auto depth{mo::GetAlgorithmStatistics(
+        mo::MakeAdditionCircuit(bitlength, mo::CircuitObjective::kDepth))};
+    EXPECT_EQ(depth.and_depth, CeilLog2(bitlength)) << bitlength;
+  }
+}
+
+TEST(IntegerCircuits, NotWorseThanCircuitFiles) {
+  for (const std::size_t bitlength : {8, 16, 32, 64}) {
+    for (const std::string operation : {"add", "sub", "mul", "div", "gt"}) {
+      const auto generator{operation == "add"   ? mo::MakeAdditionCircuit
+                           : operation == "sub" ? mo::MakeSubtractionCircuit
+                           : operation == "mul" ? mo::MakeMultiplicationCircuit
+                           : operation == "div" ? mo::MakeDivisionCircuit
+                                                : mo::MakeGreaterThanCircuit};
+      const auto path = [&](const std::string& suffix) {
+        return std::string(mo::kRootDir) + "/circuits/int/int_" + operation +
+               std::to_string(bitlength) + suffix + ".bristol";
+      };
+      const auto size_file{
+          mo::GetAlgorithmStatistics(mo::AlgorithmDescription::FromBristol(path("_size")))};
+      const auto depth_file{
+          mo::GetAlgorithmStatistics(mo::AlgorithmDescription::FromBristol(path("_depth")))};
+      const auto size{
+          mo::GetAlgorithmStatistics(generator(bitlength, mo::CircuitObjective::kSize))};
+      const auto depth{
+          mo::GetAlgorithmStatistics(generator(bitlength, mo::CircuitObjective::kDepth))};
+      EXPECT_LE(size.number_of_and_gates, size_file.number_of_and_gates) << path("_size");
+      EXPECT_LE(depth.and_depth, depth_file.and_depth) << path("_depth");
+    }
+  }
+}
+
+}  // namespace
@@ -24,12 +24,18 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <limits>
 #include <random>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "algorithm/algorithm_description.h"
+#include "algorithm/embedded_circuits.h"
+#include "algorithm/evaluation_template.h"
 #include "base/party.h"
 #include "protocols/bmr/bmr_wire.h"
 #include "protocols/boolean_gmw/boolean_gmw_wire.h"
@@ -82,6 +88,197 @@ TEST(AlgorithmDescription, FromBristolFormatIntAdd8Size) {
   EXPECT_EQ(gate33.selection_bit.has_value(), false);
 }
 
+TEST(AlgorithmDescription, FromBristolTextValidatesWires) {
+  using encrypto::motion::AlgorithmDescription;
+  std::string text{"64 66\n2 1\n\n"};
+  for (std::size_t i = 0; i < 64; ++i) text += "2 1 0 1 " + std::to_string(i + 2) + " XOR\n";
+  const auto algorithm{AlgorithmDescription::FromBristolText(text)};
+  ASSERT_EQ(algorithm.gates.size(), 64);
+  for (std::size_t i = 0; i < 64; ++i) EXPECT_EQ(algorithm.gates[i].output_wire, i + 2);
+
+  EXPECT_THROW(AlgorithmDescription::FromBristolText("1 3\n2 1\n\n2 1 0 1 3 AND\n"),
+               std::runtime_error);
+  EXPECT_THROW(AlgorithmDescription::FromBristolText("1 3\n2 1\n\n2 1 0 x 2 AND\n"),
+               std::runtime_error);
+  EXPECT_THROW(AlgorithmDescription::FromBristolText("1 3\n2 1\n\n2 1 0 2 AND\n"),
+               std::runtime_error);
+}
+
+TEST(AlgorithmDescription, BinaryFormatRoundTrip) {
+  const auto int_add8 = encrypto::motion::AlgorithmDescription::FromBristol(
+      std::string(encrypto::motion::kRootDir) + "/circuits/int/int_add8_size.bristol");
+  const auto path{(std::filesystem::temp_directory_path() / "motion_int_add8_size.mbc").string()};
+  int_add8.ToBinary(path);
+  const auto binary = encrypto::motion::AlgorithmDescription::FromBinary(path);
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(binary.number_of_gates, int_add8.number_of_gates);
+  EXPECT_EQ(binary.number_of_output_wires, int_add8.number_of_output_wires);
+  EXPECT_EQ(binary.number_of_input_wires_parent_a, int_add8.number_of_input_wires_parent_a);
+  EXPECT_EQ(binary.number_of_input_wires_parent_b, int_add8.number_of_input_wires_parent_b);
+  EXPECT_EQ(binary.number_of_wires, int_add8.number_of_wires);
+  ASSERT_EQ(binary.gates.size(), int_add8.gates.size());
+  for (std::size_t i = 0; i < binary.gates.size(); ++i) {
+    EXPECT_TRUE(binary.gates[i].type == int_add8.gates[i].type);
+    EXPECT_EQ(binary.gates[i].parent_a, int_add8.gates[i].parent_a);
+    EXPECT_EQ(binary.gates[i].parent_b, int_add8.gates[i].parent_b);
+    EXPECT_EQ(binary.gates[i].selection_bit, int_add8.gates[i].selection_bit);
+    EXPECT_EQ(binary.gates[i].output_wire, int_add8.gates[i].output_wire);
+  }
+
+  std::ofstream(path) << "int_add8_size";
+  EXPECT_THROW(encrypto::motion::AlgorithmDescription::FromBinary(path), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(AlgorithmDescription, EmbeddedCircuitsMatchBristol) {
+  using encrypto::motion::kRootDir;
+  const auto int_add8{encrypto::motion::FindEmbeddedCircuit("circuits/int/int_add8_size.bristol")};
+  ASSERT_NE(int_add8, nullptr);
+  EXPECT_EQ(encrypto::motion::FindEmbeddedCircuit(std::string(kRootDir) +
+                                                  "/circuits/int/int_add8_size.bristol"),
+            int_add8);
+  EXPECT_EQ(encrypto::motion::FindEmbeddedCircuit("circuits/int/int_add7_size.bristol"), nullptr);
+
+  for (const auto& circuit : encrypto::motion::GetEmbeddedCircuits()) {
+    const auto embedded{encrypto::motion::ToAlgorithmDescription(circuit)};
+    const auto bristol{encrypto::motion::AlgorithmDescription::FromBristol(
+        std::string(kRootDir) + "/" + std::string(circuit.path))};
+    EXPECT_EQ(embedded.number_of_gates, bristol.number_of_gates) << circuit.path;
+    EXPECT_EQ(embedded.number_of_output_wires, bristol.number_of_output_wires);
+    EXPECT_EQ(embedded.number_of_input_wires_parent_a, bristol.number_of_input_wires_parent_a);
+    EXPECT_EQ(embedded.number_of_input_wires_parent_b, bristol.number_of_input_wires_parent_b);
+    EXPECT_EQ(embedded.number_of_wires, bristol.number_of_wires);
+    ASSERT_EQ(embedded.gates.size(), bristol.gates.size()) << circuit.path;
+    for (std::size_t i = 0; i < embedded.gates.size(); ++i) {
+      EXPECT_TRUE(embedded.gates[i].type == bristol.gates[i].type);
+      EXPECT_EQ(embedded.gates[i].parent_a, bristol.gates[i].parent_a);
+      EXPECT_EQ(embedded.gates[i].parent_b, bristol.gates[i].parent_b);
+      EXPECT_EQ(embedded.gates[i].selection_bit, bristol.gates[i].selection_bit);
+      EXPECT_EQ(embedded.gates[i].output_wire, bristol.gates[i].output_wire);
+    }
+  }
+}
+
+TEST(AlgorithmDescription, FromBristolFashionExtensions) {
+  const auto path{
+      (std::filesystem::temp_directory_path() / "motion_bristol_fashion_extensions.txt").string()};
+  // 3 input values of 2 wires, the outputs are !((a0 ^ a1) & b0 & c0), b1 & c1 and 1
+  std::ofstream(path) << "7 14\n"
+                         "3 2 2 2\n"
+                         "3 1 1 1\n"
+                         "\n"
+                         "1 1 1 6 EQ\n"
+                         "2 1 0 1 7 XOR\n"
+                         "2 1 7 2 8 AND\n"
+                         "4 2 8 3 4 5 9 10 MAND\n"
+                         "2 1 6 9 11 XOR\n"
+                         "1 1 10 12 EQW\n"
+                         "1 1 6 13 EQW\n";
+  auto algorithm{AlgorithmDescription::FromBristolFashion(path)};
+  EXPECT_EQ(algorithm.number_of_input_wires_parent_a, 2);
+  EXPECT_EQ(algorithm.number_of_input_wires_parent_b, 4);
+  EXPECT_EQ(algorithm.number_of_output_wires, 3);
+  EXPECT_EQ(algorithm.number_of_wires, 14);
+  EXPECT_EQ(algorithm.number_of_gates, algorithm.gates.size());
+  ASSERT_EQ(algorithm.and_groups.size(), 1);
+  EXPECT_EQ(algorithm.and_groups[0], std::make_pair(std::size_t(2), std::size_t(2)));
+
+  for (std::size_t input = 0; input < 64; ++input) {
+    std::vector<bool> wires(algorithm.number_of_wires);
+    for (std::size_t i = 0; i < 6; ++i) wires[i] = (input >> i) & 1;
+    for (const auto& gate : algorithm.gates) {
+      if (gate.type == PrimitiveOperationType::kXor) {
+        wires[gate.output_wire] = wires[gate.parent_a] != wires[*gate.parent_b];
+      } else if (gate.type == PrimitiveOperationType::kAnd) {
+        wires[gate.output_wire] = wires[gate.parent_a] && wires[*gate.parent_b];
+      } else {
+        ASSERT_EQ(gate.type, PrimitiveOperationType::kInv);
+        wires[gate.output_wire] = !wires[gate.parent_a];
+      }
+    }
+    EXPECT_EQ(wires[11], !((wires[0] != wires[1]) && wires[2] && wires[4]));
+    EXPECT_EQ(wires[12], wires[3] && wires[5]);
+    EXPECT_TRUE(wires[13]);
+  }
+
+  // the ANDs of the MAND are in a single batch although their parents are in different layers
+  const EvaluationTemplate evaluation_template(algorithm);
+  EXPECT_TRUE(std::any_of(evaluation_template.GetBatches().begin(),
+                          evaluation_template.GetBatches().end(), [](const auto& batch) {
+                            return batch.output_wires == std::vector<std::size_t>{9, 10};
+                          }));
+
+  const auto binary_path{AlgorithmDescription::GetBinaryPath(path)};
+  algorithm.ToBinary(binary_path);
+  EXPECT_EQ(AlgorithmDescription::FromBinary(binary_path).and_groups, algorithm.and_groups);
+  std::filesystem::remove(binary_path);
+
+  std::ofstream(path) << "1 4\n"
+                         "1 2\n"
+                         "1 2\n"
+                         "\n"
+                         "3 1 0 1 2 3 MAND\n";
+  EXPECT_THROW(AlgorithmDescription::FromBristolFashion(path), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(AlgorithmDescription, EvaluateSimdOnIndependentInputs) {
+  const auto int_add8{AlgorithmDescription::FromBristol(std::string(kRootDir) +
+                                                       "/circuits/int/int_add8_size.bristol")};
+  std::mt19937 mersenne_twister(0);
+  std::uniform_int_distribution<std::uint8_t> distribution;
+  // records with 1 SIMD value each are split up by Unsimdify, the others by Subset
+  for (const std::vector<std::size_t> numbers_of_simd :
+       {std::vector<std::size_t>{1, 1, 1, 1}, std::vector<std::size_t>{1, 2, 1, 3}}) {
+    std::vector<std::vector<std::uint8_t>> a(numbers_of_simd.size()), b(numbers_of_simd.size());
+    for (std::size_t i = 0; i < numbers_of_simd.size(); ++i) {
+      for (std::size_t j = 0; j < numbers_of_simd[i]; ++j) {
+        a[i].push_back(distribution(mersenne_twister));
+        b[i].push_back(distribution(mersenne_twister));
+      }
+    }
+    for (const auto protocol : {MpcProtocol::kBmr, MpcProtocol::kBooleanGmw}) {
+      std::vector<PartyPointer> motion_parties(MakeLocallyConnectedParties(2, kPortOffset));
+      for (auto& party : motion_parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      std::vector<std::thread> threads;
+      for (auto party_id = 0u; party_id < motion_parties.size(); ++party_id) {
+        threads.emplace_back([&, party_id]() {
+          auto& party{motion_parties.at(party_id)};
+          std::vector<ShareWrapper> inputs;
+          for (std::size_t i = 0; i < numbers_of_simd.size(); ++i) {
+            std::vector<ShareWrapper> wires;
+            for (const auto& values : {a[i], b[i]}) {
+              const auto bits{party_id == 0 ? ToInput(values)
+                                            : std::vector<BitVector<>>(
+                                                  8, BitVector<>(numbers_of_simd[i], false))};
+              wires.push_back(protocol == MpcProtocol::kBmr
+                                  ? ShareWrapper(party->In<MpcProtocol::kBmr>(bits, 0))
+                                  : ShareWrapper(party->In<MpcProtocol::kBooleanGmw>(bits, 0)));
+            }
+            inputs.push_back(ShareWrapper::Concatenate(wires));
+          }
+          const auto number_of_gates{party->GetBackend()->GetRegister()->GetGates().size()};
+          auto outputs{ShareWrapper::EvaluateSimd(int_add8, inputs)};
+          // one circuit instead of one per record
+          EXPECT_LT(party->GetBackend()->GetRegister()->GetGates().size() - number_of_gates,
+                    2 * int_add8.gates.size());
+          for (auto& output : outputs) output = output.Out();
+          party->Run();
+          for (std::size_t i = 0; i < numbers_of_simd.size(); ++i) {
+            std::vector<std::uint8_t> expected(numbers_of_simd[i]);
+            for (std::size_t j = 0; j < expected.size(); ++j) expected[j] = a[i][j] + b[i][j];
+            EXPECT_EQ(ToVectorOutput<std::uint8_t>(outputs[i].As<std::vector<BitVector<>>>()),
+                      expected);
+          }
+          party->Finish();
+        });
+      }
+      for (auto& t : threads) t.join();
+    }
+  }
+}
+
 // TODO: rewrite as generic tests
 template <typename T>
 class SecureUintTest : public ::testing::Test {
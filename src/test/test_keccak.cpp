@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "algorithm/keccak.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+using encrypto::motion::BitVector;
+using encrypto::motion::MpcProtocol;
+using encrypto::motion::ShareWrapper;
+
+std::vector<std::uint8_t> HexToBytes(const std::string& hex) {
+  std::vector<std::uint8_t> bytes;
+  for (std::size_t i = 0; i < hex.size(); i += 2) {
+    bytes.push_back(static_cast<std::uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+// wire i is bit i % 8 of byte i / 8 as in FIPS 202, one SIMD value per byte string
+std::vector<BitVector<>> BytesToWires(const std::vector<std::vector<std::uint8_t>>& bytes) {
+  std::vector<BitVector<>> wires(8 * bytes.at(0).size());
+  for (const auto& simd_value : bytes) {
+    for (std::size_t wire_i = 0; wire_i < wires.size(); ++wire_i) {
+      wires[wire_i].Append(((simd_value[wire_i / 8] >> (wire_i % 8)) & 1) == 1);
+    }
+  }
+  return wires;
+}
+
+std::vector<std::uint8_t> Range(std::uint8_t first, std::size_t size) {
+  std::vector<std::uint8_t> bytes(size);
+  for (std::size_t i = 0; i < size; ++i) bytes[i] = static_cast<std::uint8_t>(first + i);
+  return bytes;
+}
+
+// evaluates function on the input of party 0 with one party per thread
+template <MpcProtocol kProtocol, typename Function>
+void EvaluateOnInput(const std::vector<BitVector<>>& input,
+                     const std::vector<BitVector<>>& expected_output, Function function) {
+  const std::vector<BitVector<>> dummy_input(input.size(), BitVector<>(input.at(0).GetSize()));
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id]() {
+      ShareWrapper input_share{
+          parties[party_id]->In<kProtocol>(party_id == 0 ? input : dummy_input, 0)};
+      auto output{function(input_share).Out()};
+      parties[party_id]->Run();
+      EXPECT_EQ(output.template As<std::vector<BitVector<>>>(), expected_output);
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+const std::vector<std::vector<std::uint8_t>> kSha3Messages{{'a', 'b', 'c'}, Range(0, 3)};
+const std::vector<std::vector<std::uint8_t>> kSha3Digests{
+    HexToBytes("3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"),
+    HexToBytes("1186d49a4ad620618f760f29da2c593b2ec2cc2ced69dc16817390d861e62253")};
+
+TEST(Keccak, Sha3_256BooleanGmw) {
+  EvaluateOnInput<MpcProtocol::kBooleanGmw>(
+      BytesToWires(kSha3Messages), BytesToWires(kSha3Digests),
+      [](const ShareWrapper& message) { return encrypto::motion::algorithm::Sha3_256(message); });
+}
+
+TEST(Keccak, Sha3_256Bmr) {
+  EvaluateOnInput<MpcProtocol::kBmr>(
+      BytesToWires(kSha3Messages), BytesToWires(kSha3Digests),
+      [](const ShareWrapper& message) { return encrypto::motion::algorithm::Sha3_256(message); });
+}
+
+// the messages of 200 bytes take two blocks, and the output of 512 bits is squeezed from one
+TEST(Keccak, Shake128BooleanGmw) {
+  const std::vector<std::vector<std::uint8_t>> outputs{
+      HexToBytes("0c4234ca1e31801ae606f8b8d8e0665c66f42a21d601c2681858a92c79ad5d69"
+                 "e143c3b1393dd894e7abd5621b0d877f3573a34245e6b911f671081664a5fa53"),
+      HexToBytes("ae6c177b32a18826e6fcc42331bb88b9c3ad35ec712494b3346549b09e9d04f5"
+                 "36e284a5f9c84badd347ccd119078e7db4c0aaf8f669d2047e5d67a436775b3b")};
+  EvaluateOnInput<MpcProtocol::kBooleanGmw>(
+      BytesToWires({Range(0, 200), Range(1, 200)}), BytesToWires(outputs),
+      [](const ShareWrapper& message) {
+        return encrypto::motion::algorithm::Shake128(message, 512);
+      });
+}
+
+// the permutation of a padded block gives the digest as the first 256 bits of the state
+TEST(Keccak, KeccakF1600Bmr) {
+  std::vector<std::vector<std::uint8_t>> states;
+  for (const auto& message : kSha3Messages) {
+    auto& state{states.emplace_back(encrypto::motion::algorithm::kKeccakStateBitSize / 8)};
+    std::copy(message.begin(), message.end(), state.begin());
+    state[message.size()] = 0x06;
+    state[encrypto::motion::algorithm::kSha3_256RateBitSize / 8 - 1] = 0x80;
+  }
+  EvaluateOnInput<MpcProtocol::kBmr>(
+      BytesToWires(states), BytesToWires(kSha3Digests), [](const ShareWrapper& state) {
+        auto wires{encrypto::motion::algorithm::KeccakF1600(state).Split()};
+        wires.resize(encrypto::motion::algorithm::kSha3_256DigestBitSize);
+        return ShareWrapper::Concatenate(wires);
+      });
+}
+
+}  // namespace
@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utility/lock_free_queue.h"
+
+using namespace encrypto::motion;
+
+TEST(LockFreeQueue, EnqueueDequeue) {
+  LockFreeQueue<int> queue;
+  EXPECT_TRUE(queue.empty());
+  queue.enqueue(1);
+  queue.enqueue(2);
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_EQ(queue.dequeue(), 1);
+  EXPECT_EQ(queue.dequeue(), 2);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.TryBatchDequeue().empty());
+}
+
+TEST(LockFreeQueue, Close) {
+  LockFreeQueue<int> queue;
+  queue.enqueue(1);
+  queue.close();
+  EXPECT_TRUE(queue.IsClosed());
+  EXPECT_FALSE(queue.IsClosedAndEmpty());
+  EXPECT_THROW(queue.enqueue(2), std::logic_error);
+  // remaining elements can still be dequeued
+  EXPECT_EQ(queue.dequeue(), 1);
+  EXPECT_TRUE(queue.IsClosedAndEmpty());
+  EXPECT_EQ(queue.dequeue(), std::nullopt);
+  EXPECT_EQ(queue.BatchDequeue(), std::nullopt);
+}
+
+TEST(LockFreeQueue, CloseWakesConsumer) {
+  LockFreeFiberQueue<int> queue;
+  std::thread consumer([&queue] { EXPECT_EQ(queue.BatchDequeue(), std::nullopt); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  consumer.join();
+}
+
+TEST(LockFreeQueue, TryBatchDequeueUntil) {
+  LockFreeFiberQueue<int> queue;
+  // times out on an empty queue
+  EXPECT_TRUE(
+      queue.TryBatchDequeueUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(1))
+          .empty());
+  std::thread producer([&queue] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.enqueue(1);
+  });
+  auto elements =
+      queue.TryBatchDequeueUntil(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+  producer.join();
+  ASSERT_EQ(elements.size(), 1);
+  EXPECT_EQ(elements.front(), 1);
+  // returns at once for a closed queue
+  queue.close();
+  EXPECT_TRUE(
+      queue.TryBatchDequeueUntil(std::chrono::steady_clock::now() + std::chrono::hours(1)).empty());
+}
+
+TEST(LockFreeQueue, MultipleProducers) {
+  constexpr std::size_t kNumberOfProducers = 4;
+  constexpr std::size_t kNumberOfElements = 10000;
+  LockFreeFiberQueue<std::pair<std::size_t, std::size_t>> queue;
+  std::vector<std::thread> producers;
+  for (std::size_t producer_id = 0; producer_id < kNumberOfProducers; ++producer_id) {
+    producers.emplace_back([&queue, producer_id] {
+      for (std::size_t i = 0; i < kNumberOfElements; ++i) {
+        queue.enqueue({producer_id, i});
+      }
+    });
+  }
+  std::thread closer([&producers, &queue] {
+    for (auto& producer : producers) producer.join();
+    queue.close();
+  });
+
+  // the elements of each producer arrive in the order it enqueued them
+  std::vector<std::size_t> next(kNumberOfProducers, 0);
+  std::size_t number_of_elements = 0;
+  while (auto elements = queue.BatchDequeue()) {
+    for (; !elements->empty(); elements->pop()) {
+      auto [producer_id, i] = elements->front();
+      ASSERT_EQ(i, next.at(producer_id)++);
+      ++number_of_elements;
+    }
+  }
+  closer.join();
+  EXPECT_EQ(number_of_elements, kNumberOfProducers * kNumberOfElements);
+  EXPECT_TRUE(queue.IsClosedAndEmpty());
+}
@@ -22,16 +22,30 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <sched.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <future>
+#include <memory>
+#include <random>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include <boost/fiber/operations.hpp>
 #include <gtest/gtest.h>
 
 #include "test_constants.h"
+#include "primitives/blake2b.h"
+#include "utility/arena.h"
 #include "utility/bit_vector.h"
+#include "utility/block.h"
 #include "utility/condition.h"
+#include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/helpers.h"
+#include "utility/pool_allocator.h"
+#include "utility/thread.h"
 
 namespace {
 TEST(Condition, WaitNotifyOne) {
@@ -292,4 +306,230 @@ TYPED_TEST(TwosComplementTest, Conversion) {
   }
 }
 
+template <typename T>
+void TestVectorKernels() {
+  constexpr std::size_t kSize{1'000};
+  const auto a{encrypto::motion::RandomVector<T>(kSize)};
+  const auto b{encrypto::motion::RandomVector<T>(kSize)};
+  const auto c{encrypto::motion::RandomVector<T>(kSize)};
+  std::vector<T> output(kSize);
+  encrypto::motion::MultiplyAddVectors<T>(a, b, c, output);
+  for (std::size_t i = 0; i < kSize; ++i) ASSERT_EQ(output[i], T(c[i] + a[i] * b[i]));
+  encrypto::motion::MultiplyAddVectors<T>(a, b, b, c, a, output);
+  for (std::size_t i = 0; i < kSize; ++i) ASSERT_EQ(output[i], T(a[i] + a[i] * b[i] + b[i] * c[i]));
+
+  // in place
+  output = a;
+  encrypto::motion::AddVectors<T>(output, b, output);
+  encrypto::motion::SubVectors<T>(output, c, output);
+  encrypto::motion::MultiplyVectors<T>(c, output, output);
+  for (std::size_t i = 0; i < kSize; ++i) ASSERT_EQ(output[i], T(c[i] * T(a[i] + b[i] - c[i])));
+}
+
+TEST(Helpers, VectorKernels) {
+  TestVectorKernels<std::uint8_t>();
+  TestVectorKernels<std::uint16_t>();
+  TestVectorKernels<std::uint32_t>();
+  TestVectorKernels<std::uint64_t>();
+  TestVectorKernels<__uint128_t>();
+}
+
+TEST(Arena, Allocate) {
+  encrypto::motion::Arena arena(1024);
+  std::vector<std::uintptr_t> addresses;
+  for (std::size_t alignment : {1u, 8u, 16u, 64u, 8u, 1u}) {
+    auto pointer{reinterpret_cast<std::uintptr_t>(arena.Allocate(24, alignment))};
+    EXPECT_EQ(pointer % alignment, 0u);
+    addresses.push_back(pointer);
+  }
+  // a large allocation gets a chunk of its own
+  auto large{reinterpret_cast<std::uintptr_t>(arena.Allocate(4096, 64))};
+  EXPECT_EQ(large % 64, 0u);
+  EXPECT_EQ(arena.GetNumberOfAllocatedBytes(), 6 * 24 + 4096u);
+  EXPECT_EQ(arena.GetNumberOfReservedBytes(), 1024 + 4096 + 64u);
+  // the small allocations do not overlap
+  std::sort(addresses.begin(), addresses.end());
+  for (std::size_t i = 1; i < addresses.size(); ++i) {
+    EXPECT_GE(addresses[i] - addresses[i - 1], 24u);
+  }
+}
+
+TEST(Arena, ReserveMakesAllocationsAdjacent) {
+  encrypto::motion::Arena arena(1024);
+  auto first{reinterpret_cast<std::uintptr_t>(arena.Allocate(200, 8))};
+  // the rest of the chunk is too small, so the next allocations are in a new chunk of 2000 bytes
+  arena.Reserve(2000);
+  EXPECT_EQ(arena.GetNumberOfReservedBytes(), 1024 + 2000u);
+  std::vector<std::uintptr_t> addresses;
+  for (std::size_t i = 0; i < 10; ++i) {
+    addresses.push_back(reinterpret_cast<std::uintptr_t>(arena.Allocate(200, 8)));
+  }
+  for (std::size_t i = 1; i < addresses.size(); ++i) {
+    EXPECT_EQ(addresses[i], addresses[i - 1] + 200);
+  }
+  EXPECT_TRUE(addresses.front() < first || addresses.front() >= first + 1024);
+  // enough is left, so nothing is reserved
+  arena.Reserve(0);
+  EXPECT_EQ(arena.GetNumberOfReservedBytes(), 1024 + 2000u);
+}
+
+TEST(Arena, ReleaseAfterObjectsAreDestroyed) {
+  encrypto::motion::Arena arena;
+  auto object{std::allocate_shared<std::vector<int>>(
+      encrypto::motion::ArenaAllocator<std::vector<int>>(arena), 3, 42)};
+  EXPECT_TRUE(arena.HasLiveObjects());
+  EXPECT_THROW(arena.Release(), std::logic_error);
+  EXPECT_EQ(*object, (std::vector<int>{42, 42, 42}));
+  object.reset();
+  EXPECT_FALSE(arena.HasLiveObjects());
+  arena.Release();
+  EXPECT_EQ(arena.GetNumberOfAllocatedBytes(), 0u);
+  EXPECT_EQ(arena.GetNumberOfReservedBytes(), 0u);
+}
+
+TEST(PooledAlignedAllocator, ReusesReleasedBlocks) {
+  using encrypto::motion::AlignedMemoryPool;
+  AlignedMemoryPool::Release();
+  std::uintptr_t address;
+  {
+    encrypto::motion::AlignedBitVector bit_vector(1000);
+    address = reinterpret_cast<std::uintptr_t>(bit_vector.GetData().data());
+    EXPECT_EQ(address % encrypto::motion::kAlignment, 0u);
+  }
+  // 125 bytes are rounded up to the size class of 128 bytes
+  EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 128u);
+  {
+    encrypto::motion::AlignedBitVector bit_vector(1016);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(bit_vector.GetData().data()), address);
+    EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 0u);
+  }
+  // blocks larger than the largest size class are not pooled
+  { encrypto::motion::Block128Vector blocks(AlignedMemoryPool::kMaximumBlockSize / 16 + 1); }
+  EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 128u);
+  AlignedMemoryPool::Release();
+  EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 0u);
+}
+
+TEST(PooledAlignedAllocator, ReleaseOnOtherThread) {
+  using encrypto::motion::AlignedMemoryPool;
+  AlignedMemoryPool::Release();
+  auto bit_vector{std::make_unique<encrypto::motion::AlignedBitVector>(4096)};
+  // the block is returned to the pool of the thread destroying the vector
+  std::thread([&bit_vector] {
+    bit_vector.reset();
+    EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 512u);
+  }).join();
+  EXPECT_EQ(AlignedMemoryPool::GetNumberOfCachedBytes(), 0u);
+  auto blocks{encrypto::motion::Block128Vector::MakeZero(4)};
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks.data()) % encrypto::motion::kAlignment, 0u);
+}
+
+TEST(Block128Vector, BulkOperationsEqualBlockwiseOperations) {
+  std::mt19937_64 random_generator(0);
+  // sizes around the number of blocks per vector register for the remainder loops
+  for (std::size_t size : {0, 1, 2, 3, 4, 5, 7, 8, 9, 17}) {
+    const auto a{encrypto::motion::Block128Vector::MakeRandom(size)};
+    const auto b{encrypto::motion::Block128Vector::MakeRandom(size)};
+    const auto offset{encrypto::motion::Block128::MakeRandom()};
+    encrypto::motion::BitVector<> bits(size);
+    for (std::size_t i = 0; i < size; ++i) bits.Set(random_generator() % 2 == 1, i);
+
+    const auto a_xor_b{a ^ b};
+    const auto a_and_b{a & b};
+    const auto a_xor_offset{a ^ offset};
+    auto in_place{a};
+    in_place ^= b;
+    auto conditional{a};
+    conditional.ConditionalXor(bits.GetData().data(), offset);
+    for (std::size_t i = 0; i < size; ++i) {
+      encrypto::motion::Block128 expected_and;
+      for (std::size_t j = 0; j < encrypto::motion::Block128::kBlockSize; ++j) {
+        expected_and.byte_array[j] = a[i].byte_array[j] & b[i].byte_array[j];
+      }
+      EXPECT_TRUE(a_xor_b[i] == (a[i] ^ b[i]));
+      EXPECT_TRUE(a_and_b[i] == expected_and);
+      EXPECT_TRUE(a_xor_offset[i] == (a[i] ^ offset));
+      EXPECT_TRUE(in_place[i] == (a[i] ^ b[i]));
+      EXPECT_TRUE(conditional[i] == (bits.Get(i) ? a[i] ^ offset : a[i]));
+    }
+  }
+}
+
+TEST(FiberThreadPool, PinnedWorkers) {
+  std::vector<std::size_t> cpus;
+  for (std::size_t cpu = 0; cpus.size() < 2 && cpu < CPU_SETSIZE; ++cpu) {
+    if (encrypto::motion::IsCpuAvailable(cpu)) {
+      cpus.push_back(cpu);
+    }
+  }
+  ASSERT_FALSE(cpus.empty());
+  constexpr std::size_t kNumberOfTasks{200};
+  std::atomic<std::size_t> number_of_tasks{0}, number_of_misplaced_tasks{0};
+  {
+    encrypto::motion::FiberThreadPool pool(2, kNumberOfTasks, true, cpus, true);
+    for (std::size_t i = 0; i < kNumberOfTasks; ++i) {
+      pool.post([&] {
+        auto cpu{static_cast<std::size_t>(sched_getcpu())};
+        if (std::find(cpus.begin(), cpus.end(), cpu) == cpus.end()) {
+          ++number_of_misplaced_tasks;
+        }
+        ++number_of_tasks;
+      });
+    }
+    pool.join();
+  }
+  EXPECT_EQ(number_of_tasks, kNumberOfTasks);
+  EXPECT_EQ(number_of_misplaced_tasks, 0u);
+}
+
+TEST(FiberThreadPool, ReuseAfterWaitIdle) {
+  constexpr std::size_t kNumberOfTasks{100};
+  std::atomic<std::size_t> number_of_tasks{0};
+  encrypto::motion::FiberThreadPool pool(2, 0, true, {}, false, 64 * 1024);
+  for (std::size_t run = 1; run <= 3; ++run) {
+    for (std::size_t i = 0; i < kNumberOfTasks; ++i) {
+      pool.post([&] {
+        boost::this_fiber::yield();
+        ++number_of_tasks;
+      });
+    }
+    pool.wait_idle();
+    EXPECT_EQ(number_of_tasks, run * kNumberOfTasks);
+  }
+  pool.join();
+}
+
+TEST(FiberThreadPool, UnavailableCpuThrows) {
+  EXPECT_THROW(encrypto::motion::FiberThreadPool(2, 0, true, {CPU_SETSIZE}),
+               std::invalid_argument);
+}
+
+TEST(Blake2b, BatchEqualsSingleHashes) {
+  std::mt19937_64 random_generator(0);
+  // message lengths around the block size of 128 B and numbers of messages around the lanes
+  for (std::size_t length : {0, 48, 127, 128, 129, 300}) {
+    for (std::size_t number_of_messages : {1, 2, 5, 8, 11}) {
+      std::vector<std::vector<std::uint8_t>> messages(number_of_messages,
+                                                      std::vector<std::uint8_t>(length));
+      std::vector<std::vector<std::uint8_t>> digests(
+          number_of_messages, std::vector<std::uint8_t>(EVP_MAX_MD_SIZE));
+      std::vector<const std::uint8_t*> message_pointers;
+      std::vector<std::uint8_t*> digest_pointers;
+      for (std::size_t i = 0; i < number_of_messages; ++i) {
+        std::generate(messages[i].begin(), messages[i].end(), [&random_generator]() {
+          return static_cast<std::uint8_t>(random_generator());
+        });
+        message_pointers.push_back(messages[i].data());
+        digest_pointers.push_back(digests[i].data());
+      }
+      encrypto::motion::Blake2bBatch(message_pointers, length, digest_pointers);
+      for (std::size_t i = 0; i < number_of_messages; ++i) {
+        std::uint8_t expected_digest[EVP_MAX_MD_SIZE];
+        encrypto::motion::Blake2b(messages[i].data(), expected_digest, length);
+        EXPECT_EQ(std::memcmp(digests[i].data(), expected_digest, EVP_MAX_MD_SIZE), 0);
+      }
+    }
+  }
+}
+
 }  // namespace
\ No newline at end of file
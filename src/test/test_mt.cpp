@@ -24,10 +24,13 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdio>
+
 #include "test_constants.h"
 
 #include "base/party.h"
 #include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/preprocessing_store.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 
 namespace {
@@ -94,6 +97,89 @@ TEST(MultiplicationTriples, Binary) {
   }
 }
 
+TEST(MultiplicationTriples, StoreAndLoad) {
+  constexpr std::size_t kNumberOfMts = 100;
+  for (auto number_of_parties : {2u, 3u}) {
+    auto path = [](std::size_t party_id) {
+      return fmt::format("{}/motion_test_mts_{}.bin", testing::TempDir(), party_id);
+    };
+    std::vector<encrypto::motion::BinaryMtVector> bit_mts(number_of_parties);
+    std::vector<encrypto::motion::IntegerMtVector<std::uint32_t>> mts_32(number_of_parties);
+
+    // generate the MTs and store them, then load them in fresh parties
+    for (bool load : {false, true}) {
+      auto motion_parties =
+          encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        auto& party = motion_parties.at(j);
+        party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        if (load) {
+          party->GetConfiguration()->SetPreprocessingInputPath(path(j));
+        } else {
+          party->GetConfiguration()->SetPreprocessingOutputPath(path(j));
+        }
+        party->GetBackend()->GetMtProvider().RequestBinaryMts(kNumberOfMts);
+        party->GetBackend()->GetMtProvider().RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+      }
+
+      std::vector<std::future<void>> futures;
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+          motion_parties.at(j)->GetBackend()->RunPreprocessing();
+          motion_parties.at(j)->Finish();
+        }));
+      }
+      std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        const auto& mt_provider = motion_parties.at(j)->GetBackend()->GetMtProvider();
+        if (load) {
+          EXPECT_EQ(mt_provider.GetBinaryAll().a, bit_mts.at(j).a);
+          EXPECT_EQ(mt_provider.GetBinaryAll().b, bit_mts.at(j).b);
+          EXPECT_EQ(mt_provider.GetBinaryAll().c, bit_mts.at(j).c);
+          EXPECT_EQ(mt_provider.GetIntegerAll<std::uint32_t>().a, mts_32.at(j).a);
+          EXPECT_EQ(mt_provider.GetIntegerAll<std::uint32_t>().b, mts_32.at(j).b);
+          EXPECT_EQ(mt_provider.GetIntegerAll<std::uint32_t>().c, mts_32.at(j).c);
+        } else {
+          bit_mts.at(j) = mt_provider.GetBinaryAll();
+          mts_32.at(j) = mt_provider.GetIntegerAll<std::uint32_t>();
+        }
+      }
+    }
+
+    for (std::size_t j = 0; j < number_of_parties; ++j) std::remove(path(j).c_str());
+  }
+}
+
+TEST(MultiplicationTriples, LoadingConsumesTheStoredMaterial) {
+  const auto path{fmt::format("{}/motion_test_consumed_mts.bin", testing::TempDir())};
+  const std::vector<std::uint32_t> values{1, 2, 3, 4, 5};
+  encrypto::motion::BitVector<> bits(20);
+  bits.Set(true, 9);
+  {
+    encrypto::motion::PreprocessingWriter writer(path, 0, 2);
+    writer.Write(values);
+    writer.Write(bits);
+    writer.Close();
+  }
+  {
+    encrypto::motion::PreprocessingReader reader(path, 0, 2);
+    EXPECT_EQ(reader.Read<std::uint32_t>(2), (std::vector<std::uint32_t>{1, 2}));
+    EXPECT_EQ(reader.ReadBits(3), encrypto::motion::BitVector<>(3));
+  }
+  {
+    // a later run gets the remaining elements and the bits from the next byte on
+    encrypto::motion::PreprocessingReader reader(path, 0, 2);
+    EXPECT_EQ(reader.Read<std::uint32_t>(3), (std::vector<std::uint32_t>{3, 4, 5}));
+    EXPECT_TRUE(reader.ReadBits(2).Get(1));
+  }
+  {
+    encrypto::motion::PreprocessingReader reader(path, 0, 2);
+    EXPECT_THROW(reader.Read<std::uint32_t>(1), std::runtime_error);
+  }
+  std::remove(path.c_str());
+}
+
 template <typename T, typename = std::enable_if_t<std::is_unsigned_v<T>>>
 void TemplateTestInteger() {
   constexpr std::size_t kNumberOfMts = 100;
@@ -145,6 +231,18 @@ void TemplateTestInteger() {
           EXPECT_EQ(c.at(k), static_cast<T>(a.at(k) * b.at(k)));
         }
 
+        // the views and copies of a range refer to the same MTs
+        constexpr std::size_t kOffset{7}, kLength{50};
+        const auto& all_mts{mt_provider_0.template GetIntegerAll<T>()};
+        const auto span_mts{mt_provider_0.template GetIntegerSpan<T>(kOffset, kLength)};
+        const auto copied_mts{mt_provider_0.template GetInteger<T>(kOffset, kLength)};
+        EXPECT_EQ(span_mts.a.data(), all_mts.a.data() + kOffset);
+        EXPECT_EQ(span_mts.c.size(), kLength);
+        EXPECT_TRUE(std::equal(span_mts.b.begin(), span_mts.b.end(), copied_mts.b.begin(),
+                               copied_mts.b.end()));
+        EXPECT_TRUE(std::equal(span_mts.c.begin(), span_mts.c.end(), copied_mts.c.begin(),
+                               copied_mts.c.end()));
+
         futures.clear();
 
         for (auto& party : motion_parties) {
@@ -166,4 +264,136 @@ TEST(MultiplicationTriples, Integer) {
   TemplateTestInteger<std::uint64_t>();
 }
 
+TEST(MultiplicationTriples, WaitReady) {
+  // several batches, s.t. the first MTs become ready before the others
+  constexpr std::size_t kNumberOfMts = 3 * 128 * 128 + 5;
+  // several parties, whose pipelines add their cross terms to the batches in parallel
+  for (std::size_t number_of_parties : {2u, 4u}) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      party->GetBackend()->GetMtProvider().RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+    }
+
+    std::vector<std::future<void>> futures;
+    std::vector<std::future<std::vector<std::uint32_t>>> first_mts;
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      auto& mt_provider = motion_parties.at(j)->GetBackend()->GetMtProvider();
+      // waits for the first MTs only
+      first_mts.emplace_back(std::async(std::launch::async, [&mt_provider] {
+        auto mts{mt_provider.GetIntegerSpan<std::uint32_t>(0, 10)};
+        std::vector<std::uint32_t> result(mts.c.begin(), mts.c.end());
+        result.insert(result.end(), mts.a.begin(), mts.a.end());
+        result.insert(result.end(), mts.b.begin(), mts.b.end());
+        return result;
+      }));
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+        auto& backend = motion_parties.at(j)->GetBackend();
+        backend->GetBaseProvider().Setup();
+        auto& mt_provider = backend->GetMtProvider();
+        mt_provider.PreSetup();
+        backend->GetOtProviderManager().PreSetup();
+        backend->GetBaseOtProvider().PreSetup();
+        backend->Synchronize();
+        backend->GetBaseOtProvider().ComputeBaseOts();
+        backend->OtExtensionSetup();
+        mt_provider.Setup();
+      }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+    // the MTs seen by the early waiters are the final ones
+    std::vector<std::uint32_t> c(10), a(10), b(10);
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      const auto early_mts{first_mts.at(j).get()};
+      const auto& mt_provider{motion_parties.at(j)->GetBackend()->GetMtProvider()};
+      const auto& mts{mt_provider.GetIntegerAll<std::uint32_t>()};
+      for (std::size_t k = 0; k < 10; ++k) {
+        EXPECT_EQ(early_mts.at(k), mts.c.at(k));
+        c.at(k) += early_mts.at(k);
+        a.at(k) += early_mts.at(10 + k);
+        b.at(k) += early_mts.at(20 + k);
+      }
+    }
+    for (std::size_t k = 0; k < 10; ++k) EXPECT_EQ(c.at(k), a.at(k) * b.at(k));
+
+    futures.clear();
+    for (auto& party : motion_parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+  }
+}
+
+template <typename T>
+void CheckIntegerMts(const std::vector<std::unique_ptr<encrypto::motion::Party>>& motion_parties,
+                     std::size_t number_of_mts) {
+  auto mts{motion_parties.at(0)->GetBackend()->GetMtProvider().template GetIntegerAll<T>()};
+  ASSERT_EQ(mts.c.size(), number_of_mts);
+  for (std::size_t j = 1; j < motion_parties.size(); ++j) {
+    auto& mt_provider_j{motion_parties.at(j)->GetBackend()->GetMtProvider()};
+    const auto& mts_j{mt_provider_j.template GetIntegerAll<T>()};
+    for (std::size_t k = 0; k < number_of_mts; ++k) {
+      mts.a.at(k) += mts_j.a.at(k);
+      mts.b.at(k) += mts_j.b.at(k);
+      mts.c.at(k) += mts_j.c.at(k);
+    }
+  }
+  for (std::size_t k = 0; k < number_of_mts; ++k) {
+    EXPECT_EQ(mts.c.at(k), static_cast<T>(mts.a.at(k) * mts.b.at(k)));
+  }
+}
+
+TEST(MultiplicationTriples, Paillier) {
+  // more 64-bit MTs than fit into one batch of ciphertexts
+  constexpr std::size_t kNumberOfMts = 100, kNumberOfMts64 = 1100;
+  for (auto number_of_parties : {2u, 3u}) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      auto& mt_provider{party->GetBackend()->GetMtProvider()};
+      // a short modulus keeps the test fast
+      dynamic_cast<encrypto::motion::MtProviderFromOts&>(mt_provider).SetPaillierMts(true, 1024);
+      mt_provider.RequestBinaryMts(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint8_t>(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint16_t>(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint32_t>(kNumberOfMts);
+      mt_provider.RequestArithmeticMts<std::uint64_t>(kNumberOfMts64);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+        auto& backend = motion_parties.at(j)->GetBackend();
+        backend->GetBaseProvider().Setup();
+        auto& mt_provider = backend->GetMtProvider();
+        mt_provider.PreSetup();
+        backend->GetOtProviderManager().PreSetup();
+        backend->GetBaseOtProvider().PreSetup();
+        backend->Synchronize();
+        backend->GetBaseOtProvider().ComputeBaseOts();
+        backend->OtExtensionSetup();
+        mt_provider.Setup();
+        motion_parties.at(j)->Finish();
+      }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+    auto bit_mts{motion_parties.at(0)->GetBackend()->GetMtProvider().GetBinaryAll()};
+    for (std::size_t j = 1; j < number_of_parties; ++j) {
+      const auto& bit_mts_j{motion_parties.at(j)->GetBackend()->GetMtProvider().GetBinaryAll()};
+      bit_mts.a ^= bit_mts_j.a;
+      bit_mts.b ^= bit_mts_j.b;
+      bit_mts.c ^= bit_mts_j.c;
+    }
+    EXPECT_EQ(bit_mts.c, bit_mts.a & bit_mts.b);
+    CheckIntegerMts<std::uint8_t>(motion_parties, kNumberOfMts);
+    CheckIntegerMts<std::uint16_t>(motion_parties, kNumberOfMts);
+    CheckIntegerMts<std::uint32_t>(motion_parties, kNumberOfMts);
+    CheckIntegerMts<std::uint64_t>(motion_parties, kNumberOfMts64);
+  }
+}
+
 }  // namespace
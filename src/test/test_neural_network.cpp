@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/neural_network.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+using mo::algorithm::TensorShape;
+
+constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+
+std::vector<std::uint32_t> RandomSignedValues(std::size_t size, std::mt19937& random) {
+  std::vector<std::uint32_t> values(size);
+  std::generate(values.begin(), values.end(),
+                [&]() { return static_cast<std::uint32_t>(std::int32_t(random() % 17) - 8); });
+  return values;
+}
+
+std::int32_t Signed(std::uint32_t value) { return static_cast<std::int32_t>(value); }
+
+TEST(NeuralNetwork, ArithmeticGmwLayers) {
+  std::mt19937 random(0);
+  constexpr TensorShape kShape{4, 4, 2};
+  constexpr std::size_t kKernelSize{3}, kNumberOfKernels{3}, kNumberOfOutputs{4};
+  constexpr std::size_t kConvolutionSize{2 * 2 * kNumberOfKernels};
+  constexpr std::size_t kFractionalBits{2};
+  const auto input{RandomSignedValues(kShape.GetSize(), random)};
+  const auto kernels{
+      RandomSignedValues(kKernelSize * kKernelSize * kShape.channels * kNumberOfKernels, random)};
+  const auto kernel_bias{RandomSignedValues(kNumberOfKernels, random)};
+  const auto weights{RandomSignedValues(kConvolutionSize * kNumberOfOutputs, random)};
+  const auto bias{RandomSignedValues(kNumberOfOutputs, random)};
+
+  // the plaintext layers
+  std::vector<std::uint32_t> convolution(kConvolutionSize);
+  for (std::size_t y = 0; y < 2; ++y) {
+    for (std::size_t x = 0; x < 2; ++x) {
+      for (std::size_t k = 0; k < kNumberOfKernels; ++k) {
+        std::uint32_t sum{kernel_bias[k]};
+        for (std::size_t dy = 0; dy < kKernelSize; ++dy) {
+          for (std::size_t dx = 0; dx < kKernelSize; ++dx) {
+            for (std::size_t c = 0; c < kShape.channels; ++c) {
+              const std::size_t row{(dy * kKernelSize + dx) * kShape.channels + c};
+              sum += input[((y + dy) * kShape.width + x + dx) * kShape.channels + c] *
+                     kernels[row * kNumberOfKernels + k];
+            }
+          }
+        }
+        convolution[(y * 2 + x) * kNumberOfKernels + k] = sum;
+      }
+    }
+  }
+  std::vector<std::uint32_t> relu(kConvolutionSize);
+  for (std::size_t i = 0; i < kConvolutionSize; ++i) {
+    relu[i] = Signed(convolution[i]) < 0 ? 0 : convolution[i];
+  }
+  std::vector<std::uint32_t> dense(kNumberOfOutputs);
+  for (std::size_t j = 0; j < kNumberOfOutputs; ++j) {
+    dense[j] = bias[j];
+    for (std::size_t i = 0; i < kConvolutionSize; ++i) {
+      dense[j] += relu[i] * weights[i * kNumberOfOutputs + j];
+    }
+  }
+  // the maxima and sums of the 2x2 windows of each channel of input
+  std::vector<std::int32_t> maximum(2 * 2 * kShape.channels), sum(2 * 2 * kShape.channels);
+  for (std::size_t y = 0; y < 2; ++y) {
+    for (std::size_t x = 0; x < 2; ++x) {
+      for (std::size_t c = 0; c < kShape.channels; ++c) {
+        const std::size_t output{(y * 2 + x) * kShape.channels + c};
+        maximum[output] = std::numeric_limits<std::int32_t>::min();
+        for (std::size_t dy = 0; dy < 2; ++dy) {
+          for (std::size_t dx = 0; dx < 2; ++dx) {
+            const auto value{
+                Signed(input[((2 * y + dy) * kShape.width + 2 * x + dx) * kShape.channels + c])};
+            maximum[output] = std::max(maximum[output], value);
+            sum[output] += value;
+          }
+        }
+      }
+    }
+  }
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      // the input is owned by party 0 and the model by party 1
+      const auto in = [&](const std::vector<std::uint32_t>& values, std::size_t owner) {
+        return mo::ShareWrapper(party->In<kArithmeticGmw>(
+            party_id == owner ? values : std::vector<std::uint32_t>(values.size(), 0), owner));
+      };
+      const auto input_share{in(input, 0)};
+      const auto convolution_share{mo::algorithm::Convolution(
+          input_share, kShape, in(kernels, 1), kKernelSize, in(kernel_bias, 1), 0)};
+      const auto relu_share{mo::algorithm::Relu(convolution_share)};
+      const auto dense_share{mo::algorithm::Dense(relu_share, in(weights, 1), in(bias, 1), 0)};
+      const auto maximum_share{mo::algorithm::MaxPooling(input_share, kShape, 2)};
+      // the input as fixed-point values with kFractionalBits fractional bits
+      const auto average_share{
+          mo::algorithm::AveragePooling(input_share, kShape, 2, kFractionalBits)};
+      EXPECT_THROW(mo::algorithm::Dense(input_share, input_share, input_share, 0),
+                   std::invalid_argument);
+      auto convolution_output{convolution_share.Out()};
+      auto relu_output{relu_share.Out()};
+      auto dense_output{dense_share.Out()};
+      auto maximum_output{maximum_share.Out()};
+      auto average_output{average_share.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(convolution_output.As<std::vector<std::uint32_t>>(), convolution);
+      EXPECT_EQ(relu_output.As<std::vector<std::uint32_t>>(), relu);
+      EXPECT_EQ(dense_output.As<std::vector<std::uint32_t>>(), dense);
+      const auto maximum_values{maximum_output.As<std::vector<std::uint32_t>>()};
+      const auto average_values{average_output.As<std::vector<std::uint32_t>>()};
+      for (std::size_t i = 0; i < maximum.size(); ++i) {
+        EXPECT_EQ(Signed(maximum_values.at(i)), maximum[i]);
+        // the probabilistic truncation may exceed the exact result by 1
+        const std::int32_t average{sum[i] >> kFractionalBits};
+        EXPECT_GE(Signed(average_values.at(i)), average);
+        EXPECT_LE(Signed(average_values.at(i)), average + 1);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <future>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/oblivious_lookup.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+// 13 entries addressed by 4 index bits, s.t. the queries 13, 14 and 15 read 0
+constexpr std::size_t kNumberOfEntries{13};
+constexpr std::size_t kIndexBitLength{4};
+
+std::vector<std::uint32_t> RandomTable(std::size_t number_of_entries = kNumberOfEntries) {
+  std::mt19937 mersenne_twister(number_of_entries);
+  std::vector<std::uint32_t> table(number_of_entries);
+  for (auto& entry : table) entry = mersenne_twister();
+  return table;
+}
+
+// every index of 4 bits once, in reverse order
+std::vector<mo::BitVector<>> MakeIndices() {
+  std::vector<std::uint8_t> indices(std::size_t(1) << kIndexBitLength);
+  for (std::size_t i = 0; i < indices.size(); ++i) indices[i] = indices.size() - 1 - i;
+  auto bits{mo::ToInput(indices)};
+  bits.resize(kIndexBitLength);
+  return bits;
+}
+
+std::vector<std::uint32_t> ExpectedResult(const std::vector<std::uint32_t>& table) {
+  std::vector<std::uint32_t> expected;
+  for (std::size_t index = std::size_t(1) << kIndexBitLength; index-- > 0;) {
+    expected.push_back(index < table.size() ? table[index] : 0);
+  }
+  return expected;
+}
+
+TEST(ObliviousLookup, BooleanGmwArithmeticGmwAndPublicTables) {
+  const auto table{RandomTable()};
+  const auto expected{ExpectedResult(table)};
+  std::vector<mo::BitVector<>> public_table;
+  for (const auto entry : table) {
+    mo::BitVector<> bits;
+    for (std::size_t i = 0; i < 32; ++i) bits.Append(((entry >> i) & 1) == 1);
+    public_table.push_back(std::move(bits));
+  }
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper index{party->In<mo::MpcProtocol::kBooleanGmw>(MakeIndices(), 1)};
+      mo::ShareWrapper boolean_table{
+          party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(table), 0)};
+      mo::ShareWrapper arithmetic_table{party->In<mo::MpcProtocol::kArithmeticGmw>(table, 0)};
+
+      const auto one_hot{mo::algorithm::OneHotIndex(index, kNumberOfEntries)};
+      EXPECT_EQ(one_hot->GetNumberOfSimdValues(), kNumberOfEntries << kIndexBitLength);
+      auto boolean_output{mo::algorithm::ObliviousLookup(boolean_table, index).Out()};
+      auto arithmetic_output{mo::algorithm::ObliviousLookup(arithmetic_table, index).Out()};
+      auto public_output{mo::algorithm::ObliviousLookup(public_table, index).Out()};
+
+      party->Run();
+
+      EXPECT_EQ(mo::ToVectorOutput<std::uint32_t>(
+                    boolean_output.As<std::vector<mo::BitVector<>>>()),
+                expected);
+      EXPECT_EQ(arithmetic_output.As<std::vector<std::uint32_t>>(), expected);
+      EXPECT_EQ(mo::ToVectorOutput<std::uint32_t>(
+                    public_output.As<std::vector<mo::BitVector<>>>()),
+                expected);
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+// tables whose rows and columns of the square-root decomposition have other shapes
+TEST(ObliviousLookup, TablesOfOtherSizes) {
+  constexpr std::array<std::size_t, 4> kTableSizes{1, 2, 5, 16};
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper index{party->In<mo::MpcProtocol::kBooleanGmw>(MakeIndices(), 1)};
+      std::vector<mo::ShareWrapper> arithmetic_outputs, public_outputs;
+      for (const auto size : kTableSizes) {
+        const auto table{RandomTable(size)};
+        std::vector<mo::BitVector<>> public_table;
+        for (const auto entry : table) {
+          mo::BitVector<> bits;
+          for (std::size_t i = 0; i < 32; ++i) bits.Append(((entry >> i) & 1) == 1);
+          public_table.push_back(std::move(bits));
+        }
+        mo::ShareWrapper arithmetic_table{party->In<mo::MpcProtocol::kArithmeticGmw>(table, 0)};
+        arithmetic_outputs.push_back(
+            mo::algorithm::ObliviousLookup(arithmetic_table, index).Out());
+        public_outputs.push_back(mo::algorithm::ObliviousLookup(public_table, index).Out());
+      }
+
+      party->Run();
+
+      for (std::size_t i = 0; i < kTableSizes.size(); ++i) {
+        const auto expected{ExpectedResult(RandomTable(kTableSizes[i]))};
+        EXPECT_EQ(arithmetic_outputs[i].As<std::vector<std::uint32_t>>(), expected);
+        EXPECT_EQ(mo::ToVectorOutput<std::uint32_t>(
+                      public_outputs[i].As<std::vector<mo::BitVector<>>>()),
+                  expected);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(ObliviousLookup, InvalidTables) {
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper index{party->In<mo::MpcProtocol::kBooleanGmw>(MakeIndices(), 1)};
+      // 4 index bits cannot address 17 entries
+      EXPECT_THROW(mo::algorithm::OneHotIndex(index, 17), std::invalid_argument);
+      EXPECT_THROW(mo::algorithm::OneHotIndex(index, 0), std::invalid_argument);
+      const std::vector<mo::BitVector<>> mixed_table{mo::BitVector<>(8), mo::BitVector<>(16)};
+      EXPECT_THROW(mo::algorithm::ObliviousLookup(mixed_table, index), std::invalid_argument);
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
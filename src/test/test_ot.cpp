@@ -30,8 +30,12 @@
 #include "base/motion_base_provider.h"
 #include "base/party.h"
 #include "data_storage/base_ot_data.h"
+#include "data_storage/ot_extension_data.h"
 #include "oblivious_transfer/base_ots/base_ot_provider.h"
 #include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "oblivious_transfer/random_ot_pool.h"
+#include "oblivious_transfer/silent_ot/silent_ot_extension.h"
 
 namespace {
 
@@ -135,6 +139,233 @@ TEST(ObliviousTransfer, Random1oo2OtsFromOtExtension) {
   }
 }
 
+TEST(SilentOtExtension, ExpandCorrelatedOts) {
+  for (auto parameters : {encrypto::motion::SilentOtParameters{1024, 16, 5},
+                          *encrypto::motion::SelectSilentOtParameters(1'000'000)}) {
+    const std::size_t number_of_base_ots{parameters.GetNumberOfBaseOts()};
+    const std::size_t number_of_ots{parameters.GetNumberOfOts()};
+    auto delta{encrypto::motion::Block128::MakeRandom()};
+    auto base_choices{encrypto::motion::BitVector<>::SecureRandom(number_of_base_ots)};
+    auto sender_base_ots{encrypto::motion::Block128Vector::MakeRandom(number_of_base_ots)};
+    auto receiver_base_ots{sender_base_ots};
+    for (std::size_t i = 0; i < number_of_base_ots; ++i) {
+      if (base_choices.Get(i)) receiver_base_ots[i] ^= delta;
+    }
+
+    encrypto::motion::Block128Vector message(parameters.GetMessageSize());
+    encrypto::motion::Block128Vector sender_ots(number_of_ots), receiver_ots(number_of_ots);
+    encrypto::motion::BitVector<> choices(number_of_ots);
+    encrypto::motion::BitSpan base_choices_span(base_choices), choices_span(choices);
+    encrypto::motion::SilentOtSenderExpand(
+        parameters, std::span(sender_base_ots.data(), number_of_base_ots), delta,
+        std::span(message.data(), message.size()), std::span(sender_ots.data(), number_of_ots));
+    encrypto::motion::SilentOtReceiverExpand(
+        parameters, std::span(receiver_base_ots.data(), number_of_base_ots), base_choices_span,
+        std::span(message.data(), message.size()), std::span(receiver_ots.data(), number_of_ots),
+        choices_span);
+
+    std::size_t number_of_ones{0};
+    for (std::size_t i = 0; i < number_of_ots; ++i) {
+      number_of_ones += choices.Get(i);
+      ASSERT_TRUE((sender_ots[i] ^ receiver_ots[i]) ==
+                  (choices.Get(i) ? delta : encrypto::motion::Block128::MakeZero()));
+    }
+    // the choices are pseudorandom
+    EXPECT_GT(number_of_ones, number_of_ots / 3);
+    EXPECT_LT(number_of_ones, 2 * number_of_ots / 3);
+  }
+}
+
+TEST(SilentOtExtension, TransposeBlocks) {
+  constexpr std::size_t kNumberOfColumns{384};
+  std::vector<encrypto::motion::AlignedBitVector> rows(128);
+  std::array<const std::byte*, 128> row_pointers;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    rows[i] = encrypto::motion::AlignedBitVector::SecureRandom(kNumberOfColumns);
+    row_pointers[i] = rows[i].GetData().data();
+  }
+  encrypto::motion::Block128Vector blocks(kNumberOfColumns);
+  encrypto::motion::TransposeRowsToBlocks(row_pointers, std::span(blocks.data(), blocks.size()),
+                                          kNumberOfColumns);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    for (std::size_t j = 0; j < kNumberOfColumns; ++j) {
+      const bool bit{((std::to_integer<unsigned>(blocks[j].data()[i / 8]) >> (i % 8)) & 1) == 1};
+      ASSERT_EQ(rows[i].Get(j), bit);
+    }
+  }
+
+  std::vector<encrypto::motion::AlignedBitVector> transposed_rows(
+      128, encrypto::motion::AlignedBitVector(kNumberOfColumns));
+  std::array<std::byte*, 128> transposed_row_pointers;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    transposed_row_pointers[i] = transposed_rows[i].GetMutableData().data();
+  }
+  encrypto::motion::TransposeBlocksToRows(std::span(blocks.data(), blocks.size()),
+                                          transposed_row_pointers);
+  EXPECT_EQ(rows, transposed_rows);
+}
+
+TEST(ObliviousTransfer, Random1oo2OtsFromSilentOtExtension) {
+  // enough OTs for the silent OT extension to be used
+  constexpr std::size_t kNumberOfOts{200'000}, kBitlength{64};
+  ASSERT_TRUE(encrypto::motion::SelectSilentOtParameters(kNumberOfOts));
+  constexpr std::size_t kNumberOfParties{2};
+  auto motion_parties{encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::array<std::unique_ptr<encrypto::motion::ROtSender>, kNumberOfParties> sender_ots;
+  std::array<std::unique_ptr<encrypto::motion::ROtReceiver>, kNumberOfParties> receiver_ots;
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    threads.emplace_back([&motion_parties, &sender_ots, &receiver_ots, i]() {
+      auto& backend{motion_parties.at(i)->GetBackend()};
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      backend->GetOtProviderManager().SetSilentOtExtension();
+      backend->GetBaseProvider().Setup();
+      auto& ot_provider{backend->GetOtProvider(1 - i)};
+      sender_ots.at(i) = ot_provider.RegisterSendROt(kNumberOfOts, kBitlength);
+      receiver_ots.at(i) = ot_provider.RegisterReceiveROt(kNumberOfOts, kBitlength);
+      ot_provider.PreSetup();
+      backend->GetBaseOtProvider().PreSetup();
+      backend->Synchronize();
+      backend->GetBaseOtProvider().ComputeBaseOts();
+      backend->OtExtensionSetup();
+      motion_parties.at(i)->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    auto& sender_ot{sender_ots.at(i)};
+    auto& receiver_ot{receiver_ots.at(1 - i)};
+    sender_ot->ComputeOutputs();
+    receiver_ot->ComputeOutputs();
+    const auto& sender_messages{sender_ot->GetOutputs()};
+    const auto& receiver_messages{receiver_ot->GetOutputs()};
+    const auto& choices{receiver_ot->GetChoices()};
+    for (std::size_t l = 0; l < kNumberOfOts; ++l) {
+      std::size_t offset{choices.Get(l) ? kBitlength : 0};
+      ASSERT_EQ(receiver_messages[l], sender_messages[l].Subset(offset, offset + kBitlength));
+    }
+  }
+}
+
+TEST(ObliviousTransfer, Random1oo2OtsFromChunkedOtExtension) {
+  // several chunks s.t. the receiver waits for the sender's acknowledgements, the last one partial
+  constexpr std::size_t kNumberOfOts{5'000}, kChunkSize{1'024}, kBitlength{64};
+  constexpr std::size_t kNumberOfParties{2};
+  auto motion_parties{encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::array<std::unique_ptr<encrypto::motion::ROtSender>, kNumberOfParties> sender_ots;
+  std::array<std::unique_ptr<encrypto::motion::ROtReceiver>, kNumberOfParties> receiver_ots;
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    threads.emplace_back([&motion_parties, &sender_ots, &receiver_ots, i]() {
+      auto& backend{motion_parties.at(i)->GetBackend()};
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      EXPECT_THROW(backend->GetOtProviderManager().SetOtExtensionChunkSize(1'000),
+                   std::invalid_argument);
+      backend->GetOtProviderManager().SetOtExtensionChunkSize(kChunkSize);
+      backend->GetBaseProvider().Setup();
+      auto& ot_provider{backend->GetOtProvider(1 - i)};
+      sender_ots.at(i) = ot_provider.RegisterSendROt(kNumberOfOts, kBitlength);
+      receiver_ots.at(i) = ot_provider.RegisterReceiveROt(kNumberOfOts, kBitlength);
+      ot_provider.PreSetup();
+      backend->GetBaseOtProvider().PreSetup();
+      backend->Synchronize();
+      backend->GetBaseOtProvider().ComputeBaseOts();
+      backend->OtExtensionSetup();
+      motion_parties.at(i)->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    auto& sender_ot{sender_ots.at(i)};
+    auto& receiver_ot{receiver_ots.at(1 - i)};
+    sender_ot->ComputeOutputs();
+    receiver_ot->ComputeOutputs();
+    const auto& sender_messages{sender_ot->GetOutputs()};
+    const auto& receiver_messages{receiver_ot->GetOutputs()};
+    const auto& choices{receiver_ot->GetChoices()};
+    for (std::size_t l = 0; l < kNumberOfOts; ++l) {
+      std::size_t offset{choices.Get(l) ? kBitlength : 0};
+      ASSERT_EQ(receiver_messages[l], sender_messages[l].Subset(offset, offset + kBitlength));
+    }
+  }
+}
+
+TEST(ObliviousTransfer, RandomOtPool) {
+  // requests that span batches and trigger extensions in the background
+  constexpr std::size_t kBatchSize{1'024}, kLowWatermark{512};
+  constexpr std::size_t kRequestSize{700}, kNumberOfRequests{5};
+  constexpr std::size_t kNumberOfParties{2};
+  auto motion_parties{encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  std::vector<encrypto::motion::RandomSenderOts> sender_ots;
+  std::vector<encrypto::motion::RandomReceiverOts> receiver_ots;
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    threads.emplace_back([&motion_parties, &sender_ots, &receiver_ots, i]() {
+      auto& backend{motion_parties.at(i)->GetBackend()};
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      backend->GetBaseProvider().Setup();
+      auto& pool{backend->GetOtProvider(1 - i).EnableRandomOtPool(kBatchSize, kLowWatermark)};
+      backend->GetBaseOtProvider().PreSetup();
+      backend->Synchronize();
+      backend->GetBaseOtProvider().ComputeBaseOts();
+      // none of the OTs was registered before the setup
+      for (std::size_t request = 0; request < kNumberOfRequests; ++request) {
+        if (i == 0) {
+          sender_ots.emplace_back(pool.ObtainSenderOts(kRequestSize));
+        } else {
+          receiver_ots.emplace_back(pool.ObtainReceiverOts(kRequestSize));
+        }
+      }
+      if (i == 0) {
+        EXPECT_EQ(pool.GetNumberOfSenderBatches(),
+                  (kNumberOfRequests * kRequestSize + kBatchSize - 1) / kBatchSize);
+      }
+      motion_parties.at(i)->Finish();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  ASSERT_EQ(sender_ots.size(), kNumberOfRequests);
+  ASSERT_EQ(receiver_ots.size(), kNumberOfRequests);
+  for (std::size_t request = 0; request < kNumberOfRequests; ++request) {
+    const auto& sender{sender_ots[request]};
+    const auto& receiver{receiver_ots[request]};
+    ASSERT_EQ(receiver.choices.GetSize(), kRequestSize);
+    for (std::size_t j = 0; j < kRequestSize; ++j) {
+      const auto& expected{receiver.choices.Get(j) ? sender.messages_1.at(j)
+                                                   : sender.messages_0.at(j)};
+      ASSERT_TRUE(receiver.messages.at(j) == expected);
+      ASSERT_TRUE(sender.messages_0.at(j) != sender.messages_1.at(j));
+    }
+  }
+}
+
+TEST(ObliviousTransfer, OtOutputsAreFreedOnceReleased) {
+  using encrypto::motion::OtOutputs;
+  constexpr std::size_t kNumberOfOts{OtOutputs::kBlockSize + 10};
+  OtOutputs outputs;
+  outputs.Resize(kNumberOfOts);
+  for (std::size_t run = 0; run < 2; ++run) {
+    std::vector<encrypto::motion::BitVector<>> extended(kNumberOfOts,
+                                                         encrypto::motion::BitVector<>(8, true));
+    outputs.Assign(0, std::span(extended));
+    EXPECT_EQ(outputs.GetNumberOfBytes(), kNumberOfOts);
+    EXPECT_EQ(outputs.at(kNumberOfOts - 1), encrypto::motion::BitVector<>(8, true));
+
+    // the first block is freed only after all of its OTs were released
+    EXPECT_FALSE(outputs.Release(0, OtOutputs::kBlockSize - 1));
+    EXPECT_NO_THROW(outputs.at(0));
+    EXPECT_TRUE(outputs.Release(OtOutputs::kBlockSize - 1, 1));
+    EXPECT_THROW(outputs.at(0), std::out_of_range);
+    EXPECT_EQ(outputs.GetNumberOfBytes(), 10u);
+
+    EXPECT_TRUE(outputs.Release(OtOutputs::kBlockSize, 10));
+    EXPECT_EQ(outputs.GetNumberOfBytes(), 0u);
+  }
+}
+
 TEST(ObliviousTransfer, General1oo2OtsFromOtExtension) {
   constexpr std::size_t kNumberOfOts{10};
   for (auto number_of_parties : kNumberOfPartiesList) {
@@ -156,6 +156,59 @@ TEST_F(OtFlavorTest, XcOtBit) {
   ASSERT_EQ(receiver_output, sender_output ^ (choice_bits & correlations));
 }
 
+TEST_F(OtFlavorTest, XcOtBitMixedWithFixedXcOt128InChunks) {
+  // the bit OTs keep their outputs packed, the 128-bit OTs in between do not
+  constexpr std::size_t kNumberOfOts = 700, kChunkSize = 512;
+  const auto correlations = encrypto::motion::BitVector<>::SecureRandom(2 * kNumberOfOts);
+  const auto choice_bits = encrypto::motion::BitVector<>::SecureRandom(3 * kNumberOfOts);
+  const auto correlation = encrypto::motion::Block128::MakeRandom();
+  for (std::size_t i = 0; i < 2; ++i) ot_provider_wrappers_[i]->SetOtExtensionChunkSize(kChunkSize);
+  auto bit_sender_0 = GetSenderProvider().RegisterSendXcOtBit(kNumberOfOts);
+  auto bit_receiver_0 = GetReceiverProvider().RegisterReceiveXcOtBit(kNumberOfOts);
+  auto block_sender = GetSenderProvider().RegisterSendFixedXcOt128(kNumberOfOts);
+  auto block_receiver = GetReceiverProvider().RegisterReceiveFixedXcOt128(kNumberOfOts);
+  auto bit_sender_1 = GetSenderProvider().RegisterSendXcOtBit(kNumberOfOts);
+  auto bit_receiver_1 = GetReceiverProvider().RegisterReceiveXcOtBit(kNumberOfOts);
+
+  RunOtExtensionSetup();
+
+  bit_sender_0->SetCorrelations(correlations.Subset(0, kNumberOfOts));
+  bit_sender_1->SetCorrelations(correlations.Subset(kNumberOfOts, 2 * kNumberOfOts));
+  block_sender->SetCorrelation(correlation);
+  bit_sender_0->SendMessages();
+  bit_sender_1->SendMessages();
+  block_sender->SendMessages();
+
+  bit_receiver_0->SetChoices(choice_bits.Subset(0, kNumberOfOts));
+  block_receiver->SetChoices(choice_bits.Subset(kNumberOfOts, 2 * kNumberOfOts));
+  bit_receiver_1->SetChoices(choice_bits.Subset(2 * kNumberOfOts, 3 * kNumberOfOts));
+  bit_receiver_0->SendCorrections();
+  block_receiver->SendCorrections();
+  bit_receiver_1->SendCorrections();
+
+  for (auto* ot : {bit_sender_0.get(), bit_sender_1.get()}) ot->ComputeOutputs();
+  for (auto* ot : {bit_receiver_0.get(), bit_receiver_1.get()}) ot->ComputeOutputs();
+  block_sender->ComputeOutputs();
+  block_receiver->ComputeOutputs();
+
+  ASSERT_EQ(bit_receiver_0->GetOutputs(),
+            bit_sender_0->GetOutputs() ^ (choice_bits.Subset(0, kNumberOfOts) &
+                                          correlations.Subset(0, kNumberOfOts)));
+  ASSERT_EQ(bit_receiver_1->GetOutputs(),
+            bit_sender_1->GetOutputs() ^
+                (choice_bits.Subset(2 * kNumberOfOts, 3 * kNumberOfOts) &
+                 correlations.Subset(kNumberOfOts, 2 * kNumberOfOts)));
+  const auto sender_output = block_sender->GetOutputs();
+  const auto receiver_output = block_receiver->GetOutputs();
+  for (std::size_t ot_i = 0; ot_i < kNumberOfOts; ++ot_i) {
+    if (choice_bits.Get(kNumberOfOts + ot_i)) {
+      EXPECT_TRUE(receiver_output[ot_i] == (sender_output[ot_i] ^ correlation));
+    } else {
+      EXPECT_TRUE(receiver_output[ot_i] == sender_output[ot_i]);
+    }
+  }
+}
+
 template <typename T>
 class AcOtTest : public OtFlavorTest {
   using is_enabled_t_ = encrypto::motion::IsUnsignedInt<T>;
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+
+#include "test_constants.h"
+
+#include "base/party.h"
+#include "executor/gate_executor.h"
+#include "oblivious_transfer/base_ots/base_ot_provider.h"
+#include "protocols/output_batcher.h"
+#include "protocols/share_wrapper.h"
+
+namespace {
+
+constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+
+TEST(Party, RunAsync) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper x{
+          party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 6 : 0), 0)};
+      encrypto::motion::ShareWrapper y{
+          party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 7 : 0), 1)};
+      auto output{(x * y).Out()};
+
+      std::atomic<std::uint32_t> callback_result{0};
+      auto run_future{party->RunAsync([&] { callback_result = output.As<std::uint32_t>(); })};
+      run_future.get();
+      EXPECT_EQ(callback_result, 42u);
+      EXPECT_EQ(output.As<std::uint32_t>(), 42u);
+
+      party->Finish();
+      EXPECT_THROW(party->RunAsync(), std::logic_error);
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Party, ResetKeepsBaseOts) {
+  auto motion_parties = encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      const std::size_t other_id{1 - i};
+      {
+        encrypto::motion::ShareWrapper x{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 6 : 0), 0)};
+        encrypto::motion::ShareWrapper y{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 7 : 0), 1)};
+        auto output{(x * y).Out()};
+        party->Run();
+        EXPECT_EQ(output.As<std::uint32_t>(), 42u);
+      }
+      const auto first_base_ots{
+          party->GetBackend()->GetBaseOtProvider().ExportBaseOts(other_id)};
+
+      // the new circuit needs different MTs, which the OT extension generates from the base OTs
+      // of the first run
+      party->Reset();
+      {
+        encrypto::motion::ShareWrapper x{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 3 : 0), 0)};
+        encrypto::motion::ShareWrapper y{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 5 : 0), 1)};
+        encrypto::motion::ShareWrapper a{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, true), 0)};
+        encrypto::motion::ShareWrapper b{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, true), 1)};
+        auto product{(x * y * y).Out()};
+        auto conjunction{(a & b).Out()};
+        party->Run();
+        EXPECT_EQ(product.As<std::uint32_t>(), 75u);
+        EXPECT_TRUE(conjunction.As<bool>());
+      }
+      // the base OTs were resumed, which reuses the choice bits with fresh messages
+      const auto second_base_ots{
+          party->GetBackend()->GetBaseOtProvider().ExportBaseOts(other_id)};
+      EXPECT_EQ(second_base_ots.first.c, first_base_ots.first.c);
+      EXPECT_NE(second_base_ots.first.messages_c, first_base_ots.first.messages_c);
+
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Party, SimulatedParties) {
+  constexpr std::size_t kNumberOfParties{4};
+  constexpr std::size_t kNumberOfWorkers{2};
+  EXPECT_THROW(encrypto::motion::MakeSimulatedParties(1), std::invalid_argument);
+  // fewer workers than parties, which only works if the parties share the pool
+  auto motion_parties =
+      encrypto::motion::MakeSimulatedParties(kNumberOfParties, kNumberOfWorkers);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < motion_parties.size(); ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      // layered evaluation waits for the gates of this party after each layer
+      party->GetConfiguration()->SetLayeredEvaluation(true);
+      std::vector<encrypto::motion::ShareWrapper> inputs;
+      for (std::size_t input_owner = 0; input_owner < kNumberOfParties; ++input_owner) {
+        inputs.emplace_back(party->In<kArithmeticGmw>(
+            std::uint32_t(i == input_owner ? input_owner + 2 : 0), input_owner));
+      }
+      auto product{inputs.at(0)};
+      for (std::size_t j = 1; j < inputs.size(); ++j) product = product * inputs.at(j);
+      auto output{product.Out()};
+      party->Run();
+      EXPECT_EQ(output.As<std::uint32_t>(), 2u * 3u * 4u * 5u);
+      EXPECT_EQ(party->GetBackend()->GetGateExecutor().GetFiberPoolStatistics().number_of_workers,
+                std::size_t{kNumberOfWorkers});
+      party->Finish();
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+TEST(Party, BatchedOutputs) {
+  constexpr std::size_t kNumberOfOutputs{20};
+  constexpr std::size_t kNumberOfRuns{2};
+  for (auto number_of_parties : {2u, 3u}) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetBackend()->GetOutputBatcher().SetOutputBatching();
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        encrypto::motion::ShareWrapper y{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 100 : 0), 1)};
+        encrypto::motion::ShareWrapper b{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 1), 1)};
+        // the outputs of the first and of the second layer are reconstructed in one message per
+        // output owner and sharing each
+        std::vector<encrypto::motion::ShareWrapper> all_outputs, owned_outputs, bit_outputs;
+        for (std::size_t j = 0; j < kNumberOfOutputs; ++j) {
+          encrypto::motion::ShareWrapper x{
+              party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? j : 0), 0)};
+          encrypto::motion::ShareWrapper a{
+              party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 0 && j % 2 == 1), 0)};
+          auto sum{x + y};
+          all_outputs.emplace_back(j % 2 == 0 ? sum.Out() : (sum + y).Out());
+          owned_outputs.emplace_back(sum.Out(1));
+          bit_outputs.emplace_back((a ^ b).Out());
+        }
+        party->Compile();
+        for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+          if (run > 0) party->Clear();
+          party->Run();
+          const auto values{encrypto::motion::ShareWrapper::AsAll<std::uint32_t>(all_outputs)};
+          const auto bits{encrypto::motion::ShareWrapper::AsAll<bool>(bit_outputs)};
+          for (std::size_t j = 0; j < kNumberOfOutputs; ++j) {
+            EXPECT_EQ(values[j], j + (j % 2 == 0 ? 100 : 200));
+            EXPECT_EQ(bits[j], j % 2 == 0);
+            if (i == 1) EXPECT_EQ(owned_outputs[j].As<std::uint32_t>(), j + 100);
+          }
+        }
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
+}  // namespace
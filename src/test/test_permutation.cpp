@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/permutation_network.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+TEST(PermutationNetwork, RoutesPermutations) {
+  std::mt19937_64 mersenne_twister(0);
+  for (std::size_t size = 2; size <= 256; size *= 2) {
+    for (std::size_t repetition = 0; repetition < 20; ++repetition) {
+      std::vector<std::size_t> permutation(size);
+      std::iota(permutation.begin(), permutation.end(), 0);
+      std::shuffle(permutation.begin(), permutation.end(), mersenne_twister);
+      const auto layers{mo::algorithm::RoutePermutationNetwork(permutation)};
+      EXPECT_EQ(layers.size(), 2 * std::bit_width(size) - 3);
+
+      std::vector<std::size_t> values(size);
+      std::iota(values.begin(), values.end(), 0);
+      for (const auto& layer : layers) {
+        ASSERT_EQ(layer.first.size(), size / 2);
+        for (std::size_t i = 0; i < layer.first.size(); ++i) {
+          if (layer.swaps[i]) std::swap(values[layer.first[i]], values[layer.second[i]]);
+        }
+      }
+      for (std::size_t i = 0; i < size; ++i) EXPECT_EQ(values[permutation[i]], i);
+    }
+  }
+  EXPECT_THROW(mo::algorithm::RoutePermutationNetwork(std::vector<std::size_t>{0, 1, 2}),
+               std::invalid_argument);
+  EXPECT_THROW(mo::algorithm::RoutePermutationNetwork(std::vector<std::size_t>{0, 0, 2, 3}),
+               std::invalid_argument);
+  auto random_permutation{mo::algorithm::RandomPermutation(100)};
+  std::sort(random_permutation.begin(), random_permutation.end());
+  for (std::size_t i = 0; i < random_permutation.size(); ++i) EXPECT_EQ(random_permutation[i], i);
+}
+
+TEST(Permutation, PermuteAndShuffle) {
+  constexpr std::size_t kNumberOfParties{3}, kNumberOfSimd{13}, kNumberOfWires{4};
+  constexpr std::size_t kPermutingParty{1};
+  std::mt19937_64 mersenne_twister(1);
+  std::vector<std::size_t> permutation(kNumberOfSimd);
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::shuffle(permutation.begin(), permutation.end(), mersenne_twister);
+  std::vector<std::uint32_t> arithmetic_input(kNumberOfSimd);
+  std::generate(arithmetic_input.begin(), arithmetic_input.end(), std::ref(mersenne_twister));
+  std::vector<mo::BitVector<>> boolean_input;
+  for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+    boolean_input.emplace_back(mo::BitVector<>::RandomSeeded(kNumberOfSimd, i));
+  }
+
+  auto parties{mo::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      const auto my_permutation{party_id == kPermutingParty ? permutation
+                                                            : std::vector<std::size_t>{}};
+      mo::ShareWrapper arithmetic{party->In<mo::MpcProtocol::kArithmeticGmw>(arithmetic_input, 0)};
+      mo::ShareWrapper boolean_gmw{party->In<mo::MpcProtocol::kBooleanGmw>(boolean_input, 0)};
+      mo::ShareWrapper bmr{party->In<mo::MpcProtocol::kBmr>(boolean_input, 0)};
+
+      auto arithmetic_output{arithmetic.Permute(my_permutation, kPermutingParty).Out()};
+      auto boolean_gmw_output{boolean_gmw.Permute(my_permutation, kPermutingParty).Out()};
+      auto bmr_output{bmr.Permute(my_permutation, kPermutingParty).Out()};
+      auto shuffled_output{arithmetic.Shuffle().Out()};
+
+      party->Run();
+
+      const auto arithmetic_result{arithmetic_output.As<std::vector<std::uint32_t>>()};
+      const auto boolean_gmw_result{boolean_gmw_output.As<std::vector<mo::BitVector<>>>()};
+      const auto bmr_result{bmr_output.As<std::vector<mo::BitVector<>>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(arithmetic_result[permutation[i]], arithmetic_input[i]);
+        for (std::size_t j = 0; j < kNumberOfWires; ++j) {
+          EXPECT_EQ(boolean_gmw_result[j].Get(permutation[i]), boolean_input[j].Get(i));
+          EXPECT_EQ(bmr_result[j].Get(permutation[i]), boolean_input[j].Get(i));
+        }
+      }
+      const auto shuffled{shuffled_output.As<std::vector<std::uint32_t>>()};
+      EXPECT_TRUE(std::is_permutation(shuffled.begin(), shuffled.end(), arithmetic_input.begin()));
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
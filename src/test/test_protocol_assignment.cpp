@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <random>
+#include <vector>
+
+#include "algorithm/protocol_assignment.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+constexpr auto kBooleanGmw{mo::MpcProtocol::kBooleanGmw};
+constexpr auto kGarbledCircuit{mo::MpcProtocol::kGarbledCircuit};
+
+TEST(ProtocolAssignment, InvalidCircuits) {
+  EXPECT_THROW(mo::MixedCircuit(12), std::invalid_argument);
+  mo::MixedCircuit circuit(32);
+  auto a{circuit.Input(0)};
+  auto b{circuit.Input(1)};
+  EXPECT_THROW(circuit.Add(mo::MixedOperation::kAdd, {a.GetNode()}), std::invalid_argument);
+  EXPECT_THROW(circuit.Add(mo::MixedOperation::kMul, {a.GetNode(), 5}), std::invalid_argument);
+  // the selection bit needs to be a comparison
+  EXPECT_THROW(a.Mux(a, b), std::invalid_argument);
+  auto selection{a > b};
+  EXPECT_EQ(circuit.GetBitLength(selection.GetNode()), 1u);
+  EXPECT_THROW(selection + a, std::invalid_argument);
+  EXPECT_NO_THROW(selection.Mux(a, b));
+}
+
+TEST(ProtocolAssignment, UnsupportedOperations) {
+  mo::MixedCircuit circuit(32);
+  auto a{circuit.Input(0)};
+  auto b{circuit.Input(1)};
+  auto c{(a > b).Mux(a, b)};
+  circuit.Output(c);
+  const mo::ProtocolCostModel cost_model(2, std::chrono::milliseconds(1), 1e9);
+  std::vector<mo::MpcProtocol> protocols(circuit.GetNodes().size(), kArithmeticGmw);
+  EXPECT_TRUE(std::isinf(mo::EstimateRunTime(circuit, protocols, cost_model)));
+  protocols.assign(protocols.size(), kBooleanGmw);
+  EXPECT_FALSE(std::isinf(mo::EstimateRunTime(circuit, protocols, cost_model)));
+  const auto assignment{mo::AssignProtocols(circuit, cost_model)};
+  EXPECT_NE(assignment.protocols[c.GetNode()], kArithmeticGmw);
+  EXPECT_LE(assignment.estimated_time, mo::EstimateRunTime(circuit, protocols, cost_model));
+}
+
+TEST(ProtocolAssignment, ArithmeticOperationsInArithmeticGmw) {
+  mo::MixedCircuit circuit(32, 1000);
+  auto a{circuit.Input(0)};
+  auto b{circuit.Input(1)};
+  auto product{a * b};
+  for (std::size_t i = 0; i < 10; ++i) product = product * a + b;
+  circuit.Output(product);
+  for (std::size_t number_of_parties : {2u, 3u}) {
+    const mo::ProtocolCostModel cost_model(number_of_parties, std::chrono::milliseconds(100), 1e9);
+    const auto assignment{mo::AssignProtocols(circuit, cost_model)};
+    for (const auto protocol : assignment.protocols) EXPECT_EQ(protocol, kArithmeticGmw);
+  }
+}
+
+TEST(ProtocolAssignment, ComparisonsInGarbledCircuitsOnSlowNetworks) {
+  mo::MixedCircuit circuit(32);
+  auto a{circuit.Input(0)};
+  auto b{circuit.Input(1)};
+  auto comparison{a > b};
+  circuit.Output(comparison.Mux(a, b));
+  const mo::ProtocolCostModel slow_network(2, std::chrono::milliseconds(100), 1e9);
+  EXPECT_EQ(mo::AssignProtocols(circuit, slow_network).protocols[comparison.GetNode()],
+            kGarbledCircuit);
+
+  // measured costs replace the defaults
+  mo::ProtocolCostModel measured(2, std::chrono::milliseconds(100), 1e9);
+  measured.SetOperationCost(mo::MixedOperation::kGreaterThan, kGarbledCircuit, 32, {10, 0, 0});
+  EXPECT_EQ(
+      measured.GetOperationCost(mo::MixedOperation::kGreaterThan, kGarbledCircuit, 32)->rounds,
+      10);
+  EXPECT_NE(mo::AssignProtocols(circuit, measured).protocols[comparison.GetNode()],
+            kGarbledCircuit);
+}
+
+template <typename T>
+std::vector<T> GetOutput(const mo::ShareWrapper& output) {
+  if (output->GetProtocol() == kArithmeticGmw) return output.As<std::vector<T>>();
+  return mo::ToVectorOutput<T>(output.As<std::vector<mo::BitVector<>>>());
+}
+
+TEST(ProtocolAssignment, BuildMixedCircuit) {
+  constexpr std::size_t kNumberOfSimd{10};
+  std::mt19937 mersenne_twister(0);
+  std::vector<std::vector<std::uint32_t>> inputs(2, std::vector<std::uint32_t>(kNumberOfSimd));
+  for (auto& v : inputs) std::generate(v.begin(), v.end(), std::ref(mersenne_twister));
+
+  mo::MixedCircuit circuit(32, kNumberOfSimd);
+  auto a{circuit.Input(0)};
+  auto b{circuit.Input(1)};
+  auto sum{a + b};
+  auto product{sum * a};
+  circuit.Output(sum);
+  circuit.Output((product > b).Mux(a, b));
+
+  const mo::ProtocolCostModel cost_model(2, std::chrono::milliseconds(100), 1e9);
+  // the optimized assignment and one with a conversion between each pair of nodes
+  std::vector<mo::ProtocolAssignment> assignments{mo::AssignProtocols(circuit, cost_model)};
+  assignments.push_back({{kArithmeticGmw, kBooleanGmw, kGarbledCircuit, kArithmeticGmw,
+                          kBooleanGmw, kGarbledCircuit}});
+
+  for (const auto& assignment : assignments) {
+    auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < 2u; ++party_id) {
+      futures.emplace_back(
+          std::async(std::launch::async, [party_id, &parties, &inputs, &circuit, &assignment]() {
+            std::vector<std::vector<std::uint32_t>> my_inputs(2);
+            my_inputs[party_id] = inputs[party_id];
+            const auto outputs{
+                mo::BuildMixedCircuit(*parties[party_id], circuit, assignment, my_inputs)};
+            parties[party_id]->Run();
+            const auto sums{GetOutput<std::uint32_t>(outputs[0])};
+            const auto results{GetOutput<std::uint32_t>(outputs[1])};
+            for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+              const std::uint32_t expected_sum = inputs[0][i] + inputs[1][i];
+              const std::uint32_t expected_product = expected_sum * inputs[0][i];
+              EXPECT_EQ(sums[i], expected_sum);
+              EXPECT_EQ(results[i], expected_product > inputs[1][i] ? inputs[0][i] : inputs[1][i]);
+            }
+            parties[party_id]->Finish();
+          }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+}  // namespace
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/psi.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+std::vector<std::uint64_t> RandomSet(std::size_t size, std::mt19937_64& random) {
+  std::set<std::uint64_t> set;
+  while (set.size() < size) set.insert(random());
+  return {set.begin(), set.end()};
+}
+
+TEST(Psi, Hashing) {
+  std::mt19937_64 random(0);
+  for (std::size_t size : {1u, 2u, 17u, 1000u}) {
+    const auto items{RandomSet(size, random)};
+    const auto parameters{mo::algorithm::GetPsiParameters(size, size)};
+    const auto cuckoo_bins{mo::algorithm::CuckooHash(items, parameters.number_of_bins)};
+    const auto simple_bins{mo::algorithm::SimpleHash(items, parameters.number_of_bins)};
+    std::set<std::size_t> placed_items;
+    for (std::size_t bin = 0; bin < parameters.number_of_bins; ++bin) {
+      EXPECT_LE(simple_bins[bin].size(), parameters.max_bin_size);
+      if (!cuckoo_bins[bin]) continue;
+      EXPECT_TRUE(placed_items.insert(*cuckoo_bins[bin]).second);
+      // both hashings agree on the bin of each cuckoo item
+      const auto item{items.at(*cuckoo_bins[bin])};
+      EXPECT_EQ(std::count(simple_bins[bin].begin(), simple_bins[bin].end(), item), 1);
+    }
+    EXPECT_EQ(placed_items.size(), size);
+  }
+  EXPECT_THROW(mo::algorithm::GetPsiParameters(0, 1), std::invalid_argument);
+}
+
+TEST(Psi, PrivateSetIntersection) {
+  constexpr std::size_t kReceiverSetSize{50}, kSenderSetSize{70}, kIntersectionSize{20};
+  std::mt19937_64 random(kReceiverSetSize);
+  const auto receiver_set{RandomSet(kReceiverSetSize, random)};
+  auto sender_set{RandomSet(kSenderSetSize - kIntersectionSize, random)};
+  sender_set.insert(sender_set.end(), receiver_set.begin(),
+                    receiver_set.begin() + kIntersectionSize);
+  const std::set<std::uint64_t> sender_items(sender_set.begin(), sender_set.end());
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::optional<std::size_t>> bin_items;
+  std::vector<mo::BitVector<>> memberships(parties.size());
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      const auto& set{party_id == 0 ? receiver_set : sender_set};
+      auto result{mo::algorithm::PrivateSetIntersection(*party->GetBackend(), set,
+                                                        kReceiverSetSize, kSenderSetSize)};
+      auto output{result.membership.Out()};
+      party->Run();
+      memberships[party_id] = output.As<mo::BitVector<>>();
+      if (party_id == 0) bin_items = std::move(result.bin_items);
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+
+  EXPECT_EQ(memberships[0], memberships[1]);
+  ASSERT_EQ(memberships[0].GetSize(), bin_items.size());
+  std::size_t intersection_size{0};
+  for (std::size_t bin = 0; bin < bin_items.size(); ++bin) {
+    const bool expected{bin_items[bin] && sender_items.contains(receiver_set.at(*bin_items[bin]))};
+    EXPECT_EQ(memberships[0].Get(bin), expected);
+    intersection_size += memberships[0].Get(bin);
+  }
+  EXPECT_EQ(intersection_size, kIntersectionSize);
+}
+
+TEST(Psi, ThrowsForInvalidSets) {
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  const std::vector<std::uint64_t> duplicates{1, 2, 2}, set{1, 2, 3};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& backend{*parties[party_id]->GetBackend()};
+      EXPECT_THROW(mo::algorithm::PrivateSetIntersection(backend, duplicates, 3, 3),
+                   std::invalid_argument);
+      // the set sizes are public
+      EXPECT_THROW(mo::algorithm::PrivateSetIntersection(backend, set, 4, 4),
+                   std::invalid_argument);
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
@@ -0,0 +1,216 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <array>
+#include <future>
+#include <random>
+
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "test_helpers.h"
+#include "utility/bit_vector.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+constexpr std::size_t kAll = std::numeric_limits<std::int64_t>::max();
+constexpr auto kArithmeticReplicated = mo::MpcProtocol::kArithmeticReplicated;
+constexpr auto kBooleanReplicated = mo::MpcProtocol::kBooleanReplicated;
+constexpr std::size_t kNumberOfParties{3};
+constexpr std::size_t kNumberOfSimd{100};
+
+std::vector<mo::PartyPointer> MakeParties() {
+  auto parties{mo::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset)};
+  for (auto& party : parties) {
+    party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    party->GetConfiguration()->SetOnlineAfterSetup(false);
+  }
+  return parties;
+}
+
+template <typename T>
+std::array<std::vector<T>, kNumberOfParties> RandomInputs() {
+  std::mt19937_64 mt(0);
+  std::uniform_int_distribution<std::uint64_t> dist;
+  std::array<std::vector<T>, kNumberOfParties> inputs;
+  for (auto& v : inputs) {
+    v.resize(kNumberOfSimd);
+    for (T& t : v) t = static_cast<T>(dist(mt));
+  }
+  return inputs;
+}
+
+// runs the circuit that \p build constructs at each party and checks its outputs by \p check
+template <typename Build, typename Check>
+void Evaluate(std::vector<mo::PartyPointer>& parties, Build build, Check check) {
+  std::array<std::future<void>, kNumberOfParties> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures[party_id] = std::async([&, party_id]() {
+      auto outputs{build(*parties[party_id], party_id)};
+      parties[party_id]->Run();
+      check(outputs, party_id);
+      parties[party_id]->Finish();
+    });
+  }
+  for (auto& f : futures) f.get();
+}
+
+template <typename T>
+class ReplicatedArithmeticTest : public ::testing::Test {
+ protected:
+  void SetUp() override { parties_ = MakeParties(); }
+
+  // the shares of the inputs of all parties at party \p party_id
+  std::array<mo::ShareWrapper, kNumberOfParties> Share(mo::Party& party, std::size_t party_id) {
+    std::array<mo::ShareWrapper, kNumberOfParties> shares;
+    for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+      shares[owner] = party.In<kArithmeticReplicated>(
+          owner == party_id ? inputs_[owner] : std::vector<T>(kNumberOfSimd), owner);
+    }
+    return shares;
+  }
+
+  std::array<std::vector<T>, kNumberOfParties> inputs_{RandomInputs<T>()};
+  std::vector<mo::PartyPointer> parties_;
+};
+
+using UintTypes = ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(ReplicatedArithmeticTest, UintTypes);
+
+TYPED_TEST(ReplicatedArithmeticTest, InputOutput) {
+  Evaluate(
+      this->parties_,
+      [this](mo::Party& party, std::size_t party_id) {
+        auto shares{this->Share(party, party_id)};
+        EXPECT_TRUE(shares[0]->GetProtocol() == kArithmeticReplicated);
+        std::vector<mo::ShareWrapper> outputs;
+        for (auto& share : shares) outputs.push_back(share.Out(kAll));
+        // each input is also revealed to its next party only
+        for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+          outputs.push_back(shares[owner].Out((owner + 1) % kNumberOfParties));
+        }
+        return outputs;
+      },
+      [this](std::vector<mo::ShareWrapper>& outputs, std::size_t party_id) {
+        for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+          EXPECT_EQ(outputs[owner].template As<std::vector<TypeParam>>(), this->inputs_[owner]);
+        }
+        const std::size_t previous{(party_id + kNumberOfParties - 1) % kNumberOfParties};
+        EXPECT_EQ(outputs[kNumberOfParties + previous].template As<std::vector<TypeParam>>(),
+                  this->inputs_[previous]);
+      });
+}
+
+TYPED_TEST(ReplicatedArithmeticTest, AdditionSubtractionMultiplication) {
+  Evaluate(
+      this->parties_,
+      [this](mo::Party& party, std::size_t party_id) {
+        auto s{this->Share(party, party_id)};
+        return std::vector<mo::ShareWrapper>{(s[0] + s[1]).Out(), (s[1] - s[2]).Out(),
+                                             (s[0] * s[1] * s[2]).Out()};
+      },
+      [this](std::vector<mo::ShareWrapper>& outputs, std::size_t) {
+        const auto& x{this->inputs_};
+        std::vector<TypeParam> sum(kNumberOfSimd), difference(kNumberOfSimd),
+            product(kNumberOfSimd);
+        for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+          sum[i] = x[0][i] + x[1][i];
+          difference[i] = x[1][i] - x[2][i];
+          product[i] = x[0][i] * x[1][i] * x[2][i];
+        }
+        EXPECT_EQ(outputs[0].template As<std::vector<TypeParam>>(), sum);
+        EXPECT_EQ(outputs[1].template As<std::vector<TypeParam>>(), difference);
+        EXPECT_EQ(outputs[2].template As<std::vector<TypeParam>>(), product);
+      });
+}
+
+TYPED_TEST(ReplicatedArithmeticTest, ConversionsFromAndToGmw) {
+  Evaluate(
+      this->parties_,
+      [this](mo::Party& party, std::size_t party_id) {
+        auto s{this->Share(party, party_id)};
+        auto arithmetic_gmw{s[0].template Convert<mo::MpcProtocol::kArithmeticGmw>()};
+        EXPECT_TRUE(arithmetic_gmw->GetProtocol() == mo::MpcProtocol::kArithmeticGmw);
+        auto boolean_gmw{s[1].template Convert<mo::MpcProtocol::kBooleanGmw>()};
+        EXPECT_TRUE(boolean_gmw->GetProtocol() == mo::MpcProtocol::kBooleanGmw);
+        auto back{arithmetic_gmw.template Convert<kArithmeticReplicated>()};
+        EXPECT_TRUE(back->GetProtocol() == kArithmeticReplicated);
+        return std::vector<mo::ShareWrapper>{arithmetic_gmw.Out(), boolean_gmw.Out(),
+                                             (back * s[2]).Out()};
+      },
+      [this](std::vector<mo::ShareWrapper>& outputs, std::size_t) {
+        const auto& x{this->inputs_};
+        std::vector<TypeParam> product(kNumberOfSimd);
+        for (std::size_t i = 0; i < kNumberOfSimd; ++i) product[i] = x[0][i] * x[2][i];
+        EXPECT_EQ(outputs[0].template As<std::vector<TypeParam>>(), x[0]);
+        EXPECT_EQ(mo::ToVectorOutput<TypeParam>(
+                      outputs[1].template As<std::vector<mo::BitVector<>>>()),
+                  x[1]);
+        EXPECT_EQ(outputs[2].template As<std::vector<TypeParam>>(), product);
+      });
+}
+
+}  // namespace
+
+TEST(ReplicatedBooleanTest, XorAndInv) {
+  constexpr std::size_t kNumberOfWires{8};
+  std::array<std::vector<mo::BitVector<>>, kNumberOfParties> inputs;
+  for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+    for (std::size_t j = 0; j < kNumberOfWires; ++j) {
+      inputs[owner].push_back(mo::BitVector<>::RandomSeeded(kNumberOfSimd, owner * 100 + j));
+    }
+  }
+  auto parties{MakeParties()};
+  Evaluate(
+      parties,
+      [&inputs](mo::Party& party, std::size_t party_id) {
+        std::array<mo::ShareWrapper, kNumberOfParties> s;
+        for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+          auto input{owner == party_id
+                         ? inputs[owner]
+                         : std::vector<mo::BitVector<>>(kNumberOfWires,
+                                                        mo::BitVector<>(kNumberOfSimd))};
+          s[owner] = party.In<kBooleanReplicated>(std::move(input), owner);
+        }
+        EXPECT_TRUE(s[0]->GetProtocol() == kBooleanReplicated);
+        auto gmw{(s[0] & s[1]).Convert<mo::MpcProtocol::kBooleanGmw>()};
+        EXPECT_TRUE(gmw->GetProtocol() == mo::MpcProtocol::kBooleanGmw);
+        return std::vector<mo::ShareWrapper>{(s[0] ^ s[1]).Out(), (s[0] & s[1] & s[2]).Out(0),
+                                             (~s[2]).Out(), gmw.Out()};
+      },
+      [&inputs](std::vector<mo::ShareWrapper>& outputs, std::size_t party_id) {
+        for (std::size_t j = 0; j < kNumberOfWires; ++j) {
+          const auto& a{inputs[0][j]};
+          const auto& b{inputs[1][j]};
+          const auto& c{inputs[2][j]};
+          EXPECT_EQ(outputs[0].GetWire(j).As<mo::BitVector<>>(), a ^ b);
+          if (party_id == 0) EXPECT_EQ(outputs[1].GetWire(j).As<mo::BitVector<>>(), a & b & c);
+          EXPECT_EQ(outputs[2].GetWire(j).As<mo::BitVector<>>(), ~c);
+          EXPECT_EQ(outputs[3].GetWire(j).As<mo::BitVector<>>(), a & b);
+        }
+      });
+}
@@ -20,6 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <stdexcept>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "utility/fiber_waitable.h"
@@ -52,6 +55,16 @@ TEST(ReusableFuture, SetTwice) {
   EXPECT_THROW(promise.set_value(47), std::future_error);
 }
 
+TEST(ReusableFuture, SetException) {
+  ReusablePromise<int> promise;
+  auto future = promise.get_future();
+  promise.set_exception(std::make_exception_ptr(std::runtime_error("failed")));
+  EXPECT_THROW(promise.set_value(42), std::future_error);
+  EXPECT_THROW(future.get(), std::runtime_error);
+  promise.set_value(42);
+  EXPECT_EQ(future.get(), 42);
+}
+
 TEST(ReusableFuture, SetTwiceWithReset) {
   constexpr int kInputValue1 = 42;
   constexpr int kInputValue2 = 47;
@@ -89,6 +102,30 @@ TEST(ReusableFuture, RetrieveFutureTwice) {
   EXPECT_THROW(promise.get_future(), std::future_error);
 }
 
+TEST(ReusableFuture, ConcurrentSetAndGet) {
+  constexpr std::size_t kNumberOfValues = 10000;
+  ReusablePromise<std::size_t> promise;
+  auto future = promise.get_future();
+  std::thread producer([&promise] {
+    for (std::size_t i = 0; i < kNumberOfValues; ++i) {
+      // wait until the consumer took the previous value
+      while (true) {
+        try {
+          promise.set_value(i);
+          break;
+        } catch (const std::future_error&) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+  for (std::size_t i = 0; i < kNumberOfValues; ++i) {
+    ASSERT_EQ(future.get(), i);
+  }
+  producer.join();
+  EXPECT_FALSE(future.is_ready());
+}
+
 TEST(WaitableFuture, Wait) {
   class SetupWaitableClass : public encrypto::motion::FiberSetupWaitable {};
 
@@ -23,6 +23,7 @@
 #include "gtest/gtest.h"
 #include "primitives/random/aes128_ctr_rng.h"
 #include "primitives/random/openssl_rng.h"
+#include "primitives/sharing_randomness_generator.h"
 #include "test_constants.h"
 
 // Test vectors from NIST FIPS 197, Appendix A
@@ -80,3 +81,28 @@ TEST(OpenSslRng, NoTrivialOutput) {
   rngt.RandomBlocksAligned(output_1.data(), 10);
   EXPECT_NE(output_0, output_1);
 }
+
+TEST(SharingRandomnessGenerator, ConsistentBatches) {
+  std::array<std::uint8_t, 32> seed;
+  for (std::size_t i = 0; i < seed.size(); ++i) seed[i] = i;
+  encrypto::motion::primitives::SharingRandomnessGenerator generator_0(0), generator_1(1);
+  generator_0.Initialize(seed.data());
+  generator_1.Initialize(seed.data());
+
+  // the values only depend on the sharing ids, not on the batches they are requested in
+  const auto values{generator_0.GetUnsigned<std::uint64_t>(10, 3000)};
+  const auto subset{generator_1.GetUnsigned<std::uint64_t>(2010, 5)};
+  for (std::size_t i = 0; i < subset.size(); ++i) EXPECT_EQ(subset[i], values[2000 + i]);
+  EXPECT_EQ(generator_1.GetUnsigned<std::uint64_t>(11), values[1]);
+  EXPECT_NE(values[0], values[1]);
+  std::vector<std::uint32_t> span_values(4);
+  generator_1.GetUnsigned<std::uint32_t>(10, std::span(span_values));
+  EXPECT_EQ(span_values[0], static_cast<std::uint32_t>(values[0]));
+
+  const auto bits{generator_0.GetBits(0, 3000)};
+  for (std::size_t from : {0, 1, 127, 128, 300}) {
+    for (std::size_t length : {1, 7, 128, 129, 1000}) {
+      EXPECT_EQ(generator_1.GetBits(from, length), bits.Subset(from, from + length));
+    }
+  }
+}
@@ -107,6 +107,140 @@ TEST(SharedBits, Integer) {
   TemplateTest<std::uint64_t>();
 }
 
+template <typename T>
+void ExpectSharedBits(std::vector<std::unique_ptr<encrypto::motion::Party>>& motion_parties,
+                      std::size_t number_of_sbs) {
+  std::vector<T> a = motion_parties.at(0)->GetBackend()->GetSbProvider().template GetSbsAll<T>();
+  ASSERT_EQ(a.size(), number_of_sbs);
+  for (std::size_t j = 1; j < motion_parties.size(); ++j) {
+    const auto& sbs_j{motion_parties.at(j)->GetBackend()->GetSbProvider().template GetSbsAll<T>()};
+    ASSERT_EQ(sbs_j.size(), number_of_sbs);
+    for (std::size_t k = 0; k < a.size(); ++k) a.at(k) += sbs_j.at(k);
+  }
+  EXPECT_TRUE(std::all_of(a.cbegin(), a.cend(), [](auto b) { return b == 0 || b == 1; }));
+  EXPECT_TRUE(std::any_of(a.cbegin(), a.cend(), [](auto b) { return b == 0; }));
+  EXPECT_TRUE(std::any_of(a.cbegin(), a.cend(), [](auto b) { return b == 1; }));
+}
+
+// the SBs of all bit sizes are computed from a single batch of SPs of the largest bit size
+TEST(SharedBits, MixedBitSizes) {
+  constexpr std::size_t kNumberOfSbs = 100;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      auto& sb_provider{party->GetBackend()->GetSbProvider()};
+      sb_provider.RequestSbs<std::uint8_t>(kNumberOfSbs);
+      sb_provider.RequestSbs<std::uint16_t>(kNumberOfSbs);
+      sb_provider.RequestSbs<std::uint32_t>(kNumberOfSbs);
+      sb_provider.RequestSbs<std::uint64_t>(kNumberOfSbs);
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+        auto& backend = motion_parties.at(j)->GetBackend();
+        backend->GetBaseProvider().Setup();
+        auto& sp_provider = backend->GetSpProvider();
+        auto& sb_provider = backend->GetSbProvider();
+        sb_provider.PreSetup();
+        EXPECT_EQ(sp_provider.GetNumberOfSps<std::uint16_t>(), 0);
+        EXPECT_EQ(sp_provider.GetNumberOfSps<std::uint32_t>(), 0);
+        EXPECT_EQ(sp_provider.GetNumberOfSps<std::uint64_t>(), 0);
+        EXPECT_EQ(sp_provider.GetNumberOfSps<__uint128_t>(), 4 * kNumberOfSbs);
+        sp_provider.PreSetup();
+        backend->GetOtProviderManager().PreSetup();
+        backend->GetBaseOtProvider().PreSetup();
+        backend->Synchronize();
+        backend->GetBaseOtProvider().ComputeBaseOts();
+        backend->OtExtensionSetup();
+        sp_provider.Setup();
+        sb_provider.Setup();
+      }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+    ExpectSharedBits<std::uint8_t>(motion_parties, kNumberOfSbs);
+    ExpectSharedBits<std::uint16_t>(motion_parties, kNumberOfSbs);
+    ExpectSharedBits<std::uint32_t>(motion_parties, kNumberOfSbs);
+    ExpectSharedBits<std::uint64_t>(motion_parties, kNumberOfSbs);
+
+    futures.clear();
+    for (auto& party : motion_parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+  }
+}
+
+template <typename T>
+void EdaBitsTemplateTest() {
+  constexpr std::size_t kBitLength{sizeof(T) * 8};
+  constexpr std::size_t kNumberOfEdaBits = 100;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::size_t> offsets;
+    for (auto& party : motion_parties) {
+      party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      // an SB ahead of the edaBits, s.t. their offset is non-zero
+      party->GetBackend()->GetSbProvider().template RequestSbs<T>(1);
+      offsets.push_back(
+          party->GetBackend()->GetSbProvider().template RequestEdaBits<T>(kNumberOfEdaBits));
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, j] {
+        auto& backend = motion_parties.at(j)->GetBackend();
+        backend->GetBaseProvider().Setup();
+        auto& sp_provider = backend->GetSpProvider();
+        auto& sb_provider = backend->GetSbProvider();
+        sb_provider.PreSetup();
+        sp_provider.PreSetup();
+        backend->GetOtProviderManager().PreSetup();
+        backend->GetBaseOtProvider().PreSetup();
+        backend->Synchronize();
+        backend->GetBaseOtProvider().ComputeBaseOts();
+        backend->OtExtensionSetup();
+        sp_provider.Setup();
+        sb_provider.Setup();
+      }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+
+    std::vector<T> arithmetic(kNumberOfEdaBits, 0);
+    std::vector<encrypto::motion::BitVector<>> boolean(
+        kBitLength, encrypto::motion::BitVector<>(kNumberOfEdaBits));
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      EXPECT_EQ(offsets.at(j), 1);
+      auto& sb_provider = motion_parties.at(j)->GetBackend()->GetSbProvider();
+      const auto edabits{sb_provider.template GetEdaBits<T>(offsets.at(j), kNumberOfEdaBits)};
+      ASSERT_EQ(edabits.arithmetic_shares.size(), kNumberOfEdaBits);
+      ASSERT_EQ(edabits.boolean_shares.size(), kBitLength);
+      for (std::size_t k = 0; k < kNumberOfEdaBits; ++k) {
+        arithmetic[k] += edabits.arithmetic_shares[k];
+      }
+      for (std::size_t i = 0; i < kBitLength; ++i) boolean[i] ^= edabits.boolean_shares[i];
+    }
+    EXPECT_EQ(arithmetic, encrypto::motion::ToVectorOutput<T>(boolean));
+
+    futures.clear();
+    for (auto& party : motion_parties) {
+      futures.emplace_back(std::async(std::launch::async, [&party] { party->Finish(); }));
+    }
+    std::for_each(futures.begin(), futures.end(), [](auto& f) { f.get(); });
+  }
+}
+
+TEST(SharedBits, EdaBits) {
+  EdaBitsTemplateTest<std::uint8_t>();
+  EdaBitsTemplateTest<std::uint16_t>();
+  EdaBitsTemplateTest<std::uint32_t>();
+  EdaBitsTemplateTest<std::uint64_t>();
+}
+
 TEST(SharedBitsImplementation, Invert) {
   constexpr std::size_t kK = 6;
   constexpr std::uint64_t kA = 47;
@@ -0,0 +1,109 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/party.h"
+#include "secure_type/secure_float.h"
+#include "test_constants.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+template <typename FloatType>
+void TestSecureFloat() {
+  constexpr std::size_t kNumberOfSimd{5};
+  std::mt19937 mersenne_twister(sizeof(FloatType));
+  std::uniform_real_distribution<FloatType> distribution(-10, 10);
+  std::vector<FloatType> a(kNumberOfSimd), b(kNumberOfSimd);
+  for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+    a[i] = distribution(mersenne_twister);
+    b[i] = distribution(mersenne_twister);
+  }
+  a[0] = b[0];
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      const mo::SecureFloat share_a{party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(a), 0)};
+      const mo::SecureFloat share_b{party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(b), 1)};
+
+      auto sum{(share_a + share_b).Out()};
+      auto difference{(share_a - share_b).Out()};
+      auto product{(share_a * share_b).Out()};
+      auto quotient{(share_a / share_b).Out()};
+      auto negation{(-share_a).Out()};
+      auto is_less{(share_a < share_b).Out()};
+      auto is_equal{(share_a == share_b).Out()};
+      // the absolute value by the square of the square root
+      const auto square{share_a * share_a};
+      auto square_root{square.Sqrt().Out()};
+      auto logarithm{square.Log().Out()};
+      auto exponential{share_a.Exp().Out()};
+
+      party->Run();
+
+      const auto sums{sum.As<std::vector<FloatType>>()};
+      const auto differences{difference.As<std::vector<FloatType>>()};
+      const auto products{product.As<std::vector<FloatType>>()};
+      const auto quotients{quotient.As<std::vector<FloatType>>()};
+      const auto negations{negation.As<std::vector<FloatType>>()};
+      const auto less_bits{is_less.template As<mo::BitVector<>>()};
+      const auto equal_bits{is_equal.template As<mo::BitVector<>>()};
+      const auto square_roots{square_root.As<std::vector<FloatType>>()};
+      const auto logarithms{logarithm.As<std::vector<FloatType>>()};
+      const auto exponentials{exponential.As<std::vector<FloatType>>()};
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(sums[i], a[i] + b[i]);
+        EXPECT_EQ(differences[i], a[i] - b[i]);
+        EXPECT_EQ(products[i], a[i] * b[i]);
+        EXPECT_EQ(quotients[i], a[i] / b[i]);
+        EXPECT_EQ(negations[i], -a[i]);
+        EXPECT_EQ(less_bits.Get(i), a[i] < b[i]);
+        EXPECT_EQ(equal_bits.Get(i), a[i] == b[i]);
+        const FloatType a_square{a[i] * a[i]};
+        EXPECT_EQ(square_roots[i], std::sqrt(a_square));
+        EXPECT_NEAR(logarithms[i], std::log(a_square), 1e-5);
+        EXPECT_NEAR(exponentials[i] / std::exp(a[i]), 1, 1e-6);
+      }
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(SecureFloat, Binary32InBooleanGmw) { TestSecureFloat<float>(); }
+
+TEST(SecureFloat, Binary64InBooleanGmw) { TestSecureFloat<double>(); }
+
+}  // namespace
@@ -0,0 +1,159 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/party.h"
+#include "base/register.h"
+#include "secure_type/secure_unsigned_integer_vector.h"
+#include "test_constants.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+template <mo::MpcProtocol P>
+mo::SecureUnsignedIntegerVector Input(mo::PartyPointer& party,
+                                      const std::vector<std::uint32_t>& values,
+                                      std::size_t input_owner) {
+  if constexpr (P == mo::MpcProtocol::kArithmeticGmw) {
+    return party->In<P>(values, input_owner);
+  } else {
+    return party->In<P>(mo::ToInput(values), input_owner);
+  }
+}
+
+template <mo::MpcProtocol P>
+void TestVectorOperations(std::size_t size) {
+  std::mt19937 mersenne_twister(size);
+  std::vector<std::uint32_t> a(size), b(size);
+  std::generate(a.begin(), a.end(), [&]() { return mersenne_twister(); });
+  std::generate(b.begin(), b.end(), [&]() { return mersenne_twister(); });
+  // reversed elements 0..size-1 and every element scattered into b in reverse order
+  std::vector<std::size_t> reversed(size);
+  std::iota(reversed.rbegin(), reversed.rend(), 0);
+
+  std::vector<std::uint32_t> expected_products(size), expected_prefix_sums(size),
+      expected_gathered(size), expected_scattered(b);
+  for (std::size_t i = 0; i < size; ++i) {
+    expected_products[i] = a[i] * b[i];
+    expected_prefix_sums[i] = a[i] + (i > 0 ? expected_prefix_sums[i - 1] : 0);
+    expected_gathered[i] = a[reversed[i]];
+    expected_scattered[reversed[i]] = a[i];
+  }
+  const std::uint32_t expected_sum{expected_prefix_sums.back()};
+  const std::uint32_t expected_minimum{*std::min_element(a.begin(), a.end())};
+  // every third element is selected from a and summed
+  mo::BitVector<> condition(size);
+  std::vector<std::uint32_t> expected_selected(b);
+  std::uint32_t expected_conditional_sum{0};
+  for (std::size_t i = 0; i < size; i += 3) {
+    condition.Set(true, i);
+    expected_selected[i] = a[i];
+    expected_conditional_sum += a[i];
+  }
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      const mo::SecureUnsignedIntegerVector share_a{Input<P>(party, a, 0)};
+      const mo::SecureUnsignedIntegerVector share_b{Input<P>(party, b, 1)};
+      const auto share_condition{party->In<mo::MpcProtocol::kBooleanGmw>(condition, 0)};
+
+      auto products_output{(share_a * share_b).Out()};
+      const auto number_of_gates{party->GetBackend()->GetRegister()->GetGates().size()};
+      auto prefix_sums{share_a.PrefixSum()};
+      if constexpr (P == mo::MpcProtocol::kArithmeticGmw) {
+        // a constant number of gates per round instead of per element
+        std::size_t number_of_rounds{0};
+        while ((std::size_t(1) << number_of_rounds) < size) ++number_of_rounds;
+        EXPECT_LE(party->GetBackend()->GetRegister()->GetGates().size() - number_of_gates,
+                  5 * number_of_rounds);
+      }
+      auto prefix_sums_output{prefix_sums.Out()};
+      auto sum_output{share_a.Sum().Out()};
+      auto minimum_output{share_a.Minimum().Out()};
+      auto gathered_output{share_a.Gather(reversed).Out()};
+      auto scattered_output{share_a.Scatter(reversed, share_b).Out()};
+      auto selected_output{
+          mo::SecureUnsignedIntegerVector::Mux(share_condition, share_a, share_b).Out()};
+      auto conditional_sum_output{share_a.SumWhere(share_condition).Out()};
+
+      party->Run();
+
+      EXPECT_EQ(products_output.As<std::uint32_t>(), expected_products);
+      EXPECT_EQ(prefix_sums_output.As<std::uint32_t>(), expected_prefix_sums);
+      EXPECT_EQ(sum_output.As<std::uint32_t>(), expected_sum);
+      EXPECT_EQ(minimum_output.As<std::uint32_t>(), expected_minimum);
+      EXPECT_EQ(gathered_output.As<std::uint32_t>(), expected_gathered);
+      EXPECT_EQ(scattered_output.As<std::uint32_t>(), expected_scattered);
+      EXPECT_EQ(selected_output.As<std::uint32_t>(), expected_selected);
+      EXPECT_EQ(conditional_sum_output.As<std::uint32_t>(), expected_conditional_sum);
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(SecureUnsignedIntegerVector, ArithmeticGmw) {
+  for (std::size_t size : {1u, 6u, 13u}) {
+    TestVectorOperations<mo::MpcProtocol::kArithmeticGmw>(size);
+  }
+}
+
+TEST(SecureUnsignedIntegerVector, BooleanGmw) {
+  for (std::size_t size : {1u, 6u, 13u}) {
+    TestVectorOperations<mo::MpcProtocol::kBooleanGmw>(size);
+  }
+}
+
+TEST(SecureUnsignedIntegerVector, InvalidScatter) {
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      const auto share{Input<mo::MpcProtocol::kBooleanGmw>(party, {1, 2, 3}, 0)};
+      EXPECT_THROW(share.Scatter(std::vector<std::size_t>{0, 1}, share), std::invalid_argument);
+      EXPECT_THROW(share.Scatter(std::vector<std::size_t>{0, 1, 1}, share), std::invalid_argument);
+      EXPECT_THROW(share.Scatter(std::vector<std::size_t>{0, 1, 3}, share), std::out_of_range);
+      EXPECT_THROW(mo::SecureUnsignedIntegerVector::Broadcast(share.Get(), 2),
+                   std::invalid_argument);
+      party->Run();
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
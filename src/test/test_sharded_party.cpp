@@ -0,0 +1,130 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <future>
+#include <numeric>
+#include <random>
+
+#include "base/sharded_party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+
+namespace mo = encrypto::motion;
+
+namespace {
+
+TEST(ShardedParty, SplitSimd) {
+  const auto shards{mo::SplitSimd(10, 4)};
+  ASSERT_EQ(shards.size(), 4u);
+  std::size_t offset{0};
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    EXPECT_EQ(shards[i].offset, offset);
+    EXPECT_EQ(shards[i].number_of_simd, i < 2 ? 3u : 2u);
+    offset += shards[i].number_of_simd;
+  }
+  EXPECT_EQ(mo::SplitSimd(2, 3).back().number_of_simd, 0u);
+  EXPECT_THROW(mo::SplitSimd(10, 0), std::invalid_argument);
+}
+
+TEST(ShardedParty, ShardAndMergeAreInverse) {
+  std::vector<mo::BitVector<>> bit_input{mo::BitVector<>::SecureRandom(77),
+                                         mo::BitVector<>::SecureRandom(77)};
+  std::vector<std::uint32_t> integer_input(77);
+  std::iota(integer_input.begin(), integer_input.end(), 0);
+  std::vector<std::vector<mo::BitVector<>>> bit_shards;
+  std::vector<std::vector<std::uint32_t>> integer_shards;
+  for (const auto& shard : mo::SplitSimd(77, 5)) {
+    bit_shards.emplace_back(
+        mo::GetShardOfInput(std::span<const mo::BitVector<>>(bit_input), shard));
+    integer_shards.emplace_back(
+        mo::GetShardOfInput(std::span<const std::uint32_t>(integer_input), shard));
+  }
+  EXPECT_EQ(mo::MergeShardOutputs(std::span<const std::vector<mo::BitVector<>>>(bit_shards)),
+            bit_input);
+  EXPECT_EQ(
+      mo::MergeShardOutputs(std::span<const std::vector<std::uint32_t>>(integer_shards)),
+      integer_input);
+}
+
+TEST(ShardedParty, EvaluateShardsOnWorkers) {
+  constexpr auto kArithmeticGmw{mo::MpcProtocol::kArithmeticGmw};
+  constexpr auto kBooleanGmw{mo::MpcProtocol::kBooleanGmw};
+  constexpr std::size_t kNumberOfParties{2}, kNumberOfWorkers{3}, kNumberOfSimd{100};
+  std::mt19937 mersenne_twister(0);
+  std::vector<std::vector<std::uint32_t>> integer_inputs(
+      kNumberOfParties, std::vector<std::uint32_t>(kNumberOfSimd));
+  for (auto& v : integer_inputs) std::generate(v.begin(), v.end(), std::ref(mersenne_twister));
+  std::vector<std::vector<mo::BitVector<>>> bit_inputs(kNumberOfParties);
+  for (auto& v : bit_inputs) v = {mo::BitVector<>::SecureRandom(kNumberOfSimd)};
+
+  auto sharded_parties{
+      mo::MakeLocallyConnectedShardedParties(kNumberOfParties, kNumberOfWorkers, kNumberOfSimd)};
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < kNumberOfParties; ++party_id) {
+    futures.emplace_back(std::async(std::launch::async, [&, party_id] {
+      auto& sharded_party{sharded_parties[party_id]};
+      std::vector<mo::ShareWrapper> sums(kNumberOfWorkers), ands(kNumberOfWorkers);
+      sharded_party.Run([&](mo::Party& worker, std::size_t worker_i, const mo::SimdShard& shard) {
+        worker.GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+        std::array<mo::ShareWrapper, kNumberOfParties> integers, bits;
+        for (std::size_t owner = 0; owner < kNumberOfParties; ++owner) {
+          integers[owner] = worker.In<kArithmeticGmw>(
+              mo::GetShardOfInput(std::span<const std::uint32_t>(integer_inputs[owner]), shard),
+              owner);
+          bits[owner] = worker.In<kBooleanGmw>(
+              mo::GetShardOfInput(std::span<const mo::BitVector<>>(bit_inputs[owner]), shard),
+              owner);
+        }
+        sums[worker_i] = (integers[0] + integers[1]).Out();
+        ands[worker_i] = (bits[0] & bits[1]).Out();
+      });
+
+      // aggregate the outputs of the workers as the coordinator
+      std::vector<std::vector<std::uint32_t>> sum_shards;
+      std::vector<std::vector<mo::BitVector<>>> and_shards;
+      for (std::size_t worker_i = 0; worker_i < kNumberOfWorkers; ++worker_i) {
+        sum_shards.emplace_back(sums[worker_i].As<std::vector<std::uint32_t>>());
+        and_shards.emplace_back(
+            std::vector<mo::BitVector<>>{ands[worker_i].As<mo::BitVector<>>()});
+      }
+      const auto sum{
+          mo::MergeShardOutputs(std::span<const std::vector<std::uint32_t>>(sum_shards))};
+      const auto conjunction{
+          mo::MergeShardOutputs(std::span<const std::vector<mo::BitVector<>>>(and_shards))};
+      ASSERT_EQ(sum.size(), kNumberOfSimd);
+      for (std::size_t i = 0; i < kNumberOfSimd; ++i) {
+        EXPECT_EQ(sum[i], static_cast<std::uint32_t>(integer_inputs[0][i] + integer_inputs[1][i]));
+      }
+      ASSERT_EQ(conjunction.size(), 1u);
+      EXPECT_EQ(conjunction[0], bit_inputs[0][0] & bit_inputs[1][0]);
+      sharded_party.Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
@@ -0,0 +1,195 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/simd_reduce.h"
+#include "base/party.h"
+#include "base/register.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+std::vector<std::uint32_t> RandomValues(std::size_t number_of_simd) {
+  std::mt19937 mersenne_twister(number_of_simd);
+  std::vector<std::uint32_t> values(number_of_simd);
+  // few distinct values for ties
+  std::generate(values.begin(), values.end(), [&]() { return mersenne_twister() % 20; });
+  return values;
+}
+
+std::uint32_t ToPosition(const std::vector<mo::BitVector<>>& bits) {
+  std::uint32_t position{0};
+  for (std::size_t i = 0; i < bits.size(); ++i) position |= std::uint32_t(bits[i].Get(0)) << i;
+  return position;
+}
+
+TEST(SimdReduce, BooleanGmw) {
+  for (std::size_t number_of_simd : {1u, 2u, 5u, 64u}) {
+    const auto values{RandomValues(number_of_simd)};
+    const auto maximum{std::max_element(values.begin(), values.end())};
+    const auto minimum{std::min_element(values.begin(), values.end())};
+    std::uint32_t expected_xor{0};
+    for (const auto value : values) expected_xor ^= value;
+
+    auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+      futures.push_back(std::async(std::launch::async, [&, party_id]() {
+        auto& party{parties[party_id]};
+        mo::ShareWrapper input{party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(values), 0)};
+
+        auto xor_output{mo::algorithm::LowDepthReduceSimd(input, std::bit_xor<>()).Out()};
+        auto maximum_output{mo::algorithm::MaximumSimd(input).Out()};
+        auto minimum_output{mo::algorithm::MinimumSimd(input).Out()};
+        auto [arg_maximum, arg_maximum_position] = mo::algorithm::ArgMaximumSimd(input);
+        auto [arg_minimum, arg_minimum_position] = mo::algorithm::ArgMinimumSimd(input);
+        EXPECT_EQ(arg_maximum_position->GetBitLength(),
+                  std::max<std::size_t>(1, std::bit_width(number_of_simd - 1)));
+        auto arg_maximum_output{arg_maximum.Out()};
+        auto arg_maximum_position_output{arg_maximum_position.Out()};
+        auto arg_minimum_output{arg_minimum.Out()};
+        auto arg_minimum_position_output{arg_minimum_position.Out()};
+
+        party->Run();
+
+        const auto as_value = [](const mo::ShareWrapper& share) {
+          return mo::ToOutput<std::uint32_t>(share.As<std::vector<mo::BitVector<>>>());
+        };
+        EXPECT_EQ(as_value(xor_output), expected_xor);
+        EXPECT_EQ(as_value(maximum_output), *maximum);
+        EXPECT_EQ(as_value(minimum_output), *minimum);
+        EXPECT_EQ(as_value(arg_maximum_output), *maximum);
+        EXPECT_EQ(as_value(arg_minimum_output), *minimum);
+        // the first of equal values
+        EXPECT_EQ(ToPosition(arg_maximum_position_output.As<std::vector<mo::BitVector<>>>()),
+                  maximum - values.begin());
+        EXPECT_EQ(ToPosition(arg_minimum_position_output.As<std::vector<mo::BitVector<>>>()),
+                  minimum - values.begin());
+        party->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+TEST(SimdReduce, TopK) {
+  for (std::size_t number_of_simd : {1u, 7u, 64u}) {
+    const auto values{RandomValues(number_of_simd)};
+    const std::size_t k{std::min<std::size_t>(number_of_simd, 5)};
+    // the positions by descending and ascending values, the first of equal values first
+    std::vector<std::uint32_t> descending(number_of_simd), ascending(number_of_simd);
+    std::iota(descending.begin(), descending.end(), 0);
+    std::iota(ascending.begin(), ascending.end(), 0);
+    std::stable_sort(descending.begin(), descending.end(),
+                     [&](auto i, auto j) { return values[i] > values[j]; });
+    std::stable_sort(ascending.begin(), ascending.end(),
+                     [&](auto i, auto j) { return values[i] < values[j]; });
+
+    auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+    for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    std::vector<std::future<void>> futures;
+    for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+      futures.push_back(std::async(std::launch::async, [&, party_id]() {
+        auto& party{parties[party_id]};
+        mo::ShareWrapper input{party->In<mo::MpcProtocol::kBooleanGmw>(mo::ToInput(values), 0)};
+
+        auto [top, top_positions] = mo::algorithm::TopKSimd(input, k);
+        auto [bottom, bottom_positions] = mo::algorithm::BottomKSimd(input, k);
+        EXPECT_EQ(top->GetNumberOfSimdValues(), k);
+        EXPECT_THROW(mo::algorithm::TopKSimd(input, number_of_simd + 1), std::invalid_argument);
+        auto top_output{top.Out()};
+        auto top_positions_output{top_positions.Out()};
+        auto bottom_output{bottom.Out()};
+        auto bottom_positions_output{bottom_positions.Out()};
+
+        party->Run();
+
+        const auto check = [&](const mo::ShareWrapper& output,
+                               const mo::ShareWrapper& positions_output,
+                               const std::vector<std::uint32_t>& expected) {
+          const auto output_values{
+              mo::ToVectorOutput<std::uint32_t>(output.As<std::vector<mo::BitVector<>>>())};
+          const auto position_bits{positions_output.As<std::vector<mo::BitVector<>>>()};
+          for (std::size_t i = 0; i < k; ++i) {
+            std::uint32_t position{0};
+            for (std::size_t j = 0; j < position_bits.size(); ++j) {
+              position |= std::uint32_t(position_bits[j].Get(i)) << j;
+            }
+            EXPECT_EQ(position, expected[i]);
+            EXPECT_EQ(output_values.at(i), values[expected[i]]);
+          }
+        };
+        check(top_output, top_positions_output, descending);
+        check(bottom_output, bottom_positions_output, ascending);
+        party->Finish();
+      }));
+    }
+    for (auto& f : futures) f.get();
+  }
+}
+
+TEST(SimdReduce, ArithmeticGmwSumHasLogarithmicNumberOfGates) {
+  constexpr std::size_t kNumberOfSimd{1000};
+  const auto values{RandomValues(kNumberOfSimd)};
+  std::uint32_t expected_sum{0};
+  for (const auto value : values) expected_sum += value;
+
+  auto parties{mo::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper input{party->In<mo::MpcProtocol::kArithmeticGmw>(values, 0)};
+      const auto number_of_gates{party->GetBackend()->GetRegister()->GetGates().size()};
+      auto sum{mo::algorithm::LowDepthReduceSimd(input, std::plus<>())};
+      // two Subsets and an addition per level and a Simdify on levels with an odd size
+      EXPECT_LE(party->GetBackend()->GetRegister()->GetGates().size() - number_of_gates,
+                4 * std::bit_width(kNumberOfSimd - 1));
+      auto sum_output{sum.Out()};
+
+      party->Run();
+
+      EXPECT_EQ(sum_output.As<std::uint32_t>(), expected_sum);
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+}  // namespace
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2021 Oleksandr Tkachenko
+// Cryptography and Privacy Engineering Group (ENCRYPTO)
+// TU Darmstadt, Germany
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "algorithm/sort.h"
+#include "base/party.h"
+#include "protocols/share_wrapper.h"
+#include "test_constants.h"
+#include "utility/bit_vector.h"
+
+namespace {
+
+namespace mo = encrypto::motion;
+
+template <mo::MpcProtocol P>
+void TestSort(std::size_t number_of_parties, std::size_t number_of_simd) {
+  std::mt19937 mersenne_twister(number_of_simd);
+  std::vector<std::uint16_t> keys(number_of_simd);
+  // few distinct keys for repetitions
+  std::generate(keys.begin(), keys.end(), [&]() { return mersenne_twister() % 50; });
+  // the index of each key as value
+  std::vector<std::uint16_t> indices(number_of_simd);
+  std::iota(indices.begin(), indices.end(), 0);
+  auto expected_keys{keys};
+  std::sort(expected_keys.begin(), expected_keys.end());
+
+  auto parties{mo::MakeLocallyConnectedParties(number_of_parties, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      auto& party{parties[party_id]};
+      mo::ShareWrapper key_share{party->In<P>(mo::ToInput(keys), 0)};
+      mo::ShareWrapper value_share{party->In<P>(mo::ToInput(indices), 1)};
+
+      auto sorted_output{mo::algorithm::Sort(key_share).Out()};
+      auto [sorted_keys, sorted_values] = mo::algorithm::SortBy(key_share, value_share);
+      auto sorted_keys_output{sorted_keys.Out()};
+      auto sorted_values_output{sorted_values.Out()};
+
+      party->Run();
+
+      const auto sorted{
+          mo::ToVectorOutput<std::uint16_t>(sorted_output.As<std::vector<mo::BitVector<>>>())};
+      const auto result_keys{mo::ToVectorOutput<std::uint16_t>(
+          sorted_keys_output.As<std::vector<mo::BitVector<>>>())};
+      const auto result_values{mo::ToVectorOutput<std::uint16_t>(
+          sorted_values_output.As<std::vector<mo::BitVector<>>>())};
+      EXPECT_EQ(sorted, expected_keys);
+      EXPECT_EQ(result_keys, expected_keys);
+      // the values are a permutation that moves along with their keys
+      for (std::size_t i = 0; i < number_of_simd; ++i) {
+        EXPECT_EQ(keys.at(result_values[i]), result_keys[i]);
+      }
+      EXPECT_TRUE(std::is_permutation(result_values.begin(), result_values.end(), indices.begin()));
+      party->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(Sort, BooleanGmw) {
+  for (std::size_t number_of_simd : {1u, 2u, 13u, 64u}) {
+    TestSort<mo::MpcProtocol::kBooleanGmw>(3, number_of_simd);
+  }
+}
+
+TEST(Sort, Bmr) { TestSort<mo::MpcProtocol::kBmr>(2, 21); }
+
+}  // namespace
@@ -22,6 +22,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <future>
 #include <random>
 
@@ -392,4 +393,54 @@ INSTANTIATE_TEST_SUITE_P(DataManagementTestSuite, ArithmeticSubsetTest,
                                std::get<1>(info.param), std::get<2>(info.param), mode);
                            return name;
                          });
+
+TEST(DataManagementViews, ComposedSubsetsAndSimdify) {
+  constexpr auto kBooleanGmw{encrypto::motion::MpcProtocol::kBooleanGmw};
+  constexpr std::size_t kNumberOfWires{4}, kNumberOfSimd{10};
+  std::vector<encrypto::motion::BitVector<>> inputs;
+  for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+    inputs.emplace_back(encrypto::motion::BitVector<>::RandomSeeded(kNumberOfSimd, i));
+  }
+  const std::vector<std::size_t> positions{9, 3, 3, 0, 5}, positions_of_positions{4, 0, 2};
+
+  auto parties{encrypto::motion::MakeLocallyConnectedParties(2, kPortOffset)};
+  for (auto& party : parties) party->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+  std::vector<std::future<void>> futures;
+  for (std::size_t party_id = 0; party_id < parties.size(); ++party_id) {
+    futures.push_back(std::async(std::launch::async, [&, party_id]() {
+      encrypto::motion::ShareWrapper input{parties[party_id]->In<kBooleanGmw>(inputs, 0)};
+
+      // restoring the SIMD values in their order needs no gate
+      auto simd_values{input.Unsimdify()};
+      EXPECT_EQ(encrypto::motion::ShareWrapper::Simdify(simd_values)->GetWires(),
+                input->GetWires());
+      EXPECT_EQ(input.Subset(std::vector<std::size_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9})->GetWires(),
+                input->GetWires());
+
+      // a permutation of the SIMD values and a subset of a subset read from the input
+      std::reverse(simd_values.begin(), simd_values.end());
+      auto reversed{encrypto::motion::ShareWrapper::Simdify(simd_values)};
+      auto subset{input.Subset(positions).Subset(positions_of_positions)};
+      EXPECT_EQ(subset->GetWires().at(0)->GetSimdViewSource(), input->GetWires().at(0));
+      auto reversed_output{reversed.Out()};
+      auto subset_output{subset.Out()};
+
+      parties[party_id]->Run();
+
+      const auto reversed_values{reversed_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      const auto subset_values{subset_output.As<std::vector<encrypto::motion::BitVector<>>>()};
+      for (std::size_t i = 0; i < kNumberOfWires; ++i) {
+        for (std::size_t j = 0; j < kNumberOfSimd; ++j) {
+          EXPECT_EQ(reversed_values[i].Get(j), inputs[i].Get(kNumberOfSimd - 1 - j));
+        }
+        for (std::size_t j = 0; j < positions_of_positions.size(); ++j) {
+          EXPECT_EQ(subset_values[i].Get(j), inputs[i].Get(positions[positions_of_positions[j]]));
+        }
+      }
+      parties[party_id]->Finish();
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
 }  // namespace
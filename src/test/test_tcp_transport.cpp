@@ -24,6 +24,7 @@
 
 #include <future>
 
+#include "communication/striped_transport.h"
 #include "communication/tcp_transport.h"
 
 class TcpTransportTest : public testing::TestWithParam<std::string> {};
@@ -54,7 +55,189 @@ TEST_P(TcpTransportTest, dummy) {
   EXPECT_FALSE(transport_bob->Available());
 
   EXPECT_EQ(ReceivedMessage, message);
+
+  const std::vector<std::span<const std::uint8_t>> message_parts = {
+      std::span(message).subspan(0, 1), std::span(message).subspan(1)};
+  transport_alice->SendMessageParts(message_parts);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+}
+
+TEST_P(TcpTransportTest, Striped) {
+  constexpr std::size_t kNumberOfConnections = 3;
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetNumberOfConnectionsPerParty(kNumberOfConnections);
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetNumberOfConnectionsPerParty(kNumberOfConnections);
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  // large enough to be split over all connections
+  std::vector<std::uint8_t> large_message(
+      kNumberOfConnections * encrypto::motion::communication::StripedTransport::kMinimumChunkSize +
+      123);
+  for (std::size_t i = 0; i < large_message.size(); ++i) {
+    large_message[i] = static_cast<std::uint8_t>(i * 7);
+  }
+
+  auto send_future = std::async(std::launch::async, [&] {
+    transport_alice->SendMessage(message);
+    transport_alice->SendMessage(large_message);
+    transport_alice->SendMessage(message);
+  });
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), large_message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  send_future.get();
+
+  // both parties send striped messages at the same time
+  auto send_future_alice =
+      std::async(std::launch::async, [&] { transport_alice->SendMessage(large_message); });
+  auto send_future_bob =
+      std::async(std::launch::async, [&] { transport_bob->SendMessage(large_message); });
+  EXPECT_EQ(transport_alice->ReceiveMessage(), large_message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), large_message);
+  send_future_alice.get();
+  send_future_bob.get();
+}
+
+TEST_P(TcpTransportTest, BusyPoll) {
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13337}, {localhost, 13338}});
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetBusyPoll();
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  // the receiver spins until the message arrives
+  auto receive_future =
+      std::async(std::launch::async, [&] { return transport_bob->ReceiveMessage(); });
+  transport_alice->SendMessage(message);
+  EXPECT_EQ(receive_future.get(), message);
+
+  transport_alice->ShutdownSend();
+  EXPECT_FALSE(transport_bob->ReceiveMessage().has_value());
+}
+
+#ifdef MOTION_IO_URING
+TEST_P(TcpTransportTest, IoUring) {
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetUseIoUring();
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetUseIoUring();
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  // larger than the registered receive buffer
+  const std::vector<std::uint8_t> large_message(3'000'000, 0x42);
+
+  // the large message does not fit into the socket buffers, so we need to send asynchronously
+  auto send_future = std::async(std::launch::async, [&] {
+    transport_alice->SendMessage(message);
+    transport_alice->SendMessage(large_message);
+    transport_alice->SendMessage(message);
+  });
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), large_message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  send_future.get();
+
+  transport_alice->ShutdownSend();
+  EXPECT_FALSE(transport_bob->ReceiveMessage().has_value());
+}
+#endif
+
+#ifdef MOTION_RDMA
+TEST_P(TcpTransportTest, Rdma) {
+  using encrypto::motion::communication::RdmaTransport;
+  if (!RdmaTransport::IsAvailable()) {
+    GTEST_SKIP() << "no RDMA device";
+  }
+  auto localhost = GetParam();
+  auto transport_alice_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        0, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetUseRdma();
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_future = std::async(std::launch::async, [localhost] {
+    encrypto::motion::communication::TcpSetupHelper helper(
+        1, {{localhost, 13337}, {localhost, 13338}});
+    helper.SetUseRdma();
+    auto transports = helper.SetupConnections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_future.get();
+  auto transport_bob = transport_bob_future.get();
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  // spans several slots of the receiver
+  std::vector<std::uint8_t> medium_message(RdmaTransport::kDirectWriteThreshold - 1);
+  for (std::size_t i = 0; i < medium_message.size(); ++i) {
+    medium_message[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  // written directly into the destination
+  std::vector<std::uint8_t> large_message(3 * RdmaTransport::kDirectWriteThreshold + 123);
+  for (std::size_t i = 0; i < large_message.size(); ++i) {
+    large_message[i] = static_cast<std::uint8_t>(i * 13);
+  }
+
+  // more messages than the receiver has slots, s.t. the sender needs the returned credits
+  constexpr std::size_t kNumberOfSmallMessages = 1000;
+  auto send_future = std::async(std::launch::async, [&] {
+    transport_alice->SendMessage(message);
+    transport_alice->SendMessage(medium_message);
+    transport_alice->SendMessage(large_message);
+    for (std::size_t i = 0; i < kNumberOfSmallMessages; ++i) transport_alice->SendMessage(message);
+  });
+  EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), medium_message);
+  EXPECT_EQ(transport_bob->ReceiveMessage(), large_message);
+  for (std::size_t i = 0; i < kNumberOfSmallMessages; ++i) {
+    EXPECT_EQ(transport_bob->ReceiveMessage(), message);
+  }
+  send_future.get();
+  EXPECT_FALSE(transport_bob->Available());
+
+  transport_alice->ShutdownSend();
+  EXPECT_FALSE(transport_bob->ReceiveMessage().has_value());
 }
+#endif
 
 INSTANTIATE_TEST_SUITE_P(TcpTransportSuite, TcpTransportTest, testing::Values("127.0.0.1", "::1"),
                          [](auto& info) { return info.param == "::1" ? "ipv6" : "ipv4"; });
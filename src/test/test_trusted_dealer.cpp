@@ -0,0 +1,463 @@
+// MIT License
+//
+// Copyright (c) 2022 Oleksandr Tkachenko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gtest/gtest.h"
+
+#include <future>
+#include <thread>
+
+#include "test_constants.h"
+
+#include "base/backend.h"
+#include "base/party.h"
+#include "communication/dummy_transport.h"
+#include "multiplication_triple/mt_provider.h"
+#include "multiplication_triple/sb_provider.h"
+#include "multiplication_triple/sp_provider.h"
+#include "oblivious_transfer/ot_flavors.h"
+#include "oblivious_transfer/ot_provider.h"
+#include "protocols/share_wrapper.h"
+#include "trusted_dealer/trusted_dealer.h"
+
+namespace {
+
+constexpr auto kNumberOfPartiesList = {2u, 3u};
+
+// returns the transports of the dealer and the parties
+std::pair<std::vector<std::unique_ptr<encrypto::motion::communication::Transport>>,
+          std::vector<std::unique_ptr<encrypto::motion::communication::Transport>>>
+MakeDealerTransports(std::size_t number_of_parties) {
+  std::vector<std::unique_ptr<encrypto::motion::communication::Transport>> dealer_transports,
+      party_transports;
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    auto [dealer_transport, party_transport] =
+        encrypto::motion::communication::DummyTransport::MakeTransportPair();
+    dealer_transports.emplace_back(std::move(dealer_transport));
+    party_transports.emplace_back(std::move(party_transport));
+  }
+  return {std::move(dealer_transports), std::move(party_transports)};
+}
+
+template <typename T>
+T SumShares(const std::vector<encrypto::motion::DealerCorrelations>& correlations,
+            std::vector<T> encrypto::motion::DealerCorrelations::*shares, std::size_t index) {
+  T sum{0};
+  for (const auto& correlation : correlations) sum += (correlation.*shares)[index];
+  return sum;
+}
+
+// request of party i for number_of_correlations MTs, SPs and SBs of each type, and
+// number_of_correlations + i resp. + j OTs as sender resp. receiver with party j
+encrypto::motion::DealerRequest MakeRequest(std::size_t i, std::size_t number_of_parties,
+                                            std::size_t number_of_correlations) {
+  encrypto::motion::DealerRequest request;
+  request.my_id = i;
+  request.number_of_parties = number_of_parties;
+  request.number_of_mts.fill(number_of_correlations);
+  request.number_of_sps.fill(number_of_correlations);
+  request.number_of_sbs.fill(number_of_correlations);
+  request.number_of_ots_sender.resize(number_of_parties);
+  request.number_of_ots_receiver.resize(number_of_parties);
+  for (std::size_t j = 0; j < number_of_parties; ++j) {
+    if (j == i) continue;
+    // different numbers of OTs for each direction
+    request.number_of_ots_sender[j] = number_of_correlations + i;
+    request.number_of_ots_receiver[j] = number_of_correlations + j;
+  }
+  return request;
+}
+
+// checks that the shares of all parties form valid MTs, SPs, SBs and OTs for the requests of
+// MakeRequest
+void ExpectValidCorrelations(const std::vector<encrypto::motion::DealerCorrelations>& correlations,
+                             std::size_t number_of_correlations) {
+  const std::size_t number_of_parties{correlations.size()};
+  encrypto::motion::BitVector<> a(number_of_correlations), b(number_of_correlations),
+      c(number_of_correlations);
+  for (const auto& correlation : correlations) {
+    a ^= correlation.bit_mts.a;
+    b ^= correlation.bit_mts.b;
+    c ^= correlation.bit_mts.c;
+  }
+  EXPECT_EQ(c, a & b);
+
+  for (std::size_t k = 0; k < number_of_correlations; ++k) {
+    std::uint32_t mt_a{0}, mt_b{0}, mt_c{0}, sp_a{0}, sp_c{0};
+    for (const auto& correlation : correlations) {
+      mt_a += correlation.mts_32.a[k];
+      mt_b += correlation.mts_32.b[k];
+      mt_c += correlation.mts_32.c[k];
+      sp_a += correlation.sps_32.a[k];
+      sp_c += correlation.sps_32.c[k];
+    }
+    EXPECT_EQ(mt_c, mt_a * mt_b);
+    EXPECT_EQ(sp_c, sp_a * sp_a);
+    EXPECT_LE(SumShares(correlations, &encrypto::motion::DealerCorrelations::sbs_8, k), 1);
+    EXPECT_LE(SumShares(correlations, &encrypto::motion::DealerCorrelations::sbs_64, k), 1);
+  }
+
+  for (std::size_t i = 0; i < number_of_parties; ++i) {
+    for (std::size_t j = 0; j < number_of_parties; ++j) {
+      if (j == i) continue;
+      const auto& sender{correlations[i].ots[j]};
+      const auto& receiver{correlations[j].ots[i]};
+      ASSERT_EQ(sender.sender_ots.size(), number_of_correlations + i);
+      ASSERT_EQ(receiver.receiver_ots.size(), number_of_correlations + i);
+      for (std::size_t k = 0; k < sender.sender_ots.size(); ++k) {
+        auto expected{receiver.receiver_ots[k]};
+        if (receiver.choices.Get(k)) expected ^= sender.delta;
+        EXPECT_TRUE(sender.sender_ots[k] == expected);
+      }
+    }
+  }
+}
+
+TEST(TrustedDealer, Correlations) {
+  constexpr std::size_t kNumberOfCorrelations = 100;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto [dealer_transports, party_transports] = MakeDealerTransports(number_of_parties);
+    encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+    auto dealer_future = std::async(std::launch::async, [&dealer] { dealer.Run(); });
+
+    std::vector<encrypto::motion::DealerRequest> requests(number_of_parties);
+    std::vector<encrypto::motion::DealerCorrelations> correlations(number_of_parties);
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      requests[i] = MakeRequest(i, number_of_parties, kNumberOfCorrelations);
+      futures.emplace_back(std::async(
+          std::launch::async, [&requests, &correlations, &party_transports = party_transports, i] {
+            encrypto::motion::TrustedDealerClient client(std::move(party_transports[i]));
+            correlations[i] = client.Request(requests[i]);
+          }));
+    }
+    for (auto& future : futures) future.get();
+    dealer_future.get();
+
+    ExpectValidCorrelations(correlations, kNumberOfCorrelations);
+  }
+}
+
+TEST(TrustedDealer, InsecureFakeCorrelations) {
+  constexpr std::size_t kNumberOfCorrelations = 100;
+  const auto seed{encrypto::motion::Block128::MakeRandom()};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    std::vector<encrypto::motion::DealerCorrelations> correlations;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      correlations.emplace_back(encrypto::motion::MakeInsecureFakeCorrelations(
+          MakeRequest(i, number_of_parties, kNumberOfCorrelations), seed));
+    }
+    ExpectValidCorrelations(correlations, kNumberOfCorrelations);
+  }
+}
+
+TEST(TrustedDealer, RejectMismatchingRequests) {
+  constexpr std::size_t kNumberOfParties = 2;
+  auto [dealer_transports, party_transports] = MakeDealerTransports(kNumberOfParties);
+  encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+  auto dealer_future = std::async(std::launch::async, [&dealer] { return dealer.ServeRequests(); });
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    futures.emplace_back(
+        std::async(std::launch::async, [&party_transports = party_transports, i] {
+          encrypto::motion::DealerRequest request;
+          request.my_id = i;
+          request.number_of_parties = kNumberOfParties;
+          // the parties disagree on the number of MTs
+          request.number_of_mts[0] = 10 + i;
+          request.number_of_ots_sender.resize(kNumberOfParties);
+          request.number_of_ots_receiver.resize(kNumberOfParties);
+          encrypto::motion::TrustedDealerClient client(std::move(party_transports[i]));
+          client.Request(request);
+        }));
+  }
+  EXPECT_THROW(dealer_future.get(), std::runtime_error);
+  for (auto& future : futures) EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(TrustedDealer, Preprocessing) {
+  constexpr std::size_t kNumberOfOts{100}, kBitlength{64}, kNumberOfMts{100};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto [dealer_transports, party_transports] = MakeDealerTransports(number_of_parties);
+    encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+    auto dealer_future = std::async(std::launch::async, [&dealer] { dealer.Run(); });
+
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    // my id, other id
+    std::vector<std::vector<std::unique_ptr<encrypto::motion::ROtSender>>> sender_ots(
+        number_of_parties);
+    std::vector<std::vector<std::unique_ptr<encrypto::motion::ROtReceiver>>> receiver_ots(
+        number_of_parties);
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      auto& backend{motion_parties.at(i)->GetBackend()};
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      backend->SetTrustedDealer(std::move(party_transports[i]));
+      backend->GetMtProvider().RequestBinaryMts(kNumberOfMts);
+      backend->GetMtProvider().RequestArithmeticMts<std::uint64_t>(kNumberOfMts);
+      sender_ots.at(i).resize(number_of_parties);
+      receiver_ots.at(i).resize(number_of_parties);
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        if (j == i) continue;
+        auto& ot_provider{backend->GetOtProvider(j)};
+        sender_ots.at(i).at(j) = ot_provider.RegisterSendROt(kNumberOfOts, kBitlength);
+        receiver_ots.at(i).at(j) = ot_provider.RegisterReceiveROt(kNumberOfOts, kBitlength);
+      }
+    }
+
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        motion_parties.at(i)->GetBackend()->RunPreprocessing();
+        motion_parties.at(i)->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      for (std::size_t j = 0; j < number_of_parties; ++j) {
+        if (j == i) continue;
+        auto& sender_ot{sender_ots.at(i).at(j)};
+        auto& receiver_ot{receiver_ots.at(j).at(i)};
+        sender_ot->ComputeOutputs();
+        receiver_ot->ComputeOutputs();
+        const auto& sender_messages{sender_ot->GetOutputs()};
+        const auto& receiver_messages{receiver_ot->GetOutputs()};
+        const auto& choices{receiver_ot->GetChoices()};
+        for (std::size_t k = 0; k < kNumberOfOts; ++k) {
+          std::size_t offset{choices.Get(k) ? kBitlength : 0};
+          EXPECT_EQ(receiver_messages[k], sender_messages[k].Subset(offset, offset + kBitlength));
+        }
+      }
+    }
+
+    encrypto::motion::BitVector<> a(kNumberOfMts), b(kNumberOfMts), c(kNumberOfMts);
+    std::vector<std::uint64_t> a_64(kNumberOfMts), b_64(kNumberOfMts), c_64(kNumberOfMts);
+    for (auto& party : motion_parties) {
+      const auto& mt_provider{party->GetBackend()->GetMtProvider()};
+      a ^= mt_provider.GetBinaryAll().a;
+      b ^= mt_provider.GetBinaryAll().b;
+      c ^= mt_provider.GetBinaryAll().c;
+      const auto& mts{mt_provider.GetIntegerAll<std::uint64_t>()};
+      for (std::size_t k = 0; k < kNumberOfMts; ++k) {
+        a_64[k] += mts.a[k];
+        b_64[k] += mts.b[k];
+        c_64[k] += mts.c[k];
+      }
+    }
+    EXPECT_EQ(c, a & b);
+    for (std::size_t k = 0; k < kNumberOfMts; ++k) EXPECT_EQ(c_64[k], a_64[k] * b_64[k]);
+
+    // closes the connections to the dealer
+    motion_parties.clear();
+    dealer_future.get();
+  }
+}
+
+TEST(TrustedDealer, GmwCircuit) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto [dealer_transports, party_transports] = MakeDealerTransports(number_of_parties);
+    encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+    auto dealer_future = std::async(std::launch::async, [&dealer] { dealer.Run(); });
+
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::pair<bool, std::uint32_t>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetBackend()->SetTrustedDealer(std::move(party_transports[i]));
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        encrypto::motion::ShareWrapper bit_0{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 0), 0)};
+        encrypto::motion::ShareWrapper bit_1{
+            party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 1), 1)};
+        encrypto::motion::ShareWrapper integer_0{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 12345 : 0), 0)};
+        encrypto::motion::ShareWrapper integer_1{
+            party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 678 : 0), 1)};
+        auto bit_output{(bit_0 & bit_1).Out()};
+        auto integer_output{(integer_0 * integer_1).Out()};
+        party->Run();
+        party->Finish();
+        return std::make_pair(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+      }));
+    }
+    for (auto& future : futures) {
+      auto [bit, integer] = future.get();
+      EXPECT_TRUE(bit);
+      EXPECT_EQ(integer, std::uint32_t(12345 * 678));
+    }
+
+    motion_parties.clear();
+    dealer_future.get();
+  }
+}
+
+// the 1-out-of-N OTs of lookup tables are not served by the dealer and are still extended from
+// base OTs between the parties
+TEST(TrustedDealer, LookupTable) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr std::size_t kNumberOfParties{2};
+  auto [dealer_transports, party_transports] = MakeDealerTransports(kNumberOfParties);
+  encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+  auto dealer_future = std::async(std::launch::async, [&dealer] { dealer.Run(); });
+
+  auto motion_parties =
+      encrypto::motion::MakeLocallyConnectedParties(kNumberOfParties, kPortOffset);
+  std::vector<std::future<std::pair<bool, std::vector<encrypto::motion::BitVector<>>>>> futures;
+  for (std::size_t i = 0; i < kNumberOfParties; ++i) {
+    motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+    motion_parties.at(i)->GetBackend()->SetTrustedDealer(std::move(party_transports[i]));
+    futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+      auto& party{motion_parties.at(i)};
+      encrypto::motion::ShareWrapper bit_0{
+          party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, true), 0)};
+      encrypto::motion::ShareWrapper bit_1{
+          party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, true), 1)};
+      // AND and XOR of the two bits
+      std::vector<encrypto::motion::BitVector<>> truth_tables{
+          encrypto::motion::BitVector<>(std::vector<bool>{false, false, false, true}),
+          encrypto::motion::BitVector<>(std::vector<bool>{false, true, true, false})};
+      auto lut_output{encrypto::motion::ShareWrapper::Concatenate(std::vector{bit_0, bit_1})
+                          .LookupTable(std::move(truth_tables))
+                          .Out()};
+      // an AND with the MTs of the dealer
+      auto and_output{(bit_0 & bit_1).Out()};
+      party->Run();
+      party->Finish();
+      return std::make_pair(and_output.As<bool>(),
+                            lut_output.As<std::vector<encrypto::motion::BitVector<>>>());
+    }));
+  }
+  for (auto& future : futures) {
+    auto [bit, lut] = future.get();
+    EXPECT_TRUE(bit);
+    EXPECT_EQ(lut, (std::vector{encrypto::motion::BitVector<>(1, true),
+                                encrypto::motion::BitVector<>(1, false)}));
+  }
+
+  motion_parties.clear();
+  dealer_future.get();
+}
+
+TEST(TrustedDealer, InsecureFakePreprocessing) {
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<void>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetConfiguration()->SetInsecureFakePreprocessing(42);
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        // two runs, which derive different correlations from the seed
+        for (std::uint32_t run = 1; run <= 2; ++run) {
+          encrypto::motion::ShareWrapper bit_0{
+              party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 0), 0)};
+          encrypto::motion::ShareWrapper bit_1{
+              party->In<kBooleanGmw>(encrypto::motion::BitVector<>(1, i == 1), 1)};
+          encrypto::motion::ShareWrapper integer_0{
+              party->In<kArithmeticGmw>(std::uint32_t(i == 0 ? 12345 * run : 0), 0)};
+          encrypto::motion::ShareWrapper integer_1{
+              party->In<kArithmeticGmw>(std::uint32_t(i == 1 ? 678 : 0), 1)};
+          auto bit_output{(bit_0 & bit_1).Out()};
+          auto integer_output{(integer_0 * integer_1).Out()};
+          party->Run();
+          EXPECT_TRUE(bit_output.As<bool>());
+          EXPECT_EQ(integer_output.As<std::uint32_t>(), std::uint32_t(12345 * run * 678));
+          if (run == 1) party->Reset();
+        }
+        party->Finish();
+      }));
+    }
+    for (auto& future : futures) future.get();
+  }
+}
+
+TEST(TrustedDealer, RerunCompiledCircuit) {
+  constexpr auto kBooleanGmw = encrypto::motion::MpcProtocol::kBooleanGmw;
+  constexpr auto kArithmeticGmw = encrypto::motion::MpcProtocol::kArithmeticGmw;
+  constexpr std::size_t kNumberOfRuns{3};
+  for (auto number_of_parties : kNumberOfPartiesList) {
+    auto [dealer_transports, party_transports] = MakeDealerTransports(number_of_parties);
+    encrypto::motion::TrustedDealer dealer(std::move(dealer_transports));
+    auto dealer_future = std::async(std::launch::async, [&dealer] { dealer.Run(); });
+
+    auto motion_parties =
+        encrypto::motion::MakeLocallyConnectedParties(number_of_parties, kPortOffset);
+    std::vector<std::future<std::vector<std::pair<bool, std::uint32_t>>>> futures;
+    for (std::size_t i = 0; i < number_of_parties; ++i) {
+      motion_parties.at(i)->GetLogger()->SetEnabled(kDetailedLoggingEnabled);
+      motion_parties.at(i)->GetBackend()->SetTrustedDealer(std::move(party_transports[i]));
+      futures.emplace_back(std::async(std::launch::async, [&motion_parties, i] {
+        auto& party{motion_parties.at(i)};
+        auto bit_input = [i](std::size_t run, std::size_t owner) {
+          return std::vector{encrypto::motion::BitVector<>(1, i == owner && run != 1)};
+        };
+        auto integer_input = [i](std::size_t run, std::size_t owner) {
+          return std::vector<std::uint32_t>{i == owner ? std::uint32_t(100 * owner + run) : 0};
+        };
+        encrypto::motion::ShareWrapper bit_0{party->In<kBooleanGmw>(bit_input(0, 0), 0)};
+        encrypto::motion::ShareWrapper bit_1{party->In<kBooleanGmw>(bit_input(0, 1), 1)};
+        encrypto::motion::ShareWrapper integer_0{party->In<kArithmeticGmw>(integer_input(0, 0), 0)};
+        encrypto::motion::ShareWrapper integer_1{party->In<kArithmeticGmw>(integer_input(0, 1), 1)};
+        auto bit_output{(bit_0 & bit_1).Out()};
+        auto integer_output{(integer_0 * integer_1).Out()};
+        auto& circuit{party->Compile()};
+
+        std::vector<std::pair<bool, std::uint32_t>> results;
+        for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+          if (run > 0) {
+            // the MTs of the last run are discarded and requested again from the dealer
+            party->Clear();
+            circuit.SetInput(0, bit_input(run, 0));
+            circuit.SetInput(1, bit_input(run, 1));
+            circuit.SetInput(2, integer_input(run, 0));
+            circuit.SetInput(3, integer_input(run, 1));
+          }
+          party->Run();
+          results.emplace_back(bit_output.As<bool>(), integer_output.As<std::uint32_t>());
+        }
+        party->Finish();
+        return results;
+      }));
+    }
+    for (auto& future : futures) {
+      const auto results{future.get()};
+      ASSERT_EQ(results.size(), kNumberOfRuns);
+      for (std::size_t run = 0; run < kNumberOfRuns; ++run) {
+        EXPECT_EQ(results[run].first, run != 1);
+        EXPECT_EQ(results[run].second, std::uint32_t(run * (100 + run)));
+      }
+    }
+
+    motion_parties.clear();
+    dealer_future.get();
+  }
+}
+
+}  // namespace